@@ -34,9 +34,39 @@
  */
 #define KERNEL_STACK_SIZE 0x1000
 
-/* Maximal number of CPU supported by the architecture */
+/* Maximal number of CPU supported by the architecture
+ * WARNING This value should be updated to fit other configuration files
+ */
 #define MAX_CPU_COUNT 4
 
+/* Maximal number of NUMA nodes, the nodes declared by the firmware after the
+ * last one are merged in the first node
+ */
+#define MAX_NUMA_NODE_COUNT 4
+
+/* Size of the per-CPU data area of each CPU, the per-CPU variables of the
+ * .percpu section must fit in it
+ */
+#define PERCPU_AREA_SIZE 0x1000
+
+/* APs startup code physical address, must be 4K aligned and below 1MB
+ * WARNING This value should be updated to fit other configuration files
+ */
+#define KERNEL_AP_BOOT_ADDR 0x8000
+
+/* Maximal number of threads managed by the scheduler, including the idle
+ * thread. Each thread gets a stack slot in the threads stacks area.
+ */
+#define KERNEL_MAX_THREAD_COUNT 12
+
+/* Virtual area of the threads stacks, below the kernel mapping. A stack slot
+ * is KERNEL_THREAD_STACK_SIZE bytes long, aligned on its size, and starts
+ * with an unmapped guard page. The stacks pages are committed on first touch.
+ * WARNING This value should be updated to fit the boot paging structures
+ */
+#define KERNEL_THREAD_STACKS_BASE 0xFFFFFFF000000000
+#define KERNEL_THREAD_STACK_SIZE  0x8000
+
 /* Kernel log level */
 #define DEBUG_LOG_LEVEL 3
 #define INFO_LOG_LEVEL  2
@@ -48,6 +78,110 @@
 /* Kernel log on UART */
 #define DEBUG_LOG_UART 1
 
+/* Record the debug messages as their format and raw arguments, they are
+ * formated when the kernel log is rendered
+ */
+#define DEBUG_LOG_BINARY 1
+
+/* Stream the trace packets on the trace UART port, tracing must be enabled */
+#define TRACE_DRAIN_UART 0
+
+/* Spinlocks implementation, KERNEL_SPINLOCK_TICKET or KERNEL_SPINLOCK_MCS.
+ * The ticket locks are the default, the locks contended by all the CPUs use
+ * the MCS queued locks, the waiters then spin on their own cache line.
+ */
+#define KERNEL_SPINLOCK_DEFAULT_TYPE KERNEL_SPINLOCK_TICKET
+#define UART_SPINLOCK_TYPE           KERNEL_SPINLOCK_MCS
+#define SCHED_SPINLOCK_TYPE          KERNEL_SPINLOCK_MCS
+
+/* Measure the spinlocks hold time with the timestamp counter */
+#define KERNEL_SPINLOCK_STATS 0
+
+/* Record the spinlocks acquisitions, contentions, wait and hold times per
+ * KERNEL_SPINLOCK_LOCK site, see lockstat.h
+ */
+#define KERNEL_LOCKSTAT 0
+
+/* Record the kernel heap allocations per size class and per kmalloc site and
+ * sample the allocations stacks, see memstat.h
+ */
+#define KERNEL_MEMSTAT 0
+
+/* One allocation out of this number records its stack with KERNEL_MEMSTAT */
+#define KERNEL_MEMSTAT_SAMPLE_PERIOD 64
+
+/* Measure the windows the interrupts stay masked on each CPU and trace the
+ * longest ones with their call sites, tracing must be enabled, see irqsoff.h
+ */
+#define KERNEL_IRQSOFF_TRACER 0
+
+/* Reset the machine once the panic crash record is written, the record is
+ * exported on the kernel output by the next boot, see crash_dump.h
+ */
+#define CRASH_DUMP_REBOOT 0
+
+/* Export the trace packet of the crash record as hexadecimal words */
+#define CRASH_DUMP_EXPORT_TRACE 0
+
+/* Number of spin iterations before a mutex waiter sleeps, the waiter only
+ * spins while the owner runs on another CPU.
+ */
+#define KERNEL_MUTEX_SPIN_COUNT 512
+
+/* Number of spin iterations before a semaphore waiter sleeps */
+#define KERNEL_SEMAPHORE_SPIN_COUNT 128
+
+/* Number of spin iterations before a message queue sender or receiver
+ * sleeps
+ */
+#define KERNEL_MQUEUE_SPIN_COUNT 128
+
+/* Set to 1 to use the x2APIC mode of the local APICs when supported */
+#define LAPIC_X2APIC_ENABLED 1
+
+/* Number of deferred works run on interrupt exit, the others are run by the
+ * CPU worker thread with interrupts enabled
+ */
+#define KERNEL_SOFTIRQ_EXIT_BUDGET 4
+
+/* CPUs reserved to the poll drivers loops at boot, one bit per CPU. The
+ * reserved CPUs do not run threads, the BSP cannot be reserved.
+ */
+#define POLL_DRIVER_CPU_MASK 0x0
+
+/* Number of device queues a poll loop can serve */
+#define POLL_DRIVER_MAX_QUEUES 16
+
+/* CPUs isolated at boot, one bit per CPU. The isolated CPUs only run the
+ * threads pinned on them, take no part in the load balancing and hand their
+ * deferred works to the other CPUs. The BSP cannot be isolated.
+ */
+#define SCHED_ISOLATED_CPU_MASK 0x0
+
+/* Percentage of each CPU the deadline threads can reserve, the rest is left
+ * to the fixed priority threads
+ */
+#define SCHED_DEADLINE_MAX_BANDWIDTH 95
+
+/* Set to 1 to make the idle isolated CPUs poll their wake flag instead of
+ * waiting in a C-state, their wakeup takes a few cycles.
+ */
+#define IDLE_POLL_ISOLATED_CPUS 1
+
+/* Virtual range private to each address space, PML4 entries 1 to 255. The
+ * range is aligned on the memory mapped by a root paging structure entry, the
+ * other root entries are shared with the kernel address space and the first
+ * one holds the boot identity mapping.
+ * WARNING This value should be updated to fit the boot paging structures
+ */
+#define KERNEL_USER_SPACE_START 0x0000008000000000
+#define KERNEL_USER_SPACE_END   0x0000800000000000
+
+/* Size of the user threads stack, at the top of the user range below a guard
+ * page. Its pages are zero filled on first touch.
+ */
+#define KERNEL_USER_STACK_SIZE 0x100000
+
 /* Defines the limit address allocable by the kernel */
 #define KERNEL_VIRTUAL_ADDR_MAX      0xFFFFFFFFFFFFFFFF
 #define KERNEL_VIRTUAL_ADDR_MAX_MASK 0xFFFFFFFFFFFFFFFF
@@ -82,28 +216,50 @@
  * Set to 1 to enable debug output for a specific module
  ******************************************************************************/
 #define ACPI_DEBUG_ENABLED 0
+#define CONSOLE_DRAIN_DEBUG_ENABLED 0
 #define CPU_DEBUG_ENABLED 0
 #define EXCEPTIONS_DEBUG_ENABLED 0
+#define IDLE_DEBUG_ENABLED 0
 #define INTERRUPTS_DEBUG_ENABLED 0
 #define IOAPIC_DEBUG_ENABLED 0
+#define IORING_DEBUG_ENABLED 0
+#define IPI_DEBUG_ENABLED 0
+#define IRQ_POLL_DEBUG_ENABLED 0
 #define KHEAP_DEBUG_ENABLED 0
 #define KICKSTART_DEBUG_ENABLED 0
+#define KSTACK_DEBUG_ENABLED 0
+#define KVM_DEBUG_ENABLED 0
 #define LAPIC_DEBUG_ENABLED 0
 #define MEMMGT_DEBUG_ENABLED 0
+#define PCI_DEBUG_ENABLED 0
+#define PERCPU_DEBUG_ENABLED 0
 #define PIC_DEBUG_ENABLED 0
 #define PIT_DEBUG_ENABLED 0
+#define POLL_DRIVER_DEBUG_ENABLED 0
 #define QUEUE_DEBUG_ENABLED 0
 #define KQUEUE_DEBUG_ENABLED 0
+#define RCU_DEBUG_ENABLED 0
 #define RTC_DEBUG_ENABLED 0
 #define SCHED_DEBUG_ENABLED 0
 #define SCHED_ELECT_DEBUG_ENABLED 0
 #define SCHED_SWITCH_DEBUG_ENABLED 0
 #define SERIAL_DEBUG_ENABLED 0
+#define SOFTIRQ_DEBUG_ENABLED 0
 #define TIME_MGT_DEBUG_ENABLED 0
+#define TOPOLOGY_DEBUG_ENABLED 0
+#define PROFILER_DEBUG_ENABLED 0
+#define TRACE_DRAIN_DEBUG_ENABLED 0
+#define VIRTIO_DEBUG_ENABLED 0
 #define VGA_DEBUG_ENABLED 0
+#define VMM_DEBUG_ENABLED 0
 #define SYSCALL_DEBUG_ENABLED 0
 #define INITRD_DEBUG_ENABLED 0
 #define USTAR_DEBUG_ENABLED 0
+#define BCACHE_DEBUG_ENABLED 0
+#define VFS_DEBUG_ENABLED 0
+#define ELF_DEBUG_ENABLED 0
+#define KTASK_DEBUG_ENABLED 0
+#define INITCALL_DEBUG_ENABLED 0
 #define MUTEX_DEBUG_ENABLED 0
 #define TEMP_DEBUG_ENABLED 0
 #define USER_HEAP_DEBUG_ENABLED 0
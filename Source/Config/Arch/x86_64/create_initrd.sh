@@ -4,12 +4,34 @@ echo -e "\e[1m\e[34m\n#---------------------------------------------------------
 echo -e "\e[1m\e[34m| Creating init ram disk for architecture x86_64\e[22m\e[39m"
 echo -e "\e[1m\e[34m#-------------------------------------------------------------------------------\n\e[22m\e[39m"
 
-# Create tar file
+# Create tar file, the regular files data starts on a page of the module: the
+# ELF loader maps the programs pages in place
 echo "Creating TAR with files:"
 curr_dir=$(pwd)
+tar_file=$curr_dir/$1/initrd.tar
+pad_dir=$(mktemp -d)
 cd $1/../Config/Arch/x86_64/initrd/
 chmod -R 0777 *
-tar --sort=name -cvf $curr_dir/$1/initrd.tar *
+tar --format=ustar -b1 -cf $tar_file --files-from /dev/null
+find * | LC_ALL=C sort | while read -r entry
+do
+    if [ -f "$entry" ]
+    then
+        # The archive ends with two empty blocks, the next header replaces them
+        blocks=$(( $(wc -c < $tar_file) / 512 - 2 ))
+
+        # The data follows its header and the 512 bytes master block, a
+        # padding entry takes a header and pad - 1 data blocks
+        pad=$(( (14 - $blocks % 8) % 8 ))
+        if [ $pad -ne 0 ]
+        then
+            head -c $(( ($pad - 1) * 512 )) /dev/zero > $pad_dir/.initrd_pad
+            tar --format=ustar -b1 -rf $tar_file -C $pad_dir .initrd_pad
+        fi
+    fi
+    tar --format=ustar -b1 --no-recursion -rvf $tar_file "$entry"
+done
+rm -rf $pad_dir
 cd $curr_dir
 
 filesize=$(wc -c < "$1/initrd.tar")
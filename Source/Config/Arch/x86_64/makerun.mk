@@ -9,8 +9,20 @@
 # virtualbox.
 ################################################################################
 
+# Number of CPUs of the virtual machine
+QEMU_SMP ?= 4
+
+# Set to 1 to attach a virtio console and a virtio network card
+QEMU_VIRTIO ?= 0
+
 QEMUOPTS = -cpu Nehalem -d guest_errors -rtc base=localtime -m 256M \
-           -smp 4 -serial stdio
+           -smp $(QEMU_SMP) -serial stdio
+
+ifeq ($(QEMU_VIRTIO), 1)
+QEMUOPTS += -chardev file,id=vcon,path=virtio_console.log \
+            -device virtio-serial-pci -device virtconsole,chardev=vcon \
+            -netdev user,id=vnet -device virtio-net-pci,netdev=vnet
+endif
 
 QEMU = qemu-system-x86_64
 
@@ -23,7 +35,7 @@ pre-run:
 	$(RM) -f ./$(BUILD_DIR)/utk_boot.iso
 	cp -R Config/Arch/x86_64/GRUB ./$(BUILD_DIR)/
 	cp ./$(BUILD_DIR)/$(KERNEL).elf ./$(BUILD_DIR)/GRUB/boot/
-#cp ./$(BUILD_DIR)/utk.initrd ./$(BUILD_DIR)/GRUB/boot/
+	cp ./$(BUILD_DIR)/utk.initrd ./$(BUILD_DIR)/GRUB/boot/
 	grub-mkrescue -o ./$(BUILD_DIR)/utk_boot.iso ./$(BUILD_DIR)/GRUB 2>&1 /dev/null
 
 run: pre-run
@@ -13,6 +13,7 @@ CC = gcc
 AS = nasm
 LD = ld
 OBJCOPY = objcopy
+NM = nm
 
 LINKER_FILE = ../../Config/Arch/x86_i386/linker.ld
 
@@ -22,7 +23,8 @@ EXTRA_FLAGS = -O3 -g
 CFLAGS = -m32 -std=c11 -nostdinc -fno-builtin -nostdlib -fno-stack-protector \
          -nostartfiles -nodefaultlibs -Wall -Wextra -Werror -c -fno-pie \
 		 -no-pie -MD -ffreestanding -Wno-address-of-packed-member \
-		 -fno-omit-frame-pointer -Wmissing-prototypes
+		 -fno-omit-frame-pointer -Wmissing-prototypes -mno-mmx -mno-sse \
+		 -mno-sse2
 
 TESTS_FLAGS = -D_TESTING_FRAMEWORK_ENABLED
 
@@ -31,14 +33,62 @@ CFLAGS += $(TESTS_FLAGS)
 endif
 
 ifeq ($(DEBUG), TRUE)
-CFLAGS += $(DEBUG_FLAGS)
+OPT_FLAGS = $(DEBUG_FLAGS)
+BUILD_MODE = debug
 else
-CFLAGS += $(EXTRA_FLAGS)
+OPT_FLAGS = $(EXTRA_FLAGS)
+BUILD_MODE = release
 endif
+CFLAGS += $(OPT_FLAGS)
 
 ifeq ($(TRACE), TRUE)
 CFLAGS += -D_TRACING_ENABLED
 endif
 
 ASFLAGS = -g -f elf -w+gnu-elf-extensions -F dwarf
-LDFLAGS = -T $(LINKER_FILE) -melf_i386 -no-pie
\ No newline at end of file
+LDFLAGS = -T $(LINKER_FILE) -melf_i386 -no-pie
+LD_MAP  = -Map=
+
+# Source tree base, the profiles are named after the objects paths in the tree
+TREE_DIR := $(abspath $(dir $(lastword $(MAKEFILE_LIST)))../..)
+
+# Kernel symbol table generator, the table is generated from a first link of
+# the kernel and linked in the KERNEL_SYM_TAB region of the final kernel
+SYMTAB_GEN = python3 $(TREE_DIR)/../Tools/SymTab/SymTabGen.py --nm $(NM)
+SYMTAB_OBJCOPY_FLAGS = -I binary -O elf32-i386 -B i386 \
+                       --rename-section .data=.kernel_symtab,alloc,load,readonly,data,contents
+
+# Link time optimization, the modules archives hold the compiler intermediate
+# representation and the kernel is linked by the compiler driver, which
+# inlines the hot helpers across the modules
+ifeq ($(LTO), TRUE)
+CFLAGS    += -flto
+AR         = gcc-ar
+LD         = $(CC)
+LDFLAGS    = -flto=auto $(OPT_FLAGS) -ffreestanding -nostdlib -static \
+             -no-pie -fno-omit-frame-pointer -m32 -mno-mmx -mno-sse -mno-sse2 \
+             -Wl,-T,$(LINKER_FILE)
+LD_MAP     = -Wl,-Map=
+BUILD_MODE := $(BUILD_MODE)-lto
+endif
+
+# Profile guided optimization, in two stages (see Tools/PGO): PGO=GEN builds
+# a kernel that outputs its arcs profile when the test framework ends, PGO=TRUE
+# builds with the profile collected in PGO_DIR. Only the arcs are profiled,
+# the profile runtime does not support the values profiling.
+PGO_DIR ?= $(TREE_DIR)/PGO/x86_i386
+
+PGO_FLAGS = -fprofile-prefix-path=$(TREE_DIR) -fno-profile-values
+
+ifeq ($(PGO), GEN)
+CFLAGS    += -fprofile-generate=$(PGO_DIR) -fprofile-update=prefer-atomic \
+             $(PGO_FLAGS) -D_PGO_GENERATE_ENABLED
+BUILD_MODE := $(BUILD_MODE)-pgogen
+else ifeq ($(PGO), TRUE)
+CFLAGS    += -fprofile-use=$(PGO_DIR) $(PGO_FLAGS) -Wno-missing-profile \
+             -Wno-coverage-mismatch
+BUILD_MODE := $(BUILD_MODE)-pgo
+endif
+
+# The build mode is given to the kernel and recorded in the build artifacts
+CFLAGS += -D_KERNEL_BUILD_MODE=\"$(BUILD_MODE)\"
\ No newline at end of file
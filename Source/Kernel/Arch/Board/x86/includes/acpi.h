@@ -0,0 +1,132 @@
+/*******************************************************************************
+ * @file acpi.h
+ *
+ * @see acpi.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief ACPI tables parser.
+ *
+ * @details ACPI tables parser. The parser finds the RSDP given by the
+ * bootloader or in the BIOS memory and walks the XSDT, or the RSDT on ACPI
+ * 1.0 machines. The MADT gives the CPUs and the IO-APICs, the SRAT and the
+ * SLIT give the NUMA nodes of the CPUs and of the memory and their
+ * distances, the HPET table gives the HPET registers address. The CPUs and
+ * the nodes are declared to the kernel topology map and the memory ranges
+ * to the physical memory manager. The tables are identity mapped while they
+ * are parsed, the results are kept by the parser.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __X86_ACPI_H_
+#define __X86_ACPI_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Maximal number of IO-APICs kept by the parser. */
+#define ACPI_MAX_IOAPIC_COUNT 8
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Parses the ACPI tables.
+ *
+ * @details Parses the MADT, SRAT, SLIT and HPET tables and fills the kernel
+ * topology map. The tables that are missing or corrupted are skipped. This
+ * function must be called once, after the virtual memory manager is
+ * initialized and before the APs are started.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if no RSDP is found.
+ * - OS_ERR_CORRUPTED_DATA is returned if the RSDP or the root table is
+ * corrupted.
+ * - Other error codes returned by the virtual memory manager when the root
+ * table cannot be mapped.
+ */
+OS_RETURN_E acpi_init(void);
+
+/**
+ * @brief Returns the number of IO-APICs given by the MADT.
+ *
+ * @return The number of IO-APICs, 0 if the MADT was not parsed.
+ */
+uint32_t acpi_get_ioapic_count(void);
+
+/**
+ * @brief Returns an IO-APIC given by the MADT.
+ *
+ * @param[in] index The index of the IO-APIC in the MADT order.
+ * @param[out] address The buffer receiving the IO-APIC registers physical
+ * address.
+ * @param[out] gsi_base The buffer receiving the first global system interrupt
+ * of the IO-APIC.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if a buffer is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if there is no IO-APIC at this index.
+ */
+OS_RETURN_E acpi_get_ioapic(const uint32_t index,
+                            uintptr_t* address,
+                            uint32_t* gsi_base);
+
+/**
+ * @brief Returns the HPET given by the HPET table.
+ *
+ * @param[out] address The buffer receiving the HPET registers physical
+ * address.
+ * @param[out] min_tick The buffer receiving the minimal periodic tick of the
+ * HPET, in main counter ticks.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if a buffer is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if the machine has no HPET table.
+ */
+OS_RETURN_E acpi_get_hpet(uint64_t* address, uint32_t* min_tick);
+
+#endif /* #ifndef __X86_ACPI_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,148 @@
+/*******************************************************************************
+ * @file ioapic.h
+ *
+ * @see ioapic.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief IO-APIC interrupt driver.
+ *
+ * @details IO-APIC interrupt driver. The IO-APIC pins are the IRQs 0 to 31,
+ * the ISA IRQs are identity mapped on the pins. The IRQs are acknowledged on
+ * the local APIC and can be routed to any CPU through their redirection
+ * entry. The IRQs following the pins are message signaled interrupts, their
+ * message is written in the device by its driver.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __X86_IOAPIC_H_
+#define __X86_IOAPIC_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>         /* Generic int types */
+#include <cpu_interrupt.h>  /* CPU interrupts settings */
+#include <interrupts.h>     /* Interrupt driver interface */
+#include <kerror.h>         /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief First IRQ number of the message signaled interrupts. */
+#define IOAPIC_MSI_IRQ_BASE (INT_MSI_IRQ_OFFSET - INT_IOAPIC_IRQ_OFFSET)
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the IO-APIC driver.
+ *
+ * @details Maps the IO-APIC, masks all its pins and routes them to the BSP.
+ * The legacy PICs are disabled. The IO-APIC is the one the MADT gives for the
+ * first global interrupts, the default one otherwise. This function must be
+ * called after lapic_init, vmm_init and acpi_init.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the local APIC is not enabled or no
+ * IO-APIC answers at its address.
+ * - Any error returned by vmm_map if the IO-APIC could not be mapped.
+ */
+OS_RETURN_E ioapic_init(void);
+
+/**
+ * @brief Returns the IO-APIC interrupt driver.
+ *
+ * @return A pointer to the IO-APIC interrupt driver.
+ */
+const interrupt_driver_t* ioapic_get_driver(void);
+
+/**
+ * @brief Allocates a message signaled interrupt.
+ *
+ * @param[out] irq_number The allocated IRQ number.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if irq_number is NULL.
+ * - OS_ERR_RESOURCE_BUSY is returned if all the message signaled interrupts
+ * are allocated.
+ */
+OS_RETURN_E ioapic_alloc_msi_irq(uint32_t* irq_number);
+
+/**
+ * @brief Releases a message signaled interrupt.
+ *
+ * @param[in] irq_number The IRQ number to release.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NO_SUCH_IRQ is returned if the IRQ is not an allocated message
+ * signaled interrupt.
+ */
+OS_RETURN_E ioapic_free_msi_irq(const uint32_t irq_number);
+
+/**
+ * @brief Returns the message of a message signaled interrupt.
+ *
+ * @details Returns the address and data the device must write to raise the
+ * IRQ on a CPU, the device driver writes them in the device MSI capability.
+ * The message is edge triggered with a fixed delivery.
+ *
+ * @param[in] irq_number The IRQ number.
+ * @param[in] cpu_id The identifier of the CPU receiving the IRQ.
+ * @param[out] address The message address.
+ * @param[out] data The message data.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if address or data is NULL.
+ * - OS_ERR_NO_SUCH_IRQ is returned if the IRQ is not a message signaled
+ * interrupt.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the CPU did not enable its
+ * local APIC.
+ * - OS_ERR_NOT_SUPPORTED is returned if the CPU local APIC identifier cannot
+ * be addressed by a message.
+ */
+OS_RETURN_E ioapic_get_msi_message(const uint32_t irq_number,
+                                   const uint32_t cpu_id,
+                                   uint64_t* address,
+                                   uint32_t* data);
+
+#endif /* #ifndef __X86_IOAPIC_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
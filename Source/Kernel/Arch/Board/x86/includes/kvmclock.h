@@ -0,0 +1,101 @@
+/*******************************************************************************
+ * @file kvmclock.h
+ *
+ * @see kvmclock.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief KVM paravirtual clock source driver.
+ *
+ * @details KVM paravirtual clock source driver. The hypervisor publishes the
+ * TSC scale and the system time in a structure registered by the boot CPU.
+ * Only the stable clock is used: the structure of the boot CPU is then valid
+ * on all the CPUs and the clock does not need a per-CPU structure.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __X86_KVMCLOCK_H_
+#define __X86_KVMCLOCK_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>   /* Generic int types */
+#include <kerror.h>   /* Kernel error codes */
+#include <time_mgt.h> /* Clock source interface */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the KVM clock.
+ *
+ * @details Registers the clock structure of the boot CPU and checks that the
+ * hypervisor marked the clock stable. Must be called on the boot CPU.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the hypervisor does not provide a
+ * stable KVM clock.
+ * - Any error returned by vmm_get_physical.
+ */
+OS_RETURN_E kvmclock_init(void);
+
+/**
+ * @brief Returns the TSC frequency published by the hypervisor.
+ *
+ * @return The TSC frequency in Hz, 0 if the KVM clock is not initialized.
+ */
+uint64_t kvmclock_get_tsc_frequency(void);
+
+/**
+ * @brief Returns the KVM clock source.
+ *
+ * @details Returns the KVM clock source, valid once kvmclock_init succeeded.
+ * The clock source counts nanoseconds.
+ *
+ * @return The KVM clock source.
+ */
+const kernel_clocksource_t* kvmclock_get_clocksource(void);
+
+#endif /* #ifndef __X86_KVMCLOCK_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,164 @@
+/*******************************************************************************
+ * @file lapic.h
+ *
+ * @see lapic.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Local APIC driver.
+ *
+ * @details Local APIC driver. The driver enables the local APIC of each CPU
+ * and gives access to its registers. When the CPU supports it, the local APIC
+ * is switched to the x2APIC mode: the registers are then accessed through
+ * MSRs, which makes the end of interrupt a single non serializing write.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __X86_LAPIC_H_
+#define __X86_LAPIC_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Local APIC registers base address, identity mapped. */
+#define LAPIC_BASE_ADDR 0xFEE00000
+
+/** @brief Local APIC identifier register. */
+#define LAPIC_ID                  0x020
+/** @brief Local APIC task priority register. */
+#define LAPIC_TPR                 0x080
+/** @brief Local APIC end of interrupt register. */
+#define LAPIC_EOI                 0x0B0
+/** @brief Local APIC spurious interrupt vector register. */
+#define LAPIC_SVR                 0x0F0
+/** @brief Local APIC LVT timer register. */
+#define LAPIC_LVT_TIMER           0x320
+/** @brief Local APIC performance counter LVT register. */
+#define LAPIC_LVT_PERF            0x340
+/** @brief Local APIC timer initial count register. */
+#define LAPIC_TIMER_INIT_COUNT    0x380
+/** @brief Local APIC timer current count register. */
+#define LAPIC_TIMER_CURRENT_COUNT 0x390
+/** @brief Local APIC timer divide configuration register. */
+#define LAPIC_TIMER_DIVIDE        0x3E0
+
+/** @brief Local APIC software enable flag in the SVR. */
+#define LAPIC_SVR_ENABLE 0x00000100
+/** @brief Local APIC LVT masked flag. */
+#define LAPIC_LVT_MASKED 0x00010000
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the local APIC driver.
+ *
+ * @details Initializes the local APIC driver and enables the BSP local APIC.
+ * The x2APIC mode is enabled when the CPU supports it and LAPIC_X2APIC_ENABLED
+ * is set. The local APIC spurious interrupt handler is registered. This
+ * function must be called on the BSP with interrupts disabled, after the
+ * interrupt manager was initialized.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the CPU has no local APIC or if the
+ * local APIC is not at the address mapped by the boot code.
+ */
+OS_RETURN_E lapic_init(void);
+
+/**
+ * @brief Enables the local APIC of the calling CPU.
+ *
+ * @details Enables the local APIC of the calling AP in the mode selected by
+ * the BSP and records its identifier. This function does nothing if the
+ * driver could not be initialized.
+ *
+ * @param[in] cpu_id The identifier of the calling CPU.
+ */
+void lapic_init_local(const uint32_t cpu_id);
+
+/**
+ * @brief Tells if the local APIC driver is initialized.
+ *
+ * @return TRUE if the local APIC driver is initialized, FALSE otherwise.
+ */
+bool_t lapic_is_enabled(void);
+
+/**
+ * @brief Reads a local APIC register of the calling CPU.
+ *
+ * @param[in] reg The register offset.
+ *
+ * @return The register value.
+ */
+uint32_t lapic_read(const uint32_t reg);
+
+/**
+ * @brief Writes a local APIC register of the calling CPU.
+ *
+ * @param[in] reg The register offset.
+ * @param[in] value The value to write.
+ */
+void lapic_write(const uint32_t reg, const uint32_t value);
+
+/**
+ * @brief Signals the end of interrupt to the local APIC of the calling CPU.
+ */
+void lapic_eoi(void);
+
+/**
+ * @brief Returns the local APIC identifier of a CPU.
+ *
+ * @param[in] cpu_id The identifier of the CPU.
+ * @param[out] apic_id The local APIC identifier of the CPU.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if apic_id is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the CPU did not enable its
+ * local APIC.
+ */
+OS_RETURN_E lapic_get_apic_id(const uint32_t cpu_id, uint32_t* apic_id);
+
+#endif /* #ifndef __X86_LAPIC_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,106 @@
+/*******************************************************************************
+ * @file lapic_timer.h
+ *
+ * @see lapic_timer.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Local APIC timer driver.
+ *
+ * @details Local APIC timer driver. The driver provides the kernel's main
+ * timer: the time reference is the TSC, calibrated against the PIT, and each
+ * CPU gets a one-shot deadline from its local APIC timer. The TSC-deadline
+ * mode is used when the CPU supports it, otherwise the local APIC timer is
+ * used in one-shot mode with a calibrated count.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __X86_LAPIC_TIMER_H_
+#define __X86_LAPIC_TIMER_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>   /* Generic int types */
+#include <kerror.h>   /* Kernel error codes */
+#include <time_mgt.h> /* Kernel timer interface */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the local APIC timer driver.
+ *
+ * @details Initializes the local APIC timer driver on the BSP. The local
+ * APIC timer is calibrated against the PIT and the BSP local APIC timer is
+ * set, disarmed. The TSC-deadline mode needs the TSC to be calibrated first.
+ * This function must be called with interrupts disabled, after lapic_init,
+ * after the kernel's clock source is set and before the APs are started.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the local APIC is not enabled.
+ */
+OS_RETURN_E lapic_timer_init(void);
+
+/**
+ * @brief Initializes the local APIC timer of the calling CPU.
+ *
+ * @details Initializes the local APIC timer of the calling AP with the
+ * calibration done by the BSP. The timer is disarmed. This function must be
+ * called after lapic_init_local and does nothing if the driver could not be
+ * initialized.
+ */
+void lapic_timer_init_local(void);
+
+/**
+ * @brief Returns the local APIC timer driver.
+ *
+ * @details Returns a constant handle to the local APIC timer driver, to be
+ * used as the kernel's main timer.
+ *
+ * @return A constant handle to the local APIC timer driver.
+ */
+const kernel_timer_t* lapic_timer_get_driver(void);
+
+#endif /* #ifndef __X86_LAPIC_TIMER_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,235 @@
+/*******************************************************************************
+ * @file pci.h
+ *
+ * @see pci.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief PCI bus driver.
+ *
+ * @details PCI bus driver. The configuration space is accessed with the
+ * configuration mechanism 1 ports. The memory BARs are mapped at their
+ * physical address, uncached. Only MSI-X is supported for the device
+ * interrupts, the IRQs are given by the IO-APIC driver.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __X86_PCI_H_
+#define __X86_PCI_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Vendor specific capability identifier. */
+#define PCI_CAP_ID_VENDOR 0x09
+/** @brief MSI-X capability identifier. */
+#define PCI_CAP_ID_MSIX   0x11
+
+/** @brief Number of BARs of a device. */
+#define PCI_BAR_COUNT 6
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief PCI device function. */
+typedef struct
+{
+    /** @brief The bus number. */
+    uint8_t bus;
+
+    /** @brief The device number on the bus. */
+    uint8_t device;
+
+    /** @brief The function number of the device. */
+    uint8_t function;
+
+    /** @brief The vendor identifier. */
+    uint16_t vendor_id;
+
+    /** @brief The device identifier. */
+    uint16_t device_id;
+} pci_device_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Finds a PCI device.
+ *
+ * @details Scans the PCI buses for the first function with the given vendor
+ * and device identifiers.
+ *
+ * @param[in] vendor_id The vendor identifier.
+ * @param[in] device_id The device identifier.
+ * @param[out] device The device found.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if device is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if no such device is present.
+ */
+OS_RETURN_E pci_find_device(const uint16_t vendor_id,
+                            const uint16_t device_id,
+                            pci_device_t* device);
+
+/**
+ * @brief Reads a byte of a device configuration space.
+ *
+ * @param[in] device The device.
+ * @param[in] offset The offset in the configuration space.
+ *
+ * @return The value read.
+ */
+uint8_t pci_read_config_8(const pci_device_t* device, const uint8_t offset);
+
+/**
+ * @brief Reads a half word of a device configuration space.
+ *
+ * @param[in] device The device.
+ * @param[in] offset The offset in the configuration space, 2 bytes aligned.
+ *
+ * @return The value read.
+ */
+uint16_t pci_read_config_16(const pci_device_t* device, const uint8_t offset);
+
+/**
+ * @brief Reads a word of a device configuration space.
+ *
+ * @param[in] device The device.
+ * @param[in] offset The offset in the configuration space, 4 bytes aligned.
+ *
+ * @return The value read.
+ */
+uint32_t pci_read_config_32(const pci_device_t* device, const uint8_t offset);
+
+/**
+ * @brief Writes a half word of a device configuration space.
+ *
+ * @param[in] device The device.
+ * @param[in] offset The offset in the configuration space, 2 bytes aligned.
+ * @param[in] value The value to write.
+ */
+void pci_write_config_16(const pci_device_t* device,
+                         const uint8_t offset,
+                         const uint16_t value);
+
+/**
+ * @brief Writes a word of a device configuration space.
+ *
+ * @param[in] device The device.
+ * @param[in] offset The offset in the configuration space, 4 bytes aligned.
+ * @param[in] value The value to write.
+ */
+void pci_write_config_32(const pci_device_t* device,
+                         const uint8_t offset,
+                         const uint32_t value);
+
+/**
+ * @brief Finds a capability of a device.
+ *
+ * @param[in] device The device.
+ * @param[in] cap_id The capability identifier.
+ * @param[in] previous The offset of the previous capability found, 0 to
+ * search from the first capability.
+ *
+ * @return The offset of the capability in the configuration space, 0 if the
+ * device has no more capability with this identifier.
+ */
+uint8_t pci_find_capability(const pci_device_t* device,
+                            const uint8_t cap_id,
+                            const uint8_t previous);
+
+/**
+ * @brief Maps a part of a memory BAR.
+ *
+ * @details Maps a range of a memory BAR at its physical address, uncached.
+ * The pages already mapped at their physical address are kept.
+ *
+ * @param[in] device The device.
+ * @param[in] bar The BAR index.
+ * @param[in] offset The offset of the range in the BAR.
+ * @param[in] size The size of the range.
+ * @param[out] address The address of the mapped range.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if device or address is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the BAR index is invalid.
+ * - OS_ERR_NOT_SUPPORTED is returned if the BAR is not a memory BAR or is not
+ * addressable by the kernel.
+ * - Any error returned by vmm_map.
+ */
+OS_RETURN_E pci_map_bar(const pci_device_t* device,
+                        const uint32_t bar,
+                        const uint32_t offset,
+                        const size_t size,
+                        volatile void** address);
+
+/**
+ * @brief Enables the memory decoding and bus mastering of a device.
+ *
+ * @details Enables the memory space decoding and the bus mastering of a
+ * device, its legacy interrupt is disabled.
+ *
+ * @param[in] device The device.
+ */
+void pci_enable_device(const pci_device_t* device);
+
+/**
+ * @brief Programs an MSI-X table entry and enables MSI-X.
+ *
+ * @param[in] device The device.
+ * @param[in] entry The table entry index.
+ * @param[in] address The message address.
+ * @param[in] data The message data.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if device is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if the device has no MSI-X capability.
+ * - OS_ERR_OUT_OF_BOUND is returned if the entry is not in the table.
+ * - Any error returned by pci_map_bar.
+ */
+OS_RETURN_E pci_set_msix_entry(const pci_device_t* device,
+                               const uint32_t entry,
+                               const uint64_t address,
+                               const uint32_t data);
+
+#endif /* #ifndef __X86_PCI_H_ */
+
+/************************************ EOF *************************************/
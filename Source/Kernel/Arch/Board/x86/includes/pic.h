@@ -0,0 +1,91 @@
+/*******************************************************************************
+ * @file pic.h
+ *
+ * @see pic.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief 8259 PIC interrupt driver.
+ *
+ * @details 8259 PIC interrupt driver. The driver is the fallback interrupt
+ * driver of the systems without IO-APIC: the master and slave PICs are
+ * remapped after the exceptions and all the IRQs are delivered to the BSP.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __X86_PIC_H_
+#define __X86_PIC_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>     /* Generic int types */
+#include <interrupts.h> /* Interrupt driver interface */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the PIC driver.
+ *
+ * @details Remaps the master and slave PICs at INT_PIC_IRQ_OFFSET and masks
+ * all the IRQs but the cascade one.
+ */
+void pic_init(void);
+
+/**
+ * @brief Disables the PICs.
+ *
+ * @details Masks all the IRQs of the master and slave PICs, used when the
+ * IRQs are delivered by the IO-APIC.
+ */
+void pic_disable(void);
+
+/**
+ * @brief Returns the PIC interrupt driver.
+ *
+ * @return A pointer to the PIC interrupt driver.
+ */
+const interrupt_driver_t* pic_get_driver(void);
+
+#endif /* #ifndef __X86_PIC_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,102 @@
+/*******************************************************************************
+ * @file pit.h
+ *
+ * @see pit.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief PIT (Programmable Interval Timer) driver.
+ *
+ * @details PIT (Programmable Interval Timer) driver. The PIT channel 2 is used
+ * in one-shot mode as a calibrated delay source, mainly during the boot
+ * sequence to calibrate the other timers and to wait for the hardware. The
+ * delays are polled and do not rely on the PIT interrupt. The PIT channel 0
+ * gives the fallback clock source.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __X86_PIT_H_
+#define __X86_PIT_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>   /* Generic int types */
+#include <time_mgt.h> /* Clock source interface */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief PIT input clock frequency in Hz. */
+#define PIT_INPUT_FREQ 1193182
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Waits for the given delay using the PIT channel 2.
+ *
+ * @details Waits for the given delay by polling the output of the PIT channel
+ * 2 programmed in one-shot mode. The PC speaker is kept disabled. This
+ * function does not rely on interrupts and can be called with interrupts
+ * disabled. Only one CPU must use the PIT at a time.
+ *
+ * @param[in] delay_us The delay to wait, in microseconds.
+ */
+void pit_busy_wait(uint32_t delay_us);
+
+/**
+ * @brief Starts the PIT clock source.
+ *
+ * @details Starts the PIT channel 0 as a free running rate generator and
+ * initializes the PIT clock source. The channel 0 interrupt is not used.
+ */
+void pit_clock_init(void);
+
+/**
+ * @brief Returns the PIT clock source.
+ *
+ * @details Returns the PIT clock source, valid once pit_clock_init was
+ * called. The clock source must be read at least every 55ms, it sets its
+ * maximal idle time accordingly.
+ *
+ * @return The PIT clock source.
+ */
+const kernel_clocksource_t* pit_get_clocksource(void);
+
+#endif /* #ifndef __X86_PIT_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,94 @@
+/*******************************************************************************
+ * @file pmu.h
+ *
+ * @see pmu.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief x86 architectural performance monitoring unit driver.
+ *
+ * @details x86 architectural performance monitoring unit driver. The first
+ * general purpose counter counts the unhalted core cycles and raises a local
+ * APIC interrupt on overflow, it is used as the sampling source of the
+ * kernel profiler. The interrupt is a regular vector: the code running with
+ * interrupts disabled is sampled when it enables them again.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __X86_PMU_H_
+#define __X86_PMU_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>   /* Generic int types */
+#include <kerror.h>   /* Kernel error codes */
+#include <profiler.h> /* Profiler source interface */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the performance monitoring unit.
+ *
+ * @details Detects the architectural performance monitoring and registers
+ * the counter overflow interrupt handler. This function must be called after
+ * the local APIC and the TSC initialization.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the CPU has no usable cycles
+ *   counter, the TSC frequency is unknown or the local APIC is disabled.
+ */
+OS_RETURN_E pmu_init(void);
+
+/**
+ * @brief Returns the PMU profiler source.
+ *
+ * @details Returns the PMU profiler source, valid once pmu_init succeeded.
+ *
+ * @return The PMU profiler source.
+ */
+const profiler_source_t* pmu_get_profiler_source(void);
+
+#endif /* #ifndef __X86_PMU_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,99 @@
+/*******************************************************************************
+ * @file tsc.h
+ *
+ * @see tsc.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief TSC (Time Stamp Counter) clock source driver.
+ *
+ * @details TSC (Time Stamp Counter) clock source driver. The TSC frequency is
+ * calibrated against the PIT during the boot sequence. The TSC is only a
+ * reliable clock source when it is invariant, its rate is otherwise changed
+ * by the CPU power states.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __X86_TSC_H_
+#define __X86_TSC_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>   /* Generic int types */
+#include <kerror.h>   /* Kernel error codes */
+#include <time_mgt.h> /* Clock source interface */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the TSC clock source.
+ *
+ * @details Initializes the TSC clock source and calibrates the TSC frequency
+ * against the PIT. The calibration busy waits about 40ms. This function must
+ * be called on the BSP, after cpu_init and before the APs are started.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the CPU has no TSC.
+ */
+OS_RETURN_E tsc_init(void);
+
+/**
+ * @brief Returns the calibrated TSC frequency.
+ *
+ * @return The TSC frequency in Hz, 0 if the TSC is not initialized.
+ */
+uint64_t tsc_get_frequency(void);
+
+/**
+ * @brief Returns the TSC clock source.
+ *
+ * @details Returns the TSC clock source, valid once tsc_init succeeded.
+ *
+ * @return The TSC clock source.
+ */
+const kernel_clocksource_t* tsc_get_clocksource(void);
+
+#endif /* #ifndef __X86_TSC_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
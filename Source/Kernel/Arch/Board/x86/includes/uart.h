@@ -25,14 +25,32 @@
  * INCLUDES
  ******************************************************************************/
 
-#include <stdint.h>  /* Generic int types */
-#include <console.h> /* console driver manager */
+#include <stdint.h>      /* Generic int types */
+#include <console.h>     /* console driver manager */
+#include <trace_drain.h> /* Trace output driver */
+#include <ioring.h>      /* Asynchronous I/O rings */
 
 /*******************************************************************************
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Serial COM1 base port ID. */
+#define SERIAL_COM1_BASE 0x3F8
+/** @brief Serial COM2 base port ID. */
+#define SERIAL_COM2_BASE 0x2F8
+/** @brief Serial COM3 base port ID. */
+#define SERIAL_COM3_BASE 0x3E8
+/** @brief Serial COM4 base port ID. */
+#define SERIAL_COM4_BASE 0x2E8
+
+/** @brief Redefinition of serial COM1 base port ID for ease of use. */
+#define COM1 SERIAL_COM1_BASE
+/** @brief Redefinition of serial COM2 base port ID for ease of use. */
+#define COM2 SERIAL_COM2_BASE
+/** @brief Redefinition of serial COM3 base port ID for ease of use. */
+#define COM3 SERIAL_COM3_BASE
+/** @brief Redefinition of serial COM4 base port ID for ease of use. */
+#define COM4 SERIAL_COM4_BASE
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
@@ -77,7 +95,9 @@ void uart_init(void);
  * @brief Write the string given as patameter on the debug port.
  *
  * @details The function will output the data given as parameter on the debug
- * port. This call is blocking until the data has been sent to the uart port
+ * port. When the transmit interrupt is enabled, the string is copied to the
+ * transmit buffer and the call only blocks if the buffer is full. Otherwise
+ * this call is blocking until the data has been sent to the uart port
  * controler.
  *
  * @param[in] string The string to write to the uart port.
@@ -101,7 +121,8 @@ void uart_put_char(const char character);
  * @brief Tells if the data on the uart port are ready to be read.
  *
  * @details The function will returns 1 if a data was received by the uart
- * port referenced by the port given as parameter.
+ * port referenced by the port given as parameter. When the port receive
+ * interrupt is enabled, the receive buffer is checked instead of the port.
  *
  * @param[in] port The uart port on which the test should be executed.
  *
@@ -115,7 +136,9 @@ bool_t uart_received(const uint32_t port);
  *
  * @details The function will read the input data on the selected port. This
  * call is blocking until the data has been received by the uart port
- * controler.
+ * controler. When the port receive interrupt is enabled, the byte is read with
+ * uart_read_buffer and the calling thread waits for it, otherwise the port is
+ * polled.
  *
  * @param[in] port The port on which the data should be read.
  *
@@ -166,6 +189,113 @@ void uart_console_write_keyboard(const char* string, const size_t len);
  */
 const kernel_console_driver_t* uart_get_driver(void);
 
+/**
+ * @brief Writes a trace packet on the trace port.
+ *
+ * @details The function will output the buffer given as parameter on the trace
+ * port, COM2, without any translation. This call is blocking until the data
+ * has been sent to the uart port controler.
+ *
+ * @param[in] buffer The buffer to write to the uart port.
+ * @param[in] size The size of the buffer in bytes.
+ */
+void uart_trace_write(const void* buffer, const size_t size);
+
+/**
+ * @brief Returns the UART trace output driver.
+ *
+ * @details Returns a constant handle to the UART trace output driver, it
+ * streams the trace packets on COM2.
+ *
+ * @return A constant handle to the UART trace output driver is returned.
+ */
+const kernel_trace_output_t* uart_get_trace_output(void);
+
+/**
+ * @brief Drains the debug port output with its transmit interrupt.
+ *
+ * @details Attaches the debug port transmit interrupt handler. The output is
+ * then copied to a transmit buffer drained by the interrupt, the FIFO being
+ * filled at each interrupt. The input stays polled. This function must be
+ * called after the interrupt manager was initialized.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the interrupt driver does not provide
+ * the debug port IRQ, the output stays polled.
+ * - Any other error returned by the interrupt manager when attaching the
+ * handler.
+ */
+OS_RETURN_E uart_enable_tx_interrupt(void);
+
+/**
+ * @brief Reads the port input with its receive interrupt.
+ *
+ * @details Attaches the port interrupt handler and enables the receive
+ * interrupt. The received bytes are then stored in the port receive buffer
+ * until read by uart_read_buffer. Only COM1 and COM2 are supported. This
+ * function must be called after the interrupt manager was initialized.
+ *
+ * @param[in] port The port to read with its interrupt.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the port is not supported or if the
+ * interrupt driver does not provide the port IRQ, the input stays polled.
+ * - Any other error returned by the interrupt manager when attaching the
+ * handler.
+ */
+OS_RETURN_E uart_enable_rx_interrupt(const uint32_t port);
+
+/**
+ * @brief Reads the bytes received by a port.
+ *
+ * @details Copies up to size bytes from the port receive buffer. If the buffer
+ * is empty, the calling thread waits until the receive interrupt stores new
+ * bytes. Only one thread can wait on a port at a time.
+ *
+ * @param[in] port The port to read from.
+ * @param[out] buffer The buffer receiving the bytes.
+ * @param[in] size The size of the buffer in bytes.
+ * @param[out] read The number of bytes copied to the buffer.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if buffer or read is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if the receive interrupt of the port is
+ * not enabled.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if another thread already waits on
+ * the port or if the caller is an idle thread.
+ */
+OS_RETURN_E uart_read_buffer(const uint32_t port,
+                             uint8_t* buffer,
+                             const size_t size,
+                             size_t* read);
+
+/**
+ * @brief Switches the debug port output back to polling.
+ *
+ * @details Disables the debug port transmit interrupt and flushes the
+ * transmit buffer by polling. No lock is taken, this function is meant to be
+ * used in the panic context.
+ */
+void uart_disable_tx_interrupt(void);
+
+/**
+ * @brief Returns the asynchronous I/O target of a port.
+ *
+ * @details The reads complete from the receive interrupt once bytes are
+ * received, with the bytes available then. Only one read can be in flight on
+ * a port, the port readers and the read requests share the received bytes.
+ * The writes are synchronous and complete during their submission.
+ *
+ * @param[in] port The port of the target.
+ *
+ * @return The target of the port, NULL if the port does not support
+ * interrupts.
+ */
+ioring_target_t* uart_get_ioring_target(const uint32_t port);
+
 #endif /* #ifndef __X86_UART_H_ */
 
 /************************************ EOF *************************************/
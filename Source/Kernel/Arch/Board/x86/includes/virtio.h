@@ -0,0 +1,390 @@
+/*******************************************************************************
+ * @file virtio.h
+ *
+ * @see virtio.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Virtio PCI transport and split virtqueues.
+ *
+ * @details Virtio PCI transport and split virtqueues. The driver handles the
+ * modern virtio PCI devices: the configuration structures are found with the
+ * vendor capabilities and mapped from the device BARs. The virtqueues buffers
+ * are given to the device at their physical address, the data is never
+ * copied. When the device offers the event index feature, the device only
+ * interrupts and is only notified when the other side asked for it.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __X86_VIRTIO_H_
+#define __X86_VIRTIO_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+#include <pci.h>    /* PCI bus driver */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Network card device type. */
+#define VIRTIO_TYPE_NET     1
+/** @brief Console device type. */
+#define VIRTIO_TYPE_CONSOLE 3
+
+/** @brief Event index feature bit. */
+#define VIRTIO_F_EVENT_IDX 29
+/** @brief Version 1 feature bit, required by the driver. */
+#define VIRTIO_F_VERSION_1 32
+
+/**
+ * @brief Maximal size of a virtqueue. Each ring of a queue of this size fits
+ * in a page and is physically contiguous.
+ */
+#define VIRTIO_QUEUE_MAX_SIZE 128
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Virtqueue descriptor, shared with the device. */
+typedef struct
+{
+    /** @brief Buffer physical address. */
+    uint64_t address;
+
+    /** @brief Buffer size. */
+    uint32_t length;
+
+    /** @brief Descriptor flags. */
+    uint16_t flags;
+
+    /** @brief Next descriptor of the chain. */
+    uint16_t next;
+} virtq_desc_t;
+
+/** @brief Virtqueue available ring, written by the driver. */
+typedef struct
+{
+    /** @brief Ring flags. */
+    uint16_t flags;
+
+    /** @brief Next ring entry the driver writes. */
+    uint16_t index;
+
+    /** @brief Chains heads, followed by the used event index. */
+    uint16_t ring[];
+} virtq_avail_t;
+
+/** @brief Virtqueue used ring element. */
+typedef struct
+{
+    /** @brief Head of the used chain. */
+    uint32_t id;
+
+    /** @brief Number of bytes written by the device. */
+    uint32_t length;
+} virtq_used_elem_t;
+
+/** @brief Virtqueue used ring, written by the device. */
+typedef struct
+{
+    /** @brief Ring flags. */
+    uint16_t flags;
+
+    /** @brief Next ring entry the device writes. */
+    uint16_t index;
+
+    /** @brief Used chains, followed by the available event index. */
+    virtq_used_elem_t ring[];
+} virtq_used_t;
+
+/** @brief Virtio PCI device. */
+typedef struct
+{
+    /** @brief The PCI function of the device. */
+    pci_device_t pci;
+
+    /** @brief Common configuration structure. */
+    volatile void* common;
+
+    /** @brief Notification area. */
+    volatile void* notify;
+
+    /** @brief Notification offset multiplier. */
+    uint32_t notify_multiplier;
+
+    /** @brief Device specific configuration structure. */
+    volatile void* device_config;
+
+    /** @brief Negotiated features. */
+    uint64_t features;
+
+    /** @brief TRUE when the queues raise an IRQ. */
+    bool_t irq_enabled;
+
+    /** @brief Message signaled IRQ of the queues. */
+    uint32_t irq;
+} virtio_device_t;
+
+/**
+ * @brief Split virtqueue. The queue is not locked, the caller serializes the
+ * accesses to a queue.
+ */
+typedef struct
+{
+    /** @brief The device owning the queue. */
+    virtio_device_t* device;
+
+    /** @brief The queue index. */
+    uint16_t index;
+
+    /** @brief The number of descriptors. */
+    uint16_t size;
+
+    /** @brief Descriptors table. */
+    virtq_desc_t* desc;
+
+    /** @brief Available ring. */
+    virtq_avail_t* avail;
+
+    /** @brief Used ring. */
+    virtq_used_t* used;
+
+    /** @brief Queue notification register. */
+    volatile void* notify;
+
+    /** @brief Head of the free descriptors list. */
+    uint16_t free_head;
+
+    /** @brief Number of free descriptors. */
+    uint16_t free_count;
+
+    /** @brief Available index at the last notification of the device. */
+    uint16_t kicked_index;
+
+    /** @brief Next used ring entry to consume. */
+    uint16_t last_used;
+
+    /** @brief TRUE when the event index feature is negotiated. */
+    bool_t event_index;
+
+    /** @brief TRUE when the used buffers interrupts are requested. */
+    bool_t notify_enabled;
+
+    /** @brief Cookie of each chain, indexed by its head descriptor. */
+    void* cookies[VIRTIO_QUEUE_MAX_SIZE];
+} virtqueue_t;
+
+/** @brief Buffer given to a virtqueue. */
+typedef struct
+{
+    /** @brief Buffer virtual address, in mapped kernel memory. */
+    const void* address;
+
+    /** @brief Buffer size. */
+    size_t size;
+} virtio_buffer_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Probes and resets a virtio device.
+ *
+ * @details Finds the first virtio PCI device of a type, maps its
+ * configuration structures, resets it and negotiates its features. The
+ * VIRTIO_F_VERSION_1 feature is always requested. The queues do not raise
+ * any IRQ unless virtio_device_enable_irq is called before their
+ * initialization. Once the queues are initialized, the caller calls
+ * virtio_device_ready.
+ *
+ * @param[in] type The device type.
+ * @param[in] features The requested features, a mask of feature bits.
+ * @param[out] device The device to initialize.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if device is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if no modern device of this type is
+ * present or its features cannot be negotiated.
+ * - Any error returned by pci_map_bar.
+ */
+OS_RETURN_E virtio_device_init(const uint32_t type,
+                               const uint64_t features,
+                               virtio_device_t* device);
+
+/**
+ * @brief Allocates the IRQ of the device queues.
+ *
+ * @details Allocates a message signaled IRQ routed to the boot CPU and sets
+ * it in the first MSI-X entry of the device. The queues initialized
+ * afterwards raise this IRQ, the caller registers its handler.
+ *
+ * @param[in, out] device The device.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - Any error returned by the IO-APIC driver and pci_set_msix_entry.
+ */
+OS_RETURN_E virtio_device_enable_irq(virtio_device_t* device);
+
+/**
+ * @brief Starts a virtio device once its queues are initialized.
+ *
+ * @param[in] device The device.
+ */
+void virtio_device_ready(virtio_device_t* device);
+
+/**
+ * @brief Marks a virtio device as failed.
+ *
+ * @details Tells the device its driver gave up, the device stops using its
+ * queues.
+ *
+ * @param[in] device The device.
+ */
+void virtio_device_fail(virtio_device_t* device);
+
+/**
+ * @brief Reads the device specific configuration.
+ *
+ * @details Reads the device specific configuration, the read is retried
+ * until the device did not change its configuration during the read.
+ *
+ * @param[in] device The device.
+ * @param[in] offset The offset in the device configuration.
+ * @param[out] buffer The buffer receiving the configuration.
+ * @param[in] size The number of bytes to read.
+ */
+void virtio_read_device_config(virtio_device_t* device,
+                               const uint32_t offset,
+                               void* buffer,
+                               const size_t size);
+
+/**
+ * @brief Initializes a virtqueue of a device.
+ *
+ * @details Allocates the rings of a queue and gives them to the device. The
+ * used chains notifications of the queue are enabled.
+ *
+ * @param[in] device The device.
+ * @param[in] index The queue index.
+ * @param[out] queue The queue to initialize.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if device or queue is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if the queue does not exist or cannot
+ * raise the device IRQ.
+ * - OS_ERR_NO_MORE_MEMORY is returned if the rings cannot be allocated.
+ */
+OS_RETURN_E virtqueue_init(virtio_device_t* device,
+                           const uint16_t index,
+                           virtqueue_t* queue);
+
+/**
+ * @brief Adds a buffers chain to a virtqueue.
+ *
+ * @details Adds a chain of buffers to the available ring: the first buffers
+ * are read by the device, the last ones are written by the device. The
+ * buffers are split on their physical pages, the data is not copied and must
+ * stay valid until the chain is returned by virtqueue_get_used. The device is
+ * not notified before virtqueue_kick is called.
+ *
+ * @param[in, out] queue The queue.
+ * @param[in] buffers The buffers of the chain.
+ * @param[in] out_count The number of buffers read by the device.
+ * @param[in] in_count The number of buffers written by the device.
+ * @param[in] cookie The value returned with the used chain, not NULL.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if a parameter is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the chain is empty.
+ * - OS_ERR_NO_MORE_MEMORY is returned if the queue has not enough free
+ * descriptors.
+ * - OS_ERR_MEMORY_NOT_MAPPED is returned if a buffer is not mapped.
+ */
+OS_RETURN_E virtqueue_add(virtqueue_t* queue,
+                          const virtio_buffer_t* buffers,
+                          const uint32_t out_count,
+                          const uint32_t in_count,
+                          void* cookie);
+
+/**
+ * @brief Notifies the device of the new available chains.
+ *
+ * @details Notifies the device of the chains added since the last
+ * notification, unless the device asked not to be notified.
+ *
+ * @param[in, out] queue The queue.
+ */
+void virtqueue_kick(virtqueue_t* queue);
+
+/**
+ * @brief Returns the next chain used by the device.
+ *
+ * @details Returns the next chain used by the device and releases its
+ * descriptors.
+ *
+ * @param[in, out] queue The queue.
+ * @param[out] length The number of bytes written by the device, can be NULL.
+ *
+ * @return The cookie of the used chain, NULL if the device did not use any
+ * new chain.
+ */
+void* virtqueue_get_used(virtqueue_t* queue, uint32_t* length);
+
+/**
+ * @brief Asks the device not to interrupt for the used chains.
+ *
+ * @details The request is a hint, the device might still interrupt.
+ *
+ * @param[in, out] queue The queue.
+ */
+void virtqueue_disable_notify(virtqueue_t* queue);
+
+/**
+ * @brief Asks the device to interrupt for the next used chain.
+ *
+ * @param[in, out] queue The queue.
+ *
+ * @return TRUE if used chains are already pending: the device might not
+ * interrupt for them and the caller consumes them, FALSE otherwise.
+ */
+bool_t virtqueue_enable_notify(virtqueue_t* queue);
+
+#endif /* #ifndef __X86_VIRTIO_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,163 @@
+/*******************************************************************************
+ * @file virtio_console.h
+ *
+ * @see virtio_console.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Virtio console driver.
+ *
+ * @details Virtio console driver, using the first port of the device. The
+ * output buffers are given to the device without copy and the writers wait
+ * for the device to consume them: the transmit queue never interrupts. The
+ * input is polled.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __X86_VIRTIO_CONSOLE_H_
+#define __X86_VIRTIO_CONSOLE_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>      /* Generic int types */
+#include <stddef.h>      /* Standard definitions */
+#include <console.h>     /* Console driver manager */
+#include <trace_drain.h> /* Trace output driver */
+#include <ioring.h>      /* Asynchronous I/O rings */
+#include <kerror.h>      /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the virtio console.
+ *
+ * @details Initializes the first virtio console device and posts its receive
+ * buffers. The outputs are ignored until the device is initialized.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - Any error returned by virtio_device_init and virtqueue_init.
+ */
+OS_RETURN_E virtio_console_init(void);
+
+/**
+ * @brief Writes a string on the console.
+ *
+ * @details The string is given to the device and the call blocks until the
+ * device consumed it.
+ *
+ * @param[in] string The string to write.
+ *
+ * @warning string must be NULL terminated.
+ */
+void virtio_console_put_string(const char* string);
+
+/**
+ * @brief Writes a character on the console.
+ *
+ * @param[in] character The character to write.
+ */
+void virtio_console_put_char(const char character);
+
+/**
+ * @brief Clears the screen by printing 25 line feeds.
+ */
+void virtio_console_clear_screen(void);
+
+/**
+ * @brief Writes the keyboard echo on the console.
+ *
+ * @param[in] string The characters to write.
+ * @param[in] len The number of characters to write.
+ */
+void virtio_console_write_keyboard(const char* string, const size_t len);
+
+/**
+ * @brief Reads the pending input of the console.
+ *
+ * @details Copies the received bytes to the buffer without waiting for new
+ * input.
+ *
+ * @param[out] buffer The buffer receiving the input.
+ * @param[in] size The size of the buffer.
+ *
+ * @return The number of bytes read.
+ */
+size_t virtio_console_read(void* buffer, const size_t size);
+
+/**
+ * @brief Returns the virtio console driver.
+ *
+ * @return The virtio console driver.
+ */
+const kernel_console_driver_t* virtio_console_get_driver(void);
+
+/**
+ * @brief Writes a trace buffer on the console.
+ *
+ * @param[in] buffer The buffer to write.
+ * @param[in] size The size of the buffer.
+ */
+void virtio_console_trace_write(const void* buffer, const size_t size);
+
+/**
+ * @brief Returns the virtio console trace output driver.
+ *
+ * @return The virtio console trace output driver.
+ */
+const kernel_trace_output_t* virtio_console_get_trace_output(void);
+
+/**
+ * @brief Returns the asynchronous I/O target of the console.
+ *
+ * @details The input is polled: the reads complete from the poll of their
+ * ring, which must use IORING_FLAG_POLL. Only one read can be in flight. The
+ * writes complete during their submission.
+ *
+ * @return The target of the console.
+ */
+ioring_target_t* virtio_console_get_ioring_target(void);
+
+#endif /* #ifndef __X86_VIRTIO_CONSOLE_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * @file virtio_net.h
+ *
+ * @see virtio_net.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Virtio network card driver.
+ *
+ * @details Virtio network card driver. The sent frames are given to the
+ * device without copy and the received frames are handed to the receive
+ * handler in the buffer the device wrote. The device interrupt schedules the
+ * queues poll and the queues interrupts stay disabled while the poll runs.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __X86_VIRTIO_NET_H_
+#define __X86_VIRTIO_NET_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+#include <kbuf.h>   /* Chained data buffers */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Size of a MAC address. */
+#define VIRTIO_NET_MAC_SIZE 6
+
+/** @brief Maximal size of a frame, without its checksum. */
+#define VIRTIO_NET_MAX_FRAME_SIZE 1514
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/**
+ * @brief Receive handler, called by the poll for each received frame. The
+ * frame buffer is given back to the device when the handler returns.
+ */
+typedef void (*virtio_net_rx_handler_t)(const void* frame,
+                                        const size_t size,
+                                        void* args);
+
+/**
+ * @brief Transmit completion handler, called once the device consumed a
+ * frame. The handler is called with the transmit lock held and must not send.
+ */
+typedef void (*virtio_net_tx_done_t)(const void* frame, void* args);
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the virtio network card.
+ *
+ * @details Initializes the first virtio network card, posts its receive
+ * buffers and attaches its interrupt. The received frames are dropped until a
+ * receive handler is set.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NO_MORE_MEMORY is returned if the receive buffers cannot be
+ * allocated.
+ * - Any error returned by the virtio transport and the interrupt manager.
+ */
+OS_RETURN_E virtio_net_init(void);
+
+/**
+ * @brief Returns the MAC address of the network card.
+ *
+ * @param[out] mac The buffer receiving the MAC address.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if mac is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if the card is not initialized or does
+ * not provide its MAC address.
+ */
+OS_RETURN_E virtio_net_get_mac(uint8_t mac[VIRTIO_NET_MAC_SIZE]);
+
+/**
+ * @brief Sets the receive handler.
+ *
+ * @param[in] handler The receive handler, NULL to drop the received frames.
+ * @param[in] args The arguments given to the handler.
+ */
+void virtio_net_set_rx_handler(virtio_net_rx_handler_t handler, void* args);
+
+/**
+ * @brief Sends a frame.
+ *
+ * @details Gives the frame to the device without copy. The frame must stay
+ * valid until the completion handler is called, the completions are handled
+ * by the queues poll and the next sends.
+ *
+ * @param[in] frame The frame to send, in mapped kernel memory.
+ * @param[in] size The size of the frame.
+ * @param[in] done The completion handler, can be NULL.
+ * @param[in] args The arguments given to the completion handler.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if frame is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if the card is not initialized.
+ * - OS_ERR_OUT_OF_BOUND is returned if the size is 0 or larger than
+ * VIRTIO_NET_MAX_FRAME_SIZE.
+ * - OS_ERR_RESOURCE_BUSY is returned if the transmit queue is full.
+ * - Any error returned by virtqueue_add.
+ */
+OS_RETURN_E virtio_net_send(const void* frame,
+                            const size_t size,
+                            virtio_net_tx_done_t done,
+                            void* args);
+
+/**
+ * @brief Sends a chained buffer.
+ *
+ * @details Gives each segment of the buffer to the device as a descriptor,
+ * without copy. The buffer belongs to the driver once sent and is released
+ * when the device consumed it; it stays with the caller on error.
+ *
+ * @param[in] frame The frame to send.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if frame is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if the card is not initialized.
+ * - OS_ERR_OUT_OF_BOUND is returned if the frame is empty, larger than
+ * VIRTIO_NET_MAX_FRAME_SIZE or has more than 8 non-empty segments.
+ * - OS_ERR_RESOURCE_BUSY is returned if the transmit queue is full.
+ * - Any error returned by virtqueue_add.
+ */
+OS_RETURN_E virtio_net_send_kbuf(kbuf_t* frame);
+
+#endif /* #ifndef __X86_VIRTIO_NET_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,1067 @@
+/*******************************************************************************
+ * @file acpi.c
+ *
+ * @see acpi.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief ACPI tables parser.
+ *
+ * @details ACPI tables parser. Each table is first mapped for its header,
+ * then for its whole length once the header gives it. The pages that were
+ * not mapped before are unmapped once the table is parsed. The entries of
+ * the MADT and the SRAT are walked with their own length, the unknown entry
+ * types are skipped. The SLIT distances are only kept for the proximity
+ * domains that fit in the topology map, the domains declared after the last
+ * node are merged in the first node.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* memcmp */
+#include <lapic.h>          /* Local APIC address */
+#include <vmm.h>            /* Tables mapping */
+#include <memmgt.h>         /* Bootloader RSDP and memory nodes */
+#include <topology.h>       /* Kernel topology map */
+#include <kernel_output.h>  /* Kernel outputs */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <acpi.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module name */
+#define MODULE_NAME "X86 ACPI"
+
+/** @brief Largest table the parser maps, in pages. */
+#define ACPI_MAX_MAP_PAGES 16
+
+/** @brief Physical address of the EBDA segment in the BIOS data area. */
+#define ACPI_EBDA_SEGMENT_ADDR 0x40E
+/** @brief Number of bytes of the EBDA searched for the RSDP. */
+#define ACPI_EBDA_SEARCH_SIZE  0x400
+/** @brief Start of the BIOS read-only memory searched for the RSDP. */
+#define ACPI_BIOS_SEARCH_START 0xE0000
+/** @brief End of the BIOS read-only memory searched for the RSDP. */
+#define ACPI_BIOS_SEARCH_END   0x100000
+/** @brief Alignment of the RSDP in the BIOS memory. */
+#define ACPI_RSDP_ALIGN        16
+
+/** @brief Size of the ACPI 1.0 part of the RSDP. */
+#define ACPI_RSDP_V1_SIZE 20
+
+/** @brief MADT entry: processor local APIC. */
+#define ACPI_MADT_LAPIC          0
+/** @brief MADT entry: IO-APIC. */
+#define ACPI_MADT_IOAPIC         1
+/** @brief MADT entry: local APIC address override. */
+#define ACPI_MADT_LAPIC_OVERRIDE 5
+/** @brief MADT entry: processor local x2APIC. */
+#define ACPI_MADT_X2APIC         9
+
+/** @brief MADT local APIC flag: the processor is enabled. */
+#define ACPI_MADT_LAPIC_ENABLED        0x1
+/** @brief MADT local APIC flag: the processor can be enabled. */
+#define ACPI_MADT_LAPIC_ONLINE_CAPABLE 0x2
+
+/** @brief SRAT entry: processor local APIC affinity. */
+#define ACPI_SRAT_LAPIC  0
+/** @brief SRAT entry: memory affinity. */
+#define ACPI_SRAT_MEMORY 1
+/** @brief SRAT entry: processor local x2APIC affinity. */
+#define ACPI_SRAT_X2APIC 2
+
+/** @brief SRAT affinity flag: the entry is enabled. */
+#define ACPI_SRAT_ENABLED 0x1
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Root system description pointer. */
+typedef struct
+{
+    /** @brief "RSD PTR " signature. */
+    char signature[8];
+
+    /** @brief Checksum of the ACPI 1.0 part. */
+    uint8_t checksum;
+
+    /** @brief OEM identifier. */
+    char oem_id[6];
+
+    /** @brief Structure revision, 2 and above have the extended part. */
+    uint8_t revision;
+
+    /** @brief RSDT physical address. */
+    uint32_t rsdt_address;
+
+    /** @brief Size of the whole structure. */
+    uint32_t length;
+
+    /** @brief XSDT physical address. */
+    uint64_t xsdt_address;
+
+    /** @brief Checksum of the whole structure. */
+    uint8_t extended_checksum;
+
+    /** @brief Reserved. */
+    uint8_t reserved[3];
+} __attribute__((packed)) acpi_rsdp_t;
+
+/** @brief System description table header. */
+typedef struct
+{
+    /** @brief Table signature. */
+    char signature[4];
+
+    /** @brief Size of the table, header included. */
+    uint32_t length;
+
+    /** @brief Table revision. */
+    uint8_t revision;
+
+    /** @brief Checksum of the whole table. */
+    uint8_t checksum;
+
+    /** @brief OEM identifier. */
+    char oem_id[6];
+
+    /** @brief OEM table identifier. */
+    char oem_table_id[8];
+
+    /** @brief OEM revision. */
+    uint32_t oem_revision;
+
+    /** @brief Table creator identifier. */
+    uint32_t creator_id;
+
+    /** @brief Table creator revision. */
+    uint32_t creator_revision;
+} __attribute__((packed)) acpi_header_t;
+
+/** @brief Header of the MADT and SRAT entries. */
+typedef struct
+{
+    /** @brief Entry type. */
+    uint8_t type;
+
+    /** @brief Entry length. */
+    uint8_t length;
+} __attribute__((packed)) acpi_entry_t;
+
+/** @brief Multiple APIC description table. */
+typedef struct
+{
+    /** @brief Table header. */
+    acpi_header_t header;
+
+    /** @brief Local APICs physical address. */
+    uint32_t lapic_address;
+
+    /** @brief MADT flags. */
+    uint32_t flags;
+} __attribute__((packed)) acpi_madt_t;
+
+/** @brief MADT processor local APIC entry. */
+typedef struct
+{
+    /** @brief Entry header. */
+    acpi_entry_t header;
+
+    /** @brief ACPI processor identifier. */
+    uint8_t processor_id;
+
+    /** @brief Local APIC identifier. */
+    uint8_t apic_id;
+
+    /** @brief Processor flags. */
+    uint32_t flags;
+} __attribute__((packed)) acpi_madt_lapic_t;
+
+/** @brief MADT IO-APIC entry. */
+typedef struct
+{
+    /** @brief Entry header. */
+    acpi_entry_t header;
+
+    /** @brief IO-APIC identifier. */
+    uint8_t ioapic_id;
+
+    /** @brief Reserved. */
+    uint8_t reserved;
+
+    /** @brief IO-APIC registers physical address. */
+    uint32_t address;
+
+    /** @brief First global system interrupt of the IO-APIC. */
+    uint32_t gsi_base;
+} __attribute__((packed)) acpi_madt_ioapic_t;
+
+/** @brief MADT local APIC address override entry. */
+typedef struct
+{
+    /** @brief Entry header. */
+    acpi_entry_t header;
+
+    /** @brief Reserved. */
+    uint16_t reserved;
+
+    /** @brief Local APICs physical address. */
+    uint64_t address;
+} __attribute__((packed)) acpi_madt_lapic_override_t;
+
+/** @brief MADT processor local x2APIC entry. */
+typedef struct
+{
+    /** @brief Entry header. */
+    acpi_entry_t header;
+
+    /** @brief Reserved. */
+    uint16_t reserved;
+
+    /** @brief Local x2APIC identifier. */
+    uint32_t x2apic_id;
+
+    /** @brief Processor flags. */
+    uint32_t flags;
+
+    /** @brief ACPI processor UID. */
+    uint32_t processor_uid;
+} __attribute__((packed)) acpi_madt_x2apic_t;
+
+/** @brief System resource affinity table. */
+typedef struct
+{
+    /** @brief Table header. */
+    acpi_header_t header;
+
+    /** @brief Reserved. */
+    uint32_t reserved0;
+
+    /** @brief Reserved. */
+    uint64_t reserved1;
+} __attribute__((packed)) acpi_srat_t;
+
+/** @brief SRAT processor local APIC affinity entry. */
+typedef struct
+{
+    /** @brief Entry header. */
+    acpi_entry_t header;
+
+    /** @brief Bits 0 to 7 of the proximity domain. */
+    uint8_t domain_low;
+
+    /** @brief Local APIC identifier. */
+    uint8_t apic_id;
+
+    /** @brief Affinity flags. */
+    uint32_t flags;
+
+    /** @brief Local SAPIC EID. */
+    uint8_t sapic_eid;
+
+    /** @brief Bits 8 to 31 of the proximity domain. */
+    uint8_t domain_high[3];
+
+    /** @brief Clock domain. */
+    uint32_t clock_domain;
+} __attribute__((packed)) acpi_srat_lapic_t;
+
+/** @brief SRAT memory affinity entry. */
+typedef struct
+{
+    /** @brief Entry header. */
+    acpi_entry_t header;
+
+    /** @brief Proximity domain. */
+    uint32_t domain;
+
+    /** @brief Reserved. */
+    uint16_t reserved0;
+
+    /** @brief Range physical base address. */
+    uint64_t base_address;
+
+    /** @brief Range length. */
+    uint64_t length;
+
+    /** @brief Reserved. */
+    uint32_t reserved1;
+
+    /** @brief Affinity flags. */
+    uint32_t flags;
+
+    /** @brief Reserved. */
+    uint64_t reserved2;
+} __attribute__((packed)) acpi_srat_memory_t;
+
+/** @brief SRAT processor local x2APIC affinity entry. */
+typedef struct
+{
+    /** @brief Entry header. */
+    acpi_entry_t header;
+
+    /** @brief Reserved. */
+    uint16_t reserved0;
+
+    /** @brief Proximity domain. */
+    uint32_t domain;
+
+    /** @brief Local x2APIC identifier. */
+    uint32_t x2apic_id;
+
+    /** @brief Affinity flags. */
+    uint32_t flags;
+
+    /** @brief Clock domain. */
+    uint32_t clock_domain;
+
+    /** @brief Reserved. */
+    uint32_t reserved1;
+} __attribute__((packed)) acpi_srat_x2apic_t;
+
+/** @brief System locality distance information table. */
+typedef struct
+{
+    /** @brief Table header. */
+    acpi_header_t header;
+
+    /** @brief Number of localities, the matrix follows the field. */
+    uint64_t locality_count;
+} __attribute__((packed)) acpi_slit_t;
+
+/** @brief Generic address structure. */
+typedef struct
+{
+    /** @brief Address space identifier. */
+    uint8_t space_id;
+
+    /** @brief Register width in bits. */
+    uint8_t bit_width;
+
+    /** @brief Register offset in bits. */
+    uint8_t bit_offset;
+
+    /** @brief Access size. */
+    uint8_t access_size;
+
+    /** @brief Register address. */
+    uint64_t address;
+} __attribute__((packed)) acpi_address_t;
+
+/** @brief High precision event timer table. */
+typedef struct
+{
+    /** @brief Table header. */
+    acpi_header_t header;
+
+    /** @brief Event timer block identifier. */
+    uint32_t block_id;
+
+    /** @brief HPET registers address. */
+    acpi_address_t address;
+
+    /** @brief HPET sequence number. */
+    uint8_t hpet_number;
+
+    /** @brief Minimal periodic tick, in main counter ticks. */
+    uint16_t min_tick;
+
+    /** @brief Page protection and OEM attributes. */
+    uint8_t page_protection;
+} __attribute__((packed)) acpi_hpet_t;
+
+/** @brief Identity mapping of a table. */
+typedef struct
+{
+    /** @brief First mapped page. */
+    uintptr_t base;
+
+    /** @brief Number of mapped pages. */
+    uint32_t page_count;
+
+    /** @brief Pages mapped by the parser, one bit per page. */
+    uint32_t owned;
+} acpi_mapping_t;
+
+/** @brief IO-APIC given by the MADT. */
+typedef struct
+{
+    /** @brief IO-APIC registers physical address. */
+    uintptr_t address;
+
+    /** @brief First global system interrupt of the IO-APIC. */
+    uint32_t gsi_base;
+} acpi_ioapic_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief IO-APICs given by the MADT. */
+static acpi_ioapic_t acpi_ioapics[ACPI_MAX_IOAPIC_COUNT];
+
+/** @brief Number of IO-APICs given by the MADT. */
+static uint32_t acpi_ioapic_count = 0;
+
+/** @brief HPET registers physical address, 0 without HPET table. */
+static uint64_t acpi_hpet_address = 0;
+
+/** @brief HPET minimal periodic tick. */
+static uint32_t acpi_hpet_min_tick = 0;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Identity maps a physical range.
+ *
+ * @details Identity maps the pages of a physical range read-only, the pages
+ * already identity mapped are kept.
+ *
+ * @param[in] phys The physical address of the range.
+ * @param[in] size The size of the range.
+ * @param[out] mapping The buffer receiving the mapping.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_OUT_OF_BOUND is returned if the range is larger than
+ * ACPI_MAX_MAP_PAGES pages or is not addressable.
+ * - OS_ERR_MAPPING_ALREADY_EXISTS is returned if a page is mapped elsewhere.
+ * - Other error codes returned by the virtual memory manager.
+ */
+static OS_RETURN_E _acpi_map(const uint64_t phys,
+                             const size_t size,
+                             acpi_mapping_t* mapping);
+
+/**
+ * @brief Unmaps the pages mapped by _acpi_map.
+ *
+ * @param[in] mapping The mapping.
+ */
+static void _acpi_unmap(const acpi_mapping_t* mapping);
+
+/**
+ * @brief Tells if the bytes of a structure sum to zero.
+ *
+ * @param[in] data The structure.
+ * @param[in] size The size of the structure.
+ *
+ * @return TRUE if the checksum is valid, FALSE otherwise.
+ */
+static bool_t _acpi_checksum(const void* data, const size_t size);
+
+/**
+ * @brief Searches the RSDP in a low memory range.
+ *
+ * @param[in] start The physical start address of the range.
+ * @param[in] end The physical end address of the range, excluded.
+ *
+ * @return The RSDP through the kernel high mapping, NULL if not found.
+ */
+static const acpi_rsdp_t* _acpi_search_rsdp(const uintptr_t start,
+                                            const uintptr_t end);
+
+/**
+ * @brief Returns the RSDP.
+ *
+ * @details Returns the RSDP copy given by the bootloader, or the RSDP found
+ * in the EBDA or the BIOS read-only memory.
+ *
+ * @return The RSDP, NULL if not found.
+ */
+static const acpi_rsdp_t* _acpi_get_rsdp(void);
+
+/**
+ * @brief Returns the node of a proximity domain.
+ *
+ * @param[in] domain The proximity domain.
+ *
+ * @return The node of the domain, the first node when the topology map is
+ * full.
+ */
+static uint32_t _acpi_get_node(const uint32_t domain);
+
+/**
+ * @brief Parses the MADT.
+ *
+ * @param[in] madt The mapped table.
+ */
+static void _acpi_parse_madt(const acpi_madt_t* madt);
+
+/**
+ * @brief Parses the SRAT.
+ *
+ * @param[in] srat The mapped table.
+ */
+static void _acpi_parse_srat(const acpi_srat_t* srat);
+
+/**
+ * @brief Parses the SLIT.
+ *
+ * @param[in] slit The mapped table.
+ */
+static void _acpi_parse_slit(const acpi_slit_t* slit);
+
+/**
+ * @brief Parses the HPET table.
+ *
+ * @param[in] hpet The mapped table.
+ */
+static void _acpi_parse_hpet(const acpi_hpet_t* hpet);
+
+/**
+ * @brief Maps and parses a table given by the root table.
+ *
+ * @details Maps a table, checks its checksum and parses it when the parser
+ * knows its signature.
+ *
+ * @param[in] phys The physical address of the table.
+ */
+static void _acpi_parse_table(const uint64_t phys);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static OS_RETURN_E _acpi_map(const uint64_t phys,
+                             const size_t size,
+                             acpi_mapping_t* mapping)
+{
+    OS_RETURN_E err;
+    uintptr_t   page;
+    uintptr_t   mapped;
+    uint64_t    end;
+    uint32_t    i;
+
+    end = phys + size;
+    if(size == 0 || end < phys || end - 1 > (uintptr_t)~(uintptr_t)0)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    mapping->base       = (uintptr_t)phys & ~(uintptr_t)(VMM_PAGE_SIZE - 1);
+    mapping->page_count = (uint32_t)((end - mapping->base + VMM_PAGE_SIZE - 1) /
+                                     VMM_PAGE_SIZE);
+    mapping->owned      = 0;
+    if(mapping->page_count > ACPI_MAX_MAP_PAGES)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    for(i = 0; i < mapping->page_count; ++i)
+    {
+        page = mapping->base + i * VMM_PAGE_SIZE;
+
+        /* The low memory is already identity mapped by the boot code */
+        err = vmm_get_physical(page, &mapped);
+        if(err == OS_ERR_MEMORY_NOT_MAPPED)
+        {
+            err = vmm_map(page, page, VMM_PAGE_SIZE, 0);
+            if(err == OS_NO_ERR)
+            {
+                mapping->owned |= 1U << i;
+            }
+        }
+        else if(err == OS_NO_ERR && mapped != page)
+        {
+            err = OS_ERR_MAPPING_ALREADY_EXISTS;
+        }
+
+        if(err != OS_NO_ERR)
+        {
+            _acpi_unmap(mapping);
+            return err;
+        }
+    }
+
+    return OS_NO_ERR;
+}
+
+static void _acpi_unmap(const acpi_mapping_t* mapping)
+{
+    uint32_t i;
+
+    for(i = 0; i < mapping->page_count; ++i)
+    {
+        if((mapping->owned & (1U << i)) != 0)
+        {
+            (void)vmm_unmap(mapping->base + i * VMM_PAGE_SIZE, VMM_PAGE_SIZE);
+        }
+    }
+}
+
+static bool_t _acpi_checksum(const void* data, const size_t size)
+{
+    const uint8_t* bytes;
+    uint8_t        sum;
+    size_t         i;
+
+    bytes = data;
+    sum   = 0;
+    for(i = 0; i < size; ++i)
+    {
+        sum += bytes[i];
+    }
+
+    return (sum == 0);
+}
+
+static const acpi_rsdp_t* _acpi_search_rsdp(const uintptr_t start,
+                                            const uintptr_t end)
+{
+    const acpi_rsdp_t* rsdp;
+    uintptr_t          addr;
+
+    for(addr = start; addr + ACPI_RSDP_V1_SIZE <= end;
+        addr += ACPI_RSDP_ALIGN)
+    {
+        rsdp = (const acpi_rsdp_t*)(addr + KERNEL_MEM_OFFSET);
+        if(memcmp(rsdp->signature, "RSD PTR ", 8) == 0 &&
+           _acpi_checksum(rsdp, ACPI_RSDP_V1_SIZE) == TRUE)
+        {
+            return rsdp;
+        }
+    }
+
+    return NULL;
+}
+
+static const acpi_rsdp_t* _acpi_get_rsdp(void)
+{
+    const void*        rsdp;
+    const acpi_rsdp_t* found;
+    uintptr_t          ebda;
+
+    if(memmgt_get_acpi_rsdp(&rsdp) == OS_NO_ERR)
+    {
+        return rsdp;
+    }
+
+    /* The legacy BIOS keeps the RSDP in the EBDA or its read-only memory */
+    ebda = (uintptr_t)*(const volatile uint16_t*)(ACPI_EBDA_SEGMENT_ADDR +
+                                                  KERNEL_MEM_OFFSET) << 4;
+    found = NULL;
+    if(ebda != 0 && ebda < ACPI_BIOS_SEARCH_START)
+    {
+        found = _acpi_search_rsdp(ebda, ebda + ACPI_EBDA_SEARCH_SIZE);
+    }
+    if(found == NULL)
+    {
+        found = _acpi_search_rsdp(ACPI_BIOS_SEARCH_START,
+                                  ACPI_BIOS_SEARCH_END);
+    }
+
+    return found;
+}
+
+static uint32_t _acpi_get_node(const uint32_t domain)
+{
+    uint32_t node;
+
+    if(topology_add_node(domain, &node) != OS_NO_ERR)
+    {
+        KERNEL_DEBUG(ACPI_DEBUG_ENABLED, MODULE_NAME,
+                     "Proximity domain %u merged in node 0", domain);
+        return 0;
+    }
+
+    return node;
+}
+
+static void _acpi_parse_madt(const acpi_madt_t* madt)
+{
+    const acpi_entry_t*               entry;
+    const acpi_madt_lapic_t*          lapic;
+    const acpi_madt_ioapic_t*         ioapic;
+    const acpi_madt_lapic_override_t* lapic_override;
+    const acpi_madt_x2apic_t*         x2apic;
+    uint64_t                          lapic_address;
+    uintptr_t                         end;
+
+    lapic_address = madt->lapic_address;
+    end           = (uintptr_t)madt + madt->header.length;
+    entry         = (const acpi_entry_t*)(madt + 1);
+    while((uintptr_t)(entry + 1) <= end && entry->length >= sizeof(*entry) &&
+          (uintptr_t)entry + entry->length <= end)
+    {
+        if(entry->type == ACPI_MADT_LAPIC &&
+           entry->length >= sizeof(acpi_madt_lapic_t))
+        {
+            lapic = (const acpi_madt_lapic_t*)entry;
+            if((lapic->flags & (ACPI_MADT_LAPIC_ENABLED |
+                                ACPI_MADT_LAPIC_ONLINE_CAPABLE)) != 0)
+            {
+                (void)topology_add_cpu(lapic->apic_id);
+            }
+        }
+        else if(entry->type == ACPI_MADT_X2APIC &&
+                entry->length >= sizeof(acpi_madt_x2apic_t))
+        {
+            /* The x2APIC identifiers above 255 cannot be started */
+            x2apic = (const acpi_madt_x2apic_t*)entry;
+            if((x2apic->flags & (ACPI_MADT_LAPIC_ENABLED |
+                                 ACPI_MADT_LAPIC_ONLINE_CAPABLE)) != 0 &&
+               topology_add_cpu(x2apic->x2apic_id) != OS_NO_ERR)
+            {
+                KERNEL_DEBUG(ACPI_DEBUG_ENABLED, MODULE_NAME,
+                             "Ignored x2APIC %u", x2apic->x2apic_id);
+            }
+        }
+        else if(entry->type == ACPI_MADT_IOAPIC &&
+                entry->length >= sizeof(acpi_madt_ioapic_t))
+        {
+            ioapic = (const acpi_madt_ioapic_t*)entry;
+            if(acpi_ioapic_count < ACPI_MAX_IOAPIC_COUNT)
+            {
+                acpi_ioapics[acpi_ioapic_count].address  = ioapic->address;
+                acpi_ioapics[acpi_ioapic_count].gsi_base = ioapic->gsi_base;
+                ++acpi_ioapic_count;
+            }
+
+            KERNEL_DEBUG(ACPI_DEBUG_ENABLED, MODULE_NAME,
+                         "IO-APIC %u at 0x%p, GSI base %u",
+                         ioapic->ioapic_id, (uintptr_t)ioapic->address,
+                         ioapic->gsi_base);
+        }
+        else if(entry->type == ACPI_MADT_LAPIC_OVERRIDE &&
+                entry->length >= sizeof(acpi_madt_lapic_override_t))
+        {
+            lapic_override = (const acpi_madt_lapic_override_t*)entry;
+            lapic_address  = lapic_override->address;
+        }
+
+        entry = (const acpi_entry_t*)((uintptr_t)entry + entry->length);
+    }
+
+    /* The local APIC driver only supports the boot code mapping */
+    if(lapic_address != LAPIC_BASE_ADDR)
+    {
+        KERNEL_ERROR("MADT local APIC at 0x%p, expected 0x%p\n",
+                     (uintptr_t)lapic_address, (uintptr_t)LAPIC_BASE_ADDR);
+    }
+}
+
+static void _acpi_parse_srat(const acpi_srat_t* srat)
+{
+    const acpi_entry_t*       entry;
+    const acpi_srat_lapic_t*  lapic;
+    const acpi_srat_memory_t* memory;
+    const acpi_srat_x2apic_t* x2apic;
+    uintptr_t                 end;
+    uint32_t                  domain;
+    OS_RETURN_E               err;
+
+    end   = (uintptr_t)srat + srat->header.length;
+    entry = (const acpi_entry_t*)(srat + 1);
+    while((uintptr_t)(entry + 1) <= end && entry->length >= sizeof(*entry) &&
+          (uintptr_t)entry + entry->length <= end)
+    {
+        if(entry->type == ACPI_SRAT_LAPIC &&
+           entry->length >= sizeof(acpi_srat_lapic_t))
+        {
+            lapic = (const acpi_srat_lapic_t*)entry;
+            if((lapic->flags & ACPI_SRAT_ENABLED) != 0)
+            {
+                domain = lapic->domain_low |
+                         ((uint32_t)lapic->domain_high[0] << 8) |
+                         ((uint32_t)lapic->domain_high[1] << 16) |
+                         ((uint32_t)lapic->domain_high[2] << 24);
+                (void)topology_set_cpu_node(lapic->apic_id,
+                                            _acpi_get_node(domain));
+            }
+        }
+        else if(entry->type == ACPI_SRAT_X2APIC &&
+                entry->length >= sizeof(acpi_srat_x2apic_t))
+        {
+            x2apic = (const acpi_srat_x2apic_t*)entry;
+            if((x2apic->flags & ACPI_SRAT_ENABLED) != 0)
+            {
+                (void)topology_set_cpu_node(x2apic->x2apic_id,
+                                            _acpi_get_node(x2apic->domain));
+            }
+        }
+        else if(entry->type == ACPI_SRAT_MEMORY &&
+                entry->length >= sizeof(acpi_srat_memory_t))
+        {
+            memory = (const acpi_srat_memory_t*)entry;
+            if((memory->flags & ACPI_SRAT_ENABLED) != 0 &&
+               memory->length != 0 &&
+               memory->base_address + memory->length > memory->base_address)
+            {
+                err = memmgt_set_node_range(memory->base_address,
+                                            memory->base_address +
+                                            memory->length,
+                                            _acpi_get_node(memory->domain));
+                if(err != OS_NO_ERR)
+                {
+                    KERNEL_ERROR("Could not set the node of memory at 0x%p: "
+                                 "%d\n",
+                                 (uintptr_t)memory->base_address, err);
+                }
+            }
+        }
+
+        entry = (const acpi_entry_t*)((uintptr_t)entry + entry->length);
+    }
+}
+
+static void _acpi_parse_slit(const acpi_slit_t* slit)
+{
+    const uint8_t* distances;
+    uint64_t       count;
+    uint32_t       from;
+    uint32_t       to;
+    uint32_t       node_from;
+    uint32_t       node_to;
+
+    count = slit->locality_count;
+    if(count == 0 ||
+       count > (slit->header.length - sizeof(acpi_slit_t)) / count)
+    {
+        return;
+    }
+
+    /* The matrix is indexed by proximity domain */
+    distances = (const uint8_t*)(slit + 1);
+    for(from = 0; from < count; ++from)
+    {
+        for(to = 0; to < count; ++to)
+        {
+            if(topology_add_node(from, &node_from) != OS_NO_ERR ||
+               topology_add_node(to, &node_to) != OS_NO_ERR)
+            {
+                continue;
+            }
+            (void)topology_set_distance(node_from, node_to,
+                                        distances[from * count + to]);
+        }
+    }
+}
+
+static void _acpi_parse_hpet(const acpi_hpet_t* hpet)
+{
+    acpi_hpet_address  = hpet->address.address;
+    acpi_hpet_min_tick = hpet->min_tick;
+
+    KERNEL_DEBUG(ACPI_DEBUG_ENABLED, MODULE_NAME,
+                 "HPET at 0x%p, minimal tick %u",
+                 (uintptr_t)acpi_hpet_address, acpi_hpet_min_tick);
+}
+
+static void _acpi_parse_table(const uint64_t phys)
+{
+    const acpi_header_t* header;
+    acpi_mapping_t       mapping;
+    uint32_t             length;
+
+    if(_acpi_map(phys, sizeof(acpi_header_t), &mapping) != OS_NO_ERR)
+    {
+        return;
+    }
+    header = (const acpi_header_t*)(uintptr_t)phys;
+    length = header->length;
+    _acpi_unmap(&mapping);
+
+    if(length < sizeof(acpi_header_t) ||
+       _acpi_map(phys, length, &mapping) != OS_NO_ERR)
+    {
+        return;
+    }
+
+    if(_acpi_checksum(header, length) == FALSE)
+    {
+        KERNEL_ERROR("ACPI table %c%c%c%c corrupted\n",
+                     header->signature[0], header->signature[1],
+                     header->signature[2], header->signature[3]);
+    }
+    else if(memcmp(header->signature, "APIC", 4) == 0 &&
+            length >= sizeof(acpi_madt_t))
+    {
+        _acpi_parse_madt((const acpi_madt_t*)header);
+    }
+    else if(memcmp(header->signature, "SRAT", 4) == 0 &&
+            length >= sizeof(acpi_srat_t))
+    {
+        _acpi_parse_srat((const acpi_srat_t*)header);
+    }
+    else if(memcmp(header->signature, "SLIT", 4) == 0 &&
+            length >= sizeof(acpi_slit_t))
+    {
+        _acpi_parse_slit((const acpi_slit_t*)header);
+    }
+    else if(memcmp(header->signature, "HPET", 4) == 0 &&
+            length >= sizeof(acpi_hpet_t))
+    {
+        _acpi_parse_hpet((const acpi_hpet_t*)header);
+    }
+
+    _acpi_unmap(&mapping);
+}
+
+OS_RETURN_E acpi_init(void)
+{
+    const acpi_rsdp_t*   rsdp;
+    const acpi_header_t* root;
+    const uint8_t*       entries;
+    acpi_mapping_t       mapping;
+    uint64_t             root_phys;
+    uint64_t             table_phys;
+    uint32_t             entry_size;
+    uint32_t             length;
+    uint32_t             count;
+    uint32_t             i;
+    OS_RETURN_E          err;
+
+    rsdp = _acpi_get_rsdp();
+    if(rsdp == NULL)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    /* The XSDT replaces the RSDT from ACPI 2.0 */
+    if(rsdp->revision >= 2 && rsdp->xsdt_address != 0 &&
+       rsdp->length >= sizeof(acpi_rsdp_t) &&
+       _acpi_checksum(rsdp, rsdp->length) == TRUE)
+    {
+        root_phys  = rsdp->xsdt_address;
+        entry_size = sizeof(uint64_t);
+    }
+    else if(_acpi_checksum(rsdp, ACPI_RSDP_V1_SIZE) == TRUE)
+    {
+        root_phys  = rsdp->rsdt_address;
+        entry_size = sizeof(uint32_t);
+    }
+    else
+    {
+        return OS_ERR_CORRUPTED_DATA;
+    }
+
+    err = _acpi_map(root_phys, sizeof(acpi_header_t), &mapping);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+    root   = (const acpi_header_t*)(uintptr_t)root_phys;
+    length = root->length;
+    _acpi_unmap(&mapping);
+
+    if(length < sizeof(acpi_header_t))
+    {
+        return OS_ERR_CORRUPTED_DATA;
+    }
+    err = _acpi_map(root_phys, length, &mapping);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+    if(_acpi_checksum(root, length) == FALSE)
+    {
+        _acpi_unmap(&mapping);
+        return OS_ERR_CORRUPTED_DATA;
+    }
+
+    /* The entries are not aligned in the root table */
+    entries = (const uint8_t*)(root + 1);
+    count   = (length - sizeof(acpi_header_t)) / entry_size;
+    for(i = 0; i < count; ++i)
+    {
+        table_phys = 0;
+        memcpy(&table_phys, entries + i * entry_size, entry_size);
+        if(table_phys != 0)
+        {
+            _acpi_parse_table(table_phys);
+        }
+    }
+
+    _acpi_unmap(&mapping);
+
+    if(topology_get_cpu_count() > MAX_CPU_COUNT)
+    {
+        KERNEL_INFO("%u CPUs present, only %u are used\n",
+                    topology_get_cpu_count(), MAX_CPU_COUNT);
+    }
+
+    KERNEL_SUCCESS("ACPI parsed, %u CPUs, %u nodes, %u IO-APICs\n",
+                   topology_get_cpu_count(), topology_get_node_count(),
+                   acpi_ioapic_count);
+
+    return OS_NO_ERR;
+}
+
+uint32_t acpi_get_ioapic_count(void)
+{
+    return acpi_ioapic_count;
+}
+
+OS_RETURN_E acpi_get_ioapic(const uint32_t index,
+                            uintptr_t* address,
+                            uint32_t* gsi_base)
+{
+    if(address == NULL || gsi_base == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(index >= acpi_ioapic_count)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    *address  = acpi_ioapics[index].address;
+    *gsi_base = acpi_ioapics[index].gsi_base;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E acpi_get_hpet(uint64_t* address, uint32_t* min_tick)
+{
+    if(address == NULL || min_tick == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(acpi_hpet_address == 0)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    *address  = acpi_hpet_address;
+    *min_tick = acpi_hpet_min_tick;
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,499 @@
+/*******************************************************************************
+ * @file ioapic.c
+ *
+ * @see ioapic.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief IO-APIC interrupt driver.
+ *
+ * @details IO-APIC interrupt driver. The IO-APIC pins are the IRQs 0 to 31,
+ * the ISA IRQs are identity mapped on the pins. The IRQs are acknowledged on
+ * the local APIC and can be routed to any CPU through their redirection
+ * entry. The IRQs following the pins are message signaled interrupts, their
+ * message is written in the device by its driver.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <cpu_interrupt.h>  /* CPU interrupts settings */
+#include <critical.h>       /* Kernel spinlocks */
+#include <interrupts.h>     /* Interrupt driver interface */
+#include <vmm.h>            /* Virtual memory manager */
+#include <lapic.h>          /* Local APIC driver */
+#include <pic.h>            /* Legacy PIC driver */
+#include <acpi.h>           /* MADT IO-APICs */
+#include <kernel_output.h>  /* Kernel outputs */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <ioapic.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module name */
+#define MODULE_NAME "X86 IOAPIC"
+
+/** @brief Default IO-APIC registers base address, used without MADT. */
+#define IOAPIC_DEFAULT_BASE_ADDR 0xFEC00000
+
+/** @brief IO-APIC register select register. */
+#define IOAPIC_IOREGSEL 0x00
+/** @brief IO-APIC register window register. */
+#define IOAPIC_IOWIN    0x10
+
+/** @brief IO-APIC version register. */
+#define IOAPIC_VER       0x01
+/** @brief First IO-APIC redirection table register. */
+#define IOAPIC_REDTBL    0x10
+
+/** @brief Maximal redirection entry position in the version register. */
+#define IOAPIC_VER_MAX_ENTRY_SHIFT 16
+/** @brief Maximal redirection entry mask in the version register. */
+#define IOAPIC_VER_MAX_ENTRY_MASK  0xFF
+
+/** @brief Redirection entry masked flag. */
+#define IOAPIC_REDTBL_MASKED      0x00010000
+/** @brief Redirection entry destination position in the high register. */
+#define IOAPIC_REDTBL_DEST_SHIFT  24
+/** @brief Maximal physical destination of a redirection entry. */
+#define IOAPIC_REDTBL_DEST_MAX    0xFF
+
+/** @brief Number of IO-APIC pins the driver handles. */
+#define IOAPIC_MAX_PIN_COUNT IOAPIC_MSI_IRQ_BASE
+
+/** @brief Message signaled interrupt address base. */
+#define IOAPIC_MSI_ADDR_BASE       0xFEE00000
+/** @brief Message signaled interrupt address destination position. */
+#define IOAPIC_MSI_ADDR_DEST_SHIFT 12
+/** @brief Maximal destination of a message signaled interrupt. */
+#define IOAPIC_MSI_DEST_MAX        0xFF
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Tells if an IRQ is a message signaled interrupt.
+ *
+ * @param[in] IRQ The IRQ number.
+ */
+#define IOAPIC_IS_MSI_IRQ(IRQ)                                        \
+    ((IRQ) >= IOAPIC_MSI_IRQ_BASE &&                                  \
+     (IRQ) < IOAPIC_MSI_IRQ_BASE + INT_MSI_IRQ_COUNT)
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief IO-APIC interrupt driver instance. */
+static interrupt_driver_t ioapic_driver;
+
+/** @brief Number of IO-APIC pins handled by the driver. */
+static uint32_t ioapic_pin_count = 0;
+
+/** @brief IO-APIC registers base address, identity mapped. */
+static uintptr_t ioapic_base_addr = IOAPIC_DEFAULT_BASE_ADDR;
+
+/** @brief Allocated message signaled interrupts, one bit per IRQ. */
+static volatile uint32_t ioapic_msi_allocated = 0;
+
+/** @brief Lock protecting the IO-APIC registers. */
+static kernel_spinlock_t ioapic_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Reads an IO-APIC register, the IO-APIC lock must be held.
+ *
+ * @param[in] reg The register index.
+ *
+ * @return The register value.
+ */
+inline static uint32_t _ioapic_read(const uint32_t reg);
+
+/**
+ * @brief Writes an IO-APIC register, the IO-APIC lock must be held.
+ *
+ * @param[in] reg The register index.
+ * @param[in] value The value to write.
+ */
+inline static void _ioapic_write(const uint32_t reg, const uint32_t value);
+
+/**
+ * @brief Masks or unmasks an IRQ.
+ *
+ * @details Masks or unmasks an IO-APIC pin. The message signaled interrupts
+ * are masked in their device and are ignored.
+ *
+ * @param[in] irq_number The IRQ number.
+ * @param[in] enabled TRUE to unmask the IRQ, FALSE to mask it.
+ */
+static void _ioapic_set_irq_mask(const uint32_t irq_number,
+                                 const bool_t enabled);
+
+/**
+ * @brief Acknowledges an IRQ on the local APIC.
+ *
+ * @param[in] irq_number Unused.
+ */
+static void _ioapic_set_irq_eoi(const uint32_t irq_number);
+
+/**
+ * @brief Checks if an interrupt is the local APIC spurious interrupt.
+ *
+ * @param[in] int_number The interrupt line.
+ *
+ * @return INTERRUPT_TYPE_SPURIOUS for the local APIC spurious interrupt,
+ * INTERRUPT_TYPE_REGULAR otherwise.
+ */
+static INTERRUPT_TYPE_E _ioapic_handle_spurious(const uint32_t int_number);
+
+/**
+ * @brief Returns the interrupt line of an IRQ.
+ *
+ * @param[in] irq_number The IRQ number.
+ *
+ * @return The interrupt line of the IRQ, -1 if the IRQ does not exist.
+ */
+static int32_t _ioapic_get_irq_int_line(const uint32_t irq_number);
+
+/**
+ * @brief Routes an IO-APIC pin to a CPU.
+ *
+ * @details Sets the physical destination of the pin redirection entry. The
+ * message signaled interrupts are routed by their message.
+ *
+ * @param[in] irq_number The IRQ number.
+ * @param[in] cpu_id The CPU identifier.
+ *
+ * @return OS_NO_ERR if the IRQ is routed to the CPU, OS_ERR_NO_SUCH_IRQ if the
+ * IRQ does not exist, OS_ERR_NOT_SUPPORTED if the IRQ cannot be routed to the
+ * CPU.
+ */
+static OS_RETURN_E _ioapic_set_irq_affinity(const uint32_t irq_number,
+                                            const uint32_t cpu_id);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static uint32_t _ioapic_read(const uint32_t reg)
+{
+    *(volatile uint32_t*)(ioapic_base_addr + IOAPIC_IOREGSEL) = reg;
+    return *(volatile uint32_t*)(ioapic_base_addr + IOAPIC_IOWIN);
+}
+
+inline static void _ioapic_write(const uint32_t reg, const uint32_t value)
+{
+    *(volatile uint32_t*)(ioapic_base_addr + IOAPIC_IOREGSEL) = reg;
+    *(volatile uint32_t*)(ioapic_base_addr + IOAPIC_IOWIN) = value;
+}
+
+static void _ioapic_set_irq_mask(const uint32_t irq_number,
+                                 const bool_t enabled)
+{
+    uint32_t int_state;
+    uint32_t reg;
+    uint32_t value;
+
+    if(irq_number >= ioapic_pin_count)
+    {
+        return;
+    }
+
+    reg = IOAPIC_REDTBL + irq_number * 2;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(ioapic_lock, int_state);
+
+    value = _ioapic_read(reg);
+    if(enabled == TRUE)
+    {
+        value &= ~IOAPIC_REDTBL_MASKED;
+    }
+    else
+    {
+        value |= IOAPIC_REDTBL_MASKED;
+    }
+    _ioapic_write(reg, value);
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(ioapic_lock, int_state);
+
+    KERNEL_DEBUG(IOAPIC_DEBUG_ENABLED, MODULE_NAME,
+                 "IRQ %u mask set to %u", irq_number, enabled);
+}
+
+static void _ioapic_set_irq_eoi(const uint32_t irq_number)
+{
+    (void)irq_number;
+
+    lapic_eoi();
+}
+
+static INTERRUPT_TYPE_E _ioapic_handle_spurious(const uint32_t int_number)
+{
+    if(int_number == LAPIC_SPURIOUS_INT_LINE)
+    {
+        return INTERRUPT_TYPE_SPURIOUS;
+    }
+
+    return INTERRUPT_TYPE_REGULAR;
+}
+
+static int32_t _ioapic_get_irq_int_line(const uint32_t irq_number)
+{
+    if(irq_number >= ioapic_pin_count && IOAPIC_IS_MSI_IRQ(irq_number) == 0)
+    {
+        return -1;
+    }
+
+    return irq_number + INT_IOAPIC_IRQ_OFFSET;
+}
+
+static OS_RETURN_E _ioapic_set_irq_affinity(const uint32_t irq_number,
+                                            const uint32_t cpu_id)
+{
+    OS_RETURN_E err;
+    uint32_t    apic_id;
+    uint32_t    int_state;
+
+    if(IOAPIC_IS_MSI_IRQ(irq_number) != 0)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+    if(irq_number >= ioapic_pin_count)
+    {
+        return OS_ERR_NO_SUCH_IRQ;
+    }
+
+    err = lapic_get_apic_id(cpu_id, &apic_id);
+    if(err != OS_NO_ERR || apic_id > IOAPIC_REDTBL_DEST_MAX)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    /* The destination is in the high register, the entry stays valid */
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(ioapic_lock, int_state);
+    _ioapic_write(IOAPIC_REDTBL + irq_number * 2 + 1,
+                  apic_id << IOAPIC_REDTBL_DEST_SHIFT);
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(ioapic_lock, int_state);
+
+    KERNEL_DEBUG(IOAPIC_DEBUG_ENABLED, MODULE_NAME,
+                 "IRQ %u routed to CPU %u", irq_number, cpu_id);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E ioapic_init(void)
+{
+    OS_RETURN_E err;
+    uintptr_t   phys;
+    uint32_t    gsi_base;
+    uint32_t    bsp_apic_id;
+    uint32_t    version;
+    uint32_t    int_state;
+    uint32_t    i;
+
+    if(lapic_is_enabled() == FALSE ||
+       lapic_get_apic_id(0, &bsp_apic_id) != OS_NO_ERR ||
+       bsp_apic_id > IOAPIC_REDTBL_DEST_MAX)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    /* The driver handles the IO-APIC of the first global interrupts */
+    for(i = 0; i < acpi_get_ioapic_count(); ++i)
+    {
+        if(acpi_get_ioapic(i, &phys, &gsi_base) == OS_NO_ERR &&
+           gsi_base == 0)
+        {
+            ioapic_base_addr = phys;
+            break;
+        }
+    }
+
+    /* The boot code might already map the IO-APIC with the local APIC */
+    err = vmm_get_physical(ioapic_base_addr, &phys);
+    if(err == OS_ERR_MEMORY_NOT_MAPPED)
+    {
+        err = vmm_map(ioapic_base_addr, ioapic_base_addr, VMM_PAGE_SIZE,
+                      VMM_FLAG_WRITE | VMM_FLAG_UNCACHED);
+        phys = ioapic_base_addr;
+    }
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+    if(phys != ioapic_base_addr)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(ioapic_lock, int_state);
+
+    version = _ioapic_read(IOAPIC_VER);
+    if(version == 0xFFFFFFFF)
+    {
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(ioapic_lock, int_state);
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    ioapic_pin_count = ((version >> IOAPIC_VER_MAX_ENTRY_SHIFT) &
+                        IOAPIC_VER_MAX_ENTRY_MASK) + 1;
+    if(ioapic_pin_count > IOAPIC_MAX_PIN_COUNT)
+    {
+        ioapic_pin_count = IOAPIC_MAX_PIN_COUNT;
+    }
+
+    /* Masked, edge triggered, active high, fixed delivery to the BSP */
+    for(i = 0; i < ioapic_pin_count; ++i)
+    {
+        _ioapic_write(IOAPIC_REDTBL + i * 2, IOAPIC_REDTBL_MASKED |
+                                             (INT_IOAPIC_IRQ_OFFSET + i));
+        _ioapic_write(IOAPIC_REDTBL + i * 2 + 1,
+                      bsp_apic_id << IOAPIC_REDTBL_DEST_SHIFT);
+    }
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(ioapic_lock, int_state);
+
+    /* The IRQs are only delivered by the IO-APIC */
+    pic_disable();
+
+    /* Init driver */
+    ioapic_driver.driver_set_irq_mask     = _ioapic_set_irq_mask;
+    ioapic_driver.driver_set_irq_eoi      = _ioapic_set_irq_eoi;
+    ioapic_driver.driver_handle_spurious  = _ioapic_handle_spurious;
+    ioapic_driver.driver_get_irq_int_line = _ioapic_get_irq_int_line;
+    ioapic_driver.driver_set_irq_affinity = _ioapic_set_irq_affinity;
+
+    KERNEL_SUCCESS("IO-APIC initialized, %u pins\n", ioapic_pin_count);
+
+    return OS_NO_ERR;
+}
+
+const interrupt_driver_t* ioapic_get_driver(void)
+{
+    return &ioapic_driver;
+}
+
+OS_RETURN_E ioapic_alloc_msi_irq(uint32_t* irq_number)
+{
+    uint32_t allocated;
+    uint32_t bit;
+
+    if(irq_number == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    allocated = __atomic_load_n(&ioapic_msi_allocated, __ATOMIC_RELAXED);
+    do
+    {
+        if(~allocated == 0)
+        {
+            return OS_ERR_RESOURCE_BUSY;
+        }
+        bit = __builtin_ctz(~allocated);
+    } while(__atomic_compare_exchange_n(&ioapic_msi_allocated, &allocated,
+                                        allocated | (1U << bit), FALSE,
+                                        __ATOMIC_ACQ_REL,
+                                        __ATOMIC_RELAXED) == FALSE);
+
+    *irq_number = IOAPIC_MSI_IRQ_BASE + bit;
+
+    KERNEL_DEBUG(IOAPIC_DEBUG_ENABLED, MODULE_NAME,
+                 "MSI IRQ %u allocated", *irq_number);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E ioapic_free_msi_irq(const uint32_t irq_number)
+{
+    uint32_t mask;
+
+    if(IOAPIC_IS_MSI_IRQ(irq_number) == 0)
+    {
+        return OS_ERR_NO_SUCH_IRQ;
+    }
+
+    mask = 1U << (irq_number - IOAPIC_MSI_IRQ_BASE);
+    if((__atomic_fetch_and(&ioapic_msi_allocated, ~mask,
+                           __ATOMIC_ACQ_REL) & mask) == 0)
+    {
+        return OS_ERR_NO_SUCH_IRQ;
+    }
+
+    KERNEL_DEBUG(IOAPIC_DEBUG_ENABLED, MODULE_NAME,
+                 "MSI IRQ %u released", irq_number);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E ioapic_get_msi_message(const uint32_t irq_number,
+                                   const uint32_t cpu_id,
+                                   uint64_t* address,
+                                   uint32_t* data)
+{
+    OS_RETURN_E err;
+    uint32_t    apic_id;
+
+    if(address == NULL || data == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(IOAPIC_IS_MSI_IRQ(irq_number) == 0)
+    {
+        return OS_ERR_NO_SUCH_IRQ;
+    }
+
+    err = lapic_get_apic_id(cpu_id, &apic_id);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+    if(apic_id > IOAPIC_MSI_DEST_MAX)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    /* Physical destination, edge triggered fixed delivery */
+    *address = IOAPIC_MSI_ADDR_BASE |
+               (apic_id << IOAPIC_MSI_ADDR_DEST_SHIFT);
+    *data    = INT_IOAPIC_IRQ_OFFSET + irq_number;
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -27,9 +27,43 @@
 #include <vga_console.h>    /* VGA console driver */
 #include <kernel_output.h>  /* Kernel logger */
 #include <cpu.h>            /* CPU manager */
+#include <cpu_features.h>   /* CPU features registry */
 #include <panic.h>          /* Kernel Panic */
 #include <uart.h>           /* UART driver */
 #include <interrupts.h>     /* Interrupt manager */
+#include <percpu.h>         /* Per-CPU variables */
+#include <scheduler.h>      /* Kernel scheduler */
+#include <softirq.h>        /* Deferred interrupt work */
+#include <ktask.h>          /* Kernel tasks */
+#include <kheap.h>          /* Kernel heap */
+#include <memmgt.h>         /* Physical memory manager */
+#include <vmm.h>            /* Virtual memory manager */
+#include <acpi.h>           /* ACPI tables parser */
+#include <ipi.h>            /* Cross-CPU calls */
+#include <idle.h>           /* CPU idle driver */
+#include <poll_driver.h>    /* Polling mode drivers */
+#include <time_mgt.h>       /* Time management */
+#include <lapic.h>          /* LAPIC driver */
+#include <ioapic.h>         /* IO-APIC interrupt driver */
+#include <pic.h>            /* PIC interrupt driver */
+#include <lapic_timer.h>    /* LAPIC timer driver */
+#include <pit.h>            /* PIT clock source */
+#include <tsc.h>            /* TSC clock source */
+#include <kvmclock.h>       /* KVM clock source */
+#include <pmu.h>            /* Performance monitoring unit */
+#include <profiler.h>       /* Sampling profiler */
+#include <crash_dump.h>     /* Crash record */
+#include <trace_drain.h>    /* Trace drain */
+#include <console_drain.h>  /* Console drain */
+#include <syscall.h>        /* System calls dispatcher */
+#include <initcall.h>       /* Init calls registry */
+#include <initrd.h>         /* Initial ram disk */
+#include <bcache.h>         /* Block cache */
+#include <vfs.h>            /* Virtual file system */
+#include <ustar.h>          /* USTAR file system */
+#include <elf.h>            /* ELF programs loader */
+#include <virtio_console.h> /* Virtio console driver */
+#include <virtio_net.h>     /* Virtio network card driver */
 
 /* Configuration files */
 #include <config.h>
@@ -51,7 +85,44 @@
  * STRUCTURES AND TYPES
  ******************************************************************************/
 
-/* None */
+/** @brief Boot sequence init calls, run before the APs are started. */
+typedef enum
+{
+    KICKSTART_INIT_UART = 0,
+    KICKSTART_INIT_VGA,
+    KICKSTART_INIT_CPU,
+    KICKSTART_INIT_KHEAP,
+    KICKSTART_INIT_MEMMGT,
+    KICKSTART_INIT_VMM,
+    KICKSTART_INIT_ACPI,
+    KICKSTART_INIT_INTERRUPTS,
+    KICKSTART_INIT_IPI,
+    KICKSTART_INIT_TLB,
+    KICKSTART_INIT_IDLE,
+    KICKSTART_INIT_UART_IRQ,
+    KICKSTART_INIT_CLOCK,
+    KICKSTART_INIT_TIMER,
+    KICKSTART_INIT_SCHEDULER,
+    KICKSTART_INIT_SOFTIRQ,
+    KICKSTART_INIT_KTASK,
+    KICKSTART_INIT_SMP,
+    KICKSTART_INIT_EARLY_COUNT
+} KICKSTART_INIT_EARLY_E;
+
+/** @brief Boot sequence init calls, run once the APs joined the scheduler. */
+typedef enum
+{
+    KICKSTART_INIT_SYSCALL = 0,
+    KICKSTART_INIT_CONSOLE_DRAIN,
+    KICKSTART_INIT_TRACE_DRAIN,
+    KICKSTART_INIT_ROOTFS,
+    KICKSTART_INIT_ELF,
+    KICKSTART_INIT_PROFILER,
+    KICKSTART_INIT_CRASH_DUMP,
+    KICKSTART_INIT_VIRTIO_CONSOLE,
+    KICKSTART_INIT_VIRTIO_NET,
+    KICKSTART_INIT_LATE_COUNT
+} KICKSTART_INIT_LATE_E;
 
 /*******************************************************************************
  * MACROS
@@ -102,54 +173,634 @@
  */
 void kickstart(void);
 
+/**
+ * @brief Application processors boot sequence.
+ *
+ * @details Application processors boot sequence, called by each AP once its
+ * CPU is initialized. The AP boot context becomes the AP idle thread and
+ * enters the scheduler.
+ *
+ * @param[in] cpu_id The identifier of the AP.
+ */
+static void _kickstart_ap(const uint32_t cpu_id);
+
+/**
+ * @brief Registers the UART console driver.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _kickstart_init_uart(void);
+
+/**
+ * @brief Registers the VGA console driver and clears the screen.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _kickstart_init_vga(void);
+
+/**
+ * @brief Initializes the BSP and its CPU local storage.
+ *
+ * @return OS_NO_ERR.
+ */
+static OS_RETURN_E _kickstart_init_cpu(void);
+
+/**
+ * @brief Parses the ACPI tables.
+ *
+ * @details Parses the ACPI tables, the kernel runs with the default topology
+ * and interrupt controllers addresses when the tables cannot be parsed.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _kickstart_init_acpi(void);
+
+/**
+ * @brief Initializes the interrupt manager and its driver.
+ *
+ * @details Initializes the interrupt manager, the IRQs are delivered with the
+ * IO-APIC, or the PIC without it.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _kickstart_init_interrupts(void);
+
+/**
+ * @brief Adds the BSP to the cross-CPU calls, sent through the LAPIC.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _kickstart_init_ipi(void);
+
+/**
+ * @brief Initializes the BSP TLB shootdowns, sent as cross-CPU calls.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _kickstart_init_tlb(void);
+
+/**
+ * @brief Initializes the BSP idle driver.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _kickstart_init_idle(void);
+
+/**
+ * @brief Enables the UART interrupts, the kernel can poll without them.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _kickstart_init_uart_irq(void);
+
+/**
+ * @brief Calibrates the TSC and sets the kernel's clock source.
+ *
+ * @details Calibrates the TSC and sets the kernel's clock source. The TSC is
+ * used when it is invariant, the PIT otherwise.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _kickstart_init_clock(void);
+
+/**
+ * @brief Initializes the main timer.
+ *
+ * @return The success state or the error code, OS_ERR_NOT_SUPPORTED if the
+ * kernel runs without main timer.
+ */
+static OS_RETURN_E _kickstart_init_timer(void);
+
+/**
+ * @brief Initializes the scheduler, the boot context becomes the init thread.
+ *
+ * @return OS_NO_ERR.
+ */
+static OS_RETURN_E _kickstart_init_scheduler(void);
+
+/**
+ * @brief Creates the BSP softirq worker.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _kickstart_init_softirq(void);
+
+/**
+ * @brief Creates the BSP task executor.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _kickstart_init_ktask(void);
+
+/**
+ * @brief Starts the APs, they join the scheduler.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _kickstart_init_smp(void);
+
+/**
+ * @brief Initializes the system calls table.
+ *
+ * @return OS_NO_ERR.
+ */
+static OS_RETURN_E _kickstart_init_syscall(void);
+
+/**
+ * @brief Starts the trace drain on the UART.
+ *
+ * @return The success state or the error code, OS_ERR_NOT_SUPPORTED if the
+ * trace is not drained on the UART.
+ */
+static OS_RETURN_E _kickstart_init_trace_drain(void);
+
+/**
+ * @brief Mounts the initial ram disk as root, on the first file open.
+ *
+ * @return The success state or the error code, OS_ERR_NOT_SUPPORTED if there
+ * is no initial ram disk.
+ */
+static OS_RETURN_E _kickstart_init_rootfs(void);
+
+/**
+ * @brief Initializes the sampling profiler, on the PMU when it is usable and
+ * on the main timer otherwise.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _kickstart_init_profiler(void);
+
+/**
+ * @brief Initializes the virtio console and adds it to the console drivers.
+ *
+ * @return The success state or the error code, OS_ERR_NOT_SUPPORTED if there
+ * is no virtio console.
+ */
+static OS_RETURN_E _kickstart_init_virtio_console(void);
+
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
 
-/* TODO: remove */
-extern void scheduler_dummy_init(void);
-
-void kickstart(void)
+static void _kickstart_ap(const uint32_t cpu_id)
 {
     OS_RETURN_E ret_value;
 
-    /* Start testing framework */
-    TEST_FRAMEWORK_START();
+    KERNEL_TRACE_INIT_CPU_LOCAL(cpu_id);
 
-    KERNEL_TRACE_EVENT(EVENT_KERNEL_KICKSTART_START, 0);
+    scheduler_init_cpu_local(cpu_id);
+    lapic_init_local(cpu_id);
+    lapic_timer_init_local();
 
-    /* TODO: remove */
-    scheduler_dummy_init();
+    ret_value = ipi_init_cpu(cpu_id);
+    KICKSTART_ASSERT(ret_value == OS_NO_ERR,
+                     "Could not add the AP to the cross-CPU calls",
+                     ret_value);
 
-    /* Init serial driver */
-#if DEBUG_LOG_UART
-    uart_init();
-    ret_value = console_set_selected_driver(uart_get_driver());
+    ret_value = vmm_init_cpu(cpu_id);
     KICKSTART_ASSERT(ret_value == OS_NO_ERR,
-                     "Could not register UART driver",
+                     "Could not add the AP to the TLB shootdowns",
                      ret_value);
-#endif
 
-    /* Register the VGA console driver for kernel console */
-    vga_console_init();
-    ret_value = console_set_selected_driver(vga_console_get_driver());
+    ret_value = idle_init_cpu(cpu_id);
     KICKSTART_ASSERT(ret_value == OS_NO_ERR,
-                     "Could not register VGA driver",
+                     "Could not initialize the AP idle driver",
                      ret_value);
 
-    console_clear_screen();
+    ret_value = softirq_init_cpu(cpu_id);
+    KICKSTART_ASSERT(ret_value == OS_NO_ERR,
+                     "Could not create the AP softirq worker",
+                     ret_value);
+
+    ret_value = ktask_init_cpu(cpu_id);
+    KICKSTART_ASSERT(ret_value == OS_NO_ERR,
+                     "Could not create the AP task executor",
+                     ret_value);
+
+    /* The reserved CPUs poll the devices instead of running threads */
+    if(poll_driver_is_reserved(cpu_id) == TRUE)
+    {
+        poll_driver_loop();
+    }
+
+    KERNEL_DEBUG(KICKSTART_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %d entering scheduler", cpu_id);
+
+    scheduler_idle();
 
+    /* The idle loop should never return */
+    KICKSTART_ASSERT(FALSE, "AP Kickstart Returned",
+                     OS_ERR_UNAUTHORIZED_ACTION);
+}
+
+static OS_RETURN_E _kickstart_init_uart(void)
+{
+#if DEBUG_LOG_UART
+    uart_init();
+    return console_add_driver(uart_get_driver());
+#else
+    return OS_NO_ERR;
+#endif
+}
 
-    KERNEL_INFO("UTK Kickstart\n");
+static OS_RETURN_E _kickstart_init_vga(void)
+{
+    OS_RETURN_E ret_value;
 
-    /* Initialize the CPU */
+    vga_console_init();
+    ret_value = console_add_driver(vga_console_get_driver());
+    if(ret_value == OS_NO_ERR)
+    {
+        console_clear_screen();
+        KERNEL_INFO("UTK Kickstart\n");
+    }
+
+    return ret_value;
+}
+
+static OS_RETURN_E _kickstart_init_cpu(void)
+{
     cpu_init();
+    percpu_init();
+    scheduler_init_cpu_local(0);
+
+    return OS_NO_ERR;
+}
+
+static OS_RETURN_E _kickstart_init_acpi(void)
+{
+    OS_RETURN_E ret_value;
+
+    ret_value = acpi_init();
+    if(ret_value != OS_NO_ERR && ret_value != OS_ERR_NOT_SUPPORTED)
+    {
+        KERNEL_ERROR("Could not parse the ACPI tables: %d\n", ret_value);
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    return ret_value;
+}
+
+static OS_RETURN_E _kickstart_init_interrupts(void)
+{
+    OS_RETURN_E ret_value;
 
-    /* Initialize interrupt manager */
     kernel_interrupt_init();
 
+    /* Deliver the IRQs with the IO-APIC, fall back on the PIC without it */
+    ret_value = lapic_init();
+    if(ret_value == OS_NO_ERR)
+    {
+        ret_value = ioapic_init();
+    }
+    if(ret_value == OS_NO_ERR)
+    {
+        return kernel_interrupt_set_driver(ioapic_get_driver());
+    }
+    if(ret_value != OS_ERR_NOT_SUPPORTED)
+    {
+        return ret_value;
+    }
+
+    pic_init();
+    return kernel_interrupt_set_driver(pic_get_driver());
+}
+
+static OS_RETURN_E _kickstart_init_ipi(void)
+{
+    return ipi_init_cpu(0);
+}
+
+static OS_RETURN_E _kickstart_init_tlb(void)
+{
+    return vmm_init_cpu(0);
+}
+
+static OS_RETURN_E _kickstart_init_idle(void)
+{
+    return idle_init_cpu(0);
+}
+
+static OS_RETURN_E _kickstart_init_uart_irq(void)
+{
+#if DEBUG_LOG_UART
+    OS_RETURN_E ret_value;
+
+    /* Drain the UART with its interrupt, the kernel can poll without it */
+    ret_value = uart_enable_tx_interrupt();
+    if(ret_value != OS_NO_ERR && ret_value != OS_ERR_NOT_SUPPORTED)
+    {
+        return ret_value;
+    }
+
+    /* Read the UART input with its interrupt, the kernel can poll without it */
+    ret_value = uart_enable_rx_interrupt(COM1);
+    if(ret_value != OS_NO_ERR && ret_value != OS_ERR_NOT_SUPPORTED)
+    {
+        return ret_value;
+    }
+#endif
+
+    return OS_NO_ERR;
+}
+
+static OS_RETURN_E _kickstart_init_clock(void)
+{
+    OS_RETURN_E kvmclock_err;
+    OS_RETURN_E tsc_err;
+
+    /* The KVM clock gives the TSC frequency, initialize it first */
+    kvmclock_err = kvmclock_init();
+    tsc_err      = tsc_init();
+
+    /* The KVM clock follows the host adjustments of the guest TSC */
+    if(kvmclock_err == OS_NO_ERR)
+    {
+        return time_set_clocksource(kvmclock_get_clocksource());
+    }
+
+    /* The rate of a non invariant TSC changes with the CPU power states */
+    if(tsc_err == OS_NO_ERR &&
+       cpu_has_feature(CPU_FEATURE_INVARIANT_TSC) == TRUE)
+    {
+        return time_set_clocksource(tsc_get_clocksource());
+    }
+
+    pit_clock_init();
+    return time_set_clocksource(pit_get_clocksource());
+}
+
+static OS_RETURN_E _kickstart_init_timer(void)
+{
+    OS_RETURN_E ret_value;
+
+    ret_value = lapic_timer_init();
+    if(ret_value != OS_NO_ERR)
+    {
+        return ret_value;
+    }
+
+    /* The kernel runs without main timer, not with a broken one */
+    ret_value = time_init(lapic_timer_get_driver());
+    KICKSTART_ASSERT(ret_value == OS_NO_ERR,
+                     "Could not set the main timer",
+                     ret_value);
+
+    return OS_NO_ERR;
+}
+
+static OS_RETURN_E _kickstart_init_scheduler(void)
+{
+    scheduler_init();
+
+    return OS_NO_ERR;
+}
+
+static OS_RETURN_E _kickstart_init_softirq(void)
+{
+    return softirq_init_cpu(0);
+}
+
+static OS_RETURN_E _kickstart_init_ktask(void)
+{
+    return ktask_init_cpu(0);
+}
+
+static OS_RETURN_E _kickstart_init_smp(void)
+{
+    return cpu_smp_init(_kickstart_ap);
+}
+
+static OS_RETURN_E _kickstart_init_syscall(void)
+{
+    syscall_init();
+
+    return OS_NO_ERR;
+}
+
+static OS_RETURN_E _kickstart_init_trace_drain(void)
+{
+#if defined(_TRACING_ENABLED) && TRACE_DRAIN_UART
+    /* Stream the trace packets on the UART */
+#if !DEBUG_LOG_UART
+    uart_init();
+#endif
+    return trace_drain_init(uart_get_trace_output());
+#else
+    return OS_ERR_NOT_SUPPORTED;
+#endif
+}
+
+static OS_RETURN_E _kickstart_init_profiler(void)
+{
+    if(pmu_init() == OS_NO_ERR)
+    {
+        return profiler_init(pmu_get_profiler_source());
+    }
+
+    return profiler_init(NULL);
+}
+
+static OS_RETURN_E _kickstart_init_virtio_console(void)
+{
+    OS_RETURN_E ret_value;
+
+    ret_value = virtio_console_init();
+    if(ret_value != OS_NO_ERR)
+    {
+        return ret_value;
+    }
+
+    return console_add_driver(virtio_console_get_driver());
+}
+
+static OS_RETURN_E _kickstart_init_rootfs(void)
+{
+    OS_RETURN_E ret_value;
+    blkdev_t*   initrd_dev;
+
+    bcache_init();
+    ret_value = vfs_register_driver(ustar_get_driver());
+    if(ret_value != OS_NO_ERR)
+    {
+        return ret_value;
+    }
+
+    ret_value = initrd_init();
+    if(ret_value != OS_NO_ERR)
+    {
+        return ret_value;
+    }
+    ret_value = initrd_get_device(&initrd_dev);
+    if(ret_value != OS_NO_ERR)
+    {
+        return ret_value;
+    }
+
+    return vfs_mount("/", USTAR_DRIVER_NAME, initrd_dev);
+}
+
+void kickstart(void)
+{
+    OS_RETURN_E ret_value;
+
+    /* The early calls form a chain, each subsystem needs the previous ones */
+    static initcall_t early_calls[KICKSTART_INIT_EARLY_COUNT] = {
+        [KICKSTART_INIT_UART] = {
+            "uart", _kickstart_init_uart, 0, 0
+        },
+        [KICKSTART_INIT_VGA] = {
+            "vga", _kickstart_init_vga, 0, 0
+        },
+        [KICKSTART_INIT_CPU] = {
+            "cpu", _kickstart_init_cpu, 0, 0
+        },
+        [KICKSTART_INIT_KHEAP] = {
+            "kheap", kheap_init,
+            INITCALL_DEP(KICKSTART_INIT_CPU), 0
+        },
+        [KICKSTART_INIT_MEMMGT] = {
+            "memmgt", memmgt_init,
+            INITCALL_DEP(KICKSTART_INIT_KHEAP), 0
+        },
+        [KICKSTART_INIT_VMM] = {
+            "vmm", vmm_init,
+            INITCALL_DEP(KICKSTART_INIT_MEMMGT), 0
+        },
+        [KICKSTART_INIT_ACPI] = {
+            "acpi", _kickstart_init_acpi,
+            INITCALL_DEP(KICKSTART_INIT_VMM), INITCALL_FLAG_OPTIONAL
+        },
+        [KICKSTART_INIT_INTERRUPTS] = {
+            "interrupts", _kickstart_init_interrupts,
+            INITCALL_DEP(KICKSTART_INIT_ACPI), 0
+        },
+        [KICKSTART_INIT_IPI] = {
+            "ipi", _kickstart_init_ipi,
+            INITCALL_DEP(KICKSTART_INIT_INTERRUPTS), 0
+        },
+        [KICKSTART_INIT_TLB] = {
+            "tlb", _kickstart_init_tlb,
+            INITCALL_DEP(KICKSTART_INIT_IPI), 0
+        },
+        [KICKSTART_INIT_IDLE] = {
+            "idle", _kickstart_init_idle,
+            INITCALL_DEP(KICKSTART_INIT_CPU), 0
+        },
+        [KICKSTART_INIT_UART_IRQ] = {
+            "uart_irq", _kickstart_init_uart_irq,
+            INITCALL_DEP(KICKSTART_INIT_UART) |
+            INITCALL_DEP(KICKSTART_INIT_INTERRUPTS), 0
+        },
+        [KICKSTART_INIT_CLOCK] = {
+            "clock", _kickstart_init_clock,
+            INITCALL_DEP(KICKSTART_INIT_CPU), 0
+        },
+        [KICKSTART_INIT_TIMER] = {
+            "timer", _kickstart_init_timer,
+            INITCALL_DEP(KICKSTART_INIT_INTERRUPTS) |
+            INITCALL_DEP(KICKSTART_INIT_CLOCK), INITCALL_FLAG_OPTIONAL
+        },
+        [KICKSTART_INIT_SCHEDULER] = {
+            "scheduler", _kickstart_init_scheduler,
+            INITCALL_DEP(KICKSTART_INIT_TIMER), 0
+        },
+        [KICKSTART_INIT_SOFTIRQ] = {
+            "softirq", _kickstart_init_softirq,
+            INITCALL_DEP(KICKSTART_INIT_SCHEDULER), 0
+        },
+        [KICKSTART_INIT_KTASK] = {
+            "ktask", _kickstart_init_ktask,
+            INITCALL_DEP(KICKSTART_INIT_SCHEDULER), 0
+        },
+        [KICKSTART_INIT_SMP] = {
+            "smp", _kickstart_init_smp,
+            INITCALL_DEP(KICKSTART_INIT_TLB) |
+            INITCALL_DEP(KICKSTART_INIT_SOFTIRQ) |
+            INITCALL_DEP(KICKSTART_INIT_KTASK), INITCALL_FLAG_OPTIONAL
+        },
+    };
+
+    /* The late calls are independent, they run on the idle CPUs */
+    static initcall_t late_calls[KICKSTART_INIT_LATE_COUNT] = {
+        [KICKSTART_INIT_SYSCALL] = {
+            "syscall", _kickstart_init_syscall, 0, INITCALL_FLAG_ASYNC
+        },
+        [KICKSTART_INIT_CONSOLE_DRAIN] = {
+            "console_drain", console_drain_init, 0, INITCALL_FLAG_ASYNC
+        },
+        [KICKSTART_INIT_TRACE_DRAIN] = {
+            "trace_drain", _kickstart_init_trace_drain, 0,
+            INITCALL_FLAG_ASYNC | INITCALL_FLAG_OPTIONAL
+        },
+        [KICKSTART_INIT_ROOTFS] = {
+            VFS_ROOT_INITCALL, _kickstart_init_rootfs, 0,
+            INITCALL_FLAG_LAZY | INITCALL_FLAG_OPTIONAL
+        },
+        [KICKSTART_INIT_ELF] = {
+            "elf", elf_init, 0, 0
+        },
+        [KICKSTART_INIT_PROFILER] = {
+            "profiler", _kickstart_init_profiler, 0, INITCALL_FLAG_OPTIONAL
+        },
+        [KICKSTART_INIT_CRASH_DUMP] = {
+            "crash_dump", crash_dump_init, 0, INITCALL_FLAG_OPTIONAL
+        },
+        [KICKSTART_INIT_VIRTIO_CONSOLE] = {
+            "virtio_console", _kickstart_init_virtio_console, 0,
+            INITCALL_FLAG_OPTIONAL
+        },
+        [KICKSTART_INIT_VIRTIO_NET] = {
+            "virtio_net", virtio_net_init, 0,
+            INITCALL_FLAG_ASYNC | INITCALL_FLAG_OPTIONAL
+        },
+    };
+
+    /* Start testing framework */
+    TEST_FRAMEWORK_START();
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_KICKSTART_START, 0);
+
+    ret_value = initcall_run(early_calls, KICKSTART_INIT_EARLY_COUNT);
+    KICKSTART_ASSERT(ret_value == OS_NO_ERR,
+                     "Could not initialize the kernel",
+                     ret_value);
+
+    ret_value = initcall_run(late_calls, KICKSTART_INIT_LATE_COUNT);
+    KICKSTART_ASSERT(ret_value == OS_NO_ERR,
+                     "Could not start the kernel services",
+                     ret_value);
+
+    TEST_POINT_FUNCTION_CALL(smp_test, TEST_SMP_ENABLED);
+
     KERNEL_TRACE_EVENT(EVENT_KERNEL_KICKSTART_END, 0);
 
+    initcall_print_profile();
+
+    /* The libc does not depend on any manager */
+    TEST_POINT_FUNCTION_CALL(libc_test, TEST_LIBC_ENABLED);
+    TEST_POINT_FUNCTION_CALL(idt_test, TEST_IDT_ENABLED);
+
+    /* The memory suites run on the fully initialized managers */
+    TEST_POINT_FUNCTION_CALL(kheap_test, TEST_KHEAP_ENABLED);
+    TEST_POINT_FUNCTION_CALL(kpool_test, TEST_KPOOL_ENABLED);
+    TEST_POINT_FUNCTION_CALL(memmgt_test, TEST_MEMMGT_ENABLED);
+    TEST_POINT_FUNCTION_CALL(vmm_test, TEST_VMM_ENABLED);
+    TEST_POINT_FUNCTION_CALL(kstack_test, TEST_KSTACK_ENABLED);
+    TEST_POINT_FUNCTION_CALL(lock_test, TEST_LOCK_ENABLED);
+    TEST_POINT_FUNCTION_CALL(queue_test, TEST_QUEUE_ENABLED);
+    TEST_POINT_FUNCTION_CALL(kbuf_test, TEST_KBUF_ENABLED);
+    TEST_POINT_FUNCTION_CALL(ioring_test, TEST_IORING_ENABLED);
+    TEST_POINT_FUNCTION_CALL(syscall_test, TEST_SYSCALL_ENABLED);
+    TEST_POINT_FUNCTION_CALL(ustar_test, TEST_USTAR_ENABLED);
+    TEST_POINT_FUNCTION_CALL(bcache_test, TEST_BCACHE_ENABLED);
+    TEST_POINT_FUNCTION_CALL(elf_test, TEST_ELF_ENABLED);
+
+    /* The benchmarks run once the kernel is fully initialized */
+    TEST_POINT_FUNCTION_CALL(bench_test, TEST_BENCHMARK_ENABLED);
+    TEST_POINT_FUNCTION_CALL(interrupt_bench_test,
+                             TEST_INTERRUPT_BENCH_ENABLED);
+
     TEST_POINT_ASSERT_RCODE(TEST_KICKSTART_END_ID,
                             TRUE,
                             OS_NO_ERR,
@@ -0,0 +1,273 @@
+/*******************************************************************************
+ * @file kvmclock.c
+ *
+ * @see kvmclock.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief KVM paravirtual clock source driver.
+ *
+ * @details KVM paravirtual clock source driver. The clock is the system time
+ * published by the hypervisor, extended with the TSC ticks elapsed since its
+ * publication. The hypervisor increments the structure version before and
+ * after each update, the readers retry while the version is odd or changed.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <cpu.h>            /* CPU management */
+#include <cpu_features.h>   /* CPU features registry */
+#include <vmm.h>            /* Virtual memory manager */
+#include <time_mgt.h>       /* Clock source interface */
+#include <kernel_output.h>  /* Kernel outputs */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <kvmclock.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module name */
+#define MODULE_NAME "X86 KVMCLOCK"
+
+/** @brief KVM system time MSR, registers the clock structure of a CPU. */
+#define KVM_MSR_SYSTEM_TIME_NEW 0x4b564d01
+/** @brief KVM system time MSR flag: the clock structure is enabled. */
+#define KVM_MSR_SYSTEM_TIME_EN  0x1
+
+/** @brief Clock structure flag: the clock is stable on all the CPUs. */
+#define PVCLOCK_TSC_STABLE_BIT 0x01
+
+/** @brief Clock source frequency, the clock counts nanoseconds. */
+#define KVMCLOCK_FREQUENCY 1000000000ULL
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Clock structure shared with the hypervisor. */
+typedef struct
+{
+    /** @brief Update version, odd while the hypervisor updates the time. */
+    volatile uint32_t version;
+    /** @brief Padding. */
+    uint32_t reserved0;
+    /** @brief TSC value at the time of the update. */
+    volatile uint64_t tsc_timestamp;
+    /** @brief System time in nanoseconds at the time of the update. */
+    volatile uint64_t system_time;
+    /** @brief TSC to nanoseconds multiplier, 32.32 fixed point. */
+    volatile uint32_t tsc_to_system_mul;
+    /** @brief TSC shift applied before the multiplication. */
+    volatile int8_t tsc_shift;
+    /** @brief Clock flags. */
+    volatile uint8_t flags;
+    /** @brief Padding. */
+    uint8_t reserved1[2];
+} __attribute__((aligned(32))) pvclock_time_info_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Clock structure of the boot CPU, shared by all the CPUs. */
+static pvclock_time_info_t kvmclock_time_info;
+
+/** @brief KVM clock source instance. */
+static kernel_clocksource_t kvmclock_clocksource;
+
+/** @brief TSC frequency in Hz published by the hypervisor. */
+static uint64_t kvmclock_tsc_frequency = 0;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Reads the TSC once the previous loads completed.
+ *
+ * @return The TSC value.
+ */
+inline static uint64_t _kvmclock_rdtsc_ordered(void);
+
+/**
+ * @brief Scales TSC ticks to nanoseconds.
+ *
+ * @param[in] delta The TSC ticks.
+ * @param[in] mul The 32.32 fixed point multiplier.
+ * @param[in] shift The shift applied before the multiplication.
+ *
+ * @return The nanoseconds elapsed during the ticks.
+ */
+static uint64_t _kvmclock_scale(uint64_t delta,
+                                const uint32_t mul,
+                                const int8_t shift);
+
+/**
+ * @brief Returns the KVM clock source counter.
+ *
+ * @return The system time in nanoseconds.
+ */
+static uint64_t _kvmclock_read(void);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static uint64_t _kvmclock_rdtsc_ordered(void)
+{
+    uint32_t low;
+    uint32_t high;
+
+    /* The TSC must not be read before the structure version */
+    __asm__ __volatile__ ("lfence\n\t"
+                          "rdtsc" : "=a"(low), "=d"(high) :: "memory");
+    return ((uint64_t)high << 32) | low;
+}
+
+static uint64_t _kvmclock_scale(uint64_t delta,
+                                const uint32_t mul,
+                                const int8_t shift)
+{
+    if(shift < 0)
+    {
+        delta >>= -shift;
+    }
+    else
+    {
+        delta <<= shift;
+    }
+
+    /* 64 x 32 bits multiplication keeping the bits 32 to 95 */
+    return (((delta & 0xFFFFFFFFULL) * mul) >> 32) + (delta >> 32) * mul;
+}
+
+static uint64_t _kvmclock_read(void)
+{
+    uint32_t version;
+    uint64_t tsc;
+    uint64_t tsc_timestamp;
+    uint64_t system_time;
+    uint32_t mul;
+    int8_t   shift;
+
+    do
+    {
+        version = __atomic_load_n(&kvmclock_time_info.version,
+                                  __ATOMIC_ACQUIRE);
+
+        tsc_timestamp = kvmclock_time_info.tsc_timestamp;
+        system_time   = kvmclock_time_info.system_time;
+        mul           = kvmclock_time_info.tsc_to_system_mul;
+        shift         = kvmclock_time_info.tsc_shift;
+        tsc           = _kvmclock_rdtsc_ordered();
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while((version & 1) != 0 || version != kvmclock_time_info.version);
+
+    /* A CPU reading the structure of the boot CPU can be slightly behind */
+    if(tsc < tsc_timestamp)
+    {
+        return system_time;
+    }
+
+    return system_time + _kvmclock_scale(tsc - tsc_timestamp, mul, shift);
+}
+
+OS_RETURN_E kvmclock_init(void)
+{
+    OS_RETURN_E err;
+    uintptr_t   phys;
+    uint64_t    frequency;
+    int8_t      shift;
+
+    if(cpu_has_feature(CPU_FEATURE_KVM_CLOCK) == FALSE)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    err = vmm_get_physical((uintptr_t)&kvmclock_time_info, &phys);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    _cpu_set_msr(KVM_MSR_SYSTEM_TIME_NEW,
+                 (uint64_t)phys | KVM_MSR_SYSTEM_TIME_EN);
+
+    /* The structure of the boot CPU is only valid on all the CPUs when the
+     * clock is stable
+     */
+    if((kvmclock_time_info.flags & PVCLOCK_TSC_STABLE_BIT) == 0 ||
+       kvmclock_time_info.tsc_to_system_mul == 0)
+    {
+        _cpu_set_msr(KVM_MSR_SYSTEM_TIME_NEW, 0);
+        KERNEL_DEBUG(KVM_DEBUG_ENABLED, MODULE_NAME,
+                     "KVM clock is not stable");
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    /* Invert the TSC scale: the multiplier converts ticks to nanoseconds */
+    frequency = (KVMCLOCK_FREQUENCY << 32) /
+                kvmclock_time_info.tsc_to_system_mul;
+    shift     = kvmclock_time_info.tsc_shift;
+    if(shift < 0)
+    {
+        frequency <<= -shift;
+    }
+    else
+    {
+        frequency >>= shift;
+    }
+    kvmclock_tsc_frequency = frequency;
+
+    kvmclock_clocksource.name        = "kvmclock";
+    kvmclock_clocksource.read        = _kvmclock_read;
+    kvmclock_clocksource.frequency   = KVMCLOCK_FREQUENCY;
+    kvmclock_clocksource.max_idle_ns = 0;
+
+    KERNEL_SUCCESS("KVM clock initialized, TSC at %uKHz\n",
+                   (uint32_t)(kvmclock_tsc_frequency / 1000));
+
+    return OS_NO_ERR;
+}
+
+uint64_t kvmclock_get_tsc_frequency(void)
+{
+    return kvmclock_tsc_frequency;
+}
+
+const kernel_clocksource_t* kvmclock_get_clocksource(void)
+{
+    return &kvmclock_clocksource;
+}
+
+/************************************ EOF *************************************/
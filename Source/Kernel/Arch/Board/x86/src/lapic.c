@@ -0,0 +1,320 @@
+/*******************************************************************************
+ * @file lapic.c
+ *
+ * @see lapic.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Local APIC driver.
+ *
+ * @details Local APIC driver. The driver enables the local APIC of each CPU
+ * and gives access to its registers. When the CPU supports it, the local APIC
+ * is switched to the x2APIC mode: the registers are then accessed through
+ * MSRs, which makes the end of interrupt a single non serializing write.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <cpu.h>            /* CPU management */
+#include <cpu_features.h>   /* CPU features registry */
+#include <cpu_interrupt.h>  /* CPU interrupts settings */
+#include <interrupts.h>     /* Interrupts management */
+#include <topology.h>       /* CPU nodes */
+#include <percpu.h>         /* Per-CPU variables */
+#include <vmm.h>            /* Virtual memory manager */
+#include <kernel_output.h>  /* Kernel outputs */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <lapic.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module name */
+#define MODULE_NAME "X86 LAPIC"
+
+/** @brief APIC base MSR. */
+#define MSR_APIC_BASE          0x1B
+/** @brief APIC base MSR: local APIC global enable. */
+#define MSR_APIC_BASE_ENABLE   0x800
+/** @brief APIC base MSR: x2APIC mode enable. */
+#define MSR_APIC_BASE_X2APIC   0x400
+/** @brief APIC base MSR: local APIC base address mask. */
+#define MSR_APIC_BASE_ADDR_MASK 0xFFFFF000
+
+/** @brief First x2APIC MSR, the register offsets are divided by 16. */
+#define MSR_X2APIC_BASE 0x800
+
+/** @brief CPUID leaf 1 EDX: local APIC present. */
+#define CPUID_EDX_APIC   0x00000200
+
+/** @brief xAPIC identifier position in the identifier register. */
+#define LAPIC_ID_SHIFT 24
+
+/** @brief Identifier of the CPUs that did not enable their local APIC. */
+#define LAPIC_NO_ID 0xFFFFFFFF
+
+/** @brief KVM paravirtual end of interrupt MSR. */
+#define KVM_MSR_PV_EOI_EN       0x4b564d04
+/** @brief KVM paravirtual end of interrupt MSR flag: the area is enabled. */
+#define KVM_MSR_PV_EOI_ENABLED  0x1
+/** @brief KVM paravirtual end of interrupt area flag: the hypervisor accepts
+ * the end of interrupt without a local APIC write.
+ */
+#define KVM_PV_EOI_PENDING      0x1
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Tells if the local APICs run in x2APIC mode, without runtime check
+ * once the CPU alternatives are applied. Used by the registers accesses.
+ */
+#define LAPIC_X2APIC_MODE()                                                 \
+    (LAPIC_X2APIC_ENABLED != 0 && CPU_FEATURE_STATIC(CPU_FEATURE_X2APIC))
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Tells if the driver was initialized. */
+static bool_t lapic_enabled = FALSE;
+
+/** @brief Tells if the local APICs run in x2APIC mode. */
+static bool_t lapic_x2apic_mode = FALSE;
+
+/** @brief Local APIC identifier of each CPU. */
+static uint32_t lapic_ids[MAX_CPU_COUNT] = {
+    [0 ... MAX_CPU_COUNT - 1] = LAPIC_NO_ID
+};
+
+/** @brief KVM paravirtual end of interrupt area of each CPU. */
+static PERCPU_DEFINE(volatile uint32_t, lapic_pv_eoi);
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Enables the local APIC of the calling CPU.
+ *
+ * @details Switches the local APIC of the calling CPU to the x2APIC mode if
+ * selected, enables it, accepts all the interrupt priorities and records the
+ * CPU local APIC identifier.
+ *
+ * @param[in] cpu_id The identifier of the calling CPU.
+ */
+static void _lapic_setup_local(const uint32_t cpu_id);
+
+/**
+ * @brief Local APIC spurious interrupt handler.
+ *
+ * @details Local APIC spurious interrupt handler. Spurious interrupts must not
+ * be acknowledged and are ignored.
+ *
+ * @param[in] curr_thread Unused.
+ */
+static void _lapic_spurious_handler(kernel_thread_t* curr_thread);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void _lapic_setup_local(const uint32_t cpu_id)
+{
+    uint64_t  base;
+    uintptr_t pv_eoi_phys;
+
+    if(lapic_x2apic_mode == TRUE)
+    {
+        /* The x2APIC mode is entered from the enabled xAPIC mode */
+        base = _cpu_get_msr(MSR_APIC_BASE);
+        _cpu_set_msr(MSR_APIC_BASE, base | MSR_APIC_BASE_ENABLE);
+        _cpu_set_msr(MSR_APIC_BASE, base | MSR_APIC_BASE_ENABLE |
+                                    MSR_APIC_BASE_X2APIC);
+    }
+
+    lapic_write(LAPIC_SVR, LAPIC_SVR_ENABLE | LAPIC_SPURIOUS_INT_LINE);
+    lapic_write(LAPIC_TPR, 0);
+
+    if(lapic_x2apic_mode == TRUE)
+    {
+        lapic_ids[cpu_id] = lapic_read(LAPIC_ID);
+    }
+    else
+    {
+        lapic_ids[cpu_id] = lapic_read(LAPIC_ID) >> LAPIC_ID_SHIFT;
+    }
+
+    /* The firmware gives the nodes of the CPUs by local APIC identifier */
+    (void)topology_register_cpu(cpu_id, lapic_ids[cpu_id]);
+
+    /* Under KVM, most end of interrupts do not need to exit to the host */
+    if(cpu_has_feature(CPU_FEATURE_KVM_PV_EOI) == TRUE)
+    {
+        *PERCPU_PTR(lapic_pv_eoi, cpu_id) = 0;
+        if(vmm_get_physical((uintptr_t)PERCPU_PTR(lapic_pv_eoi, cpu_id),
+                            &pv_eoi_phys) == OS_NO_ERR)
+        {
+            _cpu_set_msr(KVM_MSR_PV_EOI_EN,
+                         (uint64_t)pv_eoi_phys | KVM_MSR_PV_EOI_ENABLED);
+        }
+    }
+
+    KERNEL_DEBUG(LAPIC_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %u local APIC %u enabled", cpu_id, lapic_ids[cpu_id]);
+}
+
+static void _lapic_spurious_handler(kernel_thread_t* curr_thread)
+{
+    (void)curr_thread;
+
+    KERNEL_DEBUG(LAPIC_DEBUG_ENABLED, MODULE_NAME, "Spurious interrupt");
+}
+
+OS_RETURN_E lapic_init(void)
+{
+    OS_RETURN_E err;
+    uint32_t    regs[4];
+    uint64_t    base;
+
+    if(_cpu_cpuid(0x1, regs) == 0 || (regs[3] & CPUID_EDX_APIC) == 0)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    /* The boot code only maps the local APIC at its default address */
+    base = _cpu_get_msr(MSR_APIC_BASE);
+    if((base & MSR_APIC_BASE_ADDR_MASK) != LAPIC_BASE_ADDR)
+    {
+        KERNEL_ERROR("Local APIC relocated at 0x%p\n",
+                     (uintptr_t)(base & MSR_APIC_BASE_ADDR_MASK));
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    /* Spurious interrupts never switch threads */
+    err = kernel_interrupt_register_fast_int_handler(LAPIC_SPURIOUS_INT_LINE,
+                                                     _lapic_spurious_handler);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    lapic_x2apic_mode = (LAPIC_X2APIC_ENABLED != 0 &&
+                         cpu_has_feature(CPU_FEATURE_X2APIC) == TRUE);
+
+    _lapic_setup_local(0);
+    lapic_enabled = TRUE;
+
+    KERNEL_SUCCESS("Local APIC initialized, %s mode\n",
+                   lapic_x2apic_mode == TRUE ? "x2APIC" : "xAPIC");
+
+    return OS_NO_ERR;
+}
+
+void lapic_init_local(const uint32_t cpu_id)
+{
+    if(lapic_enabled == TRUE && cpu_id < MAX_CPU_COUNT)
+    {
+        _lapic_setup_local(cpu_id);
+    }
+}
+
+bool_t lapic_is_enabled(void)
+{
+    return lapic_enabled;
+}
+
+uint32_t lapic_read(const uint32_t reg)
+{
+    if(LAPIC_X2APIC_MODE())
+    {
+        return (uint32_t)_cpu_get_msr(MSR_X2APIC_BASE + (reg >> 4));
+    }
+
+    return *(volatile uint32_t*)((uintptr_t)LAPIC_BASE_ADDR + reg);
+}
+
+void lapic_write(const uint32_t reg, const uint32_t value)
+{
+    if(LAPIC_X2APIC_MODE())
+    {
+        _cpu_set_msr(MSR_X2APIC_BASE + (reg >> 4), value);
+    }
+    else
+    {
+        *(volatile uint32_t*)((uintptr_t)LAPIC_BASE_ADDR + reg) = value;
+    }
+}
+
+void lapic_eoi(void)
+{
+    volatile uint32_t* pv_eoi;
+    uint32_t           value;
+
+    /* The hypervisor only sets the flag when it injects an interrupt and the
+     * end of interrupts are issued with the interrupts disabled: the flag
+     * does not need an atomic update.
+     */
+    if(CPU_FEATURE_STATIC(CPU_FEATURE_KVM_PV_EOI))
+    {
+        pv_eoi = PERCPU_THIS_PTR(lapic_pv_eoi);
+        value  = *pv_eoi;
+        if((value & KVM_PV_EOI_PENDING) != 0)
+        {
+            *pv_eoi = value & ~KVM_PV_EOI_PENDING;
+            return;
+        }
+    }
+
+    lapic_write(LAPIC_EOI, 0);
+}
+
+OS_RETURN_E lapic_get_apic_id(const uint32_t cpu_id, uint32_t* apic_id)
+{
+    if(apic_id == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(cpu_id >= MAX_CPU_COUNT || lapic_ids[cpu_id] == LAPIC_NO_ID)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    *apic_id = lapic_ids[cpu_id];
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,330 @@
+/*******************************************************************************
+ * @file lapic_timer.c
+ *
+ * @see lapic_timer.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Local APIC timer driver.
+ *
+ * @details Local APIC timer driver. The driver provides the kernel's main
+ * timer: each CPU gets a one-shot deadline from its local APIC timer, in the
+ * time reference of the kernel's clock source. The TSC-deadline mode is used
+ * when the CPU supports it, otherwise the local APIC timer is used in
+ * one-shot mode with a count calibrated against the PIT.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <cpu.h>            /* CPU management */
+#include <cpu_features.h>   /* CPU features registry */
+#include <cpu_interrupt.h>  /* CPU interrupts settings */
+#include <interrupts.h>     /* Interrupts management */
+#include <time_mgt.h>       /* Kernel timer interface */
+#include <pit.h>            /* PIT delays */
+#include <tsc.h>            /* TSC frequency */
+#include <lapic.h>          /* Local APIC driver */
+#include <kernel_output.h>  /* Kernel outputs */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <lapic_timer.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module name */
+#define MODULE_NAME "X86 LAPIC TIMER"
+
+/** @brief LVT timer one-shot mode. */
+#define LAPIC_LVT_TIMER_ONESHOT     0x00000000
+/** @brief LVT timer TSC-deadline mode. */
+#define LAPIC_LVT_TIMER_TSC_DEADLINE 0x00040000
+/** @brief Local APIC timer divider: divide by 16. */
+#define LAPIC_TIMER_DIVIDE_BY_16    0x3
+
+/** @brief TSC deadline MSR. */
+#define MSR_TSC_DEADLINE 0x6E0
+
+/** @brief Calibration period in microseconds. */
+#define LAPIC_TIMER_CALIBRATION_US 10000
+
+/** @brief Fixed point shift used by the time conversion factors. */
+#define LAPIC_TIMER_SCALE_SHIFT 24
+/** @brief Fixed point fractional part mask of the time conversion. */
+#define LAPIC_TIMER_SCALE_MASK  ((1ULL << LAPIC_TIMER_SCALE_SHIFT) - 1)
+
+/** @brief Maximal local APIC timer count. */
+#define LAPIC_TIMER_MAX_COUNT 0xFFFFFFFF
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Local APIC timer driver instance. */
+static kernel_timer_t lapic_timer_driver;
+
+/** @brief Tells if the driver was initialized. */
+static bool_t lapic_timer_enabled = FALSE;
+
+/** @brief Tells if the TSC-deadline mode is used. */
+static bool_t tsc_deadline_mode;
+
+/** @brief Nanoseconds to TSC ticks fixed point factor. */
+static uint64_t ns_to_tsc_mult;
+
+/** @brief Nanoseconds to local APIC timer ticks fixed point factor. */
+static uint64_t ns_to_lapic_mult;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Applies a fixed point conversion factor.
+ *
+ * @details Applies a fixed point conversion factor to a value. The value is
+ * split around the fixed point shift to avoid overflowing the 64 bits
+ * product.
+ *
+ * @param[in] value The value to convert.
+ * @param[in] mult The fixed point conversion factor.
+ *
+ * @return The converted value.
+ */
+inline static uint64_t _lapic_timer_scale(const uint64_t value,
+                                          const uint64_t mult);
+
+/**
+ * @brief Sets the local APIC timer of the calling CPU.
+ *
+ * @details Sets the local APIC timer of the calling CPU in the mode selected
+ * during the calibration. The timer is disarmed.
+ */
+static void _lapic_timer_setup_local(void);
+
+/**
+ * @brief Sets the calling CPU timer deadline.
+ *
+ * @param[in] deadline_ns The deadline in nanoseconds, 0 disarms the timer.
+ */
+static void _lapic_timer_set_deadline(const uint64_t deadline_ns);
+
+/**
+ * @brief Acknowledges the local APIC timer interrupt.
+ */
+static void _lapic_timer_ack_interrupt(void);
+
+/**
+ * @brief Returns the local APIC timer interrupt line.
+ *
+ * @return The local APIC timer interrupt line.
+ */
+static uint32_t _lapic_timer_get_interrupt_line(void);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static uint64_t _lapic_timer_scale(const uint64_t value,
+                                          const uint64_t mult)
+{
+    return (value >> LAPIC_TIMER_SCALE_SHIFT) * mult +
+           (((value & LAPIC_TIMER_SCALE_MASK) * mult) >>
+            LAPIC_TIMER_SCALE_SHIFT);
+}
+
+static void _lapic_timer_setup_local(void)
+{
+    lapic_write(LAPIC_TIMER_DIVIDE, LAPIC_TIMER_DIVIDE_BY_16);
+    lapic_write(LAPIC_TIMER_INIT_COUNT, 0);
+
+    if(tsc_deadline_mode == TRUE)
+    {
+        lapic_write(LAPIC_LVT_TIMER, LAPIC_LVT_TIMER_TSC_DEADLINE |
+                                     LAPIC_TIMER_INTERRUPT_LINE);
+        _cpu_set_msr(MSR_TSC_DEADLINE, 0);
+    }
+    else
+    {
+        lapic_write(LAPIC_LVT_TIMER, LAPIC_LVT_TIMER_ONESHOT |
+                                     LAPIC_TIMER_INTERRUPT_LINE);
+    }
+}
+
+static void _lapic_timer_set_deadline(const uint64_t deadline_ns)
+{
+    uint64_t now;
+    uint64_t count;
+
+    if(tsc_deadline_mode == TRUE)
+    {
+        if(deadline_ns == 0)
+        {
+            _cpu_set_msr(MSR_TSC_DEADLINE, 0);
+        }
+        else
+        {
+            /* The TSC might not be the clock source, convert the delay */
+            now = time_get_ns();
+            if(deadline_ns <= now)
+            {
+                count = 0;
+            }
+            else
+            {
+                count = _lapic_timer_scale(deadline_ns - now, ns_to_tsc_mult);
+            }
+            _cpu_set_msr(MSR_TSC_DEADLINE, _cpu_rdtsc() + count);
+        }
+        return;
+    }
+
+    /* One-shot mode: the count is relative to the current time */
+    if(deadline_ns == 0)
+    {
+        count = 0;
+    }
+    else
+    {
+        now = time_get_ns();
+        if(deadline_ns <= now)
+        {
+            count = 1;
+        }
+        else
+        {
+            /* Longer deadlines fire early and are set again by the kernel */
+            count = _lapic_timer_scale(deadline_ns - now, ns_to_lapic_mult);
+            if(count == 0)
+            {
+                count = 1;
+            }
+            else if(count > LAPIC_TIMER_MAX_COUNT)
+            {
+                count = LAPIC_TIMER_MAX_COUNT;
+            }
+        }
+    }
+
+    lapic_write(LAPIC_TIMER_INIT_COUNT, (uint32_t)count);
+}
+
+static void _lapic_timer_ack_interrupt(void)
+{
+    lapic_eoi();
+}
+
+static uint32_t _lapic_timer_get_interrupt_line(void)
+{
+    return LAPIC_TIMER_INTERRUPT_LINE;
+}
+
+OS_RETURN_E lapic_timer_init(void)
+{
+    uint64_t tsc_freq;
+    uint64_t lapic_freq;
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_LAPIC_TIMER_INIT_START, 0);
+
+    /* The local APIC is enabled by its driver */
+    if(lapic_is_enabled() == FALSE)
+    {
+        KERNEL_TRACE_EVENT(EVENT_KERNEL_LAPIC_TIMER_INIT_END, 3,
+                           0, 0, OS_ERR_NOT_SUPPORTED);
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    /* The TSC is calibrated by its driver */
+    tsc_freq          = tsc_get_frequency();
+    tsc_deadline_mode = (tsc_freq != 0 &&
+                         cpu_has_feature(CPU_FEATURE_TSC_DEADLINE) == TRUE);
+
+    /* Let the masked local APIC timer run during a PIT delay */
+    lapic_write(LAPIC_TIMER_DIVIDE, LAPIC_TIMER_DIVIDE_BY_16);
+    lapic_write(LAPIC_LVT_TIMER, LAPIC_LVT_MASKED);
+    lapic_write(LAPIC_TIMER_INIT_COUNT, LAPIC_TIMER_MAX_COUNT);
+
+    pit_busy_wait(LAPIC_TIMER_CALIBRATION_US);
+
+    lapic_freq = LAPIC_TIMER_MAX_COUNT -
+                 lapic_read(LAPIC_TIMER_CURRENT_COUNT);
+    lapic_write(LAPIC_TIMER_INIT_COUNT, 0);
+
+    lapic_freq = lapic_freq * (1000000 / LAPIC_TIMER_CALIBRATION_US);
+
+    ns_to_tsc_mult   = (tsc_freq << LAPIC_TIMER_SCALE_SHIFT) /
+                       TIME_NS_PER_SECOND;
+    ns_to_lapic_mult = (lapic_freq << LAPIC_TIMER_SCALE_SHIFT) /
+                       TIME_NS_PER_SECOND;
+
+    _lapic_timer_setup_local();
+
+    /* Init driver */
+    lapic_timer_driver.set_deadline       = _lapic_timer_set_deadline;
+    lapic_timer_driver.ack_interrupt      = _lapic_timer_ack_interrupt;
+    lapic_timer_driver.get_interrupt_line = _lapic_timer_get_interrupt_line;
+    lapic_timer_enabled = TRUE;
+
+    KERNEL_SUCCESS("LAPIC timer initialized at %uKHz, %s mode\n",
+                   (uint32_t)(lapic_freq / 1000),
+                   tsc_deadline_mode == TRUE ? "TSC-deadline" : "one-shot");
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_LAPIC_TIMER_INIT_END, 3,
+                       (uint32_t)(lapic_freq / 1000), tsc_deadline_mode,
+                       OS_NO_ERR);
+
+    return OS_NO_ERR;
+}
+
+void lapic_timer_init_local(void)
+{
+    if(lapic_timer_enabled == TRUE)
+    {
+        _lapic_timer_setup_local();
+
+        KERNEL_DEBUG(LAPIC_DEBUG_ENABLED, MODULE_NAME,
+                     "Local timer initialized");
+    }
+}
+
+const kernel_timer_t* lapic_timer_get_driver(void)
+{
+    return &lapic_timer_driver;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,530 @@
+/*******************************************************************************
+ * @file pci.c
+ *
+ * @see pci.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief PCI bus driver.
+ *
+ * @details PCI bus driver. The configuration space is accessed with the
+ * configuration mechanism 1 ports. The memory BARs are mapped at their
+ * physical address, uncached. Only MSI-X is supported for the device
+ * interrupts, the IRQs are given by the IO-APIC driver.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <cpu.h>            /* CPU ports */
+#include <critical.h>       /* Kernel spinlocks */
+#include <vmm.h>            /* Virtual memory manager */
+#include <mmio.h>           /* Memory mapped IOs */
+#include <kernel_output.h>  /* Kernel outputs */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <pci.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module name */
+#define MODULE_NAME "X86 PCI"
+
+/** @brief Configuration address port. */
+#define PCI_CONFIG_ADDRESS_PORT 0xCF8
+/** @brief Configuration data port. */
+#define PCI_CONFIG_DATA_PORT    0xCFC
+/** @brief Configuration address enable bit. */
+#define PCI_CONFIG_ENABLE       0x80000000
+
+/** @brief Number of buses. */
+#define PCI_BUS_COUNT      256
+/** @brief Number of devices on a bus. */
+#define PCI_DEVICE_COUNT   32
+/** @brief Number of functions of a device. */
+#define PCI_FUNCTION_COUNT 8
+
+/** @brief Vendor identifier register. */
+#define PCI_REG_VENDOR_ID   0x00
+/** @brief Device identifier register. */
+#define PCI_REG_DEVICE_ID   0x02
+/** @brief Command register. */
+#define PCI_REG_COMMAND     0x04
+/** @brief Status register. */
+#define PCI_REG_STATUS      0x06
+/** @brief Header type register. */
+#define PCI_REG_HEADER_TYPE 0x0E
+/** @brief First BAR register. */
+#define PCI_REG_BAR0        0x10
+/** @brief Capabilities list pointer register. */
+#define PCI_REG_CAP_PTR     0x34
+
+/** @brief Vendor identifier of an absent function. */
+#define PCI_VENDOR_NONE 0xFFFF
+
+/** @brief Multi-function flag of the header type. */
+#define PCI_HEADER_MULTIFUNCTION 0x80
+/** @brief Capabilities list flag of the status register. */
+#define PCI_STATUS_CAP_LIST      0x0010
+
+/** @brief Memory space decoding flag of the command register. */
+#define PCI_COMMAND_MEMORY     0x0002
+/** @brief Bus mastering flag of the command register. */
+#define PCI_COMMAND_MASTER     0x0004
+/** @brief Legacy interrupt disable flag of the command register. */
+#define PCI_COMMAND_INT_DISABLE 0x0400
+
+/** @brief IO space flag of a BAR. */
+#define PCI_BAR_IO          0x1
+/** @brief Type mask of a memory BAR. */
+#define PCI_BAR_TYPE_MASK   0x6
+/** @brief 64 bits type of a memory BAR. */
+#define PCI_BAR_TYPE_64     0x4
+/** @brief Address mask of a memory BAR. */
+#define PCI_BAR_ADDRESS_MASK 0xFFFFFFF0
+
+/** @brief MSI-X message control register offset in the capability. */
+#define PCI_MSIX_CONTROL      0x02
+/** @brief MSI-X table register offset in the capability. */
+#define PCI_MSIX_TABLE        0x04
+/** @brief MSI-X table size mask of the message control register. */
+#define PCI_MSIX_SIZE_MASK    0x07FF
+/** @brief MSI-X function mask flag of the message control register. */
+#define PCI_MSIX_FUNC_MASK    0x4000
+/** @brief MSI-X enable flag of the message control register. */
+#define PCI_MSIX_ENABLE       0x8000
+/** @brief MSI-X table BAR mask of the table register. */
+#define PCI_MSIX_BIR_MASK     0x7
+/** @brief Size of an MSI-X table entry. */
+#define PCI_MSIX_ENTRY_SIZE   16
+/** @brief MSI-X entry vector control masked flag. */
+#define PCI_MSIX_ENTRY_MASKED 0x1
+
+/** @brief Maximal number of capabilities walked, bounds a looping list. */
+#define PCI_MAX_CAP_COUNT 48
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Lock protecting the configuration ports. */
+static kernel_spinlock_t pci_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Selects a configuration register, the PCI lock must be held.
+ *
+ * @param[in] bus The bus number.
+ * @param[in] device The device number.
+ * @param[in] function The function number.
+ * @param[in] offset The register offset.
+ */
+inline static void _pci_select(const uint8_t bus,
+                               const uint8_t device,
+                               const uint8_t function,
+                               const uint8_t offset);
+
+/**
+ * @brief Returns the physical address of a memory BAR.
+ *
+ * @param[in] device The device.
+ * @param[in] bar The BAR index.
+ * @param[out] address The BAR physical address.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_OUT_OF_BOUND is returned if the BAR index is invalid.
+ * - OS_ERR_NOT_SUPPORTED is returned if the BAR is not a memory BAR or is not
+ * addressable by the kernel.
+ */
+static OS_RETURN_E _pci_get_bar(const pci_device_t* device,
+                                const uint32_t bar,
+                                uintptr_t* address);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static void _pci_select(const uint8_t bus,
+                               const uint8_t device,
+                               const uint8_t function,
+                               const uint8_t offset)
+{
+    _cpu_outl(PCI_CONFIG_ENABLE |
+              ((uint32_t)bus << 16) |
+              ((uint32_t)device << 11) |
+              ((uint32_t)function << 8) |
+              (offset & 0xFC),
+              PCI_CONFIG_ADDRESS_PORT);
+}
+
+static OS_RETURN_E _pci_get_bar(const pci_device_t* device,
+                                const uint32_t bar,
+                                uintptr_t* address)
+{
+    uint32_t low;
+    uint32_t high;
+
+    if(bar >= PCI_BAR_COUNT)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    low = pci_read_config_32(device, PCI_REG_BAR0 + bar * 4);
+    if((low & PCI_BAR_IO) != 0)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    high = 0;
+    if((low & PCI_BAR_TYPE_MASK) == PCI_BAR_TYPE_64)
+    {
+        if(bar + 1 >= PCI_BAR_COUNT)
+        {
+            return OS_ERR_OUT_OF_BOUND;
+        }
+        high = pci_read_config_32(device, PCI_REG_BAR0 + (bar + 1) * 4);
+    }
+
+#ifdef ARCH_64_BITS
+    *address = ((uintptr_t)high << 32) | (low & PCI_BAR_ADDRESS_MASK);
+#else
+    /* The firmware might place the BAR above the 32 bits space */
+    if(high != 0)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+    *address = low & PCI_BAR_ADDRESS_MASK;
+#endif
+
+    if(*address == 0)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E pci_find_device(const uint16_t vendor_id,
+                            const uint16_t device_id,
+                            pci_device_t* device)
+{
+    pci_device_t candidate;
+    uint32_t     bus;
+    uint32_t     dev;
+    uint32_t     func;
+    uint32_t     func_count;
+
+    if(device == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    for(bus = 0; bus < PCI_BUS_COUNT; ++bus)
+    {
+        for(dev = 0; dev < PCI_DEVICE_COUNT; ++dev)
+        {
+            candidate.bus      = bus;
+            candidate.device   = dev;
+            candidate.function = 0;
+            if(pci_read_config_16(&candidate, PCI_REG_VENDOR_ID) ==
+               PCI_VENDOR_NONE)
+            {
+                continue;
+            }
+
+            func_count = 1;
+            if((pci_read_config_8(&candidate, PCI_REG_HEADER_TYPE) &
+                PCI_HEADER_MULTIFUNCTION) != 0)
+            {
+                func_count = PCI_FUNCTION_COUNT;
+            }
+
+            for(func = 0; func < func_count; ++func)
+            {
+                candidate.function  = func;
+                candidate.vendor_id = pci_read_config_16(&candidate,
+                                                         PCI_REG_VENDOR_ID);
+                candidate.device_id = pci_read_config_16(&candidate,
+                                                         PCI_REG_DEVICE_ID);
+                if(candidate.vendor_id != vendor_id ||
+                   candidate.device_id != device_id)
+                {
+                    continue;
+                }
+
+                *device = candidate;
+
+                KERNEL_DEBUG(PCI_DEBUG_ENABLED, MODULE_NAME,
+                             "Found 0x%x:0x%x at %u:%u.%u",
+                             vendor_id, device_id, bus, dev, func);
+
+                return OS_NO_ERR;
+            }
+        }
+    }
+
+    return OS_ERR_NOT_SUPPORTED;
+}
+
+uint8_t pci_read_config_8(const pci_device_t* device, const uint8_t offset)
+{
+    uint32_t int_state;
+    uint8_t  value;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(pci_lock, int_state);
+    _pci_select(device->bus, device->device, device->function, offset);
+    value = _cpu_inb(PCI_CONFIG_DATA_PORT + (offset & 0x3));
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(pci_lock, int_state);
+
+    return value;
+}
+
+uint16_t pci_read_config_16(const pci_device_t* device, const uint8_t offset)
+{
+    uint32_t int_state;
+    uint16_t value;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(pci_lock, int_state);
+    _pci_select(device->bus, device->device, device->function, offset);
+    value = _cpu_inw(PCI_CONFIG_DATA_PORT + (offset & 0x2));
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(pci_lock, int_state);
+
+    return value;
+}
+
+uint32_t pci_read_config_32(const pci_device_t* device, const uint8_t offset)
+{
+    uint32_t int_state;
+    uint32_t value;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(pci_lock, int_state);
+    _pci_select(device->bus, device->device, device->function, offset);
+    value = _cpu_inl(PCI_CONFIG_DATA_PORT);
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(pci_lock, int_state);
+
+    return value;
+}
+
+void pci_write_config_16(const pci_device_t* device,
+                         const uint8_t offset,
+                         const uint16_t value)
+{
+    uint32_t int_state;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(pci_lock, int_state);
+    _pci_select(device->bus, device->device, device->function, offset);
+    _cpu_outw(value, PCI_CONFIG_DATA_PORT + (offset & 0x2));
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(pci_lock, int_state);
+}
+
+void pci_write_config_32(const pci_device_t* device,
+                         const uint8_t offset,
+                         const uint32_t value)
+{
+    uint32_t int_state;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(pci_lock, int_state);
+    _pci_select(device->bus, device->device, device->function, offset);
+    _cpu_outl(value, PCI_CONFIG_DATA_PORT);
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(pci_lock, int_state);
+}
+
+uint8_t pci_find_capability(const pci_device_t* device,
+                            const uint8_t cap_id,
+                            const uint8_t previous)
+{
+    uint8_t  offset;
+    uint32_t i;
+
+    if(previous == 0)
+    {
+        if((pci_read_config_16(device, PCI_REG_STATUS) &
+            PCI_STATUS_CAP_LIST) == 0)
+        {
+            return 0;
+        }
+        offset = pci_read_config_8(device, PCI_REG_CAP_PTR);
+    }
+    else
+    {
+        offset = pci_read_config_8(device, previous + 1);
+    }
+
+    for(i = 0; i < PCI_MAX_CAP_COUNT && offset != 0; ++i)
+    {
+        offset &= 0xFC;
+        if(pci_read_config_8(device, offset) == cap_id)
+        {
+            return offset;
+        }
+        offset = pci_read_config_8(device, offset + 1);
+    }
+
+    return 0;
+}
+
+OS_RETURN_E pci_map_bar(const pci_device_t* device,
+                        const uint32_t bar,
+                        const uint32_t offset,
+                        const size_t size,
+                        volatile void** address)
+{
+    OS_RETURN_E err;
+    uintptr_t   base;
+    uintptr_t   page;
+    uintptr_t   end;
+    uintptr_t   phys;
+
+    if(device == NULL || address == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    err = _pci_get_bar(device, bar, &base);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    base += offset;
+    end   = (base + size + VMM_PAGE_SIZE - 1) & ~(VMM_PAGE_SIZE - 1);
+
+    /* Several structures of a device can share a BAR page */
+    for(page = base & ~(VMM_PAGE_SIZE - 1); page < end; page += VMM_PAGE_SIZE)
+    {
+        err = vmm_get_physical(page, &phys);
+        if(err == OS_ERR_MEMORY_NOT_MAPPED)
+        {
+            err = vmm_map(page, page, VMM_PAGE_SIZE,
+                          VMM_FLAG_WRITE | VMM_FLAG_UNCACHED);
+            phys = page;
+        }
+        if(err != OS_NO_ERR)
+        {
+            return err;
+        }
+        if(phys != page)
+        {
+            return OS_ERR_NOT_SUPPORTED;
+        }
+    }
+
+    *address = (volatile void*)base;
+
+    return OS_NO_ERR;
+}
+
+void pci_enable_device(const pci_device_t* device)
+{
+    uint16_t command;
+
+    command = pci_read_config_16(device, PCI_REG_COMMAND);
+    command |= PCI_COMMAND_MEMORY | PCI_COMMAND_MASTER |
+               PCI_COMMAND_INT_DISABLE;
+    pci_write_config_16(device, PCI_REG_COMMAND, command);
+}
+
+OS_RETURN_E pci_set_msix_entry(const pci_device_t* device,
+                               const uint32_t entry,
+                               const uint64_t address,
+                               const uint32_t data)
+{
+    OS_RETURN_E    err;
+    uint8_t        cap;
+    uint16_t       control;
+    uint32_t       table;
+    volatile void* mapping;
+    uintptr_t      table_entry;
+
+    if(device == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    cap = pci_find_capability(device, PCI_CAP_ID_MSIX, 0);
+    if(cap == 0)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    control = pci_read_config_16(device, cap + PCI_MSIX_CONTROL);
+    if(entry > (control & PCI_MSIX_SIZE_MASK))
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    table = pci_read_config_32(device, cap + PCI_MSIX_TABLE);
+    err = pci_map_bar(device, table & PCI_MSIX_BIR_MASK,
+                      (table & ~PCI_MSIX_BIR_MASK) +
+                      entry * PCI_MSIX_ENTRY_SIZE,
+                      PCI_MSIX_ENTRY_SIZE,
+                      &mapping);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+    table_entry = (uintptr_t)mapping;
+
+    /* The entry is masked while its message is changed */
+    _mapped_io_write_32((void*)(table_entry + 12),
+                        _mapped_io_read_32((void*)(table_entry + 12)) |
+                        PCI_MSIX_ENTRY_MASKED);
+    _mapped_io_write_32((void*)table_entry, (uint32_t)address);
+    _mapped_io_write_32((void*)(table_entry + 4), (uint32_t)(address >> 32));
+    _mapped_io_write_32((void*)(table_entry + 8), data);
+    _mapped_io_write_32((void*)(table_entry + 12),
+                        _mapped_io_read_32((void*)(table_entry + 12)) &
+                        ~PCI_MSIX_ENTRY_MASKED);
+
+    control |= PCI_MSIX_ENABLE;
+    control &= ~PCI_MSIX_FUNC_MASK;
+    pci_write_config_16(device, cap + PCI_MSIX_CONTROL, control);
+
+    KERNEL_DEBUG(PCI_DEBUG_ENABLED, MODULE_NAME,
+                 "MSI-X entry %u of %u:%u.%u set, data 0x%x",
+                 entry, device->bus, device->device, device->function,
+                 data);
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
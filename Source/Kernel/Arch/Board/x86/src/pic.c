@@ -0,0 +1,323 @@
+/*******************************************************************************
+ * @file pic.c
+ *
+ * @see pic.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief 8259 PIC interrupt driver.
+ *
+ * @details 8259 PIC interrupt driver. The driver is the fallback interrupt
+ * driver of the systems without IO-APIC: the master and slave PICs are
+ * remapped after the exceptions and all the IRQs are delivered to the BSP.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <cpu.h>            /* CPU ports access */
+#include <cpu_interrupt.h>  /* CPU interrupts settings */
+#include <critical.h>       /* Kernel spinlocks */
+#include <interrupts.h>     /* Interrupt driver interface */
+#include <kernel_output.h>  /* Kernel outputs */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <pic.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module name */
+#define MODULE_NAME "X86 PIC"
+
+/** @brief Master PIC command port. */
+#define PIC_MASTER_COMM_PORT 0x20
+/** @brief Master PIC data port. */
+#define PIC_MASTER_DATA_PORT 0x21
+/** @brief Slave PIC command port. */
+#define PIC_SLAVE_COMM_PORT  0xA0
+/** @brief Slave PIC data port. */
+#define PIC_SLAVE_DATA_PORT  0xA1
+
+/** @brief ICW1: initialization, ICW4 needed. */
+#define PIC_ICW1_INIT    0x11
+/** @brief ICW3 of the master: slave on IRQ 2. */
+#define PIC_ICW3_MASTER  0x04
+/** @brief ICW3 of the slave: cascade identity 2. */
+#define PIC_ICW3_SLAVE   0x02
+/** @brief ICW4: 8086 mode. */
+#define PIC_ICW4_8086    0x01
+/** @brief OCW3: the next command port read returns the ISR. */
+#define PIC_OCW3_READ_ISR 0x0B
+/** @brief Non specific end of interrupt command. */
+#define PIC_EOI          0x20
+
+/** @brief Mask value that masks all the IRQs of a PIC. */
+#define PIC_MASK_ALL     0xFF
+/** @brief Master PIC mask value that only leaves the cascade IRQ unmasked. */
+#define PIC_MASK_CASCADE 0xFB
+
+/** @brief Number of IRQs of each PIC. */
+#define PIC_IRQ_PER_PIC  8
+
+/** @brief In service bit of the IRQs that can be spurious. */
+#define PIC_SPURIOUS_ISR_BIT 0x80
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief PIC interrupt driver instance. */
+static interrupt_driver_t pic_driver;
+
+/** @brief Lock protecting the PICs registers. */
+static kernel_spinlock_t pic_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Masks or unmasks an IRQ.
+ *
+ * @param[in] irq_number The IRQ number.
+ * @param[in] enabled TRUE to unmask the IRQ, FALSE to mask it.
+ */
+static void _pic_set_irq_mask(const uint32_t irq_number, const bool_t enabled);
+
+/**
+ * @brief Acknowledges an IRQ.
+ *
+ * @param[in] irq_number The IRQ number.
+ */
+static void _pic_set_irq_eoi(const uint32_t irq_number);
+
+/**
+ * @brief Checks if an interrupt is a spurious PIC IRQ.
+ *
+ * @details Checks the in service register of the PIC when the interrupt is
+ * the lowest priority IRQ of a PIC. A spurious slave IRQ is acknowledged on
+ * the master PIC, which saw a regular cascade IRQ.
+ *
+ * @param[in] int_number The interrupt line.
+ *
+ * @return INTERRUPT_TYPE_SPURIOUS for a spurious IRQ, INTERRUPT_TYPE_REGULAR
+ * otherwise.
+ */
+static INTERRUPT_TYPE_E _pic_handle_spurious(const uint32_t int_number);
+
+/**
+ * @brief Returns the interrupt line of an IRQ.
+ *
+ * @param[in] irq_number The IRQ number.
+ *
+ * @return The interrupt line of the IRQ, -1 if the IRQ does not exist.
+ */
+static int32_t _pic_get_irq_int_line(const uint32_t irq_number);
+
+/**
+ * @brief Routes an IRQ to a CPU.
+ *
+ * @details The PICs only deliver their IRQs to the BSP.
+ *
+ * @param[in] irq_number The IRQ number.
+ * @param[in] cpu_id The CPU identifier.
+ *
+ * @return OS_NO_ERR for the BSP, OS_ERR_NOT_SUPPORTED for the other CPUs and
+ * OS_ERR_NO_SUCH_IRQ if the IRQ does not exist.
+ */
+static OS_RETURN_E _pic_set_irq_affinity(const uint32_t irq_number,
+                                         const uint32_t cpu_id);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void _pic_set_irq_mask(const uint32_t irq_number, const bool_t enabled)
+{
+    uint32_t int_state;
+    uint16_t port;
+    uint8_t  mask;
+    uint8_t  value;
+
+    if(irq_number > PIC_MAX_IRQ_LINE)
+    {
+        return;
+    }
+
+    if(irq_number < PIC_IRQ_PER_PIC)
+    {
+        port = PIC_MASTER_DATA_PORT;
+        mask = (uint8_t)(1 << irq_number);
+    }
+    else
+    {
+        port = PIC_SLAVE_DATA_PORT;
+        mask = (uint8_t)(1 << (irq_number - PIC_IRQ_PER_PIC));
+    }
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(pic_lock, int_state);
+
+    value = _cpu_inb(port);
+    if(enabled == TRUE)
+    {
+        value &= ~mask;
+    }
+    else
+    {
+        value |= mask;
+    }
+    _cpu_outb(value, port);
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(pic_lock, int_state);
+
+    KERNEL_DEBUG(PIC_DEBUG_ENABLED, MODULE_NAME,
+                 "IRQ %u mask set to %u", irq_number, enabled);
+}
+
+static void _pic_set_irq_eoi(const uint32_t irq_number)
+{
+    if(irq_number > PIC_MAX_IRQ_LINE)
+    {
+        return;
+    }
+
+    if(irq_number >= PIC_IRQ_PER_PIC)
+    {
+        _cpu_outb(PIC_EOI, PIC_SLAVE_COMM_PORT);
+    }
+    _cpu_outb(PIC_EOI, PIC_MASTER_COMM_PORT);
+}
+
+static INTERRUPT_TYPE_E _pic_handle_spurious(const uint32_t int_number)
+{
+    INTERRUPT_TYPE_E type;
+    uint32_t         int_state;
+    uint8_t          isr;
+
+    if(int_number == (INT_PIC_IRQ_OFFSET + PIC_SPURIOUS_IRQ_MASTER))
+    {
+        KERNEL_SPINLOCK_LOCK_IRQSAVE(pic_lock, int_state);
+        _cpu_outb(PIC_OCW3_READ_ISR, PIC_MASTER_COMM_PORT);
+        isr = _cpu_inb(PIC_MASTER_COMM_PORT);
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(pic_lock, int_state);
+
+        type = ((isr & PIC_SPURIOUS_ISR_BIT) == 0) ? INTERRUPT_TYPE_SPURIOUS :
+                                                     INTERRUPT_TYPE_REGULAR;
+    }
+    else if(int_number == (INT_PIC_IRQ_OFFSET + PIC_SPURIOUS_IRQ_SLAVE))
+    {
+        KERNEL_SPINLOCK_LOCK_IRQSAVE(pic_lock, int_state);
+        _cpu_outb(PIC_OCW3_READ_ISR, PIC_SLAVE_COMM_PORT);
+        isr = _cpu_inb(PIC_SLAVE_COMM_PORT);
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(pic_lock, int_state);
+
+        type = INTERRUPT_TYPE_REGULAR;
+        if((isr & PIC_SPURIOUS_ISR_BIT) == 0)
+        {
+            _cpu_outb(PIC_EOI, PIC_MASTER_COMM_PORT);
+            type = INTERRUPT_TYPE_SPURIOUS;
+        }
+    }
+    else
+    {
+        type = INTERRUPT_TYPE_REGULAR;
+    }
+
+    return type;
+}
+
+static int32_t _pic_get_irq_int_line(const uint32_t irq_number)
+{
+    if(irq_number > PIC_MAX_IRQ_LINE)
+    {
+        return -1;
+    }
+
+    return irq_number + INT_PIC_IRQ_OFFSET;
+}
+
+static OS_RETURN_E _pic_set_irq_affinity(const uint32_t irq_number,
+                                         const uint32_t cpu_id)
+{
+    if(irq_number > PIC_MAX_IRQ_LINE)
+    {
+        return OS_ERR_NO_SUCH_IRQ;
+    }
+
+    return cpu_id == 0 ? OS_NO_ERR : OS_ERR_NOT_SUPPORTED;
+}
+
+void pic_init(void)
+{
+    /* Remap the IRQs after the exceptions */
+    _cpu_outb(PIC_ICW1_INIT, PIC_MASTER_COMM_PORT);
+    _cpu_outb(PIC_ICW1_INIT, PIC_SLAVE_COMM_PORT);
+    _cpu_outb(INT_PIC_IRQ_OFFSET, PIC_MASTER_DATA_PORT);
+    _cpu_outb(INT_PIC_IRQ_OFFSET + PIC_IRQ_PER_PIC, PIC_SLAVE_DATA_PORT);
+    _cpu_outb(PIC_ICW3_MASTER, PIC_MASTER_DATA_PORT);
+    _cpu_outb(PIC_ICW3_SLAVE, PIC_SLAVE_DATA_PORT);
+    _cpu_outb(PIC_ICW4_8086, PIC_MASTER_DATA_PORT);
+    _cpu_outb(PIC_ICW4_8086, PIC_SLAVE_DATA_PORT);
+
+    /* The IRQs are unmasked by their drivers */
+    _cpu_outb(PIC_MASK_CASCADE, PIC_MASTER_DATA_PORT);
+    _cpu_outb(PIC_MASK_ALL, PIC_SLAVE_DATA_PORT);
+
+    /* Init driver */
+    pic_driver.driver_set_irq_mask      = _pic_set_irq_mask;
+    pic_driver.driver_set_irq_eoi       = _pic_set_irq_eoi;
+    pic_driver.driver_handle_spurious   = _pic_handle_spurious;
+    pic_driver.driver_get_irq_int_line  = _pic_get_irq_int_line;
+    pic_driver.driver_set_irq_affinity  = _pic_set_irq_affinity;
+
+    KERNEL_SUCCESS("PIC initialized\n");
+}
+
+void pic_disable(void)
+{
+    _cpu_outb(PIC_MASK_ALL, PIC_MASTER_DATA_PORT);
+    _cpu_outb(PIC_MASK_ALL, PIC_SLAVE_DATA_PORT);
+
+    KERNEL_DEBUG(PIC_DEBUG_ENABLED, MODULE_NAME, "PIC disabled");
+}
+
+const interrupt_driver_t* pic_get_driver(void)
+{
+    return &pic_driver;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
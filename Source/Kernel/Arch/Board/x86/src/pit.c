@@ -0,0 +1,230 @@
+/*******************************************************************************
+ * @file pit.c
+ *
+ * @see pit.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief PIT (Programmable Interval Timer) driver.
+ *
+ * @details PIT (Programmable Interval Timer) driver. The PIT channel 2 is used
+ * in one-shot mode as a calibrated delay source, mainly during the boot
+ * sequence to calibrate the other timers and to wait for the hardware. The
+ * delays are polled and do not rely on the PIT interrupt. The PIT channel 0
+ * runs as a rate generator over its whole 16 bits count and gives the
+ * fallback clock source, its count is extended to 64 bits on each read. The
+ * channel 0 interrupt stays masked.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <cpu.h>            /* CPU ports */
+#include <critical.h>       /* Critical sections */
+#include <time_mgt.h>       /* Clock source interface */
+#include <kernel_output.h>  /* Kernel outputs */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <pit.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module name */
+#define MODULE_NAME "X86 PIT"
+
+/** @brief PIT channel 0 data port. */
+#define PIT_CHANNEL0_PORT    0x40
+/** @brief PIT channel 2 data port. */
+#define PIT_CHANNEL2_PORT    0x42
+/** @brief PIT command port. */
+#define PIT_COMMAND_PORT     0x43
+/** @brief PIT command: channel 0, low/high byte access, rate generator. */
+#define PIT_CHANNEL0_RATE    0x34
+/** @brief PIT command: channel 0 count latch. */
+#define PIT_CHANNEL0_LATCH   0x00
+/** @brief PIT command: channel 2, low/high byte access, one-shot mode. */
+#define PIT_CHANNEL2_ONESHOT 0xB0
+/** @brief Maximal delay that fits in one PIT channel 2 count. */
+#define PIT_MAX_DELAY_US     50000
+/** @brief PIT channel 2 control port (port B). */
+#define PIT_CONTROL_PORT_B   0x61
+/** @brief Port B PIT channel 2 gate bit. */
+#define PIT_CHANNEL2_GATE    0x01
+/** @brief Port B PC speaker enable bit. */
+#define PIT_SPEAKER_ENABLE   0x02
+/** @brief Port B PIT channel 2 output bit. */
+#define PIT_CHANNEL2_OUT     0x20
+
+/**
+ * @brief Maximal time between two reads of the PIT clock source. The channel
+ * 0 count wraps every 65536 ticks, about 55ms.
+ */
+#define PIT_CLOCK_MAX_IDLE_NS 25000000ULL
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief PIT clock source instance. */
+static kernel_clocksource_t pit_clocksource;
+
+/** @brief Channel 0 count at the last clock source read. */
+static uint16_t pit_clock_last_count;
+
+/** @brief Channel 0 ticks elapsed since the clock source was initialized. */
+static uint64_t pit_clock_ticks;
+
+/** @brief Lock protecting the channel 0 count extension. */
+static kernel_spinlock_t pit_clock_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Latches and reads the PIT channel 0 count.
+ *
+ * @return The PIT channel 0 count.
+ */
+inline static uint16_t _pit_read_channel0(void);
+
+/**
+ * @brief Returns the PIT clock source counter.
+ *
+ * @details Returns the number of PIT ticks elapsed since the clock source was
+ * initialized. The ticks elapsed since the last read are added to the
+ * counter, the function must be called at least once per channel 0 period.
+ *
+ * @return The PIT clock source counter.
+ */
+static uint64_t _pit_clock_read(void);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static uint16_t _pit_read_channel0(void)
+{
+    uint16_t count;
+
+    _cpu_outb(PIT_CHANNEL0_LATCH, PIT_COMMAND_PORT);
+    count  = _cpu_inb(PIT_CHANNEL0_PORT);
+    count |= (uint16_t)_cpu_inb(PIT_CHANNEL0_PORT) << 8;
+
+    return count;
+}
+
+static uint64_t _pit_clock_read(void)
+{
+    uint64_t ticks;
+    uint32_t int_state;
+    uint16_t count;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(pit_clock_lock, int_state);
+
+    /* The count decreases and wraps, the difference is modulo 65536 */
+    count                 = _pit_read_channel0();
+    pit_clock_ticks      += (uint16_t)(pit_clock_last_count - count);
+    pit_clock_last_count  = count;
+    ticks                 = pit_clock_ticks;
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(pit_clock_lock, int_state);
+
+    return ticks;
+}
+
+void pit_busy_wait(uint32_t delay_us)
+{
+    uint32_t chunk;
+    uint32_t count;
+    uint8_t  control;
+
+    KERNEL_DEBUG(PIT_DEBUG_ENABLED, MODULE_NAME, "Waiting %uus", delay_us);
+
+    /* Enable the PIT channel 2 gate, keep the speaker disabled */
+    control = _cpu_inb(PIT_CONTROL_PORT_B);
+    control = (control & ~PIT_SPEAKER_ENABLE) | PIT_CHANNEL2_GATE;
+    _cpu_outb(control, PIT_CONTROL_PORT_B);
+
+    while(delay_us > 0)
+    {
+        chunk = (delay_us > PIT_MAX_DELAY_US) ? PIT_MAX_DELAY_US : delay_us;
+        count = (uint32_t)(((uint64_t)chunk * PIT_INPUT_FREQ) / 1000000);
+
+        /* In one-shot mode, the output goes high when the count reaches 0 */
+        _cpu_outb(PIT_CHANNEL2_ONESHOT, PIT_COMMAND_PORT);
+        _cpu_outb(count & 0xFF, PIT_CHANNEL2_PORT);
+        _cpu_outb((count >> 8) & 0xFF, PIT_CHANNEL2_PORT);
+
+        while((_cpu_inb(PIT_CONTROL_PORT_B) & PIT_CHANNEL2_OUT) == 0)
+        {
+            _cpu_pause();
+        }
+
+        delay_us -= chunk;
+    }
+}
+
+void pit_clock_init(void)
+{
+    uint32_t int_state;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(pit_clock_lock, int_state);
+
+    /* A reload value of 0 is a 65536 ticks period */
+    _cpu_outb(PIT_CHANNEL0_RATE, PIT_COMMAND_PORT);
+    _cpu_outb(0, PIT_CHANNEL0_PORT);
+    _cpu_outb(0, PIT_CHANNEL0_PORT);
+
+    pit_clock_last_count = _pit_read_channel0();
+    pit_clock_ticks      = 0;
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(pit_clock_lock, int_state);
+
+    pit_clocksource.name        = "pit";
+    pit_clocksource.read        = _pit_clock_read;
+    pit_clocksource.frequency   = PIT_INPUT_FREQ;
+    pit_clocksource.max_idle_ns = PIT_CLOCK_MAX_IDLE_NS;
+
+    KERNEL_DEBUG(PIT_DEBUG_ENABLED, MODULE_NAME, "Channel 0 clock started");
+}
+
+const kernel_clocksource_t* pit_get_clocksource(void)
+{
+    return &pit_clocksource;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
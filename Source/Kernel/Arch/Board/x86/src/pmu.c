@@ -0,0 +1,264 @@
+/*******************************************************************************
+ * @file pmu.c
+ *
+ * @see pmu.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief x86 architectural performance monitoring unit driver.
+ *
+ * @details x86 architectural performance monitoring unit driver. The sampling
+ * period is converted to core cycles with the TSC frequency, the counter is
+ * loaded with the negated period and reloaded by the overflow handler. The
+ * local APIC masks the performance counter LVT entry on overflow, the handler
+ * unmasks it.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <cpu.h>            /* CPU management */
+#include <cpu_interrupt.h>  /* CPU interrupts settings */
+#include <interrupts.h>     /* Interrupts management */
+#include <lapic.h>          /* Local APIC driver */
+#include <tsc.h>            /* TSC frequency */
+#include <profiler.h>       /* Kernel profiler */
+#include <time_mgt.h>       /* Time constants */
+#include <kernel_output.h>  /* Kernel outputs */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <pmu.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module name */
+#define MODULE_NAME "X86 PMU"
+
+/** @brief CPUID architectural performance monitoring leaf. */
+#define CPUID_PMU_LEAF 0x0000000A
+
+/** @brief IA32_PMC0 MSR. */
+#define PMU_MSR_PMC0             0x000000C1
+/** @brief IA32_PERFEVTSEL0 MSR. */
+#define PMU_MSR_PERFEVTSEL0      0x00000186
+/** @brief IA32_PERF_GLOBAL_CTRL MSR. */
+#define PMU_MSR_GLOBAL_CTRL      0x0000038F
+/** @brief IA32_PERF_GLOBAL_OVF_CTRL MSR. */
+#define PMU_MSR_GLOBAL_OVF_CTRL  0x00000390
+
+/** @brief Unhalted core cycles architectural event. */
+#define PMU_EVENT_CORE_CYCLES 0x0000003C
+/** @brief PERFEVTSEL: counts in user mode. */
+#define PMU_EVTSEL_USR        0x00010000
+/** @brief PERFEVTSEL: counts in kernel mode. */
+#define PMU_EVTSEL_OS         0x00020000
+/** @brief PERFEVTSEL: interrupt on overflow. */
+#define PMU_EVTSEL_INT        0x00100000
+/** @brief PERFEVTSEL: counter enabled. */
+#define PMU_EVTSEL_EN         0x00400000
+
+/** @brief Largest sampling period in cycles, the counters are at least 32
+ * bits wide and the reload value is sign extended from bit 31.
+ */
+#define PMU_MAX_PERIOD_CYCLES 0x7FFFFFFFULL
+/** @brief Smallest sampling period in cycles. */
+#define PMU_MIN_PERIOD_CYCLES 10000ULL
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Architectural performance monitoring version. */
+static uint32_t pmu_version = 0;
+
+/** @brief Sampling period in cycles. */
+static uint64_t pmu_period_cycles;
+
+/** @brief PMU profiler source. */
+static profiler_source_t pmu_source;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Loads the counter with the sampling period.
+ */
+inline static void _pmu_reload(void);
+
+/**
+ * @brief Starts the cycles counter of the calling CPU.
+ *
+ * @param[in] period_ns The sampling period in nanoseconds.
+ *
+ * @return OS_NO_ERR.
+ */
+static OS_RETURN_E _pmu_start_local(const uint64_t period_ns);
+
+/**
+ * @brief Stops the cycles counter of the calling CPU.
+ */
+static void _pmu_stop_local(void);
+
+/**
+ * @brief Counter overflow interrupt handler.
+ *
+ * @param[in] curr_thread The interrupted thread.
+ */
+static void _pmu_overflow_handler(kernel_thread_t* curr_thread);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static void _pmu_reload(void)
+{
+    _cpu_set_msr(PMU_MSR_PMC0,
+                 (uint64_t)-(int64_t)pmu_period_cycles & 0xFFFFFFFFULL);
+}
+
+static OS_RETURN_E _pmu_start_local(const uint64_t period_ns)
+{
+    uint64_t cycles;
+
+    cycles = tsc_get_frequency() / 1000 * (period_ns / 1000) / 1000;
+    if(cycles < PMU_MIN_PERIOD_CYCLES)
+    {
+        cycles = PMU_MIN_PERIOD_CYCLES;
+    }
+    else if(cycles > PMU_MAX_PERIOD_CYCLES)
+    {
+        cycles = PMU_MAX_PERIOD_CYCLES;
+    }
+    pmu_period_cycles = cycles;
+
+    _cpu_set_msr(PMU_MSR_PERFEVTSEL0, 0);
+    _pmu_reload();
+    lapic_write(LAPIC_LVT_PERF, LAPIC_PMC_INTERRUPT_LINE);
+    if(pmu_version >= 2)
+    {
+        _cpu_set_msr(PMU_MSR_GLOBAL_OVF_CTRL, 1);
+        _cpu_set_msr(PMU_MSR_GLOBAL_CTRL, 1);
+    }
+    _cpu_set_msr(PMU_MSR_PERFEVTSEL0,
+                 PMU_EVENT_CORE_CYCLES | PMU_EVTSEL_USR | PMU_EVTSEL_OS |
+                 PMU_EVTSEL_INT | PMU_EVTSEL_EN);
+
+    KERNEL_DEBUG(PROFILER_DEBUG_ENABLED, MODULE_NAME,
+                 "Started with a %u cycles period", (uint32_t)cycles);
+
+    return OS_NO_ERR;
+}
+
+static void _pmu_stop_local(void)
+{
+    _cpu_set_msr(PMU_MSR_PERFEVTSEL0, 0);
+    if(pmu_version >= 2)
+    {
+        _cpu_set_msr(PMU_MSR_GLOBAL_CTRL, 0);
+        _cpu_set_msr(PMU_MSR_GLOBAL_OVF_CTRL, 1);
+    }
+    lapic_write(LAPIC_LVT_PERF, LAPIC_LVT_MASKED | LAPIC_PMC_INTERRUPT_LINE);
+}
+
+static void _pmu_overflow_handler(kernel_thread_t* curr_thread)
+{
+    profiler_sample(curr_thread);
+
+    _pmu_reload();
+    if(pmu_version >= 2)
+    {
+        _cpu_set_msr(PMU_MSR_GLOBAL_OVF_CTRL, 1);
+    }
+
+    /* The counter is stopped between the overflow and the stop request */
+    if((_cpu_get_msr(PMU_MSR_PERFEVTSEL0) & PMU_EVTSEL_EN) != 0)
+    {
+        lapic_write(LAPIC_LVT_PERF, LAPIC_PMC_INTERRUPT_LINE);
+    }
+
+    lapic_eoi();
+}
+
+OS_RETURN_E pmu_init(void)
+{
+    uint32_t    regs[4];
+    OS_RETURN_E err;
+
+    if(_cpu_get_cpuid_max(0) < CPUID_PMU_LEAF ||
+       _cpu_cpuid(CPUID_PMU_LEAF, regs) == 0)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    /* EAX: version, number of counters, EBX bit 0 set if the core cycles
+     * event is not available.
+     */
+    if((regs[0] & 0xFF) == 0 || ((regs[0] >> 8) & 0xFF) == 0 ||
+       ((regs[0] >> 24) & 0xFF) == 0 || (regs[1] & 0x1) != 0)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+    if(lapic_is_enabled() == FALSE || tsc_get_frequency() == 0)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    err = kernel_interrupt_register_int_handler(LAPIC_PMC_INTERRUPT_LINE,
+                                                _pmu_overflow_handler);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    pmu_version            = regs[0] & 0xFF;
+    pmu_source.name        = "pmu";
+    pmu_source.start_local = _pmu_start_local;
+    pmu_source.stop_local  = _pmu_stop_local;
+
+    KERNEL_SUCCESS("PMU version %u, %u counters\n", pmu_version,
+                   (regs[0] >> 8) & 0xFF);
+
+    return OS_NO_ERR;
+}
+
+const profiler_source_t* pmu_get_profiler_source(void)
+{
+    return &pmu_source;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
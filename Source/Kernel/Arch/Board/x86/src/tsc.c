@@ -0,0 +1,198 @@
+/*******************************************************************************
+ * @file tsc.c
+ *
+ * @see tsc.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief TSC (Time Stamp Counter) clock source driver.
+ *
+ * @details TSC (Time Stamp Counter) clock source driver. The TSC is compared
+ * to a short and a long PIT delay, the frequency is computed from the
+ * difference of the two measures: the time spent to start and to detect the
+ * end of a delay cancels out. The shortest measures of several rounds are
+ * kept, the longer ones were disturbed by the hypervisor or the firmware.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <cpu.h>            /* CPU management */
+#include <pit.h>            /* PIT delays */
+#include <kvmclock.h>       /* KVM published TSC frequency */
+#include <time_mgt.h>       /* Clock source interface */
+#include <kernel_output.h>  /* Kernel outputs */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <tsc.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module name */
+#define MODULE_NAME "X86 TSC"
+
+/** @brief CPUID leaf 1 EDX: TSC present. */
+#define CPUID_EDX_TSC 0x00000010
+
+/** @brief Short calibration delay in microseconds. */
+#define TSC_CALIBRATION_SHORT_US 2000
+/** @brief Long calibration delay in microseconds. */
+#define TSC_CALIBRATION_LONG_US  12000
+/** @brief Number of calibration rounds. */
+#define TSC_CALIBRATION_ROUNDS   3
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief TSC clock source instance. */
+static kernel_clocksource_t tsc_clocksource;
+
+/** @brief Calibrated TSC frequency in Hz. */
+static uint64_t tsc_frequency = 0;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Measures the TSC ticks elapsed during a PIT delay.
+ *
+ * @param[in] delay_us The PIT delay in microseconds.
+ *
+ * @return The TSC ticks elapsed during the delay.
+ */
+static uint64_t _tsc_measure(const uint32_t delay_us);
+
+/**
+ * @brief Returns the TSC clock source counter.
+ *
+ * @return The TSC value.
+ */
+static uint64_t _tsc_read(void);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static uint64_t _tsc_measure(const uint32_t delay_us)
+{
+    uint64_t start;
+
+    start = _cpu_rdtsc();
+    pit_busy_wait(delay_us);
+
+    return _cpu_rdtsc() - start;
+}
+
+static uint64_t _tsc_read(void)
+{
+    return _cpu_rdtsc();
+}
+
+OS_RETURN_E tsc_init(void)
+{
+    uint32_t regs[4];
+    uint64_t short_ticks;
+    uint64_t long_ticks;
+    uint64_t min_short;
+    uint64_t min_long;
+    uint32_t i;
+
+    if(_cpu_cpuid(0x1, regs) == 0 || (regs[3] & CPUID_EDX_TSC) == 0)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    /* The hypervisor published the frequency, the PIT is emulated anyway */
+    tsc_frequency = kvmclock_get_tsc_frequency();
+    if(tsc_frequency == 0)
+    {
+        min_short = UINT64_MAX;
+        min_long  = UINT64_MAX;
+        for(i = 0; i < TSC_CALIBRATION_ROUNDS; ++i)
+        {
+            short_ticks = _tsc_measure(TSC_CALIBRATION_SHORT_US);
+            long_ticks  = _tsc_measure(TSC_CALIBRATION_LONG_US);
+
+            if(short_ticks < min_short)
+            {
+                min_short = short_ticks;
+            }
+            if(long_ticks < min_long)
+            {
+                min_long = long_ticks;
+            }
+
+            KERNEL_DEBUG(TIME_MGT_DEBUG_ENABLED, MODULE_NAME,
+                         "Calibration round %u: %u / %u ticks", i,
+                         (uint32_t)short_ticks, (uint32_t)long_ticks);
+        }
+
+        if(min_long <= min_short)
+        {
+            return OS_ERR_NOT_SUPPORTED;
+        }
+
+        tsc_frequency = (min_long - min_short) * 1000000ULL /
+                        (TSC_CALIBRATION_LONG_US - TSC_CALIBRATION_SHORT_US);
+    }
+
+    KERNEL_TRACE_SET_CLOCK_FREQ(tsc_frequency);
+
+    tsc_clocksource.name        = "tsc";
+    tsc_clocksource.read        = _tsc_read;
+    tsc_clocksource.frequency   = tsc_frequency;
+    tsc_clocksource.max_idle_ns = 0;
+
+    KERNEL_SUCCESS("TSC calibrated at %uKHz\n",
+                   (uint32_t)(tsc_frequency / 1000));
+
+    return OS_NO_ERR;
+}
+
+uint64_t tsc_get_frequency(void)
+{
+    return tsc_frequency;
+}
+
+const kernel_clocksource_t* tsc_get_clocksource(void)
+{
+    return &tsc_clocksource;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -7,13 +7,17 @@
  *
  * @date 23/04/2023
  *
- * @version 1.0
+ * @version 2.1
  *
  * @brief UART communication driver.
  *
  * @details UART communication driver. Initializes the uart ports as in and
  * output. The uart can be used to output data or communicate with other
- * prepherals that support this communication method
+ * prepherals that support this communication method. Once the transmit
+ * interrupt is enabled, the output is copied to a ring buffer drained by the
+ * interrupt handler, otherwise the output is polled and written by bursts of
+ * the FIFO size. Once the receive interrupt of a port is enabled, the input is
+ * stored in a per-port ring buffer and the readers wait for it.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -30,6 +34,9 @@
 #include <cpu.h>            /* CPU Ports */
 #include <kernel_output.h>  /* Kernel outputs */
 #include <critical.h>       /* Critical sections */
+#include <interrupts.h>     /* Interrupt manager */
+#include <scheduler.h>      /* Kernel scheduler */
+#include <ioring.h>         /* Asynchronous I/O rings */
 
 /* Configuration files */
 #include <config.h>
@@ -44,27 +51,55 @@
 /** @brief Current module name */
 #define MODULE_NAME "X86 UART"
 
-/** @brief Serial COM1 base port ID. */
-#define SERIAL_COM1_BASE 0x3F8
-/** @brief Serial COM2 base port ID. */
-#define SERIAL_COM2_BASE 0x2F8
-/** @brief Serial COM3 base port ID. */
-#define SERIAL_COM3_BASE 0x3E8
-/** @brief Serial COM4 base port ID. */
-#define SERIAL_COM4_BASE 0x2E8
-
-/** @brief Redefinition of serial COM1 base port ID for ease of use. */
-#define COM1 SERIAL_COM1_BASE
-/** @brief Redefinition of serial COM2 base port ID for ease of use. */
-#define COM2 SERIAL_COM2_BASE
-/** @brief Redefinition of serial COM3 base port ID for ease of use. */
-#define COM3 SERIAL_COM3_BASE
-/** @brief Redefinition of serial COM4 base port ID for ease of use. */
-#define COM4 SERIAL_COM4_BASE
-
 /** @brief Defines the port that is used to print data. */
 #define SERIAL_OUTPUT_PORT COM1
 
+/** @brief Defines the port that is used to stream the trace packets. */
+#define SERIAL_TRACE_PORT COM2
+
+/** @brief IRQ raised by COM1. */
+#define SERIAL_COM1_IRQ 4
+/** @brief IRQ raised by COM2. */
+#define SERIAL_COM2_IRQ 3
+
+/** @brief Number of ports that can be driven by their interrupt. */
+#define SERIAL_IRQ_PORT_COUNT 2
+
+/** @brief Size of the transmit ring buffer, must be a power of 2. */
+#define SERIAL_TX_BUFFER_SIZE 2048
+
+/** @brief Size of the receive ring buffers, must be a power of 2. */
+#define SERIAL_RX_BUFFER_SIZE 256
+
+/** @brief Maximal number of interrupt causes serviced per interrupt. */
+#define SERIAL_IRQ_MAX_CAUSES 8
+
+/** @brief Number of bytes the transmit FIFO can receive once empty. */
+#define SERIAL_TX_FIFO_SIZE 16
+
+/** @brief Serial line status flag: data ready. */
+#define SERIAL_LINE_STATUS_DATA_READY 0x01
+/** @brief Serial line status flag: transmit holding register empty. */
+#define SERIAL_LINE_STATUS_THR_EMPTY  0x20
+
+/** @brief Serial interrupt identification flag: no interrupt pending. */
+#define SERIAL_INT_ID_NONE         0x01
+/** @brief Serial interrupt identification mask. */
+#define SERIAL_INT_ID_MASK         0x0E
+/** @brief Serial interrupt identification: transmit holding register empty. */
+#define SERIAL_INT_ID_THR_EMPTY    0x02
+/** @brief Serial interrupt identification: received data available. */
+#define SERIAL_INT_ID_RECV_DATA    0x04
+/** @brief Serial interrupt identification: receiver line status. */
+#define SERIAL_INT_ID_LINE_STATUS  0x06
+/** @brief Serial interrupt identification: receive FIFO timeout. */
+#define SERIAL_INT_ID_RECV_TIMEOUT 0x0C
+
+/** @brief Serial interrupt enable flag: received data available. */
+#define SERIAL_INT_RECV_DATA 0x01
+/** @brief Serial interrupt enable flag: transmit holding register empty. */
+#define SERIAL_INT_THR_EMPTY 0x02
+
 /** @brief Serial data length flag: 5 bits. */
 #define SERIAL_DATA_LENGTH_5 0x00
 /** @brief Serial data length flag: 6 bits. */
@@ -156,6 +191,13 @@
  * @param[in] port The base port ID of the serial port.
  */
 #define SERIAL_LINE_STATUS_PORT(port)   (port + 5)
+/**
+ * @brief Computes the modem status port for the serial port which base port ID
+ * is given as parameter.
+ *
+ * @param[in] port The base port ID of the serial port.
+ */
+#define SERIAL_MODEM_STATUS_PORT(port)  (port + 6)
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
@@ -200,6 +242,49 @@ typedef enum
     BAUDRATE_115200 = 1,
 } SERIAL_BAUDRATE_E;
 
+/** @brief Interrupt state of a serial port. */
+typedef struct
+{
+    /** @brief Base port ID of the serial port. */
+    uint32_t base;
+
+    /** @brief IRQ raised by the serial port. */
+    uint32_t irq;
+
+    /** @brief Tells if the port interrupt handler is attached. */
+    bool_t irq_attached;
+
+    /** @brief Value of the interrupt enable register. */
+    uint8_t int_enable;
+
+    /** @brief Protects the interrupt enable register. */
+    kernel_spinlock_t int_lock;
+
+    /** @brief Receive ring buffer, filled by the interrupt handler. */
+    uint8_t rx_buffer[SERIAL_RX_BUFFER_SIZE];
+
+    /** @brief Receive ring write index. */
+    uint32_t rx_head;
+
+    /** @brief Receive ring read index. */
+    uint32_t rx_tail;
+
+    /** @brief Tells if the input is read by the receive interrupt. */
+    volatile bool_t rx_interrupt_enabled;
+
+    /** @brief Thread waiting for received bytes, NULL if none. */
+    kernel_thread_t* rx_waiter;
+
+    /** @brief Read request waiting for received bytes, NULL if none. */
+    ioring_request_t* rx_request;
+
+    /** @brief Asynchronous I/O target of the port. */
+    ioring_target_t ioring_target;
+
+    /** @brief Protects the receive ring buffer and its waiter. */
+    kernel_spinlock_t rx_lock;
+} uart_port_t;
+
 /*******************************************************************************
  * MACROS
  ******************************************************************************/
@@ -235,8 +320,52 @@ static kernel_console_driver_t uart_text_driver =
     .console_write_keyboard = uart_console_write_keyboard
 };
 
+/**
+ * @brief Serial trace output driver instance.
+ */
+static kernel_trace_output_t uart_trace_driver =
+{
+    .write = uart_trace_write
+};
+
 /** @brief Concurrency lock for the uart driver*/
-static uint32_t uart_lock = KERNEL_SPINLOCK_INIT_VALUE;
+static kernel_spinlock_t uart_lock =
+    KERNEL_SPINLOCK_INIT_VALUE_TYPE(UART_SPINLOCK_TYPE);
+
+/**
+ * @brief Transmit ring buffer of the output port. The writers, serialized by
+ * uart_lock, are the only producer and the drain is the only consumer.
+ */
+static uint8_t tx_buffer[SERIAL_TX_BUFFER_SIZE];
+
+/** @brief Transmit ring write index, only written by the producer. */
+static uint32_t tx_head = 0;
+
+/** @brief Transmit ring read index, only written by the consumer. */
+static uint32_t tx_tail = 0;
+
+/** @brief Tells if the output is drained by the transmit interrupt. */
+static volatile bool_t tx_interrupt_enabled = FALSE;
+
+/** @brief Serializes the drains of the transmit ring buffer. */
+static kernel_spinlock_t tx_drain_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/** @brief Interrupt state of the ports that support interrupts. */
+static uart_port_t uart_ports[SERIAL_IRQ_PORT_COUNT] =
+{
+    {
+        .base     = SERIAL_COM1_BASE,
+        .irq      = SERIAL_COM1_IRQ,
+        .int_lock = KERNEL_SPINLOCK_INIT_VALUE,
+        .rx_lock  = KERNEL_SPINLOCK_INIT_VALUE
+    },
+    {
+        .base     = SERIAL_COM2_BASE,
+        .irq      = SERIAL_COM2_IRQ,
+        .int_lock = KERNEL_SPINLOCK_INIT_VALUE,
+        .rx_lock  = KERNEL_SPINLOCK_INIT_VALUE
+    }
+};
 
 /*******************************************************************************
  * STATIC FUNCTIONS DECLARATIONS
@@ -275,16 +404,202 @@ static void _set_buffer(const uint8_t attr, const uint8_t com);
 static void _set_baudrate(SERIAL_BAUDRATE_E rate, const uint8_t com);
 
 /**
- * @brief Writes the data given as patameter on the desired port.
+ * @brief Writes a string on the output port.
+ *
+ * @details Writes a string on the output port and translates the line feeds.
+ * The string is copied to the transmit ring buffer when the transmit interrupt
+ * is enabled, otherwise the call is blocking until the data has been sent to
+ * the uart port controler. The lock is held for the whole string.
+ *
+ * @param[in] string The string to write.
+ * @param[in] length The length of the string to write.
+ */
+static void _uart_output(const char* string, const size_t length);
+
+/**
+ * @brief Writes a string on the output port by polling the line status.
+ *
+ * @details Writes a string on the output port and translates the line feeds.
+ * The line status is polled once per FIFO size bytes. The uart lock must be
+ * held by the caller.
+ *
+ * @param[in] string The string to write.
+ * @param[in] length The length of the string to write.
+ */
+static void _uart_output_sync(const char* string, const size_t length);
+
+/**
+ * @brief Copies a string to the transmit ring buffer.
+ *
+ * @details Copies a string to the transmit ring buffer and translates the
+ * line feeds. When the ring buffer is full, the caller drains it by polling.
+ * The uart lock must be held by the caller.
+ *
+ * @param[in] string The string to write.
+ * @param[in] length The length of the string to write.
+ */
+static void _uart_output_async(const char* string, const size_t length);
+
+/**
+ * @brief Pushes one byte in the transmit ring buffer.
+ *
+ * @details Pushes one byte in the transmit ring buffer, the ring is drained by
+ * polling while it is full. The uart lock must be held by the caller.
+ *
+ * @param[in] data The byte to push.
+ */
+inline static void _uart_tx_push(const uint8_t data);
+
+/**
+ * @brief Writes bytes of the transmit ring buffer to the FIFO.
+ *
+ * @details Writes bytes of the transmit ring buffer to the FIFO with at most
+ * two port strings, the ring wraps at most once. The FIFO must be empty and
+ * the count must not exceed SERIAL_TX_FIFO_SIZE.
+ *
+ * @param[in] tail The ring index of the first byte.
+ * @param[in] count The number of bytes to write.
+ */
+static void _uart_tx_write_fifo(const uint32_t tail, const uint32_t count);
+
+/**
+ * @brief Moves the pending bytes of the transmit ring buffer to the FIFO.
+ *
+ * @details Fills the transmit FIFO if it is empty, then arms the transmit
+ * interrupt while bytes are pending and disarms it otherwise. The caller must
+ * hold tx_drain_lock with interrupts disabled.
+ */
+static void _uart_tx_drain(void);
+
+/**
+ * @brief Drains the transmit ring buffer from an interruptible context.
+ *
+ * @details Takes the drain lock with interrupts disabled and drains the
+ * transmit ring buffer. When wait is TRUE, the function polls until the FIFO
+ * can take new bytes.
+ *
+ * @param[in] wait Set to TRUE to wait for the FIFO to be empty.
+ */
+static void _uart_tx_kick(const bool_t wait);
+
+/**
+ * @brief Returns the interrupt state of a port.
+ *
+ * @details Returns the interrupt state of a port, NULL is returned if the
+ * port does not support interrupts.
+ *
+ * @param[in] port The base port ID of the serial port.
+ *
+ * @return The interrupt state of the port or NULL.
+ */
+static uart_port_t* _uart_get_port(const uint32_t port);
+
+/**
+ * @brief Sets or clears interrupt enable flags of a port.
+ *
+ * @details Sets or clears interrupt enable flags of a port and writes the
+ * interrupt enable register.
+ *
+ * @param[in,out] port The port to update.
+ * @param[in] flags The interrupt enable flags to update.
+ * @param[in] enabled TRUE to set the flags, FALSE to clear them.
+ */
+static void _uart_set_int_enable(uart_port_t* port,
+                                 const uint8_t flags,
+                                 const bool_t enabled);
+
+/**
+ * @brief Attaches the port interrupt handler.
+ *
+ * @details Attaches the port interrupt handler and unmasks the port IRQ. The
+ * handler is only attached once.
+ *
+ * @param[in,out] port The port to attach.
+ *
+ * @return The success state or the error code. OS_ERR_NOT_SUPPORTED is
+ * returned if the interrupt driver does not provide the port IRQ.
+ */
+static OS_RETURN_E _uart_attach_irq(uart_port_t* port);
+
+/**
+ * @brief Moves the received bytes of a port to its receive ring buffer.
+ *
+ * @details Moves the received bytes of a port to its receive ring buffer and
+ * wakes up the thread waiting for them. The bytes received while the ring
+ * buffer is full are dropped.
+ *
+ * @param[in,out] port The port to read.
+ */
+static void _uart_rx_fill(uart_port_t* port);
+
+/**
+ * @brief Services the interrupt causes of a port.
+ *
+ * @details Services the interrupt causes identified by the port until none
+ * is pending, then acknowledges the IRQ.
+ *
+ * @param[in,out] port The port that raised the interrupt.
+ */
+static void _uart_irq_handler(uart_port_t* port);
+
+/**
+ * @brief COM1 interrupt handler.
+ *
+ * @details COM1 interrupt handler, services the port interrupt causes.
+ *
+ * @param[in] curr_thread Unused, the current thread.
+ */
+static void _uart_com1_irq_handler(kernel_thread_t* curr_thread);
+
+/**
+ * @brief COM2 interrupt handler.
+ *
+ * @details COM2 interrupt handler, services the port interrupt causes.
+ *
+ * @param[in] curr_thread Unused, the current thread.
+ */
+static void _uart_com2_irq_handler(kernel_thread_t* curr_thread);
+
+/**
+ * @brief Writes the byte given as patameter on the desired port.
  *
- * @details The function will output the data given as parameter on the selected
- * port. This call is blocking until the data has been sent to the uart port
- * controler.
+ * @details The function will output the byte given as parameter on the
+ * selected port without translating the line feeds. This call is blocking
+ * until the data has been sent to the uart port controler.
  *
  * @param[in] port The desired port to write the data to.
  * @param[in] data The byte to write to the uart port.
  */
-static void _uart_write(const uint32_t port, const uint8_t data);
+static void _uart_write_raw(const uint32_t port, const uint8_t data);
+
+/**
+ * @brief Copies received bytes of a port, the receive lock must be held.
+ *
+ * @param[in, out] port The port to read from.
+ * @param[out] buffer The buffer receiving the bytes.
+ * @param[in] size The size of the buffer in bytes.
+ *
+ * @return The number of bytes copied.
+ */
+static size_t _uart_rx_copy(uart_port_t* port,
+                            uint8_t* buffer,
+                            const size_t size);
+
+/**
+ * @brief Starts an asynchronous operation on a port.
+ *
+ * @param[in] target The port target.
+ * @param[in] request The request to start.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the operation is not supported or if
+ * the receive interrupt of the port is not enabled for a read.
+ * - OS_ERR_NULL_POINTER is returned if the buffer is NULL.
+ * - OS_ERR_RESOURCE_BUSY is returned if a read is already in flight.
+ */
+static OS_RETURN_E _uart_ioring_submit(ioring_target_t* target,
+                                       ioring_request_t* request);
 
 /*******************************************************************************
  * FUNCTIONS
@@ -319,20 +634,436 @@ static void _set_baudrate(SERIAL_BAUDRATE_E rate, const uint8_t com)
                  com, rate);
 }
 
-static void _uart_write(const uint32_t port, const uint8_t data)
+static void _uart_output(const char* string, const size_t length)
 {
-    /* Wait for empty transmit */
+    /* The lock is held for the whole string to avoid interleaving */
     KERNEL_SPINLOCK_LOCK(uart_lock);
-    while((_cpu_inb(SERIAL_LINE_STATUS_PORT(port)) & 0x20) == 0){}
-    if(data == '\n')
+    if(tx_interrupt_enabled == TRUE)
     {
-        _cpu_outb('\r', port);
-        _cpu_outb('\n', port);
+        _uart_output_async(string, length);
+        KERNEL_SPINLOCK_UNLOCK(uart_lock);
+
+        /* Start the transmission if the FIFO is idle */
+        _uart_tx_kick(FALSE);
     }
     else
     {
-        _cpu_outb(data, port);
+        _uart_output_sync(string, length);
+        KERNEL_SPINLOCK_UNLOCK(uart_lock);
+    }
+}
+
+static void _uart_output_sync(const char* string, const size_t length)
+{
+    size_t   i;
+    uint32_t fifo_space;
+
+    fifo_space = 0;
+    for(i = 0; i < length; ++i)
+    {
+        /* Wait for empty transmit, the FIFO can then take a full burst */
+        if(fifo_space < 2)
+        {
+            while((_cpu_inb(SERIAL_LINE_STATUS_PORT(SERIAL_OUTPUT_PORT)) &
+                   SERIAL_LINE_STATUS_THR_EMPTY) == 0){}
+            fifo_space = SERIAL_TX_FIFO_SIZE;
+        }
+
+        if(string[i] == '\n')
+        {
+            _cpu_outb('\r', SERIAL_OUTPUT_PORT);
+            --fifo_space;
+        }
+        _cpu_outb(string[i], SERIAL_OUTPUT_PORT);
+        --fifo_space;
+    }
+}
+
+static void _uart_output_async(const char* string, const size_t length)
+{
+    size_t i;
+
+    for(i = 0; i < length; ++i)
+    {
+        if(string[i] == '\n')
+        {
+            _uart_tx_push('\r');
+        }
+        _uart_tx_push(string[i]);
     }
+}
+
+inline static void _uart_tx_push(const uint8_t data)
+{
+    uint32_t head;
+
+    head = tx_head;
+
+    /* Ring full, make room by polling */
+    while(head - __atomic_load_n(&tx_tail, __ATOMIC_ACQUIRE) ==
+          SERIAL_TX_BUFFER_SIZE)
+    {
+        _uart_tx_kick(TRUE);
+    }
+
+    tx_buffer[head & (SERIAL_TX_BUFFER_SIZE - 1)] = data;
+    __atomic_store_n(&tx_head, head + 1, __ATOMIC_RELEASE);
+}
+
+static void _uart_tx_write_fifo(const uint32_t tail, const uint32_t count)
+{
+    uint32_t index;
+    uint32_t chunk;
+
+    index = tail & (SERIAL_TX_BUFFER_SIZE - 1);
+    chunk = SERIAL_TX_BUFFER_SIZE - index;
+    if(chunk > count)
+    {
+        chunk = count;
+    }
+
+    _cpu_outsb(tx_buffer + index, chunk, SERIAL_OUTPUT_PORT);
+    if(chunk != count)
+    {
+        _cpu_outsb(tx_buffer, count - chunk, SERIAL_OUTPUT_PORT);
+    }
+}
+
+static void _uart_tx_drain(void)
+{
+    uart_port_t* port;
+    uint32_t     head;
+    uint32_t     tail;
+    uint32_t     count;
+
+    head = __atomic_load_n(&tx_head, __ATOMIC_ACQUIRE);
+    tail = tx_tail;
+
+    /* Writing the data register also acknowledges the interrupt */
+    if(head != tail &&
+       (_cpu_inb(SERIAL_LINE_STATUS_PORT(SERIAL_OUTPUT_PORT)) &
+        SERIAL_LINE_STATUS_THR_EMPTY) != 0)
+    {
+        count = head - tail;
+        if(count > SERIAL_TX_FIFO_SIZE)
+        {
+            count = SERIAL_TX_FIFO_SIZE;
+        }
+
+        _uart_tx_write_fifo(tail, count);
+        tail += count;
+        __atomic_store_n(&tx_tail, tail, __ATOMIC_RELEASE);
+    }
+
+    /* The interrupt is only armed while bytes are pending */
+    port = _uart_get_port(SERIAL_OUTPUT_PORT);
+    if(head != tail && (port->int_enable & SERIAL_INT_THR_EMPTY) == 0)
+    {
+        _uart_set_int_enable(port, SERIAL_INT_THR_EMPTY, TRUE);
+    }
+    else if(head == tail && (port->int_enable & SERIAL_INT_THR_EMPTY) != 0)
+    {
+        _uart_set_int_enable(port, SERIAL_INT_THR_EMPTY, FALSE);
+    }
+}
+
+static void _uart_tx_kick(const bool_t wait)
+{
+    uint32_t int_state;
+
+    /* The interrupt manager is not used as it can output debug messages */
+    int_state = _cpu_get_interrupt_state();
+    _cpu_clear_interrupt();
+    KERNEL_SPINLOCK_LOCK(tx_drain_lock);
+
+    if(wait == TRUE)
+    {
+        while((_cpu_inb(SERIAL_LINE_STATUS_PORT(SERIAL_OUTPUT_PORT)) &
+               SERIAL_LINE_STATUS_THR_EMPTY) == 0){}
+    }
+    _uart_tx_drain();
+
+    KERNEL_SPINLOCK_UNLOCK(tx_drain_lock);
+    if(int_state != 0)
+    {
+        _cpu_set_interrupt();
+    }
+}
+
+static uart_port_t* _uart_get_port(const uint32_t port)
+{
+    uint32_t i;
+
+    for(i = 0; i < SERIAL_IRQ_PORT_COUNT; ++i)
+    {
+        if(uart_ports[i].base == port)
+        {
+            return &uart_ports[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void _uart_set_int_enable(uart_port_t* port,
+                                 const uint8_t flags,
+                                 const bool_t enabled)
+{
+    uint32_t int_state;
+
+    int_state = _cpu_get_interrupt_state();
+    _cpu_clear_interrupt();
+    KERNEL_SPINLOCK_LOCK(port->int_lock);
+
+    if(enabled == TRUE)
+    {
+        port->int_enable |= flags;
+    }
+    else
+    {
+        port->int_enable &= ~flags;
+    }
+    _cpu_outb(port->int_enable, SERIAL_DATA_PORT_2(port->base));
+
+    KERNEL_SPINLOCK_UNLOCK(port->int_lock);
+    if(int_state != 0)
+    {
+        _cpu_set_interrupt();
+    }
+}
+
+static OS_RETURN_E _uart_attach_irq(uart_port_t* port)
+{
+    OS_RETURN_E err;
+
+    if(port->irq_attached == TRUE)
+    {
+        return OS_NO_ERR;
+    }
+
+    if(port->base == SERIAL_COM1_BASE)
+    {
+        err = kernel_interrupt_register_fast_irq_handler(
+                                                    port->irq,
+                                                    _uart_com1_irq_handler);
+    }
+    else
+    {
+        err = kernel_interrupt_register_fast_irq_handler(
+                                                    port->irq,
+                                                    _uart_com2_irq_handler);
+    }
+
+    if(err == OS_ERR_NO_SUCH_IRQ || err == OR_ERR_UNAUTHORIZED_INTERRUPT_LINE)
+    {
+        /* No interrupt line for the port, the port stays polled */
+        KERNEL_DEBUG(SERIAL_DEBUG_ENABLED, MODULE_NAME,
+                     "No interrupt for port 0x%04x: %d", port->base, err);
+        return OS_ERR_NOT_SUPPORTED;
+    }
+    else if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    port->irq_attached = TRUE;
+    kernel_interrupt_set_irq_mask(port->irq, TRUE);
+
+    return OS_NO_ERR;
+}
+
+static size_t _uart_rx_copy(uart_port_t* port,
+                            uint8_t* buffer,
+                            const size_t size)
+{
+    size_t count;
+
+    count = 0;
+    while(count < size && port->rx_head != port->rx_tail)
+    {
+        buffer[count++] = port->rx_buffer[port->rx_tail &
+                                          (SERIAL_RX_BUFFER_SIZE - 1)];
+        ++port->rx_tail;
+    }
+
+    return count;
+}
+
+static OS_RETURN_E _uart_ioring_submit(ioring_target_t* target,
+                                       ioring_request_t* request)
+{
+    uart_port_t*      port;
+    ioring_request_t* completed;
+    uint8_t*          buffer;
+    size_t            count;
+    size_t            i;
+    uint32_t          int_state;
+
+    port   = target->driver_ctrl;
+    buffer = request->sqe.buffer;
+    if(buffer == NULL && request->sqe.size != 0)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(request->sqe.opcode == IORING_OP_WRITE)
+    {
+        for(i = 0; i < request->sqe.size; ++i)
+        {
+            _uart_write_raw(port->base, buffer[i]);
+        }
+        ioring_complete(request, OS_NO_ERR, request->sqe.size);
+        return OS_NO_ERR;
+    }
+    if(request->sqe.opcode != IORING_OP_READ ||
+       port->rx_interrupt_enabled == FALSE)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    ENTER_CRITICAL(int_state);
+    KERNEL_SPINLOCK_LOCK(port->rx_lock);
+
+    if(port->rx_request != NULL)
+    {
+        KERNEL_SPINLOCK_UNLOCK(port->rx_lock);
+        EXIT_CRITICAL(int_state);
+        return OS_ERR_RESOURCE_BUSY;
+    }
+
+    /* Complete with the available bytes, or wait for the receive interrupt */
+    completed = NULL;
+    count     = 0;
+    if(port->rx_head != port->rx_tail || request->sqe.size == 0)
+    {
+        count     = _uart_rx_copy(port, buffer, request->sqe.size);
+        completed = request;
+    }
+    else
+    {
+        port->rx_request = request;
+    }
+
+    KERNEL_SPINLOCK_UNLOCK(port->rx_lock);
+    EXIT_CRITICAL(int_state);
+
+    if(completed != NULL)
+    {
+        ioring_complete(completed, OS_NO_ERR, count);
+    }
+
+    return OS_NO_ERR;
+}
+
+static void _uart_rx_fill(uart_port_t* port)
+{
+    kernel_thread_t*  waiter;
+    ioring_request_t* request;
+    size_t            count;
+    uint8_t           data;
+
+    KERNEL_SPINLOCK_LOCK(port->rx_lock);
+
+    while((_cpu_inb(SERIAL_LINE_STATUS_PORT(port->base)) &
+           SERIAL_LINE_STATUS_DATA_READY) != 0)
+    {
+        data = _cpu_inb(SERIAL_DATA_PORT(port->base));
+        if(port->rx_head - port->rx_tail < SERIAL_RX_BUFFER_SIZE)
+        {
+            port->rx_buffer[port->rx_head & (SERIAL_RX_BUFFER_SIZE - 1)] = data;
+            ++port->rx_head;
+        }
+    }
+
+    /* The read request in flight takes the bytes before the waiter */
+    request = NULL;
+    count   = 0;
+    if(port->rx_request != NULL && port->rx_head != port->rx_tail)
+    {
+        request          = port->rx_request;
+        port->rx_request = NULL;
+        count            = _uart_rx_copy(port, request->sqe.buffer,
+                                         request->sqe.size);
+    }
+
+    waiter = NULL;
+    if(port->rx_head != port->rx_tail)
+    {
+        waiter          = port->rx_waiter;
+        port->rx_waiter = NULL;
+    }
+
+    KERNEL_SPINLOCK_UNLOCK(port->rx_lock);
+
+    if(request != NULL)
+    {
+        ioring_complete(request, OS_NO_ERR, count);
+    }
+    if(waiter != NULL)
+    {
+        (void)scheduler_wakeup_thread(waiter);
+    }
+}
+
+static void _uart_irq_handler(uart_port_t* port)
+{
+    uint32_t i;
+    uint8_t  int_id;
+
+    for(i = 0; i < SERIAL_IRQ_MAX_CAUSES; ++i)
+    {
+        /* Reading the identification acknowledges the transmit interrupt */
+        int_id = _cpu_inb(SERIAL_FIFO_COMMAND_PORT(port->base));
+        if((int_id & SERIAL_INT_ID_NONE) != 0)
+        {
+            break;
+        }
+
+        switch(int_id & SERIAL_INT_ID_MASK)
+        {
+            case SERIAL_INT_ID_THR_EMPTY:
+                if(port->base == SERIAL_OUTPUT_PORT)
+                {
+                    KERNEL_SPINLOCK_LOCK(tx_drain_lock);
+                    _uart_tx_drain();
+                    KERNEL_SPINLOCK_UNLOCK(tx_drain_lock);
+                }
+                break;
+            case SERIAL_INT_ID_RECV_DATA:
+            case SERIAL_INT_ID_RECV_TIMEOUT:
+                _uart_rx_fill(port);
+                break;
+            case SERIAL_INT_ID_LINE_STATUS:
+                (void)_cpu_inb(SERIAL_LINE_STATUS_PORT(port->base));
+                break;
+            default:
+                (void)_cpu_inb(SERIAL_MODEM_STATUS_PORT(port->base));
+                break;
+        }
+    }
+
+    kernel_interrupt_set_irq_eoi(port->irq);
+}
+
+static void _uart_com1_irq_handler(kernel_thread_t* curr_thread)
+{
+    (void)curr_thread;
+    _uart_irq_handler(&uart_ports[0]);
+}
+
+static void _uart_com2_irq_handler(kernel_thread_t* curr_thread)
+{
+    (void)curr_thread;
+    _uart_irq_handler(&uart_ports[1]);
+}
+
+static void _uart_write_raw(const uint32_t port, const uint8_t data)
+{
+    /* Wait for empty transmit */
+    KERNEL_SPINLOCK_LOCK(uart_lock);
+    while((_cpu_inb(SERIAL_LINE_STATUS_PORT(port)) &
+           SERIAL_LINE_STATUS_THR_EMPTY) == 0){}
+    _cpu_outb(data, port);
     KERNEL_SPINLOCK_UNLOCK(uart_lock);
 }
 
@@ -372,10 +1103,11 @@ void uart_init(void)
 
         attr = SERIAL_DATA_LENGTH_8 | SERIAL_STOP_BIT_1;
 
-        /* Enable interrupt on recv for COM1 and COM2 */
-        if(com == SERIAL_COM1_BASE || com == SERIAL_COM2_BASE)
+        /* The interrupts are enabled once their handler is attached */
+        if(_uart_get_port(com) != NULL)
         {
-            _cpu_outb(0x01, SERIAL_DATA_PORT_2(com));
+            _cpu_outb(_uart_get_port(com)->int_enable,
+                      SERIAL_DATA_PORT_2(com));
         }
         else
         {
@@ -403,7 +1135,7 @@ void uart_clear_screen(void)
     /* On 80x25 screen, just print 25 line feed. */
     for(i = 0; i < 25; ++i)
     {
-        _uart_write(SERIAL_OUTPUT_PORT, '\n');
+        _uart_output("\n", 1);
     }
 }
 
@@ -417,23 +1149,34 @@ void uart_scroll(const SCROLL_DIRECTION_E direction,
         /* Just print lines_count line feed. */
         for(i = 0; i < lines_count; ++i)
         {
-            _uart_write(SERIAL_OUTPUT_PORT, '\n');
+            _uart_output("\n", 1);
         }
     }
 }
 
 void uart_console_write_keyboard(const char* string, const size_t len)
 {
-    size_t i;
-    for(i = 0; i < len; ++i)
-    {
-        _uart_write(SERIAL_OUTPUT_PORT, string[i]);
-    }
+    _uart_output(string, len);
 }
 
 uint8_t uart_read(const uint32_t port)
 {
-    uint8_t  val;
+    uint8_t     val;
+    size_t      read;
+    OS_RETURN_E err;
+
+    /* The receive interrupt fills the buffer, wait for it */
+    err = uart_read_buffer(port, &val, sizeof(val), &read);
+    while(err == OS_ERR_UNAUTHORIZED_ACTION)
+    {
+        /* The caller cannot wait, spin until the buffer is filled */
+        _cpu_pause();
+        err = uart_read_buffer(port, &val, sizeof(val), &read);
+    }
+    if(err == OS_NO_ERR)
+    {
+        return val;
+    }
 
     /* Wait for data to be received */
     KERNEL_SPINLOCK_LOCK(uart_lock);
@@ -450,24 +1193,208 @@ uint8_t uart_read(const uint32_t port)
 
 void uart_put_string(const char* string)
 {
-    size_t i;
-    for(i = 0; i < strlen(string); ++i)
+    _uart_output(string, strlen(string));
+}
+
+void uart_put_char(const char character)
+{
+    _uart_output(&character, 1);
+}
+
+OS_RETURN_E uart_enable_tx_interrupt(void)
+{
+    OS_RETURN_E err;
+
+    err = _uart_attach_irq(_uart_get_port(SERIAL_OUTPUT_PORT));
+    if(err != OS_NO_ERR)
     {
-        _uart_write(SERIAL_OUTPUT_PORT, string[i]);
+        return err;
     }
+
+    /* The interrupt is armed by the drain while bytes are pending */
+    KERNEL_SPINLOCK_LOCK(uart_lock);
+    tx_interrupt_enabled = TRUE;
+    KERNEL_SPINLOCK_UNLOCK(uart_lock);
+
+    KERNEL_DEBUG(SERIAL_DEBUG_ENABLED, MODULE_NAME,
+                 "Transmit interrupt enabled");
+
+    return OS_NO_ERR;
 }
 
-void uart_put_char(const char character)
+OS_RETURN_E uart_enable_rx_interrupt(const uint32_t port)
+{
+    uart_port_t* uart_port;
+    OS_RETURN_E  err;
+
+    uart_port = _uart_get_port(port);
+    if(uart_port == NULL)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    err = _uart_attach_irq(uart_port);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    /* Drop the bytes received while polled */
+    KERNEL_SPINLOCK_LOCK(uart_port->rx_lock);
+    while((_cpu_inb(SERIAL_LINE_STATUS_PORT(port)) &
+           SERIAL_LINE_STATUS_DATA_READY) != 0)
+    {
+        (void)_cpu_inb(SERIAL_DATA_PORT(port));
+    }
+    uart_port->rx_head              = 0;
+    uart_port->rx_tail              = 0;
+    uart_port->rx_waiter            = NULL;
+    uart_port->rx_request           = NULL;
+    uart_port->rx_interrupt_enabled = TRUE;
+    KERNEL_SPINLOCK_UNLOCK(uart_port->rx_lock);
+
+    _uart_set_int_enable(uart_port, SERIAL_INT_RECV_DATA, TRUE);
+
+    KERNEL_DEBUG(SERIAL_DEBUG_ENABLED, MODULE_NAME,
+                 "Receive interrupt enabled on port 0x%04x", port);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E uart_read_buffer(const uint32_t port,
+                             uint8_t* buffer,
+                             const size_t size,
+                             size_t* read)
+{
+    uart_port_t* uart_port;
+    size_t       count;
+    uint32_t     int_state;
+    OS_RETURN_E  err;
+
+    if(buffer == NULL || read == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    *read = 0;
+
+    uart_port = _uart_get_port(port);
+    if(uart_port == NULL || uart_port->rx_interrupt_enabled == FALSE)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    if(size == 0)
+    {
+        return OS_NO_ERR;
+    }
+
+    ENTER_CRITICAL(int_state);
+    KERNEL_SPINLOCK_LOCK(uart_port->rx_lock);
+
+    while(uart_port->rx_head == uart_port->rx_tail)
+    {
+        if(uart_port->rx_waiter != NULL)
+        {
+            KERNEL_SPINLOCK_UNLOCK(uart_port->rx_lock);
+            EXIT_CRITICAL(int_state);
+            return OS_ERR_UNAUTHORIZED_ACTION;
+        }
+
+        /* The wait releases the lock once the thread is waiting */
+        uart_port->rx_waiter = scheduler_get_current_thread();
+        err = scheduler_wait_thread(THREAD_WAIT_TYPE_IO, &uart_port->rx_lock);
+        if(err != OS_NO_ERR)
+        {
+            uart_port->rx_waiter = NULL;
+            KERNEL_SPINLOCK_UNLOCK(uart_port->rx_lock);
+            EXIT_CRITICAL(int_state);
+            return err;
+        }
+
+        KERNEL_SPINLOCK_LOCK(uart_port->rx_lock);
+    }
+
+    count = _uart_rx_copy(uart_port, buffer, size);
+
+    KERNEL_SPINLOCK_UNLOCK(uart_port->rx_lock);
+    EXIT_CRITICAL(int_state);
+
+    *read = count;
+
+    return OS_NO_ERR;
+}
+
+void uart_disable_tx_interrupt(void)
 {
-    _uart_write(SERIAL_OUTPUT_PORT, character);
+    uart_port_t* port;
+    uint32_t     head;
+    uint32_t     tail;
+    uint32_t     count;
+
+    if(tx_interrupt_enabled == FALSE)
+    {
+        return;
+    }
+
+    /* No lock is taken, this can be called from the panic context */
+    tx_interrupt_enabled = FALSE;
+    port = _uart_get_port(SERIAL_OUTPUT_PORT);
+    port->int_enable &= ~SERIAL_INT_THR_EMPTY;
+    _cpu_outb(port->int_enable, SERIAL_DATA_PORT_2(SERIAL_OUTPUT_PORT));
+
+    /* Flush the pending bytes by polling */
+    head = __atomic_load_n(&tx_head, __ATOMIC_ACQUIRE);
+    tail = tx_tail;
+    while(head != tail)
+    {
+        while((_cpu_inb(SERIAL_LINE_STATUS_PORT(SERIAL_OUTPUT_PORT)) &
+               SERIAL_LINE_STATUS_THR_EMPTY) == 0){}
+
+        count = head - tail;
+        if(count > SERIAL_TX_FIFO_SIZE)
+        {
+            count = SERIAL_TX_FIFO_SIZE;
+        }
+
+        _uart_tx_write_fifo(tail, count);
+        tail += count;
+    }
+    __atomic_store_n(&tx_tail, tail, __ATOMIC_RELEASE);
+}
+
+ioring_target_t* uart_get_ioring_target(const uint32_t port)
+{
+    uart_port_t* uart_port;
+
+    uart_port = _uart_get_port(port);
+    if(uart_port == NULL)
+    {
+        return NULL;
+    }
+
+    uart_port->ioring_target.name        = "uart";
+    uart_port->ioring_target.submit      = _uart_ioring_submit;
+    uart_port->ioring_target.poll        = NULL;
+    uart_port->ioring_target.driver_ctrl = uart_port;
+
+    return &uart_port->ioring_target;
 }
 
 bool_t uart_received(const uint32_t port)
 {
     bool_t   ret;
+    uart_port_t* uart_port;
+
+    uart_port = _uart_get_port(port);
+    if(uart_port != NULL && uart_port->rx_interrupt_enabled == TRUE)
+    {
+        return uart_port->rx_head != uart_port->rx_tail;
+    }
 
     /* Read on LINE status port */
-    ret = _cpu_inb(SERIAL_LINE_STATUS_PORT(port)) & 0x01;
+    ret = _cpu_inb(SERIAL_LINE_STATUS_PORT(port)) &
+          SERIAL_LINE_STATUS_DATA_READY;
 
     return ret;
 }
@@ -477,5 +1404,23 @@ const kernel_console_driver_t* uart_get_driver(void)
     return &uart_text_driver;
 }
 
+void uart_trace_write(const void* buffer, const size_t size)
+{
+    const uint8_t* data;
+    size_t         i;
+
+    /* The lock is taken per byte to not delay the console output */
+    data = buffer;
+    for(i = 0; i < size; ++i)
+    {
+        _uart_write_raw(SERIAL_TRACE_PORT, data[i]);
+    }
+}
+
+const kernel_trace_output_t* uart_get_trace_output(void)
+{
+    return &uart_trace_driver;
+}
+
 
 /************************************ EOF *************************************/
\ No newline at end of file
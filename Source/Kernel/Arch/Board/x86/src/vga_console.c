@@ -7,13 +7,16 @@
  *
  * @date 28/02/2021
  *
- * @version 1.5
+ * @version 2.0
  *
  * @brief VGA text mode driver.
  *
  * @details Allows the kernel to display text and general ASCII characters to be
  * displayed on the screen. Includes cursor management, screen colors management
- * and other fancy screen driver things.
+ * and other fancy screen driver things. The text is written to a shadow buffer
+ * which lines are indexed as a ring, a scroll only moves the first line index.
+ * The modified lines and the cursor are copied to the VGA frame buffer once
+ * the output is done.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -26,10 +29,10 @@
 #include <stdint.h>         /* Generic int types */
 #include <string.h>         /* String manipualtion */
 #include <cpu.h>            /* CPU port manipulation */
+#include <mmio.h>           /* Memory mapped IOs */
 #include <kerror.h>         /* Kernel error */
 #include <kernel_output.h>  /* Kernel output manager */
 #include <console.h>        /* Console driver manager */
-#include <uart.h>           /* UART driver */
 /* Configuration files */
 #include <config.h>
 
@@ -62,6 +65,9 @@
 /** @brief VGA cursor position command high. */
 #define VGA_CONSOLE_CURSOR_COMM_HIGH 0x0E
 
+/** @brief Dirty lines mask when all the lines of the screen are modified. */
+#define VGA_CONSOLE_ALL_LINES_DIRTY ((1U << VGA_CONSOLE_SCREEN_LINE_SIZE) - 1)
+
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
@@ -110,6 +116,19 @@ static uint32_t last_columns[VGA_CONSOLE_SCREEN_LINE_SIZE] = {0};
 /** @brief VGA frame buffer address. */
 static uint16_t* vga_console_framebuffer = (uint16_t*)VGA_CONSOLE_FRAMEBUFFER;
 
+/** @brief Shadow frame buffer, its lines are indexed as a ring. */
+static uint16_t vga_console_shadow[VGA_CONSOLE_SCREEN_LINE_SIZE]
+                                  [VGA_CONSOLE_SCREEN_COL_SIZE];
+
+/** @brief Shadow frame buffer line displayed on the first screen line. */
+static uint32_t shadow_first_line = 0;
+
+/** @brief Mask of the screen lines modified since the last flush. */
+static uint32_t dirty_lines = 0;
+
+/** @brief Tells if the cursor was moved since the last flush. */
+static bool_t dirty_cursor = FALSE;
+
 /**
  * @brief VGA text driver instance.
  */
@@ -145,19 +164,56 @@ inline static void _vga_console_print_char(const uint32_t line,
                                            const char character);
 
 /**
- * @brief Returns the VGA frame buffer virtual address.
+ * @brief Returns the shadow frame buffer address of a screen line.
+ *
+ * @details Returns the shadow frame buffer address of the first character of
+ * the screen line given as parameter.
+ *
+ * @param[in] line The screen line.
+ *
+ * @return The shadow frame buffer address of the line.
+ */
+inline static uint16_t* _vga_console_get_shadow_line(const uint32_t line);
+
+/**
+ * @brief Fills a screen line with spaces.
+ *
+ * @details Fills a screen line of the shadow frame buffer with spaces using
+ * the current color scheme.
+ *
+ * @param[in] line The screen line to clear.
+ */
+static void _vga_console_clear_line(const uint32_t line);
+
+/**
+ * @brief Sets the cursor position.
+ *
+ * @details Sets the cursor position, the VGA cursor is updated on the next
+ * flush.
  *
- * @details Returns the VGA frame buffer virtual address correponding to a
- * certain region of the buffer given the parameters.
+ * @param[in] line The line index where to place the cursor.
+ * @param[in] column The column index where to place the cursor.
+ */
+static void _vga_console_set_cursor(const uint32_t line, const uint32_t column);
+
+/**
+ * @brief Scrolls the shadow frame buffer down.
  *
- * @param[in] line The frame buffer line.
- * @param[in] column The frame buffer column.
+ * @details Scrolls the shadow frame buffer down by moving the first line
+ * index and clears the new lines.
  *
- * @return The frame buffer virtual address is returned correponding to a
- * certain region of the buffer given the parameters is returned.
+ * @param[in] lines_count The number of lines to scroll.
  */
-inline static uint16_t* _vga_console_get_framebuffer(const uint32_t line,
-                                                     const uint32_t column);
+static void _vga_console_scroll_down(const uint32_t lines_count);
+
+/**
+ * @brief Copies the modified lines and the cursor to the VGA frame buffer.
+ *
+ * @details Copies the modified lines of the shadow frame buffer to the VGA
+ * frame buffer. Consecutive lines are copied at once. The VGA cursor is
+ * updated if it was moved.
+ */
+static void _vga_console_flush(void);
 
 /**
  * @brief Processes the character in parameters.
@@ -187,40 +243,37 @@ inline static void _vga_console_print_char(const uint32_t line,
     }
 
     /* Get address to inject */
-    screen_mem = _vga_console_get_framebuffer(line, column);
+    screen_mem = _vga_console_get_shadow_line(line) + column;
 
     /* Inject the character with the current colorscheme */
-    *screen_mem = character |
+    *screen_mem = (uint8_t)character |
                   ((screen_scheme.background << 8) & 0xF000) |
                   ((screen_scheme.foreground << 8) & 0x0F00);
+
+    dirty_lines |= 1U << line;
 }
 
 static void _vga_console_process_char(const char character)
 {
-#if DEBUG_LOG_UART
-    uart_put_char(character);
-#endif
-
     /* If character is a normal ASCII character */
     if(character > 31 && character < 127)
     {
          /* Manage end of line cursor position */
         if(screen_cursor.x > VGA_CONSOLE_SCREEN_COL_SIZE - 1)
         {
-            vga_console_put_cursor_at(screen_cursor.y + 1, 0);
+            _vga_console_set_cursor(screen_cursor.y + 1, 0);
             last_columns[screen_cursor.y] = screen_cursor.x;
         }
 
         /* Manage end of screen cursor position */
         if(screen_cursor.y >= VGA_CONSOLE_SCREEN_LINE_SIZE)
         {
-            vga_console_scroll(SCROLL_DOWN, 1);
-
+            _vga_console_scroll_down(1);
         }
         else
         {
             /* Move cursor */
-            vga_console_put_cursor_at(screen_cursor.y, screen_cursor.x);
+            _vga_console_set_cursor(screen_cursor.y, screen_cursor.x);
             last_columns[screen_cursor.y] = screen_cursor.x;
         }
 
@@ -239,8 +292,8 @@ static void _vga_console_process_char(const char character)
                 {
                     if(screen_cursor.x > last_printed_cursor.x)
                     {
-                        vga_console_put_cursor_at(screen_cursor.y,
-                                                  screen_cursor.x - 1);
+                        _vga_console_set_cursor(screen_cursor.y,
+                                                screen_cursor.x - 1);
                         last_columns[screen_cursor.y] = screen_cursor.x;
                         _vga_console_print_char(screen_cursor.y,
                                                 screen_cursor.x, ' ');
@@ -250,8 +303,8 @@ static void _vga_console_process_char(const char character)
                 {
                     if(screen_cursor.x > 0)
                     {
-                        vga_console_put_cursor_at(screen_cursor.y,
-                                                  screen_cursor.x - 1);
+                        _vga_console_set_cursor(screen_cursor.y,
+                                                screen_cursor.x - 1);
                             last_columns[screen_cursor.y] = screen_cursor.x;
                         _vga_console_print_char(screen_cursor.y,
                                                 screen_cursor.x, ' ');
@@ -265,8 +318,8 @@ static void _vga_console_process_char(const char character)
                                VGA_CONSOLE_SCREEN_COL_SIZE - 1;
                         }
 
-                        vga_console_put_cursor_at(screen_cursor.y - 1,
-                                      last_columns[screen_cursor.y - 1]);
+                        _vga_console_set_cursor(screen_cursor.y - 1,
+                                    last_columns[screen_cursor.y - 1]);
                         _vga_console_print_char(screen_cursor.y,
                                                 screen_cursor.x, ' ');
                     }
@@ -276,14 +329,14 @@ static void _vga_console_process_char(const char character)
             case '\t':
                 if(screen_cursor.x + 8 < VGA_CONSOLE_SCREEN_COL_SIZE - 1)
                 {
-                    vga_console_put_cursor_at(screen_cursor.y,
-                            screen_cursor.x  +
-                            (8 - screen_cursor.x % 8));
+                    _vga_console_set_cursor(screen_cursor.y,
+                          screen_cursor.x  +
+                          (8 - screen_cursor.x % 8));
                 }
                 else
                 {
-                    vga_console_put_cursor_at(screen_cursor.y,
-                           VGA_CONSOLE_SCREEN_COL_SIZE - 1);
+                    _vga_console_set_cursor(screen_cursor.y,
+                         VGA_CONSOLE_SCREEN_COL_SIZE - 1);
                 }
                 last_columns[screen_cursor.y] = screen_cursor.x;
                 break;
@@ -291,21 +344,22 @@ static void _vga_console_process_char(const char character)
             case '\n':
                 if(screen_cursor.y < VGA_CONSOLE_SCREEN_LINE_SIZE - 1)
                 {
-                    vga_console_put_cursor_at(screen_cursor.y + 1, 0);
+                    _vga_console_set_cursor(screen_cursor.y + 1, 0);
                     last_columns[screen_cursor.y] = screen_cursor.x;
                 }
                 else
                 {
-                    vga_console_scroll(SCROLL_DOWN, 1);
+                    _vga_console_scroll_down(1);
                 }
                 break;
             /* Clear screen */
             case '\f':
-                vga_console_clear_screen();
+                memset(vga_console_shadow, 0, sizeof(vga_console_shadow));
+                dirty_lines = VGA_CONSOLE_ALL_LINES_DIRTY;
                 break;
             /* Line return */
             case '\r':
-                vga_console_put_cursor_at(screen_cursor.y, 0);
+                _vga_console_set_cursor(screen_cursor.y, 0);
                 last_columns[screen_cursor.y] = screen_cursor.x;
                 break;
             /* Undefined */
@@ -315,50 +369,40 @@ static void _vga_console_process_char(const char character)
     }
 }
 
-static inline uint16_t* _vga_console_get_framebuffer(const uint32_t line,
-                                                     const uint32_t column)
+inline static uint16_t* _vga_console_get_shadow_line(const uint32_t line)
 {
-    /* Avoid overflow on text mode */
-    if(line > VGA_CONSOLE_SCREEN_LINE_SIZE - 1 ||
-       column > VGA_CONSOLE_SCREEN_COL_SIZE -1)
+    uint32_t shadow_line;
+
+    shadow_line = shadow_first_line + line;
+    if(shadow_line >= VGA_CONSOLE_SCREEN_LINE_SIZE)
     {
-        return vga_console_framebuffer;
+        shadow_line -= VGA_CONSOLE_SCREEN_LINE_SIZE;
     }
 
-    /* Returns the mem adress of the coordinates */
-    return (uint16_t*)vga_console_framebuffer +
-           (column + line * VGA_CONSOLE_SCREEN_COL_SIZE);
+    return vga_console_shadow[shadow_line];
 }
 
-void vga_console_init(void)
+static void _vga_console_clear_line(const uint32_t line)
 {
-    KERNEL_TRACE_EVENT(EVENT_KERNEL_VGA_INIT_START, 0);
-
-    /* Init framebuffer */
-    vga_console_framebuffer = (uint16_t*)VGA_CONSOLE_FRAMEBUFFER;
+    uint16_t* screen_mem;
+    uint16_t  blank;
+    uint32_t  i;
 
-    KERNEL_TRACE_EVENT(EVENT_KERNEL_VGA_INIT_END, 3,
-                       (uintptr_t)vga_console_framebuffer & 0xFFFFFFFF,
-#ifdef ARCH_64_BITS
-                       (uintptr_t)vga_console_framebuffer >> 32,
-#else
-                        0,
-#endif
-                       VGA_CONSOLE_FRAMEBUFFER_SIZE);
+    blank = ' ' |
+            ((screen_scheme.background << 8) & 0xF000) |
+            ((screen_scheme.foreground << 8) & 0x0F00);
 
-    KERNEL_DEBUG(VGA_DEBUG_ENABLED, MODULE_NAME, "VGA text driver initialized");
-}
+    screen_mem = _vga_console_get_shadow_line(line);
+    for(i = 0; i < VGA_CONSOLE_SCREEN_COL_SIZE; ++i)
+    {
+        screen_mem[i] = blank;
+    }
 
-void vga_console_clear_screen(void)
-{
-    /* Clear all screen */
-    memset(_vga_console_get_framebuffer(0, 0), 0, VGA_CONSOLE_FRAMEBUFFER_SIZE);
+    dirty_lines |= 1U << line;
 }
 
-void vga_console_put_cursor_at(const uint32_t line, const uint32_t column)
+static void _vga_console_set_cursor(const uint32_t line, const uint32_t column)
 {
-    int16_t  cursor_position;
-
     /* Checks the values of line and column */
     if(column > VGA_CONSOLE_SCREEN_COL_SIZE ||
        line > VGA_CONSOLE_SCREEN_LINE_SIZE)
@@ -366,21 +410,132 @@ void vga_console_put_cursor_at(const uint32_t line, const uint32_t column)
         return;
     }
 
-    /* Set new cursor position */
     screen_cursor.x = column;
     screen_cursor.y = line;
+    dirty_cursor    = TRUE;
+}
 
-    /* Display new position on screen */
-    cursor_position = column + line * VGA_CONSOLE_SCREEN_COL_SIZE;
+static void _vga_console_scroll_down(const uint32_t lines_count)
+{
+    uint32_t i;
+
+    /* The lines leaving the top of the screen become the new bottom lines */
+    shadow_first_line += lines_count;
+    if(shadow_first_line >= VGA_CONSOLE_SCREEN_LINE_SIZE)
+    {
+        shadow_first_line -= VGA_CONSOLE_SCREEN_LINE_SIZE;
+    }
+
+    memmove(last_columns, last_columns + lines_count,
+            sizeof(uint32_t) * (VGA_CONSOLE_SCREEN_LINE_SIZE - lines_count));
+    for(i = VGA_CONSOLE_SCREEN_LINE_SIZE - lines_count;
+        i < VGA_CONSOLE_SCREEN_LINE_SIZE;
+        ++i)
+    {
+        last_columns[i] = 0;
+        _vga_console_clear_line(i);
+    }
 
-    /* Send low part to the screen */
-    _cpu_outb(VGA_CONSOLE_CURSOR_COMM_LOW, VGA_CONSOLE_SCREEN_COMM_PORT);
-    _cpu_outb((int8_t)(cursor_position & 0x00FF), VGA_CONSOLE_SCREEN_DATA_PORT);
+    /* All the lines moved on the screen */
+    dirty_lines = VGA_CONSOLE_ALL_LINES_DIRTY;
 
-    /* Send high part to the screen */
-    _cpu_outb(VGA_CONSOLE_CURSOR_COMM_HIGH, VGA_CONSOLE_SCREEN_COMM_PORT);
-    _cpu_outb((int8_t)((cursor_position & 0xFF00) >> 8),
-             VGA_CONSOLE_SCREEN_DATA_PORT);
+    /* Replace cursor */
+    _vga_console_set_cursor(VGA_CONSOLE_SCREEN_LINE_SIZE - lines_count, 0);
+
+    if(lines_count <= last_printed_cursor.y)
+    {
+        last_printed_cursor.y -= lines_count;
+    }
+    else
+    {
+        last_printed_cursor.x = 0;
+        last_printed_cursor.y = 0;
+    }
+}
+
+static void _vga_console_flush(void)
+{
+    uint32_t line;
+    uint32_t count;
+    uint16_t cursor_position;
+
+    line = 0;
+    while(dirty_lines != 0 && line < VGA_CONSOLE_SCREEN_LINE_SIZE)
+    {
+        if((dirty_lines & (1U << line)) == 0)
+        {
+            ++line;
+            continue;
+        }
+
+        /* Copy the consecutive dirty lines until the shadow ring wraps */
+        count = 1;
+        while(line + count < VGA_CONSOLE_SCREEN_LINE_SIZE &&
+              (dirty_lines & (1U << (line + count))) != 0 &&
+              _vga_console_get_shadow_line(line + count) !=
+              vga_console_shadow[0])
+        {
+            ++count;
+        }
+
+        _mapped_io_write_stream(vga_console_framebuffer +
+                                line * VGA_CONSOLE_SCREEN_COL_SIZE,
+                                _vga_console_get_shadow_line(line),
+                                sizeof(uint16_t) *
+                                VGA_CONSOLE_SCREEN_COL_SIZE * count);
+
+        dirty_lines &= ~(((1U << count) - 1) << line);
+        line += count;
+    }
+
+    if(dirty_cursor == TRUE)
+    {
+        dirty_cursor    = FALSE;
+        cursor_position = screen_cursor.x +
+                          screen_cursor.y * VGA_CONSOLE_SCREEN_COL_SIZE;
+
+        /* Send low part to the screen */
+        _cpu_outb(VGA_CONSOLE_CURSOR_COMM_LOW, VGA_CONSOLE_SCREEN_COMM_PORT);
+        _cpu_outb((int8_t)(cursor_position & 0x00FF),
+                  VGA_CONSOLE_SCREEN_DATA_PORT);
+
+        /* Send high part to the screen */
+        _cpu_outb(VGA_CONSOLE_CURSOR_COMM_HIGH, VGA_CONSOLE_SCREEN_COMM_PORT);
+        _cpu_outb((int8_t)((cursor_position & 0xFF00) >> 8),
+                  VGA_CONSOLE_SCREEN_DATA_PORT);
+    }
+}
+
+void vga_console_init(void)
+{
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_VGA_INIT_START, 0);
+
+    /* Init framebuffer, the shadow starts with the current screen content */
+    vga_console_framebuffer = (uint16_t*)VGA_CONSOLE_FRAMEBUFFER;
+    memcpy(vga_console_shadow, vga_console_framebuffer,
+           sizeof(vga_console_shadow));
+    shadow_first_line = 0;
+    dirty_lines       = 0;
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_VGA_INIT_END, 2,
+                       (uintptr_t)vga_console_framebuffer,
+                       VGA_CONSOLE_FRAMEBUFFER_SIZE);
+
+    KERNEL_DEBUG(VGA_DEBUG_ENABLED, MODULE_NAME, "VGA text driver initialized");
+}
+
+void vga_console_clear_screen(void)
+{
+    /* Clear all screen */
+    memset(vga_console_shadow, 0, sizeof(vga_console_shadow));
+    dirty_lines = VGA_CONSOLE_ALL_LINES_DIRTY;
+    _vga_console_flush();
+}
+
+void vga_console_put_cursor_at(const uint32_t line, const uint32_t column)
+{
+    _vga_console_set_cursor(line, column);
+    _vga_console_flush();
 }
 
 void vga_console_save_cursor(cursor_t* buffer)
@@ -420,43 +575,24 @@ void vga_console_scroll(const SCROLL_DIRECTION_E direction, const uint32_t lines
     /* Select scroll direction */
     if(direction == SCROLL_DOWN)
     {
-        uint32_t i;
-        uint32_t j;
-
-
-        /* For each line scroll we want */
-        for(j = 0; j < to_scroll; ++j)
+        _vga_console_scroll_down(to_scroll);
+    }
+    else
+    {
+        /* Replace cursor */
+        _vga_console_set_cursor(VGA_CONSOLE_SCREEN_LINE_SIZE - to_scroll, 0);
+        if(to_scroll <= last_printed_cursor.y)
         {
-            /* Copy all the lines to the above one */
-            for(i = 0; i < VGA_CONSOLE_SCREEN_LINE_SIZE - 1; ++i)
-            {
-                memmove(_vga_console_get_framebuffer(i, 0),
-                        _vga_console_get_framebuffer(i + 1, 0),
-                        sizeof(uint16_t) * VGA_CONSOLE_SCREEN_COL_SIZE);
-                last_columns[i] = last_columns[i+1];
-            }
-            last_columns[VGA_CONSOLE_SCREEN_LINE_SIZE - 1] = 0;
+            last_printed_cursor.y -= to_scroll;
         }
-        /* Clear last line */
-        for(i = 0; i < VGA_CONSOLE_SCREEN_COL_SIZE; ++i)
+        else
         {
-            _vga_console_print_char(VGA_CONSOLE_SCREEN_LINE_SIZE - 1, i, ' ');
+            last_printed_cursor.x = 0;
+            last_printed_cursor.y = 0;
         }
-
     }
 
-    /* Replace cursor */
-    vga_console_put_cursor_at(VGA_CONSOLE_SCREEN_LINE_SIZE - to_scroll, 0);
-
-    if(to_scroll <= last_printed_cursor.y)
-    {
-        last_printed_cursor.y -= to_scroll;
-    }
-    else
-    {
-        last_printed_cursor.x = 0;
-        last_printed_cursor.y = 0;
-    }
+    _vga_console_flush();
 }
 
 void vga_console_set_color_scheme(const colorscheme_t color_scheme)
@@ -480,16 +616,21 @@ void vga_console_put_string(const char* string)
     size_t i;
 
     /* Output each character of the string */
-    for(i = 0; i < strlen(string); ++i)
+    for(i = 0; string[i] != 0; ++i)
     {
-        vga_console_put_char(string[i]);
+        _vga_console_process_char(string[i]);
+        last_printed_cursor = screen_cursor;
     }
+
+    _vga_console_flush();
 }
 
 void vga_console_put_char(const char character)
 {
     _vga_console_process_char(character);
     last_printed_cursor = screen_cursor;
+
+    _vga_console_flush();
 }
 
 void vga_console_write_keyboard(const char* string, const size_t size)
@@ -501,6 +642,8 @@ void vga_console_write_keyboard(const char* string, const size_t size)
     {
         _vga_console_process_char(string[i]);
     }
+
+    _vga_console_flush();
 }
 
 const kernel_console_driver_t* vga_console_get_driver(void)
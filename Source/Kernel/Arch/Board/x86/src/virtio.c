@@ -0,0 +1,855 @@
+/*******************************************************************************
+ * @file virtio.c
+ *
+ * @see virtio.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Virtio PCI transport and split virtqueues.
+ *
+ * @details Virtio PCI transport and split virtqueues. The driver handles the
+ * modern virtio PCI devices: the configuration structures are found with the
+ * vendor capabilities and mapped from the device BARs. The virtqueues buffers
+ * are given to the device at their physical address, the data is never
+ * copied. When the device offers the event index feature, the device only
+ * interrupts and is only notified when the other side asked for it.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* Memory manipulation */
+#include <cpu.h>            /* CPU pause */
+#include <kheap.h>          /* Kernel heap */
+#include <vmm.h>            /* Virtual memory manager */
+#include <mmio.h>           /* Memory mapped IOs */
+#include <ioapic.h>         /* Message signaled interrupts */
+#include <pci.h>            /* PCI bus driver */
+#include <kernel_output.h>  /* Kernel outputs */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <virtio.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module name */
+#define MODULE_NAME "X86 VIRTIO"
+
+/** @brief Virtio PCI vendor identifier. */
+#define VIRTIO_PCI_VENDOR_ID      0x1AF4
+/** @brief First modern virtio PCI device identifier, added to the type. */
+#define VIRTIO_PCI_MODERN_ID_BASE 0x1040
+/** @brief Transitional network card PCI device identifier. */
+#define VIRTIO_PCI_LEGACY_NET_ID  0x1000
+/** @brief Transitional console PCI device identifier. */
+#define VIRTIO_PCI_LEGACY_CONSOLE_ID 0x1003
+
+/** @brief Configuration type offset in the vendor capability. */
+#define VIRTIO_CAP_CFG_TYPE    3
+/** @brief BAR offset in the vendor capability. */
+#define VIRTIO_CAP_BAR         4
+/** @brief Structure offset offset in the vendor capability. */
+#define VIRTIO_CAP_OFFSET      8
+/** @brief Structure length offset in the vendor capability. */
+#define VIRTIO_CAP_LENGTH      12
+/** @brief Notify multiplier offset in the notify capability. */
+#define VIRTIO_CAP_NOTIFY_MULT 16
+
+/** @brief Common configuration structure type. */
+#define VIRTIO_CFG_TYPE_COMMON 1
+/** @brief Notification structure type. */
+#define VIRTIO_CFG_TYPE_NOTIFY 2
+/** @brief Device specific configuration structure type. */
+#define VIRTIO_CFG_TYPE_DEVICE 4
+
+/** @brief Device feature select register. */
+#define VIRTIO_COMMON_DFSELECT    0
+/** @brief Device feature register. */
+#define VIRTIO_COMMON_DFEATURE    4
+/** @brief Driver feature select register. */
+#define VIRTIO_COMMON_GFSELECT    8
+/** @brief Driver feature register. */
+#define VIRTIO_COMMON_GFEATURE    12
+/** @brief Configuration change MSI-X vector register. */
+#define VIRTIO_COMMON_MSIX_CONFIG 16
+/** @brief Device status register. */
+#define VIRTIO_COMMON_STATUS      20
+/** @brief Configuration generation register. */
+#define VIRTIO_COMMON_GENERATION  21
+/** @brief Queue select register. */
+#define VIRTIO_COMMON_Q_SELECT    22
+/** @brief Queue size register. */
+#define VIRTIO_COMMON_Q_SIZE      24
+/** @brief Queue MSI-X vector register. */
+#define VIRTIO_COMMON_Q_MSIX      26
+/** @brief Queue enable register. */
+#define VIRTIO_COMMON_Q_ENABLE    28
+/** @brief Queue notification offset register. */
+#define VIRTIO_COMMON_Q_NOFF      30
+/** @brief Descriptors table address register. */
+#define VIRTIO_COMMON_Q_DESC      32
+/** @brief Available ring address register. */
+#define VIRTIO_COMMON_Q_DRIVER    40
+/** @brief Used ring address register. */
+#define VIRTIO_COMMON_Q_DEVICE    48
+
+/** @brief Driver acknowledged the device. */
+#define VIRTIO_STATUS_ACKNOWLEDGE 0x01
+/** @brief Driver knows how to drive the device. */
+#define VIRTIO_STATUS_DRIVER      0x02
+/** @brief Driver is ready. */
+#define VIRTIO_STATUS_DRIVER_OK   0x04
+/** @brief Features negotiation is complete. */
+#define VIRTIO_STATUS_FEATURES_OK 0x08
+/** @brief Driver gave up on the device. */
+#define VIRTIO_STATUS_FAILED      0x80
+
+/** @brief MSI-X vector disabling an interrupt source. */
+#define VIRTIO_MSI_NO_VECTOR 0xFFFF
+
+/** @brief Descriptor continues in its next field. */
+#define VIRTQ_DESC_F_NEXT  0x1
+/** @brief Descriptor buffer is written by the device. */
+#define VIRTQ_DESC_F_WRITE 0x2
+
+/** @brief Driver asks the device not to interrupt. */
+#define VIRTQ_AVAIL_F_NO_INTERRUPT 0x1
+/** @brief Device asks the driver not to notify. */
+#define VIRTQ_USED_F_NO_NOTIFY     0x1
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/** @brief Address of a register of the common configuration. */
+#define VIRTIO_COMMON_REG(DEVICE, REG) \
+    ((void*)((uintptr_t)(DEVICE)->common + (REG)))
+
+/** @brief Used event index, written by the driver after the available ring. */
+#define VIRTQ_USED_EVENT(QUEUE) ((QUEUE)->avail->ring[(QUEUE)->size])
+
+/** @brief Available event index, written by the device after the used ring. */
+#define VIRTQ_AVAIL_EVENT(QUEUE)                                  \
+    (*(uint16_t*)((uintptr_t)(QUEUE)->used + sizeof(virtq_used_t) + \
+                  sizeof(virtq_used_elem_t) * (QUEUE)->size))
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Maps the configuration structures of a device.
+ *
+ * @param[in, out] device The device.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if a structure is missing.
+ * - Any error returned by pci_map_bar.
+ */
+static OS_RETURN_E _virtio_map_structures(virtio_device_t* device);
+
+/**
+ * @brief Sets bits of the device status.
+ *
+ * @param[in] device The device.
+ * @param[in] status The status bits to set.
+ */
+static void _virtio_add_status(virtio_device_t* device, const uint8_t status);
+
+/**
+ * @brief Returns the physical address of a ring.
+ *
+ * @param[in] ring The ring virtual address.
+ * @param[in] size The ring size.
+ * @param[out] phys The ring physical address.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NO_MORE_MEMORY is returned if the ring crosses a page and might
+ * not be physically contiguous.
+ * - Any error returned by vmm_get_physical.
+ */
+static OS_RETURN_E _virtio_get_ring_physical(const void* ring,
+                                             const size_t size,
+                                             uint64_t* phys);
+
+/**
+ * @brief Writes a 64 bits register of the common configuration.
+ *
+ * @param[in] device The device.
+ * @param[in] reg The register offset.
+ * @param[in] value The value to write.
+ */
+static void _virtio_write_common_64(virtio_device_t* device,
+                                    const uint32_t reg,
+                                    const uint64_t value);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static OS_RETURN_E _virtio_map_structures(virtio_device_t* device)
+{
+    OS_RETURN_E     err;
+    uint8_t         cap;
+    uint8_t         type;
+    uint8_t         bar;
+    uint32_t        offset;
+    uint32_t        length;
+    volatile void*  structure;
+
+    for(cap = pci_find_capability(&device->pci, PCI_CAP_ID_VENDOR, 0);
+        cap != 0;
+        cap = pci_find_capability(&device->pci, PCI_CAP_ID_VENDOR, cap))
+    {
+        type   = pci_read_config_8(&device->pci, cap + VIRTIO_CAP_CFG_TYPE);
+        bar    = pci_read_config_8(&device->pci, cap + VIRTIO_CAP_BAR);
+        offset = pci_read_config_32(&device->pci, cap + VIRTIO_CAP_OFFSET);
+        length = pci_read_config_32(&device->pci, cap + VIRTIO_CAP_LENGTH);
+
+        /* The first structure of each type is the preferred one */
+        if((type == VIRTIO_CFG_TYPE_COMMON && device->common != NULL) ||
+           (type == VIRTIO_CFG_TYPE_NOTIFY && device->notify != NULL) ||
+           (type == VIRTIO_CFG_TYPE_DEVICE && device->device_config != NULL) ||
+           (type != VIRTIO_CFG_TYPE_COMMON &&
+            type != VIRTIO_CFG_TYPE_NOTIFY &&
+            type != VIRTIO_CFG_TYPE_DEVICE))
+        {
+            continue;
+        }
+
+        err = pci_map_bar(&device->pci, bar, offset, length, &structure);
+        if(err != OS_NO_ERR)
+        {
+            return err;
+        }
+
+        if(type == VIRTIO_CFG_TYPE_COMMON)
+        {
+            device->common = structure;
+        }
+        else if(type == VIRTIO_CFG_TYPE_NOTIFY)
+        {
+            device->notify = structure;
+            device->notify_multiplier =
+                pci_read_config_32(&device->pci, cap + VIRTIO_CAP_NOTIFY_MULT);
+        }
+        else
+        {
+            device->device_config = structure;
+        }
+    }
+
+    if(device->common == NULL || device->notify == NULL)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    return OS_NO_ERR;
+}
+
+static void _virtio_add_status(virtio_device_t* device, const uint8_t status)
+{
+    uint8_t current;
+
+    current = _mapped_io_read_8(VIRTIO_COMMON_REG(device,
+                                                 VIRTIO_COMMON_STATUS));
+    _mapped_io_write_8(VIRTIO_COMMON_REG(device, VIRTIO_COMMON_STATUS),
+                       current | status);
+}
+
+static OS_RETURN_E _virtio_get_ring_physical(const void* ring,
+                                             const size_t size,
+                                             uint64_t* phys)
+{
+    OS_RETURN_E err;
+    uintptr_t   address;
+
+    /* The heap gives contiguous physical memory within a page only */
+    if(((uintptr_t)ring & (VMM_PAGE_SIZE - 1)) + size > VMM_PAGE_SIZE)
+    {
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+
+    err = vmm_get_physical((uintptr_t)ring, &address);
+    *phys = address;
+
+    return err;
+}
+
+static void _virtio_write_common_64(virtio_device_t* device,
+                                    const uint32_t reg,
+                                    const uint64_t value)
+{
+    _mapped_io_write_32(VIRTIO_COMMON_REG(device, reg), (uint32_t)value);
+    _mapped_io_write_32(VIRTIO_COMMON_REG(device, reg + 4),
+                        (uint32_t)(value >> 32));
+}
+
+OS_RETURN_E virtio_device_init(const uint32_t type,
+                               const uint64_t features,
+                               virtio_device_t* device)
+{
+    OS_RETURN_E err;
+    uint16_t    legacy_id;
+    uint64_t    offered;
+    uint64_t    accepted;
+
+    if(device == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    memset(device, 0, sizeof(virtio_device_t));
+
+    /* Transitional devices also expose the modern interface */
+    err = pci_find_device(VIRTIO_PCI_VENDOR_ID,
+                          VIRTIO_PCI_MODERN_ID_BASE + type,
+                          &device->pci);
+    if(err == OS_ERR_NOT_SUPPORTED)
+    {
+        legacy_id = 0;
+        if(type == VIRTIO_TYPE_NET)
+        {
+            legacy_id = VIRTIO_PCI_LEGACY_NET_ID;
+        }
+        else if(type == VIRTIO_TYPE_CONSOLE)
+        {
+            legacy_id = VIRTIO_PCI_LEGACY_CONSOLE_ID;
+        }
+
+        if(legacy_id != 0)
+        {
+            err = pci_find_device(VIRTIO_PCI_VENDOR_ID, legacy_id,
+                                  &device->pci);
+        }
+    }
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    pci_enable_device(&device->pci);
+
+    err = _virtio_map_structures(device);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    /* Reset the device, the reset completes when the status reads 0 */
+    _mapped_io_write_8(VIRTIO_COMMON_REG(device, VIRTIO_COMMON_STATUS), 0);
+    while(_mapped_io_read_8(VIRTIO_COMMON_REG(device,
+                                              VIRTIO_COMMON_STATUS)) != 0)
+    {
+        _cpu_pause();
+    }
+
+    _virtio_add_status(device, VIRTIO_STATUS_ACKNOWLEDGE);
+    _virtio_add_status(device, VIRTIO_STATUS_DRIVER);
+
+    _mapped_io_write_32(VIRTIO_COMMON_REG(device, VIRTIO_COMMON_DFSELECT), 0);
+    offered = _mapped_io_read_32(VIRTIO_COMMON_REG(device,
+                                                   VIRTIO_COMMON_DFEATURE));
+    _mapped_io_write_32(VIRTIO_COMMON_REG(device, VIRTIO_COMMON_DFSELECT), 1);
+    offered |= (uint64_t)_mapped_io_read_32(
+                   VIRTIO_COMMON_REG(device, VIRTIO_COMMON_DFEATURE)) << 32;
+
+    accepted = (features | (1ULL << VIRTIO_F_VERSION_1)) & offered;
+    if((accepted & (1ULL << VIRTIO_F_VERSION_1)) == 0)
+    {
+        virtio_device_fail(device);
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    _mapped_io_write_32(VIRTIO_COMMON_REG(device, VIRTIO_COMMON_GFSELECT), 0);
+    _mapped_io_write_32(VIRTIO_COMMON_REG(device, VIRTIO_COMMON_GFEATURE),
+                        (uint32_t)accepted);
+    _mapped_io_write_32(VIRTIO_COMMON_REG(device, VIRTIO_COMMON_GFSELECT), 1);
+    _mapped_io_write_32(VIRTIO_COMMON_REG(device, VIRTIO_COMMON_GFEATURE),
+                        (uint32_t)(accepted >> 32));
+
+    _virtio_add_status(device, VIRTIO_STATUS_FEATURES_OK);
+    if((_mapped_io_read_8(VIRTIO_COMMON_REG(device, VIRTIO_COMMON_STATUS)) &
+        VIRTIO_STATUS_FEATURES_OK) == 0)
+    {
+        virtio_device_fail(device);
+        return OS_ERR_NOT_SUPPORTED;
+    }
+    device->features = accepted;
+
+    /* The configuration changes are not handled */
+    _mapped_io_write_16(VIRTIO_COMMON_REG(device, VIRTIO_COMMON_MSIX_CONFIG),
+                        VIRTIO_MSI_NO_VECTOR);
+
+    KERNEL_DEBUG(VIRTIO_DEBUG_ENABLED, MODULE_NAME,
+                 "Device type %u at %u:%u.%u, features 0x%x 0x%x",
+                 type, device->pci.bus, device->pci.device,
+                 device->pci.function, (uint32_t)(accepted >> 32),
+                 (uint32_t)accepted);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E virtio_device_enable_irq(virtio_device_t* device)
+{
+    OS_RETURN_E err;
+    uint64_t    address;
+    uint32_t    data;
+
+    err = ioapic_alloc_msi_irq(&device->irq);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    err = ioapic_get_msi_message(device->irq, 0, &address, &data);
+    if(err == OS_NO_ERR)
+    {
+        err = pci_set_msix_entry(&device->pci, 0, address, data);
+    }
+    if(err != OS_NO_ERR)
+    {
+        ioapic_free_msi_irq(device->irq);
+        return err;
+    }
+
+    device->irq_enabled = TRUE;
+
+    return OS_NO_ERR;
+}
+
+void virtio_device_ready(virtio_device_t* device)
+{
+    _virtio_add_status(device, VIRTIO_STATUS_DRIVER_OK);
+}
+
+void virtio_device_fail(virtio_device_t* device)
+{
+    _virtio_add_status(device, VIRTIO_STATUS_FAILED);
+}
+
+void virtio_read_device_config(virtio_device_t* device,
+                               const uint32_t offset,
+                               void* buffer,
+                               const size_t size)
+{
+    uint8_t  generation;
+    uint8_t* data;
+    size_t   i;
+
+    data = buffer;
+    do
+    {
+        generation = _mapped_io_read_8(
+                         VIRTIO_COMMON_REG(device, VIRTIO_COMMON_GENERATION));
+        for(i = 0; i < size; ++i)
+        {
+            data[i] = _mapped_io_read_8(
+                          (void*)((uintptr_t)device->device_config +
+                                  offset + i));
+        }
+    } while(generation != _mapped_io_read_8(
+                              VIRTIO_COMMON_REG(device,
+                                                VIRTIO_COMMON_GENERATION)));
+}
+
+OS_RETURN_E virtqueue_init(virtio_device_t* device,
+                           const uint16_t index,
+                           virtqueue_t* queue)
+{
+    OS_RETURN_E err;
+    uint16_t    size;
+    uint16_t    notify_offset;
+    uint64_t    desc_phys;
+    uint64_t    avail_phys;
+    uint64_t    used_phys;
+    uint16_t    i;
+
+    if(device == NULL || queue == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    _mapped_io_write_16(VIRTIO_COMMON_REG(device, VIRTIO_COMMON_Q_SELECT),
+                        index);
+    size = _mapped_io_read_16(VIRTIO_COMMON_REG(device,
+                                                VIRTIO_COMMON_Q_SIZE));
+    if(size == 0)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+    if(size > VIRTIO_QUEUE_MAX_SIZE)
+    {
+        size = VIRTIO_QUEUE_MAX_SIZE;
+    }
+
+    memset(queue, 0, sizeof(virtqueue_t));
+    queue->device = device;
+    queue->index  = index;
+    queue->size   = size;
+
+    /* The rings end with the event indexes */
+    queue->desc  = kmalloc(sizeof(virtq_desc_t) * size);
+    queue->avail = kmalloc(sizeof(virtq_avail_t) +
+                           sizeof(uint16_t) * (size + 1));
+    queue->used  = kmalloc(sizeof(virtq_used_t) +
+                           sizeof(virtq_used_elem_t) * size +
+                           sizeof(uint16_t));
+    if(queue->desc == NULL || queue->avail == NULL || queue->used == NULL)
+    {
+        err = OS_ERR_NO_MORE_MEMORY;
+        goto QUEUE_INIT_ERROR;
+    }
+
+    memset(queue->desc, 0, sizeof(virtq_desc_t) * size);
+    memset(queue->avail, 0, sizeof(virtq_avail_t) +
+                            sizeof(uint16_t) * (size + 1));
+    memset(queue->used, 0, sizeof(virtq_used_t) +
+                           sizeof(virtq_used_elem_t) * size +
+                           sizeof(uint16_t));
+
+    err = _virtio_get_ring_physical(queue->desc,
+                                    sizeof(virtq_desc_t) * size,
+                                    &desc_phys);
+    if(err == OS_NO_ERR)
+    {
+        err = _virtio_get_ring_physical(queue->avail,
+                                        sizeof(virtq_avail_t) +
+                                        sizeof(uint16_t) * (size + 1),
+                                        &avail_phys);
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = _virtio_get_ring_physical(queue->used,
+                                        sizeof(virtq_used_t) +
+                                        sizeof(virtq_used_elem_t) * size +
+                                        sizeof(uint16_t),
+                                        &used_phys);
+    }
+    if(err != OS_NO_ERR)
+    {
+        goto QUEUE_INIT_ERROR;
+    }
+
+    /* The free descriptors are linked with their next field */
+    for(i = 0; i < size; ++i)
+    {
+        queue->desc[i].next = i + 1;
+    }
+    queue->free_head      = 0;
+    queue->free_count     = size;
+    queue->event_index    = (device->features >> VIRTIO_F_EVENT_IDX) & 0x1;
+    queue->notify_enabled = TRUE;
+
+    _mapped_io_write_16(VIRTIO_COMMON_REG(device, VIRTIO_COMMON_Q_SIZE),
+                        size);
+    if(device->irq_enabled == TRUE)
+    {
+        _mapped_io_write_16(VIRTIO_COMMON_REG(device, VIRTIO_COMMON_Q_MSIX),
+                            0);
+        if(_mapped_io_read_16(VIRTIO_COMMON_REG(device,
+                                                VIRTIO_COMMON_Q_MSIX)) ==
+           VIRTIO_MSI_NO_VECTOR)
+        {
+            err = OS_ERR_NOT_SUPPORTED;
+            goto QUEUE_INIT_ERROR;
+        }
+    }
+    else
+    {
+        _mapped_io_write_16(VIRTIO_COMMON_REG(device, VIRTIO_COMMON_Q_MSIX),
+                            VIRTIO_MSI_NO_VECTOR);
+    }
+
+    _virtio_write_common_64(device, VIRTIO_COMMON_Q_DESC, desc_phys);
+    _virtio_write_common_64(device, VIRTIO_COMMON_Q_DRIVER, avail_phys);
+    _virtio_write_common_64(device, VIRTIO_COMMON_Q_DEVICE, used_phys);
+
+    notify_offset = _mapped_io_read_16(VIRTIO_COMMON_REG(device,
+                                                         VIRTIO_COMMON_Q_NOFF));
+    queue->notify = (volatile void*)((uintptr_t)device->notify +
+                                     notify_offset *
+                                     device->notify_multiplier);
+
+    _mapped_io_write_16(VIRTIO_COMMON_REG(device, VIRTIO_COMMON_Q_ENABLE), 1);
+
+    KERNEL_DEBUG(VIRTIO_DEBUG_ENABLED, MODULE_NAME,
+                 "Queue %u initialized, size %u, event index %u",
+                 index, size, queue->event_index);
+
+    return OS_NO_ERR;
+
+QUEUE_INIT_ERROR:
+    kfree(queue->desc);
+    kfree(queue->avail);
+    kfree(queue->used);
+    queue->desc  = NULL;
+    queue->avail = NULL;
+    queue->used  = NULL;
+
+    return err;
+}
+
+OS_RETURN_E virtqueue_add(virtqueue_t* queue,
+                          const virtio_buffer_t* buffers,
+                          const uint32_t out_count,
+                          const uint32_t in_count,
+                          void* cookie)
+{
+    OS_RETURN_E err;
+    uint32_t    i;
+    uintptr_t   address;
+    uintptr_t   phys;
+    size_t      left;
+    size_t      chunk;
+    uint16_t    flags;
+    uint16_t    head;
+    uint16_t    free_count;
+    uint16_t    last;
+    uint16_t    used_count;
+    uint16_t    avail_index;
+
+    if(queue == NULL || buffers == NULL || cookie == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    head       = queue->free_head;
+    free_count = queue->free_count;
+    last       = queue->size;
+    used_count = 0;
+
+    /* The free list order is the chain order, only the flags are written */
+    for(i = 0; i < out_count + in_count; ++i)
+    {
+        flags   = (i < out_count) ? 0 : VIRTQ_DESC_F_WRITE;
+        address = (uintptr_t)buffers[i].address;
+        left    = buffers[i].size;
+        while(left > 0)
+        {
+            chunk = VMM_PAGE_SIZE - (address & (VMM_PAGE_SIZE - 1));
+            if(chunk > left)
+            {
+                chunk = left;
+            }
+
+            err = vmm_get_physical(address, &phys);
+            if(err != OS_NO_ERR)
+            {
+                goto ADD_ERROR;
+            }
+
+            /* Physically contiguous pages share a descriptor */
+            if(last != queue->size &&
+               queue->desc[last].flags == flags &&
+               queue->desc[last].address + queue->desc[last].length ==
+               phys &&
+               queue->desc[last].length <= UINT32_MAX - chunk)
+            {
+                queue->desc[last].length += chunk;
+            }
+            else
+            {
+                if(queue->free_count == 0)
+                {
+                    err = OS_ERR_NO_MORE_MEMORY;
+                    goto ADD_ERROR;
+                }
+                if(last != queue->size)
+                {
+                    queue->desc[last].flags |= VIRTQ_DESC_F_NEXT;
+                }
+
+                last = queue->free_head;
+                queue->free_head = queue->desc[last].next;
+                --queue->free_count;
+                ++used_count;
+
+                queue->desc[last].address = phys;
+                queue->desc[last].length  = chunk;
+                queue->desc[last].flags   = flags;
+            }
+
+            address += chunk;
+            left    -= chunk;
+        }
+    }
+
+    if(used_count == 0)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    queue->cookies[head] = cookie;
+
+    /* Publish the chain, the descriptors are written before the index */
+    avail_index = queue->avail->index;
+    queue->avail->ring[avail_index % queue->size] = head;
+    __atomic_store_n(&queue->avail->index, (uint16_t)(avail_index + 1),
+                     __ATOMIC_RELEASE);
+
+    return OS_NO_ERR;
+
+ADD_ERROR:
+    queue->free_head  = head;
+    queue->free_count = free_count;
+
+    return err;
+}
+
+void virtqueue_kick(virtqueue_t* queue)
+{
+    uint16_t new_index;
+    uint16_t old_index;
+    uint16_t event;
+    bool_t   notify;
+
+    /* The device reads the event after the new index is visible */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    new_index = queue->avail->index;
+    old_index = queue->kicked_index;
+    queue->kicked_index = new_index;
+
+    if(queue->event_index == TRUE)
+    {
+        event  = __atomic_load_n(&VIRTQ_AVAIL_EVENT(queue), __ATOMIC_RELAXED);
+        notify = (uint16_t)(new_index - event - 1) <
+                 (uint16_t)(new_index - old_index);
+    }
+    else
+    {
+        notify = (__atomic_load_n(&queue->used->flags, __ATOMIC_RELAXED) &
+                  VIRTQ_USED_F_NO_NOTIFY) == 0;
+    }
+
+    if(notify == TRUE)
+    {
+        _mapped_io_write_16((void*)queue->notify, queue->index);
+    }
+}
+
+void* virtqueue_get_used(virtqueue_t* queue, uint32_t* length)
+{
+    uint16_t used_index;
+    uint32_t id;
+    uint16_t last;
+    uint16_t count;
+    void*    cookie;
+
+    used_index = __atomic_load_n(&queue->used->index, __ATOMIC_ACQUIRE);
+    if(used_index == queue->last_used)
+    {
+        return NULL;
+    }
+
+    id = queue->used->ring[queue->last_used % queue->size].id;
+    if(length != NULL)
+    {
+        *length = queue->used->ring[queue->last_used % queue->size].length;
+    }
+    ++queue->last_used;
+
+    if(id >= queue->size || queue->cookies[id] == NULL)
+    {
+        KERNEL_ERROR("Virtqueue %u used an invalid chain %u\n",
+                     queue->index, id);
+        return NULL;
+    }
+
+    /* Give the chain back to the free list */
+    last  = id;
+    count = 1;
+    while((queue->desc[last].flags & VIRTQ_DESC_F_NEXT) != 0)
+    {
+        last = queue->desc[last].next;
+        ++count;
+    }
+    queue->desc[last].next = queue->free_head;
+    queue->free_head       = id;
+    queue->free_count     += count;
+
+    cookie = queue->cookies[id];
+    queue->cookies[id] = NULL;
+
+    /* Ask for an interrupt on the next used chain only */
+    if(queue->event_index == TRUE && queue->notify_enabled == TRUE)
+    {
+        __atomic_store_n(&VIRTQ_USED_EVENT(queue), queue->last_used,
+                         __ATOMIC_RELAXED);
+    }
+
+    return cookie;
+}
+
+void virtqueue_disable_notify(virtqueue_t* queue)
+{
+    queue->notify_enabled = FALSE;
+
+    /* With the event index, the stale used event stops the interrupts */
+    if(queue->event_index == FALSE)
+    {
+        __atomic_store_n(&queue->avail->flags, VIRTQ_AVAIL_F_NO_INTERRUPT,
+                         __ATOMIC_RELAXED);
+    }
+}
+
+bool_t virtqueue_enable_notify(virtqueue_t* queue)
+{
+    queue->notify_enabled = TRUE;
+
+    if(queue->event_index == TRUE)
+    {
+        __atomic_store_n(&VIRTQ_USED_EVENT(queue), queue->last_used,
+                         __ATOMIC_RELAXED);
+    }
+    else
+    {
+        __atomic_store_n(&queue->avail->flags, 0, __ATOMIC_RELAXED);
+    }
+
+    /* The device checks the request after writing the used index */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    return __atomic_load_n(&queue->used->index, __ATOMIC_RELAXED) !=
+           queue->last_used;
+}
+
+/************************************ EOF *************************************/
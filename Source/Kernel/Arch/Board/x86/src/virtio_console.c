@@ -0,0 +1,477 @@
+/*******************************************************************************
+ * @file virtio_console.c
+ *
+ * @see virtio_console.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Virtio console driver.
+ *
+ * @details Virtio console driver, using the first port of the device. The
+ * output buffers are given to the device without copy and the writers wait
+ * for the device to consume them: the transmit queue never interrupts. The
+ * input is polled.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* Memory manipulation */
+#include <cpu.h>            /* CPU pause */
+#include <critical.h>       /* Kernel spinlocks */
+#include <vmm.h>            /* Page size */
+#include <virtio.h>         /* Virtio transport */
+#include <console.h>        /* Console driver manager */
+#include <trace_drain.h>    /* Trace output driver */
+#include <ioring.h>         /* Asynchronous I/O rings */
+#include <kernel_output.h>  /* Kernel outputs */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <virtio_console.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module name */
+#define MODULE_NAME "X86 VIRTIO CONSOLE"
+
+/** @brief Receive queue of the first port. */
+#define VIRTIO_CONSOLE_RX_QUEUE 0
+/** @brief Transmit queue of the first port. */
+#define VIRTIO_CONSOLE_TX_QUEUE 1
+
+/** @brief Number of posted receive buffers. */
+#define VIRTIO_CONSOLE_RX_COUNT 8
+/** @brief Size of a receive buffer. */
+#define VIRTIO_CONSOLE_RX_SIZE  64
+
+/** @brief Maximal size given to the device at once, bounds the descriptors. */
+#define VIRTIO_CONSOLE_TX_MAX_SIZE (8 * VMM_PAGE_SIZE)
+
+/** @brief Number of lines printed to clear the screen. */
+#define VIRTIO_CONSOLE_LINE_COUNT 25
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+
+/** @brief Virtio console text driver instance. */
+static kernel_console_driver_t virtio_console_text_driver =
+{
+    .clear_screen           = virtio_console_clear_screen,
+    .put_cursor_at          = NULL,
+    .save_cursor            = NULL,
+    .restore_cursor         = NULL,
+    .scroll                 = NULL,
+    .set_color_scheme       = NULL,
+    .save_color_scheme      = NULL,
+    .put_string             = virtio_console_put_string,
+    .put_char               = virtio_console_put_char,
+    .console_write_keyboard = virtio_console_write_keyboard
+};
+
+/** @brief Virtio console trace output driver instance. */
+static kernel_trace_output_t virtio_console_trace_driver =
+{
+    .write = virtio_console_trace_write
+};
+
+/** @brief The console device. */
+static virtio_device_t virtio_console_device;
+
+/** @brief Receive queue. */
+static virtqueue_t virtio_console_rx;
+
+/** @brief Transmit queue. */
+static virtqueue_t virtio_console_tx;
+
+/** @brief Receive buffers, in the kernel image. */
+static uint8_t virtio_console_rx_buffers[VIRTIO_CONSOLE_RX_COUNT]
+                                        [VIRTIO_CONSOLE_RX_SIZE];
+
+/** @brief Receive buffer being read, NULL if none. */
+static uint8_t* virtio_console_rx_pending = NULL;
+
+/** @brief Number of bytes received in the pending buffer. */
+static uint32_t virtio_console_rx_length = 0;
+
+/** @brief Number of bytes of the pending buffer already read. */
+static uint32_t virtio_console_rx_offset = 0;
+
+/** @brief TRUE once the device is initialized. */
+static volatile bool_t virtio_console_ready = FALSE;
+
+/** @brief Lock serializing the transmit queue. */
+static kernel_spinlock_t virtio_console_tx_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/** @brief Lock serializing the receive queue. */
+static kernel_spinlock_t virtio_console_rx_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/** @brief Read request waiting for input, NULL if none. */
+static ioring_request_t* volatile virtio_console_rx_request = NULL;
+
+/** @brief Asynchronous I/O target of the console. */
+static ioring_target_t virtio_console_ioring_target;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Gives a buffer to the device and waits for its consumption.
+ *
+ * @param[in] buffer The buffer to write.
+ * @param[in] size The size of the buffer.
+ */
+static void _virtio_console_write(const void* buffer, const size_t size);
+
+/**
+ * @brief Posts a receive buffer, the receive lock must be held when the
+ * device is ready.
+ *
+ * @param[in] buffer The buffer to post.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - Any error returned by virtqueue_add.
+ */
+static OS_RETURN_E _virtio_console_post_rx(uint8_t* buffer);
+
+/**
+ * @brief Starts an asynchronous operation on the console.
+ *
+ * @param[in] target The console target.
+ * @param[in] request The request to start.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the console is not initialized or the
+ * operation is not supported.
+ * - OS_ERR_NULL_POINTER is returned if the buffer is NULL.
+ * - OS_ERR_RESOURCE_BUSY is returned if a read is already in flight.
+ */
+static OS_RETURN_E _virtio_console_ioring_submit(ioring_target_t* target,
+                                                 ioring_request_t* request);
+
+/**
+ * @brief Polls the read in flight on the console.
+ *
+ * @param[in] target The console target.
+ */
+static void _virtio_console_ioring_poll(ioring_target_t* target);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void _virtio_console_write(const void* buffer, const size_t size)
+{
+    OS_RETURN_E     err;
+    uint32_t        int_state;
+    virtio_buffer_t chunk;
+    size_t          left;
+
+    if(virtio_console_ready == FALSE)
+    {
+        return;
+    }
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(virtio_console_tx_lock, int_state);
+
+    chunk.address = buffer;
+    left          = size;
+    while(left > 0)
+    {
+        chunk.size = left;
+        if(chunk.size > VIRTIO_CONSOLE_TX_MAX_SIZE)
+        {
+            chunk.size = VIRTIO_CONSOLE_TX_MAX_SIZE;
+        }
+
+        err = virtqueue_add(&virtio_console_tx, &chunk, 1, 0,
+                            &virtio_console_tx);
+        if(err != OS_NO_ERR)
+        {
+            break;
+        }
+        virtqueue_kick(&virtio_console_tx);
+
+        /* The buffer is the caller's, it is released once consumed */
+        while(virtqueue_get_used(&virtio_console_tx, NULL) == NULL)
+        {
+            _cpu_pause();
+        }
+
+        chunk.address = (const uint8_t*)chunk.address + chunk.size;
+        left         -= chunk.size;
+    }
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(virtio_console_tx_lock, int_state);
+}
+
+static OS_RETURN_E _virtio_console_post_rx(uint8_t* buffer)
+{
+    virtio_buffer_t rx_buffer;
+
+    rx_buffer.address = buffer;
+    rx_buffer.size    = VIRTIO_CONSOLE_RX_SIZE;
+
+    return virtqueue_add(&virtio_console_rx, &rx_buffer, 0, 1, buffer);
+}
+
+static OS_RETURN_E _virtio_console_ioring_submit(ioring_target_t* target,
+                                                 ioring_request_t* request)
+{
+    ioring_request_t* expected;
+
+    if(virtio_console_ready == FALSE)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+    if(request->sqe.buffer == NULL && request->sqe.size != 0)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(request->sqe.opcode == IORING_OP_WRITE)
+    {
+        _virtio_console_write(request->sqe.buffer, request->sqe.size);
+        ioring_complete(request, OS_NO_ERR, request->sqe.size);
+        return OS_NO_ERR;
+    }
+    if(request->sqe.opcode != IORING_OP_READ)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    /* The input is polled, the read completes from the ring poll */
+    expected = NULL;
+    if(__atomic_compare_exchange_n(&virtio_console_rx_request, &expected,
+                                   request, FALSE, __ATOMIC_ACQ_REL,
+                                   __ATOMIC_RELAXED) == FALSE)
+    {
+        return OS_ERR_RESOURCE_BUSY;
+    }
+    _virtio_console_ioring_poll(target);
+
+    return OS_NO_ERR;
+}
+
+static void _virtio_console_ioring_poll(ioring_target_t* target)
+{
+    ioring_request_t* request;
+    size_t            read;
+
+    (void)target;
+
+    request = __atomic_load_n(&virtio_console_rx_request, __ATOMIC_ACQUIRE);
+    if(request == NULL)
+    {
+        return;
+    }
+
+    read = virtio_console_read(request->sqe.buffer, request->sqe.size);
+    if(read == 0 && request->sqe.size != 0)
+    {
+        return;
+    }
+
+    /* Only the ring owner polls, the request cannot be taken meanwhile */
+    __atomic_store_n(&virtio_console_rx_request, NULL, __ATOMIC_RELEASE);
+    ioring_complete(request, OS_NO_ERR, read);
+}
+
+OS_RETURN_E virtio_console_init(void)
+{
+    OS_RETURN_E err;
+    uint32_t    i;
+
+    err = virtio_device_init(VIRTIO_TYPE_CONSOLE,
+                             1ULL << VIRTIO_F_EVENT_IDX,
+                             &virtio_console_device);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    err = virtqueue_init(&virtio_console_device, VIRTIO_CONSOLE_RX_QUEUE,
+                         &virtio_console_rx);
+    if(err == OS_NO_ERR)
+    {
+        err = virtqueue_init(&virtio_console_device, VIRTIO_CONSOLE_TX_QUEUE,
+                             &virtio_console_tx);
+    }
+    if(err != OS_NO_ERR)
+    {
+        virtio_device_fail(&virtio_console_device);
+        return err;
+    }
+
+    /* Both queues are polled */
+    virtqueue_disable_notify(&virtio_console_rx);
+    virtqueue_disable_notify(&virtio_console_tx);
+
+    for(i = 0; i < VIRTIO_CONSOLE_RX_COUNT; ++i)
+    {
+        err = _virtio_console_post_rx(virtio_console_rx_buffers[i]);
+        if(err != OS_NO_ERR)
+        {
+            virtio_device_fail(&virtio_console_device);
+            return err;
+        }
+    }
+
+    virtio_device_ready(&virtio_console_device);
+    virtqueue_kick(&virtio_console_rx);
+
+    virtio_console_ready = TRUE;
+
+    KERNEL_DEBUG(VIRTIO_DEBUG_ENABLED, MODULE_NAME,
+                 "Virtio console initialized");
+
+    return OS_NO_ERR;
+}
+
+void virtio_console_put_string(const char* string)
+{
+    _virtio_console_write(string, strlen(string));
+}
+
+void virtio_console_put_char(const char character)
+{
+    _virtio_console_write(&character, sizeof(character));
+}
+
+void virtio_console_clear_screen(void)
+{
+    uint32_t i;
+
+    for(i = 0; i < VIRTIO_CONSOLE_LINE_COUNT; ++i)
+    {
+        virtio_console_put_char('\n');
+    }
+}
+
+void virtio_console_write_keyboard(const char* string, const size_t len)
+{
+    _virtio_console_write(string, len);
+}
+
+size_t virtio_console_read(void* buffer, const size_t size)
+{
+    uint32_t int_state;
+    size_t   read;
+    size_t   chunk;
+
+    if(virtio_console_ready == FALSE || buffer == NULL)
+    {
+        return 0;
+    }
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(virtio_console_rx_lock, int_state);
+
+    read = 0;
+    while(read < size)
+    {
+        if(virtio_console_rx_pending == NULL)
+        {
+            virtio_console_rx_pending =
+                virtqueue_get_used(&virtio_console_rx,
+                                   &virtio_console_rx_length);
+            virtio_console_rx_offset = 0;
+            if(virtio_console_rx_pending == NULL)
+            {
+                break;
+            }
+            if(virtio_console_rx_length > VIRTIO_CONSOLE_RX_SIZE)
+            {
+                virtio_console_rx_length = VIRTIO_CONSOLE_RX_SIZE;
+            }
+        }
+
+        chunk = virtio_console_rx_length - virtio_console_rx_offset;
+        if(chunk > size - read)
+        {
+            chunk = size - read;
+        }
+        memcpy((uint8_t*)buffer + read,
+               virtio_console_rx_pending + virtio_console_rx_offset,
+               chunk);
+        read                     += chunk;
+        virtio_console_rx_offset += chunk;
+
+        /* Give the consumed buffer back to the device */
+        if(virtio_console_rx_offset == virtio_console_rx_length)
+        {
+            _virtio_console_post_rx(virtio_console_rx_pending);
+            virtqueue_kick(&virtio_console_rx);
+            virtio_console_rx_pending = NULL;
+        }
+    }
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(virtio_console_rx_lock, int_state);
+
+    return read;
+}
+
+const kernel_console_driver_t* virtio_console_get_driver(void)
+{
+    return &virtio_console_text_driver;
+}
+
+void virtio_console_trace_write(const void* buffer, const size_t size)
+{
+    _virtio_console_write(buffer, size);
+}
+
+const kernel_trace_output_t* virtio_console_get_trace_output(void)
+{
+    return &virtio_console_trace_driver;
+}
+
+ioring_target_t* virtio_console_get_ioring_target(void)
+{
+    virtio_console_ioring_target.name        = "virtio-console";
+    virtio_console_ioring_target.submit      = _virtio_console_ioring_submit;
+    virtio_console_ioring_target.poll        = _virtio_console_ioring_poll;
+    virtio_console_ioring_target.driver_ctrl = NULL;
+
+    return &virtio_console_ioring_target;
+}
+
+/************************************ EOF *************************************/
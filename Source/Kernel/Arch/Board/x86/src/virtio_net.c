@@ -0,0 +1,585 @@
+/*******************************************************************************
+ * @file virtio_net.c
+ *
+ * @see virtio_net.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Virtio network card driver.
+ *
+ * @details Virtio network card driver. The sent frames are given to the
+ * device without copy and the received frames are handed to the receive
+ * handler in the buffer the device wrote. The device interrupt schedules the
+ * queues poll and the queues interrupts stay disabled while the poll runs.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* Memory manipulation */
+#include <critical.h>       /* Kernel spinlocks */
+#include <kheap.h>          /* Kernel heap */
+#include <interrupts.h>     /* Interrupt manager */
+#include <irq_poll.h>       /* Interrupt coalescing */
+#include <virtio.h>         /* Virtio transport */
+#include <kbuf.h>           /* Chained data buffers */
+#include <kernel_output.h>  /* Kernel outputs */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <virtio_net.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module name */
+#define MODULE_NAME "X86 VIRTIO NET"
+
+/** @brief MAC address feature bit. */
+#define VIRTIO_NET_F_MAC 5
+
+/** @brief Receive queue of the first queue pair. */
+#define VIRTIO_NET_RX_QUEUE 0
+/** @brief Transmit queue of the first queue pair. */
+#define VIRTIO_NET_TX_QUEUE 1
+
+/** @brief Maximal number of posted receive buffers. */
+#define VIRTIO_NET_RX_COUNT 64
+/**
+ * @brief Size of a receive buffer, holds the header and a full frame. The
+ * heap aligns it on its size, it is physically contiguous.
+ */
+#define VIRTIO_NET_RX_SIZE  2048
+
+/** @brief Number of frames in flight on the transmit queue. */
+#define VIRTIO_NET_TX_COUNT 32
+
+/** @brief Maximal number of segments of a sent buffer. */
+#define VIRTIO_NET_TX_MAX_SEGMENTS 8
+
+/** @brief Maximal number of events handled by a poll call. */
+#define VIRTIO_NET_POLL_BUDGET 64
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Virtio network header, preceding each frame. */
+typedef struct
+{
+    /** @brief Header flags. */
+    uint8_t flags;
+
+    /** @brief Segmentation offload type. */
+    uint8_t gso_type;
+
+    /** @brief Headers length. */
+    uint16_t header_length;
+
+    /** @brief Segment size. */
+    uint16_t gso_size;
+
+    /** @brief Checksum start offset. */
+    uint16_t csum_start;
+
+    /** @brief Checksum offset from its start. */
+    uint16_t csum_offset;
+
+    /** @brief Number of merged receive buffers. */
+    uint16_t buffer_count;
+} virtio_net_header_t;
+
+/** @brief Frame in flight on the transmit queue. */
+typedef struct
+{
+    /** @brief The header given to the device before the frame. */
+    virtio_net_header_t header;
+
+    /** @brief The frame. */
+    const void* frame;
+
+    /** @brief The completion handler. */
+    virtio_net_tx_done_t done;
+
+    /** @brief The completion handler arguments. */
+    void* args;
+} virtio_net_tx_slot_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+
+/** @brief The network card device. */
+static virtio_device_t virtio_net_device;
+
+/** @brief Receive queue, only used by the poll once the card is ready. */
+static virtqueue_t virtio_net_rx;
+
+/** @brief Transmit queue. */
+static virtqueue_t virtio_net_tx;
+
+/** @brief Receive buffers. */
+static uint8_t* virtio_net_rx_buffers[VIRTIO_NET_RX_COUNT];
+
+/** @brief Transmit slots. */
+static virtio_net_tx_slot_t virtio_net_tx_slots[VIRTIO_NET_TX_COUNT];
+
+/** @brief Free transmit slots stack. */
+static virtio_net_tx_slot_t* virtio_net_tx_free[VIRTIO_NET_TX_COUNT];
+
+/** @brief Number of free transmit slots. */
+static uint32_t virtio_net_tx_free_count = 0;
+
+/** @brief Receive handler. */
+static virtio_net_rx_handler_t virtio_net_rx_handler = NULL;
+
+/** @brief Receive handler arguments. */
+static void* virtio_net_rx_args = NULL;
+
+/** @brief Interrupt coalescing of the card. */
+static irq_poll_t virtio_net_poll;
+
+/** @brief TRUE once the card is initialized. */
+static volatile bool_t virtio_net_ready = FALSE;
+
+/** @brief Lock serializing the transmit queue and the notifications. */
+static kernel_spinlock_t virtio_net_tx_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Posts a receive buffer.
+ *
+ * @param[in] buffer The buffer to post.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - Any error returned by virtqueue_add.
+ */
+static OS_RETURN_E _virtio_net_post_rx(uint8_t* buffer);
+
+/**
+ * @brief Handles the consumed frames, the transmit lock must be held.
+ *
+ * @return The number of frames handled.
+ */
+static uint32_t _virtio_net_reclaim_tx(void);
+
+/**
+ * @brief Polls the card queues.
+ *
+ * @param[in] args Unused.
+ * @param[in] budget The maximal number of received frames to handle.
+ *
+ * @return The number of received frames handled, the budget when the poll
+ * must run again.
+ */
+static uint32_t _virtio_net_poll(void* args, const uint32_t budget);
+
+/**
+ * @brief Card interrupt handler, schedules the queues poll.
+ *
+ * @param[in] curr_thread Unused.
+ */
+static void _virtio_net_irq_handler(kernel_thread_t* curr_thread);
+
+/**
+ * @brief Gives a frame to the device.
+ *
+ * @param[in, out] buffers The frame descriptors, the first one is reserved
+ * for the header.
+ * @param[in] count The number of descriptors, header included.
+ * @param[in] frame The frame given to the completion handler.
+ * @param[in] done The completion handler, can be NULL.
+ * @param[in] args The arguments given to the completion handler.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_RESOURCE_BUSY is returned if the transmit queue is full.
+ * - Any error returned by virtqueue_add.
+ */
+static OS_RETURN_E _virtio_net_send(virtio_buffer_t* buffers,
+                                    const uint32_t count,
+                                    const void* frame,
+                                    virtio_net_tx_done_t done,
+                                    void* args);
+
+/**
+ * @brief Completion handler of the sent buffers, releases the buffer.
+ *
+ * @param[in] frame Unused.
+ * @param[in] args The sent buffer.
+ */
+static void _virtio_net_kbuf_done(const void* frame, void* args);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static OS_RETURN_E _virtio_net_post_rx(uint8_t* buffer)
+{
+    virtio_buffer_t rx_buffer;
+
+    rx_buffer.address = buffer;
+    rx_buffer.size    = VIRTIO_NET_RX_SIZE;
+
+    return virtqueue_add(&virtio_net_rx, &rx_buffer, 0, 1, buffer);
+}
+
+static uint32_t _virtio_net_reclaim_tx(void)
+{
+    virtio_net_tx_slot_t* slot;
+    uint32_t              count;
+
+    count = 0;
+    while((slot = virtqueue_get_used(&virtio_net_tx, NULL)) != NULL)
+    {
+        if(slot->done != NULL)
+        {
+            slot->done(slot->frame, slot->args);
+        }
+        virtio_net_tx_free[virtio_net_tx_free_count++] = slot;
+        ++count;
+    }
+
+    return count;
+}
+
+static uint32_t _virtio_net_poll(void* args, const uint32_t budget)
+{
+    uint32_t handled;
+    uint32_t length;
+    uint32_t int_state;
+    uint8_t* buffer;
+    bool_t   pending;
+
+    (void)args;
+
+    handled = 0;
+    while(handled < budget &&
+          (buffer = virtqueue_get_used(&virtio_net_rx, &length)) != NULL)
+    {
+        /* The frame is handed over in the buffer the device wrote */
+        if(virtio_net_rx_handler != NULL &&
+           length > sizeof(virtio_net_header_t))
+        {
+            virtio_net_rx_handler(buffer + sizeof(virtio_net_header_t),
+                                  length - sizeof(virtio_net_header_t),
+                                  virtio_net_rx_args);
+        }
+
+        if(_virtio_net_post_rx(buffer) != OS_NO_ERR)
+        {
+            KERNEL_ERROR("Could not repost a virtio net buffer\n");
+        }
+        ++handled;
+    }
+    if(handled > 0)
+    {
+        virtqueue_kick(&virtio_net_rx);
+    }
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(virtio_net_tx_lock, int_state);
+    _virtio_net_reclaim_tx();
+    pending = FALSE;
+    if(handled < budget)
+    {
+        pending = virtqueue_enable_notify(&virtio_net_tx);
+        pending |= virtqueue_enable_notify(&virtio_net_rx);
+        if(pending == TRUE)
+        {
+            /* Events raced with the enable, poll again instead */
+            virtqueue_disable_notify(&virtio_net_tx);
+            virtqueue_disable_notify(&virtio_net_rx);
+        }
+    }
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(virtio_net_tx_lock, int_state);
+
+    KERNEL_DEBUG(VIRTIO_DEBUG_ENABLED, MODULE_NAME,
+                 "Polled %u frames, pending %u", handled, pending);
+
+    return (pending == TRUE) ? budget : handled;
+}
+
+static void _virtio_net_irq_handler(kernel_thread_t* curr_thread)
+{
+    uint32_t int_state;
+
+    (void)curr_thread;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(virtio_net_tx_lock, int_state);
+    virtqueue_disable_notify(&virtio_net_rx);
+    virtqueue_disable_notify(&virtio_net_tx);
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(virtio_net_tx_lock, int_state);
+
+    irq_poll_schedule(&virtio_net_poll);
+
+    kernel_interrupt_set_irq_eoi(virtio_net_device.irq);
+}
+
+OS_RETURN_E virtio_net_init(void)
+{
+    OS_RETURN_E err;
+    uint32_t    rx_count;
+    uint32_t    i;
+
+    err = virtio_device_init(VIRTIO_TYPE_NET,
+                             (1ULL << VIRTIO_NET_F_MAC) |
+                             (1ULL << VIRTIO_F_EVENT_IDX),
+                             &virtio_net_device);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    err = virtio_device_enable_irq(&virtio_net_device);
+    if(err == OS_NO_ERR)
+    {
+        err = virtqueue_init(&virtio_net_device, VIRTIO_NET_RX_QUEUE,
+                             &virtio_net_rx);
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = virtqueue_init(&virtio_net_device, VIRTIO_NET_TX_QUEUE,
+                             &virtio_net_tx);
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = irq_poll_init(&virtio_net_poll, virtio_net_device.irq,
+                            VIRTIO_NET_POLL_BUDGET, _virtio_net_poll, NULL);
+    }
+    if(err != OS_NO_ERR)
+    {
+        virtio_device_fail(&virtio_net_device);
+        return err;
+    }
+
+    for(i = 0; i < VIRTIO_NET_TX_COUNT; ++i)
+    {
+        virtio_net_tx_free[i] = &virtio_net_tx_slots[i];
+    }
+    virtio_net_tx_free_count = VIRTIO_NET_TX_COUNT;
+
+    rx_count = virtio_net_rx.size;
+    if(rx_count > VIRTIO_NET_RX_COUNT)
+    {
+        rx_count = VIRTIO_NET_RX_COUNT;
+    }
+    for(i = 0; i < rx_count; ++i)
+    {
+        virtio_net_rx_buffers[i] = kmalloc(VIRTIO_NET_RX_SIZE);
+        if(virtio_net_rx_buffers[i] == NULL)
+        {
+            err = OS_ERR_NO_MORE_MEMORY;
+            break;
+        }
+        err = _virtio_net_post_rx(virtio_net_rx_buffers[i]);
+        if(err != OS_NO_ERR)
+        {
+            kfree(virtio_net_rx_buffers[i]);
+            break;
+        }
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = kernel_interrupt_register_irq_handler(virtio_net_device.irq,
+                                                    _virtio_net_irq_handler);
+    }
+    if(err != OS_NO_ERR)
+    {
+        virtio_device_fail(&virtio_net_device);
+        while(i > 0)
+        {
+            kfree(virtio_net_rx_buffers[--i]);
+        }
+        return err;
+    }
+
+    virtio_net_ready = TRUE;
+    virtio_device_ready(&virtio_net_device);
+    virtqueue_kick(&virtio_net_rx);
+    kernel_interrupt_set_irq_mask(virtio_net_device.irq, TRUE);
+
+    KERNEL_DEBUG(VIRTIO_DEBUG_ENABLED, MODULE_NAME,
+                 "Virtio net initialized, %u receive buffers", rx_count);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E virtio_net_get_mac(uint8_t mac[VIRTIO_NET_MAC_SIZE])
+{
+    if(mac == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(virtio_net_ready == FALSE ||
+       (virtio_net_device.features & (1ULL << VIRTIO_NET_F_MAC)) == 0 ||
+       virtio_net_device.device_config == NULL)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    virtio_read_device_config(&virtio_net_device, 0, mac,
+                              VIRTIO_NET_MAC_SIZE);
+
+    return OS_NO_ERR;
+}
+
+void virtio_net_set_rx_handler(virtio_net_rx_handler_t handler, void* args)
+{
+    virtio_net_rx_args    = args;
+    virtio_net_rx_handler = handler;
+}
+
+static OS_RETURN_E _virtio_net_send(virtio_buffer_t* buffers,
+                                    const uint32_t count,
+                                    const void* frame,
+                                    virtio_net_tx_done_t done,
+                                    void* args)
+{
+    OS_RETURN_E           err;
+    uint32_t              int_state;
+    virtio_net_tx_slot_t* slot;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(virtio_net_tx_lock, int_state);
+
+    if(virtio_net_tx_free_count == 0)
+    {
+        _virtio_net_reclaim_tx();
+        if(virtio_net_tx_free_count == 0)
+        {
+            KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(virtio_net_tx_lock, int_state);
+            return OS_ERR_RESOURCE_BUSY;
+        }
+    }
+
+    slot = virtio_net_tx_free[--virtio_net_tx_free_count];
+    memset(&slot->header, 0, sizeof(virtio_net_header_t));
+    slot->frame = frame;
+    slot->done  = done;
+    slot->args  = args;
+
+    /* The header is a separate descriptor, the frame is not copied */
+    buffers[0].address = &slot->header;
+    buffers[0].size    = sizeof(virtio_net_header_t);
+
+    err = virtqueue_add(&virtio_net_tx, buffers, count, 0, slot);
+    if(err == OS_ERR_NO_MORE_MEMORY)
+    {
+        err = OS_ERR_RESOURCE_BUSY;
+    }
+    if(err != OS_NO_ERR)
+    {
+        virtio_net_tx_free[virtio_net_tx_free_count++] = slot;
+    }
+    else
+    {
+        virtqueue_kick(&virtio_net_tx);
+    }
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(virtio_net_tx_lock, int_state);
+
+    return err;
+}
+
+static void _virtio_net_kbuf_done(const void* frame, void* args)
+{
+    (void)frame;
+
+    kbuf_free(args);
+}
+
+OS_RETURN_E virtio_net_send(const void* frame,
+                            const size_t size,
+                            virtio_net_tx_done_t done,
+                            void* args)
+{
+    virtio_buffer_t buffers[2];
+
+    if(frame == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(virtio_net_ready == FALSE)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+    if(size == 0 || size > VIRTIO_NET_MAX_FRAME_SIZE)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    buffers[1].address = frame;
+    buffers[1].size    = size;
+
+    return _virtio_net_send(buffers, 2, frame, done, args);
+}
+
+OS_RETURN_E virtio_net_send_kbuf(kbuf_t* frame)
+{
+    kbuf_segment_t  segments[VIRTIO_NET_TX_MAX_SEGMENTS];
+    virtio_buffer_t buffers[VIRTIO_NET_TX_MAX_SEGMENTS + 1];
+    uint32_t        count;
+    uint32_t        i;
+    size_t          size;
+
+    if(frame == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(virtio_net_ready == FALSE)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    size  = kbuf_length(frame);
+    count = kbuf_get_segments(frame, segments, VIRTIO_NET_TX_MAX_SEGMENTS);
+    if(size == 0 || size > VIRTIO_NET_MAX_FRAME_SIZE ||
+       count > VIRTIO_NET_TX_MAX_SEGMENTS)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    /* Each segment is a descriptor after the header */
+    for(i = 0; i < count; ++i)
+    {
+        buffers[i + 1].address = segments[i].address;
+        buffers[i + 1].size    = segments[i].size;
+    }
+
+    return _virtio_net_send(buffers, count + 1, frame,
+                            _virtio_net_kbuf_done, frame);
+}
+
+/************************************ EOF *************************************/
@@ -0,0 +1,19 @@
+################################################################################
+# UTK Makefile
+#
+# Created: 14/10/2026
+#
+# Author: Alexy Torres Aurora Dugo
+#
+# CPU architecture headers. Included by the modules dependencies, adds the
+# headers of the target_cpu architecture to DEP_INCLUDES. The including file
+# sets ARCH_CPU_DIR to the path of this directory from its module.
+################################################################################
+
+CPU_ARCH_LIST = i386 x86_64
+
+ifeq ($(filter $(target_cpu), $(CPU_ARCH_LIST)),)
+$(error Unknown CPU architecture $(target_cpu), available: $(CPU_ARCH_LIST))
+endif
+
+DEP_INCLUDES += -I $(ARCH_CPU_DIR)/$(target_cpu)/includes
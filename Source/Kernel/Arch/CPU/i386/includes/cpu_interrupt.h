@@ -53,6 +53,10 @@
 #define INT_PIC_IRQ_OFFSET     0x30
 /** @brief Offset of the first line of an IRQ interrupt from IO-APIC. */
 #define INT_IOAPIC_IRQ_OFFSET  0x40
+/** @brief Offset of the first line of a message signaled interrupt. */
+#define INT_MSI_IRQ_OFFSET     0x60
+/** @brief Number of lines reserved for the message signaled interrupts. */
+#define INT_MSI_IRQ_COUNT      0x20
 
 /** @brief PIC's minimal IRQ number. */
 #define PIC_MIN_IRQ_LINE 0
@@ -78,10 +82,22 @@
 #define DEVICE_NOT_FOUND_LINE      0x07
 /** @brief Page fault exception line.*/
 #define PAGE_FAULT_LINE            0x0E
+/** @brief Page fault error code flag: the page was present. */
+#define PAGE_FAULT_ERROR_PRESENT   0x01
+/** @brief Page fault error code flag: the access was a write. */
+#define PAGE_FAULT_ERROR_WRITE     0x02
+/** @brief Page fault error code flag: the access came from the user mode. */
+#define PAGE_FAULT_ERROR_USER      0x04
 /** @brief LAPIC Timer interrupt line. */
 #define LAPIC_TIMER_INTERRUPT_LINE 0x20
 /** @brief Scheduler software interrupt line. */
 #define SCHEDULER_SW_INT_LINE      0x21
+/** @brief Cross-CPU calls inter processor interrupt line. */
+#define IPI_CALL_INT_LINE          0x22
+/** @brief LAPIC performance counter overflow interrupt line. */
+#define LAPIC_PMC_INTERRUPT_LINE   0x23
+/** @brief Profiler control inter processor interrupt line. */
+#define PROFILER_INT_LINE          0x24
 /** @brief Defines the panic interrupt line. */
 #define PANIC_INT_LINE             0x2A
 /** @brief Defines the sys call interrupt line. */
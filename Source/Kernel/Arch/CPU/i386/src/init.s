@@ -38,6 +38,7 @@ CHECKSUM    equ -(MAGIC + FLAGS)
 ;-------------------------------------------------------------------------------
 ; Kernel memory layout
 KERNEL_START_PAGE_ID equ (KERNEL_MEM_OFFSET >> 22)
+LAPIC_PAGE_ID        equ (0xFEE00000 >> 22)
 __kinit_low          equ (__kinit - KERNEL_MEM_OFFSET)
 
 ;-------------------------------------------------------------------------------
@@ -201,6 +202,7 @@ section .data
 ; Kernel initial page directory:
 ; 16MB mapped for high addresses
 ; 4MB mapped 1-1 for low addresses
+; 4MB mapped 1-1 and uncached for the local APIC
 align 0x1000
 _kinit_pgdir:
     ; First 4MB R/W Present.
@@ -215,7 +217,11 @@ _kinit_pgdir:
     dd 0x00800083
     ; This page directory entry defines a 4MB page containing the kernel.
     dd 0x00C00083
-    times (1024 - KERNEL_START_PAGE_ID - 4) dd 0  ; Pages after the kernel.
+    ; Pages after the kernel.
+    times (LAPIC_PAGE_ID - KERNEL_START_PAGE_ID - 4) dd 0
+    ; This page directory entry defines a 4MB uncached page for the LAPIC.
+    dd (LAPIC_PAGE_ID << 22) | 0x9B
+    times (1024 - LAPIC_PAGE_ID - 1) dd 0
 
 ; Number of booted CPUs
 _kernel_cpu_count:
@@ -21,6 +21,21 @@
 ; DEFINES
 ;-------------------------------------------------------------------------------
 
+; CPU local storage offsets, must match the layout given in cpu.h
+%define CPU_LOCAL_CURRENT_THREAD 0x00
+%define CPU_LOCAL_SWITCHED_OUT   0x08
+
+; EFLAGS interrupt enabled flag
+%define CPU_EFLAGS_IF 0x200
+
+; Size of the interrupt stubs, the IDT is built at link time from the stubs
+; base address and must match the linker script
+%define INT_STUB_SIZE 16
+
+; IDT entries values, must match the values given in cpu.c
+%define IDT_KERNEL_CS    0x08
+%define IDT_INT_GATE_PL0 0x8E
+
 ;-------------------------------------------------------------------------------
 ; MACRO DEFINE
 ;-------------------------------------------------------------------------------
@@ -31,6 +46,8 @@ interrupt_handler_%1:
     push    dword 0                       ; push 0 as dummy error code
     push    dword %1                      ; push the interrupt number
     jmp     _generic_interrupt_handler   ; jump to the common handler
+    times INT_STUB_SIZE - ($ - interrupt_handler_%1) db 0xCC ; pad to the
+                                       ; stub size
 %endmacro
 
 %macro err_code_interrupt_handler 1    ; Interrupt that do not come with an
@@ -40,19 +57,30 @@ global interrupt_handler_%1
 interrupt_handler_%1:
     push    dword %1                      ; push the interrupt number
     jmp     _generic_interrupt_handler   ; jump to the common handler
+    times INT_STUB_SIZE - ($ - interrupt_handler_%1) db 0xCC ; pad to the
+                                       ; stub size
 %endmacro
 
 ;-------------------------------------------------------------------------------
 ; EXTERN DATA
 ;-------------------------------------------------------------------------------
+extern kernel_interrupt_fast_lines
+
+; Interrupt stubs base address parts, computed by the linker script
+extern _INT_STUBS_LOW
+extern _INT_STUBS_HIGH
 
-extern current_thread
+;-------------------------------------------------------------------------------
+; EXPORTED DATA
+;-------------------------------------------------------------------------------
+global cpu_idt
 
 ;-------------------------------------------------------------------------------
 ; EXTERN FUNCTIONS
 ;-------------------------------------------------------------------------------
 
 extern kernel_interrupt_handler
+extern kernel_interrupt_fast_handler
 
 ;-------------------------------------------------------------------------------
 ; EXPORTED FUNCTIONS
@@ -69,8 +97,18 @@ _generic_interrupt_handler:
         push eax
         push ebx
 
-        ; Get the current thread handle
-        mov eax, [current_thread]
+        ; Lines with a fast handler do not need the full context, unless the
+        ; interrupt must be blocked by the generic handler
+        mov eax, [esp+8]  ; Int id
+        cmp byte [kernel_interrupt_fast_lines+eax], 0
+        je  .full_context
+        test dword [esp+24], CPU_EFLAGS_IF
+        jnz _fast_interrupt_handler
+
+.full_context:
+
+        ; Get the current thread handle from the CPU local storage
+        mov eax, [gs:CPU_LOCAL_CURRENT_THREAD]
 
         ; Save the interrupt context
         mov ebx, [esp+8]  ; Int id
@@ -114,14 +152,15 @@ _generic_interrupt_handler:
         ; call the C generic interrupt handler
         call kernel_interrupt_handler
 
-        ; Get the current thread handle
-        mov eax, [current_thread]
+        ; Get the current thread handle, it might have been changed by the
+        ; scheduler
+        mov eax, [gs:CPU_LOCAL_CURRENT_THREAD]
 
-        ; Restore registers
+        ; Restore registers, GS is not restored as it holds the CPU local
+        ; storage segment
         mov ds,  [eax+68]
         mov es,  [eax+64]
         mov fs,  [eax+60]
-        mov gs,  [eax+56]
         mov ss,  [eax+52]
         mov ebx, [eax+44]
         mov ecx, [eax+40]
@@ -130,21 +169,43 @@ _generic_interrupt_handler:
         mov edi, [eax+28]
         mov ebp, [eax+24]
         mov esp, [eax+20]
+
+        ; We left the previous thread stack, it can now be used by other CPUs
+        mov dword [gs:CPU_LOCAL_SWITCHED_OUT], 0
+
         mov eax, [eax+48]
 
         ; Return from interrupt
         iret
 
-    ; Now create handlers for each interrupt
-    err_code_interrupt_handler 8
-    err_code_interrupt_handler 10
-    err_code_interrupt_handler 11
-    err_code_interrupt_handler 12
-    err_code_interrupt_handler 13
-    err_code_interrupt_handler 14
-    err_code_interrupt_handler 17
-    err_code_interrupt_handler 30
+_fast_interrupt_handler:
+        ; Save the other caller saved registers, the handler preserves the
+        ; others. EAX holds the interrupt id.
+        push ecx
+        push edx
+
+        ; The interrupt id and current thread are the handler parameters
+        push dword [gs:CPU_LOCAL_CURRENT_THREAD]
+        push eax
+        call kernel_interrupt_fast_handler
+        add esp, 8
+
+        ; Restore registers
+        pop edx
+        pop ecx
+        pop ebx
+        pop eax
 
+        ; Skip the interrupt id and error code
+        add esp, 8
+
+        ; Return from interrupt
+        iret
+
+; The stubs are sorted by interrupt line, the handler of line N is at
+; _INT_STUBS_BASE + N * INT_STUB_SIZE
+section .text.int_stubs progbits alloc exec nowrite align=4096
+    ; Now create handlers for each interrupt
     noerr_code_interrupt_handler 0
     noerr_code_interrupt_handler 1
     noerr_code_interrupt_handler 2
@@ -153,9 +214,16 @@ _generic_interrupt_handler:
     noerr_code_interrupt_handler 5
     noerr_code_interrupt_handler 6
     noerr_code_interrupt_handler 7
+    err_code_interrupt_handler 8
     noerr_code_interrupt_handler 9
+    err_code_interrupt_handler 10
+    err_code_interrupt_handler 11
+    err_code_interrupt_handler 12
+    err_code_interrupt_handler 13
+    err_code_interrupt_handler 14
     noerr_code_interrupt_handler 15
     noerr_code_interrupt_handler 16
+    err_code_interrupt_handler 17
     noerr_code_interrupt_handler 18
     noerr_code_interrupt_handler 19
     noerr_code_interrupt_handler 20
@@ -168,6 +236,7 @@ _generic_interrupt_handler:
     noerr_code_interrupt_handler 27
     noerr_code_interrupt_handler 28
     noerr_code_interrupt_handler 29
+    err_code_interrupt_handler 30
     noerr_code_interrupt_handler 31
     noerr_code_interrupt_handler 32
     noerr_code_interrupt_handler 33
@@ -396,4 +465,19 @@ _generic_interrupt_handler:
 
 ;-------------------------------------------------------------------------------
 ; DATA
-;-------------------------------------------------------------------------------
\ No newline at end of file
+;-------------------------------------------------------------------------------
+
+; The IDT is built at link time from the stubs base address parts given by the
+; linker, each part is already at its place in the entry double words. The
+; stubs base is 4KB aligned, the low part never carries into the high part.
+section .rodata
+align 8
+cpu_idt:
+%assign int_id 0
+%rep 256
+    ; Selector[15;0] Handler[15;0]
+    dd (IDT_KERNEL_CS << 16) + _INT_STUBS_LOW + int_id * INT_STUB_SIZE
+    ; Handler[31;16] Flags[4;0] Type[4;0] ZERO[7;0]
+    dd _INT_STUBS_HIGH + (IDT_INT_GATE_PL0 << 8)
+%assign int_id int_id + 1
+%endrep
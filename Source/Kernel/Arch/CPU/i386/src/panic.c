@@ -25,12 +25,17 @@
 /* Included headers */
 #include <cpu_interrupt.h>       /* Interrupt management */
 #include <vga_console.h>          /* VGA console driver*/
+#include <console.h>              /* Kernel console */
+#include <uart.h>                 /* UART driver */
 #include <kernel_output.h>        /* Kernel output methods */
 #include <stdint.h>               /* Generic int types */
 #include <cpu.h>                  /* CPU management */
 #include <string.h>               /* Memset */
 #include <ctrl_block.h>           /* Thread's control block */
 #include <interrupts.h>           /* Interrupts manager */
+#include <stack_trace.h>          /* Stack walker */
+#include <crash_dump.h>           /* Crash record */
+#include <ipi.h>                  /* Cross-CPU calls */
 
 /* Configuration files */
 #include <config.h>
@@ -48,6 +53,21 @@
 /** @brief Defines the stack trace size */
 #define STACK_TRACE_SIZE 6
 
+/** @brief Number of kernel log slots dumped on panic. */
+#define PANIC_LOG_DUMP_COUNT 8
+
+/** @brief Chipset reset control register port. */
+#define PANIC_RESET_CONTROL_PORT 0xCF9
+
+/** @brief Reset control value requesting a CPU soft reset. */
+#define PANIC_RESET_CONTROL_SOFT 0x04
+
+/** @brief Keyboard controller command port. */
+#define PANIC_KBD_COMMAND_PORT 0x64
+
+/** @brief Keyboard controller command pulsing the reset line. */
+#define PANIC_KBD_COMMAND_RESET 0xFE
+
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
@@ -122,11 +142,25 @@ static void _print_cpu_flags(const virtual_cpu_t* vcpu);
 /**
  * @brief Prints the stack frame rewind at the moment of the panic.
  *
- * @details Prints the stack frame rewind at the moment of the panic. The frames
- * will be unwinded and the symbols printed based on the information passed by
- * multiboot at initialization time.
+ * @details Prints the stack frame rewind at the moment of the panic. The
+ * frames of the interrupted context are unwinded and resolved with the kernel
+ * symbol table.
+ *
+ * @param[in] vcpu The pointer to the VCPU state at the moment of the panic.
  */
-static void _print_stack_trace(void);
+static void _print_stack_trace(const virtual_cpu_t* vcpu);
+
+#if CRASH_DUMP_REBOOT && !TEST_PANIC_ENABLED
+/**
+ * @brief Resets the machine once the crash record is written.
+ *
+ * @details Resets the machine once the crash record is written. The caches
+ * are written back so that the record reaches the memory, then the chipset
+ * reset control is used, the keyboard controller reset line otherwise. The
+ * memory content survives the warm reset.
+ */
+static void _panic_reset(void);
+#endif
 
 /*******************************************************************************
  * FUNCTIONS
@@ -363,40 +397,45 @@ static void _print_cpu_flags(const virtual_cpu_t* vcpu)
     kernel_printf("\n");
 }
 
-static void _print_stack_trace(void)
+static void _print_stack_trace(const virtual_cpu_t* vcpu)
 {
-    size_t        i;
-    uintptr_t*    call_addr;
-    uintptr_t*    last_ebp;
-    char*         symbol;
-
-    /* Get ebp */
-    __asm__ __volatile__ ("mov %%ebp, %0\n\t" : "=m" (last_ebp));
-
-    /* Get the return address */
-    call_addr = *(uintptr_t**)(last_ebp + 1);
-    for(i = 0; i < STACK_TRACE_SIZE && call_addr != NULL; ++i)
+    uintptr_t   addresses[STACK_TRACE_SIZE];
+    uintptr_t   offset;
+    const char* symbol;
+    uint32_t    depth;
+    uint32_t    i;
+
+    /* The trace starts at the interrupted instruction */
+    addresses[0] = _cpu_get_saved_pc(vcpu);
+    depth        = 1 + stack_trace_walk(_cpu_get_saved_fp(vcpu),
+                                        addresses + 1,
+                                        STACK_TRACE_SIZE - 1);
+
+    for(i = 0; i < depth; ++i)
     {
-        /* Get the associated symbol */
-        symbol = NULL;
-
-        kernel_printf("[%u] 0x%p in %s", i, call_addr,
-                      symbol == NULL ? "[NO_SYMBOL]" : symbol);
-        if(i % 2 == 0)
+        /* A return address might be the first byte after its function */
+        symbol = stack_trace_lookup(addresses[i] - (i != 0), &offset);
+        if(symbol != NULL)
         {
-            kernel_printf(" | ");
+            kernel_printf("[%u] 0x%p in %s+0x%x\n", i, addresses[i], symbol,
+                          (uint32_t)offset + (i != 0));
         }
         else
         {
-            kernel_printf("\n");
+            kernel_printf("[%u] 0x%p in [NO_SYMBOL]\n", i, addresses[i]);
         }
-
-        last_ebp  = (uintptr_t*)*last_ebp;
-        call_addr = *(uintptr_t**)(last_ebp + 1);
     }
+}
 
+#if CRASH_DUMP_REBOOT && !TEST_PANIC_ENABLED
+static void _panic_reset(void)
+{
+    __asm__ __volatile__("wbinvd" ::: "memory");
 
+    _cpu_outb(PANIC_RESET_CONTROL_SOFT, PANIC_RESET_CONTROL_PORT);
+    _cpu_outb(PANIC_KBD_COMMAND_RESET, PANIC_KBD_COMMAND_PORT);
 }
+#endif
 
 void panic_handler(kernel_thread_t* curr_thread)
 {
@@ -412,6 +451,16 @@ void panic_handler(kernel_thread_t* curr_thread)
 
     KERNEL_TRACE_EVENT(EVENT_KERNEL_PANIC_HANDLER_START, 1, panic_code);
 
+    /* Interrupts are disabled, the UART output must be polled */
+    uart_disable_tx_interrupt();
+
+    /* The drain threads will not run, output to the console drivers */
+    kernel_output_disable_log();
+    console_disable_sink_queues();
+
+    /* The other CPUs would keep changing the state being dumped */
+    ipi_stop_cpus();
+
     time    = 0;
     hours   = time / 3600;
     minutes = (time / 60) % 60;
@@ -419,6 +468,10 @@ void panic_handler(kernel_thread_t* curr_thread)
 
     cpu_id = 0;
 
+    /* The panic screen is copied in the crash record */
+    crash_dump_start(curr_thread, panic_code, panic_module, panic_msg,
+                     panic_file, panic_line);
+
     panic_scheme.background = BG_BLACK;
     panic_scheme.foreground = FG_CYAN;
     panic_scheme.vga_color  = TRUE;
@@ -453,7 +506,13 @@ void panic_handler(kernel_thread_t* curr_thread)
     }
     kernel_printf("%s (%d)\n\n", panic_msg, panic_code);
 
-    _print_stack_trace();
+    _print_stack_trace(&curr_thread->v_cpu);
+
+    kernel_printf("\n---------------------------------- KERNEL LOG -----------"
+                  "-----------------------\n");
+    kernel_output_dump_log(PANIC_LOG_DUMP_COUNT);
+
+    crash_dump_end();
 
     /* Hide cursor */
     panic_scheme.background = BG_BLACK;
@@ -472,6 +531,8 @@ void panic_handler(kernel_thread_t* curr_thread)
 
 #if TEST_PANIC_ENABLED
     TEST_FRAMEWORK_END();
+#elif CRASH_DUMP_REBOOT
+    _panic_reset();
 #endif
 
     /* We will never return from interrupt */
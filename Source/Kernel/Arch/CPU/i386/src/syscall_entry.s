@@ -0,0 +1,112 @@
+;-------------------------------------------------------------------------------
+;
+; File: syscall_entry.s
+;
+; Author: Alexy Torres Aurora Dugo
+;
+; Date: 14/10/2026
+;
+; Version: 1.0
+;
+; SYSENTER entry point of the user threads. Switches to the thread's kernel
+; stack and calls the C kernel system calls dispatcher, then returns to the
+; user space with iret.
+;
+; The user thread gives the system call identifier in EAX, the arguments in
+; EBX, ESI, EDI and EBP, its stack pointer in ECX and its return address in
+; EDX. The return value is given in EAX, ECX and EDX are cleared.
+;
+;-------------------------------------------------------------------------------
+;-------------------------------------------------------------------------------
+; ARCH
+;-------------------------------------------------------------------------------
+[bits 32]
+
+;-------------------------------------------------------------------------------
+; DEFINES
+;-------------------------------------------------------------------------------
+
+; CPU local storage offsets, must match the layout given in cpu.h
+%define CPU_LOCAL_KERNEL_STACK 0x0C
+
+; Segments selectors, must match the GDT layout given in cpu.c
+%define KERNEL_DS_32 0x10
+%define USER_CS_32   0x2B
+%define USER_DS_32   0x33
+
+; Initial EFLAGS of the user space on return, interrupts enabled
+%define USER_EFLAGS 0x202
+
+;-------------------------------------------------------------------------------
+; MACRO DEFINE
+;-------------------------------------------------------------------------------
+
+;-------------------------------------------------------------------------------
+; EXTERN DATA
+;-------------------------------------------------------------------------------
+
+;-------------------------------------------------------------------------------
+; EXTERN FUNCTIONS
+;-------------------------------------------------------------------------------
+
+extern syscall_dispatch
+
+;-------------------------------------------------------------------------------
+; EXPORTED FUNCTIONS
+;-------------------------------------------------------------------------------
+
+global cpu_sysenter_entry
+
+;-------------------------------------------------------------------------------
+; CODE
+;-------------------------------------------------------------------------------
+
+section .text
+cpu_sysenter_entry:
+        ; The interrupts are disabled and ESP points to the CPU local storage
+        ; selector. Get the thread's kernel stack.
+        mov gs,  [esp]
+        mov esp, [gs:CPU_LOCAL_KERNEL_STACK]
+
+        ; Build the user space interrupt return frame
+        push dword USER_DS_32
+        push ecx
+        push dword USER_EFLAGS
+        push dword USER_CS_32
+        push edx
+
+        ; Use the kernel data segments
+        push ds
+        push es
+        mov  cx, KERNEL_DS_32
+        mov  ds, cx
+        mov  es, cx
+
+        sti
+
+        ; The dispatcher preserves EBX, ESI, EDI and EBP. Only four arguments
+        ; are given in registers, the fifth one is 0.
+        push eax
+        push dword 0
+        push ebp
+        push edi
+        push esi
+        push ebx
+        call syscall_dispatch
+        add  esp, 24
+
+        ; EAX holds the return value, no kernel value leaks in ECX and EDX
+        cli
+
+        pop es
+        pop ds
+        mov cx, USER_DS_32
+        mov gs, cx
+        xor ecx, ecx
+        xor edx, edx
+
+        iret
+
+;-------------------------------------------------------------------------------
+; DATA
+;-------------------------------------------------------------------------------
\ No newline at end of file
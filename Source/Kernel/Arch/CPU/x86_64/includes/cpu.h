@@ -27,6 +27,7 @@
 #include <stdint.h>       /* Generic int types */
 #include <stddef.h>       /* Standard definition */
 #include <kerror.h>       /* Kernel error */
+#include <irqsoff.h>      /* Interrupts masked latency tracer */
 
 /*******************************************************************************
  * CONSTANTS
@@ -37,10 +38,110 @@
 /** @brief CPU flags interrupt enabled bit shift. */
 #define CPU_RFLAGS_IF_SHIFT 9
 
+/** @brief CPU local storage offset of the current thread pointer. This value
+ * is used by the interrupt entry and exit paths.
+ */
+#define CPU_LOCAL_CURRENT_THREAD_OFFSET 0x00
+/** @brief CPU local storage offset of the pointer to the storage itself. */
+#define CPU_LOCAL_SELF_OFFSET           0x08
+/** @brief CPU local storage offset of the thread being switched out. This
+ * value is cleared by the interrupt exit path once the CPU left the thread's
+ * stack.
+ */
+#define CPU_LOCAL_SWITCHED_OUT_OFFSET   0x10
+/** @brief CPU local storage offset of the current thread's kernel stack top.
+ * This value is loaded by the system call entry path.
+ */
+#define CPU_LOCAL_KERNEL_STACK_OFFSET   0x18
+/** @brief CPU local storage offset of the user stack pointer saved by the
+ * system call entry path.
+ */
+#define CPU_LOCAL_USER_STACK_OFFSET     0x20
+
+/** @brief Size of a CPU cache line. */
+#define CPU_CACHE_LINE_SIZE 64
+
+/** @brief CR0 task switched flag, the next FPU, MMX or SSE instruction raises
+ * a device not available exception.
+ */
+#define CPU_CR0_TS 0x00000008
+
+/** @brief Size of the buffer holding the FPU, SSE and AVX state of a thread.
+ */
+#define CPU_FPU_STATE_SIZE 1024
+/** @brief Alignment required by the FPU state save instructions. */
+#define CPU_FPU_STATE_ALIGN 64
+
+/** @brief Size of the kernel stacks region reserved for the CPUs: one boot
+ * stack per CPU followed by one emergency interrupt stack per CPU and one page
+ * fault stack per CPU.
+ */
+#define CPU_RESERVED_STACKS_SIZE (3 * MAX_CPU_COUNT * KERNEL_STACK_SIZE)
+
+/** @brief Tells if the page faults are delivered on a dedicated stack. A
+ * thread stack page can then be committed when the thread first touches it.
+ */
+#define CPU_FAULT_STACK_ENABLED 1
+
+/** @brief Number of paging structures levels, level 0 entries map 4KB pages.
+ */
+#define CPU_PAGING_LEVELS 4
+/** @brief Number of linear address bits translated by a paging level. */
+#define CPU_PAGING_LEVEL_BITS 9
+
+/** @brief Page entry present flag. */
+#define CPU_PAGE_PRESENT        0x001
+/** @brief Page entry writable flag. */
+#define CPU_PAGE_WRITE          0x002
+/** @brief Page entry user accessible flag. */
+#define CPU_PAGE_USER           0x004
+/** @brief Page entry write-through caching flag. */
+#define CPU_PAGE_WRITE_THROUGH  0x008
+/** @brief Page entry caching disabled flag. */
+#define CPU_PAGE_CACHE_DISABLE  0x010
+/** @brief Page entry write-combining flags, select the PAT entry programmed
+ * to write-combining, see cpu_is_write_combining_enabled.
+ */
+#define CPU_PAGE_WRITE_COMBINING CPU_PAGE_WRITE_THROUGH
+/** @brief Page entry large page flag, the entry maps a page instead of
+ * pointing to a table.
+ */
+#define CPU_PAGE_LARGE          0x080
+/** @brief Page entry software flag, ignored by the CPU: the page frame is
+ * private memory, reference counted by its mappings.
+ */
+#define CPU_PAGE_PRIVATE        0x200
+/** @brief Page entry software flag, ignored by the CPU: the page is read
+ * only until its first write copies it.
+ */
+#define CPU_PAGE_COW            0x400
+/** @brief Page entry physical address mask. */
+#define CPU_PAGE_ADDR_MASK 0x000FFFFFFFFFF000ULL
+
+/** @brief Number of process context identifiers tagging the TLB entries. */
+#define CPU_PCID_COUNT 4096
+/** @brief CR3 flag: the TLB entries of the loaded PCID are kept. */
+#define CPU_CR3_PCID_NOFLUSH (1ULL << 63)
+
+/** @brief INVPCID type: invalidates an address of a PCID. */
+#define CPU_INVPCID_ADDRESS     0
+/** @brief INVPCID type: invalidates all the addresses of a PCID. */
+#define CPU_INVPCID_CONTEXT     1
+/** @brief INVPCID type: invalidates all the PCIDs, global entries included. */
+#define CPU_INVPCID_ALL_CONTEXT 2
+
+/** @brief ELF class of the CPU programs, 64 bits. */
+#define CPU_ELF_CLASS   2
+/** @brief ELF machine of the CPU programs, x86_64. */
+#define CPU_ELF_MACHINE 62
+
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
 
+/** @brief Paging structure entry. */
+typedef uint64_t cpu_page_entry_t;
+
 /** @brief Holds the CPU register values */
 typedef struct
 {
@@ -117,6 +218,13 @@ typedef struct
     cpu_state_t vcpu;
 } virtual_cpu_t;
 
+/* Offsets used by the interrupt entry and exit paths in int_handlers.s */
+_Static_assert(offsetof(virtual_cpu_t, int_context.rip) == 16 &&
+               offsetof(virtual_cpu_t, int_context.rflags) == 32 &&
+               offsetof(virtual_cpu_t, vcpu.rsp) == 40 &&
+               offsetof(virtual_cpu_t, vcpu.ds) == 200,
+               "Virtual CPU layout does not match the interrupt handlers");
+
 /*******************************************************************************
  * MACROS
  ******************************************************************************/
@@ -190,17 +298,40 @@ inline static int32_t _cpu_cpuid(const uint32_t code, uint32_t regs[4])
     return 1;
 }
 
+/**
+ * @brief Returns the CPUID data for a requested leaf and sub-leaf.
+ *
+ * @details Returns CPUID data for requested CPUID leaf and sub-leaf, as found
+ * in returned eax, ebx, ecx and edx registers. The caller must ensure that the
+ * leaf is supported.
+ *
+ * @param[in] code The opperation code for the CPUID instruction.
+ * @param[in] subleaf The sub-leaf index, given to the CPUID instruction in
+ * ecx.
+ * @param[out] regs The register used to store the CPUID instruction return.
+ */
+inline static void _cpu_cpuid_subleaf(const uint32_t code,
+                                      const uint32_t subleaf,
+                                      uint32_t regs[4])
+{
+    __asm__ __volatile__("cpuid":"=a"(*regs),"=b"(*(regs+1)),
+                         "=c"(*(regs+2)),"=d"(*(regs+3)):"a"(code),
+                         "c"(subleaf));
+}
+
 /** @brief Clears interupt bit which results in disabling interrupts. */
 inline static void _cpu_clear_interrupt(void)
 {
     KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_DISABLE_INTERRUPT, 0);
     __asm__ __volatile__("cli":::"memory");
+    IRQSOFF_RECORD_DISABLE();
 }
 
 /** @brief Sets interrupt bit which results in enabling interupts. */
 inline static void _cpu_set_interrupt(void)
 {
     KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_ENABLE_INTERRUPT, 0);
+    IRQSOFF_RECORD_ENABLE();
     __asm__ __volatile__("sti":::"memory");
 }
 
@@ -211,6 +342,37 @@ inline static void _cpu_hlt(void)
     __asm__ __volatile__ ("hlt":::"memory");
 }
 
+/**
+ * @brief Arms the address monitoring hardware on a memory range.
+ *
+ * @details Arms the address monitoring hardware on the monitor line holding
+ * the address. A write to the line wakes the CPU from the next MWAIT.
+ *
+ * @param[in] addr The monitored address.
+ */
+inline static void _cpu_monitor(const volatile void* addr)
+{
+    __asm__ __volatile__("monitor"
+                         :: "a"(addr), "c"(0), "d"(0)
+                         : "memory");
+}
+
+/**
+ * @brief Waits for a write to the monitored range or for an event.
+ *
+ * @param[in] hints The MWAIT hints, the target C-state in bits 7:4 and the
+ * sub C-state in bits 3:0.
+ * @param[in] extensions The MWAIT extensions, bit 0 makes the interrupts
+ * break MWAIT even when they are disabled.
+ */
+inline static void _cpu_mwait(const uint32_t hints, const uint32_t extensions)
+{
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_MWAIT, 1, hints);
+    __asm__ __volatile__("mwait"
+                         :: "a"(hints), "c"(extensions)
+                         : "memory");
+}
+
 /**
  * @brief Returns the current CPU flags.
  *
@@ -322,6 +484,86 @@ inline static uint32_t _cpu_inl(const uint16_t port)
     return rega;
 }
 
+/**
+ * @brief Writes a string of bytes on port.
+ *
+ * @details Writes a string of bytes on port with a single REP OUTSB, the
+ * device must accept the whole string without being polled.
+ *
+ * @param[in] buffer The bytes to send to the port.
+ * @param[in] count The number of bytes to send.
+ * @param[in] port The port to which the bytes have to be written.
+ */
+inline static void _cpu_outsb(const void* buffer,
+                              size_t count,
+                              const uint16_t port)
+{
+    __asm__ __volatile__("cld\n\t"
+                         "rep outsb"
+                         : "+S" (buffer), "+c" (count)
+                         : "d" (port)
+                         : "memory");
+}
+
+/**
+ * @brief Writes a string of words on port.
+ *
+ * @details Writes a string of words on port with a single REP OUTSW, the
+ * device must accept the whole string without being polled.
+ *
+ * @param[in] buffer The words to send to the port.
+ * @param[in] count The number of words to send.
+ * @param[in] port The port to which the words have to be written.
+ */
+inline static void _cpu_outsw(const void* buffer,
+                              size_t count,
+                              const uint16_t port)
+{
+    __asm__ __volatile__("cld\n\t"
+                         "rep outsw"
+                         : "+S" (buffer), "+c" (count)
+                         : "d" (port)
+                         : "memory");
+}
+
+/**
+ * @brief Reads a string of bytes on port.
+ *
+ * @details Reads a string of bytes on port with a single REP INSB, the device
+ * must provide the whole string without being polled.
+ *
+ * @param[out] buffer The buffer receiving the bytes.
+ * @param[in] count The number of bytes to read.
+ * @param[in] port The port from which the bytes have to be read.
+ */
+inline static void _cpu_insb(void* buffer, size_t count, const uint16_t port)
+{
+    __asm__ __volatile__("cld\n\t"
+                         "rep insb"
+                         : "+D" (buffer), "+c" (count)
+                         : "d" (port)
+                         : "memory");
+}
+
+/**
+ * @brief Reads a string of words on port.
+ *
+ * @details Reads a string of words on port with a single REP INSW, the device
+ * must provide the whole string without being polled.
+ *
+ * @param[out] buffer The buffer receiving the words.
+ * @param[in] count The number of words to read.
+ * @param[in] port The port from which the words have to be read.
+ */
+inline static void _cpu_insw(void* buffer, size_t count, const uint16_t port)
+{
+    __asm__ __volatile__("cld\n\t"
+                         "rep insw"
+                         : "+D" (buffer), "+c" (count)
+                         : "d" (port)
+                         : "memory");
+}
+
 /**
  * @brief Reads the TSC value of the CPU.
  *
@@ -334,9 +576,64 @@ inline static uint32_t _cpu_inl(const uint16_t port)
  */
 inline static uint64_t _cpu_rdtsc(void)
 {
-    uint64_t ret;
-    __asm__ __volatile__ ( "rdtsc" : "=A"(ret) );
-    return ret;
+    uint32_t low;
+    uint32_t high;
+    __asm__ __volatile__ ( "rdtsc" : "=a"(low), "=d"(high) );
+    return ((uint64_t)high << 32) | low;
+}
+
+/**
+ * @brief Reads the TSC value of the CPU and the TSC auxiliary value.
+ *
+ * @details Reads the current value of the CPU's time-stamp counter with the
+ * RDTSCP instruction. The TSC auxiliary MSR value, usually set to the CPU
+ * identifier, is read atomically with the time stamp. The caller must ensure
+ * that the instruction is supported.
+ *
+ * @param[out] aux The buffer receiving the TSC auxiliary value.
+ *
+ * @return The CPU's TSC time stamp.
+ */
+inline static uint64_t _cpu_rdtscp(uint32_t* aux)
+{
+    uint32_t low;
+    uint32_t high;
+    __asm__ __volatile__ ( "rdtscp" : "=a"(low), "=d"(high), "=c"(*aux) );
+    return ((uint64_t)high << 32) | low;
+}
+
+/**
+ * @brief Reads a model specific register.
+ *
+ * @details Reads the model specific register given as parameter and returns
+ * its 64 bits value.
+ *
+ * @param[in] msr The model specific register to read.
+ *
+ * @return The model specific register value.
+ */
+inline static uint64_t _cpu_get_msr(const uint32_t msr)
+{
+    uint32_t low;
+    uint32_t high;
+    __asm__ __volatile__("rdmsr" : "=a" (low), "=d" (high) : "c" (msr));
+    return ((uint64_t)high << 32) | low;
+}
+
+/**
+ * @brief Writes a model specific register.
+ *
+ * @details Writes the 64 bits value given as parameter in the model specific
+ * register.
+ *
+ * @param[in] msr The model specific register to write.
+ * @param[in] value The value to write.
+ */
+inline static void _cpu_set_msr(const uint32_t msr, const uint64_t value)
+{
+    __asm__ __volatile__("wrmsr" :: "c" (msr),
+                                    "a" ((uint32_t)value),
+                                    "d" ((uint32_t)(value >> 32)));
 }
 
 /**
@@ -354,6 +651,36 @@ inline static uint32_t _cpu_get_saved_interrupt_state(
     return vcpu->int_context.rflags & CPU_RFLAGS_IF;
 }
 
+/**
+ * @brief Returns the saved instruction pointer.
+ *
+ * @details Returns the address of the instruction the thread was executing
+ * when it was interrupted.
+ *
+ * @param[in] vcpu The thread's virtual CPU.
+ *
+ * @return The saved instruction pointer.
+ */
+inline static uintptr_t _cpu_get_saved_pc(const virtual_cpu_t* vcpu)
+{
+    return vcpu->int_context.rip;
+}
+
+/**
+ * @brief Returns the saved frame pointer.
+ *
+ * @details Returns the frame pointer of the function the thread was executing
+ * when it was interrupted.
+ *
+ * @param[in] vcpu The thread's virtual CPU.
+ *
+ * @return The saved frame pointer.
+ */
+inline static uintptr_t _cpu_get_saved_fp(const virtual_cpu_t* vcpu)
+{
+    return vcpu->vcpu.rbp;
+}
+
 /**
  * @brief Returns the CPU current interrupt state.
  *
@@ -365,6 +692,201 @@ inline static uint32_t _cpu_get_interrupt_state(void)
 {
     return ((_cpu_save_flags() & CPU_RFLAGS_IF) != 0);
 }
+
+/** @brief Hints the CPU that the current code is a spin wait loop. */
+inline static void _cpu_pause(void)
+{
+    __asm__ __volatile__("pause":::"memory");
+}
+
+/** @brief Clears the CR0 task switched flag, the FPU can be used. */
+inline static void _cpu_fpu_enable(void)
+{
+    __asm__ __volatile__("clts":::"memory");
+}
+
+/**
+ * @brief Sets the CR0 task switched flag.
+ *
+ * @details Sets the CR0 task switched flag, the next FPU, MMX or SSE
+ * instruction raises a device not available exception.
+ */
+inline static void _cpu_fpu_disable(void)
+{
+    uintptr_t cr0;
+    __asm__ __volatile__("mov %%cr0, %0" : "=r" (cr0));
+    __asm__ __volatile__("mov %0, %%cr0" :: "r" (cr0 | CPU_CR0_TS) : "memory");
+}
+
+/**
+ * @brief Returns the CPU local storage of the current CPU.
+ *
+ * @details Returns the CPU local storage of the current CPU. The storage is
+ * reached through the GS segment and must contain a pointer to itself at
+ * offset CPU_LOCAL_SELF_OFFSET.
+ *
+ * @return The address of the current CPU local storage.
+ */
+inline static void* _cpu_get_local_storage(void)
+{
+    void* local_storage;
+    __asm__ __volatile__("mov %%gs:%c1, %0" : "=r" (local_storage)
+                                            : "i" (CPU_LOCAL_SELF_OFFSET));
+    return local_storage;
+}
+
+/**
+ * @brief Returns the largest paging level that can map a page.
+ *
+ * @details Returns the largest paging level that can map a page. Level 0
+ * entries map 4KB pages, each level above maps pages 2^CPU_PAGING_LEVEL_BITS
+ * times larger.
+ *
+ * @return The largest paging level that can map a page.
+ */
+inline static uint32_t _cpu_get_max_page_level(void)
+{
+    uint32_t regs[4];
+
+    /* 1GB pages support is reported in the extended features */
+    if(_cpu_cpuid(0x80000001, regs) == 1 && (regs[3] & (1 << 26)) != 0)
+    {
+        return 2;
+    }
+    return 1;
+}
+
+/**
+ * @brief Returns the physical address of the current root paging structure.
+ *
+ * @return The physical address of the current root paging structure.
+ */
+inline static uintptr_t _cpu_get_page_directory(void)
+{
+    uintptr_t cr3;
+    __asm__ __volatile__("mov %%cr3, %0" : "=r" (cr3));
+    return cr3 & CPU_PAGE_ADDR_MASK;
+}
+
+/**
+ * @brief Returns the faulting address of the last page fault.
+ *
+ * @return The linear address whose access raised the last page fault.
+ */
+inline static uintptr_t _cpu_get_fault_address(void)
+{
+    uintptr_t cr2;
+    __asm__ __volatile__("mov %%cr2, %0" : "=r" (cr2));
+    return cr2;
+}
+
+/**
+ * @brief Sets the current root paging structure.
+ *
+ * @details Sets the current root paging structure. All the TLB entries are
+ * invalidated, setting the current structure again flushes the TLB.
+ *
+ * @param[in] directory The physical address of the root paging structure.
+ */
+inline static void _cpu_set_page_directory(const uintptr_t directory)
+{
+    __asm__ __volatile__("mov %0, %%cr3" :: "r" (directory) : "memory");
+}
+
+/**
+ * @brief Invalidates the TLB entries of a page.
+ *
+ * @details Invalidates the TLB entries of the page containing an address, and
+ * the paging structures caches, on the current CPU.
+ *
+ * @param[in] address The address in the page to invalidate.
+ */
+inline static void _cpu_invalidate_page(const uintptr_t address)
+{
+    __asm__ __volatile__("invlpg (%0)" :: "r" (address) : "memory");
+}
+
+/**
+ * @brief Sets the current root paging structure and PCID.
+ *
+ * @details Sets the current root paging structure, the TLB entries created
+ * while it is loaded are tagged with the PCID. The PCIDs must be enabled,
+ * see cpu_is_pcid_enabled.
+ *
+ * @param[in] directory The physical address of the root paging structure.
+ * @param[in] pcid The PCID of the paging structures.
+ * @param[in] keep_tlb TRUE to keep the TLB entries tagged with the PCID,
+ * FALSE to invalidate them.
+ */
+inline static void _cpu_set_page_directory_pcid(const uintptr_t directory,
+                                                const uint32_t pcid,
+                                                const bool_t keep_tlb)
+{
+    uint64_t cr3;
+
+    cr3 = directory | (pcid & (CPU_PCID_COUNT - 1));
+    if(keep_tlb == TRUE)
+    {
+        cr3 |= CPU_CR3_PCID_NOFLUSH;
+    }
+    __asm__ __volatile__("mov %0, %%cr3" :: "r" (cr3) : "memory");
+}
+
+/**
+ * @brief Invalidates TLB entries of a PCID.
+ *
+ * @details Invalidates TLB entries and paging structures caches of the current
+ * CPU with the INVPCID instruction, the PCID does not need to be loaded.
+ *
+ * @param[in] type The invalidation type, a CPU_INVPCID value.
+ * @param[in] pcid The PCID to invalidate.
+ * @param[in] address The address to invalidate for CPU_INVPCID_ADDRESS.
+ */
+inline static void _cpu_invpcid(const uint64_t type,
+                                const uint32_t pcid,
+                                const uintptr_t address)
+{
+    struct
+    {
+        uint64_t pcid;
+        uint64_t address;
+    } __attribute__((packed, aligned(16))) descriptor;
+
+    descriptor.pcid    = pcid;
+    descriptor.address = address;
+    __asm__ __volatile__("invpcid %0, %1" :: "m" (descriptor), "r" (type)
+                                          : "memory");
+}
+
+/**
+ * @brief Invalidates the TLB entries of a page of a PCID.
+ *
+ * @param[in] pcid The PCID of the translation.
+ * @param[in] address The address in the page to invalidate.
+ */
+inline static void _cpu_invalidate_pcid_page(const uint32_t pcid,
+                                             const uintptr_t address)
+{
+    _cpu_invpcid(CPU_INVPCID_ADDRESS, pcid, address);
+}
+
+/**
+ * @brief Invalidates all the TLB entries of a PCID.
+ *
+ * @param[in] pcid The PCID to invalidate.
+ */
+inline static void _cpu_invalidate_pcid(const uint32_t pcid)
+{
+    _cpu_invpcid(CPU_INVPCID_CONTEXT, pcid, 0);
+}
+
+/**
+ * @brief Invalidates the TLB entries of all the PCIDs.
+ */
+inline static void _cpu_invalidate_all_pcids(void)
+{
+    _cpu_invpcid(CPU_INVPCID_ALL_CONTEXT, 0, 0);
+}
 /**
  * @brief Initializes the CPU.
  *
@@ -385,6 +907,173 @@ void cpu_init(void);
  */
 OS_RETURN_E cpu_raise_interrupt(const uint32_t interrupt_line);
 
+/**
+ * @brief Initializes a thread's virtual CPU.
+ *
+ * @details Initializes a thread's virtual CPU so that the first restoration
+ * of the context by the interrupt return path jumps to the entry point. An
+ * interrupt return frame is built at the top of the thread's stack.
+ *
+ * @param[in] entry_point The routine executed when the thread is first
+ * elected.
+ * @param[in] stack_end The address right after the end of the thread's stack.
+ * @param[out] v_cpu The virtual CPU to initialize.
+ */
+void cpu_init_thread_context(void (*entry_point)(void),
+                             const uintptr_t stack_end,
+                             virtual_cpu_t* v_cpu);
+
+/**
+ * @brief Sets the CPU local storage of the current CPU.
+ *
+ * @details Sets the CPU local storage of the current CPU. The storage is then
+ * reached through the GS segment. The storage must start with the current
+ * thread pointer and contain a pointer to itself at offset
+ * CPU_LOCAL_SELF_OFFSET, the switched out thread pointer at offset
+ * CPU_LOCAL_SWITCHED_OUT_OFFSET, the kernel stack top at offset
+ * CPU_LOCAL_KERNEL_STACK_OFFSET and the user stack scratch slot at offset
+ * CPU_LOCAL_USER_STACK_OFFSET. The GS segment must not be reloaded once the
+ * local storage is set.
+ *
+ * @param[in] cpu_id The identifier of the current CPU.
+ * @param[in] local_storage The address of the CPU local storage.
+ */
+void cpu_set_local_storage(const uint32_t cpu_id,
+                           const uintptr_t local_storage);
+
+/**
+ * @brief Sets the kernel stack of the current CPU.
+ *
+ * @details Sets the stack the CPU switches to when an interrupt is raised
+ * while it runs in the user space. The scheduler sets it to the kernel stack
+ * of the elected thread, the system call entry uses the same stack.
+ *
+ * @param[in] cpu_id The identifier of the current CPU.
+ * @param[in] stack_top The top of the kernel stack.
+ */
+void cpu_set_kernel_stack(const uint32_t cpu_id, const uintptr_t stack_top);
+
+/**
+ * @brief Starts the application processors.
+ *
+ * @details Starts the application processors with the INIT-SIPI-SIPI
+ * sequence. Each AP runs on its own boot stack, loads the kernel GDT, IDT and
+ * its own TSS, then calls the AP routine given as parameter with its CPU
+ * identifier. The function returns once all the supported CPUs started or
+ * after a timeout, as the number of CPUs present in the system is not known.
+ *
+ * @param[in] ap_main The routine called by each AP once initialized. This
+ * routine must never return.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if ap_main is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if the APs cannot be started.
+ */
+OS_RETURN_E cpu_smp_init(void (*ap_main)(const uint32_t cpu_id));
+
+/**
+ * @brief Returns the number of started CPUs.
+ *
+ * @details Returns the number of started CPUs, the BSP included. Before
+ * cpu_smp_init is called, only the BSP is started.
+ *
+ * @return The number of started CPUs.
+ */
+uint32_t cpu_get_started_count(void);
+
+/**
+ * @brief Saves the FPU state of the current CPU.
+ *
+ * @details Saves the FPU, SSE and AVX state of the current CPU in the buffer
+ * given as parameter. XSAVEOPT is used when the CPU supports it, then XSAVE,
+ * FXSAVE otherwise. The FPU must be enabled.
+ *
+ * @param[out] state The buffer receiving the state, CPU_FPU_STATE_SIZE bytes
+ * aligned on CPU_FPU_STATE_ALIGN. The buffer must be zeroed before its first
+ * use.
+ */
+void cpu_fpu_save(uint8_t* state);
+
+/**
+ * @brief Restores the FPU state of the current CPU.
+ *
+ * @details Restores the FPU, SSE and AVX state of the current CPU from a
+ * buffer filled by cpu_fpu_save. The FPU must be enabled.
+ *
+ * @param[in] state The buffer holding the state to restore.
+ */
+void cpu_fpu_restore(const uint8_t* state);
+
+/**
+ * @brief Resets the FPU state of the current CPU.
+ *
+ * @details Restores the clean FPU, SSE and AVX state captured at boot. This
+ * state is given to the threads on their first FPU use. The FPU must be
+ * enabled.
+ */
+void cpu_fpu_reset(void);
+
+/**
+ * @brief Initializes an application processor.
+ *
+ * @details Initializes an application processor. This function is called by
+ * the AP startup code once the AP runs in long mode on its boot stack. The
+ * kernel GDT, IDT and the CPU TSS are loaded and the FPU is set up, then the
+ * AP routine given to cpu_smp_init is called.
+ *
+ * @param[in] cpu_id The identifier of the AP.
+ */
+void cpu_ap_init(const uint32_t cpu_id);
+
+/**
+ * @brief Tells if the TLB entries are tagged with PCIDs.
+ *
+ * @details Tells if the TLB entries are tagged with PCIDs. The PCIDs are only
+ * enabled when the CPU supports the INVPCID instruction, the entries of a
+ * PCID that is not loaded can then be invalidated.
+ *
+ * @return TRUE if the PCIDs are enabled, FALSE otherwise.
+ */
+bool_t cpu_is_pcid_enabled(void);
+
+/**
+ * @brief Tells if the memory can be mapped write-combining.
+ *
+ * @details Tells if the PAT was programmed with the write-combining type,
+ * selected by the CPU_PAGE_WRITE_COMBINING page entry flags.
+ *
+ * @return TRUE if the write-combining type is available, FALSE otherwise.
+ */
+bool_t cpu_is_write_combining_enabled(void);
+
+/**
+ * @brief Sends an inter processor interrupt to a CPU.
+ *
+ * @details Sends a fixed inter processor interrupt to a CPU through the
+ * LAPIC. The handler of the line must signal the end of the interrupt with
+ * cpu_ipi_eoi.
+ *
+ * @param[in] cpu_id The identifier of the destination CPU.
+ * @param[in] interrupt_line The interrupt line raised on the destination CPU.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OR_ERR_UNAUTHORIZED_INTERRUPT_LINE is returned if the line is not a
+ * customizable interrupt line.
+ * - OS_ERR_NOT_SUPPORTED is returned if the destination CPU has no enabled
+ * LAPIC.
+ */
+OS_RETURN_E cpu_send_ipi(const uint32_t cpu_id, const uint32_t interrupt_line);
+
+/**
+ * @brief Signals the end of an inter processor interrupt.
+ *
+ * @details Signals the end of an inter processor interrupt to the LAPIC of
+ * the current CPU.
+ */
+void cpu_ipi_eoi(void);
+
 #endif /* #ifndef __X86_64_CPU_H_ */
 
 /************************************ EOF *************************************/
\ No newline at end of file
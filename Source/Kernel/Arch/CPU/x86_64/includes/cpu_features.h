@@ -0,0 +1,174 @@
+/*******************************************************************************
+ * @file cpu_features.h
+ *
+ * @see cpu.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief x86_64 CPU features registry and boot time code alternatives.
+ *
+ * @details x86_64 CPU features registry and boot time code alternatives.
+ * The features are detected once by the BSP in cpu_init. The hot paths test
+ * them with CPU_FEATURE_STATIC, which emits a 5 bytes NOP falling through the
+ * generic code and records the site in the .cpu_alternatives section. Once
+ * the features are detected, the sites of the supported features are
+ * patched into a jump to the feature specific code, the test then costs no
+ * memory access nor conditional branch. The sites are patched before the APs
+ * are started, the generic code is executed until then.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __X86_64_CPU_FEATURES_H_
+#define __X86_64_CPU_FEATURES_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Size of an alternative site, the NOP replaced by a JMP rel32. */
+#define CPU_ALTERNATIVE_SITE_SIZE 5
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief CPU features tracked by the registry. */
+typedef enum
+{
+    /** @brief SSE4.2 instructions. */
+    CPU_FEATURE_SSE42         = 0,
+    /** @brief AVX2 instructions. */
+    CPU_FEATURE_AVX2          = 1,
+    /** @brief Enhanced REP MOVSB and REP STOSB. */
+    CPU_FEATURE_ERMS          = 2,
+    /** @brief Fast short REP MOVSB. */
+    CPU_FEATURE_FSRM          = 3,
+    /** @brief x2APIC mode of the local APIC. */
+    CPU_FEATURE_X2APIC        = 4,
+    /** @brief Local APIC timer TSC deadline mode. */
+    CPU_FEATURE_TSC_DEADLINE  = 5,
+    /** @brief Invariant TSC, constant rate in all the power states. */
+    CPU_FEATURE_INVARIANT_TSC = 6,
+    /** @brief XSAVE and the extended state enumeration leaf. */
+    CPU_FEATURE_XSAVE         = 7,
+    /** @brief XSAVEOPT instruction. */
+    CPU_FEATURE_XSAVEOPT      = 8,
+    /** @brief Process context identifiers. */
+    CPU_FEATURE_PCID          = 9,
+    /** @brief INVPCID instruction. */
+    CPU_FEATURE_INVPCID       = 10,
+    /** @brief RDTSCP instruction. */
+    CPU_FEATURE_RDTSCP        = 11,
+    /** @brief Page attribute table. */
+    CPU_FEATURE_PAT           = 12,
+    /** @brief SSE2 instructions, non-temporal stores included. */
+    CPU_FEATURE_SSE2          = 13,
+    /** @brief MONITOR and MWAIT, with the MWAIT extensions and the interrupt
+     * break event.
+     */
+    CPU_FEATURE_MWAIT         = 14,
+    /** @brief Running under a hypervisor. */
+    CPU_FEATURE_HYPERVISOR    = 15,
+    /** @brief KVM paravirtual clock, with a stable clock on all the CPUs. */
+    CPU_FEATURE_KVM_CLOCK     = 16,
+    /** @brief KVM paravirtual end of interrupt. */
+    CPU_FEATURE_KVM_PV_EOI    = 17,
+    /** @brief KVM halted CPUs kick hypercall. */
+    CPU_FEATURE_KVM_PV_UNHALT = 18,
+    /** @brief Number of features. */
+    CPU_FEATURE_COUNT
+} CPU_FEATURE_E;
+
+/** @brief Alternative site record, emitted by CPU_FEATURE_STATIC. */
+typedef struct
+{
+    /** @brief Address of the site NOP. */
+    uintptr_t site;
+
+    /** @brief Address jumped to when the feature is supported. */
+    uintptr_t target;
+
+    /** @brief The tested feature, a CPU_FEATURE_E value. */
+    uint32_t feature;
+
+    /** @brief Padding, keeps the records 8 bytes aligned. */
+    uint32_t reserved;
+} cpu_alternative_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Tests a CPU feature without runtime check.
+ *
+ * @details Tests a CPU feature without runtime check. The macro evaluates to
+ * FALSE until the alternatives are applied by cpu_init, then to the feature
+ * support. FEATURE must be a constant CPU_FEATURE_E value. Non critical paths
+ * should use cpu_has_feature.
+ *
+ * @param[in] FEATURE The tested feature.
+ */
+#define CPU_FEATURE_STATIC(FEATURE) ({                                      \
+    __label__ _cpu_feature_yes, _cpu_feature_end;                           \
+    bool_t _cpu_feature_ret;                                                \
+    __asm__ goto("1:\n\t"                                                   \
+                 ".byte 0x0F, 0x1F, 0x44, 0x00, 0x00\n\t"                   \
+                 ".pushsection .cpu_alternatives, \"a\"\n\t"                \
+                 ".balign 8\n\t"                                            \
+                 ".quad 1b, %l[_cpu_feature_yes]\n\t"                       \
+                 ".long %c0, 0\n\t"                                         \
+                 ".popsection"                                              \
+                 :: "i" (FEATURE) :: _cpu_feature_yes);                     \
+    _cpu_feature_ret = FALSE;                                               \
+    goto _cpu_feature_end;                                                  \
+_cpu_feature_yes:                                                           \
+    _cpu_feature_ret = TRUE;                                                \
+_cpu_feature_end:                                                           \
+    _cpu_feature_ret;                                                       \
+})
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Tells if the CPU supports a feature.
+ *
+ * @details Tells if the CPU supports a feature, as detected by the BSP in
+ * cpu_init. All the features are reported as not supported before.
+ *
+ * @param[in] feature The feature to test.
+ *
+ * @return TRUE if the feature is supported, FALSE otherwise.
+ */
+bool_t cpu_has_feature(const CPU_FEATURE_E feature);
+
+#endif /* #ifndef __X86_64_CPU_FEATURES_H_ */
+
+/************************************ EOF *************************************/
@@ -24,19 +24,118 @@
  * INCLUDES
  ******************************************************************************/
 
+#include <stdint.h>     /* Generic int types */
+#include <stddef.h>     /* Standard definitions */
+#include <cpu.h>        /* CPU interrupt flag management */
 #include <interrupts.h> /* Interrupts management */
+#include <lockstat.h>   /* Lock sites statistics */
+
+/* Configuration files */
+#include <config.h>
 
 /*******************************************************************************
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Ticket spinlock, the waiters get the lock in their arrival order
+ * and spin on the lock.
+ */
+#define KERNEL_SPINLOCK_TICKET 0
+
+/** @brief MCS queued spinlock, the waiters get the lock in their arrival order
+ * and each one spins on its own queue node.
+ */
+#define KERNEL_SPINLOCK_MCS 1
+
+/** @brief Reader-writer lock state flag, set while a writer holds the lock. */
+#define KERNEL_RWLOCK_WRITER 0x80000000
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
 
-/* None */
+/** @brief Queued spinlock node. */
+typedef struct kernel_spinlock_node
+{
+    /** @brief The next waiter in the queue. */
+    struct kernel_spinlock_node* volatile next;
+
+    /** @brief Set while the waiter waits for the lock. */
+    volatile uint32_t waiting;
+} kernel_spinlock_node_t;
+
+/** @brief Kernel spinlock. */
+typedef struct
+{
+    /** @brief Ticket lock: next ticket to give. */
+    volatile uint16_t next_ticket;
+
+    /** @brief Ticket lock: ticket owning the lock. */
+    volatile uint16_t owner_ticket;
+
+    /** @brief Queued lock: last node of the queue, NULL when the lock is free.
+     */
+    kernel_spinlock_node_t* volatile tail;
+
+    /** @brief Queued lock: node standing for the owner, its next node is the
+     * first waiter.
+     */
+    kernel_spinlock_node_t owner;
+
+    /** @brief The lock implementation, KERNEL_SPINLOCK_TICKET or
+     * KERNEL_SPINLOCK_MCS.
+     */
+    uint32_t type;
+
+#if KERNEL_SPINLOCK_STATS
+    /** @brief Timestamp counter value when the lock was last acquired. */
+    uint64_t lock_time;
+
+    /** @brief Longest time the lock was held, in timestamp counter ticks. */
+    uint64_t max_hold_time;
+
+    /** @brief Number of times the lock was acquired. */
+    uint64_t lock_count;
+#endif
+
+#if KERNEL_LOCKSTAT
+    /** @brief Site the lock was acquired at, NULL when the lock was acquired
+     * without site.
+     */
+    lockstat_site_t* lockstat_site;
+
+    /** @brief Timestamp counter value when the lock was acquired at the site.
+     */
+    uint64_t lockstat_time;
+#endif
+} kernel_spinlock_t;
+
+/** @brief Kernel sequence lock, for data read often and written rarely. The
+ * writers are serialized by a spinlock. The readers never lock, they retry
+ * their read when a writer modified the data meanwhile.
+ */
+typedef struct
+{
+    /** @brief Sequence number, odd while a writer modifies the data. */
+    volatile uint32_t sequence;
+
+    /** @brief Lock serializing the writers. */
+    kernel_spinlock_t lock;
+} kernel_seqlock_t;
+
+/** @brief Kernel reader-writer spinlock. The readers share the lock, a writer
+ * owns it alone. The waiting writers have priority over the new readers.
+ */
+typedef struct
+{
+    /** @brief Number of readers holding the lock, KERNEL_RWLOCK_WRITER is set
+     * while a writer holds it.
+     */
+    volatile uint32_t state;
+
+    /** @brief Number of writers waiting for the lock. */
+    volatile uint32_t waiting_writers;
+} kernel_rwlock_t;
 
 /*******************************************************************************
  * MACROS
@@ -48,10 +147,11 @@
  * @param[out] INT_STATE The critical state at section's entrance.
  *
  * @details Enters a critical section in the kernel. Save interrupt state and
- * disables interrupts.
+ * disables interrupts. The interrupts are only disabled by the outermost
+ * critical section.
  */
 #define ENTER_CRITICAL(INT_STATE) {         \
-    INT_STATE = kernel_interrupt_disable(); \
+    INT_STATE = _critical_enter();          \
 }
 
 /**
@@ -60,22 +160,65 @@
  * @param[in] INT_STATE The critical state at section's entrance.
  *
  * @details Exits a critical section in the kernel. Restore the previous
- * interrupt state.
+ * interrupt state, the interrupts are only enabled again by the outermost
+ * critical section.
  */
 #define EXIT_CRITICAL(INT_STATE) {           \
-    kernel_interrupt_restore(INT_STATE);     \
+    _critical_exit(INT_STATE);               \
+}
+
+/**
+ * @brief Enters a critical section and locks a spinlock.
+ *
+ * @details Saves the interrupt state, disables interrupts and locks a
+ * spinlock. This function is safe in kernel mode.
+ *
+ * @param[in-out] LOCK The lock to lock.
+ * @param[out] INT_STATE The critical state at section's entrance.
+*/
+#if KERNEL_LOCKSTAT
+#define KERNEL_SPINLOCK_LOCK_IRQSAVE(LOCK, INT_STATE) {     \
+    INT_STATE = _critical_enter();                          \
+    KERNEL_SPINLOCK_LOCK(LOCK);                             \
+}
+#else
+#define KERNEL_SPINLOCK_LOCK_IRQSAVE(LOCK, INT_STATE) {     \
+    INT_STATE = spinlock_lock_irqsave(&LOCK);               \
+}
+#endif
+
+/**
+ * @brief Unlocks a spinlock and exits a critical section.
+ *
+ * @details Unlocks a spinlock and restores the interrupt state saved by
+ * KERNEL_SPINLOCK_LOCK_IRQSAVE. This function is safe in kernel mode.
+ *
+ * @param[in-out] LOCK The lock to unlock.
+ * @param[in] INT_STATE The critical state at section's entrance.
+*/
+#define KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(LOCK, INT_STATE) {    \
+    spinlock_unlock_irqrestore(&LOCK, INT_STATE);               \
 }
 
 /**
  * @brief Locks a spinlock.
  *
- * @details Locks a spinlock. This function is safe in kernel mode.
+ * @details Locks a spinlock. When KERNEL_LOCKSTAT is enabled, each use of the
+ * macro defines its own lock site descriptor. This function is safe in kernel
+ * mode.
  *
  * @param[in-out] lock The lock to lock.
 */
+#if KERNEL_LOCKSTAT
+#define KERNEL_SPINLOCK_LOCK(LOCK) {                    \
+    LOCKSTAT_SITE_DEFINE(_lockstat_site, #LOCK);        \
+    cpu_lock_spinlock_site(&LOCK, &_lockstat_site);     \
+}
+#else
 #define KERNEL_SPINLOCK_LOCK(LOCK) {    \
     cpu_lock_spinlock(&LOCK);           \
 }
+#endif
 
 /**
  * @brief Unlocks a spinlock.
@@ -88,19 +231,195 @@
     cpu_unlock_spinlock(&LOCK);         \
 }
 
+/**
+ * @brief Initializes a spinlock with an implementation.
+ *
+ * @details Initializes a spinlock with an implementation. This function is
+ * safe in kernel mode.
+ *
+ * @param[out] LOCK The lock to initialize.
+ * @param[in] TYPE The lock implementation, KERNEL_SPINLOCK_TICKET or
+ * KERNEL_SPINLOCK_MCS.
+*/
+#define KERNEL_SPINLOCK_INIT_TYPE(LOCK, TYPE) {     \
+    (LOCK).next_ticket  = 0;                        \
+    (LOCK).owner_ticket = 0;                        \
+    (LOCK).tail         = NULL;                     \
+    (LOCK).owner.next   = NULL;                     \
+    (LOCK).owner.waiting = 0;                      \
+    (LOCK).type         = (TYPE);                   \
+    KERNEL_SPINLOCK_INIT_STATS(LOCK);               \
+    KERNEL_SPINLOCK_INIT_LOCKSTAT(LOCK);            \
+}
+
+#if KERNEL_SPINLOCK_STATS
+/**
+ * @brief Clears the statistics of a spinlock.
+ *
+ * @param[out] LOCK The lock to clear the statistics of.
+*/
+#define KERNEL_SPINLOCK_INIT_STATS(LOCK) {  \
+    (LOCK).lock_time     = 0;               \
+    (LOCK).max_hold_time = 0;               \
+    (LOCK).lock_count    = 0;               \
+}
+#else
+#define KERNEL_SPINLOCK_INIT_STATS(LOCK)
+#endif
+
+#if KERNEL_LOCKSTAT
+/**
+ * @brief Clears the lock site of a spinlock.
+ *
+ * @param[out] LOCK The lock to clear the site of.
+*/
+#define KERNEL_SPINLOCK_INIT_LOCKSTAT(LOCK) {   \
+    (LOCK).lockstat_site = NULL;                \
+}
+#else
+#define KERNEL_SPINLOCK_INIT_LOCKSTAT(LOCK)
+#endif
+
 /**
  * @brief Initializes a spinlock.
  *
- * @details Initializes a spinlock. This function is safe in kernel mode.
+ * @details Initializes a spinlock with the default implementation. This
+ * function is safe in kernel mode.
+ *
+ * @param[out] LOCK The lock to initialize.
+*/
+#define KERNEL_SPINLOCK_INIT(LOCK)                                  \
+    KERNEL_SPINLOCK_INIT_TYPE(LOCK, KERNEL_SPINLOCK_DEFAULT_TYPE)
+
+/**
+ * @brief Kernel spinlock initializer with an implementation.
+ *
+ * @param[in] TYPE The lock implementation, KERNEL_SPINLOCK_TICKET or
+ * KERNEL_SPINLOCK_MCS.
+ */
+#define KERNEL_SPINLOCK_INIT_VALUE_TYPE(TYPE) {     \
+    .next_ticket  = 0,                              \
+    .owner_ticket = 0,                              \
+    .tail         = NULL,                           \
+    .owner        = { .next = NULL, .waiting = 0 }, \
+    .type         = (TYPE)                          \
+}
+
+/** @brief Kernel spinlock initializer, with the default implementation. */
+#define KERNEL_SPINLOCK_INIT_VALUE                                  \
+    KERNEL_SPINLOCK_INIT_VALUE_TYPE(KERNEL_SPINLOCK_DEFAULT_TYPE)
+
+/** @brief Kernel sequence lock initializer. */
+#define KERNEL_SEQLOCK_INIT_VALUE {             \
+    .sequence = 0,                              \
+    .lock     = KERNEL_SPINLOCK_INIT_VALUE      \
+}
+
+/**
+ * @brief Initializes a sequence lock.
+ *
+ * @param[out] LOCK The lock to initialize.
+*/
+#define KERNEL_SEQLOCK_INIT(LOCK) {             \
+    (LOCK).sequence = 0;                        \
+    KERNEL_SPINLOCK_INIT((LOCK).lock);          \
+}
+
+/**
+ * @brief Starts modifying the data protected by a sequence lock.
+ *
+ * @details Locks the sequence lock writers lock and starts a write. The
+ * readers retry their reads until the write ends. An interrupt handler reading
+ * the data would spin on the CPU writing it: the interrupts must be disabled
+ * around the write.
+ *
+ * @param[in-out] LOCK The lock to lock.
+*/
+#define KERNEL_SEQLOCK_WRITE_LOCK(LOCK) {       \
+    seqlock_write_lock(&LOCK);                  \
+}
+
+/**
+ * @brief Ends the modification of the data protected by a sequence lock.
+ *
+ * @param[in-out] LOCK The lock to unlock.
+*/
+#define KERNEL_SEQLOCK_WRITE_UNLOCK(LOCK) {     \
+    seqlock_write_unlock(&LOCK);                \
+}
+
+/**
+ * @brief Starts reading the data protected by a sequence lock.
+ *
+ * @param[in] LOCK The lock protecting the data.
+ *
+ * @return The sequence number to give to KERNEL_SEQLOCK_READ_RETRY.
+*/
+#define KERNEL_SEQLOCK_READ_BEGIN(LOCK) seqlock_read_begin(&LOCK)
+
+/**
+ * @brief Tells if the data read since KERNEL_SEQLOCK_READ_BEGIN was modified.
+ *
+ * @param[in] LOCK The lock protecting the data.
+ * @param[in] SEQUENCE The sequence number returned by
+ * KERNEL_SEQLOCK_READ_BEGIN.
+ *
+ * @return TRUE if the read must be done again, FALSE otherwise.
+*/
+#define KERNEL_SEQLOCK_READ_RETRY(LOCK, SEQUENCE)   \
+    seqlock_read_retry(&LOCK, SEQUENCE)
+
+/** @brief Kernel reader-writer lock initializer. */
+#define KERNEL_RWLOCK_INIT_VALUE {              \
+    .state           = 0,                       \
+    .waiting_writers = 0                        \
+}
+
+/**
+ * @brief Initializes a reader-writer lock.
+ *
+ * @param[out] LOCK The lock to initialize.
+*/
+#define KERNEL_RWLOCK_INIT(LOCK) {              \
+    (LOCK).state           = 0;                 \
+    (LOCK).waiting_writers = 0;                 \
+}
+
+/**
+ * @brief Locks a reader-writer lock for reading.
+ *
+ * @param[in-out] LOCK The lock to lock.
+*/
+#define KERNEL_RWLOCK_READ_LOCK(LOCK) {         \
+    cpu_lock_rwlock_read(&LOCK);                \
+}
+
+/**
+ * @brief Unlocks a reader-writer lock locked for reading.
  *
- * @param[out] lock The lock to initialize.
+ * @param[in-out] LOCK The lock to unlock.
 */
-#define KERNEL_SPINLOCK_INIT(LOCK) {                        \
-    (volatile uint32_t)LOCK = KERNEL_SPINLOCK_INIT_VALUE;   \
+#define KERNEL_RWLOCK_READ_UNLOCK(LOCK) {       \
+    cpu_unlock_rwlock_read(&LOCK);              \
 }
 
-/** @brief Kernel spinlock initializer */
-#define KERNEL_SPINLOCK_INIT_VALUE 0
+/**
+ * @brief Locks a reader-writer lock for writing.
+ *
+ * @param[in-out] LOCK The lock to lock.
+*/
+#define KERNEL_RWLOCK_WRITE_LOCK(LOCK) {        \
+    cpu_lock_rwlock_write(&LOCK);               \
+}
+
+/**
+ * @brief Unlocks a reader-writer lock locked for writing.
+ *
+ * @param[in-out] LOCK The lock to unlock.
+*/
+#define KERNEL_RWLOCK_WRITE_UNLOCK(LOCK) {      \
+    cpu_unlock_rwlock_write(&LOCK);             \
+}
 
 /*******************************************************************************
  * GLOBAL VARIABLES
@@ -122,20 +441,214 @@
 /**
  * @brief Locks a spinlock.
  *
- * @details Locks a spinlock. This function is safe in kernel mode.
+ * @details Locks a spinlock with its implementation. The waiters get the lock
+ * in their arrival order. This function is safe in kernel mode.
+ *
+ * @param[in-out] lock The pointer to the lock to lock.
+*/
+void cpu_lock_spinlock(kernel_spinlock_t* lock);
+
+#if KERNEL_LOCKSTAT
+/**
+ * @brief Locks a spinlock and records the acquisition at a lock site.
+ *
+ * @details Locks a spinlock, measures the wait for the lock and records it in
+ * the lock site descriptor. The hold time is recorded by cpu_unlock_spinlock.
+ * This function is safe in kernel mode.
  *
  * @param[in-out] lock The pointer to the lock to lock.
+ * @param[in-out] site The lock site descriptor.
 */
-void cpu_lock_spinlock(volatile uint32_t * lock);
+void cpu_lock_spinlock_site(kernel_spinlock_t* lock, lockstat_site_t* site);
+#endif
 
 /**
  * @brief Unlocks a spinlock.
  *
- * @details Unlocks a spinlock. This function is safe in kernel mode.
+ * @details Unlocks a spinlock and hands it to the next waiter. This function
+ * is safe in kernel mode.
  *
  * @param[out] lock The pointer to the lock to unlock.
 */
-void cpu_unlock_spinlock(volatile uint32_t * lock);
+void cpu_unlock_spinlock(kernel_spinlock_t* lock);
+
+/**
+ * @brief Locks a reader-writer lock for reading.
+ *
+ * @details Locks a reader-writer lock for reading, the other readers can hold
+ * the lock at the same time. The caller waits while a writer holds the lock or
+ * waits for it. This function is safe in kernel mode.
+ *
+ * @param[in-out] lock The pointer to the lock to lock.
+*/
+void cpu_lock_rwlock_read(kernel_rwlock_t* lock);
+
+/**
+ * @brief Unlocks a reader-writer lock locked for reading.
+ *
+ * @param[in-out] lock The pointer to the lock to unlock.
+*/
+void cpu_unlock_rwlock_read(kernel_rwlock_t* lock);
+
+/**
+ * @brief Locks a reader-writer lock for writing.
+ *
+ * @details Locks a reader-writer lock for writing. The new readers wait from
+ * the call, the caller gets the lock once the current readers released it.
+ * This function is safe in kernel mode.
+ *
+ * @param[in-out] lock The pointer to the lock to lock.
+*/
+void cpu_lock_rwlock_write(kernel_rwlock_t* lock);
+
+/**
+ * @brief Unlocks a reader-writer lock locked for writing.
+ *
+ * @param[in-out] lock The pointer to the lock to unlock.
+*/
+void cpu_unlock_rwlock_write(kernel_rwlock_t* lock);
+
+/**
+ * @brief Enters a critical section.
+ *
+ * @details Saves the interrupt state and disables interrupts. When the
+ * interrupts are already disabled, the section is nested in another critical
+ * section and the CPU flags are left untouched.
+ *
+ * @return The interrupt state at the section's entrance: 1 if the interrupts
+ * were enabled, 0 otherwise.
+ */
+inline static uint32_t _critical_enter(void)
+{
+    uint32_t int_state;
+
+    int_state = _cpu_get_interrupt_state();
+    if(int_state != 0)
+    {
+        _cpu_clear_interrupt();
+    }
+
+    return int_state;
+}
+
+/**
+ * @brief Exits a critical section.
+ *
+ * @details Enables the interrupts if they were enabled at the section's
+ * entrance. The CPU flags are left untouched when exiting a nested critical
+ * section.
+ *
+ * @param[in] int_state The interrupt state at the section's entrance.
+ */
+inline static void _critical_exit(const uint32_t int_state)
+{
+    if(int_state != 0)
+    {
+        _cpu_set_interrupt();
+    }
+}
+
+/**
+ * @brief Disables interrupts and locks a spinlock.
+ *
+ * @details Saves the interrupt state, disables interrupts and locks a
+ * spinlock. The lock is never held with the interrupts enabled, an interrupt
+ * handler taking the same lock on the CPU cannot deadlock.
+ *
+ * @param[in-out] lock The pointer to the lock to lock.
+ *
+ * @return The interrupt state to give to spinlock_unlock_irqrestore.
+ */
+inline static uint32_t spinlock_lock_irqsave(kernel_spinlock_t* lock)
+{
+    uint32_t int_state;
+
+    int_state = _critical_enter();
+    cpu_lock_spinlock(lock);
+
+    return int_state;
+}
+
+/**
+ * @brief Unlocks a spinlock and restores the interrupt state.
+ *
+ * @param[in-out] lock The pointer to the lock to unlock.
+ * @param[in] int_state The interrupt state returned by spinlock_lock_irqsave.
+ */
+inline static void spinlock_unlock_irqrestore(kernel_spinlock_t* lock,
+                                              const uint32_t int_state)
+{
+    cpu_unlock_spinlock(lock);
+    _critical_exit(int_state);
+}
+
+/**
+ * @brief Starts modifying the data protected by a sequence lock.
+ *
+ * @details Locks the writers lock and makes the sequence number odd before
+ * any modification of the data is visible.
+ *
+ * @param[in-out] lock The pointer to the lock to lock.
+ */
+inline static void seqlock_write_lock(kernel_seqlock_t* lock)
+{
+    cpu_lock_spinlock(&lock->lock);
+    __atomic_store_n(&lock->sequence, lock->sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Ends the modification of the data protected by a sequence lock.
+ *
+ * @details Makes the sequence number even once all the modifications of the
+ * data are visible and unlocks the writers lock.
+ *
+ * @param[in-out] lock The pointer to the lock to unlock.
+ */
+inline static void seqlock_write_unlock(kernel_seqlock_t* lock)
+{
+    __atomic_store_n(&lock->sequence, lock->sequence + 1, __ATOMIC_RELEASE);
+    cpu_unlock_spinlock(&lock->lock);
+}
+
+/**
+ * @brief Starts reading the data protected by a sequence lock.
+ *
+ * @details Waits for the current write to end and returns the sequence
+ * number.
+ *
+ * @param[in] lock The pointer to the lock protecting the data.
+ *
+ * @return The sequence number to give to seqlock_read_retry.
+ */
+inline static uint32_t seqlock_read_begin(const kernel_seqlock_t* lock)
+{
+    uint32_t sequence;
+
+    while(((sequence = __atomic_load_n(&lock->sequence, __ATOMIC_ACQUIRE)) &
+           1) != 0)
+    {
+        _cpu_pause();
+    }
+
+    return sequence;
+}
+
+/**
+ * @brief Tells if the data read since seqlock_read_begin was modified.
+ *
+ * @param[in] lock The pointer to the lock protecting the data.
+ * @param[in] sequence The sequence number returned by seqlock_read_begin.
+ *
+ * @return TRUE if the read must be done again, FALSE otherwise.
+ */
+inline static bool_t seqlock_read_retry(const kernel_seqlock_t* lock,
+                                        const uint32_t sequence)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return __atomic_load_n(&lock->sequence, __ATOMIC_RELAXED) != sequence;
+}
 
 
 #endif /* #ifndef __X86_64_CRITICAL_H_ */
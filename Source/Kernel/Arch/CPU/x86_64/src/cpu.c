@@ -26,6 +26,10 @@
 #include <string.h>         /* Memory manipulation */
 #include <kernel_output.h>  /* Kernel output */
 #include <cpu_interrupt.h>  /* Interrupt manager */
+#include <pit.h>            /* PIT delays */
+#include <lapic.h>          /* LAPIC identifiers and end of interrupt */
+#include <cpu_features.h>   /* CPU features registry */
+#include <topology.h>       /* Number of CPUs present */
 
 /* Header file */
 #include <cpu.h>
@@ -59,7 +63,8 @@
 /** @brief User's 64 bits data segment descriptor. */
 #define USER_DS_64 0x50
 
-/** @brief Kernel's TSS segment descriptor. */
+/** @brief Kernel's TSS segment descriptor, one 16 bytes descriptor per CPU.
+ */
 #define TSS_SEGMENT  0x60
 
 /** @brief Select the thread code segment. */
@@ -67,6 +72,85 @@
 /** @brief Select the thread code segment. */
 #define THREAD_KERNEL_DS KERNEL_DS_64
 
+/** @brief Initial RFLAGS value of a thread: interrupts enabled. */
+#define THREAD_INIT_RFLAGS (0x2 | CPU_RFLAGS_IF)
+/** @brief Thread's stack alignement at thread creation. */
+#define THREAD_STACK_ALIGN 16
+
+/** @brief IA32_GS_BASE MSR, holds the GS segment base address. */
+#define CPU_MSR_GS_BASE 0xC0000101
+
+/** @brief IA32_APIC_BASE MSR, holds the LAPIC base address. */
+#define CPU_MSR_APIC_BASE      0x1B
+/** @brief IA32_APIC_BASE MSR base address mask. */
+#define CPU_MSR_APIC_BASE_MASK 0xFFFFF000
+/** @brief IA32_APIC_BASE MSR flag: the LAPIC is in x2APIC mode. */
+#define CPU_MSR_APIC_BASE_X2APIC 0x400
+/** @brief x2APIC interrupt command register MSR. */
+#define CPU_MSR_X2APIC_ICR 0x830
+
+/** @brief IA32_KERNEL_GS_BASE MSR, exchanged with the GS base by swapgs. */
+#define CPU_MSR_KERNEL_GS_BASE 0xC0000102
+/** @brief IA32_EFER MSR, extended features enable register. */
+#define CPU_MSR_EFER     0xC0000080
+/** @brief IA32_EFER MSR flag: SYSCALL and SYSRET enabled. */
+#define CPU_MSR_EFER_SCE 0x1
+/** @brief IA32_STAR MSR, SYSCALL and SYSRET segments selectors. */
+#define CPU_MSR_STAR     0xC0000081
+/** @brief IA32_LSTAR MSR, SYSCALL 64 bits entry point. */
+#define CPU_MSR_LSTAR    0xC0000082
+/** @brief IA32_FMASK MSR, RFLAGS bits cleared by SYSCALL. */
+#define CPU_MSR_FMASK    0xC0000084
+
+/** @brief RFLAGS cleared on system call entry: interrupts, trap, direction
+ * and alignment check flags. The entry stub enables the interrupts once on
+ * the kernel stack.
+ */
+#define CPU_SYSCALL_RFLAGS_MASK (CPU_RFLAGS_IF | 0x00040500)
+
+/** @brief CPUID leaf 1 EDX flag: the CPU has a LAPIC. */
+#define CPUID_FEATURES_EDX_APIC (1 << 9)
+
+/** @brief LAPIC base address, identity mapped by the boot code. */
+#define CPU_LAPIC_BASE_ADDR 0xFEE00000
+/** @brief LAPIC interrupt command register, low part. */
+#define CPU_LAPIC_ICR_LOW  0x300
+/** @brief LAPIC interrupt command register, high part. */
+#define CPU_LAPIC_ICR_HIGH 0x310
+/** @brief LAPIC interrupt command register: delivery pending flag. */
+#define CPU_LAPIC_ICR_DELIVERY_PENDING 0x00001000
+/** @brief LAPIC interrupt command register, high part: destination shift. */
+#define CPU_LAPIC_ICR_DEST_SHIFT 24
+/** @brief LAPIC interrupt command: fixed IPI sent to the destination CPU, the
+ * vector is the interrupt line.
+ */
+#define CPU_LAPIC_ICR_FIXED 0x00004000
+/** @brief LAPIC interrupt command: INIT IPI sent to all the other CPUs. */
+#define CPU_LAPIC_ICR_INIT_ALL_BUT_SELF    0x000C4500
+/** @brief LAPIC interrupt command: startup IPI sent to all the other CPUs, the
+ * vector is the page number of the startup code.
+ */
+#define CPU_LAPIC_ICR_STARTUP_ALL_BUT_SELF 0x000C4600
+
+/** @brief Delay after the INIT IPI in microseconds. */
+#define CPU_SMP_INIT_DELAY_US    10000
+/** @brief Delay after each startup IPI in microseconds. */
+#define CPU_SMP_STARTUP_DELAY_US 200
+/** @brief Time given to the APs to start in microseconds. */
+#define CPU_SMP_START_TIMEOUT_US 100000
+/** @brief Polling period while waiting for the APs in microseconds. */
+#define CPU_SMP_POLL_PERIOD_US   1000
+
+/** @brief IST index of the emergency stack used for NMI, double faults and
+ * machine checks.
+ */
+#define CPU_EMERGENCY_IST 1
+
+/** @brief IST index of the fault stack used for page faults, the faults on
+ * the threads stacks pages not committed yet cannot use the faulting stack.
+ */
+#define CPU_FAULT_IST 2
+
 /** @brief Kernel's 64 bits code segment base address. */
 #define KERNEL_CODE_SEGMENT_BASE_64  0x00000000
 /** @brief Kernel's 64 bits code segment limit address. */
@@ -190,7 +274,141 @@
 #define IDT_TYPE_TRAP_GATE 0x0F
 
 /** @brief Number of entries in the kernel's GDT. */
-#define GDT_ENTRY_COUNT (13 + MAX_CPU_COUNT)
+#define GDT_ENTRY_COUNT (TSS_SEGMENT / 8 + 2 * MAX_CPU_COUNT)
+
+/***************************
+ * Features settings
+ **************************/
+
+/** @brief CR0 supervisor write protect flag. */
+#define CPU_CR0_WP 0x00010000
+
+/** @brief JMP rel32 opcode, written on the alternative sites. */
+#define CPU_JMP_REL32_OPCODE 0xE9
+
+/** @brief CPUID leaf 1 ECX flag: the CPU supports SSE4.2. */
+#define CPUID_FEATURES_ECX_SSE42        (1 << 20)
+/** @brief CPUID leaf 1 ECX flag: the CPU supports the x2APIC mode. */
+#define CPUID_FEATURES_ECX_X2APIC       (1 << 21)
+/** @brief CPUID leaf 1 ECX flag: the LAPIC timer supports the TSC deadline
+ * mode.
+ */
+#define CPUID_FEATURES_ECX_TSC_DEADLINE (1 << 24)
+/** @brief CPUID leaf 1 EDX flag: the CPU supports the page attribute table. */
+#define CPUID_FEATURES_EDX_PAT          (1 << 16)
+/** @brief CPUID leaf 1 EDX flag: the CPU supports SSE2. */
+#define CPUID_FEATURES_EDX_SSE2         (1 << 26)
+
+/** @brief IA32_PAT MSR, memory types selected by the page entries. */
+#define CPU_MSR_PAT       0x277
+/** @brief IA32_PAT MSR value: the power-on types WB, WT, UC-, UC, with the
+ * entry 1, selected by the write-through flag alone, set to write-combining.
+ */
+#define CPU_MSR_PAT_VALUE 0x0007040600070106ULL
+/** @brief CPUID structured extended features leaf EBX flag: the CPU supports
+ * AVX2.
+ */
+#define CPUID_EXT_FEATURES_EBX_AVX2     (1 << 5)
+/** @brief CPUID structured extended features leaf EBX flag: the CPU supports
+ * enhanced REP MOVSB and REP STOSB.
+ */
+#define CPUID_EXT_FEATURES_EBX_ERMS     (1 << 9)
+/** @brief CPUID structured extended features leaf EDX flag: the CPU supports
+ * fast short REP MOVSB.
+ */
+#define CPUID_EXT_FEATURES_EDX_FSRM     (1 << 4)
+/** @brief CPUID extended processor features leaf. */
+#define CPUID_EXT_PROC_LEAF             0x80000001
+/** @brief CPUID extended processor features leaf EDX flag: the CPU supports
+ * RDTSCP.
+ */
+#define CPUID_EXT_PROC_EDX_RDTSCP       (1 << 27)
+/** @brief CPUID advanced power management leaf. */
+#define CPUID_POWER_LEAF                0x80000007
+/** @brief CPUID advanced power management leaf EDX flag: the TSC is
+ * invariant.
+ */
+#define CPUID_POWER_EDX_INVARIANT_TSC   (1 << 8)
+/** @brief CPUID leaf 1 ECX flag: the CPU supports MONITOR and MWAIT. */
+#define CPUID_FEATURES_ECX_MONITOR      (1 << 3)
+/** @brief CPUID MONITOR and MWAIT leaf. */
+#define CPUID_MWAIT_LEAF                0x05
+/** @brief CPUID MONITOR and MWAIT leaf ECX flag: the MWAIT extensions are
+ * enumerated.
+ */
+#define CPUID_MWAIT_ECX_EMX             (1 << 0)
+/** @brief CPUID MONITOR and MWAIT leaf ECX flag: interrupts break MWAIT even
+ * when they are disabled.
+ */
+#define CPUID_MWAIT_ECX_IBE             (1 << 1)
+/** @brief CPUID leaf 1 ECX flag: running under a hypervisor. */
+#define CPUID_FEATURES_ECX_HYPERVISOR   (1U << 31)
+/** @brief CPUID hypervisor signature leaf. */
+#define CPUID_HYPERVISOR_LEAF           0x40000000
+/** @brief KVM signature, in the hypervisor signature leaf EBX, ECX, EDX. */
+#define CPUID_KVM_SIGNATURE             "KVMKVMKVM\0\0\0"
+/** @brief CPUID KVM features leaf. */
+#define CPUID_KVM_FEATURES_LEAF         0x40000001
+/** @brief CPUID KVM features leaf EAX flag: the new clock MSRs are
+ * supported.
+ */
+#define CPUID_KVM_EAX_CLOCKSOURCE2      (1 << 3)
+/** @brief CPUID KVM features leaf EAX flag: paravirtual end of interrupt. */
+#define CPUID_KVM_EAX_PV_EOI            (1 << 6)
+/** @brief CPUID KVM features leaf EAX flag: halted CPUs can be kicked. */
+#define CPUID_KVM_EAX_PV_UNHALT         (1 << 7)
+/** @brief CPUID KVM features leaf EAX flag: the clock is stable on all the
+ * CPUs.
+ */
+#define CPUID_KVM_EAX_CLOCK_STABLE      (1 << 24)
+
+/***************************
+ * FPU settings
+ **************************/
+
+/** @brief CR0 monitor coprocessor flag. */
+#define CPU_CR0_MP 0x00000002
+/** @brief CR0 FPU emulation flag. */
+#define CPU_CR0_EM 0x00000004
+
+/** @brief CR4 FXSAVE and FXRSTOR support flag. */
+#define CPU_CR4_OSFXSR     0x00000200
+/** @brief CR4 unmasked SIMD floating point exceptions support flag. */
+#define CPU_CR4_OSXMMEXCPT 0x00000400
+/** @brief CR4 XSAVE and extended states support flag. */
+#define CPU_CR4_OSXSAVE    0x00040000
+/** @brief CR4 process context identifiers support flag. */
+#define CPU_CR4_PCIDE      0x00020000
+
+/** @brief CPUID leaf 1 ECX flag: the CPU supports the PCIDs. */
+#define CPUID_FEATURES_ECX_PCID (1 << 17)
+/** @brief CPUID structured extended features leaf. */
+#define CPUID_EXT_FEATURES_LEAF 0x07
+/** @brief CPUID structured extended features leaf EBX flag: the CPU supports
+ * INVPCID.
+ */
+#define CPUID_EXT_FEATURES_EBX_INVPCID (1 << 10)
+
+/** @brief CPUID leaf 1 ECX flag: the CPU supports XSAVE. */
+#define CPUID_FEATURES_ECX_XSAVE (1 << 26)
+/** @brief CPUID leaf 1 ECX flag: the CPU supports AVX. */
+#define CPUID_FEATURES_ECX_AVX   (1 << 28)
+
+/** @brief CPUID extended state enumeration leaf. */
+#define CPUID_XSAVE_LEAF          0x0D
+/** @brief CPUID extended state leaf, sub-leaf 1 EAX flag: the CPU supports
+ * XSAVEOPT.
+ */
+#define CPUID_XSAVE_EAX_XSAVEOPT  (1 << 0)
+/** @brief CPUID extended state leaf, sub-leaf of the AVX state component. */
+#define CPUID_XSAVE_AVX_SUBLEAF   2
+
+/** @brief XCR0 x87 state component. */
+#define CPU_XCR0_X87 0x1
+/** @brief XCR0 SSE state component. */
+#define CPU_XCR0_SSE 0x2
+/** @brief XCR0 AVX state component. */
+#define CPU_XCR0_AVX 0x4
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
@@ -281,7 +499,37 @@ typedef struct cpu_tss_entry
  * MACROS
  ******************************************************************************/
 
-/* None */
+/**
+ * @brief Builds a GDT entry as a constant expression, with the same layout as
+ * _format_gdt_entry.
+ *
+ * @param[in] BASE  The base address of the segment for the GDT entry.
+ * @param[in] LIMIT The limit address of the segment for the GDT entry.
+ * @param[in] TYPE  The type of segment for the GDT entry.
+ * @param[in] FLAGS The flags to be set for the GDT entry.
+ */
+#define GDT_ENTRY(BASE, LIMIT, TYPE, FLAGS)                                 \
+    ((uint64_t)((((uint32_t)(BASE) & 0xFFFF) << 16) |                       \
+                ((uint32_t)(LIMIT) & 0xFFFF)) |                             \
+     ((uint64_t)((((uint32_t)(BASE) >> 16) & 0xFF) |                        \
+                 (((uint32_t)(TYPE) & 0xF) << 8) |                          \
+                 ((uint32_t)(FLAGS) & 0x00F0F000) |                         \
+                 ((uint32_t)(LIMIT) & 0xF0000) |                            \
+                 ((uint32_t)(BASE) & 0xFF000000)) << 32))
+
+/**
+ * @brief Sets a feature in the registry when its CPUID flag is set.
+ *
+ * @param[in] FEATURE The CPU_FEATURE_E value of the feature.
+ * @param[in] REG The CPUID output register holding the flag.
+ * @param[in] FLAG The CPUID flag of the feature.
+ */
+#define CPU_SET_FEATURE(FEATURE, REG, FLAG) {                               \
+    if(((REG) & (FLAG)) != 0)                                               \
+    {                                                                       \
+        cpu_features |= (1U << (FEATURE));                                  \
+    }                                                                       \
+}
 
 /*******************************************************************************
  * GLOBAL VARIABLES
@@ -291,1596 +539,298 @@ typedef struct cpu_tss_entry
 /** @brief Kernel stacks base symbol. */
 extern int8_t _KERNEL_STACKS_BASE;
 
+/** @brief APs startup code start, copied to KERNEL_AP_BOOT_ADDR. */
+extern uint8_t __kinit_ap_start;
+/** @brief APs startup code end. */
+extern uint8_t __kinit_ap_end;
+/** @brief APs startup code page table address parameter. */
+extern uint32_t _kinit_ap_cr3;
+
 /**
- * @brief Assembly interrupt handler for line 0.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_0(void);
-/**
- * @brief Assembly interrupt handler for line 1.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_1(void);
-/**
- * @brief Assembly interrupt handler for line 2.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_2(void);
-/**
- * @brief Assembly interrupt handler for line 3.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_3(void);
-/**
- * @brief Assembly interrupt handler for line 4.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_4(void);
-/**
- * @brief Assembly interrupt handler for line 5.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_5(void);
-/**
- * @brief Assembly interrupt handler for line 6.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_6(void);
-/**
- * @brief Assembly interrupt handler for line 7.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_7(void);
-/**
- * @brief Assembly interrupt handler for line 8.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_8(void);
-/**
- * @brief Assembly interrupt handler for line 9.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_9(void);
-/**
- * @brief Assembly interrupt handler for line 10.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_10(void);
-/**
- * @brief Assembly interrupt handler for line 11.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_11(void);
-/**
- * @brief Assembly interrupt handler for line 12.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_12(void);
-/**
- * @brief Assembly interrupt handler for line 13.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_13(void);
-/**
- * @brief Assembly interrupt handler for line 14.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_14(void);
-/**
- * @brief Assembly interrupt handler for line 15.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_15(void);
-/**
- * @brief Assembly interrupt handler for line 16.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_16(void);
-/**
- * @brief Assembly interrupt handler for line 17.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_17(void);
-/**
- * @brief Assembly interrupt handler for line 18.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_18(void);
-/**
- * @brief Assembly interrupt handler for line 19.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_19(void);
-/**
- * @brief Assembly interrupt handler for line 20.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_20(void);
-/**
- * @brief Assembly interrupt handler for line 21.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_21(void);
-/**
- * @brief Assembly interrupt handler for line 22.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_22(void);
-/**
- * @brief Assembly interrupt handler for line 23.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_23(void);
-/**
- * @brief Assembly interrupt handler for line 24.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_24(void);
-/**
- * @brief Assembly interrupt handler for line 25.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_25(void);
-/**
- * @brief Assembly interrupt handler for line 26.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_26(void);
-/**
- * @brief Assembly interrupt handler for line 27.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_27(void);
-/**
- * @brief Assembly interrupt handler for line 28.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_28(void);
-/**
- * @brief Assembly interrupt handler for line 29.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_29(void);
-/**
- * @brief Assembly interrupt handler for line 30.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_30(void);
-/**
- * @brief Assembly interrupt handler for line 31.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_31(void);
-/**
- * @brief Assembly interrupt handler for line 32.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_32(void);
-/**
- * @brief Assembly interrupt handler for line 33.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_33(void);
-/**
- * @brief Assembly interrupt handler for line 34.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_34(void);
-/**
- * @brief Assembly interrupt handler for line 35.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_35(void);
-/**
- * @brief Assembly interrupt handler for line 36.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_36(void);
-/**
- * @brief Assembly interrupt handler for line 37.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_37(void);
-/**
- * @brief Assembly interrupt handler for line 38.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_38(void);
-/**
- * @brief Assembly interrupt handler for line 39.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_39(void);
-/**
- * @brief Assembly interrupt handler for line 40.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_40(void);
-/**
- * @brief Assembly interrupt handler for line 41.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_41(void);
-/**
- * @brief Assembly interrupt handler for line 42.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_42(void);
-/**
- * @brief Assembly interrupt handler for line 43.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_43(void);
-/**
- * @brief Assembly interrupt handler for line 44.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_44(void);
-/**
- * @brief Assembly interrupt handler for line 45.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_45(void);
-/**
- * @brief Assembly interrupt handler for line 46.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_46(void);
-/**
- * @brief Assembly interrupt handler for line 47.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_47(void);
-/**
- * @brief Assembly interrupt handler for line 48.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_48(void);
-/**
- * @brief Assembly interrupt handler for line 49.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_49(void);
-/**
- * @brief Assembly interrupt handler for line 50.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_50(void);
-/**
- * @brief Assembly interrupt handler for line 51.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_51(void);
-/**
- * @brief Assembly interrupt handler for line 52.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_52(void);
-/**
- * @brief Assembly interrupt handler for line 53.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_53(void);
-/**
- * @brief Assembly interrupt handler for line 54.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_54(void);
-/**
- * @brief Assembly interrupt handler for line 55.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_55(void);
-/**
- * @brief Assembly interrupt handler for line 56.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_56(void);
-/**
- * @brief Assembly interrupt handler for line 57.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_57(void);
-/**
- * @brief Assembly interrupt handler for line 58.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_58(void);
-/**
- * @brief Assembly interrupt handler for line 59.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_59(void);
-/**
- * @brief Assembly interrupt handler for line 60.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_60(void);
-/**
- * @brief Assembly interrupt handler for line 61.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_61(void);
-/**
- * @brief Assembly interrupt handler for line 62.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_62(void);
-/**
- * @brief Assembly interrupt handler for line 63.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_63(void);
-/**
- * @brief Assembly interrupt handler for line 64.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_64(void);
-/**
- * @brief Assembly interrupt handler for line 65.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_65(void);
-/**
- * @brief Assembly interrupt handler for line 66.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_66(void);
-/**
- * @brief Assembly interrupt handler for line 67.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_67(void);
-/**
- * @brief Assembly interrupt handler for line 68.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_68(void);
-/**
- * @brief Assembly interrupt handler for line 69.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_69(void);
-/**
- * @brief Assembly interrupt handler for line 70.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_70(void);
-/**
- * @brief Assembly interrupt handler for line 71.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_71(void);
-/**
- * @brief Assembly interrupt handler for line 72.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_72(void);
-/**
- * @brief Assembly interrupt handler for line 73.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_73(void);
-/**
- * @brief Assembly interrupt handler for line 74.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_74(void);
-/**
- * @brief Assembly interrupt handler for line 75.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_75(void);
-/**
- * @brief Assembly interrupt handler for line 76.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_76(void);
-/**
- * @brief Assembly interrupt handler for line 77.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_77(void);
-/**
- * @brief Assembly interrupt handler for line 78.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_78(void);
-/**
- * @brief Assembly interrupt handler for line 79.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_79(void);
-/**
- * @brief Assembly interrupt handler for line 80.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_80(void);
-/**
- * @brief Assembly interrupt handler for line 81.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_81(void);
-/**
- * @brief Assembly interrupt handler for line 82.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_82(void);
-/**
- * @brief Assembly interrupt handler for line 83.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_83(void);
-/**
- * @brief Assembly interrupt handler for line 84.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_84(void);
-/**
- * @brief Assembly interrupt handler for line 85.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_85(void);
-/**
- * @brief Assembly interrupt handler for line 86.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_86(void);
-/**
- * @brief Assembly interrupt handler for line 87.
- * Saves the context and calls the generic interrupt handler
+ * @brief Assembly SYSCALL entry point.
+ * Switches to the thread's kernel stack and calls the system calls dispatcher
  */
-extern void interrupt_handler_87(void);
+extern void cpu_syscall_entry(void);
+
 /**
- * @brief Assembly interrupt handler for line 88.
- * Saves the context and calls the generic interrupt handler
+ * @brief CPU IDT, built at link time from the assembly interrupt handlers
+ * base address, see int_handlers.s.
  */
-extern void interrupt_handler_88(void);
+extern const cpu_idt_entry_t cpu_idt[IDT_ENTRY_COUNT];
+
+/** @brief Alternative sites start, see cpu_features.h. */
+extern const cpu_alternative_t _START_CPU_ALTERNATIVES_ADDR[];
+/** @brief Alternative sites end. */
+extern const cpu_alternative_t _END_CPU_ALTERNATIVES_ADDR[];
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
 /**
- * @brief Assembly interrupt handler for line 89.
- * Saves the context and calls the generic interrupt handler
+ * @brief CPU GDT space in memory. The segments are built at compile time,
+ * only the TSS descriptors are set at boot. The GDT stays writable, the CPU
+ * sets the TSS descriptors busy bit when loading the task register.
+ */
+static uint64_t cpu_gdt[GDT_ENTRY_COUNT] __attribute__((aligned(8))) = {
+    [KERNEL_CS_64 / 8] = GDT_ENTRY(KERNEL_CODE_SEGMENT_BASE_64,
+                                   KERNEL_CODE_SEGMENT_LIMIT_64,
+                                   GDT_TYPE_EXECUTABLE |
+                                   GDT_TYPE_READABLE |
+                                   GDT_TYPE_PROTECTED,
+                                   GDT_FLAG_64_BIT_SEGMENT |
+                                   GDT_FLAG_PL0 |
+                                   GDT_FLAG_SEGMENT_PRESENT |
+                                   GDT_FLAG_CODE_TYPE),
+    [KERNEL_DS_64 / 8] = GDT_ENTRY(KERNEL_DATA_SEGMENT_BASE_64,
+                                   KERNEL_DATA_SEGMENT_LIMIT_64,
+                                   GDT_TYPE_WRITABLE |
+                                   GDT_TYPE_GROW_DOWN,
+                                   GDT_FLAG_64_BIT_SEGMENT |
+                                   GDT_FLAG_PL0 |
+                                   GDT_FLAG_SEGMENT_PRESENT |
+                                   GDT_FLAG_DATA_TYPE),
+    [KERNEL_CS_32 / 8] = GDT_ENTRY(KERNEL_CODE_SEGMENT_BASE_32,
+                                   KERNEL_CODE_SEGMENT_LIMIT_32,
+                                   GDT_TYPE_EXECUTABLE |
+                                   GDT_TYPE_READABLE |
+                                   GDT_TYPE_PROTECTED,
+                                   GDT_FLAG_GRANULARITY_4K |
+                                   GDT_FLAG_32_BIT_SEGMENT |
+                                   GDT_FLAG_PL0 |
+                                   GDT_FLAG_SEGMENT_PRESENT |
+                                   GDT_FLAG_CODE_TYPE),
+    [KERNEL_DS_32 / 8] = GDT_ENTRY(KERNEL_DATA_SEGMENT_BASE_32,
+                                   KERNEL_DATA_SEGMENT_LIMIT_32,
+                                   GDT_TYPE_WRITABLE |
+                                   GDT_TYPE_GROW_DOWN,
+                                   GDT_FLAG_GRANULARITY_4K |
+                                   GDT_FLAG_32_BIT_SEGMENT |
+                                   GDT_FLAG_PL0 |
+                                   GDT_FLAG_SEGMENT_PRESENT |
+                                   GDT_FLAG_DATA_TYPE),
+    [KERNEL_CS_16 / 8] = GDT_ENTRY(KERNEL_CODE_SEGMENT_BASE_16,
+                                   KERNEL_CODE_SEGMENT_LIMIT_16,
+                                   GDT_TYPE_EXECUTABLE |
+                                   GDT_TYPE_READABLE |
+                                   GDT_TYPE_PROTECTED,
+                                   GDT_FLAG_GRANULARITY_4K |
+                                   GDT_FLAG_16_BIT_SEGMENT |
+                                   GDT_FLAG_PL0 |
+                                   GDT_FLAG_SEGMENT_PRESENT |
+                                   GDT_FLAG_CODE_TYPE),
+    [KERNEL_DS_16 / 8] = GDT_ENTRY(KERNEL_DATA_SEGMENT_BASE_16,
+                                   KERNEL_DATA_SEGMENT_LIMIT_16,
+                                   GDT_TYPE_WRITABLE |
+                                   GDT_TYPE_GROW_DOWN,
+                                   GDT_FLAG_GRANULARITY_4K |
+                                   GDT_FLAG_16_BIT_SEGMENT |
+                                   GDT_FLAG_PL0 |
+                                   GDT_FLAG_SEGMENT_PRESENT |
+                                   GDT_FLAG_DATA_TYPE),
+    [USER_CS_64 / 8]   = GDT_ENTRY(USER_CODE_SEGMENT_BASE_64,
+                                   USER_CODE_SEGMENT_LIMIT_64,
+                                   GDT_TYPE_EXECUTABLE |
+                                   GDT_TYPE_READABLE |
+                                   GDT_TYPE_PROTECTED,
+                                   GDT_FLAG_64_BIT_SEGMENT |
+                                   GDT_FLAG_PL3 |
+                                   GDT_FLAG_SEGMENT_PRESENT |
+                                   GDT_FLAG_CODE_TYPE),
+    [USER_DS_64 / 8]   = GDT_ENTRY(USER_DATA_SEGMENT_BASE_64,
+                                   USER_DATA_SEGMENT_LIMIT_64,
+                                   GDT_TYPE_WRITABLE |
+                                   GDT_TYPE_GROW_DOWN,
+                                   GDT_FLAG_64_BIT_SEGMENT |
+                                   GDT_FLAG_PL3 |
+                                   GDT_FLAG_SEGMENT_PRESENT |
+                                   GDT_FLAG_DATA_TYPE),
+    [USER_CS_32 / 8]   = GDT_ENTRY(USER_CODE_SEGMENT_BASE_32,
+                                   USER_CODE_SEGMENT_LIMIT_32,
+                                   GDT_TYPE_EXECUTABLE |
+                                   GDT_TYPE_READABLE |
+                                   GDT_TYPE_PROTECTED,
+                                   GDT_FLAG_GRANULARITY_4K |
+                                   GDT_FLAG_32_BIT_SEGMENT |
+                                   GDT_FLAG_PL3 |
+                                   GDT_FLAG_SEGMENT_PRESENT |
+                                   GDT_FLAG_CODE_TYPE),
+    [USER_DS_32 / 8]   = GDT_ENTRY(USER_DATA_SEGMENT_BASE_32,
+                                   USER_DATA_SEGMENT_LIMIT_32,
+                                   GDT_TYPE_WRITABLE |
+                                   GDT_TYPE_GROW_DOWN,
+                                   GDT_FLAG_GRANULARITY_4K |
+                                   GDT_FLAG_32_BIT_SEGMENT |
+                                   GDT_FLAG_PL3 |
+                                   GDT_FLAG_SEGMENT_PRESENT |
+                                   GDT_FLAG_DATA_TYPE)
+};
+/** @brief Kernel GDT structure */
+static const gdt_ptr_t cpu_gdt_ptr __attribute__((aligned(8))) = {
+    .size = (sizeof(uint64_t) * GDT_ENTRY_COUNT) - 1,
+    .base = (uintptr_t)cpu_gdt
+};
+
+/** @brief Kernel IDT structure */
+static const idt_ptr_t cpu_idt_ptr __attribute__((aligned(8))) = {
+    .size = (sizeof(cpu_idt_entry_t) * IDT_ENTRY_COUNT) - 1,
+    .base = (uintptr_t)cpu_idt
+};
+
+/** @brief CPU TSS structures */
+static cpu_tss_entry_t cpu_tss[MAX_CPU_COUNT] __attribute__((aligned(8)));
+
+/** @brief Features supported by the CPU, one bit per CPU_FEATURE_E value,
+ * detected by the BSP.
  */
-extern void interrupt_handler_89(void);
-/**
- * @brief Assembly interrupt handler for line 90.
- * Saves the context and calls the generic interrupt handler
+static uint32_t cpu_features;
+
+/** @brief State components enabled in XCR0 and saved by XSAVE. */
+static uint64_t cpu_fpu_xcr0;
+
+/** @brief Clean FPU state captured at boot, given to the threads on their
+ * first FPU use.
  */
-extern void interrupt_handler_90(void);
-/**
- * @brief Assembly interrupt handler for line 91.
- * Saves the context and calls the generic interrupt handler
+static uint8_t cpu_fpu_init_state[CPU_FPU_STATE_SIZE]
+    __attribute__((aligned(CPU_FPU_STATE_ALIGN)));
+
+/** @brief Tells if the TLB entries are tagged with PCIDs, detected by the
+ * BSP.
  */
-extern void interrupt_handler_91(void);
-/**
- * @brief Assembly interrupt handler for line 92.
- * Saves the context and calls the generic interrupt handler
+static bool_t cpu_pcid_enabled;
+
+/** @brief Tells if the PAT provides the write-combining type, detected by the
+ * BSP.
  */
-extern void interrupt_handler_92(void);
+static bool_t cpu_pat_enabled;
+
+/** @brief Number of CPUs that completed their initialization. */
+static volatile uint32_t cpu_ready_count;
+
+/** @brief Routine called by the APs once initialized. */
+static void (*cpu_ap_main)(const uint32_t cpu_id);
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
 /**
- * @brief Assembly interrupt handler for line 93.
- * Saves the context and calls the generic interrupt handler
+ * @brief Setups the kernel's GDT in memory and loads it in the GDT register.
+ *
+ * @details Setups a GDT for the kernel. The segments entries are built at
+ * compile time, fills the TSS entries and load the new GDT in the CPU's GDT
+ * register.
+ * Once done, the function sets the segment registers (CS, DS, ES, FS, GS, SS)
+ * of the CPU according to the kernel's settings.
  */
-extern void interrupt_handler_93(void);
+static void _cpu_setup_gdt(void);
+
 /**
- * @brief Assembly interrupt handler for line 94.
- * Saves the context and calls the generic interrupt handler
+ * @brief Loads the generic kernel's IDT in the IDT register.
+ *
+ * @details Loads the kernel's IDT, built at link time from the interrupt
+ * handlers base address. All the interrupt lines are redirected to the
+ * kernel's generic interrupt handler.
  */
-extern void interrupt_handler_94(void);
+static void _cpu_setup_idt(void);
+
 /**
- * @brief Assembly interrupt handler for line 95.
- * Saves the context and calls the generic interrupt handler
+ *  @brief Setups the main CPU TSS for the kernel.
+ *
+ * @details Initializes the main CPU's TSS with kernel settings in memory and
+ * loads it in the TSS register.
  */
-extern void interrupt_handler_95(void);
+static void _cpu_setup_tss(void);
+
 /**
- * @brief Assembly interrupt handler for line 96.
- * Saves the context and calls the generic interrupt handler
+ * @brief Detects the CPU features.
+ *
+ * @details Fills the features registry with the CPUID flags of the BSP. The
+ * APs are expected to support the same features.
  */
-extern void interrupt_handler_96(void);
+static void _cpu_detect_features(void);
+
 /**
- * @brief Assembly interrupt handler for line 97.
- * Saves the context and calls the generic interrupt handler
+ * @brief Applies the alternatives of the supported features.
+ *
+ * @details Patches the alternative sites of the supported features into a
+ * jump to their feature specific code. The kernel code is write protected,
+ * the protection is disabled while patching. The BSP must be the only
+ * running CPU and the interrupts must be disabled.
  */
-extern void interrupt_handler_97(void);
+static void _cpu_apply_alternatives(void);
+
 /**
- * @brief Assembly interrupt handler for line 98.
- * Saves the context and calls the generic interrupt handler
+ * @brief Detects the FPU state save method.
+ *
+ * @details Detects the FPU state save method supported by the CPU. XSAVE is
+ * used when the CPU supports it, with XSAVEOPT when available, and FXSAVE
+ * otherwise. The AVX state is enabled when the CPU supports it and its state
+ * fits in CPU_FPU_STATE_SIZE bytes.
  */
-extern void interrupt_handler_98(void);
+static void _cpu_detect_fpu(void);
+
 /**
- * @brief Assembly interrupt handler for line 99.
- * Saves the context and calls the generic interrupt handler
+ * @brief Setups the FPU of the current CPU.
+ *
+ * @details Enables the FPU, SSE and the detected extended states on the
+ * current CPU and resets the FPU. The FPU is left enabled, the scheduler
+ * sets the task switched flag on the first context switch.
  */
-extern void interrupt_handler_99(void);
+static void _cpu_setup_fpu(void);
+
 /**
- * @brief Assembly interrupt handler for line 100.
- * Saves the context and calls the generic interrupt handler
+ * @brief Detects the PCIDs support.
+ *
+ * @details Detects the PCIDs support. The PCIDs are only used when the CPU
+ * also supports INVPCID, without it the TLB entries of a PCID can only be
+ * invalidated while it is loaded.
  */
-extern void interrupt_handler_100(void);
+static void _cpu_detect_pcid(void);
+
 /**
- * @brief Assembly interrupt handler for line 101.
- * Saves the context and calls the generic interrupt handler
+ * @brief Enables the PCIDs on the current CPU.
+ *
+ * @details Enables the PCIDs on the current CPU when they were detected. The
+ * current root paging structure must be loaded with the PCID 0.
  */
-extern void interrupt_handler_101(void);
+static void _cpu_setup_pcid(void);
+
 /**
- * @brief Assembly interrupt handler for line 102.
- * Saves the context and calls the generic interrupt handler
+ * @brief Enables the SYSCALL and SYSRET instructions on the current CPU.
+ *
+ * @details Enables the SYSCALL and SYSRET instructions on the current CPU and
+ * programs their entry point and segments. SYSRET returns to the user 32 bits
+ * code segment + 16, the user 64 bits code segment, with the user 32 bits
+ * code segment + 8 as stack segment, a flat user data segment. The user GS
+ * base is cleared, the kernel's one is exchanged with it by swapgs on each
+ * entry from and exit to the user space.
  */
-extern void interrupt_handler_102(void);
+static void _cpu_setup_syscall(void);
+
 /**
- * @brief Assembly interrupt handler for line 103.
- * Saves the context and calls the generic interrupt handler
+ * @brief Programs the PAT of the current CPU.
+ *
+ * @details Programs the PAT of the current CPU with CPU_MSR_PAT_VALUE when
+ * it was detected. The entry 1 becomes write-combining, no mapping selects it
+ * before the PAT is programmed on all the CPUs.
  */
-extern void interrupt_handler_103(void);
+static void _cpu_setup_pat(void);
+
 /**
- * @brief Assembly interrupt handler for line 104.
- * Saves the context and calls the generic interrupt handler
+ * @brief Sends an inter processor interrupt command.
+ *
+ * @details Sends an inter processor interrupt command through the LAPIC and
+ * waits for its delivery. In x2APIC mode, the command is written in the
+ * interrupt command register MSR, which has no delivery status.
+ *
+ * @param[in] apic_id The LAPIC identifier of the destination, ignored when
+ * the command uses a destination shorthand.
+ * @param[in] command The command to write in the low part of the LAPIC
+ * interrupt command register.
  */
-extern void interrupt_handler_104(void);
-/**
- * @brief Assembly interrupt handler for line 105.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_105(void);
-/**
- * @brief Assembly interrupt handler for line 106.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_106(void);
-/**
- * @brief Assembly interrupt handler for line 107.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_107(void);
-/**
- * @brief Assembly interrupt handler for line 108.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_108(void);
-/**
- * @brief Assembly interrupt handler for line 109.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_109(void);
-/**
- * @brief Assembly interrupt handler for line 110.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_110(void);
-/**
- * @brief Assembly interrupt handler for line 111.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_111(void);
-/**
- * @brief Assembly interrupt handler for line 112.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_112(void);
-/**
- * @brief Assembly interrupt handler for line 113.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_113(void);
-/**
- * @brief Assembly interrupt handler for line 114.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_114(void);
-/**
- * @brief Assembly interrupt handler for line 115.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_115(void);
-/**
- * @brief Assembly interrupt handler for line 116.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_116(void);
-/**
- * @brief Assembly interrupt handler for line 117.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_117(void);
-/**
- * @brief Assembly interrupt handler for line 118.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_118(void);
-/**
- * @brief Assembly interrupt handler for line 119.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_119(void);
-/**
- * @brief Assembly interrupt handler for line 120.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_120(void);
-/**
- * @brief Assembly interrupt handler for line 121.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_121(void);
-/**
- * @brief Assembly interrupt handler for line 122.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_122(void);
-/**
- * @brief Assembly interrupt handler for line 123.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_123(void);
-/**
- * @brief Assembly interrupt handler for line 124.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_124(void);
-/**
- * @brief Assembly interrupt handler for line 125.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_125(void);
-/**
- * @brief Assembly interrupt handler for line 126.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_126(void);
-/**
- * @brief Assembly interrupt handler for line 127.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_127(void);
-/**
- * @brief Assembly interrupt handler for line 128.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_128(void);
-/**
- * @brief Assembly interrupt handler for line 129.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_129(void);
-/**
- * @brief Assembly interrupt handler for line 130.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_130(void);
-/**
- * @brief Assembly interrupt handler for line 131.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_131(void);
-/**
- * @brief Assembly interrupt handler for line 132.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_132(void);
-/**
- * @brief Assembly interrupt handler for line 133.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_133(void);
-/**
- * @brief Assembly interrupt handler for line 134.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_134(void);
-/**
- * @brief Assembly interrupt handler for line 135.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_135(void);
-/**
- * @brief Assembly interrupt handler for line 136.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_136(void);
-/**
- * @brief Assembly interrupt handler for line 137.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_137(void);
-/**
- * @brief Assembly interrupt handler for line 138.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_138(void);
-/**
- * @brief Assembly interrupt handler for line 139.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_139(void);
-/**
- * @brief Assembly interrupt handler for line 140.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_140(void);
-/**
- * @brief Assembly interrupt handler for line 141.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_141(void);
-/**
- * @brief Assembly interrupt handler for line 142.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_142(void);
-/**
- * @brief Assembly interrupt handler for line 143.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_143(void);
-/**
- * @brief Assembly interrupt handler for line 144.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_144(void);
-/**
- * @brief Assembly interrupt handler for line 145.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_145(void);
-/**
- * @brief Assembly interrupt handler for line 146.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_146(void);
-/**
- * @brief Assembly interrupt handler for line 147.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_147(void);
-/**
- * @brief Assembly interrupt handler for line 148.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_148(void);
-/**
- * @brief Assembly interrupt handler for line 149.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_149(void);
-/**
- * @brief Assembly interrupt handler for line 150.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_150(void);
-/**
- * @brief Assembly interrupt handler for line 151.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_151(void);
-/**
- * @brief Assembly interrupt handler for line 152.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_152(void);
-/**
- * @brief Assembly interrupt handler for line 153.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_153(void);
-/**
- * @brief Assembly interrupt handler for line 154.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_154(void);
-/**
- * @brief Assembly interrupt handler for line 155.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_155(void);
-/**
- * @brief Assembly interrupt handler for line 156.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_156(void);
-/**
- * @brief Assembly interrupt handler for line 157.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_157(void);
-/**
- * @brief Assembly interrupt handler for line 158.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_158(void);
-/**
- * @brief Assembly interrupt handler for line 159.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_159(void);
-/**
- * @brief Assembly interrupt handler for line 160.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_160(void);
-/**
- * @brief Assembly interrupt handler for line 161.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_161(void);
-/**
- * @brief Assembly interrupt handler for line 162.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_162(void);
-/**
- * @brief Assembly interrupt handler for line 163.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_163(void);
-/**
- * @brief Assembly interrupt handler for line 164.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_164(void);
-/**
- * @brief Assembly interrupt handler for line 165.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_165(void);
-/**
- * @brief Assembly interrupt handler for line 166.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_166(void);
-/**
- * @brief Assembly interrupt handler for line 167.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_167(void);
-/**
- * @brief Assembly interrupt handler for line 168.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_168(void);
-/**
- * @brief Assembly interrupt handler for line 169.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_169(void);
-/**
- * @brief Assembly interrupt handler for line 170.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_170(void);
-/**
- * @brief Assembly interrupt handler for line 171.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_171(void);
-/**
- * @brief Assembly interrupt handler for line 172.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_172(void);
-/**
- * @brief Assembly interrupt handler for line 173.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_173(void);
-/**
- * @brief Assembly interrupt handler for line 174.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_174(void);
-/**
- * @brief Assembly interrupt handler for line 175.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_175(void);
-/**
- * @brief Assembly interrupt handler for line 176.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_176(void);
-/**
- * @brief Assembly interrupt handler for line 177.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_177(void);
-/**
- * @brief Assembly interrupt handler for line 178.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_178(void);
-/**
- * @brief Assembly interrupt handler for line 179.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_179(void);
-/**
- * @brief Assembly interrupt handler for line 180.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_180(void);
-/**
- * @brief Assembly interrupt handler for line 181.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_181(void);
-/**
- * @brief Assembly interrupt handler for line 182.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_182(void);
-/**
- * @brief Assembly interrupt handler for line 183.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_183(void);
-/**
- * @brief Assembly interrupt handler for line 184.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_184(void);
-/**
- * @brief Assembly interrupt handler for line 185.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_185(void);
-/**
- * @brief Assembly interrupt handler for line 186.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_186(void);
-/**
- * @brief Assembly interrupt handler for line 187.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_187(void);
-/**
- * @brief Assembly interrupt handler for line 188.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_188(void);
-/**
- * @brief Assembly interrupt handler for line 189.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_189(void);
-/**
- * @brief Assembly interrupt handler for line 190.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_190(void);
-/**
- * @brief Assembly interrupt handler for line 191.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_191(void);
-/**
- * @brief Assembly interrupt handler for line 192.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_192(void);
-/**
- * @brief Assembly interrupt handler for line 193.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_193(void);
-/**
- * @brief Assembly interrupt handler for line 194.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_194(void);
-/**
- * @brief Assembly interrupt handler for line 195.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_195(void);
-/**
- * @brief Assembly interrupt handler for line 196.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_196(void);
-/**
- * @brief Assembly interrupt handler for line 197.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_197(void);
-/**
- * @brief Assembly interrupt handler for line 198.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_198(void);
-/**
- * @brief Assembly interrupt handler for line 199.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_199(void);
-/**
- * @brief Assembly interrupt handler for line 200.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_200(void);
-/**
- * @brief Assembly interrupt handler for line 201.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_201(void);
-/**
- * @brief Assembly interrupt handler for line 202.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_202(void);
-/**
- * @brief Assembly interrupt handler for line 203.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_203(void);
-/**
- * @brief Assembly interrupt handler for line 204.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_204(void);
-/**
- * @brief Assembly interrupt handler for line 205.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_205(void);
-/**
- * @brief Assembly interrupt handler for line 206.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_206(void);
-/**
- * @brief Assembly interrupt handler for line 207.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_207(void);
-/**
- * @brief Assembly interrupt handler for line 208.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_208(void);
-/**
- * @brief Assembly interrupt handler for line 209.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_209(void);
-/**
- * @brief Assembly interrupt handler for line 210.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_210(void);
-/**
- * @brief Assembly interrupt handler for line 211.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_211(void);
-/**
- * @brief Assembly interrupt handler for line 212.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_212(void);
-/**
- * @brief Assembly interrupt handler for line 213.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_213(void);
-/**
- * @brief Assembly interrupt handler for line 214.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_214(void);
-/**
- * @brief Assembly interrupt handler for line 215.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_215(void);
-/**
- * @brief Assembly interrupt handler for line 216.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_216(void);
-/**
- * @brief Assembly interrupt handler for line 217.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_217(void);
-/**
- * @brief Assembly interrupt handler for line 218.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_218(void);
-/**
- * @brief Assembly interrupt handler for line 219.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_219(void);
-/**
- * @brief Assembly interrupt handler for line 220.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_220(void);
-/**
- * @brief Assembly interrupt handler for line 221.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_221(void);
-/**
- * @brief Assembly interrupt handler for line 222.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_222(void);
-/**
- * @brief Assembly interrupt handler for line 223.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_223(void);
-/**
- * @brief Assembly interrupt handler for line 224.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_224(void);
-/**
- * @brief Assembly interrupt handler for line 225.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_225(void);
-/**
- * @brief Assembly interrupt handler for line 226.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_226(void);
-/**
- * @brief Assembly interrupt handler for line 227.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_227(void);
-/**
- * @brief Assembly interrupt handler for line 228.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_228(void);
-/**
- * @brief Assembly interrupt handler for line 229.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_229(void);
-/**
- * @brief Assembly interrupt handler for line 230.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_230(void);
-/**
- * @brief Assembly interrupt handler for line 231.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_231(void);
-/**
- * @brief Assembly interrupt handler for line 232.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_232(void);
-/**
- * @brief Assembly interrupt handler for line 233.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_233(void);
-/**
- * @brief Assembly interrupt handler for line 234.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_234(void);
-/**
- * @brief Assembly interrupt handler for line 235.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_235(void);
-/**
- * @brief Assembly interrupt handler for line 236.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_236(void);
-/**
- * @brief Assembly interrupt handler for line 237.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_237(void);
-/**
- * @brief Assembly interrupt handler for line 238.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_238(void);
-/**
- * @brief Assembly interrupt handler for line 239.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_239(void);
-/**
- * @brief Assembly interrupt handler for line 240.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_240(void);
-/**
- * @brief Assembly interrupt handler for line 241.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_241(void);
-/**
- * @brief Assembly interrupt handler for line 242.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_242(void);
-/**
- * @brief Assembly interrupt handler for line 243.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_243(void);
-/**
- * @brief Assembly interrupt handler for line 244.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_244(void);
-/**
- * @brief Assembly interrupt handler for line 245.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_245(void);
-/**
- * @brief Assembly interrupt handler for line 246.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_246(void);
-/**
- * @brief Assembly interrupt handler for line 247.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_247(void);
-/**
- * @brief Assembly interrupt handler for line 248.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_248(void);
-/**
- * @brief Assembly interrupt handler for line 249.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_249(void);
-/**
- * @brief Assembly interrupt handler for line 250.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_250(void);
-/**
- * @brief Assembly interrupt handler for line 251.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_251(void);
-/**
- * @brief Assembly interrupt handler for line 252.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_252(void);
-/**
- * @brief Assembly interrupt handler for line 253.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_253(void);
-/**
- * @brief Assembly interrupt handler for line 254.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_254(void);
-/**
- * @brief Assembly interrupt handler for line 255.
- * Saves the context and calls the generic interrupt handler
- */
-extern void interrupt_handler_255(void);
-
-/************************* Exported global variables **************************/
-/* None */
-
-/************************** Static global variables ***************************/
-/** @brief CPU GDT space in memory. */
-static uint64_t cpu_gdt[GDT_ENTRY_COUNT] __attribute__((aligned(8)));
-/** @brief Kernel GDT structure */
-static gdt_ptr_t cpu_gdt_ptr __attribute__((aligned(8)));
-
-/** @brief CPU IDT space in memory. */
-static cpu_idt_entry_t cpu_idt[IDT_ENTRY_COUNT] __attribute__((aligned(8)));
-/** @brief Kernel IDT structure */
-static idt_ptr_t cpu_idt_ptr __attribute__((aligned(8)));
-
-/** @brief CPU TSS structures */
-static cpu_tss_entry_t cpu_tss[MAX_CPU_COUNT] __attribute__((aligned(8)));
-
-/** @brief Stores the CPU interrupt handlers entry point */
-static uintptr_t cpu_int_handlers[IDT_ENTRY_COUNT] = {
-    (uintptr_t)interrupt_handler_0,
-    (uintptr_t)interrupt_handler_1,
-    (uintptr_t)interrupt_handler_2,
-    (uintptr_t)interrupt_handler_3,
-    (uintptr_t)interrupt_handler_4,
-    (uintptr_t)interrupt_handler_5,
-    (uintptr_t)interrupt_handler_6,
-    (uintptr_t)interrupt_handler_7,
-    (uintptr_t)interrupt_handler_8,
-    (uintptr_t)interrupt_handler_9,
-    (uintptr_t)interrupt_handler_10,
-    (uintptr_t)interrupt_handler_11,
-    (uintptr_t)interrupt_handler_12,
-    (uintptr_t)interrupt_handler_13,
-    (uintptr_t)interrupt_handler_14,
-    (uintptr_t)interrupt_handler_15,
-    (uintptr_t)interrupt_handler_16,
-    (uintptr_t)interrupt_handler_17,
-    (uintptr_t)interrupt_handler_18,
-    (uintptr_t)interrupt_handler_19,
-    (uintptr_t)interrupt_handler_20,
-    (uintptr_t)interrupt_handler_21,
-    (uintptr_t)interrupt_handler_22,
-    (uintptr_t)interrupt_handler_23,
-    (uintptr_t)interrupt_handler_24,
-    (uintptr_t)interrupt_handler_25,
-    (uintptr_t)interrupt_handler_26,
-    (uintptr_t)interrupt_handler_27,
-    (uintptr_t)interrupt_handler_28,
-    (uintptr_t)interrupt_handler_29,
-    (uintptr_t)interrupt_handler_30,
-    (uintptr_t)interrupt_handler_31,
-    (uintptr_t)interrupt_handler_32,
-    (uintptr_t)interrupt_handler_33,
-    (uintptr_t)interrupt_handler_34,
-    (uintptr_t)interrupt_handler_35,
-    (uintptr_t)interrupt_handler_36,
-    (uintptr_t)interrupt_handler_37,
-    (uintptr_t)interrupt_handler_38,
-    (uintptr_t)interrupt_handler_39,
-    (uintptr_t)interrupt_handler_40,
-    (uintptr_t)interrupt_handler_41,
-    (uintptr_t)interrupt_handler_42,
-    (uintptr_t)interrupt_handler_43,
-    (uintptr_t)interrupt_handler_44,
-    (uintptr_t)interrupt_handler_45,
-    (uintptr_t)interrupt_handler_46,
-    (uintptr_t)interrupt_handler_47,
-    (uintptr_t)interrupt_handler_48,
-    (uintptr_t)interrupt_handler_49,
-    (uintptr_t)interrupt_handler_50,
-    (uintptr_t)interrupt_handler_51,
-    (uintptr_t)interrupt_handler_52,
-    (uintptr_t)interrupt_handler_53,
-    (uintptr_t)interrupt_handler_54,
-    (uintptr_t)interrupt_handler_55,
-    (uintptr_t)interrupt_handler_56,
-    (uintptr_t)interrupt_handler_57,
-    (uintptr_t)interrupt_handler_58,
-    (uintptr_t)interrupt_handler_59,
-    (uintptr_t)interrupt_handler_60,
-    (uintptr_t)interrupt_handler_61,
-    (uintptr_t)interrupt_handler_62,
-    (uintptr_t)interrupt_handler_63,
-    (uintptr_t)interrupt_handler_64,
-    (uintptr_t)interrupt_handler_65,
-    (uintptr_t)interrupt_handler_66,
-    (uintptr_t)interrupt_handler_67,
-    (uintptr_t)interrupt_handler_68,
-    (uintptr_t)interrupt_handler_69,
-    (uintptr_t)interrupt_handler_70,
-    (uintptr_t)interrupt_handler_71,
-    (uintptr_t)interrupt_handler_72,
-    (uintptr_t)interrupt_handler_73,
-    (uintptr_t)interrupt_handler_74,
-    (uintptr_t)interrupt_handler_75,
-    (uintptr_t)interrupt_handler_76,
-    (uintptr_t)interrupt_handler_77,
-    (uintptr_t)interrupt_handler_78,
-    (uintptr_t)interrupt_handler_79,
-    (uintptr_t)interrupt_handler_80,
-    (uintptr_t)interrupt_handler_81,
-    (uintptr_t)interrupt_handler_82,
-    (uintptr_t)interrupt_handler_83,
-    (uintptr_t)interrupt_handler_84,
-    (uintptr_t)interrupt_handler_85,
-    (uintptr_t)interrupt_handler_86,
-    (uintptr_t)interrupt_handler_87,
-    (uintptr_t)interrupt_handler_88,
-    (uintptr_t)interrupt_handler_89,
-    (uintptr_t)interrupt_handler_90,
-    (uintptr_t)interrupt_handler_91,
-    (uintptr_t)interrupt_handler_92,
-    (uintptr_t)interrupt_handler_93,
-    (uintptr_t)interrupt_handler_94,
-    (uintptr_t)interrupt_handler_95,
-    (uintptr_t)interrupt_handler_96,
-    (uintptr_t)interrupt_handler_97,
-    (uintptr_t)interrupt_handler_98,
-    (uintptr_t)interrupt_handler_99,
-    (uintptr_t)interrupt_handler_100,
-    (uintptr_t)interrupt_handler_101,
-    (uintptr_t)interrupt_handler_102,
-    (uintptr_t)interrupt_handler_103,
-    (uintptr_t)interrupt_handler_104,
-    (uintptr_t)interrupt_handler_105,
-    (uintptr_t)interrupt_handler_106,
-    (uintptr_t)interrupt_handler_107,
-    (uintptr_t)interrupt_handler_108,
-    (uintptr_t)interrupt_handler_109,
-    (uintptr_t)interrupt_handler_110,
-    (uintptr_t)interrupt_handler_111,
-    (uintptr_t)interrupt_handler_112,
-    (uintptr_t)interrupt_handler_113,
-    (uintptr_t)interrupt_handler_114,
-    (uintptr_t)interrupt_handler_115,
-    (uintptr_t)interrupt_handler_116,
-    (uintptr_t)interrupt_handler_117,
-    (uintptr_t)interrupt_handler_118,
-    (uintptr_t)interrupt_handler_119,
-    (uintptr_t)interrupt_handler_120,
-    (uintptr_t)interrupt_handler_121,
-    (uintptr_t)interrupt_handler_122,
-    (uintptr_t)interrupt_handler_123,
-    (uintptr_t)interrupt_handler_124,
-    (uintptr_t)interrupt_handler_125,
-    (uintptr_t)interrupt_handler_126,
-    (uintptr_t)interrupt_handler_127,
-    (uintptr_t)interrupt_handler_128,
-    (uintptr_t)interrupt_handler_129,
-    (uintptr_t)interrupt_handler_130,
-    (uintptr_t)interrupt_handler_131,
-    (uintptr_t)interrupt_handler_132,
-    (uintptr_t)interrupt_handler_133,
-    (uintptr_t)interrupt_handler_134,
-    (uintptr_t)interrupt_handler_135,
-    (uintptr_t)interrupt_handler_136,
-    (uintptr_t)interrupt_handler_137,
-    (uintptr_t)interrupt_handler_138,
-    (uintptr_t)interrupt_handler_139,
-    (uintptr_t)interrupt_handler_140,
-    (uintptr_t)interrupt_handler_141,
-    (uintptr_t)interrupt_handler_142,
-    (uintptr_t)interrupt_handler_143,
-    (uintptr_t)interrupt_handler_144,
-    (uintptr_t)interrupt_handler_145,
-    (uintptr_t)interrupt_handler_146,
-    (uintptr_t)interrupt_handler_147,
-    (uintptr_t)interrupt_handler_148,
-    (uintptr_t)interrupt_handler_149,
-    (uintptr_t)interrupt_handler_150,
-    (uintptr_t)interrupt_handler_151,
-    (uintptr_t)interrupt_handler_152,
-    (uintptr_t)interrupt_handler_153,
-    (uintptr_t)interrupt_handler_154,
-    (uintptr_t)interrupt_handler_155,
-    (uintptr_t)interrupt_handler_156,
-    (uintptr_t)interrupt_handler_157,
-    (uintptr_t)interrupt_handler_158,
-    (uintptr_t)interrupt_handler_159,
-    (uintptr_t)interrupt_handler_160,
-    (uintptr_t)interrupt_handler_161,
-    (uintptr_t)interrupt_handler_162,
-    (uintptr_t)interrupt_handler_163,
-    (uintptr_t)interrupt_handler_164,
-    (uintptr_t)interrupt_handler_165,
-    (uintptr_t)interrupt_handler_166,
-    (uintptr_t)interrupt_handler_167,
-    (uintptr_t)interrupt_handler_168,
-    (uintptr_t)interrupt_handler_169,
-    (uintptr_t)interrupt_handler_170,
-    (uintptr_t)interrupt_handler_171,
-    (uintptr_t)interrupt_handler_172,
-    (uintptr_t)interrupt_handler_173,
-    (uintptr_t)interrupt_handler_174,
-    (uintptr_t)interrupt_handler_175,
-    (uintptr_t)interrupt_handler_176,
-    (uintptr_t)interrupt_handler_177,
-    (uintptr_t)interrupt_handler_178,
-    (uintptr_t)interrupt_handler_179,
-    (uintptr_t)interrupt_handler_180,
-    (uintptr_t)interrupt_handler_181,
-    (uintptr_t)interrupt_handler_182,
-    (uintptr_t)interrupt_handler_183,
-    (uintptr_t)interrupt_handler_184,
-    (uintptr_t)interrupt_handler_185,
-    (uintptr_t)interrupt_handler_186,
-    (uintptr_t)interrupt_handler_187,
-    (uintptr_t)interrupt_handler_188,
-    (uintptr_t)interrupt_handler_189,
-    (uintptr_t)interrupt_handler_190,
-    (uintptr_t)interrupt_handler_191,
-    (uintptr_t)interrupt_handler_192,
-    (uintptr_t)interrupt_handler_193,
-    (uintptr_t)interrupt_handler_194,
-    (uintptr_t)interrupt_handler_195,
-    (uintptr_t)interrupt_handler_196,
-    (uintptr_t)interrupt_handler_197,
-    (uintptr_t)interrupt_handler_198,
-    (uintptr_t)interrupt_handler_199,
-    (uintptr_t)interrupt_handler_200,
-    (uintptr_t)interrupt_handler_201,
-    (uintptr_t)interrupt_handler_202,
-    (uintptr_t)interrupt_handler_203,
-    (uintptr_t)interrupt_handler_204,
-    (uintptr_t)interrupt_handler_205,
-    (uintptr_t)interrupt_handler_206,
-    (uintptr_t)interrupt_handler_207,
-    (uintptr_t)interrupt_handler_208,
-    (uintptr_t)interrupt_handler_209,
-    (uintptr_t)interrupt_handler_210,
-    (uintptr_t)interrupt_handler_211,
-    (uintptr_t)interrupt_handler_212,
-    (uintptr_t)interrupt_handler_213,
-    (uintptr_t)interrupt_handler_214,
-    (uintptr_t)interrupt_handler_215,
-    (uintptr_t)interrupt_handler_216,
-    (uintptr_t)interrupt_handler_217,
-    (uintptr_t)interrupt_handler_218,
-    (uintptr_t)interrupt_handler_219,
-    (uintptr_t)interrupt_handler_220,
-    (uintptr_t)interrupt_handler_221,
-    (uintptr_t)interrupt_handler_222,
-    (uintptr_t)interrupt_handler_223,
-    (uintptr_t)interrupt_handler_224,
-    (uintptr_t)interrupt_handler_225,
-    (uintptr_t)interrupt_handler_226,
-    (uintptr_t)interrupt_handler_227,
-    (uintptr_t)interrupt_handler_228,
-    (uintptr_t)interrupt_handler_229,
-    (uintptr_t)interrupt_handler_230,
-    (uintptr_t)interrupt_handler_231,
-    (uintptr_t)interrupt_handler_232,
-    (uintptr_t)interrupt_handler_233,
-    (uintptr_t)interrupt_handler_234,
-    (uintptr_t)interrupt_handler_235,
-    (uintptr_t)interrupt_handler_236,
-    (uintptr_t)interrupt_handler_237,
-    (uintptr_t)interrupt_handler_238,
-    (uintptr_t)interrupt_handler_239,
-    (uintptr_t)interrupt_handler_240,
-    (uintptr_t)interrupt_handler_241,
-    (uintptr_t)interrupt_handler_242,
-    (uintptr_t)interrupt_handler_243,
-    (uintptr_t)interrupt_handler_244,
-    (uintptr_t)interrupt_handler_245,
-    (uintptr_t)interrupt_handler_246,
-    (uintptr_t)interrupt_handler_247,
-    (uintptr_t)interrupt_handler_248,
-    (uintptr_t)interrupt_handler_249,
-    (uintptr_t)interrupt_handler_250,
-    (uintptr_t)interrupt_handler_251,
-    (uintptr_t)interrupt_handler_252,
-    (uintptr_t)interrupt_handler_253,
-    (uintptr_t)interrupt_handler_254,
-    (uintptr_t)interrupt_handler_255
-};
-
-/*******************************************************************************
- * STATIC FUNCTIONS DECLARATIONS
- ******************************************************************************/
-
-/**
- * @brief Setups the kernel's GDT in memory and loads it in the GDT register.
- *
- * @details Setups a GDT for the kernel. Fills the entries in the GDT table and
- * load the new GDT in the CPU's GDT register.
- * Once done, the function sets the segment registers (CS, DS, ES, FS, GS, SS)
- * of the CPU according to the kernel's settings.
- */
-static void _cpu_setup_gdt(void);
-
-/**
- * @brief Setups the generic kernel's IDT in memory and loads it in the IDT
- * register.
- *
- * @details Setups a simple IDT for the kernel. Fills the entries in the IDT
- * table by adding basic support to the x86 exception (interrutps 0 to 32).
- * The rest of the interrupts are not set.
- */
-static void _cpu_setup_idt(void);
-
-/**
- *  @brief Setups the main CPU TSS for the kernel.
- *
- * @details Initializes the main CPU's TSS with kernel settings in memory and
- * loads it in the TSS register.
- */
-static void _cpu_setup_tss(void);
-
+static void _cpu_send_ipi(const uint32_t apic_id, const uint32_t command);
+
 /**
  * @brief Formats a GDT entry.
  *
@@ -1891,25 +841,10 @@ static void _cpu_setup_tss(void);
  * @param[in] base  The base address of the segment for the GDT entry.
  * @param[in] limit The limit address of the segment for the GDT entry.
  * @param[in] type  The type of segment for the GDT entry.
- * @param[in] flags The flags to be set for the GDT entry.
- */
-static void _format_gdt_entry(uint64_t* entry,
-                              const uint32_t base, const uint32_t limit,
-                              const uint8_t type, const uint32_t flags);
-
-/**
- * @brief Formats an IDT entry.
- *
- * @details Formats data given as parameter into a standard IDT entry.
- * The result is directly written in the memory pointed by the entry parameter.
- *
- * @param[out] entry The pointer to the entry structure to format.
- * @param[in] handler The handler function for the IDT entry.
- * @param[in] type  The type of segment for the IDT entry.
- * @param[in] flags The flags to be set for the IDT entry.
+ * @param[in] flags The flags to be set for the GDT entry.
  */
-static void _format_idt_entry(cpu_idt_entry_t* entry,
-                              const uintptr_t handler,
+static void _format_gdt_entry(uint64_t* entry,
+                              const uint32_t base, const uint32_t limit,
                               const uint8_t type, const uint32_t flags);
 
 /*******************************************************************************
@@ -1955,24 +890,6 @@ static void _format_gdt_entry(uint64_t* entry,
     *entry = lo_part | (((uint64_t) hi_part) << 32);
 }
 
-static void _format_idt_entry(cpu_idt_entry_t* entry,
-                              const uintptr_t handler,
-                              const uint8_t type, const uint32_t flags)
-{
-    /* Set offset */
-    entry->off_low   = handler & 0x000000000000FFFF;
-    entry->off_mid   = (handler >> 16) & 0x000000000000FFFF;
-    entry->off_hig   = (handler >> 32) & 0x00000000FFFFFFFF;
-
-    /* Set selector and flags */
-    entry->c_sel     = KERNEL_CS_64;
-    entry->flags     = (flags & 0xF0) | (type & 0x0F);
-
-    /* Zeroise */
-    entry->ist       = 0;
-    entry->reserved1 = 0;
-}
-
 static void _cpu_setup_gdt(void)
 {
     uint32_t i;
@@ -1980,181 +897,33 @@ static void _cpu_setup_gdt(void)
     KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_SET_GDT_START, 0);
     KERNEL_DEBUG(CPU_DEBUG_ENABLED, MODULE_NAME, "Setting GDT");
 
-    /************************************
-     * KERNEL GDT ENTRIES
-     ***********************************/
-
-    /* Set the kernel 64 bits code descriptor */
-    uint32_t kernel_code_64_seg_flags = GDT_FLAG_64_BIT_SEGMENT |
-                                        GDT_FLAG_PL0 |
-                                        GDT_FLAG_SEGMENT_PRESENT |
-                                        GDT_FLAG_CODE_TYPE;
-
-    uint32_t kernel_code_64_seg_type =  GDT_TYPE_EXECUTABLE |
-                                        GDT_TYPE_READABLE |
-                                        GDT_TYPE_PROTECTED;
-
-    /* Set the kernel 64 bits data descriptor */
-    uint32_t kernel_data_64_seg_flags = GDT_FLAG_64_BIT_SEGMENT |
-                                        GDT_FLAG_PL0 |
-                                        GDT_FLAG_SEGMENT_PRESENT |
-                                        GDT_FLAG_DATA_TYPE;
-
-    uint32_t kernel_data_64_seg_type =  GDT_TYPE_WRITABLE |
-                                        GDT_TYPE_GROW_DOWN;
-
-    /* Set the kernel code descriptor */
-    uint32_t kernel_code_32_seg_flags = GDT_FLAG_GRANULARITY_4K |
-                                        GDT_FLAG_32_BIT_SEGMENT |
-                                        GDT_FLAG_PL0 |
-                                        GDT_FLAG_SEGMENT_PRESENT |
-                                        GDT_FLAG_CODE_TYPE;
-
-    uint32_t kernel_code_32_seg_type =  GDT_TYPE_EXECUTABLE |
-                                        GDT_TYPE_READABLE |
-                                        GDT_TYPE_PROTECTED;
-
-    /* Set the kernel data descriptor */
-    uint32_t kernel_data_32_seg_flags = GDT_FLAG_GRANULARITY_4K |
-                                        GDT_FLAG_32_BIT_SEGMENT |
-                                        GDT_FLAG_PL0 |
-                                        GDT_FLAG_SEGMENT_PRESENT |
-                                        GDT_FLAG_DATA_TYPE;
-
-    uint32_t kernel_data_32_seg_type =  GDT_TYPE_WRITABLE |
-                                        GDT_TYPE_GROW_DOWN;
-
-    /* Set the kernel 16 bits code descriptor */
-    uint32_t kernel_code_16_seg_flags = GDT_FLAG_GRANULARITY_4K |
-                                        GDT_FLAG_16_BIT_SEGMENT |
-                                        GDT_FLAG_PL0 |
-                                        GDT_FLAG_SEGMENT_PRESENT |
-                                        GDT_FLAG_CODE_TYPE;
-
-    uint32_t kernel_code_16_seg_type =  GDT_TYPE_EXECUTABLE |
-                                        GDT_TYPE_READABLE |
-                                        GDT_TYPE_PROTECTED;
-
-    /* Set the kernel 16 bits data descriptor */
-    uint32_t kernel_data_16_seg_flags = GDT_FLAG_GRANULARITY_4K |
-                                        GDT_FLAG_16_BIT_SEGMENT |
-                                        GDT_FLAG_PL0 |
-                                        GDT_FLAG_SEGMENT_PRESENT |
-                                        GDT_FLAG_DATA_TYPE;
-
-    uint32_t kernel_data_16_seg_type =  GDT_TYPE_WRITABLE |
-                                        GDT_TYPE_GROW_DOWN;
-
-    /* Set the user 32 bits code descriptor */
-    uint32_t user_code_32_seg_flags = GDT_FLAG_GRANULARITY_4K |
-                                      GDT_FLAG_32_BIT_SEGMENT |
-                                      GDT_FLAG_PL3 |
-                                      GDT_FLAG_SEGMENT_PRESENT |
-                                      GDT_FLAG_CODE_TYPE;
-
-    uint32_t user_code_32_seg_type =  GDT_TYPE_EXECUTABLE |
-                                      GDT_TYPE_READABLE |
-                                      GDT_TYPE_PROTECTED;
-
-    /* Set the user 32 bits data descriptor */
-    uint32_t user_data_32_seg_flags = GDT_FLAG_GRANULARITY_4K |
-                                      GDT_FLAG_32_BIT_SEGMENT |
-                                      GDT_FLAG_PL3 |
-                                      GDT_FLAG_SEGMENT_PRESENT |
-                                      GDT_FLAG_DATA_TYPE;
-
-    uint32_t user_data_32_seg_type =  GDT_TYPE_WRITABLE |
-                                      GDT_TYPE_GROW_DOWN;
-
-    /* Set the user 64 bits code descriptor */
-    uint32_t user_code_64_seg_flags = GDT_FLAG_64_BIT_SEGMENT |
-                                      GDT_FLAG_PL3 |
-                                      GDT_FLAG_SEGMENT_PRESENT |
-                                      GDT_FLAG_CODE_TYPE;
-
-    uint32_t user_code_64_seg_type =  GDT_TYPE_EXECUTABLE |
-                                      GDT_TYPE_READABLE |
-                                      GDT_TYPE_PROTECTED;
-
-    /* Set the user 64 bits data descriptor */
-    uint32_t user_data_64_seg_flags = GDT_FLAG_64_BIT_SEGMENT |
-                                      GDT_FLAG_PL3 |
-                                      GDT_FLAG_SEGMENT_PRESENT |
-                                      GDT_FLAG_DATA_TYPE;
-
-    uint32_t user_data_64_seg_type =  GDT_TYPE_WRITABLE |
-                                      GDT_TYPE_GROW_DOWN;
-
     /************************************
      * TSS ENTRY
      ***********************************/
 
-    uint32_t tss_seg_flags = GDT_FLAG_GRANULARITY_4K |
-                             GDT_FLAG_64_BIT_SEGMENT |
+    uint32_t tss_seg_flags = GDT_FLAG_GRANULARITY_BYTE |
                              GDT_FLAG_SEGMENT_PRESENT |
                              GDT_FLAG_PL0 |
-                             GDT_FLAG_TSS;
+                             GDT_FLAG_SYSTEM_TYPE;
 
     uint32_t tss_seg_type = GDT_TYPE_ACCESSED |
                             GDT_TYPE_EXECUTABLE;
 
-    /* Blank the GDT, set the NULL descriptor */
-    memset(cpu_gdt, 0, sizeof(uint64_t) * GDT_ENTRY_COUNT);
-
-    /* Load the segments */
-    _format_gdt_entry(&cpu_gdt[KERNEL_CS_64 / 8],
-                      KERNEL_CODE_SEGMENT_BASE_64, KERNEL_CODE_SEGMENT_LIMIT_64,
-                      kernel_code_64_seg_type, kernel_code_64_seg_flags);
-
-    _format_gdt_entry(&cpu_gdt[KERNEL_DS_64 / 8],
-                      KERNEL_DATA_SEGMENT_BASE_64, KERNEL_DATA_SEGMENT_LIMIT_64,
-                      kernel_data_64_seg_type, kernel_data_64_seg_flags);
-
-    _format_gdt_entry(&cpu_gdt[KERNEL_CS_32 / 8],
-                      KERNEL_CODE_SEGMENT_BASE_32, KERNEL_CODE_SEGMENT_LIMIT_32,
-                      kernel_code_32_seg_type, kernel_code_32_seg_flags);
-
-    _format_gdt_entry(&cpu_gdt[KERNEL_DS_32 / 8],
-                      KERNEL_DATA_SEGMENT_BASE_32, KERNEL_DATA_SEGMENT_LIMIT_32,
-                      kernel_data_32_seg_type, kernel_data_32_seg_flags);
-
-    _format_gdt_entry(&cpu_gdt[KERNEL_CS_16 / 8],
-                      KERNEL_CODE_SEGMENT_BASE_16, KERNEL_CODE_SEGMENT_LIMIT_16,
-                      kernel_code_16_seg_type, kernel_code_16_seg_flags);
-
-    _format_gdt_entry(&cpu_gdt[KERNEL_DS_16 / 8],
-                      KERNEL_DATA_SEGMENT_BASE_16, KERNEL_DATA_SEGMENT_LIMIT_16,
-                      kernel_data_16_seg_type, kernel_data_16_seg_flags);
-
-    _format_gdt_entry(&cpu_gdt[USER_CS_64 / 8],
-                      USER_CODE_SEGMENT_BASE_64, USER_CODE_SEGMENT_LIMIT_64,
-                      user_code_64_seg_type, user_code_64_seg_flags);
-
-    _format_gdt_entry(&cpu_gdt[USER_DS_64 / 8],
-                      USER_DATA_SEGMENT_BASE_64, USER_DATA_SEGMENT_LIMIT_64,
-                      user_data_64_seg_type, user_data_64_seg_flags);
-
-    _format_gdt_entry(&cpu_gdt[USER_CS_32 / 8],
-                      USER_CODE_SEGMENT_BASE_32, USER_CODE_SEGMENT_LIMIT_32,
-                      user_code_32_seg_type, user_code_32_seg_flags);
-
-    _format_gdt_entry(&cpu_gdt[USER_DS_32 / 8],
-                      USER_DATA_SEGMENT_BASE_32, USER_DATA_SEGMENT_LIMIT_32,
-                      user_data_32_seg_type, user_data_32_seg_flags);
-
+    /* The segments descriptors are built at compile time, set the TSS ones
+     * that depend on the TSS structures address. Long mode TSS descriptors
+     * are 16 bytes long, the second entry holds the high part of the base
+     * address.
+     */
     for(i = 0; i < MAX_CPU_COUNT; ++i)
     {
-        _format_gdt_entry(&cpu_gdt[(TSS_SEGMENT + i * 0x08) / 8],
+        _format_gdt_entry(&cpu_gdt[(TSS_SEGMENT + i * 0x10) / 8],
                           (uintptr_t)&cpu_tss[i],
-                          ((uintptr_t)(&cpu_tss[i])) +
-                          sizeof(cpu_tss_entry_t),
+                          sizeof(cpu_tss_entry_t) - 1,
                           tss_seg_type, tss_seg_flags);
+        cpu_gdt[(TSS_SEGMENT + i * 0x10) / 8 + 1] =
+            ((uintptr_t)&cpu_tss[i]) >> 32;
     }
 
-    /* Set the GDT descriptor */
-    cpu_gdt_ptr.size = ((sizeof(uint64_t) * GDT_ENTRY_COUNT) - 1);
-    cpu_gdt_ptr.base = (uintptr_t)&cpu_gdt;
-
     /* Load the GDT */
     __asm__ __volatile__("lgdt %0" :: "m" (cpu_gdt_ptr.size),
                                       "m" (cpu_gdt_ptr.base));
@@ -2175,44 +944,24 @@ static void _cpu_setup_gdt(void)
 
     KERNEL_SUCCESS("GDT Initialized at 0x%P\n", cpu_gdt_ptr.base);
 
-    KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_SET_GDT_END, 2,
-                       cpu_gdt_ptr.base & 0xFFFFFFFF,
-                       cpu_gdt_ptr.base >> 32);
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_SET_GDT_END, 1, cpu_gdt_ptr.base);
 }
 
 static void _cpu_setup_idt(void)
 {
-    uint32_t i;
-
     KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_SET_IDT_START, 0);
     KERNEL_DEBUG(CPU_DEBUG_ENABLED, MODULE_NAME, "Setting IDT");
 
-    /* Blank the IDT */
-    memset(cpu_idt, 0, sizeof(uint64_t) * IDT_ENTRY_COUNT);
-
-    /* Set interrupt handlers for each interrupt
-     * This allows to redirect all interrupts to a global handler in C
+    /* The IDT is built at link time, all interrupts are redirected to the
+     * global handler in C and the NMI, double fault and machine check lines
+     * use the emergency stack.
      */
-    for(i = 0; i < IDT_ENTRY_COUNT; ++i)
-    {
-        _format_idt_entry(&cpu_idt[i],
-                          cpu_int_handlers[i],
-                          IDT_TYPE_INT_GATE, IDT_FLAG_PRESENT | IDT_FLAG_PL0);
-    }
-
-    /* Set the GDT descriptor */
-    cpu_idt_ptr.size = ((sizeof(cpu_idt_entry_t) * IDT_ENTRY_COUNT) - 1);
-    cpu_idt_ptr.base = (uintptr_t)&cpu_idt;
-
-    /* Load the GDT */
     __asm__ __volatile__("lidt %0" :: "m" (cpu_idt_ptr.size),
                                       "m" (cpu_idt_ptr.base));
 
     KERNEL_SUCCESS("IDT Initialized at 0x%P\n", cpu_idt_ptr.base);
 
-    KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_SET_IDT_END, 2,
-                       cpu_idt_ptr.base & 0xFFFFFFFF,
-                       cpu_idt_ptr.base >> 32);
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_SET_IDT_END, 1, cpu_idt_ptr.base);
 }
 
 static void _cpu_setup_tss(void)
@@ -2225,33 +974,359 @@ static void _cpu_setup_tss(void)
     /* Blank the TSS */
     memset(cpu_tss, 0, sizeof(cpu_tss_entry_t) * MAX_CPU_COUNT);
 
-    /* Set basic values */
+    /* Set basic values, the emergency stacks come after the CPUs stacks and
+     * the fault stacks after the emergency stacks
+     */
     for(i = 0; i < MAX_CPU_COUNT; ++i)
     {
         cpu_tss[i].rsp0 = ((uintptr_t)&_KERNEL_STACKS_BASE) +
                           KERNEL_STACK_SIZE * (i + 1) - sizeof(uint32_t);
+        cpu_tss[i].ist1 = ((uintptr_t)&_KERNEL_STACKS_BASE) +
+                          KERNEL_STACK_SIZE * (MAX_CPU_COUNT + i + 1) -
+                          THREAD_STACK_ALIGN;
+        cpu_tss[i].ist2 = ((uintptr_t)&_KERNEL_STACKS_BASE) +
+                          KERNEL_STACK_SIZE * (2 * MAX_CPU_COUNT + i + 1) -
+                          THREAD_STACK_ALIGN;
         cpu_tss[i].iomap_base = sizeof(cpu_tss_entry_t);
     }
 
-    /* Load TSS */
-    //__asm__ __volatile__("ltr %0" : : "rm" ((uint16_t)(TSS_SEGMENT)));
+    /* Load the BSP TSS */
+    __asm__ __volatile__("ltr %0" : : "rm" ((uint16_t)(TSS_SEGMENT)));
 
     KERNEL_SUCCESS("TSS Initialized at 0x%P\n", cpu_tss);
 
-    KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_SET_TSS_END, 2,
-                       (uintptr_t)cpu_tss & 0xFFFFFFFF,
-                       (uintptr_t)cpu_tss >> 32);
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_SET_TSS_END, 1, (uintptr_t)cpu_tss);
+}
+
+static void _cpu_send_ipi(const uint32_t apic_id, const uint32_t command)
+{
+    volatile uint32_t* icr_low;
+    volatile uint32_t* icr_high;
+
+    /* The LAPIC driver might have switched the LAPIC to x2APIC mode */
+    if((_cpu_get_msr(CPU_MSR_APIC_BASE) & CPU_MSR_APIC_BASE_X2APIC) != 0)
+    {
+        _cpu_set_msr(CPU_MSR_X2APIC_ICR, ((uint64_t)apic_id << 32) | command);
+        return;
+    }
+
+    icr_low  = (volatile uint32_t*)(CPU_LAPIC_BASE_ADDR + CPU_LAPIC_ICR_LOW);
+    icr_high = (volatile uint32_t*)(CPU_LAPIC_BASE_ADDR + CPU_LAPIC_ICR_HIGH);
+
+    *icr_high = apic_id << CPU_LAPIC_ICR_DEST_SHIFT;
+    *icr_low  = command;
+
+    while((*icr_low & CPU_LAPIC_ICR_DELIVERY_PENDING) != 0)
+    {
+        _cpu_pause();
+    }
+}
+
+static void _cpu_detect_features(void)
+{
+    uint32_t regs[4];
+    uint32_t max_leaf;
+
+    cpu_features = 0;
+    max_leaf     = _cpu_get_cpuid_max(0x0);
+
+    if(_cpu_cpuid(0x1, regs) == 1)
+    {
+        CPU_SET_FEATURE(CPU_FEATURE_SSE42, regs[2], CPUID_FEATURES_ECX_SSE42);
+        CPU_SET_FEATURE(CPU_FEATURE_X2APIC, regs[2], CPUID_FEATURES_ECX_X2APIC);
+        CPU_SET_FEATURE(CPU_FEATURE_TSC_DEADLINE, regs[2],
+                        CPUID_FEATURES_ECX_TSC_DEADLINE);
+        CPU_SET_FEATURE(CPU_FEATURE_PCID, regs[2], CPUID_FEATURES_ECX_PCID);
+        CPU_SET_FEATURE(CPU_FEATURE_PAT, regs[3], CPUID_FEATURES_EDX_PAT);
+        CPU_SET_FEATURE(CPU_FEATURE_SSE2, regs[3], CPUID_FEATURES_EDX_SSE2);
+
+        /* XSAVE is only usable with its state enumeration leaf */
+        if(max_leaf >= CPUID_XSAVE_LEAF)
+        {
+            CPU_SET_FEATURE(CPU_FEATURE_XSAVE, regs[2],
+                            CPUID_FEATURES_ECX_XSAVE);
+        }
+    }
+
+    if(max_leaf >= CPUID_EXT_FEATURES_LEAF)
+    {
+        _cpu_cpuid_subleaf(CPUID_EXT_FEATURES_LEAF, 0, regs);
+        CPU_SET_FEATURE(CPU_FEATURE_AVX2, regs[1],
+                        CPUID_EXT_FEATURES_EBX_AVX2);
+        CPU_SET_FEATURE(CPU_FEATURE_ERMS, regs[1],
+                        CPUID_EXT_FEATURES_EBX_ERMS);
+        CPU_SET_FEATURE(CPU_FEATURE_INVPCID, regs[1],
+                        CPUID_EXT_FEATURES_EBX_INVPCID);
+        CPU_SET_FEATURE(CPU_FEATURE_FSRM, regs[3],
+                        CPUID_EXT_FEATURES_EDX_FSRM);
+    }
+
+    if(cpu_has_feature(CPU_FEATURE_XSAVE) == TRUE)
+    {
+        _cpu_cpuid_subleaf(CPUID_XSAVE_LEAF, 1, regs);
+        CPU_SET_FEATURE(CPU_FEATURE_XSAVEOPT, regs[0],
+                        CPUID_XSAVE_EAX_XSAVEOPT);
+    }
+
+    if(_cpu_cpuid(CPUID_EXT_PROC_LEAF, regs) == 1)
+    {
+        CPU_SET_FEATURE(CPU_FEATURE_RDTSCP, regs[3],
+                        CPUID_EXT_PROC_EDX_RDTSCP);
+    }
+    if(_cpu_cpuid(CPUID_POWER_LEAF, regs) == 1)
+    {
+        CPU_SET_FEATURE(CPU_FEATURE_INVARIANT_TSC, regs[3],
+                        CPUID_POWER_EDX_INVARIANT_TSC);
+    }
+
+    /* MWAIT is only used when interrupts break it while they are disabled */
+    if(max_leaf >= CPUID_MWAIT_LEAF && _cpu_cpuid(0x1, regs) == 1 &&
+       (regs[2] & CPUID_FEATURES_ECX_MONITOR) != 0)
+    {
+        _cpu_cpuid_subleaf(CPUID_MWAIT_LEAF, 0, regs);
+        if((regs[2] & CPUID_MWAIT_ECX_EMX) != 0)
+        {
+            CPU_SET_FEATURE(CPU_FEATURE_MWAIT, regs[2], CPUID_MWAIT_ECX_IBE);
+        }
+    }
+
+    if(_cpu_cpuid(0x1, regs) == 1 &&
+       (regs[2] & CPUID_FEATURES_ECX_HYPERVISOR) != 0)
+    {
+        cpu_features |= (1U << CPU_FEATURE_HYPERVISOR);
+
+        /* The hypervisor leaves are outside of the standard leaves range */
+        _cpu_cpuid_subleaf(CPUID_HYPERVISOR_LEAF, 0, regs);
+        if(regs[0] >= CPUID_KVM_FEATURES_LEAF &&
+           memcmp(&regs[1], CPUID_KVM_SIGNATURE, 3 * sizeof(uint32_t)) == 0)
+        {
+            _cpu_cpuid_subleaf(CPUID_KVM_FEATURES_LEAF, 0, regs);
+            if((regs[0] & CPUID_KVM_EAX_CLOCK_STABLE) != 0)
+            {
+                CPU_SET_FEATURE(CPU_FEATURE_KVM_CLOCK, regs[0],
+                                CPUID_KVM_EAX_CLOCKSOURCE2);
+            }
+            CPU_SET_FEATURE(CPU_FEATURE_KVM_PV_EOI, regs[0],
+                            CPUID_KVM_EAX_PV_EOI);
+            CPU_SET_FEATURE(CPU_FEATURE_KVM_PV_UNHALT, regs[0],
+                            CPUID_KVM_EAX_PV_UNHALT);
+        }
+    }
+
+    KERNEL_DEBUG(CPU_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU features 0x%x", cpu_features);
+}
+
+static void _cpu_apply_alternatives(void)
+{
+    const cpu_alternative_t* alternative;
+    volatile uint8_t*        site;
+    uintptr_t                cr0;
+    uint32_t                 offset;
+    uint32_t                 regs[4];
+    uint32_t                 patched;
+    uint32_t                 i;
+
+    __asm__ __volatile__("mov %%cr0, %0" : "=r" (cr0));
+    __asm__ __volatile__("mov %0, %%cr0" :: "r" (cr0 & ~CPU_CR0_WP)
+                                         : "memory");
+
+    patched = 0;
+    for(alternative = _START_CPU_ALTERNATIVES_ADDR;
+        alternative < _END_CPU_ALTERNATIVES_ADDR;
+        ++alternative)
+    {
+        if(alternative->feature >= CPU_FEATURE_COUNT ||
+           cpu_has_feature(alternative->feature) == FALSE)
+        {
+            continue;
+        }
+
+        /* The offset is written before the opcode, the site stays a NOP
+         * until the jump is complete.
+         */
+        site   = (volatile uint8_t*)alternative->site;
+        offset = (uint32_t)(alternative->target -
+                            (alternative->site + CPU_ALTERNATIVE_SITE_SIZE));
+        for(i = 0; i < sizeof(offset); ++i)
+        {
+            site[i + 1] = (uint8_t)(offset >> (i * 8));
+        }
+        site[0] = CPU_JMP_REL32_OPCODE;
+        ++patched;
+    }
+
+    __asm__ __volatile__("mov %0, %%cr0" :: "r" (cr0) : "memory");
+
+    /* Serialize the instruction stream before executing the patched code */
+    _cpu_cpuid_subleaf(0x0, 0, regs);
+
+    KERNEL_DEBUG(CPU_DEBUG_ENABLED, MODULE_NAME,
+                 "Patched %u alternative sites out of %u", patched,
+                 (uint32_t)(_END_CPU_ALTERNATIVES_ADDR -
+                            _START_CPU_ALTERNATIVES_ADDR));
+}
+
+static void _cpu_detect_fpu(void)
+{
+    uint32_t regs[4];
+    uint32_t xsave_regs[4];
+    uint32_t avx_regs[4];
+
+    cpu_fpu_xcr0 = 0;
+
+    if(cpu_has_feature(CPU_FEATURE_XSAVE) == FALSE)
+    {
+        KERNEL_DEBUG(CPU_DEBUG_ENABLED, MODULE_NAME,
+                     "FPU state saved with FXSAVE");
+        return;
+    }
+
+    cpu_fpu_xcr0 = CPU_XCR0_X87 | CPU_XCR0_SSE;
+    _cpu_cpuid_subleaf(0x1, 0, regs);
+
+    /* Sub-leaf 0 EAX reports the supported state components */
+    _cpu_cpuid_subleaf(CPUID_XSAVE_LEAF, 0, xsave_regs);
+    if((regs[2] & CPUID_FEATURES_ECX_AVX) != 0 &&
+       (xsave_regs[0] & CPU_XCR0_AVX) != 0)
+    {
+        /* The AVX sub-leaf gives the size (EAX) and offset (EBX) of the
+         * component in the save area.
+         */
+        _cpu_cpuid_subleaf(CPUID_XSAVE_LEAF, CPUID_XSAVE_AVX_SUBLEAF, avx_regs);
+        if(avx_regs[0] + avx_regs[1] <= CPU_FPU_STATE_SIZE)
+        {
+            cpu_fpu_xcr0 |= CPU_XCR0_AVX;
+        }
+    }
+
+    KERNEL_DEBUG(CPU_DEBUG_ENABLED, MODULE_NAME,
+                 "FPU state saved with %s, XCR0 0x%x",
+                 cpu_has_feature(CPU_FEATURE_XSAVEOPT) == TRUE ?
+                 "XSAVEOPT" : "XSAVE",
+                 (uint32_t)cpu_fpu_xcr0);
+}
+
+static void _cpu_setup_fpu(void)
+{
+    uintptr_t cr0;
+    uintptr_t cr4;
+
+    /* Use the FPU, do not emulate it */
+    __asm__ __volatile__("mov %%cr0, %0" : "=r" (cr0));
+    cr0 = (cr0 & ~(CPU_CR0_EM | CPU_CR0_TS)) | CPU_CR0_MP;
+    __asm__ __volatile__("mov %0, %%cr0" :: "r" (cr0) : "memory");
+
+    __asm__ __volatile__("mov %%cr4, %0" : "=r" (cr4));
+    cr4 |= CPU_CR4_OSFXSR | CPU_CR4_OSXMMEXCPT;
+    if(cpu_has_feature(CPU_FEATURE_XSAVE) == TRUE)
+    {
+        cr4 |= CPU_CR4_OSXSAVE;
+    }
+    __asm__ __volatile__("mov %0, %%cr4" :: "r" (cr4) : "memory");
+
+    if(cpu_has_feature(CPU_FEATURE_XSAVE) == TRUE)
+    {
+        __asm__ __volatile__("xsetbv" :: "c" (0),
+                                         "a" ((uint32_t)cpu_fpu_xcr0),
+                                         "d" ((uint32_t)(cpu_fpu_xcr0 >> 32)));
+    }
+
+    __asm__ __volatile__("fninit":::"memory");
+}
+
+static void _cpu_detect_pcid(void)
+{
+    cpu_pcid_enabled = FALSE;
+
+    if(cpu_has_feature(CPU_FEATURE_PCID) == FALSE)
+    {
+        KERNEL_DEBUG(CPU_DEBUG_ENABLED, MODULE_NAME, "PCIDs not supported");
+        return;
+    }
+
+    if(cpu_has_feature(CPU_FEATURE_INVPCID) == FALSE)
+    {
+        KERNEL_DEBUG(CPU_DEBUG_ENABLED, MODULE_NAME,
+                     "INVPCID not supported, PCIDs disabled");
+        return;
+    }
+
+    cpu_pcid_enabled = TRUE;
+
+    KERNEL_DEBUG(CPU_DEBUG_ENABLED, MODULE_NAME, "PCIDs enabled");
+}
+
+static void _cpu_setup_pcid(void)
+{
+    uintptr_t cr4;
+
+    if(cpu_pcid_enabled == FALSE)
+    {
+        return;
+    }
+
+    /* The root paging structure is page aligned, CR3 holds the PCID 0 */
+    __asm__ __volatile__("mov %%cr4, %0" : "=r" (cr4));
+    cr4 |= CPU_CR4_PCIDE;
+    __asm__ __volatile__("mov %0, %%cr4" :: "r" (cr4) : "memory");
+}
+
+static void _cpu_setup_pat(void)
+{
+    if(cpu_pat_enabled == FALSE)
+    {
+        KERNEL_DEBUG(CPU_DEBUG_ENABLED, MODULE_NAME,
+                     "PAT not supported, write-combining disabled");
+        return;
+    }
+
+    _cpu_set_msr(CPU_MSR_PAT, CPU_MSR_PAT_VALUE);
+}
+
+static void _cpu_setup_syscall(void)
+{
+    _cpu_set_msr(CPU_MSR_STAR, ((uint64_t)USER_CS_32 << 48) |
+                               ((uint64_t)KERNEL_CS_64 << 32));
+    _cpu_set_msr(CPU_MSR_LSTAR, (uintptr_t)cpu_syscall_entry);
+    _cpu_set_msr(CPU_MSR_FMASK, CPU_SYSCALL_RFLAGS_MASK);
+    _cpu_set_msr(CPU_MSR_KERNEL_GS_BASE, 0);
+    _cpu_set_msr(CPU_MSR_EFER,
+                 _cpu_get_msr(CPU_MSR_EFER) | CPU_MSR_EFER_SCE);
+
+    KERNEL_DEBUG(CPU_DEBUG_ENABLED, MODULE_NAME,
+                 "SYSCALL entry at 0x%p", cpu_syscall_entry);
 }
 
 void cpu_init(void)
 {
     KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_SETUP_START, 0);
 
+    /* Select the features code paths before anything uses them */
+    _cpu_detect_features();
+    _cpu_apply_alternatives();
+
     /* Init the GDT, IDT and TSS */
     _cpu_setup_gdt();
     _cpu_setup_idt();
     _cpu_setup_tss();
 
+    /* Init the FPU, its boot state is the clean state given to the threads */
+    _cpu_detect_fpu();
+    _cpu_setup_fpu();
+    cpu_fpu_save(cpu_fpu_init_state);
+
+    /* Tag the TLB entries with the address spaces PCIDs */
+    _cpu_detect_pcid();
+    _cpu_setup_pcid();
+
+    /* The device memory can be mapped write-combining */
+    cpu_pat_enabled = cpu_has_feature(CPU_FEATURE_PAT);
+    _cpu_setup_pat();
+
+    /* The user threads enter the kernel with SYSCALL */
+    _cpu_setup_syscall();
+
     KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_SETUP_END, 0);
 }
 
@@ -3046,4 +2121,303 @@ OS_RETURN_E cpu_raise_interrupt(const uint32_t interrupt_line)
     return OS_NO_ERR;
 }
 
+void cpu_init_thread_context(void (*entry_point)(void),
+                             const uintptr_t stack_end,
+                             virtual_cpu_t* v_cpu)
+{
+    uint64_t* stack;
+
+    /* Align the stack and reserve the interrupt return frame, the frame is
+     * consumed by iretq and the thread starts as if called with RIP pushed.
+     */
+    stack = (uint64_t*)(stack_end & ~(uintptr_t)(THREAD_STACK_ALIGN - 1));
+    stack -= 5;
+
+    /* Interrupt return frame: RIP, CS, RFLAGS, RSP, SS */
+    stack[0] = (uintptr_t)entry_point;
+    stack[1] = THREAD_KERNEL_CS;
+    stack[2] = THREAD_INIT_RFLAGS;
+    stack[3] = (uintptr_t)stack;
+    stack[4] = THREAD_KERNEL_DS;
+
+    memset(v_cpu, 0, sizeof(virtual_cpu_t));
+
+    v_cpu->int_context.rip    = (uintptr_t)entry_point;
+    v_cpu->int_context.cs     = THREAD_KERNEL_CS;
+    v_cpu->int_context.rflags = THREAD_INIT_RFLAGS;
+
+    v_cpu->vcpu.rsp = (uintptr_t)stack;
+    v_cpu->vcpu.ss  = THREAD_KERNEL_DS;
+    v_cpu->vcpu.gs  = THREAD_KERNEL_DS;
+    v_cpu->vcpu.fs  = THREAD_KERNEL_DS;
+    v_cpu->vcpu.es  = THREAD_KERNEL_DS;
+    v_cpu->vcpu.ds  = THREAD_KERNEL_DS;
+}
+
+void cpu_set_local_storage(const uint32_t cpu_id,
+                           const uintptr_t local_storage)
+{
+    /* In long mode the GS base is set through its MSR, the GS selector is
+     * not used anymore.
+     */
+    __asm__ __volatile__("wrmsr" :: "c" (CPU_MSR_GS_BASE),
+                                    "a" ((uint32_t)local_storage),
+                                    "d" ((uint32_t)(local_storage >> 32))
+                                 : "memory");
+
+    (void)cpu_id;
+
+    KERNEL_DEBUG(CPU_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %d local storage at 0x%p", cpu_id, local_storage);
+}
+
+void cpu_set_kernel_stack(const uint32_t cpu_id, const uintptr_t stack_top)
+{
+    cpu_tss[cpu_id].rsp0 = stack_top;
+}
+
+OS_RETURN_E cpu_smp_init(void (*ap_main)(const uint32_t cpu_id))
+{
+    uint32_t  regs[4];
+    uint32_t  apic_base_low;
+    uint32_t  apic_base_high;
+    uintptr_t boot_code;
+    uintptr_t page_table;
+    uint32_t  expected;
+    uint32_t  waited;
+    uint32_t  i;
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_SMP_INIT_START, 0);
+    KERNEL_DEBUG(CPU_DEBUG_ENABLED, MODULE_NAME, "Starting APs");
+
+    if(ap_main == NULL)
+    {
+        KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_SMP_INIT_END, 2,
+                           1, OS_ERR_NULL_POINTER);
+        return OS_ERR_NULL_POINTER;
+    }
+
+    /* The APs are started through the LAPIC, which must be at the address
+     * mapped by the boot code.
+     */
+    if(_cpu_cpuid(0x1, regs) == 0 ||
+       (regs[3] & CPUID_FEATURES_EDX_APIC) == 0)
+    {
+        KERNEL_ERROR("No LAPIC detected, only the BSP is started\n");
+        KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_SMP_INIT_END, 2,
+                           1, OS_ERR_NOT_SUPPORTED);
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    __asm__ __volatile__("rdmsr" : "=a" (apic_base_low),
+                                   "=d" (apic_base_high)
+                                 : "c" (CPU_MSR_APIC_BASE));
+    (void)apic_base_high;
+
+    if((apic_base_low & CPU_MSR_APIC_BASE_MASK) != CPU_LAPIC_BASE_ADDR)
+    {
+        KERNEL_ERROR("LAPIC relocated at 0x%p, only the BSP is started\n",
+                     apic_base_low & CPU_MSR_APIC_BASE_MASK);
+        KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_SMP_INIT_END, 2,
+                           1, OS_ERR_NOT_SUPPORTED);
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    cpu_ap_main     = ap_main;
+    cpu_ready_count = 1;
+
+    /* Copy the startup code in low memory through the kernel high mapping and
+     * give it the current page table.
+     */
+    boot_code = KERNEL_MEM_OFFSET + KERNEL_AP_BOOT_ADDR;
+    memcpy((void*)boot_code, &__kinit_ap_start,
+           &__kinit_ap_end - &__kinit_ap_start);
+
+    __asm__ __volatile__("mov %%cr3, %0" : "=r" (page_table));
+    *(uint32_t*)(boot_code + ((uintptr_t)&_kinit_ap_cr3 -
+                              (uintptr_t)&__kinit_ap_start)) =
+        (uint32_t)page_table;
+
+    /* INIT-SIPI-SIPI sequence, broadcasted as we do not know the APs */
+    _cpu_send_ipi(0, CPU_LAPIC_ICR_INIT_ALL_BUT_SELF);
+    pit_busy_wait(CPU_SMP_INIT_DELAY_US);
+    for(i = 0; i < 2; ++i)
+    {
+        _cpu_send_ipi(0, CPU_LAPIC_ICR_STARTUP_ALL_BUT_SELF |
+                         (KERNEL_AP_BOOT_ADDR >> 12));
+        pit_busy_wait(CPU_SMP_STARTUP_DELAY_US);
+    }
+
+    /* Wait for the APs given by the firmware, all the supported ones without
+     * firmware information
+     */
+    expected = topology_get_cpu_count();
+    if(expected == 0 || expected > MAX_CPU_COUNT)
+    {
+        expected = MAX_CPU_COUNT;
+    }
+    waited = 0;
+    while(cpu_ready_count < expected &&
+          waited < CPU_SMP_START_TIMEOUT_US)
+    {
+        pit_busy_wait(CPU_SMP_POLL_PERIOD_US);
+        waited += CPU_SMP_POLL_PERIOD_US;
+    }
+
+    KERNEL_SUCCESS("SMP Initialized, %d CPUs started\n", cpu_ready_count);
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_CPU_SMP_INIT_END, 2,
+                       cpu_ready_count, OS_NO_ERR);
+
+    return OS_NO_ERR;
+}
+
+uint32_t cpu_get_started_count(void)
+{
+    /* Only the BSP runs until the APs are started */
+    return (cpu_ready_count != 0) ? cpu_ready_count : 1;
+}
+
+void cpu_ap_init(const uint32_t cpu_id)
+{
+    /* Load the kernel GDT and segments */
+    __asm__ __volatile__("lgdt %0" :: "m" (cpu_gdt_ptr.size),
+                                      "m" (cpu_gdt_ptr.base));
+
+    __asm__ __volatile__("movw %w0,%%ds\n\t"
+                         "movw %w0,%%es\n\t"
+                         "movw %w0,%%fs\n\t"
+                         "movw %w0,%%gs\n\t"
+                         "movw %w0,%%ss\n\t" :: "r" (KERNEL_DS_64));
+
+    __asm__ __volatile__("mov %0, %%rax\n\t"
+                         "push %%rax\n\t"
+                         "movabs $1f, %%rax\n\t"
+                         "push %%rax\n\t"
+                         "lretq\n\t"
+                         "1: \n\t" :: "i" (KERNEL_CS_64) : "rax");
+
+    /* Load the kernel IDT and the CPU TSS */
+    __asm__ __volatile__("lidt %0" :: "m" (cpu_idt_ptr.size),
+                                      "m" (cpu_idt_ptr.base));
+
+    __asm__ __volatile__("ltr %0" : : "rm" ((uint16_t)(TSS_SEGMENT +
+                                                       cpu_id * 0x10)));
+
+    _cpu_setup_fpu();
+    _cpu_setup_pcid();
+    _cpu_setup_pat();
+    _cpu_setup_syscall();
+
+    KERNEL_DEBUG(CPU_DEBUG_ENABLED, MODULE_NAME, "CPU %d initialized", cpu_id);
+
+    __atomic_add_fetch(&cpu_ready_count, 1, __ATOMIC_SEQ_CST);
+
+    cpu_ap_main(cpu_id);
+
+    /* The AP routine should never return */
+    while(TRUE)
+    {
+        _cpu_clear_interrupt();
+        _cpu_hlt();
+    }
+}
+
+void cpu_fpu_save(uint8_t* state)
+{
+    if(CPU_FEATURE_STATIC(CPU_FEATURE_XSAVEOPT))
+    {
+        __asm__ __volatile__("xsaveopt64 (%0)"
+                             :: "r" (state),
+                                "a" ((uint32_t)cpu_fpu_xcr0),
+                                "d" ((uint32_t)(cpu_fpu_xcr0 >> 32))
+                             : "memory");
+    }
+    else if(CPU_FEATURE_STATIC(CPU_FEATURE_XSAVE))
+    {
+        __asm__ __volatile__("xsave64 (%0)"
+                             :: "r" (state),
+                                "a" ((uint32_t)cpu_fpu_xcr0),
+                                "d" ((uint32_t)(cpu_fpu_xcr0 >> 32))
+                             : "memory");
+    }
+    else
+    {
+        __asm__ __volatile__("fxsave64 (%0)" :: "r" (state) : "memory");
+    }
+}
+
+void cpu_fpu_restore(const uint8_t* state)
+{
+    if(CPU_FEATURE_STATIC(CPU_FEATURE_XSAVE))
+    {
+        __asm__ __volatile__("xrstor64 (%0)"
+                             :: "r" (state),
+                                "a" ((uint32_t)cpu_fpu_xcr0),
+                                "d" ((uint32_t)(cpu_fpu_xcr0 >> 32))
+                             : "memory");
+    }
+    else
+    {
+        __asm__ __volatile__("fxrstor64 (%0)" :: "r" (state) : "memory");
+    }
+}
+
+void cpu_fpu_reset(void)
+{
+    cpu_fpu_restore(cpu_fpu_init_state);
+}
+
+bool_t cpu_is_pcid_enabled(void)
+{
+    return cpu_pcid_enabled;
+}
+
+bool_t cpu_is_write_combining_enabled(void)
+{
+    return cpu_pat_enabled;
+}
+
+bool_t cpu_has_feature(const CPU_FEATURE_E feature)
+{
+    if(feature >= CPU_FEATURE_COUNT)
+    {
+        return FALSE;
+    }
+
+    return (cpu_features & (1U << feature)) != 0;
+}
+
+OS_RETURN_E cpu_send_ipi(const uint32_t cpu_id, const uint32_t interrupt_line)
+{
+    OS_RETURN_E err;
+    uint64_t    flags;
+    uint32_t    apic_id;
+
+    if(interrupt_line < MIN_INTERRUPT_LINE ||
+       interrupt_line > MAX_INTERRUPT_LINE)
+    {
+        return OR_ERR_UNAUTHORIZED_INTERRUPT_LINE;
+    }
+
+    err = lapic_get_apic_id(cpu_id, &apic_id);
+    if(err != OS_NO_ERR)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    /* The xAPIC command is written in two registers */
+    flags = _cpu_save_flags();
+    _cpu_clear_interrupt();
+    _cpu_send_ipi(apic_id, CPU_LAPIC_ICR_FIXED | interrupt_line);
+    _cpu_restore_flags(flags);
+
+    return OS_NO_ERR;
+}
+
+void cpu_ipi_eoi(void)
+{
+    lapic_eoi();
+}
+
 /************************************ EOF *************************************/
\ No newline at end of file
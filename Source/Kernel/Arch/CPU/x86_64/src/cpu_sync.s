@@ -1,76 +0,0 @@
-;-------------------------------------------------------------------------------
-;
-; File: cpu_sync.S
-;
-; Author: Alexy Torres Aurora Dugo
-;
-; Date: 25/04/2023
-;
-; Version: 1.0
-;
-; CPU synchronization functions
-;-------------------------------------------------------------------------------
-;-------------------------------------------------------------------------------
-; ARCH
-;-------------------------------------------------------------------------------
-[bits 64]
-
-;-------------------------------------------------------------------------------
-; DEFINES
-;-------------------------------------------------------------------------------
-
-;-------------------------------------------------------------------------------
-; MACRO DEFINE
-;-------------------------------------------------------------------------------
-
-;-------------------------------------------------------------------------------
-; EXTERN DATA
-;-------------------------------------------------------------------------------
-
-;-------------------------------------------------------------------------------
-; EXTERN FUNCTIONS
-;-------------------------------------------------------------------------------
-
-;-------------------------------------------------------------------------------
-; EXPORTED FUNCTIONS
-;-------------------------------------------------------------------------------
-global cpu_lock_spinlock
-global cpu_unlock_spinlock
-
-;-------------------------------------------------------------------------------
-; CODE
-;-------------------------------------------------------------------------------
-
-section .text
-;-------------------------------------------------------------------------------
-; Lock Spinlock
-;
-; Param:
-;     Input: rdi: Address of the lock
-
-cpu_lock_spinlock:
-__pause_spinlock_entry:
-    lock bts dword [rdi], 0
-    jc   __pause_spinlock_pause
-    ret
-
-__pause_spinlock_pause:
-    pause
-    test  dword [rdi], 1
-    jnz   __pause_spinlock_pause
-    jmp   __pause_spinlock_entry
-
-;-------------------------------------------------------------------------------
-; Unlock Spinlock
-;
-; Param:
-;     Input: rdi: Address of the lock
-
-cpu_unlock_spinlock:
-    mov  dword [rdi], 0
-    ret
-
-;-------------------------------------------------------------------------------
-; DATA
-;-------------------------------------------------------------------------------
-
@@ -0,0 +1,471 @@
+/*******************************************************************************
+ * @file critical.c
+ *
+ * @see critical.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's spinlocks and reader-writer locks.
+ *
+ * @details Kernel's spinlocks and reader-writer locks. Two fair implementations are provided. The
+ * ticket lock is the smallest and fastest when the lock is not contended, all
+ * the waiters spin on the same cache line. The MCS queued lock links the
+ * waiters in a queue, each waiter spins on its own node and the lock cache
+ * line is only touched when the lock changes of owner. The queue nodes live on
+ * the waiters stack: once a waiter gets the lock, the lock owner node takes
+ * its place in the queue. The locks can then be used before the CPU local
+ * storage is initialized.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>       /* Generic int types */
+#include <stddef.h>       /* Standard definitions */
+#include <cpu.h>          /* CPU management */
+#include <cpu_features.h> /* CPU features registry */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <critical.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of spins of a MCS waiter before it halts under KVM. */
+#define MCS_PV_SPIN_COUNT (1 << 15)
+
+/** @brief MCS node waiting flag: the waiter halted and must be kicked. */
+#define MCS_NODE_HALTED       0x2
+/** @brief MCS node waiting field: position of the halted waiter APIC id. */
+#define MCS_NODE_APIC_ID_SHIFT 8
+
+/** @brief CPUID leaf 1 EBX: position of the initial APIC id. */
+#define CPUID_EBX_APIC_ID_SHIFT 24
+
+/** @brief KVM hypercall waking a halted CPU. */
+#define KVM_HC_KICK_CPU 5
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Locks a ticket spinlock.
+ *
+ * @param[in-out] lock The lock to lock.
+ *
+ * @return TRUE if the caller waited for the lock, FALSE otherwise.
+ */
+static bool_t _ticket_lock(kernel_spinlock_t* lock);
+
+/**
+ * @brief Unlocks a ticket spinlock.
+ *
+ * @param[in-out] lock The lock to unlock.
+ */
+static void _ticket_unlock(kernel_spinlock_t* lock);
+
+/**
+ * @brief Locks a MCS queued spinlock.
+ *
+ * @details Locks a MCS queued spinlock. When the lock is taken, the caller
+ * queues a node from its stack, spins on it until its predecessor hands it the
+ * lock and then replaces its node by the lock owner node.
+ *
+ * @param[in-out] lock The lock to lock.
+ *
+ * @return TRUE if the caller waited for the lock, FALSE otherwise.
+ */
+static bool_t _mcs_lock(kernel_spinlock_t* lock);
+
+/**
+ * @brief Unlocks a MCS queued spinlock.
+ *
+ * @details Unlocks a MCS queued spinlock, the lock is handed to the first
+ * waiter of the queue.
+ *
+ * @param[in-out] lock The lock to unlock.
+ */
+static void _mcs_unlock(kernel_spinlock_t* lock);
+
+/**
+ * @brief Waits for the lock to be handed to a MCS node.
+ *
+ * @details Spins on the node. Under KVM, the waiter halts after
+ * MCS_PV_SPIN_COUNT spins, the hypervisor can then run the vCPU holding the
+ * lock instead of the spinning one.
+ *
+ * @param[in-out] node The queued node.
+ */
+static void _mcs_wait(kernel_spinlock_node_t* node);
+
+/**
+ * @brief Halts a MCS waiter until the lock is handed to it.
+ *
+ * @details Records the APIC id of the waiter in the node and halts. The
+ * unlocker kicks the waiter with a hypercall when it sees the record. The
+ * halt can end early on an interrupt, the caller checks the node again.
+ *
+ * @param[in-out] node The queued node.
+ */
+static void _mcs_pv_halt(kernel_spinlock_node_t* node);
+
+/**
+ * @brief Wakes a halted MCS waiter.
+ *
+ * @param[in] apic_id The APIC id of the waiter CPU.
+ */
+static void _mcs_pv_kick(const uint32_t apic_id);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static bool_t _ticket_lock(kernel_spinlock_t* lock)
+{
+    uint16_t ticket;
+    bool_t   contended;
+
+    ticket = __atomic_fetch_add(&lock->next_ticket, 1, __ATOMIC_RELAXED);
+    contended = FALSE;
+    while(__atomic_load_n(&lock->owner_ticket, __ATOMIC_ACQUIRE) != ticket)
+    {
+        contended = TRUE;
+        _cpu_pause();
+    }
+
+    return contended;
+}
+
+static void _ticket_unlock(kernel_spinlock_t* lock)
+{
+    __atomic_store_n(&lock->owner_ticket,
+                     (uint16_t)(lock->owner_ticket + 1),
+                     __ATOMIC_RELEASE);
+}
+
+static bool_t _mcs_lock(kernel_spinlock_t* lock)
+{
+    kernel_spinlock_node_t  node __attribute__((aligned(CPU_CACHE_LINE_SIZE)));
+    kernel_spinlock_node_t* expected;
+    kernel_spinlock_node_t* prev;
+    kernel_spinlock_node_t* next;
+
+    /* Free lock, the owner node is the only node of the queue */
+    expected = NULL;
+    if(__atomic_compare_exchange_n(&lock->tail, &expected, &lock->owner,
+                                   FALSE, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)
+       == TRUE)
+    {
+        return FALSE;
+    }
+
+    /* Queue our node and wait for the lock to be handed to us */
+    node.next    = NULL;
+    node.waiting = 1;
+    prev = __atomic_exchange_n(&lock->tail, &node, __ATOMIC_ACQ_REL);
+    if(prev != NULL)
+    {
+        __atomic_store_n(&prev->next, &node, __ATOMIC_RELEASE);
+        _mcs_wait(&node);
+    }
+
+    /* We own the lock, the owner node replaces our node in the queue */
+    next = __atomic_load_n(&node.next, __ATOMIC_ACQUIRE);
+    if(next == NULL)
+    {
+        lock->owner.next = NULL;
+        expected = &node;
+        if(__atomic_compare_exchange_n(&lock->tail, &expected, &lock->owner,
+                                       FALSE, __ATOMIC_ACQ_REL,
+                                       __ATOMIC_RELAXED) == TRUE)
+        {
+            return TRUE;
+        }
+
+        /* A waiter is linking itself to our node */
+        while((next = __atomic_load_n(&node.next, __ATOMIC_ACQUIRE)) == NULL)
+        {
+            _cpu_pause();
+        }
+    }
+    __atomic_store_n(&lock->owner.next, next, __ATOMIC_RELEASE);
+
+    return TRUE;
+}
+
+static void _mcs_unlock(kernel_spinlock_t* lock)
+{
+    kernel_spinlock_node_t* expected;
+    kernel_spinlock_node_t* next;
+    uint32_t                waiting;
+
+    next = __atomic_load_n(&lock->owner.next, __ATOMIC_ACQUIRE);
+    if(next == NULL)
+    {
+        expected = &lock->owner;
+        if(__atomic_compare_exchange_n(&lock->tail, &expected, NULL,
+                                       FALSE, __ATOMIC_RELEASE,
+                                       __ATOMIC_RELAXED) == TRUE)
+        {
+            return;
+        }
+
+        /* A waiter is linking itself to the owner node */
+        while((next = __atomic_load_n(&lock->owner.next, __ATOMIC_ACQUIRE))
+              == NULL)
+        {
+            _cpu_pause();
+        }
+    }
+
+    /* Hand the lock to the first waiter, kick it if it halted */
+    if(CPU_FEATURE_STATIC(CPU_FEATURE_KVM_PV_UNHALT))
+    {
+        waiting = __atomic_exchange_n(&next->waiting, 0, __ATOMIC_ACQ_REL);
+        if((waiting & MCS_NODE_HALTED) != 0)
+        {
+            _mcs_pv_kick(waiting >> MCS_NODE_APIC_ID_SHIFT);
+        }
+    }
+    else
+    {
+        __atomic_store_n(&next->waiting, 0, __ATOMIC_RELEASE);
+    }
+}
+
+static void _mcs_wait(kernel_spinlock_node_t* node)
+{
+    uint32_t spins;
+
+    spins = 0;
+    while(__atomic_load_n(&node->waiting, __ATOMIC_ACQUIRE) != 0)
+    {
+        if(CPU_FEATURE_STATIC(CPU_FEATURE_KVM_PV_UNHALT) &&
+           ++spins >= MCS_PV_SPIN_COUNT)
+        {
+            _mcs_pv_halt(node);
+            spins = 0;
+        }
+        else
+        {
+            _cpu_pause();
+        }
+    }
+}
+
+static void _mcs_pv_halt(kernel_spinlock_node_t* node)
+{
+    uint32_t regs[4];
+    uint32_t halted;
+    uint32_t expected;
+    uint32_t int_state;
+
+    /* The lock functions cannot rely on the CPU local storage */
+    _cpu_cpuid_subleaf(0x1, 0, regs);
+    halted = MCS_NODE_HALTED |
+             ((regs[1] >> CPUID_EBX_APIC_ID_SHIFT) << MCS_NODE_APIC_ID_SHIFT);
+
+    /* An interrupt between the record and the halt could wait on another lock
+     * and consume our kick: the record is published with the interrupts
+     * disabled and STI enables them only once HLT executes.
+     */
+    int_state = _cpu_get_interrupt_state();
+    __asm__ __volatile__("cli" ::: "memory");
+
+    expected = 1;
+    if(__atomic_compare_exchange_n(&node->waiting, &expected, halted,
+                                   FALSE, __ATOMIC_ACQ_REL,
+                                   __ATOMIC_ACQUIRE) == TRUE ||
+       expected == halted)
+    {
+        if(int_state != 0)
+        {
+            __asm__ __volatile__("sti\n\thlt" ::: "memory");
+        }
+        else
+        {
+            __asm__ __volatile__("hlt" ::: "memory");
+        }
+    }
+    else if(int_state != 0)
+    {
+        __asm__ __volatile__("sti" ::: "memory");
+    }
+}
+
+static void _mcs_pv_kick(const uint32_t apic_id)
+{
+    uint32_t ret;
+
+    /* KVM translates VMCALL to VMMCALL on AMD CPUs */
+    __asm__ __volatile__("vmcall"
+                         : "=a"(ret)
+                         : "a"(KVM_HC_KICK_CPU), "b"(0), "c"(apic_id)
+                         : "memory");
+    (void)ret;
+}
+
+void cpu_lock_spinlock(kernel_spinlock_t* lock)
+{
+    if(lock->type == KERNEL_SPINLOCK_MCS)
+    {
+        _mcs_lock(lock);
+    }
+    else
+    {
+        _ticket_lock(lock);
+    }
+
+#if KERNEL_SPINLOCK_STATS
+    lock->lock_time = _cpu_rdtsc();
+    ++lock->lock_count;
+#endif
+}
+
+#if KERNEL_LOCKSTAT
+void cpu_lock_spinlock_site(kernel_spinlock_t* lock, lockstat_site_t* site)
+{
+    uint64_t start;
+    bool_t   contended;
+
+    start = _cpu_rdtsc();
+    if(lock->type == KERNEL_SPINLOCK_MCS)
+    {
+        contended = _mcs_lock(lock);
+    }
+    else
+    {
+        contended = _ticket_lock(lock);
+    }
+
+    lock->lockstat_site = site;
+    lock->lockstat_time = _cpu_rdtsc();
+    lockstat_record_acquire(site, contended, lock->lockstat_time - start);
+
+#if KERNEL_SPINLOCK_STATS
+    lock->lock_time = lock->lockstat_time;
+    ++lock->lock_count;
+#endif
+}
+#endif
+
+void cpu_unlock_spinlock(kernel_spinlock_t* lock)
+{
+#if KERNEL_SPINLOCK_STATS
+    uint64_t hold_time;
+
+    hold_time = _cpu_rdtsc() - lock->lock_time;
+    if(hold_time > lock->max_hold_time)
+    {
+        lock->max_hold_time = hold_time;
+    }
+#endif
+
+#if KERNEL_LOCKSTAT
+    if(lock->lockstat_site != NULL)
+    {
+        lockstat_record_release(lock->lockstat_site,
+                                _cpu_rdtsc() - lock->lockstat_time);
+        lock->lockstat_site = NULL;
+    }
+#endif
+
+    if(lock->type == KERNEL_SPINLOCK_MCS)
+    {
+        _mcs_unlock(lock);
+    }
+    else
+    {
+        _ticket_unlock(lock);
+    }
+}
+
+void cpu_lock_rwlock_read(kernel_rwlock_t* lock)
+{
+    uint32_t state;
+
+    while(TRUE)
+    {
+        /* The waiting writers go first */
+        state = __atomic_load_n(&lock->state, __ATOMIC_RELAXED);
+        if((state & KERNEL_RWLOCK_WRITER) == 0 &&
+           __atomic_load_n(&lock->waiting_writers, __ATOMIC_RELAXED) == 0 &&
+           __atomic_compare_exchange_n(&lock->state, &state, state + 1,
+                                       FALSE, __ATOMIC_ACQUIRE,
+                                       __ATOMIC_RELAXED) == TRUE)
+        {
+            return;
+        }
+        _cpu_pause();
+    }
+}
+
+void cpu_unlock_rwlock_read(kernel_rwlock_t* lock)
+{
+    __atomic_fetch_sub(&lock->state, 1, __ATOMIC_RELEASE);
+}
+
+void cpu_lock_rwlock_write(kernel_rwlock_t* lock)
+{
+    uint32_t state;
+
+    __atomic_fetch_add(&lock->waiting_writers, 1, __ATOMIC_RELAXED);
+    while(TRUE)
+    {
+        state = 0;
+        if(__atomic_compare_exchange_n(&lock->state, &state,
+                                       KERNEL_RWLOCK_WRITER,
+                                       FALSE, __ATOMIC_ACQUIRE,
+                                       __ATOMIC_RELAXED) == TRUE)
+        {
+            break;
+        }
+        _cpu_pause();
+    }
+    __atomic_fetch_sub(&lock->waiting_writers, 1, __ATOMIC_RELAXED);
+}
+
+void cpu_unlock_rwlock_write(kernel_rwlock_t* lock)
+{
+    __atomic_store_n(&lock->state, 0, __ATOMIC_RELEASE);
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
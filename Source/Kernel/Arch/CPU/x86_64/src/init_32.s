@@ -40,6 +40,11 @@ CHECKSUM    equ -(MAGIC + FLAGS)
 KERNEL_PML4_ENTRY    equ (KERNEL_MEM_OFFSET >> 39)
 KERNEL_PDPT_ENTRY    equ (KERNEL_MEM_OFFSET >> 30)
 KERNEL_PDT_ENTRY     equ (KERNEL_MEM_OFFSET >> 21)
+
+; LAPIC identity mapping, 2MB uncached page
+LAPIC_BASE_ADDR      equ 0xFEE00000
+LAPIC_PDPT_ENTRY     equ ((LAPIC_BASE_ADDR >> 30) & 0x1FF)
+LAPIC_PDT_ENTRY      equ ((LAPIC_BASE_ADDR >> 21) & 0x1FF)
 __kinit_low          equ (__kinit - KERNEL_MEM_OFFSET)
 
 ;-------------------------------------------------------------------------------
@@ -165,6 +170,15 @@ __kinit_init_pdt0:
     cmp eax, (_paging_pdt0 + 0x1000)
     jne __kinit_init_pdt0
 
+__kinit_init_lapic:
+    ; Map the LAPIC 1:1, it is used to start the APs
+    mov ebx, _paging_pdt_lapic
+    or  ebx, 0x3                      ; Present and writable
+    mov [_paging_pdpt0 + LAPIC_PDPT_ENTRY * 8], ebx
+    mov ebx, LAPIC_BASE_ADDR
+    or  ebx, 0x9B                     ; Present, writable, uncached, 2MB page
+    mov [_paging_pdt_lapic + LAPIC_PDT_ENTRY * 8], ebx
+
 __kinit_init_pml4tk:
     ; Set PML4T for kernel
     mov eax, KERNEL_PML4_ENTRY
@@ -437,6 +451,8 @@ _paging_pdt0:
     times 0x1000 db 0x00
 _paging_pdtk:
     times 0x1000 db 0x00
+_paging_pdt_lapic:
+    times 0x1000 db 0x00
 
 section .bss
 
@@ -0,0 +1,219 @@
+;-------------------------------------------------------------------------------
+;
+; File: init_ap.s
+;
+; Author: Alexy Torres Aurora Dugo
+;
+; Date: 14/10/2026
+;
+; Version: 1.0
+;
+; Application processors entry point. The startup code is copied by the BSP at
+; KERNEL_AP_BOOT_ADDR and executed by the APs after the startup IPI. It
+; switches the AP from real mode to long mode, using the page table given by
+; the BSP, then jumps to the high-memory kernel.
+; Each AP gets its identifier and its boot stack before calling the C AP
+; initialization routine.
+;-------------------------------------------------------------------------------
+
+;-------------------------------------------------------------------------------
+; INCLUDES
+;-------------------------------------------------------------------------------
+%include "config.inc"
+
+;-------------------------------------------------------------------------------
+; DEFINES
+;-------------------------------------------------------------------------------
+
+; Startup code segments selectors
+AP_CODE_32 equ (_kinit_ap_gdt.code_32 - _kinit_ap_gdt)
+AP_DATA_32 equ (_kinit_ap_gdt.data_32 - _kinit_ap_gdt)
+AP_CODE_64 equ (_kinit_ap_gdt.code_64 - _kinit_ap_gdt)
+
+;-------------------------------------------------------------------------------
+; MACRO DEFINE
+;-------------------------------------------------------------------------------
+
+; Physical address of a startup code symbol once copied in low memory
+%define AP_BOOT_ADDR(SYMBOL) (KERNEL_AP_BOOT_ADDR + ((SYMBOL) - __kinit_ap_start))
+
+;-------------------------------------------------------------------------------
+; EXTERN DATA
+;-------------------------------------------------------------------------------
+extern _KERNEL_STACKS_BASE
+extern _kernel_cpu_count
+
+;-------------------------------------------------------------------------------
+; EXTERN FUNCTIONS
+;-------------------------------------------------------------------------------
+extern cpu_ap_init
+
+;-------------------------------------------------------------------------------
+; EXPORTED FUNCTIONS
+;-------------------------------------------------------------------------------
+global __kinit_ap_start
+global __kinit_ap_end
+
+;-------------------------------------------------------------------------------
+; EXPORTED DATA
+;-------------------------------------------------------------------------------
+global _kinit_ap_cr3
+
+;-------------------------------------------------------------------------------
+; CODE
+;-------------------------------------------------------------------------------
+
+section .text
+align 16
+;-------------------------------------------------------------------------------
+; ARCH
+[bits 16]
+
+; APs startup code, position dependent: only valid at KERNEL_AP_BOOT_ADDR
+__kinit_ap_start:
+    cli
+    cld
+
+    ; CS is set by the startup IPI vector, use it as data segment
+    mov ax, cs
+    mov ds, ax
+
+    ; Set the protected mode GDT
+    lgdt [_kinit_ap_gdt_ptr - __kinit_ap_start]
+
+    ; Enable protected mode
+    mov eax, cr0
+    or  eax, 0x1
+    mov cr0, eax
+
+    jmp dword AP_CODE_32:AP_BOOT_ADDR(__kinit_ap_32b_entry)
+
+;-------------------------------------------------------------------------------
+; ARCH
+[bits 32]
+
+__kinit_ap_32b_entry:
+    ; Update data segments
+    mov eax, AP_DATA_32
+    mov ds, ax
+    mov es, ax
+    mov fs, ax
+    mov gs, ax
+    mov ss, ax
+
+    ; Enable PAE
+    mov eax, cr4
+    or  eax, 0x20
+    mov cr4, eax
+
+    ; Set CR3 with the page table given by the BSP
+    mov eax, [AP_BOOT_ADDR(_kinit_ap_cr3)]
+    mov cr3, eax
+
+    ; Switch to compatibility mode
+    mov ecx, 0xC0000080
+    rdmsr
+    or  eax, 0x00000100
+    wrmsr
+
+    ; Enable paging
+    mov eax, cr0
+    or  eax, 0x80010000
+    mov cr0, eax
+
+    ; Far jump to 64 bit mode
+    jmp AP_CODE_64:AP_BOOT_ADDR(__kinit_ap_64b_entry)
+
+;-------------------------------------------------------------------------------
+; ARCH
+[bits 64]
+
+__kinit_ap_64b_entry:
+    mov rax, __kinit_ap_x86_64
+    jmp rax
+
+;-------------------------------------------------------------------------------
+; Startup code temporary GDT
+align 8
+_kinit_ap_gdt:
+    .null:
+        dd 0x00000000
+        dd 0x00000000
+
+    .code_32:
+        dw 0xFFFF
+        dw 0x0000
+        db 0x00
+        db 0x9A
+        db 0xCF
+        db 0x00
+
+    .data_32:
+        dw 0xFFFF
+        dw 0x0000
+        db 0x00
+        db 0x92
+        db 0xCF
+        db 0x00
+
+    .code_64:
+        dw 0xFFFF
+        dw 0x0000
+        db 0x00
+        db 0x98
+        db 0x20
+        db 0x00
+
+_kinit_ap_gdt_ptr:
+    dw _kinit_ap_gdt_ptr - _kinit_ap_gdt - 1
+    dd AP_BOOT_ADDR(_kinit_ap_gdt)
+
+; Page table physical address, set by the BSP in the copied code
+_kinit_ap_cr3:
+    dd 0x00000000
+
+__kinit_ap_end:
+
+;-------------------------------------------------------------------------------
+; High-memory AP entry point
+__kinit_ap_x86_64:
+    ; Get the CPU identifier
+    mov eax, 1
+    mov rbx, _kernel_cpu_count
+    lock xadd [rbx], eax
+    cmp eax, MAX_CPU_COUNT
+    jae __kinit_ap_unsupported
+
+    ; Init stack, each CPU gets its boot stack
+    mov  edi, eax
+    lea  rax, [rdi + 1]
+    imul rax, rax, KERNEL_STACK_SIZE
+    mov  rbx, _KERNEL_STACKS_BASE
+    add  rax, rbx
+    sub  rax, 16
+    mov  rsp, rax
+    mov  rbp, rsp
+
+    ; Enable SSE
+    fninit
+    mov rax, cr0
+    and rax, 0xFFFFFFFFFFFFFFFB
+    or  rax, 0x0000000000000002
+    mov cr0, rax
+    mov rax, cr4
+    or  rax, 0x00000600
+    mov cr4, rax
+
+    ; CPU identifier is the first parameter, this should never return
+    call cpu_ap_init
+    jmp  __kinit_ap_end_loop
+
+__kinit_ap_unsupported:
+    ; This CPU is not supported, release its identifier
+    lock dec dword [rbx]
+
+__kinit_ap_end_loop:
+    ; Disable interrupt and loop forever
+    cli
+    hlt
+    jmp __kinit_ap_end_loop
@@ -21,6 +21,23 @@
 ; DEFINES
 ;-------------------------------------------------------------------------------
 
+; CPU local storage offsets, must match the layout given in cpu.h
+%define CPU_LOCAL_CURRENT_THREAD 0x00
+%define CPU_LOCAL_SWITCHED_OUT   0x10
+
+; RFLAGS interrupt enabled flag
+%define CPU_RFLAGS_IF 0x200
+
+; Size of the interrupt stubs, the IDT is built at link time from the stubs
+; base address and must match the linker script
+%define INT_STUB_SIZE 16
+
+; IDT entries values, must match the values given in cpu.c
+%define IDT_KERNEL_CS     0x28
+%define IDT_INT_GATE_PL0  0x8E
+%define IDT_EMERGENCY_IST 1
+%define IDT_FAULT_IST     2
+
 ;-------------------------------------------------------------------------------
 ; MACRO DEFINE
 ;-------------------------------------------------------------------------------
@@ -31,6 +48,8 @@ interrupt_handler_%1:
     push    0                       ; push 0 as dummy error code
     push    %1                      ; push the interrupt number
     jmp     __generic_interrupt_handler   ; jump to the common handler
+    times INT_STUB_SIZE - ($ - interrupt_handler_%1) db 0xCC ; pad to the
+                                       ; stub size
 %endmacro
 
 %macro err_code_interrupt_handler 1    ; Interrupt that do not come with an
@@ -40,19 +59,42 @@ global interrupt_handler_%1
 interrupt_handler_%1:
     push    %1                      ; push the interrupt number
     jmp     __generic_interrupt_handler   ; jump to the common handler
+    times INT_STUB_SIZE - ($ - interrupt_handler_%1) db 0xCC ; pad to the
+                                       ; stub size
+%endmacro
+
+%macro page_fault_interrupt_handler 1 ; Page fault, comes with an err code.
+
+global interrupt_handler_%1
+interrupt_handler_%1:
+    push    %1                      ; push the interrupt number
+    jmp     __page_fault_handler    ; jump to the page fault handler
+    times INT_STUB_SIZE - ($ - interrupt_handler_%1) db 0xCC ; pad to the
+                                       ; stub size
 %endmacro
 
 ;-------------------------------------------------------------------------------
 ; EXTERN DATA
 ;-------------------------------------------------------------------------------
+extern kernel_interrupt_fast_lines
 
-extern current_thread
+; Interrupt stubs base address parts, computed by the linker script
+extern _INT_STUBS_LOW
+extern _INT_STUBS_MID
+extern _INT_STUBS_HIGH
+
+;-------------------------------------------------------------------------------
+; EXPORTED DATA
+;-------------------------------------------------------------------------------
+global cpu_idt
 
 ;-------------------------------------------------------------------------------
 ; EXTERN FUNCTIONS
 ;-------------------------------------------------------------------------------
 
 extern kernel_interrupt_handler
+extern kernel_interrupt_fast_handler
+extern kstack_handle_fault
 
 ;-------------------------------------------------------------------------------
 ; EXPORTED FUNCTIONS
@@ -65,13 +107,29 @@ extern kernel_interrupt_handler
 
 section .text
 __generic_interrupt_handler:
+        ; Interrupts raised in the user space come with the user GS base,
+        ; get the CPU local storage one
+        test qword [rsp+24], 3
+        jz   .kernel_gs
+        swapgs
+.kernel_gs:
+
         ; Save a bit of context
         push rax
         push rbx
 
-        ; Get the current thread handle
-        mov rbx, current_thread
-        mov rax, [rbx]
+        ; Lines with a fast handler do not need the full context, unless the
+        ; interrupt must be blocked by the generic handler
+        mov rax, [rsp+16]  ; Int id
+        mov rbx, kernel_interrupt_fast_lines
+        cmp byte [rbx+rax], 0
+        je  .full_context
+        test qword [rsp+48], CPU_RFLAGS_IF
+        jnz __fast_interrupt_handler
+
+.full_context:
+        ; Get the current thread handle from the CPU local storage
+        mov rax, [gs:CPU_LOCAL_CURRENT_THREAD]
 
         ; Save the interrupt context
         mov rbx, [rsp+16]  ; Int id
@@ -124,13 +182,13 @@ __generic_interrupt_handler:
         ; call the C generic interrupt handler
         call kernel_interrupt_handler
 
-        ; Get the current thread handle
-        mov rbx, current_thread
-        mov rax, [rbx]
+        ; Get the current thread handle, it might have been changed by the
+        ; scheduler
+        mov rax, [gs:CPU_LOCAL_CURRENT_THREAD]
 
-        ; Restore registers
+        ; Restore registers, GS is not restored as it holds the CPU local
+        ; storage base
         mov ss, [rax+168]
-        mov gs, [rax+176]
         mov fs, [rax+184]
         mov es, [rax+192]
         mov ds, [rax+200]
@@ -145,6 +203,10 @@ __generic_interrupt_handler:
         mov r15, [rax+160]
 
         mov rsp, [rax+40]
+
+        ; We left the previous thread stack, it can now be used by other CPUs
+        mov qword [gs:CPU_LOCAL_SWITCHED_OUT], 0
+
         mov rbp, [rax+48]
         mov rdi, [rax+56]
         mov rsi, [rax+64]
@@ -153,19 +215,104 @@ __generic_interrupt_handler:
         mov rbx, [rax+88]
         mov rax, [rax+96]
 
+        ; Give the user GS base back when returning to the user space
+        test qword [rsp+8], 3
+        jz   .kernel_return
+        swapgs
+.kernel_return:
+
         ; Return from interrupt
         iretq
 
-    ; Now create handlers for each interrupt
-    err_code_interrupt_handler 8
-    err_code_interrupt_handler 10
-    err_code_interrupt_handler 11
-    err_code_interrupt_handler 12
-    err_code_interrupt_handler 13
-    err_code_interrupt_handler 14
-    err_code_interrupt_handler 17
-    err_code_interrupt_handler 30
+__fast_interrupt_handler:
+        ; Save the other caller saved registers, the handler preserves the
+        ; others. RAX holds the interrupt id.
+        push rcx
+        push rdx
+        push rsi
+        push rdi
+        push r8
+        push r9
+        push r10
+        push r11
 
+        ; The interrupt id and current thread are the handler parameters
+        mov rdi, rax
+        mov rsi, [gs:CPU_LOCAL_CURRENT_THREAD]
+
+        ; Align the stack on 16 bytes for the C call
+        sub rsp, 8
+        call kernel_interrupt_fast_handler
+        add rsp, 8
+
+        ; Restore registers
+        pop r11
+        pop r10
+        pop r9
+        pop r8
+        pop rdi
+        pop rsi
+        pop rdx
+        pop rcx
+        pop rbx
+        pop rax
+
+        ; Skip the interrupt id and error code
+        add rsp, 16
+
+        ; Give the user GS base back when returning to the user space
+        test qword [rsp+8], 3
+        jz   .kernel_return
+        swapgs
+.kernel_return:
+
+        ; Return from interrupt
+        iretq
+
+__page_fault_handler:
+        ; The user space faults are handled by the generic handler
+        test qword [rsp+24], 3
+        jnz  __generic_interrupt_handler
+
+        ; Save the caller saved registers, the stack stays aligned on 16
+        ; bytes for the C call
+        push rax
+        push rcx
+        push rdx
+        push rsi
+        push rdi
+        push r8
+        push r9
+        push r10
+        push r11
+
+        ; Commit the thread stack page, the faulting address is the parameter
+        mov  rdi, cr2
+        call kstack_handle_fault
+        test al, al
+
+        ; Restore registers, the flags are kept
+        pop r11
+        pop r10
+        pop r9
+        pop r8
+        pop rdi
+        pop rsi
+        pop rdx
+        pop rcx
+        pop rax
+
+        ; The other faults are handled by the generic handler
+        jz   __generic_interrupt_handler
+
+        ; Skip the interrupt id and error code, the access is retried
+        add rsp, 16
+        iretq
+
+; The stubs are sorted by interrupt line, the handler of line N is at
+; _INT_STUBS_BASE + N * INT_STUB_SIZE
+section .text.int_stubs progbits alloc exec nowrite align=4096
+    ; Now create handlers for each interrupt
     noerr_code_interrupt_handler 0
     noerr_code_interrupt_handler 1
     noerr_code_interrupt_handler 2
@@ -174,9 +321,16 @@ __generic_interrupt_handler:
     noerr_code_interrupt_handler 5
     noerr_code_interrupt_handler 6
     noerr_code_interrupt_handler 7
+    err_code_interrupt_handler 8
     noerr_code_interrupt_handler 9
+    err_code_interrupt_handler 10
+    err_code_interrupt_handler 11
+    err_code_interrupt_handler 12
+    err_code_interrupt_handler 13
+    page_fault_interrupt_handler 14
     noerr_code_interrupt_handler 15
     noerr_code_interrupt_handler 16
+    err_code_interrupt_handler 17
     noerr_code_interrupt_handler 18
     noerr_code_interrupt_handler 19
     noerr_code_interrupt_handler 20
@@ -189,6 +343,7 @@ __generic_interrupt_handler:
     noerr_code_interrupt_handler 27
     noerr_code_interrupt_handler 28
     noerr_code_interrupt_handler 29
+    err_code_interrupt_handler 30
     noerr_code_interrupt_handler 31
     noerr_code_interrupt_handler 32
     noerr_code_interrupt_handler 33
@@ -417,4 +572,30 @@ __generic_interrupt_handler:
 
 ;-------------------------------------------------------------------------------
 ; DATA
-;-------------------------------------------------------------------------------
\ No newline at end of file
+;-------------------------------------------------------------------------------
+
+; The IDT is built at link time from the stubs base address parts given by the
+; linker, each part is already at its place in the entry double words. The
+; stubs base is 4KB aligned, the low part never carries into the middle part.
+section .rodata
+align 16
+cpu_idt:
+%assign int_id 0
+%rep 256
+%if int_id == 2 || int_id == 8 || int_id == 18
+    %assign int_ist IDT_EMERGENCY_IST           ; NMI, #DF and #MC
+%elif int_id == 14
+    %assign int_ist IDT_FAULT_IST               ; #PF
+%else
+    %assign int_ist 0
+%endif
+    ; c_sel | off_low
+    dd (IDT_KERNEL_CS << 16) + _INT_STUBS_LOW + int_id * INT_STUB_SIZE
+    ; off_mid | flags | ist
+    dd _INT_STUBS_MID + (IDT_INT_GATE_PL0 << 8) + int_ist
+    ; off_hig
+    dd _INT_STUBS_HIGH
+    ; reserved1
+    dd 0
+%assign int_id int_id + 1
+%endrep
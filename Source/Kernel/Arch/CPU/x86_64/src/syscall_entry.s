@@ -0,0 +1,110 @@
+;-------------------------------------------------------------------------------
+;
+; File: syscall_entry.s
+;
+; Author: Alexy Torres Aurora Dugo
+;
+; Date: 14/10/2026
+;
+; Version: 1.0
+;
+; SYSCALL entry point of the user threads. Switches to the thread's kernel
+; stack and calls the C kernel system calls dispatcher, then returns to the
+; user space with SYSRET.
+;
+;-------------------------------------------------------------------------------
+;-------------------------------------------------------------------------------
+; ARCH
+;-------------------------------------------------------------------------------
+[bits 64]
+
+;-------------------------------------------------------------------------------
+; DEFINES
+;-------------------------------------------------------------------------------
+
+; CPU local storage offsets, must match the layout given in cpu.h
+%define CPU_LOCAL_KERNEL_STACK 0x18
+%define CPU_LOCAL_USER_STACK   0x20
+
+;-------------------------------------------------------------------------------
+; MACRO DEFINE
+;-------------------------------------------------------------------------------
+
+;-------------------------------------------------------------------------------
+; EXTERN DATA
+;-------------------------------------------------------------------------------
+
+;-------------------------------------------------------------------------------
+; EXTERN FUNCTIONS
+;-------------------------------------------------------------------------------
+
+extern syscall_dispatch
+
+;-------------------------------------------------------------------------------
+; EXPORTED FUNCTIONS
+;-------------------------------------------------------------------------------
+
+global cpu_syscall_entry
+
+;-------------------------------------------------------------------------------
+; CODE
+;-------------------------------------------------------------------------------
+
+section .text
+cpu_syscall_entry:
+        ; RCX holds the user RIP and R11 the user RFLAGS, the interrupts were
+        ; disabled by the RFLAGS mask. Get the CPU local storage and the
+        ; thread's kernel stack.
+        swapgs
+        mov [gs:CPU_LOCAL_USER_STACK], rsp
+        mov rsp, [gs:CPU_LOCAL_KERNEL_STACK]
+
+        ; Save the user return context on the thread's stack, the thread might
+        ; migrate once the interrupts are enabled
+        push qword [gs:CPU_LOCAL_USER_STACK]
+        push r11
+        push rcx
+
+        ; The dispatcher preserves RBX, RBP and R12 to R15, the other caller
+        ; saved registers are restored so that no kernel value leaks to the
+        ; user space
+        push rdi
+        push rsi
+        push rdx
+        push r10
+        push r8
+        push r9
+
+        sti
+
+        ; The arguments are in RDI, RSI, RDX, R10 and R8, the system call
+        ; identifier in RAX. The identifier is the dispatcher last parameter.
+        mov rcx, r10
+        mov r9,  rax
+
+        ; Align the stack on 16 bytes for the C call
+        sub rsp, 8
+        call syscall_dispatch
+        add rsp, 8
+
+        ; RAX holds the return value
+        cli
+
+        pop r9
+        pop r8
+        pop r10
+        pop rdx
+        pop rsi
+        pop rdi
+
+        pop rcx
+        pop r11
+        pop rsp
+
+        ; Give the user GS base back and return to the user space
+        swapgs
+        o64 sysret
+
+;-------------------------------------------------------------------------------
+; DATA
+;-------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,159 @@
+/*******************************************************************************
+ * @file bcache.h
+ *
+ * @see bcache.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's block cache.
+ *
+ * @details Kernel's block cache. The file systems get the device blocks from
+ * the cache and release them once read, a block is only read from its device
+ * when it is not cached. The unused blocks are evicted with the CLOCK
+ * algorithm and the sequential misses read the following blocks ahead with a
+ * single device read.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_BCACHE_H_
+#define __CORE_BCACHE_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>    /* Generic int types */
+#include <blkdev.h>    /* Block devices */
+#include <semaphore.h> /* Kernel semaphores */
+#include <kerror.h>    /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of blocks held by the cache. */
+#define BCACHE_BLOCK_COUNT 128
+
+/** @brief Number of buckets of the cache lookup table, a power of 2. */
+#define BCACHE_HASH_SIZE 64
+
+/** @brief Maximal number of blocks read by a sequential miss. */
+#define BCACHE_READ_AHEAD 16
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Cached block. The fields after data are managed by the cache. */
+typedef struct
+{
+    /** @brief The block data, BLKDEV_BLOCK_SIZE bytes. */
+    const uint8_t* data;
+
+    /** @brief The block device, NULL if the entry is free. */
+    blkdev_t* dev;
+
+    /** @brief The block number on the device. */
+    uint64_t block;
+
+    /** @brief Number of users of the block. */
+    uint32_t ref_count;
+
+    /** @brief CLOCK referenced bit, set by the lookups. */
+    bool_t referenced;
+
+    /** @brief The block loading state, an OS_RETURN_E once loaded. */
+    volatile int32_t state;
+
+    /** @brief Next entry of the lookup bucket, -1 at the end. */
+    int32_t next;
+
+    /** @brief Number of users waiting for the block to be loaded. */
+    uint32_t waiters;
+
+    /** @brief Posted once per waiting user when the block is loaded. */
+    semaphore_t loaded;
+} bcache_block_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the block cache.
+ */
+void bcache_init(void);
+
+/**
+ * @brief Gets a device block.
+ *
+ * @details Gets a device block, reading it from the device if it is not
+ * cached. The block stays cached until it is released with bcache_release.
+ * The device read is done without the cache lock, the other users of the
+ * block wait for it.
+ *
+ * @param[in] dev The block device.
+ * @param[in] block The block number on the device.
+ * @param[out] cached The buffer receiving the cached block.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if dev or cached is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the block is out of the device.
+ * - OS_ERR_NO_MORE_MEMORY is returned if all the cached blocks are used.
+ * - The device read error is returned if the block could not be read.
+ */
+OS_RETURN_E bcache_get(blkdev_t* dev,
+                       const uint64_t block,
+                       bcache_block_t** cached);
+
+/**
+ * @brief Releases a block returned by bcache_get.
+ *
+ * @param[in] cached The cached block.
+ */
+void bcache_release(bcache_block_t* cached);
+
+/**
+ * @brief Evicts the unused blocks of a device.
+ *
+ * @details Evicts the unused blocks of a device, called before the device is
+ * removed.
+ *
+ * @param[in] dev The block device.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if dev is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if a block of the device is still
+ * used, the unused ones are evicted.
+ */
+OS_RETURN_E bcache_invalidate(blkdev_t* dev);
+
+#endif /* #ifndef __CORE_BCACHE_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,115 @@
+/*******************************************************************************
+ * @file blkdev.h
+ *
+ * @see bcache.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's block devices interface.
+ *
+ * @details Kernel's block devices interface. The block devices drivers fill a
+ * block device structure with their geometry and routines, the file systems
+ * then read the device blocks through the block cache. Devices backed by
+ * memory give a map routine, their blocks are then cached without copy.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_BLKDEV_H_
+#define __CORE_BLKDEV_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Size of the blocks of the block devices in bytes. */
+#define BLKDEV_BLOCK_SIZE 512
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Block device. */
+typedef struct blkdev
+{
+    /** @brief The device name. */
+    const char* name;
+
+    /** @brief Number of blocks of the device. */
+    uint64_t block_count;
+
+    /**
+     * @brief Reads consecutive blocks of the device.
+     *
+     * @param[in] dev The device.
+     * @param[in] block The first block to read.
+     * @param[in] count The number of blocks to read.
+     * @param[out] buffer The buffer receiving the blocks.
+     *
+     * @return The success state or the error code.
+     */
+    OS_RETURN_E (*read)(struct blkdev* dev,
+                        const uint64_t block,
+                        const uint32_t count,
+                        void* buffer);
+
+    /**
+     * @brief Returns the address of a block of a memory backed device, NULL
+     * for the other devices.
+     *
+     * @param[in] dev The device.
+     * @param[in] block The block.
+     *
+     * @return The address of the block, valid for the device lifetime.
+     */
+    const void* (*map)(struct blkdev* dev, const uint64_t block);
+
+    /** @brief The driver's data. */
+    void* driver_ctrl;
+
+    /** @brief The block following the last missed block, used by the block
+     * cache to detect the sequential reads.
+     */
+    uint64_t next_block;
+} blkdev_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/* None */
+
+#endif /* #ifndef __CORE_BLKDEV_H_ */
+
+/************************************ EOF *************************************/
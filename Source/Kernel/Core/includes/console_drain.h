@@ -0,0 +1,85 @@
+/*******************************************************************************
+ * @file console_drain.h
+ *
+ * @see console_drain.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's console drain.
+ *
+ * @details Kernel's console drain. The console drain gives each registered
+ * console driver a queue and a low priority kernel thread that sends the queued
+ * output to the driver. The threads wait until output is queued for their
+ * driver. The kernel log is rendered to the console by another drain thread.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_CONSOLE_DRAIN_H_
+#define __CORE_CONSOLE_DRAIN_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the console drain.
+ *
+ * @details Creates a drain thread for each registered console driver and
+ * enables the driver queue. The drivers registered later stay synchronous.
+ * The kernel log is then enabled and its drain thread created. This function
+ * must be called after the scheduler was initialized.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the drain is already
+ * initialized.
+ * - Any error returned by the scheduler when creating the drain threads, the
+ * drivers which thread was not created stay synchronous.
+ */
+OS_RETURN_E console_drain_init(void);
+
+#endif /* #ifndef __CORE_CONSOLE_DRAIN_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,261 @@
+/*******************************************************************************
+ * @file crash_dump.h
+ *
+ * @see crash_dump.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's panic crash record.
+ *
+ * @details Kernel's panic crash record. The panic handler writes a fixed
+ * layout record in the KERNEL_CRASH_DUMP memory region: the panic cause, the
+ * CPU state, the stack of the faulting context, the threads states, the
+ * active trace packet of the faulting CPU and a copy of the panic screen,
+ * whose end holds the kernel log tail. The region is not cleared at boot, the
+ * record survives a warm reset and is exported on the kernel output by the
+ * next boot.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_CRASH_DUMP_H_
+#define __CORE_CRASH_DUMP_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>     /* Generic int types */
+#include <kerror.h>     /* Kernel error codes */
+#include <cpu.h>        /* CPU structures */
+#include <ctrl_block.h> /* Thread structures */
+
+/* Configuration files */
+#include <config.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Crash record magic, "CRSH". */
+#define CRASH_DUMP_MAGIC 0x48535243
+
+/** @brief Magic of a crash record already exported, "CRSX". */
+#define CRASH_DUMP_MAGIC_EXPORTED 0x58535243
+
+/** @brief Crash record layout version. */
+#define CRASH_DUMP_VERSION 1
+
+/** @brief Number of addresses recorded in the faulting context stack. */
+#define CRASH_DUMP_STACK_DEPTH 16
+
+/** @brief Number of threads recorded. */
+#define CRASH_DUMP_MAX_THREADS (KERNEL_MAX_THREAD_COUNT + MAX_CPU_COUNT)
+
+/** @brief Size of the recorded strings, terminator included. */
+#define CRASH_DUMP_NAME_SIZE    16
+#define CRASH_DUMP_MESSAGE_SIZE 96
+#define CRASH_DUMP_FILE_SIZE    64
+
+/** @brief Size of the trace packet area in bytes, a trace packet size. */
+#define CRASH_DUMP_TRACE_SIZE 8192
+
+/** @brief Size of the panic screen copy in bytes. */
+#define CRASH_DUMP_TEXT_SIZE 8192
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief State of a thread at the moment of the panic. */
+typedef struct
+{
+    /** @brief Thread's identifier. */
+    int32_t tid;
+
+    /** @brief Thread's state, a THREAD_STATE_E value. */
+    uint8_t state;
+
+    /** @brief Thread's wait type, a THREAD_WAIT_TYPE_E value. */
+    uint8_t block_type;
+
+    /** @brief Thread's current priority. */
+    uint8_t priority;
+
+    /** @brief CPU whose ready queues the thread was last put in. */
+    uint8_t cpu_id;
+
+    /** @brief Instruction pointer saved in the thread's context. */
+    uint64_t pc;
+
+    /** @brief Thread's name. */
+    char name[CRASH_DUMP_NAME_SIZE];
+} crash_dump_thread_t;
+
+/** @brief Crash record, written by the panic handler. The header fields
+ * precede the checksummed content so that exporting the record only updates
+ * the magic.
+ */
+typedef struct
+{
+    /** @brief CRASH_DUMP_MAGIC once the record is complete. */
+    uint32_t magic;
+
+    /** @brief CRASH_DUMP_VERSION. */
+    uint32_t version;
+
+    /** @brief Size of the record in bytes. */
+    uint32_t size;
+
+    /** @brief FNV-1a hash of the record, from crash_count to the end. */
+    uint32_t checksum;
+
+    /** @brief Number of panics recorded since the region was last
+     * invalid, a crash loop shows as a growing count.
+     */
+    uint32_t crash_count;
+
+    /** @brief Panic error code. */
+    uint32_t panic_code;
+
+    /** @brief Interrupt that led to the panic, PANIC_INT_LINE for a kernel
+     * panic.
+     */
+    uint32_t int_id;
+
+    /** @brief CPU that panicked. */
+    uint32_t cpu_id;
+
+    /** @brief Thread that panicked. */
+    int32_t tid;
+
+    /** @brief Source line of the panic. */
+    uint32_t line;
+
+    /** @brief Number of addresses in stack. */
+    uint32_t stack_depth;
+
+    /** @brief Number of entries in threads. */
+    uint32_t thread_count;
+
+    /** @brief Size of the trace packet in trace, 0 if none. */
+    uint32_t trace_size;
+
+    /** @brief Number of characters in text. */
+    uint32_t text_length;
+
+    /** @brief Timestamp counter of the panic, read on the CPU that
+     * panicked.
+     */
+    uint64_t tsc;
+
+    /** @brief Faulting context stack, the faulting instruction first. */
+    uint64_t stack[CRASH_DUMP_STACK_DEPTH];
+
+    /** @brief Panic module. */
+    char module[CRASH_DUMP_NAME_SIZE];
+
+    /** @brief Panic message. */
+    char message[CRASH_DUMP_MESSAGE_SIZE];
+
+    /** @brief Panic source file. */
+    char file[CRASH_DUMP_FILE_SIZE];
+
+    /** @brief Virtual CPU of the thread that panicked. */
+    virtual_cpu_t vcpu;
+
+    /** @brief Threads states. */
+    crash_dump_thread_t threads[CRASH_DUMP_MAX_THREADS];
+
+    /** @brief Active trace packet of the CPU that panicked. */
+    uint32_t trace[CRASH_DUMP_TRACE_SIZE / sizeof(uint32_t)];
+
+    /** @brief Copy of the panic screen, not terminated. */
+    char text[CRASH_DUMP_TEXT_SIZE];
+} crash_dump_record_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Exports the crash record left by the previous boot.
+ *
+ * @details Exports the crash record left by the previous boot on the kernel
+ * output, if the region holds a valid record not yet exported. The record is
+ * printed between "#CRASH_START <crash_count>" and "#CRASH_END" lines, then
+ * marked exported. The record stays readable with crash_dump_get_record.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered, a record was found or
+ * not.
+ * - OS_ERR_OUT_OF_BOUND is returned if the record does not fit the region.
+ */
+OS_RETURN_E crash_dump_init(void);
+
+/**
+ * @brief Returns the crash record found at boot.
+ *
+ * @return The crash record left by the previous boot, NULL if there was none.
+ */
+const crash_dump_record_t* crash_dump_get_record(void);
+
+/**
+ * @brief Starts recording a panic.
+ *
+ * @details Starts recording a panic. The record is invalidated, then filled
+ * with the panic cause, the faulting context and the threads states, and the
+ * kernel output is copied in the record until crash_dump_end is called. Only
+ * the first panic is recorded, the nested and concurrent panics are ignored.
+ * This function is meant to be called by the panic handler with interrupts
+ * disabled.
+ *
+ * @param[in] thread The thread that panicked.
+ * @param[in] panic_code The panic error code.
+ * @param[in] module The panic module.
+ * @param[in] msg The panic message.
+ * @param[in] file The panic source file.
+ * @param[in] line The panic source line.
+ */
+void crash_dump_start(const kernel_thread_t* thread,
+                      const uint32_t panic_code,
+                      const char* module,
+                      const char* msg,
+                      const char* file,
+                      const uint32_t line);
+
+/**
+ * @brief Completes the panic record.
+ *
+ * @details Completes the panic record started by crash_dump_start, stops the
+ * kernel output copy and seals the record. The record is valid once this
+ * function returns.
+ */
+void crash_dump_end(void);
+
+#endif /* #ifndef __CORE_CRASH_DUMP_H_ */
+
+/************************************ EOF *************************************/
@@ -5,7 +5,7 @@
  *
  * @date 21/04/2023
  *
- * @version 3.0
+ * @version 3.2
  *
  * @brief Kernel control block structures definitions.
  *
@@ -24,7 +24,9 @@
  ******************************************************************************/
 
 #include <stdint.h>       /* Generic int types */
+#include <stddef.h>       /* Standard definitions */
 #include <cpu.h>          /* CPU structures */
+#include <rcu.h>          /* RCU callback node */
 
 /*******************************************************************************
  * CONSTANTS
@@ -33,6 +35,9 @@
 /** @brief Maximal thead's name length. */
 #define THREAD_NAME_MAX_LENGTH 32
 
+/** @brief Number of buckets of the threads wait time histograms. */
+#define THREAD_WAIT_HISTOGRAM_SIZE 24
+
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
@@ -60,7 +65,9 @@ typedef enum
     /** @brief The thread is waiting to acquire a resource (e.g mutex, sem). */
     THREAD_WAIT_TYPE_RESOURCE,
     /** @brief The thread is waiting to acquire an IO entry. */
-    THREAD_WAIT_TYPE_IO
+    THREAD_WAIT_TYPE_IO,
+    /** @brief Number of wait types. */
+    THREAD_WAIT_TYPE_COUNT
 } THREAD_WAIT_TYPE_E;
 
 /** @brief Defines the possitble return state of a thread. */
@@ -94,8 +101,108 @@ typedef enum
     THREAD_TYPE_USER
 } THREAD_TYPE_E;
 
-/** @brief This is the representation of the thread for the kernel. */
+/** @brief Defines the thread's scheduling classes. */
+typedef enum
+{
+    /** @brief Fixed priority scheduling, the highest priority is elected. */
+    THREAD_SCHED_FIXED,
+    /** @brief Deadline scheduling, the earliest deadline is elected before
+     * the fixed priority threads.
+     */
+    THREAD_SCHED_DEADLINE
+} THREAD_SCHED_CLASS_E;
+
+/** @brief Thread's execution statistics, updated by the scheduler and the
+ * interrupt manager.
+ */
 typedef struct
+{
+    /** @brief Cumulative number of TSC cycles the thread was elected for,
+     * including the time spent in interrupt handlers.
+     */
+    uint64_t run_cycles;
+
+    /** @brief Cumulative number of TSC cycles spent in the interrupt handlers
+     * that interrupted the thread.
+     */
+    uint64_t irq_cycles;
+
+    /** @brief TSC value when the thread was last elected. */
+    uint64_t elected_tsc;
+
+    /** @brief Number of times the thread gave the CPU: yield, sleep, wait or
+     * exit.
+     */
+    uint32_t voluntary_switches;
+
+    /** @brief Number of times the thread was preempted while it could still
+     * run.
+     */
+    uint32_t involuntary_switches;
+
+    /** @brief Time in nanoseconds when the thread started its current wait. */
+    uint64_t wait_start_time;
+
+    /** @brief Longest wait in nanoseconds, per wait type. */
+    uint64_t max_wait_time[THREAD_WAIT_TYPE_COUNT];
+
+    /** @brief Log2 histograms of the wait times per wait type, bucket N
+     * counts the waits of [2^(N+10), 2^(N+11)[ nanoseconds. The first bucket
+     * also counts the shorter waits and the last one the longer waits.
+     */
+    uint32_t wait_histogram[THREAD_WAIT_TYPE_COUNT]
+                           [THREAD_WAIT_HISTOGRAM_SIZE];
+} thread_stats_t;
+
+/** @brief Thread's deadline scheduling parameters and state, the times are
+ * in nanoseconds of uptime.
+ */
+typedef struct
+{
+    /** @brief Execution time granted to each instance. */
+    uint64_t runtime;
+
+    /** @brief Deadline of each instance, relative to its release. */
+    uint64_t rel_deadline;
+
+    /** @brief Time between two instances releases. */
+    uint64_t period;
+
+    /** @brief Absolute deadline of the current instance. */
+    uint64_t deadline;
+
+    /** @brief Budget left to the current instance. */
+    uint64_t remaining;
+
+    /** @brief Uptime when the thread was last elected. */
+    uint64_t elected_time;
+
+    /** @brief Bandwidth reserved by the thread, runtime over relative
+     * deadline in the scheduler fixed point format.
+     */
+    uint32_t bandwidth;
+
+    /** @brief Identifier of the CPU the bandwidth is reserved on. */
+    uint32_t cpu_id;
+
+    /** @brief Number of instances that completed after their deadline. */
+    uint32_t missed_deadlines;
+
+    /** @brief Tells if the thread used its budget and waits for its next
+     * release.
+     */
+    bool_t throttled;
+} thread_deadline_t;
+
+/* Forward declarations */
+struct elf_process;
+
+/** @brief This is the representation of the thread for the kernel. The
+ * fields read on every scheduling decision share one cache line, right after
+ * the virtual CPU. The control blocks are cache line aligned so that threads
+ * running on different CPUs never share a line.
+ */
+typedef struct kernel_thread
 {
     /** @brief Thread's virtual CPU context, must be at the begining of the
      * structure for easie interface with assembly.
@@ -103,24 +210,28 @@ typedef struct
     virtual_cpu_t v_cpu;
 
     /**************************************
-     * Thread properties
+     * Scheduling
      *************************************/
 
-    /** @brief Thread's identifier. */
-    int32_t tid;
+    /** @brief Next thread in the scheduler queue the thread is linked to. */
+    struct kernel_thread* next_thread
+        __attribute__((aligned(CPU_CACHE_LINE_SIZE)));
 
-    /** @brief Thread's name. */
-    char name[THREAD_NAME_MAX_LENGTH];
+    /** @brief Previous thread in the scheduler queue the thread is linked
+     * to.
+     */
+    struct kernel_thread* prev_thread;
 
-    /** @brief Thread's type. */
-    THREAD_TYPE_E type;
+    /** @brief Wake up time limit for the sleeping thread. */
+    uint64_t wakeup_time;
 
-    /**************************************
-     * State management
-     *************************************/
+    /** @brief Position of the thread in the timer heap it waits in,
+     * TIMER_HEAP_NO_INDEX when the thread is not in a timer heap.
+     */
+    uint32_t timer_heap_index;
 
-    /** @brief Thread's current priority. */
-    uint8_t priority;
+    /** @brief Thread's identifier. */
+    int32_t tid;
 
     /** @brief Thread's current state. */
     THREAD_STATE_E state;
@@ -130,6 +241,62 @@ typedef struct
      */
     THREAD_WAIT_TYPE_E block_type;
 
+    /** @brief Thread's current priority, raised above the base priority by
+     * the priority inheritance.
+     */
+    uint8_t priority;
+
+    /** @brief Identifier of the CPU whose ready queues the thread was last
+     * put in.
+     */
+    uint32_t ready_cpu_id;
+
+    /** @brief CPUs the thread can run on, one bit per CPU. */
+    uint32_t cpu_affinity;
+
+    /** @brief Thread's scheduling class. */
+    THREAD_SCHED_CLASS_E sched_class;
+
+    /**************************************
+     * Deadline scheduling
+     *************************************/
+
+    /** @brief Deadline parameters and state, only relevant in the
+     * THREAD_SCHED_DEADLINE class.
+     */
+    thread_deadline_t dl;
+
+    /**************************************
+     * Stacks
+     *************************************/
+
+    /** @brief Thread's stack. */
+    uintptr_t stack;
+
+    /** @brief Thread's stack size. */
+    uint32_t stack_size;
+
+    /** @brief Thread's interrupt stack, the kernel stack of the user threads
+     * system calls.
+     */
+    uintptr_t int_stack;
+
+    /** @brief Thread's interrupt stack size. */
+    uint32_t int_stack_size;
+
+    /**************************************
+     * Time management
+     *************************************/
+
+    /** @brief Thread's start time. */
+    uint64_t start_time;
+
+    /** @brief Thread's end time. */
+    uint64_t end_time;
+
+    /** @brief Thread's execution statistics. */
+    thread_stats_t stats;
+
     /**************************************
      * System interface
      *************************************/
@@ -154,34 +321,70 @@ typedef struct
     THREAD_TERMINATE_CAUSE_E terminate_cause;
 
     /**************************************
-     * Stacks
+     * Thread properties
      *************************************/
 
-    /** @brief Thread's stack. */
-    uintptr_t stack;
+    /** @brief Thread's type. */
+    THREAD_TYPE_E type;
 
-    /** @brief Thread's stack size. */
-    uint32_t stack_size;
+    /** @brief Program of the user threads, its pages are faulted in on
+     * demand. NULL for the kernel threads.
+     */
+    struct elf_process* process;
 
-    /** @brief Thread's interrupt stack. */
-    uintptr_t int_stack;
+    /** @brief Thread's name. */
+    char name[THREAD_NAME_MAX_LENGTH];
 
-    /** @brief Thread's interrupt stack size. */
-    uint32_t int_stack_size;
+    /**************************************
+     * Synchronization
+     *************************************/
+
+    /** @brief Thread's assigned priority, without priority inheritance. */
+    uint8_t base_priority;
+
+    /** @brief Number of priority inheritance mutexes held by the thread. The
+     * inherited priority is dropped once the last one is released.
+     */
+    uint32_t pi_mutex_count;
+
+    /** @brief Node releasing the zombie thread once no lockless reader can
+     * reference it anymore.
+     */
+    rcu_head_t rcu_head;
 
     /**************************************
-     * Time management
+     * Extended CPU state
      *************************************/
 
-    /** @brief Wake up time limit for the sleeping thread. */
-    uint64_t wakeup_time;
+    /** @brief Identifier of the CPU whose FPU registers hold the thread's
+     * extended state, MAX_CPU_COUNT if none.
+     */
+    uint32_t fpu_cpu_id;
 
-    /** @brief Thread's start time. */
-    uint64_t start_time;
+    /** @brief Tells if fpu_state holds the thread's extended state. Threads
+     * that never used the FPU get the clean boot state.
+     */
+    bool_t fpu_state_valid;
 
-    /** @brief Thread's end time. */
-    uint64_t end_time;
-} kernel_thread_t;
+    /** @brief Thread's FPU, SSE and AVX state, saved by the scheduler when
+     * the thread used the FPU during its time slice.
+     */
+    uint8_t fpu_state[CPU_FPU_STATE_SIZE]
+        __attribute__((aligned(CPU_FPU_STATE_ALIGN)));
+} __attribute__((aligned(CPU_CACHE_LINE_SIZE))) kernel_thread_t;
+
+/* The interrupt entry and exit paths save the context at the thread address */
+_Static_assert(offsetof(kernel_thread_t, v_cpu) == 0,
+               "The virtual CPU must start the thread control block");
+
+/* The scheduling hot fields must fit in a single cache line */
+_Static_assert(offsetof(kernel_thread_t, next_thread) %
+               CPU_CACHE_LINE_SIZE == 0,
+               "Thread scheduling fields are not cache line aligned");
+_Static_assert(offsetof(kernel_thread_t, sched_class) +
+               sizeof(THREAD_SCHED_CLASS_E) <=
+               offsetof(kernel_thread_t, next_thread) + CPU_CACHE_LINE_SIZE,
+               "Thread scheduling fields span several cache lines");
 
 /*******************************************************************************
  * MACROS
@@ -0,0 +1,235 @@
+/*******************************************************************************
+ * @file elf.h
+ *
+ * @see elf.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's ELF programs loader.
+ *
+ * @details Kernel's ELF programs loader. A program is loaded from a file
+ * held in place by its device, such as the initial ram disk, without reading
+ * it: loading only parses the headers and creates the process address space,
+ * no page is mapped. The pages are faulted in on first touch. The read only
+ * pages fully backed by the file map the file frames directly, they are
+ * shared by all the processes running the program. The other pages get a
+ * private frame, filled from the file and zeroed after the file data. The
+ * pages holding no file data map a single shared zero page until they are
+ * written. A process can be cloned without copying its memory: the private
+ * pages are shared copy-on-write.
+ * The programs are ELF executables of the CPU class and machine, the
+ * dynamically linked programs are not supported.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_ELF_H_
+#define __CORE_ELF_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>     /* Generic int types */
+#include <stddef.h>     /* Standard definitions */
+#include <critical.h>   /* Kernel spinlocks */
+#include <vmm.h>        /* Virtual memory manager */
+#include <kerror.h>     /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Maximal number of loadable segments of a program. */
+#define ELF_MAX_SEGMENTS 8
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Loaded segment, a page aligned range of the process space. */
+typedef struct
+{
+    /** @brief The first page of the segment. */
+    uintptr_t start;
+
+    /** @brief The page following the segment. */
+    uintptr_t end;
+
+    /** @brief Offset in the file of the first page of the segment. */
+    size_t file_offset;
+
+    /** @brief End address of the segment file data, the following bytes of
+     * the segment are zeroed. Equal to start for the zero filled segments.
+     */
+    uintptr_t data_end;
+
+    /** @brief The VMM_FLAG_* mapping flags of the segment pages. */
+    uint32_t flags;
+} elf_segment_t;
+
+/** @brief Parsed program, shared by the processes running it. */
+typedef struct elf_image
+{
+    /** @brief The program file data, held in place by its device. */
+    const uint8_t* data;
+
+    /** @brief The program file size. */
+    size_t size;
+
+    /** @brief The program entry point. */
+    uintptr_t entry_point;
+
+    /** @brief The loadable segments, sorted by address. */
+    elf_segment_t segments[ELF_MAX_SEGMENTS];
+
+    /** @brief The number of loadable segments. */
+    uint32_t segment_count;
+
+    /** @brief Number of processes running the program. */
+    uint32_t refcount;
+
+    /** @brief Next image of the loaded images list. */
+    struct elf_image* next;
+} elf_image_t;
+
+/** @brief Loaded process. */
+typedef struct elf_process
+{
+    /** @brief The process address space. */
+    vmm_space_t* space;
+
+    /** @brief The program run by the process. */
+    elf_image_t* image;
+
+    /** @brief The user stack segment, zero filled. */
+    elf_segment_t stack;
+
+    /** @brief The address following the user stack, its initial stack
+     * pointer.
+     */
+    uintptr_t stack_top;
+
+    /** @brief Number of pages mapped on the program file frames. */
+    uint32_t shared_pages;
+
+    /** @brief Number of pages mapped on private frames, shared
+     * copy-on-write with the clones of the process or not.
+     */
+    uint32_t private_pages;
+
+    /** @brief Number of pages mapped on the zero frame. */
+    uint32_t zero_pages;
+
+    /** @brief Serializes the page faults of the process threads. */
+    kernel_spinlock_t lock;
+} elf_process_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the ELF loader.
+ *
+ * @details Allocates the zero frame and registers the page fault handler
+ * faulting in the pages of the processes and resolving their copy-on-write
+ * pages. The faults of the threads that run no process, or that hit no page
+ * of their process, raise a kernel panic as the unhandled exceptions.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - Any error returned by memmgt_alloc_frames, vmm_map or
+ * kernel_interrupt_register_exception_handler.
+ */
+OS_RETURN_E elf_init(void);
+
+/**
+ * @brief Loads a program.
+ *
+ * @details Parses the program headers and creates the address space of a new
+ * process, without mapping any page. The program file must be held in place
+ * by its device and its mount point must stay mounted while the process
+ * exists. The programs already loaded are not parsed again. The threads
+ * running the process reference it in their control block and run in its
+ * address space.
+ *
+ * @param[in] path The absolute path of the program file.
+ * @param[out] process The buffer receiving the process.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if path or process is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if the file is not held in place, is
+ * not an executable of the CPU or has more than ELF_MAX_SEGMENTS loadable
+ * segments.
+ * - OS_ERR_CORRUPTED_DATA is returned if the file is not a valid ELF file or
+ * its segments do not fit the user range.
+ * - OS_ERR_NO_MORE_MEMORY is returned if the process could not be allocated.
+ * - Any error returned by vfs_open or vmm_space_create.
+ */
+OS_RETURN_E elf_load(const char* path, elf_process_t** process);
+
+/**
+ * @brief Clones a process.
+ *
+ * @details Creates a process running the same program with a copy of the
+ * process memory. No memory is copied: the private pages are shared
+ * copy-on-write by both processes and the other pages are shared as they are.
+ * The pages not faulted in yet are faulted in by each process.
+ *
+ * @param[in, out] process The process to clone.
+ * @param[out] clone The buffer receiving the created process.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if process or clone is NULL.
+ * - OS_ERR_NO_MORE_MEMORY is returned if the process could not be allocated.
+ * - Any error returned by vmm_space_clone.
+ */
+OS_RETURN_E elf_clone(elf_process_t* process, elf_process_t** clone);
+
+/**
+ * @brief Destroys a process.
+ *
+ * @details Drops the references to the private frames, then releases the
+ * address space and the process.
+ * The program is released with its last process. No thread may run the
+ * process anymore and its address space must not be loaded by any CPU.
+ *
+ * @param[in] process The process to destroy.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if process is NULL.
+ * - Any error returned by vmm_space_destroy, the pages of the process are
+ * then released but the process is kept.
+ */
+OS_RETURN_E elf_destroy(elf_process_t* process);
+
+#endif /* #ifndef __CORE_ELF_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,113 @@
+/*******************************************************************************
+ * @file gcov.h
+ *
+ * @see gcov.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's execution profile runtime.
+ *
+ * @details Kernel's execution profile runtime, used by the profile guided
+ * optimization builds (PGO=GEN). The compiler instruments the kernel with
+ * arcs counters and registers each object profile information with
+ * __gcov_init. The profile is output on the kernel output as text records
+ * holding the GCC gcda files, the records are converted back to the gcda
+ * files by Tools/PGO and used by the optimized build (PGO=TRUE).
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_GCOV_H_
+#define __CORE_GCOV_H_
+
+#ifdef _PGO_GENERATE_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Tag starting the profile records on the kernel output. */
+#define GCOV_STREAM_TAG "#GCDA# "
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Object profile information, generated by the compiler. */
+struct gcov_info;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Registers an object profile information.
+ *
+ * @details Registers an object profile information. This function is called
+ * by the constructors emitted by the compiler in the instrumented objects,
+ * the constructors are run by gcov_dump.
+ *
+ * @param[in] info The object profile information.
+ */
+void __gcov_init(struct gcov_info* info);
+
+/**
+ * @brief Called by the destructors emitted by the compiler, the kernel does
+ * not run the destructors.
+ */
+void __gcov_exit(void);
+
+/**
+ * @brief Merges arcs counters, referenced by the compiler. The kernel profile
+ * is collected by a single run, the counters are never merged.
+ *
+ * @param[in] counters The counters to merge.
+ * @param[in] count The number of counters.
+ */
+void __gcov_merge_add(int64_t* counters, uint32_t count);
+
+/**
+ * @brief Outputs the kernel execution profile.
+ *
+ * @details Outputs the kernel execution profile on the kernel output. Each
+ * object profile is output as a file record with its gcda path, followed by
+ * the gcda file content as hexadecimal words. The counters keep running
+ * while the profile is output, the caller should disable the interrupts and
+ * make sure the other CPUs are idle.
+ */
+void gcov_dump(void);
+
+#endif /* #ifdef _PGO_GENERATE_ENABLED */
+
+#endif /* #ifndef __CORE_GCOV_H_ */
+
+/************************************ EOF *************************************/
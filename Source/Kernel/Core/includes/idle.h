@@ -0,0 +1,112 @@
+/*******************************************************************************
+ * @file idle.h
+ *
+ * @see idle.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's CPU idle driver.
+ *
+ * @details Kernel's CPU idle driver. The idle threads wait for work in the
+ * idle driver. When the CPU supports MONITOR and MWAIT, the idle CPU monitors
+ * its wake flag and waits in the deepest C-state whose target residency fits
+ * in the time left before its next timer interrupt: a write to the flag wakes
+ * it without an inter processor interrupt. The isolated CPUs can poll their
+ * wake flag instead, the CPUs without MWAIT halt until the next interrupt.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_IDLE_H_
+#define __CORE_IDLE_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>     /* Generic int types */
+#include <kerror.h>     /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the idle driver of a CPU.
+ *
+ * @details Initializes the idle driver of the current CPU and enumerates its
+ * MWAIT C-states. The C-states deeper than C1 are only used when the LAPIC
+ * timer keeps running in them. This function must be called on the CPU being
+ * initialized, once the CPU features are detected.
+ *
+ * @param[in] cpu_id The identifier of the current CPU.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the CPU identifier is invalid.
+ */
+OS_RETURN_E idle_init_cpu(const uint32_t cpu_id);
+
+/**
+ * @brief Waits for work on the current CPU.
+ *
+ * @details Waits until the current CPU is woken by idle_wake_cpu or by an
+ * interrupt. A polling CPU returns after a bounded number of spins, the caller
+ * must check for work and call the function again. The CPUs with RCU
+ * callbacks waiting poll, their idle loop calls the callbacks. This function
+ * must be called by the idle threads, with interrupts enabled.
+ */
+void idle_wait(void);
+
+/**
+ * @brief Wakes a CPU waiting in its idle driver.
+ *
+ * @details Wakes a CPU monitoring or polling its wake flag by writing the
+ * flag. A CPU running or halted is not woken, the caller must then send it an
+ * interrupt. A CPU leaving its idle driver might get a spurious wakeup on its
+ * next wait. This function can be called by interrupt handlers.
+ *
+ * @param[in] cpu_id The identifier of the CPU to wake.
+ *
+ * @return TRUE if the CPU was waiting on its wake flag, FALSE otherwise.
+ */
+bool_t idle_wake_cpu(const uint32_t cpu_id);
+
+#endif /* #ifndef __CORE_IDLE_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,180 @@
+/*******************************************************************************
+ * @file initcall.h
+ *
+ * @see initcall.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's initialization calls registry.
+ *
+ * @details Kernel's initialization calls registry. The boot sequence is
+ * described as tables of initialization calls with their dependencies in the
+ * table. A call runs once all its dependencies are done: the asynchronous
+ * calls run in kernel threads, possibly on other CPUs, while the other ready
+ * calls run in order on the calling CPU, and the lazy calls only run on their
+ * first use. Each call is timed with the TSC for the boot profile.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_INITCALL_H_
+#define __CORE_INITCALL_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Maximal number of calls of a table, the size of the dependencies
+ * masks.
+ */
+#define INITCALL_MAX_CALLS 32
+
+/** @brief Maximal number of tables. */
+#define INITCALL_MAX_TABLES 4
+
+/** @brief The call may return OS_ERR_NOT_SUPPORTED, it is then done. */
+#define INITCALL_FLAG_OPTIONAL 0x1
+
+/** @brief The call runs in a kernel thread, the table must be run once the
+ * scheduler is initialized.
+ */
+#define INITCALL_FLAG_ASYNC 0x2
+
+/** @brief The call only runs on its first initcall_require. */
+#define INITCALL_FLAG_LAZY 0x4
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief States of the calls. */
+typedef enum
+{
+    /** @brief The call did not run. */
+    INITCALL_STATE_PENDING = 0,
+    /** @brief The call is running. */
+    INITCALL_STATE_RUNNING = 1,
+    /** @brief The call succeeded. */
+    INITCALL_STATE_DONE    = 2,
+    /** @brief The call or one of its dependencies failed. */
+    INITCALL_STATE_FAILED  = 3,
+} INITCALL_STATE_E;
+
+/** @brief Initialization call. The fields after flags are managed by the
+ * registry and must be zeroed.
+ */
+typedef struct
+{
+    /** @brief The call name, unique among the tables. */
+    const char* name;
+
+    /** @brief The initialization routine. */
+    OS_RETURN_E (*init)(void);
+
+    /** @brief Mask of the dependencies indexes in the table. */
+    uint32_t deps;
+
+    /** @brief The INITCALL_FLAG_* flags of the call. */
+    uint32_t flags;
+
+    /** @brief The call state. */
+    volatile INITCALL_STATE_E state;
+
+    /** @brief The initialization routine result. */
+    OS_RETURN_E result;
+
+    /** @brief The TSC value when the call started. */
+    uint64_t start;
+
+    /** @brief The TSC value when the call ended. */
+    uint64_t end;
+} initcall_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Returns the dependency mask of a call index.
+ *
+ * @param[in] INDEX The index of the call in its table.
+ */
+#define INITCALL_DEP(INDEX) (1U << (INDEX))
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Runs a table of initialization calls.
+ *
+ * @details Registers the table and runs its calls that are not lazy, each
+ * once its dependencies are done. The function returns once all these calls
+ * ended. The table must stay allocated for the kernel lifetime.
+ *
+ * @param[in, out] calls The calls table.
+ * @param[in] count The number of calls.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if calls or a routine is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if a dependency is out of the
+ * table or is the call itself.
+ * - OS_ERR_NO_MORE_MEMORY is returned if the table is too large or
+ * INITCALL_MAX_TABLES tables are registered.
+ * - The first error of a failed call, its dependent calls are not run.
+ */
+OS_RETURN_E initcall_run(initcall_t* calls, const uint32_t count);
+
+/**
+ * @brief Runs a lazy initialization call.
+ *
+ * @details Runs a lazy initialization call on its first use. The other
+ * callers wait for the call to end, the later ones only read its result.
+ *
+ * @param[in] name The call name.
+ *
+ * @return The success state or the error code.
+ * - The call result, OS_NO_ERR if the call accepted OS_ERR_NOT_SUPPORTED.
+ * - OS_ERR_NULL_POINTER is returned if name is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if no call has the name.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if a dependency of the call is not
+ * done.
+ */
+OS_RETURN_E initcall_require(const char* name);
+
+/**
+ * @brief Prints the boot profile.
+ *
+ * @details Prints the TSC cycles spent in each call that ran and their share
+ * of the time elapsed since the first call started.
+ */
+void initcall_print_profile(void);
+
+#endif /* #ifndef __CORE_INITCALL_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,144 @@
+/*******************************************************************************
+ * @file initrd.h
+ *
+ * @see initrd.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's initial ram disk driver.
+ *
+ * @details Kernel's initial ram disk driver. The initial ram disk is a
+ * multiboot module starting with a master block, followed by a USTAR archive.
+ * The module is mapped read only in the kernel linear mapping and accessed in
+ * place, its memory is never copied.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_INITRD_H_
+#define __CORE_INITRD_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+#include <blkdev.h> /* Block devices */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Size of the initial ram disk master block in bytes. */
+#define INITRD_MASTER_BLOCK_SIZE 512
+
+/** @brief Magic of the initial ram disk master block. */
+#define INITRD_MAGIC "UTKINIRD"
+
+/** @brief Size of the initial ram disk magic in bytes. */
+#define INITRD_MAGIC_SIZE 8
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Initial ram disk master block, as written by create_initrd.sh. */
+typedef struct
+{
+    /** @brief The INITRD_MAGIC characters, not NULL terminated. */
+    char magic[INITRD_MAGIC_SIZE];
+
+    /** @brief Size of the initial ram disk, master block included. */
+    uint64_t size;
+
+    /** @brief Unused space of the block. */
+    uint8_t reserved[INITRD_MASTER_BLOCK_SIZE - INITRD_MAGIC_SIZE -
+                     sizeof(uint64_t)];
+} __attribute__((packed)) initrd_master_block_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the initial ram disk.
+ *
+ * @details Looks for the first multiboot module starting with the initial ram
+ * disk master block and maps it read only in the kernel linear mapping. The
+ * parts of the module already covered by the boot mapping are used as is.
+ * This function must be called after the virtual memory manager was
+ * initialized.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the initial ram disk is already
+ * initialized.
+ * - OS_ERR_NOT_SUPPORTED is returned if no module is an initial ram disk or
+ * the module cannot be reached through the linear mapping.
+ * - OS_ERR_CORRUPTED_DATA is returned if the master block size does not fit
+ * the module.
+ * - OS_ERR_NO_MORE_MEMORY is returned if the module could not be mapped.
+ */
+OS_RETURN_E initrd_init(void);
+
+/**
+ * @brief Returns the archive of the initial ram disk.
+ *
+ * @details Returns the address and the size of the archive following the
+ * master block. The archive is read only and mapped for the kernel lifetime.
+ *
+ * @param[out] image The buffer receiving the archive address.
+ * @param[out] size The buffer receiving the archive size in bytes.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if a buffer is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if the initial ram disk is not
+ * initialized.
+ */
+OS_RETURN_E initrd_get_image(const void** image, size_t* size);
+
+/**
+ * @brief Returns the block device of the initial ram disk archive.
+ *
+ * @details Returns the memory backed block device of the archive following
+ * the master block, its blocks are cached without copy.
+ *
+ * @param[out] dev The buffer receiving the block device.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if dev is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if the initial ram disk is not
+ * initialized.
+ */
+OS_RETURN_E initrd_get_device(blkdev_t** dev);
+
+#endif /* #ifndef __CORE_INITRD_H_ */
+
+/************************************ EOF *************************************/
@@ -7,13 +7,16 @@
  *
  * @date 31/03/2023
  *
- * @version 3.0
+ * @version 3.1
  *
  * @brief Interrupt manager.
  *
  * @details Interrupt manager. Allows to attach ISR to interrupt lines and
  * manage IRQ used by the CPU. We also define the general interrupt handler
  * here.
+ * Handlers registered as fast never switch threads: the interrupt entry path
+ * only saves the caller saved registers on the stack before calling them,
+ * instead of saving the full thread context in its virtual CPU.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -37,7 +40,11 @@
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Number of buckets in the interrupt handlers latency histograms.
+ * Bucket i counts the handlers that ran for [2^i, 2^(i + 1)[ cycles, the last
+ * bucket also counts the longer ones.
+ */
+#define INTERRUPT_STATS_HISTOGRAM_SIZE 32
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
@@ -109,8 +116,39 @@ typedef struct
      * number is not supported by the driver.
      */
     int32_t (*driver_get_irq_int_line)(const uint32_t irq_number);
+
+    /**
+     * @brief Routes an IRQ to a CPU.
+     *
+     * @details Routes an IRQ to a CPU, the IRQ handler then runs on this CPU.
+     *
+     * @param[in] irq_number The IRQ number to route.
+     * @param[in] cpu_id The identifier of the CPU to route the IRQ to.
+     *
+     * @return OS_NO_ERR if the IRQ is routed to the CPU, OS_ERR_NO_SUCH_IRQ if
+     * the IRQ number is not supported, OS_ERR_NOT_SUPPORTED if the driver
+     * cannot route the IRQ to the CPU.
+     */
+    OS_RETURN_E (*driver_set_irq_affinity)(const uint32_t irq_number,
+                                           const uint32_t cpu_id);
 } interrupt_driver_t;
 
+/** @brief Statistics of an interrupt line on a CPU. */
+typedef struct
+{
+    /** @brief Number of times the line handler was called. */
+    uint64_t count;
+
+    /** @brief Cumulative number of cycles spent in the line handler. */
+    uint64_t cycles;
+
+    /** @brief Highest number of cycles spent in one call of the handler. */
+    uint64_t max_cycles;
+
+    /** @brief Log2 histogram of the cycles spent in the line handler. */
+    uint32_t histogram[INTERRUPT_STATS_HISTOGRAM_SIZE];
+} interrupt_stats_t;
+
 /*******************************************************************************
  * MACROS
  ******************************************************************************/
@@ -151,6 +189,20 @@ void kernel_interrupt_init(void);
  */
 void kernel_interrupt_handler(void);
 
+/**
+ * @brief Kernel's fast path interrupt handler.
+ *
+ * @details Interrupt handler for the lines registered with a fast handler.
+ * This function should only be called by an assembly interrupt handler, when
+ * the interrupted context had interrupts enabled. The thread's virtual CPU is
+ * not saved: the handler must neither read it nor switch threads.
+ *
+ * @param[in] int_id The interrupt line that was raised.
+ * @param[in] current_thread The thread running on the CPU.
+ */
+void kernel_interrupt_fast_handler(const uint32_t int_id,
+                                   kernel_thread_t* current_thread);
+
 /**
  * @brief Set the driver to be used by the kernel to manage interrupts.
  *
@@ -181,12 +233,30 @@ OS_RETURN_E kernel_interrupt_set_driver(const interrupt_driver_t* driver);
 OS_RETURN_E kernel_interrupt_register_irq_handler(const uint32_t irq_number,
                                                   custom_handler_t handler);
 
+/**
+ * @brief Registers a fast interrupt handler for the desired IRQ number.
+ *
+ * @details Registers a custom interrupt handler called by the interrupt fast
+ * path. The handler must neither read the thread's virtual CPU nor switch
+ * threads. The handler is removed with kernel_interrupt_remove_irq_handler.
+ *
+ * @param[in] irq_number The IRQ number to attach the handler to.
+ * @param[in] handler The handler for the desired interrupt.
+ *
+ * @return The success state or the error code.
+ */
+OS_RETURN_E kernel_interrupt_register_fast_irq_handler(
+                                                   const uint32_t irq_number,
+                                                   custom_handler_t handler);
+
 /**
  * @brief Unregisters an interrupt handler for the desired IRQ number.
  *
  * @details Unregisters a custom interrupt handler to be executed. The IRQ
  * number must be greater or equal to the minimal authorized custom IRQ number
- * and less than the maximal one.
+ * and less than the maximal one. The handler can still be running on another
+ * CPU when the function returns, the data it uses must be released after
+ * rcu_synchronize or with rcu_call.
  *
  * @param[in] irq_number The IRQ number to detach the handler from.
  *
@@ -215,12 +285,54 @@ OS_RETURN_E kernel_interrupt_remove_irq_handler(const uint32_t irq_number);
 OS_RETURN_E kernel_interrupt_register_int_handler(const uint32_t interrupt_line,
                                                   custom_handler_t handler);
 
+/**
+ * @brief Registers a fast interrupt handler for the desired interrupt line.
+ *
+ * @details Registers a custom interrupt handler called by the interrupt fast
+ * path. The handler must neither read the thread's virtual CPU nor switch
+ * threads. The interrupt line must be greater or equal to the minimal
+ * authorized custom interrupt line and less than the maximal one. The handler
+ * is removed with kernel_interrupt_remove_int_handler.
+ *
+ * @param[in] interrupt_line The interrupt line to attach the handler to.
+ * @param[in] handler The handler for the desired interrupt.
+ *
+ * @return The success state or the error code.
+ */
+OS_RETURN_E kernel_interrupt_register_fast_int_handler(
+                                               const uint32_t interrupt_line,
+                                               custom_handler_t handler);
+
+/**
+ * @brief Registers an exception handler for the desired exception line.
+ *
+ * @details Registers a custom exception handler to be executed. The exception
+ * line must be greater or equal to the minimal authorized exception line and
+ * less than the maximal one. Exceptions without handler raise a kernel panic.
+ *
+ * @param[in] exception_line The exception line to attach the handler to.
+ * @param[in] handler The handler for the desired exception.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OR_ERR_UNAUTHORIZED_INTERRUPT_LINE is returned if the desired exception
+ * line is not allowed.
+ * - OS_ERR_NULL_POINTER is returned if the handler is NULL.
+ * - OS_ERR_INTERRUPT_ALREADY_REGISTERED is returned if a handler is already
+ * attached to the exception line.
+ */
+OS_RETURN_E kernel_interrupt_register_exception_handler(
+                                               const uint32_t exception_line,
+                                               custom_handler_t handler);
+
 /**
  * @brief Unregisters a new interrupt handler for the desired interrupt line.
  *
  * @details Unregisters a custom interrupt handler to be executed. The interrupt
  * line must be greater or equal to the minimal authorized custom interrupt line
- * and less than the maximal one.
+ * and less than the maximal one. The handler can still be running on another
+ * CPU when the function returns, the data it uses must be released after
+ * rcu_synchronize or with rcu_call.
  *
  * @param[in] interrupt_line The interrupt line to deattach the handler from.
  *
@@ -233,6 +345,20 @@ OS_RETURN_E kernel_interrupt_register_int_handler(const uint32_t interrupt_line,
  */
 OS_RETURN_E kernel_interrupt_remove_int_handler(const uint32_t interrupt_line);
 
+/**
+ * @brief Returns the handler attached to an interrupt line.
+ *
+ * @details Returns the handler attached to an interrupt line with the lookup
+ * used by the interrupt dispatchers. The handler can be removed right after
+ * the function returns.
+ *
+ * @param[in] interrupt_line The interrupt line.
+ *
+ * @return The handler attached to the interrupt line, NULL if the line has no
+ * handler or is not a valid interrupt line.
+ */
+custom_handler_t kernel_interrupt_get_handler(const uint32_t interrupt_line);
+
 /**
  * @brief Restores the CPU interrupts state.
  *
@@ -273,6 +399,67 @@ void kernel_interrupt_set_irq_mask(const uint32_t irq_number,
  */
 void kernel_interrupt_set_irq_eoi(const uint32_t irq_number);
 
+/**
+ * @brief Routes an IRQ to a CPU.
+ *
+ * @details Routes an IRQ to a CPU through the interrupt driver. The IRQ
+ * handler then runs on this CPU, which spreads the high rate devices over the
+ * CPUs. The IRQs are routed to the BSP by default.
+ *
+ * @param[in] irq_number The IRQ number to route.
+ * @param[in] cpu_id The identifier of the CPU to route the IRQ to.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the CPU identifier is not
+ * valid.
+ * - OS_ERR_NO_SUCH_IRQ is returned if the IRQ number is not supported.
+ * - OS_ERR_NOT_SUPPORTED is returned if the driver cannot route the IRQ to
+ * the CPU.
+ */
+OS_RETURN_E kernel_interrupt_set_irq_affinity(const uint32_t irq_number,
+                                              const uint32_t cpu_id);
+
+/**
+ * @brief Returns the statistics of an interrupt line on a CPU.
+ *
+ * @details Copies the statistics gathered by the interrupt handlers for the
+ * interrupt line on the CPU. The statistics are updated without
+ * synchronization by the CPU they belong to, values read for another CPU might
+ * be slightly out of date.
+ *
+ * @param[in] cpu_id The CPU identifier.
+ * @param[in] interrupt_line The interrupt line.
+ * @param[out] stats The buffer receiving the statistics.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the buffer is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the CPU identifier is invalid.
+ * - OR_ERR_UNAUTHORIZED_INTERRUPT_LINE is returned if the line is not a valid
+ * interrupt line.
+ */
+OS_RETURN_E kernel_interrupt_get_stats(const uint32_t cpu_id,
+                                       const uint32_t interrupt_line,
+                                       interrupt_stats_t* stats);
+
+/**
+ * @brief Prints the interrupt statistics.
+ *
+ * @details Prints the statistics and the latency histogram of every interrupt
+ * line that was handled since the last reset, for each CPU.
+ */
+void kernel_interrupt_dump_stats(void);
+
+/**
+ * @brief Resets the interrupt statistics.
+ *
+ * @details Resets the statistics of every interrupt line on every CPU.
+ * Interrupts handled by other CPUs during the reset might be partially
+ * accounted.
+ */
+void kernel_interrupt_reset_stats(void);
+
 #endif /* #ifndef __CORE_INTERRUPTS_H_ */
 
 /************************************ EOF *************************************/
@@ -0,0 +1,375 @@
+/*******************************************************************************
+ * @file ioring.h
+ *
+ * @see ioring.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's asynchronous I/O submission and completion rings.
+ *
+ * @details Kernel's asynchronous I/O submission and completion rings. The
+ * owner thread of a ring fills submission entries, gives them to their
+ * targets in batches with ioring_submit and reaps the completion entries. The
+ * targets are the drivers: they start the operation and complete it later,
+ * from any context, with ioring_complete. A ring never holds more entries
+ * than its size, between the entry reservation and its completion reaping:
+ * the completion ring cannot overflow.
+ * A thread can then drive many concurrent operations and only waits when no
+ * completion is available. A polled ring never sleeps and calls the poll
+ * function of the targets of its operations in flight instead.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_IORING_H_
+#define __CORE_IORING_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>     /* Generic int types */
+#include <stddef.h>     /* Standard definitions */
+#include <critical.h>   /* Kernel spinlocks */
+#include <ctrl_block.h> /* Kernel threads */
+#include <blkdev.h>     /* Block devices */
+#include <ktask.h>      /* Kernel tasks */
+#include <kerror.h>     /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Maximal number of entries of a ring. */
+#define IORING_MAX_ENTRIES 256
+
+/** @brief Ring flag: the completions are polled, the owner never sleeps. */
+#define IORING_FLAG_POLL 0x1
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Operations of the submission entries. */
+typedef enum
+{
+    /** @brief No operation, completed by the submission. */
+    IORING_OP_NOP   = 0,
+    /** @brief Reads from the target to the buffer. */
+    IORING_OP_READ  = 1,
+    /** @brief Writes the buffer to the target. */
+    IORING_OP_WRITE = 2
+} IORING_OP_E;
+
+/* Forward declarations */
+struct ioring_target;
+struct ioring_request;
+struct ioring;
+
+/** @brief Target of the operations, implemented by a driver. */
+typedef struct ioring_target
+{
+    /** @brief The target name. */
+    const char* name;
+
+    /**
+     * @brief Starts an operation.
+     *
+     * @details Starts the operation of the request. The driver completes the
+     * request with ioring_complete, before returning or later. The request
+     * stays valid until it is completed.
+     *
+     * @param[in] target The target.
+     * @param[in] request The request to start.
+     *
+     * @return The success state or the error code. The request completes
+     * with the error code when the operation cannot be started, it must not
+     * be completed by the driver then.
+     */
+    OS_RETURN_E (*submit)(struct ioring_target* target,
+                          struct ioring_request* request);
+
+    /**
+     * @brief Polls the operations in flight, NULL if the driver completes
+     * them by itself.
+     *
+     * @param[in] target The target.
+     */
+    void (*poll)(struct ioring_target* target);
+
+    /** @brief The driver's data. */
+    void* driver_ctrl;
+} ioring_target_t;
+
+/** @brief Submission entry. */
+typedef struct
+{
+    /** @brief The operation. */
+    IORING_OP_E opcode;
+
+    /** @brief The operation target, not used by IORING_OP_NOP. */
+    ioring_target_t* target;
+
+    /** @brief The operation buffer. */
+    void* buffer;
+
+    /** @brief The size of the buffer. */
+    size_t size;
+
+    /** @brief The target offset, ignored by the streams. */
+    uint64_t offset;
+
+    /** @brief The caller's value, returned in the completion entry. */
+    uint64_t user_data;
+} ioring_sqe_t;
+
+/** @brief Completion entry. */
+typedef struct
+{
+    /** @brief The caller's value of the submission entry. */
+    uint64_t user_data;
+
+    /** @brief The operation status. */
+    OS_RETURN_E status;
+
+    /** @brief The number of bytes transferred. */
+    size_t size;
+} ioring_cqe_t;
+
+/** @brief Operation in flight. */
+typedef struct ioring_request
+{
+    /** @brief The ring of the request. */
+    struct ioring* ring;
+
+    /** @brief The submission entry of the request. */
+    ioring_sqe_t sqe;
+
+    /** @brief Target of the request in flight, NULL once completed. */
+    ioring_target_t* volatile target;
+
+    /** @brief Next free request, or next request queued by the driver. */
+    struct ioring_request* next;
+} ioring_request_t;
+
+/** @brief Submission and completion rings. */
+typedef struct ioring
+{
+    /** @brief Number of entries of the rings, a power of two. */
+    uint32_t entries;
+
+    /** @brief The IORING_FLAG_* flags of the ring. */
+    uint32_t flags;
+
+    /** @brief Submission ring. */
+    ioring_sqe_t* sq;
+
+    /** @brief Next submission entry to give to its target. */
+    uint32_t sq_head;
+
+    /** @brief Next submission entry to reserve. */
+    uint32_t sq_tail;
+
+    /** @brief Completion ring. */
+    ioring_cqe_t* cq;
+
+    /** @brief Next completion entry to reap. */
+    uint32_t cq_head;
+
+    /** @brief Next completion entry to write. */
+    volatile uint32_t cq_tail;
+
+    /** @brief Number of entries reserved and not reaped yet. */
+    uint32_t used;
+
+    /** @brief Number of operations submitted and not reaped yet. */
+    uint32_t submitted;
+
+    /** @brief The requests storage. */
+    ioring_request_t* requests;
+
+    /** @brief The free requests. */
+    ioring_request_t* free_requests;
+
+    /** @brief Owner thread waiting for a completion, NULL if none. */
+    kernel_thread_t* waiter;
+
+    /** @brief Task woken up by each completion, NULL if none. */
+    ktask_t* task;
+
+    /** @brief Protects the completion ring tail, the free requests and the
+     * waiter.
+     */
+    kernel_spinlock_t lock;
+} ioring_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes a ring.
+ *
+ * @details Allocates the rings and the requests of the ring. The submission
+ * side and the completion reaping must only be used by one thread, the
+ * ring owner.
+ *
+ * @param[out] ring The ring to initialize.
+ * @param[in] entries The number of entries, a power of two not larger than
+ * IORING_MAX_ENTRIES.
+ * @param[in] flags The IORING_FLAG_* flags of the ring.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if ring is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if entries is not a power of two or is
+ * larger than IORING_MAX_ENTRIES.
+ * - OS_ERR_NO_MORE_MEMORY is returned if the rings cannot be allocated.
+ */
+OS_RETURN_E ioring_init(ioring_t* ring,
+                        const uint32_t entries,
+                        const uint32_t flags);
+
+/**
+ * @brief Releases the rings of a ring.
+ *
+ * @param[in, out] ring The ring to release.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if ring is NULL.
+ * - OS_ERR_RESOURCE_BUSY is returned if operations are not reaped yet.
+ */
+OS_RETURN_E ioring_destroy(ioring_t* ring);
+
+/**
+ * @brief Sets the task owning a ring.
+ *
+ * @details Each completion wakes up the task, that reaps the completion
+ * entries with ioring_get_cqe and returns KTASK_WAIT when the ring is empty.
+ * The task must not end while it owns the ring.
+ *
+ * @param[in, out] ring The ring.
+ * @param[in] task The task woken up by the completions, NULL to only wake up
+ * the owner thread.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if ring is NULL.
+ */
+OS_RETURN_E ioring_set_task(ioring_t* ring, ktask_t* task);
+
+/**
+ * @brief Reserves a submission entry.
+ *
+ * @details Reserves the next submission entry, the caller fills it before
+ * calling ioring_submit. The entry content is undefined.
+ *
+ * @param[in, out] ring The ring.
+ *
+ * @return The submission entry, NULL if all the entries of the ring are in
+ * use.
+ */
+ioring_sqe_t* ioring_get_sqe(ioring_t* ring);
+
+/**
+ * @brief Gives the reserved submission entries to their targets.
+ *
+ * @details Starts the operations of all the reserved submission entries, in
+ * order. The operations that cannot be started complete with their error.
+ *
+ * @param[in, out] ring The ring.
+ *
+ * @return The number of submitted entries.
+ */
+uint32_t ioring_submit(ioring_t* ring);
+
+/**
+ * @brief Reaps a completion entry.
+ *
+ * @details Copies the oldest completion entry without waiting. This function
+ * can be called with any ring flags.
+ *
+ * @param[in, out] ring The ring.
+ * @param[out] cqe The buffer receiving the completion entry.
+ *
+ * @return TRUE if an entry was reaped, FALSE otherwise.
+ */
+bool_t ioring_get_cqe(ioring_t* ring, ioring_cqe_t* cqe);
+
+/**
+ * @brief Waits for and reaps a completion entry.
+ *
+ * @details Reaps the oldest completion entry, waiting for it when none is
+ * available. A polled ring polls the targets of its operations in flight,
+ * the other rings put the owner thread in the THREAD_WAIT_TYPE_IO waiting
+ * state until a completion.
+ *
+ * @param[in, out] ring The ring.
+ * @param[out] cqe The buffer receiving the completion entry.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if ring or cqe is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if no operation is submitted.
+ * - Any error returned by scheduler_wait_thread.
+ */
+OS_RETURN_E ioring_wait_cqe(ioring_t* ring, ioring_cqe_t* cqe);
+
+/**
+ * @brief Completes a request.
+ *
+ * @details Writes the completion entry of the request, releases the request
+ * and wakes up the ring owner if it waits. This function is called by the
+ * drivers and can be called from interrupt handlers.
+ *
+ * @param[in] request The request.
+ * @param[in] status The operation status.
+ * @param[in] size The number of bytes transferred.
+ */
+void ioring_complete(ioring_request_t* request,
+                     const OS_RETURN_E status,
+                     const size_t size);
+
+/**
+ * @brief Initializes the target of a block device.
+ *
+ * @details The block devices read synchronously, the read requests complete
+ * during their submission. The offset and the size of the requests must be
+ * multiples of BLKDEV_BLOCK_SIZE.
+ *
+ * @param[out] target The target to initialize.
+ * @param[in] dev The block device.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if target or dev is NULL.
+ */
+OS_RETURN_E ioring_blkdev_target_init(ioring_target_t* target, blkdev_t* dev);
+
+#endif /* #ifndef __CORE_IORING_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,172 @@
+/*******************************************************************************
+ * @file ipi.h
+ *
+ * @see ipi.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's cross-CPU calls.
+ *
+ * @details Kernel's cross-CPU calls. A CPU runs a function on other CPUs by
+ * posting call requests in their lock-free call queues and sending them the
+ * IPI_CALL_INT_LINE inter processor interrupt through the LAPIC. A CPU is
+ * only interrupted when its queue was empty, the requests posted to a CPU
+ * before it serves its queue are run in a single interrupt. The called
+ * functions run in the interrupt handler, with interrupts disabled: they must
+ * neither wait nor switch threads.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_IPI_H_
+#define __CORE_IPI_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>     /* Generic int types */
+#include <stddef.h>     /* Standard definitions */
+#include <kerror.h>     /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Function run by a cross-CPU call. */
+typedef void (*ipi_function_t)(void* args);
+
+/** @brief Cross-CPU call request, owned by the caller. */
+typedef struct ipi_call
+{
+    /** @brief Next request of the call queue. */
+    struct ipi_call* next;
+
+    /** @brief Function to run on the target CPU. */
+    ipi_function_t function;
+
+    /** @brief Argument given to the function. */
+    void* args;
+
+    /** @brief Counter decremented once the function returned, NULL if the
+     * caller does not wait for the call.
+     */
+    volatile uint32_t* pending;
+
+    /** @brief Tells if the request is in a call queue. */
+    volatile bool_t queued;
+} ipi_call_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Static initializer of a call request that is not queued.
+ *
+ * @param[in] FUNCTION The function to run on the target CPU.
+ * @param[in] ARGS The argument given to the function.
+ */
+#define IPI_CALL_INIT_VALUE(FUNCTION, ARGS) \
+    {NULL, (FUNCTION), (ARGS), NULL, FALSE}
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Adds a CPU to the cross-CPU calls.
+ *
+ * @details Adds the current CPU to the CPUs receiving cross-CPU calls. The
+ * call handler is registered by the first CPU. This function must be called
+ * on the CPU being added, once its LAPIC is initialized.
+ *
+ * @param[in] cpu_id The identifier of the current CPU.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the CPU identifier is invalid.
+ * - Other error codes returned by the interrupt manager.
+ */
+OS_RETURN_E ipi_init_cpu(const uint32_t cpu_id);
+
+/**
+ * @brief Posts a call request to a CPU.
+ *
+ * @details Posts a call request to a CPU without waiting for it to run. The
+ * request must stay valid while it is queued, it can be posted again once
+ * its function started. This function can be called by interrupt handlers.
+ *
+ * @param[in] cpu_id The identifier of the target CPU.
+ * @param[in, out] call The call request.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the request or its function is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the target CPU does not receive
+ * cross-CPU calls.
+ * - OS_ERR_RESOURCE_BUSY is returned if the request is already queued.
+ */
+OS_RETURN_E ipi_call_async(const uint32_t cpu_id, ipi_call_t* call);
+
+/**
+ * @brief Runs a function on a set of CPUs and waits for it.
+ *
+ * @details Runs a function on the CPUs of a mask that receive cross-CPU
+ * calls, the current CPU included when it is in the mask. The requests are
+ * posted to all the targets before any of them is waited for, the function
+ * runs on all the CPUs in a single interrupt round. The current CPU serves
+ * its own call queue while waiting, two CPUs can call each other with
+ * interrupts disabled. This function must not be called before the current
+ * CPU was added to the cross-CPU calls.
+ *
+ * @param[in] cpu_mask The target CPUs, one bit per CPU.
+ * @param[in] function The function to run.
+ * @param[in] args The argument given to the function.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the function is NULL.
+ */
+OS_RETURN_E ipi_call_many(const uint32_t cpu_mask,
+                          ipi_function_t function,
+                          void* args);
+
+/**
+ * @brief Stops the other CPUs.
+ *
+ * @details Stops the other CPUs receiving cross-CPU calls, they halt with
+ * interrupts disabled. The calling CPU waits a bounded time for the others to
+ * stop, a CPU running with interrupts disabled might never stop. This
+ * function is used by the kernel panic and never returns an error.
+ *
+ * @return The CPUs that stopped, one bit per CPU.
+ */
+uint32_t ipi_stop_cpus(void);
+
+#endif /* #ifndef __CORE_IPI_H_ */
+
+/************************************ EOF *************************************/
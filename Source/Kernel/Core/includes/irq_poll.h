@@ -0,0 +1,133 @@
+/*******************************************************************************
+ * @file irq_poll.h
+ *
+ * @see irq_poll.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's interrupt coalescing.
+ *
+ * @details Kernel's interrupt coalescing. A driver of a high rate device
+ * schedules its poll from the interrupt handler: the IRQ is masked and the
+ * driver polls the device in a deferred work, a bounded number of events per
+ * call, until the device has no more events. The IRQ is then unmasked. A
+ * burst of events costs one interrupt instead of one per event.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_IRQ_POLL_H_
+#define __CORE_IRQ_POLL_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>  /* Generic int types */
+#include <softirq.h> /* Deferred interrupt work */
+#include <kerror.h>  /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Interrupt coalescing state of a device IRQ. */
+typedef struct
+{
+    /** @brief Deferred work polling the device. */
+    softirq_work_t work;
+
+    /**
+     * @brief The driver poll function.
+     *
+     * @details Handles up to budget events of the device.
+     *
+     * @param[in] args The driver arguments.
+     * @param[in] budget The maximal number of events to handle.
+     *
+     * @return The number of events handled, less than the budget when the
+     * device has no more events.
+     */
+    uint32_t (*poll)(void* args, const uint32_t budget);
+
+    /** @brief The arguments given to the poll function. */
+    void* args;
+
+    /** @brief The IRQ number of the device. */
+    uint32_t irq_number;
+
+    /** @brief Maximal number of events handled by a poll call. */
+    uint32_t budget;
+
+    /** @brief Poll state, a combination of the scheduled and missed flags. */
+    volatile uint32_t state;
+} irq_poll_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the interrupt coalescing of a device IRQ.
+ *
+ * @param[out] irq_poll The coalescing state to initialize.
+ * @param[in] irq_number The IRQ number of the device.
+ * @param[in] budget The maximal number of events handled by a poll call.
+ * @param[in] poll The driver poll function.
+ * @param[in] args The arguments given to the poll function.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if irq_poll or poll is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the budget is 0.
+ */
+OS_RETURN_E irq_poll_init(irq_poll_t* irq_poll,
+                          const uint32_t irq_number,
+                          const uint32_t budget,
+                          uint32_t (*poll)(void* args, const uint32_t budget),
+                          void* args);
+
+/**
+ * @brief Schedules the poll of a device.
+ *
+ * @details Masks the device IRQ and schedules its poll. Called by the device
+ * interrupt handler, which still acknowledges the IRQ. When the poll is
+ * already scheduled, it is run again before the IRQ is unmasked. The poll
+ * function is never called concurrently.
+ *
+ * @param[in, out] irq_poll The coalescing state of the device IRQ.
+ */
+void irq_poll_schedule(irq_poll_t* irq_poll);
+
+#endif /* #ifndef __CORE_IRQ_POLL_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,308 @@
+/*******************************************************************************
+ * @file kbuf.h
+ *
+ * @see kbuf.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's chained data buffers.
+ *
+ * @details Kernel's chained data buffers. A buffer is a chain of segments,
+ * each segment is a view on a reference counted storage. Slicing a buffer
+ * creates new segments on the same storages and never copies the data, the
+ * storage is released with its last segment. A storage is either allocated
+ * with the buffer, with an headroom to prepend headers, or attached from an
+ * external memory area released by a callback.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_KBUF_H_
+#define __CORE_KBUF_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/**
+ * @brief Release callback of an attached storage, called when the last
+ * segment referencing the storage is released.
+ */
+typedef void (*kbuf_release_t)(const void* data, void* args);
+
+/** @brief Reference counted storage of the buffers segments. */
+typedef struct
+{
+    /** @brief Number of segments referencing the storage. */
+    volatile uint32_t refcount;
+
+    /** @brief Tells if the storage data can be written. */
+    bool_t writable;
+
+    /** @brief First byte of the storage. */
+    uint8_t* start;
+
+    /** @brief Size of the storage. */
+    size_t size;
+
+    /** @brief Release callback, NULL if allocated with the buffer. */
+    kbuf_release_t release;
+
+    /** @brief Arguments given to the release callback. */
+    void* args;
+} kbuf_storage_t;
+
+/** @brief Buffer segment, the first segment of a chain is the buffer. */
+typedef struct kbuf
+{
+    /** @brief Next segment of the chain, NULL for the last one. */
+    struct kbuf* next;
+
+    /** @brief Storage of the segment data. */
+    kbuf_storage_t* storage;
+
+    /** @brief First byte of the segment, in the storage. */
+    uint8_t* data;
+
+    /** @brief Size of the segment data. */
+    size_t length;
+} kbuf_t;
+
+/** @brief Scatter-gather descriptor of a buffer segment. */
+typedef struct
+{
+    /** @brief Segment data address. */
+    const void* address;
+
+    /** @brief Segment size. */
+    size_t size;
+} kbuf_segment_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Allocates a buffer.
+ *
+ * @details Allocates a buffer of one empty segment, with its storage. The
+ * segment starts after headroom bytes and can grow by size bytes with
+ * kbuf_put. This function can be called from interrupt handlers.
+ *
+ * @param[in] size The size of the storage after the headroom.
+ * @param[in] headroom The size reserved before the data for kbuf_push.
+ *
+ * @return The allocated buffer, NULL if no memory is left.
+ */
+kbuf_t* kbuf_alloc(const size_t size, const size_t headroom);
+
+/**
+ * @brief Attaches an external memory area to a buffer.
+ *
+ * @details Creates a buffer of one segment on the memory area, without copy.
+ * The area is read-only for the buffer and must stay valid until the release
+ * callback is called. This function can be called from interrupt handlers.
+ *
+ * @param[in] data The memory area.
+ * @param[in] size The size of the memory area.
+ * @param[in] release The release callback, can be NULL.
+ * @param[in] args The arguments given to the release callback.
+ *
+ * @return The buffer, NULL if data is NULL or no memory is left.
+ */
+kbuf_t* kbuf_attach(const void* data,
+                    const size_t size,
+                    kbuf_release_t release,
+                    void* args);
+
+/**
+ * @brief Releases a buffer.
+ *
+ * @details Releases all the segments of the chain. Each storage is released
+ * with its last segment. NULL is ignored. This function can be called from
+ * interrupt handlers.
+ *
+ * @param[in] buf The buffer to release.
+ */
+void kbuf_free(kbuf_t* buf);
+
+/**
+ * @brief Returns the size of the data of a buffer.
+ *
+ * @param[in] buf The buffer.
+ *
+ * @return The size of the data of all the chain segments, 0 if buf is NULL.
+ */
+size_t kbuf_length(const kbuf_t* buf);
+
+/**
+ * @brief Extends the data at the end of a buffer.
+ *
+ * @details Extends the last segment of the chain over the following bytes of
+ * its storage. The storage must be writable and must not be shared.
+ *
+ * @param[in, out] buf The buffer.
+ * @param[in] size The number of bytes to add.
+ *
+ * @return The address of the added bytes, NULL if the storage cannot hold
+ * them or cannot be written.
+ */
+void* kbuf_put(kbuf_t* buf, const size_t size);
+
+/**
+ * @brief Extends the data at the start of a buffer.
+ *
+ * @details Extends the first segment of the chain over the preceding bytes of
+ * its storage, in the headroom. The storage must be writable and must not be
+ * shared.
+ *
+ * @param[in, out] buf The buffer.
+ * @param[in] size The number of bytes to add.
+ *
+ * @return The address of the added bytes, NULL if the headroom cannot hold
+ * them or cannot be written.
+ */
+void* kbuf_push(kbuf_t* buf, const size_t size);
+
+/**
+ * @brief Removes data from the start of a buffer.
+ *
+ * @details Removes data from the first segments of the chain. The emptied
+ * segments stay in the chain, the buffer address does not change.
+ *
+ * @param[in, out] buf The buffer.
+ * @param[in] size The number of bytes to remove.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if buf is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the buffer holds less than size bytes,
+ * the buffer is not modified.
+ */
+OS_RETURN_E kbuf_pull(kbuf_t* buf, const size_t size);
+
+/**
+ * @brief Truncates a buffer.
+ *
+ * @details Keeps the first length bytes of the buffer. The segments after the
+ * new end are released, the first segment is always kept.
+ *
+ * @param[in, out] buf The buffer.
+ * @param[in] length The new size of the buffer data.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if buf is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the buffer holds less than length
+ * bytes.
+ */
+OS_RETURN_E kbuf_trim(kbuf_t* buf, const size_t length);
+
+/**
+ * @brief Appends a buffer at the end of another.
+ *
+ * @details Links the segments of tail after the last segment of head, the
+ * data is not copied. The tail buffer belongs to head after the call.
+ *
+ * @param[in, out] head The buffer to extend.
+ * @param[in] tail The appended buffer.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if head or tail is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if head and tail are the same
+ * buffer.
+ */
+OS_RETURN_E kbuf_append(kbuf_t* head, kbuf_t* tail);
+
+/**
+ * @brief Creates a buffer on a part of another buffer.
+ *
+ * @details Creates a new chain of segments on the storages of the part of the
+ * buffer, the data is not copied. The slice segments hold references on the
+ * storages: the storages cannot be written with kbuf_put and kbuf_push until
+ * the slice is released. This function can be called from interrupt
+ * handlers.
+ *
+ * @param[in] buf The buffer.
+ * @param[in] offset The offset of the part in the buffer data.
+ * @param[in] length The size of the part.
+ *
+ * @return The slice, NULL if the part exceeds the buffer data or no memory is
+ * left.
+ */
+kbuf_t* kbuf_slice(const kbuf_t* buf, const size_t offset, const size_t length);
+
+/**
+ * @brief Copies data from a buffer.
+ *
+ * @param[in] buf The buffer.
+ * @param[in] offset The offset of the data to copy in the buffer data.
+ * @param[out] dest The destination of the copy.
+ * @param[in] size The number of bytes to copy.
+ *
+ * @return The number of bytes copied, smaller than size when the buffer data
+ * ends before.
+ */
+size_t kbuf_copy_out(const kbuf_t* buf,
+                     const size_t offset,
+                     void* dest,
+                     const size_t size);
+
+/**
+ * @brief Returns the scatter-gather descriptors of a buffer.
+ *
+ * @details Describes the non-empty segments of the chain, in order. Only the
+ * first max_count segments are described.
+ *
+ * @param[in] buf The buffer.
+ * @param[out] segments The descriptors buffer.
+ * @param[in] max_count The number of descriptors of the buffer.
+ *
+ * @return The number of non-empty segments of the chain, larger than
+ * max_count when the descriptors buffer is too small.
+ */
+uint32_t kbuf_get_segments(const kbuf_t* buf,
+                           kbuf_segment_t* segments,
+                           const uint32_t max_count);
+
+#endif /* #ifndef __CORE_KBUF_H_ */
+
+/************************************ EOF *************************************/
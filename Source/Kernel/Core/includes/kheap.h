@@ -0,0 +1,157 @@
+/*******************************************************************************
+ * @file kheap.h
+ *
+ * @see kheap.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's heap allocator.
+ *
+ * @details Kernel's heap allocator. The heap manages the KERNEL_HEAP region
+ * defined in the linker file. The small allocations are served by slab caches
+ * of power of two size classes with per-CPU magazines, the large allocations
+ * are served as runs of contiguous pages. When KERNEL_MEMSTAT is enabled,
+ * kmalloc records each allocation in the descriptor of its call site, see
+ * memstat.h.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_KHEAP_H_
+#define __CORE_KHEAP_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>  /* Generic int types */
+#include <stddef.h>  /* Standard definitions */
+#include <memstat.h> /* Allocation sites */
+#include <kerror.h>  /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the kernel heap.
+ *
+ * @details Initializes the kernel heap over the KERNEL_HEAP region. The pages
+ * descriptors are stored at the beginning of the region. This function must be
+ * called after the CPU local storage of the boot CPU was initialized.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the heap is already
+ * initialized.
+ * - OS_ERR_NO_MORE_MEMORY is returned if the heap region is too small.
+ */
+OS_RETURN_E kheap_init(void);
+
+/**
+ * @brief Allocates memory from the kernel heap.
+ *
+ * @details Allocates memory from the kernel heap. The allocations up to the
+ * largest size class are served by the calling CPU magazine when possible,
+ * they are aligned on their size class. The larger allocations are page
+ * aligned. This function can be called from interrupt handlers.
+ *
+ * @param[in] size The size of the memory to allocate in bytes.
+ *
+ * @return A pointer to the allocated memory, NULL if the size is 0, the heap
+ * is not initialized or no memory is left.
+ */
+void* kmalloc(const size_t size);
+
+/**
+ * @brief Releases memory allocated from the kernel heap.
+ *
+ * @details Releases memory allocated from the kernel heap with kmalloc. NULL
+ * is ignored. Releasing a pointer that was not returned by kmalloc raises a
+ * kernel panic when it is detected. This function can be called from
+ * interrupt handlers.
+ *
+ * @param[in] ptr The memory to release.
+ */
+void kfree(void* ptr);
+
+/**
+ * @brief Returns the object size of a size class.
+ *
+ * @param[in] class_id The size class, as recorded in memstat.h.
+ *
+ * @return The object size of the size class, 0 for the large allocations and
+ * the invalid classes.
+ */
+size_t kheap_get_class_size(const uint32_t class_id);
+
+#if KERNEL_MEMSTAT
+/**
+ * @brief Allocates memory from the kernel heap for a call site.
+ *
+ * @details Allocates memory as kmalloc and records the allocation in the
+ * site and size class statistics. The kmalloc call sites call this function
+ * with their own site descriptor.
+ *
+ * @param[in] size The size of the memory to allocate in bytes.
+ * @param[in, out] site The site descriptor, can be NULL.
+ *
+ * @return A pointer to the allocated memory, NULL if the size is 0, the heap
+ * is not initialized or no memory is left.
+ */
+void* kmalloc_site(const size_t size, memstat_site_t* site);
+
+/**
+ * @brief Allocates memory from the kernel heap, each use of the macro defines
+ * its own allocation site descriptor. Defined after the functions it
+ * replaces.
+ *
+ * @param[in] SIZE The size of the memory to allocate in bytes.
+ */
+#define kmalloc(SIZE) ({                                \
+    MEMSTAT_SITE_DEFINE(_memstat_site);                 \
+    kmalloc_site((SIZE), &_memstat_site);               \
+})
+#endif
+
+#endif /* #ifndef __CORE_KHEAP_H_ */
+
+/************************************ EOF *************************************/
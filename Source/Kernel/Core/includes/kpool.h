@@ -0,0 +1,215 @@
+/*******************************************************************************
+ * @file kpool.h
+ *
+ * @see kpool.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's fixed-size objects pools.
+ *
+ * @details Kernel's fixed-size objects pools. A pool manages a pre-reserved
+ * memory area cut in objects of the same size, each object is aligned on a
+ * cache line. The free objects are linked in an intrusive free list. A pool
+ * can keep a cache of free objects per CPU, allocating and releasing objects
+ * is then done without lock most of the time.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_KPOOL_H_
+#define __CORE_KPOOL_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>   /* Generic int types */
+#include <stddef.h>   /* Standard definitions */
+#include <cpu.h>      /* CPU cache line size */
+#include <critical.h> /* Kernel spinlocks */
+#include <kerror.h>   /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of free objects a pool CPU cache can hold. */
+#define KPOOL_CPU_CACHE_SIZE 8
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Free objects cache of a CPU. */
+typedef struct
+{
+    /** @brief The free objects. */
+    void* objects[KPOOL_CPU_CACHE_SIZE];
+
+    /** @brief Number of free objects in the cache. */
+    uint32_t count;
+} kpool_cpu_cache_t;
+
+/** @brief Fixed-size objects pool. */
+typedef struct
+{
+    /** @brief Address of the first object. */
+    uintptr_t base;
+
+    /** @brief Distance between two objects, multiple of the cache line. */
+    size_t stride;
+
+    /** @brief Number of objects of the pool. */
+    uint32_t capacity;
+
+    /** @brief The free objects, linked through their first word. */
+    void* free_objects;
+
+    /** @brief Lock protecting the free objects list. */
+    kernel_spinlock_t lock;
+
+    /** @brief Tells if the pool uses the CPUs caches. */
+    bool_t cpu_cache_enabled;
+
+    /** @brief The CPUs caches. */
+    kpool_cpu_cache_t cpu_caches[MAX_CPU_COUNT];
+} kpool_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Returns the distance between two objects of a pool.
+ *
+ * @param[in] SIZE The size of the pool objects.
+ */
+#define KPOOL_STRIDE(SIZE)                                              \
+    (((SIZE) + CPU_CACHE_LINE_SIZE - 1) & ~(CPU_CACHE_LINE_SIZE - 1))
+
+/**
+ * @brief Reserves the storage of a typed pool.
+ *
+ * @details Reserves a cache aligned storage able to hold CAPACITY objects of
+ * type TYPE, to be given to kpool_init with KPOOL_INIT_TYPED.
+ *
+ * @param[in] NAME The storage name.
+ * @param[in] TYPE The pool objects type.
+ * @param[in] CAPACITY The number of objects of the pool.
+ */
+#define KPOOL_STORAGE(NAME, TYPE, CAPACITY)                             \
+    uint8_t NAME[KPOOL_STRIDE(sizeof(TYPE)) * (CAPACITY)]               \
+        __attribute__((aligned(CPU_CACHE_LINE_SIZE)))
+
+/**
+ * @brief Initializes a typed pool over its reserved storage.
+ *
+ * @param[out] POOL The pool to initialize.
+ * @param[in] STORAGE The storage reserved with KPOOL_STORAGE.
+ * @param[in] TYPE The pool objects type.
+ * @param[in] CPU_CACHE Tells if the pool uses the CPUs caches.
+ */
+#define KPOOL_INIT_TYPED(POOL, STORAGE, TYPE, CPU_CACHE)                \
+    kpool_init((POOL), (STORAGE), sizeof(TYPE),                         \
+               sizeof(STORAGE) / KPOOL_STRIDE(sizeof(TYPE)), (CPU_CACHE))
+
+/**
+ * @brief Allocates a typed object from a pool.
+ *
+ * @param[in, out] POOL The pool to allocate from.
+ * @param[in] TYPE The pool objects type.
+ */
+#define KPOOL_ALLOC(POOL, TYPE) ((TYPE*)kpool_alloc(POOL))
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes a pool.
+ *
+ * @details Initializes a pool over a pre-reserved memory area. The area is cut
+ * in capacity objects, each one starting on a cache line. All the objects are
+ * free after the initialization. When the CPUs caches are used, the pool must
+ * only be used once the CPU local storage is initialized. Each CPU cache can
+ * keep up to KPOOL_CPU_CACHE_SIZE free objects that the other CPUs cannot
+ * allocate, small pools should not use them.
+ *
+ * @param[out] pool The pool to initialize.
+ * @param[in] memory The memory area, aligned on a cache line and able to hold
+ * capacity times KPOOL_STRIDE(object_size) bytes.
+ * @param[in] object_size The size of the pool objects.
+ * @param[in] capacity The number of objects of the pool.
+ * @param[in] cpu_cache Tells if the pool uses the CPUs caches.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the pool or the memory is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the memory is not aligned on a
+ * cache line, the object size is smaller than a pointer or the capacity is 0.
+ */
+OS_RETURN_E kpool_init(kpool_t* pool,
+                       void* memory,
+                       const size_t object_size,
+                       const uint32_t capacity,
+                       const bool_t cpu_cache);
+
+/**
+ * @brief Allocates an object from a pool.
+ *
+ * @details Allocates an object from a pool, from the calling CPU cache when
+ * possible. The object content is undefined. This function can be called from
+ * interrupt handlers.
+ *
+ * @param[in, out] pool The pool to allocate from.
+ *
+ * @return The allocated object, NULL if the pool has no free object left.
+ */
+void* kpool_alloc(kpool_t* pool);
+
+/**
+ * @brief Releases an object to its pool.
+ *
+ * @details Releases an object to its pool, to the calling CPU cache when
+ * possible. NULL is ignored. Releasing an object that does not belong to the
+ * pool raises a kernel panic. This function can be called from interrupt
+ * handlers.
+ *
+ * @param[in, out] pool The pool the object was allocated from.
+ * @param[in] object The object to release.
+ */
+void kpool_free(kpool_t* pool, void* object);
+
+/**
+ * @brief Tells if an object belongs to a pool.
+ *
+ * @param[in] pool The pool.
+ * @param[in] object The object to check.
+ *
+ * @return TRUE if the object is one of the pool objects, FALSE otherwise.
+ */
+bool_t kpool_contains(const kpool_t* pool, const void* object);
+
+#endif /* #ifndef __CORE_KPOOL_H_ */
+
+/************************************ EOF *************************************/
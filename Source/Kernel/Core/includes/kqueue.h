@@ -0,0 +1,167 @@
+/*******************************************************************************
+ * @file kqueue.h
+ *
+ * @see kqueue.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's intrusive queues.
+ *
+ * @details Kernel's intrusive queues. The queue nodes are embedded in the
+ * queued objects, queuing never allocates and an object is removed from the
+ * middle of its queue in constant time. The queues are not synchronized, the
+ * caller protects them with its own lock.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_KQUEUE_H_
+#define __CORE_KQUEUE_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Intrusive queue node, embedded in the queued object. */
+typedef struct kqueue_node
+{
+    /** @brief Next node of the queue, toward the tail. */
+    struct kqueue_node* next;
+
+    /** @brief Previous node of the queue, toward the head. */
+    struct kqueue_node* prev;
+
+    /** @brief Tells if the node is in a queue. */
+    bool_t enlisted;
+} kqueue_node_t;
+
+/** @brief Intrusive queue. */
+typedef struct
+{
+    /** @brief Queue's head, the next node popped. */
+    kqueue_node_t* head;
+
+    /** @brief Queue's tail, the last node pushed. */
+    kqueue_node_t* tail;
+
+    /** @brief Number of nodes in the queue. */
+    size_t size;
+} kqueue_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/** @brief Static initializer of an empty queue. */
+#define KQUEUE_INIT_VALUE {NULL, NULL, 0}
+
+/** @brief Static initializer of a node that is not in a queue. */
+#define KQUEUE_NODE_INIT_VALUE {NULL, NULL, FALSE}
+
+/**
+ * @brief Returns the object containing a queue node.
+ *
+ * @param[in] NODE The queue node.
+ * @param[in] TYPE The type of the object containing the node.
+ * @param[in] MEMBER The name of the node in the object.
+ */
+#define KQUEUE_ENTRY(NODE, TYPE, MEMBER)                    \
+    ((TYPE*)((uintptr_t)(NODE) - offsetof(TYPE, MEMBER)))
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes a queue.
+ *
+ * @details Initializes an empty queue.
+ *
+ * @param[out] queue The queue to initialize.
+ */
+void kqueue_init(kqueue_t* queue);
+
+/**
+ * @brief Initializes a queue node.
+ *
+ * @details Initializes a node that is not in a queue.
+ *
+ * @param[out] node The node to initialize.
+ */
+void kqueue_node_init(kqueue_node_t* node);
+
+/**
+ * @brief Inserts a node at the tail of a queue.
+ *
+ * @details Inserts a node at the tail of a queue, nothing is done if the node
+ * is already in a queue.
+ *
+ * @param[in, out] queue The queue.
+ * @param[in, out] node The node to insert, must stay valid while it is queued.
+ */
+void kqueue_push(kqueue_t* queue, kqueue_node_t* node);
+
+/**
+ * @brief Inserts a node at the head of a queue.
+ *
+ * @details Inserts a node at the head of a queue, nothing is done if the node
+ * is already in a queue.
+ *
+ * @param[in, out] queue The queue.
+ * @param[in, out] node The node to insert, must stay valid while it is queued.
+ */
+void kqueue_push_front(kqueue_t* queue, kqueue_node_t* node);
+
+/**
+ * @brief Removes the node at the head of a queue.
+ *
+ * @param[in, out] queue The queue.
+ *
+ * @return The removed node, NULL if the queue is empty.
+ */
+kqueue_node_t* kqueue_pop(kqueue_t* queue);
+
+/**
+ * @brief Removes a node from a queue.
+ *
+ * @details Removes a node from a queue, nothing is done if the node is not in
+ * a queue. The node must not be in another queue.
+ *
+ * @param[in, out] queue The queue.
+ * @param[in, out] node The node to remove.
+ */
+void kqueue_remove(kqueue_t* queue, kqueue_node_t* node);
+
+#endif /* #ifndef __CORE_KQUEUE_H_ */
+
+/************************************ EOF *************************************/
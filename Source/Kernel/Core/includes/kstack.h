@@ -0,0 +1,149 @@
+/*******************************************************************************
+ * @file kstack.h
+ *
+ * @see kstack.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's threads stacks.
+ *
+ * @details Kernel's threads stacks. The threads stacks are slots of a virtual
+ * area, each slot starts with an unmapped guard page: a stack overflow faults
+ * instead of overwriting the memory below the stack. When the page faults are
+ * delivered on a dedicated stack, only the top page of a stack is committed
+ * when it is allocated and the other pages are committed by the page fault
+ * handler on first touch. The released stacks pages are then given back by
+ * the idle CPUs.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_KSTACK_H_
+#define __CORE_KSTACK_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+#include <kerror.h> /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Allocates a thread stack.
+ *
+ * @details Allocates a stack slot and commits its top page, or the whole
+ * stack when the pages cannot be committed on first touch. The page fault
+ * frames reserve of the calling CPU is refilled. The virtual memory manager
+ * must be initialized.
+ *
+ * @param[out] stack The lowest address of the stack, above the guard page.
+ * @param[out] size The size of the stack, without the guard page.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if stack or size is NULL.
+ * - OS_ERR_NO_MORE_MEMORY is returned if no slot is free or the stack could
+ * not be committed.
+ */
+OS_RETURN_E kstack_alloc(uintptr_t* stack, size_t* size);
+
+/**
+ * @brief Releases a thread stack.
+ *
+ * @details Releases a stack given by kstack_alloc. The stack pages are kept,
+ * the next allocations can reuse them until an idle CPU gives them back. The
+ * function can be called with the interrupts disabled.
+ *
+ * @param[in] stack The lowest address of the stack, given by kstack_alloc.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if stack is not an allocated
+ * stack.
+ */
+OS_RETURN_E kstack_free(const uintptr_t stack);
+
+/**
+ * @brief Gives back the pages of the released stacks.
+ *
+ * @details Gives back the pages of the released stacks, except their top
+ * page, and refills the page fault frames reserve of the calling CPU. The
+ * function is called by the idle threads, with the interrupts enabled.
+ */
+void kstack_reclaim(void);
+
+/**
+ * @brief Commits a thread stack page on a page fault.
+ *
+ * @details Commits the page of a faulting address lying in an allocated stack
+ * with a frame of the page fault reserve of the calling CPU. The function is
+ * called by the page fault entry path with the interrupts disabled, it takes
+ * no lock and allocates no memory.
+ *
+ * @param[in] address The faulting address.
+ *
+ * @return TRUE if the page was committed and the access can be retried, FALSE
+ * if the fault must be handled as any other fault: the address is not in an
+ * allocated stack, it lies in a guard page or the reserve is empty.
+ */
+bool_t kstack_handle_fault(const uintptr_t address);
+
+/**
+ * @brief Returns the bounds of the thread stack containing an address.
+ *
+ * @param[in] address The address to check.
+ * @param[out] low The lowest address of the stack, above the guard page.
+ * @param[out] high The address following the stack.
+ *
+ * @return TRUE if the address lies in a stack slot, FALSE otherwise.
+ */
+bool_t kstack_get_bounds(const uintptr_t address,
+                         uintptr_t* low,
+                         uintptr_t* high);
+
+#endif /* #ifndef __CORE_KSTACK_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,208 @@
+/*******************************************************************************
+ * @file ktask.h
+ *
+ * @see ktask.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's stackless cooperative tasks.
+ *
+ * @details Kernel's stackless cooperative tasks. A task is a step function and
+ * a small heap allocated frame holding its state, it has no stack nor CPU
+ * context of its own. Each CPU has an executor thread running the steps of its
+ * ready tasks one after the other: a step runs until the task waits, yields or
+ * ends and returns, the next task then runs after a function return instead
+ * of a thread switch. The step function keeps its resume point in the task,
+ * the task code is a state machine. A waiting task is made ready by
+ * ktask_wake, from any context, for instance by the completion of its
+ * asynchronous I/O ring. Thousands of waiting tasks then only cost their
+ * frame.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_KTASK_H_
+#define __CORE_KTASK_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Result of a task step. */
+typedef enum
+{
+    /** @brief The task ended, it is released. */
+    KTASK_DONE  = 0,
+    /** @brief The task waits until it is woken up. */
+    KTASK_WAIT  = 1,
+    /** @brief The task stays ready, the other ready tasks run first. */
+    KTASK_YIELD = 2
+} KTASK_STATUS_E;
+
+/* Forward declarations */
+struct ktask;
+
+/**
+ * @brief Step function of a task.
+ *
+ * @details Runs the task from its resume point until it waits, yields or
+ * ends. The step runs in the executor thread with interrupts enabled, it must
+ * not wait nor sleep: the waits are done by returning KTASK_WAIT.
+ *
+ * @param[in, out] task The task.
+ *
+ * @return The task status after the step.
+ */
+typedef KTASK_STATUS_E (*ktask_step_t)(struct ktask* task);
+
+/** @brief Stackless task. */
+typedef struct ktask
+{
+    /** @brief Next task of the executor ready queue. */
+    struct ktask* next;
+
+    /** @brief The task step function. */
+    ktask_step_t step;
+
+    /** @brief The task frame, zeroed on creation, follows the task. */
+    void* frame;
+
+    /** @brief Resume point of the step function, 0 on the first step. */
+    uint32_t resume;
+
+    /** @brief The CPU whose executor runs the task. */
+    uint32_t cpu_id;
+
+    /** @brief The task scheduling state, private to the executors. */
+    volatile uint32_t state;
+} ktask_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Creates the executor thread of the calling CPU.
+ *
+ * @details Creates the thread running the tasks of the calling CPU, bound to
+ * the CPU. This function must be called by each CPU after its scheduler data
+ * was initialized and the scheduler was initialized.
+ *
+ * @param[in] cpu_id The identifier of the calling CPU.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the CPU identifier is not valid
+ * or the CPU already has an executor thread.
+ * - Any error returned by the scheduler when creating the executor thread.
+ */
+OS_RETURN_E ktask_init_cpu(const uint32_t cpu_id);
+
+/**
+ * @brief Creates a task.
+ *
+ * @details Allocates a task and its frame in a single allocation. The task is
+ * not started, the caller fills its frame before starting it.
+ *
+ * @param[in] step The task step function.
+ * @param[in] frame_size The size of the task frame, can be 0.
+ * @param[out] task The buffer receiving the task.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if step or task is NULL.
+ * - OS_ERR_NO_MORE_MEMORY is returned if the task could not be allocated.
+ */
+OS_RETURN_E ktask_create(ktask_step_t step,
+                         const size_t frame_size,
+                         ktask_t** task);
+
+/**
+ * @brief Releases a task that was not started.
+ *
+ * @details The started tasks are released when their step returns
+ * KTASK_DONE.
+ *
+ * @param[in] task The task to release.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if task is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the task was started.
+ */
+OS_RETURN_E ktask_destroy(ktask_t* task);
+
+/**
+ * @brief Starts a task.
+ *
+ * @details Makes the task ready on the executor of the calling CPU, that runs
+ * all its steps.
+ *
+ * @param[in, out] task The task to start.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if task is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the task was already started or
+ * the calling CPU has no executor.
+ */
+OS_RETURN_E ktask_start(ktask_t* task);
+
+/**
+ * @brief Wakes up a task.
+ *
+ * @details Makes a waiting task ready on its executor. A task woken up while
+ * its step runs runs again once the step returns, even if it returns
+ * KTASK_WAIT: a wakeup is never lost. Waking up a ready task does nothing.
+ * This function can be called from interrupt handlers. A task must not be
+ * woken up once it ended.
+ *
+ * @param[in, out] task The task to wake up.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if task is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the task was not started.
+ */
+OS_RETURN_E ktask_wake(ktask_t* task);
+
+#endif /* #ifndef __CORE_KTASK_H_ */
+
+/************************************ EOF *************************************/
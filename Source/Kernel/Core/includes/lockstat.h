@@ -0,0 +1,169 @@
+/*******************************************************************************
+ * @file lockstat.h
+ *
+ * @see lockstat.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's spinlocks contention statistics.
+ *
+ * @details Kernel's spinlocks contention statistics. When KERNEL_LOCKSTAT is
+ * enabled, each KERNEL_SPINLOCK_LOCK site defines a static site descriptor in
+ * the .lockstat_sites section. The lock records in the descriptor the
+ * acquisitions, the contended acquisitions, the cycles spent spinning and the
+ * longest hold time of the lock taken at the site, and the stack of the
+ * longest spin. When KERNEL_LOCKSTAT is disabled, no descriptor is emitted and
+ * the locks do not measure anything.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_LOCKSTAT_H_
+#define __CORE_LOCKSTAT_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+
+/* Configuration files */
+#include <config.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of return addresses recorded with the longest spin. */
+#define LOCKSTAT_STACK_DEPTH 6
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Lock site descriptor. The descriptors are packed in the
+ * .lockstat_sites section, their size is a multiple of their alignment and
+ * the descriptors variables are not aligned further by the compiler.
+ */
+typedef struct
+{
+    /** @brief The lock expression given at the site. */
+    const char* name;
+
+    /** @brief The source file of the site. */
+    const char* file;
+
+    /** @brief The source line of the site. */
+    uint32_t line;
+
+    /** @brief Number of return addresses in stack. */
+    uint32_t stack_depth;
+
+    /** @brief Number of acquisitions. */
+    uint64_t acquisitions;
+
+    /** @brief Number of acquisitions that waited for the lock. */
+    uint64_t contentions;
+
+    /** @brief Timestamp counter ticks spent waiting for the lock. */
+    uint64_t spin_cycles;
+
+    /** @brief Longest wait for the lock, in timestamp counter ticks. */
+    uint64_t max_spin_cycles;
+
+    /** @brief Longest time the lock was held, in timestamp counter ticks. */
+    uint64_t max_hold_cycles;
+
+    /** @brief Stack of the longest wait, innermost first. */
+    uintptr_t stack[LOCKSTAT_STACK_DEPTH];
+} __attribute__((aligned(8))) lockstat_site_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Defines the descriptor of a lock site.
+ *
+ * @param[in] VAR The descriptor variable name.
+ * @param[in] NAME The lock expression string.
+ */
+#define LOCKSTAT_SITE_DEFINE(VAR, NAME)                                     \
+    static lockstat_site_t VAR                                              \
+    __attribute__((section(".lockstat_sites"), aligned(8), used)) = {       \
+        .name = (NAME),                                                     \
+        .file = __FILE__,                                                   \
+        .line = __LINE__                                                    \
+    }
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Records the acquisition of a lock at a site.
+ *
+ * @details Records the acquisition of a lock at a site. The stack is walked
+ * when the wait is the longest seen at the site. The site counters are
+ * updated atomically, the recorded stack is best effort when two CPUs beat
+ * the longest wait at the same time.
+ *
+ * @param[in-out] site The lock site descriptor.
+ * @param[in] contended TRUE if the lock was taken when the caller arrived.
+ * @param[in] spin_cycles The time the caller waited for the lock, in
+ * timestamp counter ticks.
+ */
+void lockstat_record_acquire(lockstat_site_t* site,
+                             const bool_t contended,
+                             const uint64_t spin_cycles);
+
+/**
+ * @brief Records the release of a lock taken at a site.
+ *
+ * @param[in-out] site The lock site descriptor.
+ * @param[in] hold_cycles The time the lock was held, in timestamp counter
+ * ticks.
+ */
+void lockstat_record_release(lockstat_site_t* site,
+                             const uint64_t hold_cycles);
+
+/**
+ * @brief Clears the statistics of all the lock sites.
+ *
+ * @details Clears the statistics of all the lock sites. The acquisitions
+ * recorded meanwhile might be partially cleared.
+ */
+void lockstat_reset(void);
+
+/**
+ * @brief Outputs the statistics of the lock sites.
+ *
+ * @details Outputs the statistics of the acquired lock sites on the kernel
+ * output, one "#LOCKSTAT <lock> <file>:<line> <acquisitions> <contentions>
+ * <spin_cycles> <max_spin_cycles> <max_hold_cycles>" line per site, followed
+ * by a "#LOCKSTAT_STACK <frame>;...;<frame>" line for the contended sites.
+ * The frames are innermost first. Nothing is output when KERNEL_LOCKSTAT is
+ * disabled.
+ */
+void lockstat_dump(void);
+
+#endif /* #ifndef __CORE_LOCKSTAT_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,262 @@
+/*******************************************************************************
+ * @file memmgt.h
+ *
+ * @see memmgt.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's physical memory manager.
+ *
+ * @details Kernel's physical memory manager. The available physical memory is
+ * read from the multiboot memory map and served as blocks of 2^order frames,
+ * from 4KB to 2MB, by a buddy allocator. Single frames are allocated and
+ * released through per-CPU hot frames lists.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_MEMMGT_H_
+#define __CORE_MEMMGT_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Size of a physical frame in bytes. */
+#define MEMMGT_FRAME_SIZE 0x1000
+
+/** @brief Largest order of a frames block, 2^9 frames are 2MB. */
+#define MEMMGT_MAX_ORDER 9
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Free physical memory statistics. */
+typedef struct
+{
+    /** @brief Number of free blocks of each order. */
+    size_t free_blocks[MEMMGT_MAX_ORDER + 1];
+
+    /** @brief Number of free frames in the free blocks. */
+    size_t free_frames;
+
+    /** @brief Number of free frames kept in the CPUs hot frames lists. */
+    size_t hot_frames;
+} memmgt_stats_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the physical memory manager.
+ *
+ * @details Initializes the physical memory manager. The multiboot information
+ * is copied to the KERNEL_MULTIBOOT_MEM region and its memory map is parsed.
+ * The low memory, the kernel image and regions and the multiboot modules are
+ * never served. The frames descriptors are allocated from the kernel heap,
+ * this function must be called after the kernel heap was initialized.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the memory manager is already
+ * initialized.
+ * - OS_ERR_NULL_POINTER is returned if the multiboot information is missing.
+ * - OS_ERR_NOT_SUPPORTED is returned if the multiboot information has no
+ * memory map.
+ * - OS_ERR_NO_MORE_MEMORY is returned if the multiboot information does not
+ * fit its region or no physical memory could be managed.
+ */
+OS_RETURN_E memmgt_init(void);
+
+/**
+ * @brief Allocates a block of physical frames.
+ *
+ * @details Allocates a block of 2^order contiguous physical frames, aligned
+ * on its size. Single frames are taken from the calling CPU hot frames list
+ * when possible. This function can be called from interrupt handlers.
+ *
+ * @param[in] order The order of the block, from 0 to MEMMGT_MAX_ORDER.
+ * @param[out] frame The physical address of the allocated block.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if frame is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the order is too large or the
+ * memory manager is not initialized.
+ * - OS_ERR_NO_MORE_MEMORY is returned if no block of this order is free.
+ */
+OS_RETURN_E memmgt_alloc_frames(const uint32_t order, uintptr_t* frame);
+
+/**
+ * @brief Releases a block of physical frames.
+ *
+ * @details Releases a block of physical frames allocated with
+ * memmgt_alloc_frames, with the same order. Single frames are given to the
+ * calling CPU hot frames list, a frame shared with memmgt_share_frame only
+ * loses a reference until its last one. This function can be called from
+ * interrupt handlers.
+ *
+ * @param[in] frame The physical address of the block.
+ * @param[in] order The order the block was allocated with.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the block is not an allocated
+ * block of this order or the memory manager is not initialized.
+ */
+OS_RETURN_E memmgt_free_frames(const uintptr_t frame, const uint32_t order);
+
+/**
+ * @brief Adds a reference to an allocated single frame.
+ *
+ * @details Adds a reference to a single frame allocated with
+ * memmgt_alloc_frames, the caller holding a reference. Each reference is
+ * dropped with memmgt_free_frames, the frame is released with the last one.
+ * This function can be called from interrupt handlers.
+ *
+ * @param[in] frame The physical address of the frame.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the frame is not an allocated
+ * single frame or the memory manager is not initialized.
+ * - OS_ERR_OUT_OF_BOUND is returned if the frame has too many references.
+ */
+OS_RETURN_E memmgt_share_frame(const uintptr_t frame);
+
+/**
+ * @brief Tells if an allocated single frame has several references.
+ *
+ * @details A frame whose caller holds the only reference cannot be shared
+ * again by another holder, the caller can then write it in place.
+ *
+ * @param[in] frame The physical address of the frame.
+ *
+ * @return TRUE if the frame has several references, FALSE otherwise or if the
+ * frame is not an allocated single frame.
+ */
+bool_t memmgt_is_frame_shared(const uintptr_t frame);
+
+/**
+ * @brief Returns the number of free physical frames.
+ *
+ * @details Returns the number of free physical frames, including the frames
+ * kept in the CPUs hot frames lists.
+ *
+ * @return The number of free physical frames.
+ */
+size_t memmgt_get_free_frames(void);
+
+/**
+ * @brief Returns the free physical memory statistics.
+ *
+ * @details Counts the free blocks of each order of all the zones. The free
+ * blocks sizes tell how fragmented the physical memory is: the free frames
+ * out of the blocks of an order cannot serve an allocation of this order.
+ * The hot frames are read without lock, they are approximate.
+ *
+ * @param[out] stats The buffer receiving the statistics.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if stats is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the memory manager is not
+ * initialized.
+ */
+OS_RETURN_E memmgt_get_stats(memmgt_stats_t* stats);
+
+/**
+ * @brief Returns the physical range of a multiboot module.
+ *
+ * @details Returns the physical range of a module loaded by the bootloader.
+ * The modules memory is never served by the manager, the modules are indexed
+ * in the multiboot information order.
+ *
+ * @param[in] index The index of the module.
+ * @param[out] start The buffer receiving the module start physical address.
+ * @param[out] end The buffer receiving the module end physical address,
+ * excluded.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if a buffer is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if there is no module at this
+ * index or the memory manager is not initialized.
+ */
+OS_RETURN_E memmgt_get_module(const uint32_t index,
+                              uint64_t* start,
+                              uint64_t* end);
+
+/**
+ * @brief Sets the NUMA node of a physical range.
+ *
+ * @details Sets the NUMA node of the zones of a physical range, the zones
+ * crossing the range bounds are split. The bounds are rounded down to the
+ * largest block size. The allocations prefer the zones of the calling CPU
+ * node. This function is called at boot by the firmware tables parsers.
+ *
+ * @param[in] start The start address of the range.
+ * @param[in] end The end address of the range, excluded.
+ * @param[in] node The NUMA node of the range.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the range is empty or the
+ * memory manager is not initialized.
+ * - OS_ERR_OUT_OF_BOUND is returned if no zone is left to split a zone, the
+ * node of the zones that could not be split is not changed.
+ */
+OS_RETURN_E memmgt_set_node_range(const uint64_t start,
+                                  const uint64_t end,
+                                  const uint32_t node);
+
+/**
+ * @brief Returns the ACPI RSDP given by the bootloader.
+ *
+ * @param[out] rsdp The buffer receiving the address of the RSDP copy kept in
+ * the multiboot information.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the buffer is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if the bootloader gave no RSDP or the
+ * memory manager is not initialized.
+ */
+OS_RETURN_E memmgt_get_acpi_rsdp(const void** rsdp);
+
+#endif /* #ifndef __CORE_MEMMGT_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,284 @@
+/*******************************************************************************
+ * @file memstat.h
+ *
+ * @see memstat.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's memory usage statistics.
+ *
+ * @details Kernel's memory usage statistics. When KERNEL_MEMSTAT is enabled,
+ * each kmalloc call site defines a static site descriptor in the
+ * .memstat_sites section. The heap records in the descriptor and in its size
+ * class the allocations, the releases, the failures, the bytes in use and
+ * their peak. The heap tags each allocation with its site to credit the
+ * release to it, one byte per 16 bytes of heap pages. One allocation out of
+ * KERNEL_MEMSTAT_SAMPLE_PERIOD records its stack. When KERNEL_MEMSTAT is
+ * disabled, no descriptor is emitted and the heap does not measure anything.
+ * The physical memory fragmentation is read from the buddy allocator free
+ * lists, with or without KERNEL_MEMSTAT.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_MEMSTAT_H_
+#define __CORE_MEMSTAT_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+#include <memmgt.h> /* Physical memory statistics */
+#include <kerror.h> /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of size classes recorded: the heap slab size classes
+ * followed by the large allocations.
+ */
+#define MEMSTAT_CLASS_COUNT 9
+
+/** @brief Number of return addresses recorded with a sampled allocation. */
+#define MEMSTAT_STACK_DEPTH 6
+
+/** @brief Number of sampled allocations kept, the oldest are overwritten. */
+#define MEMSTAT_SAMPLE_COUNT 32
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Allocation site descriptor. The descriptors are packed in the
+ * .memstat_sites section, their size is a multiple of their alignment and
+ * the descriptors variables are not aligned further by the compiler.
+ */
+typedef struct
+{
+    /** @brief The source file of the site. */
+    const char* file;
+
+    /** @brief The source line of the site. */
+    uint32_t line;
+
+    /** @brief Reserved, 0. */
+    uint32_t reserved;
+
+    /** @brief Number of allocations. */
+    uint64_t allocations;
+
+    /** @brief Number of releases of the site allocations. */
+    uint64_t frees;
+
+    /** @brief Number of allocations that failed. */
+    uint64_t failures;
+
+    /** @brief Bytes requested by the allocations. */
+    uint64_t requested_bytes;
+
+    /** @brief Heap bytes used by the site allocations not released yet. */
+    uint64_t live_bytes;
+
+    /** @brief Largest value of live_bytes. */
+    uint64_t peak_bytes;
+} __attribute__((aligned(8))) memstat_site_t;
+
+/** @brief Size class statistics. */
+typedef struct
+{
+    /** @brief Number of allocations. */
+    uint64_t allocations;
+
+    /** @brief Number of releases. */
+    uint64_t frees;
+
+    /** @brief Number of allocations that failed. */
+    uint64_t failures;
+
+    /** @brief Heap bytes used by the allocations not released yet. */
+    uint64_t live_bytes;
+
+    /** @brief Largest value of live_bytes. */
+    uint64_t peak_bytes;
+} memstat_class_t;
+
+/** @brief Sampled allocation. */
+typedef struct
+{
+    /** @brief The allocation site, NULL if the allocation has no site. */
+    const memstat_site_t* site;
+
+    /** @brief The requested size. */
+    size_t size;
+
+    /** @brief Number of return addresses in stack. */
+    uint32_t stack_depth;
+
+    /** @brief Stack of the allocation, innermost first, starting in the
+     * function calling kmalloc.
+     */
+    uintptr_t stack[MEMSTAT_STACK_DEPTH];
+} memstat_sample_t;
+
+/** @brief Memory usage snapshot. */
+typedef struct
+{
+    /** @brief Nanoseconds since the statistics were cleared, the counters
+     * over this time give the allocation and release rates.
+     */
+    uint64_t elapsed_ns;
+
+    /** @brief The size classes statistics. */
+    memstat_class_t classes[MEMSTAT_CLASS_COUNT];
+
+    /** @brief The size classes object sizes, 0 for the large allocations. */
+    size_t class_sizes[MEMSTAT_CLASS_COUNT];
+
+    /** @brief Number of allocation sites. */
+    uint32_t site_count;
+
+    /** @brief The physical memory statistics. */
+    memmgt_stats_t frames;
+
+    /** @brief For each order, the free frames out of the free blocks of this
+     * order or larger, in per mille of the free frames: the part of the free
+     * memory unusable by an allocation of the order.
+     */
+    uint32_t unusable[MEMMGT_MAX_ORDER + 1];
+} memstat_snapshot_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Defines the descriptor of an allocation site.
+ *
+ * @param[in] VAR The descriptor variable name.
+ */
+#define MEMSTAT_SITE_DEFINE(VAR)                                            \
+    static memstat_site_t VAR                                               \
+    __attribute__((section(".memstat_sites"), aligned(8), used)) = {        \
+        .file = __FILE__,                                                   \
+        .line = __LINE__                                                    \
+    }
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Records an allocation.
+ *
+ * @details Records an allocation in its site and size class. The stack is
+ * walked from the given frame when the allocation is sampled. The counters
+ * are updated atomically, a sample is best effort when it is read or
+ * overwritten meanwhile. This function can be called from interrupt
+ * handlers.
+ *
+ * @param[in, out] site The allocation site descriptor, can be NULL.
+ * @param[in] class_id The size class.
+ * @param[in] size The requested size.
+ * @param[in] granted The heap bytes used by the allocation, 0 if the
+ * allocation failed.
+ * @param[in] frame The frame pointer of the allocator frame, called by the
+ * allocating function.
+ *
+ * @return The tag of the site, to give to memstat_record_free when the
+ * allocation is released. 0 when the site has no tag.
+ */
+uint8_t memstat_record_alloc(memstat_site_t* site,
+                             const uint32_t class_id,
+                             const size_t size,
+                             const size_t granted,
+                             const uintptr_t frame);
+
+/**
+ * @brief Records the release of an allocation.
+ *
+ * @details This function can be called from interrupt handlers.
+ *
+ * @param[in] tag The tag returned when the allocation was recorded.
+ * @param[in] class_id The size class.
+ * @param[in] granted The heap bytes used by the allocation.
+ */
+void memstat_record_free(const uint8_t tag,
+                         const uint32_t class_id,
+                         const size_t granted);
+
+/**
+ * @brief Returns the allocation sites.
+ *
+ * @param[out] count The buffer receiving the number of sites.
+ *
+ * @return The allocation sites, in link order.
+ */
+const memstat_site_t* memstat_get_sites(uint32_t* count);
+
+/**
+ * @brief Clears the statistics.
+ *
+ * @details Clears the counters of the sizes classes and the sites, the sampled
+ * allocations and restarts the measured time. The bytes in use are kept, the
+ * peaks restart from them. The allocations recorded meanwhile might be
+ * partially cleared.
+ */
+void memstat_reset(void);
+
+/**
+ * @brief Takes a snapshot of the memory usage.
+ *
+ * @details Copies the size classes statistics and computes the physical
+ * memory fragmentation. The counters are read one by one while the heap is
+ * used, the snapshot is not atomic.
+ *
+ * @param[out] snapshot The buffer receiving the snapshot.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if snapshot is NULL.
+ * - Any error returned by memmgt_get_stats, the heap statistics are then
+ * valid but not the physical memory ones.
+ */
+OS_RETURN_E memstat_snapshot(memstat_snapshot_t* snapshot);
+
+/**
+ * @brief Outputs the memory usage.
+ *
+ * @details Outputs the memory usage on the kernel output. When KERNEL_MEMSTAT
+ * is enabled: one "#MEMSTAT_CLASS <size> <allocations> <frees> <failures>
+ * <live_bytes> <peak_bytes>" line per size class, the size is 0 for the large
+ * allocations, then one "#MEMSTAT_SITE <file>:<line> <allocations> <frees>
+ * <failures> <requested_bytes> <live_bytes> <peak_bytes>" line per used site
+ * and one "#MEMSTAT_SAMPLE <size> <file>:<line> <frame>;...;<frame>" line per
+ * sampled allocation. Then one "#MEMSTAT_BUDDY <order> <free_blocks>
+ * <unusable>" line per order. The frames are innermost first.
+ */
+void memstat_dump(void);
+
+#endif /* #ifndef __CORE_MEMSTAT_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,164 @@
+/*******************************************************************************
+ * @file mutex.h
+ *
+ * @see mutex.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's mutexes.
+ *
+ * @details Kernel's mutexes. A free mutex is acquired with a single atomic
+ * operation. A thread finding the mutex owned by a thread running on another
+ * CPU spins for a short time, expecting the owner to release it soon. It then
+ * sleeps in the mutex wait queue and is given the mutex directly by the
+ * owner's release. The priority inheritance mutexes raise the priority of
+ * their owner to the priority of their highest priority waiter.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_MUTEX_H_
+#define __CORE_MUTEX_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>     /* Generic int types */
+#include <stddef.h>     /* Standard definitions */
+#include <kerror.h>     /* Kernel error codes */
+#include <critical.h>   /* Kernel spinlocks */
+#include <wait_queue.h> /* Threads wait queue */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Mutex flag, no option. */
+#define MUTEX_FLAG_NONE             0x0
+
+/** @brief Mutex flag, the owner inherits the priority of its waiters. */
+#define MUTEX_FLAG_PRIO_INHERITANCE 0x1
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Kernel mutex. */
+typedef struct
+{
+    /** @brief Owner thread, 0 when the mutex is free. The lowest bit is set
+     * when threads wait for the mutex.
+     */
+    volatile uintptr_t owner;
+
+    /** @brief Threads waiting for the mutex. */
+    wait_queue_t waiters;
+
+    /** @brief Lock protecting the wait queue. */
+    kernel_spinlock_t lock;
+
+    /** @brief Mutex flags, a combination of the MUTEX_FLAG values. */
+    uint32_t flags;
+} mutex_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Static initializer of a free mutex.
+ *
+ * @param[in] FLAGS The mutex flags, a combination of the MUTEX_FLAG values.
+ */
+#define MUTEX_INIT_VALUE(FLAGS) \
+    {0, WAIT_QUEUE_INIT_VALUE, KERNEL_SPINLOCK_INIT_VALUE, (FLAGS)}
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes a mutex.
+ *
+ * @details Initializes a free mutex.
+ *
+ * @param[out] mutex The mutex to initialize.
+ * @param[in] flags The mutex flags, a combination of the MUTEX_FLAG values.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the mutex is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the flags are not valid.
+ */
+OS_RETURN_E mutex_init(mutex_t* mutex, const uint32_t flags);
+
+/**
+ * @brief Locks a mutex.
+ *
+ * @details Locks a mutex, the calling thread waits until the mutex is free.
+ * This function must be called by a thread, with interrupts enabled and
+ * outside of a RCU read-side section.
+ *
+ * @param[in, out] mutex The mutex to lock.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the mutex is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the calling thread already
+ * owns the mutex or is an idle thread that would have to wait.
+ */
+OS_RETURN_E mutex_lock(mutex_t* mutex);
+
+/**
+ * @brief Tries to lock a mutex.
+ *
+ * @details Locks a mutex only if it is free, the calling thread never waits.
+ *
+ * @param[in, out] mutex The mutex to lock.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the mutex is NULL.
+ * - OS_ERR_RESOURCE_BUSY is returned if the mutex is owned.
+ */
+OS_RETURN_E mutex_trylock(mutex_t* mutex);
+
+/**
+ * @brief Unlocks a mutex.
+ *
+ * @details Unlocks a mutex. When threads wait for the mutex, the highest
+ * priority one becomes the owner and is woken up. A thread that inherited a
+ * priority gets its base priority back once it released all its priority
+ * inheritance mutexes.
+ *
+ * @param[in, out] mutex The mutex to unlock.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the mutex is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the calling thread does not
+ * own the mutex.
+ */
+OS_RETURN_E mutex_unlock(mutex_t* mutex);
+
+#endif /* #ifndef __CORE_MUTEX_H_ */
+
+/************************************ EOF *************************************/
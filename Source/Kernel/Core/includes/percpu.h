@@ -0,0 +1,187 @@
+/*******************************************************************************
+ * @file percpu.h
+ *
+ * @see percpu.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's per-CPU variables.
+ *
+ * @details Kernel's per-CPU variables. The per-CPU variables are defined in
+ * the .percpu section, linked at address 0: the address of a per-CPU variable
+ * is its offset in the per-CPU data area of each CPU. The section is a
+ * template copied in the areas at boot. The CPU local storage is the base of
+ * the CPU area, the current CPU variables are reached through the GS segment
+ * with a single instruction and need neither a CPU identifier nor atomic
+ * operations. The variables of the other CPUs are reached through PERCPU_PTR.
+ * A per-CPU variable must never be accessed by its name in C code.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_PERCPU_H_
+#define __CORE_PERCPU_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <cpu.h>    /* CPU local storage */
+
+/* Configuration files */
+#include <config.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Defines a per-CPU variable. The alignment of the variable must not
+ * exceed CPU_CACHE_LINE_SIZE.
+ *
+ * @param[in] TYPE The variable type.
+ * @param[in] NAME The variable name.
+ */
+#define PERCPU_DEFINE(TYPE, NAME) \
+    TYPE NAME __attribute__((section(".percpu")))
+
+/**
+ * @brief Defines the per-CPU variable placed at the base of the per-CPU areas,
+ * at the CPU local storage offsets used by the interrupt entry paths. Only the
+ * scheduler CPU data is defined this way.
+ *
+ * @param[in] TYPE The variable type.
+ * @param[in] NAME The variable name.
+ */
+#define PERCPU_DEFINE_FIRST(TYPE, NAME) \
+    TYPE NAME __attribute__((section(".percpu.first")))
+
+/**
+ * @brief Returns a pointer to a per-CPU variable of a CPU.
+ *
+ * @param[in] NAME The per-CPU variable, or one of its fields.
+ * @param[in] CPU_ID The identifier of the CPU.
+ */
+#define PERCPU_PTR(NAME, CPU_ID)                                        \
+    ((__typeof__(&(NAME)))((uintptr_t)percpu_areas[(CPU_ID)] +          \
+                           (uintptr_t)&(NAME)))
+
+/**
+ * @brief Returns a pointer to a per-CPU variable of the current CPU. The
+ * pointer stays valid after a migration, it then points to the variable of
+ * the previous CPU.
+ *
+ * @param[in] NAME The per-CPU variable, or one of its fields.
+ */
+#define PERCPU_THIS_PTR(NAME)                                           \
+    ((__typeof__(&(NAME)))((uintptr_t)_cpu_get_local_storage() +        \
+                           (uintptr_t)&(NAME)))
+
+/**
+ * @brief Reads a per-CPU variable of the current CPU with a single
+ * instruction. The variable size must not exceed the size of a register.
+ *
+ * @param[in] NAME The per-CPU variable, or one of its fields.
+ *
+ * @return The value of the variable.
+ */
+#define PERCPU_READ(NAME) ({                                            \
+    __typeof__(NAME) _percpu_value;                                     \
+    _Static_assert(sizeof(NAME) <= sizeof(uintptr_t),                   \
+                   "Per-CPU variable larger than a register");          \
+    __asm__ __volatile__("mov %%gs:%P1, %0"                             \
+                         : "=q" (_percpu_value)                         \
+                         : "i" (&(NAME))                                \
+                         : "memory");                                   \
+    _percpu_value;                                                      \
+})
+
+/**
+ * @brief Writes a per-CPU variable of the current CPU with a single
+ * instruction. The variable size must not exceed the size of a register.
+ *
+ * @param[in] NAME The per-CPU variable, or one of its fields.
+ * @param[in] VALUE The value to write.
+ */
+#define PERCPU_WRITE(NAME, VALUE) {                                     \
+    __typeof__(NAME) _percpu_value = (VALUE);                           \
+    _Static_assert(sizeof(NAME) <= sizeof(uintptr_t),                   \
+                   "Per-CPU variable larger than a register");          \
+    __asm__ __volatile__("mov %1, %%gs:%P0"                             \
+                         :: "i" (&(NAME)), "q" (_percpu_value)          \
+                         : "memory");                                   \
+}
+
+/**
+ * @brief Adds a value to a per-CPU variable of the current CPU with a single
+ * instruction. An interrupt cannot split the update on the current CPU, the
+ * other CPUs must not update the variable.
+ *
+ * @param[in] NAME The per-CPU integer variable, or one of its fields.
+ * @param[in] VALUE The value to add.
+ */
+#define PERCPU_ADD(NAME, VALUE) {                                       \
+    __typeof__(NAME) _percpu_value = (VALUE);                           \
+    _Static_assert(sizeof(NAME) <= sizeof(uintptr_t),                   \
+                   "Per-CPU variable larger than a register");          \
+    __asm__ __volatile__("add %1, %%gs:%P0"                             \
+                         :: "i" (&(NAME)), "q" (_percpu_value)          \
+                         : "memory", "cc");                             \
+}
+
+/**
+ * @brief Increments a per-CPU variable of the current CPU with a single
+ * instruction.
+ *
+ * @param[in] NAME The per-CPU integer variable, or one of its fields.
+ */
+#define PERCPU_INC(NAME) PERCPU_ADD(NAME, 1)
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/** @brief Per-CPU data areas, one per CPU. */
+extern uint8_t percpu_areas[MAX_CPU_COUNT][PERCPU_AREA_SIZE];
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the per-CPU data areas.
+ *
+ * @details Initializes the per-CPU data areas of all the CPUs with the .percpu
+ * section template. This function must be called once by the BSP, before any
+ * CPU local storage is set. A kernel panic is generated if the template does
+ * not fit in an area.
+ */
+void percpu_init(void);
+
+#endif /* #ifndef __CORE_PERCPU_H_ */
+
+/************************************ EOF *************************************/
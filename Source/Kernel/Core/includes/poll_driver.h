@@ -0,0 +1,165 @@
+/*******************************************************************************
+ * @file poll_driver.h
+ *
+ * @see poll_driver.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's polling mode drivers.
+ *
+ * @details Kernel's polling mode drivers. The CPUs of POLL_DRIVER_CPU_MASK
+ * are reserved at boot: they leave the threads scheduling, run without
+ * scheduler timer deadline and spin in a loop calling the poll function of
+ * the device queues registered on them. The IRQ of a registered queue is
+ * masked, the device never interrupts the kernel. The other CPUs schedule the
+ * threads as usual.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_POLL_DRIVER_H_
+#define __CORE_POLL_DRIVER_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>  /* Generic int types */
+#include <kerror.h>  /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief IRQ number of a queue that has no IRQ. */
+#define POLL_DRIVER_NO_IRQ 0xFFFFFFFFU
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Device queue polled by a reserved CPU. */
+typedef struct
+{
+    /**
+     * @brief The driver poll function.
+     *
+     * @details Handles up to budget events of the device queue. The function
+     * runs on the reserved CPU with interrupts disabled.
+     *
+     * @param[in] args The driver arguments.
+     * @param[in] budget The maximal number of events to handle.
+     *
+     * @return The number of events handled.
+     */
+    uint32_t (*poll)(void* args, const uint32_t budget);
+
+    /** @brief The driver arguments. */
+    void* args;
+
+    /** @brief The masked IRQ of the queue, POLL_DRIVER_NO_IRQ if none. */
+    uint32_t irq_number;
+
+    /** @brief Maximal number of events handled per poll. */
+    uint32_t budget;
+
+    /** @brief Identifier of the CPU polling the queue. */
+    uint32_t cpu_id;
+} poll_queue_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Registers a device queue on a reserved CPU.
+ *
+ * @details Registers a device queue on a reserved CPU and masks its IRQ. The
+ * queue is polled from the next pass of the CPU poll loop, it must stay valid
+ * until it is unregistered.
+ *
+ * @param[out] queue The queue to register.
+ * @param[in] cpu_id The identifier of the reserved CPU polling the queue.
+ * @param[in] irq_number The IRQ of the queue, POLL_DRIVER_NO_IRQ if none.
+ * @param[in] budget The maximal number of events handled per poll.
+ * @param[in] poll The driver poll function.
+ * @param[in] args The driver arguments.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the queue or the function is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the budget is 0 or if the CPU
+ * is not reserved to the poll loops.
+ * - OS_ERR_OUT_OF_BOUND is returned if the CPU already polls
+ * POLL_DRIVER_MAX_QUEUES queues.
+ */
+OS_RETURN_E poll_driver_register(poll_queue_t* queue,
+                                 const uint32_t cpu_id,
+                                 const uint32_t irq_number,
+                                 const uint32_t budget,
+                                 uint32_t (*poll)(void* args,
+                                                  const uint32_t budget),
+                                 void* args);
+
+/**
+ * @brief Unregisters a device queue.
+ *
+ * @details Unregisters a device queue and unmasks its IRQ. Once this function
+ * returned, the poll function of the queue is not running and will not be
+ * called anymore.
+ *
+ * @param[in, out] queue The queue to unregister.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the queue is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the queue is not registered.
+ */
+OS_RETURN_E poll_driver_unregister(poll_queue_t* queue);
+
+/**
+ * @brief Tells if a CPU is reserved to the poll loops.
+ *
+ * @param[in] cpu_id The identifier of the CPU.
+ *
+ * @return TRUE if the CPU is reserved, FALSE otherwise.
+ */
+bool_t poll_driver_is_reserved(const uint32_t cpu_id);
+
+/**
+ * @brief Runs the poll loop of the current CPU.
+ *
+ * @details Removes the current CPU from the threads scheduling and polls the
+ * queues registered on it forever. The loop reports the RCU quiescent states
+ * of the CPU and still serves the cross-CPU calls. This function must be
+ * called by the boot thread of a reserved AP, before it would enter the idle
+ * loop.
+ */
+void poll_driver_loop(void);
+
+#endif /* #ifndef __CORE_POLL_DRIVER_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,178 @@
+/*******************************************************************************
+ * @file profiler.h
+ *
+ * @see profiler.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's sampling profiler.
+ *
+ * @details Kernel's sampling profiler. At each sample, the instruction pointer
+ * saved by the interrupt entry of the interrupted thread and its stack are
+ * recorded in a per-CPU sample table. The samples are raised by a sampling
+ * source, the performance counters overflow when the architecture provides
+ * it, a kernel deadline of the main timer otherwise. The profile is exported
+ * as folded stacks on the kernel output.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_PROFILER_H_
+#define __CORE_PROFILER_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>     /* Generic int types */
+#include <kerror.h>     /* Kernel error codes */
+#include <ctrl_block.h> /* Thread structures */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of distinct samples each CPU can record, a power of 2. */
+#define PROFILER_SAMPLE_TABLE_SIZE 512
+
+/** @brief Number of addresses recorded in each sampled stack. */
+#define PROFILER_STACK_DEPTH 8
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Defines the interface of a profiler sampling source. */
+typedef struct
+{
+    /** @brief Sampling source name. */
+    const char* name;
+
+    /**
+     * @brief The function should start sampling on the calling CPU.
+     *
+     * @details The function should start raising samples on the calling CPU
+     * with the given period, the source calls profiler_sample on each
+     * sample. The function is called with interrupts disabled.
+     *
+     * @param[in] period_ns The sampling period in nanoseconds.
+     *
+     * @return The success state or the error code.
+     */
+    OS_RETURN_E (*start_local)(const uint64_t period_ns);
+
+    /**
+     * @brief The function should stop sampling on the calling CPU.
+     *
+     * @details The function should stop raising samples on the calling CPU.
+     * The function is called with interrupts disabled.
+     */
+    void (*stop_local)(void);
+} profiler_source_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the sampling profiler.
+ *
+ * @details Initializes the sampling profiler with the given sampling source.
+ * Without source, the samples are raised by the profiler deadline of the main
+ * timer. This function must be called once the interrupt manager and the
+ * main timer are initialized.
+ *
+ * @param[in] source The sampling source, NULL to use the main timer.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if one of the source functions is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if there is no source and no main timer.
+ * - Any error returned by the interrupt manager when attaching the profiler
+ * control handler.
+ */
+OS_RETURN_E profiler_init(const profiler_source_t* source);
+
+/**
+ * @brief Starts the sampling profiler on all the CPUs.
+ *
+ * @details Starts the sampling profiler on all the started CPUs. The other
+ * CPUs are notified with an inter processor interrupt and start sampling once
+ * they handle it. The recorded samples are kept, see profiler_reset.
+ *
+ * @param[in] period_ns The sampling period in nanoseconds.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the profiler is not initialized.
+ * - OS_ERR_OUT_OF_BOUND is returned if the period is 0.
+ * - OS_ERR_RESOURCE_BUSY is returned if the profiler is already running.
+ */
+OS_RETURN_E profiler_start(const uint64_t period_ns);
+
+/**
+ * @brief Stops the sampling profiler on all the CPUs.
+ *
+ * @details Stops the sampling profiler on all the CPUs. The other CPUs stop
+ * sampling once they handle the profiler inter processor interrupt.
+ */
+void profiler_stop(void);
+
+/**
+ * @brief Clears the recorded samples.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_RESOURCE_BUSY is returned if the profiler is running.
+ */
+OS_RETURN_E profiler_reset(void);
+
+/**
+ * @brief Records a sample of the interrupted thread.
+ *
+ * @details Records a sample of the interrupted thread on the calling CPU.
+ * This function is called by the sampling sources in their interrupt
+ * handler, samples raised while the profiler is stopped are ignored.
+ *
+ * @param[in] thread The interrupted thread.
+ */
+void profiler_sample(const kernel_thread_t* thread);
+
+/**
+ * @brief Prints the recorded samples.
+ *
+ * @details Prints the recorded samples on the kernel output as folded stacks,
+ * one "#PROF <tid>;<frame>;...;<frame> <count>" line per distinct sample,
+ * outermost frame first. The frames are the functions names resolved with
+ * the kernel symbol table, the unresolved addresses are printed as
+ * "0x<address>" and can be symbolized by the host tools. The profiler should
+ * be stopped.
+ */
+void profiler_dump(void);
+
+#endif /* #ifndef __CORE_PROFILER_H_ */
+
+/************************************ EOF *************************************/
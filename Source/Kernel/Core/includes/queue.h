@@ -0,0 +1,335 @@
+/*******************************************************************************
+ * @file queue.h
+ *
+ * @see queue.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's bounded lock-free queues and message queues.
+ *
+ * @details Kernel's bounded lock-free queues and message queues. The queues
+ * are rings of pointers whose power of two storage is given by the caller.
+ * The single producer single consumer queue only uses loads and stores, the
+ * multiple producers multiple consumers queue takes a slot with one compare
+ * and swap and publishes it with a per slot sequence number. The producers
+ * and the consumers indexes are on their own cache line. The message queues
+ * wrap a multiple producers multiple consumers queue: a thread finding the
+ * queue full or empty spins for a short time and then waits in the
+ * THREAD_STATE_WAITING state until the other side makes room or posts a
+ * message.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_QUEUE_H_
+#define __CORE_QUEUE_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>     /* Generic int types */
+#include <stddef.h>     /* Standard definitions */
+#include <cpu.h>        /* Cache line size */
+#include <kerror.h>     /* Kernel error codes */
+#include <critical.h>   /* Kernel spinlocks */
+#include <wait_queue.h> /* Threads wait queue */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Largest capacity of a queue. */
+#define QUEUE_MAX_CAPACITY 0x80000000U
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Bounded single producer single consumer queue. The indexes run
+ * freely and are masked on access.
+ */
+typedef struct
+{
+    /** @brief Index of the next slot written, only written by the
+     * producer.
+     */
+    uint32_t tail __attribute__((aligned(CPU_CACHE_LINE_SIZE)));
+
+    /** @brief Producer's copy of head, refreshed when the queue looks
+     * full.
+     */
+    uint32_t cached_head;
+
+    /** @brief Index of the next slot read, only written by the consumer. */
+    uint32_t head __attribute__((aligned(CPU_CACHE_LINE_SIZE)));
+
+    /** @brief Consumer's copy of tail, refreshed when the queue looks
+     * empty.
+     */
+    uint32_t cached_tail;
+
+    /** @brief Queue's storage. */
+    void** slots __attribute__((aligned(CPU_CACHE_LINE_SIZE)));
+
+    /** @brief Capacity minus one. */
+    uint32_t mask;
+} __attribute__((aligned(CPU_CACHE_LINE_SIZE))) spsc_queue_t;
+
+/** @brief Slot of a multiple producers multiple consumers queue. */
+typedef struct
+{
+    /** @brief Slot's sequence, the index of the next push in the slot when
+     * the slot is free, the index of the push plus one when it is full.
+     */
+    uint32_t sequence;
+
+    /** @brief Slot's element. */
+    void* data;
+} mpmc_cell_t;
+
+/** @brief Bounded multiple producers multiple consumers queue. The indexes
+ * run freely and are masked on access.
+ */
+typedef struct
+{
+    /** @brief Index of the next slot taken by a producer. */
+    uint32_t tail __attribute__((aligned(CPU_CACHE_LINE_SIZE)));
+
+    /** @brief Index of the next slot taken by a consumer. */
+    uint32_t head __attribute__((aligned(CPU_CACHE_LINE_SIZE)));
+
+    /** @brief Queue's storage. */
+    mpmc_cell_t* cells __attribute__((aligned(CPU_CACHE_LINE_SIZE)));
+
+    /** @brief Capacity minus one. */
+    uint32_t mask;
+} __attribute__((aligned(CPU_CACHE_LINE_SIZE))) mpmc_queue_t;
+
+/** @brief Blocking message queue. */
+typedef struct
+{
+    /** @brief Queued messages. */
+    mpmc_queue_t queue;
+
+    /** @brief Lock protecting the wait queues. */
+    kernel_spinlock_t lock __attribute__((aligned(CPU_CACHE_LINE_SIZE)));
+
+    /** @brief Threads waiting for a message. */
+    wait_queue_t receivers;
+
+    /** @brief Threads waiting for a free slot. */
+    wait_queue_t senders;
+} mqueue_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes a single producer single consumer queue.
+ *
+ * @param[out] queue The queue to initialize.
+ * @param[in] slots The queue storage, must stay valid while the queue is used.
+ * @param[in] capacity The number of slots, a power of two.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the queue or the storage is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the capacity is not a power of two or
+ * is greater than QUEUE_MAX_CAPACITY.
+ */
+OS_RETURN_E spsc_queue_init(spsc_queue_t* queue,
+                            void** slots,
+                            const uint32_t capacity);
+
+/**
+ * @brief Pushes an element in a single producer single consumer queue.
+ *
+ * @details Pushes an element in a single producer single consumer queue. Only
+ * one context may push in the queue at a time. This function can be called by
+ * interrupt handlers.
+ *
+ * @param[in, out] queue The queue.
+ * @param[in] element The element to push.
+ *
+ * @return TRUE if the element was pushed, FALSE if the queue is full.
+ */
+bool_t spsc_queue_push(spsc_queue_t* queue, void* element);
+
+/**
+ * @brief Pops an element from a single producer single consumer queue.
+ *
+ * @details Pops an element from a single producer single consumer queue. Only
+ * one context may pop from the queue at a time. This function can be called
+ * by interrupt handlers.
+ *
+ * @param[in, out] queue The queue.
+ * @param[out] element The buffer receiving the element.
+ *
+ * @return TRUE if an element was popped, FALSE if the queue is empty.
+ */
+bool_t spsc_queue_pop(spsc_queue_t* queue, void** element);
+
+/**
+ * @brief Initializes a multiple producers multiple consumers queue.
+ *
+ * @param[out] queue The queue to initialize.
+ * @param[out] cells The queue storage, must stay valid while the queue is
+ * used.
+ * @param[in] capacity The number of cells, a power of two.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the queue or the storage is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the capacity is not a power of two or
+ * is greater than QUEUE_MAX_CAPACITY.
+ */
+OS_RETURN_E mpmc_queue_init(mpmc_queue_t* queue,
+                            mpmc_cell_t* cells,
+                            const uint32_t capacity);
+
+/**
+ * @brief Pushes an element in a multiple producers multiple consumers queue.
+ *
+ * @details Pushes an element in a multiple producers multiple consumers
+ * queue. This function can be called by interrupt handlers. The consumers
+ * see the queue empty until the oldest taken cell is published, a producer
+ * interrupted between taking and publishing its cell delays the elements
+ * pushed after it.
+ *
+ * @param[in, out] queue The queue.
+ * @param[in] element The element to push.
+ *
+ * @return TRUE if the element was pushed, FALSE if the queue is full.
+ */
+bool_t mpmc_queue_push(mpmc_queue_t* queue, void* element);
+
+/**
+ * @brief Pops an element from a multiple producers multiple consumers queue.
+ *
+ * @details Pops an element from a multiple producers multiple consumers
+ * queue. This function can be called by interrupt handlers.
+ *
+ * @param[in, out] queue The queue.
+ * @param[out] element The buffer receiving the element.
+ *
+ * @return TRUE if an element was popped, FALSE if the queue is empty.
+ */
+bool_t mpmc_queue_pop(mpmc_queue_t* queue, void** element);
+
+/**
+ * @brief Initializes a message queue.
+ *
+ * @param[out] mqueue The message queue to initialize.
+ * @param[out] cells The queue storage, must stay valid while the queue is
+ * used.
+ * @param[in] capacity The number of cells, a power of two.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the queue or the storage is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the capacity is not a power of two or
+ * is greater than QUEUE_MAX_CAPACITY.
+ */
+OS_RETURN_E mqueue_init(mqueue_t* mqueue,
+                        mpmc_cell_t* cells,
+                        const uint32_t capacity);
+
+/**
+ * @brief Sends a message.
+ *
+ * @details Sends a message, the calling thread waits while the queue is full.
+ * A thread waiting for a message is woken up. This function must be called by
+ * a thread, with interrupts enabled and outside of a RCU read-side section.
+ *
+ * @param[in, out] mqueue The message queue.
+ * @param[in] message The message to send.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the queue is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the calling thread is an idle
+ * thread that would have to wait.
+ */
+OS_RETURN_E mqueue_send(mqueue_t* mqueue, void* message);
+
+/**
+ * @brief Tries to send a message.
+ *
+ * @details Sends a message only if the queue is not full, the calling context
+ * never waits. A thread waiting for a message is woken up. This function can
+ * be called by interrupt handlers.
+ *
+ * @param[in, out] mqueue The message queue.
+ * @param[in] message The message to send.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the queue is NULL.
+ * - OS_ERR_RESOURCE_BUSY is returned if the queue is full.
+ */
+OS_RETURN_E mqueue_trysend(mqueue_t* mqueue, void* message);
+
+/**
+ * @brief Receives a message.
+ *
+ * @details Receives a message, the calling thread waits while the queue is
+ * empty. A thread waiting for a free slot is woken up. This function must be
+ * called by a thread, with interrupts enabled and outside of a RCU read-side
+ * section.
+ *
+ * @param[in, out] mqueue The message queue.
+ * @param[out] message The buffer receiving the message.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the queue or the buffer is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the calling thread is an idle
+ * thread that would have to wait.
+ */
+OS_RETURN_E mqueue_receive(mqueue_t* mqueue, void** message);
+
+/**
+ * @brief Tries to receive a message.
+ *
+ * @details Receives a message only if the queue is not empty, the calling
+ * context never waits. A thread waiting for a free slot is woken up. This
+ * function can be called by interrupt handlers.
+ *
+ * @param[in, out] mqueue The message queue.
+ * @param[out] message The buffer receiving the message.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the queue or the buffer is NULL.
+ * - OS_ERR_RESOURCE_BUSY is returned if the queue is empty.
+ */
+OS_RETURN_E mqueue_tryreceive(mqueue_t* mqueue, void** message);
+
+#endif /* #ifndef __CORE_QUEUE_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,187 @@
+/*******************************************************************************
+ * @file rcu.h
+ *
+ * @see rcu.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's read-copy-update deferred reclamation.
+ *
+ * @details Kernel's read-copy-update deferred reclamation. The readers of a
+ * RCU protected data never lock nor write shared memory, they only disable
+ * interrupts for the duration of the read. A writer unlinks the old version of
+ * an object and releases it once a grace period elapsed: every CPU went
+ * through a quiescent state, a context switch or an iteration of the idle
+ * loop, and cannot hold a reference to the object anymore.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_RCU_H_
+#define __CORE_RCU_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief RCU callback node, embedded in the objects released after a grace
+ * period.
+ */
+typedef struct rcu_head
+{
+    /** @brief Next callback of the CPU callbacks list. */
+    struct rcu_head* next;
+
+    /** @brief Function called once the grace period elapsed. */
+    void (*callback)(struct rcu_head* head);
+} rcu_head_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Enters a RCU read-side section.
+ *
+ * @details Enters a RCU read-side section, the CPU cannot go through a
+ * quiescent state until the section ends. The read-side sections are critical
+ * sections, critical.h must be included.
+ *
+ * @param[out] INT_STATE The interrupt state at the section's entrance.
+ */
+#define RCU_READ_LOCK(INT_STATE) ENTER_CRITICAL(INT_STATE)
+
+/**
+ * @brief Exits a RCU read-side section.
+ *
+ * @param[in] INT_STATE The interrupt state at the section's entrance.
+ */
+#define RCU_READ_UNLOCK(INT_STATE) EXIT_CRITICAL(INT_STATE)
+
+/**
+ * @brief Reads a RCU protected pointer.
+ *
+ * @param[in] POINTER The RCU protected pointer.
+ */
+#define RCU_DEREFERENCE(POINTER) __atomic_load_n(&(POINTER), __ATOMIC_CONSUME)
+
+/**
+ * @brief Publishes a RCU protected pointer.
+ *
+ * @details Publishes a RCU protected pointer, the initialization of the
+ * pointed object is visible to the readers before the pointer.
+ *
+ * @param[out] POINTER The RCU protected pointer.
+ * @param[in] VALUE The new value of the pointer.
+ */
+#define RCU_ASSIGN_POINTER(POINTER, VALUE)                  \
+    __atomic_store_n(&(POINTER), (VALUE), __ATOMIC_RELEASE)
+
+/**
+ * @brief Returns the object embedding a RCU callback node.
+ *
+ * @param[in] HEAD The RCU callback node.
+ * @param[in] TYPE The type of the object.
+ * @param[in] MEMBER The name of the node in the object.
+ */
+#define RCU_CONTAINER_OF(HEAD, TYPE, MEMBER)                \
+    ((TYPE*)((uintptr_t)(HEAD) - offsetof(TYPE, MEMBER)))
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Adds the calling CPU to the grace periods.
+ *
+ * @details Adds the calling CPU to the CPUs that must go through a quiescent
+ * state for a grace period to elapse. This function must be called by each CPU
+ * before it uses RCU, with interrupts disabled.
+ *
+ * @param[in] cpu_id The identifier of the calling CPU.
+ */
+void rcu_init_cpu(const uint32_t cpu_id);
+
+/**
+ * @brief Reports a quiescent state of the calling CPU.
+ *
+ * @details Reports that the calling CPU holds no RCU reference, starts the
+ * grace periods its callbacks wait for and calls the callbacks whose grace
+ * period elapsed. This function is called by the scheduler on each context
+ * switch and idle loop iteration, with interrupts disabled.
+ */
+void rcu_quiescent_state(void);
+
+/**
+ * @brief Tells if the calling CPU has RCU callbacks waiting.
+ *
+ * @details Tells if the calling CPU has callbacks waiting for a grace period
+ * or for their call. The callbacks are only called by their CPU, an idle CPU
+ * with callbacks waiting must keep going through quiescent states. This
+ * function must be called with interrupts disabled.
+ *
+ * @return TRUE if the CPU has callbacks waiting, FALSE otherwise.
+ */
+bool_t rcu_cpu_has_callbacks(void);
+
+/**
+ * @brief Calls a function after a grace period.
+ *
+ * @details Queues a callback on the calling CPU. The callback is called once
+ * all the RCU read-side sections running at the time of the call ended. The
+ * callbacks are called by the scheduler with interrupts disabled, they must
+ * not block. This function can be called from interrupt handlers.
+ *
+ * @param[out] head The callback node, embedded in the object to release.
+ * @param[in] callback The function to call.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if head or callback is NULL.
+ */
+OS_RETURN_E rcu_call(rcu_head_t* head, void (*callback)(rcu_head_t* head));
+
+/**
+ * @brief Waits for a grace period.
+ *
+ * @details Waits until all the RCU read-side sections running at the time of
+ * the call ended. The calling thread waits without using the CPU. This
+ * function must not be called in a RCU read-side section nor from an
+ * interrupt handler.
+ */
+void rcu_synchronize(void);
+
+#endif /* #ifndef __CORE_RCU_H_ */
+
+/************************************ EOF *************************************/
@@ -24,13 +24,34 @@
  * INCLUDES
  ******************************************************************************/
 
-/* NONE */
+#include <stdint.h>     /* Generic int types */
+#include <kerror.h>     /* Kernel error codes */
+#include <ctrl_block.h> /* Kernel control blocks */
+#include <critical.h>   /* Kernel spinlocks */
 
 /*******************************************************************************
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Kernel's highest thread priority. */
+#define KERNEL_HIGHEST_PRIORITY 0
+/** @brief Kernel's lowest thread priority. */
+#define KERNEL_LOWEST_PRIORITY  63
+
+/** @brief Number of priority levels managed by the scheduler. */
+#define SCHED_PRIORITY_LEVELS (KERNEL_LOWEST_PRIORITY + 1)
+
+/** @brief Idle thread's priority. */
+#define IDLE_THREAD_PRIORITY KERNEL_LOWEST_PRIORITY
+
+/** @brief Affinity of the threads that can run on all the CPUs. */
+#define SCHED_CPU_AFFINITY_ALL 0xFFFFFFFFU
+
+/** @brief Shortest runtime of a deadline thread, in nanoseconds. */
+#define SCHED_DEADLINE_MIN_RUNTIME_NS 10000ULL
+
+/** @brief Longest period of a deadline thread, in nanoseconds. */
+#define SCHED_DEADLINE_MAX_PERIOD_NS 1000000000ULL
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
@@ -61,6 +82,288 @@
  * FUNCTIONS
  ******************************************************************************/
 
+/**
+ * @brief Initializes the scheduler data of the calling CPU.
+ *
+ * @details Initializes the scheduler data of the calling CPU and sets it as
+ * the CPU local storage. The execution context that calls this function
+ * becomes the CPU boot thread: the init thread on the BSP, the idle thread on
+ * the other CPUs. This function must be called on each CPU with interrupts
+ * disabled, right after the CPU was initialized and before any interrupt is
+ * raised.
+ *
+ * @param[in] cpu_id The identifier of the calling CPU.
+ */
+void scheduler_init_cpu_local(const uint32_t cpu_id);
+
+/**
+ * @brief Initializes the scheduler.
+ *
+ * @details Initializes the scheduler. The init thread runs at the highest
+ * priority. The BSP idle thread is created and the scheduling handler is
+ * attached to the scheduler software interrupt line. This function must be
+ * called on the BSP after scheduler_init_cpu_local and after the interrupt
+ * manager was initialized.
+ */
+void scheduler_init(void);
+
+/**
+ * @brief Runs the idle loop of the calling CPU.
+ *
+ * @details Runs the idle loop of the calling CPU. This function is called by
+ * the APs boot threads, that become the APs idle threads once their scheduler
+ * data is initialized. This function never returns.
+ */
+void scheduler_idle(void);
+
+/**
+ * @brief Removes the calling CPU from the threads scheduling.
+ *
+ * @details Removes the calling CPU from the threads scheduling, its boot
+ * context keeps running without timer deadline. The threads made ready on
+ * the CPU are put on the other CPUs and the ready threads it holds are moved
+ * to them, the CPU is isolated for good. This function is called by the APs
+ * boot threads reserved to a poll loop, before they would enter the idle
+ * loop.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the calling thread is not an AP
+ * idle thread.
+ */
+OS_RETURN_E scheduler_isolate_cpu(void);
+
+/**
+ * @brief Calls the scheduler to elect the next thread to run.
+ *
+ * @details Calls the scheduler by raising the scheduler software interrupt.
+ * The current thread is put back at the end of its priority ready queue and
+ * the thread with the highest priority of the CPU is elected. When the CPU has
+ * no ready thread, a thread is stolen from the most loaded CPU. If the current
+ * thread is the only thread ready at the highest priority, it is elected
+ * again.
+ */
+void scheduler_schedule(void);
+
+/**
+ * @brief Creates a new kernel thread.
+ *
+ * @details Creates a new kernel thread and puts it in the ready queue of its
+ * priority on the calling CPU. The thread will be elected on the next
+ * scheduling decision that finds its priority to be the highest ready one.
+ * The thread can run on all the CPUs, it is put on another CPU when the
+ * calling CPU is isolated.
+ *
+ * @param[out] thread The pointer to the thread control block of the created
+ * thread. Can be NULL if the caller does not need it.
+ * @param[in] priority The thread's priority, between KERNEL_HIGHEST_PRIORITY
+ * and KERNEL_LOWEST_PRIORITY.
+ * @param[in] name The thread's name.
+ * @param[in] function The thread's routine.
+ * @param[in] args The arguments passed to the thread's routine.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the function or name are NULL.
+ * - OS_ERR_FORBIDEN_PRIORITY is returned if the priority is not valid.
+ * - OS_ERR_NO_MORE_MEMORY is returned if no more thread can be created.
+ */
+OS_RETURN_E scheduler_create_kernel_thread(kernel_thread_t** thread,
+                                           const uint8_t priority,
+                                           const char* name,
+                                           void* (*function)(void*),
+                                           void* args);
+
+/**
+ * @brief Puts the calling thread to sleep.
+ *
+ * @details Puts the calling thread to sleep for at least the given time. The
+ * thread is kept in the timer heap of its CPU until the CPU timer deadline
+ * programmed for its wakeup time is reached. A time of 0 yields the
+ * CPU.
+ *
+ * @param[in] time_ns The time to sleep in nanoseconds.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if no main timer is available.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if called by an idle thread.
+ */
+OS_RETURN_E scheduler_sleep(const uint64_t time_ns);
+
+/**
+ * @brief Puts the calling thread in the waiting state.
+ *
+ * @details Puts the calling thread in the waiting state until another context
+ * calls scheduler_wakeup_thread on it. The lock given as parameter is released
+ * once the thread is marked as waiting: a wakeup issued by a context holding
+ * the lock cannot be lost. This function must be called with interrupts
+ * disabled.
+ *
+ * @param[in] block_type The reason of the wait.
+ * @param[in,out] lock The lock to release, can be NULL.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned once the thread was woken up.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if called by an idle thread, the
+ * lock is not released.
+ */
+OS_RETURN_E scheduler_wait_thread(const THREAD_WAIT_TYPE_E block_type,
+                                  kernel_spinlock_t* lock);
+
+/**
+ * @brief Wakes up a waiting thread.
+ *
+ * @details Wakes up a thread put in the waiting state by scheduler_wait_thread
+ * and makes it ready on the calling CPU. If the thread has a higher priority
+ * than the current thread, or is a deadline thread with an earlier deadline,
+ * the CPU timer is programmed to preempt the current thread. This function
+ * can be called by interrupt handlers.
+ *
+ * @param[in] thread The thread to wake up.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the thread is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the thread is not waiting.
+ */
+OS_RETURN_E scheduler_wakeup_thread(kernel_thread_t* thread);
+
+/**
+ * @brief Sets the priority of a thread.
+ *
+ * @details Sets the scheduling priority of a thread. A ready thread is moved
+ * to the ready queue of its new priority. The base priority of the thread,
+ * restored by the priority inheritance, is not modified. This function can be
+ * called with interrupts disabled.
+ *
+ * @param[in, out] thread The thread to set the priority of.
+ * @param[in] priority The new priority, between KERNEL_HIGHEST_PRIORITY and
+ * KERNEL_LOWEST_PRIORITY.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the thread is NULL.
+ * - OS_ERR_FORBIDEN_PRIORITY is returned if the priority is not valid.
+ */
+OS_RETURN_E scheduler_set_priority(kernel_thread_t* thread,
+                                   const uint8_t priority);
+
+/**
+ * @brief Sets the CPUs a thread can run on.
+ *
+ * @details Sets the affinity mask of a thread. A ready thread is moved to one
+ * of its CPUs, a running thread is moved on its next switch. The isolated
+ * CPUs only run the threads whose affinity holds no other started CPU, a
+ * thread whose CPUs are not started runs on the CPUs that are not isolated.
+ * A deadline thread stays on the CPU its bandwidth is reserved on, the
+ * affinity is used when it goes back to the fixed priorities. This function
+ * can be called with interrupts disabled.
+ *
+ * @param[in, out] thread The thread to set the affinity of.
+ * @param[in] cpu_mask The CPUs the thread can run on, one bit per CPU.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the thread is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the mask holds no valid CPU.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the thread is an idle thread.
+ */
+OS_RETURN_E scheduler_set_thread_affinity(kernel_thread_t* thread,
+                                          const uint32_t cpu_mask);
+
+/**
+ * @brief Moves the calling thread to the deadline scheduling class.
+ *
+ * @details Moves the calling thread to the deadline scheduling class. The
+ * deadline threads are elected before the fixed priority threads, earliest
+ * absolute deadline first. Each instance of the thread is released every
+ * period and gets its runtime to complete before its deadline. A thread that
+ * used its budget is throttled until its next release, a thread waking up
+ * whose remaining budget would exceed its bandwidth before its deadline
+ * starts a new instance. The admission control reserves the runtime over
+ * deadline bandwidth on one of the thread CPUs, the calling CPU first: the
+ * bandwidth reserved on a CPU cannot exceed SCHED_DEADLINE_MAX_BANDWIDTH
+ * percent. The first instance is released on the call.
+ *
+ * @param[in] runtime_ns The runtime of each instance, in nanoseconds.
+ * @param[in] deadline_ns The deadline of each instance relative to its
+ * release, in nanoseconds.
+ * @param[in] period_ns The period of the instances, in nanoseconds.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_OUT_OF_BOUND is returned if the runtime is shorter than
+ * SCHED_DEADLINE_MIN_RUNTIME_NS, the runtime, deadline and period are not
+ * ordered or the period is longer than SCHED_DEADLINE_MAX_PERIOD_NS.
+ * - OS_ERR_RESOURCE_BUSY is returned if no CPU of the thread has enough
+ * bandwidth left, the thread keeps its scheduling class.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if called by an idle thread.
+ */
+OS_RETURN_E scheduler_set_deadline(const uint64_t runtime_ns,
+                                   const uint64_t deadline_ns,
+                                   const uint64_t period_ns);
+
+/**
+ * @brief Moves the calling thread back to the fixed priorities.
+ *
+ * @details Moves the calling deadline thread back to the fixed priority
+ * scheduling class and releases its bandwidth. The thread keeps its priority
+ * and affinity. The bandwidth of a deadline thread is also released when it
+ * exits.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the calling thread is not a
+ * deadline thread.
+ */
+OS_RETURN_E scheduler_clear_deadline(void);
+
+/**
+ * @brief Completes the current instance of the calling deadline thread.
+ *
+ * @details Completes the current instance of the calling deadline thread: the
+ * remaining budget is dropped and the thread waits for its next release. An
+ * instance completed after its deadline is counted as missed.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned once the next instance was released.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the calling thread is not a
+ * deadline thread.
+ */
+OS_RETURN_E scheduler_wait_next_period(void);
+
+/**
+ * @brief Sets the isolation of a CPU.
+ *
+ * @details Isolates a CPU or returns it to the housekeeping CPUs. An isolated
+ * CPU only runs the threads pinned on it: the other threads, the logging and
+ * tracing drains included, are moved off the CPU. It neither steals nor gives
+ * threads to the load balancing, arms no profiling timer and hands its
+ * deferred works to its worker thread, that runs on the other CPUs. The CPUs
+ * removed from the scheduling are isolated for good.
+ *
+ * @param[in] cpu_id The identifier of the CPU.
+ * @param[in] isolated TRUE to isolate the CPU, FALSE otherwise.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the CPU identifier is not valid,
+ * is the BSP or if the CPU was removed from the scheduling.
+ */
+OS_RETURN_E scheduler_set_cpu_isolated(const uint32_t cpu_id,
+                                       const bool_t isolated);
+
+/**
+ * @brief Tells if a CPU is isolated.
+ *
+ * @param[in] cpu_id The identifier of the CPU.
+ *
+ * @return TRUE if the CPU is isolated or was removed from the scheduling,
+ * FALSE otherwise.
+ */
+bool_t scheduler_is_cpu_isolated(const uint32_t cpu_id);
+
 /**
  * @brief Returns the handle to the current running thread.
  *
@@ -71,6 +374,49 @@
  */
 kernel_thread_t* scheduler_get_current_thread(void);
 
+/**
+ * @brief Returns the identifier of the current CPU.
+ *
+ * @details Returns the identifier of the CPU executing the caller. This
+ * function must be called with interrupts disabled, otherwise the caller might
+ * migrate to another CPU before using the returned value.
+ *
+ * @return The identifier of the current CPU.
+ */
+uint32_t scheduler_get_current_cpu_id(void);
+
+/**
+ * @brief Gets the execution statistics of a thread.
+ *
+ * @details Copies the execution statistics of a thread. The time slice of the
+ * calling thread is accounted up to the call. The statistics are updated
+ * without synchronization by the CPU running the thread, values read for a
+ * thread running on another CPU might be slightly out of date.
+ *
+ * @param[in] thread The thread to get the statistics of.
+ * @param[out] stats The buffer receiving the statistics.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the thread or the buffer is NULL.
+ */
+OS_RETURN_E scheduler_get_thread_stats(const kernel_thread_t* thread,
+                                       thread_stats_t* stats);
+
+/**
+ * @brief Calls a function on each thread.
+ *
+ * @details Calls a function on each thread, the CPUs boot threads included.
+ * No lock is taken and the threads might change while they are walked, this
+ * function is meant to be used by the panic handler.
+ *
+ * @param[in] visitor The function called on each thread.
+ * @param[in] args The argument given to the visitor.
+ */
+void scheduler_walk_threads(void (*visitor)(const kernel_thread_t* thread,
+                                            void* args),
+                            void* args);
+
 #endif /* #ifndef __CORE_SCHEDULER_H_ */
 
 /************************************ EOF *************************************/
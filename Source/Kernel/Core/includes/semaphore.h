@@ -0,0 +1,150 @@
+/*******************************************************************************
+ * @file semaphore.h
+ *
+ * @see semaphore.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's counting semaphores.
+ *
+ * @details Kernel's counting semaphores. An available unit is taken with a
+ * single atomic operation. A thread finding no unit spins for a short time
+ * and then sleeps in the semaphore wait queue. The posted units are given
+ * directly to the highest priority waiter.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_SEMAPHORE_H_
+#define __CORE_SEMAPHORE_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>     /* Generic int types */
+#include <stddef.h>     /* Standard definitions */
+#include <kerror.h>     /* Kernel error codes */
+#include <critical.h>   /* Kernel spinlocks */
+#include <wait_queue.h> /* Threads wait queue */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Kernel counting semaphore. */
+typedef struct
+{
+    /** @brief Number of available units. */
+    volatile uint32_t count;
+
+    /** @brief Threads waiting for a unit. */
+    wait_queue_t waiters;
+
+    /** @brief Lock protecting the wait queue. */
+    kernel_spinlock_t lock;
+} semaphore_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Static initializer of a semaphore.
+ *
+ * @param[in] COUNT The initial number of available units.
+ */
+#define SEMAPHORE_INIT_VALUE(COUNT) \
+    {(COUNT), WAIT_QUEUE_INIT_VALUE, KERNEL_SPINLOCK_INIT_VALUE}
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes a semaphore.
+ *
+ * @param[out] semaphore The semaphore to initialize.
+ * @param[in] count The initial number of available units.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the semaphore is NULL.
+ */
+OS_RETURN_E semaphore_init(semaphore_t* semaphore, const uint32_t count);
+
+/**
+ * @brief Takes a unit of a semaphore.
+ *
+ * @details Takes a unit of a semaphore, the calling thread waits until a unit
+ * is available. This function must be called by a thread, with interrupts
+ * enabled and outside of a RCU read-side section.
+ *
+ * @param[in, out] semaphore The semaphore to take a unit of.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the semaphore is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the calling thread is an idle
+ * thread that would have to wait.
+ */
+OS_RETURN_E semaphore_wait(semaphore_t* semaphore);
+
+/**
+ * @brief Tries to take a unit of a semaphore.
+ *
+ * @details Takes a unit of a semaphore only if one is available, the calling
+ * context never waits. This function can be called by interrupt handlers.
+ *
+ * @param[in, out] semaphore The semaphore to take a unit of.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the semaphore is NULL.
+ * - OS_ERR_RESOURCE_BUSY is returned if no unit is available.
+ */
+OS_RETURN_E semaphore_trywait(semaphore_t* semaphore);
+
+/**
+ * @brief Gives a unit back to a semaphore.
+ *
+ * @details Gives a unit to the highest priority waiting thread and wakes it
+ * up, or makes the unit available when no thread waits. This function can be
+ * called by interrupt handlers.
+ *
+ * @param[in, out] semaphore The semaphore to give a unit to.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the semaphore is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the semaphore count would
+ * overflow.
+ */
+OS_RETURN_E semaphore_post(semaphore_t* semaphore);
+
+#endif /* #ifndef __CORE_SEMAPHORE_H_ */
+
+/************************************ EOF *************************************/
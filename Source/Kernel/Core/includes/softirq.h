@@ -0,0 +1,156 @@
+/*******************************************************************************
+ * @file softirq.h
+ *
+ * @see softirq.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's deferred interrupt work.
+ *
+ * @details Kernel's deferred interrupt work. An interrupt handler only
+ * acknowledges its device and raises a work, the work is queued on the CPU
+ * and runs after the handler returns. A few works run when the interrupt
+ * manager exits the handler, the others run in the CPU worker thread with
+ * interrupts enabled. The time spent with interrupts disabled is then bounded
+ * whatever the amount of work the devices generate.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_SOFTIRQ_H_
+#define __CORE_SOFTIRQ_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Deferred work, embedded in the objects of the interrupt handlers. */
+typedef struct softirq_work
+{
+    /** @brief Next work of the CPU queue. */
+    struct softirq_work* next;
+
+    /** @brief Function called to do the work. */
+    void (*routine)(struct softirq_work* work);
+
+    /** @brief Set while the work is queued. */
+    volatile uint32_t pending;
+} softirq_work_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Deferred work initializer.
+ *
+ * @param[in] ROUTINE The function called to do the work.
+ */
+#define SOFTIRQ_WORK_INIT_VALUE(ROUTINE) {NULL, (ROUTINE), 0}
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Creates the worker thread of the calling CPU.
+ *
+ * @details Creates the thread running the deferred works of the calling CPU
+ * that did not run on interrupt exit. This function must be called by each
+ * CPU after its scheduler data was initialized and the scheduler was
+ * initialized.
+ *
+ * @param[in] cpu_id The identifier of the calling CPU.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the CPU identifier is not valid
+ * or the CPU already has a worker thread.
+ * - Any error returned by the scheduler when creating the worker thread.
+ */
+OS_RETURN_E softirq_init_cpu(const uint32_t cpu_id);
+
+/**
+ * @brief Initializes a deferred work.
+ *
+ * @param[out] work The work to initialize.
+ * @param[in] routine The function called to do the work.
+ */
+void softirq_work_init(softirq_work_t* work,
+                       void (*routine)(softirq_work_t* work));
+
+/**
+ * @brief Queues a deferred work on the calling CPU.
+ *
+ * @details Queues a work on the calling CPU. A work raised again before it
+ * runs only runs once. Raised by an interrupt handler, the work runs when the
+ * interrupt manager exits the handler or in the CPU worker thread. Raised
+ * outside of an interrupt handler, the worker thread is woken up. The
+ * routine must neither wait nor switch threads, a work raised again while its
+ * routine runs can run concurrently on another CPU.
+ *
+ * @param[in, out] work The work to queue.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the work or its routine is NULL.
+ */
+OS_RETURN_E softirq_raise(softirq_work_t* work);
+
+/**
+ * @brief Notifies the entry in an interrupt handler.
+ *
+ * @details Notifies that the calling CPU enters an interrupt handler, the
+ * works raised until the exit are left for the exit. This function is called
+ * by the interrupt manager with interrupts disabled.
+ *
+ * @param[in] cpu_id The identifier of the calling CPU.
+ */
+void softirq_irq_enter(const uint32_t cpu_id);
+
+/**
+ * @brief Notifies the exit of an interrupt handler.
+ *
+ * @details Runs up to KERNEL_SOFTIRQ_EXIT_BUDGET queued works of the calling
+ * CPU and wakes up the CPU worker thread if works remain. An isolated CPU
+ * runs no work, its worker thread runs them on the other CPUs. This function
+ * is called by the interrupt manager with interrupts disabled.
+ *
+ * @param[in] cpu_id The identifier of the calling CPU.
+ */
+void softirq_irq_exit(const uint32_t cpu_id);
+
+#endif /* #ifndef __CORE_SOFTIRQ_H_ */
+
+/************************************ EOF *************************************/
\ No newline at end of file
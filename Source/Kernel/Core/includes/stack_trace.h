@@ -0,0 +1,138 @@
+/*******************************************************************************
+ * @file stack_trace.h
+ *
+ * @see stack_trace.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's stack walker and symbol table.
+ *
+ * @details Kernel's stack walker and symbol table. The kernel is built with
+ * frame pointers, the walker follows the frame pointers chain and collects
+ * the return addresses. The walk stops at the boundaries of the kernel stack
+ * the first frame lies in. The build emits a table of the kernel functions
+ * sorted by address in the KERNEL_SYM_TAB region, the addresses are resolved
+ * by a binary search in the table.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_STACK_TRACE_H_
+#define __CORE_STACK_TRACE_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Symbol table magic, "KSYM". */
+#define STACK_TRACE_SYMTAB_MAGIC 0x4D59534B
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Symbol table header, generated by Tools/SymTab. The header is
+ * followed by the count sorted symbols offsets from text_base, the count
+ * names offsets and the names_size bytes of NULL terminated names.
+ */
+typedef struct
+{
+    /** @brief STACK_TRACE_SYMTAB_MAGIC. */
+    uint32_t magic;
+
+    /** @brief Number of symbols. */
+    uint32_t count;
+
+    /** @brief Size of the names table in bytes. */
+    uint32_t names_size;
+
+    /** @brief Reserved, 0. */
+    uint32_t reserved;
+
+    /** @brief Address of the kernel text the symbols offsets start from. */
+    uint64_t text_base;
+} stack_trace_symtab_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Walks a frame pointers chain.
+ *
+ * @details Walks the frame pointers chain starting at a frame and stores the
+ * return addresses found, innermost first. The walk stops on the first frame
+ * out of the kernel stack of the starting frame, on a frame that does not go
+ * up the stack or on a return address out of the kernel text. The function
+ * takes no lock and can be called in any context.
+ *
+ * @param[in] frame The frame pointer of the first frame.
+ * @param[out] addresses The buffer receiving the return addresses.
+ * @param[in] max_depth The size of the buffer.
+ *
+ * @return The number of return addresses stored.
+ */
+uint32_t stack_trace_walk(const uintptr_t frame,
+                          uintptr_t* addresses,
+                          const uint32_t max_depth);
+
+/**
+ * @brief Walks the stack of the caller.
+ *
+ * @details Walks the stack of the caller, the first address is the address
+ * the caller resumes at.
+ *
+ * @param[out] addresses The buffer receiving the return addresses.
+ * @param[in] max_depth The size of the buffer.
+ *
+ * @return The number of return addresses stored.
+ */
+uint32_t stack_trace_walk_current(uintptr_t* addresses,
+                                  const uint32_t max_depth);
+
+/**
+ * @brief Resolves an address in the kernel symbol table.
+ *
+ * @details Finds the kernel function the address lies in.
+ *
+ * @param[in] address The address to resolve.
+ * @param[out] offset The buffer receiving the offset of the address in the
+ * function, can be NULL.
+ *
+ * @return The function name, NULL if the address is not in a known function
+ * or the kernel was built without symbol table.
+ */
+const char* stack_trace_lookup(const uintptr_t address, uintptr_t* offset);
+
+#endif /* #ifndef __CORE_STACK_TRACE_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,158 @@
+/*******************************************************************************
+ * @file syscall.h
+ *
+ * @see syscall.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's system calls dispatcher.
+ *
+ * @details Kernel's system calls dispatcher. The user threads enter the kernel
+ * through the CPU fast system call instruction, the architecture entry stub
+ * switches to the thread's kernel stack and calls the dispatcher with the
+ * system call identifier and its arguments. The dispatcher calls the handler
+ * registered in the system calls table for the identifier.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_SYSCALL_H_
+#define __CORE_SYSCALL_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of entries of the system calls table. */
+#define SYSCALL_TABLE_SIZE 64
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Kernel's system calls identifiers. */
+typedef enum
+{
+    /** @brief Gives the CPU to the next ready thread. */
+    SYSCALL_YIELD   = 0,
+    /** @brief Sleeps, arg0 and arg1 are the low and high parts of the time
+     * in nanoseconds.
+     */
+    SYSCALL_SLEEP   = 1,
+    /** @brief Gets the calling thread identifier, arg0 is the user address
+     * of the int32_t receiving it.
+     */
+    SYSCALL_GET_TID = 2,
+} SYSCALL_ID_E;
+
+/**
+ * @brief System call handler. The arguments are the raw values given by the
+ * user thread, the pointers must be checked before being used.
+ */
+typedef OS_RETURN_E (*syscall_handler_t)(const uintptr_t arg0,
+                                         const uintptr_t arg1,
+                                         const uintptr_t arg2,
+                                         const uintptr_t arg3,
+                                         const uintptr_t arg4);
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the system calls table.
+ *
+ * @details Initializes the system calls table and registers the kernel's
+ * system calls. The CPU fast system call entry is programmed by the CPU
+ * initialization.
+ */
+void syscall_init(void);
+
+/**
+ * @brief Registers a system call handler.
+ *
+ * @param[in] syscall_id The identifier of the system call.
+ * @param[in] handler The system call handler.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if handler is NULL.
+ * - OS_ERR_NO_SUCH_SYSCALL is returned if the identifier is out of the
+ *   system calls table.
+ * - OS_ERR_SYSCALL_ALREADY_REGISTERED is returned if the system call already
+ *   has a handler.
+ */
+OS_RETURN_E syscall_register(const uint32_t syscall_id,
+                             syscall_handler_t handler);
+
+/**
+ * @brief Removes a system call handler.
+ *
+ * @param[in] syscall_id The identifier of the system call.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NO_SUCH_SYSCALL is returned if the identifier is out of the
+ *   system calls table or has no handler.
+ */
+OS_RETURN_E syscall_remove(const uint32_t syscall_id);
+
+/**
+ * @brief Dispatches a system call.
+ *
+ * @details Dispatches a system call to its handler. This function is called
+ * by the architecture entry stub on the calling thread's kernel stack, with
+ * interrupts enabled. The identifier is the last parameter so that the
+ * arguments stay in the registers they were given in. The i386 entry only
+ * gives four arguments, arg4 is then 0.
+ *
+ * @param[in] arg0 The first argument of the system call.
+ * @param[in] arg1 The second argument of the system call.
+ * @param[in] arg2 The third argument of the system call.
+ * @param[in] arg3 The fourth argument of the system call.
+ * @param[in] arg4 The fifth argument of the system call.
+ * @param[in] syscall_id The identifier of the system call.
+ *
+ * @return The value returned by the handler, OS_ERR_NO_SUCH_SYSCALL if the
+ * system call has no handler.
+ */
+OS_RETURN_E syscall_dispatch(const uintptr_t arg0,
+                             const uintptr_t arg1,
+                             const uintptr_t arg2,
+                             const uintptr_t arg3,
+                             const uintptr_t arg4,
+                             const uintptr_t syscall_id);
+
+#endif /* #ifndef __CORE_SYSCALL_H_ */
+
+/************************************ EOF *************************************/
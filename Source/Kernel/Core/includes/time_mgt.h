@@ -0,0 +1,261 @@
+/*******************************************************************************
+ * @file time_mgt.h
+ *
+ * @see time_mgt.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's time management.
+ *
+ * @details Kernel's time management. The time reference is given by a clock
+ * source, a free running counter converted to nanoseconds with a mult/shift
+ * pair. The conversion parameters are protected by a sequence lock, reading
+ * the time takes no lock. The main timer driver provides a per-CPU one-shot
+ * deadline, shared by the kernel deadlines. There is no periodic tick: the
+ * timer interrupt is only raised when a deadline set by the kernel is
+ * reached.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_TIME_MGT_H_
+#define __CORE_TIME_MGT_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>     /* Generic int types */
+#include <kerror.h>     /* Kernel error codes */
+#include <interrupts.h> /* Interrupt handlers */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of nanoseconds in one second. */
+#define TIME_NS_PER_SECOND 1000000000ULL
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/**
+ * @brief Kernel deadlines, each CPU has one deadline of each kind. The
+ * handlers of the deadlines reached at once are called in this order.
+ */
+typedef enum
+{
+    /** @brief Sampling profiler deadline. */
+    TIME_DEADLINE_PROFILER  = 0,
+    /** @brief Scheduler deadline. */
+    TIME_DEADLINE_SCHEDULER = 1,
+    /** @brief Number of deadlines. */
+    TIME_DEADLINE_COUNT
+} TIME_DEADLINE_E;
+
+/** @brief Defines the interface of a kernel clock source. */
+typedef struct
+{
+    /** @brief Clock source name. */
+    const char* name;
+
+    /**
+     * @brief The function should return the clock source counter.
+     *
+     * @details The function should return the value of a free running
+     * counter increasing at the clock source frequency. The counter must be
+     * monotonic, consistent between the CPUs and must not wrap.
+     *
+     * @return The clock source counter.
+     */
+    uint64_t (*read)(void);
+
+    /** @brief Counter frequency in Hz. */
+    uint64_t frequency;
+
+    /**
+     * @brief Maximal time in nanoseconds between two counter reads, 0 if
+     * the counter can be left unread indefinitely. The time manager bounds
+     * the timer deadlines so that the counter is read at least this often.
+     */
+    uint64_t max_idle_ns;
+} kernel_clocksource_t;
+
+/** @brief Defines the basic interface for the kernel's main timer driver. */
+typedef struct
+{
+    /**
+     * @brief The function should set the calling CPU timer deadline.
+     *
+     * @details The function should program the timer of the calling CPU to
+     * raise its interrupt once the deadline is reached. A deadline in the
+     * past raises the interrupt as soon as possible. A deadline of 0 disarms
+     * the timer.
+     *
+     * @param[in] deadline_ns The deadline in nanoseconds, in the time
+     * reference returned by time_get_ns.
+     */
+    void (*set_deadline)(const uint64_t deadline_ns);
+
+    /**
+     * @brief The function should acknowledge the timer interrupt.
+     *
+     * @details The function should acknowledge the timer interrupt on the
+     * calling CPU.
+     */
+    void (*ack_interrupt)(void);
+
+    /**
+     * @brief The function should return the timer interrupt line.
+     *
+     * @details The function should return the interrupt line raised by the
+     * timer when the deadline is reached.
+     *
+     * @return The timer interrupt line.
+     */
+    uint32_t (*get_interrupt_line)(void);
+} kernel_timer_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the time manager.
+ *
+ * @details Initializes the time manager with the main timer driver given as
+ * parameter and attaches the timer interrupt handler. This function must be
+ * called after the interrupt manager was initialized.
+ *
+ * @param[in] main_timer The main timer driver.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the driver or one of its functions is
+ * NULL.
+ * - Any error returned by the interrupt manager when attaching the timer
+ * handler.
+ */
+OS_RETURN_E time_init(const kernel_timer_t* main_timer);
+
+/**
+ * @brief Sets the kernel's clock source.
+ *
+ * @details Sets the clock source giving the kernel's time reference and
+ * computes its conversion factors. The time stays continuous when the clock
+ * source is replaced. This function must not be called concurrently with
+ * itself.
+ *
+ * @param[in] clocksource The clock source.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the clock source or its read function
+ * is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the frequency is 0 or above 1GHz
+ * times 2^32.
+ */
+OS_RETURN_E time_set_clocksource(const kernel_clocksource_t* clocksource);
+
+/**
+ * @brief Returns the name of the kernel's clock source.
+ *
+ * @return The clock source name, "none" if no clock source is set.
+ */
+const char* time_get_clocksource_name(void);
+
+/**
+ * @brief Returns the kernel's monotonic time.
+ *
+ * @details Returns the time elapsed since the first clock source was set in
+ * nanoseconds, 0 before. The time is monotonic and consistent between the
+ * CPUs. This function takes no lock, it can be called from any context except
+ * while setting the clock source on the same CPU.
+ *
+ * @return The kernel's monotonic time in nanoseconds.
+ */
+uint64_t time_get_ns(void);
+
+/**
+ * @brief Registers a deadline handler.
+ *
+ * @details Registers the handler called on the CPU that reached one of its
+ * deadlines of the given kind. The timer interrupt is acknowledged and the
+ * deadline is cleared before the handler is called.
+ *
+ * @param[in] deadline The kind of deadline.
+ * @param[in] handler The deadline handler.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the handler is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the kind of deadline is invalid.
+ * - OS_ERR_NOT_SUPPORTED is returned if no main timer is available.
+ */
+OS_RETURN_E time_register_deadline_handler(const TIME_DEADLINE_E deadline,
+                                           custom_handler_t handler);
+
+/**
+ * @brief Returns the system uptime.
+ *
+ * @details Returns the system uptime in nanoseconds, this is time_get_ns. The
+ * function can be used where a time getter pointer is expected.
+ *
+ * @return The system uptime in nanoseconds.
+ */
+uint64_t time_get_current_uptime_nano(void);
+
+/**
+ * @brief Sets one of the calling CPU deadlines.
+ *
+ * @details Sets one of the calling CPU deadlines. The deadline handler is
+ * called on this CPU once the deadline is reached. A deadline of 0 clears it.
+ * The timer is armed on the closest deadline of the CPU, brought forward when
+ * the clock source must be read before it. This function must be called with
+ * interrupts disabled.
+ *
+ * @param[in] deadline The kind of deadline.
+ * @param[in] deadline_ns The deadline in nanoseconds of uptime.
+ */
+void time_set_deadline(const TIME_DEADLINE_E deadline,
+                       const uint64_t deadline_ns);
+
+/**
+ * @brief Returns the calling CPU next timer interrupt.
+ *
+ * @details Returns the deadline the calling CPU timer is armed on, the
+ * closest of its deadlines or the clock source bound. This function must be
+ * called with interrupts disabled.
+ *
+ * @return The next timer interrupt in nanoseconds of uptime, 0 when the timer
+ * is disarmed.
+ */
+uint64_t time_get_next_deadline(void);
+
+#endif /* #ifndef __CORE_TIME_MGT_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,161 @@
+/*******************************************************************************
+ * @file timer_heap.h
+ *
+ * @see timer_heap.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Threads timer heap.
+ *
+ * @details Threads timer heap. The timer heap is a binary min-heap of threads
+ * keyed on their wakeup time. The earliest deadline is read in constant time,
+ * which is what a tickless timer needs to program its next interrupt, and the
+ * threads due by a given time are extracted in logarithmic time each. Each
+ * thread stores its position in the heap, which allows removing a thread
+ * before its deadline, for instance when a timed wait completes early.
+ * The timer heap is not thread safe, the caller is responsible for the
+ * locking.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_TIMER_HEAP_H_
+#define __CORE_TIMER_HEAP_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>     /* Generic int types */
+#include <stddef.h>     /* Standard definitions */
+#include <kerror.h>     /* Kernel error codes */
+#include <ctrl_block.h> /* Kernel control blocks */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Maximal number of threads in a timer heap: all the pool threads and
+ * the CPUs boot threads.
+ */
+#define TIMER_HEAP_CAPACITY (KERNEL_MAX_THREAD_COUNT + MAX_CPU_COUNT)
+
+/** @brief Timer heap index of a thread that is not in a timer heap. */
+#define TIMER_HEAP_NO_INDEX 0
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Threads timer heap. */
+typedef struct
+{
+    /** @brief Heap storage, the root is at index 1 to keep the parent and
+     * children computation simple. Index 0 is never used.
+     */
+    kernel_thread_t* threads[TIMER_HEAP_CAPACITY + 1];
+
+    /** @brief Number of threads in the heap. */
+    uint32_t size;
+} timer_heap_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes a timer heap.
+ *
+ * @details Initializes an empty timer heap.
+ *
+ * @param[out] heap The timer heap to initialize.
+ */
+void timer_heap_init(timer_heap_t* heap);
+
+/**
+ * @brief Inserts a thread in a timer heap.
+ *
+ * @details Inserts a thread in a timer heap, keyed on its wakeup time. The
+ * wakeup time must not be modified while the thread is in the heap. Threads
+ * with the same wakeup time are extracted in an unspecified order.
+ *
+ * @param[in, out] heap The timer heap to insert the thread in.
+ * @param[in, out] thread The thread to insert.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the heap or the thread is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the thread already is in a
+ * timer heap.
+ * - OS_ERR_NO_MORE_MEMORY is returned if the heap is full.
+ */
+OS_RETURN_E timer_heap_insert(timer_heap_t* heap, kernel_thread_t* thread);
+
+/**
+ * @brief Removes a thread from a timer heap.
+ *
+ * @details Removes a thread from a timer heap before its deadline.
+ *
+ * @param[in, out] heap The timer heap to remove the thread from.
+ * @param[in, out] thread The thread to remove.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the heap or the thread is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the thread is not in the heap.
+ */
+OS_RETURN_E timer_heap_remove(timer_heap_t* heap, kernel_thread_t* thread);
+
+/**
+ * @brief Returns the thread with the earliest wakeup time.
+ *
+ * @details Returns the thread with the earliest wakeup time without removing
+ * it from the heap.
+ *
+ * @param[in] heap The timer heap to look in.
+ *
+ * @return The thread with the earliest wakeup time, NULL if the heap is empty.
+ */
+kernel_thread_t* timer_heap_peek(const timer_heap_t* heap);
+
+/**
+ * @brief Removes a thread that reached its wakeup time.
+ *
+ * @details Removes and returns the thread with the earliest wakeup time if it
+ * is due by the time given as parameter. Calling this function until it
+ * returns NULL extracts all the due threads.
+ *
+ * @param[in, out] heap The timer heap to extract the thread from.
+ * @param[in] now The current time, in the wakeup times reference.
+ *
+ * @return The extracted thread, NULL if no thread is due.
+ */
+kernel_thread_t* timer_heap_pop_expired(timer_heap_t* heap,
+                                        const uint64_t now);
+
+#endif /* #ifndef __CORE_TIMER_HEAP_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,201 @@
+/*******************************************************************************
+ * @file topology.h
+ *
+ * @see topology.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's CPU and memory topology.
+ *
+ * @details Kernel's CPU and memory topology. The firmware tables parsers
+ * declare the CPUs present in the machine, the NUMA nodes and the distances
+ * between them. The CPUs are declared with their hardware identifier, the
+ * local APIC identifier on x86, and are bound to a kernel CPU identifier once
+ * they started. Without firmware information, the machine is a single node
+ * holding all the CPUs. The map is filled at boot, before the APs are
+ * started, and is only read afterwards.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_TOPOLOGY_H_
+#define __CORE_TOPOLOGY_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of CPU hardware identifiers the map can hold. */
+#define TOPOLOGY_MAX_HW_ID 256
+
+/** @brief Distance from a node to itself. */
+#define TOPOLOGY_LOCAL_DISTANCE 10
+
+/** @brief Distance between two nodes the firmware gives no distance for. */
+#define TOPOLOGY_REMOTE_DISTANCE 20
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Returns the node of a firmware proximity domain.
+ *
+ * @details Returns the node of a firmware proximity domain, the nodes are
+ * numbered in the order their domains are first declared.
+ *
+ * @param[in] domain The firmware proximity domain.
+ * @param[out] node The buffer receiving the node.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the buffer is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the map already holds
+ * MAX_NUMA_NODE_COUNT nodes.
+ */
+OS_RETURN_E topology_add_node(const uint32_t domain, uint32_t* node);
+
+/**
+ * @brief Declares a CPU present in the machine.
+ *
+ * @details Declares a CPU present in the machine, the CPU belongs to the
+ * first node until its node is set.
+ *
+ * @param[in] hw_id The CPU hardware identifier.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_OUT_OF_BOUND is returned if the identifier is not lower than
+ * TOPOLOGY_MAX_HW_ID.
+ */
+OS_RETURN_E topology_add_cpu(const uint32_t hw_id);
+
+/**
+ * @brief Sets the node of a CPU.
+ *
+ * @param[in] hw_id The CPU hardware identifier.
+ * @param[in] node The node of the CPU.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_OUT_OF_BOUND is returned if the identifier is not lower than
+ * TOPOLOGY_MAX_HW_ID or the node does not exist.
+ */
+OS_RETURN_E topology_set_cpu_node(const uint32_t hw_id, const uint32_t node);
+
+/**
+ * @brief Sets the distance between two nodes.
+ *
+ * @details Sets the relative memory access distance from a node to another,
+ * TOPOLOGY_LOCAL_DISTANCE being the distance from a node to itself.
+ *
+ * @param[in] from The node accessing the memory.
+ * @param[in] to The node holding the memory.
+ * @param[in] distance The distance between the nodes.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_OUT_OF_BOUND is returned if a node does not exist.
+ */
+OS_RETURN_E topology_set_distance(const uint32_t from,
+                                  const uint32_t to,
+                                  const uint8_t distance);
+
+/**
+ * @brief Binds a started CPU to its hardware identifier.
+ *
+ * @details Binds a kernel CPU identifier to the hardware identifier of the
+ * CPU. This function is called by each CPU once it knows its hardware
+ * identifier.
+ *
+ * @param[in] cpu_id The kernel CPU identifier.
+ * @param[in] hw_id The CPU hardware identifier.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_OUT_OF_BOUND is returned if an identifier is out of bounds.
+ */
+OS_RETURN_E topology_register_cpu(const uint32_t cpu_id, const uint32_t hw_id);
+
+/**
+ * @brief Returns the number of CPUs present in the machine.
+ *
+ * @return The number of CPUs declared by the firmware, 0 if unknown.
+ */
+uint32_t topology_get_cpu_count(void);
+
+/**
+ * @brief Returns the number of nodes.
+ *
+ * @return The number of NUMA nodes, at least 1.
+ */
+uint32_t topology_get_node_count(void);
+
+/**
+ * @brief Returns the node of a CPU.
+ *
+ * @param[in] cpu_id The kernel CPU identifier.
+ *
+ * @return The node of the CPU, 0 for an unknown CPU.
+ */
+uint32_t topology_get_cpu_node(const uint32_t cpu_id);
+
+/**
+ * @brief Returns the distance between two nodes.
+ *
+ * @param[in] from The node accessing the memory.
+ * @param[in] to The node holding the memory.
+ *
+ * @return The distance between the nodes.
+ */
+uint32_t topology_get_distance(const uint32_t from, const uint32_t to);
+
+/**
+ * @brief Returns the distance between the nodes of two CPUs.
+ *
+ * @param[in] cpu_a The kernel identifier of the first CPU.
+ * @param[in] cpu_b The kernel identifier of the second CPU.
+ *
+ * @return The distance between the nodes of the CPUs.
+ */
+uint32_t topology_get_cpu_distance(const uint32_t cpu_a, const uint32_t cpu_b);
+
+#endif /* #ifndef __CORE_TOPOLOGY_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,103 @@
+/*******************************************************************************
+ * @file trace_drain.h
+ *
+ * @see trace_drain.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's trace drain.
+ *
+ * @details Kernel's trace drain. The trace drain streams the trace packets of
+ * each CPU to a trace output driver. Packets are sent by a low priority kernel
+ * thread, the CPUs keep writing their events in their other packet while a full
+ * packet is being sent.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_TRACE_DRAIN_H_
+#define __CORE_TRACE_DRAIN_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Defines the basic interface for the trace output driver. */
+typedef struct
+{
+    /**
+     * @brief The function should send a trace packet.
+     *
+     * @details The function should send the buffer given as parameter to the
+     * trace output. The function returns once the buffer was sent, the buffer
+     * is reused after the function returns.
+     *
+     * @param[in] buffer The buffer to send.
+     * @param[in] size The size of the buffer in bytes.
+     */
+    void (*write)(const void* buffer, const size_t size);
+} kernel_trace_output_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the trace drain.
+ *
+ * @details Initializes the trace drain with the output driver given as
+ * parameter. The tracing library is set in drain mode and the drain thread is
+ * created. This function must be called after the scheduler was initialized
+ * and before the other CPUs are started.
+ *
+ * @param[in] output The trace output driver.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the driver or its function is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the drain is already
+ * initialized.
+ * - Any error returned by the scheduler when creating the drain thread.
+ */
+OS_RETURN_E trace_drain_init(const kernel_trace_output_t* output);
+
+#endif /* #ifndef __CORE_TRACE_DRAIN_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,81 @@
+/*******************************************************************************
+ * @file ustar.h
+ *
+ * @see ustar.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's USTAR file system driver.
+ *
+ * @details Kernel's USTAR file system driver. The archive is read in place
+ * on its block device through the block cache: on mount, its headers are
+ * indexed once in a hash table of the paths, the opens are then a single
+ * lookup. The archive is read only.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_USTAR_H_
+#define __CORE_USTAR_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <vfs.h> /* Virtual file system */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Name of the USTAR file system driver. */
+#define USTAR_DRIVER_NAME "ustar"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Returns the USTAR file system driver.
+ *
+ * @details Returns the USTAR file system driver, to register in the virtual
+ * file system. The driver mount returns OS_ERR_CORRUPTED_DATA if a header is
+ * not a valid USTAR header and its open returns OS_ERR_FILE_NOT_FOUND if the
+ * archive has no such entry.
+ *
+ * @return The USTAR file system driver.
+ */
+const vfs_driver_t* ustar_get_driver(void);
+
+#endif /* #ifndef __CORE_USTAR_H_ */
+
+/************************************ EOF *************************************/
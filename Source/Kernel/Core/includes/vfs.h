@@ -0,0 +1,336 @@
+/*******************************************************************************
+ * @file vfs.h
+ *
+ * @see vfs.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's virtual file system.
+ *
+ * @details Kernel's virtual file system. The file systems drivers register
+ * their routines, the block devices are then mounted on paths with a driver.
+ * The paths are resolved to the mount point with the longest matching path
+ * and the rest of the path is given to its driver. The drivers read their
+ * devices through the block cache.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_VFS_H_
+#define __CORE_VFS_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+#include <blkdev.h> /* Block devices */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Maximal number of file systems drivers. */
+#define VFS_MAX_DRIVERS 4
+
+/** @brief Maximal number of mount points. */
+#define VFS_MAX_MOUNTS 8
+
+/** @brief Maximal length of the mount points paths. */
+#define VFS_MAX_MOUNT_PATH 64
+
+/** @brief Name of the lazy init call mounting the boot file systems, it is
+ * required by the first open.
+ */
+#define VFS_ROOT_INITCALL "rootfs"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Types of the file system nodes. */
+typedef enum
+{
+    /** @brief Regular file. */
+    VFS_NODE_FILE      = 0,
+    /** @brief Directory. */
+    VFS_NODE_DIRECTORY = 1,
+    /** @brief Links, devices and other nodes, they have no data. */
+    VFS_NODE_OTHER     = 2,
+} VFS_NODE_TYPE_E;
+
+/** @brief File system node, filled by the drivers on open. */
+typedef struct
+{
+    /** @brief The node type. */
+    VFS_NODE_TYPE_E type;
+
+    /** @brief The node data size in bytes. */
+    size_t size;
+
+    /** @brief The node permissions. */
+    uint32_t mode;
+
+    /** @brief The node identifier, given by the driver. */
+    uint64_t inode;
+} vfs_node_t;
+
+/** @brief File system driver. */
+typedef struct
+{
+    /** @brief The driver name, used to mount the devices. */
+    const char* name;
+
+    /**
+     * @brief Mounts a device.
+     *
+     * @param[in] dev The block device.
+     * @param[out] fs_ctrl The buffer receiving the mounted file system data.
+     *
+     * @return The success state or the error code.
+     */
+    OS_RETURN_E (*mount)(blkdev_t* dev, void** fs_ctrl);
+
+    /**
+     * @brief Unmounts a device.
+     *
+     * @param[in] fs_ctrl The mounted file system data.
+     *
+     * @return The success state or the error code.
+     */
+    OS_RETURN_E (*unmount)(void* fs_ctrl);
+
+    /**
+     * @brief Opens a node.
+     *
+     * @param[in] fs_ctrl The mounted file system data.
+     * @param[in] path The node path relative to the mount point, without
+     * leading and trailing '/'.
+     * @param[in] length The path length.
+     * @param[out] node The buffer receiving the node.
+     *
+     * @return The success state or the error code.
+     */
+    OS_RETURN_E (*open)(void* fs_ctrl,
+                        const char* path,
+                        const size_t length,
+                        vfs_node_t* node);
+
+    /**
+     * @brief Reads the data of a node.
+     *
+     * @param[in] fs_ctrl The mounted file system data.
+     * @param[in] node The node.
+     * @param[in] offset The offset in the node data, smaller than its size.
+     * @param[out] buffer The buffer receiving the data.
+     * @param[in] size The number of bytes to read, the data after offset is
+     * at least that long.
+     *
+     * @return The success state or the error code.
+     */
+    OS_RETURN_E (*read)(void* fs_ctrl,
+                        const vfs_node_t* node,
+                        const size_t offset,
+                        void* buffer,
+                        const size_t size);
+
+    /**
+     * @brief Returns the address of the data of a node held in place by the
+     * device memory, can be NULL if the driver never does.
+     *
+     * @param[in] fs_ctrl The mounted file system data.
+     * @param[in] node The node.
+     *
+     * @return The address of the node data, valid while the device is
+     * mounted, NULL if the data is not held in place.
+     */
+    const void* (*map)(void* fs_ctrl, const vfs_node_t* node);
+} vfs_driver_t;
+
+/** @brief Mount point. */
+typedef struct
+{
+    /** @brief The mount point path, without trailing '/'. */
+    char path[VFS_MAX_MOUNT_PATH];
+
+    /** @brief The mount point path length. */
+    size_t length;
+
+    /** @brief The file system driver. */
+    const vfs_driver_t* driver;
+
+    /** @brief The mounted device. */
+    blkdev_t* dev;
+
+    /** @brief The mounted file system data. */
+    void* fs_ctrl;
+
+    /** @brief Tells if the device is mounted, the entry is reserved while
+     * the driver mounts it.
+     */
+    bool_t ready;
+} vfs_mount_t;
+
+/** @brief Opened file. */
+typedef struct
+{
+    /** @brief The mount point of the file. */
+    const vfs_mount_t* mount;
+
+    /** @brief The file node. */
+    vfs_node_t node;
+
+    /** @brief The current read offset. */
+    size_t offset;
+} vfs_file_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Registers a file system driver.
+ *
+ * @param[in] driver The file system driver.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if driver or one of its routines is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if a driver has the same name.
+ * - OS_ERR_NO_MORE_MEMORY is returned if VFS_MAX_DRIVERS drivers are
+ * registered.
+ */
+OS_RETURN_E vfs_register_driver(const vfs_driver_t* driver);
+
+/**
+ * @brief Mounts a block device.
+ *
+ * @param[in] path The mount point path.
+ * @param[in] driver_name The name of the file system driver.
+ * @param[in] dev The block device.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if a parameter is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if no driver has the name.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the path is already mounted or
+ * too long.
+ * - OS_ERR_NO_MORE_MEMORY is returned if VFS_MAX_MOUNTS devices are mounted.
+ * - The driver mount error is returned if the driver could not mount the
+ * device.
+ */
+OS_RETURN_E vfs_mount(const char* path,
+                      const char* driver_name,
+                      blkdev_t* dev);
+
+/**
+ * @brief Unmounts a block device.
+ *
+ * @param[in] path The mount point path.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if path is NULL.
+ * - OS_ERR_FILE_NOT_FOUND is returned if the path is not a mount point.
+ * - The driver unmount error is returned if the driver could not unmount the
+ * device.
+ */
+OS_RETURN_E vfs_unmount(const char* path);
+
+/**
+ * @brief Opens a file.
+ *
+ * @details Opens a file, the file does not hold any resource and needs not be
+ * closed. Its mount point must stay mounted while it is used.
+ *
+ * @param[in] path The absolute path of the file.
+ * @param[out] file The buffer receiving the opened file.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if path or file is NULL.
+ * - OS_ERR_FILE_NOT_FOUND is returned if no mount point contains the path or
+ * the file does not exist.
+ * - The driver open error is returned for the other failures.
+ */
+OS_RETURN_E vfs_open(const char* path, vfs_file_t* file);
+
+/**
+ * @brief Reads a file from its current offset and advances the offset.
+ *
+ * @param[in, out] file The opened file.
+ * @param[out] buffer The buffer receiving the data.
+ * @param[in] size The maximal number of bytes to read.
+ * @param[out] read_size The buffer receiving the number of bytes read, 0 at
+ * the end of the file.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if a parameter is NULL.
+ * - The driver read error is returned if the data could not be read.
+ */
+OS_RETURN_E vfs_read(vfs_file_t* file,
+                     void* buffer,
+                     const size_t size,
+                     size_t* read_size);
+
+/**
+ * @brief Sets the read offset of a file.
+ *
+ * @param[in, out] file The opened file.
+ * @param[in] offset The new offset.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if file is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the offset is after the end of the
+ * file.
+ */
+OS_RETURN_E vfs_seek(vfs_file_t* file, const size_t offset);
+
+/**
+ * @brief Returns the address of the data of a file held in place.
+ *
+ * @details Returns the address of the data of a file whose device memory
+ * holds it in place, such as the initial ram disk: the data can then be used
+ * without copy. The data is read only and stays valid while the mount point
+ * stays mounted.
+ *
+ * @param[in] file The opened file.
+ * @param[out] data The buffer receiving the data address.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if file or data is NULL.
+ * - OS_ERR_NOT_SUPPORTED is returned if the data is not held in place.
+ */
+OS_RETURN_E vfs_map(const vfs_file_t* file, const void** data);
+
+#endif /* #ifndef __CORE_VFS_H_ */
+
+/************************************ EOF *************************************/
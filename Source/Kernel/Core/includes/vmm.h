@@ -0,0 +1,557 @@
+/*******************************************************************************
+ * @file vmm.h
+ *
+ * @see vmm.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's virtual memory manager.
+ *
+ * @details Kernel's virtual memory manager. The manager maps, unmaps and
+ * changes the protection of the kernel address space and of the address
+ * spaces created for the user threads. The largest pages the CPU supports are
+ * used where the virtual and physical addresses alignment allows it, the
+ * large pages are only split when a part of them is unmapped or protected.
+ * An address space only owns the range between KERNEL_USER_SPACE_START and
+ * KERNEL_USER_SPACE_END, the rest is shared with the kernel address space. Its
+ * TLB entries are tagged with its own PCID when the CPU supports it, switching
+ * address spaces then keeps the TLB entries of the others.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_VMM_H_
+#define __CORE_VMM_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+#include <cpu.h>    /* Paging structures */
+#include <kerror.h> /* Kernel error codes */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Size of the smallest page in bytes. */
+#define VMM_PAGE_SIZE 0x1000
+
+/** @brief Mapping flag, the memory is writable. */
+#define VMM_FLAG_WRITE    0x1
+
+/** @brief Mapping flag, the memory is accessible from user mode. */
+#define VMM_FLAG_USER     0x2
+
+/** @brief Mapping flag, the memory is not cached. */
+#define VMM_FLAG_UNCACHED 0x4
+
+/** @brief Mapping flag, the memory is not cached and the writes are combined
+ * in the CPU write buffers. Falls back to VMM_FLAG_UNCACHED when the CPU does
+ * not provide the write-combining type, ignored with VMM_FLAG_UNCACHED.
+ */
+#define VMM_FLAG_WRITE_COMBINING 0x8
+
+/** @brief Mapping flag, the frames are single frames allocated with
+ * memmgt_alloc_frames and each mapping holds a reference to its frame. The
+ * clones of an address space share the private pages, copy-on-write when
+ * they are writable. Only user ranges are mapped with this flag, with pages
+ * of VMM_PAGE_SIZE.
+ */
+#define VMM_FLAG_PRIVATE 0x10
+
+/** @brief Mapping flag, the memory is read only until its first write, which
+ * faults and is resolved with vmm_space_resolve_cow. VMM_FLAG_WRITE is
+ * ignored. Only user ranges are mapped with this flag, with pages of
+ * VMM_PAGE_SIZE.
+ */
+#define VMM_FLAG_COPY_ON_WRITE 0x20
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Address space of user threads. */
+typedef struct vmm_space
+{
+    /** @brief Root paging structure, reached through the kernel linear
+     * mapping.
+     */
+    cpu_page_entry_t* root;
+
+    /** @brief PCID tagging the TLB entries of the space, 0 when the PCIDs are
+     * disabled.
+     */
+    uint32_t pcid;
+
+    /** @brief CPUs that might cache TLB entries of the space, one bit per
+     * CPU.
+     */
+    volatile uint32_t cpu_mask;
+
+    /** @brief Next space of the address spaces list. */
+    struct vmm_space* next;
+} vmm_space_t;
+
+/** @brief Virtual range. */
+typedef struct
+{
+    /** @brief The virtual address, page aligned. */
+    uintptr_t virt;
+
+    /** @brief The size of the range, multiple of VMM_PAGE_SIZE. */
+    size_t size;
+} vmm_range_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes the virtual memory manager.
+ *
+ * @details Initializes the virtual memory manager over the paging structures
+ * set by the boot code. The new paging structures are allocated from the
+ * kernel heap, this function must be called after the kernel heap was
+ * initialized.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the manager is already
+ * initialized.
+ */
+OS_RETURN_E vmm_init(void);
+
+/**
+ * @brief Adds the calling CPU to the TLB shootdowns.
+ *
+ * @details Adds the calling CPU to the CPUs whose TLB is invalidated when the
+ * paging structures change, then flushes its TLB. The shootdowns are
+ * cross-CPU calls, this function must be called by each CPU once it was added
+ * to the cross-CPU calls, with interrupts disabled.
+ *
+ * @param[in] cpu_id The identifier of the calling CPU.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the manager is not initialized
+ * or the CPU identifier is not valid.
+ */
+OS_RETURN_E vmm_init_cpu(const uint32_t cpu_id);
+
+/**
+ * @brief Maps physical memory in the kernel address space.
+ *
+ * @details Maps a physical range at a virtual range. The largest pages are
+ * used where both addresses are aligned on their size. Nothing is mapped if
+ * a part of the virtual range is already mapped.
+ *
+ * @param[in] virt The virtual address, page aligned.
+ * @param[in] phys The physical address, page aligned.
+ * @param[in] size The size of the range, multiple of VMM_PAGE_SIZE.
+ * @param[in] flags The mapping flags, a combination of the VMM_FLAG values.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if a parameter is not aligned, the
+ * size is 0 or the manager is not initialized.
+ * - OS_ERR_MAPPING_ALREADY_EXISTS is returned if a part of the virtual range
+ * is already mapped.
+ * - OS_ERR_NO_MORE_MEMORY is returned if a paging structure could not be
+ * allocated.
+ */
+OS_RETURN_E vmm_map(const uintptr_t virt,
+                    const uintptr_t phys,
+                    const size_t size,
+                    const uint32_t flags);
+
+/**
+ * @brief Unmaps a range of the kernel address space.
+ *
+ * @details Unmaps a virtual range, the parts of the range that are not mapped
+ * are ignored. The large pages crossing the range bounds are split. The
+ * paging structures left empty are released.
+ *
+ * @param[in] virt The virtual address, page aligned.
+ * @param[in] size The size of the range, multiple of VMM_PAGE_SIZE.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if a parameter is not aligned, the
+ * size is 0 or the manager is not initialized.
+ * - OS_ERR_NO_MORE_MEMORY is returned if a large page could not be split, the
+ * range is then partially unmapped.
+ */
+OS_RETURN_E vmm_unmap(const uintptr_t virt, const size_t size);
+
+/**
+ * @brief Maps a page of the kernel address space from a fault handler.
+ *
+ * @details Maps a physical page at a virtual page without taking the manager
+ * lock nor allocating paging structures, the function can be called with the
+ * interrupts disabled while the lock is held. The paging structures of the
+ * page must exist and the caller guarantees they are not released. The page
+ * was not present, no TLB entry is invalidated.
+ *
+ * @param[in] virt The virtual address, page aligned.
+ * @param[in] phys The physical address, page aligned.
+ * @param[in] flags The mapping flags, a combination of the VMM_FLAG values.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if a parameter is not aligned or
+ * the manager is not initialized.
+ * - OS_ERR_MEMORY_NOT_MAPPED is returned if a paging structure of the page is
+ * missing or a large page maps it.
+ * - OS_ERR_MAPPING_ALREADY_EXISTS is returned if the page is already mapped.
+ */
+OS_RETURN_E vmm_map_fault(const uintptr_t virt,
+                          const uintptr_t phys,
+                          const uint32_t flags);
+
+/**
+ * @brief Changes the protection of a range of the kernel address space.
+ *
+ * @details Changes the mapping flags of a mapped virtual range. The large
+ * pages crossing the range bounds are split when their flags change.
+ *
+ * @param[in] virt The virtual address, page aligned.
+ * @param[in] size The size of the range, multiple of VMM_PAGE_SIZE.
+ * @param[in] flags The new mapping flags, a combination of the VMM_FLAG
+ * values.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if a parameter is not aligned, the
+ * size is 0 or the manager is not initialized.
+ * - OS_ERR_MEMORY_NOT_MAPPED is returned if a part of the range is not mapped.
+ * - OS_ERR_NO_MORE_MEMORY is returned if a large page could not be split, the
+ * range is then partially protected.
+ */
+OS_RETURN_E vmm_protect(const uintptr_t virt,
+                        const size_t size,
+                        const uint32_t flags);
+
+/**
+ * @brief Returns the physical address mapped at a virtual address.
+ *
+ * @param[in] virt The virtual address.
+ * @param[out] phys The physical address mapped at virt.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if phys is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the manager is not initialized.
+ * - OS_ERR_MEMORY_NOT_MAPPED is returned if virt is not mapped.
+ */
+OS_RETURN_E vmm_get_physical(const uintptr_t virt, uintptr_t* phys);
+
+/**
+ * @brief Returns the mapping of a virtual address.
+ *
+ * @details Returns the physical address mapped at a virtual address, the
+ * mapping flags of its page and the size of the page, which tells if a large
+ * page maps it.
+ *
+ * @param[in] virt The virtual address.
+ * @param[out] phys The physical address mapped at virt.
+ * @param[out] flags The mapping flags of the page, a combination of the
+ * VMM_FLAG values.
+ * @param[out] page_size The size of the page mapping virt.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if an output buffer is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the manager is not initialized.
+ * - OS_ERR_MEMORY_NOT_MAPPED is returned if virt is not mapped.
+ */
+OS_RETURN_E vmm_get_mapping(const uintptr_t virt,
+                            uintptr_t* phys,
+                            uint32_t* flags,
+                            size_t* page_size);
+
+/**
+ * @brief Creates an address space.
+ *
+ * @details Creates an address space with an empty user range, the rest of the
+ * space is shared with the kernel address space. A PCID is allocated to the
+ * space when the PCIDs are enabled.
+ *
+ * @param[out] space The created address space.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if space is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the manager is not initialized.
+ * - OS_ERR_NO_MORE_MEMORY is returned if the space could not be allocated or
+ * no PCID is left.
+ */
+OS_RETURN_E vmm_space_create(vmm_space_t** space);
+
+/**
+ * @brief Destroys an address space.
+ *
+ * @details Releases the paging structures of an address space and its PCID.
+ * The memory mapped in the space is not released. The space must not be
+ * switched to during the call.
+ *
+ * @param[in] space The address space to destroy.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if space is NULL.
+ * - OS_ERR_RESOURCE_BUSY is returned if the space is the current address
+ * space of a CPU.
+ */
+OS_RETURN_E vmm_space_destroy(vmm_space_t* space);
+
+/**
+ * @brief Switches the address space of the calling CPU.
+ *
+ * @details Loads the paging structures of an address space on the calling
+ * CPU. With the PCIDs, the TLB entries the CPU cached for the space are kept.
+ * This function must be called with interrupts disabled.
+ *
+ * @param[in] space The address space, NULL for the kernel address space.
+ */
+void vmm_space_switch(vmm_space_t* space);
+
+/**
+ * @brief Maps physical memory in an address space.
+ *
+ * @details Maps a physical range at a virtual range of the user range of an
+ * address space, as vmm_map does for the kernel address space.
+ *
+ * @param[in, out] space The address space.
+ * @param[in] virt The virtual address, page aligned.
+ * @param[in] phys The physical address, page aligned.
+ * @param[in] size The size of the range, multiple of VMM_PAGE_SIZE.
+ * @param[in] flags The mapping flags, a combination of the VMM_FLAG values.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if space is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if a parameter is not aligned, the
+ * size is 0 or the range is not in the user range.
+ * - OS_ERR_MAPPING_ALREADY_EXISTS is returned if a part of the virtual range
+ * is already mapped.
+ * - OS_ERR_NO_MORE_MEMORY is returned if a paging structure could not be
+ * allocated.
+ */
+OS_RETURN_E vmm_space_map(vmm_space_t* space,
+                          const uintptr_t virt,
+                          const uintptr_t phys,
+                          const size_t size,
+                          const uint32_t flags);
+
+/**
+ * @brief Unmaps a range of an address space.
+ *
+ * @details Unmaps a virtual range of the user range of an address space, as
+ * vmm_unmap does for the kernel address space.
+ *
+ * @param[in, out] space The address space.
+ * @param[in] virt The virtual address, page aligned.
+ * @param[in] size The size of the range, multiple of VMM_PAGE_SIZE.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if space is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if a parameter is not aligned, the
+ * size is 0 or the range is not in the user range.
+ * - OS_ERR_NO_MORE_MEMORY is returned if a large page could not be split, the
+ * range is then partially unmapped.
+ */
+OS_RETURN_E vmm_space_unmap(vmm_space_t* space,
+                            const uintptr_t virt,
+                            const size_t size);
+
+/**
+ * @brief Unmaps several ranges of an address space.
+ *
+ * @details Unmaps several virtual ranges of the user range of an address
+ * space. The TLB entries of all the ranges are invalidated at once, the other
+ * CPUs are interrupted a single time.
+ *
+ * @param[in, out] space The address space.
+ * @param[in] ranges The ranges to unmap.
+ * @param[in] count The number of ranges.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if space or ranges is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if a range is not aligned, its
+ * size is 0, it is not in the user range or count is 0.
+ * - OS_ERR_NO_MORE_MEMORY is returned if a large page could not be split, the
+ * ranges are then partially unmapped.
+ */
+OS_RETURN_E vmm_space_unmap_ranges(vmm_space_t* space,
+                                   const vmm_range_t* ranges,
+                                   const uint32_t count);
+
+/**
+ * @brief Changes the protection of a range of an address space.
+ *
+ * @details Changes the mapping flags of a mapped virtual range of the user
+ * range of an address space, as vmm_protect does for the kernel address
+ * space. The private and copy-on-write states of the pages are kept, the
+ * copy-on-write pages stay read only until they are resolved.
+ *
+ * @param[in, out] space The address space.
+ * @param[in] virt The virtual address, page aligned.
+ * @param[in] size The size of the range, multiple of VMM_PAGE_SIZE.
+ * @param[in] flags The new mapping flags, a combination of the VMM_FLAG
+ * values.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if space is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if a parameter is not aligned, the
+ * size is 0 or the range is not in the user range.
+ * - OS_ERR_MEMORY_NOT_MAPPED is returned if a part of the range is not mapped.
+ * - OS_ERR_NO_MORE_MEMORY is returned if a large page could not be split, the
+ * range is then partially protected.
+ */
+OS_RETURN_E vmm_space_protect(vmm_space_t* space,
+                              const uintptr_t virt,
+                              const size_t size,
+                              const uint32_t flags);
+
+/**
+ * @brief Returns the physical address mapped at a virtual address of an
+ * address space.
+ *
+ * @param[in] space The address space.
+ * @param[in] virt The virtual address.
+ * @param[out] phys The physical address mapped at virt.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if space or phys is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the manager is not initialized.
+ * - OS_ERR_MEMORY_NOT_MAPPED is returned if virt is not mapped.
+ */
+OS_RETURN_E vmm_space_get_physical(const vmm_space_t* space,
+                                   const uintptr_t virt,
+                                   uintptr_t* phys);
+
+/**
+ * @brief Returns the mapping of a virtual address of an address space.
+ *
+ * @details Returns the physical address mapped at a virtual address, the
+ * mapping flags of its page and the size of the page, which tells if a large
+ * page maps it.
+ *
+ * @param[in] space The address space.
+ * @param[in] virt The virtual address.
+ * @param[out] phys The physical address mapped at virt.
+ * @param[out] flags The mapping flags of the page, a combination of the
+ * VMM_FLAG values.
+ * @param[out] page_size The size of the page mapping virt.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if an output buffer or space is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the manager is not initialized.
+ * - OS_ERR_MEMORY_NOT_MAPPED is returned if virt is not mapped.
+ */
+OS_RETURN_E vmm_space_get_mapping(const vmm_space_t* space,
+                                  const uintptr_t virt,
+                                  uintptr_t* phys,
+                                  uint32_t* flags,
+                                  size_t* page_size);
+
+/**
+ * @brief Clones an address space.
+ *
+ * @details Creates an address space mapping the user range of an address
+ * space to the same memory, without copying it. The private pages are
+ * shared: a reference to their frame is taken and the writable ones become
+ * copy-on-write in both address spaces. The other pages are mapped as they
+ * are, with their access rights.
+ *
+ * @param[in, out] space The address space to clone.
+ * @param[out] clone The created address space.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if space or clone is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the manager is not initialized.
+ * - OS_ERR_NO_MORE_MEMORY is returned if the space or a paging structure
+ * could not be allocated or no PCID is left, the pages already shared stay
+ * copy-on-write.
+ * - Any error returned by memmgt_share_frame.
+ */
+OS_RETURN_E vmm_space_clone(vmm_space_t* space, vmm_space_t** clone);
+
+/**
+ * @brief Returns the frame of a copy-on-write page of an address space.
+ *
+ * @param[in] space The address space.
+ * @param[in] virt The virtual address, page aligned.
+ * @param[out] phys The physical address of the page frame.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if space or phys is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if virt is not aligned or not in
+ * the user range, the manager is not initialized or the page is not
+ * copy-on-write.
+ * - OS_ERR_MEMORY_NOT_MAPPED is returned if virt is not mapped.
+ */
+OS_RETURN_E vmm_space_get_cow_frame(const vmm_space_t* space,
+                                    const uintptr_t virt,
+                                    uintptr_t* phys);
+
+/**
+ * @brief Resolves a copy-on-write page of an address space.
+ *
+ * @details Maps a copy-on-write page writable, on a private frame: a copy of
+ * the page, or its own frame when no other mapping shares it. The TLB
+ * entries of the page are invalidated before returning, the reference to the
+ * previous frame can then be dropped.
+ *
+ * @param[in, out] space The address space.
+ * @param[in] virt The virtual address, page aligned.
+ * @param[in] phys The physical address of the private frame, page aligned.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if space is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if a parameter is not aligned,
+ * virt is not in the user range, the manager is not initialized or the page
+ * is not copy-on-write.
+ * - OS_ERR_MEMORY_NOT_MAPPED is returned if virt is not mapped.
+ */
+OS_RETURN_E vmm_space_resolve_cow(vmm_space_t* space,
+                                  const uintptr_t virt,
+                                  const uintptr_t phys);
+
+#endif /* #ifndef __CORE_VMM_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,137 @@
+/*******************************************************************************
+ * @file wait_queue.h
+ *
+ * @see wait_queue.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Threads wait queue.
+ *
+ * @details Threads wait queue used by the blocking synchronization primitives.
+ * The queue is intrusive: each waiting thread links a node allocated on its
+ * own stack, the queue never allocates memory. The nodes are kept sorted by
+ * priority, threads of the same priority are served in their arrival order.
+ * The wait queue is not thread safe, the caller is responsible for the
+ * locking.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __CORE_WAIT_QUEUE_H_
+#define __CORE_WAIT_QUEUE_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h>     /* Generic int types */
+#include <stddef.h>     /* Standard definitions */
+#include <ctrl_block.h> /* Kernel control blocks */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Wait queue node, allocated on the stack of the waiting thread. */
+typedef struct wait_queue_node
+{
+    /** @brief Next node of the queue. */
+    struct wait_queue_node* next;
+
+    /** @brief Waiting thread. */
+    kernel_thread_t* thread;
+
+    /** @brief Priority of the thread when it was queued. */
+    uint8_t priority;
+
+    /** @brief Set by the waker once the thread was given the resource. */
+    volatile bool_t woken;
+} wait_queue_node_t;
+
+/** @brief Threads wait queue. */
+typedef struct
+{
+    /** @brief Queue's head, node of the highest priority waiting thread. */
+    wait_queue_node_t* head;
+} wait_queue_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/** @brief Static initializer of an empty wait queue. */
+#define WAIT_QUEUE_INIT_VALUE {NULL}
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes a wait queue.
+ *
+ * @details Initializes an empty wait queue.
+ *
+ * @param[out] queue The wait queue to initialize.
+ */
+void wait_queue_init(wait_queue_t* queue);
+
+/**
+ * @brief Inserts a thread in a wait queue.
+ *
+ * @details Initializes the node for the thread and inserts it after the
+ * nodes of the threads with the same or a higher priority.
+ *
+ * @param[in, out] queue The wait queue.
+ * @param[out] node The node to insert, must stay valid while it is queued.
+ * @param[in] thread The waiting thread.
+ */
+void wait_queue_insert(wait_queue_t* queue,
+                       wait_queue_node_t* node,
+                       kernel_thread_t* thread);
+
+/**
+ * @brief Removes the node of the highest priority waiting thread.
+ *
+ * @param[in, out] queue The wait queue.
+ *
+ * @return The removed node, NULL if the queue is empty.
+ */
+wait_queue_node_t* wait_queue_pop(wait_queue_t* queue);
+
+/**
+ * @brief Removes a node from a wait queue.
+ *
+ * @details Removes a node from a wait queue, nothing is done if the node is
+ * not in the queue.
+ *
+ * @param[in, out] queue The wait queue.
+ * @param[in] node The node to remove.
+ */
+void wait_queue_remove(wait_queue_t* queue, const wait_queue_node_t* node);
+
+#endif /* #ifndef __CORE_WAIT_QUEUE_H_ */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,567 @@
+/*******************************************************************************
+ * @file bcache.c
+ *
+ * @see bcache.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's block cache.
+ *
+ * @details Kernel's block cache. The cached blocks are found with a chained
+ * hash table of the device and block numbers. The cache lock only protects
+ * the table and the entries bookkeeping, the device reads are done without
+ * it: the missed blocks are inserted in the loading state and the other
+ * users of these blocks wait for the reader to publish the read result.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* Memory manipulation */
+#include <critical.h>       /* Kernel spinlocks */
+#include <semaphore.h>      /* Kernel semaphores */
+#include <blkdev.h>         /* Block devices */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <bcache.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "BCACHE"
+
+/** @brief State of the blocks being read from their device. */
+#define BCACHE_STATE_LOADING -1
+
+/** @brief End of the lookup buckets chains. */
+#define BCACHE_CHAIN_END -1
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The cache entries. */
+static bcache_block_t bcache_blocks[BCACHE_BLOCK_COUNT];
+
+/** @brief The cache entries data, used by the devices without map routine. */
+static uint8_t bcache_data[BCACHE_BLOCK_COUNT][BLKDEV_BLOCK_SIZE]
+    __attribute__((aligned(64)));
+
+/** @brief The read ahead buffer, a sequential miss reads its blocks in it. */
+static uint8_t bcache_staging[BCACHE_READ_AHEAD * BLKDEV_BLOCK_SIZE]
+    __attribute__((aligned(64)));
+
+/** @brief Tells if the read ahead buffer is used. */
+static volatile bool_t bcache_staging_busy = FALSE;
+
+/** @brief The lookup table buckets, the first entry of each chain. */
+static int32_t bcache_buckets[BCACHE_HASH_SIZE];
+
+/** @brief The CLOCK hand, the next entry to check for eviction. */
+static uint32_t bcache_hand = 0;
+
+/** @brief Cache lock. */
+static kernel_spinlock_t bcache_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Returns the lookup bucket of a block.
+ *
+ * @param[in] dev The block device.
+ * @param[in] block The block number.
+ *
+ * @return The bucket index.
+ */
+inline static uint32_t _bcache_bucket(const blkdev_t* dev,
+                                      const uint64_t block);
+
+/**
+ * @brief Looks for a cached block. The cache lock must be held.
+ *
+ * @param[in] dev The block device.
+ * @param[in] block The block number.
+ *
+ * @return The entry index, BCACHE_CHAIN_END if the block is not cached.
+ */
+static int32_t _bcache_lookup(const blkdev_t* dev, const uint64_t block);
+
+/**
+ * @brief Removes an entry from its lookup bucket and frees it. The cache lock
+ * must be held.
+ *
+ * @param[in] index The entry index.
+ */
+static void _bcache_remove(const int32_t index);
+
+/**
+ * @brief Selects an unused entry with the CLOCK algorithm and frees it. The
+ * cache lock must be held.
+ *
+ * @return The entry index, BCACHE_CHAIN_END if all the entries are used.
+ */
+static int32_t _bcache_evict(void);
+
+/**
+ * @brief Inserts a block in an entry, in the loading state and used once.
+ * The cache lock must be held.
+ *
+ * @param[in] index The free entry index.
+ * @param[in] dev The block device.
+ * @param[in] block The block number.
+ * @param[in] referenced The initial CLOCK referenced bit.
+ */
+static void _bcache_insert(const int32_t index,
+                           blkdev_t* dev,
+                           const uint64_t block,
+                           const bool_t referenced);
+
+/**
+ * @brief Loads consecutive blocks inserted by a miss and publishes their
+ * state.
+ *
+ * @param[in] dev The block device.
+ * @param[in] block The first block number.
+ * @param[in] run The entries of the blocks.
+ * @param[in] count The number of blocks.
+ *
+ * @return The first block read state.
+ */
+static OS_RETURN_E _bcache_load(blkdev_t* dev,
+                                const uint64_t block,
+                                const int32_t* run,
+                                const uint32_t count);
+
+/**
+ * @brief Publishes the state of a loaded block and wakes its waiting users.
+ *
+ * @param[in] cached The cached block.
+ * @param[in] state The block read state.
+ */
+static void _bcache_publish(bcache_block_t* cached, const OS_RETURN_E state);
+
+/**
+ * @brief Waits for a block to be loaded. The cache lock must be held, it is
+ * released before waiting.
+ *
+ * @details The users of a loading block sleep on the block semaphore until
+ * the device read completes, it can take the time of a device transfer.
+ *
+ * @param[in] cached The cached block.
+ *
+ * @return The block read state.
+ */
+static OS_RETURN_E _bcache_wait(bcache_block_t* cached);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static uint32_t _bcache_bucket(const blkdev_t* dev,
+                                      const uint64_t block)
+{
+    uint64_t key;
+
+    key = ((uint64_t)(uintptr_t)dev >> 4) ^ (block * 0x9E3779B97F4A7C15ULL);
+
+    return (uint32_t)(key >> 32) & (BCACHE_HASH_SIZE - 1);
+}
+
+static int32_t _bcache_lookup(const blkdev_t* dev, const uint64_t block)
+{
+    int32_t index;
+
+    for(index = bcache_buckets[_bcache_bucket(dev, block)];
+        index != BCACHE_CHAIN_END;
+        index = bcache_blocks[index].next)
+    {
+        if(bcache_blocks[index].dev == dev &&
+           bcache_blocks[index].block == block)
+        {
+            break;
+        }
+    }
+
+    return index;
+}
+
+static void _bcache_remove(const int32_t index)
+{
+    int32_t* link;
+
+    link = &bcache_buckets[_bcache_bucket(bcache_blocks[index].dev,
+                                          bcache_blocks[index].block)];
+    while(*link != index)
+    {
+        link = &bcache_blocks[*link].next;
+    }
+    *link = bcache_blocks[index].next;
+
+    bcache_blocks[index].dev  = NULL;
+    bcache_blocks[index].next = BCACHE_CHAIN_END;
+}
+
+static int32_t _bcache_evict(void)
+{
+    bcache_block_t* entry;
+    int32_t         index;
+    uint32_t        i;
+
+    /* Two turns clear all the referenced bits */
+    for(i = 0; i < 2 * BCACHE_BLOCK_COUNT; ++i)
+    {
+        index       = (int32_t)bcache_hand;
+        entry       = &bcache_blocks[index];
+        bcache_hand = (bcache_hand + 1) % BCACHE_BLOCK_COUNT;
+
+        if(entry->ref_count != 0)
+        {
+            continue;
+        }
+        if(entry->referenced == TRUE)
+        {
+            entry->referenced = FALSE;
+            continue;
+        }
+
+        if(entry->dev != NULL)
+        {
+            _bcache_remove(index);
+        }
+        return index;
+    }
+
+    return BCACHE_CHAIN_END;
+}
+
+static void _bcache_insert(const int32_t index,
+                           blkdev_t* dev,
+                           const uint64_t block,
+                           const bool_t referenced)
+{
+    bcache_block_t* entry;
+    uint32_t        bucket;
+
+    bucket = _bcache_bucket(dev, block);
+    entry  = &bcache_blocks[index];
+
+    entry->data       = bcache_data[index];
+    entry->dev        = dev;
+    entry->block      = block;
+    entry->ref_count  = 1;
+    entry->referenced = referenced;
+    entry->state      = BCACHE_STATE_LOADING;
+    entry->next       = bcache_buckets[bucket];
+    entry->waiters    = 0;
+
+    bcache_buckets[bucket] = index;
+}
+
+static OS_RETURN_E _bcache_load(blkdev_t* dev,
+                                const uint64_t block,
+                                const int32_t* run,
+                                const uint32_t count)
+{
+    bcache_block_t* entry;
+    OS_RETURN_E     err;
+    OS_RETURN_E     first_err;
+    uint32_t        i;
+    bool_t          staged;
+
+    first_err = OS_NO_ERR;
+
+    /* The read ahead blocks are read at once when the buffer is free */
+    staged = FALSE;
+    err    = OS_NO_ERR;
+    if(count > 1 &&
+       __atomic_exchange_n(&bcache_staging_busy, TRUE,
+                           __ATOMIC_ACQUIRE) == FALSE)
+    {
+        staged = TRUE;
+        err    = dev->read(dev, block, count, bcache_staging);
+    }
+
+    for(i = 0; i < count; ++i)
+    {
+        entry = &bcache_blocks[run[i]];
+
+        if(dev->map != NULL)
+        {
+            entry->data = dev->map(dev, block + i);
+            err = (entry->data != NULL) ? OS_NO_ERR : OS_ERR_MEMORY_NOT_MAPPED;
+        }
+        else if(staged == TRUE)
+        {
+            if(err == OS_NO_ERR)
+            {
+                memcpy(bcache_data[run[i]],
+                       bcache_staging + i * BLKDEV_BLOCK_SIZE,
+                       BLKDEV_BLOCK_SIZE);
+            }
+        }
+        else
+        {
+            err = dev->read(dev, block + i, 1, bcache_data[run[i]]);
+        }
+
+        if(i == 0)
+        {
+            first_err = err;
+        }
+
+        _bcache_publish(entry, err);
+
+        /* The read ahead blocks are only kept by the cache */
+        if(i != 0)
+        {
+            bcache_release(entry);
+        }
+    }
+
+    if(staged == TRUE)
+    {
+        __atomic_store_n(&bcache_staging_busy, FALSE, __ATOMIC_RELEASE);
+    }
+
+    return first_err;
+}
+
+static void _bcache_publish(bcache_block_t* cached, const OS_RETURN_E state)
+{
+    uint32_t waiters;
+
+    /* The state is set under the lock, a user either sees it or is counted
+     * before the posts.
+     */
+    KERNEL_SPINLOCK_LOCK(bcache_lock);
+
+    /* The users waiting for the block get the error */
+    if(state != OS_NO_ERR)
+    {
+        _bcache_remove((int32_t)(cached - bcache_blocks));
+    }
+    __atomic_store_n(&cached->state, state, __ATOMIC_RELEASE);
+
+    waiters         = cached->waiters;
+    cached->waiters = 0;
+
+    KERNEL_SPINLOCK_UNLOCK(bcache_lock);
+
+    for(; waiters != 0; --waiters)
+    {
+        (void)semaphore_post(&cached->loaded);
+    }
+}
+
+static OS_RETURN_E _bcache_wait(bcache_block_t* cached)
+{
+    bool_t loading;
+
+    loading = (cached->state == BCACHE_STATE_LOADING);
+    if(loading == TRUE)
+    {
+        ++cached->waiters;
+    }
+
+    KERNEL_SPINLOCK_UNLOCK(bcache_lock);
+
+    if(loading == TRUE)
+    {
+        (void)semaphore_wait(&cached->loaded);
+    }
+
+    return (OS_RETURN_E)__atomic_load_n(&cached->state, __ATOMIC_ACQUIRE);
+}
+
+void bcache_init(void)
+{
+    uint32_t i;
+
+    KERNEL_SPINLOCK_INIT(bcache_lock);
+
+    memset(bcache_blocks, 0, sizeof(bcache_blocks));
+    for(i = 0; i < BCACHE_BLOCK_COUNT; ++i)
+    {
+        bcache_blocks[i].next = BCACHE_CHAIN_END;
+        (void)semaphore_init(&bcache_blocks[i].loaded, 0);
+    }
+    for(i = 0; i < BCACHE_HASH_SIZE; ++i)
+    {
+        bcache_buckets[i] = BCACHE_CHAIN_END;
+    }
+    bcache_hand         = 0;
+    bcache_staging_busy = FALSE;
+
+    KERNEL_SUCCESS("Block cache initialized, %u blocks\n", BCACHE_BLOCK_COUNT);
+}
+
+OS_RETURN_E bcache_get(blkdev_t* dev,
+                       const uint64_t block,
+                       bcache_block_t** cached)
+{
+    bcache_block_t* entry;
+    int32_t         run[BCACHE_READ_AHEAD];
+    int32_t         index;
+    uint32_t        count;
+    OS_RETURN_E     err;
+
+    if(dev == NULL || cached == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(block >= dev->block_count)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    KERNEL_SPINLOCK_LOCK(bcache_lock);
+
+    index = _bcache_lookup(dev, block);
+    if(index != BCACHE_CHAIN_END)
+    {
+        entry = &bcache_blocks[index];
+        ++entry->ref_count;
+        entry->referenced = TRUE;
+
+        err = _bcache_wait(entry);
+        if(err != OS_NO_ERR)
+        {
+            bcache_release(entry);
+            return err;
+        }
+
+        *cached = entry;
+        return OS_NO_ERR;
+    }
+
+    index = _bcache_evict();
+    if(index == BCACHE_CHAIN_END)
+    {
+        KERNEL_SPINLOCK_UNLOCK(bcache_lock);
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+    _bcache_insert(index, dev, block, TRUE);
+    run[0] = index;
+    count  = 1;
+
+    /* A miss following the previous one reads the next uncached blocks, the
+     * memory backed devices do not need it.
+     */
+    if(dev->map == NULL && block == dev->next_block)
+    {
+        while(count < BCACHE_READ_AHEAD &&
+              block + count < dev->block_count &&
+              _bcache_lookup(dev, block + count) == BCACHE_CHAIN_END)
+        {
+            index = _bcache_evict();
+            if(index == BCACHE_CHAIN_END)
+            {
+                break;
+            }
+            _bcache_insert(index, dev, block + count, FALSE);
+            run[count++] = index;
+        }
+    }
+    dev->next_block = block + count;
+
+    KERNEL_SPINLOCK_UNLOCK(bcache_lock);
+
+    KERNEL_DEBUG(BCACHE_DEBUG_ENABLED, MODULE_NAME,
+                 "Device %s miss on block %llu, reading %u blocks",
+                 dev->name, block, count);
+
+    entry = &bcache_blocks[run[0]];
+    err   = _bcache_load(dev, block, run, count);
+    if(err != OS_NO_ERR)
+    {
+        bcache_release(entry);
+        return err;
+    }
+
+    *cached = entry;
+    return OS_NO_ERR;
+}
+
+void bcache_release(bcache_block_t* cached)
+{
+    if(cached == NULL)
+    {
+        return;
+    }
+
+    KERNEL_SPINLOCK_LOCK(bcache_lock);
+    --cached->ref_count;
+    KERNEL_SPINLOCK_UNLOCK(bcache_lock);
+}
+
+OS_RETURN_E bcache_invalidate(blkdev_t* dev)
+{
+    OS_RETURN_E err;
+    int32_t     i;
+
+    if(dev == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    err = OS_NO_ERR;
+
+    KERNEL_SPINLOCK_LOCK(bcache_lock);
+    for(i = 0; i < BCACHE_BLOCK_COUNT; ++i)
+    {
+        if(bcache_blocks[i].dev != dev)
+        {
+            continue;
+        }
+        if(bcache_blocks[i].ref_count != 0)
+        {
+            err = OS_ERR_UNAUTHORIZED_ACTION;
+            continue;
+        }
+        _bcache_remove(i);
+    }
+    dev->next_block = 0;
+    KERNEL_SPINLOCK_UNLOCK(bcache_lock);
+
+    return err;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
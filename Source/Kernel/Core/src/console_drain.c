@@ -0,0 +1,344 @@
+/*******************************************************************************
+ * @file console_drain.c
+ *
+ * @see console_drain.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's console drain.
+ *
+ * @details Kernel's console drain. The console drain gives each registered
+ * console driver a queue and a low priority kernel thread that sends the queued
+ * output to the driver. A thread waits until the console notifies that output
+ * was queued for its driver, a slow driver only delays its own thread. The
+ * kernel log is rendered to the console by another drain thread, the kernel
+ * messages are then only copied to the log by their callers.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <cpu.h>            /* Interrupt state */
+#include <critical.h>       /* Kernel spinlocks */
+#include <console.h>        /* Kernel console */
+#include <scheduler.h>      /* Kernel scheduler */
+#include <time_mgt.h>       /* Time management */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <console_drain.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "CONSOLE DRAIN"
+
+/** @brief Console drain threads name. */
+#define CONSOLE_DRAIN_THREAD_NAME "console_drain"
+
+/** @brief Kernel log drain thread name. */
+#define CONSOLE_DRAIN_LOG_THREAD_NAME "log_drain"
+
+/** @brief Console drain threads priority, above the trace drain thread. */
+#define CONSOLE_DRAIN_THREAD_PRIORITY (KERNEL_LOWEST_PRIORITY - 2)
+
+/** @brief Index of the kernel log drain state. */
+#define CONSOLE_DRAIN_LOG_INDEX CONSOLE_MAX_SINKS
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Drain state of a console driver. */
+typedef struct
+{
+    /** @brief The drain thread. */
+    kernel_thread_t* thread;
+
+    /** @brief The drain thread when waiting for output, NULL otherwise. */
+    kernel_thread_t* waiter;
+
+    /** @brief Tells if output was queued since the last drain. */
+    bool_t pending;
+
+    /** @brief Protects the drain state. */
+    kernel_spinlock_t lock;
+} console_drainer_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Drain state of each console driver, then of the kernel log. */
+static console_drainer_t drainers[CONSOLE_MAX_SINKS + 1];
+
+/** @brief Tells if the console drain was initialized. */
+static bool_t drain_initialized = FALSE;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Console drain thread routine.
+ *
+ * @details Console drain thread routine. Sends the queued output to the
+ * console driver, or renders the kernel log, then waits until new output is
+ * queued.
+ *
+ * @param[in] args The registration index of the console driver, or
+ * CONSOLE_DRAIN_LOG_INDEX for the kernel log.
+ *
+ * @return The function never returns.
+ */
+static void* _console_drain_routine(void* args);
+
+/**
+ * @brief Creates a drain thread.
+ *
+ * @details Initializes the drain state and creates the drain thread of the
+ * index given as parameter.
+ *
+ * @param[in] index The index of the drain state.
+ * @param[in] name The name of the thread.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _console_drain_create(const uint32_t index,
+                                         const char* name);
+
+/**
+ * @brief Notifies that a message was stored in the kernel log.
+ *
+ * @details Notifies that a message was stored in the kernel log and wakes up
+ * the log drain thread if it is waiting.
+ */
+static void _console_drain_notify_log(void);
+
+/**
+ * @brief Returns the identifier of the current CPU for the kernel log.
+ *
+ * @details Returns the identifier of the current CPU for the kernel log.
+ *
+ * @return The identifier of the current CPU.
+ */
+static uint32_t _console_drain_get_cpu_id(void);
+
+/**
+ * @brief Notifies that output was queued for a console driver.
+ *
+ * @details Notifies that output was queued for a console driver and wakes up
+ * its drain thread if it is waiting. The interrupts are disabled directly, the
+ * interrupt manager could output and notify again.
+ *
+ * @param[in] sink The registration index of the console driver.
+ */
+static void _console_drain_notify(const uint32_t sink);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void* _console_drain_routine(void* args)
+{
+    console_drainer_t* drainer;
+    uint32_t           sink;
+    uint32_t           int_state;
+    OS_RETURN_E        err;
+
+    sink    = (uint32_t)(uintptr_t)args;
+    drainer = &drainers[sink];
+
+    while(TRUE)
+    {
+        int_state = _cpu_get_interrupt_state();
+        _cpu_clear_interrupt();
+        KERNEL_SPINLOCK_LOCK(drainer->lock);
+
+        while(drainer->pending == FALSE)
+        {
+            /* The wait releases the lock once the thread is waiting */
+            drainer->waiter = drainer->thread;
+            err = scheduler_wait_thread(THREAD_WAIT_TYPE_IO, &drainer->lock);
+            KERNEL_SPINLOCK_LOCK(drainer->lock);
+            if(err != OS_NO_ERR)
+            {
+                drainer->waiter = NULL;
+                break;
+            }
+        }
+        drainer->pending = FALSE;
+
+        KERNEL_SPINLOCK_UNLOCK(drainer->lock);
+        if(int_state != 0)
+        {
+            _cpu_set_interrupt();
+        }
+
+        if(sink == CONSOLE_DRAIN_LOG_INDEX)
+        {
+            kernel_output_drain_log();
+        }
+        else
+        {
+            console_drain_sink(sink);
+        }
+    }
+
+    return NULL;
+}
+
+static OS_RETURN_E _console_drain_create(const uint32_t index,
+                                         const char* name)
+{
+    OS_RETURN_E err;
+
+    drainers[index].waiter  = NULL;
+    drainers[index].pending = TRUE;
+    KERNEL_SPINLOCK_INIT(drainers[index].lock);
+
+    err = scheduler_create_kernel_thread(&drainers[index].thread,
+                                         CONSOLE_DRAIN_THREAD_PRIORITY,
+                                         name,
+                                         _console_drain_routine,
+                                         (void*)(uintptr_t)index);
+    if(err != OS_NO_ERR)
+    {
+        drainers[index].thread = NULL;
+    }
+
+    return err;
+}
+
+static void _console_drain_notify(const uint32_t sink)
+{
+    console_drainer_t* drainer;
+    kernel_thread_t*   waiter;
+    uint32_t           int_state;
+
+    drainer = &drainers[sink];
+
+    int_state = _cpu_get_interrupt_state();
+    _cpu_clear_interrupt();
+    KERNEL_SPINLOCK_LOCK(drainer->lock);
+
+    drainer->pending = TRUE;
+    waiter           = drainer->waiter;
+    drainer->waiter  = NULL;
+
+    KERNEL_SPINLOCK_UNLOCK(drainer->lock);
+    if(int_state != 0)
+    {
+        _cpu_set_interrupt();
+    }
+
+    if(waiter != NULL)
+    {
+        (void)scheduler_wakeup_thread(waiter);
+    }
+}
+
+static void _console_drain_notify_log(void)
+{
+    _console_drain_notify(CONSOLE_DRAIN_LOG_INDEX);
+}
+
+static uint32_t _console_drain_get_cpu_id(void)
+{
+    uint32_t int_state;
+    uint32_t cpu_id;
+
+    /* A migration only stores the message in another CPU log ring */
+    int_state = _cpu_get_interrupt_state();
+    _cpu_clear_interrupt();
+    cpu_id = scheduler_get_current_cpu_id();
+    if(int_state != 0)
+    {
+        _cpu_set_interrupt();
+    }
+
+    return cpu_id;
+}
+
+OS_RETURN_E console_drain_init(void)
+{
+    OS_RETURN_E         err;
+    uint32_t            sink_count;
+    uint32_t            i;
+    kernel_log_driver_t log_driver;
+
+    if(drain_initialized == TRUE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+    drain_initialized = TRUE;
+
+    sink_count = console_get_sink_count();
+    for(i = 0; i < sink_count; ++i)
+    {
+        err = _console_drain_create(i, CONSOLE_DRAIN_THREAD_NAME);
+        if(err != OS_NO_ERR)
+        {
+            return err;
+        }
+
+        err = console_enable_sink_queue(i, _console_drain_notify);
+        if(err != OS_NO_ERR)
+        {
+            return err;
+        }
+    }
+
+    /* The kernel messages are now rendered by the log drain thread */
+    err = _console_drain_create(CONSOLE_DRAIN_LOG_INDEX,
+                                CONSOLE_DRAIN_LOG_THREAD_NAME);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    log_driver.get_cpu_id  = _console_drain_get_cpu_id;
+    log_driver.get_time_ns = time_get_current_uptime_nano;
+    log_driver.notify      = _console_drain_notify_log;
+    err = kernel_output_enable_log(&log_driver);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    KERNEL_DEBUG(CONSOLE_DRAIN_DEBUG_ENABLED, MODULE_NAME,
+                 "Console drain initialized for %d drivers", sink_count);
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,518 @@
+/*******************************************************************************
+ * @file crash_dump.c
+ *
+ * @see crash_dump.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's panic crash record.
+ *
+ * @details Kernel's panic crash record. The record is written in place in the
+ * KERNEL_CRASH_DUMP region, without lock nor allocation as the panicking
+ * context cannot be trusted. The magic is written last, a record interrupted
+ * by a reset is never exported.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* Memory manipulation */
+#include <cpu.h>            /* CPU management */
+#include <cpu_features.h>   /* CPU features alternatives */
+#include <scheduler.h>      /* Threads walk */
+#include <stack_trace.h>    /* Stack walker */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <tracing.h>        /* Kernel tracing */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <crash_dump.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief FNV-1a 32 bits offset basis. */
+#define CRASH_DUMP_FNV_BASIS 0x811C9DC5
+
+/** @brief FNV-1a 32 bits prime. */
+#define CRASH_DUMP_FNV_PRIME 0x01000193
+
+/** @brief Offset of the checksummed content in the record. */
+#define CRASH_DUMP_CONTENT_OFFSET offsetof(crash_dump_record_t, crash_count)
+
+/** @brief Number of characters of the panic screen exported per line. */
+#define CRASH_DUMP_TEXT_LINE_SIZE 128
+
+/** @brief Number of words exported per line. */
+#define CRASH_DUMP_WORDS_PER_LINE 8
+
+/** @brief Recording state, no panic recorded yet. */
+#define CRASH_DUMP_STATE_IDLE 0
+
+/** @brief Recording state, a panic is being recorded. */
+#define CRASH_DUMP_STATE_RECORDING 1
+
+/** @brief Recording state, the panic record is sealed. */
+#define CRASH_DUMP_STATE_SEALED 2
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/** @brief Crash record region base, defined by the linker. */
+extern uint8_t _KERNEL_CRASH_DUMP_BASE[];
+
+/** @brief Crash record region size, defined by the linker. */
+extern int8_t _KERNEL_CRASH_DUMP_SIZE;
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The crash record, at the base of its region. */
+static crash_dump_record_t* const crash_record =
+    (crash_dump_record_t*)_KERNEL_CRASH_DUMP_BASE;
+
+/** @brief Tells if the previous boot left a crash record. */
+static bool_t crash_found = FALSE;
+
+/** @brief Panic recording state. */
+static uint32_t crash_state = CRASH_DUMP_STATE_IDLE;
+
+/** @brief CPU recording the panic. */
+static uint32_t crash_cpu_id;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Computes the checksum of the record content.
+ *
+ * @param[in] record The record.
+ *
+ * @return The FNV-1a hash of the record, from crash_count to the end.
+ */
+static uint32_t _crash_dump_checksum(const crash_dump_record_t* record);
+
+/**
+ * @brief Tells if a record is complete and intact.
+ *
+ * @param[in] record The record.
+ *
+ * @return TRUE if the record is complete, exported or not, FALSE otherwise.
+ */
+static bool_t _crash_dump_is_valid(const crash_dump_record_t* record);
+
+/**
+ * @brief Copies a string in a record field.
+ *
+ * @details Copies a string in a record field, the string is truncated to the
+ * field and terminated.
+ *
+ * @param[out] field The record field.
+ * @param[in] string The string to copy, NULL for an empty string.
+ * @param[in] size The size of the field.
+ */
+static void _crash_dump_copy_string(char* field,
+                                    const char* string,
+                                    const size_t size);
+
+/**
+ * @brief Appends the rendered kernel output to the record text.
+ *
+ * @param[in] text The rendered text.
+ */
+static void _crash_dump_capture(const char* text);
+
+/**
+ * @brief Adds a thread state to the record.
+ *
+ * @param[in] thread The thread.
+ * @param[in, out] args The record.
+ */
+static void _crash_dump_add_thread(const kernel_thread_t* thread, void* args);
+
+/**
+ * @brief Outputs a memory area as hexadecimal words.
+ *
+ * @param[in] prefix The prefix of each line.
+ * @param[in] words The words to output.
+ * @param[in] count The number of words.
+ */
+static void _crash_dump_export_words(const char* prefix,
+                                     const uint32_t* words,
+                                     const uint32_t count);
+
+/**
+ * @brief Outputs a crash record on the kernel output.
+ *
+ * @param[in] record The record.
+ */
+static void _crash_dump_export(const crash_dump_record_t* record);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static uint32_t _crash_dump_checksum(const crash_dump_record_t* record)
+{
+    const uint8_t* content;
+    uint32_t       hash;
+    size_t         i;
+
+    content = (const uint8_t*)record;
+    hash    = CRASH_DUMP_FNV_BASIS;
+    for(i = CRASH_DUMP_CONTENT_OFFSET; i < sizeof(crash_dump_record_t); ++i)
+    {
+        hash = (hash ^ content[i]) * CRASH_DUMP_FNV_PRIME;
+    }
+
+    return hash;
+}
+
+static bool_t _crash_dump_is_valid(const crash_dump_record_t* record)
+{
+    if(record->magic != CRASH_DUMP_MAGIC &&
+       record->magic != CRASH_DUMP_MAGIC_EXPORTED)
+    {
+        return FALSE;
+    }
+    if(record->version != CRASH_DUMP_VERSION ||
+       record->size != sizeof(crash_dump_record_t))
+    {
+        return FALSE;
+    }
+
+    return _crash_dump_checksum(record) == record->checksum;
+}
+
+static void _crash_dump_copy_string(char* field,
+                                    const char* string,
+                                    const size_t size)
+{
+    if(string == NULL)
+    {
+        field[0] = 0;
+        return;
+    }
+
+    strncpy(field, string, size - 1);
+    field[size - 1] = 0;
+}
+
+static void _crash_dump_capture(const char* text)
+{
+    crash_dump_record_t* record;
+
+    record = crash_record;
+    while(*text != 0 && record->text_length < CRASH_DUMP_TEXT_SIZE)
+    {
+        record->text[record->text_length++] = *text++;
+    }
+}
+
+static void _crash_dump_add_thread(const kernel_thread_t* thread, void* args)
+{
+    crash_dump_record_t* record;
+    crash_dump_thread_t* entry;
+
+    record = args;
+    if(record->thread_count >= CRASH_DUMP_MAX_THREADS)
+    {
+        return;
+    }
+
+    entry             = &record->threads[record->thread_count++];
+    entry->tid        = thread->tid;
+    entry->state      = (uint8_t)thread->state;
+    entry->block_type = (uint8_t)thread->block_type;
+    entry->priority   = thread->priority;
+    entry->cpu_id     = (uint8_t)thread->ready_cpu_id;
+    entry->pc         = _cpu_get_saved_pc(&thread->v_cpu);
+    _crash_dump_copy_string(entry->name, thread->name, CRASH_DUMP_NAME_SIZE);
+}
+
+static void _crash_dump_export_words(const char* prefix,
+                                     const uint32_t* words,
+                                     const uint32_t count)
+{
+    uint32_t i;
+
+    for(i = 0; i < count; ++i)
+    {
+        if(i % CRASH_DUMP_WORDS_PER_LINE == 0)
+        {
+            kernel_printf("%s", prefix);
+        }
+        kernel_printf(" %08x", words[i]);
+        if(i % CRASH_DUMP_WORDS_PER_LINE == CRASH_DUMP_WORDS_PER_LINE - 1 ||
+           i == count - 1)
+        {
+            kernel_printf("\n");
+        }
+    }
+}
+
+static void _crash_dump_export(const crash_dump_record_t* record)
+{
+    const crash_dump_thread_t* thread;
+    const char*                symbol;
+    uintptr_t                  address;
+    char                       line[CRASH_DUMP_TEXT_LINE_SIZE];
+    uint32_t                   length;
+    uint32_t                   i;
+
+    kernel_printf("#CRASH_START %u\n", record->crash_count);
+    kernel_printf("#CRASH_CAUSE %u %u %u %d %llu\n",
+                  record->panic_code, record->int_id, record->cpu_id,
+                  record->tid, record->tsc);
+    kernel_printf("#CRASH_PANIC [%s] %s\n", record->module, record->message);
+    kernel_printf("#CRASH_FILE %s:%u\n", record->file, record->line);
+
+    if(record->stack_depth != 0)
+    {
+        kernel_printf("#CRASH_STACK ");
+        for(i = 0; i < record->stack_depth; ++i)
+        {
+            /* Past the faulting instruction, the addresses are return
+             * addresses that might be the first byte after their function
+             */
+            address = (uintptr_t)record->stack[i];
+            symbol  = stack_trace_lookup(address - (i != 0), NULL);
+            if(symbol != NULL)
+            {
+                kernel_printf("%s%s", (i != 0) ? ";" : "", symbol);
+            }
+            else
+            {
+                kernel_printf("%s0x%p", (i != 0) ? ";" : "", address);
+            }
+        }
+        kernel_printf("\n");
+    }
+
+    for(i = 0; i < record->thread_count; ++i)
+    {
+        thread = &record->threads[i];
+        kernel_printf("#CRASH_THREAD %d %s %u %u %u %u 0x%p\n",
+                      thread->tid, thread->name, thread->state,
+                      thread->block_type, thread->priority, thread->cpu_id,
+                      (uintptr_t)thread->pc);
+    }
+
+    _crash_dump_export_words("#CRASH_VCPU", (const uint32_t*)&record->vcpu,
+                             sizeof(virtual_cpu_t) / sizeof(uint32_t));
+
+#if CRASH_DUMP_EXPORT_TRACE
+    if(record->trace_size != 0)
+    {
+        _crash_dump_export_words("#CRASH_TRACE", record->trace,
+                                 record->trace_size / sizeof(uint32_t));
+    }
+#endif
+
+    /* The panic screen is exported line per line, long lines are split */
+    length = 0;
+    for(i = 0; i < record->text_length; ++i)
+    {
+        if(record->text[i] != '\n')
+        {
+            line[length++] = record->text[i];
+        }
+        if(record->text[i] == '\n' ||
+           length == CRASH_DUMP_TEXT_LINE_SIZE - 1 ||
+           i == record->text_length - 1)
+        {
+            line[length] = 0;
+            kernel_printf("#CRASH_TEXT %s\n", line);
+            length = 0;
+        }
+    }
+
+    kernel_printf("#CRASH_END\n");
+}
+
+OS_RETURN_E crash_dump_init(void)
+{
+    if(sizeof(crash_dump_record_t) > (uintptr_t)&_KERNEL_CRASH_DUMP_SIZE)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    if(crash_record->magic != CRASH_DUMP_MAGIC ||
+       _crash_dump_is_valid(crash_record) == FALSE)
+    {
+        return OS_NO_ERR;
+    }
+
+    crash_found = TRUE;
+    _crash_dump_export(crash_record);
+
+    /* The content is not modified, the crash count still chains */
+    __atomic_store_n(&crash_record->magic, CRASH_DUMP_MAGIC_EXPORTED,
+                     __ATOMIC_RELEASE);
+
+    return OS_NO_ERR;
+}
+
+const crash_dump_record_t* crash_dump_get_record(void)
+{
+    return (crash_found == TRUE) ? crash_record : NULL;
+}
+
+void crash_dump_start(const kernel_thread_t* thread,
+                      const uint32_t panic_code,
+                      const char* module,
+                      const char* msg,
+                      const char* file,
+                      const uint32_t line)
+{
+    crash_dump_record_t* record;
+    uintptr_t            addresses[CRASH_DUMP_STACK_DEPTH];
+    uintptr_t            frame;
+    uint32_t             crash_count;
+    uint32_t             cpu_id;
+    uint32_t             state;
+    uint64_t             tsc;
+    uint32_t             i;
+
+    if(sizeof(crash_dump_record_t) > (uintptr_t)&_KERNEL_CRASH_DUMP_SIZE ||
+       thread == NULL)
+    {
+        return;
+    }
+
+    /* The scheduler CPU data might not be set, as for the trace rings the
+     * CPU is identified by the TSC auxiliary value
+     */
+    if(CPU_FEATURE_STATIC(CPU_FEATURE_RDTSCP))
+    {
+        tsc = _cpu_rdtscp(&cpu_id);
+    }
+    else
+    {
+        tsc    = _cpu_rdtsc();
+        cpu_id = 0;
+    }
+
+    state = CRASH_DUMP_STATE_IDLE;
+    if(__atomic_compare_exchange_n(&crash_state, &state,
+                                   CRASH_DUMP_STATE_RECORDING, FALSE,
+                                   __ATOMIC_ACQUIRE,
+                                   __ATOMIC_RELAXED) == FALSE)
+    {
+        return;
+    }
+    crash_cpu_id = cpu_id;
+
+    record = crash_record;
+
+    /* Invalidate the previous record before its content is overwritten */
+    crash_count = 1;
+    if(_crash_dump_is_valid(record) == TRUE)
+    {
+        crash_count = record->crash_count + 1;
+    }
+    __atomic_store_n(&record->magic, 0, __ATOMIC_RELEASE);
+
+    memset((uint8_t*)record + CRASH_DUMP_CONTENT_OFFSET, 0,
+           sizeof(crash_dump_record_t) - CRASH_DUMP_CONTENT_OFFSET);
+    record->version     = CRASH_DUMP_VERSION;
+    record->size        = sizeof(crash_dump_record_t);
+    record->crash_count = crash_count;
+    record->panic_code  = panic_code;
+    record->int_id      = thread->v_cpu.int_context.int_id;
+    record->cpu_id      = cpu_id;
+    record->tid         = thread->tid;
+    record->line        = line;
+    record->tsc         = tsc;
+    _crash_dump_copy_string(record->module, module, CRASH_DUMP_NAME_SIZE);
+    _crash_dump_copy_string(record->message, msg, CRASH_DUMP_MESSAGE_SIZE);
+    _crash_dump_copy_string(record->file, file, CRASH_DUMP_FILE_SIZE);
+    memcpy(&record->vcpu, &thread->v_cpu, sizeof(virtual_cpu_t));
+
+    /* The trace starts at the interrupted instruction */
+    addresses[0]        = _cpu_get_saved_pc(&thread->v_cpu);
+    frame               = _cpu_get_saved_fp(&thread->v_cpu);
+    record->stack_depth = 1 + stack_trace_walk(frame, addresses + 1,
+                                               CRASH_DUMP_STACK_DEPTH - 1);
+    for(i = 0; i < record->stack_depth; ++i)
+    {
+        record->stack[i] = addresses[i];
+    }
+
+    scheduler_walk_threads(_crash_dump_add_thread, record);
+
+#ifdef _TRACING_ENABLED
+    record->trace_size = kernel_trace_copy_active_packet(cpu_id,
+                                                         record->trace,
+                                                         CRASH_DUMP_TRACE_SIZE);
+#endif
+
+    kernel_output_set_capture(_crash_dump_capture);
+}
+
+void crash_dump_end(void)
+{
+    crash_dump_record_t* record;
+    uint32_t             cpu_id;
+
+    if(__atomic_load_n(&crash_state, __ATOMIC_ACQUIRE) !=
+       CRASH_DUMP_STATE_RECORDING)
+    {
+        return;
+    }
+
+    /* A concurrent panic on another CPU must not seal the record, a nested
+     * panic on the recording CPU seals what was recorded
+     */
+    if(CPU_FEATURE_STATIC(CPU_FEATURE_RDTSCP))
+    {
+        _cpu_rdtscp(&cpu_id);
+    }
+    else
+    {
+        cpu_id = 0;
+    }
+    if(cpu_id != crash_cpu_id)
+    {
+        return;
+    }
+
+    kernel_output_set_capture(NULL);
+
+    record           = crash_record;
+    record->checksum = _crash_dump_checksum(record);
+    __atomic_store_n(&record->magic, CRASH_DUMP_MAGIC, __ATOMIC_RELEASE);
+    __atomic_store_n(&crash_state, CRASH_DUMP_STATE_SEALED, __ATOMIC_RELEASE);
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
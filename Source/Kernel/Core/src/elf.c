@@ -0,0 +1,1289 @@
+/*******************************************************************************
+ * @file elf.c
+ *
+ * @see elf.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's ELF programs loader.
+ *
+ * @details Kernel's ELF programs loader. The parsed programs are kept in a
+ * list while a process runs them, keyed by the address of their file data.
+ * The page faults of a process are serialized by its lock, with the
+ * interrupts disabled: the private frames are filled through the kernel
+ * linear mapping and mapped once filled, a new mapping needs no TLB
+ * invalidation. A page is mapped on the file frame when the segment is read
+ * only, the page is fully backed by the file data and the data is page
+ * aligned in memory, which the initial ram disk creation ensures. The pages
+ * holding no file data are mapped on a single zero frame when first read,
+ * copy-on-write in the writable segments. The private frames are reference
+ * counted: the clones of a process share them copy-on-write and a write
+ * fault copies the page unless the process holds the last reference.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* Memory manipulation */
+#include <cpu.h>            /* CPU ELF class and fault address */
+#include <cpu_interrupt.h>  /* Page fault line and error code */
+#include <interrupts.h>     /* Exception handlers */
+#include <panic.h>          /* Kernel panic */
+#include <critical.h>       /* Kernel critical sections and spinlocks */
+#include <ctrl_block.h>     /* Kernel threads */
+#include <memmgt.h>         /* Physical memory manager */
+#include <vmm.h>            /* Virtual memory manager */
+#include <vfs.h>            /* Virtual file system */
+#include <kheap.h>          /* Kernel heap */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <elf.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "ELF"
+
+/** @brief ELF file magic. */
+#define ELF_MAGIC      "\x7F" "ELF"
+/** @brief ELF file magic size. */
+#define ELF_MAGIC_SIZE 4
+
+/** @brief Size of the ELF identification bytes. */
+#define ELF_IDENT_SIZE    16
+/** @brief Identification byte of the file class. */
+#define ELF_IDENT_CLASS   4
+/** @brief Identification byte of the data encoding. */
+#define ELF_IDENT_DATA    5
+/** @brief Identification byte of the file version. */
+#define ELF_IDENT_VERSION 6
+
+/** @brief File class of the 32 bits programs. */
+#define ELF_CLASS_32 1
+/** @brief File class of the 64 bits programs. */
+#define ELF_CLASS_64 2
+
+/** @brief Data encoding: two's complement, little endian. */
+#define ELF_DATA_LSB 1
+
+/** @brief Current ELF version. */
+#define ELF_VERSION_CURRENT 1
+
+/** @brief File type of the executables. */
+#define ELF_TYPE_EXEC 2
+
+/** @brief Program header type: loadable segment. */
+#define ELF_PT_LOAD    1
+/** @brief Program header type: dynamic linking information. */
+#define ELF_PT_DYNAMIC 2
+/** @brief Program header type: program interpreter. */
+#define ELF_PT_INTERP  3
+
+/** @brief Segment flag: the segment is writable. */
+#define ELF_PF_W 0x2
+
+/** @brief Number of pages unmapped at once when a process is destroyed. */
+#define ELF_RELEASE_BATCH 16
+
+/** @brief First address of the user stack, the segments stay below. */
+#define ELF_STACK_START ((uintptr_t)KERNEL_USER_SPACE_END - VMM_PAGE_SIZE - \
+                         KERNEL_USER_STACK_SIZE)
+
+#if KERNEL_USER_STACK_SIZE % VMM_PAGE_SIZE != 0
+#error "The user stack size must be a multiple of the page size"
+#endif
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief ELF file header of the 32 bits programs. */
+typedef struct
+{
+    /** @brief Identification bytes. */
+    uint8_t ident[ELF_IDENT_SIZE];
+    /** @brief File type. */
+    uint16_t type;
+    /** @brief Machine of the program. */
+    uint16_t machine;
+    /** @brief File version. */
+    uint32_t version;
+    /** @brief Entry point. */
+    uint32_t entry;
+    /** @brief Program headers table offset. */
+    uint32_t phoff;
+    /** @brief Section headers table offset. */
+    uint32_t shoff;
+    /** @brief Machine flags. */
+    uint32_t flags;
+    /** @brief Size of the file header. */
+    uint16_t ehsize;
+    /** @brief Size of a program header. */
+    uint16_t phentsize;
+    /** @brief Number of program headers. */
+    uint16_t phnum;
+    /** @brief Size of a section header. */
+    uint16_t shentsize;
+    /** @brief Number of section headers. */
+    uint16_t shnum;
+    /** @brief Section names table index. */
+    uint16_t shstrndx;
+} __attribute__((packed)) elf32_header_t;
+
+/** @brief ELF file header of the 64 bits programs. */
+typedef struct
+{
+    /** @brief Identification bytes. */
+    uint8_t ident[ELF_IDENT_SIZE];
+    /** @brief File type. */
+    uint16_t type;
+    /** @brief Machine of the program. */
+    uint16_t machine;
+    /** @brief File version. */
+    uint32_t version;
+    /** @brief Entry point. */
+    uint64_t entry;
+    /** @brief Program headers table offset. */
+    uint64_t phoff;
+    /** @brief Section headers table offset. */
+    uint64_t shoff;
+    /** @brief Machine flags. */
+    uint32_t flags;
+    /** @brief Size of the file header. */
+    uint16_t ehsize;
+    /** @brief Size of a program header. */
+    uint16_t phentsize;
+    /** @brief Number of program headers. */
+    uint16_t phnum;
+    /** @brief Size of a section header. */
+    uint16_t shentsize;
+    /** @brief Number of section headers. */
+    uint16_t shnum;
+    /** @brief Section names table index. */
+    uint16_t shstrndx;
+} __attribute__((packed)) elf64_header_t;
+
+/** @brief ELF program header of the 32 bits programs. */
+typedef struct
+{
+    /** @brief Segment type. */
+    uint32_t type;
+    /** @brief Segment offset in the file. */
+    uint32_t offset;
+    /** @brief Segment virtual address. */
+    uint32_t vaddr;
+    /** @brief Segment physical address. */
+    uint32_t paddr;
+    /** @brief Segment size in the file. */
+    uint32_t filesz;
+    /** @brief Segment size in memory. */
+    uint32_t memsz;
+    /** @brief Segment flags. */
+    uint32_t flags;
+    /** @brief Segment alignment. */
+    uint32_t align;
+} __attribute__((packed)) elf32_program_header_t;
+
+/** @brief ELF program header of the 64 bits programs. */
+typedef struct
+{
+    /** @brief Segment type. */
+    uint32_t type;
+    /** @brief Segment flags. */
+    uint32_t flags;
+    /** @brief Segment offset in the file. */
+    uint64_t offset;
+    /** @brief Segment virtual address. */
+    uint64_t vaddr;
+    /** @brief Segment physical address. */
+    uint64_t paddr;
+    /** @brief Segment size in the file. */
+    uint64_t filesz;
+    /** @brief Segment size in memory. */
+    uint64_t memsz;
+    /** @brief Segment alignment. */
+    uint64_t align;
+} __attribute__((packed)) elf64_program_header_t;
+
+/** @brief Program header fields used by the loader, of any class. */
+typedef struct
+{
+    /** @brief Segment type. */
+    uint32_t type;
+    /** @brief Segment flags. */
+    uint32_t flags;
+    /** @brief Segment offset in the file. */
+    uint64_t offset;
+    /** @brief Segment virtual address. */
+    uint64_t vaddr;
+    /** @brief Segment size in the file. */
+    uint64_t filesz;
+    /** @brief Segment size in memory. */
+    uint64_t memsz;
+} elf_program_header_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The programs run by at least one process. */
+static elf_image_t* elf_images = NULL;
+
+/** @brief Protects the programs list and their reference counts. */
+static kernel_spinlock_t elf_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/** @brief The zero filled frame mapped by the pages read before written. */
+static uintptr_t elf_zero_frame;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Reads a program header of the CPU class.
+ *
+ * @param[in] image The program, its program headers table fits the file.
+ * @param[in] offset The offset of the program header in the file.
+ * @param[out] header The buffer receiving the program header fields.
+ */
+static void _elf_read_program_header(const elf_image_t* image,
+                                     const uint64_t offset,
+                                     elf_program_header_t* header);
+
+/**
+ * @brief Adds a loadable segment to a program.
+ *
+ * @param[in, out] image The program.
+ * @param[in] header The segment program header.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the program has too many segments or
+ * the segment shares a page with the previous one.
+ * - OS_ERR_CORRUPTED_DATA is returned if the segment exceeds the file or
+ * does not fit the user range.
+ */
+static OS_RETURN_E _elf_add_segment(elf_image_t* image,
+                                    const elf_program_header_t* header);
+
+/**
+ * @brief Parses the headers of a program.
+ *
+ * @param[in, out] image The program, its data and size are set.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the file is not an executable of the
+ * CPU or the program is not supported.
+ * - OS_ERR_CORRUPTED_DATA is returned if the file is not a valid ELF file.
+ */
+static OS_RETURN_E _elf_parse(elf_image_t* image);
+
+/**
+ * @brief Returns the parsed program of a file.
+ *
+ * @details Returns the program already parsed for the file data or parses
+ * it. The program reference count is incremented.
+ *
+ * @param[in] data The file data.
+ * @param[in] size The file size.
+ * @param[out] image The buffer receiving the program.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NO_MORE_MEMORY is returned if the program could not be allocated.
+ * - Any error returned by _elf_parse.
+ */
+static OS_RETURN_E _elf_get_image(const uint8_t* data,
+                                  const size_t size,
+                                  elf_image_t** image);
+
+/**
+ * @brief Releases a process reference on its program.
+ *
+ * @param[in, out] image The program, released with its last reference.
+ */
+static void _elf_release_image(elf_image_t* image);
+
+/**
+ * @brief Returns the segment of a process containing an address.
+ *
+ * @param[in] process The process.
+ * @param[in] address The address.
+ *
+ * @return The segment, NULL if no segment contains the address.
+ */
+static const elf_segment_t* _elf_find_segment(const elf_process_t* process,
+                                              const uintptr_t address);
+
+/**
+ * @brief Returns the file frame a segment page maps to.
+ *
+ * @param[in] image The program of the segment.
+ * @param[in] segment The segment.
+ * @param[in] page The page, in the segment.
+ * @param[out] phys The buffer receiving the physical address of the frame.
+ *
+ * @return TRUE if the page maps the file frame, FALSE if it maps a private
+ * frame.
+ */
+static bool_t _elf_get_shared_frame(const elf_image_t* image,
+                                    const elf_segment_t* segment,
+                                    const uintptr_t page,
+                                    uintptr_t* phys);
+
+/**
+ * @brief Returns the linear mapping address of a frame.
+ *
+ * @details Maps the frame at its linear mapping address when the boot
+ * mapping does not cover it. The mapping is kept, a new mapping needs no TLB
+ * invalidation.
+ *
+ * @param[in] frame The physical address of the frame.
+ * @param[out] address The buffer receiving the frame address.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the frame is out of the linear
+ * mapping or its address maps another physical address.
+ * - Any error returned by vmm_map.
+ */
+static OS_RETURN_E _elf_get_frame_address(const uintptr_t frame,
+                                          uint8_t** address);
+
+/**
+ * @brief Maps a segment page of a process on a private frame.
+ *
+ * @details Fills a new frame with the file data of the page, zeroed after
+ * the segment file data, and maps it.
+ *
+ * @param[in, out] process The process.
+ * @param[in] segment The segment.
+ * @param[in] page The page, in the segment.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - Any error returned by memmgt_alloc_frames, _elf_get_frame_address or
+ * vmm_space_map.
+ */
+static OS_RETURN_E _elf_map_private(elf_process_t* process,
+                                    const elf_segment_t* segment,
+                                    const uintptr_t page);
+
+/**
+ * @brief Maps a segment page of a process on the zero frame.
+ *
+ * @details The page is copy-on-write in the writable segments.
+ *
+ * @param[in, out] process The process.
+ * @param[in] segment The segment, the page holds none of its file data.
+ * @param[in] page The page, in the segment.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - Any error returned by vmm_space_map.
+ */
+static OS_RETURN_E _elf_map_zero(elf_process_t* process,
+                                 const elf_segment_t* segment,
+                                 const uintptr_t page);
+
+/**
+ * @brief Resolves a write to a copy-on-write page of a process.
+ *
+ * @details Copies the page to a new private frame, the reference to the
+ * previous frame is then dropped. A private frame whose last reference is
+ * held by the process is made writable in place.
+ *
+ * @param[in, out] process The process.
+ * @param[in] page The page.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered, or if the page is not
+ * copy-on-write anymore.
+ * - Any error returned by vmm_space_get_cow_frame, memmgt_alloc_frames,
+ * _elf_get_frame_address or vmm_space_resolve_cow.
+ */
+static OS_RETURN_E _elf_copy_on_write(elf_process_t* process,
+                                      const uintptr_t page);
+
+/**
+ * @brief Faults in a page of a process.
+ *
+ * @param[in, out] process The process.
+ * @param[in] address The faulting address.
+ * @param[in] error The page fault error code.
+ *
+ * @return TRUE if the page was mapped and the access can be retried, FALSE
+ * if the address is in no segment, the access is not allowed or the page
+ * could not be mapped.
+ */
+static bool_t _elf_handle_fault(elf_process_t* process,
+                                const uintptr_t address,
+                                const uint32_t error);
+
+/**
+ * @brief Page fault exception handler.
+ *
+ * @details Faults in the page of the process of the current thread, raises a
+ * kernel panic when the fault cannot be handled.
+ *
+ * @param[in] curr_thread The current thread.
+ */
+static void _elf_page_fault_handler(kernel_thread_t* curr_thread);
+
+/**
+ * @brief Releases the pages of a process segment.
+ *
+ * @details Unmaps the mapped pages of the segment, the references to the
+ * private frames are dropped once unmapped.
+ *
+ * @param[in, out] process The process.
+ * @param[in] segment The segment.
+ */
+static void _elf_release_segment(elf_process_t* process,
+                                 const elf_segment_t* segment);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void _elf_read_program_header(const elf_image_t* image,
+                                     const uint64_t offset,
+                                     elf_program_header_t* header)
+{
+    elf32_program_header_t header32;
+    elf64_program_header_t header64;
+
+    /* The file data alignment is not guaranteed */
+    if(CPU_ELF_CLASS == ELF_CLASS_64)
+    {
+        memcpy(&header64, image->data + offset, sizeof(header64));
+        header->type   = header64.type;
+        header->flags  = header64.flags;
+        header->offset = header64.offset;
+        header->vaddr  = header64.vaddr;
+        header->filesz = header64.filesz;
+        header->memsz  = header64.memsz;
+    }
+    else
+    {
+        memcpy(&header32, image->data + offset, sizeof(header32));
+        header->type   = header32.type;
+        header->flags  = header32.flags;
+        header->offset = header32.offset;
+        header->vaddr  = header32.vaddr;
+        header->filesz = header32.filesz;
+        header->memsz  = header32.memsz;
+    }
+}
+
+static OS_RETURN_E _elf_add_segment(elf_image_t* image,
+                                    const elf_program_header_t* header)
+{
+    elf_segment_t* segment;
+    uintptr_t      start;
+    uintptr_t      end;
+
+    if(header->filesz > header->memsz ||
+       header->offset > image->size ||
+       header->filesz > image->size - header->offset ||
+       (header->vaddr - header->offset) % VMM_PAGE_SIZE != 0)
+    {
+        return OS_ERR_CORRUPTED_DATA;
+    }
+    if(header->vaddr < (uintptr_t)KERNEL_USER_SPACE_START ||
+       header->vaddr >= ELF_STACK_START ||
+       header->memsz > ELF_STACK_START - header->vaddr)
+    {
+        return OS_ERR_CORRUPTED_DATA;
+    }
+
+    /* The pages of a segment only belong to it */
+    start = (uintptr_t)header->vaddr & ~(uintptr_t)(VMM_PAGE_SIZE - 1);
+    end   = ((uintptr_t)(header->vaddr + header->memsz) + VMM_PAGE_SIZE - 1) &
+            ~(uintptr_t)(VMM_PAGE_SIZE - 1);
+    if(image->segment_count == ELF_MAX_SEGMENTS ||
+       (image->segment_count != 0 &&
+        start < image->segments[image->segment_count - 1].end))
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    segment              = &image->segments[image->segment_count];
+    segment->start       = start;
+    segment->end         = end;
+    segment->file_offset = (size_t)header->offset -
+                           ((uintptr_t)header->vaddr - start);
+    segment->flags       = VMM_FLAG_USER;
+    if((header->flags & ELF_PF_W) != 0)
+    {
+        segment->flags |= VMM_FLAG_WRITE;
+    }
+
+    /* The zero filled segments never read the file */
+    if(header->filesz != 0)
+    {
+        segment->data_end = (uintptr_t)(header->vaddr + header->filesz);
+    }
+    else
+    {
+        segment->data_end = start;
+    }
+
+    ++image->segment_count;
+
+    return OS_NO_ERR;
+}
+
+static OS_RETURN_E _elf_parse(elf_image_t* image)
+{
+    elf32_header_t       header32;
+    elf64_header_t       header64;
+    elf_program_header_t program_header;
+    uint64_t             table_offset;
+    uint64_t             entry_point;
+    uint32_t             entry_size;
+    uint32_t             entry_count;
+    uint32_t             type;
+    uint32_t             machine;
+    uint32_t             i;
+    OS_RETURN_E          err;
+
+    if(image->size < ELF_IDENT_SIZE ||
+       memcmp(image->data, ELF_MAGIC, ELF_MAGIC_SIZE) != 0 ||
+       image->data[ELF_IDENT_VERSION] != ELF_VERSION_CURRENT)
+    {
+        return OS_ERR_CORRUPTED_DATA;
+    }
+    if(image->data[ELF_IDENT_CLASS] != CPU_ELF_CLASS ||
+       image->data[ELF_IDENT_DATA] != ELF_DATA_LSB)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    if(CPU_ELF_CLASS == ELF_CLASS_64)
+    {
+        if(image->size < sizeof(header64))
+        {
+            return OS_ERR_CORRUPTED_DATA;
+        }
+        memcpy(&header64, image->data, sizeof(header64));
+        type         = header64.type;
+        machine      = header64.machine;
+        entry_point  = header64.entry;
+        table_offset = header64.phoff;
+        entry_size   = header64.phentsize;
+        entry_count  = header64.phnum;
+        if(entry_size != sizeof(elf64_program_header_t))
+        {
+            return OS_ERR_CORRUPTED_DATA;
+        }
+    }
+    else
+    {
+        if(image->size < sizeof(header32))
+        {
+            return OS_ERR_CORRUPTED_DATA;
+        }
+        memcpy(&header32, image->data, sizeof(header32));
+        type         = header32.type;
+        machine      = header32.machine;
+        entry_point  = header32.entry;
+        table_offset = header32.phoff;
+        entry_size   = header32.phentsize;
+        entry_count  = header32.phnum;
+        if(entry_size != sizeof(elf32_program_header_t))
+        {
+            return OS_ERR_CORRUPTED_DATA;
+        }
+    }
+
+    if(type != ELF_TYPE_EXEC || machine != CPU_ELF_MACHINE)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+    if(table_offset > image->size ||
+       (uint64_t)entry_count * entry_size > image->size - table_offset)
+    {
+        return OS_ERR_CORRUPTED_DATA;
+    }
+
+    image->segment_count = 0;
+    for(i = 0; i < entry_count; ++i)
+    {
+        _elf_read_program_header(image, table_offset + i * entry_size,
+                                 &program_header);
+
+        /* The programs needing an interpreter are dynamically linked */
+        if(program_header.type == ELF_PT_INTERP ||
+           program_header.type == ELF_PT_DYNAMIC)
+        {
+            return OS_ERR_NOT_SUPPORTED;
+        }
+        if(program_header.type != ELF_PT_LOAD || program_header.memsz == 0)
+        {
+            continue;
+        }
+
+        err = _elf_add_segment(image, &program_header);
+        if(err != OS_NO_ERR)
+        {
+            return err;
+        }
+    }
+
+    /* The entry point must be in a segment */
+    image->entry_point = (uintptr_t)entry_point;
+    for(i = 0; i < image->segment_count; ++i)
+    {
+        if(entry_point >= image->segments[i].start &&
+           entry_point < image->segments[i].end)
+        {
+            return OS_NO_ERR;
+        }
+    }
+
+    return OS_ERR_CORRUPTED_DATA;
+}
+
+static OS_RETURN_E _elf_get_image(const uint8_t* data,
+                                  const size_t size,
+                                  elf_image_t** image)
+{
+    elf_image_t* new_image;
+    elf_image_t* cursor;
+    uint32_t     int_state;
+    OS_RETURN_E  err;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(elf_lock, int_state);
+    for(cursor = elf_images; cursor != NULL; cursor = cursor->next)
+    {
+        if(cursor->data == data)
+        {
+            ++cursor->refcount;
+            KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(elf_lock, int_state);
+            *image = cursor;
+            return OS_NO_ERR;
+        }
+    }
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(elf_lock, int_state);
+
+    /* Parse outside of the lock, another load may parse the same program */
+    new_image = kmalloc(sizeof(elf_image_t));
+    if(new_image == NULL)
+    {
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+    new_image->data = data;
+    new_image->size = size;
+
+    err = _elf_parse(new_image);
+    if(err != OS_NO_ERR)
+    {
+        kfree(new_image);
+        return err;
+    }
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(elf_lock, int_state);
+    for(cursor = elf_images; cursor != NULL; cursor = cursor->next)
+    {
+        if(cursor->data == data)
+        {
+            ++cursor->refcount;
+            KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(elf_lock, int_state);
+            kfree(new_image);
+            *image = cursor;
+            return OS_NO_ERR;
+        }
+    }
+    new_image->refcount = 1;
+    new_image->next     = elf_images;
+    elf_images          = new_image;
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(elf_lock, int_state);
+
+    KERNEL_DEBUG(ELF_DEBUG_ENABLED, MODULE_NAME,
+                 "Parsed program 0x%p, %u segments, entry 0x%p",
+                 data, new_image->segment_count, new_image->entry_point);
+
+    *image = new_image;
+
+    return OS_NO_ERR;
+}
+
+static void _elf_release_image(elf_image_t* image)
+{
+    elf_image_t** link;
+    uint32_t      int_state;
+    bool_t        release;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(elf_lock, int_state);
+    release = (--image->refcount == 0);
+    if(release == TRUE)
+    {
+        link = &elf_images;
+        while(*link != image)
+        {
+            link = &(*link)->next;
+        }
+        *link = image->next;
+    }
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(elf_lock, int_state);
+
+    if(release == TRUE)
+    {
+        kfree(image);
+    }
+}
+
+static const elf_segment_t* _elf_find_segment(const elf_process_t* process,
+                                              const uintptr_t address)
+{
+    const elf_segment_t* segment;
+    uint32_t             i;
+
+    for(i = 0; i < process->image->segment_count; ++i)
+    {
+        segment = &process->image->segments[i];
+        if(address >= segment->start && address < segment->end)
+        {
+            return segment;
+        }
+    }
+
+    if(address >= process->stack.start && address < process->stack.end)
+    {
+        return &process->stack;
+    }
+
+    return NULL;
+}
+
+static bool_t _elf_get_shared_frame(const elf_image_t* image,
+                                    const elf_segment_t* segment,
+                                    const uintptr_t page,
+                                    uintptr_t* phys)
+{
+    const uint8_t* file_page;
+
+    if((segment->flags & VMM_FLAG_WRITE) != 0 ||
+       page + VMM_PAGE_SIZE > segment->data_end)
+    {
+        return FALSE;
+    }
+
+    file_page = image->data + segment->file_offset + (page - segment->start);
+    if(((uintptr_t)file_page & (VMM_PAGE_SIZE - 1)) != 0)
+    {
+        return FALSE;
+    }
+
+    return (vmm_get_physical((uintptr_t)file_page, phys) == OS_NO_ERR);
+}
+
+static OS_RETURN_E _elf_get_frame_address(const uintptr_t frame,
+                                          uint8_t** address)
+{
+    uintptr_t   virt;
+    uintptr_t   phys;
+    OS_RETURN_E err;
+
+    if((uint64_t)frame + VMM_PAGE_SIZE >
+       (uint64_t)KERNEL_VIRTUAL_ADDR_MAX - KERNEL_MEM_OFFSET)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    virt = frame + KERNEL_MEM_OFFSET;
+    err  = vmm_get_physical(virt, &phys);
+    if(err == OS_ERR_MEMORY_NOT_MAPPED)
+    {
+        err = vmm_map(virt, frame, VMM_PAGE_SIZE, VMM_FLAG_WRITE);
+    }
+    else if(err == OS_NO_ERR && phys != frame)
+    {
+        err = OS_ERR_NOT_SUPPORTED;
+    }
+
+    *address = (uint8_t*)virt;
+
+    return err;
+}
+
+static OS_RETURN_E _elf_map_private(elf_process_t* process,
+                                    const elf_segment_t* segment,
+                                    const uintptr_t page)
+{
+    uintptr_t   frame;
+    uint8_t*    address;
+    size_t      copy_size;
+    OS_RETURN_E err;
+
+    err = memmgt_alloc_frames(0, &frame);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    err = _elf_get_frame_address(frame, &address);
+    if(err == OS_NO_ERR)
+    {
+        copy_size = 0;
+        if(segment->data_end > page)
+        {
+            copy_size = segment->data_end - page;
+            if(copy_size > VMM_PAGE_SIZE)
+            {
+                copy_size = VMM_PAGE_SIZE;
+            }
+            memcpy(address, process->image->data + segment->file_offset +
+                   (page - segment->start), copy_size);
+        }
+        memset(address + copy_size, 0, VMM_PAGE_SIZE - copy_size);
+
+        err = vmm_space_map(process->space, page, frame, VMM_PAGE_SIZE,
+                            segment->flags | VMM_FLAG_PRIVATE);
+    }
+    if(err != OS_NO_ERR)
+    {
+        (void)memmgt_free_frames(frame, 0);
+        return err;
+    }
+
+    ++process->private_pages;
+
+    return OS_NO_ERR;
+}
+
+static OS_RETURN_E _elf_map_zero(elf_process_t* process,
+                                 const elf_segment_t* segment,
+                                 const uintptr_t page)
+{
+    uint32_t    flags;
+    OS_RETURN_E err;
+
+    flags = VMM_FLAG_USER;
+    if((segment->flags & VMM_FLAG_WRITE) != 0)
+    {
+        flags |= VMM_FLAG_COPY_ON_WRITE;
+    }
+
+    err = vmm_space_map(process->space, page, elf_zero_frame, VMM_PAGE_SIZE,
+                        flags);
+    if(err == OS_NO_ERR)
+    {
+        ++process->zero_pages;
+    }
+
+    return err;
+}
+
+static OS_RETURN_E _elf_copy_on_write(elf_process_t* process,
+                                      const uintptr_t page)
+{
+    uintptr_t   frame;
+    uintptr_t   copy;
+    uint8_t*    address;
+    uint8_t*    source;
+    OS_RETURN_E err;
+
+    /* Another thread of the process may have resolved the page */
+    err = vmm_space_get_cow_frame(process->space, page, &frame);
+    if(err == OS_ERR_UNAUTHORIZED_ACTION)
+    {
+        return OS_NO_ERR;
+    }
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    /* No other mapping can take a reference to the frame anymore */
+    if(frame != elf_zero_frame && memmgt_is_frame_shared(frame) == FALSE)
+    {
+        return vmm_space_resolve_cow(process->space, page, frame);
+    }
+
+    err = memmgt_alloc_frames(0, &copy);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    err = _elf_get_frame_address(copy, &address);
+    if(err == OS_NO_ERR)
+    {
+        if(frame == elf_zero_frame)
+        {
+            memset(address, 0, VMM_PAGE_SIZE);
+        }
+        else
+        {
+            err = _elf_get_frame_address(frame, &source);
+            if(err == OS_NO_ERR)
+            {
+                memcpy(address, source, VMM_PAGE_SIZE);
+            }
+        }
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = vmm_space_resolve_cow(process->space, page, copy);
+    }
+    if(err != OS_NO_ERR)
+    {
+        (void)memmgt_free_frames(copy, 0);
+        return err;
+    }
+
+    /* The TLB entries of the previous frame are invalidated */
+    if(frame == elf_zero_frame)
+    {
+        --process->zero_pages;
+        ++process->private_pages;
+    }
+    else
+    {
+        (void)memmgt_free_frames(frame, 0);
+    }
+
+    return OS_NO_ERR;
+}
+
+static bool_t _elf_handle_fault(elf_process_t* process,
+                                const uintptr_t address,
+                                const uint32_t error)
+{
+    const elf_segment_t* segment;
+    uintptr_t            page;
+    uintptr_t            phys;
+    OS_RETURN_E          err;
+
+    /* The faults on present pages are protection violations, except the
+     * writes to the copy-on-write pages of the writable segments
+     */
+    segment = _elf_find_segment(process, address);
+    if(segment == NULL ||
+       ((error & PAGE_FAULT_ERROR_WRITE) != 0 &&
+        (segment->flags & VMM_FLAG_WRITE) == 0) ||
+       ((error & PAGE_FAULT_ERROR_PRESENT) != 0 &&
+        (error & PAGE_FAULT_ERROR_WRITE) == 0))
+    {
+        return FALSE;
+    }
+
+    page = address & ~(uintptr_t)(VMM_PAGE_SIZE - 1);
+
+    KERNEL_SPINLOCK_LOCK(process->lock);
+
+    if((error & PAGE_FAULT_ERROR_PRESENT) != 0)
+    {
+        err = _elf_copy_on_write(process, page);
+    }
+    else if(vmm_space_get_physical(process->space, page, &phys) == OS_NO_ERR)
+    {
+        /* Another thread of the process faulted the page in */
+        err = OS_NO_ERR;
+    }
+    else if(_elf_get_shared_frame(process->image, segment, page,
+                                  &phys) == TRUE)
+    {
+        err = vmm_space_map(process->space, page, phys, VMM_PAGE_SIZE,
+                            segment->flags);
+        if(err == OS_NO_ERR)
+        {
+            ++process->shared_pages;
+        }
+    }
+    else if(page >= segment->data_end &&
+            (error & PAGE_FAULT_ERROR_WRITE) == 0)
+    {
+        err = _elf_map_zero(process, segment, page);
+    }
+    else
+    {
+        err = _elf_map_private(process, segment, page);
+    }
+
+    KERNEL_SPINLOCK_UNLOCK(process->lock);
+
+    KERNEL_DEBUG(ELF_DEBUG_ENABLED, MODULE_NAME,
+                 "Fault at 0x%p, error 0x%x, result %d", address, error, err);
+
+    return (err == OS_NO_ERR);
+}
+
+static void _elf_page_fault_handler(kernel_thread_t* curr_thread)
+{
+    uintptr_t address;
+    uint32_t  error;
+
+    /* The interrupts are disabled, no other fault replaced the address */
+    address = _cpu_get_fault_address();
+    error   = (uint32_t)curr_thread->v_cpu.int_context.error_code;
+
+    if(curr_thread->process == NULL ||
+       _elf_handle_fault(curr_thread->process, address, error) == FALSE)
+    {
+        panic_handler(curr_thread);
+    }
+}
+
+static void _elf_release_segment(elf_process_t* process,
+                                 const elf_segment_t* segment)
+{
+    uintptr_t frames[ELF_RELEASE_BATCH];
+    uintptr_t page;
+    uintptr_t batch_end;
+    uintptr_t phys;
+    uintptr_t shared;
+    uint32_t  count;
+    uint32_t  i;
+    bool_t    mapped;
+
+    for(page = segment->start; page < segment->end; page = batch_end)
+    {
+        batch_end = page + ELF_RELEASE_BATCH * VMM_PAGE_SIZE;
+        if(batch_end > segment->end)
+        {
+            batch_end = segment->end;
+        }
+
+        count  = 0;
+        mapped = FALSE;
+        for(i = 0; page + i * VMM_PAGE_SIZE < batch_end; ++i)
+        {
+            if(vmm_space_get_physical(process->space, page + i * VMM_PAGE_SIZE,
+                                      &phys) != OS_NO_ERR)
+            {
+                continue;
+            }
+            mapped = TRUE;
+            if(phys == elf_zero_frame)
+            {
+                continue;
+            }
+            if(_elf_get_shared_frame(process->image, segment,
+                                     page + i * VMM_PAGE_SIZE,
+                                     &shared) == FALSE ||
+               shared != phys)
+            {
+                frames[count++] = phys;
+            }
+        }
+
+        /* The frames are released once no TLB can reference them anymore */
+        if(mapped == TRUE)
+        {
+            (void)vmm_space_unmap(process->space, page, batch_end - page);
+        }
+        for(i = 0; i < count; ++i)
+        {
+            (void)memmgt_free_frames(frames[i], 0);
+        }
+    }
+}
+
+OS_RETURN_E elf_init(void)
+{
+    uint8_t*    address;
+    OS_RETURN_E err;
+
+    err = memmgt_alloc_frames(0, &elf_zero_frame);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+    err = _elf_get_frame_address(elf_zero_frame, &address);
+    if(err != OS_NO_ERR)
+    {
+        (void)memmgt_free_frames(elf_zero_frame, 0);
+        return err;
+    }
+    memset(address, 0, VMM_PAGE_SIZE);
+
+    return kernel_interrupt_register_exception_handler(PAGE_FAULT_LINE,
+                                                      _elf_page_fault_handler);
+}
+
+OS_RETURN_E elf_load(const char* path, elf_process_t** process)
+{
+    elf_process_t* new_process;
+    elf_image_t*   image;
+    vfs_file_t     file;
+    const void*    data;
+    OS_RETURN_E    err;
+
+    if(path == NULL || process == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    err = vfs_open(path, &file);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+    err = vfs_map(&file, &data);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    err = _elf_get_image(data, file.node.size, &image);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    new_process = kmalloc(sizeof(elf_process_t));
+    if(new_process == NULL)
+    {
+        _elf_release_image(image);
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+
+    err = vmm_space_create(&new_process->space);
+    if(err != OS_NO_ERR)
+    {
+        kfree(new_process);
+        _elf_release_image(image);
+        return err;
+    }
+
+    new_process->image = image;
+
+    new_process->stack.start       = ELF_STACK_START;
+    new_process->stack.end         = ELF_STACK_START + KERNEL_USER_STACK_SIZE;
+    new_process->stack.file_offset = 0;
+    new_process->stack.data_end    = ELF_STACK_START;
+    new_process->stack.flags       = VMM_FLAG_WRITE | VMM_FLAG_USER;
+    new_process->stack_top         = new_process->stack.end;
+
+    new_process->shared_pages  = 0;
+    new_process->private_pages = 0;
+    new_process->zero_pages    = 0;
+    KERNEL_SPINLOCK_INIT(new_process->lock);
+
+    KERNEL_DEBUG(ELF_DEBUG_ENABLED, MODULE_NAME,
+                 "Loaded %s, process 0x%p, entry 0x%p",
+                 path, new_process, image->entry_point);
+
+    *process = new_process;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E elf_clone(elf_process_t* process, elf_process_t** clone)
+{
+    elf_process_t* new_process;
+    uint32_t       int_state;
+    OS_RETURN_E    err;
+
+    if(process == NULL || clone == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    new_process = kmalloc(sizeof(elf_process_t));
+    if(new_process == NULL)
+    {
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+
+    /* The faults of the process threads wait until its pages are shared */
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(process->lock, int_state);
+    err = vmm_space_clone(process->space, &new_process->space);
+    new_process->shared_pages  = process->shared_pages;
+    new_process->private_pages = process->private_pages;
+    new_process->zero_pages    = process->zero_pages;
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(process->lock, int_state);
+
+    if(err != OS_NO_ERR)
+    {
+        kfree(new_process);
+        return err;
+    }
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(elf_lock, int_state);
+    ++process->image->refcount;
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(elf_lock, int_state);
+
+    new_process->image     = process->image;
+    new_process->stack     = process->stack;
+    new_process->stack_top = process->stack_top;
+    KERNEL_SPINLOCK_INIT(new_process->lock);
+
+    KERNEL_DEBUG(ELF_DEBUG_ENABLED, MODULE_NAME,
+                 "Cloned process 0x%p to 0x%p, %u private pages shared",
+                 process, new_process, new_process->private_pages);
+
+    *clone = new_process;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E elf_destroy(elf_process_t* process)
+{
+    uint32_t    i;
+    OS_RETURN_E err;
+
+    if(process == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    for(i = 0; i < process->image->segment_count; ++i)
+    {
+        _elf_release_segment(process, &process->image->segments[i]);
+    }
+    _elf_release_segment(process, &process->stack);
+    process->shared_pages  = 0;
+    process->private_pages = 0;
+    process->zero_pages    = 0;
+
+    err = vmm_space_destroy(process->space);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    KERNEL_DEBUG(ELF_DEBUG_ENABLED, MODULE_NAME,
+                 "Destroyed process 0x%p", process);
+
+    _elf_release_image(process->image);
+    kfree(process);
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
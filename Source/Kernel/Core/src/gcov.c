@@ -0,0 +1,425 @@
+/*******************************************************************************
+ * @file gcov.c
+ *
+ * @see gcov.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's execution profile runtime.
+ *
+ * @details Kernel's execution profile runtime. The profile information
+ * structures are the ones emitted by GCC 10 and later, the gcda files are
+ * written as libgcov does for a single run. Only the arcs counters are
+ * enabled, the PGO build disables the values profiling. The runtime itself is
+ * not instrumented.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _PGO_GENERATE_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <kernel_output.h>  /* Kernel output methods */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <gcov.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of counters kinds known by the compiler. */
+#if __GNUC__ >= 14
+#define GCOV_COUNTERS 9
+#elif __GNUC__ >= 10
+#define GCOV_COUNTERS 8
+#else
+#error "The profile runtime needs GCC 10 or later"
+#endif
+
+/**
+ * @brief Size unit of the records lengths, GCC 12 and later give the lengths
+ * in bytes instead of words.
+ */
+#if __GNUC__ >= 12
+#define GCOV_UNIT_SIZE 4
+#else
+#define GCOV_UNIT_SIZE 1
+#endif
+
+/** @brief gcda file magic number. */
+#define GCOV_DATA_MAGIC 0x67636461
+
+/** @brief Function record tag. */
+#define GCOV_TAG_FUNCTION 0x01000000
+
+/** @brief Function record length. */
+#define GCOV_TAG_FUNCTION_LENGTH (3 * GCOV_UNIT_SIZE)
+
+/** @brief Counters record tag of the counters kind KIND. */
+#define GCOV_TAG_FOR_COUNTER(KIND) (0x01A10000 + ((uint32_t)(KIND) << 17))
+
+/** @brief Object summary record tag. */
+#define GCOV_TAG_OBJECT_SUMMARY 0xA1000000
+
+/** @brief Object summary record length. */
+#define GCOV_TAG_SUMMARY_LENGTH (2 * GCOV_UNIT_SIZE)
+
+/** @brief Arcs counters kind. */
+#define GCOV_COUNTER_ARCS 0
+
+/** @brief Number of words output per data record. */
+#define GCOV_WORDS_PER_LINE 16
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Counters of one kind of a function. */
+typedef struct
+{
+    /** @brief Number of counters. */
+    uint32_t num;
+
+    /** @brief Counters values. */
+    int64_t* values;
+} gcov_ctr_info_t;
+
+/** @brief Function profile information. */
+typedef struct
+{
+    /** @brief Object owning the function, other objects may reference the
+     * discarded copies of a shared function.
+     */
+    const struct gcov_info* key;
+
+    /** @brief Function identifier. */
+    uint32_t ident;
+
+    /** @brief Function lines checksum. */
+    uint32_t lineno_checksum;
+
+    /** @brief Function control flow checksum. */
+    uint32_t cfg_checksum;
+
+    /** @brief Counters of the enabled kinds, in kinds order. */
+    gcov_ctr_info_t ctrs[];
+} gcov_fn_info_t;
+
+/** @brief Object profile information. */
+struct gcov_info
+{
+    /** @brief Profile format version. */
+    uint32_t version;
+
+    /** @brief Next registered object. */
+    struct gcov_info* next;
+
+    /** @brief Compilation time stamp. */
+    uint32_t stamp;
+
+#if __GNUC__ >= 12
+    /** @brief Object checksum. */
+    uint32_t checksum;
+#endif
+
+    /** @brief Output gcda file path. */
+    const char* filename;
+
+    /** @brief Merge routines of the counters kinds, NULL for the disabled
+     * kinds.
+     */
+    void (*merge[GCOV_COUNTERS])(int64_t*, uint32_t);
+
+    /** @brief Number of functions. */
+    uint32_t n_functions;
+
+    /** @brief Functions profile information. */
+    const gcov_fn_info_t* const* functions;
+};
+
+/** @brief Constructor routine. */
+typedef void (*gcov_ctor_t)(void);
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/** @brief Excludes a runtime routine from the instrumentation. */
+#define GCOV_NO_PROFILE __attribute__((no_profile_instrument_function))
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/** @brief Constructors table start, set by the linker. */
+extern const gcov_ctor_t _START_INIT_ARRAY_ADDR[];
+/** @brief Constructors table end, set by the linker. */
+extern const gcov_ctor_t _END_INIT_ARRAY_ADDR[];
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Registered objects list. */
+static struct gcov_info* gcov_list = NULL;
+
+/** @brief Tells if the constructors were run. */
+static bool_t gcov_registered = FALSE;
+
+/** @brief Data record being output. */
+static char gcov_line[GCOV_WORDS_PER_LINE * 9 + 1];
+
+/** @brief Number of words in the data record being output. */
+static uint32_t gcov_line_words = 0;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Outputs the data record being built.
+ */
+static void _gcov_flush(void);
+
+/**
+ * @brief Adds a word to the data record being built.
+ *
+ * @param[in] word The word to add.
+ */
+static void _gcov_write_u32(const uint32_t word);
+
+/**
+ * @brief Adds a 64 bits value to the data record being built, low word
+ * first.
+ *
+ * @param[in] value The value to add.
+ */
+static void _gcov_write_u64(const uint64_t value);
+
+/**
+ * @brief Gets the greatest arcs counter of the profile, used as the object
+ * summary maximum.
+ *
+ * @return The greatest arcs counter, saturated to 32 bits.
+ */
+static uint32_t _gcov_get_sum_max(void);
+
+/**
+ * @brief Outputs the gcda file of an object.
+ *
+ * @param[in] info The object profile information.
+ * @param[in] sum_max The profile greatest arcs counter.
+ */
+static void _gcov_dump_info(const struct gcov_info* info,
+                            const uint32_t sum_max);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+GCOV_NO_PROFILE
+static void _gcov_flush(void)
+{
+    if(gcov_line_words != 0)
+    {
+        gcov_line[gcov_line_words * 9 - 1] = 0;
+        kernel_printf(GCOV_STREAM_TAG "D %s\n", gcov_line);
+        gcov_line_words = 0;
+    }
+}
+
+GCOV_NO_PROFILE
+static void _gcov_write_u32(const uint32_t word)
+{
+    static const char digits[] = "0123456789abcdef";
+    char*             cursor;
+    int32_t           i;
+
+    cursor = &gcov_line[gcov_line_words * 9];
+    for(i = 7; i >= 0; --i)
+    {
+        cursor[7 - i] = digits[(word >> (i * 4)) & 0xF];
+    }
+    cursor[8] = ' ';
+
+    if(++gcov_line_words == GCOV_WORDS_PER_LINE)
+    {
+        _gcov_flush();
+    }
+}
+
+GCOV_NO_PROFILE
+static void _gcov_write_u64(const uint64_t value)
+{
+    _gcov_write_u32((uint32_t)value);
+    _gcov_write_u32((uint32_t)(value >> 32));
+}
+
+GCOV_NO_PROFILE
+static uint32_t _gcov_get_sum_max(void)
+{
+    const struct gcov_info* info;
+    const gcov_fn_info_t*   fn;
+    uint64_t                sum_max;
+    uint32_t                i;
+    uint32_t                j;
+
+    sum_max = 0;
+    for(info = gcov_list; info != NULL; info = info->next)
+    {
+        if(info->merge[GCOV_COUNTER_ARCS] == NULL)
+        {
+            continue;
+        }
+        for(i = 0; i < info->n_functions; ++i)
+        {
+            fn = info->functions[i];
+            if(fn == NULL || fn->key != info)
+            {
+                continue;
+            }
+            /* The arcs counters are the first enabled kind */
+            for(j = 0; j < fn->ctrs[0].num; ++j)
+            {
+                if((uint64_t)fn->ctrs[0].values[j] > sum_max)
+                {
+                    sum_max = fn->ctrs[0].values[j];
+                }
+            }
+        }
+    }
+
+    return (sum_max > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t)sum_max;
+}
+
+GCOV_NO_PROFILE
+static void _gcov_dump_info(const struct gcov_info* info,
+                            const uint32_t sum_max)
+{
+    const gcov_fn_info_t*  fn;
+    const gcov_ctr_info_t* ctr;
+    uint32_t               i;
+    uint32_t               j;
+    uint32_t               kind;
+
+    kernel_printf(GCOV_STREAM_TAG "F %s\n", info->filename);
+
+    _gcov_write_u32(GCOV_DATA_MAGIC);
+    _gcov_write_u32(info->version);
+    _gcov_write_u32(info->stamp);
+#if __GNUC__ >= 12
+    _gcov_write_u32(info->checksum);
+#endif
+
+    _gcov_write_u32(GCOV_TAG_OBJECT_SUMMARY);
+    _gcov_write_u32(GCOV_TAG_SUMMARY_LENGTH);
+    _gcov_write_u32(1);
+    _gcov_write_u32(sum_max);
+
+    for(i = 0; i < info->n_functions; ++i)
+    {
+        fn = info->functions[i];
+
+        /* Functions emitted by another object get an empty record */
+        _gcov_write_u32(GCOV_TAG_FUNCTION);
+        if(fn == NULL || fn->key != info)
+        {
+            _gcov_write_u32(0);
+            continue;
+        }
+        _gcov_write_u32(GCOV_TAG_FUNCTION_LENGTH);
+        _gcov_write_u32(fn->ident);
+        _gcov_write_u32(fn->lineno_checksum);
+        _gcov_write_u32(fn->cfg_checksum);
+
+        ctr = fn->ctrs;
+        for(kind = 0; kind < GCOV_COUNTERS; ++kind)
+        {
+            if(info->merge[kind] == NULL)
+            {
+                continue;
+            }
+
+            _gcov_write_u32(GCOV_TAG_FOR_COUNTER(kind));
+            _gcov_write_u32(ctr->num * 2 * GCOV_UNIT_SIZE);
+            for(j = 0; j < ctr->num; ++j)
+            {
+                _gcov_write_u64(ctr->values[j]);
+            }
+            ++ctr;
+        }
+    }
+
+    _gcov_flush();
+    kernel_printf(GCOV_STREAM_TAG "E\n");
+}
+
+GCOV_NO_PROFILE
+void __gcov_init(struct gcov_info* info)
+{
+    info->next = gcov_list;
+    gcov_list  = info;
+}
+
+GCOV_NO_PROFILE
+void __gcov_exit(void)
+{
+}
+
+GCOV_NO_PROFILE
+void __gcov_merge_add(int64_t* counters, uint32_t count)
+{
+    (void)counters;
+    (void)count;
+}
+
+GCOV_NO_PROFILE
+void gcov_dump(void)
+{
+    const gcov_ctor_t*      ctor;
+    const struct gcov_info* info;
+    uint32_t                sum_max;
+    uint32_t                count;
+
+    /* The profiling constructors only register the objects, they are run
+     * when the profile is first output.
+     */
+    if(gcov_registered == FALSE)
+    {
+        for(ctor = _START_INIT_ARRAY_ADDR; ctor < _END_INIT_ARRAY_ADDR; ++ctor)
+        {
+            (*ctor)();
+        }
+        gcov_registered = TRUE;
+    }
+
+    sum_max = _gcov_get_sum_max();
+
+    count = 0;
+    for(info = gcov_list; info != NULL; info = info->next)
+    {
+        _gcov_dump_info(info, sum_max);
+        ++count;
+    }
+
+    kernel_printf(GCOV_STREAM_TAG "DONE %u\n", count);
+}
+
+#endif /* #ifdef _PGO_GENERATE_ENABLED */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,346 @@
+/*******************************************************************************
+ * @file idle.c
+ *
+ * @see idle.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's CPU idle driver.
+ *
+ * @details Kernel's CPU idle driver. Each CPU publishes its idle state next to
+ * its wake flag. A CPU only monitors or polls its flag with interrupts
+ * disabled and goes back to the running state before it takes the pending
+ * interrupts: the wakers write the flag of the waiting CPUs and interrupt the
+ * others. The predicted idle time is the time left before the CPU timer
+ * interrupt, the C-state target residencies are conservative values shared
+ * by the recent Intel parts.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <cpu.h>            /* MONITOR, MWAIT and HLT */
+#include <cpu_features.h>   /* CPU features registry */
+#include <critical.h>       /* Kernel critical sections */
+#include <scheduler.h>      /* Current CPU and isolated CPUs */
+#include <time_mgt.h>       /* Next timer interrupt */
+#include <rcu.h>            /* Waiting RCU callbacks */
+#include <irqsoff.h>        /* Interrupts masked latency tracer */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <idle.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "IDLE"
+
+/** @brief CPUID MONITOR and MWAIT leaf. */
+#define IDLE_CPUID_MWAIT_LEAF 0x05
+
+/** @brief CPUID thermal and power management leaf. */
+#define IDLE_CPUID_POWER_LEAF 0x06
+
+/** @brief CPUID thermal and power management leaf EAX flag: the LAPIC timer
+ * runs at a constant rate in all the C-states.
+ */
+#define IDLE_CPUID_POWER_EAX_ARAT (1 << 2)
+
+/** @brief Number of MWAIT C-states, C1 to C7 in the MWAIT hints encoding. */
+#define IDLE_MWAIT_CSTATE_COUNT 7
+
+/** @brief Shift of the target C-state in the MWAIT hints. */
+#define IDLE_MWAIT_HINTS_CSTATE_SHIFT 4
+
+/** @brief MWAIT extension: interrupts break MWAIT when they are disabled. */
+#define IDLE_MWAIT_BREAK_ON_INTERRUPT 0x1
+
+/** @brief Number of pauses of a polling round, the pending interrupts are
+ * taken between two rounds.
+ */
+#define IDLE_POLL_SPINS 256
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Idle states of a CPU. */
+typedef enum
+{
+    /** @brief The CPU must be interrupted to be woken. */
+    IDLE_STATE_RUNNING = 0,
+    /** @brief The CPU waits in MWAIT on its wake flag. */
+    IDLE_STATE_MWAIT   = 1,
+    /** @brief The CPU polls its wake flag. */
+    IDLE_STATE_POLL    = 2
+} IDLE_STATE_E;
+
+/** @brief Idle driver data of a CPU. */
+typedef struct
+{
+    /** @brief Wake flag, the monitored word, set by the wakers. */
+    volatile uint32_t wake;
+
+    /** @brief CPU's idle state, an IDLE_STATE_E value. */
+    volatile uint32_t state;
+
+    /** @brief Usable MWAIT C-states, bit N is set when the C-state N + 1 is
+     * usable. 0 when MWAIT is not used.
+     */
+    uint32_t cstates;
+} __attribute__((aligned(CPU_CACHE_LINE_SIZE))) idle_cpu_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Idle driver data of each CPU. */
+static idle_cpu_t idle_cpus[MAX_CPU_COUNT];
+
+/** @brief Target residency of the MWAIT C-states in nanoseconds, the
+ * shortest idle time for which a C-state saves power.
+ */
+static const uint64_t idle_cstate_residency[IDLE_MWAIT_CSTATE_COUNT] = {
+    2000, 100000, 400000, 800000, 1000000, 5000000, 5000000
+};
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Selects the MWAIT hints for the predicted idle time.
+ *
+ * @details Selects the deepest usable C-state whose target residency fits in
+ * the time left before the CPU timer interrupt. An idle CPU without timer
+ * deadline goes to the deepest usable C-state.
+ *
+ * @param[in] cpu The current CPU idle data.
+ *
+ * @return The MWAIT hints.
+ */
+static uint32_t _idle_select_hints(const idle_cpu_t* cpu);
+
+/**
+ * @brief Waits in MWAIT on the current CPU wake flag.
+ *
+ * @details Waits in MWAIT on the current CPU wake flag. This function must be
+ * called with interrupts disabled, the pending interrupts break MWAIT.
+ *
+ * @param[in, out] cpu The current CPU idle data.
+ */
+static void _idle_mwait(idle_cpu_t* cpu);
+
+/**
+ * @brief Polls the current CPU wake flag.
+ *
+ * @details Polls the current CPU wake flag for one polling round. This
+ * function must be called with interrupts disabled.
+ *
+ * @param[in, out] cpu The current CPU idle data.
+ */
+static void _idle_poll(idle_cpu_t* cpu);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static uint32_t _idle_select_hints(const idle_cpu_t* cpu)
+{
+    uint64_t next;
+    uint64_t now;
+    uint64_t idle_ns;
+    uint32_t cstate;
+    uint32_t i;
+
+    next = time_get_next_deadline();
+    now  = time_get_ns();
+    if(next == 0)
+    {
+        idle_ns = UINT64_MAX;
+    }
+    else
+    {
+        idle_ns = (next > now) ? next - now : 0;
+    }
+
+    cstate = __builtin_ctz(cpu->cstates);
+    for(i = cstate + 1; i < IDLE_MWAIT_CSTATE_COUNT; ++i)
+    {
+        if((cpu->cstates & (1U << i)) != 0 &&
+           idle_cstate_residency[i] <= idle_ns)
+        {
+            cstate = i;
+        }
+    }
+
+    return cstate << IDLE_MWAIT_HINTS_CSTATE_SHIFT;
+}
+
+static void _idle_mwait(idle_cpu_t* cpu)
+{
+    uint32_t hints;
+
+    hints = _idle_select_hints(cpu);
+
+    /* The wakers read the state before writing the flag */
+    __atomic_store_n(&cpu->state, IDLE_STATE_MWAIT, __ATOMIC_SEQ_CST);
+    _cpu_monitor(&cpu->wake);
+    if(__atomic_load_n(&cpu->wake, __ATOMIC_ACQUIRE) == 0)
+    {
+        _cpu_mwait(hints, IDLE_MWAIT_BREAK_ON_INTERRUPT);
+    }
+}
+
+static void _idle_poll(idle_cpu_t* cpu)
+{
+    uint32_t i;
+
+    __atomic_store_n(&cpu->state, IDLE_STATE_POLL, __ATOMIC_SEQ_CST);
+    for(i = 0;
+        i < IDLE_POLL_SPINS &&
+        __atomic_load_n(&cpu->wake, __ATOMIC_ACQUIRE) == 0;
+        ++i)
+    {
+        _cpu_pause();
+    }
+}
+
+OS_RETURN_E idle_init_cpu(const uint32_t cpu_id)
+{
+    idle_cpu_t* cpu;
+    uint32_t    regs[4];
+    uint32_t    i;
+
+    if(cpu_id >= MAX_CPU_COUNT)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    cpu          = &idle_cpus[cpu_id];
+    cpu->wake    = 0;
+    cpu->state   = IDLE_STATE_RUNNING;
+    cpu->cstates = 0;
+
+    if(cpu_has_feature(CPU_FEATURE_MWAIT) == TRUE)
+    {
+        /* EDX gives the number of sub C-states of each C-state, C0 first */
+        _cpu_cpuid_subleaf(IDLE_CPUID_MWAIT_LEAF, 0, regs);
+        for(i = 0; i < IDLE_MWAIT_CSTATE_COUNT; ++i)
+        {
+            if(((regs[3] >> ((i + 1) * 4)) & 0xF) != 0)
+            {
+                cpu->cstates |= (1U << i);
+            }
+        }
+
+        /* The deeper C-states stop the LAPIC timer without ARAT */
+        if(_cpu_cpuid(IDLE_CPUID_POWER_LEAF, regs) == 0 ||
+           (regs[0] & IDLE_CPUID_POWER_EAX_ARAT) == 0)
+        {
+            cpu->cstates &= 0x1;
+        }
+    }
+
+    KERNEL_DEBUG(IDLE_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %u idle MWAIT C-states 0x%x", cpu_id, cpu->cstates);
+
+    return OS_NO_ERR;
+}
+
+void idle_wait(void)
+{
+    idle_cpu_t* cpu;
+    uint32_t    cpu_id;
+    uint32_t    int_state;
+
+    ENTER_CRITICAL(int_state);
+
+    cpu_id = scheduler_get_current_cpu_id();
+    cpu    = &idle_cpus[cpu_id];
+
+    /* The CPU waits with the interrupts masked on purpose, the wait is not a
+     * masked window
+     */
+    if(rcu_cpu_has_callbacks() == TRUE ||
+       (IDLE_POLL_ISOLATED_CPUS != 0 &&
+        scheduler_is_cpu_isolated(cpu_id) == TRUE))
+    {
+        IRQSOFF_PAUSE();
+        _idle_poll(cpu);
+        IRQSOFF_RESUME();
+    }
+    else if(cpu->cstates != 0)
+    {
+        IRQSOFF_PAUSE();
+        _idle_mwait(cpu);
+        IRQSOFF_RESUME();
+    }
+    else
+    {
+        /* An interrupt taken before the halt preempts the idle thread when
+         * it makes a thread ready.
+         */
+        EXIT_CRITICAL(int_state);
+        _cpu_hlt();
+        return;
+    }
+
+    /* The pending interrupts are taken once the wakers interrupt the CPU */
+    __atomic_store_n(&cpu->state, IDLE_STATE_RUNNING, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&cpu->wake, 0, __ATOMIC_RELAXED);
+
+    EXIT_CRITICAL(int_state);
+}
+
+bool_t idle_wake_cpu(const uint32_t cpu_id)
+{
+    idle_cpu_t* cpu;
+
+    if(cpu_id >= MAX_CPU_COUNT)
+    {
+        return FALSE;
+    }
+
+    cpu = &idle_cpus[cpu_id];
+    if(__atomic_load_n(&cpu->state, __ATOMIC_SEQ_CST) == IDLE_STATE_RUNNING)
+    {
+        return FALSE;
+    }
+
+    __atomic_store_n(&cpu->wake, 1, __ATOMIC_RELEASE);
+
+    return TRUE;
+}
+
+/************************************ EOF *************************************/
@@ -0,0 +1,464 @@
+/*******************************************************************************
+ * @file initcall.c
+ *
+ * @see initcall.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's initialization calls registry.
+ *
+ * @details Kernel's initialization calls registry. A table is run by passes
+ * over its calls, each pass starts the pending calls whose dependencies are
+ * done. When no call can start, the runner waits for an asynchronous call to
+ * end. The calls states are published with release stores, the asynchronous
+ * calls post a semaphore once their state is published.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* Memory manipulation */
+#include <cpu.h>            /* TSC */
+#include <critical.h>       /* Kernel spinlocks */
+#include <scheduler.h>      /* Kernel scheduler */
+#include <semaphore.h>      /* Kernel semaphores */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+#include <tracing.h>        /* Kernel tracing */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <initcall.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "INITCALL"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Asynchronous call context. */
+typedef struct
+{
+    /** @brief The call. */
+    initcall_t* call;
+
+    /** @brief The table identifier. */
+    uint32_t table_id;
+
+    /** @brief The call index in its table. */
+    uint32_t index;
+} initcall_async_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The registered tables. */
+static initcall_t* initcall_tables[INITCALL_MAX_TABLES];
+
+/** @brief Number of calls of the registered tables. */
+static uint32_t initcall_counts[INITCALL_MAX_TABLES];
+
+/** @brief Number of registered tables. */
+static uint32_t initcall_table_count = 0;
+
+/** @brief The TSC value when the first table started. */
+static uint64_t initcall_boot_start = 0;
+
+/** @brief Tables lock. */
+static kernel_spinlock_t initcall_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/** @brief Posted by the asynchronous calls once ended. */
+static semaphore_t initcall_async_sem;
+
+/** @brief The asynchronous calls contexts of the running table. */
+static initcall_async_t initcall_async[INITCALL_MAX_CALLS];
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Runs a call and publishes its state.
+ *
+ * @param[in, out] call The call, in the running state.
+ * @param[in] table_id The table identifier.
+ * @param[in] index The call index in its table.
+ */
+static void _initcall_call(initcall_t* call,
+                           const uint32_t table_id,
+                           const uint32_t index);
+
+/**
+ * @brief Returns the aggregated state of dependencies.
+ *
+ * @param[in] calls The calls table.
+ * @param[in] deps The dependencies mask.
+ *
+ * @return INITCALL_STATE_DONE if all the dependencies are done,
+ * INITCALL_STATE_FAILED if one failed, INITCALL_STATE_PENDING otherwise.
+ */
+static INITCALL_STATE_E _initcall_deps_state(const initcall_t* calls,
+                                             const uint32_t deps);
+
+/**
+ * @brief Asynchronous calls thread routine.
+ *
+ * @param[in] args The initcall_async_t context of the call.
+ *
+ * @return NULL.
+ */
+static void* _initcall_async_routine(void* args);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void _initcall_call(initcall_t* call,
+                           const uint32_t table_id,
+                           const uint32_t index)
+{
+    OS_RETURN_E err;
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_INITCALL_START, 2, table_id, index);
+
+    call->start = _cpu_rdtsc();
+    err         = call->init();
+    call->end   = _cpu_rdtsc();
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_INITCALL_END, 3, table_id, index, err);
+
+    if(err == OS_ERR_NOT_SUPPORTED &&
+       (call->flags & INITCALL_FLAG_OPTIONAL) != 0)
+    {
+        err = OS_NO_ERR;
+    }
+    call->result = err;
+
+    KERNEL_DEBUG(INITCALL_DEBUG_ENABLED, MODULE_NAME,
+                 "Call %s returned %d in %llu cycles", call->name, err,
+                 call->end - call->start);
+
+    __atomic_store_n(&call->state,
+                     (err == OS_NO_ERR) ? INITCALL_STATE_DONE :
+                                          INITCALL_STATE_FAILED,
+                     __ATOMIC_RELEASE);
+}
+
+static INITCALL_STATE_E _initcall_deps_state(const initcall_t* calls,
+                                             const uint32_t deps)
+{
+    INITCALL_STATE_E state;
+    INITCALL_STATE_E dep_state;
+    uint32_t         mask;
+    uint32_t         i;
+
+    state = INITCALL_STATE_DONE;
+    for(mask = deps, i = 0; mask != 0; mask >>= 1, ++i)
+    {
+        if((mask & 1) == 0)
+        {
+            continue;
+        }
+
+        dep_state = __atomic_load_n(&calls[i].state, __ATOMIC_ACQUIRE);
+        if(dep_state == INITCALL_STATE_FAILED)
+        {
+            return INITCALL_STATE_FAILED;
+        }
+        if(dep_state != INITCALL_STATE_DONE)
+        {
+            state = INITCALL_STATE_PENDING;
+        }
+    }
+
+    return state;
+}
+
+static void* _initcall_async_routine(void* args)
+{
+    initcall_async_t* async;
+
+    async = args;
+
+    _initcall_call(async->call, async->table_id, async->index);
+    (void)semaphore_post(&initcall_async_sem);
+
+    return NULL;
+}
+
+OS_RETURN_E initcall_run(initcall_t* calls, const uint32_t count)
+{
+    initcall_t*      call;
+    INITCALL_STATE_E deps_state;
+    OS_RETURN_E      err;
+    uint32_t         table_id;
+    uint32_t         running;
+    uint32_t         i;
+    bool_t           progress;
+
+    if(calls == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(count > INITCALL_MAX_CALLS)
+    {
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+    for(i = 0; i < count; ++i)
+    {
+        if(calls[i].init == NULL || calls[i].name == NULL)
+        {
+            return OS_ERR_NULL_POINTER;
+        }
+        if((calls[i].deps & INITCALL_DEP(i)) != 0 ||
+           (count < INITCALL_MAX_CALLS && (calls[i].deps >> count) != 0))
+        {
+            return OS_ERR_UNAUTHORIZED_ACTION;
+        }
+    }
+
+    KERNEL_SPINLOCK_LOCK(initcall_lock);
+    if(initcall_table_count == INITCALL_MAX_TABLES)
+    {
+        KERNEL_SPINLOCK_UNLOCK(initcall_lock);
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+    table_id                  = initcall_table_count++;
+    initcall_tables[table_id] = calls;
+    initcall_counts[table_id] = count;
+    if(initcall_boot_start == 0)
+    {
+        initcall_boot_start = _cpu_rdtsc();
+    }
+    KERNEL_SPINLOCK_UNLOCK(initcall_lock);
+
+    err = semaphore_init(&initcall_async_sem, 0);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    /* Start the ready calls until none is left, waiting for the asynchronous
+     * calls when no call is ready.
+     */
+    running = 0;
+    do
+    {
+        progress = FALSE;
+        for(i = 0; i < count; ++i)
+        {
+            call = &calls[i];
+            if((call->flags & INITCALL_FLAG_LAZY) != 0 ||
+               __atomic_load_n(&call->state, __ATOMIC_ACQUIRE) !=
+               INITCALL_STATE_PENDING)
+            {
+                continue;
+            }
+
+            deps_state = _initcall_deps_state(calls, call->deps);
+            if(deps_state == INITCALL_STATE_PENDING)
+            {
+                continue;
+            }
+            progress = TRUE;
+
+            if(deps_state == INITCALL_STATE_FAILED)
+            {
+                call->result = OS_ERR_UNAUTHORIZED_ACTION;
+                __atomic_store_n(&call->state, INITCALL_STATE_FAILED,
+                                 __ATOMIC_RELEASE);
+                continue;
+            }
+
+            call->state = INITCALL_STATE_RUNNING;
+            if((call->flags & INITCALL_FLAG_ASYNC) != 0)
+            {
+                initcall_async[i].call     = call;
+                initcall_async[i].table_id = table_id;
+                initcall_async[i].index    = i;
+                err = scheduler_create_kernel_thread(NULL,
+                                                     KERNEL_HIGHEST_PRIORITY,
+                                                     call->name,
+                                                     _initcall_async_routine,
+                                                     &initcall_async[i]);
+                if(err == OS_NO_ERR)
+                {
+                    ++running;
+                    continue;
+                }
+            }
+
+            /* Without thread, the asynchronous calls run in place */
+            _initcall_call(call, table_id, i);
+        }
+
+        if(progress == FALSE && running != 0)
+        {
+            (void)semaphore_wait(&initcall_async_sem);
+            --running;
+            progress = TRUE;
+        }
+    } while(progress == TRUE);
+
+    /* Report the first failure and the calls blocked by lazy dependencies */
+    err = OS_NO_ERR;
+    for(i = 0; i < count; ++i)
+    {
+        call = &calls[i];
+        if((call->flags & INITCALL_FLAG_LAZY) != 0)
+        {
+            continue;
+        }
+        if(call->state == INITCALL_STATE_PENDING)
+        {
+            call->result = OS_ERR_UNAUTHORIZED_ACTION;
+            call->state  = INITCALL_STATE_FAILED;
+        }
+        if(call->state == INITCALL_STATE_FAILED)
+        {
+            KERNEL_ERROR("Init call %s failed, error %d\n", call->name,
+                         call->result);
+            if(err == OS_NO_ERR)
+            {
+                err = call->result;
+            }
+        }
+    }
+
+    return err;
+}
+
+OS_RETURN_E initcall_require(const char* name)
+{
+    initcall_t*      call;
+    initcall_t*      calls;
+    INITCALL_STATE_E state;
+    uint32_t         table_id;
+    uint32_t         index;
+    uint32_t         table_count;
+
+    if(name == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    call        = NULL;
+    calls       = NULL;
+    table_id    = 0;
+    index       = 0;
+    table_count = __atomic_load_n(&initcall_table_count, __ATOMIC_ACQUIRE);
+    for(table_id = 0; table_id < table_count && call == NULL; ++table_id)
+    {
+        calls = initcall_tables[table_id];
+        for(index = 0; index < initcall_counts[table_id]; ++index)
+        {
+            if(strcmp(calls[index].name, name) == 0)
+            {
+                call = &calls[index];
+                break;
+            }
+        }
+    }
+    if(call == NULL)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+    --table_id;
+
+    /* Only the first caller runs the call */
+    state = __atomic_load_n(&call->state, __ATOMIC_ACQUIRE);
+    if(state == INITCALL_STATE_PENDING)
+    {
+        if(_initcall_deps_state(calls, call->deps) != INITCALL_STATE_DONE)
+        {
+            return OS_ERR_UNAUTHORIZED_ACTION;
+        }
+        if(__atomic_compare_exchange_n(&call->state, &state,
+                                       INITCALL_STATE_RUNNING, FALSE,
+                                       __ATOMIC_ACQUIRE,
+                                       __ATOMIC_ACQUIRE) == TRUE)
+        {
+            _initcall_call(call, table_id, index);
+        }
+    }
+
+    while((state = __atomic_load_n(&call->state, __ATOMIC_ACQUIRE)) ==
+          INITCALL_STATE_RUNNING)
+    {
+        _cpu_pause();
+    }
+
+    return call->result;
+}
+
+void initcall_print_profile(void)
+{
+    const initcall_t* call;
+    uint64_t          total;
+    uint64_t          cycles;
+    uint64_t          share;
+    uint32_t          table_id;
+    uint32_t          i;
+
+    total = _cpu_rdtsc() - initcall_boot_start;
+    if(total == 0)
+    {
+        total = 1;
+    }
+
+    KERNEL_INFO("Boot profile: %llu cycles\n", total);
+    for(table_id = 0; table_id < initcall_table_count; ++table_id)
+    {
+        for(i = 0; i < initcall_counts[table_id]; ++i)
+        {
+            call = &initcall_tables[table_id][i];
+            if(call->state != INITCALL_STATE_DONE &&
+               call->state != INITCALL_STATE_FAILED)
+            {
+                continue;
+            }
+
+            /* Shares in tenth of percent */
+            cycles = call->end - call->start;
+            share  = (cycles * 1000) / total;
+            KERNEL_INFO("%12llu cycles %3u.%u%% %s%s\n", cycles,
+                        (uint32_t)(share / 10), (uint32_t)(share % 10),
+                        call->name,
+                        (call->flags & INITCALL_FLAG_ASYNC) != 0 ?
+                        " (async)" : "");
+        }
+    }
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
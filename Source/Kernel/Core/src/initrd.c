@@ -0,0 +1,304 @@
+/*******************************************************************************
+ * @file initrd.c
+ *
+ * @see initrd.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's initial ram disk driver.
+ *
+ * @details Kernel's initial ram disk driver. The module is mapped at its
+ * linear mapping address, KERNEL_MEM_OFFSET plus its physical address, so
+ * that the parts covered by the boot mapping need no new mapping.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* Memory manipulation */
+#include <memmgt.h>         /* Physical memory manager */
+#include <vmm.h>            /* Virtual memory manager */
+#include <blkdev.h>         /* Block devices */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <initrd.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "INITRD"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Address of the archive, after the master block. */
+static const uint8_t* initrd_image = NULL;
+
+/** @brief Size of the archive in bytes. */
+static size_t initrd_size = 0;
+
+/** @brief Block device of the archive. */
+static blkdev_t initrd_dev;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Maps a physical range at its linear mapping address.
+ *
+ * @details Maps read only the pages of a physical range that are not mapped
+ * yet at their linear mapping address. The mapped pages must map the range.
+ *
+ * @param[in] start The start physical address of the range.
+ * @param[in] end The end physical address of the range, excluded.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the range is out of the linear
+ * mapping or a page is mapped to another physical address.
+ * - OS_ERR_NO_MORE_MEMORY is returned if a paging structure could not be
+ * allocated.
+ */
+static OS_RETURN_E _initrd_map(const uint64_t start, const uint64_t end);
+
+/**
+ * @brief Block device read routine, copies blocks of the archive.
+ *
+ * @param[in] dev The block device.
+ * @param[in] block The first block to read.
+ * @param[in] count The number of blocks to read.
+ * @param[out] buffer The buffer receiving the blocks.
+ *
+ * @return OS_NO_ERR, the block cache checks the device bounds.
+ */
+static OS_RETURN_E _initrd_read(blkdev_t* dev,
+                                const uint64_t block,
+                                const uint32_t count,
+                                void* buffer);
+
+/**
+ * @brief Block device map routine, returns the address of a block.
+ *
+ * @param[in] dev The block device.
+ * @param[in] block The block.
+ *
+ * @return The address of the block in the archive.
+ */
+static const void* _initrd_map_block(blkdev_t* dev, const uint64_t block);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static OS_RETURN_E _initrd_map(const uint64_t start, const uint64_t end)
+{
+    uint64_t    page;
+    uint64_t    page_end;
+    uint64_t    run_start;
+    uintptr_t   phys;
+    OS_RETURN_E err;
+
+    page     = start & ~(uint64_t)(VMM_PAGE_SIZE - 1);
+    page_end = (end + VMM_PAGE_SIZE - 1) & ~(uint64_t)(VMM_PAGE_SIZE - 1);
+    if(page_end < end ||
+       page_end > (uint64_t)KERNEL_VIRTUAL_ADDR_MAX - KERNEL_MEM_OFFSET)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    /* Map the runs of pages the boot mapping does not cover */
+    run_start = page_end;
+    for(; page < page_end; page += VMM_PAGE_SIZE)
+    {
+        err = vmm_get_physical((uintptr_t)(page + KERNEL_MEM_OFFSET), &phys);
+        if(err == OS_ERR_MEMORY_NOT_MAPPED)
+        {
+            if(run_start == page_end)
+            {
+                run_start = page;
+            }
+            continue;
+        }
+        if(err != OS_NO_ERR || phys != page)
+        {
+            return OS_ERR_NOT_SUPPORTED;
+        }
+
+        if(run_start != page_end)
+        {
+            err = vmm_map((uintptr_t)(run_start + KERNEL_MEM_OFFSET),
+                          (uintptr_t)run_start, (size_t)(page - run_start), 0);
+            if(err != OS_NO_ERR)
+            {
+                return err;
+            }
+            run_start = page_end;
+        }
+    }
+
+    if(run_start != page_end)
+    {
+        err = vmm_map((uintptr_t)(run_start + KERNEL_MEM_OFFSET),
+                      (uintptr_t)run_start, (size_t)(page_end - run_start), 0);
+    }
+    else
+    {
+        err = OS_NO_ERR;
+    }
+
+    return err;
+}
+
+static OS_RETURN_E _initrd_read(blkdev_t* dev,
+                                const uint64_t block,
+                                const uint32_t count,
+                                void* buffer)
+{
+    (void)dev;
+
+    memcpy(buffer, initrd_image + block * BLKDEV_BLOCK_SIZE,
+           (size_t)count * BLKDEV_BLOCK_SIZE);
+
+    return OS_NO_ERR;
+}
+
+static const void* _initrd_map_block(blkdev_t* dev, const uint64_t block)
+{
+    (void)dev;
+
+    return initrd_image + block * BLKDEV_BLOCK_SIZE;
+}
+
+OS_RETURN_E initrd_init(void)
+{
+    const initrd_master_block_t* master;
+    uint64_t                     start;
+    uint64_t                     end;
+    uint32_t                     i;
+    OS_RETURN_E                  err;
+
+    if(initrd_image != NULL)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    for(i = 0; memmgt_get_module(i, &start, &end) == OS_NO_ERR; ++i)
+    {
+        if(end - start < INITRD_MASTER_BLOCK_SIZE)
+        {
+            continue;
+        }
+
+        err = _initrd_map(start, end);
+        if(err != OS_NO_ERR)
+        {
+            KERNEL_ERROR("Could not map module %u, error %d\n", i, err);
+            continue;
+        }
+
+        master = (const initrd_master_block_t*)(uintptr_t)(start +
+                                                          KERNEL_MEM_OFFSET);
+        if(memcmp(master->magic, INITRD_MAGIC, INITRD_MAGIC_SIZE) != 0)
+        {
+            continue;
+        }
+        if(master->size < INITRD_MASTER_BLOCK_SIZE ||
+           master->size > end - start)
+        {
+            return OS_ERR_CORRUPTED_DATA;
+        }
+
+        initrd_size  = (size_t)(master->size - INITRD_MASTER_BLOCK_SIZE);
+        initrd_image = (const uint8_t*)(master + 1);
+
+        memset(&initrd_dev, 0, sizeof(initrd_dev));
+        initrd_dev.name        = "initrd0";
+        initrd_dev.block_count = initrd_size / BLKDEV_BLOCK_SIZE;
+        initrd_dev.read        = _initrd_read;
+        initrd_dev.map         = _initrd_map_block;
+
+        KERNEL_DEBUG(INITRD_DEBUG_ENABLED, MODULE_NAME,
+                     "Initrd module %u at 0x%p, %u bytes", i, initrd_image,
+                     initrd_size);
+        KERNEL_SUCCESS("Initial ram disk found, %u bytes\n", initrd_size);
+
+        return OS_NO_ERR;
+    }
+
+    return OS_ERR_NOT_SUPPORTED;
+}
+
+OS_RETURN_E initrd_get_image(const void** image, size_t* size)
+{
+    if(image == NULL || size == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(initrd_image == NULL)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    *image = initrd_image;
+    *size  = initrd_size;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E initrd_get_device(blkdev_t** dev)
+{
+    if(dev == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(initrd_image == NULL)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    *dev = &initrd_dev;
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
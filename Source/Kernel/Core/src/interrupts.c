@@ -7,7 +7,7 @@
  *
  * @date 31/03/2023
  *
- * @version 3.0
+ * @version 3.1
  *
  * @brief Interrupt manager.
  *
@@ -30,8 +30,10 @@
 #include <cpu_interrupt.h>      /* CPU interrupts settings */
 #include <panic.h>              /* Kernel panic */
 #include <kernel_output.h>      /* Kernel output methods */
-#include <critical.h>           /* Critical sections */
+#include <critical.h>           /* Critical sections and sequence locks */
 #include <scheduler.h>          /* Kernel scheduler */
+#include <softirq.h>            /* Deferred interrupt work */
+#include <irqsoff.h>            /* Interrupts masked latency tracer */
 
 /* Configuration files */
 #include <config.h>
@@ -74,15 +76,30 @@
  */
 custom_handler_t kernel_interrupt_handlers[INT_ENTRY_COUNT];
 
+/** @brief Tells, for each interrupt line, if its handler never switches
+ * threads. Such handlers are called by the interrupt fast path, the thread's
+ * virtual CPU is not saved. Not static because used by the interrupt entry
+ * path.
+ */
+bool_t kernel_interrupt_fast_lines[INT_ENTRY_COUNT];
+
 /************************** Static global variables ***************************/
 /** @brief The current interrupt driver to be used by the kernel. */
 static interrupt_driver_t interrupt_driver;
 
+/** @brief Protects the interrupt driver and the interrupt handlers table. The
+ * interrupt dispatch path reads them without locking.
+ */
+static kernel_seqlock_t interrupt_table_lock = KERNEL_SEQLOCK_INIT_VALUE;
+
 /** @brief Stores the number of spurious interrupts since the initialization of
  * the kernel.
  */
 static uint64_t spurious_interrupt_count;
 
+/** @brief Per CPU interrupt lines statistics, only updated by their CPU. */
+static interrupt_stats_t interrupt_stats[MAX_CPU_COUNT][INT_ENTRY_COUNT];
+
 /*******************************************************************************
  * STATIC FUNCTIONS DECLARATIONS
  ******************************************************************************/
@@ -117,6 +134,15 @@ static INTERRUPT_TYPE_E _init_driver_handle_spurious(const uint32_t int_number);
  */
 static int32_t _init_driver_get_irq_int_line(const uint32_t irq_number);
 
+/**
+ * @brief Initial placeholder for the IRQ affinity driver.
+ *
+ * @param irq_number Unused.
+ * @param cpu_id Unused.
+ */
+static OS_RETURN_E _init_driver_set_irq_affinity(const uint32_t irq_number,
+                                                 const uint32_t cpu_id);
+
 /**
  * @brief Kernel's spurious interrupt handler.
  *
@@ -126,6 +152,93 @@ static int32_t _init_driver_get_irq_int_line(const uint32_t irq_number);
  */
 static void _spurious_handler(void);
 
+/**
+ * @brief Registers a handler for an interrupt line in the allowed range.
+ *
+ * @details Registers a custom handler to be executed for the interrupt line.
+ * The interrupt line must be in the [min_line, max_line] range.
+ *
+ * @param[in] interrupt_line The interrupt line to attach the handler to.
+ * @param[in] handler The handler for the desired interrupt.
+ * @param[in] min_line The lowest allowed interrupt line.
+ * @param[in] max_line The highest allowed interrupt line.
+ * @param[in] fast Tells if the handler is called by the interrupt fast path.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _register_handler(const uint32_t interrupt_line,
+                                     custom_handler_t handler,
+                                     const uint32_t min_line,
+                                     const uint32_t max_line,
+                                     const bool_t fast);
+
+/**
+ * @brief Registers a handler for an IRQ.
+ *
+ * @details Registers a custom handler to be executed for the interrupt line
+ * attached to the IRQ.
+ *
+ * @param[in] irq_number The IRQ number to attach the handler to.
+ * @param[in] handler The handler for the desired interrupt.
+ * @param[in] fast Tells if the handler is called by the interrupt fast path.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _register_irq_handler(const uint32_t irq_number,
+                                         custom_handler_t handler,
+                                         const bool_t fast);
+
+/**
+ * @brief Calls an interrupt handler and updates the line statistics.
+ *
+ * @details Calls the interrupt handler and accounts the cycles it took in the
+ * statistics of the interrupt line on the current CPU. The deferred works
+ * raised by the handler then run or are handed to the CPU worker thread. Must
+ * be called with interrupts disabled.
+ *
+ * @param[in] handler The handler to call.
+ * @param[in] int_id The interrupt line being handled.
+ * @param[in] current_thread The thread interrupted by the interrupt.
+ */
+inline static void _call_handler(custom_handler_t handler,
+                                 const uint32_t int_id,
+                                 kernel_thread_t* current_thread);
+
+/**
+ * @brief Reads the current interrupt driver.
+ *
+ * @details Copies the current interrupt driver without locking, the copy is
+ * done again when the driver was changed meanwhile.
+ *
+ * @param[out] driver The copy of the current driver.
+ */
+inline static void _get_driver(interrupt_driver_t* driver);
+
+/**
+ * @brief Reads the dispatch data of an interrupt line.
+ *
+ * @details Reads the spurious interrupt handler of the current driver and the
+ * handler of an interrupt line without locking. The read is done again when
+ * the driver or the handlers table was modified meanwhile.
+ *
+ * @param[in] int_id The interrupt line.
+ * @param[out] handle_spurious The spurious interrupt handler of the driver.
+ *
+ * @return The handler of the interrupt line, NULL if none is registered.
+ */
+inline static custom_handler_t _get_line_handler(
+                const uint32_t int_id,
+                INTERRUPT_TYPE_E (**handle_spurious)(const uint32_t int_number));
+
+/**
+ * @brief Records the end of the generic handler masked window.
+ *
+ * @details The handler might have switched threads: the interrupts are
+ * enabled again by the return to the current thread when its saved state has
+ * them enabled.
+ */
+inline static void _irqsoff_handler_exit(void);
+
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
@@ -154,6 +267,113 @@ static int32_t _init_driver_get_irq_int_line(const uint32_t irq_number)
     return 0;
 }
 
+static OS_RETURN_E _init_driver_set_irq_affinity(const uint32_t irq_number,
+                                                 const uint32_t cpu_id)
+{
+    (void)irq_number;
+    (void)cpu_id;
+    return OS_ERR_NOT_SUPPORTED;
+}
+
+inline static void _call_handler(custom_handler_t handler,
+                                 const uint32_t int_id,
+                                 kernel_thread_t* current_thread)
+{
+    interrupt_stats_t* stats;
+    uint64_t           start;
+    uint64_t           cycles;
+    uint32_t           bucket;
+    uint32_t           cpu_id;
+
+    /* The handler might switch threads but we stay on the same CPU */
+    cpu_id = scheduler_get_current_cpu_id();
+    stats  = &interrupt_stats[cpu_id][int_id];
+
+    softirq_irq_enter(cpu_id);
+
+    start = _cpu_rdtsc();
+    handler(current_thread);
+    cycles = _cpu_rdtsc() - start;
+
+    /* Get the log2 bucket */
+    if(cycles != 0)
+    {
+        bucket = 63 - __builtin_clzll(cycles);
+        if(bucket >= INTERRUPT_STATS_HISTOGRAM_SIZE)
+        {
+            bucket = INTERRUPT_STATS_HISTOGRAM_SIZE - 1;
+        }
+    }
+    else
+    {
+        bucket = 0;
+    }
+
+    ++stats->count;
+    stats->cycles += cycles;
+    if(cycles > stats->max_cycles)
+    {
+        stats->max_cycles = cycles;
+    }
+    ++stats->histogram[bucket];
+
+    /* The scheduler interrupt is the thread giving the CPU, not handler time
+     * taken from it.
+     */
+    if(int_id != SCHEDULER_SW_INT_LINE)
+    {
+        current_thread->stats.irq_cycles += cycles;
+    }
+
+    /* Run the deferred work raised by the handler */
+    softirq_irq_exit(cpu_id);
+}
+
+inline static void _get_driver(interrupt_driver_t* driver)
+{
+    uint32_t sequence;
+
+    do
+    {
+        sequence = KERNEL_SEQLOCK_READ_BEGIN(interrupt_table_lock);
+        *driver  = interrupt_driver;
+    } while(KERNEL_SEQLOCK_READ_RETRY(interrupt_table_lock, sequence) == TRUE);
+}
+
+inline static custom_handler_t _get_line_handler(
+                const uint32_t int_id,
+                INTERRUPT_TYPE_E (**handle_spurious)(const uint32_t int_number))
+{
+    custom_handler_t handler;
+    uint32_t         sequence;
+
+    do
+    {
+        sequence         = KERNEL_SEQLOCK_READ_BEGIN(interrupt_table_lock);
+        *handle_spurious = interrupt_driver.driver_handle_spurious;
+        handler          = NULL;
+        if(int_id < INT_ENTRY_COUNT)
+        {
+            handler = kernel_interrupt_handlers[int_id];
+        }
+    } while(KERNEL_SEQLOCK_READ_RETRY(interrupt_table_lock, sequence) == TRUE);
+
+    return handler;
+}
+
+inline static void _irqsoff_handler_exit(void)
+{
+#if IRQSOFF_ENABLED
+    kernel_thread_t* thread;
+
+    thread = scheduler_get_current_thread();
+    if(_cpu_get_saved_interrupt_state(&thread->v_cpu) != 0)
+    {
+        IRQSOFF_RECORD_ENABLE();
+    }
+#endif
+}
+
 static void _spurious_handler(void)
 {
     KERNEL_DEBUG(INTERRUPTS_DEBUG_ENABLED, MODULE_NAME,
@@ -166,10 +386,13 @@ static void _spurious_handler(void)
 
 void kernel_interrupt_handler(void)
 {
+    INTERRUPT_TYPE_E (*handle_spurious)(const uint32_t int_number);
     custom_handler_t handler;
     kernel_thread_t* current_thread;
     uint32_t         int_id;
 
+    /* The CPU masked the interrupts when taking the interrupt */
+    IRQSOFF_RECORD_DISABLE();
 
     /* Get the current thread */
     current_thread = scheduler_get_current_thread();
@@ -196,11 +419,13 @@ void kernel_interrupt_handler(void)
 
     KERNEL_DEBUG(INTERRUPTS_DEBUG_ENABLED, MODULE_NAME, "Int %d", int_id);
 
+    handler = _get_line_handler(int_id, &handle_spurious);
+
     /* Check for spurious interrupt */
-    if(interrupt_driver.driver_handle_spurious(int_id) ==
-       INTERRUPT_TYPE_SPURIOUS)
+    if(handle_spurious(int_id) == INTERRUPT_TYPE_SPURIOUS)
     {
         _spurious_handler();
+        _irqsoff_handler_exit();
         return;
     }
 
@@ -208,21 +433,58 @@ void kernel_interrupt_handler(void)
                  int_id);
 
     /* Select custom handlers */
-    if(int_id < INT_ENTRY_COUNT &&
-       kernel_interrupt_handlers[int_id] != NULL)
+    if(handler == NULL)
     {
-        handler = kernel_interrupt_handlers[int_id];
+        handler = panic_handler;
     }
-    else
+
+    /* Execute the handler */
+    _call_handler(handler, int_id, current_thread);
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_INTERRUPT_HANDLER_END, 2,
+                       int_id, current_thread->tid);
+
+    _irqsoff_handler_exit();
+}
+
+void kernel_interrupt_fast_handler(const uint32_t int_id,
+                                   kernel_thread_t* current_thread)
+{
+    INTERRUPT_TYPE_E (*handle_spurious)(const uint32_t int_number);
+    custom_handler_t handler;
+
+    /* The fast path is only taken from a context with interrupts enabled,
+     * the return enables them again.
+     */
+    IRQSOFF_RECORD_DISABLE();
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_INTERRUPT_HANDLER_START, 2,
+                       int_id, current_thread->tid);
+
+    handler = _get_line_handler(int_id, &handle_spurious);
+
+    /* Check for spurious interrupt */
+    if(handle_spurious(int_id) == INTERRUPT_TYPE_SPURIOUS)
+    {
+        _spurious_handler();
+        IRQSOFF_RECORD_ENABLE();
+        return;
+    }
+
+    /* The handler might have been removed since the entry path checked the
+     * line.
+     */
+    if(handler == NULL)
     {
         handler = panic_handler;
     }
 
-    /* Execute the handler */
-    handler(current_thread);
+    _call_handler(handler, int_id, current_thread);
 
     KERNEL_TRACE_EVENT(EVENT_KERNEL_INTERRUPT_HANDLER_END, 2,
                        int_id, current_thread->tid);
+
+    IRQSOFF_RECORD_ENABLE();
 }
 
 void kernel_interrupt_init(void)
@@ -235,6 +497,7 @@ void kernel_interrupt_init(void)
     memset(kernel_interrupt_handlers,
            0,
            sizeof(custom_handler_t) * INT_ENTRY_COUNT);
+    memset(kernel_interrupt_fast_lines, 0, sizeof(bool_t) * INT_ENTRY_COUNT);
 
     /* Attach the special PANIC interrupt for when we don't know what to do */
     kernel_interrupt_handlers[PANIC_INT_LINE] = panic_handler;
@@ -242,12 +505,14 @@ void kernel_interrupt_init(void)
     /* Init state */
     kernel_interrupt_disable();
     spurious_interrupt_count = 0;
+    memset(interrupt_stats, 0, sizeof(interrupt_stats));
 
     /* Init driver */
     interrupt_driver.driver_get_irq_int_line = _init_driver_get_irq_int_line;
     interrupt_driver.driver_handle_spurious  = _init_driver_handle_spurious;
     interrupt_driver.driver_set_irq_eoi      = _init_driver_set_irq_eoi;
     interrupt_driver.driver_set_irq_mask     = _init_driver_set_irq_mask;
+    interrupt_driver.driver_set_irq_affinity = _init_driver_set_irq_affinity;
 
     TEST_POINT_FUNCTION_CALL(interrupt_test, TEST_INTERRUPT_ENABLED);
 
@@ -258,22 +523,15 @@ OS_RETURN_E kernel_interrupt_set_driver(const interrupt_driver_t* driver)
 {
     uint32_t int_state;
 
-#ifdef ARCH_64_BITS
-    KERNEL_TRACE_EVENT(EVENT_KERNEL_INTERRUPT_SET_DRIVER_START, 2,
-                       (uintptr_t)driver & 0xFFFFFFFF,
-                       (uintptr_t)driver >> 32);
-#else
-    KERNEL_TRACE_EVENT(EVENT_KERNEL_INTERRUPT_SET_DRIVER_START, 2,
-                       (uintptr_t)driver & 0xFFFFFFFF,
-                       0);
-#endif
-
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_INTERRUPT_SET_DRIVER_START, 1,
+                       (uintptr_t)driver);
 
     if(driver == NULL ||
        driver->driver_set_irq_eoi == NULL ||
        driver->driver_set_irq_mask == NULL ||
        driver->driver_handle_spurious == NULL ||
-       driver->driver_get_irq_int_line == NULL)
+       driver->driver_get_irq_int_line == NULL ||
+       driver->driver_set_irq_affinity == NULL)
     {
         KERNEL_TRACE_EVENT(EVENT_KERNEL_INTERRUPT_SET_DRIVER_END, 1,
                            OS_ERR_NULL_POINTER);
@@ -281,10 +539,13 @@ OS_RETURN_E kernel_interrupt_set_driver(const interrupt_driver_t* driver)
         return OS_ERR_NULL_POINTER;
     }
 
+    /* The interrupts are disabled, a handler cannot wait for our write */
     ENTER_CRITICAL(int_state);
+    KERNEL_SEQLOCK_WRITE_LOCK(interrupt_table_lock);
 
     interrupt_driver = *driver;
 
+    KERNEL_SEQLOCK_WRITE_UNLOCK(interrupt_table_lock);
     EXIT_CRITICAL(int_state);
 
     KERNEL_DEBUG(INTERRUPTS_DEBUG_ENABLED, MODULE_NAME,
@@ -295,25 +556,19 @@ OS_RETURN_E kernel_interrupt_set_driver(const interrupt_driver_t* driver)
     return OS_NO_ERR;
 }
 
-OS_RETURN_E kernel_interrupt_register_int_handler(const uint32_t interrupt_line,
-                                                  custom_handler_t handler)
+static OS_RETURN_E _register_handler(const uint32_t interrupt_line,
+                                     custom_handler_t handler,
+                                     const uint32_t min_line,
+                                     const uint32_t max_line,
+                                     const bool_t fast)
 {
     uint32_t int_state;
 
-#ifdef ARCH_64_BITS
-    KERNEL_TRACE_EVENT(EVENT_KERNEL_INTERRUPT_REGISTER_START, 3,
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_INTERRUPT_REGISTER_START, 2,
                        interrupt_line,
-                       (uintptr_t)handler & 0xFFFFFFFF,
-                       (uintptr_t)handler >> 32);
-#else
-    KERNEL_TRACE_EVENT(EVENT_KERNEL_INTERRUPT_REGISTER_START, 3,
-                       interrupt_line,
-                       handler,
-                       0);
-#endif
+                       (uintptr_t)handler);
 
-    if(interrupt_line < MIN_INTERRUPT_LINE ||
-       interrupt_line > MAX_INTERRUPT_LINE)
+    if(interrupt_line < min_line || interrupt_line > max_line)
     {
         KERNEL_TRACE_EVENT(EVENT_KERNEL_INTERRUPT_REGISTER_END, 2,
                            interrupt_line,
@@ -332,9 +587,11 @@ OS_RETURN_E kernel_interrupt_register_int_handler(const uint32_t interrupt_line,
     }
 
     ENTER_CRITICAL(int_state);
+    KERNEL_SEQLOCK_WRITE_LOCK(interrupt_table_lock);
 
     if(kernel_interrupt_handlers[interrupt_line] != NULL)
     {
+        KERNEL_SEQLOCK_WRITE_UNLOCK(interrupt_table_lock);
         EXIT_CRITICAL(int_state);
         KERNEL_TRACE_EVENT(EVENT_KERNEL_INTERRUPT_REGISTER_END, 2,
                            interrupt_line,
@@ -343,10 +600,16 @@ OS_RETURN_E kernel_interrupt_register_int_handler(const uint32_t interrupt_line,
         return OS_ERR_INTERRUPT_ALREADY_REGISTERED;
     }
 
+    /* The entry path only takes the fast path once the handler is set */
     kernel_interrupt_handlers[interrupt_line] = handler;
+    __atomic_store_n(&kernel_interrupt_fast_lines[interrupt_line], fast,
+                     __ATOMIC_RELEASE);
+
+    KERNEL_SEQLOCK_WRITE_UNLOCK(interrupt_table_lock);
 
     KERNEL_DEBUG(INTERRUPTS_DEBUG_ENABLED, MODULE_NAME,
-                 "Added INT %u handler at 0x%p", interrupt_line, handler);
+                 "Added INT %u handler at 0x%p, fast %d",
+                 interrupt_line, handler, fast);
 
     KERNEL_TRACE_EVENT(EVENT_KERNEL_INTERRUPT_REGISTER_END, 2,
                        interrupt_line,
@@ -357,6 +620,29 @@ OS_RETURN_E kernel_interrupt_register_int_handler(const uint32_t interrupt_line,
     return OS_NO_ERR;
 }
 
+OS_RETURN_E kernel_interrupt_register_int_handler(const uint32_t interrupt_line,
+                                                  custom_handler_t handler)
+{
+    return _register_handler(interrupt_line, handler,
+                             MIN_INTERRUPT_LINE, MAX_INTERRUPT_LINE, FALSE);
+}
+
+OS_RETURN_E kernel_interrupt_register_fast_int_handler(
+                                               const uint32_t interrupt_line,
+                                               custom_handler_t handler)
+{
+    return _register_handler(interrupt_line, handler,
+                             MIN_INTERRUPT_LINE, MAX_INTERRUPT_LINE, TRUE);
+}
+
+OS_RETURN_E kernel_interrupt_register_exception_handler(
+                                               const uint32_t exception_line,
+                                               custom_handler_t handler)
+{
+    return _register_handler(exception_line, handler,
+                             MIN_EXCEPTION_LINE, MAX_EXCEPTION_LINE, FALSE);
+}
+
 OS_RETURN_E kernel_interrupt_remove_int_handler(const uint32_t interrupt_line)
 {
     uint32_t int_state;
@@ -375,9 +661,11 @@ OS_RETURN_E kernel_interrupt_remove_int_handler(const uint32_t interrupt_line)
     }
 
     ENTER_CRITICAL(int_state);
+    KERNEL_SEQLOCK_WRITE_LOCK(interrupt_table_lock);
 
     if(kernel_interrupt_handlers[interrupt_line] == NULL)
     {
+        KERNEL_SEQLOCK_WRITE_UNLOCK(interrupt_table_lock);
         EXIT_CRITICAL(int_state);
 
         KERNEL_TRACE_EVENT(EVENT_KERNEL_INTERRUPT_REMOVE_END, 2,
@@ -387,8 +675,12 @@ OS_RETURN_E kernel_interrupt_remove_int_handler(const uint32_t interrupt_line)
         return OS_ERR_INTERRUPT_NOT_REGISTERED;
     }
 
+    __atomic_store_n(&kernel_interrupt_fast_lines[interrupt_line], FALSE,
+                     __ATOMIC_RELEASE);
     kernel_interrupt_handlers[interrupt_line] = NULL;
 
+    KERNEL_SEQLOCK_WRITE_UNLOCK(interrupt_table_lock);
+
     KERNEL_DEBUG(INTERRUPTS_DEBUG_ENABLED, MODULE_NAME,
                  "Removed interrupt %u handle", interrupt_line);
 
@@ -401,26 +693,28 @@ OS_RETURN_E kernel_interrupt_remove_int_handler(const uint32_t interrupt_line)
     return OS_NO_ERR;
 }
 
-OS_RETURN_E kernel_interrupt_register_irq_handler(const uint32_t irq_number,
-                                                  custom_handler_t handler)
+custom_handler_t kernel_interrupt_get_handler(const uint32_t interrupt_line)
 {
-    int32_t     int_line;
-    OS_RETURN_E ret_code;
+    INTERRUPT_TYPE_E (*handle_spurious)(const uint32_t int_number);
 
-#ifdef ARCH_64_BITS
-    KERNEL_TRACE_EVENT(EVENT_KERNEL_IRQ_REGISTER_START, 3,
-                       irq_number,
-                       (uintptr_t)handler & 0xFFFFFFFF,
-                       (uintptr_t)handler >> 32);
-#else
-    KERNEL_TRACE_EVENT(EVENT_KERNEL_IRQ_REGISTER_START, 3,
+    return _get_line_handler(interrupt_line, &handle_spurious);
+}
+
+static OS_RETURN_E _register_irq_handler(const uint32_t irq_number,
+                                         custom_handler_t handler,
+                                         const bool_t fast)
+{
+    interrupt_driver_t driver;
+    int32_t            int_line;
+    OS_RETURN_E        ret_code;
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_IRQ_REGISTER_START, 2,
                        irq_number,
-                       handler,
-                       0);
-#endif
+                       (uintptr_t)handler);
 
     /* Get the interrupt line attached to the IRQ number. */
-    int_line = interrupt_driver.driver_get_irq_int_line(irq_number);
+    _get_driver(&driver);
+    int_line = driver.driver_get_irq_int_line(irq_number);
 
     if(int_line < 0)
     {
@@ -429,22 +723,38 @@ OS_RETURN_E kernel_interrupt_register_irq_handler(const uint32_t irq_number,
         return OS_ERR_NO_SUCH_IRQ;
     }
 
-    ret_code = kernel_interrupt_register_int_handler(int_line, handler);
+    ret_code = _register_handler(int_line, handler,
+                                 MIN_INTERRUPT_LINE, MAX_INTERRUPT_LINE, fast);
 
     KERNEL_TRACE_EVENT(EVENT_KERNEL_IRQ_REGISTER_END, 1, ret_code);
 
     return ret_code;
 }
 
+OS_RETURN_E kernel_interrupt_register_irq_handler(const uint32_t irq_number,
+                                                  custom_handler_t handler)
+{
+    return _register_irq_handler(irq_number, handler, FALSE);
+}
+
+OS_RETURN_E kernel_interrupt_register_fast_irq_handler(
+                                                   const uint32_t irq_number,
+                                                   custom_handler_t handler)
+{
+    return _register_irq_handler(irq_number, handler, TRUE);
+}
+
 OS_RETURN_E kernel_interrupt_remove_irq_handler(const uint32_t irq_number)
 {
-    int32_t     int_line;
-    OS_RETURN_E ret_code;
+    interrupt_driver_t driver;
+    int32_t            int_line;
+    OS_RETURN_E        ret_code;
 
     KERNEL_TRACE_EVENT(EVENT_KERNEL_IRQ_REMOVE_START, 1, irq_number);
 
     /* Get the interrupt line attached to the IRQ number. */
-    int_line = interrupt_driver.driver_get_irq_int_line(irq_number);
+    _get_driver(&driver);
+    int_line = driver.driver_get_irq_int_line(irq_number);
 
     if(int_line < 0)
     {
@@ -495,22 +805,108 @@ uint32_t kernel_interrupt_disable(void)
 void kernel_interrupt_set_irq_mask(const uint32_t irq_number,
                                    const uint32_t enabled)
 {
+    interrupt_driver_t driver;
+
     KERNEL_TRACE_EVENT(EVENT_KERNEL_SET_IRQ_MASK, 2, irq_number, enabled);
 
     KERNEL_DEBUG(INTERRUPTS_DEBUG_ENABLED, MODULE_NAME,
                  "IRQ Mask change: %u %u", irq_number, enabled);
 
-    interrupt_driver.driver_set_irq_mask(irq_number, enabled);
+    _get_driver(&driver);
+    driver.driver_set_irq_mask(irq_number, enabled);
 }
 
 void kernel_interrupt_set_irq_eoi(const uint32_t irq_number)
 {
+    interrupt_driver_t driver;
+
     KERNEL_TRACE_EVENT(EVENT_KERNEL_SET_IRQ_EOI, 1, irq_number);
 
     KERNEL_DEBUG(INTERRUPTS_DEBUG_ENABLED,  "INTERRUPTS", "IRQ EOI: %u",
                  irq_number);
 
-    interrupt_driver.driver_set_irq_eoi(irq_number);
+    _get_driver(&driver);
+    driver.driver_set_irq_eoi(irq_number);
+}
+
+OS_RETURN_E kernel_interrupt_set_irq_affinity(const uint32_t irq_number,
+                                              const uint32_t cpu_id)
+{
+    interrupt_driver_t driver;
+
+    if(cpu_id >= MAX_CPU_COUNT)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    KERNEL_DEBUG(INTERRUPTS_DEBUG_ENABLED, MODULE_NAME,
+                 "IRQ %u routed to CPU %u", irq_number, cpu_id);
+
+    _get_driver(&driver);
+    return driver.driver_set_irq_affinity(irq_number, cpu_id);
+}
+
+OS_RETURN_E kernel_interrupt_get_stats(const uint32_t cpu_id,
+                                       const uint32_t interrupt_line,
+                                       interrupt_stats_t* stats)
+{
+    if(stats == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(cpu_id >= MAX_CPU_COUNT)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    if(interrupt_line >= INT_ENTRY_COUNT)
+    {
+        return OR_ERR_UNAUTHORIZED_INTERRUPT_LINE;
+    }
+
+    memcpy(stats, &interrupt_stats[cpu_id][interrupt_line],
+           sizeof(interrupt_stats_t));
+
+    return OS_NO_ERR;
+}
+
+void kernel_interrupt_dump_stats(void)
+{
+    const interrupt_stats_t* stats;
+    uint32_t                 cpu_id;
+    uint32_t                 line;
+    uint32_t                 i;
+
+    for(cpu_id = 0; cpu_id < MAX_CPU_COUNT; ++cpu_id)
+    {
+        for(line = 0; line < INT_ENTRY_COUNT; ++line)
+        {
+            stats = &interrupt_stats[cpu_id][line];
+            if(stats->count == 0)
+            {
+                continue;
+            }
+
+            KERNEL_INFO("CPU %u INT %u: %llu calls, %llu cycles, "
+                        "avg %llu, max %llu\n",
+                        cpu_id, line, stats->count, stats->cycles,
+                        stats->cycles / stats->count, stats->max_cycles);
+
+            for(i = 0; i < INTERRUPT_STATS_HISTOGRAM_SIZE; ++i)
+            {
+                if(stats->histogram[i] != 0)
+                {
+                    kernel_printf("    [2^%u] %u\n", i, stats->histogram[i]);
+                }
+            }
+        }
+    }
+}
+
+void kernel_interrupt_reset_stats(void)
+{
+    memset(interrupt_stats, 0, sizeof(interrupt_stats));
 }
 
 /************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,470 @@
+/*******************************************************************************
+ * @file ioring.c
+ *
+ * @see ioring.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's asynchronous I/O submission and completion rings.
+ *
+ * @details Kernel's asynchronous I/O submission and completion rings. Only
+ * the owner thread uses the submission ring and the completion ring head, they
+ * are not locked. The drivers complete from any context: the completion ring
+ * tail, the free requests and the waiter are protected by the ring lock, the
+ * interrupts disabled.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <cpu.h>            /* CPU pause */
+#include <critical.h>       /* Kernel critical sections and spinlocks */
+#include <scheduler.h>      /* Thread wait */
+#include <kheap.h>          /* Kernel heap */
+#include <blkdev.h>         /* Block devices */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <ioring.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "IORING"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Takes a free request of a ring.
+ *
+ * @details The reserved entries never exceed the number of requests, a free
+ * request is always found for a reserved entry.
+ *
+ * @param[in, out] ring The ring.
+ *
+ * @return The request.
+ */
+static ioring_request_t* _ioring_take_request(ioring_t* ring);
+
+/**
+ * @brief Polls the targets of the operations in flight of a ring.
+ *
+ * @param[in] ring The ring.
+ */
+static void _ioring_poll_targets(ioring_t* ring);
+
+/**
+ * @brief Starts an operation on a block device.
+ *
+ * @param[in] target The block device target.
+ * @param[in] request The request to start.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NOT_SUPPORTED is returned if the operation is not a read.
+ * - OS_ERR_OUT_OF_BOUND is returned if the request is not aligned on the
+ * blocks or exceeds the device.
+ */
+static OS_RETURN_E _ioring_blkdev_submit(ioring_target_t* target,
+                                         ioring_request_t* request);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static ioring_request_t* _ioring_take_request(ioring_t* ring)
+{
+    ioring_request_t* request;
+    uint32_t          int_state;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(ring->lock, int_state);
+    request             = ring->free_requests;
+    ring->free_requests = request->next;
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(ring->lock, int_state);
+
+    request->next = NULL;
+
+    return request;
+}
+
+static void _ioring_poll_targets(ioring_t* ring)
+{
+    ioring_target_t* target;
+    uint32_t         i;
+
+    for(i = 0; i < ring->entries; ++i)
+    {
+        target = ring->requests[i].target;
+        if(target != NULL && target->poll != NULL)
+        {
+            target->poll(target);
+        }
+    }
+}
+
+static OS_RETURN_E _ioring_blkdev_submit(ioring_target_t* target,
+                                         ioring_request_t* request)
+{
+    blkdev_t*   dev;
+    uint64_t    block;
+    uint32_t    count;
+    OS_RETURN_E err;
+
+    dev = target->driver_ctrl;
+
+    if(request->sqe.opcode != IORING_OP_READ)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+    if(request->sqe.offset % BLKDEV_BLOCK_SIZE != 0 ||
+       request->sqe.size % BLKDEV_BLOCK_SIZE != 0)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    block = request->sqe.offset / BLKDEV_BLOCK_SIZE;
+    count = request->sqe.size / BLKDEV_BLOCK_SIZE;
+    if(block > dev->block_count || count > dev->block_count - block)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    /* The block devices read synchronously */
+    err = OS_NO_ERR;
+    if(count != 0)
+    {
+        err = dev->read(dev, block, count, request->sqe.buffer);
+    }
+    ioring_complete(request, err, err == OS_NO_ERR ? request->sqe.size : 0);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E ioring_init(ioring_t* ring,
+                        const uint32_t entries,
+                        const uint32_t flags)
+{
+    uint32_t i;
+
+    if(ring == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(entries == 0 || entries > IORING_MAX_ENTRIES ||
+       (entries & (entries - 1)) != 0)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    ring->sq       = kmalloc(entries * sizeof(ioring_sqe_t));
+    ring->cq       = kmalloc(entries * sizeof(ioring_cqe_t));
+    ring->requests = kmalloc(entries * sizeof(ioring_request_t));
+    if(ring->sq == NULL || ring->cq == NULL || ring->requests == NULL)
+    {
+        kfree(ring->sq);
+        kfree(ring->cq);
+        kfree(ring->requests);
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+
+    ring->free_requests = NULL;
+    for(i = 0; i < entries; ++i)
+    {
+        ring->requests[i].ring   = ring;
+        ring->requests[i].target = NULL;
+        ring->requests[i].next   = ring->free_requests;
+        ring->free_requests      = &ring->requests[i];
+    }
+
+    ring->entries   = entries;
+    ring->flags     = flags;
+    ring->sq_head   = 0;
+    ring->sq_tail   = 0;
+    ring->cq_head   = 0;
+    ring->cq_tail   = 0;
+    ring->used      = 0;
+    ring->submitted = 0;
+    ring->waiter    = NULL;
+    ring->task      = NULL;
+    KERNEL_SPINLOCK_INIT(ring->lock);
+
+    KERNEL_DEBUG(IORING_DEBUG_ENABLED, MODULE_NAME,
+                 "Ring 0x%p initialized, %u entries", ring, entries);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E ioring_set_task(ioring_t* ring, ktask_t* task)
+{
+    uint32_t int_state;
+
+    if(ring == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(ring->lock, int_state);
+    ring->task = task;
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(ring->lock, int_state);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E ioring_destroy(ioring_t* ring)
+{
+    if(ring == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(ring->used != 0)
+    {
+        return OS_ERR_RESOURCE_BUSY;
+    }
+
+    kfree(ring->sq);
+    kfree(ring->cq);
+    kfree(ring->requests);
+    ring->sq       = NULL;
+    ring->cq       = NULL;
+    ring->requests = NULL;
+    ring->entries  = 0;
+
+    return OS_NO_ERR;
+}
+
+ioring_sqe_t* ioring_get_sqe(ioring_t* ring)
+{
+    ioring_sqe_t* sqe;
+
+    /* The reserved entries bound the completions, the ring cannot overflow */
+    if(ring == NULL || ring->used == ring->entries)
+    {
+        return NULL;
+    }
+
+    sqe = &ring->sq[ring->sq_tail & (ring->entries - 1)];
+    ++ring->sq_tail;
+    ++ring->used;
+
+    return sqe;
+}
+
+uint32_t ioring_submit(ioring_t* ring)
+{
+    ioring_request_t* request;
+    ioring_target_t*  target;
+    OS_RETURN_E       err;
+    uint32_t          count;
+
+    if(ring == NULL)
+    {
+        return 0;
+    }
+
+    count = 0;
+    while(ring->sq_head != ring->sq_tail)
+    {
+        request      = _ioring_take_request(ring);
+        request->sqe = ring->sq[ring->sq_head & (ring->entries - 1)];
+        ++ring->sq_head;
+        ++ring->submitted;
+        ++count;
+
+        target = request->sqe.target;
+        if(request->sqe.opcode == IORING_OP_NOP)
+        {
+            ioring_complete(request, OS_NO_ERR, 0);
+            continue;
+        }
+        if(target == NULL || target->submit == NULL)
+        {
+            ioring_complete(request, OS_ERR_NULL_POINTER, 0);
+            continue;
+        }
+
+        /* The target can complete before returning */
+        request->target = target;
+        err = target->submit(target, request);
+        if(err != OS_NO_ERR)
+        {
+            ioring_complete(request, err, 0);
+        }
+    }
+
+    KERNEL_DEBUG(IORING_DEBUG_ENABLED, MODULE_NAME,
+                 "Ring 0x%p submitted %u entries", ring, count);
+
+    return count;
+}
+
+bool_t ioring_get_cqe(ioring_t* ring, ioring_cqe_t* cqe)
+{
+    if(ring == NULL || cqe == NULL ||
+       __atomic_load_n(&ring->cq_tail, __ATOMIC_ACQUIRE) == ring->cq_head)
+    {
+        return FALSE;
+    }
+
+    *cqe = ring->cq[ring->cq_head & (ring->entries - 1)];
+    ++ring->cq_head;
+    --ring->submitted;
+    --ring->used;
+
+    return TRUE;
+}
+
+OS_RETURN_E ioring_wait_cqe(ioring_t* ring, ioring_cqe_t* cqe)
+{
+    uint32_t    int_state;
+    OS_RETURN_E err;
+
+    if(ring == NULL || cqe == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    while(ioring_get_cqe(ring, cqe) == FALSE)
+    {
+        if(ring->submitted == 0)
+        {
+            return OS_ERR_UNAUTHORIZED_ACTION;
+        }
+
+        if((ring->flags & IORING_FLAG_POLL) != 0)
+        {
+            _ioring_poll_targets(ring);
+            _cpu_pause();
+            continue;
+        }
+
+        ENTER_CRITICAL(int_state);
+        KERNEL_SPINLOCK_LOCK(ring->lock);
+
+        /* The wait releases the lock once the thread is waiting */
+        if(ring->cq_tail == ring->cq_head)
+        {
+            ring->waiter = scheduler_get_current_thread();
+            err = scheduler_wait_thread(THREAD_WAIT_TYPE_IO, &ring->lock);
+            if(err != OS_NO_ERR)
+            {
+                ring->waiter = NULL;
+                KERNEL_SPINLOCK_UNLOCK(ring->lock);
+                EXIT_CRITICAL(int_state);
+                return err;
+            }
+        }
+        else
+        {
+            KERNEL_SPINLOCK_UNLOCK(ring->lock);
+        }
+
+        EXIT_CRITICAL(int_state);
+    }
+
+    return OS_NO_ERR;
+}
+
+void ioring_complete(ioring_request_t* request,
+                     const OS_RETURN_E status,
+                     const size_t size)
+{
+    ioring_t*        ring;
+    ioring_cqe_t*    cqe;
+    kernel_thread_t* waiter;
+    ktask_t*         task;
+    uint32_t         int_state;
+
+    if(request == NULL)
+    {
+        return;
+    }
+
+    ring = request->ring;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(ring->lock, int_state);
+
+    cqe            = &ring->cq[ring->cq_tail & (ring->entries - 1)];
+    cqe->user_data = request->sqe.user_data;
+    cqe->status    = status;
+    cqe->size      = size;
+    __atomic_store_n(&ring->cq_tail, ring->cq_tail + 1, __ATOMIC_RELEASE);
+
+    request->target     = NULL;
+    request->next       = ring->free_requests;
+    ring->free_requests = request;
+
+    waiter       = ring->waiter;
+    ring->waiter = NULL;
+    task         = ring->task;
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(ring->lock, int_state);
+
+    if(waiter != NULL)
+    {
+        (void)scheduler_wakeup_thread(waiter);
+    }
+    if(task != NULL)
+    {
+        (void)ktask_wake(task);
+    }
+}
+
+OS_RETURN_E ioring_blkdev_target_init(ioring_target_t* target, blkdev_t* dev)
+{
+    if(target == NULL || dev == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    target->name        = dev->name;
+    target->submit      = _ioring_blkdev_submit;
+    target->poll        = NULL;
+    target->driver_ctrl = dev;
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
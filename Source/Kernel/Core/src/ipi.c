@@ -0,0 +1,415 @@
+/*******************************************************************************
+ * @file ipi.c
+ *
+ * @see ipi.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's cross-CPU calls.
+ *
+ * @details Kernel's cross-CPU calls. The call queue of a CPU is a lock-free
+ * stack of call requests: the callers push their requests with a compare and
+ * swap, the target CPU takes the whole stack with one exchange and runs the
+ * requests in the order they were posted. Only the caller that finds the
+ * queue empty sends the interrupt, the other callers join the pending round.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <cpu.h>            /* IPI management */
+#include <cpu_interrupt.h>  /* Call interrupt line */
+#include <critical.h>       /* Kernel critical sections */
+#include <interrupts.h>     /* Interrupt handlers */
+#include <scheduler.h>      /* Current CPU identifier */
+#include <panic.h>          /* Kernel panic */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <ipi.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "IPI"
+
+/** @brief Number of pauses the stopping CPU waits for the other CPUs. */
+#define IPI_STOP_WAIT_SPINS 10000000U
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Call queue of a CPU. */
+typedef struct
+{
+    /** @brief Last posted request, the requests are linked toward the first
+     * posted one.
+     */
+    ipi_call_t* head;
+} __attribute__((aligned(CPU_CACHE_LINE_SIZE))) ipi_queue_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Assert macro used by the cross-CPU calls to ensure correctness of
+ * execution.
+ *
+ * @details Assert macro used by the cross-CPU calls to ensure correctness of
+ * execution. A caller waiting for a call that cannot be delivered would wait
+ * forever, any error generates a kernel panic.
+ *
+ * @param[in] COND The condition that should be true.
+ * @param[in] MSG The message to display in case of kernel panic.
+ * @param[in] ERROR The error code to use in case of kernel panic.
+ */
+#define IPI_ASSERT(COND, MSG, ERROR) {                      \
+    if((COND) == FALSE)                                     \
+    {                                                       \
+        PANIC(ERROR, MODULE_NAME, MSG, TRUE);               \
+    }                                                       \
+}
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief CPUs receiving the cross-CPU calls, one bit per CPU. */
+static volatile uint32_t ipi_online_cpus = 0;
+
+/** @brief Call queue of each CPU. */
+static ipi_queue_t ipi_queues[MAX_CPU_COUNT];
+
+/** @brief Stop requests posted by the kernel panic. */
+static ipi_call_t ipi_stop_calls[MAX_CPU_COUNT];
+
+/** @brief CPUs that stopped, one bit per CPU. */
+static volatile uint32_t ipi_stopped_cpus = 0;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Pushes a request in the call queue of a CPU.
+ *
+ * @param[in] cpu_id The identifier of the target CPU.
+ * @param[in, out] call The request.
+ *
+ * @return TRUE if the queue was empty and the CPU must be interrupted, FALSE
+ * otherwise.
+ */
+static bool_t _ipi_push(const uint32_t cpu_id, ipi_call_t* call);
+
+/**
+ * @brief Runs the requests of the call queue of the current CPU.
+ *
+ * @param[in] cpu_id The identifier of the current CPU.
+ */
+static void _ipi_serve(const uint32_t cpu_id);
+
+/**
+ * @brief Call interrupt handler.
+ *
+ * @param[in] current_thread The interrupted thread.
+ */
+static void _ipi_handler(kernel_thread_t* current_thread);
+
+/**
+ * @brief Stop request function, halts the current CPU.
+ *
+ * @param[in] args Unused.
+ */
+static void _ipi_stop(void* args);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static bool_t _ipi_push(const uint32_t cpu_id, ipi_call_t* call)
+{
+    ipi_call_t* head;
+
+    head = __atomic_load_n(&ipi_queues[cpu_id].head, __ATOMIC_RELAXED);
+    do
+    {
+        call->next = head;
+    } while(__atomic_compare_exchange_n(&ipi_queues[cpu_id].head, &head, call,
+                                        TRUE, __ATOMIC_RELEASE,
+                                        __ATOMIC_RELAXED) == FALSE);
+
+    return (head == NULL);
+}
+
+static void _ipi_serve(const uint32_t cpu_id)
+{
+    ipi_call_t*        call;
+    ipi_call_t*        next;
+    ipi_call_t*        list;
+    ipi_function_t     function;
+    void*              args;
+    volatile uint32_t* pending;
+
+    call = __atomic_exchange_n(&ipi_queues[cpu_id].head, NULL,
+                               __ATOMIC_ACQUIRE);
+
+    /* The queue is a stack, run the requests in the order they were posted */
+    list = NULL;
+    while(call != NULL)
+    {
+        next       = call->next;
+        call->next = list;
+        list       = call;
+        call       = next;
+    }
+
+    while(list != NULL)
+    {
+        /* The request belongs to its caller again once it is released */
+        next     = list->next;
+        function = list->function;
+        args     = list->args;
+        pending  = list->pending;
+        __atomic_store_n(&list->queued, FALSE, __ATOMIC_RELEASE);
+
+        function(args);
+
+        if(pending != NULL)
+        {
+            __atomic_fetch_sub(pending, 1, __ATOMIC_RELEASE);
+        }
+        list = next;
+    }
+}
+
+static void _ipi_handler(kernel_thread_t* current_thread)
+{
+    (void)current_thread;
+
+    _ipi_serve(scheduler_get_current_cpu_id());
+    cpu_ipi_eoi();
+}
+
+static void _ipi_stop(void* args)
+{
+    (void)args;
+
+    __atomic_fetch_or(&ipi_stopped_cpus,
+                      1U << scheduler_get_current_cpu_id(),
+                      __ATOMIC_SEQ_CST);
+
+    while(TRUE)
+    {
+        _cpu_clear_interrupt();
+        _cpu_hlt();
+    }
+}
+
+OS_RETURN_E ipi_init_cpu(const uint32_t cpu_id)
+{
+    OS_RETURN_E err;
+
+    if(cpu_id >= MAX_CPU_COUNT)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    /* The calls never switch threads */
+    if(ipi_online_cpus == 0)
+    {
+        err = kernel_interrupt_register_fast_int_handler(IPI_CALL_INT_LINE,
+                                                         _ipi_handler);
+        if(err != OS_NO_ERR)
+        {
+            return err;
+        }
+    }
+
+    __atomic_fetch_or(&ipi_online_cpus, 1U << cpu_id, __ATOMIC_SEQ_CST);
+
+    KERNEL_DEBUG(IPI_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %u added to the cross-CPU calls", cpu_id);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E ipi_call_async(const uint32_t cpu_id, ipi_call_t* call)
+{
+    bool_t      expected;
+    OS_RETURN_E err;
+
+    if(call == NULL || call->function == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(cpu_id >= MAX_CPU_COUNT ||
+       (ipi_online_cpus & (1U << cpu_id)) == 0)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    /* A queued request is already going to run */
+    expected = FALSE;
+    if(__atomic_compare_exchange_n(&call->queued, &expected, TRUE, FALSE,
+                                   __ATOMIC_ACQUIRE,
+                                   __ATOMIC_RELAXED) == FALSE)
+    {
+        return OS_ERR_RESOURCE_BUSY;
+    }
+
+    call->pending = NULL;
+    if(_ipi_push(cpu_id, call) == TRUE)
+    {
+        err = cpu_send_ipi(cpu_id, IPI_CALL_INT_LINE);
+        IPI_ASSERT(err == OS_NO_ERR, "Could not send the call IPI", err);
+    }
+
+    KERNEL_DEBUG(IPI_DEBUG_ENABLED, MODULE_NAME,
+                 "Posted call 0x%p to CPU %u", call, cpu_id);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E ipi_call_many(const uint32_t cpu_mask,
+                          ipi_function_t function,
+                          void* args)
+{
+    ipi_call_t        calls[MAX_CPU_COUNT];
+    volatile uint32_t pending;
+    uint32_t          cpu_id;
+    uint32_t          targets;
+    uint32_t          int_state;
+    uint32_t          i;
+    OS_RETURN_E       err;
+
+    if(function == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    cpu_id  = scheduler_get_current_cpu_id();
+    targets = cpu_mask & ipi_online_cpus & ~(1U << cpu_id);
+
+    /* Counted before the first post, the targets decrement it. The kernel is
+     * built without POPCNT and without libgcc.
+     */
+    pending = 0;
+    for(i = targets; i != 0; i &= i - 1)
+    {
+        ++pending;
+    }
+
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        if((targets & (1U << i)) == 0)
+        {
+            continue;
+        }
+        calls[i].function = function;
+        calls[i].args     = args;
+        calls[i].pending  = &pending;
+        calls[i].queued   = TRUE;
+        if(_ipi_push(i, &calls[i]) == TRUE)
+        {
+            err = cpu_send_ipi(i, IPI_CALL_INT_LINE);
+            IPI_ASSERT(err == OS_NO_ERR, "Could not send the call IPI", err);
+        }
+    }
+
+    /* The current CPU runs its call while the others run theirs */
+    if((cpu_mask & (1U << cpu_id)) != 0)
+    {
+        function(args);
+    }
+
+    /* The other callers might wait for this CPU with interrupts disabled */
+    while(__atomic_load_n(&pending, __ATOMIC_ACQUIRE) != 0)
+    {
+        _ipi_serve(cpu_id);
+        _cpu_pause();
+    }
+
+    KERNEL_DEBUG(IPI_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %u called CPUs 0x%x", cpu_id, targets);
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+uint32_t ipi_stop_cpus(void)
+{
+    uint32_t cpu_id;
+    uint32_t targets;
+    uint32_t i;
+    bool_t   expected;
+
+    if(ipi_online_cpus == 0)
+    {
+        return 0;
+    }
+
+    cpu_id  = scheduler_get_current_cpu_id();
+    targets = ipi_online_cpus & ~(1U << cpu_id);
+
+    /* The panic cannot wait for a busy request, the CPUs are stopped once */
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        if((targets & (1U << i)) == 0)
+        {
+            continue;
+        }
+        ipi_stop_calls[i].function = _ipi_stop;
+        expected = FALSE;
+        if(__atomic_compare_exchange_n(&ipi_stop_calls[i].queued, &expected,
+                                       TRUE, FALSE, __ATOMIC_ACQUIRE,
+                                       __ATOMIC_RELAXED) == FALSE)
+        {
+            continue;
+        }
+        if(_ipi_push(i, &ipi_stop_calls[i]) == TRUE)
+        {
+            cpu_send_ipi(i, IPI_CALL_INT_LINE);
+        }
+    }
+
+    for(i = 0;
+        i < IPI_STOP_WAIT_SPINS &&
+        (__atomic_load_n(&ipi_stopped_cpus, __ATOMIC_ACQUIRE) & targets) !=
+        targets;
+        ++i)
+    {
+        _cpu_pause();
+    }
+
+    return ipi_stopped_cpus & targets;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
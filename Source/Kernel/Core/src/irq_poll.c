@@ -0,0 +1,194 @@
+/*******************************************************************************
+ * @file irq_poll.c
+ *
+ * @see irq_poll.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's interrupt coalescing.
+ *
+ * @details Kernel's interrupt coalescing. The poll of a device is scheduled
+ * once, later interrupts only mark it as missed. A poll that exhausts its
+ * budget is scheduled again with the IRQ masked. Once the device has no more
+ * events, the IRQ is unmasked and the device polled one last time: the events
+ * that arrived while the IRQ was masked might not raise a new edge triggered
+ * interrupt.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <interrupts.h>     /* Interrupt manager */
+#include <rcu.h>            /* Container of the deferred work */
+#include <softirq.h>        /* Deferred interrupt work */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <irq_poll.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "IRQ POLL"
+
+/** @brief Poll state flag: the poll is scheduled or running. */
+#define IRQ_POLL_SCHEDULED 0x1
+/** @brief Poll state flag: an interrupt was raised while scheduled. */
+#define IRQ_POLL_MISSED    0x2
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Polls a device.
+ *
+ * @details Deferred work polling a device. Schedules the poll again while the
+ * device has events, otherwise unmasks its IRQ.
+ *
+ * @param[in] work The deferred work of the coalescing state.
+ */
+static void _irq_poll_routine(softirq_work_t* work);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void _irq_poll_routine(softirq_work_t* work)
+{
+    irq_poll_t* irq_poll;
+    uint32_t    state;
+
+    irq_poll = RCU_CONTAINER_OF(work, irq_poll_t, work);
+
+    if(irq_poll->poll(irq_poll->args, irq_poll->budget) >= irq_poll->budget)
+    {
+        (void)softirq_raise(&irq_poll->work);
+        return;
+    }
+
+    /* Catch the events that arrived while the IRQ was masked */
+    kernel_interrupt_set_irq_mask(irq_poll->irq_number, TRUE);
+    if(irq_poll->poll(irq_poll->args, irq_poll->budget) != 0)
+    {
+        kernel_interrupt_set_irq_mask(irq_poll->irq_number, FALSE);
+        (void)softirq_raise(&irq_poll->work);
+        return;
+    }
+
+    /* An interrupt raised since the last poll masked the IRQ again */
+    state = __atomic_load_n(&irq_poll->state, __ATOMIC_ACQUIRE);
+    do
+    {
+        if((state & IRQ_POLL_MISSED) != 0)
+        {
+            __atomic_store_n(&irq_poll->state, IRQ_POLL_SCHEDULED,
+                             __ATOMIC_RELEASE);
+            (void)softirq_raise(&irq_poll->work);
+            return;
+        }
+    } while(__atomic_compare_exchange_n(&irq_poll->state, &state, 0, FALSE,
+                                        __ATOMIC_ACQ_REL,
+                                        __ATOMIC_ACQUIRE) == FALSE);
+
+    KERNEL_DEBUG(IRQ_POLL_DEBUG_ENABLED, MODULE_NAME,
+                 "IRQ %u poll completed", irq_poll->irq_number);
+}
+
+OS_RETURN_E irq_poll_init(irq_poll_t* irq_poll,
+                          const uint32_t irq_number,
+                          const uint32_t budget,
+                          uint32_t (*poll)(void* args, const uint32_t budget),
+                          void* args)
+{
+    if(irq_poll == NULL || poll == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(budget == 0)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    softirq_work_init(&irq_poll->work, _irq_poll_routine);
+    irq_poll->poll       = poll;
+    irq_poll->args       = args;
+    irq_poll->irq_number = irq_number;
+    irq_poll->budget     = budget;
+    irq_poll->state      = 0;
+
+    return OS_NO_ERR;
+}
+
+void irq_poll_schedule(irq_poll_t* irq_poll)
+{
+    uint32_t state;
+    uint32_t new_state;
+
+    /* The IRQ stays masked until the device has no more events */
+    kernel_interrupt_set_irq_mask(irq_poll->irq_number, FALSE);
+
+    state = __atomic_load_n(&irq_poll->state, __ATOMIC_ACQUIRE);
+    do
+    {
+        if((state & IRQ_POLL_SCHEDULED) != 0)
+        {
+            new_state = state | IRQ_POLL_MISSED;
+        }
+        else
+        {
+            new_state = IRQ_POLL_SCHEDULED;
+        }
+    } while(__atomic_compare_exchange_n(&irq_poll->state, &state, new_state,
+                                        FALSE, __ATOMIC_ACQ_REL,
+                                        __ATOMIC_ACQUIRE) == FALSE);
+
+    if((state & IRQ_POLL_SCHEDULED) == 0)
+    {
+        (void)softirq_raise(&irq_poll->work);
+    }
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
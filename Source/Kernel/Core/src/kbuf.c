@@ -0,0 +1,509 @@
+/*******************************************************************************
+ * @file kbuf.c
+ *
+ * @see kbuf.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's chained data buffers.
+ *
+ * @details Kernel's chained data buffers. The segments and the storages are
+ * allocated from the kernel heap, whose CPU magazines serve them without lock
+ * from any context. The storage allocated with a buffer shares its heap
+ * allocation, its data follows the storage descriptor. A storage is only
+ * written while a single segment references it: the slices can then keep
+ * their view without copy.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* Memory manipulation */
+#include <kheap.h>          /* Kernel heap */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <kbuf.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "KBUF"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Creates a segment referencing a storage.
+ *
+ * @param[in, out] storage The storage of the segment, its reference count is
+ * incremented.
+ * @param[in] data The first byte of the segment, in the storage.
+ * @param[in] length The size of the segment data.
+ *
+ * @return The segment, NULL if no memory is left.
+ */
+static kbuf_t* _kbuf_new_segment(kbuf_storage_t* storage,
+                                 uint8_t* data,
+                                 const size_t length);
+
+/**
+ * @brief Releases a segment reference on its storage.
+ *
+ * @details Releases the storage with its last reference: the release
+ * callback is called for an attached storage.
+ *
+ * @param[in, out] storage The storage to dereference.
+ */
+static void _kbuf_release_storage(kbuf_storage_t* storage);
+
+/**
+ * @brief Tells if a segment storage can be written by the segment.
+ *
+ * @param[in] segment The segment.
+ *
+ * @return TRUE if the storage is writable and only referenced by the segment,
+ * FALSE otherwise.
+ */
+static bool_t _kbuf_is_exclusive(const kbuf_t* segment);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static kbuf_t* _kbuf_new_segment(kbuf_storage_t* storage,
+                                 uint8_t* data,
+                                 const size_t length)
+{
+    kbuf_t* segment;
+
+    segment = kmalloc(sizeof(kbuf_t));
+    if(segment == NULL)
+    {
+        return NULL;
+    }
+
+    segment->next    = NULL;
+    segment->storage = storage;
+    segment->data    = data;
+    segment->length  = length;
+
+    __atomic_fetch_add(&storage->refcount, 1, __ATOMIC_RELAXED);
+
+    return segment;
+}
+
+static void _kbuf_release_storage(kbuf_storage_t* storage)
+{
+    /* The last reference sees all the accesses of the other segments */
+    if(__atomic_fetch_sub(&storage->refcount, 1, __ATOMIC_ACQ_REL) != 1)
+    {
+        return;
+    }
+
+    if(storage->release != NULL)
+    {
+        storage->release(storage->start, storage->args);
+    }
+    kfree(storage);
+}
+
+static bool_t _kbuf_is_exclusive(const kbuf_t* segment)
+{
+    return (segment->storage->writable == TRUE &&
+            __atomic_load_n(&segment->storage->refcount,
+                            __ATOMIC_ACQUIRE) == 1);
+}
+
+kbuf_t* kbuf_alloc(const size_t size, const size_t headroom)
+{
+    kbuf_storage_t* storage;
+    kbuf_t*         buf;
+
+    /* Such sizes cannot be allocated, they would only overflow the sum */
+    if(size > ((size_t)-1) / 4 || headroom > ((size_t)-1) / 4)
+    {
+        return NULL;
+    }
+
+    /* The data follows the storage descriptor in the same allocation */
+    storage = kmalloc(sizeof(kbuf_storage_t) + headroom + size);
+    if(storage == NULL)
+    {
+        return NULL;
+    }
+
+    storage->refcount = 0;
+    storage->writable = TRUE;
+    storage->start    = (uint8_t*)(storage + 1);
+    storage->size     = headroom + size;
+    storage->release  = NULL;
+    storage->args     = NULL;
+
+    buf = _kbuf_new_segment(storage, storage->start + headroom, 0);
+    if(buf == NULL)
+    {
+        kfree(storage);
+    }
+
+    return buf;
+}
+
+kbuf_t* kbuf_attach(const void* data,
+                    const size_t size,
+                    kbuf_release_t release,
+                    void* args)
+{
+    kbuf_storage_t* storage;
+    kbuf_t*         buf;
+
+    if(data == NULL)
+    {
+        return NULL;
+    }
+
+    storage = kmalloc(sizeof(kbuf_storage_t));
+    if(storage == NULL)
+    {
+        return NULL;
+    }
+
+    /* The attached area is never written through the buffer */
+    storage->refcount = 0;
+    storage->writable = FALSE;
+    storage->start    = (uint8_t*)data;
+    storage->size     = size;
+    storage->release  = release;
+    storage->args     = args;
+
+    buf = _kbuf_new_segment(storage, storage->start, size);
+    if(buf == NULL)
+    {
+        kfree(storage);
+    }
+
+    return buf;
+}
+
+void kbuf_free(kbuf_t* buf)
+{
+    kbuf_t* next;
+
+    while(buf != NULL)
+    {
+        next = buf->next;
+        _kbuf_release_storage(buf->storage);
+        kfree(buf);
+        buf = next;
+    }
+}
+
+size_t kbuf_length(const kbuf_t* buf)
+{
+    size_t length;
+
+    length = 0;
+    while(buf != NULL)
+    {
+        length += buf->length;
+        buf     = buf->next;
+    }
+
+    return length;
+}
+
+void* kbuf_put(kbuf_t* buf, const size_t size)
+{
+    uint8_t* end;
+
+    if(buf == NULL)
+    {
+        return NULL;
+    }
+
+    while(buf->next != NULL)
+    {
+        buf = buf->next;
+    }
+
+    end = buf->data + buf->length;
+    if(_kbuf_is_exclusive(buf) == FALSE ||
+       size > (size_t)(buf->storage->start + buf->storage->size - end))
+    {
+        return NULL;
+    }
+
+    buf->length += size;
+
+    return end;
+}
+
+void* kbuf_push(kbuf_t* buf, const size_t size)
+{
+    if(buf == NULL || _kbuf_is_exclusive(buf) == FALSE ||
+       size > (size_t)(buf->data - buf->storage->start))
+    {
+        return NULL;
+    }
+
+    buf->data   -= size;
+    buf->length += size;
+
+    return buf->data;
+}
+
+OS_RETURN_E kbuf_pull(kbuf_t* buf, const size_t size)
+{
+    size_t left;
+    size_t chunk;
+
+    if(buf == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(kbuf_length(buf) < size)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    left = size;
+    while(left > 0)
+    {
+        chunk = buf->length;
+        if(chunk > left)
+        {
+            chunk = left;
+        }
+
+        buf->data   += chunk;
+        buf->length -= chunk;
+        left        -= chunk;
+        buf          = buf->next;
+    }
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E kbuf_trim(kbuf_t* buf, const size_t length)
+{
+    size_t left;
+
+    if(buf == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(kbuf_length(buf) < length)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    /* The chain holds enough data, the walk stops before its end */
+    left = length;
+    while(buf->length < left)
+    {
+        left -= buf->length;
+        buf   = buf->next;
+    }
+
+    buf->length = left;
+    kbuf_free(buf->next);
+    buf->next = NULL;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E kbuf_append(kbuf_t* head, kbuf_t* tail)
+{
+    if(head == NULL || tail == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(head == tail)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    while(head->next != NULL)
+    {
+        head = head->next;
+    }
+    head->next = tail;
+
+    return OS_NO_ERR;
+}
+
+kbuf_t* kbuf_slice(const kbuf_t* buf, const size_t offset, const size_t length)
+{
+    const kbuf_t* segment;
+    kbuf_t*       head;
+    kbuf_t*       tail;
+    kbuf_t*       slice;
+    size_t        total;
+    size_t        skip;
+    size_t        left;
+    size_t        chunk;
+
+    if(buf == NULL)
+    {
+        return NULL;
+    }
+
+    total = kbuf_length(buf);
+    if(offset > total || length > total - offset)
+    {
+        return NULL;
+    }
+
+    /* Find the segment holding the offset */
+    segment = buf;
+    skip    = offset;
+    while(segment->next != NULL && skip >= segment->length)
+    {
+        skip   -= segment->length;
+        segment = segment->next;
+    }
+
+    /* An empty slice still has its segment */
+    head = NULL;
+    tail = NULL;
+    left = length;
+    do
+    {
+        chunk = segment->length - skip;
+        if(chunk > left)
+        {
+            chunk = left;
+        }
+
+        slice = _kbuf_new_segment(segment->storage, segment->data + skip,
+                                  chunk);
+        if(slice == NULL)
+        {
+            kbuf_free(head);
+            return NULL;
+        }
+
+        if(head == NULL)
+        {
+            head = slice;
+        }
+        else
+        {
+            tail->next = slice;
+        }
+        tail = slice;
+
+        left   -= chunk;
+        skip    = 0;
+        segment = segment->next;
+    } while(left > 0);
+
+    return head;
+}
+
+size_t kbuf_copy_out(const kbuf_t* buf,
+                     const size_t offset,
+                     void* dest,
+                     const size_t size)
+{
+    size_t skip;
+    size_t copied;
+    size_t chunk;
+
+    if(dest == NULL)
+    {
+        return 0;
+    }
+
+    skip   = offset;
+    copied = 0;
+    while(buf != NULL && copied < size)
+    {
+        if(skip >= buf->length)
+        {
+            skip -= buf->length;
+        }
+        else
+        {
+            chunk = buf->length - skip;
+            if(chunk > size - copied)
+            {
+                chunk = size - copied;
+            }
+
+            memcpy((uint8_t*)dest + copied, buf->data + skip, chunk);
+            copied += chunk;
+            skip    = 0;
+        }
+        buf = buf->next;
+    }
+
+    return copied;
+}
+
+uint32_t kbuf_get_segments(const kbuf_t* buf,
+                           kbuf_segment_t* segments,
+                           const uint32_t max_count)
+{
+    uint32_t count;
+
+    count = 0;
+    while(buf != NULL)
+    {
+        if(buf->length != 0)
+        {
+            if(segments != NULL && count < max_count)
+            {
+                segments[count].address = buf->data;
+                segments[count].size    = buf->length;
+            }
+            ++count;
+        }
+        buf = buf->next;
+    }
+
+    return count;
+}
+
+/************************************ EOF *************************************/
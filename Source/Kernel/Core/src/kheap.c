@@ -0,0 +1,814 @@
+/*******************************************************************************
+ * @file kheap.c
+ *
+ * @see kheap.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's heap allocator.
+ *
+ * @details Kernel's heap allocator. The KERNEL_HEAP region is divided in pages
+ * described by an array of pages descriptors stored at the beginning of the
+ * region. Free pages are kept in runs of contiguous pages, released runs are
+ * merged with their free neighbours.
+ * The small allocations are served by one slab cache per power of two size
+ * class. A slab is a page cut in objects of its size class. Each CPU keeps a
+ * magazine of free objects per size class, the allocations and releases only
+ * use the magazine with interrupts disabled, without any lock. The cache is
+ * only locked to refill or flush half a magazine at a time.
+ * The large allocations are served as runs of contiguous pages.
+ * When KERNEL_MEMSTAT is enabled, the tag of the site of each allocation is
+ * stored in a byte per KHEAP_MIN_OBJECT_SIZE bytes of heap pages, placed
+ * after the pages descriptors.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <critical.h>       /* Kernel critical sections and spinlocks */
+#include <scheduler.h>      /* Current CPU identifier */
+#include <panic.h>          /* Kernel panic */
+#include <memstat.h>        /* Memory usage statistics */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <kheap.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "KHEAP"
+
+/** @brief Size of a heap page. */
+#define KHEAP_PAGE_SIZE 0x1000
+
+/** @brief Size of the smallest size class. */
+#define KHEAP_MIN_OBJECT_SIZE 16
+
+/** @brief Number of size classes, the largest one is 2048 bytes. */
+#define KHEAP_CLASS_COUNT 8
+
+/** @brief Number of objects a CPU magazine can hold. */
+#define KHEAP_MAGAZINE_SIZE 16
+
+/** @brief Number of objects moved between a magazine and its cache. */
+#define KHEAP_MAGAZINE_BATCH (KHEAP_MAGAZINE_SIZE / 2)
+
+/** @brief Page type: the page starts or ends a free run. */
+#define KHEAP_PAGE_FREE 0
+
+/** @brief Page type: the page is a slab. */
+#define KHEAP_PAGE_SLAB 1
+
+/** @brief Page type: the page starts a large allocation. */
+#define KHEAP_PAGE_LARGE 2
+
+/** @brief Page type: the page ends a large allocation of several pages. */
+#define KHEAP_PAGE_LARGE_TAIL 3
+
+/** @brief Number of allocation site tags per heap page. */
+#if KERNEL_MEMSTAT
+#define KHEAP_PAGE_TAGS (KHEAP_PAGE_SIZE / KHEAP_MIN_OBJECT_SIZE)
+#else
+#define KHEAP_PAGE_TAGS 0
+#endif
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Heap page descriptor. */
+typedef struct kheap_page
+{
+    /** @brief Next page in the free runs list or the cache partial list. */
+    struct kheap_page* next;
+
+    /** @brief Previous page in the free runs list or the cache partial list. */
+    struct kheap_page* prev;
+
+    /** @brief Free objects of the slab. */
+    void* free_objects;
+
+    /** @brief Number of pages of the run, set on its first and last pages. */
+    uint32_t run_length;
+
+    /** @brief Number of objects of the slab being used. */
+    uint16_t used;
+
+    /** @brief The page type. */
+    uint8_t type;
+
+    /** @brief The slab size class. */
+    uint8_t class_id;
+} kheap_page_t;
+
+/** @brief Slab cache of a size class. */
+typedef struct
+{
+    /** @brief The slabs that have free objects. */
+    kheap_page_t* partial;
+
+    /** @brief Lock protecting the cache and its slabs. */
+    kernel_spinlock_t lock;
+} kheap_cache_t;
+
+/** @brief CPU magazine of a size class. */
+typedef struct
+{
+    /** @brief The free objects. */
+    void* objects[KHEAP_MAGAZINE_SIZE];
+
+    /** @brief Number of free objects in the magazine. */
+    uint32_t count;
+} kheap_magazine_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Assert macro used by the kernel heap to ensure correctness of
+ * execution.
+ *
+ * @details Assert macro used by the kernel heap to ensure correctness of
+ * execution. Due to the critical nature of the kernel heap, any error
+ * generates a kernel panic.
+ *
+ * @param[in] COND The condition that should be true.
+ * @param[in] MSG The message to display in case of kernel panic.
+ * @param[in] ERROR The error code to use in case of kernel panic.
+ */
+#define KHEAP_ASSERT(COND, MSG, ERROR) {                    \
+    if((COND) == FALSE)                                     \
+    {                                                       \
+        PANIC(ERROR, MODULE_NAME, MSG, TRUE);               \
+    }                                                       \
+}
+
+/* The heap defines the allocation function the call sites macro replaces */
+#undef kmalloc
+
+_Static_assert(KHEAP_CLASS_COUNT + 1 == MEMSTAT_CLASS_COUNT,
+               "The memory statistics do not match the size classes");
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/** @brief Kernel heap region base address, defined in the linker file. */
+extern int8_t _KERNEL_HEAP_BASE[];
+
+/** @brief Kernel heap region size, defined in the linker file. */
+extern int8_t _KERNEL_HEAP_SIZE;
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Tells if the heap is initialized. */
+static bool_t kheap_initialized = FALSE;
+
+/** @brief The pages descriptors. */
+static kheap_page_t* kheap_pages;
+
+/** @brief Address of the first heap page. */
+static uintptr_t kheap_pages_base;
+
+/** @brief Number of heap pages. */
+static uint32_t kheap_page_count;
+
+/** @brief The free runs, each one is referenced by its first page. */
+static kheap_page_t* kheap_free_runs;
+
+/** @brief Lock protecting the pages descriptors and the free runs. */
+static kernel_spinlock_t kheap_pages_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/** @brief The slab caches. */
+static kheap_cache_t kheap_caches[KHEAP_CLASS_COUNT];
+
+/** @brief The CPUs magazines. */
+static kheap_magazine_t kheap_magazines[MAX_CPU_COUNT][KHEAP_CLASS_COUNT];
+
+#if KERNEL_MEMSTAT
+/** @brief The allocation site tags, one per KHEAP_MIN_OBJECT_SIZE bytes. */
+static uint8_t* kheap_tags;
+#endif
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Returns the address of a heap page.
+ *
+ * @param[in] page The page descriptor.
+ *
+ * @return The address of the page.
+ */
+inline static uintptr_t _kheap_page_address(const kheap_page_t* page);
+
+/**
+ * @brief Returns the size class of an allocation.
+ *
+ * @details Returns the smallest size class that fits the allocation,
+ * KHEAP_CLASS_COUNT is returned for the large allocations.
+ *
+ * @param[in] size The size of the allocation.
+ *
+ * @return The size class of the allocation.
+ */
+inline static uint32_t _kheap_get_class(const size_t size);
+
+/**
+ * @brief Adds a page to a pages list.
+ *
+ * @param[in, out] list The list to add the page to.
+ * @param[in, out] page The page to add.
+ */
+inline static void _kheap_list_push(kheap_page_t** list, kheap_page_t* page);
+
+/**
+ * @brief Removes a page from a pages list.
+ *
+ * @param[in, out] list The list to remove the page from.
+ * @param[in, out] page The page to remove.
+ */
+inline static void _kheap_list_remove(kheap_page_t** list, kheap_page_t* page);
+
+/**
+ * @brief Adds a free run.
+ *
+ * @details Marks the first and last pages of the run free and adds the run to
+ * the free runs. The pages lock must be held.
+ *
+ * @param[in, out] head The first page of the run.
+ * @param[in] length The number of pages of the run.
+ */
+static void _kheap_run_add(kheap_page_t* head, const uint32_t length);
+
+/**
+ * @brief Allocates a run of contiguous pages.
+ *
+ * @details Allocates a run of contiguous pages from the first free run that
+ * is large enough. The remaining pages of the free run stay free. The first
+ * page is marked with the type given as parameter and the last page as a
+ * large allocation tail.
+ *
+ * @param[in] length The number of pages to allocate.
+ * @param[in] type The type of the first page.
+ *
+ * @return The first page of the run, NULL if no free run is large enough.
+ */
+static kheap_page_t* _kheap_alloc_pages(const uint32_t length,
+                                        const uint8_t type);
+
+/**
+ * @brief Releases a run of contiguous pages.
+ *
+ * @details Releases a run of contiguous pages and merges it with the free
+ * runs placed right before and after it.
+ *
+ * @param[in, out] head The first page of the run.
+ * @param[in] length The number of pages of the run.
+ */
+static void _kheap_free_pages(kheap_page_t* head, uint32_t length);
+
+/**
+ * @brief Fills a magazine from its slab cache.
+ *
+ * @details Moves up to KHEAP_MAGAZINE_BATCH objects from the slab cache to the
+ * magazine. New slabs are created when the cache has no free object left.
+ * Interrupts must be disabled.
+ *
+ * @param[in] class_id The size class.
+ * @param[in, out] magazine The magazine to fill.
+ */
+static void _kheap_cache_refill(const uint32_t class_id,
+                                kheap_magazine_t* magazine);
+
+/**
+ * @brief Empties a magazine to its slab cache.
+ *
+ * @details Moves KHEAP_MAGAZINE_BATCH objects from the magazine back to their
+ * slabs. The slabs that become unused are released, except the last slab of
+ * the cache. Interrupts must be disabled.
+ *
+ * @param[in] class_id The size class.
+ * @param[in, out] magazine The magazine to empty.
+ */
+static void _kheap_cache_flush(const uint32_t class_id,
+                               kheap_magazine_t* magazine);
+
+/**
+ * @brief Allocates memory from a size class.
+ *
+ * @param[in] size The size of the memory to allocate in bytes, not 0.
+ * @param[in] class_id The size class of the allocation.
+ *
+ * @return A pointer to the allocated memory, NULL if no memory is left.
+ */
+inline static void* _kheap_alloc(const size_t size, const uint32_t class_id);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static uintptr_t _kheap_page_address(const kheap_page_t* page)
+{
+    return kheap_pages_base + (uintptr_t)(page - kheap_pages) * KHEAP_PAGE_SIZE;
+}
+
+inline static uint32_t _kheap_get_class(const size_t size)
+{
+    uint32_t class_id;
+    size_t   class_size;
+
+    class_id   = 0;
+    class_size = KHEAP_MIN_OBJECT_SIZE;
+    while(class_size < size && class_id < KHEAP_CLASS_COUNT)
+    {
+        class_size <<= 1;
+        ++class_id;
+    }
+
+    return class_id;
+}
+
+inline static void _kheap_list_push(kheap_page_t** list, kheap_page_t* page)
+{
+    page->prev = NULL;
+    page->next = *list;
+    if(*list != NULL)
+    {
+        (*list)->prev = page;
+    }
+    *list = page;
+}
+
+inline static void _kheap_list_remove(kheap_page_t** list, kheap_page_t* page)
+{
+    if(page->prev != NULL)
+    {
+        page->prev->next = page->next;
+    }
+    else
+    {
+        *list = page->next;
+    }
+    if(page->next != NULL)
+    {
+        page->next->prev = page->prev;
+    }
+    page->next = NULL;
+    page->prev = NULL;
+}
+
+static void _kheap_run_add(kheap_page_t* head, const uint32_t length)
+{
+    head->type                  = KHEAP_PAGE_FREE;
+    head->run_length            = length;
+    head[length - 1].type       = KHEAP_PAGE_FREE;
+    head[length - 1].run_length = length;
+
+    _kheap_list_push(&kheap_free_runs, head);
+}
+
+static kheap_page_t* _kheap_alloc_pages(const uint32_t length,
+                                        const uint8_t type)
+{
+    kheap_page_t* run;
+    uint32_t      run_length;
+
+    KERNEL_SPINLOCK_LOCK(kheap_pages_lock);
+
+    run = kheap_free_runs;
+    while(run != NULL && run->run_length < length)
+    {
+        run = run->next;
+    }
+
+    if(run != NULL)
+    {
+        run_length = run->run_length;
+        _kheap_list_remove(&kheap_free_runs, run);
+        if(run_length > length)
+        {
+            _kheap_run_add(run + length, run_length - length);
+        }
+
+        run->type       = type;
+        run->run_length = length;
+        if(length > 1)
+        {
+            run[length - 1].type       = KHEAP_PAGE_LARGE_TAIL;
+            run[length - 1].run_length = length;
+        }
+    }
+
+    KERNEL_SPINLOCK_UNLOCK(kheap_pages_lock);
+
+    return run;
+}
+
+static void _kheap_free_pages(kheap_page_t* head, uint32_t length)
+{
+    kheap_page_t* neighbour;
+
+    KERNEL_SPINLOCK_LOCK(kheap_pages_lock);
+
+    /* Merge with the next free run */
+    neighbour = head + length;
+    if(neighbour < kheap_pages + kheap_page_count &&
+       neighbour->type == KHEAP_PAGE_FREE)
+    {
+        length += neighbour->run_length;
+        _kheap_list_remove(&kheap_free_runs, neighbour);
+    }
+
+    /* Merge with the previous free run, found from its last page */
+    if(head > kheap_pages && head[-1].type == KHEAP_PAGE_FREE)
+    {
+        neighbour = head - head[-1].run_length;
+        length   += neighbour->run_length;
+        head      = neighbour;
+        _kheap_list_remove(&kheap_free_runs, neighbour);
+    }
+
+    _kheap_run_add(head, length);
+
+    KERNEL_SPINLOCK_UNLOCK(kheap_pages_lock);
+}
+
+static void _kheap_cache_refill(const uint32_t class_id,
+                                kheap_magazine_t* magazine)
+{
+    kheap_cache_t* cache;
+    kheap_page_t*  slab;
+    uintptr_t      object;
+    uintptr_t      page_end;
+    size_t         object_size;
+
+    cache       = &kheap_caches[class_id];
+    object_size = KHEAP_MIN_OBJECT_SIZE << class_id;
+
+    KERNEL_SPINLOCK_LOCK(cache->lock);
+
+    while(magazine->count < KHEAP_MAGAZINE_BATCH)
+    {
+        slab = cache->partial;
+        if(slab == NULL)
+        {
+            /* Create a new slab and cut it in objects */
+            slab = _kheap_alloc_pages(1, KHEAP_PAGE_SLAB);
+            if(slab == NULL)
+            {
+                break;
+            }
+
+            slab->class_id     = class_id;
+            slab->used         = 0;
+            slab->free_objects = NULL;
+
+            page_end = _kheap_page_address(slab) + KHEAP_PAGE_SIZE;
+            for(object = page_end - object_size;
+                object >= _kheap_page_address(slab);
+                object -= object_size)
+            {
+                *(void**)object    = slab->free_objects;
+                slab->free_objects = (void*)object;
+            }
+
+            _kheap_list_push(&cache->partial, slab);
+        }
+
+        magazine->objects[magazine->count++] = slab->free_objects;
+        slab->free_objects = *(void**)slab->free_objects;
+        ++slab->used;
+
+        if(slab->free_objects == NULL)
+        {
+            _kheap_list_remove(&cache->partial, slab);
+        }
+    }
+
+    KERNEL_SPINLOCK_UNLOCK(cache->lock);
+
+    KERNEL_DEBUG(KHEAP_DEBUG_ENABLED, MODULE_NAME,
+                 "Refilled class %d magazine, %d objects",
+                 class_id, magazine->count);
+}
+
+static void _kheap_cache_flush(const uint32_t class_id,
+                               kheap_magazine_t* magazine)
+{
+    kheap_cache_t* cache;
+    kheap_page_t*  slab;
+    void*          object;
+    uint32_t       i;
+
+    cache = &kheap_caches[class_id];
+
+    KERNEL_SPINLOCK_LOCK(cache->lock);
+
+    for(i = 0; i < KHEAP_MAGAZINE_BATCH; ++i)
+    {
+        object = magazine->objects[--magazine->count];
+        slab   = &kheap_pages[((uintptr_t)object - kheap_pages_base) /
+                              KHEAP_PAGE_SIZE];
+
+        /* A full slab gets free objects again */
+        if(slab->free_objects == NULL)
+        {
+            _kheap_list_push(&cache->partial, slab);
+        }
+        *(void**)object    = slab->free_objects;
+        slab->free_objects = object;
+        --slab->used;
+
+        /* Keep the last slab to avoid creating it again on the next refill */
+        if(slab->used == 0 &&
+           (cache->partial != slab || slab->next != NULL))
+        {
+            _kheap_list_remove(&cache->partial, slab);
+            _kheap_free_pages(slab, 1);
+        }
+    }
+
+    KERNEL_SPINLOCK_UNLOCK(cache->lock);
+
+    KERNEL_DEBUG(KHEAP_DEBUG_ENABLED, MODULE_NAME,
+                 "Flushed class %d magazine", class_id);
+}
+
+inline static void* _kheap_alloc(const size_t size, const uint32_t class_id)
+{
+    kheap_magazine_t* magazine;
+    kheap_page_t*     run;
+    void*             object;
+    uint32_t          int_state;
+
+    /* Large allocation */
+    if(class_id == KHEAP_CLASS_COUNT)
+    {
+        if(size > (size_t)kheap_page_count * KHEAP_PAGE_SIZE)
+        {
+            return NULL;
+        }
+
+        ENTER_CRITICAL(int_state);
+        run = _kheap_alloc_pages((size + KHEAP_PAGE_SIZE - 1) /
+                                 KHEAP_PAGE_SIZE,
+                                 KHEAP_PAGE_LARGE);
+        EXIT_CRITICAL(int_state);
+
+        if(run == NULL)
+        {
+            return NULL;
+        }
+        return (void*)_kheap_page_address(run);
+    }
+
+    /* The magazine is only used by this CPU, disabling interrupts is enough */
+    ENTER_CRITICAL(int_state);
+
+    magazine = &kheap_magazines[scheduler_get_current_cpu_id()][class_id];
+    if(magazine->count == 0)
+    {
+        _kheap_cache_refill(class_id, magazine);
+    }
+
+    object = NULL;
+    if(magazine->count != 0)
+    {
+        object = magazine->objects[--magazine->count];
+    }
+
+    EXIT_CRITICAL(int_state);
+
+    return object;
+}
+
+OS_RETURN_E kheap_init(void)
+{
+    uintptr_t heap_base;
+    uintptr_t heap_end;
+    uint32_t  desc_count;
+    uint32_t  i;
+
+    if(kheap_initialized == TRUE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    heap_base = (uintptr_t)_KERNEL_HEAP_BASE;
+    heap_end  = heap_base + (uintptr_t)&_KERNEL_HEAP_SIZE;
+
+    /* The pages descriptors and tags are placed before the pages */
+    kheap_pages      = (kheap_page_t*)heap_base;
+    desc_count       = (heap_end - heap_base) /
+                       (KHEAP_PAGE_SIZE + sizeof(kheap_page_t) +
+                        KHEAP_PAGE_TAGS);
+    kheap_pages_base = heap_base +
+                       desc_count * (sizeof(kheap_page_t) + KHEAP_PAGE_TAGS);
+    kheap_pages_base = (kheap_pages_base + KHEAP_PAGE_SIZE - 1) &
+                       ~(uintptr_t)(KHEAP_PAGE_SIZE - 1);
+    if(kheap_pages_base >= heap_end)
+    {
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+    kheap_page_count = (heap_end - kheap_pages_base) / KHEAP_PAGE_SIZE;
+    if(kheap_page_count > desc_count)
+    {
+        kheap_page_count = desc_count;
+    }
+    if(kheap_page_count == 0)
+    {
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+
+#if KERNEL_MEMSTAT
+    kheap_tags = (uint8_t*)(heap_base + desc_count * sizeof(kheap_page_t));
+    for(i = 0; i < kheap_page_count * KHEAP_PAGE_TAGS; ++i)
+    {
+        kheap_tags[i] = 0;
+    }
+#endif
+
+    for(i = 0; i < kheap_page_count; ++i)
+    {
+        kheap_pages[i].next         = NULL;
+        kheap_pages[i].prev         = NULL;
+        kheap_pages[i].free_objects = NULL;
+        kheap_pages[i].run_length   = 0;
+        kheap_pages[i].used         = 0;
+        kheap_pages[i].type         = KHEAP_PAGE_FREE;
+        kheap_pages[i].class_id     = 0;
+    }
+    kheap_free_runs = NULL;
+    _kheap_run_add(kheap_pages, kheap_page_count);
+
+    for(i = 0; i < KHEAP_CLASS_COUNT; ++i)
+    {
+        kheap_caches[i].partial = NULL;
+        KERNEL_SPINLOCK_INIT(kheap_caches[i].lock);
+    }
+
+    kheap_initialized = TRUE;
+
+    KERNEL_DEBUG(KHEAP_DEBUG_ENABLED, MODULE_NAME,
+                 "Heap initialized, %d pages at 0x%p",
+                 kheap_page_count, kheap_pages_base);
+
+    return OS_NO_ERR;
+}
+
+void* kmalloc(const size_t size)
+{
+#if KERNEL_MEMSTAT
+    return kmalloc_site(size, NULL);
+#else
+    if(size == 0 || kheap_initialized == FALSE)
+    {
+        return NULL;
+    }
+
+    return _kheap_alloc(size, _kheap_get_class(size));
+#endif
+}
+
+#if KERNEL_MEMSTAT
+void* kmalloc_site(const size_t size, memstat_site_t* site)
+{
+    void*    object;
+    size_t   granted;
+    uint32_t class_id;
+    uint8_t  tag;
+
+    if(size == 0 || kheap_initialized == FALSE)
+    {
+        return NULL;
+    }
+
+    class_id = _kheap_get_class(size);
+    object   = _kheap_alloc(size, class_id);
+
+    granted = 0;
+    if(object != NULL && class_id == KHEAP_CLASS_COUNT)
+    {
+        granted = (size + KHEAP_PAGE_SIZE - 1) & ~(size_t)(KHEAP_PAGE_SIZE - 1);
+    }
+    else if(object != NULL)
+    {
+        granted = (size_t)KHEAP_MIN_OBJECT_SIZE << class_id;
+    }
+
+    /* The stack is walked from the caller of the allocator */
+    tag = memstat_record_alloc(site, class_id, size, granted,
+                               (uintptr_t)__builtin_frame_address(0));
+    if(object != NULL)
+    {
+        kheap_tags[((uintptr_t)object - kheap_pages_base) /
+                   KHEAP_MIN_OBJECT_SIZE] = tag;
+    }
+
+    return object;
+}
+#endif
+
+void kfree(void* ptr)
+{
+    kheap_magazine_t* magazine;
+    kheap_page_t*     page;
+    uintptr_t         address;
+    uint32_t          int_state;
+
+    if(ptr == NULL)
+    {
+        return;
+    }
+
+    address = (uintptr_t)ptr;
+    KHEAP_ASSERT(kheap_initialized == TRUE &&
+                 address >= kheap_pages_base &&
+                 address < kheap_pages_base +
+                           (uintptr_t)kheap_page_count * KHEAP_PAGE_SIZE,
+                 "Released memory is outside the kernel heap",
+                 OS_ERR_UNAUTHORIZED_ACTION);
+
+    page = &kheap_pages[(address - kheap_pages_base) / KHEAP_PAGE_SIZE];
+
+    /* Large allocation */
+    if(page->type == KHEAP_PAGE_LARGE)
+    {
+        KHEAP_ASSERT(address == _kheap_page_address(page),
+                     "Released memory is not an allocation",
+                     OS_ERR_UNAUTHORIZED_ACTION);
+
+#if KERNEL_MEMSTAT
+        memstat_record_free(kheap_tags[(address - kheap_pages_base) /
+                                       KHEAP_MIN_OBJECT_SIZE],
+                            KHEAP_CLASS_COUNT,
+                            (size_t)page->run_length * KHEAP_PAGE_SIZE);
+#endif
+
+        ENTER_CRITICAL(int_state);
+        _kheap_free_pages(page, page->run_length);
+        EXIT_CRITICAL(int_state);
+        return;
+    }
+
+    KHEAP_ASSERT(page->type == KHEAP_PAGE_SLAB &&
+                 ((address - _kheap_page_address(page)) &
+                  ((KHEAP_MIN_OBJECT_SIZE << page->class_id) - 1)) == 0,
+                 "Released memory is not an allocation",
+                 OS_ERR_UNAUTHORIZED_ACTION);
+
+#if KERNEL_MEMSTAT
+    memstat_record_free(kheap_tags[(address - kheap_pages_base) /
+                                   KHEAP_MIN_OBJECT_SIZE],
+                        page->class_id,
+                        (size_t)KHEAP_MIN_OBJECT_SIZE << page->class_id);
+#endif
+
+    /* The magazine is only used by this CPU, disabling interrupts is enough */
+    ENTER_CRITICAL(int_state);
+
+    magazine = &kheap_magazines[scheduler_get_current_cpu_id()]
+                               [page->class_id];
+    if(magazine->count == KHEAP_MAGAZINE_SIZE)
+    {
+        _kheap_cache_flush(page->class_id, magazine);
+    }
+    magazine->objects[magazine->count++] = ptr;
+
+    EXIT_CRITICAL(int_state);
+}
+
+size_t kheap_get_class_size(const uint32_t class_id)
+{
+    if(class_id >= KHEAP_CLASS_COUNT)
+    {
+        return 0;
+    }
+
+    return (size_t)KHEAP_MIN_OBJECT_SIZE << class_id;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
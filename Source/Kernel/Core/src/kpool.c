@@ -0,0 +1,285 @@
+/*******************************************************************************
+ * @file kpool.c
+ *
+ * @see kpool.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's fixed-size objects pools.
+ *
+ * @details Kernel's fixed-size objects pools. The free objects of a pool are
+ * linked through their first word, allocating and releasing an object is done
+ * in constant time. When the CPUs caches are used, each CPU keeps some free
+ * objects that it allocates and releases with interrupts disabled, without
+ * any lock. The pool is only locked to refill or flush half a CPU cache at a
+ * time.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <critical.h>       /* Kernel critical sections and spinlocks */
+#include <scheduler.h>      /* Current CPU identifier */
+#include <panic.h>          /* Kernel panic */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <kpool.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "KPOOL"
+
+/** @brief Number of objects moved between a CPU cache and its pool. */
+#define KPOOL_CPU_CACHE_BATCH (KPOOL_CPU_CACHE_SIZE / 2)
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Assert macro used by the pools to ensure correctness of execution.
+ *
+ * @details Assert macro used by the pools to ensure correctness of execution.
+ * Due to the critical nature of the pools, any error generates a kernel
+ * panic.
+ *
+ * @param[in] COND The condition that should be true.
+ * @param[in] MSG The message to display in case of kernel panic.
+ * @param[in] ERROR The error code to use in case of kernel panic.
+ */
+#define KPOOL_ASSERT(COND, MSG, ERROR) {                    \
+    if((COND) == FALSE)                                     \
+    {                                                       \
+        PANIC(ERROR, MODULE_NAME, MSG, TRUE);               \
+    }                                                       \
+}
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Removes an object from the pool free list.
+ *
+ * @details Removes an object from the pool free list. The pool lock must be
+ * held.
+ *
+ * @param[in, out] pool The pool.
+ *
+ * @return The removed object, NULL if the free list is empty.
+ */
+inline static void* _kpool_pop(kpool_t* pool);
+
+/**
+ * @brief Adds an object to the pool free list.
+ *
+ * @details Adds an object to the pool free list. The pool lock must be held.
+ *
+ * @param[in, out] pool The pool.
+ * @param[in, out] object The object to add.
+ */
+inline static void _kpool_push(kpool_t* pool, void* object);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static void* _kpool_pop(kpool_t* pool)
+{
+    void* object;
+
+    object = pool->free_objects;
+    if(object != NULL)
+    {
+        pool->free_objects = *(void**)object;
+    }
+
+    return object;
+}
+
+inline static void _kpool_push(kpool_t* pool, void* object)
+{
+    *(void**)object    = pool->free_objects;
+    pool->free_objects = object;
+}
+
+OS_RETURN_E kpool_init(kpool_t* pool,
+                       void* memory,
+                       const size_t object_size,
+                       const uint32_t capacity,
+                       const bool_t cpu_cache)
+{
+    uint32_t i;
+
+    if(pool == NULL || memory == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(((uintptr_t)memory & (CPU_CACHE_LINE_SIZE - 1)) != 0 ||
+       object_size < sizeof(void*) ||
+       capacity == 0)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    pool->base              = (uintptr_t)memory;
+    pool->stride            = KPOOL_STRIDE(object_size);
+    pool->capacity          = capacity;
+    pool->free_objects      = NULL;
+    KERNEL_SPINLOCK_INIT(pool->lock);
+    pool->cpu_cache_enabled = cpu_cache;
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        pool->cpu_caches[i].count = 0;
+    }
+
+    /* Link from the last object to allocate the first objects first */
+    for(i = capacity; i > 0; --i)
+    {
+        _kpool_push(pool, (void*)(pool->base + (i - 1) * pool->stride));
+    }
+
+    return OS_NO_ERR;
+}
+
+void* kpool_alloc(kpool_t* pool)
+{
+    kpool_cpu_cache_t* cache;
+    void*              object;
+    uint32_t           int_state;
+
+    ENTER_CRITICAL(int_state);
+
+    if(pool->cpu_cache_enabled == FALSE)
+    {
+        KERNEL_SPINLOCK_LOCK(pool->lock);
+        object = _kpool_pop(pool);
+        KERNEL_SPINLOCK_UNLOCK(pool->lock);
+
+        EXIT_CRITICAL(int_state);
+        return object;
+    }
+
+    /* The cache is only used by this CPU, disabling interrupts is enough */
+    cache = &pool->cpu_caches[scheduler_get_current_cpu_id()];
+    if(cache->count == 0)
+    {
+        KERNEL_SPINLOCK_LOCK(pool->lock);
+        while(cache->count < KPOOL_CPU_CACHE_BATCH)
+        {
+            object = _kpool_pop(pool);
+            if(object == NULL)
+            {
+                break;
+            }
+            cache->objects[cache->count++] = object;
+        }
+        KERNEL_SPINLOCK_UNLOCK(pool->lock);
+    }
+
+    object = NULL;
+    if(cache->count != 0)
+    {
+        object = cache->objects[--cache->count];
+    }
+
+    EXIT_CRITICAL(int_state);
+
+    return object;
+}
+
+void kpool_free(kpool_t* pool, void* object)
+{
+    kpool_cpu_cache_t* cache;
+    uint32_t           int_state;
+    uint32_t           i;
+
+    if(object == NULL)
+    {
+        return;
+    }
+
+    KPOOL_ASSERT(kpool_contains(pool, object) == TRUE,
+                 "Released object does not belong to the pool",
+                 OS_ERR_UNAUTHORIZED_ACTION);
+
+    ENTER_CRITICAL(int_state);
+
+    if(pool->cpu_cache_enabled == FALSE)
+    {
+        KERNEL_SPINLOCK_LOCK(pool->lock);
+        _kpool_push(pool, object);
+        KERNEL_SPINLOCK_UNLOCK(pool->lock);
+
+        EXIT_CRITICAL(int_state);
+        return;
+    }
+
+    /* The cache is only used by this CPU, disabling interrupts is enough */
+    cache = &pool->cpu_caches[scheduler_get_current_cpu_id()];
+    if(cache->count == KPOOL_CPU_CACHE_SIZE)
+    {
+        KERNEL_SPINLOCK_LOCK(pool->lock);
+        for(i = 0; i < KPOOL_CPU_CACHE_BATCH; ++i)
+        {
+            _kpool_push(pool, cache->objects[--cache->count]);
+        }
+        KERNEL_SPINLOCK_UNLOCK(pool->lock);
+    }
+    cache->objects[cache->count++] = object;
+
+    EXIT_CRITICAL(int_state);
+}
+
+bool_t kpool_contains(const kpool_t* pool, const void* object)
+{
+    uintptr_t address;
+
+    address = (uintptr_t)object;
+    if(address < pool->base ||
+       address >= pool->base + (uintptr_t)pool->capacity * pool->stride)
+    {
+        return FALSE;
+    }
+
+    return ((address - pool->base) % pool->stride) == 0;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
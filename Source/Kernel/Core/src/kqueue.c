@@ -0,0 +1,184 @@
+/*******************************************************************************
+ * @file kqueue.c
+ *
+ * @see kqueue.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's intrusive queues.
+ *
+ * @details Kernel's intrusive queues. The queues are doubly linked lists
+ * whose nodes are owned by the queued objects.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <kernel_output.h>  /* Kernel output methods */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <kqueue.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "KQUEUE"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+void kqueue_init(kqueue_t* queue)
+{
+    queue->head = NULL;
+    queue->tail = NULL;
+    queue->size = 0;
+}
+
+void kqueue_node_init(kqueue_node_t* node)
+{
+    node->next     = NULL;
+    node->prev     = NULL;
+    node->enlisted = FALSE;
+}
+
+void kqueue_push(kqueue_t* queue, kqueue_node_t* node)
+{
+    if(node->enlisted == TRUE)
+    {
+        KERNEL_DEBUG(KQUEUE_DEBUG_ENABLED, MODULE_NAME,
+                     "Node 0x%p already queued", node);
+        return;
+    }
+
+    node->next     = NULL;
+    node->prev     = queue->tail;
+    node->enlisted = TRUE;
+
+    if(queue->tail != NULL)
+    {
+        queue->tail->next = node;
+    }
+    else
+    {
+        queue->head = node;
+    }
+    queue->tail = node;
+    ++queue->size;
+}
+
+void kqueue_push_front(kqueue_t* queue, kqueue_node_t* node)
+{
+    if(node->enlisted == TRUE)
+    {
+        KERNEL_DEBUG(KQUEUE_DEBUG_ENABLED, MODULE_NAME,
+                     "Node 0x%p already queued", node);
+        return;
+    }
+
+    node->next     = queue->head;
+    node->prev     = NULL;
+    node->enlisted = TRUE;
+
+    if(queue->head != NULL)
+    {
+        queue->head->prev = node;
+    }
+    else
+    {
+        queue->tail = node;
+    }
+    queue->head = node;
+    ++queue->size;
+}
+
+kqueue_node_t* kqueue_pop(kqueue_t* queue)
+{
+    kqueue_node_t* node;
+
+    node = queue->head;
+    if(node != NULL)
+    {
+        kqueue_remove(queue, node);
+    }
+
+    return node;
+}
+
+void kqueue_remove(kqueue_t* queue, kqueue_node_t* node)
+{
+    if(node->enlisted == FALSE)
+    {
+        return;
+    }
+
+    if(node->prev != NULL)
+    {
+        node->prev->next = node->next;
+    }
+    else
+    {
+        queue->head = node->next;
+    }
+    if(node->next != NULL)
+    {
+        node->next->prev = node->prev;
+    }
+    else
+    {
+        queue->tail = node->prev;
+    }
+
+    node->next     = NULL;
+    node->prev     = NULL;
+    node->enlisted = FALSE;
+    --queue->size;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,507 @@
+/*******************************************************************************
+ * @file kstack.c
+ *
+ * @see kstack.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's threads stacks.
+ *
+ * @details Kernel's threads stacks. A stack slot is aligned on its size and
+ * does not cross a last level paging structure: the committed top page keeps
+ * the structure of the slot allocated, the page fault handler only writes a
+ * page entry. The fault handler cannot take the physical memory manager lock,
+ * the faulting thread might hold it, the frames come from a per-CPU reserve
+ * refilled in thread context.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <cpu.h>            /* Fault stack support */
+#include <critical.h>       /* Kernel critical sections and spinlocks */
+#include <percpu.h>         /* Per-CPU variables */
+#include <memmgt.h>         /* Physical frames */
+#include <vmm.h>            /* Kernel mappings */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <kstack.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "KSTACK"
+
+/** @brief Number of stack slots. */
+#define KSTACK_SLOT_COUNT KERNEL_MAX_THREAD_COUNT
+
+/** @brief Size of the guard page starting each slot. */
+#define KSTACK_GUARD_SIZE VMM_PAGE_SIZE
+
+/** @brief Number of pages of a slot. */
+#define KSTACK_PAGE_COUNT (KERNEL_THREAD_STACK_SIZE / VMM_PAGE_SIZE)
+
+/** @brief Number of frames kept per CPU for the page faults. */
+#define KSTACK_RESERVE_SIZE 4
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Stack slot states. */
+typedef enum
+{
+    /** @brief No page of the slot is committed. */
+    KSTACK_SLOT_EMPTY = 0,
+    /** @brief The slot is free, its top page is committed. */
+    KSTACK_SLOT_FREE,
+    /** @brief The slot is allocated. */
+    KSTACK_SLOT_USED,
+    /** @brief The slot is free, its pages are still committed. */
+    KSTACK_SLOT_RELEASED,
+    /** @brief The slot pages are being given back. */
+    KSTACK_SLOT_RECLAIMING
+} KSTACK_SLOT_STATE_E;
+
+/** @brief Page fault frames reserve of a CPU. The fault handler only empties
+ * entries, the refill only fills the empty ones: they never race on an entry.
+ */
+typedef struct
+{
+    /** @brief The reserved frames, 0 for an empty entry. */
+    uintptr_t frames[KSTACK_RESERVE_SIZE];
+} kstack_reserve_t;
+
+/* The slots are aligned on their size and start with a guard page */
+_Static_assert((KERNEL_THREAD_STACK_SIZE &
+                (KERNEL_THREAD_STACK_SIZE - 1)) == 0,
+               "The thread stack size must be a power of 2");
+_Static_assert(KERNEL_THREAD_STACK_SIZE >= 2 * VMM_PAGE_SIZE,
+               "The thread stack must hold a guard page and a stack page");
+_Static_assert((KERNEL_THREAD_STACKS_BASE &
+                (KERNEL_THREAD_STACK_SIZE - 1)) == 0,
+               "The threads stacks area must be aligned on the stack size");
+
+/* The top page keeps the last level structure of the slot allocated */
+_Static_assert(KERNEL_THREAD_STACK_SIZE <=
+               ((uintptr_t)VMM_PAGE_SIZE << CPU_PAGING_LEVEL_BITS),
+               "A thread stack must not cross a last level paging structure");
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Returns the base address of a stack slot.
+ *
+ * @param[in] SLOT The slot index.
+ */
+#define KSTACK_SLOT_BASE(SLOT)                                          \
+    ((uintptr_t)KERNEL_THREAD_STACKS_BASE +                             \
+     (uintptr_t)(SLOT) * KERNEL_THREAD_STACK_SIZE)
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Slots states, read without lock by the page fault handler. */
+static uint8_t kstack_slots[KSTACK_SLOT_COUNT];
+
+/** @brief Number of released slots, the idle CPUs skip the slots scan when
+ * none is released.
+ */
+static uint32_t kstack_released = 0;
+
+/** @brief Slots states lock. */
+static kernel_spinlock_t kstack_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/** @brief Allocation preference of the slots states, the slots with the most
+ * committed pages are reused first.
+ */
+static const uint8_t kstack_reuse_rank[] = {
+    [KSTACK_SLOT_EMPTY]      = 1,
+    [KSTACK_SLOT_FREE]       = 2,
+    [KSTACK_SLOT_USED]       = 0,
+    [KSTACK_SLOT_RELEASED]   = 3,
+    [KSTACK_SLOT_RECLAIMING] = 0
+};
+
+/** @brief Page fault frames reserve of each CPU. */
+static PERCPU_DEFINE(kstack_reserve_t, kstack_reserve);
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Gives back the pages of a range.
+ *
+ * @details Gives back the frames of the pages mapped in a range. The frames
+ * are released once the range is unmapped from all the CPUs TLBs.
+ *
+ * @param[in] virt The range address, page aligned.
+ * @param[in] size The range size, at most a slot.
+ */
+static void _kstack_decommit(const uintptr_t virt, const size_t size);
+
+/**
+ * @brief Commits the pages of a range.
+ *
+ * @param[in] virt The range address, page aligned.
+ * @param[in] size The range size, at most a slot.
+ *
+ * @return The success state or the error code, nothing is committed on error.
+ */
+static OS_RETURN_E _kstack_commit(const uintptr_t virt, const size_t size);
+
+/**
+ * @brief Fills the empty entries of the calling CPU page fault reserve.
+ */
+static void _kstack_refill(void);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void _kstack_decommit(const uintptr_t virt, const size_t size)
+{
+    uintptr_t   frames[KSTACK_PAGE_COUNT];
+    uint32_t    count;
+    uint32_t    i;
+    OS_RETURN_E err;
+
+    count = 0;
+    for(i = 0; i < size / VMM_PAGE_SIZE; ++i)
+    {
+        if(vmm_get_physical(virt + i * VMM_PAGE_SIZE,
+                            &frames[count]) == OS_NO_ERR)
+        {
+            ++count;
+        }
+    }
+    if(count == 0)
+    {
+        return;
+    }
+
+    /* A frame still mapped is lost rather than reused */
+    err = vmm_unmap(virt, size);
+    if(err != OS_NO_ERR)
+    {
+        KERNEL_ERROR("Could not unmap the stack pages at 0x%p: %d\n",
+                     virt, err);
+        return;
+    }
+
+    for(i = 0; i < count; ++i)
+    {
+        (void)memmgt_free_frames(frames[i], 0);
+    }
+}
+
+static OS_RETURN_E _kstack_commit(const uintptr_t virt, const size_t size)
+{
+    uintptr_t   frame;
+    uintptr_t   page;
+    OS_RETURN_E err;
+
+    for(page = virt; page < virt + size; page += VMM_PAGE_SIZE)
+    {
+        err = memmgt_alloc_frames(0, &frame);
+        if(err == OS_NO_ERR)
+        {
+            err = vmm_map(page, frame, VMM_PAGE_SIZE, VMM_FLAG_WRITE);
+            if(err != OS_NO_ERR)
+            {
+                (void)memmgt_free_frames(frame, 0);
+            }
+        }
+        if(err != OS_NO_ERR)
+        {
+            _kstack_decommit(virt, page - virt);
+            return OS_ERR_NO_MORE_MEMORY;
+        }
+    }
+
+    return OS_NO_ERR;
+}
+
+static void _kstack_refill(void)
+{
+    kstack_reserve_t* reserve;
+    uintptr_t         frame;
+    uint32_t          int_state;
+    uint32_t          i;
+
+    /* The reserve stays the one of the current CPU */
+    ENTER_CRITICAL(int_state);
+
+    reserve = PERCPU_THIS_PTR(kstack_reserve);
+    for(i = 0; i < KSTACK_RESERVE_SIZE; ++i)
+    {
+        if(__atomic_load_n(&reserve->frames[i], __ATOMIC_RELAXED) != 0)
+        {
+            continue;
+        }
+        if(memmgt_alloc_frames(0, &frame) != OS_NO_ERR)
+        {
+            break;
+        }
+        __atomic_store_n(&reserve->frames[i], frame, __ATOMIC_RELAXED);
+    }
+
+    EXIT_CRITICAL(int_state);
+}
+
+OS_RETURN_E kstack_alloc(uintptr_t* stack, size_t* size)
+{
+    KSTACK_SLOT_STATE_E state;
+    uintptr_t           base;
+    uint32_t            slot;
+    uint32_t            int_state;
+    uint32_t            i;
+    OS_RETURN_E         err;
+
+    if(stack == NULL || size == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    /* Reuse the committed pages first */
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(kstack_lock, int_state);
+    slot = KSTACK_SLOT_COUNT;
+    for(i = 0; i < KSTACK_SLOT_COUNT; ++i)
+    {
+        if(kstack_reuse_rank[kstack_slots[i]] != 0 &&
+           (slot == KSTACK_SLOT_COUNT ||
+            kstack_reuse_rank[kstack_slots[i]] >
+            kstack_reuse_rank[kstack_slots[slot]]))
+        {
+            slot = i;
+        }
+    }
+    if(slot == KSTACK_SLOT_COUNT)
+    {
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(kstack_lock, int_state);
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+    state = kstack_slots[slot];
+    if(state == KSTACK_SLOT_RELEASED)
+    {
+        --kstack_released;
+    }
+    __atomic_store_n(&kstack_slots[slot], KSTACK_SLOT_USED, __ATOMIC_RELEASE);
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(kstack_lock, int_state);
+
+    base = KSTACK_SLOT_BASE(slot);
+    if(state == KSTACK_SLOT_EMPTY)
+    {
+        /* Without fault stack, the faults on the stack cannot be delivered */
+        if(CPU_FAULT_STACK_ENABLED != 0)
+        {
+            err = _kstack_commit(base + KERNEL_THREAD_STACK_SIZE -
+                                 VMM_PAGE_SIZE, VMM_PAGE_SIZE);
+        }
+        else
+        {
+            err = _kstack_commit(base + KSTACK_GUARD_SIZE,
+                                 KERNEL_THREAD_STACK_SIZE - KSTACK_GUARD_SIZE);
+        }
+        if(err != OS_NO_ERR)
+        {
+            KERNEL_SPINLOCK_LOCK_IRQSAVE(kstack_lock, int_state);
+            kstack_slots[slot] = KSTACK_SLOT_EMPTY;
+            KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(kstack_lock, int_state);
+            return err;
+        }
+    }
+
+    if(CPU_FAULT_STACK_ENABLED != 0)
+    {
+        _kstack_refill();
+    }
+
+    *stack = base + KSTACK_GUARD_SIZE;
+    *size  = KERNEL_THREAD_STACK_SIZE - KSTACK_GUARD_SIZE;
+
+    KERNEL_DEBUG(KSTACK_DEBUG_ENABLED, MODULE_NAME,
+                 "Allocated stack %u at 0x%p, state %u", slot, *stack, state);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E kstack_free(const uintptr_t stack)
+{
+    uint32_t slot;
+    uint32_t int_state;
+
+    if(stack < KSTACK_SLOT_BASE(0) + KSTACK_GUARD_SIZE ||
+       stack >= KSTACK_SLOT_BASE(KSTACK_SLOT_COUNT) ||
+       ((stack - KSTACK_GUARD_SIZE) & (KERNEL_THREAD_STACK_SIZE - 1)) != 0)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+    slot = (stack - KSTACK_SLOT_BASE(0)) / KERNEL_THREAD_STACK_SIZE;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(kstack_lock, int_state);
+    if(kstack_slots[slot] != KSTACK_SLOT_USED)
+    {
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(kstack_lock, int_state);
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    /* Eagerly committed stacks keep their pages */
+    if(CPU_FAULT_STACK_ENABLED != 0)
+    {
+        kstack_slots[slot] = KSTACK_SLOT_RELEASED;
+        ++kstack_released;
+    }
+    else
+    {
+        kstack_slots[slot] = KSTACK_SLOT_FREE;
+    }
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(kstack_lock, int_state);
+
+    KERNEL_DEBUG(KSTACK_DEBUG_ENABLED, MODULE_NAME,
+                 "Released stack %u at 0x%p", slot, stack);
+
+    return OS_NO_ERR;
+}
+
+void kstack_reclaim(void)
+{
+    uint32_t slot;
+    uint32_t int_state;
+
+    if(CPU_FAULT_STACK_ENABLED == 0)
+    {
+        return;
+    }
+
+    _kstack_refill();
+
+    while(__atomic_load_n(&kstack_released, __ATOMIC_RELAXED) != 0)
+    {
+        KERNEL_SPINLOCK_LOCK_IRQSAVE(kstack_lock, int_state);
+        for(slot = 0; slot < KSTACK_SLOT_COUNT; ++slot)
+        {
+            if(kstack_slots[slot] == KSTACK_SLOT_RELEASED)
+            {
+                kstack_slots[slot] = KSTACK_SLOT_RECLAIMING;
+                --kstack_released;
+                break;
+            }
+        }
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(kstack_lock, int_state);
+
+        if(slot == KSTACK_SLOT_COUNT)
+        {
+            break;
+        }
+
+        /* The top page is kept, the next allocation does not commit it */
+        _kstack_decommit(KSTACK_SLOT_BASE(slot) + KSTACK_GUARD_SIZE,
+                         KERNEL_THREAD_STACK_SIZE - KSTACK_GUARD_SIZE -
+                         VMM_PAGE_SIZE);
+
+        KERNEL_SPINLOCK_LOCK_IRQSAVE(kstack_lock, int_state);
+        kstack_slots[slot] = KSTACK_SLOT_FREE;
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(kstack_lock, int_state);
+
+        KERNEL_DEBUG(KSTACK_DEBUG_ENABLED, MODULE_NAME,
+                     "Reclaimed stack %u", slot);
+    }
+}
+
+bool_t kstack_handle_fault(const uintptr_t address)
+{
+    kstack_reserve_t* reserve;
+    uintptr_t         frame;
+    uint32_t          slot;
+    uint32_t          i;
+
+    if(CPU_FAULT_STACK_ENABLED == 0 ||
+       address < KSTACK_SLOT_BASE(0) ||
+       address >= KSTACK_SLOT_BASE(KSTACK_SLOT_COUNT))
+    {
+        return FALSE;
+    }
+
+    /* A fault in the guard page is a stack overflow */
+    slot = (address - KSTACK_SLOT_BASE(0)) / KERNEL_THREAD_STACK_SIZE;
+    if(address - KSTACK_SLOT_BASE(slot) < KSTACK_GUARD_SIZE ||
+       __atomic_load_n(&kstack_slots[slot], __ATOMIC_ACQUIRE) !=
+       KSTACK_SLOT_USED)
+    {
+        return FALSE;
+    }
+
+    /* The interrupts are disabled, the reserve is the one of this CPU */
+    reserve = PERCPU_THIS_PTR(kstack_reserve);
+    for(i = 0; i < KSTACK_RESERVE_SIZE; ++i)
+    {
+        frame = __atomic_load_n(&reserve->frames[i], __ATOMIC_RELAXED);
+        if(frame != 0)
+        {
+            break;
+        }
+    }
+    if(i == KSTACK_RESERVE_SIZE)
+    {
+        return FALSE;
+    }
+
+    if(vmm_map_fault(address & ~((uintptr_t)VMM_PAGE_SIZE - 1), frame,
+                     VMM_FLAG_WRITE) != OS_NO_ERR)
+    {
+        return FALSE;
+    }
+    __atomic_store_n(&reserve->frames[i], 0, __ATOMIC_RELAXED);
+
+    return TRUE;
+}
+
+bool_t kstack_get_bounds(const uintptr_t address,
+                         uintptr_t* low,
+                         uintptr_t* high)
+{
+    uintptr_t base;
+
+    if(address < KSTACK_SLOT_BASE(0) ||
+       address >= KSTACK_SLOT_BASE(KSTACK_SLOT_COUNT))
+    {
+        return FALSE;
+    }
+
+    base  = address & ~((uintptr_t)KERNEL_THREAD_STACK_SIZE - 1);
+    *low  = base + KSTACK_GUARD_SIZE;
+    *high = base + KERNEL_THREAD_STACK_SIZE;
+
+    return TRUE;
+}
+
+/************************************ EOF *************************************/
@@ -0,0 +1,425 @@
+/*******************************************************************************
+ * @file ktask.c
+ *
+ * @see ktask.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's stackless cooperative tasks.
+ *
+ * @details Kernel's stackless cooperative tasks. The ready queue of an
+ * executor is protected by its lock with interrupts disabled, the tasks are
+ * woken up from any context. The task state is changed atomically: a wakeup
+ * only queues a waiting task, a wakeup during a step is recorded in the state
+ * and checked by the executor when the step returns KTASK_WAIT.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* Memory manipulation */
+#include <cpu.h>            /* CPU cache line size */
+#include <critical.h>       /* Kernel critical sections and spinlocks */
+#include <scheduler.h>      /* Kernel scheduler */
+#include <kheap.h>          /* Kernel heap */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <ktask.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "KTASK"
+
+/** @brief Executor threads name. */
+#define KTASK_THREAD_NAME "ktask"
+
+/** @brief Executor threads priority, the tasks run after the deferred
+ * interrupt work.
+ */
+#define KTASK_THREAD_PRIORITY (KERNEL_HIGHEST_PRIORITY + 1)
+
+/** @brief Task state: created, not started. */
+#define KTASK_STATE_CREATED 0
+/** @brief Task state: waiting for a wakeup. */
+#define KTASK_STATE_WAITING 1
+/** @brief Task state: in the ready queue of its executor. */
+#define KTASK_STATE_QUEUED  2
+/** @brief Task state: its step runs. */
+#define KTASK_STATE_RUNNING 3
+/** @brief Task state: its step runs and it was woken up meanwhile. */
+#define KTASK_STATE_WOKEN   4
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Per-CPU executor data. */
+typedef struct
+{
+    /** @brief First ready task. */
+    ktask_t* head;
+
+    /** @brief Last ready task. */
+    ktask_t* tail;
+
+    /** @brief The executor thread. */
+    kernel_thread_t* executor;
+
+    /** @brief The executor thread when waiting for a task, NULL otherwise. */
+    kernel_thread_t* waiter;
+
+    /** @brief Protects the queue, the tasks are woken up from any context. */
+    kernel_spinlock_t lock;
+} __attribute__((aligned(CPU_CACHE_LINE_SIZE))) ktask_cpu_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Per-CPU executor data. */
+static ktask_cpu_t ktask_cpus[MAX_CPU_COUNT] = {
+    [0 ... MAX_CPU_COUNT - 1] = {
+        .head     = NULL,
+        .tail     = NULL,
+        .executor = NULL,
+        .waiter   = NULL,
+        .lock     = KERNEL_SPINLOCK_INIT_VALUE
+    }
+};
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Adds a task to the ready queue of its executor.
+ *
+ * @details Wakes up the executor thread if it waits for a task.
+ *
+ * @param[in, out] task The task, in the KTASK_STATE_QUEUED state.
+ */
+static void _ktask_enqueue(ktask_t* task);
+
+/**
+ * @brief Runs a step of a task and handles its status.
+ *
+ * @param[in, out] task The task removed from the ready queue.
+ */
+static void _ktask_run(ktask_t* task);
+
+/**
+ * @brief Executor thread routine.
+ *
+ * @details Executor thread routine. Runs the ready tasks of its CPU one step
+ * at a time and waits when the queue is empty.
+ *
+ * @param[in] args The identifier of the CPU.
+ *
+ * @return The function never returns.
+ */
+static void* _ktask_executor_routine(void* args);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void _ktask_enqueue(ktask_t* task)
+{
+    ktask_cpu_t*     cpu;
+    kernel_thread_t* waiter;
+    uint32_t         int_state;
+
+    cpu = &ktask_cpus[task->cpu_id];
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(cpu->lock, int_state);
+
+    task->next = NULL;
+    if(cpu->tail == NULL)
+    {
+        cpu->head = task;
+    }
+    else
+    {
+        cpu->tail->next = task;
+    }
+    cpu->tail = task;
+
+    waiter      = cpu->waiter;
+    cpu->waiter = NULL;
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(cpu->lock, int_state);
+
+    if(waiter != NULL)
+    {
+        (void)scheduler_wakeup_thread(waiter);
+    }
+}
+
+static void _ktask_run(ktask_t* task)
+{
+    KTASK_STATUS_E status;
+    uint32_t       expected;
+
+    /* A wakeup of a queued task leaves it queued, it runs now */
+    __atomic_store_n(&task->state, KTASK_STATE_RUNNING, __ATOMIC_SEQ_CST);
+
+    status = task->step(task);
+    if(status == KTASK_DONE)
+    {
+        KERNEL_DEBUG(KTASK_DEBUG_ENABLED, MODULE_NAME,
+                     "Task 0x%p ended on CPU %u", task, task->cpu_id);
+        kfree(task);
+        return;
+    }
+
+    /* The wakeups received during the step make the task ready again */
+    expected = KTASK_STATE_RUNNING;
+    if(status == KTASK_WAIT &&
+       __atomic_compare_exchange_n(&task->state, &expected,
+                                   KTASK_STATE_WAITING, FALSE,
+                                   __ATOMIC_SEQ_CST,
+                                   __ATOMIC_SEQ_CST) == TRUE)
+    {
+        return;
+    }
+
+    __atomic_store_n(&task->state, KTASK_STATE_QUEUED, __ATOMIC_SEQ_CST);
+    _ktask_enqueue(task);
+}
+
+static void* _ktask_executor_routine(void* args)
+{
+    ktask_cpu_t* cpu;
+    ktask_t*     task;
+    uint32_t     int_state;
+    OS_RETURN_E  err;
+
+    cpu = &ktask_cpus[(uint32_t)(uintptr_t)args];
+
+    while(TRUE)
+    {
+        KERNEL_SPINLOCK_LOCK_IRQSAVE(cpu->lock, int_state);
+
+        while(cpu->head == NULL)
+        {
+            /* The wait releases the lock once the thread is waiting */
+            cpu->waiter = cpu->executor;
+            err = scheduler_wait_thread(THREAD_WAIT_TYPE_RESOURCE, &cpu->lock);
+            KERNEL_SPINLOCK_LOCK(cpu->lock);
+            if(err != OS_NO_ERR)
+            {
+                cpu->waiter = NULL;
+                break;
+            }
+        }
+
+        task = cpu->head;
+        if(task != NULL)
+        {
+            cpu->head = task->next;
+            if(cpu->head == NULL)
+            {
+                cpu->tail = NULL;
+            }
+        }
+
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(cpu->lock, int_state);
+
+        /* The steps run with interrupts enabled, a task switch is a call */
+        if(task != NULL)
+        {
+            _ktask_run(task);
+        }
+    }
+
+    return NULL;
+}
+
+OS_RETURN_E ktask_init_cpu(const uint32_t cpu_id)
+{
+    OS_RETURN_E err;
+
+    if(cpu_id >= MAX_CPU_COUNT || ktask_cpus[cpu_id].executor != NULL)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    err = scheduler_create_kernel_thread(&ktask_cpus[cpu_id].executor,
+                                         KTASK_THREAD_PRIORITY,
+                                         KTASK_THREAD_NAME,
+                                         _ktask_executor_routine,
+                                         (void*)(uintptr_t)cpu_id);
+    if(err != OS_NO_ERR)
+    {
+        ktask_cpus[cpu_id].executor = NULL;
+        return err;
+    }
+
+    /* The tasks of a CPU keep their frames in its caches */
+    err = scheduler_set_thread_affinity(ktask_cpus[cpu_id].executor,
+                                        1U << cpu_id);
+    if(err != OS_NO_ERR)
+    {
+        KERNEL_ERROR("Could not bind the CPU %u executor: %d\n",
+                     cpu_id, err);
+    }
+
+    KERNEL_DEBUG(KTASK_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %u executor thread created", cpu_id);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E ktask_create(ktask_step_t step,
+                         const size_t frame_size,
+                         ktask_t** task)
+{
+    ktask_t* new_task;
+
+    if(step == NULL || task == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(frame_size > ((size_t)-1) - sizeof(ktask_t))
+    {
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+
+    /* The frame follows the task in the same allocation */
+    new_task = kmalloc(sizeof(ktask_t) + frame_size);
+    if(new_task == NULL)
+    {
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+    memset(new_task, 0, sizeof(ktask_t) + frame_size);
+
+    new_task->step   = step;
+    new_task->frame  = new_task + 1;
+    new_task->resume = 0;
+    new_task->state  = KTASK_STATE_CREATED;
+
+    *task = new_task;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E ktask_destroy(ktask_t* task)
+{
+    if(task == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(task->state != KTASK_STATE_CREATED)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    kfree(task);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E ktask_start(ktask_t* task)
+{
+    uint32_t cpu_id;
+    uint32_t int_state;
+
+    if(task == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    ENTER_CRITICAL(int_state);
+    cpu_id = scheduler_get_current_cpu_id();
+    EXIT_CRITICAL(int_state);
+
+    if(ktask_cpus[cpu_id].executor == NULL ||
+       task->state != KTASK_STATE_CREATED)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    task->cpu_id = cpu_id;
+    task->state  = KTASK_STATE_QUEUED;
+    _ktask_enqueue(task);
+
+    KERNEL_DEBUG(KTASK_DEBUG_ENABLED, MODULE_NAME,
+                 "Task 0x%p started on CPU %u", task, cpu_id);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E ktask_wake(ktask_t* task)
+{
+    uint32_t state;
+    uint32_t new_state;
+
+    if(task == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    state = __atomic_load_n(&task->state, __ATOMIC_SEQ_CST);
+    do
+    {
+        if(state == KTASK_STATE_WAITING)
+        {
+            new_state = KTASK_STATE_QUEUED;
+        }
+        else if(state == KTASK_STATE_RUNNING)
+        {
+            new_state = KTASK_STATE_WOKEN;
+        }
+        else if(state == KTASK_STATE_CREATED)
+        {
+            return OS_ERR_UNAUTHORIZED_ACTION;
+        }
+        else
+        {
+            /* The task is already ready */
+            return OS_NO_ERR;
+        }
+    } while(__atomic_compare_exchange_n(&task->state, &state, new_state,
+                                        FALSE, __ATOMIC_SEQ_CST,
+                                        __ATOMIC_SEQ_CST) == FALSE);
+
+    if(new_state == KTASK_STATE_QUEUED)
+    {
+        _ktask_enqueue(task);
+    }
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
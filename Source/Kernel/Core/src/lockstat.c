@@ -0,0 +1,211 @@
+/*******************************************************************************
+ * @file lockstat.c
+ *
+ * @see lockstat.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's spinlocks contention statistics.
+ *
+ * @details Kernel's spinlocks contention statistics. The site descriptors are
+ * statically allocated by the lock sites, the module only updates them and
+ * walks the .lockstat_sites section to output them.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <stack_trace.h>    /* Stack walker */
+#include <kernel_output.h>  /* Kernel output methods */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <lockstat.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/** @brief Start of the lock sites descriptors, defined by the linker. */
+extern lockstat_site_t _START_LOCKSTAT_SITES_ADDR[];
+
+/** @brief End of the lock sites descriptors, defined by the linker. */
+extern lockstat_site_t _END_LOCKSTAT_SITES_ADDR[];
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Raises a site maximum.
+ *
+ * @param[in-out] max The maximum to raise.
+ * @param[in] value The new value.
+ *
+ * @return TRUE if the value is the new maximum, FALSE otherwise.
+ */
+inline static bool_t _lockstat_update_max(uint64_t* max,
+                                          const uint64_t value);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static bool_t _lockstat_update_max(uint64_t* max,
+                                          const uint64_t value)
+{
+    uint64_t current;
+
+    current = __atomic_load_n(max, __ATOMIC_RELAXED);
+    while(value > current)
+    {
+        if(__atomic_compare_exchange_n(max, &current, value, FALSE,
+                                       __ATOMIC_RELAXED,
+                                       __ATOMIC_RELAXED) == TRUE)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+void lockstat_record_acquire(lockstat_site_t* site,
+                             const bool_t contended,
+                             const uint64_t spin_cycles)
+{
+    uint32_t depth;
+
+    __atomic_fetch_add(&site->acquisitions, 1, __ATOMIC_RELAXED);
+    if(contended == FALSE)
+    {
+        return;
+    }
+
+    __atomic_fetch_add(&site->contentions, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&site->spin_cycles, spin_cycles, __ATOMIC_RELAXED);
+    if(_lockstat_update_max(&site->max_spin_cycles, spin_cycles) == TRUE)
+    {
+        depth = stack_trace_walk_current(site->stack, LOCKSTAT_STACK_DEPTH);
+        __atomic_store_n(&site->stack_depth, depth, __ATOMIC_RELAXED);
+    }
+}
+
+void lockstat_record_release(lockstat_site_t* site,
+                             const uint64_t hold_cycles)
+{
+    _lockstat_update_max(&site->max_hold_cycles, hold_cycles);
+}
+
+void lockstat_reset(void)
+{
+    lockstat_site_t* site;
+
+    for(site = _START_LOCKSTAT_SITES_ADDR;
+        site < _END_LOCKSTAT_SITES_ADDR;
+        ++site)
+    {
+        __atomic_store_n(&site->acquisitions, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&site->contentions, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&site->spin_cycles, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&site->max_spin_cycles, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&site->max_hold_cycles, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&site->stack_depth, 0, __ATOMIC_RELAXED);
+    }
+}
+
+void lockstat_dump(void)
+{
+    const lockstat_site_t* site;
+    const char*            symbol;
+    uintptr_t              address;
+    uint32_t               depth;
+    uint32_t               i;
+
+    if(_END_LOCKSTAT_SITES_ADDR - _START_LOCKSTAT_SITES_ADDR == 0)
+    {
+        return;
+    }
+
+    kernel_printf("#LOCKSTAT_START\n");
+
+    for(site = _START_LOCKSTAT_SITES_ADDR;
+        site < _END_LOCKSTAT_SITES_ADDR;
+        ++site)
+    {
+        if(__atomic_load_n(&site->acquisitions, __ATOMIC_RELAXED) == 0)
+        {
+            continue;
+        }
+
+        kernel_printf("#LOCKSTAT %s %s:%u %llu %llu %llu %llu %llu\n",
+                      site->name, site->file, site->line,
+                      site->acquisitions, site->contentions,
+                      site->spin_cycles, site->max_spin_cycles,
+                      site->max_hold_cycles);
+
+        depth = __atomic_load_n(&site->stack_depth, __ATOMIC_RELAXED);
+        if(depth == 0)
+        {
+            continue;
+        }
+
+        kernel_printf("#LOCKSTAT_STACK ");
+        for(i = 0; i < depth; ++i)
+        {
+            /* A return address might be the first byte after its function */
+            address = site->stack[i];
+            symbol  = stack_trace_lookup(address - 1, NULL);
+            if(symbol != NULL)
+            {
+                kernel_printf("%s%s", (i != 0) ? ";" : "", symbol);
+            }
+            else
+            {
+                kernel_printf("%s0x%p", (i != 0) ? ";" : "", address);
+            }
+        }
+        kernel_printf("\n");
+    }
+
+    kernel_printf("#LOCKSTAT_END\n");
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,1274 @@
+/*******************************************************************************
+ * @file memmgt.c
+ *
+ * @see memmgt.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's physical memory manager.
+ *
+ * @details Kernel's physical memory manager. Each available range of the
+ * multiboot memory map, minus the reserved ranges, is a zone. A zone has a
+ * descriptor per frame and a free list per order, a block of order k is only
+ * merged with its buddy, the block whose frame number differs by 2^k, when the
+ * buddy is free with the same order. The blocks are aligned on their size in
+ * the physical address space. Each CPU keeps a list of free single frames that
+ * it allocates and releases with interrupts disabled, without any lock. The
+ * zones are only locked to refill or flush half a hot list at a time. The
+ * zones crossing a NUMA node bound are split on the bound rounded to the
+ * largest block, no block crosses it. The allocations are served by the zones
+ * of the CPU node first.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* memcpy */
+#include <critical.h>       /* Kernel critical sections and spinlocks */
+#include <scheduler.h>      /* Current CPU identifier */
+#include <topology.h>       /* CPU nodes */
+#include <kheap.h>          /* Kernel heap */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <memmgt.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "MEMMGT"
+
+/** @brief Number of orders of the buddy allocator. */
+#define MEMMGT_ORDER_COUNT (MEMMGT_MAX_ORDER + 1)
+
+/** @brief Maximal number of zones. */
+#define MEMMGT_MAX_ZONES 16
+
+/** @brief Maximal number of reserved physical ranges. */
+#define MEMMGT_MAX_RESERVED 16
+
+/** @brief Maximal number of multiboot modules kept by the manager. */
+#define MEMMGT_MAX_MODULES 4
+
+/** @brief Number of free frames a CPU hot list can hold. */
+#define MEMMGT_HOT_FRAMES_SIZE 32
+
+/** @brief Number of frames moved between a CPU hot list and the zones. */
+#define MEMMGT_HOT_FRAMES_BATCH (MEMMGT_HOT_FRAMES_SIZE / 2)
+
+/** @brief Last frame aligned physical address that can be managed. */
+#define MEMMGT_MAX_ADDRESS \
+    ((uint64_t)(uintptr_t)~(uintptr_t)(MEMMGT_FRAME_SIZE - 1))
+
+/** @brief Frame index used as the end of a free list. */
+#define MEMMGT_NO_FRAME 0xFFFFFFFF
+
+/** @brief State of a frame that is not the first frame of a block. */
+#define MEMMGT_FRAME_TAIL 0
+
+/** @brief State of the first frame of a free block. */
+#define MEMMGT_FRAME_FREE 1
+
+/** @brief State of the first frame of an allocated block. */
+#define MEMMGT_FRAME_USED 2
+
+/** @brief State of a single frame kept in a CPU hot list. */
+#define MEMMGT_FRAME_HOT 3
+
+/** @brief Maximal number of references to a frame beside the allocation
+ * one.
+ */
+#define MEMMGT_MAX_SHARES 0xFFFF
+
+/** @brief Multiboot end tag type. */
+#define MULTIBOOT_TAG_END 0
+
+/** @brief Multiboot module tag type. */
+#define MULTIBOOT_TAG_MODULE 3
+
+/** @brief Multiboot memory map tag type. */
+#define MULTIBOOT_TAG_MMAP 6
+
+/** @brief Multiboot ACPI 1.0 RSDP copy tag type. */
+#define MULTIBOOT_TAG_ACPI_OLD 14
+
+/** @brief Multiboot ACPI 2.0 RSDP copy tag type. */
+#define MULTIBOOT_TAG_ACPI_NEW 15
+
+/** @brief Multiboot memory map available memory type. */
+#define MULTIBOOT_MEMORY_AVAILABLE 1
+
+/** @brief Multiboot tags alignment. */
+#define MULTIBOOT_TAG_ALIGN 8
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Multiboot information header. */
+typedef struct
+{
+    /** @brief Total size of the information, including the header. */
+    uint32_t total_size;
+
+    /** @brief Reserved. */
+    uint32_t reserved;
+} __attribute__((packed)) multiboot_info_t;
+
+/** @brief Multiboot information tag header. */
+typedef struct
+{
+    /** @brief The tag type. */
+    uint32_t type;
+
+    /** @brief The tag size, without the padding. */
+    uint32_t size;
+} __attribute__((packed)) multiboot_tag_t;
+
+/** @brief Multiboot module tag. */
+typedef struct
+{
+    /** @brief The tag header. */
+    multiboot_tag_t header;
+
+    /** @brief Physical start address of the module. */
+    uint32_t mod_start;
+
+    /** @brief Physical end address of the module. */
+    uint32_t mod_end;
+} __attribute__((packed)) multiboot_tag_module_t;
+
+/** @brief Multiboot memory map tag. */
+typedef struct
+{
+    /** @brief The tag header. */
+    multiboot_tag_t header;
+
+    /** @brief Size of an entry. */
+    uint32_t entry_size;
+
+    /** @brief Version of the entries. */
+    uint32_t entry_version;
+} __attribute__((packed)) multiboot_tag_mmap_t;
+
+/** @brief Multiboot memory map entry. */
+typedef struct
+{
+    /** @brief Physical base address of the range. */
+    uint64_t base_addr;
+
+    /** @brief Size of the range in bytes. */
+    uint64_t length;
+
+    /** @brief Type of the range. */
+    uint32_t type;
+
+    /** @brief Reserved. */
+    uint32_t reserved;
+} __attribute__((packed)) multiboot_mmap_entry_t;
+
+/** @brief Physical frame descriptor. */
+typedef struct
+{
+    /** @brief Next block in the free list of its order. */
+    uint32_t next;
+
+    /** @brief Previous block in the free list of its order. */
+    uint32_t prev;
+
+    /** @brief Order of the block, set on its first frame. */
+    uint8_t order;
+
+    /** @brief The frame state. */
+    uint8_t state;
+
+    /** @brief Number of references to an allocated single frame beside the
+     * allocation one.
+     */
+    uint16_t shares;
+} memmgt_frame_t;
+
+/** @brief Physical memory zone. */
+typedef struct
+{
+    /** @brief Frame number of the first frame of the zone. */
+    uintptr_t first_frame;
+
+    /** @brief Number of frames of the zone. */
+    uint32_t frame_count;
+
+    /** @brief The frames descriptors. */
+    memmgt_frame_t* frames;
+
+    /** @brief First free block of each order. */
+    uint32_t free_lists[MEMMGT_ORDER_COUNT];
+
+    /** @brief Number of free blocks of each order. */
+    uint32_t free_blocks[MEMMGT_ORDER_COUNT];
+
+    /** @brief Number of free frames in the free lists. */
+    size_t free_count;
+
+    /** @brief NUMA node of the zone. */
+    uint32_t node;
+} memmgt_zone_t;
+
+/** @brief Physical memory range. */
+typedef struct
+{
+    /** @brief Start address of the range. */
+    uint64_t start;
+
+    /** @brief End address of the range, excluded. */
+    uint64_t end;
+} memmgt_range_t;
+
+/** @brief Hot frames list of a CPU. */
+typedef struct
+{
+    /** @brief The free frames physical addresses. */
+    uintptr_t frames[MEMMGT_HOT_FRAMES_SIZE];
+
+    /** @brief Number of free frames in the list. */
+    uint32_t count;
+} memmgt_hot_frames_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/** @brief Multiboot information physical address, set by the boot code. */
+extern uintptr_t _kernel_multiboot_ptr;
+
+/** @brief Multiboot region base address, defined in the linker file. */
+extern int8_t _KERNEL_MULTIBOOT_MEM_BASE[];
+
+/** @brief Multiboot region size, defined in the linker file. */
+extern int8_t _KERNEL_MULTIBOOT_MEM_SIZE;
+
+/** @brief Kernel heap region base address, defined in the linker file. */
+extern int8_t _KERNEL_HEAP_BASE[];
+
+/** @brief Kernel heap region size, defined in the linker file. */
+extern int8_t _KERNEL_HEAP_SIZE;
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Tells if the memory manager is initialized. */
+static bool_t memmgt_initialized = FALSE;
+
+/** @brief The physical memory zones. */
+static memmgt_zone_t memmgt_zones[MEMMGT_MAX_ZONES];
+
+/** @brief Number of physical memory zones. */
+static uint32_t memmgt_zone_count = 0;
+
+/** @brief The physical ranges that are never served. */
+static memmgt_range_t memmgt_reserved[MEMMGT_MAX_RESERVED];
+
+/** @brief Number of reserved physical ranges. */
+static uint32_t memmgt_reserved_count = 0;
+
+/** @brief The multiboot modules physical ranges. */
+static memmgt_range_t memmgt_modules[MEMMGT_MAX_MODULES];
+
+/** @brief Number of multiboot modules. */
+static uint32_t memmgt_module_count = 0;
+
+/** @brief The RSDP copy in the multiboot information, NULL if none. */
+static const void* memmgt_acpi_rsdp = NULL;
+
+/** @brief Lock protecting the zones. */
+static kernel_spinlock_t memmgt_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/** @brief The CPUs hot frames lists. */
+static memmgt_hot_frames_t memmgt_hot_frames[MAX_CPU_COUNT];
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Adds a block to the free list of its order.
+ *
+ * @details Adds a block to the free list of its order and marks its first
+ * frame as free. The zones lock must be held.
+ *
+ * @param[in, out] zone The zone of the block.
+ * @param[in] index The index of the first frame of the block in the zone.
+ * @param[in] order The order of the block.
+ */
+static void _memmgt_list_push(memmgt_zone_t* zone,
+                              const uint32_t index,
+                              const uint32_t order);
+
+/**
+ * @brief Removes a block from the free list of its order.
+ *
+ * @details Removes a block from the free list of its order. The zones lock
+ * must be held.
+ *
+ * @param[in, out] zone The zone of the block.
+ * @param[in] index The index of the first frame of the block in the zone.
+ */
+static void _memmgt_list_remove(memmgt_zone_t* zone, const uint32_t index);
+
+/**
+ * @brief Returns the zone of a physical frame.
+ *
+ * @param[in] frame_number The frame number, its address divided by the frame
+ * size.
+ *
+ * @return The zone of the frame, NULL if the frame is not managed.
+ */
+static memmgt_zone_t* _memmgt_get_zone(const uintptr_t frame_number);
+
+/**
+ * @brief Returns the descriptor of an allocated single frame.
+ *
+ * @param[in] frame The physical address of the frame.
+ *
+ * @return The frame descriptor, NULL if the frame is not a single frame
+ * allocated with memmgt_alloc_frames.
+ */
+static memmgt_frame_t* _memmgt_get_single_frame(const uintptr_t frame);
+
+/**
+ * @brief Allocates a block from the zones free lists.
+ *
+ * @details Allocates a block from the zones free lists, splitting the
+ * smallest larger free block when needed. The zones of the node are used
+ * first. The zones lock must be held.
+ *
+ * @param[in] order The order of the block.
+ * @param[in] node The NUMA node the block is preferably allocated on.
+ * @param[out] frame The physical address of the allocated block.
+ *
+ * @return TRUE if a block was allocated, FALSE otherwise.
+ */
+static bool_t _memmgt_block_alloc(const uint32_t order,
+                                  const uint32_t node,
+                                  uintptr_t* frame);
+
+/**
+ * @brief Splits a zone in two zones.
+ *
+ * @details Splits a zone on a frame aligned on the largest block. The frames
+ * after the split frame form a new zone of the same node, the free lists of
+ * both zones are rebuilt. The zones lock must be held.
+ *
+ * @param[in, out] zone The zone to split.
+ * @param[in] frame_number The frame number of the first frame of the new
+ * zone.
+ *
+ * @return TRUE if the frame is not inside the zone or the zone was split,
+ * FALSE if no zone is left.
+ */
+static bool_t _memmgt_split_zone(memmgt_zone_t* zone,
+                                 const uintptr_t frame_number);
+
+/**
+ * @brief Releases a block to the zones free lists.
+ *
+ * @details Releases a block to the zones free lists, merging it with its free
+ * buddies. The zones lock must be held.
+ *
+ * @param[in, out] zone The zone of the block.
+ * @param[in] index The index of the first frame of the block in the zone.
+ * @param[in] order The order of the block.
+ */
+static void _memmgt_block_free(memmgt_zone_t* zone,
+                               uint32_t index,
+                               uint32_t order);
+
+/**
+ * @brief Adds a zone over a physical range.
+ *
+ * @details Adds a zone over a frame aligned physical range and releases all
+ * its frames as the largest aligned blocks. When the kernel heap cannot hold
+ * the frames descriptors, the zone is shrunk.
+ *
+ * @param[in] start The start address of the range.
+ * @param[in] end The end address of the range, excluded.
+ */
+static void _memmgt_add_zone(const uint64_t start, const uint64_t end);
+
+/**
+ * @brief Adds the zones of an available physical range.
+ *
+ * @details Adds the zones of a frame aligned available physical range, minus
+ * the reserved ranges starting at first_reserved.
+ *
+ * @param[in] start The start address of the range.
+ * @param[in] end The end address of the range, excluded.
+ * @param[in] first_reserved The first reserved range to remove.
+ */
+static void _memmgt_add_range(uint64_t start,
+                              const uint64_t end,
+                              const uint32_t first_reserved);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void _memmgt_list_push(memmgt_zone_t* zone,
+                              const uint32_t index,
+                              const uint32_t order)
+{
+    memmgt_frame_t* frame;
+
+    frame        = &zone->frames[index];
+    frame->state = MEMMGT_FRAME_FREE;
+    frame->order = order;
+    frame->prev  = MEMMGT_NO_FRAME;
+    frame->next  = zone->free_lists[order];
+    if(frame->next != MEMMGT_NO_FRAME)
+    {
+        zone->frames[frame->next].prev = index;
+    }
+    zone->free_lists[order] = index;
+    ++zone->free_blocks[order];
+}
+
+static void _memmgt_list_remove(memmgt_zone_t* zone, const uint32_t index)
+{
+    memmgt_frame_t* frame;
+
+    frame = &zone->frames[index];
+    if(frame->prev != MEMMGT_NO_FRAME)
+    {
+        zone->frames[frame->prev].next = frame->next;
+    }
+    else
+    {
+        zone->free_lists[frame->order] = frame->next;
+    }
+    --zone->free_blocks[frame->order];
+    if(frame->next != MEMMGT_NO_FRAME)
+    {
+        zone->frames[frame->next].prev = frame->prev;
+    }
+}
+
+static memmgt_zone_t* _memmgt_get_zone(const uintptr_t frame_number)
+{
+    memmgt_zone_t* zone;
+    uint32_t       i;
+
+    for(i = 0; i < memmgt_zone_count; ++i)
+    {
+        zone = &memmgt_zones[i];
+        if(frame_number >= zone->first_frame &&
+           frame_number - zone->first_frame < zone->frame_count)
+        {
+            return zone;
+        }
+    }
+
+    return NULL;
+}
+
+static memmgt_frame_t* _memmgt_get_single_frame(const uintptr_t frame)
+{
+    memmgt_zone_t*  zone;
+    memmgt_frame_t* descriptor;
+
+    if(memmgt_initialized == FALSE || (frame & (MEMMGT_FRAME_SIZE - 1)) != 0)
+    {
+        return NULL;
+    }
+
+    zone = _memmgt_get_zone(frame / MEMMGT_FRAME_SIZE);
+    if(zone == NULL)
+    {
+        return NULL;
+    }
+
+    descriptor = &zone->frames[frame / MEMMGT_FRAME_SIZE - zone->first_frame];
+    if(descriptor->state != MEMMGT_FRAME_USED || descriptor->order != 0)
+    {
+        return NULL;
+    }
+
+    return descriptor;
+}
+
+static bool_t _memmgt_block_alloc(const uint32_t order,
+                                  const uint32_t node,
+                                  uintptr_t* frame)
+{
+    memmgt_zone_t* zone;
+    uint32_t       index;
+    uint32_t       current;
+    uint32_t       i;
+
+    /* The zones of the node come first, then the remote zones */
+    for(i = 0; i < memmgt_zone_count * 2; ++i)
+    {
+        zone = &memmgt_zones[i % memmgt_zone_count];
+        if((zone->node == node) != (i < memmgt_zone_count))
+        {
+            continue;
+        }
+
+        /* Get the smallest free block that can hold the order */
+        for(current = order; current < MEMMGT_ORDER_COUNT; ++current)
+        {
+            if(zone->free_lists[current] != MEMMGT_NO_FRAME)
+            {
+                break;
+            }
+        }
+        if(current == MEMMGT_ORDER_COUNT)
+        {
+            continue;
+        }
+
+        index = zone->free_lists[current];
+        _memmgt_list_remove(zone, index);
+
+        /* Release the upper halves until the block has the right order */
+        while(current > order)
+        {
+            --current;
+            _memmgt_list_push(zone, index + (1U << current), current);
+        }
+
+        zone->frames[index].state = MEMMGT_FRAME_USED;
+        zone->frames[index].order = order;
+        zone->free_count -= (size_t)1 << order;
+
+        *frame = (zone->first_frame + index) * MEMMGT_FRAME_SIZE;
+        return TRUE;
+    }
+
+    return FALSE;
+}
+
+static void _memmgt_block_free(memmgt_zone_t* zone,
+                               uint32_t index,
+                               uint32_t order)
+{
+    uintptr_t buddy_frame;
+    uint32_t  buddy;
+
+    zone->free_count += (size_t)1 << order;
+
+    while(order < MEMMGT_MAX_ORDER)
+    {
+        buddy_frame = (zone->first_frame + index) ^ ((uintptr_t)1 << order);
+        if(buddy_frame < zone->first_frame ||
+           buddy_frame - zone->first_frame >= zone->frame_count)
+        {
+            break;
+        }
+
+        buddy = buddy_frame - zone->first_frame;
+        if(zone->frames[buddy].state != MEMMGT_FRAME_FREE ||
+           zone->frames[buddy].order != order)
+        {
+            break;
+        }
+
+        /* Merge with the buddy, the lower block becomes the merged block */
+        _memmgt_list_remove(zone, buddy);
+        zone->frames[buddy].state = MEMMGT_FRAME_TAIL;
+        zone->frames[index].state = MEMMGT_FRAME_TAIL;
+        if(buddy < index)
+        {
+            index = buddy;
+        }
+        ++order;
+    }
+
+    _memmgt_list_push(zone, index, order);
+}
+
+static bool_t _memmgt_split_zone(memmgt_zone_t* zone,
+                                 const uintptr_t frame_number)
+{
+    memmgt_zone_t* upper;
+    uint32_t       split;
+    uint32_t       count;
+    uint32_t       i;
+
+    if(frame_number <= zone->first_frame ||
+       frame_number - zone->first_frame >= zone->frame_count)
+    {
+        return TRUE;
+    }
+    if(memmgt_zone_count == MEMMGT_MAX_ZONES)
+    {
+        return FALSE;
+    }
+
+    /* The zones share the descriptors, the indexes are zone relative */
+    split              = frame_number - zone->first_frame;
+    count              = zone->frame_count;
+    upper              = &memmgt_zones[memmgt_zone_count++];
+    upper->first_frame = frame_number;
+    upper->frame_count = count - split;
+    upper->frames      = zone->frames + split;
+    upper->node        = zone->node;
+    zone->frame_count  = split;
+
+    zone->free_count  = 0;
+    upper->free_count = 0;
+    for(i = 0; i < MEMMGT_ORDER_COUNT; ++i)
+    {
+        zone->free_lists[i]   = MEMMGT_NO_FRAME;
+        upper->free_lists[i]  = MEMMGT_NO_FRAME;
+        zone->free_blocks[i]  = 0;
+        upper->free_blocks[i] = 0;
+    }
+
+    /* The split frame is aligned on the largest block, no block crosses it */
+    for(i = 0; i < count; ++i)
+    {
+        if(i < split && zone->frames[i].state == MEMMGT_FRAME_FREE)
+        {
+            zone->free_count += (size_t)1 << zone->frames[i].order;
+            _memmgt_list_push(zone, i, zone->frames[i].order);
+        }
+        else if(i >= split && zone->frames[i].state == MEMMGT_FRAME_FREE)
+        {
+            upper->free_count += (size_t)1 << zone->frames[i].order;
+            _memmgt_list_push(upper, i - split, zone->frames[i].order);
+        }
+    }
+
+    return TRUE;
+}
+
+static void _memmgt_add_zone(const uint64_t start, const uint64_t end)
+{
+    memmgt_zone_t* zone;
+    uint64_t       frame_count;
+    uint32_t       index;
+    uint32_t       order;
+    uint32_t       i;
+
+    if(memmgt_zone_count == MEMMGT_MAX_ZONES)
+    {
+        KERNEL_DEBUG(MEMMGT_DEBUG_ENABLED, MODULE_NAME,
+                     "No zone left for 0x%p - 0x%p",
+                     (uintptr_t)start, (uintptr_t)end);
+        return;
+    }
+
+    frame_count = (end - start) / MEMMGT_FRAME_SIZE;
+    if(frame_count >= MEMMGT_NO_FRAME)
+    {
+        frame_count = MEMMGT_NO_FRAME - 1;
+    }
+
+    zone         = &memmgt_zones[memmgt_zone_count];
+    zone->frames = NULL;
+    while(frame_count != 0)
+    {
+        zone->frames = kmalloc(frame_count * sizeof(memmgt_frame_t));
+        if(zone->frames != NULL)
+        {
+            break;
+        }
+        frame_count /= 2;
+    }
+    if(zone->frames == NULL)
+    {
+        KERNEL_DEBUG(MEMMGT_DEBUG_ENABLED, MODULE_NAME,
+                     "No descriptors for 0x%p - 0x%p",
+                     (uintptr_t)start, (uintptr_t)end);
+        return;
+    }
+
+    zone->first_frame = (uintptr_t)(start / MEMMGT_FRAME_SIZE);
+    zone->frame_count = (uint32_t)frame_count;
+    zone->free_count  = 0;
+    zone->node        = 0;
+    for(i = 0; i < MEMMGT_ORDER_COUNT; ++i)
+    {
+        zone->free_lists[i]  = MEMMGT_NO_FRAME;
+        zone->free_blocks[i] = 0;
+    }
+    for(i = 0; i < zone->frame_count; ++i)
+    {
+        zone->frames[i].next  = MEMMGT_NO_FRAME;
+        zone->frames[i].prev  = MEMMGT_NO_FRAME;
+        zone->frames[i].order  = 0;
+        zone->frames[i].state  = MEMMGT_FRAME_TAIL;
+        zone->frames[i].shares = 0;
+    }
+
+    /* Release the frames as the largest blocks aligned on their size */
+    index = 0;
+    while(index < zone->frame_count)
+    {
+        order = MEMMGT_MAX_ORDER;
+        while(order > 0 &&
+              (((zone->first_frame + index) & ((1U << order) - 1)) != 0 ||
+               zone->frame_count - index < (1U << order)))
+        {
+            --order;
+        }
+
+        _memmgt_list_push(zone, index, order);
+        zone->free_count += (size_t)1 << order;
+        index += 1U << order;
+    }
+
+    ++memmgt_zone_count;
+
+    KERNEL_DEBUG(MEMMGT_DEBUG_ENABLED, MODULE_NAME,
+                 "Zone at 0x%p, %d frames",
+                 (uintptr_t)start, zone->frame_count);
+}
+
+static void _memmgt_add_range(uint64_t start,
+                              const uint64_t end,
+                              const uint32_t first_reserved)
+{
+    const memmgt_range_t* reserved;
+    uint32_t              i;
+
+    for(i = first_reserved; i < memmgt_reserved_count; ++i)
+    {
+        reserved = &memmgt_reserved[i];
+        if(reserved->end <= start || reserved->start >= end)
+        {
+            continue;
+        }
+
+        /* Keep the part before the reserved range, skip the reserved range */
+        if(reserved->start > start)
+        {
+            _memmgt_add_range(start, reserved->start, i + 1);
+        }
+        start = reserved->end;
+        if(start >= end)
+        {
+            return;
+        }
+    }
+
+    _memmgt_add_zone(start, end);
+}
+
+OS_RETURN_E memmgt_init(void)
+{
+    const multiboot_info_t*       info;
+    const multiboot_tag_t*        tag;
+    const multiboot_tag_module_t* module;
+    const multiboot_tag_mmap_t*   mmap;
+    const multiboot_mmap_entry_t* entry;
+    uintptr_t                     info_end;
+    uintptr_t                     entry_addr;
+    uint64_t                      start;
+    uint64_t                      end;
+    uint32_t                      i;
+
+    if(memmgt_initialized == TRUE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    if(_kernel_multiboot_ptr == 0)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    /* Keep a copy of the information, its original memory is not reserved */
+    info = (const multiboot_info_t*)(_kernel_multiboot_ptr +
+                                     KERNEL_MEM_OFFSET);
+    if(info->total_size > (uintptr_t)&_KERNEL_MULTIBOOT_MEM_SIZE ||
+       info->total_size < sizeof(multiboot_info_t))
+    {
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+    memcpy(_KERNEL_MULTIBOOT_MEM_BASE, info, info->total_size);
+    info     = (const multiboot_info_t*)_KERNEL_MULTIBOOT_MEM_BASE;
+    info_end = (uintptr_t)info + info->total_size;
+
+    /* The low memory and the kernel image and regions end with the heap */
+    memmgt_reserved[0].start = 0;
+    memmgt_reserved[0].end   = (uintptr_t)_KERNEL_HEAP_BASE +
+                               (uintptr_t)&_KERNEL_HEAP_SIZE -
+                               KERNEL_MEM_OFFSET;
+    memmgt_reserved_count    = 1;
+    memmgt_module_count      = 0;
+    memmgt_acpi_rsdp         = NULL;
+
+    mmap = NULL;
+    tag  = (const multiboot_tag_t*)(info + 1);
+    while((uintptr_t)(tag + 1) <= info_end && tag->type != MULTIBOOT_TAG_END)
+    {
+        if(tag->type == MULTIBOOT_TAG_MODULE)
+        {
+            if(memmgt_reserved_count == MEMMGT_MAX_RESERVED)
+            {
+                return OS_ERR_NOT_SUPPORTED;
+            }
+            module = (const multiboot_tag_module_t*)tag;
+            memmgt_reserved[memmgt_reserved_count].start =
+                module->mod_start & ~(uint64_t)(MEMMGT_FRAME_SIZE - 1);
+            memmgt_reserved[memmgt_reserved_count].end =
+                ((uint64_t)module->mod_end + MEMMGT_FRAME_SIZE - 1) &
+                ~(uint64_t)(MEMMGT_FRAME_SIZE - 1);
+            ++memmgt_reserved_count;
+
+            if(memmgt_module_count < MEMMGT_MAX_MODULES)
+            {
+                memmgt_modules[memmgt_module_count].start = module->mod_start;
+                memmgt_modules[memmgt_module_count].end   = module->mod_end;
+                ++memmgt_module_count;
+            }
+        }
+        else if(tag->type == MULTIBOOT_TAG_MMAP)
+        {
+            mmap = (const multiboot_tag_mmap_t*)tag;
+        }
+        else if(tag->type == MULTIBOOT_TAG_ACPI_NEW ||
+                (tag->type == MULTIBOOT_TAG_ACPI_OLD &&
+                 memmgt_acpi_rsdp == NULL))
+        {
+            /* The ACPI 2.0 RSDP is preferred, it gives the XSDT */
+            memmgt_acpi_rsdp = tag + 1;
+        }
+
+        tag = (const multiboot_tag_t*)((uintptr_t)tag +
+                                       ((tag->size + MULTIBOOT_TAG_ALIGN - 1) &
+                                        ~(MULTIBOOT_TAG_ALIGN - 1)));
+    }
+
+    if(mmap == NULL || mmap->entry_size < sizeof(multiboot_mmap_entry_t))
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        memmgt_hot_frames[i].count = 0;
+    }
+
+    memmgt_zone_count = 0;
+    entry_addr        = (uintptr_t)(mmap + 1);
+    while(entry_addr + sizeof(multiboot_mmap_entry_t) <=
+          (uintptr_t)mmap + mmap->header.size)
+    {
+        entry       = (const multiboot_mmap_entry_t*)entry_addr;
+        entry_addr += mmap->entry_size;
+
+        if(entry->type != MULTIBOOT_MEMORY_AVAILABLE ||
+           entry->base_addr >= MEMMGT_MAX_ADDRESS)
+        {
+            continue;
+        }
+
+        start = (entry->base_addr + MEMMGT_FRAME_SIZE - 1) &
+                ~(uint64_t)(MEMMGT_FRAME_SIZE - 1);
+        if(entry->length > MEMMGT_MAX_ADDRESS - entry->base_addr)
+        {
+            end = MEMMGT_MAX_ADDRESS;
+        }
+        else
+        {
+            end = (entry->base_addr + entry->length) &
+                  ~(uint64_t)(MEMMGT_FRAME_SIZE - 1);
+        }
+
+        if(start < end)
+        {
+            _memmgt_add_range(start, end, 0);
+        }
+    }
+
+    if(memmgt_zone_count == 0)
+    {
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+
+    KERNEL_SPINLOCK_INIT(memmgt_lock);
+    memmgt_initialized = TRUE;
+
+    KERNEL_DEBUG(MEMMGT_DEBUG_ENABLED, MODULE_NAME,
+                 "Memory manager initialized, %d zones, %d free frames",
+                 memmgt_zone_count, memmgt_get_free_frames());
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E memmgt_alloc_frames(const uint32_t order, uintptr_t* frame)
+{
+    memmgt_hot_frames_t* hot;
+    memmgt_zone_t*       zone;
+    uintptr_t            address;
+    uint32_t             node;
+    uint32_t             int_state;
+    bool_t               allocated;
+
+    if(frame == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(order > MEMMGT_MAX_ORDER || memmgt_initialized == FALSE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    node = topology_get_cpu_node(scheduler_get_current_cpu_id());
+
+    if(order != 0)
+    {
+        KERNEL_SPINLOCK_LOCK(memmgt_lock);
+        allocated = _memmgt_block_alloc(order, node, frame);
+        KERNEL_SPINLOCK_UNLOCK(memmgt_lock);
+
+        EXIT_CRITICAL(int_state);
+        return allocated == TRUE ? OS_NO_ERR : OS_ERR_NO_MORE_MEMORY;
+    }
+
+    /* The hot list is only used by this CPU, disabling interrupts is enough */
+    hot = &memmgt_hot_frames[scheduler_get_current_cpu_id()];
+    if(hot->count == 0)
+    {
+        KERNEL_SPINLOCK_LOCK(memmgt_lock);
+        while(hot->count < MEMMGT_HOT_FRAMES_BATCH &&
+              _memmgt_block_alloc(0, node, &address) == TRUE)
+        {
+            hot->frames[hot->count++] = address;
+        }
+        KERNEL_SPINLOCK_UNLOCK(memmgt_lock);
+    }
+
+    if(hot->count == 0)
+    {
+        EXIT_CRITICAL(int_state);
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+
+    address = hot->frames[--hot->count];
+    zone    = _memmgt_get_zone(address / MEMMGT_FRAME_SIZE);
+    zone->frames[address / MEMMGT_FRAME_SIZE - zone->first_frame].state =
+        MEMMGT_FRAME_USED;
+
+    EXIT_CRITICAL(int_state);
+
+    *frame = address;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E memmgt_free_frames(const uintptr_t frame, const uint32_t order)
+{
+    memmgt_hot_frames_t* hot;
+    memmgt_zone_t*       zone;
+    memmgt_frame_t*      descriptor;
+    uintptr_t            address;
+    uint32_t             index;
+    uint32_t             int_state;
+    uint32_t             i;
+    uint16_t             shares;
+
+    if(order > MEMMGT_MAX_ORDER || memmgt_initialized == FALSE ||
+       (frame & (((uintptr_t)MEMMGT_FRAME_SIZE << order) - 1)) != 0)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    zone = _memmgt_get_zone(frame / MEMMGT_FRAME_SIZE);
+    if(zone == NULL)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+    index      = frame / MEMMGT_FRAME_SIZE - zone->first_frame;
+    descriptor = &zone->frames[index];
+
+    ENTER_CRITICAL(int_state);
+
+    if(order != 0)
+    {
+        KERNEL_SPINLOCK_LOCK(memmgt_lock);
+        if(descriptor->state != MEMMGT_FRAME_USED ||
+           descriptor->order != order)
+        {
+            KERNEL_SPINLOCK_UNLOCK(memmgt_lock);
+            EXIT_CRITICAL(int_state);
+            return OS_ERR_UNAUTHORIZED_ACTION;
+        }
+        _memmgt_block_free(zone, index, order);
+        KERNEL_SPINLOCK_UNLOCK(memmgt_lock);
+
+        EXIT_CRITICAL(int_state);
+        return OS_NO_ERR;
+    }
+
+    /* A single frame is owned by its caller until it is released */
+    if(descriptor->state != MEMMGT_FRAME_USED || descriptor->order != 0)
+    {
+        EXIT_CRITICAL(int_state);
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    /* A shared frame is released with its last reference */
+    shares = __atomic_load_n(&descriptor->shares, __ATOMIC_RELAXED);
+    while(shares != 0)
+    {
+        if(__atomic_compare_exchange_n(&descriptor->shares, &shares,
+                                       shares - 1, FALSE, __ATOMIC_ACQ_REL,
+                                       __ATOMIC_RELAXED) == TRUE)
+        {
+            EXIT_CRITICAL(int_state);
+            return OS_NO_ERR;
+        }
+    }
+    descriptor->state = MEMMGT_FRAME_HOT;
+
+    /* The hot list is only used by this CPU, disabling interrupts is enough */
+    hot = &memmgt_hot_frames[scheduler_get_current_cpu_id()];
+    if(hot->count == MEMMGT_HOT_FRAMES_SIZE)
+    {
+        KERNEL_SPINLOCK_LOCK(memmgt_lock);
+        for(i = 0; i < MEMMGT_HOT_FRAMES_BATCH; ++i)
+        {
+            address = hot->frames[--hot->count] / MEMMGT_FRAME_SIZE;
+            zone    = _memmgt_get_zone(address);
+            _memmgt_block_free(zone, address - zone->first_frame, 0);
+        }
+        KERNEL_SPINLOCK_UNLOCK(memmgt_lock);
+    }
+    hot->frames[hot->count++] = frame;
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E memmgt_share_frame(const uintptr_t frame)
+{
+    memmgt_frame_t* descriptor;
+    uint16_t        shares;
+
+    descriptor = _memmgt_get_single_frame(frame);
+    if(descriptor == NULL)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    /* The caller holds a reference, the frame cannot be released meanwhile */
+    shares = __atomic_load_n(&descriptor->shares, __ATOMIC_RELAXED);
+    do
+    {
+        if(shares == MEMMGT_MAX_SHARES)
+        {
+            return OS_ERR_OUT_OF_BOUND;
+        }
+    } while(__atomic_compare_exchange_n(&descriptor->shares, &shares,
+                                        shares + 1, FALSE, __ATOMIC_RELAXED,
+                                        __ATOMIC_RELAXED) == FALSE);
+
+    return OS_NO_ERR;
+}
+
+bool_t memmgt_is_frame_shared(const uintptr_t frame)
+{
+    memmgt_frame_t* descriptor;
+
+    descriptor = _memmgt_get_single_frame(frame);
+    if(descriptor == NULL)
+    {
+        return FALSE;
+    }
+
+    return (__atomic_load_n(&descriptor->shares, __ATOMIC_ACQUIRE) != 0);
+}
+
+size_t memmgt_get_free_frames(void)
+{
+    size_t   free_count;
+    uint32_t int_state;
+    uint32_t i;
+
+    free_count = 0;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(memmgt_lock, int_state);
+    for(i = 0; i < memmgt_zone_count; ++i)
+    {
+        free_count += memmgt_zones[i].free_count;
+    }
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(memmgt_lock, int_state);
+
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        free_count += memmgt_hot_frames[i].count;
+    }
+
+    return free_count;
+}
+
+OS_RETURN_E memmgt_get_stats(memmgt_stats_t* stats)
+{
+    uint32_t int_state;
+    uint32_t i;
+    uint32_t j;
+
+    if(stats == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(memmgt_initialized == FALSE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    for(j = 0; j < MEMMGT_ORDER_COUNT; ++j)
+    {
+        stats->free_blocks[j] = 0;
+    }
+    stats->free_frames = 0;
+    stats->hot_frames  = 0;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(memmgt_lock, int_state);
+    for(i = 0; i < memmgt_zone_count; ++i)
+    {
+        for(j = 0; j < MEMMGT_ORDER_COUNT; ++j)
+        {
+            stats->free_blocks[j] += memmgt_zones[i].free_blocks[j];
+        }
+        stats->free_frames += memmgt_zones[i].free_count;
+    }
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(memmgt_lock, int_state);
+
+    /* The hot frames are single frames out of the free blocks */
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        stats->hot_frames += memmgt_hot_frames[i].count;
+    }
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E memmgt_get_module(const uint32_t index,
+                              uint64_t* start,
+                              uint64_t* end)
+{
+    if(start == NULL || end == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(memmgt_initialized == FALSE || index >= memmgt_module_count)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    *start = memmgt_modules[index].start;
+    *end   = memmgt_modules[index].end;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E memmgt_set_node_range(const uint64_t start,
+                                  const uint64_t end,
+                                  const uint32_t node)
+{
+    memmgt_zone_t* zone;
+    uint64_t       first_frame;
+    uint64_t       last_frame;
+    uint32_t       int_state;
+    uint32_t       i;
+    OS_RETURN_E    err;
+
+    if(memmgt_initialized == FALSE || start >= end)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    /* The blocks are aligned on their size, the rounded bounds split none */
+    first_frame = (start / MEMMGT_FRAME_SIZE) &
+                  ~(uint64_t)((1U << MEMMGT_MAX_ORDER) - 1);
+    last_frame  = (end / MEMMGT_FRAME_SIZE) &
+                  ~(uint64_t)((1U << MEMMGT_MAX_ORDER) - 1);
+    if(last_frame > MEMMGT_MAX_ADDRESS / MEMMGT_FRAME_SIZE)
+    {
+        last_frame = MEMMGT_MAX_ADDRESS / MEMMGT_FRAME_SIZE;
+    }
+    if(first_frame >= last_frame)
+    {
+        return OS_NO_ERR;
+    }
+
+    err = OS_NO_ERR;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(memmgt_lock, int_state);
+
+    /* The zones added by a split are visited by the loop */
+    for(i = 0; i < memmgt_zone_count; ++i)
+    {
+        zone = &memmgt_zones[i];
+        if(_memmgt_split_zone(zone, (uintptr_t)first_frame) == FALSE ||
+           _memmgt_split_zone(zone, (uintptr_t)last_frame) == FALSE)
+        {
+            err = OS_ERR_OUT_OF_BOUND;
+            continue;
+        }
+        if(zone->first_frame >= first_frame &&
+           zone->first_frame < last_frame)
+        {
+            zone->node = node;
+        }
+    }
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(memmgt_lock, int_state);
+
+    KERNEL_DEBUG(MEMMGT_DEBUG_ENABLED, MODULE_NAME,
+                 "Range 0x%p - 0x%p on node %u",
+                 (uintptr_t)start, (uintptr_t)end, node);
+
+    return err;
+}
+
+OS_RETURN_E memmgt_get_acpi_rsdp(const void** rsdp)
+{
+    if(rsdp == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(memmgt_initialized == FALSE || memmgt_acpi_rsdp == NULL)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    *rsdp = memmgt_acpi_rsdp;
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
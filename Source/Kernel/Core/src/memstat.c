@@ -0,0 +1,443 @@
+/*******************************************************************************
+ * @file memstat.c
+ *
+ * @see memstat.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's memory usage statistics.
+ *
+ * @details Kernel's memory usage statistics. The site descriptors are
+ * statically allocated by the kmalloc call sites, the module only updates them
+ * and walks the .memstat_sites section to output them. The tag of a site is
+ * its index in the section plus one, the sites past the first
+ * MEMSTAT_MAX_TAGS ones have no tag and their releases are only credited to
+ * their size class.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <stack_trace.h>    /* Stack walker */
+#include <time_mgt.h>       /* Measured time */
+#include <memmgt.h>         /* Physical memory statistics */
+#include <kheap.h>          /* Heap size classes */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <memstat.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of sites that get a tag. */
+#define MEMSTAT_MAX_TAGS 255
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/** @brief Start of the allocation sites descriptors, defined by the linker. */
+extern memstat_site_t _START_MEMSTAT_SITES_ADDR[];
+
+/** @brief End of the allocation sites descriptors, defined by the linker. */
+extern memstat_site_t _END_MEMSTAT_SITES_ADDR[];
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The size classes statistics. */
+static memstat_class_t memstat_classes[MEMSTAT_CLASS_COUNT];
+
+/** @brief The sampled allocations. */
+static memstat_sample_t memstat_samples[MEMSTAT_SAMPLE_COUNT];
+
+/** @brief Number of allocations recorded, selects the sampled ones. */
+static uint32_t memstat_allocation_count = 0;
+
+/** @brief Time the statistics were cleared, in nanoseconds of uptime. */
+static uint64_t memstat_reset_time = 0;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Adds bytes in use to a counter and raises its peak.
+ *
+ * @param[in-out] live The bytes in use counter.
+ * @param[in-out] peak The peak of the counter.
+ * @param[in] bytes The bytes to add.
+ */
+inline static void _memstat_add_live(uint64_t* live,
+                                     uint64_t* peak,
+                                     const uint64_t bytes);
+
+/**
+ * @brief Records an allocation in a sample.
+ *
+ * @param[in] site The allocation site, can be NULL.
+ * @param[in] size The requested size.
+ * @param[in] frame The frame pointer to walk the stack from.
+ */
+static void _memstat_sample(const memstat_site_t* site,
+                            const size_t size,
+                            const uintptr_t frame);
+
+/**
+ * @brief Outputs a stack, resolved in the kernel symbol table.
+ *
+ * @param[in] stack The return addresses, innermost first.
+ * @param[in] depth The number of return addresses.
+ */
+static void _memstat_print_stack(const uintptr_t* stack,
+                                 const uint32_t depth);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static void _memstat_add_live(uint64_t* live,
+                                     uint64_t* peak,
+                                     const uint64_t bytes)
+{
+    uint64_t value;
+    uint64_t current;
+
+    value   = __atomic_add_fetch(live, bytes, __ATOMIC_RELAXED);
+    current = __atomic_load_n(peak, __ATOMIC_RELAXED);
+    while(value > current)
+    {
+        if(__atomic_compare_exchange_n(peak, &current, value, FALSE,
+                                       __ATOMIC_RELAXED,
+                                       __ATOMIC_RELAXED) == TRUE)
+        {
+            break;
+        }
+    }
+}
+
+static void _memstat_sample(const memstat_site_t* site,
+                            const size_t size,
+                            const uintptr_t frame)
+{
+    memstat_sample_t* sample;
+    uint32_t          index;
+
+    index = __atomic_fetch_add(&memstat_allocation_count, 1,
+                               __ATOMIC_RELAXED);
+    if(index % KERNEL_MEMSTAT_SAMPLE_PERIOD != 0)
+    {
+        return;
+    }
+
+    sample = &memstat_samples[(index / KERNEL_MEMSTAT_SAMPLE_PERIOD) %
+                              MEMSTAT_SAMPLE_COUNT];
+
+    /* The stack is invalid while it is written */
+    __atomic_store_n(&sample->stack_depth, 0, __ATOMIC_RELAXED);
+    sample->site = site;
+    sample->size = size;
+    __atomic_store_n(&sample->stack_depth,
+                     stack_trace_walk(frame, sample->stack,
+                                      MEMSTAT_STACK_DEPTH),
+                     __ATOMIC_RELEASE);
+}
+
+static void _memstat_print_stack(const uintptr_t* stack,
+                                 const uint32_t depth)
+{
+    const char* symbol;
+    uint32_t    i;
+
+    for(i = 0; i < depth; ++i)
+    {
+        /* A return address might be the first byte after its function */
+        symbol = stack_trace_lookup(stack[i] - 1, NULL);
+        if(symbol != NULL)
+        {
+            kernel_printf("%s%s", (i != 0) ? ";" : "", symbol);
+        }
+        else
+        {
+            kernel_printf("%s0x%p", (i != 0) ? ";" : "", stack[i]);
+        }
+    }
+    kernel_printf("\n");
+}
+
+uint8_t memstat_record_alloc(memstat_site_t* site,
+                             const uint32_t class_id,
+                             const size_t size,
+                             const size_t granted,
+                             const uintptr_t frame)
+{
+    memstat_class_t* class;
+    uintptr_t        index;
+
+    class = &memstat_classes[class_id];
+
+    if(granted == 0)
+    {
+        __atomic_fetch_add(&class->failures, 1, __ATOMIC_RELAXED);
+        if(site != NULL)
+        {
+            __atomic_fetch_add(&site->failures, 1, __ATOMIC_RELAXED);
+        }
+        return 0;
+    }
+
+    __atomic_fetch_add(&class->allocations, 1, __ATOMIC_RELAXED);
+    _memstat_add_live(&class->live_bytes, &class->peak_bytes, granted);
+
+    _memstat_sample(site, size, frame);
+
+    if(site == NULL)
+    {
+        return 0;
+    }
+
+    __atomic_fetch_add(&site->allocations, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&site->requested_bytes, size, __ATOMIC_RELAXED);
+    _memstat_add_live(&site->live_bytes, &site->peak_bytes, granted);
+
+    index = (uintptr_t)(site - _START_MEMSTAT_SITES_ADDR);
+    if(index >= MEMSTAT_MAX_TAGS)
+    {
+        return 0;
+    }
+    return (uint8_t)(index + 1);
+}
+
+void memstat_record_free(const uint8_t tag,
+                         const uint32_t class_id,
+                         const size_t granted)
+{
+    memstat_site_t* site;
+
+    __atomic_fetch_add(&memstat_classes[class_id].frees, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&memstat_classes[class_id].live_bytes, granted,
+                       __ATOMIC_RELAXED);
+
+    if(tag == 0)
+    {
+        return;
+    }
+
+    site = &_START_MEMSTAT_SITES_ADDR[tag - 1];
+    __atomic_fetch_add(&site->frees, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_sub(&site->live_bytes, granted, __ATOMIC_RELAXED);
+}
+
+const memstat_site_t* memstat_get_sites(uint32_t* count)
+{
+    if(count != NULL)
+    {
+        *count = (uint32_t)(_END_MEMSTAT_SITES_ADDR -
+                            _START_MEMSTAT_SITES_ADDR);
+    }
+
+    return _START_MEMSTAT_SITES_ADDR;
+}
+
+void memstat_reset(void)
+{
+    memstat_site_t*  site;
+    memstat_class_t* class;
+    uint32_t         i;
+
+    for(i = 0; i < MEMSTAT_CLASS_COUNT; ++i)
+    {
+        class = &memstat_classes[i];
+        __atomic_store_n(&class->allocations, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&class->frees, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&class->failures, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&class->peak_bytes,
+                         __atomic_load_n(&class->live_bytes, __ATOMIC_RELAXED),
+                         __ATOMIC_RELAXED);
+    }
+
+    for(site = _START_MEMSTAT_SITES_ADDR;
+        site < _END_MEMSTAT_SITES_ADDR;
+        ++site)
+    {
+        __atomic_store_n(&site->allocations, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&site->frees, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&site->failures, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&site->requested_bytes, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&site->peak_bytes,
+                         __atomic_load_n(&site->live_bytes, __ATOMIC_RELAXED),
+                         __ATOMIC_RELAXED);
+    }
+
+    for(i = 0; i < MEMSTAT_SAMPLE_COUNT; ++i)
+    {
+        __atomic_store_n(&memstat_samples[i].stack_depth, 0,
+                         __ATOMIC_RELAXED);
+    }
+
+    memstat_reset_time = time_get_ns();
+}
+
+OS_RETURN_E memstat_snapshot(memstat_snapshot_t* snapshot)
+{
+    memstat_class_t* class;
+    OS_RETURN_E      err;
+    size_t           usable;
+    uint32_t         i;
+
+    if(snapshot == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    snapshot->elapsed_ns = time_get_ns() - memstat_reset_time;
+
+    for(i = 0; i < MEMSTAT_CLASS_COUNT; ++i)
+    {
+        class = &memstat_classes[i];
+        snapshot->classes[i].allocations =
+            __atomic_load_n(&class->allocations, __ATOMIC_RELAXED);
+        snapshot->classes[i].frees =
+            __atomic_load_n(&class->frees, __ATOMIC_RELAXED);
+        snapshot->classes[i].failures =
+            __atomic_load_n(&class->failures, __ATOMIC_RELAXED);
+        snapshot->classes[i].live_bytes =
+            __atomic_load_n(&class->live_bytes, __ATOMIC_RELAXED);
+        snapshot->classes[i].peak_bytes =
+            __atomic_load_n(&class->peak_bytes, __ATOMIC_RELAXED);
+        snapshot->class_sizes[i] = kheap_get_class_size(i);
+    }
+
+    (void)memstat_get_sites(&snapshot->site_count);
+
+    err = memmgt_get_stats(&snapshot->frames);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    /* Walk down the orders, the usable frames are the larger blocks ones */
+    usable = 0;
+    for(i = MEMMGT_MAX_ORDER + 1; i > 0; --i)
+    {
+        usable += snapshot->frames.free_blocks[i - 1] << (i - 1);
+        if(snapshot->frames.free_frames == 0)
+        {
+            snapshot->unusable[i - 1] = 0;
+        }
+        else
+        {
+            snapshot->unusable[i - 1] =
+                (uint32_t)(((uint64_t)(snapshot->frames.free_frames - usable) *
+                            1000) / snapshot->frames.free_frames);
+        }
+    }
+
+    return OS_NO_ERR;
+}
+
+void memstat_dump(void)
+{
+    memstat_snapshot_t      snapshot;
+    const memstat_site_t*   site;
+    const memstat_site_t*   sample_site;
+    const memstat_sample_t* sample;
+    uint32_t                depth;
+    uint32_t                i;
+
+    if(memstat_snapshot(&snapshot) != OS_NO_ERR)
+    {
+        return;
+    }
+
+    kernel_printf("#MEMSTAT_START\n");
+
+    /* Without KERNEL_MEMSTAT, there is no site and no sample either */
+#if KERNEL_MEMSTAT
+    for(i = 0; i < MEMSTAT_CLASS_COUNT; ++i)
+    {
+        kernel_printf("#MEMSTAT_CLASS %u %llu %llu %llu %llu %llu\n",
+                      (uint32_t)snapshot.class_sizes[i],
+                      snapshot.classes[i].allocations,
+                      snapshot.classes[i].frees,
+                      snapshot.classes[i].failures,
+                      snapshot.classes[i].live_bytes,
+                      snapshot.classes[i].peak_bytes);
+    }
+#endif
+
+    for(site = _START_MEMSTAT_SITES_ADDR;
+        site < _END_MEMSTAT_SITES_ADDR;
+        ++site)
+    {
+        if(__atomic_load_n(&site->allocations, __ATOMIC_RELAXED) == 0 &&
+           __atomic_load_n(&site->failures, __ATOMIC_RELAXED) == 0)
+        {
+            continue;
+        }
+
+        kernel_printf("#MEMSTAT_SITE %s:%u %llu %llu %llu %llu %llu %llu\n",
+                      site->file, site->line,
+                      site->allocations, site->frees, site->failures,
+                      site->requested_bytes, site->live_bytes,
+                      site->peak_bytes);
+    }
+
+    for(i = 0; i < MEMSTAT_SAMPLE_COUNT; ++i)
+    {
+        sample = &memstat_samples[i];
+        depth  = __atomic_load_n(&sample->stack_depth, __ATOMIC_ACQUIRE);
+        if(depth == 0)
+        {
+            continue;
+        }
+
+        sample_site = sample->site;
+        kernel_printf("#MEMSTAT_SAMPLE %u %s:%u ",
+                      (uint32_t)sample->size,
+                      (sample_site != NULL) ? sample_site->file : "unknown",
+                      (sample_site != NULL) ? sample_site->line : 0);
+        _memstat_print_stack(sample->stack, depth);
+    }
+
+    for(i = 0; i <= MEMMGT_MAX_ORDER; ++i)
+    {
+        kernel_printf("#MEMSTAT_BUDDY %u %u %u\n",
+                      i, (uint32_t)snapshot.frames.free_blocks[i],
+                      snapshot.unusable[i]);
+    }
+
+    kernel_printf("#MEMSTAT_END\n");
+}
+
+/************************************ EOF *************************************/
@@ -0,0 +1,416 @@
+/*******************************************************************************
+ * @file mutex.c
+ *
+ * @see mutex.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's mutexes.
+ *
+ * @details Kernel's mutexes. The owner word holds the owner thread and a
+ * waiters bit. The lock and the release without waiter are a single compare
+ * and swap on the owner word. Once the waiters bit is set, the release takes
+ * the slow path: the mutex lock is taken and the mutex is handed over to the
+ * highest priority waiter, the mutex is never free while threads wait for it.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <cpu.h>            /* CPU pause */
+#include <critical.h>       /* Kernel critical sections and spinlocks */
+#include <ctrl_block.h>     /* Threads control blocks */
+#include <scheduler.h>      /* Thread wait and priority */
+#include <wait_queue.h>     /* Threads wait queue */
+#include <rcu.h>            /* RCU read-side sections */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <mutex.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "MUTEX"
+
+/** @brief Owner word bit set when threads wait for the mutex. */
+#define MUTEX_WAITERS_BIT ((uintptr_t)0x1)
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Returns the owner thread stored in an owner word.
+ *
+ * @param[in] OWNER The owner word.
+ */
+#define MUTEX_GET_OWNER(OWNER) \
+    ((kernel_thread_t*)((OWNER) & ~MUTEX_WAITERS_BIT))
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Acquires a free mutex.
+ *
+ * @param[in, out] mutex The mutex to acquire.
+ * @param[in] thread The calling thread.
+ *
+ * @return TRUE if the mutex was free and is now owned by the thread, FALSE
+ * otherwise.
+ */
+inline static bool_t _mutex_try_acquire(mutex_t* mutex,
+                                        const kernel_thread_t* thread);
+
+/**
+ * @brief Spins while the mutex owner runs on another CPU.
+ *
+ * @details Spins for at most KERNEL_MUTEX_SPIN_COUNT iterations, trying to
+ * acquire the mutex. The spin stops as soon as the owner is not running or
+ * threads already sleep on the mutex, the owner then hands it over to them.
+ *
+ * @param[in, out] mutex The mutex to acquire.
+ * @param[in] thread The calling thread.
+ *
+ * @return TRUE if the mutex was acquired, FALSE otherwise.
+ */
+static bool_t _mutex_spin(mutex_t* mutex, const kernel_thread_t* thread);
+
+/**
+ * @brief Waits for the mutex in its wait queue.
+ *
+ * @details Sets the waiters bit, raises the owner priority for the priority
+ * inheritance mutexes and sleeps until the owner hands over the mutex.
+ *
+ * @param[in, out] mutex The mutex to acquire.
+ * @param[in, out] thread The calling thread.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if the mutex was acquired.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the calling thread is an idle
+ * thread.
+ */
+static OS_RETURN_E _mutex_wait(mutex_t* mutex, kernel_thread_t* thread);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static bool_t _mutex_try_acquire(mutex_t* mutex,
+                                        const kernel_thread_t* thread)
+{
+    uintptr_t expected;
+
+    expected = 0;
+    return __atomic_compare_exchange_n(&mutex->owner, &expected,
+                                       (uintptr_t)thread, FALSE,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+static bool_t _mutex_spin(mutex_t* mutex, const kernel_thread_t* thread)
+{
+    uintptr_t owner;
+    uint32_t  int_state;
+    uint32_t  i;
+    bool_t    acquired;
+
+    acquired = FALSE;
+
+    /* The owner control block is released after a grace period, it can be
+     * read until the read-side section ends.
+     */
+    RCU_READ_LOCK(int_state);
+    for(i = 0; i < KERNEL_MUTEX_SPIN_COUNT; ++i)
+    {
+        owner = __atomic_load_n(&mutex->owner, __ATOMIC_RELAXED);
+        if(owner == 0)
+        {
+            if(_mutex_try_acquire(mutex, thread) == TRUE)
+            {
+                acquired = TRUE;
+                break;
+            }
+            continue;
+        }
+
+        if((owner & MUTEX_WAITERS_BIT) != 0 ||
+           MUTEX_GET_OWNER(owner)->state != THREAD_STATE_RUNNING)
+        {
+            break;
+        }
+
+        _cpu_pause();
+    }
+    RCU_READ_UNLOCK(int_state);
+
+    return acquired;
+}
+
+static OS_RETURN_E _mutex_wait(mutex_t* mutex, kernel_thread_t* thread)
+{
+    wait_queue_node_t node;
+    kernel_thread_t*  owner_thread;
+    uintptr_t         owner;
+    uint32_t          int_state;
+    OS_RETURN_E       err;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(mutex->lock, int_state);
+
+    /* Once the waiters bit is set, the owner releases the mutex under the
+     * mutex lock and cannot miss the new waiter.
+     */
+    owner = __atomic_load_n(&mutex->owner, __ATOMIC_RELAXED);
+    while(TRUE)
+    {
+        if(owner == 0)
+        {
+            if(__atomic_compare_exchange_n(&mutex->owner, &owner,
+                                           (uintptr_t)thread, FALSE,
+                                           __ATOMIC_ACQUIRE,
+                                           __ATOMIC_RELAXED) == TRUE)
+            {
+                KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(mutex->lock, int_state);
+                return OS_NO_ERR;
+            }
+        }
+        else if((owner & MUTEX_WAITERS_BIT) != 0 ||
+                __atomic_compare_exchange_n(&mutex->owner, &owner,
+                                            owner | MUTEX_WAITERS_BIT, FALSE,
+                                            __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED) == TRUE)
+        {
+            break;
+        }
+    }
+
+    wait_queue_insert(&mutex->waiters, &node, thread);
+
+    /* The owner cannot release the mutex while we hold the lock */
+    owner_thread = MUTEX_GET_OWNER(owner);
+    if((mutex->flags & MUTEX_FLAG_PRIO_INHERITANCE) != 0 &&
+       thread->priority < owner_thread->priority)
+    {
+        KERNEL_DEBUG(MUTEX_DEBUG_ENABLED, MODULE_NAME,
+                     "Thread %d inherits priority %d from thread %d",
+                     owner_thread->tid, thread->priority, thread->tid);
+
+        (void)scheduler_set_priority(owner_thread, thread->priority);
+    }
+
+    /* The wait releases the lock once the thread is waiting */
+    while(node.woken == FALSE)
+    {
+        err = scheduler_wait_thread(THREAD_WAIT_TYPE_RESOURCE, &mutex->lock);
+        if(err != OS_NO_ERR)
+        {
+            /* The owner handles a waiters bit left without waiter */
+            wait_queue_remove(&mutex->waiters, &node);
+            KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(mutex->lock, int_state);
+            return err;
+        }
+        KERNEL_SPINLOCK_LOCK(mutex->lock);
+    }
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(mutex->lock, int_state);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E mutex_init(mutex_t* mutex, const uint32_t flags)
+{
+    if(mutex == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if((flags & ~MUTEX_FLAG_PRIO_INHERITANCE) != 0)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    mutex->owner = 0;
+    mutex->flags = flags;
+    wait_queue_init(&mutex->waiters);
+    KERNEL_SPINLOCK_INIT(mutex->lock);
+
+    KERNEL_DEBUG(MUTEX_DEBUG_ENABLED, MODULE_NAME,
+                 "Mutex 0x%p initialized, flags 0x%x", mutex, flags);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E mutex_lock(mutex_t* mutex)
+{
+    kernel_thread_t* thread;
+    OS_RETURN_E      err;
+
+    if(mutex == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    thread = scheduler_get_current_thread();
+
+    if(_mutex_try_acquire(mutex, thread) == FALSE)
+    {
+        if(MUTEX_GET_OWNER(mutex->owner) == thread)
+        {
+            return OS_ERR_UNAUTHORIZED_ACTION;
+        }
+
+        if(_mutex_spin(mutex, thread) == FALSE)
+        {
+            err = _mutex_wait(mutex, thread);
+            if(err != OS_NO_ERR)
+            {
+                return err;
+            }
+        }
+    }
+
+    if((mutex->flags & MUTEX_FLAG_PRIO_INHERITANCE) != 0)
+    {
+        ++thread->pi_mutex_count;
+    }
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E mutex_trylock(mutex_t* mutex)
+{
+    kernel_thread_t* thread;
+
+    if(mutex == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    thread = scheduler_get_current_thread();
+    if(_mutex_try_acquire(mutex, thread) == FALSE)
+    {
+        return OS_ERR_RESOURCE_BUSY;
+    }
+
+    if((mutex->flags & MUTEX_FLAG_PRIO_INHERITANCE) != 0)
+    {
+        ++thread->pi_mutex_count;
+    }
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E mutex_unlock(mutex_t* mutex)
+{
+    kernel_thread_t*   thread;
+    kernel_thread_t*   next_owner;
+    wait_queue_node_t* node;
+    uintptr_t          owner;
+    uint32_t           int_state;
+
+    if(mutex == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    thread = scheduler_get_current_thread();
+    owner  = __atomic_load_n(&mutex->owner, __ATOMIC_RELAXED);
+    if(MUTEX_GET_OWNER(owner) != thread)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    owner = (uintptr_t)thread;
+    if(__atomic_compare_exchange_n(&mutex->owner, &owner, 0, FALSE,
+                                   __ATOMIC_RELEASE,
+                                   __ATOMIC_RELAXED) == FALSE)
+    {
+        /* Threads wait, hand the mutex over to the highest priority one */
+        KERNEL_SPINLOCK_LOCK_IRQSAVE(mutex->lock, int_state);
+
+        node = wait_queue_pop(&mutex->waiters);
+        if(node == NULL)
+        {
+            __atomic_store_n(&mutex->owner, 0, __ATOMIC_RELEASE);
+        }
+        else
+        {
+            next_owner = node->thread;
+            owner      = (uintptr_t)next_owner;
+            if(mutex->waiters.head != NULL)
+            {
+                owner |= MUTEX_WAITERS_BIT;
+
+                /* The new owner inherits from the remaining waiters */
+                if((mutex->flags & MUTEX_FLAG_PRIO_INHERITANCE) != 0 &&
+                   mutex->waiters.head->priority < next_owner->priority)
+                {
+                    (void)scheduler_set_priority(next_owner,
+                                                 mutex->waiters.head->priority);
+                }
+            }
+            __atomic_store_n(&mutex->owner, owner, __ATOMIC_RELEASE);
+
+            /* The waiter is waiting, it cannot leave before being woken up */
+            node->woken = TRUE;
+            (void)scheduler_wakeup_thread(next_owner);
+
+            KERNEL_DEBUG(MUTEX_DEBUG_ENABLED, MODULE_NAME,
+                         "Mutex 0x%p handed over from thread %d to %d",
+                         mutex, thread->tid, next_owner->tid);
+        }
+
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(mutex->lock, int_state);
+    }
+
+    /* Drop the inherited priority once the new owner was woken up */
+    if((mutex->flags & MUTEX_FLAG_PRIO_INHERITANCE) != 0)
+    {
+        --thread->pi_mutex_count;
+        if(thread->pi_mutex_count == 0 &&
+           thread->priority != thread->base_priority)
+        {
+            (void)scheduler_set_priority(thread, thread->base_priority);
+        }
+    }
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,116 @@
+/*******************************************************************************
+ * @file percpu.c
+ *
+ * @see percpu.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's per-CPU variables.
+ *
+ * @details Kernel's per-CPU variables. The .percpu section template is loaded
+ * after the kernel data, its initial values are copied in the per-CPU data
+ * areas of all the CPUs before the BSP sets its local storage: the areas of
+ * the CPUs not started yet already hold valid variables.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* Memory manipulation */
+#include <cpu.h>            /* CPU cache line size */
+#include <panic.h>          /* Kernel panic */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <percpu.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "PERCPU"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/** @brief Start of the .percpu section, address 0, defined by the linker. */
+extern uint8_t _START_PERCPU_ADDR;
+
+/** @brief End of the .percpu section, its size, defined by the linker. */
+extern uint8_t _END_PERCPU_ADDR;
+
+/** @brief Load address of the .percpu section template, defined by the
+ * linker.
+ */
+extern uint8_t _START_PERCPU_LOAD_ADDR;
+
+/************************* Exported global variables **************************/
+/** @brief Per-CPU data areas, one per CPU. */
+uint8_t percpu_areas[MAX_CPU_COUNT][PERCPU_AREA_SIZE]
+    __attribute__((aligned(CPU_CACHE_LINE_SIZE)));
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+void percpu_init(void)
+{
+    size_t   size;
+    uint32_t i;
+
+    size = (uintptr_t)&_END_PERCPU_ADDR - (uintptr_t)&_START_PERCPU_ADDR;
+    if(size > PERCPU_AREA_SIZE)
+    {
+        PANIC(OS_ERR_NO_MORE_MEMORY, MODULE_NAME,
+              "Per-CPU variables do not fit in the per-CPU areas", TRUE);
+    }
+
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        memcpy(percpu_areas[i], &_START_PERCPU_LOAD_ADDR, size);
+    }
+
+    KERNEL_DEBUG(PERCPU_DEBUG_ENABLED, MODULE_NAME,
+                 "Per-CPU areas initialized, %u bytes used of %u",
+                 (uint32_t)size, PERCPU_AREA_SIZE);
+}
+
+/************************************ EOF *************************************/
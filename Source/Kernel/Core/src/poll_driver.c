@@ -0,0 +1,267 @@
+/*******************************************************************************
+ * @file poll_driver.c
+ *
+ * @see poll_driver.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's polling mode drivers.
+ *
+ * @details Kernel's polling mode drivers. Each reserved CPU owns a table of
+ * registered queues protected by its own lock. The poll loop holds the lock
+ * with interrupts disabled for one pass over the table, a queue that is
+ * unregistered is never polled again once the lock is released. Between two
+ * passes the loop reports a RCU quiescent state and lets the pending
+ * cross-CPU calls run.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <cpu.h>            /* CPU pause */
+#include <critical.h>       /* Kernel critical sections */
+#include <interrupts.h>     /* Interrupt manager */
+#include <scheduler.h>      /* CPU isolation */
+#include <rcu.h>            /* RCU quiescent states */
+#include <panic.h>          /* Kernel panic */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <poll_driver.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "POLL DRIVER"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Per-CPU registered queues. */
+typedef struct
+{
+    /** @brief The registered queues. */
+    poll_queue_t* queues[POLL_DRIVER_MAX_QUEUES];
+
+    /** @brief Number of registered queues. */
+    uint32_t count;
+
+    /** @brief Protects the queues, held by the poll loop during a pass. */
+    kernel_spinlock_t lock;
+} __attribute__((aligned(CPU_CACHE_LINE_SIZE))) poll_driver_cpu_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Assert macro used by the polling mode drivers to ensure correctness
+ * of execution.
+ *
+ * @details Assert macro used by the polling mode drivers to ensure
+ * correctness of execution. Due to the critical nature of the polling mode
+ * drivers, any error generates a kernel panic.
+ *
+ * @param[in] COND The condition that should be true.
+ * @param[in] MSG The message to display in case of kernel panic.
+ * @param[in] ERROR The error code to use in case of kernel panic.
+ */
+#define POLL_DRIVER_ASSERT(COND, MSG, ERROR) {              \
+    if((COND) == FALSE)                                     \
+    {                                                       \
+        PANIC(ERROR, MODULE_NAME, MSG, TRUE);               \
+    }                                                       \
+}
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Per-CPU registered queues. */
+static poll_driver_cpu_t poll_driver_cpus[MAX_CPU_COUNT] = {
+    [0 ... MAX_CPU_COUNT - 1] = {
+        .count = 0,
+        .lock  = KERNEL_SPINLOCK_INIT_VALUE
+    }
+};
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+bool_t poll_driver_is_reserved(const uint32_t cpu_id)
+{
+    /* The BSP always takes part in the threads scheduling */
+    if(cpu_id == 0 || cpu_id >= MAX_CPU_COUNT)
+    {
+        return FALSE;
+    }
+
+    return (((POLL_DRIVER_CPU_MASK) & (1U << cpu_id)) != 0);
+}
+
+OS_RETURN_E poll_driver_register(poll_queue_t* queue,
+                                 const uint32_t cpu_id,
+                                 const uint32_t irq_number,
+                                 const uint32_t budget,
+                                 uint32_t (*poll)(void* args,
+                                                  const uint32_t budget),
+                                 void* args)
+{
+    poll_driver_cpu_t* cpu;
+    uint32_t           int_state;
+
+    if(queue == NULL || poll == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(budget == 0 || poll_driver_is_reserved(cpu_id) == FALSE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    queue->poll       = poll;
+    queue->args       = args;
+    queue->irq_number = irq_number;
+    queue->budget     = budget;
+    queue->cpu_id     = cpu_id;
+
+    cpu = &poll_driver_cpus[cpu_id];
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(cpu->lock, int_state);
+    if(cpu->count == POLL_DRIVER_MAX_QUEUES)
+    {
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(cpu->lock, int_state);
+        return OS_ERR_OUT_OF_BOUND;
+    }
+    cpu->queues[cpu->count++] = queue;
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(cpu->lock, int_state);
+
+    /* The loop handles the events, the device must not interrupt anymore */
+    if(irq_number != POLL_DRIVER_NO_IRQ)
+    {
+        kernel_interrupt_set_irq_mask(irq_number, FALSE);
+    }
+
+    KERNEL_DEBUG(POLL_DRIVER_DEBUG_ENABLED, MODULE_NAME,
+                 "Registered queue 0x%p on CPU %u", queue, cpu_id);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E poll_driver_unregister(poll_queue_t* queue)
+{
+    poll_driver_cpu_t* cpu;
+    uint32_t           int_state;
+    uint32_t           i;
+
+    if(queue == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(queue->cpu_id >= MAX_CPU_COUNT)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    cpu = &poll_driver_cpus[queue->cpu_id];
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(cpu->lock, int_state);
+    for(i = 0; i < cpu->count && cpu->queues[i] != queue; ++i);
+    if(i == cpu->count)
+    {
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(cpu->lock, int_state);
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+    cpu->queues[i] = cpu->queues[--cpu->count];
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(cpu->lock, int_state);
+
+    if(queue->irq_number != POLL_DRIVER_NO_IRQ)
+    {
+        kernel_interrupt_set_irq_mask(queue->irq_number, TRUE);
+    }
+
+    KERNEL_DEBUG(POLL_DRIVER_DEBUG_ENABLED, MODULE_NAME,
+                 "Unregistered queue 0x%p from CPU %u", queue, queue->cpu_id);
+
+    return OS_NO_ERR;
+}
+
+void poll_driver_loop(void)
+{
+    poll_driver_cpu_t* cpu;
+    uint32_t           cpu_id;
+    uint32_t           events;
+    uint32_t           int_state;
+    uint32_t           i;
+    OS_RETURN_E        err;
+
+    err = scheduler_isolate_cpu();
+    POLL_DRIVER_ASSERT(err == OS_NO_ERR,
+                       "Could not remove the CPU from the scheduling",
+                       err);
+
+    cpu_id = scheduler_get_current_cpu_id();
+    cpu    = &poll_driver_cpus[cpu_id];
+
+    KERNEL_DEBUG(POLL_DRIVER_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %u entering the poll loop", cpu_id);
+
+    /* The cross-CPU calls are served between two passes */
+    _cpu_set_interrupt();
+
+    while(TRUE)
+    {
+        KERNEL_SPINLOCK_LOCK_IRQSAVE(cpu->lock, int_state);
+
+        /* The loop never enters the idle routine that reports it */
+        rcu_quiescent_state();
+
+        events = 0;
+        for(i = 0; i < cpu->count; ++i)
+        {
+            events += cpu->queues[i]->poll(cpu->queues[i]->args,
+                                           cpu->queues[i]->budget);
+        }
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(cpu->lock, int_state);
+
+        if(events == 0)
+        {
+            _cpu_pause();
+        }
+    }
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
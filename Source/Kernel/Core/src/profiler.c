@@ -0,0 +1,482 @@
+/*******************************************************************************
+ * @file profiler.c
+ *
+ * @see profiler.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's sampling profiler.
+ *
+ * @details Kernel's sampling profiler. Each CPU aggregates its samples in its
+ * own open addressing table keyed by thread and instruction pointer, a sample
+ * takes no lock and touches a single entry. The samples that find no free
+ * entry are counted as dropped. The start and stop requests are applied by
+ * each CPU in the profiler control interrupt handler. The main timer source
+ * only samples the code running with interrupts enabled.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* Memory manipulation */
+#include <cpu.h>            /* CPU management */
+#include <cpu_interrupt.h>  /* CPU interrupts settings */
+#include <interrupts.h>     /* Interrupts management */
+#include <critical.h>       /* Critical sections */
+#include <scheduler.h>      /* Current CPU identifier */
+#include <time_mgt.h>       /* Profiler deadline */
+#include <ctrl_block.h>     /* Thread structures */
+#include <stack_trace.h>    /* Stack walker */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <profiler.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "PROFILER"
+
+/** @brief Number of entries probed before a sample is dropped. */
+#define PROFILER_MAX_PROBES 8
+
+/** @brief Multiplicative hash factor of the sample keys. */
+#define PROFILER_HASH_FACTOR 0x9E3779B1U
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Aggregated sample. */
+typedef struct
+{
+    /** @brief Sampled stack, the interrupted instruction pointer followed by
+     * the return addresses.
+     */
+    uintptr_t stack[PROFILER_STACK_DEPTH];
+
+    /** @brief Sampled thread identifier. */
+    int32_t tid;
+
+    /** @brief Number of valid addresses in the stack. */
+    uint32_t depth;
+
+    /** @brief Number of samples, 0 for a free entry. */
+    uint32_t count;
+} profiler_entry_t;
+
+/** @brief Per-CPU profiler data, only written by its CPU. */
+typedef struct
+{
+    /** @brief Aggregated samples table. */
+    profiler_entry_t entries[PROFILER_SAMPLE_TABLE_SIZE];
+
+    /** @brief Number of recorded samples. */
+    uint32_t sample_count;
+
+    /** @brief Number of samples dropped because the table was full. */
+    uint32_t dropped_count;
+
+    /** @brief Tells if the CPU is sampling. */
+    bool_t running;
+} __attribute__((aligned(CPU_CACHE_LINE_SIZE))) profiler_cpu_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Per-CPU profiler data. */
+static profiler_cpu_t profiler_cpus[MAX_CPU_COUNT];
+
+/** @brief The sampling source. */
+static profiler_source_t profiler_source;
+
+/** @brief Tells if the profiler is initialized. */
+static bool_t profiler_initialized = FALSE;
+
+/** @brief Tells if the CPUs should sample. */
+static volatile bool_t profiler_enabled = FALSE;
+
+/** @brief Sampling period in nanoseconds. */
+static uint64_t profiler_period_ns;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Starts or stops sampling on the calling CPU.
+ *
+ * @details Starts or stops sampling on the calling CPU to match the profiler
+ * state. This function must be called with interrupts disabled.
+ */
+static void _profiler_update_local(void);
+
+/**
+ * @brief Profiler control interrupt handler.
+ *
+ * @param[in] curr_thread The interrupted thread.
+ */
+static void _profiler_control_handler(kernel_thread_t* curr_thread);
+
+/**
+ * @brief Notifies the other CPUs of a profiler state change.
+ */
+static void _profiler_notify_cpus(void);
+
+/**
+ * @brief Main timer source start function.
+ *
+ * @param[in] period_ns The sampling period in nanoseconds.
+ *
+ * @return OS_NO_ERR.
+ */
+static OS_RETURN_E _profiler_timer_start_local(const uint64_t period_ns);
+
+/**
+ * @brief Main timer source stop function.
+ */
+static void _profiler_timer_stop_local(void);
+
+/**
+ * @brief Main timer source deadline handler.
+ *
+ * @details Samples the interrupted thread and sets the next profiler
+ * deadline of the calling CPU.
+ *
+ * @param[in] curr_thread The interrupted thread.
+ */
+static void _profiler_timer_handler(kernel_thread_t* curr_thread);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void _profiler_update_local(void)
+{
+    profiler_cpu_t* cpu;
+    bool_t          enabled;
+
+    cpu     = &profiler_cpus[scheduler_get_current_cpu_id()];
+    enabled = __atomic_load_n(&profiler_enabled, __ATOMIC_ACQUIRE);
+
+    /* The isolated CPUs arm no sampling timer */
+    if(scheduler_is_cpu_isolated(scheduler_get_current_cpu_id()) == TRUE)
+    {
+        enabled = FALSE;
+    }
+    if(enabled == cpu->running)
+    {
+        return;
+    }
+
+    if(enabled == TRUE)
+    {
+        cpu->running = (profiler_source.start_local(profiler_period_ns) ==
+                        OS_NO_ERR);
+    }
+    else
+    {
+        profiler_source.stop_local();
+        cpu->running = FALSE;
+    }
+
+    KERNEL_DEBUG(PROFILER_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %u sampling set to %u",
+                 scheduler_get_current_cpu_id(), cpu->running);
+}
+
+static void _profiler_control_handler(kernel_thread_t* curr_thread)
+{
+    (void)curr_thread;
+
+    cpu_ipi_eoi();
+    _profiler_update_local();
+}
+
+static void _profiler_notify_cpus(void)
+{
+    uint32_t int_state;
+    uint32_t cpu_id;
+    uint32_t i;
+
+    ENTER_CRITICAL(int_state);
+
+    _profiler_update_local();
+
+    /* The CPUs that are not started have no LAPIC identifier */
+    cpu_id = scheduler_get_current_cpu_id();
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        if(i != cpu_id)
+        {
+            (void)cpu_send_ipi(i, PROFILER_INT_LINE);
+        }
+    }
+
+    EXIT_CRITICAL(int_state);
+}
+
+static OS_RETURN_E _profiler_timer_start_local(const uint64_t period_ns)
+{
+    time_set_deadline(TIME_DEADLINE_PROFILER, time_get_ns() + period_ns);
+
+    return OS_NO_ERR;
+}
+
+static void _profiler_timer_stop_local(void)
+{
+    time_set_deadline(TIME_DEADLINE_PROFILER, 0);
+}
+
+static void _profiler_timer_handler(kernel_thread_t* curr_thread)
+{
+    if(profiler_cpus[scheduler_get_current_cpu_id()].running == TRUE)
+    {
+        profiler_sample(curr_thread);
+        time_set_deadline(TIME_DEADLINE_PROFILER,
+                          time_get_ns() + profiler_period_ns);
+    }
+}
+
+OS_RETURN_E profiler_init(const profiler_source_t* source)
+{
+    OS_RETURN_E err;
+
+    if(source != NULL)
+    {
+        if(source->start_local == NULL || source->stop_local == NULL)
+        {
+            return OS_ERR_NULL_POINTER;
+        }
+        profiler_source = *source;
+    }
+    else
+    {
+        err = time_register_deadline_handler(TIME_DEADLINE_PROFILER,
+                                             _profiler_timer_handler);
+        if(err != OS_NO_ERR)
+        {
+            return err;
+        }
+        profiler_source.name        = "timer";
+        profiler_source.start_local = _profiler_timer_start_local;
+        profiler_source.stop_local  = _profiler_timer_stop_local;
+    }
+
+    err = kernel_interrupt_register_int_handler(PROFILER_INT_LINE,
+                                                _profiler_control_handler);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    memset(profiler_cpus, 0, sizeof(profiler_cpus));
+    profiler_initialized = TRUE;
+
+    KERNEL_SUCCESS("Profiler initialized, %s source\n", profiler_source.name);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E profiler_start(const uint64_t period_ns)
+{
+    if(profiler_initialized == FALSE)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+    if(period_ns == 0)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+    if(__atomic_load_n(&profiler_enabled, __ATOMIC_ACQUIRE) == TRUE)
+    {
+        return OS_ERR_RESOURCE_BUSY;
+    }
+
+    profiler_period_ns = period_ns;
+    __atomic_store_n(&profiler_enabled, TRUE, __ATOMIC_RELEASE);
+
+    _profiler_notify_cpus();
+
+    KERNEL_DEBUG(PROFILER_DEBUG_ENABLED, MODULE_NAME,
+                 "Started with a %uns period", (uint32_t)period_ns);
+
+    return OS_NO_ERR;
+}
+
+void profiler_stop(void)
+{
+    if(profiler_initialized == FALSE)
+    {
+        return;
+    }
+
+    __atomic_store_n(&profiler_enabled, FALSE, __ATOMIC_RELEASE);
+
+    _profiler_notify_cpus();
+
+    KERNEL_DEBUG(PROFILER_DEBUG_ENABLED, MODULE_NAME, "Stopped");
+}
+
+OS_RETURN_E profiler_reset(void)
+{
+    uint32_t i;
+
+    if(__atomic_load_n(&profiler_enabled, __ATOMIC_ACQUIRE) == TRUE)
+    {
+        return OS_ERR_RESOURCE_BUSY;
+    }
+
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        memset(profiler_cpus[i].entries, 0, sizeof(profiler_cpus[i].entries));
+        profiler_cpus[i].sample_count  = 0;
+        profiler_cpus[i].dropped_count = 0;
+    }
+
+    return OS_NO_ERR;
+}
+
+void profiler_sample(const kernel_thread_t* thread)
+{
+    profiler_cpu_t*   cpu;
+    profiler_entry_t* entry;
+    uintptr_t         stack[PROFILER_STACK_DEPTH];
+    uint32_t          depth;
+    uint32_t          index;
+    uint32_t          i;
+    uint32_t          j;
+
+    cpu = &profiler_cpus[scheduler_get_current_cpu_id()];
+    if(cpu->running == FALSE)
+    {
+        return;
+    }
+
+    stack[0] = _cpu_get_saved_pc(&thread->v_cpu);
+    depth    = 1 + stack_trace_walk(_cpu_get_saved_fp(&thread->v_cpu),
+                                    stack + 1, PROFILER_STACK_DEPTH - 1);
+
+    index = (uint32_t)thread->tid * PROFILER_HASH_FACTOR;
+    for(i = 0; i < depth; ++i)
+    {
+        index = (index ^ (uint32_t)stack[i]) * PROFILER_HASH_FACTOR;
+    }
+    index = index >> (32 - __builtin_ctz(PROFILER_SAMPLE_TABLE_SIZE));
+
+    for(i = 0; i < PROFILER_MAX_PROBES; ++i)
+    {
+        entry = &cpu->entries[(index + i) & (PROFILER_SAMPLE_TABLE_SIZE - 1)];
+        if(entry->count == 0)
+        {
+            for(j = 0; j < depth; ++j)
+            {
+                entry->stack[j] = stack[j];
+            }
+            entry->depth = depth;
+            entry->tid   = thread->tid;
+            entry->count = 1;
+            ++cpu->sample_count;
+            return;
+        }
+        if(entry->tid == thread->tid && entry->depth == depth)
+        {
+            j = 0;
+            while(j < depth && entry->stack[j] == stack[j])
+            {
+                ++j;
+            }
+            if(j == depth)
+            {
+                ++entry->count;
+                ++cpu->sample_count;
+                return;
+            }
+        }
+    }
+
+    ++cpu->dropped_count;
+}
+
+void profiler_dump(void)
+{
+    const profiler_entry_t* entry;
+    const char*             symbol;
+    uintptr_t               address;
+    uint32_t                i;
+    uint32_t                j;
+    uint32_t                k;
+
+    kernel_printf("#PROF_START %s %u\n", profiler_source.name,
+                  (uint32_t)profiler_period_ns);
+
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        kernel_printf("#PROF_CPU %u %u %u\n", i,
+                      profiler_cpus[i].sample_count,
+                      profiler_cpus[i].dropped_count);
+
+        for(j = 0; j < PROFILER_SAMPLE_TABLE_SIZE; ++j)
+        {
+            entry = &profiler_cpus[i].entries[j];
+            if(entry->count == 0)
+            {
+                continue;
+            }
+
+            /* Folded stacks start with the outermost frame */
+            kernel_printf("#PROF %d", entry->tid);
+            for(k = entry->depth; k > 0; --k)
+            {
+                /* A return address might be the first byte after its
+                 * function.
+                 */
+                address = entry->stack[k - 1];
+                symbol  = stack_trace_lookup(address - (k != 1), NULL);
+                if(symbol != NULL)
+                {
+                    kernel_printf(";%s", symbol);
+                }
+                else
+                {
+                    kernel_printf(";0x%p", address);
+                }
+            }
+            kernel_printf(" %u\n", entry->count);
+        }
+    }
+
+    kernel_printf("#PROF_END\n");
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
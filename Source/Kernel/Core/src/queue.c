@@ -0,0 +1,550 @@
+/*******************************************************************************
+ * @file queue.c
+ *
+ * @see queue.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's bounded lock-free queues and message queues.
+ *
+ * @details Kernel's bounded lock-free queues and message queues. The multiple
+ * producers multiple consumers queue follows the bounded queue of D. Vyukov:
+ * the sequence of a cell tells the producers and the consumers whether the
+ * cell is theirs for the current turn. The message queues only take their
+ * lock when a thread waits or has to be woken up.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <cpu.h>            /* CPU pause */
+#include <critical.h>       /* Kernel critical sections and spinlocks */
+#include <ctrl_block.h>     /* Threads control blocks */
+#include <scheduler.h>      /* Thread wait */
+#include <wait_queue.h>     /* Threads wait queue */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <queue.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "QUEUE"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Checks the storage and the capacity of a queue.
+ *
+ * @param[in] storage The queue storage.
+ * @param[in] capacity The queue capacity.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the storage is NULL.
+ * - OS_ERR_OUT_OF_BOUND is returned if the capacity is not a power of two or
+ * is greater than QUEUE_MAX_CAPACITY.
+ */
+static OS_RETURN_E _queue_check_capacity(const void* storage,
+                                         const uint32_t capacity);
+
+/**
+ * @brief Sends or receives a message without waiting.
+ *
+ * @param[in, out] mqueue The message queue.
+ * @param[in] send TRUE to send the message, FALSE to receive it.
+ * @param[in, out] message The sent message or the buffer receiving the
+ * message.
+ *
+ * @return TRUE if the message was sent or received, FALSE if the queue is
+ * full or empty.
+ */
+inline static bool_t _mqueue_try(mqueue_t* mqueue,
+                                 const bool_t send,
+                                 void** message);
+
+/**
+ * @brief Sends or receives a message, waits while the queue is full or
+ * empty.
+ *
+ * @details Sends or receives a message. The calling thread spins while no
+ * other thread waits, then waits in the senders or the receivers wait queue.
+ * The waiter is queued before its last try: either the try succeeds or the
+ * other side sees the waiter once it made room or posted a message.
+ *
+ * @param[in, out] mqueue The message queue.
+ * @param[in] send TRUE to send the message, FALSE to receive it.
+ * @param[in, out] message The sent message or the buffer receiving the
+ * message.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the calling thread is an idle
+ * thread that would have to wait.
+ */
+static OS_RETURN_E _mqueue_transfer(mqueue_t* mqueue,
+                                    const bool_t send,
+                                    void** message);
+
+/**
+ * @brief Wakes up the highest priority thread of a message queue wait queue.
+ *
+ * @details Wakes up the highest priority thread of a message queue wait
+ * queue. The lock is only taken when a thread waits.
+ *
+ * @param[in, out] mqueue The message queue.
+ * @param[in, out] waiters The wait queue.
+ */
+static void _mqueue_wakeup(mqueue_t* mqueue, wait_queue_t* waiters);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static OS_RETURN_E _queue_check_capacity(const void* storage,
+                                         const uint32_t capacity)
+{
+    if(storage == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(capacity == 0 ||
+       capacity > QUEUE_MAX_CAPACITY ||
+       (capacity & (capacity - 1)) != 0)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E spsc_queue_init(spsc_queue_t* queue,
+                            void** slots,
+                            const uint32_t capacity)
+{
+    OS_RETURN_E err;
+
+    if(queue == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    err = _queue_check_capacity(slots, capacity);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    queue->tail        = 0;
+    queue->cached_head = 0;
+    queue->head        = 0;
+    queue->cached_tail = 0;
+    queue->slots       = slots;
+    queue->mask        = capacity - 1;
+
+    KERNEL_DEBUG(QUEUE_DEBUG_ENABLED, MODULE_NAME,
+                 "SPSC queue 0x%p initialized, capacity %u", queue, capacity);
+
+    return OS_NO_ERR;
+}
+
+bool_t spsc_queue_push(spsc_queue_t* queue, void* element)
+{
+    uint32_t tail;
+
+    tail = queue->tail;
+    if(tail - queue->cached_head > queue->mask)
+    {
+        /* Only read the consumer line when the queue looks full */
+        queue->cached_head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+        if(tail - queue->cached_head > queue->mask)
+        {
+            return FALSE;
+        }
+    }
+
+    queue->slots[tail & queue->mask] = element;
+    __atomic_store_n(&queue->tail, tail + 1, __ATOMIC_RELEASE);
+
+    return TRUE;
+}
+
+bool_t spsc_queue_pop(spsc_queue_t* queue, void** element)
+{
+    uint32_t head;
+
+    head = queue->head;
+    if(head == queue->cached_tail)
+    {
+        /* Only read the producer line when the queue looks empty */
+        queue->cached_tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+        if(head == queue->cached_tail)
+        {
+            return FALSE;
+        }
+    }
+
+    *element = queue->slots[head & queue->mask];
+    __atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+
+    return TRUE;
+}
+
+OS_RETURN_E mpmc_queue_init(mpmc_queue_t* queue,
+                            mpmc_cell_t* cells,
+                            const uint32_t capacity)
+{
+    OS_RETURN_E err;
+    uint32_t    i;
+
+    if(queue == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    err = _queue_check_capacity(cells, capacity);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    for(i = 0; i < capacity; ++i)
+    {
+        cells[i].sequence = i;
+        cells[i].data     = NULL;
+    }
+
+    queue->tail  = 0;
+    queue->head  = 0;
+    queue->cells = cells;
+    queue->mask  = capacity - 1;
+
+    KERNEL_DEBUG(QUEUE_DEBUG_ENABLED, MODULE_NAME,
+                 "MPMC queue 0x%p initialized, capacity %u", queue, capacity);
+
+    return OS_NO_ERR;
+}
+
+bool_t mpmc_queue_push(mpmc_queue_t* queue, void* element)
+{
+    mpmc_cell_t* cell;
+    uint32_t     position;
+    uint32_t     sequence;
+    int32_t      diff;
+
+    position = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+    while(TRUE)
+    {
+        cell     = &queue->cells[position & queue->mask];
+        sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        diff     = (int32_t)(sequence - position);
+        if(diff == 0)
+        {
+            /* The cell is free for this turn, take it */
+            if(__atomic_compare_exchange_n(&queue->tail, &position,
+                                           position + 1, TRUE,
+                                           __ATOMIC_RELAXED,
+                                           __ATOMIC_RELAXED) == TRUE)
+            {
+                break;
+            }
+        }
+        else if(diff < 0)
+        {
+            /* The cell still holds the element of the previous turn */
+            return FALSE;
+        }
+        else
+        {
+            position = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    cell->data = element;
+    __atomic_store_n(&cell->sequence, position + 1, __ATOMIC_RELEASE);
+
+    return TRUE;
+}
+
+bool_t mpmc_queue_pop(mpmc_queue_t* queue, void** element)
+{
+    mpmc_cell_t* cell;
+    uint32_t     position;
+    uint32_t     sequence;
+    int32_t      diff;
+
+    position = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    while(TRUE)
+    {
+        cell     = &queue->cells[position & queue->mask];
+        sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        diff     = (int32_t)(sequence - (position + 1));
+        if(diff == 0)
+        {
+            /* The cell was published for this turn, take it */
+            if(__atomic_compare_exchange_n(&queue->head, &position,
+                                           position + 1, TRUE,
+                                           __ATOMIC_RELAXED,
+                                           __ATOMIC_RELAXED) == TRUE)
+            {
+                break;
+            }
+        }
+        else if(diff < 0)
+        {
+            /* The cell was not published yet */
+            return FALSE;
+        }
+        else
+        {
+            position = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    *element = cell->data;
+
+    /* Free the cell for the next turn */
+    __atomic_store_n(&cell->sequence, position + queue->mask + 1,
+                     __ATOMIC_RELEASE);
+
+    return TRUE;
+}
+
+inline static bool_t _mqueue_try(mqueue_t* mqueue,
+                                 const bool_t send,
+                                 void** message)
+{
+    if(send == TRUE)
+    {
+        return mpmc_queue_push(&mqueue->queue, *message);
+    }
+
+    return mpmc_queue_pop(&mqueue->queue, message);
+}
+
+static OS_RETURN_E _mqueue_transfer(mqueue_t* mqueue,
+                                    const bool_t send,
+                                    void** message)
+{
+    wait_queue_node_t node;
+    wait_queue_t*     waiters;
+    uint32_t          int_state;
+    uint32_t          i;
+    OS_RETURN_E       err;
+
+    waiters = (send == TRUE) ? &mqueue->senders : &mqueue->receivers;
+
+    /* Spin while no thread sleeps, the woken threads go first */
+    for(i = 0; i < KERNEL_MQUEUE_SPIN_COUNT; ++i)
+    {
+        if(_mqueue_try(mqueue, send, message) == TRUE)
+        {
+            return OS_NO_ERR;
+        }
+        if(__atomic_load_n(&waiters->head, __ATOMIC_RELAXED) != NULL)
+        {
+            break;
+        }
+        _cpu_pause();
+    }
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(mqueue->lock, int_state);
+
+    while(TRUE)
+    {
+        wait_queue_insert(waiters, &node, scheduler_get_current_thread());
+
+        /* Pairs with the fence of _mqueue_wakeup */
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+        if(_mqueue_try(mqueue, send, message) == TRUE)
+        {
+            wait_queue_remove(waiters, &node);
+            break;
+        }
+
+        /* The wait releases the lock once the thread is waiting */
+        err = scheduler_wait_thread(THREAD_WAIT_TYPE_RESOURCE, &mqueue->lock);
+        if(err != OS_NO_ERR)
+        {
+            wait_queue_remove(waiters, &node);
+            KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(mqueue->lock, int_state);
+            return err;
+        }
+        KERNEL_SPINLOCK_LOCK(mqueue->lock);
+
+        /* Another thread might have been faster, the node is queued again.
+         * Nothing is removed when the waker already popped the node.
+         */
+        wait_queue_remove(waiters, &node);
+    }
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(mqueue->lock, int_state);
+
+    return OS_NO_ERR;
+}
+
+static void _mqueue_wakeup(mqueue_t* mqueue, wait_queue_t* waiters)
+{
+    wait_queue_node_t* node;
+    uint32_t           int_state;
+
+    /* Either the waiter sees the queue change or the waiter is seen here */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if(__atomic_load_n(&waiters->head, __ATOMIC_RELAXED) == NULL)
+    {
+        return;
+    }
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(mqueue->lock, int_state);
+
+    node = wait_queue_pop(waiters);
+    if(node != NULL)
+    {
+        /* The waiter is waiting, it cannot leave before being woken up */
+        node->woken = TRUE;
+        (void)scheduler_wakeup_thread(node->thread);
+
+        KERNEL_DEBUG(QUEUE_DEBUG_ENABLED, MODULE_NAME,
+                     "Message queue 0x%p woke up thread %d",
+                     mqueue, node->thread->tid);
+    }
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(mqueue->lock, int_state);
+}
+
+OS_RETURN_E mqueue_init(mqueue_t* mqueue,
+                        mpmc_cell_t* cells,
+                        const uint32_t capacity)
+{
+    OS_RETURN_E err;
+
+    if(mqueue == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    err = mpmc_queue_init(&mqueue->queue, cells, capacity);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    wait_queue_init(&mqueue->receivers);
+    wait_queue_init(&mqueue->senders);
+    KERNEL_SPINLOCK_INIT(mqueue->lock);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E mqueue_send(mqueue_t* mqueue, void* message)
+{
+    OS_RETURN_E err;
+
+    if(mqueue == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    err = _mqueue_transfer(mqueue, TRUE, &message);
+    if(err == OS_NO_ERR)
+    {
+        _mqueue_wakeup(mqueue, &mqueue->receivers);
+    }
+
+    return err;
+}
+
+OS_RETURN_E mqueue_trysend(mqueue_t* mqueue, void* message)
+{
+    if(mqueue == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(mpmc_queue_push(&mqueue->queue, message) == FALSE)
+    {
+        return OS_ERR_RESOURCE_BUSY;
+    }
+    _mqueue_wakeup(mqueue, &mqueue->receivers);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E mqueue_receive(mqueue_t* mqueue, void** message)
+{
+    OS_RETURN_E err;
+
+    if(mqueue == NULL || message == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    err = _mqueue_transfer(mqueue, FALSE, message);
+    if(err == OS_NO_ERR)
+    {
+        _mqueue_wakeup(mqueue, &mqueue->senders);
+    }
+
+    return err;
+}
+
+OS_RETURN_E mqueue_tryreceive(mqueue_t* mqueue, void** message)
+{
+    if(mqueue == NULL || message == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(mpmc_queue_pop(&mqueue->queue, message) == FALSE)
+    {
+        return OS_ERR_RESOURCE_BUSY;
+    }
+    _mqueue_wakeup(mqueue, &mqueue->senders);
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
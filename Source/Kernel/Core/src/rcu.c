@@ -0,0 +1,435 @@
+/*******************************************************************************
+ * @file rcu.c
+ *
+ * @see rcu.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's read-copy-update deferred reclamation.
+ *
+ * @details Kernel's read-copy-update deferred reclamation. The grace periods
+ * are numbered. Starting a grace period sets the pending mask to the online
+ * CPUs, each CPU clears its bit on its first quiescent state of the grace
+ * period and the last one marks the grace period as completed. The callbacks
+ * are queued on their CPU without lock. When the CPU has no callback waiting
+ * for a grace period, its new callbacks are assigned the next grace period
+ * and are called by the CPU once it completed. Starting a grace period wakes
+ * the other CPUs, an idle CPU might otherwise wait for its next interrupt
+ * before it goes through a quiescent state.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <cpu.h>            /* CPU cache line size */
+#include <critical.h>       /* Kernel critical sections and spinlocks */
+#include <scheduler.h>      /* Current CPU identifier and thread wait */
+#include <ipi.h>            /* Cross-CPU calls */
+#include <idle.h>           /* Idle CPUs wakeup */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <rcu.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "RCU"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Per-CPU RCU data, only accessed by its CPU. */
+typedef struct
+{
+    /** @brief Last grace period the CPU reported a quiescent state for. */
+    uint32_t quiescent_gp;
+
+    /** @brief Callbacks not yet assigned to a grace period. */
+    rcu_head_t* next_list;
+
+    /** @brief Callbacks waiting for the end of wait_gp. */
+    rcu_head_t* wait_list;
+
+    /** @brief Grace period the waiting callbacks wait for. */
+    uint32_t wait_gp;
+} __attribute__((aligned(CPU_CACHE_LINE_SIZE))) rcu_cpu_t;
+
+/** @brief Grace period waited for by rcu_synchronize. */
+typedef struct
+{
+    /** @brief Callback node of the wait. */
+    rcu_head_t head;
+
+    /** @brief Thread waiting for the grace period, NULL if none. */
+    kernel_thread_t* waiter;
+
+    /** @brief Set once the grace period elapsed. */
+    volatile bool_t done;
+
+    /** @brief Lock protecting the wait. */
+    kernel_spinlock_t lock;
+} rcu_sync_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Tells if the grace period A is the grace period B or a later one.
+ *
+ * @param[in] A The first grace period.
+ * @param[in] B The second grace period.
+ */
+#define RCU_GP_REACHED(A, B) ((int32_t)((A) - (B)) >= 0)
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Per-CPU RCU data. */
+static rcu_cpu_t rcu_cpus[MAX_CPU_COUNT];
+
+/** @brief Last started grace period. */
+static volatile uint32_t rcu_gp_current = 0;
+
+/** @brief Last completed grace period. */
+static volatile uint32_t rcu_gp_completed = 0;
+
+/** @brief CPUs that did not report a quiescent state for the current grace
+ * period, one bit per CPU.
+ */
+static volatile uint32_t rcu_gp_pending = 0;
+
+/** @brief CPUs taking part in the grace periods, one bit per CPU. */
+static volatile uint32_t rcu_online_cpus = 0;
+
+/** @brief Lock serializing the grace periods start. */
+static kernel_spinlock_t rcu_gp_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/** @brief Quiescent state requests posted to the CPUs when a grace period
+ * starts.
+ */
+static ipi_call_t rcu_kick_calls[MAX_CPU_COUNT];
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Reports a quiescent state for the current grace period.
+ *
+ * @details Clears the CPU bit in the pending mask the first time the CPU goes
+ * through a quiescent state in the current grace period. The last CPU to
+ * report completes the grace period.
+ *
+ * @param[in, out] cpu The calling CPU RCU data.
+ * @param[in] cpu_id The calling CPU identifier.
+ */
+inline static void _rcu_report(rcu_cpu_t* cpu, const uint32_t cpu_id);
+
+/**
+ * @brief Requests a new grace period.
+ *
+ * @details Starts a new grace period if none is in progress. When a grace
+ * period is in progress, a CPU might already have reported its quiescent
+ * state: the callbacks wait for the next one.
+ *
+ * @return The grace period the callbacks queued before the call must wait for.
+ */
+static uint32_t _rcu_request_gp(void);
+
+/**
+ * @brief Quiescent state request function, reports a quiescent state.
+ *
+ * @details Reports a quiescent state of the interrupted CPU. The RCU
+ * read-side sections run with interrupts disabled, the interrupted context is
+ * not in one.
+ *
+ * @param[in] args Unused.
+ */
+static void _rcu_kick(void* args);
+
+/**
+ * @brief Advances the calling CPU callbacks.
+ *
+ * @details Calls the callbacks whose grace period completed and assigns a
+ * grace period to the new callbacks.
+ *
+ * @param[in, out] cpu The calling CPU RCU data.
+ */
+static void _rcu_process_callbacks(rcu_cpu_t* cpu);
+
+/**
+ * @brief Ends a rcu_synchronize wait.
+ *
+ * @param[in] head The callback node of the wait.
+ */
+static void _rcu_sync_callback(rcu_head_t* head);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static void _rcu_report(rcu_cpu_t* cpu, const uint32_t cpu_id)
+{
+    uint32_t current;
+    uint32_t mask;
+
+    current = __atomic_load_n(&rcu_gp_current, __ATOMIC_ACQUIRE);
+    if(cpu->quiescent_gp == current)
+    {
+        return;
+    }
+    cpu->quiescent_gp = current;
+
+    /* The CPU holds no reference from before the grace period started */
+    mask = 1U << cpu_id;
+    if(__atomic_fetch_and(&rcu_gp_pending, ~mask, __ATOMIC_ACQ_REL) == mask)
+    {
+        __atomic_store_n(&rcu_gp_completed, current, __ATOMIC_RELEASE);
+
+        KERNEL_DEBUG(RCU_DEBUG_ENABLED, MODULE_NAME,
+                     "Grace period %u completed by CPU %u", current, cpu_id);
+    }
+}
+
+static uint32_t _rcu_request_gp(void)
+{
+    uint32_t current;
+    uint32_t target;
+    uint32_t kicked;
+    uint32_t i;
+
+    kicked = 0;
+
+    KERNEL_SPINLOCK_LOCK(rcu_gp_lock);
+
+    current = rcu_gp_current;
+    target  = current + 1;
+    if(rcu_gp_completed == current)
+    {
+        __atomic_store_n(&rcu_gp_pending, rcu_online_cpus, __ATOMIC_RELAXED);
+        __atomic_store_n(&rcu_gp_current, target, __ATOMIC_RELEASE);
+        kicked = rcu_online_cpus & ~(1U << scheduler_get_current_cpu_id());
+    }
+
+    KERNEL_SPINLOCK_UNLOCK(rcu_gp_lock);
+
+    /* The idle CPUs report from their idle loop, the others when they take
+     * the call.
+     */
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        if((kicked & (1U << i)) != 0 && idle_wake_cpu(i) == FALSE)
+        {
+            (void)ipi_call_async(i, &rcu_kick_calls[i]);
+        }
+    }
+
+    return target;
+}
+
+static void _rcu_kick(void* args)
+{
+    uint32_t cpu_id;
+
+    (void)args;
+
+    cpu_id = scheduler_get_current_cpu_id();
+    _rcu_report(&rcu_cpus[cpu_id], cpu_id);
+}
+
+static void _rcu_process_callbacks(rcu_cpu_t* cpu)
+{
+    rcu_head_t* head;
+    rcu_head_t* next;
+    uint32_t    completed;
+    uint32_t    current;
+
+    completed = __atomic_load_n(&rcu_gp_completed, __ATOMIC_ACQUIRE);
+    if(cpu->wait_list != NULL && RCU_GP_REACHED(completed, cpu->wait_gp))
+    {
+        /* A callback can queue new callbacks */
+        head           = cpu->wait_list;
+        cpu->wait_list = NULL;
+        while(head != NULL)
+        {
+            next = head->next;
+            head->callback(head);
+            head = next;
+        }
+    }
+
+    if(cpu->wait_list == NULL)
+    {
+        if(cpu->next_list != NULL)
+        {
+            cpu->wait_list = cpu->next_list;
+            cpu->next_list = NULL;
+            cpu->wait_gp   = _rcu_request_gp();
+        }
+    }
+    else
+    {
+        /* The grace period of the callbacks is started once the one in
+         * progress at their assignment completed
+         */
+        current = __atomic_load_n(&rcu_gp_current, __ATOMIC_ACQUIRE);
+        if(RCU_GP_REACHED(current, cpu->wait_gp) == FALSE &&
+           __atomic_load_n(&rcu_gp_completed, __ATOMIC_ACQUIRE) == current)
+        {
+            (void)_rcu_request_gp();
+        }
+    }
+}
+
+static void _rcu_sync_callback(rcu_head_t* head)
+{
+    rcu_sync_t*      sync;
+    kernel_thread_t* waiter;
+
+    sync = RCU_CONTAINER_OF(head, rcu_sync_t, head);
+
+    KERNEL_SPINLOCK_LOCK(sync->lock);
+    sync->done   = TRUE;
+    waiter       = sync->waiter;
+    sync->waiter = NULL;
+    KERNEL_SPINLOCK_UNLOCK(sync->lock);
+
+    /* The wait might be over as soon as the lock is released */
+    if(waiter != NULL)
+    {
+        (void)scheduler_wakeup_thread(waiter);
+    }
+}
+
+void rcu_init_cpu(const uint32_t cpu_id)
+{
+    rcu_cpu_t* cpu;
+
+    cpu = &rcu_cpus[cpu_id];
+
+    cpu->next_list    = NULL;
+    cpu->wait_list    = NULL;
+    cpu->wait_gp      = 0;
+    cpu->quiescent_gp = __atomic_load_n(&rcu_gp_current, __ATOMIC_ACQUIRE);
+
+    rcu_kick_calls[cpu_id].function = _rcu_kick;
+
+    __atomic_fetch_or(&rcu_online_cpus, 1U << cpu_id, __ATOMIC_SEQ_CST);
+
+    KERNEL_DEBUG(RCU_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %u added to the grace periods", cpu_id);
+}
+
+void rcu_quiescent_state(void)
+{
+    rcu_cpu_t* cpu;
+    uint32_t   cpu_id;
+
+    cpu_id = scheduler_get_current_cpu_id();
+    cpu    = &rcu_cpus[cpu_id];
+
+    _rcu_report(cpu, cpu_id);
+    _rcu_process_callbacks(cpu);
+
+    /* This quiescent state also counts for a grace period we just started */
+    _rcu_report(cpu, cpu_id);
+}
+
+bool_t rcu_cpu_has_callbacks(void)
+{
+    const rcu_cpu_t* cpu;
+
+    cpu = &rcu_cpus[scheduler_get_current_cpu_id()];
+
+    return (cpu->next_list != NULL || cpu->wait_list != NULL);
+}
+
+OS_RETURN_E rcu_call(rcu_head_t* head, void (*callback)(rcu_head_t* head))
+{
+    rcu_cpu_t* cpu;
+    uint32_t   int_state;
+
+    if(head == NULL || callback == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    head->callback = callback;
+
+    /* The callbacks lists are only used by their CPU */
+    ENTER_CRITICAL(int_state);
+
+    cpu            = &rcu_cpus[scheduler_get_current_cpu_id()];
+    head->next     = cpu->next_list;
+    cpu->next_list = head;
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+void rcu_synchronize(void)
+{
+    rcu_sync_t  sync;
+    uint32_t    int_state;
+    OS_RETURN_E err;
+
+    sync.waiter = NULL;
+    sync.done   = FALSE;
+    KERNEL_SPINLOCK_INIT(sync.lock);
+
+    (void)rcu_call(&sync.head, _rcu_sync_callback);
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(sync.lock, int_state);
+    while(sync.done == FALSE)
+    {
+        /* The wait releases the lock once the thread is waiting */
+        sync.waiter = scheduler_get_current_thread();
+        err = scheduler_wait_thread(THREAD_WAIT_TYPE_RESOURCE, &sync.lock);
+        KERNEL_SPINLOCK_LOCK(sync.lock);
+        if(err != OS_NO_ERR)
+        {
+            /* The idle threads cannot wait, they report quiescent states
+             * until the grace period elapsed
+             */
+            sync.waiter = NULL;
+            KERNEL_SPINLOCK_UNLOCK(sync.lock);
+            while(sync.done == FALSE)
+            {
+                rcu_quiescent_state();
+                _cpu_pause();
+            }
+            KERNEL_SPINLOCK_LOCK(sync.lock);
+        }
+    }
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(sync.lock, int_state);
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -7,12 +7,38 @@
  *
  * @date 16/12/2017
  *
- * @version 3.0
+ * @version 5.2
  *
  * @brief Kernel's thread scheduler.
  *
  * @details Kernel's thread scheduler. Thread creation and management functions
  * are located in this file.
+ * The scheduler is a preemptive fixed priority scheduler. Each CPU owns its
+ * run queues: one FIFO ready queue per priority level and a two levels bitmap
+ * that tracks the non empty queues. Electing the next thread costs two
+ * find-first-set operations, whatever the number of threads in the system.
+ * When a CPU has no ready thread, it steals the highest priority ready thread
+ * of the most loaded CPU before falling back to its idle thread.
+ * The per-CPU scheduler data is the CPU local storage, reached through the GS
+ * segment, and starts with the CPU current thread pointer.
+ * The scheduler is tickless: each CPU keeps its sleeping threads in a timer
+ * heap and programs a one-shot timer deadline for the earliest wakeup time,
+ * and for the end of the current time slice only when other threads of the
+ * same priority are ready. An idle CPU with no sleeping thread gets no timer
+ * interrupt. The idle threads wait in the idle driver, the CPUs that leave
+ * threads ready in their queues send a reschedule hint to an idle CPU.
+ * Waiting threads are kept out of the queues, their waker makes them ready on
+ * its own CPU.
+ * Deadline threads are scheduled earliest deadline first ahead of the fixed
+ * priority threads. Each one is bound to a CPU at admission and kept in the
+ * CPU deadline queue, sorted by absolute deadline. A deadline thread that
+ * consumed its runtime budget is throttled in the timer heap until its next
+ * period.
+ * The FPU, SSE and AVX state is switched lazily: the FPU is disabled when a
+ * thread is elected and its first FPU instruction raises a device not
+ * available exception that loads its state. The state is only saved when the
+ * thread used the FPU during its time slice. The kernel itself never uses the
+ * FPU.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -22,7 +48,26 @@
  ******************************************************************************/
 
 /* Included headers */
+#include <stdint.h>             /* Generic int types */
+#include <stddef.h>             /* Standard definitions */
+#include <string.h>             /* String manipulation */
 #include <ctrl_block.h>         /* Threads and processes control block */
+#include <cpu.h>                /* CPU management */
+#include <cpu_interrupt.h>      /* CPU interrupts settings */
+#include <interrupts.h>         /* Interrupts management */
+#include <critical.h>           /* Critical sections */
+#include <panic.h>              /* Kernel panic */
+#include <kernel_output.h>      /* Kernel output methods */
+#include <kerror.h>             /* Kernel error codes */
+#include <time_mgt.h>           /* Time management */
+#include <timer_heap.h>         /* Threads timer heap */
+#include <kpool.h>              /* Fixed-size objects pools */
+#include <kstack.h>             /* Threads stacks */
+#include <rcu.h>                /* RCU quiescent states */
+#include <ipi.h>                /* Cross-CPU calls */
+#include <idle.h>               /* CPU idle driver */
+#include <topology.h>           /* CPU nodes distances */
+#include <percpu.h>             /* Per-CPU variables */
 
 /* Configuration files */
 #include <config.h>
@@ -30,17 +75,161 @@
 /* Header file */
 #include <scheduler.h>
 
+/* Unit test header */
+#include <test_framework.h>
+
 /*******************************************************************************
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Current module's name */
+#define MODULE_NAME "SCHED"
+
+/** @brief Number of priorities tracked by one ready bitmap word. */
+#define SCHED_BITMAP_WORD_SIZE 32
+
+/** @brief Number of words in the ready bitmap. */
+#define SCHED_BITMAP_WORD_COUNT \
+    ((SCHED_PRIORITY_LEVELS + SCHED_BITMAP_WORD_SIZE - 1) / \
+     SCHED_BITMAP_WORD_SIZE)
+
+/** @brief Mask of the CPUs the scheduler manages. */
+#define SCHED_CPU_MASK_ALL ((uint32_t)((1ULL << MAX_CPU_COUNT) - 1))
+
+/** @brief Fixed point shift of the deadline threads bandwidths. */
+#define SCHED_DL_BW_SHIFT 20
+
+/** @brief Bandwidth the deadline threads can reserve on a CPU. */
+#define SCHED_DL_MAX_BW \
+    (((uint64_t)SCHED_DEADLINE_MAX_BANDWIDTH << SCHED_DL_BW_SHIFT) / 100)
+
+/** @brief Time slice given to threads sharing a priority, in nanoseconds. */
+#define SCHED_TIME_SLICE_NS (1000000000ULL / KERNEL_MAIN_TIMER_FREQ)
+
+/** @brief Init thread's name. */
+#define INIT_THREAD_NAME "init"
+
+/** @brief Idle thread's name. */
+#define IDLE_THREAD_NAME "idle"
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
 
-/* None */
+/** @brief Scheduler thread queue, threads are linked through their control
+ * block.
+ */
+typedef struct
+{
+    /** @brief Queue's head, next thread to be removed. */
+    kernel_thread_t* head;
+
+    /** @brief Queue's tail, last inserted thread. */
+    kernel_thread_t* tail;
+} sched_queue_t;
+
+/** @brief Per-CPU scheduler data, used as the CPU local storage. The first
+ * fields are accessed by the interrupt entry and exit paths and must follow
+ * the CPU_LOCAL_*_OFFSET layout defined in cpu.h.
+ */
+typedef struct sched_cpu
+{
+    /** @brief Thread running on the CPU. */
+    kernel_thread_t* volatile current_thread;
+
+    /** @brief Pointer to this structure, read through the GS segment. */
+    struct sched_cpu* self;
+
+    /** @brief Thread switched out by the last scheduling decision, the CPU
+     * might still be using its stack. Cleared by the interrupt exit path.
+     */
+    kernel_thread_t* volatile switched_out;
+
+    /** @brief Top of the current thread's kernel stack, loaded by the system
+     * call entry path.
+     */
+    uintptr_t kernel_stack;
+
+    /** @brief User stack pointer saved by the system call entry path. */
+    uintptr_t user_stack;
+
+    /** @brief CPU identifier. */
+    uint32_t cpu_id;
+
+    /** @brief CPU's idle thread, never present in the ready queues. */
+    kernel_thread_t* idle_thread;
+
+    /** @brief Zombie thread to release once the CPU left its stack. */
+    kernel_thread_t* zombie_thread;
+
+    /** @brief Sleeping threads, keyed on their wakeup time. Only accessed by
+     * its CPU.
+     */
+    timer_heap_t sleeping_threads;
+
+    /** @brief Timer deadline programmed on the CPU, 0 when disarmed. */
+    uint64_t timer_deadline;
+
+    /** @brief Thread whose extended state was last loaded in the CPU FPU
+     * registers.
+     */
+    kernel_thread_t* fpu_owner;
+
+    /** @brief Tells if the current thread enabled the FPU during its time
+     * slice.
+     */
+    bool_t fpu_active;
+
+    /** @brief Ready deadline threads, ordered by absolute deadline. */
+    sched_queue_t dl_queue;
+
+    /** @brief Bandwidth reserved by the deadline threads of the CPU,
+     * protected by the deadline lock.
+     */
+    uint32_t dl_bandwidth;
+
+    /** @brief Ready queues, one per priority level. */
+    sched_queue_t ready_queues[SCHED_PRIORITY_LEVELS];
+
+    /** @brief Ready bitmap, bit N is set when the ready queue of priority N
+     * is not empty.
+     */
+    uint32_t ready_bitmap[SCHED_BITMAP_WORD_COUNT];
+
+    /** @brief Ready bitmap summary, bit N is set when ready_bitmap[N] is not
+     * 0.
+     */
+    uint32_t ready_summary;
+
+    /** @brief Number of threads in the ready queues, read without lock by the
+     * CPUs looking for work to steal.
+     */
+    volatile uint32_t ready_count;
+
+    /** @brief Reschedule hint posted to the CPU by the other CPUs. */
+    ipi_call_t resched_call;
+
+    /** @brief Threads made ready on the CPU that their affinity sends to
+     * other CPUs, linked through their next_thread field. They are moved on
+     * the next scheduling decision of the CPU, once it left their stack.
+     */
+    kernel_thread_t* migrating;
+
+    /** @brief Lock protecting the ready queues. */
+    kernel_spinlock_t lock;
+} __attribute__((aligned(CPU_CACHE_LINE_SIZE))) sched_cpu_t;
+
+/* The interrupt entry and exit paths access the CPU local storage fields */
+_Static_assert(offsetof(sched_cpu_t, current_thread) ==
+               CPU_LOCAL_CURRENT_THREAD_OFFSET &&
+               offsetof(sched_cpu_t, self) == CPU_LOCAL_SELF_OFFSET &&
+               offsetof(sched_cpu_t, switched_out) ==
+               CPU_LOCAL_SWITCHED_OUT_OFFSET &&
+               offsetof(sched_cpu_t, kernel_stack) ==
+               CPU_LOCAL_KERNEL_STACK_OFFSET &&
+               offsetof(sched_cpu_t, user_stack) ==
+               CPU_LOCAL_USER_STACK_OFFSET,
+               "Invalid CPU local storage layout");
 
 /*******************************************************************************
  * MACROS
@@ -65,39 +254,2395 @@
     }                                                       \
 }
 
+/**
+ * @brief Returns the scheduler data of a CPU.
+ *
+ * @param[in] CPU_ID The identifier of the CPU.
+ */
+#define SCHED_CPU(CPU_ID) PERCPU_PTR(sched_cpu, CPU_ID)
+
 /*******************************************************************************
  * GLOBAL VARIABLES
  ******************************************************************************/
 
 /************************* Imported global variables **************************/
-/* None */
+/** @brief Kernel stacks region base address, defined in the linker file. */
+extern int8_t _KERNEL_STACKS_BASE;
+
+/** @brief Kernel stacks region size, defined in the linker file. */
+extern int8_t _KERNEL_STACKS_SIZE;
 
 /************************* Exported global variables **************************/
+/* None */
 
-/** @brief Pointer to the currently kernel thread */
-kernel_thread_t* current_thread = NULL;
+/************************** Static global variables ***************************/
+/** @brief Per-CPU scheduler data, at the base of the CPU local storage. */
+static PERCPU_DEFINE_FIRST(sched_cpu_t, sched_cpu);
 
-kernel_thread_t dummy_thread;
+/** @brief Boot threads control blocks, the boot execution context of each CPU
+ * runs in its boot thread. The boot thread of the BSP is the init thread, the
+ * boot threads of the other CPUs become their idle thread.
+ */
+static kernel_thread_t boot_threads[MAX_CPU_COUNT];
 
-/************************** Static global variables ***************************/
-/* None */
+/** @brief Threads control blocks storage. */
+static KPOOL_STORAGE(thread_storage, kernel_thread_t, KERNEL_MAX_THREAD_COUNT);
+
+/**
+ * @brief Threads control blocks pool. The pool is too small to keep free
+ * control blocks in the CPUs caches.
+ */
+static kpool_t thread_pool;
+
+/** @brief Last thread identifier given. */
+static int32_t last_given_tid;
+
+/** @brief Tells if the main timer drives the sleeps and time slices. */
+static bool_t sched_timer_enabled;
+
+/** @brief CPUs taking part in the threads scheduling, one bit per CPU. The
+ * CPUs removed from the scheduling are not part of it.
+ */
+static volatile uint32_t sched_cpu_mask = 0;
+
+/** @brief Isolated CPUs, one bit per CPU. */
+static volatile uint32_t sched_isolated_cpus =
+    SCHED_ISOLATED_CPU_MASK & SCHED_CPU_MASK_ALL & ~1U;
+
+/** @brief Lock protecting the deadline bandwidth reservations. */
+static kernel_spinlock_t sched_dl_lock = KERNEL_SPINLOCK_INIT_VALUE;
 
 /*******************************************************************************
  * STATIC FUNCTIONS DECLARATIONS
  ******************************************************************************/
 
+/**
+ * @brief Returns the index of the least significant bit set in a word.
+ *
+ * @details Returns the index of the least significant bit set in a word. The
+ * word must not be 0.
+ *
+ * @param[in] word The word to scan.
+ *
+ * @return The index of the least significant bit set in the word.
+ */
+inline static uint32_t _sched_find_first_set(const uint32_t word);
+
+/**
+ * @brief Returns the scheduler data of the current CPU.
+ *
+ * @details Returns the scheduler data of the current CPU. This function must
+ * be called with interrupts disabled.
+ *
+ * @return The scheduler data of the current CPU.
+ */
+inline static sched_cpu_t* _sched_get_local_cpu(void);
+
+/**
+ * @brief Puts a thread at the end of the ready queue of its priority.
+ *
+ * @details Puts a thread at the end of the ready queue of its priority on a
+ * CPU and updates the CPU ready bitmap. A deadline thread is put in the CPU
+ * deadline queue, after the threads whose deadline is not later. This
+ * function must be called with the CPU lock held.
+ *
+ * @param[in, out] cpu The CPU to put the thread on.
+ * @param[in, out] thread The thread to put in the ready queue.
+ */
+static void _sched_enqueue_ready(sched_cpu_t* cpu, kernel_thread_t* thread);
+
+/**
+ * @brief Removes the ready thread with the highest priority.
+ *
+ * @details Removes the ready thread with the highest priority from the ready
+ * queues of a CPU and updates the CPU ready bitmap. The deadline threads are
+ * removed first, earliest deadline first. This function must be called with
+ * the CPU lock held.
+ *
+ * @param[in, out] cpu The CPU to get the thread from.
+ *
+ * @return The next thread to run, NULL if no thread is ready.
+ */
+static kernel_thread_t* _sched_dequeue_ready(sched_cpu_t* cpu);
+
+/**
+ * @brief Removes the highest priority ready thread another CPU can run.
+ *
+ * @details Removes the ready thread with the highest priority of a victim CPU
+ * whose affinity allows it to run on a thief CPU. The thread the victim CPU
+ * is switching out is never returned as the victim might still be running on
+ * its stack, the deadline threads are never stolen. This function must be
+ * called with the victim CPU lock held.
+ *
+ * @param[in, out] victim The CPU to get the thread from.
+ * @param[in] cpu The CPU that runs the thread.
+ *
+ * @return The removed thread, NULL if no thread could be removed.
+ */
+static kernel_thread_t* _sched_dequeue_stealable(sched_cpu_t* victim,
+                                                 const sched_cpu_t* cpu);
+
+/**
+ * @brief Removes a thread from the ready queue of its priority.
+ *
+ * @details Removes a thread from the ready queue of its priority on a CPU and
+ * updates the CPU ready bitmap. The thread must be in the CPU ready queues.
+ * This function must be called with the CPU lock held.
+ *
+ * @param[in, out] cpu The CPU the thread is ready on.
+ * @param[in, out] thread The thread to remove.
+ */
+static void _sched_unlink_ready(sched_cpu_t* cpu, kernel_thread_t* thread);
+
+/**
+ * @brief Tells if a thread made ready preempts the running thread.
+ *
+ * @details Tells if a thread made ready preempts the running thread: the
+ * deadline threads preempt the fixed priority threads and the deadline
+ * threads with a later deadline.
+ *
+ * @param[in] thread The thread made ready.
+ * @param[in] current The running thread.
+ *
+ * @return TRUE if the thread preempts the running thread, FALSE otherwise.
+ */
+inline static bool_t _sched_preempts(const kernel_thread_t* thread,
+                                     const kernel_thread_t* current);
+
+/**
+ * @brief Consumes the budget of a deadline thread leaving the CPU.
+ *
+ * @details Removes the time the deadline thread was elected for from its
+ * budget. A running thread that used its budget is throttled: it is put to
+ * sleep until its next release, or replenished at once if the release is
+ * due.
+ *
+ * @param[in, out] thread The deadline thread leaving the CPU.
+ * @param[in] now The current uptime in nanoseconds.
+ */
+static void _sched_dl_account(kernel_thread_t* thread, const uint64_t now);
+
+/**
+ * @brief Releases the next instance of a deadline thread.
+ *
+ * @details Gives a deadline thread its runtime and moves its deadline by one
+ * period. An instance whose deadline already passed is released now.
+ *
+ * @param[in, out] thread The deadline thread.
+ * @param[in] now The current uptime in nanoseconds.
+ */
+static void _sched_dl_replenish(kernel_thread_t* thread, const uint64_t now);
+
+/**
+ * @brief Updates the budget of a deadline thread made ready.
+ *
+ * @details Replenishes a throttled deadline thread. Otherwise following the
+ * constant bandwidth server rule, a thread whose remaining budget, run
+ * before its deadline, would exceed its bandwidth starts a new instance with
+ * a full budget and a new deadline.
+ *
+ * @param[in, out] thread The deadline thread made ready.
+ * @param[in] now The current uptime in nanoseconds.
+ */
+static void _sched_dl_wakeup(kernel_thread_t* thread, const uint64_t now);
+
+/**
+ * @brief Releases the bandwidth of a deadline thread.
+ *
+ * @details Releases the bandwidth reserved by a deadline thread and moves it
+ * back to the fixed priority scheduling class.
+ *
+ * @param[in, out] thread The deadline thread.
+ */
+static void _sched_dl_release(kernel_thread_t* thread);
+
+/**
+ * @brief Preempts the current thread of the CPU on the next timer interrupt.
+ *
+ * @details Programs the CPU timer to fire immediately, the scheduling handler
+ * then elects the highest priority ready thread. Does nothing when the main
+ * timer is not available. This function must be called on the CPU to preempt,
+ * with interrupts disabled.
+ *
+ * @param[in, out] cpu The current CPU.
+ */
+static void _sched_request_preemption(sched_cpu_t* cpu);
+
+/**
+ * @brief Reschedule hint cross-CPU call, preempts the current CPU.
+ *
+ * @param[in] args Unused.
+ */
+static void _sched_resched_call(void* args);
+
+/**
+ * @brief Sends a reschedule hint to a CPU.
+ *
+ * @details Sends a reschedule hint to a CPU. A CPU waiting on its idle driver
+ * wake flag is woken by a write to the flag, the other CPUs are sent a
+ * cross-CPU call.
+ *
+ * @param[in, out] cpu The target CPU.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - Other error codes returned by ipi_call_async.
+ */
+static OS_RETURN_E _sched_send_resched(sched_cpu_t* cpu);
+
+/**
+ * @brief Sends a reschedule hint to an idle CPU.
+ *
+ * @details Looks for another CPU running its idle thread without ready
+ * threads and makes it reschedule, the CPU then steals the threads made ready
+ * on the busy CPUs instead of waiting for its next timer deadline. This
+ * function must be called with interrupts disabled.
+ *
+ * @param[in] cpu The current CPU.
+ */
+static void _sched_kick_idle_cpu(const sched_cpu_t* cpu);
+
+/**
+ * @brief Returns the CPUs a thread can run on.
+ *
+ * @details Returns the CPUs of the thread affinity that take part in the
+ * scheduling. The isolated CPUs are left out unless the thread cannot run on
+ * any other CPU. When none of its CPUs is started, the thread runs on the
+ * CPUs that are not isolated. A deadline thread runs on the CPU its
+ * bandwidth is reserved on.
+ *
+ * @param[in] thread The thread.
+ *
+ * @return The CPUs the thread can run on, one bit per CPU, never 0.
+ */
+inline static uint32_t _sched_get_thread_cpus(const kernel_thread_t* thread);
+
+/**
+ * @brief Returns the CPU a thread made ready on a CPU is put on.
+ *
+ * @details Returns the CPU itself when the thread can run on it, the least
+ * loaded CPU the thread can run on otherwise.
+ *
+ * @param[in] cpu The CPU the thread is made ready on.
+ * @param[in] thread The thread made ready.
+ *
+ * @return The CPU whose ready queues receive the thread.
+ */
+static sched_cpu_t* _sched_get_enqueue_cpu(sched_cpu_t* cpu,
+                                           const kernel_thread_t* thread);
+
+/**
+ * @brief Moves the migrating threads of the current CPU to their CPUs.
+ *
+ * @details Puts the threads the affinity sends away from the current CPU in
+ * the ready queues of the CPUs they can run on. This function must be called
+ * on the CPU that owns the migrating threads, with interrupts disabled and
+ * without holding any CPU lock.
+ *
+ * @param[in, out] cpu The current CPU.
+ */
+static void _sched_flush_migrating(sched_cpu_t* cpu);
+
+/**
+ * @brief Locks all the started CPUs.
+ *
+ * @details Locks all the started CPUs in the order of their identifiers. This
+ * function must be called with interrupts disabled.
+ *
+ * @return The locked CPUs, one bit per CPU.
+ */
+static uint32_t _sched_lock_all_cpus(void);
+
+/**
+ * @brief Unlocks the CPUs locked by _sched_lock_all_cpus.
+ *
+ * @param[in] locked_cpus The locked CPUs, one bit per CPU.
+ */
+static void _sched_unlock_all_cpus(const uint32_t locked_cpus);
+
+/**
+ * @brief Moves the ready threads of a CPU that cannot run on it anymore.
+ *
+ * @details Moves the ready threads of a CPU whose affinity does not allow
+ * them to run on it to the CPUs they can run on. The thread the CPU is
+ * switching out is left in place and migrates on its next switch. This
+ * function must be called with the locked CPUs locks held.
+ *
+ * @param[in, out] cpu The CPU to move the threads of.
+ * @param[in] locked_cpus The locked CPUs, one bit per CPU.
+ *
+ * @return The CPUs that received threads, one bit per CPU.
+ */
+static uint32_t _sched_move_ready(sched_cpu_t* cpu,
+                                  const uint32_t locked_cpus);
+
+/**
+ * @brief Makes CPUs reschedule.
+ *
+ * @details Preempts the current CPU or sends a reschedule hint to the other
+ * CPUs of a mask. This function must be called with interrupts disabled.
+ *
+ * @param[in] cpu_mask The CPUs to reschedule, one bit per CPU.
+ */
+static void _sched_resched_cpus(const uint32_t cpu_mask);
+
+/**
+ * @brief Steals a ready thread from the most loaded CPU.
+ *
+ * @details Steals the highest priority ready thread of the CPU that has the
+ * most ready threads. The thread the victim CPU is switching out is never
+ * stolen as the victim might still be running on its stack. The isolated
+ * CPUs neither steal nor are stolen from. This function must be called with
+ * interrupts disabled and without holding any CPU lock.
+ *
+ * @param[in] cpu The CPU looking for work.
+ *
+ * @return The stolen thread, NULL if no thread could be stolen.
+ */
+static kernel_thread_t* _sched_steal(const sched_cpu_t* cpu);
+
+/**
+ * @brief Wakes up the sleeping threads that reached their wakeup time.
+ *
+ * @details Moves the sleeping threads of a CPU that reached their wakeup time
+ * to the CPU ready queues, or to its migrating threads when they cannot run
+ * on the CPU anymore. This function must be called with the CPU lock held, on
+ * the CPU that owns the sleeping threads.
+ *
+ * @param[in, out] cpu The CPU to wake the threads of.
+ * @param[in] now The current uptime in nanoseconds.
+ */
+static void _sched_wakeup_threads(sched_cpu_t* cpu, const uint64_t now);
+
+/**
+ * @brief Programs the CPU timer for the next scheduling event.
+ *
+ * @details Programs the CPU timer deadline to the earliest wakeup time of the
+ * CPU sleeping threads. When other threads of the same priority as the
+ * elected thread are ready, the deadline is bounded by the end of the time
+ * slice. An elected deadline thread bounds it by the end of its budget.
+ * Otherwise no periodic tick is programmed and the timer is disarmed when no
+ * thread sleeps.
+ *
+ * @param[in, out] cpu The CPU to program the timer of.
+ * @param[in] next_thread The thread elected on the CPU.
+ */
+static void _sched_update_timer(sched_cpu_t* cpu,
+                                const kernel_thread_t* next_thread);
+
+/**
+ * @brief Scheduler's timer deadline handler.
+ *
+ * @details Scheduler's timer deadline handler. The CPU timer is disarmed once
+ * it fired, the scheduling handler wakes up the due threads, elects the next
+ * thread to run and programs the next deadline.
+ *
+ * @param[in] curr_thread The interrupted thread.
+ */
+static void _sched_timer_handler(kernel_thread_t* curr_thread);
+
+/**
+ * @brief Updates the execution statistics of the switched threads.
+ *
+ * @param[in, out] curr_thread The thread leaving the CPU.
+ * @param[in, out] next_thread The thread elected on the CPU.
+ * @param[in] voluntary Tells if the current thread gave the CPU.
+ */
+inline static void _sched_account_switch(kernel_thread_t* curr_thread,
+                                         kernel_thread_t* next_thread,
+                                         const bool_t voluntary);
+
+/**
+ * @brief Updates the wait statistics of a woken up thread.
+ *
+ * @param[in, out] thread The thread that is not waiting anymore.
+ */
+inline static void _sched_account_wait(kernel_thread_t* thread);
+
+/**
+ * @brief Puts a thread control block back in the threads pool.
+ *
+ * @details Puts a thread control block and its stack back in their pools. The
+ * thread stack must not be in use anymore. Called once a RCU grace period
+ * elapsed after the thread became a zombie.
+ *
+ * @param[in] head The RCU node of the thread to release.
+ */
+static void _sched_release_thread(rcu_head_t* head);
+
+/**
+ * @brief Device not available exception handler.
+ *
+ * @details Device not available exception handler, raised by the first FPU
+ * instruction of a thread's time slice. The FPU is enabled and the thread's
+ * extended state is loaded, unless the CPU registers still hold it.
+ *
+ * @param[in] curr_thread The thread that used the FPU.
+ */
+static void _sched_fpu_handler(kernel_thread_t* curr_thread);
+
+/**
+ * @brief Elects the next thread to run on the CPU.
+ *
+ * @details Puts the current thread back in the CPU ready queue, in the CPU
+ * sleeping threads if it sleeps, or marks it for release if it is a zombie.
+ * The sleeping threads that reached their wakeup time are made ready and the
+ * next thread to run is elected. The context switch happens on the interrupt
+ * return path that restores the context of the CPU current thread.
+ *
+ * @param[in] curr_thread The interrupted thread.
+ * @param[in] preempted Tells if the scheduler timer interrupted the thread,
+ * FALSE if the thread called the scheduler.
+ */
+static void _sched_switch(kernel_thread_t* curr_thread, const bool_t preempted);
+
+/**
+ * @brief Scheduler's software interrupt handler.
+ *
+ * @details Scheduler's software interrupt handler, raised by the threads that
+ * give the CPU.
+ *
+ * @param[in] curr_thread The interrupted thread.
+ */
+static void _sched_switch_handler(kernel_thread_t* curr_thread);
+
+/**
+ * @brief Thread's entry point wrapper.
+ *
+ * @details Thread's entry point wrapper. Calls the thread's routine, saves its
+ * return value and terminates the thread.
+ */
+static void _sched_thread_entry(void);
+
+/**
+ * @brief Idle thread's routine.
+ *
+ * @details Idle thread's routine. Spins until a CPU has a ready thread and
+ * calls the scheduler to run it. When the CPU is the only online CPU, it halts
+ * until the next interrupt instead of spinning.
+ *
+ * @param[in] args Unused.
+ *
+ * @return This function never returns.
+ */
+static void* _sched_idle_routine(void* args);
+
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
-void scheduler_dummy_init(void);
-void scheduler_dummy_init(void)
+
+inline static uint32_t _sched_find_first_set(const uint32_t word)
 {
-    current_thread = &dummy_thread;
+    return (uint32_t)__builtin_ctz(word);
 }
 
-kernel_thread_t* scheduler_get_current_thread(void)
+inline static sched_cpu_t* _sched_get_local_cpu(void)
+{
+    return (sched_cpu_t*)_cpu_get_local_storage();
+}
+
+static void _sched_enqueue_ready(sched_cpu_t* cpu, kernel_thread_t* thread)
+{
+    sched_queue_t*   queue;
+    kernel_thread_t* prev;
+    uint32_t         word;
+
+    if(thread->sched_class == THREAD_SCHED_DEADLINE)
+    {
+        /* The new deadlines are usually the latest, look from the tail */
+        queue = &cpu->dl_queue;
+        prev  = queue->tail;
+        while(prev != NULL && prev->dl.deadline > thread->dl.deadline)
+        {
+            prev = prev->prev_thread;
+        }
+    }
+    else
+    {
+        queue = &cpu->ready_queues[thread->priority];
+        prev  = queue->tail;
+
+        /* Update the bitmaps */
+        word = thread->priority / SCHED_BITMAP_WORD_SIZE;
+        cpu->ready_bitmap[word] |=
+            (1U << (thread->priority % SCHED_BITMAP_WORD_SIZE));
+        cpu->ready_summary |= (1U << word);
+    }
+
+    thread->prev_thread = prev;
+    if(prev != NULL)
+    {
+        thread->next_thread = prev->next_thread;
+        prev->next_thread   = thread;
+    }
+    else
+    {
+        thread->next_thread = queue->head;
+        queue->head         = thread;
+    }
+    if(thread->next_thread != NULL)
+    {
+        thread->next_thread->prev_thread = thread;
+    }
+    else
+    {
+        queue->tail = thread;
+    }
+
+    thread->state        = THREAD_STATE_READY;
+    thread->ready_cpu_id = cpu->cpu_id;
+
+    ++cpu->ready_count;
+}
+
+static kernel_thread_t* _sched_dequeue_ready(sched_cpu_t* cpu)
+{
+    kernel_thread_t* thread;
+    uint32_t         word;
+    uint32_t         priority;
+
+    thread = cpu->dl_queue.head;
+    if(thread == NULL)
+    {
+        if(cpu->ready_summary == 0)
+        {
+            return NULL;
+        }
+
+        word     = _sched_find_first_set(cpu->ready_summary);
+        priority = word * SCHED_BITMAP_WORD_SIZE +
+                   _sched_find_first_set(cpu->ready_bitmap[word]);
+        thread   = cpu->ready_queues[priority].head;
+    }
+
+    _sched_unlink_ready(cpu, thread);
+
+    return thread;
+}
+
+static kernel_thread_t* _sched_dequeue_stealable(sched_cpu_t* victim,
+                                                 const sched_cpu_t* cpu)
 {
-    return current_thread;
+    kernel_thread_t* thread;
+    uint32_t         word;
+    uint32_t         bits;
+    uint32_t         priority;
+
+    /* Walk the ready queues by decreasing priority */
+    for(word = 0; word < SCHED_BITMAP_WORD_COUNT; ++word)
+    {
+        bits = victim->ready_bitmap[word];
+        while(bits != 0)
+        {
+            priority = word * SCHED_BITMAP_WORD_SIZE +
+                       _sched_find_first_set(bits);
+            bits &= bits - 1;
+
+            thread = victim->ready_queues[priority].head;
+            while(thread != NULL)
+            {
+                if(thread != victim->switched_out &&
+                   (_sched_get_thread_cpus(thread) &
+                    (1U << cpu->cpu_id)) != 0)
+                {
+                    _sched_unlink_ready(victim, thread);
+                    return thread;
+                }
+                thread = thread->next_thread;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+static void _sched_unlink_ready(sched_cpu_t* cpu, kernel_thread_t* thread)
+{
+    sched_queue_t* queue;
+    uint32_t       word;
+
+    if(thread->sched_class == THREAD_SCHED_DEADLINE)
+    {
+        queue = &cpu->dl_queue;
+    }
+    else
+    {
+        queue = &cpu->ready_queues[thread->priority];
+    }
+
+    if(thread->prev_thread != NULL)
+    {
+        thread->prev_thread->next_thread = thread->next_thread;
+    }
+    else
+    {
+        queue->head = thread->next_thread;
+    }
+    if(thread->next_thread != NULL)
+    {
+        thread->next_thread->prev_thread = thread->prev_thread;
+    }
+    else
+    {
+        queue->tail = thread->prev_thread;
+    }
+
+    if(queue->head == NULL && queue != &cpu->dl_queue)
+    {
+        /* The queue is now empty, update the bitmaps */
+        word = thread->priority / SCHED_BITMAP_WORD_SIZE;
+        cpu->ready_bitmap[word] &=
+            ~(1U << (thread->priority % SCHED_BITMAP_WORD_SIZE));
+        if(cpu->ready_bitmap[word] == 0)
+        {
+            cpu->ready_summary &= ~(1U << word);
+        }
+    }
+
+    --cpu->ready_count;
+
+    thread->next_thread = NULL;
+    thread->prev_thread = NULL;
+}
+
+inline static bool_t _sched_preempts(const kernel_thread_t* thread,
+                                     const kernel_thread_t* current)
+{
+    if(thread->sched_class == THREAD_SCHED_DEADLINE)
+    {
+        return (current->sched_class != THREAD_SCHED_DEADLINE ||
+                thread->dl.deadline < current->dl.deadline);
+    }
+
+    return (current->sched_class != THREAD_SCHED_DEADLINE &&
+            thread->priority < current->priority);
+}
+
+static void _sched_dl_account(kernel_thread_t* thread, const uint64_t now)
+{
+    thread_deadline_t* dl;
+    uint64_t           used;
+
+    dl   = &thread->dl;
+    used = now - dl->elected_time;
+    if(used < dl->remaining)
+    {
+        dl->remaining -= used;
+        return;
+    }
+    dl->remaining = 0;
+
+    if(thread->state != THREAD_STATE_RUNNING)
+    {
+        return;
+    }
+
+    /* The thread waits for its next release in the CPU timer heap */
+    thread->wakeup_time = dl->deadline - dl->rel_deadline + dl->period;
+    if(thread->wakeup_time <= now)
+    {
+        _sched_dl_replenish(thread, now);
+    }
+    else
+    {
+        dl->throttled = TRUE;
+        thread->state = THREAD_STATE_SLEEPING;
+
+        KERNEL_DEBUG(SCHED_SWITCH_DEBUG_ENABLED, MODULE_NAME,
+                     "Thread %d throttled", thread->tid);
+    }
+}
+
+static void _sched_dl_replenish(kernel_thread_t* thread, const uint64_t now)
+{
+    thread_deadline_t* dl;
+
+    dl = &thread->dl;
+
+    dl->throttled  = FALSE;
+    dl->remaining  = dl->runtime;
+    dl->deadline  += dl->period;
+
+    /* A thread that fell behind its releases starts over */
+    if(dl->deadline - dl->rel_deadline < now)
+    {
+        dl->deadline = now + dl->rel_deadline;
+    }
+}
+
+static void _sched_dl_wakeup(kernel_thread_t* thread, const uint64_t now)
+{
+    thread_deadline_t* dl;
+
+    dl = &thread->dl;
+
+    /* The periods bound keeps the products within 64 bits */
+    if(dl->throttled == TRUE)
+    {
+        _sched_dl_replenish(thread, now);
+    }
+    else if(dl->deadline <= now ||
+            dl->remaining * dl->rel_deadline >
+            (dl->deadline - now) * dl->runtime)
+    {
+        dl->deadline  = now + dl->rel_deadline;
+        dl->remaining = dl->runtime;
+    }
+}
+
+static void _sched_dl_release(kernel_thread_t* thread)
+{
+    KERNEL_SPINLOCK_LOCK(sched_dl_lock);
+    SCHED_CPU(thread->dl.cpu_id)->dl_bandwidth -= thread->dl.bandwidth;
+    KERNEL_SPINLOCK_UNLOCK(sched_dl_lock);
+
+    thread->dl.bandwidth = 0;
+    thread->sched_class  = THREAD_SCHED_FIXED;
+}
+
+static void _sched_request_preemption(sched_cpu_t* cpu)
+{
+    uint64_t now;
+
+    if(sched_timer_enabled == TRUE)
+    {
+        /* A deadline of 0 would disarm the timer */
+        now                 = time_get_current_uptime_nano() + 1;
+        cpu->timer_deadline = now;
+        time_set_deadline(TIME_DEADLINE_SCHEDULER, now);
+    }
+}
+
+static void _sched_resched_call(void* args)
+{
+    sched_cpu_t* cpu;
+
+    (void)args;
+
+    cpu = _sched_get_local_cpu();
+    if((sched_cpu_mask & (1U << cpu->cpu_id)) != 0)
+    {
+        _sched_request_preemption(cpu);
+    }
+}
+
+static OS_RETURN_E _sched_send_resched(sched_cpu_t* cpu)
+{
+    if(idle_wake_cpu(cpu->cpu_id) == TRUE)
+    {
+        return OS_NO_ERR;
+    }
+
+    return ipi_call_async(cpu->cpu_id, &cpu->resched_call);
+}
+
+static void _sched_kick_idle_cpu(const sched_cpu_t* cpu)
+{
+    sched_cpu_t* idle_cpu;
+    uint32_t     i;
+
+    /* The idle CPUs of the same node are kicked first, then the others. The
+     * isolated CPUs do not steal.
+     */
+    for(i = 0; i < MAX_CPU_COUNT * 2; ++i)
+    {
+        idle_cpu = SCHED_CPU(i % MAX_CPU_COUNT);
+        if((i < MAX_CPU_COUNT &&
+            topology_get_cpu_node(idle_cpu->cpu_id) !=
+            topology_get_cpu_node(cpu->cpu_id)) ||
+           idle_cpu == cpu ||
+           (sched_isolated_cpus & (1U << idle_cpu->cpu_id)) != 0 ||
+           idle_cpu->idle_thread == NULL ||
+           idle_cpu->current_thread != idle_cpu->idle_thread ||
+           idle_cpu->ready_count != 0)
+        {
+            continue;
+        }
+
+        /* A hint already queued on the CPU is enough */
+        if(_sched_send_resched(idle_cpu) != OS_ERR_UNAUTHORIZED_ACTION)
+        {
+            return;
+        }
+    }
+}
+
+inline static uint32_t _sched_get_thread_cpus(const kernel_thread_t* thread)
+{
+    uint32_t cpus;
+    uint32_t mask;
+
+    cpus = __atomic_load_n(&sched_cpu_mask, __ATOMIC_RELAXED);
+
+    if(thread->sched_class == THREAD_SCHED_DEADLINE &&
+       (cpus & (1U << thread->dl.cpu_id)) != 0)
+    {
+        return (1U << thread->dl.cpu_id);
+    }
+
+    mask = thread->cpu_affinity & cpus;
+
+    /* The isolated CPUs only run the threads that cannot run elsewhere, the
+     * BSP is never isolated.
+     */
+    if((mask & ~sched_isolated_cpus) != 0)
+    {
+        mask &= ~sched_isolated_cpus;
+    }
+    else if(mask == 0)
+    {
+        mask = cpus & ~sched_isolated_cpus;
+    }
+
+    return mask;
+}
+
+static sched_cpu_t* _sched_get_enqueue_cpu(sched_cpu_t* cpu,
+                                           const kernel_thread_t* thread)
+{
+    sched_cpu_t* target;
+    uint32_t     mask;
+    uint32_t     i;
+
+    mask = _sched_get_thread_cpus(thread);
+    if((mask & (1U << cpu->cpu_id)) != 0)
+    {
+        return cpu;
+    }
+
+    /* The counts are only hints */
+    target = NULL;
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        if((mask & (1U << i)) != 0 &&
+           (target == NULL ||
+            SCHED_CPU(i)->ready_count < target->ready_count))
+        {
+            target = SCHED_CPU(i);
+        }
+    }
+
+    return target;
+}
+
+static void _sched_flush_migrating(sched_cpu_t* cpu)
+{
+    kernel_thread_t* thread;
+    sched_cpu_t*     target;
+
+    while(cpu->migrating != NULL)
+    {
+        thread         = cpu->migrating;
+        cpu->migrating = thread->next_thread;
+
+        target = _sched_get_enqueue_cpu(cpu, thread);
+        KERNEL_SPINLOCK_LOCK(target->lock);
+        _sched_enqueue_ready(target, thread);
+        KERNEL_SPINLOCK_UNLOCK(target->lock);
+
+        /* The target time slices the threads of the same priority */
+        if(target != cpu &&
+           (_sched_preempts(thread, target->current_thread) == TRUE ||
+            thread->priority == target->current_thread->priority))
+        {
+            (void)_sched_send_resched(target);
+        }
+
+        KERNEL_DEBUG(SCHED_SWITCH_DEBUG_ENABLED, MODULE_NAME,
+                     "CPU %d moved thread %d to CPU %d",
+                     cpu->cpu_id, thread->tid, target->cpu_id);
+    }
+}
+
+static uint32_t _sched_lock_all_cpus(void)
+{
+    uint32_t locked_cpus;
+    uint32_t i;
+
+    locked_cpus = 0;
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        if(SCHED_CPU(i)->self != NULL)
+        {
+            KERNEL_SPINLOCK_LOCK(SCHED_CPU(i)->lock);
+            locked_cpus |= (1U << i);
+        }
+    }
+
+    return locked_cpus;
+}
+
+static void _sched_unlock_all_cpus(const uint32_t locked_cpus)
+{
+    uint32_t i;
+
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        if((locked_cpus & (1U << i)) != 0)
+        {
+            KERNEL_SPINLOCK_UNLOCK(SCHED_CPU(i)->lock);
+        }
+    }
+}
+
+static uint32_t _sched_move_ready(sched_cpu_t* cpu,
+                                  const uint32_t locked_cpus)
+{
+    kernel_thread_t* thread;
+    kernel_thread_t* next;
+    sched_cpu_t*     target;
+    uint32_t         priority;
+    uint32_t         targets;
+
+    targets = 0;
+    for(priority = 0; priority < SCHED_PRIORITY_LEVELS; ++priority)
+    {
+        thread = cpu->ready_queues[priority].head;
+        while(thread != NULL)
+        {
+            next = thread->next_thread;
+
+            /* A CPU started after the locks were taken is not considered */
+            target = _sched_get_enqueue_cpu(cpu, thread);
+            if(target != cpu &&
+               thread != cpu->switched_out &&
+               (locked_cpus & (1U << target->cpu_id)) != 0)
+            {
+                _sched_unlink_ready(cpu, thread);
+                _sched_enqueue_ready(target, thread);
+                targets |= (1U << target->cpu_id);
+            }
+
+            thread = next;
+        }
+    }
+
+    return targets;
+}
+
+static void _sched_resched_cpus(const uint32_t cpu_mask)
+{
+    sched_cpu_t* cpu;
+    uint32_t     i;
+
+    cpu = _sched_get_local_cpu();
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        if((cpu_mask & (1U << i)) == 0)
+        {
+            continue;
+        }
+        if(i == cpu->cpu_id)
+        {
+            _sched_request_preemption(cpu);
+        }
+        else
+        {
+            (void)_sched_send_resched(SCHED_CPU(i));
+        }
+    }
+}
+
+static kernel_thread_t* _sched_steal(const sched_cpu_t* cpu)
+{
+    sched_cpu_t*     victim;
+    kernel_thread_t* thread;
+    uint32_t         max_count;
+    uint32_t         min_distance;
+    uint32_t         distance;
+    uint32_t         i;
+
+    if((sched_isolated_cpus & (1U << cpu->cpu_id)) != 0)
+    {
+        return NULL;
+    }
+
+    /* Look for the most loaded CPU of the closest node that has ready
+     * threads, the threads stay near their memory. The counts are only hints.
+     */
+    victim       = NULL;
+    max_count    = 0;
+    min_distance = 0;
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        if(SCHED_CPU(i) == cpu ||
+           SCHED_CPU(i)->self == NULL ||
+           SCHED_CPU(i)->ready_count == 0 ||
+           (sched_isolated_cpus & (1U << i)) != 0)
+        {
+            continue;
+        }
+
+        distance = topology_get_cpu_distance(cpu->cpu_id, i);
+        if(victim == NULL || distance < min_distance ||
+           (distance == min_distance &&
+            SCHED_CPU(i)->ready_count > max_count))
+        {
+            min_distance = distance;
+            max_count    = SCHED_CPU(i)->ready_count;
+            victim       = SCHED_CPU(i);
+        }
+    }
+
+    if(victim == NULL)
+    {
+        return NULL;
+    }
+
+    KERNEL_SPINLOCK_LOCK(victim->lock);
+    thread = _sched_dequeue_stealable(victim, cpu);
+    KERNEL_SPINLOCK_UNLOCK(victim->lock);
+
+    if(thread != NULL)
+    {
+        KERNEL_TRACE_EVENT(EVENT_KERNEL_SCHED_STEAL, 3,
+                           cpu->cpu_id, victim->cpu_id, thread->tid);
+
+        KERNEL_DEBUG(SCHED_SWITCH_DEBUG_ENABLED, MODULE_NAME,
+                     "CPU %d stole thread %d from CPU %d",
+                     cpu->cpu_id, thread->tid, victim->cpu_id);
+    }
+
+    return thread;
+}
+
+static void _sched_wakeup_threads(sched_cpu_t* cpu, const uint64_t now)
+{
+    kernel_thread_t* thread;
+
+    thread = timer_heap_pop_expired(&cpu->sleeping_threads, now);
+    while(thread != NULL)
+    {
+        if(thread->sched_class == THREAD_SCHED_DEADLINE)
+        {
+            _sched_dl_wakeup(thread, now);
+        }
+
+        if((_sched_get_thread_cpus(thread) & (1U << cpu->cpu_id)) != 0)
+        {
+            _sched_enqueue_ready(cpu, thread);
+        }
+        else
+        {
+            thread->state       = THREAD_STATE_READY;
+            thread->next_thread = cpu->migrating;
+            cpu->migrating      = thread;
+        }
+
+        KERNEL_TRACE_EVENT(EVENT_KERNEL_SCHED_WAKEUP, 2,
+                           cpu->cpu_id, thread->tid);
+
+        KERNEL_DEBUG(SCHED_SWITCH_DEBUG_ENABLED, MODULE_NAME,
+                     "CPU %d woke up thread %d", cpu->cpu_id, thread->tid);
+
+        thread = timer_heap_pop_expired(&cpu->sleeping_threads, now);
+    }
+}
+
+static void _sched_update_timer(sched_cpu_t* cpu,
+                                const kernel_thread_t* next_thread)
+{
+    kernel_thread_t* sleeper;
+    uint64_t         deadline;
+    uint64_t         slice_end;
+    uint64_t         budget_end;
+
+    if(sched_timer_enabled == FALSE)
+    {
+        return;
+    }
+
+    deadline = 0;
+    sleeper  = timer_heap_peek(&cpu->sleeping_threads);
+    if(sleeper != NULL)
+    {
+        deadline = sleeper->wakeup_time;
+    }
+
+    /* The budget of a deadline thread is enforced by the CPU timer */
+    if(next_thread->sched_class == THREAD_SCHED_DEADLINE)
+    {
+        budget_end = next_thread->dl.elected_time + next_thread->dl.remaining;
+        if(deadline == 0 || budget_end < deadline)
+        {
+            deadline = budget_end;
+        }
+    }
+    /* The ready queue head is only a hint, a thread made ready later on this
+     * priority gets its time slice on the next scheduling decision.
+     */
+    else if(next_thread != cpu->idle_thread &&
+            cpu->ready_queues[next_thread->priority].head != NULL)
+    {
+        slice_end = time_get_current_uptime_nano() + SCHED_TIME_SLICE_NS;
+        if(deadline == 0 || slice_end < deadline)
+        {
+            deadline = slice_end;
+        }
+    }
+
+    if(deadline != cpu->timer_deadline)
+    {
+        cpu->timer_deadline = deadline;
+        time_set_deadline(TIME_DEADLINE_SCHEDULER, deadline);
+    }
+}
+
+static void _sched_timer_handler(kernel_thread_t* curr_thread)
+{
+    /* The one-shot timer fired, it is not armed anymore */
+    _sched_get_local_cpu()->timer_deadline = 0;
+
+    _sched_switch(curr_thread, TRUE);
+}
+
+inline static void _sched_account_switch(kernel_thread_t* curr_thread,
+                                         kernel_thread_t* next_thread,
+                                         const bool_t voluntary)
+{
+    uint64_t now;
+
+    now = _cpu_rdtsc();
+
+    curr_thread->stats.run_cycles += now - curr_thread->stats.elected_tsc;
+    next_thread->stats.elected_tsc = now;
+
+    if(voluntary == TRUE)
+    {
+        ++curr_thread->stats.voluntary_switches;
+    }
+    else
+    {
+        ++curr_thread->stats.involuntary_switches;
+    }
+}
+
+inline static void _sched_account_wait(kernel_thread_t* thread)
+{
+    thread_stats_t* stats;
+    uint64_t        wait_time;
+    uint32_t        bucket;
+
+    stats     = &thread->stats;
+    wait_time = time_get_ns() - stats->wait_start_time;
+
+    /* Get the log2 bucket, in units of 1024ns */
+    bucket = 0;
+    if((wait_time >> 10) != 0)
+    {
+        bucket = 63 - __builtin_clzll(wait_time >> 10);
+        if(bucket >= THREAD_WAIT_HISTOGRAM_SIZE)
+        {
+            bucket = THREAD_WAIT_HISTOGRAM_SIZE - 1;
+        }
+    }
+
+    ++stats->wait_histogram[thread->block_type][bucket];
+    if(wait_time > stats->max_wait_time[thread->block_type])
+    {
+        stats->max_wait_time[thread->block_type] = wait_time;
+    }
+}
+
+static void _sched_release_thread(rcu_head_t* head)
+{
+    kernel_thread_t* thread;
+    OS_RETURN_E      err;
+
+    thread = RCU_CONTAINER_OF(head, kernel_thread_t, rcu_head);
+
+    /* The created threads identifiers are positive, scheduler_walk_threads
+     * skips the free control blocks.
+     */
+    thread->tid = 0;
+
+    err = kstack_free(thread->stack);
+    SCHED_ASSERT(err == OS_NO_ERR, "Could not release a thread stack", err);
+    kpool_free(&thread_pool, thread);
+}
+
+static void _sched_fpu_handler(kernel_thread_t* curr_thread)
+{
+    sched_cpu_t* cpu;
+    bool_t       restored;
+
+    cpu = _sched_get_local_cpu();
+
+    _cpu_fpu_enable();
+
+    /* The registers still hold the thread's state when the thread was the last
+     * one to use the FPU on this CPU and did not use it elsewhere since.
+     */
+    restored = FALSE;
+    if(cpu->fpu_owner != curr_thread || curr_thread->fpu_cpu_id != cpu->cpu_id)
+    {
+        if(curr_thread->fpu_state_valid == TRUE)
+        {
+            cpu_fpu_restore(curr_thread->fpu_state);
+        }
+        else
+        {
+            cpu_fpu_reset();
+        }
+        cpu->fpu_owner          = curr_thread;
+        curr_thread->fpu_cpu_id = cpu->cpu_id;
+        restored                = TRUE;
+    }
+
+    cpu->fpu_active = TRUE;
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_SCHED_FPU_LOAD, 3,
+                       cpu->cpu_id, curr_thread->tid, restored);
+
+    KERNEL_DEBUG(SCHED_SWITCH_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %d FPU enabled for thread %d", cpu->cpu_id,
+                 curr_thread->tid);
+}
+
+static void _sched_switch(kernel_thread_t* curr_thread, const bool_t preempted)
+{
+    sched_cpu_t*     cpu;
+    kernel_thread_t* next_thread;
+    OS_RETURN_E      err;
+    uint64_t         now;
+    bool_t           voluntary;
+
+    cpu = _sched_get_local_cpu();
+    now = time_get_current_uptime_nano();
+
+    /* A thread that left the running state gave the CPU, even when preempted
+     * while doing so.
+     */
+    voluntary = (preempted == FALSE ||
+                 curr_thread->state != THREAD_STATE_RUNNING);
+
+    /* The previous thread context holds no RCU reference anymore */
+    rcu_quiescent_state();
+
+    /* The CPU left the stack of the last zombie, it is released once the
+     * lockless readers cannot reference it anymore.
+     */
+    if(cpu->zombie_thread != NULL)
+    {
+        (void)rcu_call(&cpu->zombie_thread->rcu_head, _sched_release_thread);
+        cpu->zombie_thread = NULL;
+    }
+
+    /* The CPU also left the stacks of the threads moved to other CPUs */
+    if(cpu->migrating != NULL)
+    {
+        _sched_flush_migrating(cpu);
+    }
+
+    /* Save the extended state before the thread can be stolen, the registers
+     * keep holding it if the thread resumes on this CPU.
+     */
+    if(cpu->fpu_active == TRUE)
+    {
+        cpu_fpu_save(curr_thread->fpu_state);
+        curr_thread->fpu_state_valid = TRUE;
+        cpu->fpu_active              = FALSE;
+        _cpu_fpu_disable();
+    }
+
+    /* A deadline thread that used its budget is throttled */
+    if(curr_thread->sched_class == THREAD_SCHED_DEADLINE)
+    {
+        _sched_dl_account(curr_thread, now);
+    }
+
+    KERNEL_SPINLOCK_LOCK(cpu->lock);
+
+    /* Other CPUs must not steal the current thread until we left its stack */
+    cpu->switched_out = curr_thread;
+
+    if(curr_thread->state == THREAD_STATE_RUNNING &&
+       curr_thread != cpu->idle_thread)
+    {
+        if((_sched_get_thread_cpus(curr_thread) & (1U << cpu->cpu_id)) != 0)
+        {
+            _sched_enqueue_ready(cpu, curr_thread);
+        }
+        else
+        {
+            /* The thread is moved once the CPU left its stack */
+            curr_thread->state       = THREAD_STATE_READY;
+            curr_thread->next_thread = cpu->migrating;
+            cpu->migrating           = curr_thread;
+        }
+    }
+    else if(curr_thread->state == THREAD_STATE_SLEEPING)
+    {
+        /* The heap can hold every thread, it cannot be full */
+        err = timer_heap_insert(&cpu->sleeping_threads, curr_thread);
+        SCHED_ASSERT(err == OS_NO_ERR, "Could not put thread to sleep", err);
+    }
+    else if(curr_thread->state == THREAD_STATE_ZOMBIE &&
+            kpool_contains(&thread_pool, curr_thread) == TRUE)
+    {
+        /* We are still running on the thread's stack, the control block is
+         * released on the next scheduling decision of this CPU.
+         */
+        cpu->zombie_thread = curr_thread;
+    }
+
+    if(cpu->sleeping_threads.size != 0)
+    {
+        _sched_wakeup_threads(cpu, now);
+    }
+
+    next_thread = _sched_dequeue_ready(cpu);
+
+    KERNEL_SPINLOCK_UNLOCK(cpu->lock);
+
+    /* The idle CPUs wait for a hint to steal the threads left ready */
+    if(cpu->ready_count != 0)
+    {
+        _sched_kick_idle_cpu(cpu);
+    }
+
+    if(next_thread == NULL)
+    {
+        next_thread = _sched_steal(cpu);
+        if(next_thread == NULL)
+        {
+            next_thread = cpu->idle_thread;
+        }
+    }
+
+    next_thread->state  = THREAD_STATE_RUNNING;
+    cpu->current_thread = next_thread;
+
+    /* Only the threads entering the user space have a kernel stack */
+    if(next_thread->int_stack != 0)
+    {
+        cpu->kernel_stack = next_thread->int_stack +
+                            next_thread->int_stack_size;
+        cpu_set_kernel_stack(cpu->cpu_id, cpu->kernel_stack);
+    }
+
+    /* A deadline thread consumes its budget from its election */
+    next_thread->dl.elected_time = now;
+
+    _sched_update_timer(cpu, next_thread);
+
+    /* The next scheduling decision moves the migrating threads */
+    if(cpu->migrating != NULL)
+    {
+        _sched_request_preemption(cpu);
+    }
+
+    if(next_thread != curr_thread)
+    {
+        _sched_account_switch(curr_thread, next_thread, voluntary);
+    }
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_SCHED_SWITCH, 2,
+                       curr_thread->tid, next_thread->tid);
+
+    KERNEL_DEBUG(SCHED_SWITCH_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %d switch %d -> %d", cpu->cpu_id,
+                 curr_thread->tid, next_thread->tid);
+}
+
+static void _sched_switch_handler(kernel_thread_t* curr_thread)
+{
+    _sched_switch(curr_thread, FALSE);
+}
+
+static void _sched_thread_entry(void)
+{
+    kernel_thread_t* thread;
+    uint32_t         int_state;
+
+    thread = scheduler_get_current_thread();
+
+    thread->ret_val      = thread->entry_point(thread->args);
+    thread->return_state = THREAD_RETURN_STATE_RETURNED;
+    thread->end_time     = time_get_ns();
+
+    KERNEL_DEBUG(SCHED_DEBUG_ENABLED, MODULE_NAME,
+                 "Thread %d returned", thread->tid);
+
+    ENTER_CRITICAL(int_state);
+    (void)int_state;
+
+    if(thread->sched_class == THREAD_SCHED_DEADLINE)
+    {
+        _sched_dl_release(thread);
+    }
+
+    thread->state = THREAD_STATE_ZOMBIE;
+    scheduler_schedule();
+
+    /* We should never come back */
+    SCHED_ASSERT(FALSE, "Zombie thread elected", OS_ERR_UNAUTHORIZED_ACTION);
+}
+
+static void* _sched_idle_routine(void* args)
+{
+    sched_cpu_t* cpu;
+    uint32_t     i;
+    uint32_t     int_state;
+
+    (void)args;
+
+    while(TRUE)
+    {
+        /* The idle thread never migrates */
+        ENTER_CRITICAL(int_state);
+        cpu = _sched_get_local_cpu();
+        rcu_quiescent_state();
+        EXIT_CRITICAL(int_state);
+
+        /* Give back the pages of the stacks released by the RCU callbacks */
+        kstack_reclaim();
+
+        /* The isolated CPUs only wait for their own threads */
+        for(i = 0; i < MAX_CPU_COUNT; ++i)
+        {
+            if(SCHED_CPU(i)->ready_count != 0 &&
+               (SCHED_CPU(i) == cpu ||
+                (sched_isolated_cpus & (1U << cpu->cpu_id)) == 0))
+            {
+                scheduler_schedule();
+                break;
+            }
+        }
+
+        /* The other CPUs send a reschedule hint when they have work */
+        idle_wait();
+    }
+
+    return NULL;
+}
+
+void scheduler_init_cpu_local(const uint32_t cpu_id)
+{
+    sched_cpu_t*     cpu;
+    kernel_thread_t* boot_thread;
+
+    SCHED_ASSERT(cpu_id < MAX_CPU_COUNT, "Invalid CPU identifier",
+                 OS_ERR_UNAUTHORIZED_ACTION);
+    SCHED_ASSERT((uintptr_t)&sched_cpu == 0,
+                 "Scheduler data not at the per-CPU areas base",
+                 OS_ERR_UNAUTHORIZED_ACTION);
+
+    cpu         = SCHED_CPU(cpu_id);
+    boot_thread = &boot_threads[cpu_id];
+
+    /* The current execution context becomes the CPU boot thread */
+    memset(boot_thread, 0, sizeof(kernel_thread_t));
+    boot_thread->fpu_cpu_id = cpu_id;
+    boot_thread->type       = THREAD_TYPE_KERNEL;
+    boot_thread->state      = THREAD_STATE_RUNNING;
+    boot_thread->stack      = (uintptr_t)&_KERNEL_STACKS_BASE +
+                              cpu_id * KERNEL_STACK_SIZE;
+    boot_thread->stack_size = KERNEL_STACK_SIZE;
+    boot_thread->start_time = time_get_ns();
+
+    boot_thread->stats.elected_tsc = _cpu_rdtsc();
+    if(cpu_id == 0)
+    {
+        boot_thread->tid          = 0;
+        boot_thread->priority     = KERNEL_HIGHEST_PRIORITY;
+        boot_thread->cpu_affinity = SCHED_CPU_AFFINITY_ALL;
+        strncpy(boot_thread->name, INIT_THREAD_NAME, THREAD_NAME_MAX_LENGTH);
+    }
+    else
+    {
+        boot_thread->tid          = -(int32_t)cpu_id;
+        boot_thread->priority     = IDLE_THREAD_PRIORITY;
+        boot_thread->cpu_affinity = (1U << cpu_id);
+        strncpy(boot_thread->name, IDLE_THREAD_NAME, THREAD_NAME_MAX_LENGTH);
+    }
+
+    memset(cpu, 0, sizeof(sched_cpu_t));
+    boot_thread->base_priority = boot_thread->priority;
+
+    cpu->current_thread = boot_thread;
+    cpu->cpu_id         = cpu_id;
+    KERNEL_SPINLOCK_INIT_TYPE(cpu->lock, SCHED_SPINLOCK_TYPE);
+    timer_heap_init(&cpu->sleeping_threads);
+    rcu_init_cpu(cpu_id);
+
+    cpu->resched_call.function = _sched_resched_call;
+
+    /* The FPU is enabled at boot, the boot thread owns its registers */
+    cpu->fpu_owner  = boot_thread;
+    cpu->fpu_active = TRUE;
+
+    if(cpu_id != 0)
+    {
+        cpu->idle_thread = boot_thread;
+    }
+
+    cpu_set_local_storage(cpu_id, (uintptr_t)cpu);
+
+    /* Publish the CPU last, other CPUs consider it once self is set. The
+     * threads are put on the CPU once it can be locked by the others.
+     */
+    cpu->self = cpu;
+    __atomic_fetch_or(&sched_cpu_mask, 1U << cpu_id, __ATOMIC_SEQ_CST);
+
+    KERNEL_DEBUG(SCHED_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %d scheduler data initialized", cpu_id);
+}
+
+void scheduler_init(void)
+{
+    OS_RETURN_E  err;
+    sched_cpu_t* cpu;
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_SCHED_INIT_START, 0);
+    KERNEL_DEBUG(SCHED_DEBUG_ENABLED, MODULE_NAME, "Initializing scheduler");
+
+    SCHED_ASSERT(CPU_RESERVED_STACKS_SIZE <= (uintptr_t)&_KERNEL_STACKS_SIZE,
+                 "Kernel stacks region too small",
+                 OS_ERR_NO_MORE_MEMORY);
+
+    cpu = SCHED_CPU(0);
+    SCHED_ASSERT(cpu->self == cpu, "CPU local storage not initialized",
+                 OS_ERR_UNAUTHORIZED_ACTION);
+
+    /* Init the threads pool, the stacks are given by the stacks manager */
+    err = KPOOL_INIT_TYPED(&thread_pool, thread_storage, kernel_thread_t,
+                           FALSE);
+    SCHED_ASSERT(err == OS_NO_ERR, "Could not create threads pool", err);
+
+    last_given_tid = 0;
+
+    /* Create the BSP idle thread, it is elected when no thread is ready */
+    err = scheduler_create_kernel_thread(&cpu->idle_thread,
+                                         IDLE_THREAD_PRIORITY,
+                                         IDLE_THREAD_NAME,
+                                         _sched_idle_routine,
+                                         NULL);
+    SCHED_ASSERT(err == OS_NO_ERR, "Could not create idle thread", err);
+
+    /* The idle thread is never kept in the ready queues */
+    KERNEL_SPINLOCK_LOCK(cpu->lock);
+    cpu->idle_thread = _sched_dequeue_ready(cpu);
+    KERNEL_SPINLOCK_UNLOCK(cpu->lock);
+
+    /* Attach the scheduler handler */
+    err = kernel_interrupt_register_int_handler(SCHEDULER_SW_INT_LINE,
+                                                _sched_switch_handler);
+    SCHED_ASSERT(err == OS_NO_ERR, "Could not register scheduler handler",
+                 err);
+
+    /* Threads load their extended state on their first FPU use */
+    err = kernel_interrupt_register_exception_handler(DEVICE_NOT_FOUND_LINE,
+                                                      _sched_fpu_handler);
+    SCHED_ASSERT(err == OS_NO_ERR, "Could not register FPU handler", err);
+
+    /* Without main timer, threads cannot sleep and are never time sliced */
+    err = time_register_deadline_handler(TIME_DEADLINE_SCHEDULER,
+                                         _sched_timer_handler);
+    SCHED_ASSERT(err == OS_NO_ERR || err == OS_ERR_NOT_SUPPORTED,
+                 "Could not register scheduler timer handler",
+                 err);
+    sched_timer_enabled = (err == OS_NO_ERR);
+
+    KERNEL_SUCCESS("Scheduler initialized\n");
+
+    TEST_POINT_FUNCTION_CALL(scheduler_test, TEST_SCHEDULER_ENABLED);
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_SCHED_INIT_END, 0);
+}
+
+void scheduler_idle(void)
+{
+    sched_cpu_t* cpu;
+
+    cpu = _sched_get_local_cpu();
+
+    SCHED_ASSERT(cpu->current_thread == cpu->idle_thread,
+                 "Only the idle thread can run the idle loop",
+                 OS_ERR_UNAUTHORIZED_ACTION);
+
+    KERNEL_DEBUG(SCHED_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %d entering idle loop", cpu->cpu_id);
+
+    /* The idle thread waits for the timer interrupts */
+    _cpu_set_interrupt();
+    _sched_idle_routine(NULL);
+}
+
+OS_RETURN_E scheduler_isolate_cpu(void)
+{
+    sched_cpu_t*     cpu;
+    sched_cpu_t*     target;
+    kernel_thread_t* thread;
+    uint32_t         int_state;
+
+    ENTER_CRITICAL(int_state);
+
+    cpu = _sched_get_local_cpu();
+    if(cpu->idle_thread == NULL || cpu->current_thread != cpu->idle_thread)
+    {
+        EXIT_CRITICAL(int_state);
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    __atomic_fetch_or(&sched_isolated_cpus, 1U << cpu->cpu_id,
+                      __ATOMIC_SEQ_CST);
+    __atomic_fetch_and(&sched_cpu_mask, ~(1U << cpu->cpu_id),
+                       __ATOMIC_SEQ_CST);
+
+    /* No thread is elected on the CPU anymore */
+    if(sched_timer_enabled == TRUE)
+    {
+        cpu->timer_deadline = 0;
+        time_set_deadline(TIME_DEADLINE_SCHEDULER, 0);
+    }
+
+    /* The CPU locks are never nested, move the ready threads one by one */
+    while(TRUE)
+    {
+        KERNEL_SPINLOCK_LOCK(cpu->lock);
+        thread = _sched_dequeue_ready(cpu);
+        KERNEL_SPINLOCK_UNLOCK(cpu->lock);
+        if(thread == NULL)
+        {
+            break;
+        }
+
+        target = _sched_get_enqueue_cpu(cpu, thread);
+        KERNEL_SPINLOCK_LOCK(target->lock);
+        _sched_enqueue_ready(target, thread);
+        KERNEL_SPINLOCK_UNLOCK(target->lock);
+        _sched_kick_idle_cpu(cpu);
+    }
+
+    KERNEL_DEBUG(SCHED_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %d removed from the scheduling", cpu->cpu_id);
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+void scheduler_schedule(void)
+{
+    cpu_raise_interrupt(SCHEDULER_SW_INT_LINE);
+}
+
+OS_RETURN_E scheduler_create_kernel_thread(kernel_thread_t** thread,
+                                           const uint8_t priority,
+                                           const char* name,
+                                           void* (*function)(void*),
+                                           void* args)
+{
+    kernel_thread_t* new_thread;
+    sched_cpu_t*     cpu;
+    sched_cpu_t*     local;
+    uintptr_t        stack;
+    size_t           stack_size;
+    uint32_t         int_state;
+    OS_RETURN_E      err;
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_SCHED_CREATE_THREAD_START, 1, priority);
+
+    if(function == NULL || name == NULL)
+    {
+        KERNEL_TRACE_EVENT(EVENT_KERNEL_SCHED_CREATE_THREAD_END, 2,
+                           -1, OS_ERR_NULL_POINTER);
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(priority > KERNEL_LOWEST_PRIORITY)
+    {
+        KERNEL_TRACE_EVENT(EVENT_KERNEL_SCHED_CREATE_THREAD_END, 2,
+                           -1, OS_ERR_FORBIDEN_PRIORITY);
+        return OS_ERR_FORBIDEN_PRIORITY;
+    }
+
+    /* The stack pages might be mapped, get the stack first */
+    err = kstack_alloc(&stack, &stack_size);
+    if(err != OS_NO_ERR)
+    {
+        KERNEL_TRACE_EVENT(EVENT_KERNEL_SCHED_CREATE_THREAD_END, 2,
+                           -1, err);
+        return err;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    /* Get a free control block */
+    new_thread = KPOOL_ALLOC(&thread_pool, kernel_thread_t);
+    if(new_thread == NULL)
+    {
+        EXIT_CRITICAL(int_state);
+        (void)kstack_free(stack);
+
+        KERNEL_TRACE_EVENT(EVENT_KERNEL_SCHED_CREATE_THREAD_END, 2,
+                           -1, OS_ERR_NO_MORE_MEMORY);
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+
+    /* Setup the thread */
+    memset(new_thread, 0, sizeof(kernel_thread_t));
+    new_thread->tid = __atomic_add_fetch(&last_given_tid, 1, __ATOMIC_RELAXED);
+
+    new_thread->type          = THREAD_TYPE_KERNEL;
+    new_thread->priority      = priority;
+    new_thread->base_priority = priority;
+    new_thread->args          = args;
+    new_thread->entry_point   = function;
+    new_thread->stack         = stack;
+    new_thread->stack_size    = stack_size;
+    new_thread->fpu_cpu_id    = MAX_CPU_COUNT;
+    new_thread->cpu_affinity  = SCHED_CPU_AFFINITY_ALL;
+    new_thread->start_time    = time_get_ns();
+    strncpy(new_thread->name, name, THREAD_NAME_MAX_LENGTH);
+    new_thread->name[THREAD_NAME_MAX_LENGTH - 1] = 0;
+
+    cpu_init_thread_context(_sched_thread_entry,
+                            new_thread->stack + new_thread->stack_size,
+                            &new_thread->v_cpu);
+
+    /* The thread starts on the creating CPU, other CPUs might steal it */
+    local = _sched_get_local_cpu();
+    cpu   = _sched_get_enqueue_cpu(local, new_thread);
+    KERNEL_SPINLOCK_LOCK(cpu->lock);
+    _sched_enqueue_ready(cpu, new_thread);
+    KERNEL_SPINLOCK_UNLOCK(cpu->lock);
+
+    /* The idle CPUs only run the thread once they get a hint */
+    if(cpu != local &&
+       _sched_preempts(new_thread, cpu->current_thread) == TRUE)
+    {
+        (void)_sched_send_resched(cpu);
+    }
+    else
+    {
+        _sched_kick_idle_cpu(cpu);
+    }
+
+    KERNEL_DEBUG(SCHED_DEBUG_ENABLED, MODULE_NAME,
+                 "Created thread %s (%d) priority %d on CPU %d",
+                 new_thread->name, new_thread->tid, priority, cpu->cpu_id);
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_SCHED_CREATE_THREAD_END, 2,
+                       new_thread->tid, OS_NO_ERR);
+
+    EXIT_CRITICAL(int_state);
+
+    if(thread != NULL)
+    {
+        *thread = new_thread;
+    }
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E scheduler_sleep(const uint64_t time_ns)
+{
+    sched_cpu_t*     cpu;
+    kernel_thread_t* thread;
+    uint32_t         int_state;
+
+    if(sched_timer_enabled == FALSE)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    cpu    = _sched_get_local_cpu();
+    thread = cpu->current_thread;
+    if(thread == cpu->idle_thread)
+    {
+        EXIT_CRITICAL(int_state);
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    thread->wakeup_time = time_get_current_uptime_nano() + time_ns;
+    thread->state       = THREAD_STATE_SLEEPING;
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_SCHED_SLEEP, 2,
+                       thread->tid,
+                       thread->wakeup_time);
+
+    KERNEL_DEBUG(SCHED_DEBUG_ENABLED, MODULE_NAME,
+                 "Thread %d sleeps for %lluns", thread->tid, time_ns);
+
+    /* The thread is put in the timer heap when switched out */
+    scheduler_schedule();
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E scheduler_wait_thread(const THREAD_WAIT_TYPE_E block_type,
+                                  kernel_spinlock_t* lock)
+{
+    sched_cpu_t*     cpu;
+    kernel_thread_t* thread;
+    uint32_t         int_state;
+
+    ENTER_CRITICAL(int_state);
+
+    cpu    = _sched_get_local_cpu();
+    thread = cpu->current_thread;
+    if(thread == cpu->idle_thread)
+    {
+        EXIT_CRITICAL(int_state);
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    thread->block_type            = block_type;
+    thread->stats.wait_start_time = time_get_ns();
+    __atomic_store_n(&thread->state, THREAD_STATE_WAITING, __ATOMIC_RELEASE);
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_SCHED_WAIT, 2, thread->tid, block_type);
+
+    KERNEL_DEBUG(SCHED_DEBUG_ENABLED, MODULE_NAME,
+                 "Thread %d waits, type %d", thread->tid, block_type);
+
+    /* The waker can now see the waiting state */
+    if(lock != NULL)
+    {
+        KERNEL_SPINLOCK_UNLOCK(*lock);
+    }
+
+    /* The thread is left out of the queues when switched out */
+    scheduler_schedule();
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E scheduler_wakeup_thread(kernel_thread_t* thread)
+{
+    sched_cpu_t*   local;
+    sched_cpu_t*   cpu;
+    THREAD_STATE_E expected;
+    uint32_t       int_state;
+    uint32_t       i;
+
+    if(thread == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    /* Only one waker can take the thread out of the waiting state */
+    expected = THREAD_STATE_WAITING;
+    if(__atomic_compare_exchange_n(&thread->state, &expected,
+                                   THREAD_STATE_READY, FALSE,
+                                   __ATOMIC_ACQ_REL,
+                                   __ATOMIC_ACQUIRE) == FALSE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    /* The waker that took the thread out of the waiting state owns it */
+    _sched_account_wait(thread);
+
+    ENTER_CRITICAL(int_state);
+
+    /* The thread might still be switching out, its CPU switches with
+     * interrupts disabled and leaves its stack shortly.
+     */
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        while(SCHED_CPU(i)->current_thread == thread ||
+              SCHED_CPU(i)->switched_out == thread)
+        {
+            _cpu_pause();
+        }
+    }
+
+    if(thread->sched_class == THREAD_SCHED_DEADLINE)
+    {
+        _sched_dl_wakeup(thread, time_get_current_uptime_nano());
+    }
+
+    local = _sched_get_local_cpu();
+    cpu   = _sched_get_enqueue_cpu(local, thread);
+    KERNEL_SPINLOCK_LOCK(cpu->lock);
+    _sched_enqueue_ready(cpu, thread);
+    KERNEL_SPINLOCK_UNLOCK(cpu->lock);
+
+    if(_sched_preempts(thread, cpu->current_thread) == TRUE)
+    {
+        if(cpu == local)
+        {
+            _sched_request_preemption(cpu);
+        }
+        else
+        {
+            (void)_sched_send_resched(cpu);
+        }
+    }
+    else
+    {
+        _sched_kick_idle_cpu(cpu);
+    }
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_SCHED_WAKEUP, 2, cpu->cpu_id, thread->tid);
+
+    KERNEL_DEBUG(SCHED_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %d woke up waiting thread %d", cpu->cpu_id, thread->tid);
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E scheduler_set_priority(kernel_thread_t* thread,
+                                   const uint8_t priority)
+{
+    sched_cpu_t* cpu;
+    uint32_t     locked_cpus;
+    uint32_t     int_state;
+    uint32_t     i;
+
+    if(thread == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(priority > KERNEL_LOWEST_PRIORITY)
+    {
+        return OS_ERR_FORBIDEN_PRIORITY;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    /* The ready queues are only modified with their CPU lock held, holding
+     * all of them keeps the priority stable for every enqueue and dequeue.
+     */
+    locked_cpus = _sched_lock_all_cpus();
+
+    /* A ready thread might be between two CPUs, only move it when it is the
+     * head or a linked member of the queue it was last put in.
+     */
+    cpu = SCHED_CPU(thread->ready_cpu_id);
+    if(thread->state == THREAD_STATE_READY &&
+       (locked_cpus & (1U << thread->ready_cpu_id)) != 0 &&
+       (thread->prev_thread != NULL ||
+        cpu->ready_queues[thread->priority].head == thread))
+    {
+        _sched_unlink_ready(cpu, thread);
+        thread->priority = priority;
+        _sched_enqueue_ready(cpu, thread);
+    }
+    else
+    {
+        thread->priority = priority;
+    }
+
+    _sched_unlock_all_cpus(locked_cpus);
+
+    /* A ready thread of this CPU might now have a higher priority than the
+     * current thread.
+     */
+    cpu = _sched_get_local_cpu();
+    if(cpu->ready_summary != 0 &&
+       cpu->current_thread != cpu->idle_thread &&
+       cpu->current_thread->sched_class == THREAD_SCHED_FIXED)
+    {
+        i = _sched_find_first_set(cpu->ready_summary);
+        i = i * SCHED_BITMAP_WORD_SIZE +
+            _sched_find_first_set(cpu->ready_bitmap[i]);
+        if(i < cpu->current_thread->priority)
+        {
+            _sched_request_preemption(cpu);
+        }
+    }
+
+    KERNEL_DEBUG(SCHED_DEBUG_ENABLED, MODULE_NAME,
+                 "Thread %d priority set to %d", thread->tid, priority);
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E scheduler_set_thread_affinity(kernel_thread_t* thread,
+                                          const uint32_t cpu_mask)
+{
+    uint32_t         locked_cpus;
+    uint32_t         resched_cpus;
+    uint32_t         int_state;
+    uint32_t         i;
+
+    if(thread == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if((cpu_mask & SCHED_CPU_MASK_ALL) == 0)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        if(thread == SCHED_CPU(i)->idle_thread)
+        {
+            return OS_ERR_UNAUTHORIZED_ACTION;
+        }
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    locked_cpus = _sched_lock_all_cpus();
+
+    thread->cpu_affinity = cpu_mask;
+
+    /* A ready thread is moved now, a running thread on its next switch */
+    resched_cpus = 0;
+    if(thread->state == THREAD_STATE_READY &&
+       (locked_cpus & (1U << thread->ready_cpu_id)) != 0)
+    {
+        resched_cpus = _sched_move_ready(SCHED_CPU(thread->ready_cpu_id),
+                                         locked_cpus);
+    }
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        if((locked_cpus & (1U << i)) != 0 &&
+           SCHED_CPU(i)->current_thread == thread &&
+           (_sched_get_thread_cpus(thread) & (1U << i)) == 0)
+        {
+            resched_cpus |= (1U << i);
+        }
+    }
+
+    _sched_unlock_all_cpus(locked_cpus);
+
+    _sched_resched_cpus(resched_cpus);
+
+    KERNEL_DEBUG(SCHED_DEBUG_ENABLED, MODULE_NAME,
+                 "Thread %d affinity set to 0x%x", thread->tid, cpu_mask);
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E scheduler_set_deadline(const uint64_t runtime_ns,
+                                   const uint64_t deadline_ns,
+                                   const uint64_t period_ns)
+{
+    sched_cpu_t*     cpu;
+    sched_cpu_t*     target;
+    kernel_thread_t* thread;
+    uint64_t         now;
+    uint32_t         bandwidth;
+    uint32_t         cpus;
+    uint32_t         int_state;
+    uint32_t         i;
+    bool_t           was_deadline;
+
+    if(runtime_ns < SCHED_DEADLINE_MIN_RUNTIME_NS ||
+       runtime_ns > deadline_ns ||
+       deadline_ns > period_ns ||
+       period_ns > SCHED_DEADLINE_MAX_PERIOD_NS)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    /* The constrained deadlines are admitted on their density */
+    bandwidth = (uint32_t)((runtime_ns << SCHED_DL_BW_SHIFT) / deadline_ns);
+
+    ENTER_CRITICAL(int_state);
+
+    cpu    = _sched_get_local_cpu();
+    thread = cpu->current_thread;
+    if(thread == cpu->idle_thread)
+    {
+        EXIT_CRITICAL(int_state);
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    KERNEL_SPINLOCK_LOCK(sched_dl_lock);
+
+    /* The previous reservation of the thread is given back to its CPU, the
+     * running thread is in no queue.
+     */
+    was_deadline = (thread->sched_class == THREAD_SCHED_DEADLINE);
+    if(was_deadline == TRUE)
+    {
+        SCHED_CPU(thread->dl.cpu_id)->dl_bandwidth -= thread->dl.bandwidth;
+        thread->sched_class = THREAD_SCHED_FIXED;
+    }
+
+    /* Reserve the bandwidth on the calling CPU or on the least reserved CPU
+     * the thread can run on.
+     */
+    target = NULL;
+    cpus   = _sched_get_thread_cpus(thread);
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        if((cpus & (1U << i)) == 0 ||
+           SCHED_CPU(i)->dl_bandwidth + (uint64_t)bandwidth > SCHED_DL_MAX_BW)
+        {
+            continue;
+        }
+        if(target == NULL ||
+           SCHED_CPU(i) == cpu ||
+           (target != cpu &&
+            SCHED_CPU(i)->dl_bandwidth < target->dl_bandwidth))
+        {
+            target = SCHED_CPU(i);
+        }
+    }
+
+    if(target == NULL)
+    {
+        if(was_deadline == TRUE)
+        {
+            SCHED_CPU(thread->dl.cpu_id)->dl_bandwidth +=
+                thread->dl.bandwidth;
+            thread->sched_class = THREAD_SCHED_DEADLINE;
+        }
+        KERNEL_SPINLOCK_UNLOCK(sched_dl_lock);
+        EXIT_CRITICAL(int_state);
+
+        KERNEL_DEBUG(SCHED_DEBUG_ENABLED, MODULE_NAME,
+                     "Thread %d deadline parameters rejected", thread->tid);
+        return OS_ERR_RESOURCE_BUSY;
+    }
+
+    target->dl_bandwidth += bandwidth;
+
+    KERNEL_SPINLOCK_UNLOCK(sched_dl_lock);
+
+    /* The thread is running, it is in no queue and releases its first
+     * instance now.
+     */
+    now = time_get_current_uptime_nano();
+    thread->dl.runtime      = runtime_ns;
+    thread->dl.rel_deadline = deadline_ns;
+    thread->dl.period       = period_ns;
+    thread->dl.deadline     = now + deadline_ns;
+    thread->dl.remaining    = runtime_ns;
+    thread->dl.elected_time = now;
+    thread->dl.bandwidth    = bandwidth;
+    thread->dl.cpu_id       = target->cpu_id;
+    thread->dl.throttled    = FALSE;
+    thread->sched_class     = THREAD_SCHED_DEADLINE;
+
+    KERNEL_DEBUG(SCHED_DEBUG_ENABLED, MODULE_NAME,
+                 "Thread %d deadline class on CPU %d, bandwidth %u",
+                 thread->tid, target->cpu_id, bandwidth);
+
+    /* The scheduling decision moves the thread to its CPU and arms its
+     * budget.
+     */
+    scheduler_schedule();
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E scheduler_clear_deadline(void)
+{
+    kernel_thread_t* thread;
+    uint32_t         int_state;
+
+    ENTER_CRITICAL(int_state);
+
+    thread = _sched_get_local_cpu()->current_thread;
+    if(thread->sched_class != THREAD_SCHED_DEADLINE)
+    {
+        EXIT_CRITICAL(int_state);
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    _sched_dl_release(thread);
+
+    KERNEL_DEBUG(SCHED_DEBUG_ENABLED, MODULE_NAME,
+                 "Thread %d back to the fixed priorities", thread->tid);
+
+    /* The thread is elected again among the fixed priority threads */
+    scheduler_schedule();
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E scheduler_wait_next_period(void)
+{
+    kernel_thread_t* thread;
+    uint32_t         int_state;
+
+    ENTER_CRITICAL(int_state);
+
+    thread = _sched_get_local_cpu()->current_thread;
+    if(thread->sched_class != THREAD_SCHED_DEADLINE)
+    {
+        EXIT_CRITICAL(int_state);
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    if(time_get_current_uptime_nano() > thread->dl.deadline)
+    {
+        ++thread->dl.missed_deadlines;
+
+        KERNEL_TRACE_EVENT(EVENT_KERNEL_SCHED_DEADLINE_MISS, 2,
+                           thread->tid, thread->dl.missed_deadlines);
+    }
+
+    /* The thread is throttled until its next release when switched out */
+    thread->dl.remaining = 0;
+    scheduler_schedule();
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E scheduler_set_cpu_isolated(const uint32_t cpu_id,
+                                       const bool_t isolated)
+{
+    sched_cpu_t* cpu;
+    uint32_t     locked_cpus;
+    uint32_t     resched_cpus;
+    uint32_t     int_state;
+
+    if(cpu_id == 0 || cpu_id >= MAX_CPU_COUNT)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    cpu = SCHED_CPU(cpu_id);
+
+    ENTER_CRITICAL(int_state);
+
+    locked_cpus = _sched_lock_all_cpus();
+
+    /* A CPU removed from the scheduling stays isolated */
+    if(cpu->self != NULL && (sched_cpu_mask & (1U << cpu_id)) == 0)
+    {
+        _sched_unlock_all_cpus(locked_cpus);
+        EXIT_CRITICAL(int_state);
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    resched_cpus = 0;
+    if(isolated == TRUE)
+    {
+        __atomic_fetch_or(&sched_isolated_cpus, 1U << cpu_id,
+                          __ATOMIC_SEQ_CST);
+
+        /* The threads that are not pinned on the CPU leave it */
+        if((locked_cpus & (1U << cpu_id)) != 0)
+        {
+            resched_cpus = _sched_move_ready(cpu, locked_cpus);
+            if(cpu->current_thread != cpu->idle_thread &&
+               (_sched_get_thread_cpus(cpu->current_thread) &
+                (1U << cpu_id)) == 0)
+            {
+                resched_cpus |= (1U << cpu_id);
+            }
+        }
+    }
+    else
+    {
+        __atomic_fetch_and(&sched_isolated_cpus, ~(1U << cpu_id),
+                           __ATOMIC_SEQ_CST);
+    }
+
+    _sched_unlock_all_cpus(locked_cpus);
+
+    _sched_resched_cpus(resched_cpus);
+
+    KERNEL_DEBUG(SCHED_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %d isolation set to %d", cpu_id, isolated);
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+bool_t scheduler_is_cpu_isolated(const uint32_t cpu_id)
+{
+    if(cpu_id >= MAX_CPU_COUNT)
+    {
+        return FALSE;
+    }
+
+    return ((sched_isolated_cpus & (1U << cpu_id)) != 0);
+}
+
+kernel_thread_t* scheduler_get_current_thread(void)
+{
+    kernel_thread_t* thread;
+    uint32_t         int_state;
+
+    /* Interrupts are disabled to avoid migrating between reading the local
+     * storage and the current thread.
+     */
+    ENTER_CRITICAL(int_state);
+    thread = _sched_get_local_cpu()->current_thread;
+    EXIT_CRITICAL(int_state);
+
+    return thread;
+}
+
+uint32_t scheduler_get_current_cpu_id(void)
+{
+    return _sched_get_local_cpu()->cpu_id;
+}
+
+OS_RETURN_E scheduler_get_thread_stats(const kernel_thread_t* thread,
+                                       thread_stats_t* stats)
+{
+    uint32_t int_state;
+
+    if(thread == NULL || stats == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    memcpy(stats, &thread->stats, sizeof(thread_stats_t));
+
+    /* The current time slice is not accounted yet */
+    if(_sched_get_local_cpu()->current_thread == thread)
+    {
+        stats->run_cycles += _cpu_rdtsc() - stats->elected_tsc;
+    }
+
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+void scheduler_walk_threads(void (*visitor)(const kernel_thread_t* thread,
+                                            void* args),
+                            void* args)
+{
+    const kernel_thread_t* thread;
+    uint32_t               i;
+
+    /* The boot threads of the started CPUs are named */
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        if(boot_threads[i].name[0] != 0)
+        {
+            visitor(&boot_threads[i], args);
+        }
+    }
+
+    for(i = 0; i < thread_pool.capacity; ++i)
+    {
+        thread = (const kernel_thread_t*)(thread_pool.base +
+                                          i * thread_pool.stride);
+        if(thread->tid > 0)
+        {
+            visitor(thread, args);
+        }
+    }
 }
 
 /************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,241 @@
+/*******************************************************************************
+ * @file semaphore.c
+ *
+ * @see semaphore.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's counting semaphores.
+ *
+ * @details Kernel's counting semaphores. The units are taken with a compare
+ * and swap on the count. The waiters only queue themselves under the
+ * semaphore lock after failing to take a unit, and the posts increment the
+ * count under the same lock when no thread waits: a unit is either in the
+ * count or given to a waiter, never both.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <cpu.h>            /* CPU pause */
+#include <critical.h>       /* Kernel critical sections and spinlocks */
+#include <ctrl_block.h>     /* Threads control blocks */
+#include <scheduler.h>      /* Thread wait */
+#include <wait_queue.h>     /* Threads wait queue */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <semaphore.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "SEMAPHORE"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Takes an available unit of a semaphore.
+ *
+ * @param[in, out] semaphore The semaphore to take a unit of.
+ *
+ * @return TRUE if a unit was taken, FALSE otherwise.
+ */
+inline static bool_t _semaphore_try_take(semaphore_t* semaphore);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static bool_t _semaphore_try_take(semaphore_t* semaphore)
+{
+    uint32_t count;
+
+    count = __atomic_load_n(&semaphore->count, __ATOMIC_RELAXED);
+    while(count != 0)
+    {
+        if(__atomic_compare_exchange_n(&semaphore->count, &count, count - 1,
+                                       FALSE, __ATOMIC_ACQUIRE,
+                                       __ATOMIC_RELAXED) == TRUE)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+OS_RETURN_E semaphore_init(semaphore_t* semaphore, const uint32_t count)
+{
+    if(semaphore == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    semaphore->count = count;
+    wait_queue_init(&semaphore->waiters);
+    KERNEL_SPINLOCK_INIT(semaphore->lock);
+
+    KERNEL_DEBUG(SEMAPHORE_DEBUG_ENABLED, MODULE_NAME,
+                 "Semaphore 0x%p initialized, count %u", semaphore, count);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E semaphore_wait(semaphore_t* semaphore)
+{
+    wait_queue_node_t node;
+    uint32_t          int_state;
+    uint32_t          i;
+    OS_RETURN_E       err;
+
+    if(semaphore == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    /* Spin while no thread sleeps, the posts go to the sleepers first */
+    for(i = 0; i < KERNEL_SEMAPHORE_SPIN_COUNT; ++i)
+    {
+        if(_semaphore_try_take(semaphore) == TRUE)
+        {
+            return OS_NO_ERR;
+        }
+        if(semaphore->waiters.head != NULL)
+        {
+            break;
+        }
+        _cpu_pause();
+    }
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(semaphore->lock, int_state);
+
+    /* A post between the spin and the lock incremented the count */
+    if(_semaphore_try_take(semaphore) == TRUE)
+    {
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(semaphore->lock, int_state);
+        return OS_NO_ERR;
+    }
+
+    wait_queue_insert(&semaphore->waiters, &node,
+                      scheduler_get_current_thread());
+
+    /* The wait releases the lock once the thread is waiting */
+    while(node.woken == FALSE)
+    {
+        err = scheduler_wait_thread(THREAD_WAIT_TYPE_RESOURCE,
+                                    &semaphore->lock);
+        if(err != OS_NO_ERR)
+        {
+            wait_queue_remove(&semaphore->waiters, &node);
+            KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(semaphore->lock, int_state);
+            return err;
+        }
+        KERNEL_SPINLOCK_LOCK(semaphore->lock);
+    }
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(semaphore->lock, int_state);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E semaphore_trywait(semaphore_t* semaphore)
+{
+    if(semaphore == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(_semaphore_try_take(semaphore) == FALSE)
+    {
+        return OS_ERR_RESOURCE_BUSY;
+    }
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E semaphore_post(semaphore_t* semaphore)
+{
+    wait_queue_node_t* node;
+    uint32_t           int_state;
+    OS_RETURN_E        err;
+
+    if(semaphore == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    err = OS_NO_ERR;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(semaphore->lock, int_state);
+
+    node = wait_queue_pop(&semaphore->waiters);
+    if(node != NULL)
+    {
+        /* The waiter is waiting, it cannot leave before being woken up */
+        node->woken = TRUE;
+        (void)scheduler_wakeup_thread(node->thread);
+
+        KERNEL_DEBUG(SEMAPHORE_DEBUG_ENABLED, MODULE_NAME,
+                     "Semaphore 0x%p unit given to thread %d",
+                     semaphore, node->thread->tid);
+    }
+    else if(__atomic_load_n(&semaphore->count, __ATOMIC_RELAXED) ==
+            UINT32_MAX)
+    {
+        err = OS_ERR_UNAUTHORIZED_ACTION;
+    }
+    else
+    {
+        __atomic_fetch_add(&semaphore->count, 1, __ATOMIC_RELEASE);
+    }
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(semaphore->lock, int_state);
+
+    return err;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,372 @@
+/*******************************************************************************
+ * @file softirq.c
+ *
+ * @see softirq.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's deferred interrupt work.
+ *
+ * @details Kernel's deferred interrupt work. Each CPU has a FIFO of raised
+ * works and a worker thread. The interrupt manager runs a bounded number of
+ * works when it exits a handler, with interrupts still disabled, and leaves
+ * the others to the worker thread which runs them with interrupts enabled.
+ * The works raised while a handler runs never wake the worker thread up, the
+ * interrupt exit would find them first.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <cpu.h>            /* CPU cache line size */
+#include <critical.h>       /* Kernel spinlocks */
+#include <scheduler.h>      /* Kernel scheduler */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <softirq.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "SOFTIRQ"
+
+/** @brief Worker threads name. */
+#define SOFTIRQ_THREAD_NAME "softirq"
+
+/** @brief Worker threads priority, the deferred works preempt the threads. */
+#define SOFTIRQ_THREAD_PRIORITY KERNEL_HIGHEST_PRIORITY
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Per-CPU deferred work data. */
+typedef struct
+{
+    /** @brief First queued work. */
+    softirq_work_t* head;
+
+    /** @brief Last queued work. */
+    softirq_work_t* tail;
+
+    /** @brief Number of interrupt handlers the CPU is in, only accessed by the
+     * CPU.
+     */
+    uint32_t irq_nesting;
+
+    /** @brief The worker thread. */
+    kernel_thread_t* worker;
+
+    /** @brief The worker thread when waiting for work, NULL otherwise. */
+    kernel_thread_t* waiter;
+
+    /** @brief Protects the queue, the worker thread can run on another CPU. */
+    kernel_spinlock_t lock;
+} __attribute__((aligned(CPU_CACHE_LINE_SIZE))) softirq_cpu_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Per-CPU deferred work data. */
+static softirq_cpu_t softirq_cpus[MAX_CPU_COUNT] = {
+    [0 ... MAX_CPU_COUNT - 1] = {
+        .head        = NULL,
+        .tail        = NULL,
+        .irq_nesting = 0,
+        .worker      = NULL,
+        .waiter      = NULL,
+        .lock        = KERNEL_SPINLOCK_INIT_VALUE
+    }
+};
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Removes the first work of a CPU queue.
+ *
+ * @details Removes the first work of a CPU queue, the queue lock must be held.
+ *
+ * @param[in, out] cpu The CPU deferred work data.
+ *
+ * @return The removed work, NULL if the queue is empty.
+ */
+inline static softirq_work_t* _softirq_pop(softirq_cpu_t* cpu);
+
+/**
+ * @brief Runs a work removed from its queue.
+ *
+ * @details Clears the pending flag of the work before calling its routine,
+ * the routine can raise the work again.
+ *
+ * @param[in, out] work The work to run.
+ */
+inline static void _softirq_run(softirq_work_t* work);
+
+/**
+ * @brief Worker thread routine.
+ *
+ * @details Worker thread routine. Runs the queued works of its CPU with
+ * interrupts enabled and waits when the queue is empty.
+ *
+ * @param[in] args The identifier of the CPU.
+ *
+ * @return The function never returns.
+ */
+static void* _softirq_worker_routine(void* args);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static softirq_work_t* _softirq_pop(softirq_cpu_t* cpu)
+{
+    softirq_work_t* work;
+
+    work = cpu->head;
+    if(work != NULL)
+    {
+        cpu->head = work->next;
+        if(cpu->head == NULL)
+        {
+            cpu->tail = NULL;
+        }
+    }
+
+    return work;
+}
+
+inline static void _softirq_run(softirq_work_t* work)
+{
+    __atomic_store_n(&work->pending, 0, __ATOMIC_RELEASE);
+    work->routine(work);
+}
+
+static void* _softirq_worker_routine(void* args)
+{
+    softirq_cpu_t*  cpu;
+    softirq_work_t* work;
+    uint32_t        int_state;
+    OS_RETURN_E     err;
+
+    cpu = &softirq_cpus[(uint32_t)(uintptr_t)args];
+
+    while(TRUE)
+    {
+        KERNEL_SPINLOCK_LOCK_IRQSAVE(cpu->lock, int_state);
+
+        while(cpu->head == NULL)
+        {
+            /* The wait releases the lock once the thread is waiting */
+            cpu->waiter = cpu->worker;
+            err = scheduler_wait_thread(THREAD_WAIT_TYPE_RESOURCE, &cpu->lock);
+            KERNEL_SPINLOCK_LOCK(cpu->lock);
+            if(err != OS_NO_ERR)
+            {
+                cpu->waiter = NULL;
+                break;
+            }
+        }
+        work = _softirq_pop(cpu);
+
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(cpu->lock, int_state);
+
+        /* One work at a time, the interrupts can be served in between */
+        if(work != NULL)
+        {
+            _softirq_run(work);
+        }
+    }
+
+    return NULL;
+}
+
+OS_RETURN_E softirq_init_cpu(const uint32_t cpu_id)
+{
+    OS_RETURN_E err;
+
+    if(cpu_id >= MAX_CPU_COUNT || softirq_cpus[cpu_id].worker != NULL)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    /* The thread starts on the calling CPU and runs the works already queued */
+    err = scheduler_create_kernel_thread(&softirq_cpus[cpu_id].worker,
+                                         SOFTIRQ_THREAD_PRIORITY,
+                                         SOFTIRQ_THREAD_NAME,
+                                         _softirq_worker_routine,
+                                         (void*)(uintptr_t)cpu_id);
+    if(err != OS_NO_ERR)
+    {
+        softirq_cpus[cpu_id].worker = NULL;
+        return err;
+    }
+
+    KERNEL_DEBUG(SOFTIRQ_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %u worker thread created", cpu_id);
+
+    return OS_NO_ERR;
+}
+
+void softirq_work_init(softirq_work_t* work,
+                       void (*routine)(softirq_work_t* work))
+{
+    work->next    = NULL;
+    work->routine = routine;
+    work->pending = 0;
+}
+
+OS_RETURN_E softirq_raise(softirq_work_t* work)
+{
+    softirq_cpu_t*   cpu;
+    kernel_thread_t* waiter;
+    uint32_t         int_state;
+
+    if(work == NULL || work->routine == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    /* The work is already queued and did not run yet */
+    if(__atomic_exchange_n(&work->pending, 1, __ATOMIC_ACQ_REL) != 0)
+    {
+        return OS_NO_ERR;
+    }
+
+    ENTER_CRITICAL(int_state);
+
+    cpu = &softirq_cpus[scheduler_get_current_cpu_id()];
+
+    KERNEL_SPINLOCK_LOCK(cpu->lock);
+
+    work->next = NULL;
+    if(cpu->tail == NULL)
+    {
+        cpu->head = work;
+    }
+    else
+    {
+        cpu->tail->next = work;
+    }
+    cpu->tail = work;
+
+    /* In an interrupt handler, the interrupt exit runs or hands the work */
+    waiter = NULL;
+    if(cpu->irq_nesting == 0)
+    {
+        waiter      = cpu->waiter;
+        cpu->waiter = NULL;
+    }
+
+    KERNEL_SPINLOCK_UNLOCK(cpu->lock);
+
+    EXIT_CRITICAL(int_state);
+
+    if(waiter != NULL)
+    {
+        (void)scheduler_wakeup_thread(waiter);
+    }
+
+    return OS_NO_ERR;
+}
+
+void softirq_irq_enter(const uint32_t cpu_id)
+{
+    ++softirq_cpus[cpu_id].irq_nesting;
+}
+
+void softirq_irq_exit(const uint32_t cpu_id)
+{
+    softirq_cpu_t*   cpu;
+    softirq_work_t*  work;
+    kernel_thread_t* waiter;
+    uint32_t         budget;
+    uint32_t         limit;
+
+    cpu = &softirq_cpus[cpu_id];
+
+    /* The works are run by the outermost handler, the works they raise are
+     * left for the exit.
+     */
+    if(cpu->irq_nesting > 1 ||
+       __atomic_load_n(&cpu->head, __ATOMIC_RELAXED) == NULL)
+    {
+        --cpu->irq_nesting;
+        return;
+    }
+
+    /* The isolated CPUs hand their works to the worker thread, that runs on
+     * the other CPUs.
+     */
+    limit = KERNEL_SOFTIRQ_EXIT_BUDGET;
+    if(scheduler_is_cpu_isolated(cpu_id) == TRUE)
+    {
+        limit = 0;
+    }
+
+    for(budget = 0; budget < limit; ++budget)
+    {
+        KERNEL_SPINLOCK_LOCK(cpu->lock);
+        work = _softirq_pop(cpu);
+        KERNEL_SPINLOCK_UNLOCK(cpu->lock);
+
+        if(work == NULL)
+        {
+            break;
+        }
+        _softirq_run(work);
+    }
+
+    /* The remaining works run with interrupts enabled */
+    KERNEL_SPINLOCK_LOCK(cpu->lock);
+    waiter = NULL;
+    if(cpu->head != NULL)
+    {
+        waiter      = cpu->waiter;
+        cpu->waiter = NULL;
+    }
+    --cpu->irq_nesting;
+    KERNEL_SPINLOCK_UNLOCK(cpu->lock);
+
+    if(waiter != NULL)
+    {
+        KERNEL_DEBUG(SOFTIRQ_DEBUG_ENABLED, MODULE_NAME,
+                     "CPU %u hands works to its worker thread", cpu_id);
+
+        (void)scheduler_wakeup_thread(waiter);
+    }
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
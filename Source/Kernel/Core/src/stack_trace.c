@@ -0,0 +1,240 @@
+/*******************************************************************************
+ * @file stack_trace.c
+ *
+ * @see stack_trace.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's stack walker and symbol table.
+ *
+ * @details Kernel's stack walker and symbol table. The CPUs stacks are
+ * KERNEL_STACK_SIZE bytes blocks aligned on their size, the threads stacks are
+ * slots of the threads stacks area. The walker bounds the walk to the stack
+ * of the first frame, the guard pages of the threads stacks are never read.
+ * The symbol table is only read, it is checked on each lookup as it might be
+ * missing or truncated.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <kstack.h>         /* Threads stacks bounds */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <stack_trace.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "STACK_TRACE"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* The walker bounds rely on the stacks alignment */
+_Static_assert((KERNEL_STACK_SIZE & (KERNEL_STACK_SIZE - 1)) == 0,
+               "The kernel stack size must be a power of 2");
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/** @brief Kernel text start, defined in the linker file. */
+extern const uint8_t _START_TEXT_ADDR[];
+
+/** @brief Kernel text end, defined in the linker file. */
+extern const uint8_t _END_TEXT_ADDR[];
+
+/** @brief Symbol table start, defined in the linker file. */
+extern const uint8_t _START_KERNEL_SYMTAB_ADDR[];
+
+/** @brief Symbol table end, defined in the linker file. */
+extern const uint8_t _END_KERNEL_SYMTAB_ADDR[];
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Tells if an address lies in the kernel text.
+ *
+ * @param[in] address The address to check.
+ *
+ * @return TRUE if the address lies in the kernel text, FALSE otherwise.
+ */
+inline static bool_t _stack_trace_is_text(const uintptr_t address);
+
+/**
+ * @brief Returns the kernel symbol table.
+ *
+ * @return The symbol table, NULL if it is missing or malformed.
+ */
+inline static const stack_trace_symtab_t* _stack_trace_get_symtab(void);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static bool_t _stack_trace_is_text(const uintptr_t address)
+{
+    return (address >= (uintptr_t)_START_TEXT_ADDR &&
+            address < (uintptr_t)_END_TEXT_ADDR);
+}
+
+inline static const stack_trace_symtab_t* _stack_trace_get_symtab(void)
+{
+    const stack_trace_symtab_t* symtab;
+    size_t                      size;
+
+    symtab = (const stack_trace_symtab_t*)_START_KERNEL_SYMTAB_ADDR;
+    size   = _END_KERNEL_SYMTAB_ADDR - _START_KERNEL_SYMTAB_ADDR;
+
+    if(size < sizeof(stack_trace_symtab_t) ||
+       symtab->magic != STACK_TRACE_SYMTAB_MAGIC ||
+       symtab->text_base != (uintptr_t)_START_TEXT_ADDR ||
+       symtab->count == 0 ||
+       (size - sizeof(stack_trace_symtab_t)) / (2 * sizeof(uint32_t)) <
+       symtab->count ||
+       size - sizeof(stack_trace_symtab_t) - 2 * sizeof(uint32_t) *
+       symtab->count < symtab->names_size)
+    {
+        return NULL;
+    }
+
+    return symtab;
+}
+
+uint32_t stack_trace_walk(const uintptr_t frame,
+                          uintptr_t* addresses,
+                          const uint32_t max_depth)
+{
+    const uintptr_t* current;
+    uintptr_t        stack_low;
+    uintptr_t        stack_high;
+    uintptr_t        next;
+    uint32_t         depth;
+
+    if(kstack_get_bounds(frame, &stack_low, &stack_high) == FALSE)
+    {
+        stack_low  = frame & ~((uintptr_t)KERNEL_STACK_SIZE - 1);
+        stack_high = stack_low + KERNEL_STACK_SIZE;
+    }
+
+    depth   = 0;
+    current = (const uintptr_t*)frame;
+    while(depth < max_depth &&
+          ((uintptr_t)current & (sizeof(uintptr_t) - 1)) == 0 &&
+          (uintptr_t)current >= stack_low &&
+          (uintptr_t)(current + 2) <= stack_high)
+    {
+        /* The saved frame pointer is followed by the return address */
+        if(_stack_trace_is_text(current[1]) == FALSE)
+        {
+            break;
+        }
+        addresses[depth++] = current[1];
+
+        next = current[0];
+        if(next <= (uintptr_t)current)
+        {
+            break;
+        }
+        current = (const uintptr_t*)next;
+    }
+
+    return depth;
+}
+
+__attribute__((noinline))
+uint32_t stack_trace_walk_current(uintptr_t* addresses,
+                                  const uint32_t max_depth)
+{
+    return stack_trace_walk((uintptr_t)__builtin_frame_address(0), addresses,
+                            max_depth);
+}
+
+const char* stack_trace_lookup(const uintptr_t address, uintptr_t* offset)
+{
+    const stack_trace_symtab_t* symtab;
+    const uint32_t*             symbols;
+    const uint32_t*             names;
+    const char*                 strings;
+    uintptr_t                   text_offset;
+    uint32_t                    low;
+    uint32_t                    high;
+    uint32_t                    middle;
+
+    symtab = _stack_trace_get_symtab();
+    if(symtab == NULL || _stack_trace_is_text(address) == FALSE)
+    {
+        return NULL;
+    }
+
+    symbols     = (const uint32_t*)(symtab + 1);
+    names       = symbols + symtab->count;
+    strings     = (const char*)(names + symtab->count);
+    text_offset = address - (uintptr_t)_START_TEXT_ADDR;
+
+    /* Find the last symbol starting at or before the address */
+    if(text_offset < symbols[0])
+    {
+        return NULL;
+    }
+    low  = 0;
+    high = symtab->count;
+    while(high - low > 1)
+    {
+        middle = low + (high - low) / 2;
+        if(symbols[middle] <= text_offset)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    if(names[low] >= symtab->names_size)
+    {
+        return NULL;
+    }
+
+    if(offset != NULL)
+    {
+        *offset = text_offset - symbols[low];
+    }
+
+    return strings + names[low];
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,325 @@
+/*******************************************************************************
+ * @file syscall.c
+ *
+ * @see syscall.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's system calls dispatcher.
+ *
+ * @details Kernel's system calls dispatcher. The system calls table is read
+ * without lock by the dispatcher, the handlers are installed and removed with
+ * atomic operations.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* Memory manipulation */
+#include <scheduler.h>      /* Kernel scheduler */
+#include <panic.h>          /* Kernel panic */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <syscall.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "SYSCALL"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Assert macro used by the system calls dispatcher to ensure
+ * correctness of execution.
+ *
+ * @details Assert macro used by the system calls dispatcher to ensure
+ * correctness of execution. Due to the critical nature of the dispatcher, any
+ * error generates a kernel panic.
+ *
+ * @param[in] COND The Assertion condition.
+ * @param[in] MSG The message to print in case of error.
+ * @param[in] ERROR The error code.
+ */
+#define SYSCALL_ASSERT(COND, MSG, ERROR) {                  \
+    if((COND) == FALSE)                                     \
+    {                                                       \
+        PANIC(ERROR, MODULE_NAME, MSG, TRUE);               \
+    }                                                       \
+}
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief System calls table, indexed by the system calls identifiers. */
+static syscall_handler_t syscall_table[SYSCALL_TABLE_SIZE];
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Tells if a buffer lies in the user address space.
+ *
+ * @param[in] address The user address of the buffer.
+ * @param[in] size The size of the buffer in bytes.
+ *
+ * @return TRUE if the whole buffer lies in the user address space, FALSE
+ * otherwise.
+ */
+inline static bool_t _syscall_is_user_buffer(const uintptr_t address,
+                                             const size_t size);
+
+/**
+ * @brief SYSCALL_YIELD handler.
+ *
+ * @param[in] arg0 Unused.
+ * @param[in] arg1 Unused.
+ * @param[in] arg2 Unused.
+ * @param[in] arg3 Unused.
+ * @param[in] arg4 Unused.
+ *
+ * @return OS_NO_ERR.
+ */
+static OS_RETURN_E _syscall_yield(const uintptr_t arg0,
+                                  const uintptr_t arg1,
+                                  const uintptr_t arg2,
+                                  const uintptr_t arg3,
+                                  const uintptr_t arg4);
+
+/**
+ * @brief SYSCALL_SLEEP handler.
+ *
+ * @param[in] arg0 The low part of the time to sleep in nanoseconds.
+ * @param[in] arg1 The high part of the time to sleep in nanoseconds, ignored
+ * when the registers hold 64 bits.
+ * @param[in] arg2 Unused.
+ * @param[in] arg3 Unused.
+ * @param[in] arg4 Unused.
+ *
+ * @return The scheduler_sleep return value.
+ */
+static OS_RETURN_E _syscall_sleep(const uintptr_t arg0,
+                                  const uintptr_t arg1,
+                                  const uintptr_t arg2,
+                                  const uintptr_t arg3,
+                                  const uintptr_t arg4);
+
+/**
+ * @brief SYSCALL_GET_TID handler.
+ *
+ * @param[out] arg0 The user address of the int32_t receiving the identifier.
+ * @param[in] arg1 Unused.
+ * @param[in] arg2 Unused.
+ * @param[in] arg3 Unused.
+ * @param[in] arg4 Unused.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the buffer is not in the user
+ *   address space.
+ */
+static OS_RETURN_E _syscall_get_tid(const uintptr_t arg0,
+                                    const uintptr_t arg1,
+                                    const uintptr_t arg2,
+                                    const uintptr_t arg3,
+                                    const uintptr_t arg4);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static bool_t _syscall_is_user_buffer(const uintptr_t address,
+                                             const size_t size)
+{
+    return (address >= KERNEL_USER_SPACE_START &&
+            address < KERNEL_USER_SPACE_END &&
+            size <= KERNEL_USER_SPACE_END - address);
+}
+
+static OS_RETURN_E _syscall_yield(const uintptr_t arg0,
+                                  const uintptr_t arg1,
+                                  const uintptr_t arg2,
+                                  const uintptr_t arg3,
+                                  const uintptr_t arg4)
+{
+    (void)arg0;
+    (void)arg1;
+    (void)arg2;
+    (void)arg3;
+    (void)arg4;
+
+    scheduler_schedule();
+
+    return OS_NO_ERR;
+}
+
+static OS_RETURN_E _syscall_sleep(const uintptr_t arg0,
+                                  const uintptr_t arg1,
+                                  const uintptr_t arg2,
+                                  const uintptr_t arg3,
+                                  const uintptr_t arg4)
+{
+    uint64_t time_ns;
+
+    (void)arg2;
+    (void)arg3;
+    (void)arg4;
+
+    if(sizeof(uintptr_t) < sizeof(uint64_t))
+    {
+        time_ns = ((uint64_t)arg1 << 32) | (uint32_t)arg0;
+    }
+    else
+    {
+        (void)arg1;
+        time_ns = arg0;
+    }
+
+    return scheduler_sleep(time_ns);
+}
+
+static OS_RETURN_E _syscall_get_tid(const uintptr_t arg0,
+                                    const uintptr_t arg1,
+                                    const uintptr_t arg2,
+                                    const uintptr_t arg3,
+                                    const uintptr_t arg4)
+{
+    (void)arg1;
+    (void)arg2;
+    (void)arg3;
+    (void)arg4;
+
+    if(_syscall_is_user_buffer(arg0, sizeof(int32_t)) == FALSE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    *(int32_t*)arg0 = scheduler_get_current_thread()->tid;
+
+    return OS_NO_ERR;
+}
+
+void syscall_init(void)
+{
+    OS_RETURN_E err;
+
+    memset(syscall_table, 0, sizeof(syscall_table));
+
+    err = syscall_register(SYSCALL_YIELD, _syscall_yield);
+    SYSCALL_ASSERT(err == OS_NO_ERR, "Could not register the yield syscall",
+                   err);
+    err = syscall_register(SYSCALL_SLEEP, _syscall_sleep);
+    SYSCALL_ASSERT(err == OS_NO_ERR, "Could not register the sleep syscall",
+                   err);
+    err = syscall_register(SYSCALL_GET_TID, _syscall_get_tid);
+    SYSCALL_ASSERT(err == OS_NO_ERR, "Could not register the get TID syscall",
+                   err);
+
+    KERNEL_SUCCESS("System calls initialized\n");
+}
+
+OS_RETURN_E syscall_register(const uint32_t syscall_id,
+                             syscall_handler_t handler)
+{
+    syscall_handler_t expected;
+
+    if(handler == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(syscall_id >= SYSCALL_TABLE_SIZE)
+    {
+        return OS_ERR_NO_SUCH_SYSCALL;
+    }
+
+    expected = NULL;
+    if(__atomic_compare_exchange_n(&syscall_table[syscall_id], &expected,
+                                   handler, FALSE, __ATOMIC_RELEASE,
+                                   __ATOMIC_RELAXED) == FALSE)
+    {
+        return OS_ERR_SYSCALL_ALREADY_REGISTERED;
+    }
+
+    KERNEL_DEBUG(SYSCALL_DEBUG_ENABLED, MODULE_NAME,
+                 "Registered syscall %u handler 0x%p", syscall_id, handler);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E syscall_remove(const uint32_t syscall_id)
+{
+    if(syscall_id >= SYSCALL_TABLE_SIZE ||
+       __atomic_exchange_n(&syscall_table[syscall_id], NULL,
+                           __ATOMIC_ACQ_REL) == NULL)
+    {
+        return OS_ERR_NO_SUCH_SYSCALL;
+    }
+
+    KERNEL_DEBUG(SYSCALL_DEBUG_ENABLED, MODULE_NAME,
+                 "Removed syscall %u handler", syscall_id);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E syscall_dispatch(const uintptr_t arg0,
+                             const uintptr_t arg1,
+                             const uintptr_t arg2,
+                             const uintptr_t arg3,
+                             const uintptr_t arg4,
+                             const uintptr_t syscall_id)
+{
+    syscall_handler_t handler;
+
+    if(syscall_id >= SYSCALL_TABLE_SIZE)
+    {
+        return OS_ERR_NO_SUCH_SYSCALL;
+    }
+
+    handler = __atomic_load_n(&syscall_table[syscall_id], __ATOMIC_ACQUIRE);
+    if(handler == NULL)
+    {
+        return OS_ERR_NO_SUCH_SYSCALL;
+    }
+
+    KERNEL_DEBUG(SYSCALL_DEBUG_ENABLED, MODULE_NAME,
+                 "Thread %d syscall %u", scheduler_get_current_thread()->tid,
+                 (uint32_t)syscall_id);
+
+    return handler(arg0, arg1, arg2, arg3, arg4);
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,448 @@
+/*******************************************************************************
+ * @file time_mgt.c
+ *
+ * @see time_mgt.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's time management.
+ *
+ * @details Kernel's time management. The time is computed from the clock
+ * source counter and the conversion parameters of the clock source, read
+ * under a sequence lock. The parameters only change when the clock source is
+ * replaced, the time is then rebased so that it stays continuous. The main
+ * timer driver provides a per-CPU one-shot deadline, shared by the kernel
+ * deadlines: the timer is armed on the closest one and the interrupt only
+ * calls the handlers of the deadlines that passed. There is no periodic
+ * tick: the timer interrupt is only raised when a deadline set by the kernel
+ * is reached.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>             /* Generic int types */
+#include <stddef.h>             /* Standard definitions */
+#include <interrupts.h>         /* Interrupts management */
+#include <critical.h>           /* Critical sections */
+#include <percpu.h>             /* Per-CPU deadlines */
+#include <cpu.h>                /* CPU cache line size */
+#include <kernel_output.h>      /* Kernel output methods */
+#include <kerror.h>             /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <time_mgt.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "TIME"
+
+/** @brief Maximal shift of the clock source conversion factor. */
+#define TIME_MAX_SHIFT 32
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Clock source conversion parameters. */
+typedef struct
+{
+    /** @brief Clock source counter read function. */
+    uint64_t (*read)(void);
+
+    /** @brief Counter value when the clock source was set. */
+    uint64_t base_cycles;
+
+    /** @brief Time in nanoseconds when the clock source was set. */
+    uint64_t base_ns;
+
+    /** @brief Counter to nanoseconds fixed point factor. */
+    uint32_t mult;
+
+    /** @brief Counter to nanoseconds fixed point shift. */
+    uint32_t shift;
+} time_clock_t;
+
+/** @brief Per-CPU deadlines, only accessed by their CPU. */
+typedef struct
+{
+    /** @brief Deadlines in nanoseconds, 0 when not set. */
+    uint64_t deadlines[TIME_DEADLINE_COUNT];
+
+    /** @brief Deadline the timer is armed on, 0 when disarmed. */
+    uint64_t armed;
+} __attribute__((aligned(CPU_CACHE_LINE_SIZE))) time_cpu_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The kernel's main timer driver. */
+static kernel_timer_t main_timer_driver;
+
+/** @brief Tells if the main timer driver is set. */
+static bool_t main_timer_set = FALSE;
+
+/** @brief Handlers called when a CPU reaches one of its deadlines. */
+static custom_handler_t deadline_handlers[TIME_DEADLINE_COUNT];
+
+/** @brief Per-CPU deadlines. */
+static PERCPU_DEFINE(time_cpu_t, time_cpu);
+
+/** @brief Clock source conversion parameters, protected by time_clock_lock. */
+static time_clock_t time_clock = {
+    .read        = NULL,
+    .base_cycles = 0,
+    .base_ns     = 0,
+    .mult        = 0,
+    .shift       = 0
+};
+
+/** @brief Lock protecting the clock source conversion parameters. */
+static kernel_seqlock_t time_clock_lock = KERNEL_SEQLOCK_INIT_VALUE;
+
+/** @brief Current clock source name. */
+static const char* time_clock_name = "none";
+
+/** @brief Maximal time between two reads of the current clock source. */
+static uint64_t time_clock_max_idle_ns = 0;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Converts a clock source counter delta to nanoseconds.
+ *
+ * @details Converts a clock source counter delta to nanoseconds. The delta is
+ * split around the shift so that the products fit in 64 bits, the factor
+ * holds on 32 bits and the shift is at most 32.
+ *
+ * @param[in] cycles The counter delta.
+ * @param[in] mult The fixed point conversion factor.
+ * @param[in] shift The fixed point conversion shift.
+ *
+ * @return The delta in nanoseconds.
+ */
+inline static uint64_t _time_cycles_to_ns(const uint64_t cycles,
+                                          const uint32_t mult,
+                                          const uint32_t shift);
+
+/**
+ * @brief Returns the time given by the clock source conversion parameters.
+ *
+ * @details Returns the time given by the clock source conversion parameters.
+ * The caller must either hold the clock lock or check the read with the
+ * sequence number.
+ *
+ * @return The time in nanoseconds, 0 if no clock source is set.
+ */
+inline static uint64_t _time_read_clock(void);
+
+/**
+ * @brief Arms the calling CPU timer on its closest deadline.
+ *
+ * @details Arms the calling CPU timer on its closest deadline, bounded by the
+ * maximal idle time of the clock source. The timer is not programmed again
+ * when it is already armed on this deadline. This function must be called
+ * with interrupts disabled.
+ *
+ * @param[in-out] cpu The calling CPU deadlines.
+ */
+static void _time_arm_timer(time_cpu_t* cpu);
+
+/**
+ * @brief Main timer interrupt handler.
+ *
+ * @details Main timer interrupt handler. Acknowledges the timer interrupt and
+ * calls the deadline handler, if any.
+ *
+ * @param[in] curr_thread The interrupted thread.
+ */
+static void _time_main_timer_handler(kernel_thread_t* curr_thread);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static uint64_t _time_cycles_to_ns(const uint64_t cycles,
+                                          const uint32_t mult,
+                                          const uint32_t shift)
+{
+    return (cycles >> shift) * mult +
+           (((cycles & ((1ULL << shift) - 1)) * mult) >> shift);
+}
+
+inline static uint64_t _time_read_clock(void)
+{
+    if(time_clock.read == NULL)
+    {
+        return 0;
+    }
+
+    return time_clock.base_ns +
+           _time_cycles_to_ns(time_clock.read() - time_clock.base_cycles,
+                              time_clock.mult, time_clock.shift);
+}
+
+static void _time_arm_timer(time_cpu_t* cpu)
+{
+    uint64_t deadline;
+    uint64_t max_deadline;
+    uint32_t i;
+
+    deadline = 0;
+    for(i = 0; i < TIME_DEADLINE_COUNT; ++i)
+    {
+        if(cpu->deadlines[i] != 0 &&
+           (deadline == 0 || cpu->deadlines[i] < deadline))
+        {
+            deadline = cpu->deadlines[i];
+        }
+    }
+
+    /* The clock source must be read before its counter is lost */
+    if(time_clock_max_idle_ns != 0)
+    {
+        max_deadline = time_get_ns() + time_clock_max_idle_ns;
+        if(deadline == 0 || deadline > max_deadline)
+        {
+            deadline = max_deadline;
+        }
+    }
+
+    if(deadline != cpu->armed)
+    {
+        cpu->armed = deadline;
+        main_timer_driver.set_deadline(deadline);
+    }
+}
+
+static void _time_main_timer_handler(kernel_thread_t* curr_thread)
+{
+    time_cpu_t* cpu;
+    uint64_t    now;
+    uint32_t    expired;
+    uint32_t    i;
+
+    main_timer_driver.ack_interrupt();
+
+    /* The one-shot timer fired, it is not armed anymore */
+    cpu        = PERCPU_THIS_PTR(time_cpu);
+    cpu->armed = 0;
+
+    /* The timer can fire early, only the passed deadlines are handled */
+    now     = time_get_ns();
+    expired = 0;
+    for(i = 0; i < TIME_DEADLINE_COUNT; ++i)
+    {
+        if(cpu->deadlines[i] != 0 && cpu->deadlines[i] <= now)
+        {
+            cpu->deadlines[i] = 0;
+            expired |= 1U << i;
+        }
+    }
+
+    _time_arm_timer(cpu);
+
+    /* The handlers can set their next deadline */
+    for(i = 0; i < TIME_DEADLINE_COUNT; ++i)
+    {
+        if((expired & (1U << i)) != 0 && deadline_handlers[i] != NULL)
+        {
+            deadline_handlers[i](curr_thread);
+        }
+    }
+}
+
+OS_RETURN_E time_init(const kernel_timer_t* main_timer)
+{
+    OS_RETURN_E err;
+    uint32_t    int_state;
+
+    if(main_timer == NULL ||
+       main_timer->set_deadline == NULL ||
+       main_timer->ack_interrupt == NULL ||
+       main_timer->get_interrupt_line == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    main_timer_driver = *main_timer;
+
+    err = kernel_interrupt_register_int_handler(
+                                        main_timer->get_interrupt_line(),
+                                        _time_main_timer_handler);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    main_timer_set = TRUE;
+
+    /* Start reading the clock source periodically, if it needs it */
+    if(time_clock_max_idle_ns != 0)
+    {
+        ENTER_CRITICAL(int_state);
+        _time_arm_timer(PERCPU_THIS_PTR(time_cpu));
+        EXIT_CRITICAL(int_state);
+    }
+
+    KERNEL_DEBUG(TIME_MGT_DEBUG_ENABLED, MODULE_NAME,
+                 "Main timer set on line %d",
+                 main_timer->get_interrupt_line());
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E time_set_clocksource(const kernel_clocksource_t* clocksource)
+{
+    uint64_t mult;
+    uint32_t shift;
+    uint32_t int_state;
+
+    if(clocksource == NULL || clocksource->read == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(clocksource->frequency == 0 ||
+       clocksource->frequency > (TIME_NS_PER_SECOND << TIME_MAX_SHIFT))
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    /* Use the largest shift that keeps the factor on 32 bits */
+    shift = TIME_MAX_SHIFT + 1;
+    do
+    {
+        --shift;
+        mult = ((TIME_NS_PER_SECOND << shift) + clocksource->frequency / 2) /
+               clocksource->frequency;
+    } while(mult > UINT32_MAX && shift > 0);
+
+    /* Rebase the time on the new clock source */
+    ENTER_CRITICAL(int_state);
+    KERNEL_SEQLOCK_WRITE_LOCK(time_clock_lock);
+
+    time_clock.base_ns     = _time_read_clock();
+    time_clock.read        = clocksource->read;
+    time_clock.base_cycles = clocksource->read();
+    time_clock.mult        = (uint32_t)mult;
+    time_clock.shift       = shift;
+    time_clock_name        = clocksource->name;
+    time_clock_max_idle_ns = clocksource->max_idle_ns;
+
+    KERNEL_SEQLOCK_WRITE_UNLOCK(time_clock_lock);
+    EXIT_CRITICAL(int_state);
+
+    KERNEL_SUCCESS("Clock source %s at %uKHz, mult %u shift %u\n",
+                   clocksource->name,
+                   (uint32_t)(clocksource->frequency / 1000),
+                   (uint32_t)mult, shift);
+
+    return OS_NO_ERR;
+}
+
+const char* time_get_clocksource_name(void)
+{
+    return time_clock_name;
+}
+
+uint64_t time_get_ns(void)
+{
+    uint64_t time_ns;
+    uint32_t sequence;
+
+    do
+    {
+        sequence = KERNEL_SEQLOCK_READ_BEGIN(time_clock_lock);
+        time_ns  = _time_read_clock();
+    } while(KERNEL_SEQLOCK_READ_RETRY(time_clock_lock, sequence) == TRUE);
+
+    return time_ns;
+}
+
+OS_RETURN_E time_register_deadline_handler(const TIME_DEADLINE_E deadline,
+                                           custom_handler_t handler)
+{
+    uint32_t int_state;
+
+    if(handler == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(deadline >= TIME_DEADLINE_COUNT)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    if(main_timer_set == FALSE)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    ENTER_CRITICAL(int_state);
+    deadline_handlers[deadline] = handler;
+    EXIT_CRITICAL(int_state);
+
+    return OS_NO_ERR;
+}
+
+uint64_t time_get_current_uptime_nano(void)
+{
+    return time_get_ns();
+}
+
+void time_set_deadline(const TIME_DEADLINE_E deadline,
+                       const uint64_t deadline_ns)
+{
+    time_cpu_t* cpu;
+
+    if(main_timer_set == FALSE || deadline >= TIME_DEADLINE_COUNT)
+    {
+        return;
+    }
+
+    cpu                      = PERCPU_THIS_PTR(time_cpu);
+    cpu->deadlines[deadline] = deadline_ns;
+    _time_arm_timer(cpu);
+}
+
+uint64_t time_get_next_deadline(void)
+{
+    if(main_timer_set == FALSE)
+    {
+        return 0;
+    }
+
+    return PERCPU_THIS_PTR(time_cpu)->armed;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
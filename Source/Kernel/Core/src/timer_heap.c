@@ -0,0 +1,282 @@
+/*******************************************************************************
+ * @file timer_heap.c
+ *
+ * @see timer_heap.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Threads timer heap.
+ *
+ * @details Threads timer heap. The timer heap is a binary min-heap of threads
+ * keyed on their wakeup time. The earliest deadline is read in constant time,
+ * which is what a tickless timer needs to program its next interrupt, and the
+ * threads due by a given time are extracted in logarithmic time each. Each
+ * thread stores its position in the heap, which allows removing a thread
+ * before its deadline, for instance when a timed wait completes early.
+ * The timer heap is not thread safe, the caller is responsible for the
+ * locking.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>             /* Generic int types */
+#include <stddef.h>             /* Standard definitions */
+#include <ctrl_block.h>         /* Threads control blocks */
+#include <kerror.h>             /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <timer_heap.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Places a thread at a position of the heap.
+ *
+ * @details Places a thread at a position of the heap and updates the thread
+ * heap index.
+ *
+ * @param[in, out] heap The timer heap.
+ * @param[in] index The position to place the thread at.
+ * @param[in, out] thread The thread to place.
+ */
+inline static void _timer_heap_set(timer_heap_t* heap,
+                                   const uint32_t index,
+                                   kernel_thread_t* thread);
+
+/**
+ * @brief Moves a thread up the heap until its parent is due earlier.
+ *
+ * @param[in, out] heap The timer heap.
+ * @param[in] index The position of the thread to move.
+ */
+static void _timer_heap_sift_up(timer_heap_t* heap, uint32_t index);
+
+/**
+ * @brief Moves a thread down the heap until its children are due later.
+ *
+ * @param[in, out] heap The timer heap.
+ * @param[in] index The position of the thread to move.
+ */
+static void _timer_heap_sift_down(timer_heap_t* heap, uint32_t index);
+
+/**
+ * @brief Removes the thread at a position of the heap.
+ *
+ * @details Removes the thread at a position of the heap and restores the heap
+ * property. The position must be valid.
+ *
+ * @param[in, out] heap The timer heap.
+ * @param[in] index The position of the thread to remove.
+ */
+static void _timer_heap_remove_at(timer_heap_t* heap, const uint32_t index);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static void _timer_heap_set(timer_heap_t* heap,
+                                   const uint32_t index,
+                                   kernel_thread_t* thread)
+{
+    heap->threads[index]     = thread;
+    thread->timer_heap_index = index;
+}
+
+static void _timer_heap_sift_up(timer_heap_t* heap, uint32_t index)
+{
+    kernel_thread_t* thread;
+    kernel_thread_t* parent;
+
+    thread = heap->threads[index];
+    while(index > 1)
+    {
+        parent = heap->threads[index / 2];
+        if(parent->wakeup_time <= thread->wakeup_time)
+        {
+            break;
+        }
+        _timer_heap_set(heap, index, parent);
+        index /= 2;
+    }
+    _timer_heap_set(heap, index, thread);
+}
+
+static void _timer_heap_sift_down(timer_heap_t* heap, uint32_t index)
+{
+    kernel_thread_t* thread;
+    uint32_t         child;
+
+    thread = heap->threads[index];
+    while(index * 2 <= heap->size)
+    {
+        /* Select the earliest child */
+        child = index * 2;
+        if(child < heap->size &&
+           heap->threads[child + 1]->wakeup_time <
+           heap->threads[child]->wakeup_time)
+        {
+            ++child;
+        }
+
+        if(thread->wakeup_time <= heap->threads[child]->wakeup_time)
+        {
+            break;
+        }
+        _timer_heap_set(heap, index, heap->threads[child]);
+        index = child;
+    }
+    _timer_heap_set(heap, index, thread);
+}
+
+static void _timer_heap_remove_at(timer_heap_t* heap, const uint32_t index)
+{
+    kernel_thread_t* last;
+
+    heap->threads[index]->timer_heap_index = TIMER_HEAP_NO_INDEX;
+
+    last = heap->threads[heap->size];
+    heap->threads[heap->size] = NULL;
+    --heap->size;
+
+    if(index <= heap->size)
+    {
+        /* The last thread fills the hole, it can go either way */
+        _timer_heap_set(heap, index, last);
+        if(index > 1 &&
+           last->wakeup_time < heap->threads[index / 2]->wakeup_time)
+        {
+            _timer_heap_sift_up(heap, index);
+        }
+        else
+        {
+            _timer_heap_sift_down(heap, index);
+        }
+    }
+}
+
+void timer_heap_init(timer_heap_t* heap)
+{
+    uint32_t i;
+
+    for(i = 0; i <= TIMER_HEAP_CAPACITY; ++i)
+    {
+        heap->threads[i] = NULL;
+    }
+    heap->size = 0;
+}
+
+OS_RETURN_E timer_heap_insert(timer_heap_t* heap, kernel_thread_t* thread)
+{
+    if(heap == NULL || thread == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(thread->timer_heap_index != TIMER_HEAP_NO_INDEX)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    if(heap->size == TIMER_HEAP_CAPACITY)
+    {
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+
+    ++heap->size;
+    _timer_heap_set(heap, heap->size, thread);
+    _timer_heap_sift_up(heap, heap->size);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E timer_heap_remove(timer_heap_t* heap, kernel_thread_t* thread)
+{
+    if(heap == NULL || thread == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(thread->timer_heap_index == TIMER_HEAP_NO_INDEX ||
+       thread->timer_heap_index > heap->size ||
+       heap->threads[thread->timer_heap_index] != thread)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    _timer_heap_remove_at(heap, thread->timer_heap_index);
+
+    return OS_NO_ERR;
+}
+
+kernel_thread_t* timer_heap_peek(const timer_heap_t* heap)
+{
+    if(heap->size == 0)
+    {
+        return NULL;
+    }
+
+    return heap->threads[1];
+}
+
+kernel_thread_t* timer_heap_pop_expired(timer_heap_t* heap,
+                                        const uint64_t now)
+{
+    kernel_thread_t* thread;
+
+    if(heap->size == 0 || heap->threads[1]->wakeup_time > now)
+    {
+        return NULL;
+    }
+
+    thread = heap->threads[1];
+    _timer_heap_remove_at(heap, 1);
+
+    return thread;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
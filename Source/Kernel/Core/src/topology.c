@@ -0,0 +1,234 @@
+/*******************************************************************************
+ * @file topology.c
+ *
+ * @see topology.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's CPU and memory topology.
+ *
+ * @details Kernel's CPU and memory topology. The node of each hardware
+ * identifier is kept in a table indexed by the identifier, a CPU copies its
+ * node in the kernel CPU table when it is registered. The distances left
+ * unset by the firmware are TOPOLOGY_LOCAL_DISTANCE on the diagonal and
+ * TOPOLOGY_REMOTE_DISTANCE elsewhere.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <topology.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "TOPOLOGY"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Firmware proximity domain of each node. */
+static uint32_t topology_domains[MAX_NUMA_NODE_COUNT];
+
+/** @brief Number of nodes declared by the firmware. */
+static uint32_t topology_node_count = 0;
+
+/** @brief Distances between the nodes, 0 when not set. */
+static uint8_t topology_distances[MAX_NUMA_NODE_COUNT][MAX_NUMA_NODE_COUNT];
+
+/** @brief Node of each CPU hardware identifier. */
+static uint8_t topology_hw_nodes[TOPOLOGY_MAX_HW_ID];
+
+/** @brief Tells if a CPU hardware identifier is present in the machine. */
+static bool_t topology_hw_present[TOPOLOGY_MAX_HW_ID];
+
+/** @brief Number of CPUs declared by the firmware. */
+static uint32_t topology_cpu_count = 0;
+
+/** @brief Node of each kernel CPU. */
+static uint32_t topology_cpu_nodes[MAX_CPU_COUNT];
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+OS_RETURN_E topology_add_node(const uint32_t domain, uint32_t* node)
+{
+    uint32_t i;
+
+    if(node == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    for(i = 0; i < topology_node_count; ++i)
+    {
+        if(topology_domains[i] == domain)
+        {
+            *node = i;
+            return OS_NO_ERR;
+        }
+    }
+
+    if(topology_node_count == MAX_NUMA_NODE_COUNT)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    topology_domains[topology_node_count] = domain;
+    *node = topology_node_count++;
+
+    KERNEL_DEBUG(TOPOLOGY_DEBUG_ENABLED, MODULE_NAME,
+                 "Node %u is proximity domain %u", *node, domain);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E topology_add_cpu(const uint32_t hw_id)
+{
+    if(hw_id >= TOPOLOGY_MAX_HW_ID)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    if(topology_hw_present[hw_id] == FALSE)
+    {
+        topology_hw_present[hw_id] = TRUE;
+        ++topology_cpu_count;
+    }
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E topology_set_cpu_node(const uint32_t hw_id, const uint32_t node)
+{
+    if(hw_id >= TOPOLOGY_MAX_HW_ID || node >= topology_node_count)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    topology_hw_nodes[hw_id] = (uint8_t)node;
+
+    KERNEL_DEBUG(TOPOLOGY_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU hardware ID %u on node %u", hw_id, node);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E topology_set_distance(const uint32_t from,
+                                  const uint32_t to,
+                                  const uint8_t distance)
+{
+    if(from >= topology_node_count || to >= topology_node_count)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    topology_distances[from][to] = distance;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E topology_register_cpu(const uint32_t cpu_id, const uint32_t hw_id)
+{
+    if(cpu_id >= MAX_CPU_COUNT || hw_id >= TOPOLOGY_MAX_HW_ID)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    topology_cpu_nodes[cpu_id] = topology_hw_nodes[hw_id];
+
+    KERNEL_DEBUG(TOPOLOGY_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %u (hardware ID %u) on node %u",
+                 cpu_id, hw_id, topology_cpu_nodes[cpu_id]);
+
+    return OS_NO_ERR;
+}
+
+uint32_t topology_get_cpu_count(void)
+{
+    return topology_cpu_count;
+}
+
+uint32_t topology_get_node_count(void)
+{
+    return topology_node_count == 0 ? 1 : topology_node_count;
+}
+
+uint32_t topology_get_cpu_node(const uint32_t cpu_id)
+{
+    if(cpu_id >= MAX_CPU_COUNT)
+    {
+        return 0;
+    }
+
+    return topology_cpu_nodes[cpu_id];
+}
+
+uint32_t topology_get_distance(const uint32_t from, const uint32_t to)
+{
+    if(from == to)
+    {
+        return TOPOLOGY_LOCAL_DISTANCE;
+    }
+    if(from >= topology_node_count || to >= topology_node_count ||
+       topology_distances[from][to] == 0)
+    {
+        return TOPOLOGY_REMOTE_DISTANCE;
+    }
+
+    return topology_distances[from][to];
+}
+
+uint32_t topology_get_cpu_distance(const uint32_t cpu_a, const uint32_t cpu_b)
+{
+    return topology_get_distance(topology_get_cpu_node(cpu_a),
+                                 topology_get_cpu_node(cpu_b));
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,177 @@
+/*******************************************************************************
+ * @file trace_drain.c
+ *
+ * @see trace_drain.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's trace drain.
+ *
+ * @details Kernel's trace drain. The trace drain streams the trace packets of
+ * each CPU to a trace output driver. Packets are sent by a low priority kernel
+ * thread, the CPUs keep writing their events in their other packet while a full
+ * packet is being sent. The packets are sent back to back, each one starts
+ * with its CTF packet header.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TRACING_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <scheduler.h>      /* Kernel scheduler */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+#include <tracing.h>        /* Kernel tracing */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <trace_drain.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "TRACE DRAIN"
+
+/** @brief Trace drain thread name. */
+#define TRACE_DRAIN_THREAD_NAME "trace_drain"
+
+/** @brief Trace drain thread priority, only above the idle threads. */
+#define TRACE_DRAIN_THREAD_PRIORITY (KERNEL_LOWEST_PRIORITY - 1)
+
+/** @brief Period of the trace drain thread in nanoseconds. */
+#define TRACE_DRAIN_PERIOD_NS 50000000ULL
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The trace output driver. */
+static kernel_trace_output_t output_driver;
+
+/** @brief The trace drain thread. */
+static kernel_thread_t* drain_thread = NULL;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Trace drain thread routine.
+ *
+ * @details Trace drain thread routine. Sends the full packets of each CPU to
+ * the trace output then waits for the next period. Partially filled packets
+ * are sent when a CPU has no full packet, so the events reach the output even
+ * when the CPUs trace at a low rate.
+ *
+ * @param[in] args Unused.
+ *
+ * @return The function never returns.
+ */
+static void* _trace_drain_routine(void* args);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void* _trace_drain_routine(void* args)
+{
+    const uint32_t* packet;
+    uint32_t        size;
+    uint32_t        i;
+
+    (void)args;
+
+    while(TRUE)
+    {
+        for(i = 0; i < MAX_CPU_COUNT; ++i)
+        {
+            /* Send the full packet, or close the active one */
+            if(kernel_trace_get_packet(i, TRUE, &packet, &size) == TRUE)
+            {
+                output_driver.write(packet, size);
+                kernel_trace_release_packet(i);
+            }
+        }
+
+        /* Without timer, only yield to the other threads */
+        if(scheduler_sleep(TRACE_DRAIN_PERIOD_NS) != OS_NO_ERR)
+        {
+            scheduler_schedule();
+        }
+    }
+
+    return NULL;
+}
+
+OS_RETURN_E trace_drain_init(const kernel_trace_output_t* output)
+{
+    OS_RETURN_E err;
+
+    if(output == NULL || output->write == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(drain_thread != NULL)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    output_driver = *output;
+    kernel_trace_set_drain_mode(TRUE);
+
+    err = scheduler_create_kernel_thread(&drain_thread,
+                                         TRACE_DRAIN_THREAD_PRIORITY,
+                                         TRACE_DRAIN_THREAD_NAME,
+                                         _trace_drain_routine,
+                                         NULL);
+    if(err != OS_NO_ERR)
+    {
+        kernel_trace_set_drain_mode(FALSE);
+        drain_thread = NULL;
+        return err;
+    }
+
+    KERNEL_DEBUG(TRACE_DRAIN_DEBUG_ENABLED, MODULE_NAME,
+                 "Trace drain initialized");
+
+    return OS_NO_ERR;
+}
+
+#endif /* #ifdef _TRACING_ENABLED */
+
+/************************************ EOF *************************************/
\ No newline at end of file
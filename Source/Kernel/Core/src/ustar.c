@@ -0,0 +1,756 @@
+/*******************************************************************************
+ * @file ustar.c
+ *
+ * @see ustar.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's USTAR file system driver.
+ *
+ * @details Kernel's USTAR file system driver. The index is an open addressing
+ * hash table of the entries headers blocks, keyed by the FNV-1a hash of their
+ * normalized path. It holds at least twice as many slots as entries, the
+ * paths are compared in the headers only when the hashes match. The headers
+ * and data blocks are read through the block cache.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* Memory manipulation */
+#include <kheap.h>          /* Kernel heap */
+#include <blkdev.h>         /* Block devices */
+#include <bcache.h>         /* Block cache */
+#include <vfs.h>            /* Virtual file system */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <ustar.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "USTAR"
+
+/** @brief Size of the USTAR blocks in bytes. */
+#define USTAR_BLOCK_SIZE 512
+
+#if USTAR_BLOCK_SIZE != BLKDEV_BLOCK_SIZE
+#error "The USTAR blocks must be the block devices blocks"
+#endif
+
+/** @brief Magic of the USTAR headers, its NULL character included. */
+#define USTAR_MAGIC "ustar"
+
+/** @brief Size of the USTAR magic in bytes. */
+#define USTAR_MAGIC_SIZE 6
+
+/** @brief Regular file type flag. */
+#define USTAR_FLAG_FILE '0'
+
+/** @brief Old regular file type flag. */
+#define USTAR_FLAG_FILE_OLD '\0'
+
+/** @brief Directory type flag. */
+#define USTAR_FLAG_DIRECTORY '5'
+
+/** @brief FNV-1a hash offset basis. */
+#define USTAR_FNV_OFFSET 2166136261U
+
+/** @brief FNV-1a hash prime. */
+#define USTAR_FNV_PRIME 16777619U
+
+/** @brief Index slot value of the empty slots. */
+#define USTAR_SLOT_EMPTY 0xFFFFFFFF
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief USTAR header, one block. */
+typedef struct
+{
+    char name[100];
+    char mode[8];
+    char uid[8];
+    char gid[8];
+    char size[12];
+    char mtime[12];
+    char checksum[8];
+    char type;
+    char link_name[100];
+    char magic[USTAR_MAGIC_SIZE];
+    char version[2];
+    char user_name[32];
+    char group_name[32];
+    char dev_major[8];
+    char dev_minor[8];
+    char prefix[155];
+    char padding[12];
+} __attribute__((packed)) ustar_header_t;
+
+/** @brief Index slot. */
+typedef struct
+{
+    /** @brief The hash of the entry path. */
+    uint32_t hash;
+
+    /** @brief The entry header offset in blocks, USTAR_SLOT_EMPTY if the slot
+     * is not used.
+     */
+    uint32_t block;
+} ustar_slot_t;
+
+/** @brief Mounted archive. */
+typedef struct
+{
+    /** @brief The archive block device. */
+    blkdev_t* dev;
+
+    /** @brief The entries index. */
+    ustar_slot_t* index;
+
+    /** @brief Number of slots of the index, a power of 2. */
+    uint32_t index_size;
+} ustar_fs_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The USTAR file system driver. */
+static vfs_driver_t ustar_driver;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Parses an octal field of a header.
+ *
+ * @param[in] field The field characters.
+ * @param[in] size The field size in bytes.
+ * @param[out] value The buffer receiving the value.
+ *
+ * @return TRUE if the field is a valid octal number, FALSE otherwise.
+ */
+static bool_t _ustar_parse_octal(const char* field,
+                                 const size_t size,
+                                 uint64_t* value);
+
+/**
+ * @brief Validates a header.
+ *
+ * @details Checks the header magic and checksum and returns the size of its
+ * data.
+ *
+ * @param[in] header The header.
+ * @param[out] size The buffer receiving the entry data size.
+ *
+ * @return TRUE if the header is valid, FALSE otherwise.
+ */
+static bool_t _ustar_check_header(const ustar_header_t* header,
+                                  uint64_t* size);
+
+/**
+ * @brief Returns the length of a header field string.
+ *
+ * @param[in] field The field characters, NULL terminated or not.
+ * @param[in] size The field size in bytes.
+ *
+ * @return The number of characters before the first NULL character.
+ */
+inline static size_t _ustar_field_length(const char* field, const size_t size);
+
+/**
+ * @brief Returns the normalized path of a header.
+ *
+ * @details The path of a header is its prefix, a '/' and its name. The
+ * normalized path omits the leading "./" and the trailing '/'.
+ *
+ * @param[in] header The header.
+ * @param[out] prefix The buffer receiving the normalized prefix.
+ * @param[out] prefix_length The buffer receiving the prefix length.
+ * @param[out] name The buffer receiving the normalized name.
+ * @param[out] name_length The buffer receiving the name length.
+ */
+static void _ustar_header_path(const ustar_header_t* header,
+                               const char** prefix,
+                               size_t* prefix_length,
+                               const char** name,
+                               size_t* name_length);
+
+/**
+ * @brief Updates a FNV-1a hash with characters.
+ *
+ * @param[in] hash The current hash.
+ * @param[in] chars The characters.
+ * @param[in] length The number of characters.
+ *
+ * @return The updated hash.
+ */
+inline static uint32_t _ustar_hash(uint32_t hash,
+                                   const char* chars,
+                                   const size_t length);
+
+/**
+ * @brief Returns the normalized path hash of a header.
+ *
+ * @param[in] header The header.
+ *
+ * @return The path hash.
+ */
+static uint32_t _ustar_header_hash(const ustar_header_t* header);
+
+/**
+ * @brief Tells if a header has a normalized path.
+ *
+ * @param[in] header The header.
+ * @param[in] path The normalized path.
+ * @param[in] length The path length.
+ *
+ * @return TRUE if the header path is the path, FALSE otherwise.
+ */
+static bool_t _ustar_header_matches(const ustar_header_t* header,
+                                    const char* path,
+                                    const size_t length);
+
+/**
+ * @brief Scans the headers of an archive.
+ *
+ * @details Scans the headers of an archive, counting them when the index is
+ * not allocated and indexing them otherwise.
+ *
+ * @param[in, out] fs The mounted archive.
+ * @param[out] count The buffer receiving the number of entries.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _ustar_scan(ustar_fs_t* fs, uint32_t* count);
+
+/**
+ * @brief USTAR driver mount routine.
+ *
+ * @param[in] dev The block device.
+ * @param[out] fs_ctrl The buffer receiving the mounted archive.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _ustar_mount(blkdev_t* dev, void** fs_ctrl);
+
+/**
+ * @brief USTAR driver unmount routine.
+ *
+ * @param[in] fs_ctrl The mounted archive.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _ustar_unmount(void* fs_ctrl);
+
+/**
+ * @brief USTAR driver open routine.
+ *
+ * @param[in] fs_ctrl The mounted archive.
+ * @param[in] path The normalized entry path.
+ * @param[in] length The path length.
+ * @param[out] node The buffer receiving the entry node.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _ustar_open(void* fs_ctrl,
+                               const char* path,
+                               const size_t length,
+                               vfs_node_t* node);
+
+/**
+ * @brief USTAR driver read routine.
+ *
+ * @param[in] fs_ctrl The mounted archive.
+ * @param[in] node The entry node.
+ * @param[in] offset The offset in the entry data.
+ * @param[out] buffer The buffer receiving the data.
+ * @param[in] size The number of bytes to read.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _ustar_read(void* fs_ctrl,
+                               const vfs_node_t* node,
+                               const size_t offset,
+                               void* buffer,
+                               const size_t size);
+
+/**
+ * @brief Driver map routine, returns the address of a node data.
+ *
+ * @details The data of a node follows its header block, it is held in place
+ * when the device is memory backed.
+ *
+ * @param[in] fs_ctrl The mounted file system.
+ * @param[in] node The node.
+ *
+ * @return The address of the node data, NULL if the device is not memory
+ * backed.
+ */
+static const void* _ustar_map(void* fs_ctrl, const vfs_node_t* node);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static bool_t _ustar_parse_octal(const char* field,
+                                 const size_t size,
+                                 uint64_t* value)
+{
+    size_t i;
+
+    *value = 0;
+    for(i = 0; i < size && field[i] == ' '; ++i);
+    for(; i < size && field[i] >= '0' && field[i] <= '7'; ++i)
+    {
+        *value = (*value << 3) | (uint64_t)(field[i] - '0');
+    }
+
+    /* The number ends with spaces or NULL characters */
+    return (i == size || field[i] == ' ' || field[i] == '\0');
+}
+
+static bool_t _ustar_check_header(const ustar_header_t* header,
+                                  uint64_t* size)
+{
+    const uint8_t* bytes;
+    uint64_t       checksum;
+    uint64_t       sum;
+    size_t         i;
+
+    if(memcmp(header->magic, USTAR_MAGIC, USTAR_MAGIC_SIZE - 1) != 0 ||
+       _ustar_parse_octal(header->checksum, sizeof(header->checksum),
+                          &checksum) == FALSE ||
+       _ustar_parse_octal(header->size, sizeof(header->size), size) == FALSE)
+    {
+        return FALSE;
+    }
+
+    /* The checksum is computed with its field set to spaces */
+    bytes = (const uint8_t*)header;
+    sum   = ' ' * sizeof(header->checksum);
+    for(i = 0; i < sizeof(ustar_header_t); ++i)
+    {
+        if(i < offsetof(ustar_header_t, checksum) ||
+           i >= offsetof(ustar_header_t, type))
+        {
+            sum += bytes[i];
+        }
+    }
+
+    return (sum == checksum);
+}
+
+inline static size_t _ustar_field_length(const char* field, const size_t size)
+{
+    size_t length;
+
+    for(length = 0; length < size && field[length] != '\0'; ++length);
+
+    return length;
+}
+
+static void _ustar_header_path(const ustar_header_t* header,
+                               const char** prefix,
+                               size_t* prefix_length,
+                               const char** name,
+                               size_t* name_length)
+{
+    *prefix        = header->prefix;
+    *prefix_length = _ustar_field_length(header->prefix,
+                                         sizeof(header->prefix));
+    *name          = header->name;
+    *name_length   = _ustar_field_length(header->name, sizeof(header->name));
+
+    /* The leading "./" is on the first part of the path */
+    if(*prefix_length != 0)
+    {
+        if(*prefix_length >= 2 && (*prefix)[0] == '.' && (*prefix)[1] == '/')
+        {
+            *prefix        += 2;
+            *prefix_length -= 2;
+        }
+    }
+    else if(*name_length >= 2 && (*name)[0] == '.' && (*name)[1] == '/')
+    {
+        *name        += 2;
+        *name_length -= 2;
+    }
+
+    while(*name_length != 0 && (*name)[*name_length - 1] == '/')
+    {
+        --*name_length;
+    }
+}
+
+inline static uint32_t _ustar_hash(uint32_t hash,
+                                   const char* chars,
+                                   const size_t length)
+{
+    size_t i;
+
+    for(i = 0; i < length; ++i)
+    {
+        hash = (hash ^ (uint8_t)chars[i]) * USTAR_FNV_PRIME;
+    }
+
+    return hash;
+}
+
+static uint32_t _ustar_header_hash(const ustar_header_t* header)
+{
+    const char* prefix;
+    const char* name;
+    size_t      prefix_length;
+    size_t      name_length;
+    uint32_t    hash;
+
+    _ustar_header_path(header, &prefix, &prefix_length, &name, &name_length);
+
+    hash = USTAR_FNV_OFFSET;
+    if(prefix_length != 0)
+    {
+        hash = _ustar_hash(hash, prefix, prefix_length);
+        hash = _ustar_hash(hash, "/", 1);
+    }
+
+    return _ustar_hash(hash, name, name_length);
+}
+
+static bool_t _ustar_header_matches(const ustar_header_t* header,
+                                    const char* path,
+                                    const size_t length)
+{
+    const char* prefix;
+    const char* name;
+    size_t      prefix_length;
+    size_t      name_length;
+
+    _ustar_header_path(header, &prefix, &prefix_length, &name, &name_length);
+
+    if(prefix_length != 0)
+    {
+        if(length != prefix_length + 1 + name_length ||
+           memcmp(path, prefix, prefix_length) != 0 ||
+           path[prefix_length] != '/')
+        {
+            return FALSE;
+        }
+        path += prefix_length + 1;
+    }
+    else if(length != name_length)
+    {
+        return FALSE;
+    }
+
+    return (memcmp(path, name, name_length) == 0);
+}
+
+
+static OS_RETURN_E _ustar_scan(ustar_fs_t* fs, uint32_t* count)
+{
+    const ustar_header_t* header;
+    bcache_block_t*       cached;
+    uint64_t              data_size;
+    uint64_t              block;
+    uint32_t              slot;
+    uint32_t              hash;
+    OS_RETURN_E           err;
+
+    *count = 0;
+    block  = 0;
+    while(block < fs->dev->block_count)
+    {
+        err = bcache_get(fs->dev, block, &cached);
+        if(err != OS_NO_ERR)
+        {
+            return err;
+        }
+        header = (const ustar_header_t*)cached->data;
+
+        /* The archive ends with empty blocks */
+        if(header->name[0] == '\0')
+        {
+            bcache_release(cached);
+            break;
+        }
+        if(_ustar_check_header(header, &data_size) == FALSE ||
+           data_size > (fs->dev->block_count - block - 1) * USTAR_BLOCK_SIZE)
+        {
+            bcache_release(cached);
+            KERNEL_ERROR("Invalid USTAR header at block %llu\n", block);
+            return OS_ERR_CORRUPTED_DATA;
+        }
+
+        if(fs->index != NULL)
+        {
+            /* Linear probing, the table is never full */
+            hash = _ustar_header_hash(header);
+            slot = hash & (fs->index_size - 1);
+            while(fs->index[slot].block != USTAR_SLOT_EMPTY)
+            {
+                slot = (slot + 1) & (fs->index_size - 1);
+            }
+            fs->index[slot].hash  = hash;
+            fs->index[slot].block = (uint32_t)block;
+        }
+        bcache_release(cached);
+
+        ++*count;
+        block += 1 + (data_size + USTAR_BLOCK_SIZE - 1) / USTAR_BLOCK_SIZE;
+    }
+
+    return OS_NO_ERR;
+}
+
+static OS_RETURN_E _ustar_mount(blkdev_t* dev, void** fs_ctrl)
+{
+    ustar_fs_t* fs;
+    uint32_t    count;
+    OS_RETURN_E err;
+
+    /* The index holds 32 bits blocks numbers */
+    if(dev->block_count >= USTAR_SLOT_EMPTY)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    fs = kmalloc(sizeof(ustar_fs_t));
+    if(fs == NULL)
+    {
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+    fs->dev   = dev;
+    fs->index = NULL;
+
+    /* Count the entries, then index them */
+    err = _ustar_scan(fs, &count);
+    if(err != OS_NO_ERR)
+    {
+        kfree(fs);
+        return err;
+    }
+
+    for(fs->index_size = 2;
+        fs->index_size < count * 2;
+        fs->index_size <<= 1);
+
+    fs->index = kmalloc(fs->index_size * sizeof(ustar_slot_t));
+    if(fs->index == NULL)
+    {
+        kfree(fs);
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+    memset(fs->index, 0xFF, fs->index_size * sizeof(ustar_slot_t));
+
+    err = _ustar_scan(fs, &count);
+    if(err != OS_NO_ERR)
+    {
+        kfree(fs->index);
+        kfree(fs);
+        return err;
+    }
+
+    KERNEL_DEBUG(USTAR_DEBUG_ENABLED, MODULE_NAME,
+                 "Mounted archive on %s, %u entries, %u slots",
+                 dev->name, count, fs->index_size);
+
+    *fs_ctrl = fs;
+
+    return OS_NO_ERR;
+}
+
+static OS_RETURN_E _ustar_unmount(void* fs_ctrl)
+{
+    ustar_fs_t* fs;
+
+    fs = fs_ctrl;
+
+    (void)bcache_invalidate(fs->dev);
+    kfree(fs->index);
+    kfree(fs);
+
+    return OS_NO_ERR;
+}
+
+static OS_RETURN_E _ustar_open(void* fs_ctrl,
+                               const char* path,
+                               const size_t length,
+                               vfs_node_t* node)
+{
+    const ustar_fs_t*     fs;
+    const ustar_header_t* header;
+    bcache_block_t*       cached;
+    uint64_t              value;
+    uint32_t              hash;
+    uint32_t              slot;
+    OS_RETURN_E           err;
+
+    fs   = fs_ctrl;
+    hash = _ustar_hash(USTAR_FNV_OFFSET, path, length);
+    for(slot = hash & (fs->index_size - 1);
+        fs->index[slot].block != USTAR_SLOT_EMPTY;
+        slot = (slot + 1) & (fs->index_size - 1))
+    {
+        if(fs->index[slot].hash != hash)
+        {
+            continue;
+        }
+
+        err = bcache_get(fs->dev, fs->index[slot].block, &cached);
+        if(err != OS_NO_ERR)
+        {
+            return err;
+        }
+        header = (const ustar_header_t*)cached->data;
+
+        if(_ustar_header_matches(header, path, length) == FALSE)
+        {
+            bcache_release(cached);
+            continue;
+        }
+
+        /* The headers were checked on mount */
+        (void)_ustar_parse_octal(header->mode, sizeof(header->mode), &value);
+        node->mode  = (uint32_t)value;
+        (void)_ustar_parse_octal(header->size, sizeof(header->size), &value);
+        node->size  = (size_t)value;
+        node->inode = fs->index[slot].block;
+
+        if(header->type == USTAR_FLAG_FILE ||
+           header->type == USTAR_FLAG_FILE_OLD)
+        {
+            node->type = VFS_NODE_FILE;
+        }
+        else if(header->type == USTAR_FLAG_DIRECTORY)
+        {
+            node->type = VFS_NODE_DIRECTORY;
+        }
+        else
+        {
+            node->type = VFS_NODE_OTHER;
+            node->size = 0;
+        }
+
+        bcache_release(cached);
+
+        return OS_NO_ERR;
+    }
+
+    return OS_ERR_FILE_NOT_FOUND;
+}
+
+static OS_RETURN_E _ustar_read(void* fs_ctrl,
+                               const vfs_node_t* node,
+                               const size_t offset,
+                               void* buffer,
+                               const size_t size)
+{
+    const ustar_fs_t* fs;
+    bcache_block_t*   cached;
+    uint8_t*          dst;
+    uint64_t          block;
+    size_t            block_offset;
+    size_t            left;
+    size_t            chunk;
+    OS_RETURN_E       err;
+
+    fs           = fs_ctrl;
+    dst          = buffer;
+    left         = size;
+    block        = node->inode + 1 + offset / USTAR_BLOCK_SIZE;
+    block_offset = offset % USTAR_BLOCK_SIZE;
+
+    /* The data follows the header block */
+    while(left != 0)
+    {
+        err = bcache_get(fs->dev, block, &cached);
+        if(err != OS_NO_ERR)
+        {
+            return err;
+        }
+
+        chunk = USTAR_BLOCK_SIZE - block_offset;
+        if(chunk > left)
+        {
+            chunk = left;
+        }
+        memcpy(dst, cached->data + block_offset, chunk);
+        bcache_release(cached);
+
+        dst          += chunk;
+        left         -= chunk;
+        block_offset  = 0;
+        ++block;
+    }
+
+    return OS_NO_ERR;
+}
+
+static const void* _ustar_map(void* fs_ctrl, const vfs_node_t* node)
+{
+    const ustar_fs_t* fs;
+    const uint8_t*    header;
+
+    fs = fs_ctrl;
+    if(fs->dev->map == NULL)
+    {
+        return NULL;
+    }
+
+    /* The header block always exists, the data may be empty */
+    header = fs->dev->map(fs->dev, node->inode);
+    if(header == NULL)
+    {
+        return NULL;
+    }
+
+    return header + USTAR_BLOCK_SIZE;
+}
+
+const vfs_driver_t* ustar_get_driver(void)
+{
+    ustar_driver.name    = USTAR_DRIVER_NAME;
+    ustar_driver.mount   = _ustar_mount;
+    ustar_driver.unmount = _ustar_unmount;
+    ustar_driver.open    = _ustar_open;
+    ustar_driver.read    = _ustar_read;
+    ustar_driver.map     = _ustar_map;
+
+    return &ustar_driver;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,453 @@
+/*******************************************************************************
+ * @file vfs.c
+ *
+ * @see vfs.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's virtual file system.
+ *
+ * @details Kernel's virtual file system. The drivers and mount points tables
+ * are protected by a spinlock. The drivers mount and unmount routines are
+ * called without it, the mount point entry is reserved meanwhile.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* Memory manipulation */
+#include <critical.h>       /* Kernel spinlocks */
+#include <blkdev.h>         /* Block devices */
+#include <initcall.h>       /* Init calls registry */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <vfs.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "VFS"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The registered file systems drivers. */
+static const vfs_driver_t* vfs_drivers[VFS_MAX_DRIVERS];
+
+/** @brief The mount points, the free entries have no driver. */
+static vfs_mount_t vfs_mounts[VFS_MAX_MOUNTS];
+
+/** @brief Tables lock. */
+static kernel_spinlock_t vfs_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/** @brief Tells if the boot file systems init call was required. */
+static volatile bool_t vfs_root_required = FALSE;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Returns the length of a path without its trailing '/'.
+ *
+ * @param[in] path The path.
+ *
+ * @return The path length.
+ */
+static size_t _vfs_path_length(const char* path);
+
+/**
+ * @brief Looks for a mount point. The tables lock must be held.
+ *
+ * @param[in] path The mount point path.
+ * @param[in] length The path length, without trailing '/'.
+ *
+ * @return The mount point, NULL if the path is not a mount point.
+ */
+static vfs_mount_t* _vfs_find_mount(const char* path, const size_t length);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static size_t _vfs_path_length(const char* path)
+{
+    size_t length;
+
+    length = strlen(path);
+    while(length != 0 && path[length - 1] == '/')
+    {
+        --length;
+    }
+
+    return length;
+}
+
+static vfs_mount_t* _vfs_find_mount(const char* path, const size_t length)
+{
+    uint32_t i;
+
+    for(i = 0; i < VFS_MAX_MOUNTS; ++i)
+    {
+        if(vfs_mounts[i].driver != NULL &&
+           vfs_mounts[i].length == length &&
+           memcmp(vfs_mounts[i].path, path, length) == 0)
+        {
+            return &vfs_mounts[i];
+        }
+    }
+
+    return NULL;
+}
+
+OS_RETURN_E vfs_register_driver(const vfs_driver_t* driver)
+{
+    OS_RETURN_E err;
+    int32_t     free_slot;
+    uint32_t    i;
+
+    if(driver == NULL || driver->name == NULL || driver->mount == NULL ||
+       driver->unmount == NULL || driver->open == NULL || driver->read == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    err       = OS_NO_ERR;
+    free_slot = -1;
+
+    KERNEL_SPINLOCK_LOCK(vfs_lock);
+    for(i = 0; i < VFS_MAX_DRIVERS; ++i)
+    {
+        if(vfs_drivers[i] == NULL)
+        {
+            if(free_slot == -1)
+            {
+                free_slot = (int32_t)i;
+            }
+        }
+        else if(strcmp(vfs_drivers[i]->name, driver->name) == 0)
+        {
+            err = OS_ERR_UNAUTHORIZED_ACTION;
+            break;
+        }
+    }
+    if(err == OS_NO_ERR)
+    {
+        if(free_slot == -1)
+        {
+            err = OS_ERR_NO_MORE_MEMORY;
+        }
+        else
+        {
+            vfs_drivers[free_slot] = driver;
+        }
+    }
+    KERNEL_SPINLOCK_UNLOCK(vfs_lock);
+
+    if(err == OS_NO_ERR)
+    {
+        KERNEL_DEBUG(VFS_DEBUG_ENABLED, MODULE_NAME,
+                     "Registered file system driver %s", driver->name);
+    }
+
+    return err;
+}
+
+OS_RETURN_E vfs_mount(const char* path,
+                      const char* driver_name,
+                      blkdev_t* dev)
+{
+    const vfs_driver_t* driver;
+    vfs_mount_t*        mount;
+    size_t              length;
+    uint32_t            i;
+    OS_RETURN_E         err;
+
+    if(path == NULL || driver_name == NULL || dev == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    length = _vfs_path_length(path);
+    if(path[0] != '/' || length >= VFS_MAX_MOUNT_PATH)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    /* Reserve the mount point */
+    err    = OS_NO_ERR;
+    driver = NULL;
+    mount  = NULL;
+    KERNEL_SPINLOCK_LOCK(vfs_lock);
+    for(i = 0; i < VFS_MAX_DRIVERS; ++i)
+    {
+        if(vfs_drivers[i] != NULL &&
+           strcmp(vfs_drivers[i]->name, driver_name) == 0)
+        {
+            driver = vfs_drivers[i];
+            break;
+        }
+    }
+    if(driver == NULL)
+    {
+        err = OS_ERR_NOT_SUPPORTED;
+    }
+    else if(_vfs_find_mount(path, length) != NULL)
+    {
+        err = OS_ERR_UNAUTHORIZED_ACTION;
+    }
+    else
+    {
+        for(i = 0; i < VFS_MAX_MOUNTS && mount == NULL; ++i)
+        {
+            if(vfs_mounts[i].driver == NULL)
+            {
+                mount = &vfs_mounts[i];
+            }
+        }
+        if(mount == NULL)
+        {
+            err = OS_ERR_NO_MORE_MEMORY;
+        }
+        else
+        {
+            memcpy(mount->path, path, length);
+            mount->path[length] = 0;
+            mount->length       = length;
+            mount->driver       = driver;
+            mount->dev          = dev;
+            mount->fs_ctrl      = NULL;
+            mount->ready        = FALSE;
+        }
+    }
+    KERNEL_SPINLOCK_UNLOCK(vfs_lock);
+
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    err = driver->mount(dev, &mount->fs_ctrl);
+
+    KERNEL_SPINLOCK_LOCK(vfs_lock);
+    if(err == OS_NO_ERR)
+    {
+        mount->ready = TRUE;
+    }
+    else
+    {
+        mount->driver = NULL;
+    }
+    KERNEL_SPINLOCK_UNLOCK(vfs_lock);
+
+    if(err == OS_NO_ERR)
+    {
+        KERNEL_SUCCESS("Mounted %s on %s with %s\n", dev->name, mount->path,
+                       driver->name);
+    }
+
+    return err;
+}
+
+OS_RETURN_E vfs_unmount(const char* path)
+{
+    vfs_mount_t* mount;
+    OS_RETURN_E  err;
+
+    if(path == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    KERNEL_SPINLOCK_LOCK(vfs_lock);
+    mount = _vfs_find_mount(path, _vfs_path_length(path));
+    if(mount == NULL || mount->ready == FALSE)
+    {
+        KERNEL_SPINLOCK_UNLOCK(vfs_lock);
+        return OS_ERR_FILE_NOT_FOUND;
+    }
+    mount->ready = FALSE;
+    KERNEL_SPINLOCK_UNLOCK(vfs_lock);
+
+    err = mount->driver->unmount(mount->fs_ctrl);
+
+    KERNEL_SPINLOCK_LOCK(vfs_lock);
+    if(err == OS_NO_ERR)
+    {
+        mount->driver = NULL;
+    }
+    else
+    {
+        mount->ready = TRUE;
+    }
+    KERNEL_SPINLOCK_UNLOCK(vfs_lock);
+
+    return err;
+}
+
+OS_RETURN_E vfs_open(const char* path, vfs_file_t* file)
+{
+    const vfs_mount_t* mount;
+    size_t             length;
+    size_t             best_length;
+    uint32_t           i;
+
+    if(path == NULL || file == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    /* The boot file systems are mounted on the first open */
+    if(__atomic_load_n(&vfs_root_required, __ATOMIC_ACQUIRE) == FALSE)
+    {
+        (void)initcall_require(VFS_ROOT_INITCALL);
+        __atomic_store_n(&vfs_root_required, TRUE, __ATOMIC_RELEASE);
+    }
+
+    length = _vfs_path_length(path);
+
+    /* The mount point with the longest path containing the file */
+    mount       = NULL;
+    best_length = 0;
+    KERNEL_SPINLOCK_LOCK(vfs_lock);
+    for(i = 0; i < VFS_MAX_MOUNTS; ++i)
+    {
+        if(vfs_mounts[i].ready == FALSE ||
+           vfs_mounts[i].length > length ||
+           (mount != NULL && vfs_mounts[i].length < best_length) ||
+           memcmp(vfs_mounts[i].path, path, vfs_mounts[i].length) != 0 ||
+           (vfs_mounts[i].length != length &&
+            path[vfs_mounts[i].length] != '/'))
+        {
+            continue;
+        }
+        mount       = &vfs_mounts[i];
+        best_length = mount->length;
+    }
+    KERNEL_SPINLOCK_UNLOCK(vfs_lock);
+
+    if(mount == NULL)
+    {
+        return OS_ERR_FILE_NOT_FOUND;
+    }
+
+    path   += best_length;
+    length -= best_length;
+    while(length != 0 && *path == '/')
+    {
+        ++path;
+        --length;
+    }
+
+    file->mount  = mount;
+    file->offset = 0;
+
+    return mount->driver->open(mount->fs_ctrl, path, length, &file->node);
+}
+
+OS_RETURN_E vfs_read(vfs_file_t* file,
+                     void* buffer,
+                     const size_t size,
+                     size_t* read_size)
+{
+    size_t      to_read;
+    OS_RETURN_E err;
+
+    if(file == NULL || buffer == NULL || read_size == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    *read_size = 0;
+    if(file->offset >= file->node.size || size == 0)
+    {
+        return OS_NO_ERR;
+    }
+
+    to_read = file->node.size - file->offset;
+    if(to_read > size)
+    {
+        to_read = size;
+    }
+
+    err = file->mount->driver->read(file->mount->fs_ctrl, &file->node,
+                                    file->offset, buffer, to_read);
+    if(err == OS_NO_ERR)
+    {
+        file->offset += to_read;
+        *read_size    = to_read;
+    }
+
+    return err;
+}
+
+OS_RETURN_E vfs_seek(vfs_file_t* file, const size_t offset)
+{
+    if(file == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(offset > file->node.size)
+    {
+        return OS_ERR_OUT_OF_BOUND;
+    }
+
+    file->offset = offset;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E vfs_map(const vfs_file_t* file, const void** data)
+{
+    if(file == NULL || data == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    *data = NULL;
+    if(file->mount->driver->map != NULL)
+    {
+        *data = file->mount->driver->map(file->mount->fs_ctrl, &file->node);
+    }
+
+    return (*data != NULL) ? OS_NO_ERR : OS_ERR_NOT_SUPPORTED;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,2101 @@
+/*******************************************************************************
+ * @file vmm.c
+ *
+ * @see vmm.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Kernel's virtual memory manager.
+ *
+ * @details Kernel's virtual memory manager. The paging structures are walked
+ * from the root structure, each level translating CPU_PAGING_LEVEL_BITS bits
+ * of the virtual address. The structures are reached through the kernel
+ * linear mapping at KERNEL_MEM_OFFSET, the new ones are allocated from the
+ * kernel heap. The TLB entries of an operation are gathered in ranges of
+ * entries of the same size and invalidated once the operation is done: entry
+ * per entry when few entries changed, the whole address space otherwise. The
+ * other CPUs that might cache the entries invalidate them in a single
+ * cross-CPU call round, the initiator waits for all of them while serving the
+ * calls of the other CPUs. The paging structures released by
+ * an operation are freed once no TLB can reference them anymore.
+ * The address spaces are tagged with PCIDs when the CPU supports them: the
+ * entries of a space are invalidated with INVPCID, even on the CPUs it is not
+ * loaded on, and stay valid across the address space switches. The kernel
+ * entries are cached with every PCID, changing them while user address spaces
+ * exist invalidates all the PCIDs.
+ * The private and copy-on-write states of the user pages are kept in the page
+ * entries bits ignored by the CPU. Cloning an address space copies its paging
+ * structures: the private frames get a reference and the writable private
+ * pages become read only in both spaces until their owner resolves the write
+ * fault.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>         /* Generic int types */
+#include <stddef.h>         /* Standard definitions */
+#include <string.h>         /* memset */
+#include <cpu.h>            /* Paging structures and TLB management */
+#include <critical.h>       /* Kernel critical sections and spinlocks */
+#include <ipi.h>            /* Cross-CPU calls */
+#include <scheduler.h>      /* Current CPU identifier */
+#include <memmgt.h>         /* Private frames references */
+#include <kheap.h>          /* Kernel heap */
+#include <kernel_output.h>  /* Kernel output methods */
+#include <kerror.h>         /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <vmm.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Current module's name */
+#define MODULE_NAME "VMM"
+
+/** @brief Number of entries of a paging structure. */
+#define VMM_TABLE_ENTRIES (1U << CPU_PAGING_LEVEL_BITS)
+
+/** @brief Size of a paging structure in bytes. */
+#define VMM_TABLE_SIZE (VMM_TABLE_ENTRIES * sizeof(cpu_page_entry_t))
+
+/** @brief Level of the root paging structure. */
+#define VMM_ROOT_LEVEL (CPU_PAGING_LEVELS - 1)
+
+/** @brief Number of ranges of a TLB invalidation batch. */
+#define VMM_TLB_BATCH_SIZE 8
+
+/** @brief Number of entries invalidated one by one before invalidating the
+ * whole address space instead.
+ */
+#define VMM_TLB_BATCH_PAGES 32
+
+/** @brief First root paging structure entry of the user range. */
+#define VMM_USER_ROOT_FIRST                                             \
+    VMM_LEVEL_INDEX((uintptr_t)KERNEL_USER_SPACE_START, VMM_ROOT_LEVEL)
+
+/** @brief Last root paging structure entry of the user range. */
+#define VMM_USER_ROOT_LAST                                              \
+    VMM_LEVEL_INDEX((uintptr_t)KERNEL_USER_SPACE_END - 1, VMM_ROOT_LEVEL)
+
+/** @brief Number of words of the PCIDs allocation bitmap. */
+#define VMM_PCID_MAP_SIZE ((CPU_PCID_COUNT + 31) / 32)
+
+/** @brief Page entries flags set by the manager. */
+#define VMM_ENTRY_FLAGS_MASK (CPU_PAGE_PRESENT | CPU_PAGE_WRITE |         \
+                              CPU_PAGE_USER | CPU_PAGE_WRITE_THROUGH |    \
+                              CPU_PAGE_CACHE_DISABLE)
+
+/** @brief Page entries flags of the pages that are never mapped by large
+ * pages.
+ */
+#define VMM_ENTRY_SMALL_FLAGS (CPU_PAGE_PRIVATE | CPU_PAGE_COW)
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Contiguous entries of the same size whose TLB entries must be
+ * invalidated.
+ */
+typedef struct
+{
+    /** @brief Address of the first entry. */
+    uintptr_t virt;
+
+    /** @brief Size of the memory mapped by each entry. */
+    uintptr_t size;
+
+    /** @brief Number of entries. */
+    uint32_t count;
+} vmm_tlb_range_t;
+
+/** @brief TLB entries of an address space that must be invalidated. */
+typedef struct
+{
+    /** @brief The ranges of entries. */
+    vmm_tlb_range_t ranges[VMM_TLB_BATCH_SIZE];
+
+    /** @brief Number of ranges in the batch. */
+    uint32_t count;
+
+    /** @brief Number of entries in the ranges. */
+    uint32_t page_count;
+
+    /** @brief Tells if the whole address space must be invalidated. */
+    bool_t flush_all;
+
+    /** @brief Tells if the batch changes the kernel address space. */
+    bool_t kernel;
+
+    /** @brief Tells if the entries must be invalidated for all the PCIDs. */
+    bool_t all_pcids;
+
+    /** @brief Physical address of the address space root paging structure. */
+    uintptr_t root;
+
+    /** @brief PCID of the address space. */
+    uint32_t pcid;
+
+    /** @brief Paging structures released once the entries are invalidated,
+     * linked through their first entry.
+     */
+    cpu_page_entry_t* free_tables;
+} vmm_tlb_batch_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Returns the size of the memory mapped by an entry of a level.
+ *
+ * @param[in] LEVEL The paging level.
+ */
+#define VMM_LEVEL_SIZE(LEVEL) \
+    ((uintptr_t)1 << (12 + (LEVEL) * CPU_PAGING_LEVEL_BITS))
+
+/**
+ * @brief Returns the index of the entry of a level translating an address.
+ *
+ * @param[in] VIRT The virtual address.
+ * @param[in] LEVEL The paging level.
+ */
+#define VMM_LEVEL_INDEX(VIRT, LEVEL)                                    \
+    (((VIRT) >> (12 + (LEVEL) * CPU_PAGING_LEVEL_BITS)) &               \
+     (VMM_TABLE_ENTRIES - 1))
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/** @brief Kernel heap region base address, defined in the linker file. */
+extern int8_t _KERNEL_HEAP_BASE[];
+
+/** @brief Kernel heap region size, defined in the linker file. */
+extern int8_t _KERNEL_HEAP_SIZE;
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Tells if the manager is initialized. */
+static bool_t vmm_initialized = FALSE;
+
+/** @brief The kernel address space, its PCID is 0. */
+static vmm_space_t vmm_kernel_space;
+
+/** @brief The user address spaces. */
+static vmm_space_t* vmm_spaces = NULL;
+
+/** @brief Allocated PCIDs, one bit per PCID. */
+static uint32_t vmm_pcid_map[VMM_PCID_MAP_SIZE];
+
+/** @brief Current address space of each CPU. */
+static vmm_space_t* vmm_cpu_spaces[MAX_CPU_COUNT];
+
+/** @brief CPUs taking part in the TLB shootdowns, one bit per CPU. */
+static volatile uint32_t vmm_online_cpus = 0;
+
+/** @brief Largest paging level that can map a page. */
+static uint32_t vmm_max_page_level;
+
+/** @brief Lock protecting the paging structures. */
+static kernel_spinlock_t vmm_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Initializes a TLB invalidation batch.
+ *
+ * @param[out] batch The batch.
+ * @param[in] space The address space changed by the batch.
+ */
+static void _vmm_batch_init(vmm_tlb_batch_t* batch, const vmm_space_t* space);
+
+/**
+ * @brief Adds an entry to a TLB invalidation batch.
+ *
+ * @details Adds an entry to a TLB invalidation batch, the entry is merged
+ * with the last range when it follows it.
+ *
+ * @param[in, out] batch The batch.
+ * @param[in] virt The address translated by the entry.
+ * @param[in] level The level of the entry.
+ */
+static void _vmm_batch_add(vmm_tlb_batch_t* batch,
+                           const uintptr_t virt,
+                           const uint32_t level);
+
+/**
+ * @brief Invalidates the TLB entries of a batch on the current CPU.
+ *
+ * @param[in] batch The batch.
+ */
+static void _vmm_batch_invalidate(const vmm_tlb_batch_t* batch);
+
+/**
+ * @brief TLB shootdown cross-CPU call, invalidates a batch.
+ *
+ * @param[in] args The batch to invalidate.
+ */
+static void _vmm_shootdown_call(void* args);
+
+/**
+ * @brief Commits a TLB invalidation batch and releases the manager lock.
+ *
+ * @details Copies the kernel root entries to the user address spaces after a
+ * change of the kernel address space, then releases the manager lock. The
+ * batch is invalidated on the current CPU and on the other CPUs that might
+ * cache its entries, in a single shootdown round. The interrupt state is
+ * restored and the released paging structures are freed once all the CPUs
+ * invalidated the batch.
+ *
+ * @param[in] space The address space changed by the batch.
+ * @param[in, out] batch The batch.
+ * @param[in] int_state The interrupt state saved when the lock was acquired.
+ */
+static void _vmm_commit_unlock(const vmm_space_t* space,
+                               vmm_tlb_batch_t* batch,
+                               const uint32_t int_state);
+
+/**
+ * @brief Returns the paging structure an entry points to.
+ *
+ * @param[in] entry The entry.
+ *
+ * @return The virtual address of the paging structure.
+ */
+inline static cpu_page_entry_t* _vmm_get_table(const cpu_page_entry_t entry);
+
+/**
+ * @brief Tells if an entry maps a page.
+ *
+ * @param[in] entry The entry.
+ * @param[in] level The level of the entry.
+ *
+ * @return TRUE if the entry maps a page, FALSE if it points to a paging
+ * structure.
+ */
+inline static bool_t _vmm_is_page(const cpu_page_entry_t entry,
+                                  const uint32_t level);
+
+/**
+ * @brief Returns the end of the part of a range covered by an entry.
+ *
+ * @param[in] virt The start of the range.
+ * @param[in] end The end of the range.
+ * @param[in] level The level of the entry translating virt.
+ *
+ * @return The end of the part of the range covered by the entry.
+ */
+inline static uintptr_t _vmm_get_entry_end(const uintptr_t virt,
+                                           const uintptr_t end,
+                                           const uint32_t level);
+
+/**
+ * @brief Allocates an empty paging structure.
+ *
+ * @param[out] entry The entry pointing to the structure, not user accessible.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _vmm_alloc_table(cpu_page_entry_t* entry);
+
+/**
+ * @brief Releases a paging structure and the structures it points to.
+ *
+ * @details Releases a paging structure that maps no page and the structures
+ * it points to. The structures are added to the batch and freed once it is
+ * invalidated. The structures set by the boot code are not released.
+ *
+ * @param[in] entry The entry pointing to the structure.
+ * @param[in] level The level of the structure.
+ * @param[in, out] batch The TLB invalidation batch.
+ */
+static void _vmm_free_table(const cpu_page_entry_t entry,
+                            const uint32_t level,
+                            vmm_tlb_batch_t* batch);
+
+/**
+ * @brief Tells if a paging structure has no present entry.
+ *
+ * @param[in] table The paging structure.
+ *
+ * @return TRUE if the structure has no present entry, FALSE otherwise.
+ */
+static bool_t _vmm_is_table_empty(const cpu_page_entry_t* table);
+
+/**
+ * @brief Splits a large page.
+ *
+ * @details Replaces a large page by a paging structure mapping the same
+ * memory with the same flags with pages of the level below.
+ *
+ * @param[in, out] entry The entry mapping the large page.
+ * @param[in] level The level of the entry.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _vmm_split(cpu_page_entry_t* entry, const uint32_t level);
+
+/**
+ * @brief Tells if a range is entirely mapped or entirely unmapped.
+ *
+ * @param[in] table The paging structure translating the range.
+ * @param[in] level The level of the structure.
+ * @param[in] virt The start of the range.
+ * @param[in] end The end of the range.
+ * @param[in] mapped TRUE to check that the range is mapped, FALSE to check
+ * that it is not.
+ *
+ * @return TRUE if the whole range is in the requested state, FALSE otherwise.
+ */
+static bool_t _vmm_check_range(const cpu_page_entry_t* table,
+                               const uint32_t level,
+                               uintptr_t virt,
+                               const uintptr_t end,
+                               const bool_t mapped);
+
+/**
+ * @brief Maps an unmapped range.
+ *
+ * @param[in, out] table The paging structure translating the range.
+ * @param[in] level The level of the structure.
+ * @param[in] virt The start of the range.
+ * @param[in] end The end of the range.
+ * @param[in] phys The physical address mapped at virt.
+ * @param[in] page_flags The pages entries flags.
+ * @param[in, out] batch The TLB invalidation batch.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _vmm_map_range(cpu_page_entry_t* table,
+                                  const uint32_t level,
+                                  uintptr_t virt,
+                                  const uintptr_t end,
+                                  uintptr_t phys,
+                                  const cpu_page_entry_t page_flags,
+                                  vmm_tlb_batch_t* batch);
+
+/**
+ * @brief Unmaps a range.
+ *
+ * @param[in, out] table The paging structure translating the range.
+ * @param[in] level The level of the structure.
+ * @param[in] virt The start of the range.
+ * @param[in] end The end of the range.
+ * @param[in, out] batch The TLB invalidation batch.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _vmm_unmap_range(cpu_page_entry_t* table,
+                                    const uint32_t level,
+                                    uintptr_t virt,
+                                    const uintptr_t end,
+                                    vmm_tlb_batch_t* batch);
+
+/**
+ * @brief Changes the flags of a mapped range.
+ *
+ * @param[in, out] table The paging structure translating the range.
+ * @param[in] level The level of the structure.
+ * @param[in] virt The start of the range.
+ * @param[in] end The end of the range.
+ * @param[in] page_flags The new pages entries flags.
+ * @param[in, out] batch The TLB invalidation batch.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _vmm_protect_range(cpu_page_entry_t* table,
+                                      const uint32_t level,
+                                      uintptr_t virt,
+                                      const uintptr_t end,
+                                      const cpu_page_entry_t page_flags,
+                                      vmm_tlb_batch_t* batch);
+
+/**
+ * @brief Copies the mappings of a paging structure to a new structure.
+ *
+ * @details Copies the present entries of a range of entries, the paging
+ * structures they point to are copied. The private pages frames get a
+ * reference and the writable private pages become copy-on-write in both
+ * structures.
+ *
+ * @param[in, out] table The paging structure to copy.
+ * @param[out] clone_table The empty paging structure receiving the copy.
+ * @param[in] level The level of the structures.
+ * @param[in] base The address translated by the first entry of the
+ * structures.
+ * @param[in] first The first entry to copy.
+ * @param[in] last The last entry to copy.
+ * @param[in, out] batch The TLB invalidation batch of the copied structure.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _vmm_clone_table(cpu_page_entry_t* table,
+                                    cpu_page_entry_t* clone_table,
+                                    const uint32_t level,
+                                    const uintptr_t base,
+                                    const uint32_t first,
+                                    const uint32_t last,
+                                    vmm_tlb_batch_t* batch);
+
+/**
+ * @brief Drops the references of the private pages of a range of entries.
+ *
+ * @param[in] table The paging structure.
+ * @param[in] level The level of the structure.
+ * @param[in] first The first entry of the range.
+ * @param[in] last The last entry of the range.
+ */
+static void _vmm_release_private(const cpu_page_entry_t* table,
+                                 const uint32_t level,
+                                 const uint32_t first,
+                                 const uint32_t last);
+
+/**
+ * @brief Returns the entry of a copy-on-write page of an address space.
+ *
+ * @details The manager lock must be held.
+ *
+ * @param[in] space The address space.
+ * @param[in] virt The virtual address, page aligned.
+ * @param[out] entry The buffer receiving the entry mapping the page.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the page is not copy-on-write.
+ * - OS_ERR_MEMORY_NOT_MAPPED is returned if the page is not mapped.
+ */
+static OS_RETURN_E _vmm_get_cow_entry(const vmm_space_t* space,
+                                      const uintptr_t virt,
+                                      cpu_page_entry_t** entry);
+
+/**
+ * @brief Returns the pages entries flags of mapping flags.
+ *
+ * @param[in] flags The mapping flags.
+ *
+ * @return The pages entries flags.
+ */
+static cpu_page_entry_t _vmm_get_page_flags(const uint32_t flags);
+
+/**
+ * @brief Returns the mapping flags of a page entry.
+ *
+ * @param[in] entry The page entry.
+ *
+ * @return The mapping flags, a combination of the VMM_FLAG values.
+ */
+static uint32_t _vmm_get_mapping_flags(const cpu_page_entry_t entry);
+
+/**
+ * @brief Checks the range given to the manager.
+ *
+ * @param[in] virt The start of the range.
+ * @param[in] size The size of the range.
+ *
+ * @return TRUE if the range is valid and the manager initialized, FALSE
+ * otherwise.
+ */
+static bool_t _vmm_check_args(const uintptr_t virt, const size_t size);
+
+/**
+ * @brief Checks the range given to the manager for a user address space.
+ *
+ * @param[in] virt The start of the range.
+ * @param[in] size The size of the range.
+ *
+ * @return TRUE if the range is valid, in the user range and the manager
+ * initialized, FALSE otherwise.
+ */
+static bool_t _vmm_check_user_args(const uintptr_t virt, const size_t size);
+
+/**
+ * @brief Allocates a PCID.
+ *
+ * @details Allocates a PCID, the manager lock must be held. When the PCIDs
+ * are disabled, the PCID 0 is returned.
+ *
+ * @param[out] pcid The allocated PCID.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _vmm_alloc_pcid(uint32_t* pcid);
+
+/**
+ * @brief Maps physical memory in an address space.
+ *
+ * @param[in, out] space The address space.
+ * @param[in] virt The virtual address.
+ * @param[in] phys The physical address.
+ * @param[in] size The size of the range.
+ * @param[in] flags The mapping flags.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _vmm_space_map(vmm_space_t* space,
+                                  const uintptr_t virt,
+                                  const uintptr_t phys,
+                                  const size_t size,
+                                  const uint32_t flags);
+
+/**
+ * @brief Unmaps ranges of an address space.
+ *
+ * @param[in, out] space The address space.
+ * @param[in] ranges The ranges to unmap.
+ * @param[in] count The number of ranges.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _vmm_space_unmap(vmm_space_t* space,
+                                    const vmm_range_t* ranges,
+                                    const uint32_t count);
+
+/**
+ * @brief Changes the protection of a range of an address space.
+ *
+ * @param[in, out] space The address space.
+ * @param[in] virt The virtual address.
+ * @param[in] size The size of the range.
+ * @param[in] flags The new mapping flags.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _vmm_space_protect(vmm_space_t* space,
+                                      const uintptr_t virt,
+                                      const size_t size,
+                                      const uint32_t flags);
+
+/**
+ * @brief Returns the mapping of a virtual address of an address space.
+ *
+ * @param[in] space The address space.
+ * @param[in] virt The virtual address.
+ * @param[out] phys The physical address mapped at virt.
+ * @param[out] flags The mapping flags of the page, can be NULL.
+ * @param[out] page_size The size of the page mapping virt, can be NULL.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _vmm_space_get_mapping(const vmm_space_t* space,
+                                          const uintptr_t virt,
+                                          uintptr_t* phys,
+                                          uint32_t* flags,
+                                          size_t* page_size);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void _vmm_batch_init(vmm_tlb_batch_t* batch, const vmm_space_t* space)
+{
+    batch->count       = 0;
+    batch->page_count  = 0;
+    batch->flush_all   = FALSE;
+    batch->kernel      = (space == &vmm_kernel_space);
+    batch->all_pcids   = FALSE;
+    batch->root        = (uintptr_t)space->root - KERNEL_MEM_OFFSET;
+    batch->pcid        = space->pcid;
+    batch->free_tables = NULL;
+}
+
+static void _vmm_batch_add(vmm_tlb_batch_t* batch,
+                           const uintptr_t virt,
+                           const uint32_t level)
+{
+    vmm_tlb_range_t* range;
+    uintptr_t        size;
+
+    if(batch->flush_all == TRUE)
+    {
+        return;
+    }
+
+    if(batch->page_count == VMM_TLB_BATCH_PAGES)
+    {
+        batch->flush_all = TRUE;
+        return;
+    }
+    ++batch->page_count;
+
+    size = VMM_LEVEL_SIZE(level);
+    if(batch->count != 0)
+    {
+        range = &batch->ranges[batch->count - 1];
+        if(range->size == size && range->virt + range->count * size == virt)
+        {
+            ++range->count;
+            return;
+        }
+    }
+
+    if(batch->count == VMM_TLB_BATCH_SIZE)
+    {
+        batch->flush_all = TRUE;
+        return;
+    }
+
+    range        = &batch->ranges[batch->count++];
+    range->virt  = virt;
+    range->size  = size;
+    range->count = 1;
+}
+
+static void _vmm_batch_invalidate(const vmm_tlb_batch_t* batch)
+{
+    const vmm_tlb_range_t* range;
+    bool_t                 tagged;
+    uint32_t               i;
+    uint32_t               j;
+
+    /* The kernel entries are invalidated in the loaded address space, the
+     * entries of a user address space with its PCID
+     */
+    tagged = (batch->kernel == FALSE && cpu_is_pcid_enabled() == TRUE);
+    if(batch->all_pcids == TRUE)
+    {
+        _cpu_invalidate_all_pcids();
+        return;
+    }
+
+    /* Without PCIDs, switching address spaces flushes the TLB */
+    if(batch->kernel == FALSE && tagged == FALSE &&
+       _cpu_get_page_directory() != batch->root)
+    {
+        return;
+    }
+
+    if(batch->flush_all == TRUE)
+    {
+        if(tagged == TRUE)
+        {
+            _cpu_invalidate_pcid(batch->pcid);
+        }
+        else
+        {
+            _cpu_set_page_directory(_cpu_get_page_directory());
+        }
+        return;
+    }
+
+    for(i = 0; i < batch->count; ++i)
+    {
+        range = &batch->ranges[i];
+        for(j = 0; j < range->count; ++j)
+        {
+            if(tagged == TRUE)
+            {
+                _cpu_invalidate_pcid_page(batch->pcid,
+                                          range->virt + j * range->size);
+            }
+            else
+            {
+                _cpu_invalidate_page(range->virt + j * range->size);
+            }
+        }
+    }
+}
+
+static void _vmm_shootdown_call(void* args)
+{
+    _vmm_batch_invalidate((const vmm_tlb_batch_t*)args);
+}
+
+static void _vmm_commit_unlock(const vmm_space_t* space,
+                               vmm_tlb_batch_t* batch,
+                               const uint32_t int_state)
+{
+    vmm_space_t*      user_space;
+    cpu_page_entry_t* table;
+    uint32_t          cpu_id;
+    uint32_t          targets;
+    OS_RETURN_E       err;
+
+    cpu_id  = scheduler_get_current_cpu_id();
+    targets = 0;
+    if(batch->kernel == TRUE)
+    {
+        /* The user address spaces share the kernel root entries */
+        for(user_space = vmm_spaces;
+            user_space != NULL;
+            user_space = user_space->next)
+        {
+            memcpy(user_space->root, vmm_kernel_space.root,
+                   VMM_USER_ROOT_FIRST * sizeof(cpu_page_entry_t));
+            memcpy(user_space->root + VMM_USER_ROOT_LAST + 1,
+                   vmm_kernel_space.root + VMM_USER_ROOT_LAST + 1,
+                   (VMM_TABLE_ENTRIES - VMM_USER_ROOT_LAST - 1) *
+                   sizeof(cpu_page_entry_t));
+        }
+        batch->all_pcids = (vmm_spaces != NULL &&
+                            cpu_is_pcid_enabled() == TRUE);
+    }
+    if(batch->count != 0 || batch->flush_all == TRUE)
+    {
+        targets = (batch->kernel == TRUE) ? vmm_online_cpus : space->cpu_mask;
+        targets &= vmm_online_cpus & ~(1U << cpu_id);
+        _vmm_batch_invalidate(batch);
+    }
+
+    KERNEL_SPINLOCK_UNLOCK(vmm_lock);
+
+    if(targets != 0)
+    {
+        err = ipi_call_many(targets, _vmm_shootdown_call, batch);
+        if(err != OS_NO_ERR)
+        {
+            KERNEL_ERROR("Could not send the TLB shootdown: %d\n", err);
+        }
+
+        KERNEL_DEBUG(VMM_DEBUG_ENABLED, MODULE_NAME,
+                     "TLB shootdown to CPUs 0x%x, %u ranges, flush %u",
+                     targets, batch->count, batch->flush_all);
+    }
+
+    EXIT_CRITICAL(int_state);
+
+    while(batch->free_tables != NULL)
+    {
+        table              = batch->free_tables;
+        batch->free_tables = (cpu_page_entry_t*)(uintptr_t)table[0];
+        kfree(table);
+    }
+}
+
+inline static cpu_page_entry_t* _vmm_get_table(const cpu_page_entry_t entry)
+{
+    return (cpu_page_entry_t*)((uintptr_t)(entry & CPU_PAGE_ADDR_MASK) +
+                               KERNEL_MEM_OFFSET);
+}
+
+inline static bool_t _vmm_is_page(const cpu_page_entry_t entry,
+                                  const uint32_t level)
+{
+    return level == 0 || (entry & CPU_PAGE_LARGE) != 0;
+}
+
+inline static uintptr_t _vmm_get_entry_end(const uintptr_t virt,
+                                           const uintptr_t end,
+                                           const uint32_t level)
+{
+    uintptr_t entry_end;
+
+    entry_end = (virt & ~(VMM_LEVEL_SIZE(level) - 1)) + VMM_LEVEL_SIZE(level);
+
+    /* The last entry of the address space wraps around */
+    if(entry_end < virt || entry_end > end)
+    {
+        return end;
+    }
+    return entry_end;
+}
+
+static OS_RETURN_E _vmm_alloc_table(cpu_page_entry_t* entry)
+{
+    void* table;
+
+    table = kmalloc(VMM_TABLE_SIZE);
+    if(table == NULL)
+    {
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+    memset(table, 0, VMM_TABLE_SIZE);
+
+    *entry = ((uintptr_t)table - KERNEL_MEM_OFFSET) |
+             CPU_PAGE_PRESENT | CPU_PAGE_WRITE;
+
+    return OS_NO_ERR;
+}
+
+static void _vmm_free_table(const cpu_page_entry_t entry,
+                            const uint32_t level,
+                            vmm_tlb_batch_t* batch)
+{
+    cpu_page_entry_t* table;
+    uintptr_t         heap_base;
+    uint32_t          i;
+
+    table = _vmm_get_table(entry);
+    if(level > 0)
+    {
+        for(i = 0; i < VMM_TABLE_ENTRIES; ++i)
+        {
+            if((table[i] & CPU_PAGE_PRESENT) != 0 &&
+               _vmm_is_page(table[i], level) == FALSE)
+            {
+                _vmm_free_table(table[i], level - 1, batch);
+            }
+        }
+    }
+
+    /* The boot paging structures are static */
+    heap_base = (uintptr_t)_KERNEL_HEAP_BASE;
+    if((uintptr_t)table >= heap_base &&
+       (uintptr_t)table - heap_base < (uintptr_t)&_KERNEL_HEAP_SIZE)
+    {
+        /* The tables are aligned, the link is not a present entry */
+        table[0]           = (cpu_page_entry_t)(uintptr_t)batch->free_tables;
+        batch->free_tables = table;
+    }
+}
+
+static bool_t _vmm_is_table_empty(const cpu_page_entry_t* table)
+{
+    uint32_t i;
+
+    for(i = 0; i < VMM_TABLE_ENTRIES; ++i)
+    {
+        if((table[i] & CPU_PAGE_PRESENT) != 0)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static OS_RETURN_E _vmm_split(cpu_page_entry_t* entry, const uint32_t level)
+{
+    cpu_page_entry_t* table;
+    cpu_page_entry_t  table_entry;
+    cpu_page_entry_t  page_flags;
+    uintptr_t         base;
+    OS_RETURN_E       err;
+    uint32_t          i;
+
+    err = _vmm_alloc_table(&table_entry);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+    table = _vmm_get_table(table_entry);
+
+    base       = *entry & CPU_PAGE_ADDR_MASK & ~(VMM_LEVEL_SIZE(level) - 1);
+    page_flags = *entry & VMM_ENTRY_FLAGS_MASK;
+    if(level > 1)
+    {
+        page_flags |= CPU_PAGE_LARGE;
+    }
+    for(i = 0; i < VMM_TABLE_ENTRIES; ++i)
+    {
+        table[i] = (base + i * VMM_LEVEL_SIZE(level - 1)) | page_flags;
+    }
+
+    /* The translations do not change, the TLB entries stay valid */
+    *entry = table_entry | (*entry & CPU_PAGE_USER);
+
+    return OS_NO_ERR;
+}
+
+static bool_t _vmm_check_range(const cpu_page_entry_t* table,
+                               const uint32_t level,
+                               uintptr_t virt,
+                               const uintptr_t end,
+                               const bool_t mapped)
+{
+    cpu_page_entry_t entry;
+    uintptr_t        entry_end;
+
+    while(virt < end)
+    {
+        entry_end = _vmm_get_entry_end(virt, end, level);
+        entry     = table[VMM_LEVEL_INDEX(virt, level)];
+
+        if((entry & CPU_PAGE_PRESENT) == 0)
+        {
+            if(mapped == TRUE)
+            {
+                return FALSE;
+            }
+        }
+        else if(_vmm_is_page(entry, level) == TRUE)
+        {
+            if(mapped == FALSE)
+            {
+                return FALSE;
+            }
+        }
+        else if(_vmm_check_range(_vmm_get_table(entry), level - 1,
+                                 virt, entry_end, mapped) == FALSE)
+        {
+            return FALSE;
+        }
+
+        virt = entry_end;
+    }
+
+    return TRUE;
+}
+
+static OS_RETURN_E _vmm_map_range(cpu_page_entry_t* table,
+                                  const uint32_t level,
+                                  uintptr_t virt,
+                                  const uintptr_t end,
+                                  uintptr_t phys,
+                                  const cpu_page_entry_t page_flags,
+                                  vmm_tlb_batch_t* batch)
+{
+    cpu_page_entry_t* entry;
+    uintptr_t         entry_end;
+    OS_RETURN_E       err;
+
+    while(virt < end)
+    {
+        entry_end = _vmm_get_entry_end(virt, end, level);
+        entry     = &table[VMM_LEVEL_INDEX(virt, level)];
+
+        /* Use the largest page the range and the alignment allow */
+        if((level == 0 ||
+            (level <= vmm_max_page_level &&
+             (page_flags & VMM_ENTRY_SMALL_FLAGS) == 0)) &&
+           entry_end - virt == VMM_LEVEL_SIZE(level) &&
+           (phys & (VMM_LEVEL_SIZE(level) - 1)) == 0)
+        {
+            /* An empty structure can be left by a previous unmap */
+            if((*entry & CPU_PAGE_PRESENT) != 0)
+            {
+                _vmm_free_table(*entry, level - 1, batch);
+                _vmm_batch_add(batch, virt, level);
+            }
+
+            *entry = phys | page_flags;
+            if(level > 0)
+            {
+                *entry |= CPU_PAGE_LARGE;
+            }
+        }
+        else
+        {
+            if((*entry & CPU_PAGE_PRESENT) == 0)
+            {
+                err = _vmm_alloc_table(entry);
+                if(err != OS_NO_ERR)
+                {
+                    return err;
+                }
+            }
+            *entry |= page_flags & CPU_PAGE_USER;
+
+            err = _vmm_map_range(_vmm_get_table(*entry), level - 1,
+                                 virt, entry_end, phys, page_flags, batch);
+            if(err != OS_NO_ERR)
+            {
+                return err;
+            }
+        }
+
+        phys += entry_end - virt;
+        virt  = entry_end;
+    }
+
+    return OS_NO_ERR;
+}
+
+static OS_RETURN_E _vmm_unmap_range(cpu_page_entry_t* table,
+                                    const uint32_t level,
+                                    uintptr_t virt,
+                                    const uintptr_t end,
+                                    vmm_tlb_batch_t* batch)
+{
+    cpu_page_entry_t* entry;
+    uintptr_t         entry_end;
+    OS_RETURN_E       err;
+
+    while(virt < end)
+    {
+        entry_end = _vmm_get_entry_end(virt, end, level);
+        entry     = &table[VMM_LEVEL_INDEX(virt, level)];
+
+        if((*entry & CPU_PAGE_PRESENT) == 0)
+        {
+            virt = entry_end;
+            continue;
+        }
+
+        if(entry_end - virt == VMM_LEVEL_SIZE(level))
+        {
+            /* The whole entry is unmapped, its structure is released */
+            if(_vmm_is_page(*entry, level) == FALSE)
+            {
+                err = _vmm_unmap_range(_vmm_get_table(*entry), level - 1,
+                                       virt, entry_end, batch);
+                if(err != OS_NO_ERR)
+                {
+                    return err;
+                }
+                _vmm_free_table(*entry, level - 1, batch);
+            }
+            *entry = 0;
+            _vmm_batch_add(batch, virt, level);
+        }
+        else
+        {
+            if(_vmm_is_page(*entry, level) == TRUE)
+            {
+                err = _vmm_split(entry, level);
+                if(err != OS_NO_ERR)
+                {
+                    return err;
+                }
+            }
+            err = _vmm_unmap_range(_vmm_get_table(*entry), level - 1,
+                                   virt, entry_end, batch);
+            if(err != OS_NO_ERR)
+            {
+                return err;
+            }
+
+            /* Release the structure once its last page is unmapped */
+            if(_vmm_is_table_empty(_vmm_get_table(*entry)) == TRUE)
+            {
+                _vmm_free_table(*entry, level - 1, batch);
+                *entry = 0;
+                _vmm_batch_add(batch, virt, level);
+            }
+        }
+
+        virt = entry_end;
+    }
+
+    return OS_NO_ERR;
+}
+
+static OS_RETURN_E _vmm_protect_range(cpu_page_entry_t* table,
+                                      const uint32_t level,
+                                      uintptr_t virt,
+                                      const uintptr_t end,
+                                      const cpu_page_entry_t page_flags,
+                                      vmm_tlb_batch_t* batch)
+{
+    cpu_page_entry_t* entry;
+    cpu_page_entry_t  new_entry;
+    uintptr_t         entry_end;
+    OS_RETURN_E       err;
+
+    while(virt < end)
+    {
+        entry_end = _vmm_get_entry_end(virt, end, level);
+        entry     = &table[VMM_LEVEL_INDEX(virt, level)];
+
+        if(_vmm_is_page(*entry, level) == TRUE)
+        {
+            new_entry = (*entry & ~(cpu_page_entry_t)VMM_ENTRY_FLAGS_MASK) |
+                        page_flags;
+
+            /* The copy-on-write pages are only made writable once resolved */
+            if((*entry & CPU_PAGE_COW) != 0)
+            {
+                new_entry &= ~(cpu_page_entry_t)CPU_PAGE_WRITE;
+            }
+            if(new_entry == *entry)
+            {
+                virt = entry_end;
+                continue;
+            }
+
+            if(entry_end - virt == VMM_LEVEL_SIZE(level))
+            {
+                *entry = new_entry;
+                _vmm_batch_add(batch, virt, level);
+                virt = entry_end;
+                continue;
+            }
+
+            err = _vmm_split(entry, level);
+            if(err != OS_NO_ERR)
+            {
+                return err;
+            }
+        }
+
+        *entry |= page_flags & CPU_PAGE_USER;
+        err = _vmm_protect_range(_vmm_get_table(*entry), level - 1,
+                                 virt, entry_end, page_flags, batch);
+        if(err != OS_NO_ERR)
+        {
+            return err;
+        }
+
+        virt = entry_end;
+    }
+
+    return OS_NO_ERR;
+}
+
+static OS_RETURN_E _vmm_clone_table(cpu_page_entry_t* table,
+                                    cpu_page_entry_t* clone_table,
+                                    const uint32_t level,
+                                    const uintptr_t base,
+                                    const uint32_t first,
+                                    const uint32_t last,
+                                    vmm_tlb_batch_t* batch)
+{
+    cpu_page_entry_t entry;
+    uintptr_t        virt;
+    OS_RETURN_E      err;
+    uint32_t         i;
+
+    for(i = first; i <= last; ++i)
+    {
+        entry = table[i];
+        if((entry & CPU_PAGE_PRESENT) == 0)
+        {
+            continue;
+        }
+        virt = base + i * VMM_LEVEL_SIZE(level);
+
+        if(_vmm_is_page(entry, level) == FALSE)
+        {
+            err = _vmm_alloc_table(&clone_table[i]);
+            if(err != OS_NO_ERR)
+            {
+                return err;
+            }
+            clone_table[i] |= entry & CPU_PAGE_USER;
+
+            err = _vmm_clone_table(_vmm_get_table(entry),
+                                   _vmm_get_table(clone_table[i]), level - 1,
+                                   virt, 0, VMM_TABLE_ENTRIES - 1, batch);
+            if(err != OS_NO_ERR)
+            {
+                return err;
+            }
+            continue;
+        }
+
+        /* The other pages are not owned by the mappings, they are shared */
+        if((entry & CPU_PAGE_PRIVATE) != 0)
+        {
+            err = memmgt_share_frame((uintptr_t)(entry & CPU_PAGE_ADDR_MASK));
+            if(err != OS_NO_ERR)
+            {
+                return err;
+            }
+
+            if((entry & CPU_PAGE_WRITE) != 0)
+            {
+                entry    = (entry & ~(cpu_page_entry_t)CPU_PAGE_WRITE) |
+                           CPU_PAGE_COW;
+                table[i] = entry;
+                _vmm_batch_add(batch, virt, level);
+            }
+        }
+        clone_table[i] = entry;
+    }
+
+    return OS_NO_ERR;
+}
+
+static void _vmm_release_private(const cpu_page_entry_t* table,
+                                 const uint32_t level,
+                                 const uint32_t first,
+                                 const uint32_t last)
+{
+    cpu_page_entry_t entry;
+    uint32_t         i;
+
+    for(i = first; i <= last; ++i)
+    {
+        entry = table[i];
+        if((entry & CPU_PAGE_PRESENT) == 0)
+        {
+            continue;
+        }
+
+        if(_vmm_is_page(entry, level) == FALSE)
+        {
+            _vmm_release_private(_vmm_get_table(entry), level - 1,
+                                 0, VMM_TABLE_ENTRIES - 1);
+        }
+        else if((entry & CPU_PAGE_PRIVATE) != 0)
+        {
+            (void)memmgt_free_frames((uintptr_t)(entry & CPU_PAGE_ADDR_MASK),
+                                     0);
+        }
+    }
+}
+
+static OS_RETURN_E _vmm_get_cow_entry(const vmm_space_t* space,
+                                      const uintptr_t virt,
+                                      cpu_page_entry_t** entry)
+{
+    cpu_page_entry_t* table;
+    cpu_page_entry_t  table_entry;
+    uint32_t          level;
+
+    table = space->root;
+    for(level = VMM_ROOT_LEVEL; level > 0; --level)
+    {
+        table_entry = table[VMM_LEVEL_INDEX(virt, level)];
+        if((table_entry & CPU_PAGE_PRESENT) == 0)
+        {
+            return OS_ERR_MEMORY_NOT_MAPPED;
+        }
+
+        /* The large pages are never copy-on-write */
+        if(_vmm_is_page(table_entry, level) == TRUE)
+        {
+            return OS_ERR_UNAUTHORIZED_ACTION;
+        }
+        table = _vmm_get_table(table_entry);
+    }
+
+    *entry = &table[VMM_LEVEL_INDEX(virt, 0)];
+    if((**entry & CPU_PAGE_PRESENT) == 0)
+    {
+        return OS_ERR_MEMORY_NOT_MAPPED;
+    }
+
+    return ((**entry & CPU_PAGE_COW) != 0) ? OS_NO_ERR :
+                                              OS_ERR_UNAUTHORIZED_ACTION;
+}
+
+static cpu_page_entry_t _vmm_get_page_flags(const uint32_t flags)
+{
+    cpu_page_entry_t page_flags;
+
+    page_flags = CPU_PAGE_PRESENT;
+    if((flags & VMM_FLAG_COPY_ON_WRITE) != 0)
+    {
+        page_flags |= CPU_PAGE_COW;
+    }
+    else if((flags & VMM_FLAG_WRITE) != 0)
+    {
+        page_flags |= CPU_PAGE_WRITE;
+    }
+    if((flags & VMM_FLAG_PRIVATE) != 0)
+    {
+        page_flags |= CPU_PAGE_PRIVATE;
+    }
+    if((flags & VMM_FLAG_USER) != 0)
+    {
+        page_flags |= CPU_PAGE_USER;
+    }
+    if((flags & VMM_FLAG_UNCACHED) != 0 ||
+       ((flags & VMM_FLAG_WRITE_COMBINING) != 0 &&
+        cpu_is_write_combining_enabled() == FALSE))
+    {
+        page_flags |= CPU_PAGE_WRITE_THROUGH | CPU_PAGE_CACHE_DISABLE;
+    }
+    else if((flags & VMM_FLAG_WRITE_COMBINING) != 0)
+    {
+        page_flags |= CPU_PAGE_WRITE_COMBINING;
+    }
+
+    return page_flags;
+}
+
+static uint32_t _vmm_get_mapping_flags(const cpu_page_entry_t entry)
+{
+    uint32_t flags;
+
+    flags = 0;
+    if((entry & CPU_PAGE_COW) != 0)
+    {
+        flags |= VMM_FLAG_COPY_ON_WRITE;
+    }
+    else if((entry & CPU_PAGE_WRITE) != 0)
+    {
+        flags |= VMM_FLAG_WRITE;
+    }
+    if((entry & CPU_PAGE_PRIVATE) != 0)
+    {
+        flags |= VMM_FLAG_PRIVATE;
+    }
+    if((entry & CPU_PAGE_USER) != 0)
+    {
+        flags |= VMM_FLAG_USER;
+    }
+    if((entry & CPU_PAGE_CACHE_DISABLE) != 0)
+    {
+        flags |= VMM_FLAG_UNCACHED;
+    }
+    else if((entry & CPU_PAGE_WRITE_COMBINING) != 0)
+    {
+        flags |= VMM_FLAG_WRITE_COMBINING;
+    }
+
+    return flags;
+}
+
+static bool_t _vmm_check_args(const uintptr_t virt, const size_t size)
+{
+    if(vmm_initialized == FALSE || size == 0 ||
+       (virt & (VMM_PAGE_SIZE - 1)) != 0 ||
+       (size & (VMM_PAGE_SIZE - 1)) != 0)
+    {
+        return FALSE;
+    }
+
+    /* The range cannot wrap around the address space */
+    return virt + size > virt;
+}
+
+static bool_t _vmm_check_user_args(const uintptr_t virt, const size_t size)
+{
+    if(_vmm_check_args(virt, size) == FALSE)
+    {
+        return FALSE;
+    }
+
+    return virt >= (uintptr_t)KERNEL_USER_SPACE_START &&
+           virt + size <= (uintptr_t)KERNEL_USER_SPACE_END;
+}
+
+static OS_RETURN_E _vmm_alloc_pcid(uint32_t* pcid)
+{
+    uint32_t i;
+    uint32_t free_bits;
+
+    if(cpu_is_pcid_enabled() == FALSE)
+    {
+        *pcid = 0;
+        return OS_NO_ERR;
+    }
+
+    for(i = 0; i < VMM_PCID_MAP_SIZE; ++i)
+    {
+        free_bits = ~vmm_pcid_map[i];
+        if(free_bits != 0)
+        {
+            vmm_pcid_map[i] |= free_bits & -free_bits;
+            *pcid = i * 32 + __builtin_ctz(free_bits);
+            return OS_NO_ERR;
+        }
+    }
+
+    return OS_ERR_NO_MORE_MEMORY;
+}
+
+static OS_RETURN_E _vmm_space_map(vmm_space_t* space,
+                                  const uintptr_t virt,
+                                  const uintptr_t phys,
+                                  const size_t size,
+                                  const uint32_t flags)
+{
+    vmm_tlb_batch_t batch;
+    OS_RETURN_E     err;
+    uint32_t        int_state;
+
+    _vmm_batch_init(&batch, space);
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(vmm_lock, int_state);
+
+    if(_vmm_check_range(space->root, VMM_ROOT_LEVEL,
+                        virt, virt + size, FALSE) == FALSE)
+    {
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(vmm_lock, int_state);
+        return OS_ERR_MAPPING_ALREADY_EXISTS;
+    }
+
+    err = _vmm_map_range(space->root, VMM_ROOT_LEVEL, virt, virt + size, phys,
+                         _vmm_get_page_flags(flags), &batch);
+    if(err != OS_NO_ERR)
+    {
+        /* The range was not mapped, only the new mappings are removed */
+        _vmm_unmap_range(space->root, VMM_ROOT_LEVEL, virt, virt + size,
+                         &batch);
+    }
+    _vmm_commit_unlock(space, &batch, int_state);
+
+    KERNEL_DEBUG(VMM_DEBUG_ENABLED, MODULE_NAME,
+                 "Mapped 0x%p to 0x%p, size 0x%p, flags 0x%x, error %d",
+                 virt, phys, size, flags, err);
+
+    return err;
+}
+
+static OS_RETURN_E _vmm_space_unmap(vmm_space_t* space,
+                                    const vmm_range_t* ranges,
+                                    const uint32_t count)
+{
+    vmm_tlb_batch_t batch;
+    OS_RETURN_E     err;
+    uint32_t        int_state;
+    uint32_t        i;
+
+    _vmm_batch_init(&batch, space);
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(vmm_lock, int_state);
+
+    err = OS_NO_ERR;
+    for(i = 0; i < count && err == OS_NO_ERR; ++i)
+    {
+        err = _vmm_unmap_range(space->root, VMM_ROOT_LEVEL, ranges[i].virt,
+                               ranges[i].virt + ranges[i].size, &batch);
+    }
+    _vmm_commit_unlock(space, &batch, int_state);
+
+    KERNEL_DEBUG(VMM_DEBUG_ENABLED, MODULE_NAME,
+                 "Unmapped %u ranges from 0x%p, size 0x%p, error %d",
+                 count, ranges[0].virt, ranges[0].size, err);
+
+    return err;
+}
+
+static OS_RETURN_E _vmm_space_protect(vmm_space_t* space,
+                                      const uintptr_t virt,
+                                      const size_t size,
+                                      const uint32_t flags)
+{
+    vmm_tlb_batch_t batch;
+    OS_RETURN_E     err;
+    uint32_t        int_state;
+
+    _vmm_batch_init(&batch, space);
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(vmm_lock, int_state);
+
+    if(_vmm_check_range(space->root, VMM_ROOT_LEVEL,
+                        virt, virt + size, TRUE) == FALSE)
+    {
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(vmm_lock, int_state);
+        return OS_ERR_MEMORY_NOT_MAPPED;
+    }
+
+    /* The frames ownership and the copy-on-write state are kept */
+    err = _vmm_protect_range(space->root, VMM_ROOT_LEVEL, virt, virt + size,
+                             _vmm_get_page_flags(flags) & VMM_ENTRY_FLAGS_MASK,
+                             &batch);
+    _vmm_commit_unlock(space, &batch, int_state);
+
+    KERNEL_DEBUG(VMM_DEBUG_ENABLED, MODULE_NAME,
+                 "Protected 0x%p, size 0x%p, flags 0x%x, error %d",
+                 virt, size, flags, err);
+
+    return err;
+}
+
+static OS_RETURN_E _vmm_space_get_mapping(const vmm_space_t* space,
+                                          const uintptr_t virt,
+                                          uintptr_t* phys,
+                                          uint32_t* flags,
+                                          size_t* page_size)
+{
+    const cpu_page_entry_t* table;
+    cpu_page_entry_t        entry;
+    uint32_t                level;
+    uint32_t                int_state;
+
+    if(phys == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(vmm_initialized == FALSE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(vmm_lock, int_state);
+
+    table = space->root;
+    level = VMM_ROOT_LEVEL;
+    while(TRUE)
+    {
+        entry = table[VMM_LEVEL_INDEX(virt, level)];
+        if((entry & CPU_PAGE_PRESENT) == 0)
+        {
+            KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(vmm_lock, int_state);
+            return OS_ERR_MEMORY_NOT_MAPPED;
+        }
+        if(_vmm_is_page(entry, level) == TRUE)
+        {
+            break;
+        }
+        table = _vmm_get_table(entry);
+        --level;
+    }
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(vmm_lock, int_state);
+
+    *phys = ((uintptr_t)(entry & CPU_PAGE_ADDR_MASK) &
+             ~(VMM_LEVEL_SIZE(level) - 1)) |
+            (virt & (VMM_LEVEL_SIZE(level) - 1));
+    if(flags != NULL)
+    {
+        *flags = _vmm_get_mapping_flags(entry);
+    }
+    if(page_size != NULL)
+    {
+        *page_size = VMM_LEVEL_SIZE(level);
+    }
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E vmm_init(void)
+{
+    if(vmm_initialized == TRUE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    vmm_kernel_space.root     = (cpu_page_entry_t*)(_cpu_get_page_directory() +
+                                                    KERNEL_MEM_OFFSET);
+    vmm_kernel_space.pcid     = 0;
+    vmm_kernel_space.cpu_mask = 0;
+    vmm_kernel_space.next     = NULL;
+    vmm_max_page_level        = _cpu_get_max_page_level();
+
+    /* The PCID 0 tags the kernel address space */
+    memset(vmm_pcid_map, 0, sizeof(vmm_pcid_map));
+    vmm_pcid_map[0] = 1;
+
+    KERNEL_SPINLOCK_INIT(vmm_lock);
+    vmm_initialized = TRUE;
+
+    KERNEL_DEBUG(VMM_DEBUG_ENABLED, MODULE_NAME,
+                 "VMM initialized, root 0x%p, largest page 0x%p, PCIDs %u",
+                 vmm_kernel_space.root, VMM_LEVEL_SIZE(vmm_max_page_level),
+                 cpu_is_pcid_enabled());
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E vmm_init_cpu(const uint32_t cpu_id)
+{
+    if(vmm_initialized == FALSE || cpu_id >= MAX_CPU_COUNT)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    vmm_cpu_spaces[cpu_id] = &vmm_kernel_space;
+    __atomic_fetch_or(&vmm_online_cpus, 1U << cpu_id, __ATOMIC_SEQ_CST);
+
+    /* The kernel address space might have changed since the CPU booted */
+    if(cpu_is_pcid_enabled() == TRUE)
+    {
+        _cpu_invalidate_all_pcids();
+    }
+    else
+    {
+        _cpu_set_page_directory(_cpu_get_page_directory());
+    }
+
+    KERNEL_DEBUG(VMM_DEBUG_ENABLED, MODULE_NAME,
+                 "CPU %u added to the TLB shootdowns", cpu_id);
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E vmm_map(const uintptr_t virt,
+                    const uintptr_t phys,
+                    const size_t size,
+                    const uint32_t flags)
+{
+    if(_vmm_check_args(virt, size) == FALSE ||
+       (phys & (VMM_PAGE_SIZE - 1)) != 0)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    return _vmm_space_map(&vmm_kernel_space, virt, phys, size, flags);
+}
+
+OS_RETURN_E vmm_unmap(const uintptr_t virt, const size_t size)
+{
+    vmm_range_t range;
+
+    if(_vmm_check_args(virt, size) == FALSE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    range.virt = virt;
+    range.size = size;
+
+    return _vmm_space_unmap(&vmm_kernel_space, &range, 1);
+}
+
+OS_RETURN_E vmm_map_fault(const uintptr_t virt,
+                          const uintptr_t phys,
+                          const uint32_t flags)
+{
+    cpu_page_entry_t* table;
+    cpu_page_entry_t  entry;
+    cpu_page_entry_t  expected;
+    uint32_t          level;
+
+    if(vmm_initialized == FALSE ||
+       (virt & (VMM_PAGE_SIZE - 1)) != 0 ||
+       (phys & (VMM_PAGE_SIZE - 1)) != 0)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    /* The structures are kept by the caller, only the page entry changes */
+    table = vmm_kernel_space.root;
+    for(level = VMM_ROOT_LEVEL; level > 0; --level)
+    {
+        entry = __atomic_load_n(&table[VMM_LEVEL_INDEX(virt, level)],
+                                __ATOMIC_ACQUIRE);
+        if((entry & CPU_PAGE_PRESENT) == 0 ||
+           _vmm_is_page(entry, level) == TRUE)
+        {
+            return OS_ERR_MEMORY_NOT_MAPPED;
+        }
+        table = _vmm_get_table(entry);
+    }
+
+    /* The lock holders might update the other entries of the table */
+    expected = 0;
+    if(__atomic_compare_exchange_n(&table[VMM_LEVEL_INDEX(virt, 0)],
+                                   &expected,
+                                   phys | _vmm_get_page_flags(flags),
+                                   FALSE,
+                                   __ATOMIC_RELEASE,
+                                   __ATOMIC_RELAXED) == FALSE)
+    {
+        return OS_ERR_MAPPING_ALREADY_EXISTS;
+    }
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E vmm_protect(const uintptr_t virt,
+                        const size_t size,
+                        const uint32_t flags)
+{
+    if(_vmm_check_args(virt, size) == FALSE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    return _vmm_space_protect(&vmm_kernel_space, virt, size, flags);
+}
+
+OS_RETURN_E vmm_get_physical(const uintptr_t virt, uintptr_t* phys)
+{
+    return _vmm_space_get_mapping(&vmm_kernel_space, virt, phys, NULL, NULL);
+}
+
+OS_RETURN_E vmm_get_mapping(const uintptr_t virt,
+                            uintptr_t* phys,
+                            uint32_t* flags,
+                            size_t* page_size)
+{
+    if(flags == NULL || page_size == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    return _vmm_space_get_mapping(&vmm_kernel_space, virt, phys, flags,
+                                  page_size);
+}
+
+OS_RETURN_E vmm_space_create(vmm_space_t** space)
+{
+    vmm_space_t* new_space;
+    OS_RETURN_E  err;
+    uint32_t     int_state;
+
+    if(space == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(vmm_initialized == FALSE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    new_space = kmalloc(sizeof(vmm_space_t));
+    if(new_space == NULL)
+    {
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+    new_space->root = kmalloc(VMM_TABLE_SIZE);
+    if(new_space->root == NULL)
+    {
+        kfree(new_space);
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+    new_space->cpu_mask = 0;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(vmm_lock, int_state);
+
+    err = _vmm_alloc_pcid(&new_space->pcid);
+    if(err != OS_NO_ERR)
+    {
+        KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(vmm_lock, int_state);
+        kfree(new_space->root);
+        kfree(new_space);
+        return err;
+    }
+
+    /* Only the user range is private to the space */
+    memcpy(new_space->root, vmm_kernel_space.root, VMM_TABLE_SIZE);
+    memset(new_space->root + VMM_USER_ROOT_FIRST, 0,
+           (VMM_USER_ROOT_LAST - VMM_USER_ROOT_FIRST + 1) *
+           sizeof(cpu_page_entry_t));
+
+    new_space->next = vmm_spaces;
+    vmm_spaces      = new_space;
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(vmm_lock, int_state);
+
+    KERNEL_DEBUG(VMM_DEBUG_ENABLED, MODULE_NAME,
+                 "Created address space 0x%p, PCID %u",
+                 new_space, new_space->pcid);
+
+    *space = new_space;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E vmm_space_destroy(vmm_space_t* space)
+{
+    vmm_tlb_batch_t batch;
+    vmm_space_t**   link;
+    uint32_t        int_state;
+    uint32_t        i;
+
+    if(space == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(space == &vmm_kernel_space)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    _vmm_batch_init(&batch, space);
+    batch.flush_all = TRUE;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(vmm_lock, int_state);
+
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        if(vmm_cpu_spaces[i] == space)
+        {
+            KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(vmm_lock, int_state);
+            return OS_ERR_RESOURCE_BUSY;
+        }
+    }
+
+    link = &vmm_spaces;
+    while(*link != space)
+    {
+        link = &(*link)->next;
+    }
+    *link = space->next;
+
+    for(i = VMM_USER_ROOT_FIRST; i <= VMM_USER_ROOT_LAST; ++i)
+    {
+        if((space->root[i] & CPU_PAGE_PRESENT) != 0 &&
+           _vmm_is_page(space->root[i], VMM_ROOT_LEVEL) == FALSE)
+        {
+            _vmm_free_table(space->root[i], VMM_ROOT_LEVEL - 1, &batch);
+        }
+    }
+
+    /* The PCID is reused once its TLB entries are invalidated */
+    _vmm_commit_unlock(space, &batch, int_state);
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(vmm_lock, int_state);
+    vmm_pcid_map[space->pcid / 32] &= ~(1U << (space->pcid % 32));
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(vmm_lock, int_state);
+
+    KERNEL_DEBUG(VMM_DEBUG_ENABLED, MODULE_NAME,
+                 "Destroyed address space 0x%p, PCID %u",
+                 space, space->pcid);
+
+    kfree(space->root);
+    kfree(space);
+
+    return OS_NO_ERR;
+}
+
+void vmm_space_switch(vmm_space_t* space)
+{
+    vmm_space_t* previous;
+    uint32_t     cpu_id;
+    uint32_t     mask;
+    bool_t       keep_tlb;
+
+    if(space == NULL)
+    {
+        space = &vmm_kernel_space;
+    }
+
+    cpu_id   = scheduler_get_current_cpu_id();
+    previous = vmm_cpu_spaces[cpu_id];
+    if(previous == space)
+    {
+        return;
+    }
+    vmm_cpu_spaces[cpu_id] = space;
+
+    /* The shootdowns of the space target the CPU before it is loaded */
+    mask     = 1U << cpu_id;
+    keep_tlb = ((__atomic_fetch_or(&space->cpu_mask, mask, __ATOMIC_SEQ_CST) &
+                 mask) != 0 || space == &vmm_kernel_space);
+
+    if(cpu_is_pcid_enabled() == TRUE)
+    {
+        /* The CPU received all the shootdowns since it first used the PCID */
+        _cpu_set_page_directory_pcid((uintptr_t)space->root -
+                                     KERNEL_MEM_OFFSET,
+                                     space->pcid, keep_tlb);
+    }
+    else
+    {
+        _cpu_set_page_directory((uintptr_t)space->root - KERNEL_MEM_OFFSET);
+
+        /* Loading the new space flushed the previous one entries */
+        __atomic_fetch_and(&previous->cpu_mask, ~mask, __ATOMIC_SEQ_CST);
+    }
+}
+
+OS_RETURN_E vmm_space_map(vmm_space_t* space,
+                          const uintptr_t virt,
+                          const uintptr_t phys,
+                          const size_t size,
+                          const uint32_t flags)
+{
+    if(space == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(_vmm_check_user_args(virt, size) == FALSE ||
+       (phys & (VMM_PAGE_SIZE - 1)) != 0)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    return _vmm_space_map(space, virt, phys, size, flags);
+}
+
+OS_RETURN_E vmm_space_unmap(vmm_space_t* space,
+                            const uintptr_t virt,
+                            const size_t size)
+{
+    vmm_range_t range;
+
+    range.virt = virt;
+    range.size = size;
+
+    return vmm_space_unmap_ranges(space, &range, 1);
+}
+
+OS_RETURN_E vmm_space_unmap_ranges(vmm_space_t* space,
+                                   const vmm_range_t* ranges,
+                                   const uint32_t count)
+{
+    uint32_t i;
+
+    if(space == NULL || ranges == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(count == 0)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    for(i = 0; i < count; ++i)
+    {
+        if(_vmm_check_user_args(ranges[i].virt, ranges[i].size) == FALSE)
+        {
+            return OS_ERR_UNAUTHORIZED_ACTION;
+        }
+    }
+
+    return _vmm_space_unmap(space, ranges, count);
+}
+
+OS_RETURN_E vmm_space_protect(vmm_space_t* space,
+                              const uintptr_t virt,
+                              const size_t size,
+                              const uint32_t flags)
+{
+    if(space == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(_vmm_check_user_args(virt, size) == FALSE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    return _vmm_space_protect(space, virt, size, flags);
+}
+
+OS_RETURN_E vmm_space_get_physical(const vmm_space_t* space,
+                                   const uintptr_t virt,
+                                   uintptr_t* phys)
+{
+    if(space == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    return _vmm_space_get_mapping(space, virt, phys, NULL, NULL);
+}
+
+OS_RETURN_E vmm_space_get_mapping(const vmm_space_t* space,
+                                  const uintptr_t virt,
+                                  uintptr_t* phys,
+                                  uint32_t* flags,
+                                  size_t* page_size)
+{
+    if(space == NULL || flags == NULL || page_size == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    return _vmm_space_get_mapping(space, virt, phys, flags, page_size);
+}
+
+OS_RETURN_E vmm_space_clone(vmm_space_t* space, vmm_space_t** clone)
+{
+    vmm_tlb_batch_t batch;
+    vmm_space_t*    new_space;
+    OS_RETURN_E     err;
+    uint32_t        int_state;
+
+    if(space == NULL || clone == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(space == &vmm_kernel_space)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    err = vmm_space_create(&new_space);
+    if(err != OS_NO_ERR)
+    {
+        return err;
+    }
+
+    _vmm_batch_init(&batch, space);
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(vmm_lock, int_state);
+
+    err = _vmm_clone_table(space->root, new_space->root, VMM_ROOT_LEVEL, 0,
+                           VMM_USER_ROOT_FIRST, VMM_USER_ROOT_LAST, &batch);
+    if(err != OS_NO_ERR)
+    {
+        /* The source pages made copy-on-write are resolved by their faults */
+        _vmm_release_private(new_space->root, VMM_ROOT_LEVEL,
+                             VMM_USER_ROOT_FIRST, VMM_USER_ROOT_LAST);
+    }
+
+    /* The source pages lose their write access on all the CPUs */
+    _vmm_commit_unlock(space, &batch, int_state);
+
+    KERNEL_DEBUG(VMM_DEBUG_ENABLED, MODULE_NAME,
+                 "Cloned address space 0x%p to 0x%p, %u pages protected, "
+                 "error %d", space, new_space, batch.page_count, err);
+
+    if(err != OS_NO_ERR)
+    {
+        (void)vmm_space_destroy(new_space);
+        return err;
+    }
+
+    *clone = new_space;
+
+    return OS_NO_ERR;
+}
+
+OS_RETURN_E vmm_space_get_cow_frame(const vmm_space_t* space,
+                                    const uintptr_t virt,
+                                    uintptr_t* phys)
+{
+    cpu_page_entry_t* entry;
+    OS_RETURN_E       err;
+    uint32_t          int_state;
+
+    if(space == NULL || phys == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(_vmm_check_user_args(virt, VMM_PAGE_SIZE) == FALSE)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(vmm_lock, int_state);
+
+    err = _vmm_get_cow_entry(space, virt, &entry);
+    if(err == OS_NO_ERR)
+    {
+        *phys = (uintptr_t)(*entry & CPU_PAGE_ADDR_MASK);
+    }
+
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(vmm_lock, int_state);
+
+    return err;
+}
+
+OS_RETURN_E vmm_space_resolve_cow(vmm_space_t* space,
+                                  const uintptr_t virt,
+                                  const uintptr_t phys)
+{
+    vmm_tlb_batch_t   batch;
+    cpu_page_entry_t* entry;
+    OS_RETURN_E       err;
+    uint32_t          int_state;
+
+    if(space == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(_vmm_check_user_args(virt, VMM_PAGE_SIZE) == FALSE ||
+       (phys & (VMM_PAGE_SIZE - 1)) != 0)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+
+    _vmm_batch_init(&batch, space);
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(vmm_lock, int_state);
+
+    err = _vmm_get_cow_entry(space, virt, &entry);
+    if(err == OS_NO_ERR)
+    {
+        /* The other threads must not keep reading the previous frame */
+        *entry = phys | (*entry & VMM_ENTRY_FLAGS_MASK) | CPU_PAGE_WRITE |
+                 CPU_PAGE_PRIVATE;
+        _vmm_batch_add(&batch, virt, 0);
+    }
+
+    _vmm_commit_unlock(space, &batch, int_state);
+
+    KERNEL_DEBUG(VMM_DEBUG_ENABLED, MODULE_NAME,
+                 "Resolved copy-on-write page 0x%p to 0x%p, error %d",
+                 virt, phys, err);
+
+    return err;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,136 @@
+/*******************************************************************************
+ * @file wait_queue.c
+ *
+ * @see wait_queue.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Threads wait queue.
+ *
+ * @details Threads wait queue used by the blocking synchronization primitives.
+ * The queue is intrusive: each waiting thread links a node allocated on its
+ * own stack, the queue never allocates memory. The nodes are kept sorted by
+ * priority, threads of the same priority are served in their arrival order.
+ * The wait queue is not thread safe, the caller is responsible for the
+ * locking.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>             /* Generic int types */
+#include <stddef.h>             /* Standard definitions */
+#include <ctrl_block.h>         /* Threads control blocks */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <wait_queue.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+void wait_queue_init(wait_queue_t* queue)
+{
+    queue->head = NULL;
+}
+
+void wait_queue_insert(wait_queue_t* queue,
+                       wait_queue_node_t* node,
+                       kernel_thread_t* thread)
+{
+    wait_queue_node_t** link;
+
+    node->thread   = thread;
+    node->priority = thread->priority;
+    node->woken    = FALSE;
+
+    /* Lower values are higher priorities */
+    link = &queue->head;
+    while(*link != NULL && (*link)->priority <= node->priority)
+    {
+        link = &(*link)->next;
+    }
+
+    node->next = *link;
+    *link      = node;
+}
+
+wait_queue_node_t* wait_queue_pop(wait_queue_t* queue)
+{
+    wait_queue_node_t* node;
+
+    node = queue->head;
+    if(node != NULL)
+    {
+        queue->head = node->next;
+        node->next  = NULL;
+    }
+
+    return node;
+}
+
+void wait_queue_remove(wait_queue_t* queue, const wait_queue_node_t* node)
+{
+    wait_queue_node_t** link;
+
+    link = &queue->head;
+    while(*link != NULL)
+    {
+        if(*link == node)
+        {
+            *link = node->next;
+            return;
+        }
+        link = &(*link)->next;
+    }
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -2,4 +2,7 @@ DEP_INCLUDES  = -I ../Libs/libc/includes
 DEP_INCLUDES += -I ../Libs/libapi/includes
 DEP_INCLUDES += -I ../Libs/libtrace/includes
 
+ARCH_CPU_DIR = ../Arch/CPU
+include $(ARCH_CPU_DIR)/cpu_includes.mk
+
 DEP_LIBS =
\ No newline at end of file
@@ -7,13 +7,14 @@
  *
  * @date 30/03/2023
  *
- * @version 2.0
+ * @version 3.0
  *
  * @brief Console drivers abtraction.
  *
  * @details Console driver abtraction layer. The functions of this module allows
  * to abtract the use of any supported console driver and the selection of the
- * desired driver.
+ * desired drivers. The output is sent to every registered driver, each driver
+ * can be given its own queue drained asynchronously.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -33,7 +34,8 @@
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Maximal number of console drivers receiving the output. */
+#define CONSOLE_MAX_SINKS 4
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
@@ -218,15 +220,85 @@ typedef struct
 /**
  * @brief Sets the current selected driver.
  *
- * @details Changes the current selected driver to ouput data with the new one
- * as defined by the parameter driver.
+ * @details Replaces the registered drivers with the driver given as parameter,
+ * which becomes the only driver receiving the output.
  *
  * @param[in] driver The driver to select.
  *
  * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the driver or one of its mandatory
+ * functions is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if a driver output is queued.
  */
 OS_RETURN_E console_set_selected_driver(const kernel_console_driver_t* driver);
 
+/**
+ * @brief Adds a driver to the console output.
+ *
+ * @details Registers the driver given as parameter, the output is then sent to
+ * all the registered drivers. The output of the driver is synchronous until
+ * its queue is enabled.
+ *
+ * @param[in] driver The driver to add.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the driver or one of its mandatory
+ * functions is NULL.
+ * - OS_ERR_NO_MORE_MEMORY is returned if CONSOLE_MAX_SINKS drivers are
+ * already registered.
+ */
+OS_RETURN_E console_add_driver(const kernel_console_driver_t* driver);
+
+/**
+ * @brief Returns the number of registered drivers.
+ *
+ * @details Returns the number of registered drivers, the drivers are
+ * identified by their registration index.
+ *
+ * @return The number of registered drivers.
+ */
+uint32_t console_get_sink_count(void);
+
+/**
+ * @brief Queues the output of a driver.
+ *
+ * @details Queues the output sent to the driver given as parameter instead of
+ * calling it. The notify function is called each time the queue is filled and
+ * must result in a later call to console_drain_sink. The output is dropped
+ * when the queue is full so the callers are never held back.
+ *
+ * @param[in] sink The registration index of the driver.
+ * @param[in] notify The function called when the queue is filled.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if notify is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if the driver is not registered.
+ */
+OS_RETURN_E console_enable_sink_queue(const uint32_t sink,
+                                      void (*notify)(const uint32_t sink));
+
+/**
+ * @brief Sends the queued output to a driver.
+ *
+ * @details Calls the driver given as parameter for each operation of its queue
+ * until the queue is empty. Only one caller can drain a queue at a time.
+ *
+ * @param[in] sink The registration index of the driver.
+ */
+void console_drain_sink(const uint32_t sink);
+
+/**
+ * @brief Disables the queues of all the drivers.
+ *
+ * @details Sends the queued output and makes every driver synchronous again.
+ * No lock is taken, this function is meant to be used by the panic handler
+ * once the other CPUs are stopped.
+ */
+void console_disable_sink_queues(void);
+
 /**
  * @brief Clears the screen, the background color is set to black.
  */
@@ -247,7 +319,8 @@ void console_put_cursor_at(const uint32_t line, const uint32_t column);
  * @brief Saves the cursor attributes in the buffer given as paramter.
  *
  * @details Fills the buffer given s parameter with the current value of the
- * cursor.
+ * cursor. The cursor of the first driver that supports it is returned, the
+ * operations still queued for this driver are not accounted for.
  *
  * @param[out] buffer The cursor buffer in which the current cursor position is
  * going to be saved.
@@ -7,14 +7,18 @@
  *
  * @date 30/03/2023
  *
- * @version 2.1
+ * @version 3.0
  *
  * @brief Kernel's output methods.
  *
  * @details Simple output functions to print messages to screen. These are
  * really basic output too allow early kernel boot output and debug. These
  * functions can be used in interrupts handlers since no lock is required to use
- * them. This also makes them non thread safe.
+ * them. This also makes them non thread safe. Once the kernel log is enabled,
+ * the messages are stored in lock-free per-CPU log rings and rendered to the
+ * console by the log consumer. When DEBUG_LOG_BINARY is set, the debug
+ * messages only record their format and raw arguments, they are formated when
+ * the kernel log is rendered.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -26,19 +30,53 @@
  * INCLUDES
  ******************************************************************************/
 
-/* None */
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* uintptr_t */
+#include <kerror.h> /* Kernel error codes */
 
 /*******************************************************************************
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Maximal number of raw arguments of a binary debug message. */
+#define KERNEL_LOG_BINARY_MAX_ARGS 10
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
 
-/* None */
+/** @brief Defines the sources and the consumer of the kernel log. */
+typedef struct
+{
+    /**
+     * @brief The function should return the identifier of the current CPU.
+     *
+     * @details The function should return the identifier of the current CPU,
+     * it is called from any context, interrupt handlers included.
+     *
+     * @return The identifier of the current CPU.
+     */
+    uint32_t (*get_cpu_id)(void);
+
+    /**
+     * @brief The function should return the current time.
+     *
+     * @details The function should return the current time in nanoseconds,
+     * it is called from any context, interrupt handlers included.
+     *
+     * @return The current time in nanoseconds.
+     */
+    uint64_t (*get_time_ns)(void);
+
+    /**
+     * @brief The function should notify the log consumer.
+     *
+     * @details The function is called once a message is stored in the log and
+     * should result in a later call to kernel_output_drain_log. It is called
+     * from any context, interrupt handlers included.
+     */
+    void (*notify)(void);
+} kernel_log_driver_t;
 
 /*******************************************************************************
  * MACROS
@@ -61,7 +99,76 @@
 
 #define KERNEL_GET_TIME 0
 
+/** @brief Counts the arguments given to the macro, up to 16. */
+#define KERNEL_LOG_ARG_COUNT(...)                                       \
+    _KERNEL_LOG_ARG_COUNT(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9,   \
+                          8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define _KERNEL_LOG_ARG_COUNT(A1, A2, A3, A4, A5, A6, A7, A8, A9, A10,  \
+                              A11, A12, A13, A14, A15, A16, N, ...) N
+
+/**
+ * @brief Converts an argument to a raw argument word. The 64 bits integers are
+ * kept as is, the other arguments, pointers included, are converted through
+ * uintptr_t.
+ */
+#define KERNEL_LOG_WORD(ARG)                                            \
+    ((uint64_t)_Generic((ARG),                                          \
+                        long long: (ARG),                               \
+                        unsigned long long: (ARG),                      \
+                        default: (uintptr_t)(ARG)))
+
+/** @brief Converts the arguments given to the macro to raw argument words. */
+#define KERNEL_LOG_WORDS(...)                                           \
+    _KERNEL_LOG_WORDS(KERNEL_LOG_ARG_COUNT(__VA_ARGS__), __VA_ARGS__)
+#define _KERNEL_LOG_WORDS(N, ...)  __KERNEL_LOG_WORDS(N, __VA_ARGS__)
+#define __KERNEL_LOG_WORDS(N, ...) _KERNEL_LOG_WORDS_##N(__VA_ARGS__)
+#define _KERNEL_LOG_WORDS_1(A) KERNEL_LOG_WORD(A)
+#define _KERNEL_LOG_WORDS_2(A, ...)                                     \
+    KERNEL_LOG_WORD(A), _KERNEL_LOG_WORDS_1(__VA_ARGS__)
+#define _KERNEL_LOG_WORDS_3(A, ...)                                     \
+    KERNEL_LOG_WORD(A), _KERNEL_LOG_WORDS_2(__VA_ARGS__)
+#define _KERNEL_LOG_WORDS_4(A, ...)                                     \
+    KERNEL_LOG_WORD(A), _KERNEL_LOG_WORDS_3(__VA_ARGS__)
+#define _KERNEL_LOG_WORDS_5(A, ...)                                     \
+    KERNEL_LOG_WORD(A), _KERNEL_LOG_WORDS_4(__VA_ARGS__)
+#define _KERNEL_LOG_WORDS_6(A, ...)                                     \
+    KERNEL_LOG_WORD(A), _KERNEL_LOG_WORDS_5(__VA_ARGS__)
+#define _KERNEL_LOG_WORDS_7(A, ...)                                     \
+    KERNEL_LOG_WORD(A), _KERNEL_LOG_WORDS_6(__VA_ARGS__)
+#define _KERNEL_LOG_WORDS_8(A, ...)                                     \
+    KERNEL_LOG_WORD(A), _KERNEL_LOG_WORDS_7(__VA_ARGS__)
+#define _KERNEL_LOG_WORDS_9(A, ...)                                     \
+    KERNEL_LOG_WORD(A), _KERNEL_LOG_WORDS_8(__VA_ARGS__)
+#define _KERNEL_LOG_WORDS_10(A, ...)                                    \
+    KERNEL_LOG_WORD(A), _KERNEL_LOG_WORDS_9(__VA_ARGS__)
+
 #if KERNEL_LOG_LEVEL >= DEBUG_LOG_LEVEL
+#if DEBUG_LOG_BINARY
+/* The string arguments must point to persistent storage, they are only read
+ * when the message is rendered.
+ */
+#define KERNEL_DEBUG(ENABLED, MODULE, STR, ...)                         \
+do {                                                                    \
+    if(ENABLED)                                                         \
+    {                                                                   \
+        _Static_assert(KERNEL_LOG_ARG_COUNT(KERNEL_GET_TIME,            \
+                                            ##__VA_ARGS__,              \
+                                            __LINE__) <=                \
+                       KERNEL_LOG_BINARY_MAX_ARGS,                      \
+                       "Too many arguments for a binary debug message");\
+        kernel_debug_binary("[%d]" MODULE " | " STR " | " __FILE__      \
+                            ":%d\n",                                    \
+                            KERNEL_LOG_ARG_COUNT(KERNEL_GET_TIME,       \
+                                                 ##__VA_ARGS__,         \
+                                                 __LINE__),             \
+                            (const uint64_t[]){                         \
+                                KERNEL_LOG_WORDS(KERNEL_GET_TIME,       \
+                                                 ##__VA_ARGS__,         \
+                                                 __LINE__)              \
+                            });                                         \
+    }                                                                   \
+} while(0);
+#else
 #define KERNEL_DEBUG(ENABLED, MODULE, STR, ...)                         \
 do {                                                                    \
     if(ENABLED)                                                         \
@@ -70,6 +177,7 @@ do {                                                                    \
                         KERNEL_GET_TIME, ##__VA_ARGS__, __LINE__);      \
     }                                                                   \
 } while(0);
+#endif
 #else
 #define KERNEL_DEBUG(...)
 #endif
@@ -150,6 +258,25 @@ void kernel_info(const char *fmt, ...);
  */
 void kernel_debug(const char *fmt, ...);
 
+/**
+ * @brief Records a debug message as its format and raw arguments.
+ *
+ * @details Stores the format pointer and the raw arguments words of a debug
+ * message in the kernel log. The message is formated when the log is rendered,
+ * the format and the string arguments must then point to persistent storage.
+ * The message is formated directly if the kernel log is disabled. The
+ * arguments are read as 32 bits values unless the format uses the l length
+ * modifier twice.
+ *
+ * @param[in] fmt The format string to output.
+ * @param[in] arg_count The number of raw arguments words, at most
+ * KERNEL_LOG_BINARY_MAX_ARGS.
+ * @param[in] args The raw arguments words.
+ */
+void kernel_debug_binary(const char* fmt,
+                         const uint32_t arg_count,
+                         const uint64_t* args);
+
 /**
  * @brief Prints the desired string to the screen.
  *
@@ -176,6 +303,62 @@ void kernel_warning(const char *fmt, ...);
  */
 void kernel_doprint(const char* str, __builtin_va_list args);
 
+/**
+ * @brief Stores the kernel messages in the kernel log.
+ *
+ * @details Stores the kernel messages in the per-CPU log rings instead of
+ * outputing them. Writing a message then only copies its formated text. The
+ * messages are rendered to the console by kernel_output_drain_log.
+ *
+ * @param[in] driver The log sources and consumer.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if the driver or one of its functions is
+ * NULL.
+ */
+OS_RETURN_E kernel_output_enable_log(const kernel_log_driver_t* driver);
+
+/**
+ * @brief Outputs the kernel messages directly.
+ *
+ * @details Stops storing the kernel messages in the kernel log, they are
+ * output directly again. The messages not rendered yet stay in the log.
+ */
+void kernel_output_disable_log(void);
+
+/**
+ * @brief Sets the function receiving a copy of the rendered text.
+ *
+ * @details Sets the function receiving a copy of the text rendered to the
+ * console, tags included. The function is called in the rendering context and
+ * must not output anything. This is meant to be used by the panic handler to
+ * record its output.
+ *
+ * @param[in] capture The function receiving the text, NULL to stop the copy.
+ */
+void kernel_output_set_capture(void (*capture)(const char* text));
+
+/**
+ * @brief Renders the kernel log to the console.
+ *
+ * @details Renders the messages stored in the kernel log to the console, in
+ * their time order. The messages overwritten before being rendered are lost.
+ * Only one thread can render the log at a time.
+ */
+void kernel_output_drain_log(void);
+
+/**
+ * @brief Dumps the last messages of the kernel log.
+ *
+ * @details Disables the kernel log and outputs the last slots stored in the
+ * log, rendered or not, with their time and CPU. No lock is taken, this
+ * function is meant to be used by the panic handler.
+ *
+ * @param[in] count The number of log slots to dump.
+ */
+void kernel_output_dump_log(const uint32_t count);
+
 #endif /* #ifndef __IO_KERNEL_OUTPUT_H_ */
 
 /************************************ EOF *************************************/
@@ -13,6 +13,8 @@
  * compilers to reorganize memory access.
  * So instead of doing : *addr = value, do
  * mapped_io_write(addr, value)
+ * The bulk accessors copy buffers to memory mapped IOs with non-temporal
+ * stores, combined in the CPU write buffers on write-combining mappings.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -24,7 +26,9 @@
  * INCLUDES
  ******************************************************************************/
 
-#include <stdint.h> /* Generic types */
+#include <stdint.h>       /* Generic types */
+#include <stddef.h>       /* Standard definitions */
+#include <cpu_features.h> /* CPU features registry */
 
 /*******************************************************************************
  * CONSTANTS
@@ -181,6 +185,87 @@ inline static uint64_t _mapped_io_read_64(const volatile void* addr)
     return *(volatile uint64_t*)(addr);
 }
 
+/**
+ * @brief Orders the memory mapped IO bulk writes.
+ *
+ * @details Orders the memory mapped IO bulk writes. The non-temporal stores
+ * are weakly ordered, the fence makes them visible before the next stores,
+ * such as the doorbell write announcing a ring update to a device.
+ */
+inline static void _mapped_io_write_fence(void)
+{
+#if defined(__i386__)
+    if(CPU_FEATURE_STATIC(CPU_FEATURE_SSE2))
+    {
+        __asm__ __volatile__("sfence" ::: "memory");
+    }
+    else
+    {
+        __asm__ __volatile__("" ::: "memory");
+    }
+#else
+    __asm__ __volatile__("sfence" ::: "memory");
+#endif
+}
+
+/**
+ * @brief Memory mapped IO bulk write access.
+ *
+ * @details Memory mapped IO bulk write access. The buffer is copied with
+ * MOVNTI non-temporal stores when the destination is aligned on the CPU word
+ * size and the CPU supports SSE2, the stores bypass the caches and are
+ * combined in full bus writes on write-combining mappings. The stores use the
+ * general purpose registers, the SIMD registers of the threads are not used.
+ * The remaining bytes are written one at a time. The copy ends with
+ * _mapped_io_write_fence.
+ *
+ * @param[out] addr The address of the IO to write.
+ * @param[in] buffer The data to write to the IO.
+ * @param[in] size The number of bytes to write.
+ */
+inline static void _mapped_io_write_stream(void* volatile addr,
+                                           const void* buffer,
+                                           size_t size)
+{
+    volatile uint8_t* dst;
+    const uint8_t*    src;
+    uintptr_t         word;
+    bool_t            stream;
+
+    dst = (volatile uint8_t*)addr;
+    src = (const uint8_t*)buffer;
+
+#if defined(__i386__)
+    stream = CPU_FEATURE_STATIC(CPU_FEATURE_SSE2);
+#else
+    stream = TRUE;
+#endif
+
+    if(stream == TRUE && ((uintptr_t)dst & (sizeof(uintptr_t) - 1)) == 0)
+    {
+        while(size >= sizeof(uintptr_t))
+        {
+            __builtin_memcpy(&word, src, sizeof(uintptr_t));
+            __asm__ __volatile__("movnti %1, %0"
+                                 : "=m" (*(volatile uintptr_t*)dst)
+                                 : "r" (word));
+            dst  += sizeof(uintptr_t);
+            src  += sizeof(uintptr_t);
+            size -= sizeof(uintptr_t);
+        }
+    }
+
+    while(size != 0)
+    {
+        *dst = *src;
+        ++dst;
+        ++src;
+        --size;
+    }
+
+    _mapped_io_write_fence();
+}
+
 #endif /* #ifndef __IO_MMIO_H_ */
 
 /************************************ EOF *************************************/
\ No newline at end of file
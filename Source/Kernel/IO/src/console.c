@@ -7,13 +7,16 @@
  *
  * @date 30/03/2023
  *
- * @version 2.0
+ * @version 3.0
  *
  * @brief Console drivers abtraction.
  *
  * @details Console driver abtraction layer. The functions of this module allows
  * to abtract the use of any supported console driver and the selection of the
- * desired driver.
+ * desired drivers. Each operation is sent to every registered driver. When the
+ * queue of a driver is enabled, the operations are copied to its ring buffer
+ * and the driver is called later by the drainer of the queue, a slow driver
+ * does not hold back the callers nor the other drivers.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -24,6 +27,8 @@
 
 /* Included headers */
 #include <stdint.h> /* Generic int types */
+#include <string.h> /* memcpy, strlen */
+#include <cpu.h>    /* Interrupt state */
 #include <kerror.h> /* Kernel error codes */
 
 /* Configuration files */
@@ -36,13 +41,91 @@
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Size of a driver queue in bytes, must be a power of 2. */
+#define CONSOLE_SINK_QUEUE_SIZE 4096
+
+/** @brief Maximal size of the text carried by a queued operation. */
+#define CONSOLE_OP_TEXT_SIZE 128
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
 
-/* None */
+/** @brief Console operations that can be queued. */
+typedef enum
+{
+    /** @brief Clears the screen. */
+    CONSOLE_OP_CLEAR_SCREEN,
+    /** @brief Places the cursor. */
+    CONSOLE_OP_PUT_CURSOR,
+    /** @brief Restores the cursor. */
+    CONSOLE_OP_RESTORE_CURSOR,
+    /** @brief Scrolls the screen. */
+    CONSOLE_OP_SCROLL,
+    /** @brief Sets the color scheme. */
+    CONSOLE_OP_SET_COLOR_SCHEME,
+    /** @brief Outputs a string. */
+    CONSOLE_OP_PUT_STRING,
+    /** @brief Outputs a string from a keyboard input. */
+    CONSOLE_OP_WRITE_KEYBOARD
+} CONSOLE_OP_E;
+
+/**
+ * @brief Queued console operation, the text of the operation follows it in the
+ * queue.
+ */
+typedef struct
+{
+    /** @brief The operation type. */
+    CONSOLE_OP_E type;
+
+    /** @brief Length of the text following the operation. */
+    uint32_t length;
+
+    /** @brief The operation arguments. */
+    union
+    {
+        /** @brief Cursor position, for the cursor operations. */
+        cursor_t cursor;
+
+        /** @brief Scroll arguments. */
+        struct
+        {
+            /** @brief The scroll direction. */
+            SCROLL_DIRECTION_E direction;
+            /** @brief The number of lines to scroll. */
+            uint32_t lines_count;
+        } scroll;
+
+        /** @brief Color scheme, for the color scheme operation. */
+        colorscheme_t color_scheme;
+    } args;
+} console_op_t;
+
+/** @brief Console driver receiving the output. */
+typedef struct
+{
+    /** @brief The driver. */
+    kernel_console_driver_t driver;
+
+    /** @brief Tells if the operations are queued instead of sent. */
+    volatile bool_t queued;
+
+    /** @brief Function called when the queue is filled. */
+    void (*notify)(const uint32_t sink);
+
+    /** @brief Queue write index. */
+    uint32_t head;
+
+    /** @brief Queue read index. */
+    uint32_t tail;
+
+    /** @brief Protects the queue. */
+    volatile uint32_t lock;
+
+    /** @brief Queued operations ring buffer. */
+    uint8_t queue[CONSOLE_SINK_QUEUE_SIZE];
+} console_sink_t;
 
 /*******************************************************************************
  * MACROS
@@ -61,31 +144,372 @@
 /* None */
 
 /************************** Static global variables ***************************/
-/** @brief Stores the currently selected driver */
-static kernel_console_driver_t console_driver = {NULL};
+/** @brief Stores the registered drivers. */
+static console_sink_t console_sinks[CONSOLE_MAX_SINKS];
+
+/** @brief Number of registered drivers. */
+static uint32_t console_sink_count = 0;
+
+/** @brief Last color scheme set on the console. */
+static colorscheme_t console_color_scheme;
+
+/** @brief Tells if a color scheme was set on the console. */
+static bool_t console_color_scheme_set = FALSE;
 
 /*******************************************************************************
  * STATIC FUNCTIONS DECLARATIONS
  ******************************************************************************/
 
-/* None */
+/**
+ * @brief Locks a driver queue.
+ *
+ * @details Disables the interrupts and locks the driver queue. The interrupts
+ * are disabled as the console can be used from interrupt handlers.
+ *
+ * @param[in,out] sink The driver to lock.
+ *
+ * @return The interrupt state before the lock was taken.
+ */
+inline static uint32_t _console_sink_lock(console_sink_t* sink);
+
+/**
+ * @brief Unlocks a driver queue.
+ *
+ * @details Unlocks the driver queue and restores the interrupt state.
+ *
+ * @param[in,out] sink The driver to unlock.
+ * @param[in] int_state The interrupt state returned by _console_sink_lock.
+ */
+inline static void _console_sink_unlock(console_sink_t* sink,
+                                        const uint32_t int_state);
+
+/**
+ * @brief Copies data to a driver queue.
+ *
+ * @details Copies data to a driver queue, the caller must hold the queue lock
+ * and check that the queue has enough space.
+ *
+ * @param[in,out] sink The driver.
+ * @param[in] data The data to copy.
+ * @param[in] size The size of the data in bytes.
+ */
+static void _console_sink_write(console_sink_t* sink,
+                                const void* data,
+                                const size_t size);
+
+/**
+ * @brief Copies data from a driver queue.
+ *
+ * @details Copies data from a driver queue, the caller must hold the queue
+ * lock and check that the queue contains enough data.
+ *
+ * @param[in,out] sink The driver.
+ * @param[out] data The buffer receiving the data.
+ * @param[in] size The size of the data in bytes.
+ */
+static void _console_sink_read(console_sink_t* sink,
+                               void* data,
+                               const size_t size);
+
+/**
+ * @brief Queues an operation for a driver.
+ *
+ * @details Queues an operation and its text for a driver, then notifies the
+ * drainer of the queue. The operation is dropped if the queue is full.
+ *
+ * @param[in] sink_id The registration index of the driver.
+ * @param[in] op The operation to queue.
+ * @param[in] text The text of the operation, op->length bytes are queued.
+ */
+static void _console_sink_push(const uint32_t sink_id,
+                               const console_op_t* op,
+                               const char* text);
+
+/**
+ * @brief Queues a text operation for a driver.
+ *
+ * @details Queues a text operation for a driver, the text is split in as many
+ * operations as needed.
+ *
+ * @param[in] sink_id The registration index of the driver.
+ * @param[in] type The operation type.
+ * @param[in] text The text to queue.
+ * @param[in] length The length of the text.
+ */
+static void _console_sink_push_text(const uint32_t sink_id,
+                                    const CONSOLE_OP_E type,
+                                    const char* text,
+                                    const size_t length);
+
+/**
+ * @brief Sends an operation to a driver.
+ *
+ * @details Calls the driver function corresponding to the operation. The
+ * operations not supported by the driver are ignored.
+ *
+ * @param[in] driver The driver.
+ * @param[in] op The operation to send.
+ * @param[in] text The NULL terminated text of the operation.
+ */
+static void _console_execute(const kernel_console_driver_t* driver,
+                             const console_op_t* op,
+                             const char* text);
+
+/**
+ * @brief Sends an operation to all the drivers.
+ *
+ * @details Sends an operation without text to all the drivers, the operation is
+ * queued for the drivers which queue is enabled.
+ *
+ * @param[in] op The operation to send.
+ */
+static void _console_dispatch(const console_op_t* op);
+
+/**
+ * @brief Sends the queued operations to a driver.
+ *
+ * @details Sends the queued operations to a driver until its queue is empty.
+ *
+ * @param[in,out] sink The driver.
+ * @param[in] lock Tells if the queue lock must be taken.
+ */
+static void _console_drain(console_sink_t* sink, const bool_t lock);
+
+/**
+ * @brief Registers a console driver.
+ *
+ * @details Checks that the driver and its mandatory functions are not NULL and
+ * registers it after the already registered drivers.
+ *
+ * @param[in] driver The driver to register.
+ *
+ * @return The success state or the error code.
+ */
+static OS_RETURN_E _console_register(const kernel_console_driver_t* driver);
 
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
 
-OS_RETURN_E console_set_selected_driver(const kernel_console_driver_t* driver)
+inline static uint32_t _console_sink_lock(console_sink_t* sink)
+{
+    uint32_t int_state;
+
+    int_state = _cpu_get_interrupt_state();
+    _cpu_clear_interrupt();
+
+    while(__atomic_exchange_n(&sink->lock, 1, __ATOMIC_ACQUIRE) != 0)
+    {
+        _cpu_pause();
+    }
+
+    return int_state;
+}
+
+inline static void _console_sink_unlock(console_sink_t* sink,
+                                        const uint32_t int_state)
+{
+    __atomic_store_n(&sink->lock, 0, __ATOMIC_RELEASE);
+
+    if(int_state != 0)
+    {
+        _cpu_set_interrupt();
+    }
+}
+
+static void _console_sink_write(console_sink_t* sink,
+                                const void* data,
+                                const size_t size)
+{
+    uint32_t offset;
+    size_t   first;
+
+    offset = sink->head & (CONSOLE_SINK_QUEUE_SIZE - 1);
+    first  = CONSOLE_SINK_QUEUE_SIZE - offset;
+    if(first > size)
+    {
+        first = size;
+    }
+
+    memcpy(sink->queue + offset, data, first);
+    memcpy(sink->queue, (const uint8_t*)data + first, size - first);
+
+    sink->head += size;
+}
+
+static void _console_sink_read(console_sink_t* sink,
+                               void* data,
+                               const size_t size)
+{
+    uint32_t offset;
+    size_t   first;
+
+    offset = sink->tail & (CONSOLE_SINK_QUEUE_SIZE - 1);
+    first  = CONSOLE_SINK_QUEUE_SIZE - offset;
+    if(first > size)
+    {
+        first = size;
+    }
+
+    memcpy(data, sink->queue + offset, first);
+    memcpy((uint8_t*)data + first, sink->queue, size - first);
+
+    sink->tail += size;
+}
+
+static void _console_sink_push(const uint32_t sink_id,
+                               const console_op_t* op,
+                               const char* text)
+{
+    console_sink_t* sink;
+    uint32_t        int_state;
+    size_t          size;
+
+    sink = &console_sinks[sink_id];
+    size = sizeof(console_op_t) + op->length;
+
+    int_state = _console_sink_lock(sink);
+
+    /* Never wait for the drainer, drop the operation */
+    if(CONSOLE_SINK_QUEUE_SIZE - (sink->head - sink->tail) < size)
+    {
+        _console_sink_unlock(sink, int_state);
+        return;
+    }
+
+    _console_sink_write(sink, op, sizeof(console_op_t));
+    if(op->length != 0)
+    {
+        _console_sink_write(sink, text, op->length);
+    }
+
+    _console_sink_unlock(sink, int_state);
+
+    sink->notify(sink_id);
+}
+
+static void _console_sink_push_text(const uint32_t sink_id,
+                                    const CONSOLE_OP_E type,
+                                    const char* text,
+                                    const size_t length)
+{
+    console_op_t op;
+    size_t       sent;
+
+    op.type = type;
+    for(sent = 0; sent < length; sent += op.length)
+    {
+        op.length = length - sent;
+        if(op.length > CONSOLE_OP_TEXT_SIZE)
+        {
+            op.length = CONSOLE_OP_TEXT_SIZE;
+        }
+        _console_sink_push(sink_id, &op, text + sent);
+    }
+}
+
+static void _console_execute(const kernel_console_driver_t* driver,
+                             const console_op_t* op,
+                             const char* text)
+{
+    switch(op->type)
+    {
+        case CONSOLE_OP_CLEAR_SCREEN:
+            driver->clear_screen();
+            break;
+        case CONSOLE_OP_PUT_CURSOR:
+            if(driver->put_cursor_at != NULL)
+            {
+                driver->put_cursor_at(op->args.cursor.y, op->args.cursor.x);
+            }
+            break;
+        case CONSOLE_OP_RESTORE_CURSOR:
+            if(driver->restore_cursor != NULL)
+            {
+                driver->restore_cursor(op->args.cursor);
+            }
+            break;
+        case CONSOLE_OP_SCROLL:
+            if(driver->scroll != NULL)
+            {
+                driver->scroll(op->args.scroll.direction,
+                               op->args.scroll.lines_count);
+            }
+            break;
+        case CONSOLE_OP_SET_COLOR_SCHEME:
+            if(driver->set_color_scheme != NULL)
+            {
+                driver->set_color_scheme(op->args.color_scheme);
+            }
+            break;
+        case CONSOLE_OP_PUT_STRING:
+            driver->put_string(text);
+            break;
+        case CONSOLE_OP_WRITE_KEYBOARD:
+            driver->console_write_keyboard(text, op->length);
+            break;
+        default:
+            break;
+    }
+}
+
+static void _console_dispatch(const console_op_t* op)
 {
-#ifdef ARCH_64_BITS
-    KERNEL_TRACE_EVENT(EVENT_KERNEL_CONSOLE_SET_DRIVER_START, 2,
-                       (uintptr_t)driver & 0xFFFFFFFF,
-                       (uintptr_t)driver >> 32);
-#else
-    KERNEL_TRACE_EVENT(EVENT_KERNEL_CONSOLE_SET_DRIVER_START, 2,
-                       irq_number,
-                       driver,
-                       0);
-#endif
+    uint32_t i;
+
+    for(i = 0; i < console_sink_count; ++i)
+    {
+        if(console_sinks[i].queued == TRUE)
+        {
+            _console_sink_push(i, op, NULL);
+        }
+        else
+        {
+            _console_execute(&console_sinks[i].driver, op, NULL);
+        }
+    }
+}
+
+static void _console_drain(console_sink_t* sink, const bool_t lock)
+{
+    console_op_t op;
+    char         text[CONSOLE_OP_TEXT_SIZE + 1];
+    uint32_t     int_state;
+
+    int_state = 0;
+    while(TRUE)
+    {
+        if(lock == TRUE)
+        {
+            int_state = _console_sink_lock(sink);
+        }
+
+        if(sink->head == sink->tail)
+        {
+            if(lock == TRUE)
+            {
+                _console_sink_unlock(sink, int_state);
+            }
+            break;
+        }
+
+        _console_sink_read(sink, &op, sizeof(console_op_t));
+        _console_sink_read(sink, text, op.length);
+
+        if(lock == TRUE)
+        {
+            _console_sink_unlock(sink, int_state);
+        }
+
+        /* The driver is called without the lock, it can output itself */
+        text[op.length] = 0;
+        _console_execute(&sink->driver, &op, text);
+    }
+}
+
+static OS_RETURN_E _console_register(const kernel_console_driver_t* driver)
+{
+    console_sink_t* sink;
 
     if(driver == NULL ||
        driver->clear_screen == NULL ||
@@ -93,96 +517,274 @@ OS_RETURN_E console_set_selected_driver(const kernel_console_driver_t* driver)
        driver->put_char == NULL ||
        driver->console_write_keyboard == NULL)
     {
-        KERNEL_TRACE_EVENT(EVENT_KERNEL_CONSOLE_SET_DRIVER_END, 1,
-                           OS_ERR_NULL_POINTER);
         return OS_ERR_NULL_POINTER;
     }
 
-    console_driver = *driver;
+    if(console_sink_count >= CONSOLE_MAX_SINKS)
+    {
+        return OS_ERR_NO_MORE_MEMORY;
+    }
+
+    sink         = &console_sinks[console_sink_count];
+    sink->driver = *driver;
+    sink->queued = FALSE;
+    sink->notify = NULL;
+    sink->head   = 0;
+    sink->tail   = 0;
+    sink->lock   = 0;
+    ++console_sink_count;
 
-    KERNEL_TRACE_EVENT(EVENT_KERNEL_CONSOLE_SET_DRIVER_END, 1,
-                       OS_NO_ERR);
     return OS_NO_ERR;
 }
 
-void console_clear_screen(void)
+OS_RETURN_E console_set_selected_driver(const kernel_console_driver_t* driver)
 {
-    if(console_driver.clear_screen != NULL)
+    OS_RETURN_E err;
+    uint32_t    i;
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_CONSOLE_SET_DRIVER_START, 1,
+                       (uintptr_t)driver);
+
+    /* The drainers of the queues may still use their driver */
+    for(i = 0; i < console_sink_count; ++i)
+    {
+        if(console_sinks[i].queued == TRUE)
+        {
+            KERNEL_TRACE_EVENT(EVENT_KERNEL_CONSOLE_SET_DRIVER_END, 1,
+                               OS_ERR_UNAUTHORIZED_ACTION);
+            return OS_ERR_UNAUTHORIZED_ACTION;
+        }
+    }
+
+    i   = console_sink_count;
+    err = OS_ERR_NULL_POINTER;
+    if(driver != NULL)
     {
-        console_driver.clear_screen();
+        console_sink_count = 0;
+        err = _console_register(driver);
+        if(err != OS_NO_ERR)
+        {
+            console_sink_count = i;
+        }
     }
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_CONSOLE_SET_DRIVER_END, 1, err);
+    return err;
 }
 
-void console_put_cursor_at(const uint32_t line, const uint32_t column)
+OS_RETURN_E console_add_driver(const kernel_console_driver_t* driver)
 {
-    if(console_driver.put_cursor_at != NULL)
+    OS_RETURN_E err;
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_CONSOLE_SET_DRIVER_START, 1,
+                       (uintptr_t)driver);
+
+    err = _console_register(driver);
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_CONSOLE_SET_DRIVER_END, 1, err);
+    return err;
+}
+
+uint32_t console_get_sink_count(void)
+{
+    return console_sink_count;
+}
+
+OS_RETURN_E console_enable_sink_queue(const uint32_t sink,
+                                      void (*notify)(const uint32_t sink))
+{
+    uint32_t int_state;
+
+    if(notify == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    if(sink >= console_sink_count)
     {
-        console_driver.put_cursor_at(line, column);
+        return OS_ERR_UNAUTHORIZED_ACTION;
     }
+
+    int_state = _console_sink_lock(&console_sinks[sink]);
+    console_sinks[sink].notify = notify;
+    console_sinks[sink].queued = TRUE;
+    _console_sink_unlock(&console_sinks[sink], int_state);
+
+    return OS_NO_ERR;
 }
 
-void console_save_cursor(cursor_t* buffer)
+void console_drain_sink(const uint32_t sink)
 {
-    if(console_driver.save_cursor != NULL)
+    if(sink < console_sink_count)
     {
-        return console_driver.save_cursor(buffer);
+        _console_drain(&console_sinks[sink], TRUE);
     }
 }
 
-void console_restore_cursor(const cursor_t buffer)
+void console_disable_sink_queues(void)
 {
-    if(console_driver.restore_cursor != NULL)
+    uint32_t i;
+
+    /* No lock is taken, this can be called from the panic context */
+    for(i = 0; i < console_sink_count; ++i)
     {
-        return console_driver.restore_cursor(buffer);
+        if(console_sinks[i].queued == TRUE)
+        {
+            console_sinks[i].queued = FALSE;
+            _console_drain(&console_sinks[i], FALSE);
+        }
     }
 }
 
-void console_scroll(const SCROLL_DIRECTION_E direction,
-                    const uint32_t lines_count)
+void console_clear_screen(void)
 {
-    if(console_driver.scroll != NULL)
+    console_op_t op;
+
+    op.type   = CONSOLE_OP_CLEAR_SCREEN;
+    op.length = 0;
+    _console_dispatch(&op);
+}
+
+void console_put_cursor_at(const uint32_t line, const uint32_t column)
+{
+    console_op_t op;
+
+    op.type          = CONSOLE_OP_PUT_CURSOR;
+    op.length        = 0;
+    op.args.cursor.x = column;
+    op.args.cursor.y = line;
+    _console_dispatch(&op);
+}
+
+void console_save_cursor(cursor_t* buffer)
+{
+    uint32_t i;
+
+    for(i = 0; i < console_sink_count; ++i)
     {
-        console_driver.scroll(direction, lines_count);
+        if(console_sinks[i].driver.save_cursor != NULL)
+        {
+            console_sinks[i].driver.save_cursor(buffer);
+            return;
+        }
     }
 }
 
+void console_restore_cursor(const cursor_t buffer)
+{
+    console_op_t op;
+
+    op.type        = CONSOLE_OP_RESTORE_CURSOR;
+    op.length      = 0;
+    op.args.cursor = buffer;
+    _console_dispatch(&op);
+}
+
+void console_scroll(const SCROLL_DIRECTION_E direction,
+                    const uint32_t lines_count)
+{
+    console_op_t op;
+
+    op.type                    = CONSOLE_OP_SCROLL;
+    op.length                  = 0;
+    op.args.scroll.direction   = direction;
+    op.args.scroll.lines_count = lines_count;
+    _console_dispatch(&op);
+}
+
 void console_set_color_scheme(colorscheme_t color_scheme)
 {
-    if(console_driver.set_color_scheme != NULL)
-    {
-        console_driver.set_color_scheme(color_scheme);
-    }
+    console_op_t op;
+
+    /* Keep the scheme, the queued drivers may not have applied it yet */
+    console_color_scheme     = color_scheme;
+    console_color_scheme_set = TRUE;
+
+    op.type              = CONSOLE_OP_SET_COLOR_SCHEME;
+    op.length            = 0;
+    op.args.color_scheme = color_scheme;
+    _console_dispatch(&op);
 }
 
 void console_save_color_scheme(colorscheme_t* buffer)
 {
-    if(console_driver.save_color_scheme != NULL)
+    uint32_t i;
+
+    if(buffer == NULL)
+    {
+        return;
+    }
+
+    if(console_color_scheme_set == TRUE)
     {
-        return console_driver.save_color_scheme(buffer);
+        *buffer = console_color_scheme;
+        return;
+    }
+
+    for(i = 0; i < console_sink_count; ++i)
+    {
+        if(console_sinks[i].driver.save_color_scheme != NULL)
+        {
+            console_sinks[i].driver.save_color_scheme(buffer);
+            return;
+        }
     }
 }
 
 void console_put_string(const char* str)
 {
-    if(console_driver.put_string != NULL)
+    uint32_t i;
+    size_t   length;
+
+    length = 0;
+    for(i = 0; i < console_sink_count; ++i)
     {
-        console_driver.put_string(str);
+        if(console_sinks[i].queued == TRUE)
+        {
+            if(length == 0)
+            {
+                length = strlen(str);
+            }
+            _console_sink_push_text(i, CONSOLE_OP_PUT_STRING, str, length);
+        }
+        else
+        {
+            console_sinks[i].driver.put_string(str);
+        }
     }
 }
 
 void console_put_char(const char character)
 {
-    if(console_driver.put_char != NULL)
+    uint32_t i;
+
+    for(i = 0; i < console_sink_count; ++i)
     {
-        console_driver.put_char(character);
+        if(console_sinks[i].queued == TRUE)
+        {
+            _console_sink_push_text(i, CONSOLE_OP_PUT_STRING, &character, 1);
+        }
+        else
+        {
+            console_sinks[i].driver.put_char(character);
+        }
     }
 }
 
 void console_console_write_keyboard(const char* str, const size_t len)
 {
-    if(console_driver.console_write_keyboard != NULL)
+    uint32_t i;
+
+    for(i = 0; i < console_sink_count; ++i)
     {
-        console_driver.console_write_keyboard(str, len);
+        if(console_sinks[i].queued == TRUE)
+        {
+            _console_sink_push_text(i, CONSOLE_OP_WRITE_KEYBOARD, str, len);
+        }
+        else
+        {
+            console_sinks[i].driver.console_write_keyboard(str, len);
+        }
     }
 }
 
@@ -7,14 +7,21 @@
  *
  * @date 30/03/2023
  *
- * @version 2.1
+ * @version 3.0
  *
  * @brief Kernel's output methods.
  *
  * @details Simple output functions to print messages to screen. These are
  * really basic output too allow early kernel boot output and debug. These
  * functions can be used in interrupts handlers since no lock is required to use
- * them. This also makes them non thread safe.
+ * them. Each message is formated in a buffer owned by the caller's stack frame,
+ * then given to the console driver in one call. Messages longer than the buffer
+ * are output in several parts. Once the kernel log is enabled, the messages are
+ * stored in the log ring of the CPU instead and rendered to the console by the
+ * log consumer. The log rings are lock-free, writing a message only reserves a
+ * slot and copies the formated text. The binary debug messages only store
+ * their format and raw arguments, they are formated when rendered. The last
+ * slots can be dumped after a crash.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -24,9 +31,10 @@
  ******************************************************************************/
 
 /* Included headers */
-#include <string.h>   /* memset, strlen */
-#include <stdlib.h>   /* uitoa, itoa */
+#include <string.h>   /* strlen, memcpy */
+#include <stdlib.h>   /* uitoa_len, itoa_len */
 #include <console.h>  /* Console driver */
+#include <kerror.h>   /* Kernel error codes */
 
 /* Configuration files */
 #include <config.h>
@@ -104,6 +112,23 @@
 /** @brief VGA foreground color definition: white. */
 #define FG_WHITE            0x0F
 
+/** @brief Size of the formated message buffer, NULL terminator included. */
+#define KERNEL_OUTPUT_BUFFER_SIZE 256
+
+/** @brief Number of slots in the log ring of a CPU, must be a power of 2. */
+#define KERNEL_LOG_SLOT_COUNT 64
+
+/** @brief Size of the text stored in a log slot. */
+#define KERNEL_LOG_TEXT_SIZE 116
+
+/** @brief Log slot flag: the slot starts a message. */
+#define KERNEL_LOG_FLAG_FIRST 0x01
+
+/**
+ * @brief Log slot flag: the slot stores a format and its raw arguments instead
+ * of a formated text.
+ */
+#define KERNEL_LOG_FLAG_BINARY 0x02
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
@@ -112,26 +137,138 @@
 /** @brief Output descriptor, used to define the handlers that manage outputs */
 typedef struct
 {
-    /** @brief The handler used to print character. */
-    void (*putc)(const char);
     /** @brief The handler used to print string. */
     void (*puts)(const char*);
 } output_t;
 
+/** @brief Kernel output message levels. */
+typedef enum
+{
+    /** @brief Message without tag. */
+    LOG_LEVEL_PRINTF,
+    /** @brief Error message. */
+    LOG_LEVEL_ERROR,
+    /** @brief Success message. */
+    LOG_LEVEL_SUCCESS,
+    /** @brief Information message. */
+    LOG_LEVEL_INFO,
+    /** @brief Warning message. */
+    LOG_LEVEL_WARNING,
+    /** @brief Debug message. */
+    LOG_LEVEL_DEBUG
+} LOG_LEVEL_E;
+
+/** @brief Formated message buffer. */
+typedef struct
+{
+    /** @brief The message being formated. */
+    char buffer[KERNEL_OUTPUT_BUFFER_SIZE];
+
+    /** @brief Length of the message in the buffer. */
+    size_t length;
+
+    /** @brief The message level. */
+    LOG_LEVEL_E level;
+
+    /** @brief Tells if the buffer starts the message. */
+    bool_t first;
+
+    /** @brief Tells if the buffer is rendered without using the kernel log. */
+    bool_t direct;
+} output_buffer_t;
+
+/** @brief Arguments of a formated string. */
+typedef struct
+{
+    /** @brief The arguments list, used when words is NULL. */
+    __builtin_va_list list;
+
+    /** @brief The raw arguments words. */
+    const uint64_t* words;
+
+    /** @brief Number of raw arguments words. */
+    uint32_t count;
+
+    /** @brief Index of the next raw argument word. */
+    uint32_t index;
+} format_args_t;
+
+/** @brief Message tag, printed before the tagged messages. */
+typedef struct
+{
+    /** @brief The tag string. */
+    const char* tag;
+
+    /** @brief The tag length. */
+    size_t length;
+
+    /** @brief The tag foreground color. */
+    uint32_t foreground;
+} output_tag_t;
+
+/** @brief Kernel log slot. */
+typedef struct
+{
+    /**
+     * @brief Index of the slot in the ring plus one once written, 0 while the
+     * slot is being written.
+     */
+    uint32_t sequence;
+
+    /** @brief The message level. */
+    uint8_t level;
+
+    /** @brief The slot flags. */
+    uint8_t flags;
+
+    /** @brief Length of the text, number of arguments for binary slots. */
+    uint16_t length;
+
+    /** @brief Identifier of the CPU that wrote the slot. */
+    uint32_t cpu_id;
+
+    /** @brief Time at which the slot was written in nanoseconds. */
+    uint64_t timestamp;
+
+    /**
+     * @brief The formated text, or the format pointer followed by the raw
+     * arguments for binary slots.
+     */
+    char text[KERNEL_LOG_TEXT_SIZE];
+} kernel_log_slot_t;
+
+/** @brief Kernel log ring of a CPU. */
+typedef struct
+{
+    /** @brief Index of the next slot to reserve. */
+    uint32_t head;
+
+    /** @brief Index of the next slot to render. */
+    uint32_t tail;
+
+    /** @brief The log slots. */
+    kernel_log_slot_t slots[KERNEL_LOG_SLOT_COUNT];
+} kernel_log_ring_t;
+
+/* The binary slots store the format pointer and the raw arguments words */
+_Static_assert(sizeof(const char*) +
+               KERNEL_LOG_BINARY_MAX_ARGS * sizeof(uint64_t) <=
+               KERNEL_LOG_TEXT_SIZE,
+               "Binary log slots cannot store all the arguments");
+
 /*******************************************************************************
  * MACROS
  ******************************************************************************/
 
 /**
- * @brief Adds a padding sequence before a formated input.
+ * @brief Adds a padding sequence before a formated input. str_size must
+ * contain the length of the formated input.
  */
 #define PAD_SEQ                         \
 {                                       \
-    str_size = strlen(tmp_seq);         \
-                                        \
     while(padding_mod > str_size)       \
     {                                   \
-        used_output.putc(pad_char_mod); \
+        _output_putc(out, pad_char_mod);\
         --padding_mod;                  \
     }                                   \
 }
@@ -151,19 +288,19 @@ typedef struct
     switch(length_mod)                                         \
     {                                                          \
         case 1:                                                \
-            val = (__builtin_va_arg(args, uint32_t) & 0xFF);   \
+            val = (_format_get_arg(args, 4) & 0xFF);           \
             break;                                             \
         case 2:                                                \
-            val = (__builtin_va_arg(args, uint32_t) & 0xFFFF); \
+            val = (_format_get_arg(args, 4) & 0xFFFF);         \
             break;                                             \
         case 4:                                                \
-            val = __builtin_va_arg(args, uint32_t);            \
+            val = (_format_get_arg(args, 4) & 0xFFFFFFFF);     \
             break;                                             \
         case 8:                                                \
-            val = __builtin_va_arg(args, uint64_t);            \
+            val = _format_get_arg(args, 8);                    \
             break;                                             \
         default:                                               \
-           val = __builtin_va_arg(args, uint32_t);             \
+           val = (_format_get_arg(args, 4) & 0xFFFFFFFF);      \
     }                                                          \
                                                                \
 }
@@ -181,47 +318,97 @@ typedef struct
 /************************** Static global variables ***************************/
 /** @brief Stores the current output type. */
 static output_t current_output = {
-    .putc = console_put_char,
     .puts = console_put_string
 };
 
+/** @brief Tags of the message levels. */
+static const output_tag_t output_tags[] = {
+    [LOG_LEVEL_PRINTF]  = {NULL,           0,  0},
+    [LOG_LEVEL_ERROR]   = {"[ERROR] ",     8,  FG_RED},
+    [LOG_LEVEL_SUCCESS] = {"[OK] ",        5,  FG_GREEN},
+    [LOG_LEVEL_INFO]    = {"[INFO] ",      7,  FG_CYAN},
+    [LOG_LEVEL_WARNING] = {"[WARNING] ",   10, FG_BROWN},
+    [LOG_LEVEL_DEBUG]   = {"[DEBUG] ",     8,  FG_YELLOW}
+};
+
+/** @brief Kernel log rings of each CPU. */
+static kernel_log_ring_t log_rings[MAX_CPU_COUNT];
+
+/** @brief Kernel log sources and consumer, valid only when log_enabled. */
+static kernel_log_driver_t log_driver;
+
+/** @brief Tells if the messages are stored in the kernel log. */
+static volatile bool_t log_enabled = FALSE;
+
+/** @brief Receives a copy of the rendered text when not NULL. */
+static void (*output_capture)(const char*) = NULL;
+
 /*******************************************************************************
  * STATIC FUNCTIONS DECLARATIONS
  ******************************************************************************/
 
 /**
- * @brief Converts a string to upper case characters.
+ * @brief Outputs the content of a message buffer.
+ *
+ * @details Outputs the content of a message buffer to the current output in
+ * one call and empties the buffer.
+ *
+ * @param[in,out] out The message buffer to flush.
+ */
+static void _output_flush(output_buffer_t* out);
+
+/**
+ * @brief Appends a character to a message buffer.
+ *
+ * @details Appends a character to a message buffer. The buffer is flushed
+ * when full.
+ *
+ * @param[in,out] out The message buffer to use.
+ * @param[in] character The character to append.
+ */
+inline static void _output_putc(output_buffer_t* out, const char character);
+
+/**
+ * @brief Appends a string to a message buffer.
  *
- * @details Transforms all lowercase character of a NULL terminated string to
- * uppercase characters.
+ * @details Appends a string to a message buffer. The buffer is flushed each
+ * time it is full.
  *
- * @param[in,out] string The string to tranform.
+ * @param[in,out] out The message buffer to use.
+ * @param[in] string The string to append.
+ * @param[in] length The length of the string to append.
  */
-static void _toupper(char* string);
+static void _output_puts(output_buffer_t* out,
+                         const char* string,
+                         size_t length);
 
 /**
- * @brief Converts a string to upper case characters.
+ * @brief Gets the next argument of a formated string.
+ *
+ * @details Gets the next argument of a formated string, either from the
+ * arguments list or from the raw arguments words. 0 is returned when all the
+ * raw arguments words were used.
  *
- * @details Transforms all uppercase character of a NULL terminated string to
- * lowercase characters.
+ * @param[in,out] args The arguments of the formated string.
+ * @param[in] length The size of the argument in the arguments list, 4 or 8.
  *
- * @param[in,out] string The string to tranform.
+ * @return The argument value.
  */
-static void _tolower(char* string);
+static uint64_t _format_get_arg(format_args_t* args, const uint8_t length);
 
 /**
  * @brief Prints a formated string.
  *
- * @details Prints a formated string to the output and managing the formated
+ * @details Formats a string in the message buffer and managing the formated
  * string arguments.
  *
  * @param[in] str The formated string to output.
- * @param[in] args The arguments to use with the formated string.
- * @param[in] used_output The output to use.
+ * @param[in,out] args The arguments to use with the formated string.
+ * @param[in,out] out The message buffer to use.
  */
 static void _formater(const char* str,
-                      __builtin_va_list args,
-                      output_t used_output);
+                      format_args_t* args,
+                      output_buffer_t* out);
 
 /**
  * @brief Prints a formated string.
@@ -235,50 +422,198 @@ static void _formater(const char* str,
 static void _kprint_fmt(const char* str, __builtin_va_list args);
 
 /**
- * @brief Prints the tag for kernel output functions.
+ * @brief Prints a formated string with a level.
+ *
+ * @details Formats a string and outputs it with the level given as parameter,
+ * either directly or through the kernel log.
+ *
+ * @param[in] level The message level.
+ * @param[in] str The formated string to output.
+ * @param[in] args The arguments to use with the formated string.
+ */
+static void _kprint_level(const LOG_LEVEL_E level,
+                          const char* str,
+                          __builtin_va_list args);
+
+/**
+ * @brief Formats a string with its raw arguments words.
+ *
+ * @details Formats a string with the raw arguments words given as parameter
+ * and outputs it with the level given as parameter.
+ *
+ * @param[in] level The message level.
+ * @param[in] direct Tells if the message is rendered without using the kernel
+ * log.
+ * @param[in] first Tells if the message is rendered with its tag.
+ * @param[in] str The formated string to output.
+ * @param[in] count The number of raw arguments words.
+ * @param[in] words The raw arguments words.
+ */
+static void _kprint_words(const LOG_LEVEL_E level,
+                          const bool_t direct,
+                          const bool_t first,
+                          const char* str,
+                          const uint32_t count,
+                          const uint64_t* words);
+
+/**
+ * @brief Renders a message to the console.
+ *
+ * @details Renders a message to the console. The message tag is printed with
+ * its color when the text starts the message.
+ *
+ * @param[in] level The message level.
+ * @param[in] first Tells if the text starts the message.
+ * @param[in] text The NULL terminated text to output.
+ */
+static void _output_render(const LOG_LEVEL_E level,
+                           const bool_t first,
+                           const char* text);
+
+/**
+ * @brief Stores a text in the kernel log.
+ *
+ * @details Stores a text in the log ring of the current CPU, the text is
+ * split in as many slots as needed. The oldest slots are overwritten when the
+ * ring is full. The log consumer is then notified.
+ *
+ * @param[in] level The message level.
+ * @param[in] first Tells if the text starts the message.
+ * @param[in] text The text to store.
+ * @param[in] length The length of the text.
+ */
+static void _log_write(const LOG_LEVEL_E level,
+                       bool_t first,
+                       const char* text,
+                       size_t length);
+
+/**
+ * @brief Reserves a slot in a log ring.
+ *
+ * @details Reserves the next slot of a log ring and invalidates it until its
+ * sequence is published.
+ *
+ * @param[in,out] ring The log ring.
+ * @param[out] index The index of the reserved slot.
+ *
+ * @return The reserved slot.
+ */
+static kernel_log_slot_t* _log_reserve(kernel_log_ring_t* ring,
+                                       uint32_t* index);
+
+/**
+ * @brief Gets the log ring of the current CPU.
+ *
+ * @details Gets the log ring of the current CPU. The first ring is used when
+ * the CPU identifier is out of range.
+ *
+ * @param[out] cpu_id The identifier of the ring CPU.
+ *
+ * @return The log ring of the current CPU.
+ */
+static kernel_log_ring_t* _log_get_ring(uint32_t* cpu_id);
+
+/**
+ * @brief Renders a log slot to the console.
+ *
+ * @details Renders a log slot to the console, the binary slots are formated
+ * with their raw arguments.
+ *
+ * @param[in] slot The slot to render.
+ */
+static void _log_render_slot(const kernel_log_slot_t* slot);
+
+/**
+ * @brief Copies the slot at the tail of a log ring.
+ *
+ * @details Copies the slot at the tail of a log ring if it was written. The
+ * tail is moved past the slots that were overwritten before being rendered.
  *
- * @details Prints the tag for kernel output functions.
+ * @param[in,out] ring The log ring.
+ * @param[out] slot The buffer receiving the slot.
  *
- * @param[in] fmt The formated string to print.
- * @param[in] ... The associated arguments to the formated string.
+ * @return TRUE if a slot was copied, FALSE otherwise.
  */
-static void _tag_printf(const char* fmt, ...);
+static bool_t _log_peek(kernel_log_ring_t* ring, kernel_log_slot_t* slot);
 
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
 
-static void _toupper(char* string)
+static void _output_flush(output_buffer_t* out)
 {
-    /* For each character of the string */
-    while(*string != 0)
+    if(out->length != 0)
     {
-        /* If the character is lowercase, makes it uppercase */
-        if(*string > 96 && *string < 123)
+        if(out->direct == FALSE && log_enabled == TRUE)
         {
-            *string = *string - 32;
+            _log_write(out->level, out->first, out->buffer, out->length);
         }
-        ++string;
+        else
+        {
+            out->buffer[out->length] = 0;
+            _output_render(out->level, out->first, out->buffer);
+        }
+        out->first  = FALSE;
+        out->length = 0;
+    }
+}
+
+inline static void _output_putc(output_buffer_t* out, const char character)
+{
+    if(out->length == KERNEL_OUTPUT_BUFFER_SIZE - 1)
+    {
+        _output_flush(out);
+    }
+    out->buffer[out->length++] = character;
+}
+
+static void _output_puts(output_buffer_t* out,
+                         const char* string,
+                         size_t length)
+{
+    size_t copy_size;
+
+    while(length != 0)
+    {
+        if(out->length == KERNEL_OUTPUT_BUFFER_SIZE - 1)
+        {
+            _output_flush(out);
+        }
+
+        copy_size = KERNEL_OUTPUT_BUFFER_SIZE - 1 - out->length;
+        if(copy_size > length)
+        {
+            copy_size = length;
+        }
+
+        memcpy(out->buffer + out->length, string, copy_size);
+        out->length += copy_size;
+        string      += copy_size;
+        length      -= copy_size;
     }
 }
 
-static void _tolower(char* string)
+static uint64_t _format_get_arg(format_args_t* args, const uint8_t length)
 {
-    /* For each character of the string */
-    while(*string != 0)
+    if(args->words != NULL)
     {
-        /* If the character is uppercase, makes it lowercase */
-        if(*string > 64 && *string < 91)
+        if(args->index < args->count)
         {
-            *string = *string + 32;
+            return args->words[args->index++];
         }
-        ++string;
+        return 0;
     }
+
+    if(length == 8)
+    {
+        return __builtin_va_arg(args->list, uint64_t);
+    }
+    return __builtin_va_arg(args->list, uint32_t);
 }
 
 static void _formater(const char* str,
-                      __builtin_va_list args,
-                      output_t used_output)
+                      format_args_t* args,
+                      output_buffer_t* out)
 {
     size_t   pos;
     size_t   str_length;
@@ -318,7 +653,7 @@ static void _formater(const char* str,
             }
             else
             {
-                used_output.putc(str[pos]);
+                _output_putc(out, str[pos]);
             }
         }
         else if(modifier)
@@ -335,41 +670,31 @@ static void _formater(const char* str,
 
                 /* Specifier mods */
                 case 's':
-                    args_value = __builtin_va_arg(args, char*);
-                    used_output.puts(args_value);
+                    args_value = (char*)(uintptr_t)
+                                 _format_get_arg(args, sizeof(uintptr_t));
+                    _output_puts(out, args_value, strlen(args_value));
                     break;
                 case 'd':
                 case 'i':
                     GET_SEQ_VAL(seq_val, args, length_mod);
-                    memset(tmp_seq, 0, sizeof(tmp_seq));
-                    itoa(seq_val, tmp_seq, 10);
+                    str_size = itoa_len(seq_val, tmp_seq, 10, FALSE);
                     PAD_SEQ
-                    used_output.puts(tmp_seq);
+                    _output_puts(out, tmp_seq, str_size);
                     break;
                 case 'u':
                     GET_SEQ_VAL(seq_val, args, length_mod);
-                    memset(tmp_seq, 0, sizeof(tmp_seq));
-                    uitoa(seq_val, tmp_seq, 10);
+                    str_size = uitoa_len(seq_val, tmp_seq, 10, FALSE);
                     PAD_SEQ
-                    used_output.puts(tmp_seq);
+                    _output_puts(out, tmp_seq, str_size);
                     break;
                 case 'X':
                     upper_mod = TRUE;
                     __attribute__ ((fallthrough));
                 case 'x':
                     GET_SEQ_VAL(seq_val, args, length_mod);
-                    memset(tmp_seq, 0, sizeof(tmp_seq));
-                    uitoa(seq_val, tmp_seq, 16);
+                    str_size = uitoa_len(seq_val, tmp_seq, 16, upper_mod);
                     PAD_SEQ
-                    if(upper_mod == TRUE)
-                    {
-                        _toupper(tmp_seq);
-                    }
-                    else
-                    {
-                        _tolower(tmp_seq);
-                    }
-                    used_output.puts(tmp_seq);
+                    _output_puts(out, tmp_seq, str_size);
                     break;
                 case 'P':
                     upper_mod = TRUE;
@@ -379,23 +704,14 @@ static void _formater(const char* str,
                     pad_char_mod = '0';
                     length_mod = sizeof(uintptr_t);
                     GET_SEQ_VAL(seq_val, args, length_mod);
-                    memset(tmp_seq, 0, sizeof(tmp_seq));
-                    uitoa(seq_val, tmp_seq, 16);
+                    str_size = uitoa_len(seq_val, tmp_seq, 16, upper_mod);
                     PAD_SEQ
-                    if(upper_mod == TRUE)
-                    {
-                        _toupper(tmp_seq);
-                    }
-                    else
-                    {
-                        _tolower(tmp_seq);
-                    }
-                    used_output.puts(tmp_seq);
+                    _output_puts(out, tmp_seq, str_size);
                     break;
                 case 'c':
                     length_mod = sizeof(char);
                     GET_SEQ_VAL(tmp_seq[0], args, length_mod);
-                    used_output.putc(tmp_seq[0]);
+                    _output_putc(out, tmp_seq[0]);
                     break;
 
                 /* Padding mods */
@@ -442,7 +758,7 @@ static void _formater(const char* str,
         }
         else
         {
-            used_output.putc(str[pos]);
+            _output_putc(out, str[pos]);
         }
 
         /* Reinit mods */
@@ -457,21 +773,372 @@ static void _formater(const char* str,
 
 static void _kprint_fmt(const char* str, __builtin_va_list args)
 {
-    _formater(str, args, current_output);
+    _kprint_level(LOG_LEVEL_PRINTF, str, args);
 }
 
-static void _tag_printf(const char* fmt, ...)
+static void _kprint_level(const LOG_LEVEL_E level,
+                          const char* str,
+                          __builtin_va_list args)
 {
-    __builtin_va_list args;
+    output_buffer_t out;
+    format_args_t   format_args;
 
-    if(fmt == NULL)
+    out.length  = 0;
+    out.level   = level;
+    out.first   = TRUE;
+    out.direct  = FALSE;
+
+    format_args.words = NULL;
+    __builtin_va_copy(format_args.list, args);
+    _formater(str, &format_args, &out);
+    __builtin_va_end(format_args.list);
+
+    _output_flush(&out);
+}
+
+static void _kprint_words(const LOG_LEVEL_E level,
+                          const bool_t direct,
+                          const bool_t first,
+                          const char* str,
+                          const uint32_t count,
+                          const uint64_t* words)
+{
+    output_buffer_t out;
+    format_args_t   format_args;
+
+    out.length  = 0;
+    out.level   = level;
+    out.first   = first;
+    out.direct  = direct;
+
+    format_args.words = words;
+    format_args.count = count;
+    format_args.index = 0;
+    _formater(str, &format_args, &out);
+
+    _output_flush(&out);
+}
+
+static void _output_render(const LOG_LEVEL_E level,
+                           const bool_t first,
+                           const char* text)
+{
+    colorscheme_t buffer;
+    colorscheme_t new_scheme;
+
+    if(first == TRUE && output_tags[level].tag != NULL)
     {
-        return;
+        new_scheme.foreground = output_tags[level].foreground;
+        new_scheme.background = BG_BLACK;
+        new_scheme.vga_color  = TRUE;
+
+        /* No need to test return value */
+        console_save_color_scheme(&buffer);
+
+        /* Set the tag color scheme */
+        console_set_color_scheme(new_scheme);
+
+        /* Print tag */
+        current_output.puts(output_tags[level].tag);
+        if(output_capture != NULL)
+        {
+            output_capture(output_tags[level].tag);
+        }
+
+        /* Restore original screen color scheme */
+        console_set_color_scheme(buffer);
+    }
+
+    current_output.puts(text);
+    if(output_capture != NULL)
+    {
+        output_capture(text);
+    }
+}
+
+static void _log_write(const LOG_LEVEL_E level,
+                       bool_t first,
+                       const char* text,
+                       size_t length)
+{
+    kernel_log_ring_t* ring;
+    kernel_log_slot_t* slot;
+    uint32_t           cpu_id;
+    uint32_t           index;
+    uint64_t           timestamp;
+    size_t             copy_size;
+
+    ring      = _log_get_ring(&cpu_id);
+    timestamp = log_driver.get_time_ns();
+
+    while(length != 0)
+    {
+        copy_size = length;
+        if(copy_size > KERNEL_LOG_TEXT_SIZE)
+        {
+            copy_size = KERNEL_LOG_TEXT_SIZE;
+        }
+
+        slot = _log_reserve(ring, &index);
+
+        slot->level     = level;
+        slot->flags     = (first == TRUE) ? KERNEL_LOG_FLAG_FIRST : 0;
+        slot->length    = copy_size;
+        slot->cpu_id    = cpu_id;
+        slot->timestamp = timestamp;
+        memcpy(slot->text, text, copy_size);
+
+        __atomic_store_n(&slot->sequence, index + 1, __ATOMIC_RELEASE);
+
+        first   = FALSE;
+        text   += copy_size;
+        length -= copy_size;
+    }
+
+    log_driver.notify();
+}
+
+static kernel_log_slot_t* _log_reserve(kernel_log_ring_t* ring,
+                                       uint32_t* index)
+{
+    kernel_log_slot_t* slot;
+
+    *index = __atomic_fetch_add(&ring->head, 1, __ATOMIC_RELAXED);
+    slot   = &ring->slots[*index & (KERNEL_LOG_SLOT_COUNT - 1)];
+
+    /* Invalidate the slot while it is written */
+    __atomic_store_n(&slot->sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    return slot;
+}
+
+static kernel_log_ring_t* _log_get_ring(uint32_t* cpu_id)
+{
+    /* Using a wrong ring, for instance when migrated, only mixes the CPUs
+     * messages as the slots are reserved atomically.
+     */
+    *cpu_id = log_driver.get_cpu_id();
+    if(*cpu_id >= MAX_CPU_COUNT)
+    {
+        *cpu_id = 0;
+    }
+    return &log_rings[*cpu_id];
+}
+
+static void _log_render_slot(const kernel_log_slot_t* slot)
+{
+    const char* fmt;
+    uint64_t    words[KERNEL_LOG_BINARY_MAX_ARGS];
+    uint32_t    count;
+    char        text[KERNEL_LOG_TEXT_SIZE + 1];
+
+    if((slot->flags & KERNEL_LOG_FLAG_BINARY) != 0)
+    {
+        count = slot->length;
+        if(count > KERNEL_LOG_BINARY_MAX_ARGS)
+        {
+            count = KERNEL_LOG_BINARY_MAX_ARGS;
+        }
+        memcpy(&fmt, slot->text, sizeof(fmt));
+        memcpy(words, slot->text + sizeof(fmt), count * sizeof(uint64_t));
+        _kprint_words(slot->level,
+                      TRUE,
+                      (slot->flags & KERNEL_LOG_FLAG_FIRST) != 0,
+                      fmt,
+                      count,
+                      words);
+    }
+    else
+    {
+        memcpy(text, slot->text, slot->length);
+        text[slot->length] = 0;
+        _output_render(slot->level,
+                       (slot->flags & KERNEL_LOG_FLAG_FIRST) != 0,
+                       text);
+    }
+}
+
+static bool_t _log_peek(kernel_log_ring_t* ring, kernel_log_slot_t* slot)
+{
+    kernel_log_slot_t* ring_slot;
+    uint32_t           head;
+    uint32_t           sequence;
+
+    while(TRUE)
+    {
+        head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+
+        /* Skip the slots overwritten before being rendered */
+        if(head - ring->tail > KERNEL_LOG_SLOT_COUNT)
+        {
+            ring->tail = head - KERNEL_LOG_SLOT_COUNT;
+        }
+        if(head == ring->tail)
+        {
+            return FALSE;
+        }
+
+        ring_slot = &ring->slots[ring->tail & (KERNEL_LOG_SLOT_COUNT - 1)];
+        sequence  = __atomic_load_n(&ring_slot->sequence, __ATOMIC_ACQUIRE);
+        if(sequence != ring->tail + 1)
+        {
+            /* Still being written */
+            return FALSE;
+        }
+
+        *slot = *ring_slot;
+
+        /* The slot is only valid if it was not overwritten during the copy */
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if(__atomic_load_n(&ring_slot->sequence, __ATOMIC_RELAXED) == sequence)
+        {
+            return TRUE;
+        }
+    }
+}
+
+OS_RETURN_E kernel_output_enable_log(const kernel_log_driver_t* driver)
+{
+    if(driver == NULL ||
+       driver->get_cpu_id == NULL ||
+       driver->get_time_ns == NULL ||
+       driver->notify == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+
+    log_driver = *driver;
+    __atomic_store_n(&log_enabled, TRUE, __ATOMIC_RELEASE);
+
+    return OS_NO_ERR;
+}
+
+void kernel_output_disable_log(void)
+{
+    log_enabled = FALSE;
+}
+
+void kernel_output_set_capture(void (*capture)(const char* text))
+{
+    output_capture = capture;
+}
+
+void kernel_output_drain_log(void)
+{
+    kernel_log_slot_t  slot;
+    kernel_log_slot_t  candidate;
+    kernel_log_ring_t* ring;
+    uint32_t           i;
+
+    while(TRUE)
+    {
+        /* Render the oldest slot of all the CPUs */
+        ring = NULL;
+        for(i = 0; i < MAX_CPU_COUNT; ++i)
+        {
+            if(_log_peek(&log_rings[i], &candidate) == TRUE &&
+               (ring == NULL || candidate.timestamp < slot.timestamp))
+            {
+                ring = &log_rings[i];
+                slot = candidate;
+            }
+        }
+
+        if(ring == NULL)
+        {
+            break;
+        }
+        ++ring->tail;
+
+        _log_render_slot(&slot);
+    }
+}
+
+void kernel_output_dump_log(const uint32_t count)
+{
+    kernel_log_slot_t* slot;
+    kernel_log_slot_t* newest;
+    uint32_t           cursors[MAX_CPU_COUNT];
+    uint32_t           newest_cpu;
+    uint32_t           dumped;
+    uint32_t           i;
+
+    log_enabled = FALSE;
+
+    /* Find the first slot to dump, going back from the newest of all CPUs */
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        cursors[i] = log_rings[i].head;
+    }
+    for(dumped = 0; dumped < count; ++dumped)
+    {
+        newest     = NULL;
+        newest_cpu = 0;
+        for(i = 0; i < MAX_CPU_COUNT; ++i)
+        {
+            if(log_rings[i].head - cursors[i] >= KERNEL_LOG_SLOT_COUNT ||
+               cursors[i] == 0)
+            {
+                continue;
+            }
+            slot = &log_rings[i].slots[(cursors[i] - 1) &
+                                       (KERNEL_LOG_SLOT_COUNT - 1)];
+            if(slot->sequence == cursors[i] &&
+               (newest == NULL || slot->timestamp >= newest->timestamp))
+            {
+                newest     = slot;
+                newest_cpu = i;
+            }
+        }
+        if(newest == NULL)
+        {
+            break;
+        }
+        --cursors[newest_cpu];
+    }
+
+    /* Dump the slots from the oldest */
+    while(dumped != 0)
+    {
+        newest     = NULL;
+        newest_cpu = 0;
+        for(i = 0; i < MAX_CPU_COUNT; ++i)
+        {
+            if(cursors[i] == log_rings[i].head)
+            {
+                continue;
+            }
+            slot = &log_rings[i].slots[cursors[i] &
+                                       (KERNEL_LOG_SLOT_COUNT - 1)];
+            if(slot->sequence != cursors[i] + 1)
+            {
+                /* Not written, skip it */
+                ++cursors[i];
+                continue;
+            }
+            if(newest == NULL || slot->timestamp < newest->timestamp)
+            {
+                newest     = slot;
+                newest_cpu = i;
+            }
+        }
+        if(newest == NULL)
+        {
+            break;
+        }
+        ++cursors[newest_cpu];
+        --dumped;
+
+        if((newest->flags & KERNEL_LOG_FLAG_FIRST) != 0)
+        {
+            kernel_printf("[%u.%09u | CPU %u] ",
+                          (uint32_t)(newest->timestamp / 1000000000ULL),
+                          (uint32_t)(newest->timestamp % 1000000000ULL),
+                          newest->cpu_id);
+        }
+        _log_render_slot(newest);
     }
-    /* Prtinf format string */
-    __builtin_va_start(args, fmt);
-    _kprint_fmt(fmt, args);
-    __builtin_va_end(args);
 }
 
 void kernel_printf(const char* fmt, ...)
@@ -492,166 +1159,112 @@ void kernel_printf(const char* fmt, ...)
 void kernel_error(const char* fmt, ...)
 {
     __builtin_va_list args;
-    colorscheme_t     buffer;
-    colorscheme_t     new_scheme;
 
     if(fmt == NULL)
     {
         return;
     }
 
-    new_scheme.foreground = FG_RED;
-    new_scheme.background = BG_BLACK;
-    new_scheme.vga_color  = TRUE;
-
-    /* No need to test return value */
-    console_save_color_scheme(&buffer);
-
-    /* Set REG on BLACK color scheme */
-    console_set_color_scheme(new_scheme);
-
-    /* Print tag */
-    _tag_printf("[ERROR] ");
-
-    /* Restore original screen color scheme */
-    console_set_color_scheme(buffer);
-
-    /* Printf format string */
+    /* Printf format string with its tag */
     __builtin_va_start(args, fmt);
-    _kprint_fmt(fmt, args);
+    _kprint_level(LOG_LEVEL_ERROR, fmt, args);
     __builtin_va_end(args);
 }
 
 void kernel_success(const char* fmt, ...)
 {
-    __builtin_va_list    args;
-    colorscheme_t        buffer;
-    colorscheme_t        new_scheme;
+    __builtin_va_list args;
 
     if(fmt == NULL)
     {
         return;
     }
 
-    new_scheme.foreground = FG_GREEN;
-    new_scheme.background = BG_BLACK;
-    new_scheme.vga_color  = TRUE;
-
-    /* No need to test return value */
-    console_save_color_scheme(&buffer);
-
-    /* Set REG on BLACK color scheme */
-    console_set_color_scheme(new_scheme);
-
-    /* Print tag */
-    _tag_printf("[OK] ");
-
-    /* Restore original screen color scheme */
-    console_set_color_scheme(buffer);
-
-    /* Printf format string */
+    /* Printf format string with its tag */
     __builtin_va_start(args, fmt);
-    _kprint_fmt(fmt, args);
+    _kprint_level(LOG_LEVEL_SUCCESS, fmt, args);
     __builtin_va_end(args);
 }
 
 void kernel_info(const char* fmt, ...)
 {
-    __builtin_va_list    args;
-    colorscheme_t        buffer;
-    colorscheme_t        new_scheme;
+    __builtin_va_list args;
 
     if(fmt == NULL)
     {
         return;
     }
 
-    new_scheme.foreground = FG_CYAN;
-    new_scheme.background = BG_BLACK;
-    new_scheme.vga_color  = TRUE;
-
-    /* No need to test return value */
-    console_save_color_scheme(&buffer);
-
-    /* Set REG on BLACK color scheme */
-    console_set_color_scheme(new_scheme);
-
-    /* Print tag */
-    _tag_printf("[INFO] ");
-
-    /* Restore original screen color scheme */
-    console_set_color_scheme(buffer);
-
-    /* Printf format string */
+    /* Printf format string with its tag */
     __builtin_va_start(args, fmt);
-    _kprint_fmt(fmt, args);
+    _kprint_level(LOG_LEVEL_INFO, fmt, args);
     __builtin_va_end(args);
 }
 
 void kernel_warning(const char* fmt, ...)
 {
-    __builtin_va_list    args;
-    colorscheme_t        buffer;
-    colorscheme_t        new_scheme;
+    __builtin_va_list args;
 
     if(fmt == NULL)
     {
         return;
     }
 
-    new_scheme.foreground = FG_BROWN;
-    new_scheme.background = BG_BLACK;
-    new_scheme.vga_color  = TRUE;
-
-    /* No need to test return value */
-    console_save_color_scheme(&buffer);
-
-    /* Set REG on BLACK color scheme */
-    console_set_color_scheme(new_scheme);
-
-    /* Print tag */
-    _tag_printf("[WARNING] ");
-
-    /* Restore original screen color scheme */
-    console_set_color_scheme(buffer);
-
-    /* Printf format string */
+    /* Printf format string with its tag */
     __builtin_va_start(args, fmt);
-    _kprint_fmt(fmt, args);
+    _kprint_level(LOG_LEVEL_WARNING, fmt, args);
     __builtin_va_end(args);
 }
 
 void kernel_debug(const char* fmt, ...)
 {
-    __builtin_va_list    args;
-    colorscheme_t        buffer;
-    colorscheme_t        new_scheme;
+    __builtin_va_list args;
 
     if(fmt == NULL)
     {
         return;
     }
 
-    new_scheme.foreground = FG_YELLOW;
-    new_scheme.background = BG_BLACK;
-    new_scheme.vga_color  = TRUE;
+    /* Printf format string with its tag */
+    __builtin_va_start(args, fmt);
+    _kprint_level(LOG_LEVEL_DEBUG, fmt, args);
+    __builtin_va_end(args);
+}
+
+void kernel_debug_binary(const char* fmt,
+                         const uint32_t arg_count,
+                         const uint64_t* args)
+{
+    kernel_log_ring_t* ring;
+    kernel_log_slot_t* slot;
+    uint32_t           cpu_id;
+    uint32_t           index;
+
+    if(fmt == NULL || arg_count > KERNEL_LOG_BINARY_MAX_ARGS)
+    {
+        return;
+    }
 
-    /* No need to test return value */
-    console_save_color_scheme(&buffer);
+    if(log_enabled == FALSE)
+    {
+        _kprint_words(LOG_LEVEL_DEBUG, FALSE, TRUE, fmt, arg_count, args);
+        return;
+    }
 
-    /* Set REG on BLACK color scheme */
-    console_set_color_scheme(new_scheme);
+    ring = _log_get_ring(&cpu_id);
+    slot = _log_reserve(ring, &index);
 
-    /* Print tag */
-    _tag_printf("[DEBUG] ");
+    slot->level     = LOG_LEVEL_DEBUG;
+    slot->flags     = KERNEL_LOG_FLAG_FIRST | KERNEL_LOG_FLAG_BINARY;
+    slot->length    = arg_count;
+    slot->cpu_id    = cpu_id;
+    slot->timestamp = log_driver.get_time_ns();
+    memcpy(slot->text, &fmt, sizeof(fmt));
+    memcpy(slot->text + sizeof(fmt), args, arg_count * sizeof(uint64_t));
 
-    /* Restore original screen color scheme */
-    console_set_color_scheme(buffer);
+    __atomic_store_n(&slot->sequence, index + 1, __ATOMIC_RELEASE);
 
-    /* Printf format string */
-    __builtin_va_start(args, fmt);
-    _kprint_fmt(fmt, args);
-    __builtin_va_end(args);
+    log_driver.notify();
 }
 
 void kernel_doprint(const char* str, __builtin_va_list args)
@@ -52,6 +52,26 @@ typedef enum
     OS_ERR_NO_SUCH_IRQ                     = 6,
     /** @brief Missing required memory */
     OS_ERR_NO_MORE_MEMORY                  = 7,
+    /** @brief The priority is out of the scheduler's bounds. */
+    OS_ERR_FORBIDEN_PRIORITY               = 8,
+    /** @brief The feature is not supported by the system. */
+    OS_ERR_NOT_SUPPORTED                   = 9,
+    /** @brief The memory is already mapped. */
+    OS_ERR_MAPPING_ALREADY_EXISTS          = 10,
+    /** @brief The memory is not mapped. */
+    OS_ERR_MEMORY_NOT_MAPPED               = 11,
+    /** @brief The resource is held by another thread. */
+    OS_ERR_RESOURCE_BUSY                   = 12,
+    /** @brief Unknown system call. */
+    OS_ERR_NO_SUCH_SYSCALL                 = 13,
+    /** @brief System call handler was already registered. */
+    OS_ERR_SYSCALL_ALREADY_REGISTERED      = 14,
+    /** @brief The file does not exist. */
+    OS_ERR_FILE_NOT_FOUND                  = 15,
+    /** @brief The data is not in the expected format. */
+    OS_ERR_CORRUPTED_DATA                  = 16,
+    /** @brief The value is out of the resource bounds. */
+    OS_ERR_OUT_OF_BOUND                    = 17,
 } OS_RETURN_E;
 
 /*******************************************************************************
@@ -82,4 +102,3 @@ typedef enum
 #endif /* #ifndef __LIB_KERROR_H_ */
 
 /************************************ EOF *************************************/
-
@@ -1,2 +1,6 @@
 DEP_INCLUDES = -I ../libtrace/includes
+
+ARCH_CPU_DIR = ../../Arch/CPU
+include $(ARCH_CPU_DIR)/cpu_includes.mk
+
 DEP_LIBS     =
\ No newline at end of file
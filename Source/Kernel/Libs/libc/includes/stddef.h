@@ -95,6 +95,16 @@ typedef uint32_t uintptr_t;
  */
 #define MAX(x, y) ((x) < (y) ? (y) : (x))
 
+/** @brief Defines the offsetof function, returns the offset of a member in a
+ * structure.
+ *
+ * @param[in] TYPE The structure type.
+ * @param[in] MEMBER The member to get the offset of.
+ *
+ * @return The offset in bytes of the member in the structure.
+ */
+#define offsetof(TYPE, MEMBER) __builtin_offsetof(TYPE, MEMBER)
+
 /*******************************************************************************
  * GLOBAL VARIABLES
  ******************************************************************************/
@@ -34,7 +34,23 @@
  * STRUCTURES AND TYPES
  ******************************************************************************/
 
-/* None */
+/**
+ * @brief Precomputed reciprocal of a 64 bits divisor.
+ *
+ * @details Precomputed reciprocal of a 64 bits divisor, initialized with
+ * div_by_const_init. The division is then a multiplication and shifts.
+ */
+typedef struct
+{
+    /** @brief Reciprocal multiplier, 0 for powers of two. */
+    uint64_t magic;
+
+    /** @brief Final shift of the quotient. */
+    uint32_t shift;
+
+    /** @brief Tells if the multiplier has an implicit 65th bit. */
+    bool_t add;
+} div_by_const_t;
 
 /*******************************************************************************
  * MACROS
@@ -83,6 +99,112 @@ void itoa(int64_t value, char* buf, uint32_t base);
  */
 void uitoa(uint64_t value, char* buf, uint32_t base);
 
+/**
+ * @brief Convert a signed integer value to a string and returns its length.
+ *
+ * @details Convert a signed integer value to a string and inject the conversion
+ * result in the buffer given as parameter. The string is NULL terminated. A
+ * base lower than 2 or greater than 16 produces "0".
+ *
+ * @param[in] value The value to convert.
+ * @param[out] buf The buffer to receive the convertion's result.
+ * @param[in] base The base of the signed integer to convert.
+ * @param[in] upper Set to TRUE to use uppercase letters for the digits greater
+ * than 9.
+ *
+ * @return The length of the string, without the NULL terminator.
+ */
+size_t itoa_len(int64_t value, char* buf, uint32_t base, bool_t upper);
+
+/**
+ * @brief Convert a unsigned integer value to a string and returns its length.
+ *
+ * @details Convert a unsigned integer value to a string and inject the
+ * conversion result in the buffer given as parameter. The string is NULL
+ * terminated. A base lower than 2 or greater than 16 produces "0".
+ *
+ * @param[in] value The value to convert.
+ * @param[out] buf The buffer to receive the convertion's result.
+ * @param[in] base The base of the unsigned integer to convert.
+ * @param[in] upper Set to TRUE to use uppercase letters for the digits greater
+ * than 9.
+ *
+ * @return The length of the string, without the NULL terminator.
+ */
+size_t uitoa_len(uint64_t value, char* buf, uint32_t base, bool_t upper);
+
+/**
+ * @brief Computes the reciprocal of a divisor.
+ *
+ * @details Computes the reciprocal of a divisor used by div_by_const. This
+ * function divides a 128 bits value and should be called once per divisor,
+ * not on hot paths. A divisor of 0 is replaced by 1.
+ *
+ * @param[out] div The reciprocal to initialize.
+ * @param[in] divisor The divisor.
+ */
+void div_by_const_init(div_by_const_t* div, uint64_t divisor);
+
+/**
+ * @brief Returns the high 64 bits of a 64 bits multiplication.
+ *
+ * @param[in] a The first operand.
+ * @param[in] b The second operand.
+ *
+ * @return The high 64 bits of the 128 bits product.
+ */
+inline static uint64_t mul_high_64(const uint64_t a, const uint64_t b)
+{
+#if defined(__x86_64__)
+    return (uint64_t)(((unsigned __int128)a * b) >> 64);
+#else
+    uint64_t lo_lo;
+    uint64_t hi_lo;
+    uint64_t lo_hi;
+    uint64_t cross;
+
+    /* Four 32 bits multiplications, the compiler emits mull for each */
+    lo_lo = (uint64_t)(uint32_t)a * (uint32_t)b;
+    hi_lo = (a >> 32) * (uint32_t)b;
+    lo_hi = (uint64_t)(uint32_t)a * (b >> 32);
+    cross = (lo_lo >> 32) + (uint32_t)hi_lo + lo_hi;
+
+    return (hi_lo >> 32) + (cross >> 32) + (a >> 32) * (b >> 32);
+#endif
+}
+
+/**
+ * @brief Divides a value by a precomputed reciprocal.
+ *
+ * @details Divides a value by the divisor which reciprocal was computed with
+ * div_by_const_init. The division is a multiplication and shifts, no
+ * division instruction or helper is used.
+ *
+ * @param[in] value The value to divide.
+ * @param[in] div The divisor reciprocal.
+ *
+ * @return The quotient of the division.
+ */
+inline static uint64_t div_by_const(const uint64_t value,
+                                    const div_by_const_t* div)
+{
+    uint64_t quot;
+
+    if(div->magic == 0)
+    {
+        return value >> div->shift;
+    }
+
+    quot = mul_high_64(value, div->magic);
+    if(div->add == TRUE)
+    {
+        /* (value + quot) / 2 without overflowing */
+        quot += (value - quot) >> 1;
+    }
+
+    return quot >> div->shift;
+}
+
 #endif /* #ifndef __LIB_STDLIB_H_ */
 
 /************************************ EOF *************************************/
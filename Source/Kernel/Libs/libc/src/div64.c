@@ -97,6 +97,10 @@ typedef unsigned int    qshift_t;
 
 static void shl(digit *p, int len, int sh);
 
+#if defined(__i386__)
+static uint64_t qdivrem32(uint64_t uq, uint32_t v, uint64_t *arq);
+#endif
+
 uint64_t __qdivrem(uint64_t uq, uint64_t vq, uint64_t *arq);
 
 uint64_t __umoddi3(uint64_t a, uint64_t b);
@@ -139,6 +143,11 @@ __qdivrem(uint64_t uq, uint64_t vq, uint64_t *arq)
             *arq = uq;
         return (0);
     }
+#if defined(__i386__)
+    /* 32 bits divisors: two native divisions */
+    if ((vq >> 32) == 0)
+        return (qdivrem32(uq, (uint32_t)vq, arq));
+#endif
     u = &uspace[0];
     v = &vspace[0];
     q = &qspace[0];
@@ -324,6 +333,29 @@ shl(digit *p, int len, int sh)
     p[i] = (digit)(LHALF((uint32_t)p[i] << sh));
 }
 
+#if defined(__i386__)
+/*
+ * Divide by a 32 bits divisor with two divl: the high word first, then the
+ * remainder and the low word. The second quotient fits in 32 bits as the
+ * remainder is lower than the divisor.
+ */
+static uint64_t
+qdivrem32(uint64_t uq, uint32_t v, uint64_t *arq)
+{
+    uint32_t hi = (uint32_t)(uq >> 32);
+    uint32_t qhi = hi / v;
+    uint32_t r = hi % v;
+    uint32_t qlo;
+
+    __asm__ ("divl %4"
+             : "=a"(qlo), "=d"(r)
+             : "a"((uint32_t)uq), "d"(r), "rm"(v));
+    if (arq)
+        *arq = r;
+    return (((uint64_t)qhi << 32) | qlo);
+}
+#endif
+
 uint64_t
 __umoddi3(uint64_t a, uint64_t b)
 {
@@ -0,0 +1,164 @@
+/*******************************************************************************
+ * @file div_by_const.c
+ *
+ * @see stdlib.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief div_by_const_init function. To be used with stdlib.h header.
+ *
+ * @details div_by_const_init function. To be used with stdlib.h header.
+ * Computes the reciprocal of a 64 bits divisor, the division is then a high
+ * multiplication and shifts. When the reciprocal does not fit in 64 bits, its
+ * 65th bit is applied with an add and shift step.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h> /* Generic int types */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <stdlib.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Divides a 128 bits value by a 64 bits value.
+ *
+ * @details Divides a 128 bits value by a 64 bits value, bit by bit. The high
+ * part of the value must be lower than the divisor so the quotient fits in 64
+ * bits.
+ *
+ * @param[in] high The high 64 bits of the value.
+ * @param[in] low The low 64 bits of the value.
+ * @param[in] divisor The divisor.
+ * @param[out] rem The remainder buffer.
+ *
+ * @return The quotient of the division.
+ */
+static uint64_t _div_128_64(uint64_t high,
+                            const uint64_t low,
+                            const uint64_t divisor,
+                            uint64_t* rem);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static uint64_t _div_128_64(uint64_t high,
+                            const uint64_t low,
+                            const uint64_t divisor,
+                            uint64_t* rem)
+{
+    uint64_t quot;
+    uint64_t carry;
+    int32_t  i;
+
+    quot = 0;
+    for(i = 63; i >= 0; --i)
+    {
+        carry = high >> 63;
+        high  = (high << 1) | ((low >> i) & 1);
+        if(carry != 0 || high >= divisor)
+        {
+            high -= divisor;
+            quot |= 1ULL << i;
+        }
+    }
+
+    *rem = high;
+    return quot;
+}
+
+void div_by_const_init(div_by_const_t* div, uint64_t divisor)
+{
+    uint64_t magic;
+    uint64_t rem;
+    uint64_t twice_rem;
+    uint32_t log2;
+
+    if(divisor == 0)
+    {
+        divisor = 1;
+    }
+
+    log2 = 63 - __builtin_clzll(divisor);
+
+    /* Powers of two are a single shift */
+    if((divisor & (divisor - 1)) == 0)
+    {
+        div->magic = 0;
+        div->shift = log2;
+        div->add   = FALSE;
+        return;
+    }
+
+    /* magic = 2^(64 + log2) / divisor, rounded up */
+    magic = _div_128_64(1ULL << log2, 0, divisor, &rem);
+    if(divisor - rem < (1ULL << log2))
+    {
+        /* The rounding error is small enough for a 64 bits multiplier */
+        div->shift = log2;
+        div->add   = FALSE;
+    }
+    else
+    {
+        /* Use 2^(65 + log2) / divisor, its 65th bit is added back */
+        magic    += magic;
+        twice_rem = rem + rem;
+        if(twice_rem >= divisor || twice_rem < rem)
+        {
+            magic += 1;
+        }
+        div->shift = log2;
+        div->add   = TRUE;
+    }
+    div->magic = magic + 1;
+}
+
+/************************************ EOF *************************************/
\ No newline at end of file
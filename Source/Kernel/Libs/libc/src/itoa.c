@@ -70,6 +70,19 @@
  * FUNCTIONS
  ******************************************************************************/
 
+size_t itoa_len(int64_t value, char* buf, uint32_t base, bool_t upper)
+{
+    /* Check sign, the negation is done unsigned to handle INT64_MIN */
+    if(base == 10 && value < 0)
+    {
+        *buf = '-';
+        return uitoa_len((uint64_t)0 - (uint64_t)value, buf + 1, base, upper)
+               + 1;
+    }
+
+    return uitoa_len((uint64_t)value, buf, base, upper);
+}
+
 void itoa(int64_t i, char* buf, uint32_t base)
 {
     /* If base is unknown just return */
@@ -78,15 +91,7 @@ void itoa(int64_t i, char* buf, uint32_t base)
         return;
     }
 
-    /* Check sign */
-    if (base == 10 && i < 0)
-    {
-        *buf++ = '-';
-        i *= -1;
-    }
-
-    /* To the job */
-    uitoa(i, buf, base);
+    (void)itoa_len(i, buf, base, TRUE);
 }
 
 /************************************ EOF *************************************/
\ No newline at end of file
@@ -7,11 +7,13 @@
  *
  * @date 03/10/2017
  *
- * @version 1.0
+ * @version 2.0
  *
  * @brief memchr function. To be used with string.h header.
  *
- * @details memchr function. To be used with string.h header.
+ * @details memchr function. To be used with string.h header. The memory is
+ * read one machine word at a time once the pointer is aligned, no byte after
+ * the end of the area is read.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -22,6 +24,7 @@
 
 /* Included headers */
 #include <stddef.h> /* Standard definitions */
+#include "word.h"   /* Machine word scanning */
 
 /* Configuration files */
 #include <config.h>
@@ -73,7 +76,25 @@
 void *memchr(const void *s, int c, size_t n)
 {
     const unsigned char *sp = s;
+    const word_t *w;
+    uintptr_t pattern;
 
+    while (n && (uintptr_t)sp % sizeof(uintptr_t)) {
+        if (*sp == (unsigned char)c)
+            return (void *)sp;
+        sp++;
+        n--;
+    }
+
+    /* Skip the words without the character */
+    pattern = WORD_ONES * (unsigned char)c;
+    w = (const word_t *)sp;
+    while (n >= sizeof(uintptr_t) && !WORD_HAS_ZERO(*w ^ pattern)) {
+        w++;
+        n -= sizeof(uintptr_t);
+    }
+
+    sp = (const unsigned char *)w;
     while (n--) {
         if (*sp == (unsigned char)c)
             return (void *)sp;
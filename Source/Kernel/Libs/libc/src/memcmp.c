@@ -7,11 +7,13 @@
  *
  * @date 03/10/2017
  *
- * @version 1.0
+ * @version 2.0
  *
  * @brief memcmp function. To be used with string.h header.
  *
- * @details memcmp function. To be used with string.h header.
+ * @details memcmp function. To be used with string.h header. The areas are
+ * compared one machine word at a time, the first differing word gives the
+ * first differing byte.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -22,6 +24,7 @@
 
 /* Included headers */
 #include <stddef.h> /* Standard definitions */
+#include "word.h"   /* Machine word scanning */
 
 /* Configuration files */
 #include <config.h>
@@ -39,7 +42,8 @@
  * STRUCTURES AND TYPES
  ******************************************************************************/
 
-/* None */
+/** @brief Unaligned machine word access. */
+typedef uintptr_t __attribute__((__may_alias__, __aligned__(1))) word_u_t;
 
 /*******************************************************************************
  * MACROS
@@ -75,6 +79,19 @@ int memcmp(const void *s1, const void *s2, size_t n)
     const unsigned char *c1 = s1, *c2 = s2;
     int d = 0;
 
+    while (n >= sizeof(uintptr_t)) {
+        uintptr_t diff = *(const word_u_t *)c1 ^ *(const word_u_t *)c2;
+
+        if (diff) {
+            /* Little endian: the lowest differing bit is in the first byte */
+            size_t i = WORD_FIRST_BYTE(diff);
+            return (int)c1[i] - (int)c2[i];
+        }
+        c1 += sizeof(uintptr_t);
+        c2 += sizeof(uintptr_t);
+        n -= sizeof(uintptr_t);
+    }
+
     while (n--) {
         d = (int)*c1++ - (int)*c2++;
         if (d)
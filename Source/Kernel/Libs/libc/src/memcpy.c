@@ -7,11 +7,19 @@
  *
  * @date 03/10/2017
  *
- * @version 1.0
+ * @version 2.0
  *
  * @brief memcpy function. To be used with string.h header.
  *
- * @details memcpy function. To be used with string.h header.
+ * @details memcpy function. To be used with string.h header. The copy
+ * strategy depends on the size: sizes below 16 bytes are copied with two
+ * overlapping unaligned moves, medium sizes with a word loop and large sizes
+ * with the string instructions. When the CPU has fast short REP MOVSB, all
+ * the sizes above 16 bytes are copied with it, when it has enhanced REP MOVSB,
+ * the large sizes are. The CPU features are selected by the boot time
+ * alternatives, without runtime check. The source is always read before the
+ * overlapping destination bytes are written, memmove relies on it when the
+ * destination is before the source.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -21,7 +29,8 @@
  ******************************************************************************/
 
 /* Included headers */
-#include <stddef.h> /* Standard definitions */
+#include <stddef.h>       /* Standard definitions */
+#include <cpu_features.h> /* CPU features alternatives */
 
 /* Configuration files */
 #include <config.h>
@@ -33,13 +42,23 @@
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Size from which the string instructions are used. Below, their
+ * startup cost is higher than the word loop.
+ */
+#define MEMCPY_REP_THRESHOLD 256
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
 
-/* None */
+/** @brief Unaligned 16 bits access. */
+typedef uint16_t __attribute__((__may_alias__, __aligned__(1))) u16_u_t;
+/** @brief Unaligned 32 bits access. */
+typedef uint32_t __attribute__((__may_alias__, __aligned__(1))) u32_u_t;
+/** @brief Unaligned 64 bits access. */
+typedef uint64_t __attribute__((__may_alias__, __aligned__(1))) u64_u_t;
+/** @brief Unaligned machine word access. */
+typedef uintptr_t __attribute__((__may_alias__, __aligned__(1))) word_u_t;
 
 /*******************************************************************************
  * MACROS
@@ -64,16 +83,87 @@
  * STATIC FUNCTIONS DECLARATIONS
  ******************************************************************************/
 
-/* None */
+/**
+ * @brief Copies n bytes with REP MOVSB.
+ *
+ * @param[out] q The destination.
+ * @param[in] p The source.
+ * @param[in] n The number of bytes to copy.
+ */
+static inline void memcpy_movsb(char *q, const char *p, size_t n);
 
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
 
+static inline void memcpy_movsb(char *q, const char *p, size_t n)
+{
+    __asm__ __volatile__ ("cld ; rep ; movsb"
+              : "+c" (n), "+S" (p), "+D" (q)
+              :: "memory");
+}
+
+/* The word loop must not be turned into a memcpy call */
+__attribute__((optimize("no-tree-loop-distribute-patterns")))
 void *memcpy(void *dst, const void *src, size_t n)
 {
     const char *p = src;
     char *q = dst;
+
+    /* Small sizes: load both ends then store them, the moves overlap */
+    if (n < 4) {
+        if (n) {
+            char a = p[0], b = p[n >> 1], c = p[n - 1];
+            q[0] = a;
+            q[n >> 1] = b;
+            q[n - 1] = c;
+        }
+        return dst;
+    }
+    if (n < 8) {
+        uint32_t a = *(const u32_u_t *)p;
+        uint32_t b = *(const u32_u_t *)(p + n - 4);
+        *(u32_u_t *)q = a;
+        *(u32_u_t *)(q + n - 4) = b;
+        return dst;
+    }
+    if (n <= 16) {
+        uint64_t a = *(const u64_u_t *)p;
+        uint64_t b = *(const u64_u_t *)(p + n - 8);
+        *(u64_u_t *)q = a;
+        *(u64_u_t *)(q + n - 8) = b;
+        return dst;
+    }
+
+    /* Fast short REP MOVSB: no startup cost to amortize */
+    if (CPU_FEATURE_STATIC(CPU_FEATURE_FSRM)) {
+        memcpy_movsb(q, p, n);
+        return dst;
+    }
+
+    /* Medium sizes: word loop, the last word is loaded first and stored last
+     * so the tail is copied with an overlapping move.
+     */
+    if (n < MEMCPY_REP_THRESHOLD) {
+        uintptr_t tail = *(const word_u_t *)(p + n - sizeof(uintptr_t));
+        char *end = q + n - sizeof(uintptr_t);
+
+        while (q < end) {
+            *(word_u_t *)q = *(const word_u_t *)p;
+            q += sizeof(uintptr_t);
+            p += sizeof(uintptr_t);
+        }
+        *(word_u_t *)end = tail;
+        return dst;
+    }
+
+    /* Large sizes: the string instructions use fast string operations, a
+     * single REP MOVSB with enhanced REP MOVSB
+     */
+    if (CPU_FEATURE_STATIC(CPU_FEATURE_ERMS)) {
+        memcpy_movsb(q, p, n);
+        return dst;
+    }
 #if defined(__i386__)
     size_t nl = n >> 2;
     __asm__ __volatile__ ("cld ; rep ; movsl ; movl %3,%0 ; rep ; movsb":"+c"
@@ -7,11 +7,13 @@
  *
  * @date 03/10/2017
  *
- * @version 1.0
+ * @version 2.0
  *
  * @brief memmem function. To be used with string.h header.
  *
- * @details memmem function. To be used with string.h header.
+ * @details memmem function. To be used with string.h header. The search uses
+ * the Two-Way algorithm and runs in linear time with constant space. Windows
+ * which last byte does not appear in the needle are skipped entirely.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -45,7 +47,16 @@
  * MACROS
  ******************************************************************************/
 
-/* None */
+/**
+ * @brief Applies a bit operation on the bit of a byte in a bytes set.
+ *
+ * @param[in] SET The bytes set.
+ * @param[in] BYTE The byte.
+ * @param[in] OP The operation.
+ */
+#define BYTESET_OP(SET, BYTE, OP)                                         \
+    ((SET)[(size_t)(BYTE) / (8 * sizeof(*(SET)))] OP                      \
+     ((size_t)1 << ((size_t)(BYTE) % (8 * sizeof(*(SET))))))
 
 /*******************************************************************************
  * GLOBAL VARIABLES
@@ -64,12 +75,124 @@
  * STATIC FUNCTIONS DECLARATIONS
  ******************************************************************************/
 
-/* None */
+/**
+ * @brief Searches a needle in a haystack with the Two-Way algorithm.
+ *
+ * @details Searches a needle in a haystack with the Two-Way algorithm. The
+ * needle is split at its critical factorization, the right part is compared
+ * first then the left part. The shifts depend on the needle period, the
+ * comparisons already done are remembered for periodic needles.
+ *
+ * @param[in] h The haystack.
+ * @param[in] n The haystack length.
+ * @param[in] x The needle.
+ * @param[in] m The needle length, at least 2 and at most n.
+ *
+ * @return The first occurrence of the needle or NULL.
+ */
+static void *_two_way(const unsigned char *h, size_t n,
+                      const unsigned char *x, size_t m);
 
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
 
+static void *_two_way(const unsigned char *h, size_t n,
+                      const unsigned char *x, size_t m)
+{
+    const unsigned char *z = h + n;
+    size_t byteset[32 / sizeof(size_t)] = { 0 };
+    size_t i, ip, jp, k, p, ms, p0, mem, mem0;
+
+    for (i = 0; i < m; i++)
+        BYTESET_OP(byteset, x[i], |=);
+
+    /* Maximal suffix for the byte order */
+    ip = -1;
+    jp = 0;
+    k = p = 1;
+    while (jp + k < m) {
+        if (x[ip + k] == x[jp + k]) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else
+                k++;
+        } else if (x[ip + k] > x[jp + k]) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+    ms = ip;
+    p0 = p;
+
+    /* Maximal suffix for the reverse order, keep the longest */
+    ip = -1;
+    jp = 0;
+    k = p = 1;
+    while (jp + k < m) {
+        if (x[ip + k] == x[jp + k]) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else
+                k++;
+        } else if (x[ip + k] < x[jp + k]) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = p = 1;
+        }
+    }
+    if (ip + 1 > ms + 1)
+        ms = ip;
+    else
+        p = p0;
+
+    /* Non periodic needle: the shift is bounded by the longest part and
+       nothing is remembered between windows */
+    if (memcmp(x, x + p, ms + 1)) {
+        mem0 = 0;
+        p = MAX(ms, m - ms - 1) + 1;
+    } else
+        mem0 = m - p;
+    mem = 0;
+
+    while ((size_t)(z - h) >= m) {
+        /* No occurrence can contain a byte absent from the needle */
+        if (!BYTESET_OP(byteset, h[m - 1], &)) {
+            h += m;
+            mem = 0;
+            continue;
+        }
+
+        /* Right part */
+        for (k = MAX(ms + 1, mem); k < m && x[k] == h[k]; k++)
+            ;
+        if (k < m) {
+            h += k - ms;
+            mem = 0;
+            continue;
+        }
+
+        /* Left part */
+        for (k = ms + 1; k > mem && x[k - 1] == h[k - 1]; k--)
+            ;
+        if (k <= mem)
+            return (void *)h;
+        h += p;
+        mem = mem0;
+    }
+
+    return NULL;
+}
+
 void *memmem(const void *haystack, size_t n, const void *needle, size_t m)
 {
     const unsigned char *y = (const unsigned char *)haystack;
@@ -78,36 +201,13 @@ void *memmem(const void *haystack, size_t n, const void *needle, size_t m)
     if (m > n || !m || !n)
         return NULL;
 
-    if (1 != m) {
-        size_t j, k, l;
+    /* Start at the first occurrence of the needle first byte */
+    y = memchr(y, x[0], n - m + 1);
+    if (!y || 1 == m)
+        return (void *)y;
+    n -= y - (const unsigned char *)haystack;
 
-        if (x[0] == x[1]) {
-            k = 2;
-            l = 1;
-        } else {
-            k = 1;
-            l = 2;
-        }
-
-        j = 0;
-        while (j <= n - m) {
-            if (x[1] != y[j + 1]) {
-                j += k;
-            } else {
-                if (!memcmp(x + 2, y + j + 2, m - 2)
-                    && x[0] == y[j])
-                    return (void *)&y[j];
-                j += l;
-            }
-        }
-    } else
-        do {
-            if (*y == *x)
-                return (void *)y;
-            y++;
-        }while (--n);
-
-    return NULL;
+    return _two_way(y, n, x, m);
 }
 
 /************************************ EOF *************************************/
\ No newline at end of file
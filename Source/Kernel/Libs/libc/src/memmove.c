@@ -7,11 +7,14 @@
  *
  * @date 03/10/2017
  *
- * @version 1.0
+ * @version 2.0
  *
  * @brief memmove function. To be used with string.h header.
  *
- * @details memmove function. To be used with string.h header.
+ * @details memmove function. To be used with string.h header. When the
+ * destination is before the source or does not overlap it, the copy is done
+ * by memcpy which reads the source before writing the overlapping destination
+ * bytes. Otherwise, the copy is done backward with a word loop.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -39,7 +42,8 @@
  * STRUCTURES AND TYPES
  ******************************************************************************/
 
-/* None */
+/** @brief Unaligned machine word access. */
+typedef uintptr_t __attribute__((__may_alias__, __aligned__(1))) word_u_t;
 
 /*******************************************************************************
  * MACROS
@@ -70,33 +74,34 @@
  * FUNCTIONS
  ******************************************************************************/
 
+/* The word loop must not be turned into a memmove call */
+__attribute__((optimize("no-tree-loop-distribute-patterns")))
 void *memmove(void *dst, const void *src, size_t n)
 {
     const char *p = src;
     char *q = dst;
-#if defined(__i386__) || defined(__x86_64__)
-    if (q < p) {
-        __asm__ __volatile__("cld ; rep ; movsb"
-                 : "+c" (n), "+S"(p), "+D"(q));
-    } else {
-        p += (n - 1);
-        q += (n - 1);
-        __asm__ __volatile__("std ; rep ; movsb"
-                 : "+c" (n), "+S"(p), "+D"(q));
+
+    /* memcpy copies forward and small sizes are loaded before being stored */
+    if ((uintptr_t)q - (uintptr_t)p >= n || n <= 16) {
+        return memcpy(dst, src, n);
     }
-#else
-    if (q < p) {
-        while (n--) {
-            *q++ = *p++;
-        }
-    } else {
+
+    /* Backward word loop, the first word is loaded first and stored last so
+     * the head is copied with an overlapping move.
+     */
+    {
+        uintptr_t head = *(const word_u_t *)p;
+
         p += n;
         q += n;
-        while (n--) {
-            *--q = *--p;
+        while (q - sizeof(uintptr_t) > (char *)dst) {
+            p -= sizeof(uintptr_t);
+            q -= sizeof(uintptr_t);
+            *(word_u_t *)q = *(const word_u_t *)p;
         }
+        *(word_u_t *)dst = head;
     }
-#endif
+
     return dst;
 }
 
@@ -7,11 +7,15 @@
  *
  * @date 03/10/2017
  *
- * @version 1.0
+ * @version 2.0
  *
  * @brief memset function. To be used with string.h header.
  *
- * @details memset function. To be used with string.h header.
+ * @details memset function. To be used with string.h header. The fill
+ * strategy depends on the size: sizes below 16 bytes are filled with two
+ * overlapping unaligned stores, medium sizes with a word loop and large sizes
+ * with the string instructions, a single REP STOSB when the CPU has enhanced
+ * REP STOSB. The CPU feature is selected by the boot time alternatives.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -21,7 +25,8 @@
  ******************************************************************************/
 
 /* Included headers */
-#include <stddef.h> /* Standard definitions */
+#include <stddef.h>       /* Standard definitions */
+#include <cpu_features.h> /* CPU features alternatives */
 
 /* Configuration files */
 #include <config.h>
@@ -33,13 +38,21 @@
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Size from which the string instructions are used. Below, their
+ * startup cost is higher than the word loop.
+ */
+#define MEMSET_REP_THRESHOLD 256
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
 
-/* None */
+/** @brief Unaligned 32 bits access. */
+typedef uint32_t __attribute__((__may_alias__, __aligned__(1))) u32_u_t;
+/** @brief Unaligned 64 bits access. */
+typedef uint64_t __attribute__((__may_alias__, __aligned__(1))) u64_u_t;
+/** @brief Unaligned machine word access. */
+typedef uintptr_t __attribute__((__may_alias__, __aligned__(1))) word_u_t;
 
 /*******************************************************************************
  * MACROS
@@ -70,10 +83,53 @@
  * FUNCTIONS
  ******************************************************************************/
 
+/* The word loop must not be turned into a memset call */
+__attribute__((optimize("no-tree-loop-distribute-patterns")))
 void *memset(void *dst, int c, size_t n)
 {
     char *q = dst;
+    uint64_t v = (unsigned char)c * 0x0101010101010101ULL;
+
+    /* Small sizes: store both ends, the stores overlap */
+    if (n < 4) {
+        if (n) {
+            q[0] = c;
+            q[n >> 1] = c;
+            q[n - 1] = c;
+        }
+        return dst;
+    }
+    if (n < 8) {
+        *(u32_u_t *)q = (uint32_t)v;
+        *(u32_u_t *)(q + n - 4) = (uint32_t)v;
+        return dst;
+    }
+    if (n <= 16) {
+        *(u64_u_t *)q = v;
+        *(u64_u_t *)(q + n - 8) = v;
+        return dst;
+    }
 
+    /* Medium sizes: word loop, the tail is filled with an overlapping store */
+    if (n < MEMSET_REP_THRESHOLD) {
+        char *end = q + n - sizeof(uintptr_t);
+
+        while (q < end) {
+            *(word_u_t *)q = (uintptr_t)v;
+            q += sizeof(uintptr_t);
+        }
+        *(word_u_t *)end = (uintptr_t)v;
+        return dst;
+    }
+
+    /* Large sizes: the string instructions use fast string operations */
+    if (CPU_FEATURE_STATIC(CPU_FEATURE_ERMS)) {
+        __asm__ __volatile__ ("cld ; rep ; stosb"
+                  : "+c" (n), "+D" (q)
+                  : "a" (c)
+                  : "memory");
+        return dst;
+    }
 #if defined(__i386__)
     size_t nl = n >> 2;
     __asm__ __volatile__ ("cld ; rep ; stosl ; movl %3,%0 ; rep ; stosb"
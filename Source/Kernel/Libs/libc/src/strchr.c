@@ -7,11 +7,14 @@
  *
  * @date 03/10/2017
  *
- * @version 1.0
+ * @version 2.0
  *
  * @brief strchr function. To be used with string.h header.
  *
- * @details strchr function. To be used with string.h header.
+ * @details strchr function. To be used with string.h header. The string is
+ * read one machine word at a time once the pointer is aligned, each word is
+ * tested for the terminator and the character. Aligned words never cross a
+ * page boundary, reading past the terminator is safe.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -21,7 +24,7 @@
  ******************************************************************************/
 
 /* Included headers */
-/* None */
+#include "word.h" /* Machine word scanning */
 
 /* Configuration files */
 #include <config.h>
@@ -72,13 +75,26 @@
 
 char *strchr(const char *s, int c)
 {
-    while (*s != (char)c) {
+    const word_t *w;
+    uintptr_t pattern;
+    uintptr_t found;
+
+    while ((uintptr_t)s % sizeof(uintptr_t)) {
+        if (*s == (char)c)
+            return (char *)s;
         if (!*s)
             return NULL;
         s++;
     }
 
-    return (char *)s;
+    /* Stop on the first word holding the terminator or the character */
+    pattern = WORD_ONES * (unsigned char)c;
+    w = (const word_t *)s;
+    while (!(found = WORD_HAS_ZERO(*w) | WORD_HAS_ZERO(*w ^ pattern)))
+        w++;
+
+    s = (const char *)w + WORD_FIRST_BYTE(found);
+    return *s == (char)c ? (char *)s : NULL;
 }
 
 /************************************ EOF *************************************/
\ No newline at end of file
@@ -7,11 +7,13 @@
  *
  * @date 03/10/2017
  *
- * @version 1.0
+ * @version 2.0
  *
  * @brief strlen function. To be used with string.h header.
  *
- * @details strlen function. To be used with string.h header.
+ * @details strlen function. To be used with string.h header. The string is
+ * read one machine word at a time once the pointer is aligned. Aligned words
+ * never cross a page boundary, reading past the terminator is safe.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -22,6 +24,7 @@
 
 /* Included headers */
 #include <stddef.h> /* Standard definitions */
+#include "word.h"   /* Machine word scanning */
 
 /* Configuration files */
 #include <config.h>
@@ -73,9 +76,20 @@
 size_t strlen(const char *s)
 {
     const char *ss = s;
-    while (*ss)
+    const word_t *w;
+    uintptr_t zero;
+
+    while ((uintptr_t)ss % sizeof(uintptr_t)) {
+        if (!*ss)
+            return ss - s;
         ss++;
-    return ss - s;
+    }
+
+    w = (const word_t *)ss;
+    while (!(zero = WORD_HAS_ZERO(*w)))
+        w++;
+
+    return (const char *)w + WORD_FIRST_BYTE(zero) - s;
 }
 
 /************************************ EOF *************************************/
@@ -7,11 +7,13 @@
  *
  * @date 03/10/2017
  *
- * @version 1.0
+ * @version 1.1
  *
  * @brief __udivmoddi4 function. To be used with stdlib.h header.
  *
- * @details __udivmoddi4 function. To be used with stdlib.h header.
+ * @details __udivmoddi4 function. To be used with stdlib.h header. On i386,
+ * divisors that fit in 32 bits are divided with two native divisions instead
+ * of the bit by bit loop.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -91,6 +93,27 @@ uint64_t __udivmoddi4(uint64_t num, uint64_t den, uint64_t* rem_p)
         return 1 / ((unsigned)den);
     }
 
+#if defined(__i386__)
+    if((den >> 32) == 0)
+    {
+        uint32_t hi;
+        uint32_t rem;
+        uint32_t quot_lo;
+
+        /* The high word first, then the remainder and the low word */
+        hi  = (uint32_t)(num >> 32);
+        rem = hi % (uint32_t)den;
+        __asm__ ("divl %4"
+                 : "=a"(quot_lo), "=d"(rem)
+                 : "a"((uint32_t)num), "d"(rem), "rm"((uint32_t)den));
+        if(rem_p)
+        {
+            *rem_p = rem;
+        }
+        return ((uint64_t)(hi / (uint32_t)den) << 32) | quot_lo;
+    }
+#endif
+
     /* Left-justify denominator and count shift */
     while((int64_t)den >= 0)
     {
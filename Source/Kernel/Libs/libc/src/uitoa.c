@@ -7,11 +7,14 @@
  *
  * @date 08/01/2018
  *
- * @version 1.0
+ * @version 2.0
  *
  * @brief uitoa function. To be used with stdlib.h header.
  *
- * @details uitoa function. To be used with stdlib.h header.
+ * @details uitoa function. To be used with stdlib.h header. The length of the
+ * string is computed before the conversion and the digits are written from the
+ * end of the buffer. Base 10 emits two digits per division using a table and
+ * power of two bases only use shifts and masks.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -34,7 +37,8 @@
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Maximal base supported by the conversion functions. */
+#define UITOA_MAX_BASE 16
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
@@ -60,53 +64,252 @@
 
 /************************** Static global variables ***************************/
 
+/** @brief Uppercase digits table. */
+static const char digits_upper[UITOA_MAX_BASE + 1] = "0123456789ABCDEF";
+
+/** @brief Lowercase digits table. */
+static const char digits_lower[UITOA_MAX_BASE + 1] = "0123456789abcdef";
+
+/** @brief Decimal digits pairs table, "00" to "99". */
+static const char digits_pairs[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+/** @brief Powers of 10 table used to compute the decimal length. */
+static const uint64_t pow10_table[20] = {
+    1ULL,
+    10ULL,
+    100ULL,
+    1000ULL,
+    10000ULL,
+    100000ULL,
+    1000000ULL,
+    10000000ULL,
+    100000000ULL,
+    1000000000ULL,
+    10000000000ULL,
+    100000000000ULL,
+    1000000000000ULL,
+    10000000000000ULL,
+    100000000000000ULL,
+    1000000000000000ULL,
+    10000000000000000ULL,
+    100000000000000000ULL,
+    1000000000000000000ULL,
+    10000000000000000000ULL
+};
+
+#ifdef ARCH_32_BITS
 /**
- * @brief Hexadecimal characters table.
+ * @brief Reciprocal of 100, avoids the 64 bits division helpers.
+ *
+ * @details The value div_by_const_init(100) computes, the shift is
+ * log2(100) = 6. The 64 bits multiplier ceil(2^70 / 100) = 0xA3D70A3D70A3D70B
+ * is not exact for all the 64 bits values: its rounding error,
+ * 100 - 2^70 mod 100 = 76, is not below 2^6. The 65 bits multiplier
+ * ceil(2^71 / 100) = 2^64 + 0x47AE147AE147AE15 is used instead, its 65th bit
+ * is implied by add. The Libc Suite compares it to the division.
  */
-static char hex_table[] =
-     {'0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F'};
+static const div_by_const_t div_100 = {0x47AE147AE147AE15ULL, 6, TRUE};
+#endif
 
 /*******************************************************************************
  * STATIC FUNCTIONS DECLARATIONS
  ******************************************************************************/
 
-/* None */
+/**
+ * @brief Converts a non zero value to a decimal string.
+ *
+ * @details Converts a non zero value to a decimal string. The length is
+ * computed first, then the digits are written two by two from the end of the
+ * buffer.
+ *
+ * @param[in] value The value to convert, must not be 0.
+ * @param[out] buf The buffer to receive the convertion's result.
+ *
+ * @return The length of the string, without the NULL terminator.
+ */
+static size_t _uitoa_dec(uint64_t value, char* buf);
+
+/**
+ * @brief Converts a non zero value to a power of two base string.
+ *
+ * @details Converts a non zero value to a power of two base string. The length
+ * is computed from the position of the most significant bit and the digits are
+ * extracted with shifts and masks.
+ *
+ * @param[in] value The value to convert, must not be 0.
+ * @param[out] buf The buffer to receive the convertion's result.
+ * @param[in] shift The log2 of the base.
+ * @param[in] digits The digits table to use.
+ *
+ * @return The length of the string, without the NULL terminator.
+ */
+static size_t _uitoa_pow2(uint64_t value, char* buf, const uint32_t shift,
+                          const char* digits);
+
+/**
+ * @brief Converts a non zero value to a string in any supported base.
+ *
+ * @details Converts a non zero value to a string in any supported base. This
+ * is the generic path used for the bases that are not 10 or a power of two.
+ *
+ * @param[in] value The value to convert, must not be 0.
+ * @param[out] buf The buffer to receive the convertion's result.
+ * @param[in] base The base to use.
+ * @param[in] digits The digits table to use.
+ *
+ * @return The length of the string, without the NULL terminator.
+ */
+static size_t _uitoa_generic(uint64_t value, char* buf, const uint32_t base,
+                             const char* digits);
 
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
 
-void uitoa(uint64_t i, char* buf, uint32_t base)
+static size_t _uitoa_dec(uint64_t value, char* buf)
+{
+    size_t   length;
+    uint32_t estimate;
+    uint32_t value32;
+    uint32_t rem;
+    uint64_t quot;
+    char*    cursor;
+
+    /* log10 estimate from log2, corrected with the powers table */
+    estimate = ((64 - __builtin_clzll(value)) * 1233) >> 12;
+    length   = estimate + 1 - (value < pow10_table[estimate]);
+
+    cursor  = buf + length;
+    *cursor = 0;
+
+    /* Wide values, one 64 bits division by 100 per two digits */
+    while(value > 0xFFFFFFFFULL)
+    {
+#ifdef ARCH_32_BITS
+        quot = div_by_const(value, &div_100);
+#else
+        quot = value / 100;
+#endif
+        rem = (uint32_t)(value - quot * 100);
+        value = quot;
+
+        cursor -= 2;
+        cursor[0] = digits_pairs[rem * 2];
+        cursor[1] = digits_pairs[rem * 2 + 1];
+    }
+
+    /* The rest fits in 32 bits */
+    value32 = (uint32_t)value;
+    while(value32 >= 100)
+    {
+        rem = value32 % 100;
+        value32 /= 100;
+
+        cursor -= 2;
+        cursor[0] = digits_pairs[rem * 2];
+        cursor[1] = digits_pairs[rem * 2 + 1];
+    }
+
+    if(value32 >= 10)
+    {
+        cursor[-2] = digits_pairs[value32 * 2];
+        cursor[-1] = digits_pairs[value32 * 2 + 1];
+    }
+    else
+    {
+        cursor[-1] = '0' + value32;
+    }
+
+    return length;
+}
+
+static size_t _uitoa_pow2(uint64_t value, char* buf, const uint32_t shift,
+                          const char* digits)
+{
+    size_t   length;
+    uint64_t mask;
+    char*    cursor;
+
+    length = (64 - __builtin_clzll(value) + shift - 1) / shift;
+    mask   = (1ULL << shift) - 1;
+
+    cursor  = buf + length;
+    *cursor = 0;
+
+    while(value != 0)
+    {
+        *--cursor = digits[value & mask];
+        value >>= shift;
+    }
+
+    return length;
+}
+
+static size_t _uitoa_generic(uint64_t value, char* buf, const uint32_t base,
+                             const char* digits)
 {
-    char tmp[128];
+    size_t   length;
+    uint64_t tmp;
+    char*    cursor;
+
+    /* Count the digits first to write them in place */
+    length = 0;
+    for(tmp = value; tmp != 0; tmp /= base)
+    {
+        ++length;
+    }
 
-    uint32_t pos  = 0;
-    uint32_t opos = 0;
-    uint32_t top  = 0;
+    cursor  = buf + length;
+    *cursor = 0;
 
-    if (i == 0 || base > 16)
+    while(value != 0)
     {
-        *buf++ = '0';
-        *buf = '\0';
-        return;
+        *--cursor = digits[value % base];
+        value /= base;
     }
 
-    /* Fill temp buffer */
-    while (i != 0)
+    return length;
+}
+
+size_t uitoa_len(uint64_t value, char* buf, uint32_t base, bool_t upper)
+{
+    const char* digits;
+
+    if(value == 0 || base < 2 || base > UITOA_MAX_BASE)
     {
-        tmp[pos++] = hex_table[i % base];
-        i /= base;
+        buf[0] = '0';
+        buf[1] = 0;
+        return 1;
     }
 
-    top = pos--;
-    /* Fill buffer */
-    for (opos = 0; opos < top; --pos, ++opos)
+    if(base == 10)
     {
-        buf[opos] = tmp[pos];
+        return _uitoa_dec(value, buf);
     }
 
-    /* Null termitate */
-    buf[opos] = 0;
+    digits = (upper == TRUE) ? digits_upper : digits_lower;
+
+    if((base & (base - 1)) == 0)
+    {
+        return _uitoa_pow2(value, buf, __builtin_ctz(base), digits);
+    }
+
+    return _uitoa_generic(value, buf, base, digits);
+}
+
+void uitoa(uint64_t i, char* buf, uint32_t base)
+{
+    (void)uitoa_len(i, buf, base, TRUE);
 }
 
 /************************************ EOF *************************************/
\ No newline at end of file
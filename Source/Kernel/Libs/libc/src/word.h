@@ -0,0 +1,87 @@
+/*******************************************************************************
+ * @file word.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Machine word scanning helpers of the libc.
+ *
+ * @details Machine word scanning helpers of the libc. The string and memory
+ * scanning functions test a machine word at a time for a zero, a given or
+ * a differing byte. This header is private to the libc sources.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __LIB_WORD_H_
+#define __LIB_WORD_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <stddef.h> /* Standard definitions */
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Machine word with all its bytes set to 0x01. */
+#define WORD_ONES  ((uintptr_t)-1 / 0xFF)
+/** @brief Machine word with all its bytes set to 0x80. */
+#define WORD_HIGHS (WORD_ONES * 0x80)
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Machine word access aliasing the bytes. */
+typedef uintptr_t __attribute__((__may_alias__)) word_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/**
+ * @brief Tells if a machine word contains a zero byte. The lowest set bit of
+ * the result is the high bit of the first zero byte.
+ *
+ * @param[in] X The machine word.
+ */
+#define WORD_HAS_ZERO(X) (((X) - WORD_ONES) & ~(X) & WORD_HIGHS)
+
+/**
+ * @brief Returns the index of the first byte flagged in a non zero machine
+ * word. __builtin_ctzl has the machine word width, __builtin_ctzll would call
+ * a libgcc helper in 32 bits mode.
+ *
+ * @param[in] X The machine word, must not be 0.
+ */
+#define WORD_FIRST_BYTE(X) ((size_t)__builtin_ctzl(X) >> 3)
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/* None */
+
+#endif /* #ifndef __LIB_WORD_H_ */
+
+/************************************ EOF *************************************/
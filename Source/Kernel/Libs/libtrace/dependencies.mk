@@ -1,2 +1,7 @@
-DEP_INCLUDES = -I ../libc/includes
+DEP_INCLUDES =  -I ../libc/includes
+DEP_INCLUDES += -I ../libapi/includes
+
+ARCH_CPU_DIR = ../../Arch/CPU
+include $(ARCH_CPU_DIR)/cpu_includes.mk
+
 DEP_LIBS     =
\ No newline at end of file
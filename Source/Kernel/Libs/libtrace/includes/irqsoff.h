@@ -0,0 +1,179 @@
+/*******************************************************************************
+ * @file irqsoff.h
+ *
+ * @see irqsoff.c
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Interrupts masked latency tracer.
+ *
+ * @details Interrupts masked latency tracer. Each CPU timestamps its
+ * interrupts disable and enable transitions: the interrupt flag helpers, the
+ * critical sections built on them, and the interrupt handlers entered with the
+ * interrupts masked by the CPU. The longest masked window of each CPU is kept
+ * with its call sites, the return addresses of the transitions opening and
+ * closing it, and each new longest window is traced as an
+ * EVENT_KERNEL_IRQSOFF_MAX event. The tracer is enabled by
+ * KERNEL_IRQSOFF_TRACER and needs the tracing: the CPUs are identified by the
+ * TSC auxiliary value the tracing library sets, read with the timestamp by
+ * RDTSCP. Nothing is measured on CPUs without RDTSCP. As for the trace rings,
+ * the transitions of a CPU before it sets its identifier might be recorded for
+ * the first CPU.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifndef __LIB_IRQSOFF_H_
+#define __LIB_IRQSOFF_H_
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+#include <stdint.h> /* Generic int types */
+#include <kerror.h> /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+#if KERNEL_IRQSOFF_TRACER && defined(_TRACING_ENABLED)
+/** @brief Set when the interrupts transitions are recorded. */
+#define IRQSOFF_ENABLED 1
+#else
+/** @brief Set when the interrupts transitions are recorded. */
+#define IRQSOFF_ENABLED 0
+#endif
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Interrupts masked window. */
+typedef struct
+{
+    /** @brief Window duration, in timestamp counter ticks. */
+    uint64_t cycles;
+
+    /** @brief Return address of the transition disabling the interrupts. */
+    uintptr_t start_site;
+
+    /** @brief Return address of the transition enabling the interrupts. */
+    uintptr_t end_site;
+} irqsoff_window_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+#if IRQSOFF_ENABLED
+/** @brief Records that the interrupts were disabled on the current CPU. */
+#define IRQSOFF_RECORD_DISABLE() irqsoff_record_disable()
+
+/** @brief Records that the interrupts are about to be enabled on the current
+ * CPU.
+ */
+#define IRQSOFF_RECORD_ENABLE() irqsoff_record_enable()
+
+/** @brief Drops the masked window of the current CPU before a wait. */
+#define IRQSOFF_PAUSE() irqsoff_pause()
+
+/** @brief Opens a new masked window on the current CPU after a wait. */
+#define IRQSOFF_RESUME() irqsoff_resume()
+#else
+#define IRQSOFF_RECORD_DISABLE()
+#define IRQSOFF_RECORD_ENABLE()
+#define IRQSOFF_PAUSE()
+#define IRQSOFF_RESUME()
+#endif
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/**
+ * @brief Records that the interrupts were disabled on the current CPU.
+ *
+ * @details Opens the masked window of the current CPU at the caller. The call
+ * is ignored when the window is already open: the nested disables do not
+ * move its start. This function must be called with the interrupts disabled.
+ */
+void irqsoff_record_disable(void);
+
+/**
+ * @brief Records that the interrupts are about to be enabled on the current
+ * CPU.
+ *
+ * @details Closes the masked window of the current CPU at the caller. The
+ * window replaces the longest one of the CPU when it lasted longer and is
+ * then traced. The call is ignored when no window is open. This function must
+ * be called with the interrupts disabled.
+ */
+void irqsoff_record_enable(void);
+
+/**
+ * @brief Drops the masked window of the current CPU.
+ *
+ * @details Drops the open window without measuring it, before the CPU waits
+ * with the interrupts masked on purpose, for instance in the idle routine.
+ * This function must be called with the interrupts disabled.
+ */
+void irqsoff_pause(void);
+
+/**
+ * @brief Opens a new masked window on the current CPU.
+ *
+ * @details Opens a new window at the caller once the wait started by
+ * irqsoff_pause ended, the interrupts still disabled. This function must be
+ * called with the interrupts disabled.
+ */
+void irqsoff_resume(void);
+
+/**
+ * @brief Clears the longest masked windows of all the CPUs.
+ *
+ * @details Clears the longest masked windows of all the CPUs. Each CPU
+ * clears its window when it closes its next one, the windows open at the time
+ * of the call are still measured.
+ */
+void irqsoff_reset(void);
+
+/**
+ * @brief Returns the longest masked window of a CPU.
+ *
+ * @param[in] cpu_id The CPU identifier.
+ * @param[out] window The buffer receiving the window, its duration is 0 when
+ * no window was closed since the last reset.
+ *
+ * @return The success state or the error code.
+ * - OS_NO_ERR is returned if no error is encountered.
+ * - OS_ERR_NULL_POINTER is returned if window is NULL.
+ * - OS_ERR_UNAUTHORIZED_ACTION is returned if cpu_id is not a valid CPU
+ * identifier.
+ * - OS_ERR_NOT_SUPPORTED is returned if the tracer is disabled.
+ */
+OS_RETURN_E irqsoff_get_max(const uint32_t cpu_id, irqsoff_window_t* window);
+
+#endif /* #ifndef __LIB_IRQSOFF_H_ */
+
+/************************************ EOF *************************************/
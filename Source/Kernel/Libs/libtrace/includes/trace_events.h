@@ -127,8 +127,70 @@ typedef enum
     EVENT_KERNEL_UART_INIT_START            = 41,
     /** @brief Kernel UART Driver Init End */
     EVENT_KERNEL_UART_INIT_END              = 42,
+    /** @brief Kernel Scheduler Init Start */
+    EVENT_KERNEL_SCHED_INIT_START           = 43,
+    /** @brief Kernel Scheduler Init End */
+    EVENT_KERNEL_SCHED_INIT_END             = 44,
+    /** @brief Kernel Scheduler Create Thread Start */
+    EVENT_KERNEL_SCHED_CREATE_THREAD_START  = 45,
+    /** @brief Kernel Scheduler Create Thread End */
+    EVENT_KERNEL_SCHED_CREATE_THREAD_END    = 46,
+    /** @brief Kernel Scheduler Context Switch */
+    EVENT_KERNEL_SCHED_SWITCH               = 47,
+    /** @brief Kernel Scheduler Work Steal */
+    EVENT_KERNEL_SCHED_STEAL                = 48,
+    /** @brief Kernel CPU SMP Init Start */
+    EVENT_KERNEL_CPU_SMP_INIT_START         = 49,
+    /** @brief Kernel CPU SMP Init End */
+    EVENT_KERNEL_CPU_SMP_INIT_END           = 50,
+    /** @brief Kernel LAPIC Timer Init Start */
+    EVENT_KERNEL_LAPIC_TIMER_INIT_START     = 51,
+    /** @brief Kernel LAPIC Timer Init End */
+    EVENT_KERNEL_LAPIC_TIMER_INIT_END       = 52,
+    /** @brief Kernel Scheduler Thread Sleep */
+    EVENT_KERNEL_SCHED_SLEEP                = 53,
+    /** @brief Kernel Scheduler Thread Wakeup */
+    EVENT_KERNEL_SCHED_WAKEUP               = 54,
+    /** @brief Kernel Scheduler FPU Load */
+    EVENT_KERNEL_SCHED_FPU_LOAD             = 55,
+    /** @brief Kernel Scheduler Thread Wait */
+    EVENT_KERNEL_SCHED_WAIT                 = 56,
+    /** @brief Kernel Init Call Start */
+    EVENT_KERNEL_INITCALL_START             = 57,
+    /** @brief Kernel Init Call End */
+    EVENT_KERNEL_INITCALL_END               = 58,
+    /** @brief Kernel Scheduler Deadline Miss */
+    EVENT_KERNEL_SCHED_DEADLINE_MISS        = 59,
+    EVENT_KERNEL_MWAIT                      = 60,
+    /** @brief Kernel Interrupts Masked Longest Window */
+    EVENT_KERNEL_IRQSOFF_MAX                = 61,
+
+    /** @brief Number of trace events, must stay the last entry. New events
+     * must also be attached to their group in the tracing library.
+     */
+    TRACE_EVENT_COUNT
 } TRACE_EVENT_E;
 
+/**
+ * @brief Tracing events groups, used to filter the events at runtime.
+ */
+typedef enum
+{
+    /** @brief Kernel boot sequence events */
+    TRACE_GROUP_KICKSTART = 0,
+    /** @brief CPU management and panic events */
+    TRACE_GROUP_CPU       = 1,
+    /** @brief Interrupt manager events */
+    TRACE_GROUP_INTERRUPT = 2,
+    /** @brief Scheduler events */
+    TRACE_GROUP_SCHEDULER = 3,
+    /** @brief Device drivers events */
+    TRACE_GROUP_DRIVER    = 4,
+
+    /** @brief Number of trace groups, must stay the last entry. */
+    TRACE_GROUP_COUNT
+} TRACE_GROUP_E;
+
 /*******************************************************************************
  * MACROS
  ******************************************************************************/
@@ -7,7 +7,7 @@
  *
  * @date 22/04/2023
  *
- * @version 1.0
+ * @version 3.0
  *
  * @brief Tracing library main file.
  *
@@ -49,16 +49,45 @@
 /**
  * @brief Traces an event.
  *
- * @details Traces an event, the first parameter is the type of the event
- * and the subsequent parameters are the metadata associated with the event.
- * Metadata are interpreted as uint32_t.
+ * @details Traces an event, the first parameter is the type of the event, the
+ * second one is the number of metadata associated with the event and the
+ * subsequent parameters are the the metadata. The number of metadata must be a
+ * literal, it selects the emitter at compile time. Metadata are stored as
+ * uint64_t.
+ */
+#define KERNEL_TRACE_EVENT(EVENT, FIELD_COUNT, ...) \
+    kernel_trace_event_##FIELD_COUNT(EVENT, ##__VA_ARGS__);
+
+/**
+ * @brief Initializes the tracing for the calling CPU.
+ *
+ * @details Initializes the tracing for the calling CPU, the parameter is the
+ * CPU identifier.
+ */
+#define KERNEL_TRACE_INIT_CPU_LOCAL(CPU_ID) kernel_trace_init_cpu_local(CPU_ID);
+
+/**
+ * @brief Sets the frequency of the timestamps clock.
  *
+ * @details Sets the frequency of the timestamps clock, the parameter is the
+ * frequency in Hz.
  */
-#define KERNEL_TRACE_EVENT(...) kernel_trace_event(__VA_ARGS__);
+#define KERNEL_TRACE_SET_CLOCK_FREQ(FREQ) kernel_trace_set_clock_freq(FREQ);
 
 #else
 
-#define KERNEL_TRACE_EVENT(...)
+/**
+ * @brief Traces an event, the tracing is disabled.
+ *
+ * @details The event metadata are only given to kernel_trace_discard in a
+ * sizeof expression, which is not evaluated. No code is generated but the
+ * variables only read by the trace events are still used. The event itself is
+ * dropped as the events are not defined when the tracing is disabled.
+ */
+#define KERNEL_TRACE_EVENT(EVENT, FIELD_COUNT, ...) \
+    ((void)sizeof(kernel_trace_discard(FIELD_COUNT, ##__VA_ARGS__)));
+#define KERNEL_TRACE_INIT_CPU_LOCAL(CPU_ID)
+#define KERNEL_TRACE_SET_CLOCK_FREQ(FREQ)
 
 #endif /* #ifdef _TRACING_ENABLED */
 
@@ -72,7 +101,11 @@
 /* None */
 
 /************************* Exported global variables **************************/
-/* None */
+/** @brief Disabled events bitmap, indexed by event identifier. Not static
+ * because checked by the inline emitters. Use kernel_trace_set_event and
+ * kernel_trace_set_group to modify it.
+ */
+extern uint32_t kernel_trace_disabled_events[(TRACE_EVENT_COUNT + 31) / 32];
 
 /************************** Static global variables ***************************/
 /* None */
@@ -82,18 +115,274 @@
  ******************************************************************************/
 
 /**
- * @brief Traces an event.
+ * @brief Writes an event.
+ *
+ * @details Reserves the slot of an event in the active packet of the calling
+ * CPU and writes the event identifier, its TSC timestamp and its metadata. The
+ * event is then committed. This function can be called from any context, it
+ * does not take any lock. In drain mode, the event is dropped if both packets
+ * of the CPU are full.
+ *
+ * @param[in] event The event identifier.
+ * @param[in] field_count The number of metadata associated with the event.
+ * @param[in] fields The event metadata.
+ */
+void kernel_trace_write(const TRACE_EVENT_E event,
+                        const uint32_t field_count,
+                        const uint64_t* fields);
+
+/**
+ * @brief Initializes the tracing for the calling CPU.
+ *
+ * @details Initializes the tracing for the calling CPU. The CPU identifier is
+ * used to select the CPU trace ring. Events traced by a CPU before this
+ * function is called are written in the ring of the first CPU.
+ *
+ * @param[in] cpu_id The calling CPU identifier.
+ */
+void kernel_trace_init_cpu_local(const uint32_t cpu_id);
+
+/**
+ * @brief Sets the frequency of the timestamps clock.
+ *
+ * @details Sets the frequency of the TSC used to timestamp the events. The
+ * frequency is written in the header of each CPU trace ring.
+ *
+ * @param[in] freq The TSC frequency in Hz.
+ */
+void kernel_trace_set_clock_freq(const uint64_t freq);
+
+/**
+ * @brief Enables or disables an event.
+ *
+ * @details Enables or disables an event at runtime. Disabled events are
+ * dropped by the emitters before reserving their slot. All events are enabled
+ * at boot. Invalid event identifiers are ignored.
+ *
+ * @param[in] event The event identifier.
+ * @param[in] enabled TRUE to enable the event and FALSE to disable it.
+ */
+void kernel_trace_set_event(const TRACE_EVENT_E event, const bool_t enabled);
+
+/**
+ * @brief Enables or disables a group of events.
+ *
+ * @details Enables or disables all the events of a group at runtime. Invalid
+ * groups are ignored.
+ *
+ * @param[in] group The events group.
+ * @param[in] enabled TRUE to enable the events and FALSE to disable them.
+ */
+void kernel_trace_set_group(const TRACE_GROUP_E group, const bool_t enabled);
+
+/**
+ * @brief Enables or disables the drain mode.
+ *
+ * @details Enables or disables the drain mode. In drain mode, a full packet is
+ * kept until it is released and events are dropped while both packets of a
+ * CPU are full. Otherwise, the oldest packet is overwritten. The drain mode
+ * should be set before the other CPUs are started.
+ *
+ * @param[in] enabled TRUE to enable the drain mode and FALSE to disable it.
+ */
+void kernel_trace_set_drain_mode(const bool_t enabled);
+
+/**
+ * @brief Returns the packet of a CPU ready to be drained.
+ *
+ * @details Returns the full packet of a CPU once all its events are committed.
+ * When flush is TRUE and no packet is full, the active packet is closed if it
+ * contains events. It is then returned once its events are committed. The
+ * packet must be released with kernel_trace_release_packet before the CPU can
+ * reuse it. Only one drain can get the packets of a CPU.
+ *
+ * @param[in] cpu_id The CPU identifier.
+ * @param[in] flush TRUE to close the active packet if no packet is full.
+ * @param[out] packet The buffer receiving the packet address.
+ * @param[out] size The buffer receiving the packet size in bytes.
+ *
+ * @return TRUE if a packet is ready, FALSE otherwise. FALSE is also returned
+ * when the drain mode is disabled.
+ */
+bool_t kernel_trace_get_packet(const uint32_t cpu_id,
+                               const bool_t flush,
+                               const uint32_t** packet,
+                               uint32_t* size);
+
+/**
+ * @brief Releases the packet of a CPU returned by kernel_trace_get_packet.
+ *
+ * @details Releases the packet of a CPU returned by kernel_trace_get_packet.
+ * The CPU can then write its events in the packet again.
  *
- * @details Traces an event, the first parameter is the type of the event
- * and the subsequent parameters are the metadata associated with the event.
+ * @param[in] cpu_id The CPU identifier.
+ */
+void kernel_trace_release_packet(const uint32_t cpu_id);
+
+/**
+ * @brief Copies the active packet of a CPU.
+ *
+ * @details Copies the active packet of a CPU, its header and the events
+ * reserved in it, the most recent events of the CPU. The size of the copied
+ * packet is set to its content. No lock is taken, this function is meant to
+ * be used by the panic handler. The events being written are copied as is.
+ *
+ * @param[in] cpu_id The CPU identifier.
+ * @param[out] buffer The buffer receiving the packet.
+ * @param[in] size The size of the buffer in bytes.
+ *
+ * @return The size of the copied packet in bytes, 0 if the tracing is not
+ * initialized or if the packet does not fit in the buffer.
+ */
+uint32_t kernel_trace_copy_active_packet(const uint32_t cpu_id,
+                                         uint32_t* buffer,
+                                         const uint32_t size);
+
+/**
+ * @brief Tells if an event is enabled.
+ *
+ * @details Tells if an event is enabled. The event identifier is usually a
+ * constant, the check is then a single test of the disabled events bitmap.
  *
  * @param[in] event The event identifier.
+ *
+ * @return TRUE if the event is enabled, FALSE otherwise.
+ */
+inline static bool_t kernel_trace_is_event_enabled(const TRACE_EVENT_E event)
+{
+    return (__atomic_load_n(&kernel_trace_disabled_events[event / 32],
+                            __ATOMIC_RELAXED) &
+            (1U << (event % 32))) == 0;
+}
+
+/**
+ * @brief Traces an event without metadata.
+ *
+ * @param[in] event The event identifier.
+ */
+inline static void kernel_trace_event_0(const TRACE_EVENT_E event)
+{
+    if(kernel_trace_is_event_enabled(event) == FALSE)
+    {
+        return;
+    }
+
+    kernel_trace_write(event, 0, 0);
+}
+
+/**
+ * @brief Traces an event with one metadata.
+ *
+ * @param[in] event The event identifier.
+ * @param[in] field0 The first metadata.
+ */
+inline static void kernel_trace_event_1(const TRACE_EVENT_E event,
+                                        const uint64_t field0)
+{
+    uint64_t fields[1];
+
+    if(kernel_trace_is_event_enabled(event) == FALSE)
+    {
+        return;
+    }
+
+    fields[0] = field0;
+    kernel_trace_write(event, 1, fields);
+}
+
+/**
+ * @brief Traces an event with two metadata.
+ *
+ * @param[in] event The event identifier.
+ * @param[in] field0 The first metadata.
+ * @param[in] field1 The second metadata.
+ */
+inline static void kernel_trace_event_2(const TRACE_EVENT_E event,
+                                        const uint64_t field0,
+                                        const uint64_t field1)
+{
+    uint64_t fields[2];
+
+    if(kernel_trace_is_event_enabled(event) == FALSE)
+    {
+        return;
+    }
+
+    fields[0] = field0;
+    fields[1] = field1;
+    kernel_trace_write(event, 2, fields);
+}
+
+/**
+ * @brief Traces an event with three metadata.
+ *
+ * @param[in] event The event identifier.
+ * @param[in] field0 The first metadata.
+ * @param[in] field1 The second metadata.
+ * @param[in] field2 The third metadata.
+ */
+inline static void kernel_trace_event_3(const TRACE_EVENT_E event,
+                                        const uint64_t field0,
+                                        const uint64_t field1,
+                                        const uint64_t field2)
+{
+    uint64_t fields[3];
+
+    if(kernel_trace_is_event_enabled(event) == FALSE)
+    {
+        return;
+    }
+
+    fields[0] = field0;
+    fields[1] = field1;
+    fields[2] = field2;
+    kernel_trace_write(event, 3, fields);
+}
+
+/**
+ * @brief Traces an event with four metadata.
+ *
+ * @param[in] event The event identifier.
+ * @param[in] field0 The first metadata.
+ * @param[in] field1 The second metadata.
+ * @param[in] field2 The third metadata.
+ * @param[in] field3 The fourth metadata.
+ */
+inline static void kernel_trace_event_4(const TRACE_EVENT_E event,
+                                        const uint64_t field0,
+                                        const uint64_t field1,
+                                        const uint64_t field2,
+                                        const uint64_t field3)
+{
+    uint64_t fields[4];
+
+    if(kernel_trace_is_event_enabled(event) == FALSE)
+    {
+        return;
+    }
+
+    fields[0] = field0;
+    fields[1] = field1;
+    fields[2] = field2;
+    fields[3] = field3;
+    kernel_trace_write(event, 4, fields);
+}
+
+#else
+
+/**
+ * @brief Discards the metadata of an event when the tracing is disabled.
+ *
+ * @details Discards the metadata of an event when the tracing is disabled.
+ * This function is not defined: it is only named by KERNEL_TRACE_EVENT in a
+ * sizeof expression, which is never evaluated.
+ *
  * @param[in] field_count The number of metadata associated with the event.
- * @param ... The event metadata associated with the event. Metadata are
- * interpreted as uint32_t.
+ * @param ... The event metadata associated with the event.
+ *
+ * @return The function is never called.
  */
-void kernel_trace_event(const TRACE_EVENT_E event, const uint32_t field_count,
-                        ...);
+int kernel_trace_discard(const uint32_t field_count, ...);
 
 #endif /* #ifndef __LIB_TRACING_H_ */
 
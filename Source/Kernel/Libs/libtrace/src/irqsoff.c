@@ -0,0 +1,278 @@
+/*******************************************************************************
+ * @file irqsoff.c
+ *
+ * @see irqsoff.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Interrupts masked latency tracer.
+ *
+ * @details Interrupts masked latency tracer. The transitions are
+ * recorded with the interrupts disabled: only its CPU updates a CPU data and
+ * no lock is taken. The longest window is published under a sequence number
+ * for the readers of the other CPUs. A reset only bumps the generation, each
+ * CPU clears its own window when it sees the new generation.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>       /* Generic integer definitions */
+#include <stddef.h>       /* Standard definitions */
+#include <cpu.h>          /* CPU TSC */
+#include <cpu_features.h> /* CPU features alternatives */
+#include <kerror.h>       /* Kernel error codes */
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <irqsoff.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Tracer data of a CPU. */
+typedef struct
+{
+    /** @brief Timestamp counter value when the open window started. */
+    uint64_t start_tsc;
+
+    /** @brief Return address of the transition opening the open window. */
+    uintptr_t start_site;
+
+    /** @brief Tells if a window is open. */
+    bool_t masked;
+
+    /** @brief Reset generation of the longest window. */
+    volatile uint32_t generation;
+
+    /** @brief Sequence number of the longest window, odd while it is
+     * written.
+     */
+    volatile uint32_t sequence;
+
+    /** @brief Longest window since the last reset. */
+    irqsoff_window_t max;
+} __attribute__((aligned(CPU_CACHE_LINE_SIZE))) irqsoff_cpu_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Tracer data of the CPUs. */
+static irqsoff_cpu_t irqsoff_cpus[MAX_CPU_COUNT];
+
+/** @brief Reset generation, incremented by irqsoff_reset. */
+static volatile uint32_t irqsoff_generation = 0;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Returns the tracer data of the current CPU and the current time.
+ *
+ * @param[out] tsc The buffer receiving the timestamp counter value.
+ *
+ * @return The tracer data of the current CPU, NULL when the CPU cannot be
+ * identified.
+ */
+inline static irqsoff_cpu_t* _irqsoff_get_cpu(uint64_t* tsc);
+
+/**
+ * @brief Opens the masked window of the current CPU.
+ *
+ * @param[in] site The return address of the transition.
+ */
+inline static void _irqsoff_start(const uintptr_t site);
+
+/**
+ * @brief Closes the masked window of the current CPU.
+ *
+ * @param[in] site The return address of the transition.
+ */
+inline static void _irqsoff_stop(const uintptr_t site);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+inline static irqsoff_cpu_t* _irqsoff_get_cpu(uint64_t* tsc)
+{
+    uint32_t cpu_id;
+
+    /* The scheduler CPU data might not be set, as for the trace rings the
+     * CPU is identified by the TSC auxiliary value
+     */
+    if(CPU_FEATURE_STATIC(CPU_FEATURE_RDTSCP))
+    {
+        *tsc = _cpu_rdtscp(&cpu_id);
+        if(cpu_id < MAX_CPU_COUNT)
+        {
+            return &irqsoff_cpus[cpu_id];
+        }
+    }
+
+    return NULL;
+}
+
+inline static void _irqsoff_start(const uintptr_t site)
+{
+    irqsoff_cpu_t* cpu;
+    uint64_t       tsc;
+
+    cpu = _irqsoff_get_cpu(&tsc);
+    if(cpu == NULL || cpu->masked == TRUE)
+    {
+        return;
+    }
+
+    cpu->start_tsc  = tsc;
+    cpu->start_site = site;
+    cpu->masked     = TRUE;
+}
+
+inline static void _irqsoff_stop(const uintptr_t site)
+{
+    irqsoff_cpu_t* cpu;
+    uint64_t       tsc;
+    uint64_t       cycles;
+    uint32_t       generation;
+
+    cpu = _irqsoff_get_cpu(&tsc);
+    if(cpu == NULL || cpu->masked == FALSE)
+    {
+        return;
+    }
+
+    cpu->masked = FALSE;
+    cycles      = tsc - cpu->start_tsc;
+
+    generation = __atomic_load_n(&irqsoff_generation, __ATOMIC_RELAXED);
+    if(generation == cpu->generation && cycles <= cpu->max.cycles)
+    {
+        return;
+    }
+
+    /* Only this CPU writes its window, the sequence number is enough */
+    __atomic_store_n(&cpu->sequence, cpu->sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    cpu->max.cycles     = cycles;
+    cpu->max.start_site = cpu->start_site;
+    cpu->max.end_site   = site;
+    cpu->generation     = generation;
+
+    __atomic_store_n(&cpu->sequence, cpu->sequence + 1, __ATOMIC_RELEASE);
+
+    KERNEL_TRACE_EVENT(EVENT_KERNEL_IRQSOFF_MAX, 3,
+                       cycles, cpu->start_site, site);
+}
+
+void irqsoff_record_disable(void)
+{
+    _irqsoff_start((uintptr_t)__builtin_return_address(0));
+}
+
+void irqsoff_record_enable(void)
+{
+    _irqsoff_stop((uintptr_t)__builtin_return_address(0));
+}
+
+void irqsoff_pause(void)
+{
+    irqsoff_cpu_t* cpu;
+    uint64_t       tsc;
+
+    cpu = _irqsoff_get_cpu(&tsc);
+    if(cpu != NULL)
+    {
+        cpu->masked = FALSE;
+    }
+}
+
+void irqsoff_resume(void)
+{
+    _irqsoff_start((uintptr_t)__builtin_return_address(0));
+}
+
+void irqsoff_reset(void)
+{
+    __atomic_fetch_add(&irqsoff_generation, 1, __ATOMIC_RELAXED);
+}
+
+OS_RETURN_E irqsoff_get_max(const uint32_t cpu_id, irqsoff_window_t* window)
+{
+    const irqsoff_cpu_t* cpu;
+    uint32_t             sequence;
+    uint32_t             generation;
+
+    if(window == NULL)
+    {
+        return OS_ERR_NULL_POINTER;
+    }
+    if(cpu_id >= MAX_CPU_COUNT)
+    {
+        return OS_ERR_UNAUTHORIZED_ACTION;
+    }
+    if(IRQSOFF_ENABLED == 0)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    cpu = &irqsoff_cpus[cpu_id];
+    do
+    {
+        while(((sequence = __atomic_load_n(&cpu->sequence,
+                                           __ATOMIC_ACQUIRE)) & 1) != 0)
+        {
+            _cpu_pause();
+        }
+
+        *window    = cpu->max;
+        generation = cpu->generation;
+
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while(__atomic_load_n(&cpu->sequence, __ATOMIC_RELAXED) != sequence);
+
+    /* The CPU did not close a window since the reset */
+    if(generation != __atomic_load_n(&irqsoff_generation, __ATOMIC_RELAXED))
+    {
+        window->cycles     = 0;
+        window->start_site = 0;
+        window->end_site   = 0;
+    }
+
+    return OS_NO_ERR;
+}
+
+/************************************ EOF *************************************/
@@ -7,12 +7,23 @@
  *
  * @date 22/04/2023
  *
- * @version 1.0
+ * @version 3.0
  *
  * @brief Tracing library main file.
  *
  * @details Tracing library main file. This library allows to trace events in
- * the kernel.
+ * the kernel. The trace buffer is split in one ring per CPU, each ring holds
+ * two CTF packets used as a double buffer. Slots are reserved in the active
+ * packet with an atomic operation, no lock is taken. When the active packet is
+ * full, the writers switch to the other packet. In overwrite mode, the default,
+ * the other packet is always reused. In drain mode, a full packet is kept until
+ * it is released by the drain and events are dropped while both packets are
+ * full. Events are timestamped with the CPU TSC, the TSC frequency calibrated
+ * by the kernel is written in the header of each packet. Events can be
+ * disabled at runtime, one by one or by group, the emitters then only test a
+ * bit in the disabled events bitmap. Each packet records the timestamps of its
+ * first and last events and the number of events lost by the CPU before its
+ * start, either dropped in drain mode or overwritten.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -24,8 +35,11 @@
  ******************************************************************************/
 
 /* Included headers */
-#include <stdint.h> /* Generic integer definitions */
-#include <string.h> /* Memory manipulation */
+#include <stdint.h>       /* Generic integer definitions */
+#include <stddef.h>       /* Standard definitions */
+#include <string.h>       /* Memory manipulation */
+#include <cpu.h>          /* CPU TSC and MSR */
+#include <cpu_features.h> /* CPU features alternatives */
 
 /* Configuration files */
 #include <config.h>
@@ -41,16 +55,106 @@
 #define TRACE_LIB_MAGIC ((uint32_t)0x1ACEAC1D)
 
 /** @brief Trace library file version */
-#define TRACE_LIB_VERSION ((uint32_t)1)
+#define TRACE_LIB_VERSION ((uint32_t)5)
 
-/** @brief Trace library header length */
-#define TRACE_LIB_HEADER_LEN 2
+/** @brief Trace library packet header length, in words */
+#define TRACE_LIB_HEADER_LEN (sizeof(trace_packet_header_t) / sizeof(uint32_t))
+
+/** @brief Trace event header length (identifier and timestamp), in words */
+#define TRACE_LIB_EVENT_HEADER_LEN 3
+
+/** @brief Trace event metadata length, in words */
+#define TRACE_LIB_FIELD_LEN 2
+
+/** @brief Number of packets in each CPU ring. */
+#define TRACE_LIB_PACKET_COUNT 2
+
+/** @brief Packet state: active packet bit. */
+#define TRACE_STATE_ACTIVE      0x80000000
+/** @brief Packet state: full packet bits, one per packet. */
+#define TRACE_STATE_FULL(PACKET) (0x20000000U << (PACKET))
+/** @brief Packet state: offset of the active packet end mask, in words. */
+#define TRACE_STATE_OFFSET_MASK 0x1FFFFFFF
+
+/** @brief CPUID extended features leaf. */
+#define TRACE_CPUID_EXT_FEATURES 0x80000001
+/** @brief CPUID extended features EDX RDTSCP bit. */
+#define TRACE_CPUID_EXT_RDTSCP   0x08000000
+/** @brief TSC auxiliary MSR, returned by RDTSCP. */
+#define TRACE_MSR_TSC_AUX        0xC0000103
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
 
-/* None */
+/** @brief Trace packet header and context. The events follow the context. */
+typedef struct
+{
+    /** @brief Trace library magic. */
+    uint32_t magic;
+
+    /** @brief Trace library file version. */
+    uint32_t version;
+
+    /** @brief Identifier of the CPU owning the packet. */
+    uint32_t cpu_id;
+
+    /** @brief Offset, in words from the packet start, of the end of the last
+     * reserved event. Only the events before the cursor are valid.
+     */
+    uint32_t cursor;
+
+    /** @brief Timestamps clock frequency in Hz, low part. */
+    uint32_t clock_freq_low;
+
+    /** @brief Timestamps clock frequency in Hz, high part. */
+    uint32_t clock_freq_high;
+
+    /** @brief Timestamp of the first event of the packet, low part. */
+    uint32_t timestamp_begin_low;
+
+    /** @brief Timestamp of the first event of the packet, high part. */
+    uint32_t timestamp_begin_high;
+
+    /** @brief Timestamp of the last event of the packet, low part. */
+    uint32_t timestamp_end_low;
+
+    /** @brief Timestamp of the last event of the packet, high part. */
+    uint32_t timestamp_end_high;
+
+    /** @brief Size of the valid content of the packet, in bits. */
+    uint32_t content_size;
+
+    /** @brief Size of the packet, in bits. */
+    uint32_t packet_size;
+
+    /** @brief Number of events lost by the CPU before the packet start. */
+    uint32_t events_discarded;
+} trace_packet_header_t;
+
+/** @brief Per CPU trace ring state. */
+typedef struct
+{
+    /** @brief Active packet, full packets and offset of the end of the active
+     * packet, updated atomically.
+     */
+    uint32_t state;
+
+    /** @brief Number of words written by the committed events of each packet.
+     */
+    uint32_t committed[TRACE_LIB_PACKET_COUNT];
+
+    /** @brief Offset of the end of each full packet, 0 while not known. */
+    uint32_t content_end[TRACE_LIB_PACKET_COUNT];
+
+    /** @brief Number of committed events of each packet. */
+    uint32_t events[TRACE_LIB_PACKET_COUNT];
+
+    /** @brief Number of events lost, dropped because both packets were full
+     * or overwritten.
+     */
+    uint32_t discarded;
+} trace_ring_state_t;
 
 /*******************************************************************************
  * MACROS
@@ -64,26 +168,103 @@
 
 /************************* Imported global variables **************************/
 /** @brief Trace buffer address set by linker */
-extern uint32_t* _KERNEL_TRACE_BUFFER_BASE;
+extern uint32_t _KERNEL_TRACE_BUFFER_BASE[];
 /** @brief Trace buffer size set by linker */
 extern size_t _KERNEL_TRACE_BUFFER_SIZE;
 
 /************************* Exported global variables **************************/
-/* None */
+/** @brief Disabled events bitmap, all events are enabled at boot */
+uint32_t kernel_trace_disabled_events[(TRACE_EVENT_COUNT + 31) / 32];
 
 /************************** Static global variables ***************************/
 
-/** @brief Trace buffer cursor */
-static size_t cursor;
-
 /** @brief Tells if the tracing was enabled. */
 static bool_t enabled = FALSE;
 
+/** @brief Tells if the TSC auxiliary MSR holds the CPU identifier, read with
+ * RDTSCP once the CPU alternatives are applied.
+ */
+static bool_t use_rdtscp = FALSE;
+
+/** @brief Tells if the full packets are kept until released. */
+static bool_t drain_mode = FALSE;
+
+/** @brief Size of each packet, in words. */
+static uint32_t packet_size;
+
+/** @brief State of each CPU ring. */
+static trace_ring_state_t ring_states[MAX_CPU_COUNT];
+
 /** @brief Trace buffer address */
-static uint32_t* trace_buffer = (uint32_t*)&_KERNEL_TRACE_BUFFER_BASE;
+static uint32_t* trace_buffer = _KERNEL_TRACE_BUFFER_BASE;
 /** @brief Trace buffer size */
 static size_t trace_buffer_size = (size_t)&_KERNEL_TRACE_BUFFER_SIZE;
 
+/** @brief Group of each event */
+static const uint8_t event_groups[TRACE_EVENT_COUNT] = {
+    [EVENT_KERNEL_KICKSTART_START]            = TRACE_GROUP_KICKSTART,
+    [EVENT_KERNEL_KICKSTART_END]              = TRACE_GROUP_KICKSTART,
+    [EVENT_KERNEL_VGA_INIT_START]             = TRACE_GROUP_DRIVER,
+    [EVENT_KERNEL_VGA_INIT_END]               = TRACE_GROUP_DRIVER,
+    [EVENT_KERNEL_CPU_SET_GDT_START]          = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_CPU_SET_GDT_END]            = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_CPU_SET_IDT_START]          = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_CPU_SET_IDT_END]            = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_CPU_SET_TSS_START]          = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_CPU_SET_TSS_END]            = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_CPU_SETUP_START]            = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_CPU_SETUP_END]              = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_CPU_RAISE_INT_START]        = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_CPU_RAISE_INT_END]          = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_PANIC]                      = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_PANIC_HANDLER_START]        = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_PANIC_HANDLER_END]          = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_CPU_DISABLE_INTERRUPT]      = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_CPU_ENABLE_INTERRUPT]       = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_HALT]                       = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_INTERRUPT_HANDLER_START]    = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_INTERRUPT_HANDLER_END]      = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_INTERRUPT_INIT_START]       = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_INTERRUPT_INIT_END]         = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_INTERRUPT_SET_DRIVER_START] = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_INTERRUPT_SET_DRIVER_END]   = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_INTERRUPT_REGISTER_START]   = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_INTERRUPT_REGISTER_END]     = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_INTERRUPT_REMOVE_START]     = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_INTERRUPT_REMOVE_END]       = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_IRQ_REGISTER_START]         = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_IRQ_REGISTER_END]           = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_IRQ_REMOVE_START]           = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_IRQ_REMOVE_END]             = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_RESTORE_INTERRUPT]          = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_DISABLE_INTERRUPT]          = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_SET_IRQ_MASK]               = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_SET_IRQ_EOI]                = TRACE_GROUP_INTERRUPT,
+    [EVENT_KERNEL_CONSOLE_SET_DRIVER_START]   = TRACE_GROUP_DRIVER,
+    [EVENT_KERNEL_CONSOLE_SET_DRIVER_END]     = TRACE_GROUP_DRIVER,
+    [EVENT_KERNEL_UART_INIT_START]            = TRACE_GROUP_DRIVER,
+    [EVENT_KERNEL_UART_INIT_END]              = TRACE_GROUP_DRIVER,
+    [EVENT_KERNEL_SCHED_INIT_START]           = TRACE_GROUP_SCHEDULER,
+    [EVENT_KERNEL_SCHED_INIT_END]             = TRACE_GROUP_SCHEDULER,
+    [EVENT_KERNEL_SCHED_CREATE_THREAD_START]  = TRACE_GROUP_SCHEDULER,
+    [EVENT_KERNEL_SCHED_CREATE_THREAD_END]    = TRACE_GROUP_SCHEDULER,
+    [EVENT_KERNEL_SCHED_SWITCH]               = TRACE_GROUP_SCHEDULER,
+    [EVENT_KERNEL_SCHED_STEAL]                = TRACE_GROUP_SCHEDULER,
+    [EVENT_KERNEL_CPU_SMP_INIT_START]         = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_CPU_SMP_INIT_END]           = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_LAPIC_TIMER_INIT_START]     = TRACE_GROUP_DRIVER,
+    [EVENT_KERNEL_LAPIC_TIMER_INIT_END]       = TRACE_GROUP_DRIVER,
+    [EVENT_KERNEL_SCHED_SLEEP]                = TRACE_GROUP_SCHEDULER,
+    [EVENT_KERNEL_SCHED_WAKEUP]               = TRACE_GROUP_SCHEDULER,
+    [EVENT_KERNEL_SCHED_FPU_LOAD]             = TRACE_GROUP_SCHEDULER,
+    [EVENT_KERNEL_SCHED_WAIT]                 = TRACE_GROUP_SCHEDULER,
+    [EVENT_KERNEL_INITCALL_START]             = TRACE_GROUP_KICKSTART,
+    [EVENT_KERNEL_INITCALL_END]               = TRACE_GROUP_KICKSTART,
+    [EVENT_KERNEL_SCHED_DEADLINE_MISS]        = TRACE_GROUP_SCHEDULER,
+    [EVENT_KERNEL_MWAIT]                      = TRACE_GROUP_CPU,
+    [EVENT_KERNEL_IRQSOFF_MAX]                = TRACE_GROUP_INTERRUPT
+};
+
 /*******************************************************************************
  * STATIC FUNCTIONS DECLARATIONS
  ******************************************************************************/
@@ -92,68 +273,498 @@ static size_t trace_buffer_size = (size_t)&_KERNEL_TRACE_BUFFER_SIZE;
  * @brief Initializes the tracing feature of the kernel.
  *
  * @details Initializes the tracing feature of the kernel. The trace buffer
- * is initialized and the tracing feature ready to be used after this function
- * is called.
+ * is split in one ring per CPU and the tracing feature ready to be used after
+ * this function is called. This function must be called before the other CPUs
+ * are started.
  */
 static void kernel_trace_init(void);
 
+/**
+ * @brief Returns a packet of the given CPU.
+ *
+ * @param[in] cpu_id The CPU identifier.
+ * @param[in] packet The packet index in the CPU ring.
+ *
+ * @return The packet header.
+ */
+inline static trace_packet_header_t* _get_packet(const uint32_t cpu_id,
+                                                 const uint32_t packet);
+
+/**
+ * @brief Switches the active packet of a CPU.
+ *
+ * @details Switches the active packet of a CPU and reserves the first slot of
+ * the new active packet. The previous active packet is marked as full in drain
+ * mode. The switch fails if the state was updated concurrently or if, in drain
+ * mode, the other packet is still full.
+ *
+ * @param[in] cpu_id The CPU identifier.
+ * @param[in, out] state The expected state, updated with the current state
+ * on failure.
+ * @param[in] length The length of the slot to reserve, in words.
+ *
+ * @return TRUE if the packet was switched, FALSE otherwise.
+ */
+static bool_t _switch_packet(const uint32_t cpu_id,
+                             uint32_t* state,
+                             const uint32_t length);
+
+/**
+ * @brief Sets the end of a packet content.
+ *
+ * @param[out] packet The packet header.
+ * @param[in] end The offset of the end of the content, in words.
+ */
+inline static void _set_packet_end(trace_packet_header_t* packet,
+                                   const uint32_t end);
+
+/**
+ * @brief Updates the timestamps range of a packet with an event timestamp.
+ *
+ * @details Updates the timestamps range of a packet with an event timestamp.
+ * The first event of the packet resets the range. Events reserved by nested
+ * writers can be timestamped out of order, the range keeps the minimum and the
+ * maximum timestamps.
+ *
+ * @param[out] packet The packet header.
+ * @param[in] first TRUE if the event is the first of the packet.
+ * @param[in] timestamp The event timestamp.
+ */
+static void _update_packet_time(trace_packet_header_t* packet,
+                                const bool_t first,
+                                const uint64_t timestamp);
+
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
 
+inline static trace_packet_header_t* _get_packet(const uint32_t cpu_id,
+                                                 const uint32_t packet)
+{
+    return (trace_packet_header_t*)(trace_buffer +
+                                    (cpu_id * TRACE_LIB_PACKET_COUNT + packet) *
+                                    packet_size);
+}
+
+inline static void _set_packet_end(trace_packet_header_t* packet,
+                                   const uint32_t end)
+{
+    packet->cursor       = end;
+    packet->content_size = end * sizeof(uint32_t) * 8;
+}
+
+static void _update_packet_time(trace_packet_header_t* packet,
+                                const bool_t first,
+                                const uint64_t timestamp)
+{
+    uint64_t begin;
+    uint64_t end;
+
+    begin = ((uint64_t)packet->timestamp_begin_high << 32) |
+            packet->timestamp_begin_low;
+    end   = ((uint64_t)packet->timestamp_end_high << 32) |
+            packet->timestamp_end_low;
+
+    if(first == TRUE || timestamp < begin)
+    {
+        packet->timestamp_begin_low  = (uint32_t)timestamp;
+        packet->timestamp_begin_high = (uint32_t)(timestamp >> 32);
+    }
+    if(first == TRUE || timestamp > end)
+    {
+        packet->timestamp_end_low  = (uint32_t)timestamp;
+        packet->timestamp_end_high = (uint32_t)(timestamp >> 32);
+    }
+}
+
+static bool_t _switch_packet(const uint32_t cpu_id,
+                             uint32_t* state,
+                             const uint32_t length)
+{
+    trace_ring_state_t* ring_state;
+    uint32_t            active;
+    uint32_t            other;
+    uint32_t            new_state;
+    uint32_t            lost;
+
+    ring_state = &ring_states[cpu_id];
+    active     = (*state & TRACE_STATE_ACTIVE) != 0 ? 1 : 0;
+    other      = 1 - active;
+
+    if(drain_mode == TRUE)
+    {
+        if((*state & TRACE_STATE_FULL(other)) != 0)
+        {
+            return FALSE;
+        }
+        new_state = (*state & ~TRACE_STATE_OFFSET_MASK) |
+                    TRACE_STATE_FULL(active);
+    }
+    else
+    {
+        new_state = 0;
+    }
+    new_state = (new_state & ~TRACE_STATE_ACTIVE) |
+                (other == 1 ? TRACE_STATE_ACTIVE : 0) |
+                (TRACE_LIB_HEADER_LEN + length);
+
+    if(__atomic_compare_exchange_n(&ring_state->state, state, new_state, FALSE,
+                                   __ATOMIC_ACQ_REL,
+                                   __ATOMIC_RELAXED) == FALSE)
+    {
+        return FALSE;
+    }
+
+    /* The previous packet ends where the switch happened */
+    _set_packet_end(_get_packet(cpu_id, active),
+                    *state & TRACE_STATE_OFFSET_MASK);
+    if(drain_mode == FALSE)
+    {
+        /* Nobody reads the committed words in overwrite mode, the events of
+         * the overwritten packet are lost.
+         */
+        __atomic_store_n(&ring_state->committed[other], 0, __ATOMIC_RELAXED);
+        lost = __atomic_exchange_n(&ring_state->events[other], 0,
+                                   __ATOMIC_RELAXED);
+        __atomic_add_fetch(&ring_state->discarded, lost, __ATOMIC_RELAXED);
+    }
+    _get_packet(cpu_id, other)->events_discarded =
+        __atomic_load_n(&ring_state->discarded, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring_state->content_end[active],
+                     *state & TRACE_STATE_OFFSET_MASK,
+                     __ATOMIC_RELEASE);
+
+    return TRUE;
+}
+
 static void kernel_trace_init(void)
 {
+    trace_packet_header_t* packet;
+    uint32_t               regs[4];
+    uint32_t               i;
+    uint32_t               j;
+
     /** Init the buffer */
     memset(trace_buffer, 0, trace_buffer_size);
 
-    /* Init the trace buffer header */
-    trace_buffer[0] = TRACE_LIB_MAGIC;
-    trace_buffer[1] = TRACE_LIB_VERSION;
+    packet_size = (trace_buffer_size / sizeof(uint32_t)) /
+                  (MAX_CPU_COUNT * TRACE_LIB_PACKET_COUNT);
+
+    /* Init the packets headers */
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        for(j = 0; j < TRACE_LIB_PACKET_COUNT; ++j)
+        {
+            packet              = _get_packet(i, j);
+            packet->magic       = TRACE_LIB_MAGIC;
+            packet->version     = TRACE_LIB_VERSION;
+            packet->cpu_id      = i;
+            packet->packet_size = packet_size * sizeof(uint32_t) * 8;
+            _set_packet_end(packet, TRACE_LIB_HEADER_LEN);
+        }
+        ring_states[i].state = TRACE_LIB_HEADER_LEN;
+    }
 
-    /* Init the cursor after the header */
-    cursor = TRACE_LIB_HEADER_LEN;
+    /* RDTSCP returns the CPU identifier set in the TSC auxiliary MSR with the
+     * timestamp.
+     */
+    if(_cpu_cpuid(TRACE_CPUID_EXT_FEATURES, regs) == 1 &&
+       (regs[3] & TRACE_CPUID_EXT_RDTSCP) != 0)
+    {
+        _cpu_set_msr(TRACE_MSR_TSC_AUX, 0);
+        use_rdtscp = TRUE;
+    }
 
     enabled = TRUE;
 }
 
-void kernel_trace_event(const TRACE_EVENT_E event, const uint32_t field_count,
-                        ...)
+void kernel_trace_init_cpu_local(const uint32_t cpu_id)
 {
-    __builtin_va_list args;
-    uint32_t          i;
-    uint64_t          timestpamp;
+    if(enabled == FALSE)
+    {
+        kernel_trace_init();
+    }
+
+    if(use_rdtscp == TRUE)
+    {
+        _cpu_set_msr(TRACE_MSR_TSC_AUX, cpu_id);
+    }
+}
+
+void kernel_trace_set_clock_freq(const uint64_t freq)
+{
+    trace_packet_header_t* packet;
+    uint32_t               i;
+    uint32_t               j;
 
-    /* Init the tracing feature is needed */
     if(enabled == FALSE)
     {
         kernel_trace_init();
     }
 
-    /* Get the variadic arguments */
-    __builtin_va_start(args, field_count);
+    for(i = 0; i < MAX_CPU_COUNT; ++i)
+    {
+        for(j = 0; j < TRACE_LIB_PACKET_COUNT; ++j)
+        {
+            packet                  = _get_packet(i, j);
+            packet->clock_freq_low  = (uint32_t)freq;
+            packet->clock_freq_high = (uint32_t)(freq >> 32);
+        }
+    }
+}
+
+void kernel_trace_write(const TRACE_EVENT_E event,
+                        const uint32_t field_count,
+                        const uint64_t* fields)
+{
+    trace_ring_state_t*    ring_state;
+    trace_packet_header_t* header;
+    uint32_t*              slot;
+    uint32_t               cpu_id;
+    uint32_t               state;
+    uint32_t               start;
+    uint32_t               length;
+    uint32_t               packet;
+    uint32_t               i;
+    uint64_t               timestamp;
+
+    /* Init the tracing feature is needed */
+    if(enabled == FALSE)
+    {
+        kernel_trace_init();
+    }
 
-    /* Check the cursor position and cycle if needed */
-    if(cursor + sizeof(event) > trace_buffer_size)
+    /* Get the timestamp and the CPU. Using a wrong ring, for instance before
+     * the CPU set its identifier, only mixes the CPUs events as the slots are
+     * reserved atomically. Until the CPU alternatives are applied, only the
+     * BSP runs.
+     */
+    if(CPU_FEATURE_STATIC(CPU_FEATURE_RDTSCP))
+    {
+        timestamp = _cpu_rdtscp(&cpu_id);
+        if(cpu_id >= MAX_CPU_COUNT)
+        {
+            cpu_id = 0;
+        }
+    }
+    else
     {
-        cursor = TRACE_LIB_HEADER_LEN;
+        timestamp = _cpu_rdtsc();
+        cpu_id    = 0;
     }
 
-    /* Write the event */
-    trace_buffer[cursor++] = (uint32_t)event;
+    ring_state = &ring_states[cpu_id];
+    length     = TRACE_LIB_EVENT_HEADER_LEN + field_count * TRACE_LIB_FIELD_LEN;
 
-    /* Write the timestamp */
-    /* TODO: Add timestamp */
-    timestpamp = 420;
-    trace_buffer[cursor++] = (uint32_t)timestpamp;
-    trace_buffer[cursor++] = (uint32_t)(timestpamp >> 32);
+    /* Reserve the slot, switch packet if the end of the active one is reached
+     */
+    state = __atomic_load_n(&ring_state->state, __ATOMIC_RELAXED);
+    while(TRUE)
+    {
+        start = state & TRACE_STATE_OFFSET_MASK;
+        if(start + length <= packet_size)
+        {
+            if(__atomic_compare_exchange_n(&ring_state->state, &state,
+                                           state + length, TRUE,
+                                           __ATOMIC_ACQUIRE,
+                                           __ATOMIC_RELAXED) == TRUE)
+            {
+                break;
+            }
+        }
+        else if(_switch_packet(cpu_id, &state, length) == TRUE)
+        {
+            /* The state now holds the previous packet, flip the active bit */
+            state ^= TRACE_STATE_ACTIVE;
+            start  = TRACE_LIB_HEADER_LEN;
+            break;
+        }
+        else if(drain_mode == TRUE &&
+                (state & TRACE_STATE_OFFSET_MASK) + length > packet_size &&
+                (state & TRACE_STATE_FULL((state & TRACE_STATE_ACTIVE) != 0 ?
+                                          0 : 1)) != 0)
+        {
+            /* Both packets are full, drop the event */
+            __atomic_add_fetch(&ring_state->discarded, 1, __ATOMIC_RELAXED);
+            return;
+        }
+    }
 
-    /* Write all metadata */
+    packet = (state & TRACE_STATE_ACTIVE) != 0 ? 1 : 0;
+    header = _get_packet(cpu_id, packet);
+    slot   = (uint32_t*)header + start;
+
+    /* Write the event, the timestamp and the metadata */
+    slot[0] = (uint32_t)event;
+    slot[1] = (uint32_t)timestamp;
+    slot[2] = (uint32_t)(timestamp >> 32);
     for(i = 0; i < field_count; ++i)
     {
-        trace_buffer[cursor++] = __builtin_va_arg(args, uint32_t);
+        slot[TRACE_LIB_EVENT_HEADER_LEN + i * TRACE_LIB_FIELD_LEN] =
+            (uint32_t)fields[i];
+        slot[TRACE_LIB_EVENT_HEADER_LEN + i * TRACE_LIB_FIELD_LEN + 1] =
+            (uint32_t)(fields[i] >> 32);
+    }
+
+    /* Keep the header usable when the buffer is dumped from memory */
+    _set_packet_end(header, start + length);
+    _update_packet_time(header, start == TRACE_LIB_HEADER_LEN, timestamp);
+
+    /* Commit the event, the drain sends the packet once all its events are
+     * committed.
+     */
+    __atomic_add_fetch(&ring_state->events[packet], 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&ring_state->committed[packet], length,
+                       __ATOMIC_RELEASE);
+}
+
+void kernel_trace_set_drain_mode(const bool_t enabled)
+{
+    drain_mode = enabled;
+}
+
+bool_t kernel_trace_get_packet(const uint32_t cpu_id,
+                               const bool_t flush,
+                               const uint32_t** packet,
+                               uint32_t* size)
+{
+    trace_ring_state_t* ring_state;
+    uint32_t            state;
+    uint32_t            other;
+    uint32_t            content_end;
+
+    if(enabled == FALSE || drain_mode == FALSE || cpu_id >= MAX_CPU_COUNT ||
+       packet == NULL || size == NULL)
+    {
+        return FALSE;
+    }
+
+    ring_state = &ring_states[cpu_id];
+    state      = __atomic_load_n(&ring_state->state, __ATOMIC_ACQUIRE);
+    other      = (state & TRACE_STATE_ACTIVE) != 0 ? 0 : 1;
+
+    /* Close the active packet if it is partially filled */
+    if((state & TRACE_STATE_FULL(other)) == 0)
+    {
+        if(flush == FALSE ||
+           (state & TRACE_STATE_OFFSET_MASK) == TRACE_LIB_HEADER_LEN ||
+           _switch_packet(cpu_id, &state, 0) == FALSE)
+        {
+            return FALSE;
+        }
+        other = 1 - other;
     }
 
-    __builtin_va_end(args);
+    /* The packet is ready once all its events are committed */
+    content_end = __atomic_load_n(&ring_state->content_end[other],
+                                  __ATOMIC_ACQUIRE);
+    if(content_end == 0 ||
+       __atomic_load_n(&ring_state->committed[other], __ATOMIC_ACQUIRE) !=
+       content_end - TRACE_LIB_HEADER_LEN)
+    {
+        return FALSE;
+    }
+
+    /* A late writer of the packet may have moved the cursor backward */
+    _set_packet_end(_get_packet(cpu_id, other), content_end);
+
+    *packet = (const uint32_t*)_get_packet(cpu_id, other);
+    *size   = content_end * sizeof(uint32_t);
+
+    return TRUE;
+}
+
+void kernel_trace_release_packet(const uint32_t cpu_id)
+{
+    trace_ring_state_t* ring_state;
+    uint32_t            state;
+    uint32_t            other;
+
+    if(enabled == FALSE || cpu_id >= MAX_CPU_COUNT)
+    {
+        return;
+    }
+
+    ring_state = &ring_states[cpu_id];
+    state      = __atomic_load_n(&ring_state->state, __ATOMIC_ACQUIRE);
+    other      = (state & TRACE_STATE_ACTIVE) != 0 ? 0 : 1;
+
+    /* The full packet cannot become active before its full flag is cleared */
+    __atomic_store_n(&ring_state->committed[other], 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring_state->content_end[other], 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring_state->events[other], 0, __ATOMIC_RELAXED);
+    __atomic_and_fetch(&ring_state->state, ~TRACE_STATE_FULL(other),
+                       __ATOMIC_RELEASE);
+}
+
+uint32_t kernel_trace_copy_active_packet(const uint32_t cpu_id,
+                                         uint32_t* buffer,
+                                         const uint32_t size)
+{
+    trace_packet_header_t* copy;
+    uint32_t               state;
+    uint32_t               end;
+
+    if(enabled == FALSE || cpu_id >= MAX_CPU_COUNT || buffer == NULL)
+    {
+        return 0;
+    }
+
+    state = __atomic_load_n(&ring_states[cpu_id].state, __ATOMIC_ACQUIRE);
+    end   = state & TRACE_STATE_OFFSET_MASK;
+    if(end * sizeof(uint32_t) > size)
+    {
+        return 0;
+    }
+
+    memcpy(buffer,
+           _get_packet(cpu_id, (state & TRACE_STATE_ACTIVE) != 0 ? 1 : 0),
+           end * sizeof(uint32_t));
+
+    /* The copy only holds the packet content */
+    copy = (trace_packet_header_t*)buffer;
+    _set_packet_end(copy, end);
+    copy->packet_size = copy->content_size;
+
+    return end * sizeof(uint32_t);
+}
+
+void kernel_trace_set_event(const TRACE_EVENT_E event, const bool_t enabled)
+{
+    if((uint32_t)event >= TRACE_EVENT_COUNT)
+    {
+        return;
+    }
+
+    if(enabled == TRUE)
+    {
+        __atomic_and_fetch(&kernel_trace_disabled_events[event / 32],
+                           ~(1U << (event % 32)), __ATOMIC_RELAXED);
+    }
+    else
+    {
+        __atomic_or_fetch(&kernel_trace_disabled_events[event / 32],
+                          1U << (event % 32), __ATOMIC_RELAXED);
+    }
+}
+
+void kernel_trace_set_group(const TRACE_GROUP_E group, const bool_t enabled)
+{
+    uint32_t i;
+
+    if((uint32_t)group >= TRACE_GROUP_COUNT)
+    {
+        return;
+    }
+
+    /* Event 0 is not used */
+    for(i = 1; i < TRACE_EVENT_COUNT; ++i)
+    {
+        if(event_groups[i] == group)
+        {
+            kernel_trace_set_event((TRACE_EVENT_E)i, enabled);
+        }
+    }
 }
 
 #endif /* #ifdef _TRACING_ENABLED */
@@ -32,13 +32,15 @@
  * CONSTANTS
  ******************************************************************************/
 
-/* None */
+/** @brief Maximal number of timed iterations of a benchmark. */
+#define TEST_FRAMEWORK_BENCH_MAX_ITERATIONS 1024
 
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
 
-/* None */
+/** @brief Benchmark routine, one call is one timed iteration. */
+typedef void (*test_bench_routine_t)(void* args);
 
 /*******************************************************************************
  * MACROS
@@ -128,6 +130,17 @@
     }                                                                       \
 }
 
+#define TEST_POINT_BENCH(NAME, ROUTINE, ARGS, WARMUP, ITERATIONS,        \
+                         TEST_ENABLED) {                                    \
+    if(TEST_ENABLED)                                                        \
+    {                                                                       \
+        test_framework_bench_register(NAME, ROUTINE, ARGS, WARMUP,          \
+                                      ITERATIONS);                          \
+    }                                                                       \
+}
+
+#define TEST_FRAMEWORK_RUN_BENCH() test_framework_bench_run();
+
 #define TEST_FRAMEWORK_START() test_framework_init();
 
 #define TEST_FRAMEWORK_END() test_framework_end();
@@ -207,6 +220,36 @@ void test_framework_assert_errcode(const uint32_t test_id,
                                    const OS_RETURN_E expected,
                                    const OS_RETURN_E value);
 
+/**
+ * @brief Registers a benchmark.
+ *
+ * @details Registers a named benchmark run by test_framework_bench_run. The
+ * routine is called warmup times, then iterations times, each call being
+ * timed with the serialized time stamp counter. The iterations count is
+ * limited to TEST_FRAMEWORK_BENCH_MAX_ITERATIONS.
+ *
+ * @param[in] name The benchmark name, reported in the results.
+ * @param[in] routine The benchmark routine.
+ * @param[in] args The routine argument.
+ * @param[in] warmup The number of untimed calls before the measure.
+ * @param[in] iterations The number of timed calls.
+ */
+void test_framework_bench_register(const char* name,
+                                   test_bench_routine_t routine,
+                                   void* args,
+                                   const uint32_t warmup,
+                                   const uint32_t iterations);
+
+/**
+ * @brief Runs the registered benchmarks.
+ *
+ * @details Runs the registered benchmarks in their registration order, with
+ * interrupts disabled. The minimum, median, 99th percentile and maximum
+ * cycles of each benchmark are output once it is measured, the time stamp
+ * counter reading overhead is removed from the samples.
+ */
+void test_framework_bench_run(void);
+
 #else /* #ifdef _TESTING_FRAMEWORK_ENABLED */
 
 /*******************************************************************************
@@ -255,6 +298,11 @@ void test_framework_assert_errcode(const uint32_t test_id,
 
 #define TEST_POINT_FUNCTION_CALL(FUNCTION_NAME, TEST_ENABLED)
 
+#define TEST_POINT_BENCH(NAME, ROUTINE, ARGS, WARMUP, ITERATIONS,        \
+                         TEST_ENABLED)
+
+#define TEST_FRAMEWORK_RUN_BENCH()
+
 #define TEST_FRAMEWORK_START()
 
 /*******************************************************************************
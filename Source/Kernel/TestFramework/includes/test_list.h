@@ -36,6 +36,25 @@
 #define TEST_INTERRUPT_ENABLED                    1
 #define TEST_PANIC_ENABLED                        0
 #define TEST_KICKSTART_ENABLED                    0
+#define TEST_SCHEDULER_ENABLED                    0
+#define TEST_SMP_ENABLED                          0
+#define TEST_LIBC_ENABLED                         0
+#define TEST_KHEAP_ENABLED                        0
+#define TEST_KPOOL_ENABLED                        0
+#define TEST_MEMMGT_ENABLED                       0
+#define TEST_VMM_ENABLED                          0
+#define TEST_LOCK_ENABLED                         0
+#define TEST_SYSCALL_ENABLED                      0
+#define TEST_BENCHMARK_ENABLED                    0
+#define TEST_INTERRUPT_BENCH_ENABLED              0
+#define TEST_USTAR_ENABLED                        0
+#define TEST_BCACHE_ENABLED                       0
+#define TEST_IDT_ENABLED                          0
+#define TEST_QUEUE_ENABLED                        0
+#define TEST_KSTACK_ENABLED                       0
+#define TEST_KBUF_ENABLED                         0
+#define TEST_IORING_ENABLED                       0
+#define TEST_ELF_ENABLED                          0
 
 /*************************************************
  * TEST IDENTIFIERS
@@ -75,6 +94,703 @@
     (TEST_INTERRUPT_SW_REM0_SWINT_HANDLER(MAX_INTERRUPT_LINE) + IDVAL)
 #define TEST_INTERRUPT_SW_REM1_SWINT_HANDLER(IDVAL)     \
     (TEST_INTERRUPT_SW_REG1_SWINT_HANDLER(MAX_INTERRUPT_LINE) + IDVAL)
+#define TEST_INTERRUPT_FAST_REG_BAD_HANDLER0_ID         \
+    (TEST_INTERRUPT_SW_REM1_SWINT_HANDLER(MAX_INTERRUPT_LINE) + 1)
+#define TEST_INTERRUPT_FAST_REG_BAD_HANDLER1_ID         \
+    (TEST_INTERRUPT_FAST_REG_BAD_HANDLER0_ID + 1)
+#define TEST_INTERRUPT_FAST_REG_HANDLER0_ID             \
+    (TEST_INTERRUPT_FAST_REG_BAD_HANDLER1_ID + 1)
+#define TEST_INTERRUPT_FAST_COUNTER_CHECK0_ID           \
+    (TEST_INTERRUPT_FAST_REG_HANDLER0_ID + 1)
+#define TEST_INTERRUPT_FAST_COUNTER_CHECK1_ID           \
+    (TEST_INTERRUPT_FAST_COUNTER_CHECK0_ID + 1)
+#define TEST_INTERRUPT_FAST_REM_HANDLER0_ID             \
+    (TEST_INTERRUPT_FAST_COUNTER_CHECK1_ID + 1)
+#define TEST_INTERRUPT_STATS_BAD_PARAM0_ID              \
+    (TEST_INTERRUPT_FAST_REM_HANDLER0_ID + 1)
+#define TEST_INTERRUPT_STATS_BAD_PARAM1_ID              \
+    (TEST_INTERRUPT_STATS_BAD_PARAM0_ID + 1)
+#define TEST_INTERRUPT_STATS_BAD_PARAM2_ID              \
+    (TEST_INTERRUPT_STATS_BAD_PARAM1_ID + 1)
+#define TEST_INTERRUPT_STATS_REG_HANDLER0_ID            \
+    (TEST_INTERRUPT_STATS_BAD_PARAM2_ID + 1)
+#define TEST_INTERRUPT_STATS_GET0_ID                    \
+    (TEST_INTERRUPT_STATS_REG_HANDLER0_ID + 1)
+#define TEST_INTERRUPT_STATS_COUNT_CHECK0_ID            \
+    (TEST_INTERRUPT_STATS_GET0_ID + 1)
+#define TEST_INTERRUPT_STATS_HISTOGRAM_CHECK0_ID        \
+    (TEST_INTERRUPT_STATS_COUNT_CHECK0_ID + 1)
+#define TEST_INTERRUPT_STATS_RESET_CHECK0_ID            \
+    (TEST_INTERRUPT_STATS_HISTOGRAM_CHECK0_ID + 1)
+#define TEST_INTERRUPT_STATS_REM_HANDLER0_ID            \
+    (TEST_INTERRUPT_STATS_RESET_CHECK0_ID + 1)
+
+#define TEST_SCHED_CREATE_NULL0_ID                      \
+    (TEST_INTERRUPT_STATS_REM_HANDLER0_ID + 1)
+#define TEST_SCHED_CREATE_PRIO0_ID                      \
+    (TEST_SCHED_CREATE_NULL0_ID + 1)
+#define TEST_SCHED_ORDER_CREATE(IDVAL)                  \
+    (TEST_SCHED_CREATE_PRIO0_ID + 1 + IDVAL)
+#define TEST_SCHED_ORDER_COUNT0_ID                      \
+    (TEST_SCHED_ORDER_CREATE(2) + 1)
+#define TEST_SCHED_ORDER_CHECK(IDVAL)                   \
+    (TEST_SCHED_ORDER_COUNT0_ID + 1 + IDVAL)
+#define TEST_SCHED_RR_CREATE(IDVAL)                     \
+    (TEST_SCHED_ORDER_CHECK(2) + 1 + IDVAL)
+#define TEST_SCHED_RR_CHECK(IDVAL)                      \
+    (TEST_SCHED_RR_CREATE(1) + 1 + IDVAL)
+#define TEST_SCHED_REUSE0_ID                            \
+    (TEST_SCHED_RR_CHECK(3) + 1)
+#define TEST_SCHED_SLEEP0_ID                            \
+    (TEST_SCHED_REUSE0_ID + 1)
+#define TEST_SCHED_SLEEP_LATENCY0_ID                    \
+    (TEST_SCHED_SLEEP0_ID + 1)
+#define TEST_SCHED_SLEEP_CREATE(IDVAL)                  \
+    (TEST_SCHED_SLEEP_LATENCY0_ID + 1 + IDVAL)
+#define TEST_SCHED_SLEEP_ORDER(IDVAL)                   \
+    (TEST_SCHED_SLEEP_CREATE(2) + 1 + IDVAL)
+#define TEST_SCHED_HEAP_INSERT0_ID                      \
+    (TEST_SCHED_SLEEP_ORDER(2) + 1)
+#define TEST_SCHED_HEAP_INDEX0_ID                       \
+    (TEST_SCHED_HEAP_INSERT0_ID + 1)
+#define TEST_SCHED_HEAP_DOUBLE0_ID                      \
+    (TEST_SCHED_HEAP_INDEX0_ID + 1)
+#define TEST_SCHED_HEAP_REMOVE0_ID                      \
+    (TEST_SCHED_HEAP_DOUBLE0_ID + 1)
+#define TEST_SCHED_HEAP_INDEX1_ID                       \
+    (TEST_SCHED_HEAP_REMOVE0_ID + 1)
+#define TEST_SCHED_HEAP_REMOVE1_ID                      \
+    (TEST_SCHED_HEAP_INDEX1_ID + 1)
+#define TEST_SCHED_HEAP_PEEK0_ID                        \
+    (TEST_SCHED_HEAP_REMOVE1_ID + 1)
+#define TEST_SCHED_HEAP_POP(IDVAL)                      \
+    (TEST_SCHED_HEAP_PEEK0_ID + 1 + IDVAL)
+#define TEST_SCHED_HEAP_POP_NONE0_ID                    \
+    (TEST_SCHED_HEAP_POP(3) + 1)
+#define TEST_SCHED_HEAP_FULL0_ID                        \
+    (TEST_SCHED_HEAP_POP_NONE0_ID + 1)
+#define TEST_SCHED_DL_BOUND0_ID                         \
+    (TEST_SCHED_HEAP_FULL0_ID + 1)
+#define TEST_SCHED_DL_BUSY0_ID                          \
+    (TEST_SCHED_DL_BOUND0_ID + 1)
+#define TEST_SCHED_DL_CLEAR0_ID                         \
+    (TEST_SCHED_DL_BUSY0_ID + 1)
+#define TEST_SCHED_DL_CREATE0_ID                        \
+    (TEST_SCHED_DL_CLEAR0_ID + 1)
+#define TEST_SCHED_DL_ORDER(IDVAL)                      \
+    (TEST_SCHED_DL_CREATE0_ID + 1 + IDVAL)
+#define TEST_SCHED_DL_ERRORS0_ID                        \
+    (TEST_SCHED_DL_ORDER(2) + 1)
+#define TEST_SCHED_DL_BUDGET0_ID                        \
+    (TEST_SCHED_DL_ERRORS0_ID + 1)
+#define TEST_SCHED_DL_THROTTLE0_ID                      \
+    (TEST_SCHED_DL_BUDGET0_ID + 1)
+
+#define TEST_SMP_STARTED0_ID                            \
+    (TEST_SCHED_DL_THROTTLE0_ID + 1)
+#define TEST_SMP_CREATE(IDVAL)                          \
+    (TEST_SMP_STARTED0_ID + 1 + IDVAL)
+#define TEST_SMP_ARRIVED0_ID                            \
+    (TEST_SMP_CREATE(3) + 1)
+#define TEST_SMP_DISTINCT0_ID                           \
+    (TEST_SMP_ARRIVED0_ID + 1)
+
+#define TEST_LIBC_MEMCPY(IDVAL)                         \
+    (TEST_SMP_DISTINCT0_ID + 1 + IDVAL)
+#define TEST_LIBC_MEMMOVE_FWD(IDVAL)                    \
+    (TEST_LIBC_MEMCPY(17) + 1 + IDVAL)
+#define TEST_LIBC_MEMMOVE_BWD(IDVAL)                    \
+    (TEST_LIBC_MEMMOVE_FWD(17) + 1 + IDVAL)
+#define TEST_LIBC_MEMSET(IDVAL)                         \
+    (TEST_LIBC_MEMMOVE_BWD(17) + 1 + IDVAL)
+#define TEST_LIBC_STRLEN(IDVAL)                         \
+    (TEST_LIBC_MEMSET(17) + 1 + IDVAL)
+#define TEST_LIBC_STRCHR(IDVAL)                         \
+    (TEST_LIBC_STRLEN(7) + 1 + IDVAL)
+#define TEST_LIBC_MEMCHR(IDVAL)                         \
+    (TEST_LIBC_STRCHR(7) + 1 + IDVAL)
+#define TEST_LIBC_MEMCMP(IDVAL)                         \
+    (TEST_LIBC_MEMCHR(7) + 1 + IDVAL)
+#define TEST_LIBC_MEMMEM(IDVAL)                         \
+    (TEST_LIBC_MEMCMP(7) + 1 + IDVAL)
+#define TEST_LIBC_UDIVMOD(IDVAL)                        \
+    (TEST_LIBC_MEMMEM(11) + 1 + IDVAL)
+#define TEST_LIBC_DIV_CONST(IDVAL)                      \
+    (TEST_LIBC_UDIVMOD(19) + 1 + IDVAL)
+#define TEST_LIBC_DIV_100_INIT0_ID                      \
+    (TEST_LIBC_DIV_CONST(19) + 1)
+#define TEST_LIBC_DIV_100_CHECK0_ID                     \
+    (TEST_LIBC_DIV_100_INIT0_ID + 1)
+#define TEST_LIBC_UITOA_POW10(IDVAL)                    \
+    (TEST_LIBC_DIV_100_CHECK0_ID + 1 + IDVAL)
+#define TEST_LIBC_UITOA_LIMITS0_ID                      \
+    (TEST_LIBC_UITOA_POW10(19) + 1)
+#define TEST_LIBC_ITOA_POW10(IDVAL)                     \
+    (TEST_LIBC_UITOA_LIMITS0_ID + 1 + IDVAL)
+#define TEST_LIBC_ITOA_LIMITS0_ID                       \
+    (TEST_LIBC_ITOA_POW10(18) + 1)
+
+#define TEST_KHEAP_ALLOC_ZERO0_ID                       \
+    (TEST_LIBC_ITOA_LIMITS0_ID + 1)
+#define TEST_KHEAP_CLASS0_ID                            \
+    (TEST_KHEAP_ALLOC_ZERO0_ID + 1)
+#define TEST_KHEAP_CLASS1_ID                            \
+    (TEST_KHEAP_CLASS0_ID + 1)
+#define TEST_KHEAP_CLASS2_ID                            \
+    (TEST_KHEAP_CLASS1_ID + 1)
+#define TEST_KHEAP_CLASS3_ID                            \
+    (TEST_KHEAP_CLASS2_ID + 1)
+#define TEST_KHEAP_CLASS4_ID                            \
+    (TEST_KHEAP_CLASS3_ID + 1)
+#define TEST_KHEAP_CLASS5_ID                            \
+    (TEST_KHEAP_CLASS4_ID + 1)
+#define TEST_KHEAP_CLASS6_ID                            \
+    (TEST_KHEAP_CLASS5_ID + 1)
+#define TEST_KHEAP_CLASS7_ID                            \
+    (TEST_KHEAP_CLASS6_ID + 1)
+#define TEST_KHEAP_CLASS_COUNT0_ID                      \
+    (TEST_KHEAP_CLASS7_ID + 1)
+#define TEST_KHEAP_LARGE0_ID                            \
+    (TEST_KHEAP_CLASS_COUNT0_ID + 1)
+#define TEST_KHEAP_LARGE_WRITE0_ID                      \
+    (TEST_KHEAP_LARGE0_ID + 1)
+#define TEST_KHEAP_LARGE_TOO_BIG0_ID                    \
+    (TEST_KHEAP_LARGE_WRITE0_ID + 1)
+#define TEST_KHEAP_CROSS_ALLOC0_ID                      \
+    (TEST_KHEAP_LARGE_TOO_BIG0_ID + 1)
+#define TEST_KHEAP_CROSS_THREAD0_ID                     \
+    (TEST_KHEAP_CROSS_ALLOC0_ID + 1)
+#define TEST_KHEAP_CROSS_CPU0_ID                        \
+    (TEST_KHEAP_CROSS_THREAD0_ID + 1)
+#define TEST_KHEAP_CROSS_REUSE0_ID                      \
+    (TEST_KHEAP_CROSS_CPU0_ID + 1)
+#define TEST_KHEAP_CROSS_REALLOC0_ID                    \
+    (TEST_KHEAP_CROSS_REUSE0_ID + 1)
+
+#define TEST_KPOOL_INIT_NULL0_ID                        \
+    (TEST_KHEAP_CROSS_REALLOC0_ID + 1)
+#define TEST_KPOOL_INIT_UNALIGNED0_ID                   \
+    (TEST_KPOOL_INIT_NULL0_ID + 1)
+#define TEST_KPOOL_INIT_SMALL0_ID                       \
+    (TEST_KPOOL_INIT_UNALIGNED0_ID + 1)
+#define TEST_KPOOL_INIT_EMPTY0_ID                       \
+    (TEST_KPOOL_INIT_SMALL0_ID + 1)
+#define TEST_KPOOL_INIT0_ID                             \
+    (TEST_KPOOL_INIT_EMPTY0_ID + 1)
+#define TEST_KPOOL_ALLOC0_ID                            \
+    (TEST_KPOOL_INIT0_ID + 1)
+#define TEST_KPOOL_EXHAUSTED0_ID                        \
+    (TEST_KPOOL_ALLOC0_ID + 1)
+#define TEST_KPOOL_REUSE0_ID                            \
+    (TEST_KPOOL_EXHAUSTED0_ID + 1)
+#define TEST_KPOOL_EXHAUSTED1_ID                        \
+    (TEST_KPOOL_REUSE0_ID + 1)
+#define TEST_KPOOL_INIT1_ID                             \
+    (TEST_KPOOL_EXHAUSTED1_ID + 1)
+#define TEST_KPOOL_ALLOC1_ID                            \
+    (TEST_KPOOL_INIT1_ID + 1)
+#define TEST_KPOOL_EXHAUSTED2_ID                        \
+    (TEST_KPOOL_ALLOC1_ID + 1)
+#define TEST_KPOOL_REUSE1_ID                            \
+    (TEST_KPOOL_EXHAUSTED2_ID + 1)
+#define TEST_KPOOL_EXHAUSTED3_ID                        \
+    (TEST_KPOOL_REUSE1_ID + 1)
+#define TEST_KPOOL_CONTAINS0_ID                         \
+    (TEST_KPOOL_EXHAUSTED3_ID + 1)
+
+#define TEST_MEMMGT_ALLOC_NULL0_ID                      \
+    (TEST_KPOOL_CONTAINS0_ID + 1)
+#define TEST_MEMMGT_ALLOC_BAD_ORDER0_ID                 \
+    (TEST_MEMMGT_ALLOC_NULL0_ID + 1)
+#define TEST_MEMMGT_FREE_BAD_ORDER0_ID                  \
+    (TEST_MEMMGT_ALLOC_BAD_ORDER0_ID + 1)
+#define TEST_MEMMGT_ALLOC_MAX0_ID                       \
+    (TEST_MEMMGT_FREE_BAD_ORDER0_ID + 1)
+#define TEST_MEMMGT_ALLOC_MAX_ALIGN0_ID                 \
+    (TEST_MEMMGT_ALLOC_MAX0_ID + 1)
+#define TEST_MEMMGT_FREE_WRONG_ORDER0_ID                \
+    (TEST_MEMMGT_ALLOC_MAX_ALIGN0_ID + 1)
+#define TEST_MEMMGT_FREE_MAX0_ID                        \
+    (TEST_MEMMGT_FREE_WRONG_ORDER0_ID + 1)
+#define TEST_MEMMGT_DOUBLE_FREE0_ID                     \
+    (TEST_MEMMGT_FREE_MAX0_ID + 1)
+#define TEST_MEMMGT_EXHAUST0_ID                         \
+    (TEST_MEMMGT_DOUBLE_FREE0_ID + 1)
+#define TEST_MEMMGT_SPLIT0_ID                           \
+    (TEST_MEMMGT_EXHAUST0_ID + 1)
+#define TEST_MEMMGT_SPLIT_BUDDY0_ID                     \
+    (TEST_MEMMGT_SPLIT0_ID + 1)
+#define TEST_MEMMGT_FREE_LOWER0_ID                      \
+    (TEST_MEMMGT_SPLIT_BUDDY0_ID + 1)
+#define TEST_MEMMGT_COALESCE0_ID                        \
+    (TEST_MEMMGT_FREE_LOWER0_ID + 1)
+#define TEST_MEMMGT_FREE_HELD0_ID                       \
+    (TEST_MEMMGT_COALESCE0_ID + 1)
+#define TEST_MEMMGT_FREE_FRAMES0_ID                     \
+    (TEST_MEMMGT_FREE_HELD0_ID + 1)
+
+#define TEST_VMM_SPACE_CREATE0_ID                       \
+    (TEST_MEMMGT_FREE_FRAMES0_ID + 1)
+#define TEST_VMM_MAP_UNALIGNED0_ID                      \
+    (TEST_VMM_SPACE_CREATE0_ID + 1)
+#define TEST_VMM_MAP_KERNEL0_ID                         \
+    (TEST_VMM_MAP_UNALIGNED0_ID + 1)
+#define TEST_VMM_GET_MAPPING_NULL0_ID                   \
+    (TEST_VMM_MAP_KERNEL0_ID + 1)
+#define TEST_VMM_MAP0_ID                                \
+    (TEST_VMM_GET_MAPPING_NULL0_ID + 1)
+#define TEST_VMM_MAP_CHECK0_ID                          \
+    (TEST_VMM_MAP0_ID + 1)
+#define TEST_VMM_MAP_EXISTS0_ID                         \
+    (TEST_VMM_MAP_CHECK0_ID + 1)
+#define TEST_VMM_PROTECT0_ID                            \
+    (TEST_VMM_MAP_EXISTS0_ID + 1)
+#define TEST_VMM_PROTECT_CHECK0_ID                      \
+    (TEST_VMM_PROTECT0_ID + 1)
+#define TEST_VMM_PROTECT_CHECK1_ID                      \
+    (TEST_VMM_PROTECT_CHECK0_ID + 1)
+#define TEST_VMM_PROTECT_CHECK2_ID                      \
+    (TEST_VMM_PROTECT_CHECK1_ID + 1)
+#define TEST_VMM_PROTECT_CHECK3_ID                      \
+    (TEST_VMM_PROTECT_CHECK2_ID + 1)
+#define TEST_VMM_UNMAP0_ID                              \
+    (TEST_VMM_PROTECT_CHECK3_ID + 1)
+#define TEST_VMM_UNMAP_CHECK0_ID                        \
+    (TEST_VMM_UNMAP0_ID + 1)
+#define TEST_VMM_UNMAP_CHECK1_ID                        \
+    (TEST_VMM_UNMAP_CHECK0_ID + 1)
+#define TEST_VMM_UNMAP_CHECK2_ID                        \
+    (TEST_VMM_UNMAP_CHECK1_ID + 1)
+#define TEST_VMM_UNMAP1_ID                              \
+    (TEST_VMM_UNMAP_CHECK2_ID + 1)
+#define TEST_VMM_UNMAP_CHECK3_ID                        \
+    (TEST_VMM_UNMAP1_ID + 1)
+#define TEST_VMM_SPACE_DESTROY0_ID                      \
+    (TEST_VMM_UNMAP_CHECK3_ID + 1)
+#define TEST_VMM_COW_ALLOC0_ID                          \
+    (TEST_VMM_SPACE_DESTROY0_ID + 1)
+#define TEST_VMM_COW_CLONE0_ID                          \
+    (TEST_VMM_COW_ALLOC0_ID + 1)
+#define TEST_VMM_COW_CLONE_CHECK0_ID                    \
+    (TEST_VMM_COW_CLONE0_ID + 1)
+#define TEST_VMM_COW_CLONE_CHECK1_ID                    \
+    (TEST_VMM_COW_CLONE_CHECK0_ID + 1)
+#define TEST_VMM_COW_SHARED0_ID                         \
+    (TEST_VMM_COW_CLONE_CHECK1_ID + 1)
+#define TEST_VMM_COW_GET_FRAME0_ID                      \
+    (TEST_VMM_COW_SHARED0_ID + 1)
+#define TEST_VMM_COW_RESOLVE0_ID                        \
+    (TEST_VMM_COW_GET_FRAME0_ID + 1)
+#define TEST_VMM_COW_RESOLVE_CHECK0_ID                  \
+    (TEST_VMM_COW_RESOLVE0_ID + 1)
+#define TEST_VMM_COW_RESOLVE_CHECK1_ID                  \
+    (TEST_VMM_COW_RESOLVE_CHECK0_ID + 1)
+#define TEST_VMM_COW_COPY_CHECK0_ID                     \
+    (TEST_VMM_COW_RESOLVE_CHECK1_ID + 1)
+#define TEST_VMM_COW_RESOLVE1_ID                        \
+    (TEST_VMM_COW_COPY_CHECK0_ID + 1)
+#define TEST_VMM_COW_RESOLVE_CHECK2_ID                  \
+    (TEST_VMM_COW_RESOLVE1_ID + 1)
+#define TEST_VMM_COW_OWN_FRAMES0_ID                     \
+    (TEST_VMM_COW_RESOLVE_CHECK2_ID + 1)
+#define TEST_VMM_COW_RESOLVED0_ID                       \
+    (TEST_VMM_COW_OWN_FRAMES0_ID + 1)
+
+#define TEST_LOCK_TICKET0_ID                            \
+    (TEST_VMM_COW_RESOLVED0_ID + 1)
+#define TEST_LOCK_TICKET1_ID                            \
+    (TEST_LOCK_TICKET0_ID + 1)
+#define TEST_LOCK_MCS0_ID                               \
+    (TEST_LOCK_TICKET1_ID + 1)
+#define TEST_LOCK_MCS1_ID                               \
+    (TEST_LOCK_MCS0_ID + 1)
+#define TEST_LOCK_NESTED0_ID                            \
+    (TEST_LOCK_MCS1_ID + 1)
+#define TEST_LOCK_NESTED1_ID                            \
+    (TEST_LOCK_NESTED0_ID + 1)
+#define TEST_LOCK_NESTED2_ID                            \
+    (TEST_LOCK_NESTED1_ID + 1)
+#define TEST_LOCK_CRITICAL0_ID                          \
+    (TEST_LOCK_NESTED2_ID + 1)
+#define TEST_LOCK_CRITICAL1_ID                          \
+    (TEST_LOCK_CRITICAL0_ID + 1)
+#define TEST_LOCK_CRITICAL2_ID                          \
+    (TEST_LOCK_CRITICAL1_ID + 1)
+#define TEST_LOCK_TICKET_CONTENTION0_ID                 \
+    (TEST_LOCK_CRITICAL2_ID + 1)
+#define TEST_LOCK_MCS_CONTENTION0_ID                    \
+    (TEST_LOCK_TICKET_CONTENTION0_ID + 1)
+#define TEST_LOCK_SEQLOCK0_ID                           \
+    (TEST_LOCK_MCS_CONTENTION0_ID + 1)
+#define TEST_LOCK_SEQLOCK1_ID                           \
+    (TEST_LOCK_SEQLOCK0_ID + 1)
+#define TEST_LOCK_SEQLOCK2_ID                           \
+    (TEST_LOCK_SEQLOCK1_ID + 1)
+#define TEST_LOCK_RWLOCK0_ID                            \
+    (TEST_LOCK_SEQLOCK2_ID + 1)
+#define TEST_LOCK_RWLOCK1_ID                            \
+    (TEST_LOCK_RWLOCK0_ID + 1)
+#define TEST_LOCK_RWLOCK2_ID                            \
+    (TEST_LOCK_RWLOCK1_ID + 1)
+#define TEST_LOCK_RWLOCK3_ID                            \
+    (TEST_LOCK_RWLOCK2_ID + 1)
+#define TEST_LOCK_SEQLOCK_CONTENTION0_ID                \
+    (TEST_LOCK_RWLOCK3_ID + 1)
+#define TEST_LOCK_RWLOCK_CONTENTION0_ID                 \
+    (TEST_LOCK_SEQLOCK_CONTENTION0_ID + 1)
+#define TEST_LOCK_MUTEX_INIT0_ID                        \
+    (TEST_LOCK_RWLOCK_CONTENTION0_ID + 1)
+#define TEST_LOCK_MUTEX_INIT1_ID                        \
+    (TEST_LOCK_MUTEX_INIT0_ID + 1)
+#define TEST_LOCK_MUTEX_INIT2_ID                        \
+    (TEST_LOCK_MUTEX_INIT1_ID + 1)
+#define TEST_LOCK_MUTEX_LOCK0_ID                        \
+    (TEST_LOCK_MUTEX_INIT2_ID + 1)
+#define TEST_LOCK_MUTEX_TRYLOCK0_ID                     \
+    (TEST_LOCK_MUTEX_LOCK0_ID + 1)
+#define TEST_LOCK_MUTEX_RELOCK0_ID                      \
+    (TEST_LOCK_MUTEX_TRYLOCK0_ID + 1)
+#define TEST_LOCK_MUTEX_NESTED0_ID                      \
+    (TEST_LOCK_MUTEX_RELOCK0_ID + 1)
+#define TEST_LOCK_MUTEX_UNLOCK0_ID                      \
+    (TEST_LOCK_MUTEX_NESTED0_ID + 1)
+#define TEST_LOCK_MUTEX_UNLOCK1_ID                      \
+    (TEST_LOCK_MUTEX_UNLOCK0_ID + 1)
+#define TEST_LOCK_SEMAPHORE_INIT0_ID                    \
+    (TEST_LOCK_MUTEX_UNLOCK1_ID + 1)
+#define TEST_LOCK_SEMAPHORE_OVERFLOW0_ID                \
+    (TEST_LOCK_SEMAPHORE_INIT0_ID + 1)
+#define TEST_LOCK_SEMAPHORE_TAKE0_ID                    \
+    (TEST_LOCK_SEMAPHORE_OVERFLOW0_ID + 1)
+#define TEST_LOCK_SEMAPHORE_EMPTY0_ID                   \
+    (TEST_LOCK_SEMAPHORE_TAKE0_ID + 1)
+#define TEST_LOCK_SEMAPHORE_POST0_ID                    \
+    (TEST_LOCK_SEMAPHORE_EMPTY0_ID + 1)
+#define TEST_LOCK_SEMAPHORE_POST1_ID                    \
+    (TEST_LOCK_SEMAPHORE_POST0_ID + 1)
+#define TEST_LOCK_MUTEX_CONTENTION0_ID                  \
+    (TEST_LOCK_SEMAPHORE_POST1_ID + 1)
+#define TEST_LOCK_SEMAPHORE_CONTENTION0_ID              \
+    (TEST_LOCK_MUTEX_CONTENTION0_ID + 1)
+
+#define TEST_SYSCALL_REGISTER_NULL0_ID                  \
+    (TEST_LOCK_SEMAPHORE_CONTENTION0_ID + 1)
+#define TEST_SYSCALL_REGISTER_RANGE0_ID                 \
+    (TEST_SYSCALL_REGISTER_NULL0_ID + 1)
+#define TEST_SYSCALL_REGISTER0_ID                       \
+    (TEST_SYSCALL_REGISTER_RANGE0_ID + 1)
+#define TEST_SYSCALL_REGISTER1_ID                       \
+    (TEST_SYSCALL_REGISTER0_ID + 1)
+#define TEST_SYSCALL_DISPATCH0_ID                       \
+    (TEST_SYSCALL_REGISTER1_ID + 1)
+#define TEST_SYSCALL_DISPATCH_RANGE0_ID                 \
+    (TEST_SYSCALL_DISPATCH0_ID + 1)
+#define TEST_SYSCALL_REMOVE0_ID                         \
+    (TEST_SYSCALL_DISPATCH_RANGE0_ID + 1)
+#define TEST_SYSCALL_REMOVE1_ID                         \
+    (TEST_SYSCALL_REMOVE0_ID + 1)
+#define TEST_SYSCALL_DISPATCH_REMOVED0_ID               \
+    (TEST_SYSCALL_REMOVE1_ID + 1)
+#define TEST_SYSCALL_USER_MAP0_ID                       \
+    (TEST_SYSCALL_DISPATCH_REMOVED0_ID + 1)
+#define TEST_SYSCALL_USER_THREAD0_ID                    \
+    (TEST_SYSCALL_USER_MAP0_ID + 1)
+#define TEST_SYSCALL_USER_CALL0_ID                      \
+    (TEST_SYSCALL_USER_THREAD0_ID + 1)
+#define TEST_SYSCALL_USER_ARGS0_ID                      \
+    (TEST_SYSCALL_USER_CALL0_ID + 1)
+#define TEST_SYSCALL_USER_ARGS1_ID                      \
+    (TEST_SYSCALL_USER_ARGS0_ID + 1)
+#define TEST_SYSCALL_USER_RETURN0_ID                    \
+    (TEST_SYSCALL_USER_ARGS1_ID + 1)
+#define TEST_SYSCALL_USER_STACK0_ID                     \
+    (TEST_SYSCALL_USER_RETURN0_ID + 1)
+#define TEST_SYSCALL_USER_UNMAP0_ID                     \
+    (TEST_SYSCALL_USER_STACK0_ID + 1)
+#define TEST_INTERRUPT_BENCH_REG_HANDLER0_ID            \
+    (TEST_SYSCALL_USER_UNMAP0_ID + 1)
+#define TEST_INTERRUPT_BENCH_REG_FAST_HANDLER0_ID       \
+    (TEST_INTERRUPT_BENCH_REG_HANDLER0_ID + 1)
+#define TEST_INTERRUPT_BENCH_GET_HANDLER0_ID            \
+    (TEST_INTERRUPT_BENCH_REG_FAST_HANDLER0_ID + 1)
+#define TEST_INTERRUPT_BENCH_COUNT_CHECK0_ID            \
+    (TEST_INTERRUPT_BENCH_GET_HANDLER0_ID + 1)
+#define TEST_INTERRUPT_BENCH_REM_HANDLER0_ID            \
+    (TEST_INTERRUPT_BENCH_COUNT_CHECK0_ID + 1)
+#define TEST_INTERRUPT_BENCH_REM_FAST_HANDLER0_ID       \
+    (TEST_INTERRUPT_BENCH_REM_HANDLER0_ID + 1)
+
+#define TEST_USTAR_LAZY_OPEN0_ID                        \
+    (TEST_INTERRUPT_BENCH_REM_FAST_HANDLER0_ID + 1)
+#define TEST_USTAR_INITRD0_ID                           \
+    (TEST_USTAR_LAZY_OPEN0_ID + 1)
+#define TEST_USTAR_MOUNT_NULL0_ID                       \
+    (TEST_USTAR_INITRD0_ID + 1)
+#define TEST_USTAR_MOUNT_AGAIN0_ID                      \
+    (TEST_USTAR_MOUNT_NULL0_ID + 1)
+#define TEST_USTAR_MOUNT_DRIVER0_ID                     \
+    (TEST_USTAR_MOUNT_AGAIN0_ID + 1)
+#define TEST_USTAR_MOUNT_CORRUPT0_ID                    \
+    (TEST_USTAR_MOUNT_DRIVER0_ID + 1)
+#define TEST_USTAR_MOUNT_INVALIDATE0_ID                 \
+    (TEST_USTAR_MOUNT_CORRUPT0_ID + 1)
+#define TEST_USTAR_OPEN_NULL0_ID                        \
+    (TEST_USTAR_MOUNT_INVALIDATE0_ID + 1)
+#define TEST_USTAR_OPEN_NULL1_ID                        \
+    (TEST_USTAR_OPEN_NULL0_ID + 1)
+#define TEST_USTAR_OPEN_FILE0_ID                        \
+    (TEST_USTAR_OPEN_NULL1_ID + 1)
+#define TEST_USTAR_FILE_DATA0_ID                        \
+    (TEST_USTAR_OPEN_FILE0_ID + 1)
+#define TEST_USTAR_OPEN_NESTED0_ID                      \
+    (TEST_USTAR_FILE_DATA0_ID + 1)
+#define TEST_USTAR_OPEN_EMPTY0_ID                       \
+    (TEST_USTAR_OPEN_NESTED0_ID + 1)
+#define TEST_USTAR_OPEN_FOLDER0_ID                      \
+    (TEST_USTAR_OPEN_EMPTY0_ID + 1)
+#define TEST_USTAR_OPEN_MISSING0_ID                     \
+    (TEST_USTAR_OPEN_FOLDER0_ID + 1)
+#define TEST_USTAR_READ_OPEN0_ID                        \
+    (TEST_USTAR_OPEN_MISSING0_ID + 1)
+#define TEST_USTAR_READ_NULL0_ID                        \
+    (TEST_USTAR_READ_OPEN0_ID + 1)
+#define TEST_USTAR_READ0_ID                             \
+    (TEST_USTAR_READ_NULL0_ID + 1)
+#define TEST_USTAR_READ_END0_ID                         \
+    (TEST_USTAR_READ0_ID + 1)
+#define TEST_USTAR_READ_PAST0_ID                        \
+    (TEST_USTAR_READ_END0_ID + 1)
+
+#define TEST_BCACHE_INIT0_ID                            \
+    (TEST_USTAR_READ_PAST0_ID + 1)
+#define TEST_BCACHE_GET_NULL0_ID                        \
+    (TEST_BCACHE_INIT0_ID + 1)
+#define TEST_BCACHE_GET_NULL1_ID                        \
+    (TEST_BCACHE_GET_NULL0_ID + 1)
+#define TEST_BCACHE_GET_BOUND0_ID                       \
+    (TEST_BCACHE_GET_NULL1_ID + 1)
+#define TEST_BCACHE_MISS0_ID                            \
+    (TEST_BCACHE_GET_BOUND0_ID + 1)
+#define TEST_BCACHE_MISS_DATA0_ID                       \
+    (TEST_BCACHE_MISS0_ID + 1)
+#define TEST_BCACHE_HIT0_ID                             \
+    (TEST_BCACHE_MISS_DATA0_ID + 1)
+#define TEST_BCACHE_READ_AHEAD0_ID                      \
+    (TEST_BCACHE_HIT0_ID + 1)
+#define TEST_BCACHE_READ_AHEAD_HIT0_ID                  \
+    (TEST_BCACHE_READ_AHEAD0_ID + 1)
+#define TEST_BCACHE_READ_AHEAD_DATA0_ID                 \
+    (TEST_BCACHE_READ_AHEAD_HIT0_ID + 1)
+#define TEST_BCACHE_ERROR0_ID                           \
+    (TEST_BCACHE_READ_AHEAD_DATA0_ID + 1)
+#define TEST_BCACHE_ERROR_RETRY0_ID                     \
+    (TEST_BCACHE_ERROR0_ID + 1)
+#define TEST_BCACHE_INVALIDATE_NULL0_ID                 \
+    (TEST_BCACHE_ERROR_RETRY0_ID + 1)
+#define TEST_BCACHE_INVALIDATE_HELD0_ID                 \
+    (TEST_BCACHE_INVALIDATE_NULL0_ID + 1)
+#define TEST_BCACHE_INVALIDATE0_ID                      \
+    (TEST_BCACHE_INVALIDATE_HELD0_ID + 1)
+#define TEST_BCACHE_INVALIDATE_MISS0_ID                 \
+    (TEST_BCACHE_INVALIDATE0_ID + 1)
+#define TEST_BCACHE_FILL0_ID                            \
+    (TEST_BCACHE_INVALIDATE_MISS0_ID + 1)
+#define TEST_BCACHE_FILL_RELEASED0_ID                   \
+    (TEST_BCACHE_FILL0_ID + 1)
+#define TEST_BCACHE_EVICT_HELD0_ID                      \
+    (TEST_BCACHE_FILL_RELEASED0_ID + 1)
+#define TEST_BCACHE_WAIT_INIT0_ID                       \
+    (TEST_BCACHE_EVICT_HELD0_ID + 1)
+#define TEST_BCACHE_WAIT_THREADS0_ID                    \
+    (TEST_BCACHE_WAIT_INIT0_ID + 1)
+#define TEST_BCACHE_WAIT_BLOCKED0_ID                    \
+    (TEST_BCACHE_WAIT_THREADS0_ID + 1)
+#define TEST_BCACHE_WAIT_LOADER0_ID                     \
+    (TEST_BCACHE_WAIT_BLOCKED0_ID + 1)
+#define TEST_BCACHE_WAIT_WAITER0_ID                     \
+    (TEST_BCACHE_WAIT_LOADER0_ID + 1)
+#define TEST_BCACHE_WAIT_READS0_ID                      \
+    (TEST_BCACHE_WAIT_WAITER0_ID + 1)
+#define TEST_BCACHE_END0_ID                             \
+    (TEST_BCACHE_WAIT_READS0_ID + 1)
+
+#define TEST_IDT_SIZE0_ID                               \
+    (TEST_BCACHE_END0_ID + 1)
+#define TEST_IDT_RODATA0_ID                             \
+    (TEST_IDT_SIZE0_ID + 1)
+#define TEST_IDT_STUBS_ALIGN0_ID                        \
+    (TEST_IDT_RODATA0_ID + 1)
+#define TEST_IDT_HANDLERS0_ID                           \
+    (TEST_IDT_STUBS_ALIGN0_ID + 1)
+#define TEST_IDT_FLAGS0_ID                              \
+    (TEST_IDT_HANDLERS0_ID + 1)
+#define TEST_IDT_STUBS0_ID                              \
+    (TEST_IDT_FLAGS0_ID + 1)
+#define TEST_IDT_IST0_ID                                \
+    (TEST_IDT_STUBS0_ID + 1)
+#define TEST_IDT_SYMBOL0_ID                             \
+    (TEST_IDT_IST0_ID + 1)
+#define TEST_IDT_SYMBOL1_ID                             \
+    (TEST_IDT_SYMBOL0_ID + 1)
+
+#define TEST_QUEUE_SPSC_INIT_NULL0_ID                   \
+    (TEST_IDT_SYMBOL1_ID + 1)
+#define TEST_QUEUE_SPSC_INIT_POW20_ID                   \
+    (TEST_QUEUE_SPSC_INIT_NULL0_ID + 1)
+#define TEST_QUEUE_MPMC_INIT_POW20_ID                   \
+    (TEST_QUEUE_SPSC_INIT_POW20_ID + 1)
+#define TEST_QUEUE_MPMC_INIT_ZERO0_ID                   \
+    (TEST_QUEUE_MPMC_INIT_POW20_ID + 1)
+#define TEST_QUEUE_MQUEUE_INIT_POW20_ID                 \
+    (TEST_QUEUE_MPMC_INIT_ZERO0_ID + 1)
+#define TEST_QUEUE_SPSC_INIT0_ID                        \
+    (TEST_QUEUE_MQUEUE_INIT_POW20_ID + 1)
+#define TEST_QUEUE_SPSC_CYCLE0_ID                       \
+    (TEST_QUEUE_SPSC_INIT0_ID + 1)
+#define TEST_QUEUE_SPSC_WRAP0_ID                        \
+    (TEST_QUEUE_SPSC_CYCLE0_ID + 1)
+#define TEST_QUEUE_MPMC_INIT0_ID                        \
+    (TEST_QUEUE_SPSC_WRAP0_ID + 1)
+#define TEST_QUEUE_MPMC_CYCLE0_ID                       \
+    (TEST_QUEUE_MPMC_INIT0_ID + 1)
+#define TEST_QUEUE_MPMC_WRAP0_ID                        \
+    (TEST_QUEUE_MPMC_CYCLE0_ID + 1)
+#define TEST_QUEUE_MQUEUE_INIT0_ID                      \
+    (TEST_QUEUE_MPMC_WRAP0_ID + 1)
+#define TEST_QUEUE_MQUEUE_EMPTY0_ID                     \
+    (TEST_QUEUE_MQUEUE_INIT0_ID + 1)
+#define TEST_QUEUE_MQUEUE_FULL0_ID                      \
+    (TEST_QUEUE_MQUEUE_EMPTY0_ID + 1)
+#define TEST_QUEUE_MQUEUE_DRAIN0_ID                     \
+    (TEST_QUEUE_MQUEUE_FULL0_ID + 1)
+#define TEST_QUEUE_MQUEUE_THREAD0_ID                    \
+    (TEST_QUEUE_MQUEUE_DRAIN0_ID + 1)
+#define TEST_QUEUE_MQUEUE_BLOCKING0_ID                  \
+    (TEST_QUEUE_MQUEUE_THREAD0_ID + 1)
+
+#define TEST_KSTACK_ALLOC_NULL0_ID                      \
+    (TEST_QUEUE_MQUEUE_BLOCKING0_ID + 1)
+#define TEST_KSTACK_ALLOC0_ID                           \
+    (TEST_KSTACK_ALLOC_NULL0_ID + 1)
+#define TEST_KSTACK_SIZE0_ID                            \
+    (TEST_KSTACK_ALLOC0_ID + 1)
+#define TEST_KSTACK_BOUNDS0_ID                          \
+    (TEST_KSTACK_SIZE0_ID + 1)
+#define TEST_KSTACK_GUARD0_ID                           \
+    (TEST_KSTACK_BOUNDS0_ID + 1)
+#define TEST_KSTACK_TOP0_ID                             \
+    (TEST_KSTACK_GUARD0_ID + 1)
+#define TEST_KSTACK_FREE0_ID                            \
+    (TEST_KSTACK_TOP0_ID + 1)
+#define TEST_KSTACK_FREE1_ID                            \
+    (TEST_KSTACK_FREE0_ID + 1)
+#define TEST_KSTACK_FREE2_ID                            \
+    (TEST_KSTACK_FREE1_ID + 1)
+#define TEST_KSTACK_FAULT_ALLOC0_ID                     \
+    (TEST_KSTACK_FREE2_ID + 1)
+#define TEST_KSTACK_FAULT_LAZY0_ID                      \
+    (TEST_KSTACK_FAULT_ALLOC0_ID + 1)
+#define TEST_KSTACK_FAULT_COMMIT0_ID                    \
+    (TEST_KSTACK_FAULT_LAZY0_ID + 1)
+#define TEST_KSTACK_FAULT_TOUCH0_ID                     \
+    (TEST_KSTACK_FAULT_COMMIT0_ID + 1)
+#define TEST_KSTACK_FAULT_GUARD0_ID                     \
+    (TEST_KSTACK_FAULT_TOUCH0_ID + 1)
+#define TEST_KSTACK_FAULT_OUT0_ID                       \
+    (TEST_KSTACK_FAULT_GUARD0_ID + 1)
+#define TEST_KSTACK_FAULT_FREED0_ID                     \
+    (TEST_KSTACK_FAULT_OUT0_ID + 1)
+#define TEST_KSTACK_OVERFLOW0_ID                        \
+    (TEST_KSTACK_FAULT_FREED0_ID + 1)
+
+#define TEST_KBUF_PUT0_ID                               \
+    (TEST_KSTACK_OVERFLOW0_ID + 1)
+#define TEST_KBUF_PUSH0_ID                              \
+    (TEST_KBUF_PUT0_ID + 1)
+#define TEST_KBUF_BOUNDS0_ID                            \
+    (TEST_KBUF_PUSH0_ID + 1)
+#define TEST_KBUF_SLICE0_ID                             \
+    (TEST_KBUF_BOUNDS0_ID + 1)
+#define TEST_KBUF_SHARED_PUT0_ID                        \
+    (TEST_KBUF_SLICE0_ID + 1)
+#define TEST_KBUF_SHARED_PUSH0_ID                       \
+    (TEST_KBUF_SHARED_PUT0_ID + 1)
+#define TEST_KBUF_SLICE_BOUNDS0_ID                      \
+    (TEST_KBUF_SHARED_PUSH0_ID + 1)
+#define TEST_KBUF_EXCLUSIVE0_ID                         \
+    (TEST_KBUF_SLICE_BOUNDS0_ID + 1)
+#define TEST_KBUF_APPEND0_ID                            \
+    (TEST_KBUF_EXCLUSIVE0_ID + 1)
+#define TEST_KBUF_SEGMENTS0_ID                          \
+    (TEST_KBUF_APPEND0_ID + 1)
+#define TEST_KBUF_ATTACHED_PUT0_ID                      \
+    (TEST_KBUF_SEGMENTS0_ID + 1)
+#define TEST_KBUF_SLICE_CHAIN0_ID                       \
+    (TEST_KBUF_ATTACHED_PUT0_ID + 1)
+#define TEST_KBUF_RELEASE0_ID                           \
+    (TEST_KBUF_SLICE_CHAIN0_ID + 1)
+#define TEST_KBUF_RELEASE1_ID                           \
+    (TEST_KBUF_RELEASE0_ID + 1)
+
+#define TEST_IORING_INIT_NULL0_ID                       \
+    (TEST_KBUF_RELEASE1_ID + 1)
+#define TEST_IORING_INIT_NOT_POW20_ID                   \
+    (TEST_IORING_INIT_NULL0_ID + 1)
+#define TEST_IORING_INIT_TOO_BIG0_ID                    \
+    (TEST_IORING_INIT_NOT_POW20_ID + 1)
+#define TEST_IORING_INIT_EMPTY0_ID                      \
+    (TEST_IORING_INIT_TOO_BIG0_ID + 1)
+#define TEST_IORING_INIT0_ID                            \
+    (TEST_IORING_INIT_EMPTY0_ID + 1)
+#define TEST_IORING_NOP_SUBMIT0_ID                      \
+    (TEST_IORING_INIT0_ID + 1)
+#define TEST_IORING_NOP_CQE0_ID                         \
+    (TEST_IORING_NOP_SUBMIT0_ID + 1)
+#define TEST_IORING_WAIT_IDLE0_ID                       \
+    (TEST_IORING_NOP_CQE0_ID + 1)
+#define TEST_IORING_SYNC_READ0_ID                       \
+    (TEST_IORING_WAIT_IDLE0_ID + 1)
+#define TEST_IORING_SYNC_REFUSED0_ID                    \
+    (TEST_IORING_SYNC_READ0_ID + 1)
+#define TEST_IORING_SYNC_NO_TARGET0_ID                  \
+    (TEST_IORING_SYNC_REFUSED0_ID + 1)
+#define TEST_IORING_DEFERRED_THREAD0_ID                 \
+    (TEST_IORING_SYNC_NO_TARGET0_ID + 1)
+#define TEST_IORING_DEFERRED_CQE0_ID                    \
+    (TEST_IORING_DEFERRED_THREAD0_ID + 1)
+#define TEST_IORING_DESTROY_BUSY0_ID                    \
+    (TEST_IORING_DEFERRED_CQE0_ID + 1)
+#define TEST_IORING_DESTROY0_ID                         \
+    (TEST_IORING_DESTROY_BUSY0_ID + 1)
+#define TEST_IORING_POLL_INIT0_ID                       \
+    (TEST_IORING_DESTROY0_ID + 1)
+#define TEST_IORING_POLL_CQE0_ID                        \
+    (TEST_IORING_POLL_INIT0_ID + 1)
+#define TEST_IORING_POLL_DESTROY0_ID                    \
+    (TEST_IORING_POLL_CQE0_ID + 1)
+
+#define TEST_ELF_MOUNT0_ID                              \
+    (TEST_IORING_POLL_DESTROY0_ID + 1)
+#define TEST_ELF_LOAD0_ID                               \
+    (TEST_ELF_MOUNT0_ID + 1)
+#define TEST_ELF_FAULT0_ID                              \
+    (TEST_ELF_LOAD0_ID + 1)
+#define TEST_ELF_CLONE0_ID                              \
+    (TEST_ELF_FAULT0_ID + 1)
+#define TEST_ELF_SHARED0_ID                             \
+    (TEST_ELF_CLONE0_ID + 1)
+#define TEST_ELF_COW0_ID                                \
+    (TEST_ELF_SHARED0_ID + 1)
+#define TEST_ELF_COW1_ID                                \
+    (TEST_ELF_COW0_ID + 1)
+#define TEST_ELF_PARENT0_ID                             \
+    (TEST_ELF_COW1_ID + 1)
+#define TEST_ELF_DESTROY0_ID                            \
+    (TEST_ELF_PARENT0_ID + 1)
+#define TEST_ELF_DESTROY1_ID                            \
+    (TEST_ELF_DESTROY0_ID + 1)
+#define TEST_ELF_UNMOUNT0_ID                            \
+    (TEST_ELF_DESTROY1_ID + 1)
 
 /** @brief Current test name */
 #define TEST_FRAMEWORK_TEST_NAME "Interrupt Suite"
@@ -109,6 +825,25 @@
  ******************************************************************************/
 
 void interrupt_test(void);
+void scheduler_test(void);
+void smp_test(void);
+void libc_test(void);
+void kheap_test(void);
+void kpool_test(void);
+void memmgt_test(void);
+void vmm_test(void);
+void lock_test(void);
+void syscall_test(void);
+void bench_test(void);
+void interrupt_bench_test(void);
+void ustar_test(void);
+void bcache_test(void);
+void idt_test(void);
+void queue_test(void);
+void kstack_test(void);
+void kbuf_test(void);
+void ioring_test(void);
+void elf_test(void);
 
 #endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
 
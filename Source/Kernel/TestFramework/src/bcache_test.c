@@ -0,0 +1,657 @@
+/*******************************************************************************
+ * @file bcache_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework block cache testing.
+ *
+ * @details Testing framework block cache testing. Uses a test block device
+ * that is not memory backed and counts its reads: checks the misses and hits,
+ * the read ahead of the sequential misses, the read errors, the invalidation,
+ * the CLOCK eviction of the unused blocks and the users waiting for a block
+ * that is being read.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <string.h>
+#include <blkdev.h>
+#include <bcache.h>
+#include <semaphore.h>
+#include <scheduler.h>
+#include <ctrl_block.h>
+#include <initcall.h>
+#include <vfs.h>
+#include <cpu_interrupt.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of blocks of the test device. */
+#define TEST_BCACHE_DEV_BLOCKS 1024
+
+/** @brief Block of the miss and hit tests. */
+#define TEST_BCACHE_MISS_BLOCK 10
+
+/** @brief Block of the read error tests. */
+#define TEST_BCACHE_ERROR_BLOCK 40
+
+/** @brief First block of the eviction tests, accessed with a stride of 2. */
+#define TEST_BCACHE_FILL_BLOCK 100
+
+/** @brief Block kept while the other blocks are evicted. */
+#define TEST_BCACHE_HELD_BLOCK 900
+
+/** @brief Block whose read waits for the test. */
+#define TEST_BCACHE_GATED_BLOCK 1000
+
+/** @brief Number of checks of the waiting thread state. */
+#define TEST_BCACHE_WAIT_TRIES 100
+
+/** @brief Time between the checks of the waiting thread state. */
+#define TEST_BCACHE_WAIT_NS 1000000ULL
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Result of a block get done by a test thread. */
+typedef struct
+{
+    /** @brief The cached block. */
+    bcache_block_t* cached;
+
+    /** @brief The get return value. */
+    OS_RETURN_E err;
+} test_bcache_get_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The test block device. */
+static blkdev_t test_bcache_dev;
+
+/** @brief Number of reads of the test device. */
+static volatile uint32_t test_bcache_reads;
+
+/** @brief Number of blocks read from the test device. */
+static volatile uint32_t test_bcache_read_blocks;
+
+/** @brief Tells if the next read of the test device fails. */
+static volatile bool_t test_bcache_fail;
+
+/** @brief Posted when the read of the gated block starts. */
+static semaphore_t test_bcache_reading;
+
+/** @brief Posted by the test to end the read of the gated block. */
+static semaphore_t test_bcache_gate;
+
+/** @brief Posted when a test thread got its block. */
+static semaphore_t test_bcache_done;
+
+/** @brief The blocks held by the eviction tests. */
+static bcache_block_t* test_bcache_held[BCACHE_BLOCK_COUNT + 1];
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Reads blocks of the test device.
+ *
+ * @details Reads blocks of the test device: every 64 bits word of a block
+ * holds its offset on the device. The read of the gated block waits for the
+ * test.
+ *
+ * @param[in] dev The device.
+ * @param[in] block The first block to read.
+ * @param[in] count The number of blocks to read.
+ * @param[out] buffer The buffer receiving the blocks.
+ *
+ * @return OS_ERR_CORRUPTED_DATA is returned if the read must fail, OS_NO_ERR
+ * otherwise.
+ */
+static OS_RETURN_E _test_bcache_read(blkdev_t* dev,
+                                     const uint64_t block,
+                                     const uint32_t count,
+                                     void* buffer);
+
+/**
+ * @brief Checks the data of a block of the test device.
+ *
+ * @param[in] cached The cached block.
+ * @param[in] block The block number.
+ *
+ * @return TRUE if the data is the one of the block, FALSE otherwise.
+ */
+static bool_t _test_bcache_check(const bcache_block_t* cached,
+                                 const uint64_t block);
+
+/**
+ * @brief Gets the gated block from a test thread.
+ *
+ * @param[out] args The test_bcache_get_t receiving the result.
+ *
+ * @return NULL is always returned.
+ */
+static void* _test_bcache_get_routine(void* args);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static OS_RETURN_E _test_bcache_read(blkdev_t* dev,
+                                     const uint64_t block,
+                                     const uint32_t count,
+                                     void* buffer)
+{
+    uint64_t* words;
+    uint64_t  i;
+
+    (void)dev;
+
+    __atomic_fetch_add(&test_bcache_reads, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&test_bcache_read_blocks, count, __ATOMIC_RELAXED);
+
+    if(block == TEST_BCACHE_GATED_BLOCK)
+    {
+        (void)semaphore_post(&test_bcache_reading);
+        (void)semaphore_wait(&test_bcache_gate);
+    }
+
+    if(test_bcache_fail == TRUE)
+    {
+        test_bcache_fail = FALSE;
+        return OS_ERR_CORRUPTED_DATA;
+    }
+
+    words = buffer;
+    for(i = 0; i < count * BLKDEV_BLOCK_SIZE / sizeof(uint64_t); ++i)
+    {
+        words[i] = block * BLKDEV_BLOCK_SIZE + i * sizeof(uint64_t);
+    }
+
+    return OS_NO_ERR;
+}
+
+static bool_t _test_bcache_check(const bcache_block_t* cached,
+                                 const uint64_t block)
+{
+    const uint64_t* words;
+    uint64_t        i;
+
+    words = (const uint64_t*)cached->data;
+    for(i = 0; i < BLKDEV_BLOCK_SIZE / sizeof(uint64_t); ++i)
+    {
+        if(words[i] != block * BLKDEV_BLOCK_SIZE + i * sizeof(uint64_t))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static void* _test_bcache_get_routine(void* args)
+{
+    test_bcache_get_t* result;
+
+    result      = args;
+    result->err = bcache_get(&test_bcache_dev, TEST_BCACHE_GATED_BLOCK,
+                             &result->cached);
+
+    (void)semaphore_post(&test_bcache_done);
+
+    return NULL;
+}
+
+static void test_bcache_get(void)
+{
+    OS_RETURN_E     err;
+    bcache_block_t* cached;
+    bcache_block_t* hit;
+    uint32_t        reads;
+
+    err = bcache_get(NULL, 0, &cached);
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_GET_NULL0_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_BCACHE_ENABLED);
+
+    err = bcache_get(&test_bcache_dev, 0, NULL);
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_GET_NULL1_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_BCACHE_ENABLED);
+
+    err = bcache_get(&test_bcache_dev, TEST_BCACHE_DEV_BLOCKS, &cached);
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_GET_BOUND0_ID,
+                            err == OS_ERR_OUT_OF_BOUND,
+                            OS_ERR_OUT_OF_BOUND,
+                            err,
+                            TEST_BCACHE_ENABLED);
+
+    /* A first miss reads the block alone */
+    reads = test_bcache_reads;
+    err   = bcache_get(&test_bcache_dev, TEST_BCACHE_MISS_BLOCK, &cached);
+    TEST_POINT_ASSERT_UINT(TEST_BCACHE_MISS0_ID,
+                           err == OS_NO_ERR &&
+                           test_bcache_reads == reads + 1 &&
+                           test_bcache_read_blocks == 1,
+                           reads + 1,
+                           test_bcache_reads,
+                           TEST_BCACHE_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+    TEST_POINT_ASSERT_UINT(TEST_BCACHE_MISS_DATA0_ID,
+                           cached->ref_count == 1 &&
+                           _test_bcache_check(cached,
+                                              TEST_BCACHE_MISS_BLOCK) == TRUE,
+                           1,
+                           cached->ref_count,
+                           TEST_BCACHE_ENABLED);
+
+    /* A hit returns the cached block without read */
+    err = bcache_get(&test_bcache_dev, TEST_BCACHE_MISS_BLOCK, &hit);
+    TEST_POINT_ASSERT_UINT(TEST_BCACHE_HIT0_ID,
+                           err == OS_NO_ERR &&
+                           hit == cached &&
+                           test_bcache_reads == reads + 1 &&
+                           cached->ref_count == 2,
+                           2,
+                           cached->ref_count,
+                           TEST_BCACHE_ENABLED);
+    if(err == OS_NO_ERR)
+    {
+        bcache_release(hit);
+    }
+    bcache_release(cached);
+}
+
+static void test_bcache_read_ahead(void)
+{
+    OS_RETURN_E     err;
+    bcache_block_t* cached;
+    uint32_t        reads;
+    uint32_t        blocks;
+    uint32_t        i;
+    bool_t          valid;
+
+    /* The miss following the previous one reads the next blocks at once */
+    reads  = test_bcache_reads;
+    blocks = test_bcache_read_blocks;
+    err    = bcache_get(&test_bcache_dev, TEST_BCACHE_MISS_BLOCK + 1, &cached);
+    TEST_POINT_ASSERT_UINT(TEST_BCACHE_READ_AHEAD0_ID,
+                           err == OS_NO_ERR &&
+                           test_bcache_reads == reads + 1 &&
+                           test_bcache_read_blocks ==
+                           blocks + BCACHE_READ_AHEAD,
+                           blocks + BCACHE_READ_AHEAD,
+                           test_bcache_read_blocks,
+                           TEST_BCACHE_ENABLED);
+    if(err == OS_NO_ERR)
+    {
+        bcache_release(cached);
+    }
+
+    /* The read ahead blocks are hits */
+    valid = TRUE;
+    for(i = 2; i <= BCACHE_READ_AHEAD && valid == TRUE; ++i)
+    {
+        err = bcache_get(&test_bcache_dev, TEST_BCACHE_MISS_BLOCK + i, &cached);
+        if(err != OS_NO_ERR)
+        {
+            break;
+        }
+        valid = _test_bcache_check(cached, TEST_BCACHE_MISS_BLOCK + i);
+        bcache_release(cached);
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_READ_AHEAD_HIT0_ID,
+                            err == OS_NO_ERR &&
+                            test_bcache_reads == reads + 1,
+                            OS_NO_ERR,
+                            err,
+                            TEST_BCACHE_ENABLED);
+    TEST_POINT_ASSERT_UINT(TEST_BCACHE_READ_AHEAD_DATA0_ID,
+                           valid == TRUE,
+                           TRUE,
+                           valid,
+                           TEST_BCACHE_ENABLED);
+}
+
+static void test_bcache_error(void)
+{
+    OS_RETURN_E     err;
+    bcache_block_t* cached;
+    uint32_t        reads;
+
+    test_bcache_fail = TRUE;
+    err = bcache_get(&test_bcache_dev, TEST_BCACHE_ERROR_BLOCK, &cached);
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_ERROR0_ID,
+                            err == OS_ERR_CORRUPTED_DATA,
+                            OS_ERR_CORRUPTED_DATA,
+                            err,
+                            TEST_BCACHE_ENABLED);
+
+    /* The failed block is not cached, the next get reads it again */
+    reads = test_bcache_reads;
+    err   = bcache_get(&test_bcache_dev, TEST_BCACHE_ERROR_BLOCK, &cached);
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_ERROR_RETRY0_ID,
+                            err == OS_NO_ERR &&
+                            test_bcache_reads == reads + 1 &&
+                            _test_bcache_check(cached,
+                                               TEST_BCACHE_ERROR_BLOCK) == TRUE,
+                            OS_NO_ERR,
+                            err,
+                            TEST_BCACHE_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+
+    err = bcache_invalidate(NULL);
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_INVALIDATE_NULL0_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_BCACHE_ENABLED);
+
+    /* The held blocks are kept */
+    err = bcache_invalidate(&test_bcache_dev);
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_INVALIDATE_HELD0_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_BCACHE_ENABLED);
+
+    bcache_release(cached);
+    err = bcache_invalidate(&test_bcache_dev);
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_INVALIDATE0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_BCACHE_ENABLED);
+
+    /* The invalidated blocks are read again */
+    reads = test_bcache_reads;
+    err   = bcache_get(&test_bcache_dev, TEST_BCACHE_MISS_BLOCK, &cached);
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_INVALIDATE_MISS0_ID,
+                            err == OS_NO_ERR &&
+                            test_bcache_reads == reads + 1,
+                            OS_NO_ERR,
+                            err,
+                            TEST_BCACHE_ENABLED);
+    if(err == OS_NO_ERR)
+    {
+        bcache_release(cached);
+    }
+}
+
+static void test_bcache_evict(void)
+{
+    OS_RETURN_E     err;
+    bcache_block_t* cached;
+    bcache_block_t* held;
+    uint32_t        count;
+    uint32_t        reads;
+    uint32_t        i;
+
+    /* The stride prevents the read ahead, each get holds one entry */
+    test_bcache_dev.next_block = TEST_BCACHE_DEV_BLOCKS;
+    err   = OS_NO_ERR;
+    count = 0;
+    while(count <= BCACHE_BLOCK_COUNT)
+    {
+        err = bcache_get(&test_bcache_dev,
+                         TEST_BCACHE_FILL_BLOCK + 2 * count,
+                         &test_bcache_held[count]);
+        if(err != OS_NO_ERR)
+        {
+            break;
+        }
+        ++count;
+    }
+    TEST_POINT_ASSERT_UINT(TEST_BCACHE_FILL0_ID,
+                           err == OS_ERR_NO_MORE_MEMORY &&
+                           count == BCACHE_BLOCK_COUNT,
+                           BCACHE_BLOCK_COUNT,
+                           count,
+                           TEST_BCACHE_ENABLED);
+
+    /* The released blocks can be evicted */
+    for(i = 0; i < count; ++i)
+    {
+        bcache_release(test_bcache_held[i]);
+    }
+    err = bcache_get(&test_bcache_dev, TEST_BCACHE_HELD_BLOCK, &held);
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_FILL_RELEASED0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_BCACHE_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+
+    /* The held block survives a full turn of misses */
+    for(i = 0; i < BCACHE_BLOCK_COUNT && err == OS_NO_ERR; ++i)
+    {
+        err = bcache_get(&test_bcache_dev,
+                         TEST_BCACHE_FILL_BLOCK + 2 * (BCACHE_BLOCK_COUNT + i),
+                         &cached);
+        if(err == OS_NO_ERR)
+        {
+            bcache_release(cached);
+        }
+    }
+    reads = test_bcache_reads;
+    if(err == OS_NO_ERR)
+    {
+        err = bcache_get(&test_bcache_dev, TEST_BCACHE_HELD_BLOCK, &cached);
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_EVICT_HELD0_ID,
+                            err == OS_NO_ERR &&
+                            cached == held &&
+                            test_bcache_reads == reads &&
+                            _test_bcache_check(cached,
+                                               TEST_BCACHE_HELD_BLOCK) == TRUE,
+                            OS_NO_ERR,
+                            err,
+                            TEST_BCACHE_ENABLED);
+    if(err == OS_NO_ERR)
+    {
+        bcache_release(cached);
+    }
+    bcache_release(held);
+}
+
+static void test_bcache_wait(void)
+{
+    OS_RETURN_E       err;
+    kernel_thread_t*  current;
+    kernel_thread_t*  waiter;
+    test_bcache_get_t loader_get;
+    test_bcache_get_t waiter_get;
+    uint32_t          reads;
+    uint32_t          i;
+
+    err = semaphore_init(&test_bcache_reading, 0);
+    if(err == OS_NO_ERR)
+    {
+        err = semaphore_init(&test_bcache_gate, 0);
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = semaphore_init(&test_bcache_done, 0);
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_WAIT_INIT0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_BCACHE_ENABLED);
+
+    /* The loader thread reads the gated block and waits for the gate */
+    reads   = test_bcache_reads;
+    current = scheduler_get_current_thread();
+    err     = scheduler_create_kernel_thread(NULL, current->priority,
+                                             "bcache_test",
+                                             _test_bcache_get_routine,
+                                             &loader_get);
+    if(err == OS_NO_ERR)
+    {
+        (void)semaphore_wait(&test_bcache_reading);
+        err = scheduler_create_kernel_thread(&waiter, current->priority,
+                                             "bcache_test",
+                                             _test_bcache_get_routine,
+                                             &waiter_get);
+        if(err != OS_NO_ERR)
+        {
+            (void)semaphore_post(&test_bcache_gate);
+            (void)semaphore_wait(&test_bcache_done);
+        }
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_WAIT_THREADS0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_BCACHE_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+
+    /* The other user of the block waits instead of spinning */
+    for(i = 0;
+        i < TEST_BCACHE_WAIT_TRIES &&
+        __atomic_load_n(&waiter->state, __ATOMIC_ACQUIRE) !=
+        THREAD_STATE_WAITING;
+        ++i)
+    {
+        (void)scheduler_sleep(TEST_BCACHE_WAIT_NS);
+    }
+    TEST_POINT_ASSERT_UINT(TEST_BCACHE_WAIT_BLOCKED0_ID,
+                           waiter->state == THREAD_STATE_WAITING,
+                           THREAD_STATE_WAITING,
+                           waiter->state,
+                           TEST_BCACHE_ENABLED);
+
+    (void)semaphore_post(&test_bcache_gate);
+    (void)semaphore_wait(&test_bcache_done);
+    (void)semaphore_wait(&test_bcache_done);
+
+    /* Both users get the block read once */
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_WAIT_LOADER0_ID,
+                            loader_get.err == OS_NO_ERR &&
+                            _test_bcache_check(loader_get.cached,
+                                               TEST_BCACHE_GATED_BLOCK) == TRUE,
+                            OS_NO_ERR,
+                            loader_get.err,
+                            TEST_BCACHE_ENABLED);
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_WAIT_WAITER0_ID,
+                            waiter_get.err == OS_NO_ERR &&
+                            waiter_get.cached == loader_get.cached,
+                            OS_NO_ERR,
+                            waiter_get.err,
+                            TEST_BCACHE_ENABLED);
+    TEST_POINT_ASSERT_UINT(TEST_BCACHE_WAIT_READS0_ID,
+                           test_bcache_reads == reads + 1,
+                           reads + 1,
+                           test_bcache_reads,
+                           TEST_BCACHE_ENABLED);
+
+    if(loader_get.err == OS_NO_ERR)
+    {
+        bcache_release(loader_get.cached);
+    }
+    if(waiter_get.err == OS_NO_ERR)
+    {
+        bcache_release(waiter_get.cached);
+    }
+}
+
+void bcache_test(void)
+{
+    OS_RETURN_E err;
+
+    /* The first miss is not sequential */
+    test_bcache_dev.name        = "bcache_test";
+    test_bcache_dev.block_count = TEST_BCACHE_DEV_BLOCKS;
+    test_bcache_dev.read        = _test_bcache_read;
+    test_bcache_dev.map         = NULL;
+    test_bcache_dev.driver_ctrl = NULL;
+    test_bcache_dev.next_block  = TEST_BCACHE_DEV_BLOCKS;
+    test_bcache_reads           = 0;
+    test_bcache_read_blocks     = 0;
+    test_bcache_fail            = FALSE;
+
+    /* The cache is initialized with the boot file systems */
+    err = initcall_require(VFS_ROOT_INITCALL);
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_INIT0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_BCACHE_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        TEST_FRAMEWORK_END();
+        return;
+    }
+
+    test_bcache_get();
+    test_bcache_read_ahead();
+    test_bcache_error();
+    test_bcache_evict();
+    test_bcache_wait();
+
+    err = bcache_invalidate(&test_bcache_dev);
+    TEST_POINT_ASSERT_RCODE(TEST_BCACHE_END0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_BCACHE_ENABLED);
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
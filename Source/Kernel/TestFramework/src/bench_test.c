@@ -0,0 +1,177 @@
+/*******************************************************************************
+ * @file bench_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework kernel microbenchmarks.
+ *
+ * @details Testing framework kernel microbenchmarks. Measures the memory
+ * copy and set routines, the spinlocks and the kernel formatted output. The
+ * interrupts latencies are measured by interrupt_bench_test.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <string.h>
+#include <critical.h>
+#include <kernel_output.h>
+#include <profiler.h>
+#include <lockstat.h>
+#include <memstat.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Size of the memory benchmarks buffers. */
+#define BENCH_BUFFER_SIZE 4096
+
+/** @brief Number of untimed calls before each benchmark. */
+#define BENCH_WARMUP 64
+
+/** @brief Number of timed calls of each benchmark. */
+#define BENCH_ITERATIONS 1000
+
+/** @brief Profiler sampling period during the benchmarks, in nanoseconds. */
+#define BENCH_PROFILER_PERIOD_NS 100000
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+static uint8_t bench_src[BENCH_BUFFER_SIZE] __attribute__((aligned(64)));
+static uint8_t bench_dst[BENCH_BUFFER_SIZE] __attribute__((aligned(64)));
+
+static kernel_spinlock_t bench_lock = KERNEL_SPINLOCK_INIT_VALUE;
+
+static volatile uint32_t bench_counter = 0;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void bench_memcpy(void* args)
+{
+    (void)args;
+
+    memcpy(bench_dst, bench_src, BENCH_BUFFER_SIZE);
+}
+
+static void bench_memset(void* args)
+{
+    (void)args;
+
+    memset(bench_dst, 0xA5, BENCH_BUFFER_SIZE);
+}
+
+static void bench_spinlock(void* args)
+{
+    (void)args;
+
+    KERNEL_SPINLOCK_LOCK(bench_lock);
+    ++bench_counter;
+    KERNEL_SPINLOCK_UNLOCK(bench_lock);
+}
+
+static void bench_spinlock_irqsave(void* args)
+{
+    uint32_t int_state;
+
+    (void)args;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(bench_lock, int_state);
+    ++bench_counter;
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(bench_lock, int_state);
+}
+
+static void bench_printf(void* args)
+{
+    (void)args;
+
+    kernel_printf("BENCH %u 0x%x %s\n", bench_counter, bench_counter,
+                  "printf");
+}
+
+void bench_test(void)
+{
+    OS_RETURN_E err;
+
+    TEST_POINT_BENCH("memcpy_4k", bench_memcpy, NULL,
+                     BENCH_WARMUP, BENCH_ITERATIONS,
+                     TEST_BENCHMARK_ENABLED);
+    TEST_POINT_BENCH("memset_4k", bench_memset, NULL,
+                     BENCH_WARMUP, BENCH_ITERATIONS,
+                     TEST_BENCHMARK_ENABLED);
+    TEST_POINT_BENCH("spinlock", bench_spinlock, NULL,
+                     BENCH_WARMUP, BENCH_ITERATIONS,
+                     TEST_BENCHMARK_ENABLED);
+    TEST_POINT_BENCH("spinlock_irqsave", bench_spinlock_irqsave, NULL,
+                     BENCH_WARMUP, BENCH_ITERATIONS,
+                     TEST_BENCHMARK_ENABLED);
+    TEST_POINT_BENCH("printf", bench_printf, NULL,
+                     BENCH_WARMUP, BENCH_ITERATIONS,
+                     TEST_BENCHMARK_ENABLED);
+
+    /* The benchmarks still run when the profiler is not available */
+    err = profiler_start(BENCH_PROFILER_PERIOD_NS);
+
+    TEST_FRAMEWORK_RUN_BENCH();
+
+    if(err == OS_NO_ERR)
+    {
+        profiler_stop();
+        profiler_dump();
+    }
+    lockstat_dump();
+    memstat_dump();
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
\ No newline at end of file
@@ -0,0 +1,599 @@
+/*******************************************************************************
+ * @file elf_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework ELF loader testing.
+ *
+ * @details Testing framework ELF loader testing. Mounts a memory backed
+ * archive holding a program with one writable segment and loads it. The
+ * segment page is faulted in on a private frame by a first read, the clone of
+ * the process then shares the frame copy-on-write. A write in the clone goes
+ * through the copy-on-write fault and must leave the page of the parent
+ * unchanged.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stddef.h>
+#include <string.h>
+#include <kerror.h>
+#include <cpu.h>
+#include <critical.h>
+#include <scheduler.h>
+#include <vmm.h>
+#include <blkdev.h>
+#include <vfs.h>
+#include <ustar.h>
+#include <elf.h>
+#include <cpu_interrupt.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Mount point of the test archive. */
+#define TEST_ELF_MOUNT_PATH "/elf_test"
+
+/** @brief Name of the program in the test archive. */
+#define TEST_ELF_FILE_NAME "prog"
+
+/** @brief Path of the program in the test archive. */
+#define TEST_ELF_FILE_PATH TEST_ELF_MOUNT_PATH "/" TEST_ELF_FILE_NAME
+
+/** @brief Number of blocks of the archive: header, program, end blocks. */
+#define TEST_ELF_BLOCK_COUNT 4
+
+/** @brief Size of the program, one block. */
+#define TEST_ELF_FILE_SIZE BLKDEV_BLOCK_SIZE
+
+/** @brief Offset of the segment data in the program. */
+#define TEST_ELF_DATA_OFFSET 256
+
+/** @brief Address of the segment data, in the first user page. */
+#define TEST_ELF_DATA_ADDR \
+    ((uintptr_t)KERNEL_USER_SPACE_START + TEST_ELF_DATA_OFFSET)
+
+/** @brief Value of the segment data in the program. */
+#define TEST_ELF_PATTERN 0xC0FFEE42
+
+/** @brief Value written by the clone. */
+#define TEST_ELF_CLONE_PATTERN 0x600DF00D
+
+/** @brief ELF executable type. */
+#define TEST_ELF_TYPE_EXEC 2
+
+/** @brief Loadable program header type. */
+#define TEST_ELF_PT_LOAD 1
+
+/** @brief Readable and writable segment flags. */
+#define TEST_ELF_PF_RW 0x6
+
+/** @brief Offset of the USTAR header checksum field. */
+#define TEST_ELF_USTAR_CHECKSUM 148
+
+/** @brief Size of the USTAR header checksum field. */
+#define TEST_ELF_USTAR_CHECKSUM_SIZE 8
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+#ifdef ARCH_64_BITS
+/** @brief ELF header. */
+typedef struct
+{
+    /** @brief Identification bytes. */
+    uint8_t ident[16];
+
+    /** @brief File type. */
+    uint16_t type;
+
+    /** @brief Target machine. */
+    uint16_t machine;
+
+    /** @brief File version. */
+    uint32_t version;
+
+    /** @brief Entry point. */
+    uint64_t entry;
+
+    /** @brief Program headers table offset. */
+    uint64_t phoff;
+
+    /** @brief Section headers table offset. */
+    uint64_t shoff;
+
+    /** @brief Machine flags. */
+    uint32_t flags;
+
+    /** @brief ELF header size. */
+    uint16_t ehsize;
+
+    /** @brief Program header size. */
+    uint16_t phentsize;
+
+    /** @brief Number of program headers. */
+    uint16_t phnum;
+
+    /** @brief Section header size. */
+    uint16_t shentsize;
+
+    /** @brief Number of section headers. */
+    uint16_t shnum;
+
+    /** @brief Section names index. */
+    uint16_t shstrndx;
+} __attribute__((packed)) test_elf_header_t;
+
+/** @brief ELF program header. */
+typedef struct
+{
+    /** @brief Segment type. */
+    uint32_t type;
+
+    /** @brief Segment flags. */
+    uint32_t flags;
+
+    /** @brief Segment file offset. */
+    uint64_t offset;
+
+    /** @brief Segment virtual address. */
+    uint64_t vaddr;
+
+    /** @brief Segment physical address. */
+    uint64_t paddr;
+
+    /** @brief Segment file size. */
+    uint64_t filesz;
+
+    /** @brief Segment memory size. */
+    uint64_t memsz;
+
+    /** @brief Segment alignment. */
+    uint64_t align;
+} __attribute__((packed)) test_elf_program_header_t;
+#else
+/** @brief ELF header. */
+typedef struct
+{
+    /** @brief Identification bytes. */
+    uint8_t ident[16];
+
+    /** @brief File type. */
+    uint16_t type;
+
+    /** @brief Target machine. */
+    uint16_t machine;
+
+    /** @brief File version. */
+    uint32_t version;
+
+    /** @brief Entry point. */
+    uint32_t entry;
+
+    /** @brief Program headers table offset. */
+    uint32_t phoff;
+
+    /** @brief Section headers table offset. */
+    uint32_t shoff;
+
+    /** @brief Machine flags. */
+    uint32_t flags;
+
+    /** @brief ELF header size. */
+    uint16_t ehsize;
+
+    /** @brief Program header size. */
+    uint16_t phentsize;
+
+    /** @brief Number of program headers. */
+    uint16_t phnum;
+
+    /** @brief Section header size. */
+    uint16_t shentsize;
+
+    /** @brief Number of section headers. */
+    uint16_t shnum;
+
+    /** @brief Section names index. */
+    uint16_t shstrndx;
+} __attribute__((packed)) test_elf_header_t;
+
+/** @brief ELF program header. */
+typedef struct
+{
+    /** @brief Segment type. */
+    uint32_t type;
+
+    /** @brief Segment file offset. */
+    uint32_t offset;
+
+    /** @brief Segment virtual address. */
+    uint32_t vaddr;
+
+    /** @brief Segment physical address. */
+    uint32_t paddr;
+
+    /** @brief Segment file size. */
+    uint32_t filesz;
+
+    /** @brief Segment memory size. */
+    uint32_t memsz;
+
+    /** @brief Segment flags. */
+    uint32_t flags;
+
+    /** @brief Segment alignment. */
+    uint32_t align;
+} __attribute__((packed)) test_elf_program_header_t;
+#endif
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Test archive, the program data is held in place. */
+static uint8_t test_elf_archive[TEST_ELF_BLOCK_COUNT * BLKDEV_BLOCK_SIZE]
+    __attribute__((aligned(VMM_PAGE_SIZE)));
+
+/** @brief Memory backed device of the test archive. */
+static blkdev_t test_elf_dev;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Reads the blocks of the test archive device.
+ *
+ * @param[in] dev The device.
+ * @param[in] block The first block to read.
+ * @param[in] count The number of blocks to read.
+ * @param[out] buffer The buffer receiving the blocks.
+ *
+ * @return OS_NO_ERR is always returned.
+ */
+static OS_RETURN_E _test_elf_read(blkdev_t* dev,
+                                  const uint64_t block,
+                                  const uint32_t count,
+                                  void* buffer);
+
+/**
+ * @brief Returns the address of a block of the test archive device.
+ *
+ * @param[in] dev The device.
+ * @param[in] block The block.
+ *
+ * @return The address of the block.
+ */
+static const void* _test_elf_map(blkdev_t* dev, const uint64_t block);
+
+/**
+ * @brief Writes an octal number in a USTAR header field.
+ *
+ * @param[out] field The field, ended by a NULL character.
+ * @param[in] size The field size in bytes.
+ * @param[in] value The number.
+ */
+static void _test_elf_octal(char* field, const size_t size, uint32_t value);
+
+/**
+ * @brief Builds the test archive holding the program.
+ */
+static void _test_elf_build(void);
+
+/**
+ * @brief Accesses the segment data in the address space of a process.
+ *
+ * @details The current thread runs in the process address space during the
+ * access, its page faults are then resolved in the process.
+ *
+ * @param[in] process The process.
+ * @param[in] write TRUE to write the value before reading it back.
+ * @param[in] value The value to write.
+ *
+ * @return The value read.
+ */
+static uint32_t _test_elf_access(elf_process_t* process,
+                                 const bool_t write,
+                                 const uint32_t value);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static OS_RETURN_E _test_elf_read(blkdev_t* dev,
+                                  const uint64_t block,
+                                  const uint32_t count,
+                                  void* buffer)
+{
+    (void)dev;
+
+    memcpy(buffer, test_elf_archive + block * BLKDEV_BLOCK_SIZE,
+           count * BLKDEV_BLOCK_SIZE);
+
+    return OS_NO_ERR;
+}
+
+static const void* _test_elf_map(blkdev_t* dev, const uint64_t block)
+{
+    (void)dev;
+
+    return test_elf_archive + block * BLKDEV_BLOCK_SIZE;
+}
+
+static void _test_elf_octal(char* field, const size_t size, uint32_t value)
+{
+    size_t i;
+
+    field[size - 1] = '\0';
+    for(i = size - 1; i > 0; --i)
+    {
+        field[i - 1] = '0' + (value & 0x7);
+        value >>= 3;
+    }
+}
+
+static void _test_elf_build(void)
+{
+    test_elf_header_t         header;
+    test_elf_program_header_t program_header;
+    uint8_t*                  file;
+    uint32_t                  pattern;
+    uint32_t                  sum;
+    uint32_t                  i;
+
+    memset(test_elf_archive, 0, sizeof(test_elf_archive));
+
+    /* Entry header */
+    memcpy(test_elf_archive, TEST_ELF_FILE_NAME, sizeof(TEST_ELF_FILE_NAME));
+    _test_elf_octal((char*)test_elf_archive + 100, 8, 0644);
+    _test_elf_octal((char*)test_elf_archive + 108, 8, 0);
+    _test_elf_octal((char*)test_elf_archive + 116, 8, 0);
+    _test_elf_octal((char*)test_elf_archive + 124, 12, TEST_ELF_FILE_SIZE);
+    _test_elf_octal((char*)test_elf_archive + 136, 12, 0);
+    test_elf_archive[156] = '0';
+    memcpy(test_elf_archive + 257, "ustar", sizeof("ustar"));
+    memcpy(test_elf_archive + 263, "00", 2);
+
+    sum = 0;
+    for(i = 0; i < BLKDEV_BLOCK_SIZE; ++i)
+    {
+        if(i >= TEST_ELF_USTAR_CHECKSUM &&
+           i < TEST_ELF_USTAR_CHECKSUM + TEST_ELF_USTAR_CHECKSUM_SIZE)
+        {
+            sum += ' ';
+        }
+        else
+        {
+            sum += test_elf_archive[i];
+        }
+    }
+    _test_elf_octal((char*)test_elf_archive + TEST_ELF_USTAR_CHECKSUM,
+                    TEST_ELF_USTAR_CHECKSUM_SIZE, sum);
+
+    /* Program: one writable segment holding the pattern */
+    file = test_elf_archive + BLKDEV_BLOCK_SIZE;
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.ident, "\x7F" "ELF", 4);
+    header.ident[4]  = CPU_ELF_CLASS;
+    header.ident[5]  = 1;
+    header.ident[6]  = 1;
+    header.type      = TEST_ELF_TYPE_EXEC;
+    header.machine   = CPU_ELF_MACHINE;
+    header.version   = 1;
+    header.entry     = TEST_ELF_DATA_ADDR;
+    header.phoff     = sizeof(header);
+    header.ehsize    = sizeof(header);
+    header.phentsize = sizeof(program_header);
+    header.phnum     = 1;
+    memcpy(file, &header, sizeof(header));
+
+    memset(&program_header, 0, sizeof(program_header));
+    program_header.type   = TEST_ELF_PT_LOAD;
+    program_header.flags  = TEST_ELF_PF_RW;
+    program_header.offset = TEST_ELF_DATA_OFFSET;
+    program_header.vaddr  = TEST_ELF_DATA_ADDR;
+    program_header.paddr  = TEST_ELF_DATA_ADDR;
+    program_header.filesz = sizeof(pattern);
+    program_header.memsz  = sizeof(pattern);
+    program_header.align  = VMM_PAGE_SIZE;
+    memcpy(file + sizeof(header), &program_header, sizeof(program_header));
+
+    pattern = TEST_ELF_PATTERN;
+    memcpy(file + TEST_ELF_DATA_OFFSET, &pattern, sizeof(pattern));
+}
+
+static uint32_t _test_elf_access(elf_process_t* process,
+                                 const bool_t write,
+                                 const uint32_t value)
+{
+    kernel_thread_t*   current;
+    elf_process_t*     saved;
+    volatile uint32_t* data;
+    uint32_t           read;
+    uint32_t           int_state;
+
+    data = (volatile uint32_t*)TEST_ELF_DATA_ADDR;
+
+    /* The thread cannot be scheduled out of the address space */
+    ENTER_CRITICAL(int_state);
+    current          = scheduler_get_current_thread();
+    saved            = current->process;
+    current->process = process;
+    vmm_space_switch(process->space);
+
+    if(write == TRUE)
+    {
+        *data = value;
+    }
+    read = *data;
+
+    vmm_space_switch(NULL);
+    current->process = saved;
+    EXIT_CRITICAL(int_state);
+
+    return read;
+}
+
+static void test_elf_clone_cow(void)
+{
+    OS_RETURN_E    err;
+    elf_process_t* process;
+    elf_process_t* clone;
+    uintptr_t      phys;
+    uintptr_t      clone_phys;
+    uint32_t       value;
+
+    _test_elf_build();
+    test_elf_dev.name        = "elf_test";
+    test_elf_dev.block_count = TEST_ELF_BLOCK_COUNT;
+    test_elf_dev.read        = _test_elf_read;
+    test_elf_dev.map         = _test_elf_map;
+    test_elf_dev.driver_ctrl = NULL;
+    test_elf_dev.next_block  = TEST_ELF_BLOCK_COUNT;
+
+    err = vfs_mount(TEST_ELF_MOUNT_PATH, USTAR_DRIVER_NAME, &test_elf_dev);
+    TEST_POINT_ASSERT_RCODE(TEST_ELF_MOUNT0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_ELF_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+
+    err = elf_load(TEST_ELF_FILE_PATH, &process);
+    TEST_POINT_ASSERT_RCODE(TEST_ELF_LOAD0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_ELF_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        (void)vfs_unmount(TEST_ELF_MOUNT_PATH);
+        return;
+    }
+
+    /* The first read faults the page in on a private frame */
+    value = _test_elf_access(process, FALSE, 0);
+    TEST_POINT_ASSERT_UINT(TEST_ELF_FAULT0_ID,
+                           value == TEST_ELF_PATTERN &&
+                           process->private_pages == 1,
+                           TEST_ELF_PATTERN,
+                           value,
+                           TEST_ELF_ENABLED);
+
+    err = elf_clone(process, &clone);
+    TEST_POINT_ASSERT_RCODE(TEST_ELF_CLONE0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_ELF_ENABLED);
+    if(err == OS_NO_ERR)
+    {
+        /* The processes share the private frame */
+        phys       = 0;
+        clone_phys = 1;
+        (void)vmm_space_get_physical(process->space, TEST_ELF_DATA_ADDR,
+                                     &phys);
+        (void)vmm_space_get_physical(clone->space, TEST_ELF_DATA_ADDR,
+                                     &clone_phys);
+        TEST_POINT_ASSERT_UDWORD(TEST_ELF_SHARED0_ID,
+                                 phys == clone_phys,
+                                 (uint64_t)phys,
+                                 (uint64_t)clone_phys,
+                                 TEST_ELF_ENABLED);
+
+        /* The write of the clone copies the page */
+        value = _test_elf_access(clone, TRUE, TEST_ELF_CLONE_PATTERN);
+        TEST_POINT_ASSERT_UINT(TEST_ELF_COW0_ID,
+                               value == TEST_ELF_CLONE_PATTERN,
+                               TEST_ELF_CLONE_PATTERN,
+                               value,
+                               TEST_ELF_ENABLED);
+
+        (void)vmm_space_get_physical(clone->space, TEST_ELF_DATA_ADDR,
+                                     &clone_phys);
+        TEST_POINT_ASSERT_UDWORD(TEST_ELF_COW1_ID,
+                                 phys != clone_phys,
+                                 (uint64_t)phys,
+                                 (uint64_t)clone_phys,
+                                 TEST_ELF_ENABLED);
+
+        /* The page of the parent is unchanged */
+        value = _test_elf_access(process, FALSE, 0);
+        TEST_POINT_ASSERT_UINT(TEST_ELF_PARENT0_ID,
+                               value == TEST_ELF_PATTERN,
+                               TEST_ELF_PATTERN,
+                               value,
+                               TEST_ELF_ENABLED);
+
+        err = elf_destroy(clone);
+        TEST_POINT_ASSERT_RCODE(TEST_ELF_DESTROY0_ID,
+                                err == OS_NO_ERR,
+                                OS_NO_ERR,
+                                err,
+                                TEST_ELF_ENABLED);
+    }
+
+    err = elf_destroy(process);
+    TEST_POINT_ASSERT_RCODE(TEST_ELF_DESTROY1_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_ELF_ENABLED);
+
+    err = vfs_unmount(TEST_ELF_MOUNT_PATH);
+    TEST_POINT_ASSERT_RCODE(TEST_ELF_UNMOUNT0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_ELF_ENABLED);
+}
+
+void elf_test(void)
+{
+    test_elf_clone_cow();
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,370 @@
+/*******************************************************************************
+ * @file idt_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework IDT testing.
+ *
+ * @details Testing framework IDT testing. Checks the IDT built at link time:
+ * the loaded IDT is the read only one, every entry points to the stub of its
+ * line with the kernel code segment and the interrupt gate flags, the stubs
+ * push their line number and the x86_64 emergency and page fault lines use
+ * their IST.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stddef.h>
+#include <kerror.h>
+#include <cpu_interrupt.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Size of an interrupt stub, must match int_handlers.s. */
+#define TEST_IDT_STUB_SIZE 16
+
+/** @brief Flags of the IDT entries: present PL0 interrupt gate. */
+#define TEST_IDT_INT_GATE_PL0 0x8E
+
+/** @brief Opcode of a push with a byte immediate. */
+#define TEST_IDT_PUSH_IMM8 0x6A
+
+/** @brief Opcode of a push with a double word immediate. */
+#define TEST_IDT_PUSH_IMM32 0x68
+
+#ifdef ARCH_64_BITS
+/** @brief Kernel code segment of the IDT entries. */
+#define TEST_IDT_KERNEL_CS 0x28
+
+/** @brief IST of the emergency lines. */
+#define TEST_IDT_EMERGENCY_IST 1
+
+/** @brief IST of the page fault line. */
+#define TEST_IDT_FAULT_IST 2
+#else
+/** @brief Kernel code segment of the IDT entries. */
+#define TEST_IDT_KERNEL_CS 0x08
+#endif
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief IDT register value. */
+typedef struct
+{
+    /** @brief IDT size minus one. */
+    uint16_t size;
+
+    /** @brief IDT base address. */
+    uintptr_t base;
+} __attribute__((packed)) test_idt_ptr_t;
+
+#ifdef ARCH_64_BITS
+/** @brief IDT entry. */
+typedef struct
+{
+    /** @brief Handler address bits 15 to 0. */
+    uint16_t off_low;
+
+    /** @brief Code segment selector. */
+    uint16_t c_sel;
+
+    /** @brief Entry IST number. */
+    uint8_t ist;
+
+    /** @brief Entry flags. */
+    uint8_t flags;
+
+    /** @brief Handler address bits 31 to 16. */
+    uint16_t off_mid;
+
+    /** @brief Handler address bits 63 to 32. */
+    uint32_t off_hig;
+
+    /** @brief Must be zero. */
+    uint32_t reserved1;
+} __attribute__((packed)) test_idt_entry_t;
+#else
+/** @brief IDT entry. */
+typedef struct
+{
+    /** @brief Handler address bits 15 to 0. */
+    uint16_t off_low;
+
+    /** @brief Code segment selector. */
+    uint16_t c_sel;
+
+    /** @brief Must be zero. */
+    uint8_t zero;
+
+    /** @brief Entry flags. */
+    uint8_t flags;
+
+    /** @brief Handler address bits 31 to 16. */
+    uint16_t off_hig;
+} __attribute__((packed)) test_idt_entry_t;
+#endif
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/** @brief Interrupt stubs base symbol. */
+extern int8_t _INT_STUBS_BASE;
+
+/** @brief Read only data start symbol. */
+extern int8_t _START_RO_DATA_ADDR;
+
+/** @brief Read only data end symbol. */
+extern int8_t _END_RO_DATA_ADDR;
+
+/** @brief Assembly interrupt handler of the page fault. */
+extern void interrupt_handler_14(void);
+
+/** @brief Assembly interrupt handler of the last line. */
+extern void interrupt_handler_255(void);
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Returns the handler address of an IDT entry.
+ *
+ * @param[in] entry The IDT entry.
+ *
+ * @return The handler address.
+ */
+static uintptr_t _test_idt_handler(const test_idt_entry_t* entry);
+
+/**
+ * @brief Tells if the CPU pushes an error code for an interrupt line.
+ *
+ * @param[in] line The interrupt line.
+ *
+ * @return TRUE if the CPU pushes an error code, FALSE otherwise.
+ */
+static bool_t _test_idt_has_error_code(const uint32_t line);
+
+/**
+ * @brief Tells if an interrupt stub pushes its line number.
+ *
+ * @details Tells if an interrupt stub pushes its line number, after the dummy
+ * error code for the lines without error code.
+ *
+ * @param[in] stub The stub address.
+ * @param[in] line The interrupt line.
+ *
+ * @return TRUE if the stub pushes the line number, FALSE otherwise.
+ */
+static bool_t _test_idt_stub_pushes(const uint8_t* stub, const uint32_t line);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static uintptr_t _test_idt_handler(const test_idt_entry_t* entry)
+{
+#ifdef ARCH_64_BITS
+    return (uintptr_t)entry->off_low |
+           ((uintptr_t)entry->off_mid << 16) |
+           ((uintptr_t)entry->off_hig << 32);
+#else
+    return (uintptr_t)entry->off_low | ((uintptr_t)entry->off_hig << 16);
+#endif
+}
+
+static bool_t _test_idt_has_error_code(const uint32_t line)
+{
+    return (line == 8 || (line >= 10 && line <= 14) ||
+            line == 17 || line == 30);
+}
+
+static bool_t _test_idt_stub_pushes(const uint8_t* stub, const uint32_t line)
+{
+    if(_test_idt_has_error_code(line) == FALSE)
+    {
+        if(stub[0] != TEST_IDT_PUSH_IMM8 || stub[1] != 0)
+        {
+            return FALSE;
+        }
+        stub += 2;
+    }
+
+    if(line < 128)
+    {
+        return (stub[0] == TEST_IDT_PUSH_IMM8 && stub[1] == (uint8_t)line);
+    }
+
+    return (stub[0] == TEST_IDT_PUSH_IMM32 &&
+            stub[1] == (uint8_t)line &&
+            stub[2] == 0 && stub[3] == 0 && stub[4] == 0);
+}
+
+static void test_idt_table(void)
+{
+    test_idt_ptr_t          idt_ptr;
+    const test_idt_entry_t* idt;
+    uintptr_t               stubs;
+    uint32_t                i;
+    uint32_t                bad_handlers;
+    uint32_t                bad_flags;
+    uint32_t                bad_stubs;
+#ifdef ARCH_64_BITS
+    uint32_t                bad_ist;
+    uint8_t                 ist;
+#endif
+
+    __asm__ __volatile__("sidt %0" : "=m" (idt_ptr));
+    idt   = (const test_idt_entry_t*)idt_ptr.base;
+    stubs = (uintptr_t)&_INT_STUBS_BASE;
+
+    TEST_POINT_ASSERT_UINT(TEST_IDT_SIZE0_ID,
+                           idt_ptr.size ==
+                           IDT_ENTRY_COUNT * sizeof(test_idt_entry_t) - 1,
+                           IDT_ENTRY_COUNT * sizeof(test_idt_entry_t) - 1,
+                           idt_ptr.size,
+                           TEST_IDT_ENABLED);
+
+    /* The IDT is constant data */
+    TEST_POINT_ASSERT_UDWORD(TEST_IDT_RODATA0_ID,
+                             idt_ptr.base >=
+                             (uintptr_t)&_START_RO_DATA_ADDR &&
+                             idt_ptr.base + idt_ptr.size <
+                             (uintptr_t)&_END_RO_DATA_ADDR,
+                             (uint64_t)(uintptr_t)&_START_RO_DATA_ADDR,
+                             (uint64_t)idt_ptr.base,
+                             TEST_IDT_ENABLED);
+
+    TEST_POINT_ASSERT_UDWORD(TEST_IDT_STUBS_ALIGN0_ID,
+                             (stubs & 0xFFF) == 0,
+                             (uint64_t)0,
+                             (uint64_t)(stubs & 0xFFF),
+                             TEST_IDT_ENABLED);
+
+    bad_handlers = 0;
+    bad_flags    = 0;
+    bad_stubs    = 0;
+#ifdef ARCH_64_BITS
+    bad_ist      = 0;
+#endif
+    for(i = 0; i < IDT_ENTRY_COUNT; ++i)
+    {
+        if(_test_idt_handler(&idt[i]) != stubs + i * TEST_IDT_STUB_SIZE)
+        {
+            ++bad_handlers;
+        }
+        if(idt[i].c_sel != TEST_IDT_KERNEL_CS ||
+           idt[i].flags != TEST_IDT_INT_GATE_PL0)
+        {
+            ++bad_flags;
+        }
+        if(_test_idt_stub_pushes((const uint8_t*)stubs +
+                                 i * TEST_IDT_STUB_SIZE, i) == FALSE)
+        {
+            ++bad_stubs;
+        }
+#ifdef ARCH_64_BITS
+        /* NMI, #DF and #MC run on the emergency stack, #PF on the fault
+         * stack
+         */
+        ist = (i == 2 || i == 8 || i == 18) ? TEST_IDT_EMERGENCY_IST : 0;
+        if(i == 14)
+        {
+            ist = TEST_IDT_FAULT_IST;
+        }
+        if(idt[i].ist != ist || idt[i].reserved1 != 0)
+        {
+            ++bad_ist;
+        }
+#else
+        if(idt[i].zero != 0)
+        {
+            ++bad_flags;
+        }
+#endif
+    }
+
+    TEST_POINT_ASSERT_UINT(TEST_IDT_HANDLERS0_ID,
+                           bad_handlers == 0,
+                           0,
+                           bad_handlers,
+                           TEST_IDT_ENABLED);
+    TEST_POINT_ASSERT_UINT(TEST_IDT_FLAGS0_ID,
+                           bad_flags == 0,
+                           0,
+                           bad_flags,
+                           TEST_IDT_ENABLED);
+    TEST_POINT_ASSERT_UINT(TEST_IDT_STUBS0_ID,
+                           bad_stubs == 0,
+                           0,
+                           bad_stubs,
+                           TEST_IDT_ENABLED);
+#ifdef ARCH_64_BITS
+    TEST_POINT_ASSERT_UINT(TEST_IDT_IST0_ID,
+                           bad_ist == 0,
+                           0,
+                           bad_ist,
+                           TEST_IDT_ENABLED);
+#endif
+
+    /* The stubs symbols are where the IDT points */
+    TEST_POINT_ASSERT_UDWORD(TEST_IDT_SYMBOL0_ID,
+                             _test_idt_handler(&idt[14]) ==
+                             (uintptr_t)interrupt_handler_14,
+                             (uint64_t)(uintptr_t)interrupt_handler_14,
+                             (uint64_t)_test_idt_handler(&idt[14]),
+                             TEST_IDT_ENABLED);
+    TEST_POINT_ASSERT_UDWORD(TEST_IDT_SYMBOL1_ID,
+                             _test_idt_handler(&idt[255]) ==
+                             (uintptr_t)interrupt_handler_255,
+                             (uint64_t)(uintptr_t)interrupt_handler_255,
+                             (uint64_t)_test_idt_handler(&idt[255]),
+                             TEST_IDT_ENABLED);
+}
+
+void idt_test(void)
+{
+    test_idt_table();
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
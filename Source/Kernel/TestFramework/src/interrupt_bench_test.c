@@ -0,0 +1,259 @@
+/*******************************************************************************
+ * @file interrupt_bench_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework interrupts latency benchmarks.
+ *
+ * @details Testing framework interrupts latency benchmarks. Measures the
+ * software interrupt round trip through the generic and the fast entry paths,
+ * the generic entry spill and restore alone and the handler lookup. When the
+ * tracing is compiled in, the benchmarks are measured with the tracing enabled
+ * and then disabled.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <interrupts.h>
+#include <cpu_interrupt.h>
+#include <cpu.h>
+#include <tracing.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Line of the generic path benchmarks handler. */
+#define BENCH_INT_LINE MIN_INTERRUPT_LINE
+
+/** @brief Line of the fast path benchmarks handler. */
+#define BENCH_FAST_INT_LINE (MIN_INTERRUPT_LINE + 1)
+
+/** @brief Number of untimed calls before each benchmark. */
+#define BENCH_WARMUP 64
+
+/** @brief Number of timed calls of each benchmark. */
+#define BENCH_ITERATIONS 1000
+
+/** @brief Number of times the round trip benchmarks are measured. */
+#ifdef _TRACING_ENABLED
+#define BENCH_PASS_COUNT 2
+#else
+#define BENCH_PASS_COUNT 1
+#endif
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+static volatile uint32_t bench_int_count      = 0;
+static volatile uint32_t bench_fast_int_count = 0;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void bench_int_handler(kernel_thread_t* curr_thread)
+{
+    (void)curr_thread;
+
+    ++bench_int_count;
+}
+
+static void bench_fast_int_handler(kernel_thread_t* curr_thread)
+{
+    (void)curr_thread;
+
+    ++bench_fast_int_count;
+}
+
+/* The benchmarks run with interrupts disabled, the generic handler blocks the
+ * interrupts raised in this state. The round trips enable them around the
+ * raise only, an hardware interrupt pending at this point shows in the p99
+ * and max values.
+ */
+static void bench_int_roundtrip(void* args)
+{
+    (void)args;
+
+    _cpu_set_interrupt();
+    (void)cpu_raise_interrupt(BENCH_INT_LINE);
+    _cpu_clear_interrupt();
+}
+
+static void bench_fast_int_roundtrip(void* args)
+{
+    (void)args;
+
+    _cpu_set_interrupt();
+    (void)cpu_raise_interrupt(BENCH_FAST_INT_LINE);
+    _cpu_clear_interrupt();
+}
+
+/* Raised with interrupts disabled, the interrupt is blocked by the generic
+ * handler before the lookup: the entry spill and restore are measured alone.
+ */
+static void bench_int_entry_exit(void* args)
+{
+    (void)args;
+
+    (void)cpu_raise_interrupt(BENCH_INT_LINE);
+}
+
+static void bench_int_lookup(void* args)
+{
+    (void)args;
+
+    (void)kernel_interrupt_get_handler(BENCH_INT_LINE);
+}
+
+#ifdef _TRACING_ENABLED
+static void bench_set_tracing(const bool_t enabled)
+{
+    uint32_t i;
+
+    for(i = 0; i < TRACE_GROUP_COUNT; ++i)
+    {
+        kernel_trace_set_group((TRACE_GROUP_E)i, enabled);
+    }
+}
+#endif
+
+void interrupt_bench_test(void)
+{
+    OS_RETURN_E      err;
+    custom_handler_t handler;
+
+    err = kernel_interrupt_register_int_handler(BENCH_INT_LINE,
+                                                bench_int_handler);
+    TEST_POINT_ASSERT_RCODE(TEST_INTERRUPT_BENCH_REG_HANDLER0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_INTERRUPT_BENCH_ENABLED);
+
+    err = kernel_interrupt_register_fast_int_handler(BENCH_FAST_INT_LINE,
+                                                     bench_fast_int_handler);
+    TEST_POINT_ASSERT_RCODE(TEST_INTERRUPT_BENCH_REG_FAST_HANDLER0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_INTERRUPT_BENCH_ENABLED);
+
+    handler = kernel_interrupt_get_handler(BENCH_INT_LINE);
+    TEST_POINT_ASSERT_UDWORD(TEST_INTERRUPT_BENCH_GET_HANDLER0_ID,
+                             handler == bench_int_handler,
+                             (uint64_t)(uintptr_t)bench_int_handler,
+                             (uint64_t)(uintptr_t)handler,
+                             TEST_INTERRUPT_BENCH_ENABLED);
+
+#ifdef _TRACING_ENABLED
+    TEST_POINT_BENCH("int_roundtrip_traced", bench_int_roundtrip, NULL,
+                     BENCH_WARMUP, BENCH_ITERATIONS,
+                     TEST_INTERRUPT_BENCH_ENABLED);
+    TEST_POINT_BENCH("int_fast_roundtrip_traced", bench_fast_int_roundtrip,
+                     NULL, BENCH_WARMUP, BENCH_ITERATIONS,
+                     TEST_INTERRUPT_BENCH_ENABLED);
+    TEST_POINT_BENCH("int_entry_exit_traced", bench_int_entry_exit, NULL,
+                     BENCH_WARMUP, BENCH_ITERATIONS,
+                     TEST_INTERRUPT_BENCH_ENABLED);
+
+    TEST_FRAMEWORK_RUN_BENCH();
+
+    bench_set_tracing(FALSE);
+#endif
+
+    TEST_POINT_BENCH("int_roundtrip", bench_int_roundtrip, NULL,
+                     BENCH_WARMUP, BENCH_ITERATIONS,
+                     TEST_INTERRUPT_BENCH_ENABLED);
+    TEST_POINT_BENCH("int_fast_roundtrip", bench_fast_int_roundtrip, NULL,
+                     BENCH_WARMUP, BENCH_ITERATIONS,
+                     TEST_INTERRUPT_BENCH_ENABLED);
+    TEST_POINT_BENCH("int_entry_exit", bench_int_entry_exit, NULL,
+                     BENCH_WARMUP, BENCH_ITERATIONS,
+                     TEST_INTERRUPT_BENCH_ENABLED);
+    TEST_POINT_BENCH("int_handler_lookup", bench_int_lookup, NULL,
+                     BENCH_WARMUP, BENCH_ITERATIONS,
+                     TEST_INTERRUPT_BENCH_ENABLED);
+
+    TEST_FRAMEWORK_RUN_BENCH();
+
+#ifdef _TRACING_ENABLED
+    bench_set_tracing(TRUE);
+#endif
+
+    /* Every round trip reached its handler */
+    TEST_POINT_ASSERT_UINT(TEST_INTERRUPT_BENCH_COUNT_CHECK0_ID,
+                           bench_int_count ==
+                           (BENCH_WARMUP + BENCH_ITERATIONS) *
+                           BENCH_PASS_COUNT &&
+                           bench_fast_int_count == bench_int_count,
+                           (BENCH_WARMUP + BENCH_ITERATIONS) *
+                           BENCH_PASS_COUNT,
+                           bench_int_count,
+                           TEST_INTERRUPT_BENCH_ENABLED);
+
+    err = kernel_interrupt_remove_int_handler(BENCH_INT_LINE);
+    TEST_POINT_ASSERT_RCODE(TEST_INTERRUPT_BENCH_REM_HANDLER0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_INTERRUPT_BENCH_ENABLED);
+
+    err = kernel_interrupt_remove_int_handler(BENCH_FAST_INT_LINE);
+    TEST_POINT_ASSERT_RCODE(TEST_INTERRUPT_BENCH_REM_FAST_HANDLER0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_INTERRUPT_BENCH_ENABLED);
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
@@ -29,6 +29,7 @@
 #include <panic.h>
 #include <kernel_output.h>
 #include <cpu.h>
+#include <scheduler.h>
 
 /* Configuration files */
 #include <config.h>
@@ -96,6 +97,17 @@ static void decrementer_handler(kernel_thread_t* curr_thread)
     }
 }
 
+static void fast_incrementer_handler(kernel_thread_t* curr_thread)
+{
+    /* The virtual CPU is not saved on the fast path */
+    (void)curr_thread;
+
+    if(counter < UINT32_MAX)
+    {
+        ++counter;
+    }
+}
+
 static void test_sw_interupts_lock(void)
 {
     OS_RETURN_E err;
@@ -848,10 +860,176 @@ static void test_sw_interupts(void)
     }
 }
 
+static void test_fast_interupts(void)
+{
+    OS_RETURN_E err;
+    uint32_t    cnt_val;
+
+    /* TEST REGISTER < MIN */
+    err = kernel_interrupt_register_fast_int_handler(MIN_INTERRUPT_LINE - 1,
+                                                     fast_incrementer_handler);
+    TEST_POINT_ASSERT_RCODE(TEST_INTERRUPT_FAST_REG_BAD_HANDLER0_ID,
+                            err == OR_ERR_UNAUTHORIZED_INTERRUPT_LINE,
+                            OR_ERR_UNAUTHORIZED_INTERRUPT_LINE,
+                            err,
+                            TEST_INTERRUPT_ENABLED);
+
+    /* TEST NULL HANDLER */
+    err = kernel_interrupt_register_fast_int_handler(MIN_INTERRUPT_LINE, NULL);
+    TEST_POINT_ASSERT_RCODE(TEST_INTERRUPT_FAST_REG_BAD_HANDLER1_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_INTERRUPT_ENABLED);
+
+    err = kernel_interrupt_register_fast_int_handler(MIN_INTERRUPT_LINE,
+                                                     fast_incrementer_handler);
+    TEST_POINT_ASSERT_RCODE(TEST_INTERRUPT_FAST_REG_HANDLER0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_INTERRUPT_ENABLED);
+
+    /* Interrupts enabled, the fast path is taken */
+    cnt_val = counter;
+    kernel_interrupt_restore(1);
+
+    __asm__ __volatile__("int %0" :: "i" (MIN_INTERRUPT_LINE));
+    __asm__ __volatile__("int %0" :: "i" (MIN_INTERRUPT_LINE));
+    __asm__ __volatile__("int %0" :: "i" (MIN_INTERRUPT_LINE));
+
+    TEST_POINT_ASSERT_UINT(TEST_INTERRUPT_FAST_COUNTER_CHECK0_ID,
+                           cnt_val + 3 == counter,
+                           cnt_val + 3,
+                           counter,
+                           TEST_INTERRUPT_ENABLED);
+
+    /* Interrupts disabled, the generic handler blocks the interrupt */
+    cnt_val = counter;
+    kernel_interrupt_disable();
+
+    __asm__ __volatile__("int %0" :: "i" (MIN_INTERRUPT_LINE));
+
+    TEST_POINT_ASSERT_UINT(TEST_INTERRUPT_FAST_COUNTER_CHECK1_ID,
+                           cnt_val == counter,
+                           cnt_val,
+                           counter,
+                           TEST_INTERRUPT_ENABLED);
+
+    err = kernel_interrupt_remove_int_handler(MIN_INTERRUPT_LINE);
+    TEST_POINT_ASSERT_RCODE(TEST_INTERRUPT_FAST_REM_HANDLER0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_INTERRUPT_ENABLED);
+}
+
+static void test_interupts_stats(void)
+{
+    OS_RETURN_E       err;
+    interrupt_stats_t stats;
+    uint32_t          cpu_id;
+    uint32_t          histogram_count;
+    uint32_t          i;
+
+    kernel_interrupt_disable();
+    cpu_id = scheduler_get_current_cpu_id();
+
+    /* TEST NULL BUFFER */
+    err = kernel_interrupt_get_stats(cpu_id, MIN_INTERRUPT_LINE, NULL);
+    TEST_POINT_ASSERT_RCODE(TEST_INTERRUPT_STATS_BAD_PARAM0_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_INTERRUPT_ENABLED);
+
+    /* TEST BAD CPU */
+    err = kernel_interrupt_get_stats(MAX_CPU_COUNT, MIN_INTERRUPT_LINE, &stats);
+    TEST_POINT_ASSERT_RCODE(TEST_INTERRUPT_STATS_BAD_PARAM1_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_INTERRUPT_ENABLED);
+
+    /* TEST BAD LINE */
+    err = kernel_interrupt_get_stats(cpu_id, INT_ENTRY_COUNT, &stats);
+    TEST_POINT_ASSERT_RCODE(TEST_INTERRUPT_STATS_BAD_PARAM2_ID,
+                            err == OR_ERR_UNAUTHORIZED_INTERRUPT_LINE,
+                            OR_ERR_UNAUTHORIZED_INTERRUPT_LINE,
+                            err,
+                            TEST_INTERRUPT_ENABLED);
+
+    err = kernel_interrupt_register_int_handler(MIN_INTERRUPT_LINE,
+                                                fast_incrementer_handler);
+    TEST_POINT_ASSERT_RCODE(TEST_INTERRUPT_STATS_REG_HANDLER0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_INTERRUPT_ENABLED);
+
+    kernel_interrupt_reset_stats();
+
+    __asm__ __volatile__("int %0" :: "i" (MIN_INTERRUPT_LINE));
+    __asm__ __volatile__("int %0" :: "i" (MIN_INTERRUPT_LINE));
+
+    err = kernel_interrupt_get_stats(cpu_id, MIN_INTERRUPT_LINE, &stats);
+    TEST_POINT_ASSERT_RCODE(TEST_INTERRUPT_STATS_GET0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_INTERRUPT_ENABLED);
+
+    /* The interrupts are blocked but the handler is not called */
+    TEST_POINT_ASSERT_UINT(TEST_INTERRUPT_STATS_COUNT_CHECK0_ID,
+                           stats.count == 0,
+                           0,
+                           (uint32_t)stats.count,
+                           TEST_INTERRUPT_ENABLED);
+
+    kernel_interrupt_restore(1);
+
+    __asm__ __volatile__("int %0" :: "i" (MIN_INTERRUPT_LINE));
+    __asm__ __volatile__("int %0" :: "i" (MIN_INTERRUPT_LINE));
+
+    kernel_interrupt_disable();
+
+    err = kernel_interrupt_get_stats(cpu_id, MIN_INTERRUPT_LINE, &stats);
+    histogram_count = 0;
+    for(i = 0; i < INTERRUPT_STATS_HISTOGRAM_SIZE; ++i)
+    {
+        histogram_count += stats.histogram[i];
+    }
+    TEST_POINT_ASSERT_UINT(TEST_INTERRUPT_STATS_HISTOGRAM_CHECK0_ID,
+                           err == OS_NO_ERR && stats.count == 2 &&
+                           histogram_count == 2,
+                           2,
+                           histogram_count,
+                           TEST_INTERRUPT_ENABLED);
+
+    kernel_interrupt_reset_stats();
+
+    err = kernel_interrupt_get_stats(cpu_id, MIN_INTERRUPT_LINE, &stats);
+    TEST_POINT_ASSERT_UINT(TEST_INTERRUPT_STATS_RESET_CHECK0_ID,
+                           err == OS_NO_ERR && stats.count == 0 &&
+                           stats.cycles == 0,
+                           0,
+                           (uint32_t)stats.count,
+                           TEST_INTERRUPT_ENABLED);
+
+    err = kernel_interrupt_remove_int_handler(MIN_INTERRUPT_LINE);
+    TEST_POINT_ASSERT_RCODE(TEST_INTERRUPT_STATS_REM_HANDLER0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_INTERRUPT_ENABLED);
+}
+
 void interrupt_test(void)
 {
     test_sw_interupts();
     test_sw_interupts_lock();
+    test_fast_interupts();
+    test_interupts_stats();
 
     TEST_FRAMEWORK_END();
 }
@@ -0,0 +1,538 @@
+/*******************************************************************************
+ * @file ioring_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework asynchronous I/O rings testing.
+ *
+ * @details Testing framework asynchronous I/O rings testing. Checks the
+ * parameters validation, then round-trips entries through the submission and
+ * completion rings: no-operations over several laps of the rings, a target
+ * completing during the submission, a target completing from another thread
+ * while the owner waits, and a target completed by the polling of the owner.
+ * Finally checks that a ring is not released while its entries are in use.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <string.h>
+#include <ioring.h>
+#include <scheduler.h>
+#include <semaphore.h>
+#include <cpu_interrupt.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of entries of the tested rings. */
+#define TEST_IORING_ENTRIES 8
+
+/** @brief Number of laps of the no-operations over the rings. */
+#define TEST_IORING_LAPS 3
+
+/** @brief Size of the buffers read from the tested targets. */
+#define TEST_IORING_BUFFER_SIZE 16
+
+/** @brief Value of the bytes read from the tested targets. */
+#define TEST_IORING_PATTERN 0x5A
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Driver of the tested targets. */
+typedef struct
+{
+    /** @brief The requests waiting to be completed. */
+    ioring_request_t* pending[TEST_IORING_ENTRIES];
+
+    /** @brief The number of requests waiting to be completed. */
+    uint32_t pending_count;
+
+    /** @brief Posted when the completing thread is done. */
+    semaphore_t done;
+} test_ioring_driver_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The tested ring. */
+static ioring_t test_ring;
+
+/** @brief The tested target driver. */
+static test_ioring_driver_t test_driver;
+
+/** @brief The buffers read from the tested targets. */
+static uint8_t test_buffers[TEST_IORING_ENTRIES][TEST_IORING_BUFFER_SIZE];
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void test_ioring_read(ioring_request_t* request)
+{
+    memset(request->sqe.buffer, TEST_IORING_PATTERN, request->sqe.size);
+    ioring_complete(request, OS_NO_ERR, request->sqe.size);
+}
+
+static OS_RETURN_E test_ioring_sync_submit(ioring_target_t* target,
+                                           ioring_request_t* request)
+{
+    (void)target;
+
+    if(request->sqe.opcode != IORING_OP_READ)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    test_ioring_read(request);
+
+    return OS_NO_ERR;
+}
+
+static OS_RETURN_E test_ioring_deferred_submit(ioring_target_t* target,
+                                               ioring_request_t* request)
+{
+    test_ioring_driver_t* driver;
+
+    driver = target->driver_ctrl;
+    driver->pending[driver->pending_count++] = request;
+
+    return OS_NO_ERR;
+}
+
+static void test_ioring_poll(ioring_target_t* target)
+{
+    test_ioring_driver_t* driver;
+    uint32_t              i;
+
+    /* Each poll completes the oldest pending request */
+    driver = target->driver_ctrl;
+    if(driver->pending_count != 0)
+    {
+        test_ioring_read(driver->pending[0]);
+        --driver->pending_count;
+        for(i = 0; i < driver->pending_count; ++i)
+        {
+            driver->pending[i] = driver->pending[i + 1];
+        }
+    }
+}
+
+static void* test_ioring_complete_routine(void* args)
+{
+    test_ioring_driver_t* driver;
+    uint32_t              i;
+
+    driver = args;
+    for(i = 0; i < driver->pending_count; ++i)
+    {
+        test_ioring_read(driver->pending[i]);
+    }
+    driver->pending_count = 0;
+
+    (void)semaphore_post(&driver->done);
+
+    return NULL;
+}
+
+static void test_ioring_params(void)
+{
+    OS_RETURN_E err;
+
+    err = ioring_init(NULL, TEST_IORING_ENTRIES, 0);
+    TEST_POINT_ASSERT_RCODE(TEST_IORING_INIT_NULL0_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_IORING_ENABLED);
+
+    err = ioring_init(&test_ring, TEST_IORING_ENTRIES - 1, 0);
+    TEST_POINT_ASSERT_RCODE(TEST_IORING_INIT_NOT_POW20_ID,
+                            err == OS_ERR_OUT_OF_BOUND,
+                            OS_ERR_OUT_OF_BOUND,
+                            err,
+                            TEST_IORING_ENABLED);
+
+    err = ioring_init(&test_ring, IORING_MAX_ENTRIES * 2, 0);
+    TEST_POINT_ASSERT_RCODE(TEST_IORING_INIT_TOO_BIG0_ID,
+                            err == OS_ERR_OUT_OF_BOUND,
+                            OS_ERR_OUT_OF_BOUND,
+                            err,
+                            TEST_IORING_ENABLED);
+
+    err = ioring_init(&test_ring, 0, 0);
+    TEST_POINT_ASSERT_RCODE(TEST_IORING_INIT_EMPTY0_ID,
+                            err == OS_ERR_OUT_OF_BOUND,
+                            OS_ERR_OUT_OF_BOUND,
+                            err,
+                            TEST_IORING_ENABLED);
+}
+
+static void test_ioring_nop(void)
+{
+    OS_RETURN_E   err;
+    ioring_sqe_t* sqe;
+    ioring_cqe_t  cqe;
+    uint32_t      lap;
+    uint32_t      count;
+    uint32_t      i;
+    bool_t        valid;
+
+    /* The laps wrap the indexes of the rings */
+    valid = TRUE;
+    count = 0;
+    for(lap = 0; lap < TEST_IORING_LAPS && valid == TRUE; ++lap)
+    {
+        for(i = 0; i < TEST_IORING_ENTRIES; ++i)
+        {
+            sqe            = ioring_get_sqe(&test_ring);
+            sqe->opcode    = IORING_OP_NOP;
+            sqe->target    = NULL;
+            sqe->user_data = lap * TEST_IORING_ENTRIES + i;
+        }
+        if(ioring_get_sqe(&test_ring) != NULL)
+        {
+            valid = FALSE;
+        }
+
+        count += ioring_submit(&test_ring);
+
+        /* The completions are reaped in the submission order */
+        for(i = 0; i < TEST_IORING_ENTRIES; ++i)
+        {
+            if(ioring_get_cqe(&test_ring, &cqe) == FALSE ||
+               cqe.user_data != lap * TEST_IORING_ENTRIES + i ||
+               cqe.status != OS_NO_ERR || cqe.size != 0)
+            {
+                valid = FALSE;
+            }
+        }
+        if(ioring_get_cqe(&test_ring, &cqe) == TRUE)
+        {
+            valid = FALSE;
+        }
+    }
+    TEST_POINT_ASSERT_UINT(TEST_IORING_NOP_SUBMIT0_ID,
+                           count == TEST_IORING_LAPS * TEST_IORING_ENTRIES,
+                           TEST_IORING_LAPS * TEST_IORING_ENTRIES,
+                           count,
+                           TEST_IORING_ENABLED);
+    TEST_POINT_ASSERT_UINT(TEST_IORING_NOP_CQE0_ID,
+                           valid == TRUE,
+                           TRUE,
+                           valid,
+                           TEST_IORING_ENABLED);
+
+    /* Waiting without any submitted operation would never return */
+    err = ioring_wait_cqe(&test_ring, &cqe);
+    TEST_POINT_ASSERT_RCODE(TEST_IORING_WAIT_IDLE0_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_IORING_ENABLED);
+}
+
+static void test_ioring_sync(void)
+{
+    ioring_target_t target;
+    ioring_sqe_t*   sqe;
+    ioring_cqe_t    cqe;
+    bool_t          valid;
+
+    target.name        = "ioring_test_sync";
+    target.submit      = test_ioring_sync_submit;
+    target.poll        = NULL;
+    target.driver_ctrl = NULL;
+
+    memset(test_buffers, 0, sizeof(test_buffers));
+
+    /* A read, an operation the target refuses and an entry without target */
+    sqe            = ioring_get_sqe(&test_ring);
+    sqe->opcode    = IORING_OP_READ;
+    sqe->target    = &target;
+    sqe->buffer    = test_buffers[0];
+    sqe->size      = TEST_IORING_BUFFER_SIZE;
+    sqe->offset    = 0;
+    sqe->user_data = 0;
+
+    sqe            = ioring_get_sqe(&test_ring);
+    sqe->opcode    = IORING_OP_WRITE;
+    sqe->target    = &target;
+    sqe->buffer    = test_buffers[1];
+    sqe->size      = TEST_IORING_BUFFER_SIZE;
+    sqe->offset    = 0;
+    sqe->user_data = 1;
+
+    sqe            = ioring_get_sqe(&test_ring);
+    sqe->opcode    = IORING_OP_READ;
+    sqe->target    = NULL;
+    sqe->buffer    = test_buffers[2];
+    sqe->size      = TEST_IORING_BUFFER_SIZE;
+    sqe->offset    = 0;
+    sqe->user_data = 2;
+
+    (void)ioring_submit(&test_ring);
+
+    valid = ioring_get_cqe(&test_ring, &cqe) == TRUE &&
+            cqe.user_data == 0 && cqe.status == OS_NO_ERR &&
+            cqe.size == TEST_IORING_BUFFER_SIZE &&
+            test_buffers[0][0] == TEST_IORING_PATTERN &&
+            test_buffers[0][TEST_IORING_BUFFER_SIZE - 1] ==
+            TEST_IORING_PATTERN;
+    TEST_POINT_ASSERT_UINT(TEST_IORING_SYNC_READ0_ID,
+                           valid == TRUE,
+                           TRUE,
+                           valid,
+                           TEST_IORING_ENABLED);
+
+    valid = ioring_get_cqe(&test_ring, &cqe) == TRUE &&
+            cqe.user_data == 1 && cqe.size == 0 &&
+            test_buffers[1][0] == 0;
+    TEST_POINT_ASSERT_RCODE(TEST_IORING_SYNC_REFUSED0_ID,
+                            valid == TRUE &&
+                            cqe.status == OS_ERR_NOT_SUPPORTED,
+                            OS_ERR_NOT_SUPPORTED,
+                            cqe.status,
+                            TEST_IORING_ENABLED);
+
+    valid = ioring_get_cqe(&test_ring, &cqe) == TRUE &&
+            cqe.user_data == 2 && cqe.size == 0;
+    TEST_POINT_ASSERT_RCODE(TEST_IORING_SYNC_NO_TARGET0_ID,
+                            valid == TRUE &&
+                            cqe.status == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            cqe.status,
+                            TEST_IORING_ENABLED);
+}
+
+static void test_ioring_submit_reads(ioring_t* ring, ioring_target_t* target)
+{
+    ioring_sqe_t* sqe;
+    uint32_t      i;
+
+    memset(test_buffers, 0, sizeof(test_buffers));
+    for(i = 0; i < TEST_IORING_ENTRIES; ++i)
+    {
+        sqe            = ioring_get_sqe(ring);
+        sqe->opcode    = IORING_OP_READ;
+        sqe->target    = target;
+        sqe->buffer    = test_buffers[i];
+        sqe->size      = TEST_IORING_BUFFER_SIZE;
+        sqe->offset    = (uint64_t)i * TEST_IORING_BUFFER_SIZE;
+        sqe->user_data = i;
+    }
+    (void)ioring_submit(ring);
+}
+
+static bool_t test_ioring_wait_reads(ioring_t* ring)
+{
+    ioring_cqe_t cqe;
+    uint32_t     i;
+    bool_t       valid;
+
+    /* The target completes in the submission order */
+    valid = TRUE;
+    for(i = 0; i < TEST_IORING_ENTRIES; ++i)
+    {
+        if(ioring_wait_cqe(ring, &cqe) != OS_NO_ERR ||
+           cqe.user_data != i || cqe.status != OS_NO_ERR ||
+           cqe.size != TEST_IORING_BUFFER_SIZE ||
+           test_buffers[i][TEST_IORING_BUFFER_SIZE - 1] !=
+           TEST_IORING_PATTERN)
+        {
+            valid = FALSE;
+        }
+    }
+
+    return valid;
+}
+
+static void test_ioring_deferred(void)
+{
+    OS_RETURN_E      err;
+    ioring_target_t  target;
+    kernel_thread_t* thread;
+    bool_t           valid;
+
+    target.name        = "ioring_test_deferred";
+    target.submit      = test_ioring_deferred_submit;
+    target.poll        = NULL;
+    target.driver_ctrl = &test_driver;
+
+    test_driver.pending_count = 0;
+    err = semaphore_init(&test_driver.done, 0);
+    if(err == OS_NO_ERR)
+    {
+        test_ioring_submit_reads(&test_ring, &target);
+
+        /* The owner waits for the completions of the thread */
+        err = scheduler_create_kernel_thread(&thread,
+                                             scheduler_get_current_thread()->
+                                             priority,
+                                             "ioring_test",
+                                             test_ioring_complete_routine,
+                                             &test_driver);
+        if(err != OS_NO_ERR)
+        {
+            /* Completes the pending requests, the ring must be reaped */
+            (void)test_ioring_complete_routine(&test_driver);
+        }
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_IORING_DEFERRED_THREAD0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_IORING_ENABLED);
+
+    valid = test_ioring_wait_reads(&test_ring);
+    if(err == OS_NO_ERR)
+    {
+        err = semaphore_wait(&test_driver.done);
+    }
+    TEST_POINT_ASSERT_UINT(TEST_IORING_DEFERRED_CQE0_ID,
+                           valid == TRUE && err == OS_NO_ERR,
+                           TRUE,
+                           valid,
+                           TEST_IORING_ENABLED);
+}
+
+static void test_ioring_polled(void)
+{
+    OS_RETURN_E     err;
+    ioring_t        ring;
+    ioring_target_t target;
+    bool_t          valid;
+
+    target.name        = "ioring_test_polled";
+    target.submit      = test_ioring_deferred_submit;
+    target.poll        = test_ioring_poll;
+    target.driver_ctrl = &test_driver;
+
+    test_driver.pending_count = 0;
+
+    err = ioring_init(&ring, TEST_IORING_ENTRIES, IORING_FLAG_POLL);
+    TEST_POINT_ASSERT_RCODE(TEST_IORING_POLL_INIT0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_IORING_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+
+    /* The owner polls the target while it waits */
+    test_ioring_submit_reads(&ring, &target);
+    valid = test_ioring_wait_reads(&ring);
+    TEST_POINT_ASSERT_UINT(TEST_IORING_POLL_CQE0_ID,
+                           valid == TRUE && test_driver.pending_count == 0,
+                           TRUE,
+                           valid,
+                           TEST_IORING_ENABLED);
+
+    err = ioring_destroy(&ring);
+    TEST_POINT_ASSERT_RCODE(TEST_IORING_POLL_DESTROY0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_IORING_ENABLED);
+}
+
+static void test_ioring_destroy(void)
+{
+    OS_RETURN_E   err;
+    ioring_sqe_t* sqe;
+    ioring_cqe_t  cqe;
+
+    /* A reserved entry keeps the ring in use until it is reaped */
+    sqe            = ioring_get_sqe(&test_ring);
+    sqe->opcode    = IORING_OP_NOP;
+    sqe->target    = NULL;
+    sqe->user_data = 0;
+
+    err = ioring_destroy(&test_ring);
+    TEST_POINT_ASSERT_RCODE(TEST_IORING_DESTROY_BUSY0_ID,
+                            err == OS_ERR_RESOURCE_BUSY,
+                            OS_ERR_RESOURCE_BUSY,
+                            err,
+                            TEST_IORING_ENABLED);
+
+    (void)ioring_submit(&test_ring);
+    (void)ioring_get_cqe(&test_ring, &cqe);
+
+    err = ioring_destroy(&test_ring);
+    TEST_POINT_ASSERT_RCODE(TEST_IORING_DESTROY0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_IORING_ENABLED);
+}
+
+void ioring_test(void)
+{
+    OS_RETURN_E err;
+
+    test_ioring_params();
+
+    err = ioring_init(&test_ring, TEST_IORING_ENTRIES, 0);
+    TEST_POINT_ASSERT_RCODE(TEST_IORING_INIT0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_IORING_ENABLED);
+    if(err == OS_NO_ERR)
+    {
+        test_ioring_nop();
+        test_ioring_sync();
+        test_ioring_deferred();
+        test_ioring_destroy();
+    }
+    test_ioring_polled();
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
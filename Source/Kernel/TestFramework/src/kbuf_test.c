@@ -0,0 +1,318 @@
+/*******************************************************************************
+ * @file kbuf_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework chained buffers testing.
+ *
+ * @details Testing framework chained buffers testing. Grows a buffer in its
+ * storage and its headroom, then slices it: the slice shares the storage
+ * without copy and the storage cannot be written with kbuf_put or kbuf_push
+ * until the slice is released. Finally chains an attached read-only area to
+ * the buffer, slices across the two segments and checks that the area is
+ * released with the last segment referencing it.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <string.h>
+#include <kbuf.h>
+#include <cpu_interrupt.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Size of the tested buffer storage after the headroom. */
+#define TEST_KBUF_SIZE 64
+
+/** @brief Size of the tested buffer headroom. */
+#define TEST_KBUF_HEADROOM 16
+
+/** @brief Size of the data written in the tested buffer. */
+#define TEST_KBUF_DATA_SIZE 32
+
+/** @brief Size of the header pushed in the tested buffer headroom. */
+#define TEST_KBUF_HEADER_SIZE 8
+
+/** @brief Size of the attached area. */
+#define TEST_KBUF_AREA_SIZE 16
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The attached area. */
+static const uint8_t test_kbuf_area[TEST_KBUF_AREA_SIZE] = {
+    0xF0, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7,
+    0xF8, 0xF9, 0xFA, 0xFB, 0xFC, 0xFD, 0xFE, 0xFF
+};
+
+/** @brief Number of calls to the attached area release callback. */
+static uint32_t test_kbuf_releases;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void test_kbuf_release(const void* data, void* args)
+{
+    (void)args;
+
+    if(data == test_kbuf_area)
+    {
+        ++test_kbuf_releases;
+    }
+}
+
+static kbuf_t* test_kbuf_grow(void)
+{
+    kbuf_t*  buf;
+    uint8_t* data;
+    uint8_t* header;
+    uint32_t i;
+
+    buf  = kbuf_alloc(TEST_KBUF_SIZE, TEST_KBUF_HEADROOM);
+    data = NULL;
+    if(buf != NULL)
+    {
+        data = kbuf_put(buf, TEST_KBUF_DATA_SIZE);
+    }
+    TEST_POINT_ASSERT_UDWORD(TEST_KBUF_PUT0_ID,
+                             data != NULL &&
+                             kbuf_length(buf) == TEST_KBUF_DATA_SIZE,
+                             TEST_KBUF_DATA_SIZE,
+                             (uint64_t)kbuf_length(buf),
+                             TEST_KBUF_ENABLED);
+    if(data == NULL)
+    {
+        kbuf_free(buf);
+        return NULL;
+    }
+    for(i = 0; i < TEST_KBUF_DATA_SIZE; ++i)
+    {
+        data[i] = (uint8_t)i;
+    }
+
+    /* The header is prepended in the headroom */
+    header = kbuf_push(buf, TEST_KBUF_HEADER_SIZE);
+    TEST_POINT_ASSERT_UDWORD(TEST_KBUF_PUSH0_ID,
+                             header == data - TEST_KBUF_HEADER_SIZE,
+                             (uint64_t)(uintptr_t)
+                             (data - TEST_KBUF_HEADER_SIZE),
+                             (uint64_t)(uintptr_t)header,
+                             TEST_KBUF_ENABLED);
+    if(header != NULL)
+    {
+        memset(header, 0xAB, TEST_KBUF_HEADER_SIZE);
+    }
+
+    /* The storage and the headroom cannot grow */
+    TEST_POINT_ASSERT_UINT(TEST_KBUF_BOUNDS0_ID,
+                           kbuf_push(buf, TEST_KBUF_HEADROOM -
+                                          TEST_KBUF_HEADER_SIZE + 1) ==
+                           NULL &&
+                           kbuf_put(buf, TEST_KBUF_SIZE -
+                                         TEST_KBUF_DATA_SIZE + 1) == NULL,
+                           TEST_KBUF_DATA_SIZE + TEST_KBUF_HEADER_SIZE,
+                           (uint32_t)kbuf_length(buf),
+                           TEST_KBUF_ENABLED);
+
+    return buf;
+}
+
+static void test_kbuf_shared(kbuf_t* buf)
+{
+    kbuf_t*  slice;
+    uint8_t  copy[TEST_KBUF_DATA_SIZE];
+    uint32_t i;
+    bool_t   valid;
+
+    /* The slice views the data written in the storage */
+    slice = kbuf_slice(buf, TEST_KBUF_HEADER_SIZE, TEST_KBUF_DATA_SIZE);
+    valid = slice != NULL &&
+            slice->storage == buf->storage &&
+            buf->storage->refcount == 2 &&
+            kbuf_copy_out(slice, 0, copy, sizeof(copy)) == sizeof(copy);
+    for(i = 0; i < TEST_KBUF_DATA_SIZE && valid == TRUE; ++i)
+    {
+        valid = copy[i] == (uint8_t)i;
+    }
+    TEST_POINT_ASSERT_UINT(TEST_KBUF_SLICE0_ID,
+                           valid == TRUE,
+                           TRUE,
+                           valid,
+                           TEST_KBUF_ENABLED);
+    if(slice == NULL)
+    {
+        return;
+    }
+
+    /* The shared storage cannot be written by either buffer */
+    TEST_POINT_ASSERT_UINT(TEST_KBUF_SHARED_PUT0_ID,
+                           kbuf_put(buf, 1) == NULL &&
+                           kbuf_put(slice, 1) == NULL,
+                           TRUE,
+                           FALSE,
+                           TEST_KBUF_ENABLED);
+    TEST_POINT_ASSERT_UINT(TEST_KBUF_SHARED_PUSH0_ID,
+                           kbuf_push(buf, 1) == NULL &&
+                           kbuf_push(slice, 1) == NULL,
+                           TRUE,
+                           FALSE,
+                           TEST_KBUF_ENABLED);
+
+    TEST_POINT_ASSERT_UDWORD(TEST_KBUF_SLICE_BOUNDS0_ID,
+                             kbuf_slice(buf, TEST_KBUF_HEADER_SIZE,
+                                        TEST_KBUF_DATA_SIZE + 1) == NULL,
+                             TRUE,
+                             FALSE,
+                             TEST_KBUF_ENABLED);
+
+    /* The released slice gives the storage back to the buffer */
+    kbuf_free(slice);
+    TEST_POINT_ASSERT_UINT(TEST_KBUF_EXCLUSIVE0_ID,
+                           buf->storage->refcount == 1 &&
+                           kbuf_put(buf, 1) != NULL &&
+                           kbuf_push(buf, 1) != NULL,
+                           1,
+                           buf->storage->refcount,
+                           TEST_KBUF_ENABLED);
+    (void)kbuf_trim(buf, TEST_KBUF_DATA_SIZE + TEST_KBUF_HEADER_SIZE + 1);
+    (void)kbuf_pull(buf, 1);
+}
+
+static void test_kbuf_chain(kbuf_t* buf)
+{
+    OS_RETURN_E    err;
+    kbuf_t*        area;
+    kbuf_t*        slice;
+    kbuf_segment_t segments[2];
+    uint8_t        copy[2];
+    uint32_t       count;
+
+    test_kbuf_releases = 0;
+    area = kbuf_attach(test_kbuf_area, sizeof(test_kbuf_area),
+                       test_kbuf_release, NULL);
+    err  = kbuf_append(buf, area);
+    TEST_POINT_ASSERT_RCODE(TEST_KBUF_APPEND0_ID,
+                            err == OS_NO_ERR &&
+                            kbuf_length(buf) == TEST_KBUF_HEADER_SIZE +
+                                                TEST_KBUF_DATA_SIZE +
+                                                TEST_KBUF_AREA_SIZE,
+                            OS_NO_ERR,
+                            err,
+                            TEST_KBUF_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        kbuf_free(area);
+        kbuf_free(buf);
+        return;
+    }
+
+    count = kbuf_get_segments(buf, segments, 2);
+    TEST_POINT_ASSERT_UINT(TEST_KBUF_SEGMENTS0_ID,
+                           count == 2 &&
+                           segments[1].address == test_kbuf_area &&
+                           segments[1].size == TEST_KBUF_AREA_SIZE,
+                           2,
+                           count,
+                           TEST_KBUF_ENABLED);
+
+    /* The attached area is read-only */
+    TEST_POINT_ASSERT_UDWORD(TEST_KBUF_ATTACHED_PUT0_ID,
+                             kbuf_put(buf, 1) == NULL,
+                             TRUE,
+                             FALSE,
+                             TEST_KBUF_ENABLED);
+
+    /* The slice across the segments holds the last written byte and the
+     * first attached byte
+     */
+    slice = kbuf_slice(buf, TEST_KBUF_HEADER_SIZE + TEST_KBUF_DATA_SIZE - 1,
+                       2);
+    TEST_POINT_ASSERT_UINT(TEST_KBUF_SLICE_CHAIN0_ID,
+                           slice != NULL &&
+                           kbuf_copy_out(slice, 0, copy, 2) == 2 &&
+                           copy[0] == TEST_KBUF_DATA_SIZE - 1 &&
+                           copy[1] == test_kbuf_area[0],
+                           TRUE,
+                           slice != NULL,
+                           TEST_KBUF_ENABLED);
+
+    /* The area is released with the last segment referencing it */
+    kbuf_free(buf);
+    TEST_POINT_ASSERT_UINT(TEST_KBUF_RELEASE0_ID,
+                           test_kbuf_releases == 0,
+                           0,
+                           test_kbuf_releases,
+                           TEST_KBUF_ENABLED);
+    kbuf_free(slice);
+    TEST_POINT_ASSERT_UINT(TEST_KBUF_RELEASE1_ID,
+                           test_kbuf_releases == 1,
+                           1,
+                           test_kbuf_releases,
+                           TEST_KBUF_ENABLED);
+}
+
+void kbuf_test(void)
+{
+    kbuf_t* buf;
+
+    buf = test_kbuf_grow();
+    if(buf != NULL)
+    {
+        test_kbuf_shared(buf);
+        test_kbuf_chain(buf);
+    }
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
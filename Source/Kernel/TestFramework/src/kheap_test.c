@@ -0,0 +1,388 @@
+/*******************************************************************************
+ * @file kheap_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework kernel heap testing.
+ *
+ * @details Testing framework kernel heap testing. Allocates objects of every
+ * size class and checks their alignment and that they do not overlap, then
+ * checks the large allocations served as page runs. Finally releases objects
+ * from another thread: the objects fill and flush the magazine of the CPU
+ * running the thread, it serves back the last released object, and the
+ * objects are allocated again by the testing thread.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <string.h>
+#include <kheap.h>
+#include <cpu.h>
+#include <scheduler.h>
+#include <semaphore.h>
+#include <cpu_interrupt.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of slab size classes. */
+#define TEST_KHEAP_CLASS_COUNT 8
+
+/** @brief Size of the smallest slab size class, each class doubles it. */
+#define TEST_KHEAP_MIN_CLASS_SIZE 16
+
+/** @brief Size of the heap pages. */
+#define TEST_KHEAP_PAGE_SIZE 0x1000
+
+/** @brief Size of the tested large allocations, served with 4 pages. */
+#define TEST_KHEAP_LARGE_SIZE (TEST_KHEAP_PAGE_SIZE * 3 + 1)
+
+/** @brief Number of objects released by another CPU, enough to fill and
+ * flush its magazine several times.
+ */
+#define TEST_KHEAP_CROSS_COUNT 64
+
+/** @brief Size of the objects released by another CPU. */
+#define TEST_KHEAP_CROSS_SIZE 64
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Objects released by the remote thread. */
+typedef struct
+{
+    /** @brief The objects allocated by the testing CPU. */
+    void* objects[TEST_KHEAP_CROSS_COUNT];
+
+    /** @brief The object the remote thread allocated after the releases. */
+    void* reused;
+
+    /** @brief The CPU the remote thread released the objects on. */
+    uint32_t cpu_id;
+
+    /** @brief Posted when the remote thread is done. */
+    semaphore_t done;
+} test_kheap_cross_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The objects released by the remote thread. */
+static test_kheap_cross_t cross_data;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void test_kheap_classes(void)
+{
+    void*    object;
+    void*    small;
+    uint8_t* bytes;
+    size_t   class_size;
+    uint32_t class_count;
+    bool_t   valid;
+
+    object = kmalloc(0);
+    TEST_POINT_ASSERT_UDWORD(TEST_KHEAP_ALLOC_ZERO0_ID,
+                             object == NULL,
+                             0,
+                             (uint64_t)(uintptr_t)object,
+                             TEST_KHEAP_ENABLED);
+
+    /* Each class serves the sizes above the previous class size */
+    valid = TRUE;
+    for(class_count = 0; class_count < TEST_KHEAP_CLASS_COUNT; ++class_count)
+    {
+        class_size = TEST_KHEAP_MIN_CLASS_SIZE << class_count;
+        object     = kmalloc(class_size);
+        small      = kmalloc(class_size / 2 + 1);
+        if(object == NULL || small == NULL ||
+           ((uintptr_t)object & (class_size - 1)) != 0 ||
+           ((uintptr_t)small & (class_size - 1)) != 0 ||
+           object == small)
+        {
+            valid = FALSE;
+        }
+        else
+        {
+            /* The objects do not overlap */
+            memset(object, 0xA5, class_size);
+            memset(small, 0x5A, class_size);
+            bytes = object;
+            if(bytes[0] != 0xA5 || bytes[class_size - 1] != 0xA5)
+            {
+                valid = FALSE;
+            }
+        }
+        kfree(small);
+        kfree(object);
+
+        TEST_POINT_ASSERT_UINT(TEST_KHEAP_CLASS0_ID + class_count,
+                               valid == TRUE,
+                               TRUE,
+                               valid,
+                               TEST_KHEAP_ENABLED);
+        if(valid == FALSE)
+        {
+            break;
+        }
+    }
+    TEST_POINT_ASSERT_UINT(TEST_KHEAP_CLASS_COUNT0_ID,
+                           class_count == TEST_KHEAP_CLASS_COUNT,
+                           TEST_KHEAP_CLASS_COUNT,
+                           class_count,
+                           TEST_KHEAP_ENABLED);
+}
+
+static void test_kheap_large(void)
+{
+    uint8_t* first;
+    uint8_t* second;
+    uint8_t* object;
+    size_t   distance;
+    bool_t   valid;
+
+    /* The allocations above the largest class are page runs */
+    first  = kmalloc(TEST_KHEAP_LARGE_SIZE);
+    second = kmalloc(TEST_KHEAP_LARGE_SIZE);
+    valid  = FALSE;
+    if(first != NULL && second != NULL)
+    {
+        distance = (first > second) ? (size_t)(first - second) :
+                                      (size_t)(second - first);
+        valid = ((uintptr_t)first & (TEST_KHEAP_PAGE_SIZE - 1)) == 0 &&
+                ((uintptr_t)second & (TEST_KHEAP_PAGE_SIZE - 1)) == 0 &&
+                distance >= TEST_KHEAP_PAGE_SIZE * 4;
+    }
+    TEST_POINT_ASSERT_UINT(TEST_KHEAP_LARGE0_ID,
+                           valid == TRUE,
+                           TRUE,
+                           valid,
+                           TEST_KHEAP_ENABLED);
+
+    if(valid == TRUE)
+    {
+        memset(first, 0xA5, TEST_KHEAP_LARGE_SIZE);
+        memset(second, 0x5A, TEST_KHEAP_LARGE_SIZE);
+        TEST_POINT_ASSERT_UINT(TEST_KHEAP_LARGE_WRITE0_ID,
+                               first[0] == 0xA5 &&
+                               first[TEST_KHEAP_LARGE_SIZE - 1] == 0xA5,
+                               0xA5,
+                               first[TEST_KHEAP_LARGE_SIZE - 1],
+                               TEST_KHEAP_ENABLED);
+    }
+    kfree(second);
+    kfree(first);
+
+    /* A run larger than the heap cannot be served */
+    object = kmalloc((size_t)-1);
+    TEST_POINT_ASSERT_UDWORD(TEST_KHEAP_LARGE_TOO_BIG0_ID,
+                             object == NULL,
+                             0,
+                             (uint64_t)(uintptr_t)object,
+                             TEST_KHEAP_ENABLED);
+}
+
+static void* test_kheap_cross_routine(void* args)
+{
+    test_kheap_cross_t* data;
+    uint32_t            i;
+
+    data = args;
+
+    /* Switching out moves the thread to the CPU of its affinity */
+    (void)scheduler_sleep(0);
+    data->cpu_id = scheduler_get_current_cpu_id();
+
+    /* The releases fill and flush the magazine of this CPU */
+    for(i = 0; i < TEST_KHEAP_CROSS_COUNT; ++i)
+    {
+        kfree(data->objects[i]);
+    }
+
+    /* The magazine serves back the last released object */
+    data->reused = kmalloc(TEST_KHEAP_CROSS_SIZE);
+    kfree(data->reused);
+
+    (void)semaphore_post(&data->done);
+
+    return NULL;
+}
+
+static void test_kheap_cross_cpu(void)
+{
+    OS_RETURN_E      err;
+    kernel_thread_t* current;
+    kernel_thread_t* thread;
+    uint32_t         cpu;
+    uint32_t         started;
+    uint32_t         i;
+    bool_t           valid;
+
+    valid = TRUE;
+    for(i = 0; i < TEST_KHEAP_CROSS_COUNT; ++i)
+    {
+        cross_data.objects[i] = kmalloc(TEST_KHEAP_CROSS_SIZE);
+        if(cross_data.objects[i] == NULL)
+        {
+            valid = FALSE;
+            break;
+        }
+    }
+    TEST_POINT_ASSERT_UINT(TEST_KHEAP_CROSS_ALLOC0_ID,
+                           valid == TRUE,
+                           TRUE,
+                           valid,
+                           TEST_KHEAP_ENABLED);
+    if(valid == FALSE)
+    {
+        while(i > 0)
+        {
+            kfree(cross_data.objects[--i]);
+        }
+        return;
+    }
+
+    /* The thread has the testing thread priority, both run in turn. With more
+     * than one CPU started, each thread is pinned to its own CPU.
+     */
+    current = scheduler_get_current_thread();
+    cpu     = scheduler_get_current_cpu_id();
+    started = cpu_get_started_count();
+    cross_data.cpu_id = cpu;
+    err = scheduler_set_thread_affinity(current, 1U << cpu);
+    if(err == OS_NO_ERR)
+    {
+        err = semaphore_init(&cross_data.done, 0);
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = scheduler_create_kernel_thread(&thread, current->priority,
+                                             "kheap_test",
+                                             test_kheap_cross_routine,
+                                             &cross_data);
+        if(err == OS_NO_ERR)
+        {
+            if(started > 1)
+            {
+                (void)scheduler_set_thread_affinity(thread,
+                                                    1U <<
+                                                    ((cpu + 1) % started));
+            }
+            err = semaphore_wait(&cross_data.done);
+        }
+    }
+    (void)scheduler_set_thread_affinity(current, SCHED_CPU_AFFINITY_ALL);
+    TEST_POINT_ASSERT_RCODE(TEST_KHEAP_CROSS_THREAD0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_KHEAP_ENABLED);
+    TEST_POINT_ASSERT_UINT(TEST_KHEAP_CROSS_CPU0_ID,
+                           started == 1 || cross_data.cpu_id != cpu,
+                           (cpu + 1) % started,
+                           cross_data.cpu_id,
+                           TEST_KHEAP_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        for(i = 0; i < TEST_KHEAP_CROSS_COUNT; ++i)
+        {
+            kfree(cross_data.objects[i]);
+        }
+        return;
+    }
+
+    TEST_POINT_ASSERT_UDWORD(TEST_KHEAP_CROSS_REUSE0_ID,
+                             cross_data.reused ==
+                             cross_data.objects[TEST_KHEAP_CROSS_COUNT - 1],
+                             (uint64_t)(uintptr_t)
+                             cross_data.objects[TEST_KHEAP_CROSS_COUNT - 1],
+                             (uint64_t)(uintptr_t)cross_data.reused,
+                             TEST_KHEAP_ENABLED);
+
+    /* The objects released remotely are allocated again by this CPU */
+    valid = TRUE;
+    for(i = 0; i < TEST_KHEAP_CROSS_COUNT; ++i)
+    {
+        cross_data.objects[i] = kmalloc(TEST_KHEAP_CROSS_SIZE);
+        if(cross_data.objects[i] == NULL ||
+           ((uintptr_t)cross_data.objects[i] &
+            (TEST_KHEAP_CROSS_SIZE - 1)) != 0)
+        {
+            valid = FALSE;
+        }
+        else
+        {
+            memset(cross_data.objects[i], (int)i, TEST_KHEAP_CROSS_SIZE);
+        }
+    }
+    for(i = 0; i < TEST_KHEAP_CROSS_COUNT; ++i)
+    {
+        if(cross_data.objects[i] != NULL &&
+           *(uint8_t*)cross_data.objects[i] != (uint8_t)i)
+        {
+            valid = FALSE;
+        }
+        kfree(cross_data.objects[i]);
+    }
+    TEST_POINT_ASSERT_UINT(TEST_KHEAP_CROSS_REALLOC0_ID,
+                           valid == TRUE,
+                           TRUE,
+                           valid,
+                           TEST_KHEAP_ENABLED);
+}
+
+void kheap_test(void)
+{
+    test_kheap_classes();
+    test_kheap_large();
+    test_kheap_cross_cpu();
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
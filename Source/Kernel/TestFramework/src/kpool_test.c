@@ -0,0 +1,233 @@
+/*******************************************************************************
+ * @file kpool_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework fixed-size objects pools testing.
+ *
+ * @details Testing framework fixed-size objects pools testing. Checks the
+ * parameters validation, then exhausts a pool with and without the CPUs
+ * caches: every object is served once, cache aligned and inside the pool
+ * storage, and the allocations fail once the pool is empty until an object is
+ * released.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <cpu.h>
+#include <kpool.h>
+#include <cpu_interrupt.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of objects of the tested pools. */
+#define TEST_KPOOL_CAPACITY 6
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/** @brief Objects of the tested pools, larger than a cache line. */
+typedef struct
+{
+    /** @brief The object content. */
+    uint8_t content[CPU_CACHE_LINE_SIZE + 1];
+} test_kpool_object_t;
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The tested pool. */
+static kpool_t test_pool;
+
+/** @brief The tested pool storage. */
+static KPOOL_STORAGE(test_pool_storage, test_kpool_object_t,
+                     TEST_KPOOL_CAPACITY);
+
+/** @brief The objects allocated from the tested pool. */
+static test_kpool_object_t* test_objects[TEST_KPOOL_CAPACITY];
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void test_kpool_params(void)
+{
+    OS_RETURN_E err;
+
+    err = kpool_init(NULL, test_pool_storage, sizeof(test_kpool_object_t),
+                     TEST_KPOOL_CAPACITY, FALSE);
+    TEST_POINT_ASSERT_RCODE(TEST_KPOOL_INIT_NULL0_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_KPOOL_ENABLED);
+
+    err = kpool_init(&test_pool, test_pool_storage + 1,
+                     sizeof(test_kpool_object_t), TEST_KPOOL_CAPACITY - 1,
+                     FALSE);
+    TEST_POINT_ASSERT_RCODE(TEST_KPOOL_INIT_UNALIGNED0_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_KPOOL_ENABLED);
+
+    err = kpool_init(&test_pool, test_pool_storage, sizeof(void*) - 1,
+                     TEST_KPOOL_CAPACITY, FALSE);
+    TEST_POINT_ASSERT_RCODE(TEST_KPOOL_INIT_SMALL0_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_KPOOL_ENABLED);
+
+    err = kpool_init(&test_pool, test_pool_storage,
+                     sizeof(test_kpool_object_t), 0, FALSE);
+    TEST_POINT_ASSERT_RCODE(TEST_KPOOL_INIT_EMPTY0_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_KPOOL_ENABLED);
+}
+
+static void test_kpool_exhaust(const uint32_t test_id,
+                               const bool_t cpu_cache)
+{
+    OS_RETURN_E          err;
+    test_kpool_object_t* object;
+    uint32_t             i;
+    uint32_t             j;
+    bool_t               valid;
+
+    /* The identifiers of the pass checks follow test_id */
+    err = KPOOL_INIT_TYPED(&test_pool, test_pool_storage, test_kpool_object_t,
+                           cpu_cache);
+    TEST_POINT_ASSERT_RCODE(test_id,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_KPOOL_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+
+    /* Each object is served once */
+    valid = TRUE;
+    for(i = 0; i < TEST_KPOOL_CAPACITY; ++i)
+    {
+        test_objects[i] = KPOOL_ALLOC(&test_pool, test_kpool_object_t);
+        if(test_objects[i] == NULL ||
+           kpool_contains(&test_pool, test_objects[i]) == FALSE ||
+           ((uintptr_t)test_objects[i] & (CPU_CACHE_LINE_SIZE - 1)) != 0)
+        {
+            valid = FALSE;
+            break;
+        }
+        for(j = 0; j < i; ++j)
+        {
+            if(test_objects[j] == test_objects[i])
+            {
+                valid = FALSE;
+            }
+        }
+    }
+    TEST_POINT_ASSERT_UINT(test_id + 1,
+                           valid == TRUE,
+                           TRUE,
+                           valid,
+                           TEST_KPOOL_ENABLED);
+    if(valid == FALSE)
+    {
+        return;
+    }
+
+    /* The pool is exhausted */
+    object = KPOOL_ALLOC(&test_pool, test_kpool_object_t);
+    TEST_POINT_ASSERT_UDWORD(test_id + 2,
+                             object == NULL,
+                             0,
+                             (uint64_t)(uintptr_t)object,
+                             TEST_KPOOL_ENABLED);
+
+    /* A released object is served again */
+    kpool_free(&test_pool, test_objects[0]);
+    object = KPOOL_ALLOC(&test_pool, test_kpool_object_t);
+    TEST_POINT_ASSERT_UDWORD(test_id + 3,
+                             object == test_objects[0],
+                             (uint64_t)(uintptr_t)test_objects[0],
+                             (uint64_t)(uintptr_t)object,
+                             TEST_KPOOL_ENABLED);
+
+    object = KPOOL_ALLOC(&test_pool, test_kpool_object_t);
+    TEST_POINT_ASSERT_UDWORD(test_id + 4,
+                             object == NULL,
+                             0,
+                             (uint64_t)(uintptr_t)object,
+                             TEST_KPOOL_ENABLED);
+
+    for(i = 0; i < TEST_KPOOL_CAPACITY; ++i)
+    {
+        kpool_free(&test_pool, test_objects[i]);
+    }
+}
+
+void kpool_test(void)
+{
+    test_kpool_params();
+    test_kpool_exhaust(TEST_KPOOL_INIT0_ID, FALSE);
+    test_kpool_exhaust(TEST_KPOOL_INIT1_ID, TRUE);
+
+    /* An object outside the storage does not belong to the pool */
+    TEST_POINT_ASSERT_UINT(TEST_KPOOL_CONTAINS0_ID,
+                           kpool_contains(&test_pool, &test_pool) == FALSE,
+                           FALSE,
+                           kpool_contains(&test_pool, &test_pool),
+                           TEST_KPOOL_ENABLED);
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,297 @@
+/*******************************************************************************
+ * @file kstack_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework threads stacks testing.
+ *
+ * @details Testing framework threads stacks testing. Allocates a stack and
+ * checks its bounds, its unmapped guard page and its committed top page.
+ * When the page faults are delivered on the fault stack, a page not
+ * committed yet is committed by kstack_handle_fault and by a first touch,
+ * while the guard page and the released stacks are refused. With the panic
+ * tests enabled, a write in the guard page must end in a kernel panic.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stddef.h>
+#include <kerror.h>
+#include <cpu.h>
+#include <critical.h>
+#include <vmm.h>
+#include <kstack.h>
+#include <cpu_interrupt.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Value written in the touched stack page. */
+#define TEST_KSTACK_MAGIC 0x5A
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Tells if a virtual page is mapped.
+ *
+ * @param[in] virt The virtual address of the page.
+ *
+ * @return TRUE if the page is mapped, FALSE otherwise.
+ */
+static bool_t _test_kstack_mapped(const uintptr_t virt);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static bool_t _test_kstack_mapped(const uintptr_t virt)
+{
+    uintptr_t phys;
+
+    return (vmm_get_physical(virt, &phys) == OS_NO_ERR);
+}
+
+static void test_kstack_alloc(void)
+{
+    OS_RETURN_E err;
+    uintptr_t   stack;
+    uintptr_t   low;
+    uintptr_t   high;
+    size_t      size;
+    bool_t      found;
+
+    err = kstack_alloc(NULL, &size);
+    TEST_POINT_ASSERT_RCODE(TEST_KSTACK_ALLOC_NULL0_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_KSTACK_ENABLED);
+
+    err = kstack_alloc(&stack, &size);
+    TEST_POINT_ASSERT_RCODE(TEST_KSTACK_ALLOC0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_KSTACK_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+
+    /* The stack fills its slot above the guard page */
+    TEST_POINT_ASSERT_UDWORD(TEST_KSTACK_SIZE0_ID,
+                             size == KERNEL_THREAD_STACK_SIZE -
+                                     VMM_PAGE_SIZE &&
+                             ((stack - VMM_PAGE_SIZE) &
+                              (KERNEL_THREAD_STACK_SIZE - 1)) == 0,
+                             (uint64_t)(KERNEL_THREAD_STACK_SIZE -
+                                        VMM_PAGE_SIZE),
+                             (uint64_t)size,
+                             TEST_KSTACK_ENABLED);
+
+    found = kstack_get_bounds(stack + size / 2, &low, &high);
+    TEST_POINT_ASSERT_UDWORD(TEST_KSTACK_BOUNDS0_ID,
+                             found == TRUE && low == stack &&
+                             high == stack + size,
+                             (uint64_t)stack,
+                             (uint64_t)low,
+                             TEST_KSTACK_ENABLED);
+
+    TEST_POINT_ASSERT_UINT(TEST_KSTACK_GUARD0_ID,
+                           _test_kstack_mapped(stack - VMM_PAGE_SIZE) ==
+                           FALSE,
+                           FALSE,
+                           _test_kstack_mapped(stack - VMM_PAGE_SIZE),
+                           TEST_KSTACK_ENABLED);
+    TEST_POINT_ASSERT_UINT(TEST_KSTACK_TOP0_ID,
+                           _test_kstack_mapped(stack + size - VMM_PAGE_SIZE) ==
+                           TRUE,
+                           TRUE,
+                           _test_kstack_mapped(stack + size - VMM_PAGE_SIZE),
+                           TEST_KSTACK_ENABLED);
+
+    err = kstack_free(stack);
+    TEST_POINT_ASSERT_RCODE(TEST_KSTACK_FREE0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_KSTACK_ENABLED);
+    err = kstack_free(stack);
+    TEST_POINT_ASSERT_RCODE(TEST_KSTACK_FREE1_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_KSTACK_ENABLED);
+    err = kstack_free(stack + VMM_PAGE_SIZE);
+    TEST_POINT_ASSERT_RCODE(TEST_KSTACK_FREE2_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_KSTACK_ENABLED);
+}
+
+static void test_kstack_fault(void)
+{
+    OS_RETURN_E err;
+    uintptr_t   stack;
+    size_t      size;
+    uint32_t    int_state;
+    bool_t      handled;
+    bool_t      lazy;
+
+    /* The released stacks are given back, the allocation then reuses a slot
+     * with only its top page committed.
+     */
+    kstack_reclaim();
+    err = kstack_alloc(&stack, &size);
+    TEST_POINT_ASSERT_RCODE(TEST_KSTACK_FAULT_ALLOC0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_KSTACK_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+
+    lazy = (CPU_FAULT_STACK_ENABLED != 0);
+    TEST_POINT_ASSERT_UINT(TEST_KSTACK_FAULT_LAZY0_ID,
+                           _test_kstack_mapped(stack) == !lazy &&
+                           _test_kstack_mapped(stack + VMM_PAGE_SIZE) ==
+                           !lazy,
+                           !lazy,
+                           _test_kstack_mapped(stack),
+                           TEST_KSTACK_ENABLED);
+
+    /* The fault handler runs with the interrupts disabled */
+    ENTER_CRITICAL(int_state);
+    handled = kstack_handle_fault(stack + VMM_PAGE_SIZE + sizeof(uintptr_t));
+    EXIT_CRITICAL(int_state);
+    TEST_POINT_ASSERT_UINT(TEST_KSTACK_FAULT_COMMIT0_ID,
+                           handled == lazy &&
+                           _test_kstack_mapped(stack + VMM_PAGE_SIZE) == TRUE,
+                           lazy,
+                           handled,
+                           TEST_KSTACK_ENABLED);
+
+    /* The first touch of the lowest page goes through the page fault */
+    *(volatile uint8_t*)stack = TEST_KSTACK_MAGIC;
+    TEST_POINT_ASSERT_UINT(TEST_KSTACK_FAULT_TOUCH0_ID,
+                           _test_kstack_mapped(stack) == TRUE &&
+                           *(volatile uint8_t*)stack == TEST_KSTACK_MAGIC,
+                           TEST_KSTACK_MAGIC,
+                           *(volatile uint8_t*)stack,
+                           TEST_KSTACK_ENABLED);
+
+    /* The guard page, the addresses out of the stacks and the released
+     * stacks are not committed.
+     */
+    ENTER_CRITICAL(int_state);
+    handled = kstack_handle_fault(stack - sizeof(uintptr_t));
+    EXIT_CRITICAL(int_state);
+    TEST_POINT_ASSERT_UINT(TEST_KSTACK_FAULT_GUARD0_ID,
+                           handled == FALSE &&
+                           _test_kstack_mapped(stack - VMM_PAGE_SIZE) ==
+                           FALSE,
+                           FALSE,
+                           handled,
+                           TEST_KSTACK_ENABLED);
+
+    ENTER_CRITICAL(int_state);
+    handled = kstack_handle_fault(KERNEL_THREAD_STACKS_BASE - 1);
+    EXIT_CRITICAL(int_state);
+    TEST_POINT_ASSERT_UINT(TEST_KSTACK_FAULT_OUT0_ID,
+                           handled == FALSE,
+                           FALSE,
+                           handled,
+                           TEST_KSTACK_ENABLED);
+
+    err = kstack_free(stack);
+    ENTER_CRITICAL(int_state);
+    handled = kstack_handle_fault(stack + 2 * VMM_PAGE_SIZE);
+    EXIT_CRITICAL(int_state);
+    TEST_POINT_ASSERT_UINT(TEST_KSTACK_FAULT_FREED0_ID,
+                           err == OS_NO_ERR && handled == FALSE,
+                           FALSE,
+                           handled,
+                           TEST_KSTACK_ENABLED);
+}
+
+static void test_kstack_overflow(void)
+{
+#if TEST_PANIC_ENABLED
+    uintptr_t stack;
+    size_t    size;
+
+    /* The panic handler ends the suite */
+    if(kstack_alloc(&stack, &size) == OS_NO_ERR)
+    {
+        *(volatile uint8_t*)(stack - 1) = TEST_KSTACK_MAGIC;
+    }
+    TEST_POINT_ASSERT_UINT(TEST_KSTACK_OVERFLOW0_ID,
+                           FALSE,
+                           TRUE,
+                           FALSE,
+                           TEST_KSTACK_ENABLED);
+#endif
+}
+
+void kstack_test(void)
+{
+    test_kstack_alloc();
+    test_kstack_fault();
+    test_kstack_overflow();
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
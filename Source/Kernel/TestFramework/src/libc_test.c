@@ -0,0 +1,1034 @@
+/*******************************************************************************
+ * @file libc_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework libc testing.
+ *
+ * @details Testing framework libc testing. Each function is called on the
+ * sizes around its size classes boundaries, from destination and source
+ * addresses with every misalignment in a machine word. The result is compared
+ * to a byte by byte reference computed on a snapshot of the buffers, which
+ * also checks that no byte outside of the destination range was written.
+ * The scanning functions are called on every length up to a few machine
+ * words, with the searched byte or the terminator as the last byte of the
+ * range, and with the searched byte right after the range. memmem is
+ * compared to a naive search for periodic needles, in periodic haystacks that
+ * contain the needle, only at their end, or only partial matches. The 64
+ * bits divisions are checked with a multiplication for divisors around the 32
+ * bits boundaries, and the constant divisor reciprocals are compared to the
+ * division. Finally, the integer conversions are checked on 0, the limits of
+ * the types and the powers of ten, in every base the kernel formatter uses.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <stdint.h>
+#include <string.h>
+#include <stdlib.h>
+#include <kerror.h>
+#include <cpu_interrupt.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of tested sizes. */
+#define TEST_LIBC_SIZE_COUNT 18
+
+/** @brief Number of tested misalignments. */
+#define TEST_LIBC_ALIGN_COUNT 8
+
+/** @brief Number of bytes before the tested ranges, checked for writes. */
+#define TEST_LIBC_GUARD 16
+
+/** @brief Size of the tested buffers. */
+#define TEST_LIBC_BUF_SIZE 512
+
+/** @brief Value given to memset, only its low byte must be stored. */
+#define TEST_LIBC_SET_VALUE 0x1A5
+
+/** @brief Maximal length of the scanned ranges. */
+#define TEST_LIBC_SCAN_MAX 40
+
+/** @brief Byte searched in the scanned ranges, its high bit is set. */
+#define TEST_LIBC_SCAN_CHAR 0xE5
+
+/** @brief Number of tested memmem needles. */
+#define TEST_LIBC_NEEDLE_COUNT 12
+
+/** @brief Maximal length of the memmem haystacks. */
+#define TEST_LIBC_HAYSTACK_MAX 64
+
+/** @brief Number of tested divisors. */
+#define TEST_LIBC_DIVISOR_COUNT 20
+
+/** @brief Number of tested dividends, before the divisor dependent ones. */
+#define TEST_LIBC_DIVIDEND_COUNT 12
+
+/** @brief Number of divisor dependent dividends. */
+#define TEST_LIBC_DIVIDEND_REL_COUNT 7
+
+/** @brief Number of powers of ten in 64 bits. */
+#define TEST_LIBC_POW10_COUNT 20
+
+/** @brief Number of dividends compared around each multiple of 100. */
+#define TEST_LIBC_DIV_100_STEPS 4096
+
+/** @brief Size of the integer conversion buffers. */
+#define TEST_LIBC_CONV_SIZE 72
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/** @brief 64 bits division helper of the libc, it is not in a header. */
+uint64_t __udivmoddi4(uint64_t num, uint64_t den, uint64_t* rem_p);
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Tested sizes: the size classes boundaries and their neighbours. */
+static const size_t test_libc_sizes[TEST_LIBC_SIZE_COUNT] = {
+    0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 255, 256, 257, 300
+};
+
+/** @brief memmem needles, most of them are periodic or almost periodic. */
+static const char* test_libc_needles[TEST_LIBC_NEEDLE_COUNT] = {
+    "a",
+    "aa",
+    "aaaa",
+    "abab",
+    "aab",
+    "abaab",
+    "abcabc",
+    "abcabd",
+    "aaaaaaab",
+    "baaaaaaa",
+    "abababababababac",
+    "abaabaabaabaabaabaabaabaabaaba"
+};
+
+/** @brief Divisors, around the 32 bits boundaries for most of them. */
+static const uint64_t test_libc_divisors[TEST_LIBC_DIVISOR_COUNT] = {
+    1ULL,
+    2ULL,
+    3ULL,
+    7ULL,
+    10ULL,
+    100ULL,
+    641ULL,
+    1000000007ULL,
+    0x7FFFFFFFULL,
+    0x80000000ULL,
+    0xFFFFFFFFULL,
+    0x100000000ULL,
+    0x100000001ULL,
+    0x1FFFFFFFFULL,
+    0x123456789ULL,
+    0xFFFFFFFF00000000ULL,
+    0x8000000000000000ULL,
+    0x8000000000000001ULL,
+    0xFFFFFFFFFFFFFFFEULL,
+    0xFFFFFFFFFFFFFFFFULL
+};
+
+/** @brief Dividends, around the 32 bits boundaries for most of them. */
+static const uint64_t test_libc_dividends[TEST_LIBC_DIVIDEND_COUNT] = {
+    0ULL,
+    1ULL,
+    0xFFFFFFFFULL,
+    0x100000000ULL,
+    0x100000001ULL,
+    0x1FFFFFFFFULL,
+    0x123456789ABCDEF0ULL,
+    0x7FFFFFFFFFFFFFFFULL,
+    0x8000000000000000ULL,
+    0xFFFFFFFF00000000ULL,
+    0xFFFFFFFFFFFFFFFEULL,
+    0xFFFFFFFFFFFFFFFFULL
+};
+
+/** @brief Reciprocal of 100 used by uitoa on 32 bits, it must stay equal to
+ * the uitoa one.
+ */
+static const div_by_const_t test_libc_recip_100 = {
+    0x47AE147AE147AE15ULL, 6, TRUE
+};
+
+/** @brief Source buffer of the copies. */
+static uint8_t test_libc_src[TEST_LIBC_BUF_SIZE];
+
+/** @brief Buffer modified by the tested functions. */
+static uint8_t test_libc_dst[TEST_LIBC_BUF_SIZE];
+
+/** @brief Snapshot of the modified buffer before the tested call. */
+static uint8_t test_libc_orig[TEST_LIBC_BUF_SIZE];
+
+/** @brief Expected content of the modified buffer after the tested call. */
+static uint8_t test_libc_ref[TEST_LIBC_BUF_SIZE];
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+/* The reference loops must not be turned into calls to the tested functions */
+__attribute__((optimize("no-tree-loop-distribute-patterns")))
+static void test_libc_fill(uint8_t* buf, const uint8_t seed)
+{
+    size_t i;
+
+    /* The pattern does not repeat with the word size */
+    for(i = 0; i < TEST_LIBC_BUF_SIZE; ++i)
+    {
+        buf[i] = (uint8_t)(seed + i * 13 + (i >> 5));
+    }
+}
+
+__attribute__((optimize("no-tree-loop-distribute-patterns")))
+static void test_libc_snapshot(void)
+{
+    size_t i;
+
+    for(i = 0; i < TEST_LIBC_BUF_SIZE; ++i)
+    {
+        test_libc_orig[i] = test_libc_dst[i];
+        test_libc_ref[i]  = test_libc_dst[i];
+    }
+}
+
+static uint32_t test_libc_compare(void)
+{
+    uint32_t errors;
+    size_t   i;
+
+    errors = 0;
+    for(i = 0; i < TEST_LIBC_BUF_SIZE; ++i)
+    {
+        if(test_libc_dst[i] != test_libc_ref[i])
+        {
+            ++errors;
+        }
+    }
+
+    return errors;
+}
+
+__attribute__((optimize("no-tree-loop-distribute-patterns")))
+static void test_libc_fill_text(uint8_t* buf)
+{
+    size_t i;
+
+    /* Neither the terminator nor the searched byte appear in the text */
+    for(i = 0; i < TEST_LIBC_BUF_SIZE; ++i)
+    {
+        buf[i] = (uint8_t)('a' + i % 26);
+    }
+}
+
+static void test_libc_memcpy(void)
+{
+    uint32_t errors;
+    uint32_t i;
+    size_t   size;
+    size_t   dst_off;
+    size_t   src_off;
+    size_t   j;
+    void*    ret;
+
+    for(i = 0; i < TEST_LIBC_SIZE_COUNT; ++i)
+    {
+        size   = test_libc_sizes[i];
+        errors = 0;
+        for(dst_off = 0; dst_off < TEST_LIBC_ALIGN_COUNT; ++dst_off)
+        {
+            for(src_off = 0; src_off < TEST_LIBC_ALIGN_COUNT; ++src_off)
+            {
+                test_libc_fill(test_libc_src, 0x11);
+                test_libc_fill(test_libc_dst, 0x77);
+                test_libc_snapshot();
+                for(j = 0; j < size; ++j)
+                {
+                    test_libc_ref[TEST_LIBC_GUARD + dst_off + j] =
+                        test_libc_src[src_off + j];
+                }
+
+                ret = memcpy(test_libc_dst + TEST_LIBC_GUARD + dst_off,
+                             test_libc_src + src_off,
+                             size);
+                if(ret != test_libc_dst + TEST_LIBC_GUARD + dst_off)
+                {
+                    ++errors;
+                }
+                errors += test_libc_compare();
+            }
+        }
+
+        TEST_POINT_ASSERT_UINT(TEST_LIBC_MEMCPY(i),
+                               errors == 0,
+                               0,
+                               errors,
+                               TEST_LIBC_ENABLED);
+    }
+}
+
+static uint32_t test_libc_memmove_shift(const size_t size,
+                                        const size_t src_start,
+                                        const size_t dst_start)
+{
+    uint32_t errors;
+    size_t   j;
+    void*    ret;
+
+    test_libc_fill(test_libc_dst, 0x33);
+    test_libc_snapshot();
+    for(j = 0; j < size; ++j)
+    {
+        test_libc_ref[dst_start + j] = test_libc_orig[src_start + j];
+    }
+
+    errors = 0;
+    ret = memmove(test_libc_dst + dst_start, test_libc_dst + src_start, size);
+    if(ret != test_libc_dst + dst_start)
+    {
+        ++errors;
+    }
+
+    return errors + test_libc_compare();
+}
+
+static void test_libc_memmove(void)
+{
+    uint32_t errors_fwd;
+    uint32_t errors_bwd;
+    uint32_t i;
+    size_t   size;
+    size_t   start;
+    size_t   shift;
+
+    /* The ranges overlap for every size larger than the shift */
+    for(i = 0; i < TEST_LIBC_SIZE_COUNT; ++i)
+    {
+        size       = test_libc_sizes[i];
+        errors_fwd = 0;
+        errors_bwd = 0;
+        for(start = 0; start < TEST_LIBC_ALIGN_COUNT; ++start)
+        {
+            for(shift = 1; shift <= TEST_LIBC_ALIGN_COUNT; ++shift)
+            {
+                /* Destination after the source */
+                errors_fwd += test_libc_memmove_shift(size,
+                                                      TEST_LIBC_GUARD + start,
+                                                      TEST_LIBC_GUARD + start +
+                                                      shift);
+                /* Destination before the source */
+                errors_bwd += test_libc_memmove_shift(size,
+                                                      TEST_LIBC_GUARD + start +
+                                                      shift,
+                                                      TEST_LIBC_GUARD + start);
+            }
+        }
+
+        TEST_POINT_ASSERT_UINT(TEST_LIBC_MEMMOVE_FWD(i),
+                               errors_fwd == 0,
+                               0,
+                               errors_fwd,
+                               TEST_LIBC_ENABLED);
+        TEST_POINT_ASSERT_UINT(TEST_LIBC_MEMMOVE_BWD(i),
+                               errors_bwd == 0,
+                               0,
+                               errors_bwd,
+                               TEST_LIBC_ENABLED);
+    }
+}
+
+static void test_libc_memset(void)
+{
+    uint32_t errors;
+    uint32_t i;
+    size_t   size;
+    size_t   dst_off;
+    size_t   j;
+    void*    ret;
+
+    for(i = 0; i < TEST_LIBC_SIZE_COUNT; ++i)
+    {
+        size   = test_libc_sizes[i];
+        errors = 0;
+        for(dst_off = 0; dst_off < TEST_LIBC_ALIGN_COUNT; ++dst_off)
+        {
+            test_libc_fill(test_libc_dst, 0x55);
+            test_libc_snapshot();
+            for(j = 0; j < size; ++j)
+            {
+                test_libc_ref[TEST_LIBC_GUARD + dst_off + j] =
+                    (uint8_t)TEST_LIBC_SET_VALUE;
+            }
+
+            ret = memset(test_libc_dst + TEST_LIBC_GUARD + dst_off,
+                         TEST_LIBC_SET_VALUE,
+                         size);
+            if(ret != test_libc_dst + TEST_LIBC_GUARD + dst_off)
+            {
+                ++errors;
+            }
+            errors += test_libc_compare();
+        }
+
+        TEST_POINT_ASSERT_UINT(TEST_LIBC_MEMSET(i),
+                               errors == 0,
+                               0,
+                               errors,
+                               TEST_LIBC_ENABLED);
+    }
+}
+
+static void test_libc_strlen(void)
+{
+    uint32_t errors;
+    size_t   start;
+    size_t   len;
+    char*    str;
+
+    for(start = 0; start < TEST_LIBC_ALIGN_COUNT; ++start)
+    {
+        errors = 0;
+        str    = (char*)test_libc_src + TEST_LIBC_GUARD + start;
+        for(len = 0; len <= TEST_LIBC_SCAN_MAX; ++len)
+        {
+            /* The bytes after the terminator are not zero */
+            test_libc_fill_text(test_libc_src);
+            str[len] = 0;
+            if(strlen(str) != len)
+            {
+                ++errors;
+            }
+        }
+
+        TEST_POINT_ASSERT_UINT(TEST_LIBC_STRLEN(start),
+                               errors == 0,
+                               0,
+                               errors,
+                               TEST_LIBC_ENABLED);
+    }
+}
+
+static void test_libc_strchr(void)
+{
+    uint32_t errors;
+    size_t   start;
+    size_t   len;
+    char*    str;
+
+    for(start = 0; start < TEST_LIBC_ALIGN_COUNT; ++start)
+    {
+        errors = 0;
+        str    = (char*)test_libc_src + TEST_LIBC_GUARD + start;
+        for(len = 0; len <= TEST_LIBC_SCAN_MAX; ++len)
+        {
+            test_libc_fill_text(test_libc_src);
+            str[len] = 0;
+
+            /* Absent, then only after the terminator */
+            if(strchr(str, TEST_LIBC_SCAN_CHAR) != NULL)
+            {
+                ++errors;
+            }
+            str[len + 1] = (char)TEST_LIBC_SCAN_CHAR;
+            if(strchr(str, TEST_LIBC_SCAN_CHAR) != NULL)
+            {
+                ++errors;
+            }
+
+            /* The terminator itself is found */
+            if(strchr(str, 0) != str + len)
+            {
+                ++errors;
+            }
+
+            /* Last byte of the string */
+            if(len > 0)
+            {
+                str[len - 1] = (char)TEST_LIBC_SCAN_CHAR;
+                if(strchr(str, TEST_LIBC_SCAN_CHAR) != str + len - 1)
+                {
+                    ++errors;
+                }
+            }
+        }
+
+        TEST_POINT_ASSERT_UINT(TEST_LIBC_STRCHR(start),
+                               errors == 0,
+                               0,
+                               errors,
+                               TEST_LIBC_ENABLED);
+    }
+}
+
+static void test_libc_memchr(void)
+{
+    uint32_t errors;
+    size_t   start;
+    size_t   len;
+    uint8_t* buf;
+
+    for(start = 0; start < TEST_LIBC_ALIGN_COUNT; ++start)
+    {
+        errors = 0;
+        buf    = test_libc_src + TEST_LIBC_GUARD + start;
+        for(len = 0; len <= TEST_LIBC_SCAN_MAX; ++len)
+        {
+            /* Absent, then right after the range */
+            test_libc_fill_text(test_libc_src);
+            if(memchr(buf, TEST_LIBC_SCAN_CHAR, len) != NULL)
+            {
+                ++errors;
+            }
+            buf[len] = TEST_LIBC_SCAN_CHAR;
+            if(memchr(buf, TEST_LIBC_SCAN_CHAR, len) != NULL)
+            {
+                ++errors;
+            }
+
+            /* Last byte of the range, zero bytes do not stop the scan */
+            if(len > 0)
+            {
+                buf[0]       = 0;
+                buf[len - 1] = TEST_LIBC_SCAN_CHAR;
+                if(memchr(buf, TEST_LIBC_SCAN_CHAR, len) != buf + len - 1)
+                {
+                    ++errors;
+                }
+            }
+        }
+
+        TEST_POINT_ASSERT_UINT(TEST_LIBC_MEMCHR(start),
+                               errors == 0,
+                               0,
+                               errors,
+                               TEST_LIBC_ENABLED);
+    }
+}
+
+static void test_libc_memcmp(void)
+{
+    uint32_t errors;
+    size_t   start;
+    size_t   len;
+    uint8_t* buf1;
+    uint8_t* buf2;
+
+    /* The two ranges have different misalignments */
+    for(start = 0; start < TEST_LIBC_ALIGN_COUNT; ++start)
+    {
+        errors = 0;
+        buf1   = test_libc_src + TEST_LIBC_GUARD + start;
+        buf2   = test_libc_dst + TEST_LIBC_GUARD +
+                 (start * 3 + 1) % TEST_LIBC_ALIGN_COUNT;
+        for(len = 0; len <= TEST_LIBC_SCAN_MAX; ++len)
+        {
+            test_libc_fill_text(test_libc_src);
+            memmove(buf2, buf1, len + 1);
+
+            /* Equal ranges, the byte after the range differs */
+            buf2[len] = TEST_LIBC_SCAN_CHAR;
+            if(memcmp(buf1, buf2, len) != 0)
+            {
+                ++errors;
+            }
+
+            /* The last byte differs, the bytes compare as unsigned */
+            if(len > 0)
+            {
+                buf2[len - 1] = TEST_LIBC_SCAN_CHAR;
+                if(memcmp(buf1, buf2, len) >= 0 ||
+                   memcmp(buf2, buf1, len) <= 0)
+                {
+                    ++errors;
+                }
+            }
+        }
+
+        TEST_POINT_ASSERT_UINT(TEST_LIBC_MEMCMP(start),
+                               errors == 0,
+                               0,
+                               errors,
+                               TEST_LIBC_ENABLED);
+    }
+}
+
+static const uint8_t* test_libc_memmem_ref(const uint8_t* haystack,
+                                           const size_t n,
+                                           const uint8_t* needle,
+                                           const size_t m)
+{
+    size_t i;
+    size_t j;
+
+    if(m == 0 || m > n)
+    {
+        return NULL;
+    }
+
+    for(i = 0; i <= n - m; ++i)
+    {
+        j = 0;
+        while(j < m && haystack[i + j] == needle[j])
+        {
+            ++j;
+        }
+        if(j == m)
+        {
+            return haystack + i;
+        }
+    }
+
+    return NULL;
+}
+
+static uint32_t test_libc_memmem_check(const uint8_t* haystack,
+                                       const size_t n,
+                                       const uint8_t* needle,
+                                       const size_t m)
+{
+    const void* found;
+
+    found = memmem(haystack, n, needle, m);
+
+    return (found == test_libc_memmem_ref(haystack, n, needle, m)) ? 0 : 1;
+}
+
+static void test_libc_memmem(void)
+{
+    uint32_t       errors;
+    uint32_t       i;
+    size_t         m;
+    size_t         n;
+    size_t         j;
+    const uint8_t* needle;
+    uint8_t*       haystack;
+
+    haystack = test_libc_src + TEST_LIBC_GUARD + 1;
+    for(i = 0; i < TEST_LIBC_NEEDLE_COUNT; ++i)
+    {
+        needle = (const uint8_t*)test_libc_needles[i];
+        m      = strlen(test_libc_needles[i]);
+        errors = test_libc_memmem_check(haystack, 0, needle, 0);
+        for(n = 0; n <= TEST_LIBC_HAYSTACK_MAX; ++n)
+        {
+            /* Repetitions of the needle, it matches from the start */
+            for(j = 0; j < n; ++j)
+            {
+                haystack[j] = needle[j % m];
+            }
+            errors += test_libc_memmem_check(haystack, n, needle, m);
+            errors += test_libc_memmem_check(haystack + 1, n - (n > 0),
+                                             needle, m);
+
+            /* Repetitions of the needle without its last byte: partial
+             * matches only, then the needle at the end of the haystack
+             */
+            for(j = 0; j < n; ++j)
+            {
+                haystack[j] = needle[j % (m > 1 ? m - 1 : 1)];
+            }
+            errors += test_libc_memmem_check(haystack, n, needle, m);
+            if(n >= m)
+            {
+                for(j = 0; j < m; ++j)
+                {
+                    haystack[n - m + j] = needle[j];
+                }
+                errors += test_libc_memmem_check(haystack, n, needle, m);
+                errors += test_libc_memmem_check(haystack, n - 1, needle, m);
+            }
+        }
+
+        TEST_POINT_ASSERT_UINT(TEST_LIBC_MEMMEM(i),
+                               errors == 0,
+                               0,
+                               errors,
+                               TEST_LIBC_ENABLED);
+    }
+}
+
+static uint64_t test_libc_dividend(const uint32_t index,
+                                   const uint64_t divisor)
+{
+    uint64_t top;
+
+    if(index < TEST_LIBC_DIVIDEND_COUNT)
+    {
+        return test_libc_dividends[index];
+    }
+
+    /* Around the first multiples and the largest multiple of the divisor */
+    top = UINT64_MAX - UINT64_MAX % divisor;
+    switch(index - TEST_LIBC_DIVIDEND_COUNT)
+    {
+        case 0:
+            return divisor - 1;
+        case 1:
+            return divisor;
+        case 2:
+            return divisor + 1;
+        case 3:
+            return divisor * 2 - 1;
+        case 4:
+            return divisor * 3;
+        case 5:
+            return top - 1;
+        default:
+            return top;
+    }
+}
+
+static void test_libc_udivmod(void)
+{
+    uint32_t errors;
+    uint32_t i;
+    uint32_t j;
+    uint64_t divisor;
+    uint64_t dividend;
+    uint64_t quot;
+    uint64_t rem;
+
+    /* The quotient and remainder are checked without dividing */
+    for(i = 0; i < TEST_LIBC_DIVISOR_COUNT; ++i)
+    {
+        divisor = test_libc_divisors[i];
+        errors  = 0;
+        for(j = 0;
+            j < TEST_LIBC_DIVIDEND_COUNT + TEST_LIBC_DIVIDEND_REL_COUNT;
+            ++j)
+        {
+            dividend = test_libc_dividend(j, divisor);
+
+            rem  = divisor;
+            quot = __udivmoddi4(dividend, divisor, &rem);
+            if(rem >= divisor ||
+               mul_high_64(quot, divisor) != 0 ||
+               quot * divisor > dividend ||
+               quot * divisor + rem != dividend)
+            {
+                ++errors;
+            }
+
+            /* The division operators, __udivdi3 and __umoddi3 on i386 */
+            if(dividend / divisor != quot || dividend % divisor != rem)
+            {
+                ++errors;
+            }
+        }
+
+        TEST_POINT_ASSERT_UINT(TEST_LIBC_UDIVMOD(i),
+                               errors == 0,
+                               0,
+                               errors,
+                               TEST_LIBC_ENABLED);
+    }
+}
+
+static void test_libc_div_by_const(void)
+{
+    div_by_const_t reciprocal;
+    uint32_t       errors;
+    uint32_t       i;
+    uint32_t       j;
+    uint64_t       divisor;
+    uint64_t       dividend;
+
+    for(i = 0; i < TEST_LIBC_DIVISOR_COUNT; ++i)
+    {
+        divisor = test_libc_divisors[i];
+        errors  = 0;
+        div_by_const_init(&reciprocal, divisor);
+        for(j = 0;
+            j < TEST_LIBC_DIVIDEND_COUNT + TEST_LIBC_DIVIDEND_REL_COUNT;
+            ++j)
+        {
+            dividend = test_libc_dividend(j, divisor);
+            if(div_by_const(dividend, &reciprocal) != dividend / divisor)
+            {
+                ++errors;
+            }
+        }
+
+        TEST_POINT_ASSERT_UINT(TEST_LIBC_DIV_CONST(i),
+                               errors == 0,
+                               0,
+                               errors,
+                               TEST_LIBC_ENABLED);
+    }
+}
+
+static void test_libc_div_100(void)
+{
+    div_by_const_t reciprocal;
+    uint32_t       errors;
+    uint32_t       i;
+    uint64_t       dividend;
+
+    div_by_const_init(&reciprocal, 100);
+    TEST_POINT_ASSERT_UINT(TEST_LIBC_DIV_100_INIT0_ID,
+                           reciprocal.magic == test_libc_recip_100.magic &&
+                           reciprocal.shift == test_libc_recip_100.shift &&
+                           reciprocal.add == test_libc_recip_100.add,
+                           test_libc_recip_100.magic,
+                           reciprocal.magic,
+                           TEST_LIBC_ENABLED);
+
+    /* Both sides of multiples of 100, from 0 and down from UINT64_MAX,
+     * then values scattered over the whole range
+     */
+    errors = 0;
+    for(i = 0; i < TEST_LIBC_DIV_100_STEPS; ++i)
+    {
+        dividend = (uint64_t)i * 50 + (i & 1);
+        if(div_by_const(dividend, &test_libc_recip_100) != dividend / 100)
+        {
+            ++errors;
+        }
+        dividend = UINT64_MAX - dividend;
+        if(div_by_const(dividend, &test_libc_recip_100) != dividend / 100)
+        {
+            ++errors;
+        }
+        dividend = (uint64_t)i * 0x9E3779B97F4A7C15ULL;
+        if(div_by_const(dividend, &test_libc_recip_100) != dividend / 100)
+        {
+            ++errors;
+        }
+    }
+    TEST_POINT_ASSERT_UINT(TEST_LIBC_DIV_100_CHECK0_ID,
+                           errors == 0,
+                           0,
+                           errors,
+                           TEST_LIBC_ENABLED);
+}
+
+static uint32_t test_libc_check_str(const char*  str,
+                                    const size_t len,
+                                    const char*  expected)
+{
+    return (strcmp(str, expected) == 0 && len == strlen(expected)) ? 0 : 1;
+}
+
+static void test_libc_uitoa(void)
+{
+    uint32_t errors;
+    uint32_t i;
+    uint32_t j;
+    uint64_t pow10;
+    size_t   len;
+    char     buf[TEST_LIBC_CONV_SIZE];
+    char     expected[TEST_LIBC_CONV_SIZE];
+
+    /* 10^i, 10^i - 1 and 10^i + 1 */
+    pow10 = 1;
+    for(i = 0; i < TEST_LIBC_POW10_COUNT; ++i)
+    {
+        errors = 0;
+
+        expected[0] = '1';
+        for(j = 1; j <= i; ++j)
+        {
+            expected[j] = '0';
+        }
+        expected[i + 1] = 0;
+        len = uitoa_len(pow10, buf, 10, FALSE);
+        errors += test_libc_check_str(buf, len, expected);
+
+        if(i > 0)
+        {
+            expected[i] = '1';
+            len = uitoa_len(pow10 + 1, buf, 10, FALSE);
+            errors += test_libc_check_str(buf, len, expected);
+
+            for(j = 0; j < i; ++j)
+            {
+                expected[j] = '9';
+            }
+            expected[i] = 0;
+            len = uitoa_len(pow10 - 1, buf, 10, FALSE);
+            errors += test_libc_check_str(buf, len, expected);
+        }
+
+        TEST_POINT_ASSERT_UINT(TEST_LIBC_UITOA_POW10(i),
+                               errors == 0,
+                               0,
+                               errors,
+                               TEST_LIBC_ENABLED);
+
+        if(i + 1 < TEST_LIBC_POW10_COUNT)
+        {
+            pow10 *= 10;
+        }
+    }
+
+    errors = 0;
+    len = uitoa_len(0, buf, 10, FALSE);
+    errors += test_libc_check_str(buf, len, "0");
+    len = uitoa_len(0, buf, 16, TRUE);
+    errors += test_libc_check_str(buf, len, "0");
+    len = uitoa_len(UINT64_MAX, buf, 10, FALSE);
+    errors += test_libc_check_str(buf, len, "18446744073709551615");
+    len = uitoa_len(UINT64_MAX, buf, 16, TRUE);
+    errors += test_libc_check_str(buf, len, "FFFFFFFFFFFFFFFF");
+    len = uitoa_len(0xABCDEF0123456789ULL, buf, 16, FALSE);
+    errors += test_libc_check_str(buf, len, "abcdef0123456789");
+    len = uitoa_len(UINT64_MAX, buf, 8, FALSE);
+    errors += test_libc_check_str(buf, len, "1777777777777777777777");
+    len = uitoa_len(UINT64_MAX, buf, 3, FALSE);
+    errors += test_libc_check_str(buf, len,
+                                  "11112220022122120101211020120210210211220");
+    len = uitoa_len(0x123456789ABCDEF0ULL, buf, 10, FALSE);
+    errors += test_libc_check_str(buf, len, "1311768467463790320");
+    len = uitoa_len(UINT64_MAX, buf, 2, FALSE);
+    for(i = 0; i < 64; ++i)
+    {
+        expected[i] = '1';
+    }
+    expected[64] = 0;
+    errors += test_libc_check_str(buf, len, expected);
+    uitoa(UINT64_MAX, buf, 10);
+    errors += test_libc_check_str(buf, strlen(buf), "18446744073709551615");
+    TEST_POINT_ASSERT_UINT(TEST_LIBC_UITOA_LIMITS0_ID,
+                           errors == 0,
+                           0,
+                           errors,
+                           TEST_LIBC_ENABLED);
+}
+
+static void test_libc_itoa(void)
+{
+    uint32_t errors;
+    uint32_t i;
+    uint32_t j;
+    int64_t  pow10;
+    size_t   len;
+    char     buf[TEST_LIBC_CONV_SIZE];
+    char     expected[TEST_LIBC_CONV_SIZE];
+
+    /* -10^i and -(10^i - 1) */
+    pow10 = 1;
+    for(i = 0; i < TEST_LIBC_POW10_COUNT - 1; ++i)
+    {
+        errors = 0;
+
+        expected[0] = '-';
+        expected[1] = '1';
+        for(j = 1; j <= i; ++j)
+        {
+            expected[j + 1] = '0';
+        }
+        expected[i + 2] = 0;
+        len = itoa_len(-pow10, buf, 10, FALSE);
+        errors += test_libc_check_str(buf, len, expected);
+        len = itoa_len(pow10, buf, 10, FALSE);
+        errors += test_libc_check_str(buf, len, expected + 1);
+
+        if(i > 0)
+        {
+            for(j = 0; j < i; ++j)
+            {
+                expected[j + 1] = '9';
+            }
+            expected[i + 1] = 0;
+            len = itoa_len(-(pow10 - 1), buf, 10, FALSE);
+            errors += test_libc_check_str(buf, len, expected);
+        }
+
+        TEST_POINT_ASSERT_UINT(TEST_LIBC_ITOA_POW10(i),
+                               errors == 0,
+                               0,
+                               errors,
+                               TEST_LIBC_ENABLED);
+
+        if(i + 2 < TEST_LIBC_POW10_COUNT)
+        {
+            pow10 *= 10;
+        }
+    }
+
+    errors = 0;
+    len = itoa_len(0, buf, 10, FALSE);
+    errors += test_libc_check_str(buf, len, "0");
+    len = itoa_len(-1, buf, 10, FALSE);
+    errors += test_libc_check_str(buf, len, "-1");
+    len = itoa_len(INT64_MAX, buf, 10, FALSE);
+    errors += test_libc_check_str(buf, len, "9223372036854775807");
+    len = itoa_len(INT64_MIN, buf, 10, FALSE);
+    errors += test_libc_check_str(buf, len, "-9223372036854775808");
+    len = itoa_len(-1, buf, 16, TRUE);
+    errors += test_libc_check_str(buf, len, "FFFFFFFFFFFFFFFF");
+    itoa(INT64_MIN, buf, 10);
+    errors += test_libc_check_str(buf, strlen(buf), "-9223372036854775808");
+    TEST_POINT_ASSERT_UINT(TEST_LIBC_ITOA_LIMITS0_ID,
+                           errors == 0,
+                           0,
+                           errors,
+                           TEST_LIBC_ENABLED);
+}
+
+void libc_test(void)
+{
+    test_libc_memcpy();
+    test_libc_memmove();
+    test_libc_memset();
+    test_libc_strlen();
+    test_libc_strchr();
+    test_libc_memchr();
+    test_libc_memcmp();
+    test_libc_memmem();
+    test_libc_udivmod();
+    test_libc_div_by_const();
+    test_libc_div_100();
+    test_libc_uitoa();
+    test_libc_itoa();
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,655 @@
+/*******************************************************************************
+ * @file lock_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework locks testing.
+ *
+ * @details Testing framework locks testing. Checks the state of the ticket
+ * and MCS spinlocks when locked, unlocked and nested in each other and the
+ * critical sections nesting, the sequence numbers of the sequence locks, the
+ * state of the reader-writer locks, the mutexes ownership and the semaphores
+ * units. Then one thread per CPU increments a shared counter under each lock
+ * with a non atomic read-modify-write: a lost update shows a broken mutual
+ * exclusion. The writers also copy the counter
+ * in a pair of values the readers check, a torn pair shows a read racing
+ * with a write. The idle CPUs steal the threads from the testing CPU,
+ * without other started CPUs they all run on the testing CPU.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <cpu.h>
+#include <critical.h>
+#include <scheduler.h>
+#include <mutex.h>
+#include <semaphore.h>
+#include <cpu_interrupt.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Number of increments of each contending thread. */
+#define TEST_LOCK_ITERATIONS 20000
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The counter incremented by the contending threads. */
+static volatile uint32_t test_lock_counter;
+
+/** @brief The copies of the counter, written one after the other. */
+static volatile uint32_t test_lock_pair[2];
+
+/** @brief Number of torn pairs read by the contending threads. */
+static volatile uint32_t test_lock_errors;
+
+/** @brief Posted by each contending thread when it is done. */
+static semaphore_t test_lock_done;
+
+/** @brief The tested ticket spinlock. */
+static kernel_spinlock_t test_ticket_lock =
+    KERNEL_SPINLOCK_INIT_VALUE_TYPE(KERNEL_SPINLOCK_TICKET);
+
+/** @brief The tested MCS spinlock. */
+static kernel_spinlock_t test_mcs_lock =
+    KERNEL_SPINLOCK_INIT_VALUE_TYPE(KERNEL_SPINLOCK_MCS);
+
+/** @brief The tested sequence lock. */
+static kernel_seqlock_t test_seqlock = KERNEL_SEQLOCK_INIT_VALUE;
+
+/** @brief The tested reader-writer lock. */
+static kernel_rwlock_t test_rwlock = KERNEL_RWLOCK_INIT_VALUE;
+
+/** @brief The tested mutex. */
+static mutex_t test_mutex = MUTEX_INIT_VALUE(MUTEX_FLAG_NONE);
+
+/** @brief The tested priority inheritance mutex. */
+static mutex_t test_pi_mutex = MUTEX_INIT_VALUE(MUTEX_FLAG_PRIO_INHERITANCE);
+
+/** @brief The tested semaphore. */
+static semaphore_t test_semaphore;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void test_lock_increment(void)
+{
+    uint32_t value;
+
+    /* The pause widens the window in which an update can be lost */
+    value = test_lock_counter;
+    _cpu_pause();
+    test_lock_counter = value + 1;
+
+    test_lock_pair[0] = value + 1;
+    _cpu_pause();
+    test_lock_pair[1] = value + 1;
+}
+
+static void test_lock_check_pair(const uint32_t first, const uint32_t second)
+{
+    if(first != second)
+    {
+        __atomic_fetch_add(&test_lock_errors, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void test_lock_ticket_increment(const uint32_t iteration)
+{
+    uint32_t int_state;
+
+    (void)iteration;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(test_ticket_lock, int_state);
+    test_lock_increment();
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(test_ticket_lock, int_state);
+}
+
+static void test_lock_mcs_increment(const uint32_t iteration)
+{
+    uint32_t int_state;
+
+    (void)iteration;
+
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(test_mcs_lock, int_state);
+    test_lock_increment();
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(test_mcs_lock, int_state);
+}
+
+static void test_lock_seqlock_increment(const uint32_t iteration)
+{
+    uint32_t sequence;
+    uint32_t first;
+    uint32_t second;
+    uint32_t int_state;
+
+    (void)iteration;
+
+    do
+    {
+        sequence = KERNEL_SEQLOCK_READ_BEGIN(test_seqlock);
+        first    = test_lock_pair[0];
+        second   = test_lock_pair[1];
+    } while(KERNEL_SEQLOCK_READ_RETRY(test_seqlock, sequence) == TRUE);
+    test_lock_check_pair(first, second);
+
+    /* A reader on the writing CPU would spin on the odd sequence */
+    ENTER_CRITICAL(int_state);
+    KERNEL_SEQLOCK_WRITE_LOCK(test_seqlock);
+    test_lock_increment();
+    KERNEL_SEQLOCK_WRITE_UNLOCK(test_seqlock);
+    EXIT_CRITICAL(int_state);
+}
+
+static void test_lock_rwlock_increment(const uint32_t iteration)
+{
+    uint32_t int_state;
+
+    (void)iteration;
+
+    ENTER_CRITICAL(int_state);
+
+    KERNEL_RWLOCK_READ_LOCK(test_rwlock);
+    test_lock_check_pair(test_lock_pair[0], test_lock_pair[1]);
+    KERNEL_RWLOCK_READ_UNLOCK(test_rwlock);
+
+    KERNEL_RWLOCK_WRITE_LOCK(test_rwlock);
+    test_lock_increment();
+    KERNEL_RWLOCK_WRITE_UNLOCK(test_rwlock);
+
+    EXIT_CRITICAL(int_state);
+}
+
+static void test_lock_mutex_increment(const uint32_t iteration)
+{
+    mutex_t* mutex;
+
+    /* The waiters sleep, the owner can be preempted while holding it */
+    mutex = (iteration % 2 == 0) ? &test_mutex : &test_pi_mutex;
+    if(mutex_lock(mutex) != OS_NO_ERR)
+    {
+        __atomic_fetch_add(&test_lock_errors, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    test_lock_increment();
+    if(mutex_unlock(mutex) != OS_NO_ERR)
+    {
+        __atomic_fetch_add(&test_lock_errors, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void test_lock_semaphore_increment(const uint32_t iteration)
+{
+    (void)iteration;
+
+    /* The semaphore has a single unit */
+    if(semaphore_wait(&test_semaphore) != OS_NO_ERR)
+    {
+        __atomic_fetch_add(&test_lock_errors, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    test_lock_increment();
+    if(semaphore_post(&test_semaphore) != OS_NO_ERR)
+    {
+        __atomic_fetch_add(&test_lock_errors, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void* test_lock_routine(void* args)
+{
+    void             (*increment)(const uint32_t);
+    kernel_thread_t* current;
+    uint32_t         i;
+
+    /* Switching out moves the thread to the CPU of its affinity */
+    (void)scheduler_sleep(0);
+
+    /* Function pointers cannot be converted to data pointers directly */
+    increment = *(void (**)(const uint32_t))args;
+    for(i = 0; i < TEST_LOCK_ITERATIONS; ++i)
+    {
+        increment(i);
+    }
+
+    /* The thread never left its CPU */
+    current = scheduler_get_current_thread();
+    if((current->cpu_affinity & (1U << scheduler_get_current_cpu_id())) == 0)
+    {
+        __atomic_fetch_add(&test_lock_errors, 1, __ATOMIC_RELAXED);
+    }
+
+    (void)semaphore_post(&test_lock_done);
+
+    return NULL;
+}
+
+static void test_lock_contention(const uint32_t test_id,
+                                 void (*increment)(const uint32_t))
+{
+    OS_RETURN_E      err;
+    kernel_thread_t* current;
+    kernel_thread_t* thread;
+    uint32_t         created;
+    uint32_t         started;
+    uint32_t         i;
+
+    test_lock_counter = 0;
+    test_lock_pair[0] = 0;
+    test_lock_pair[1] = 0;
+    test_lock_errors  = 0;
+    err = semaphore_init(&test_lock_done, 0);
+
+    /* One thread pinned to each started CPU, all of them contend for the lock */
+    current = scheduler_get_current_thread();
+    started = cpu_get_started_count();
+    created = 0;
+    for(i = 0; i < started && err == OS_NO_ERR; ++i)
+    {
+        err = scheduler_create_kernel_thread(&thread, current->priority,
+                                             "lock_test", test_lock_routine,
+                                             &increment);
+        if(err == OS_NO_ERR)
+        {
+            ++created;
+            err = scheduler_set_thread_affinity(thread, 1U << i);
+        }
+    }
+    for(i = 0; i < created; ++i)
+    {
+        (void)semaphore_wait(&test_lock_done);
+    }
+
+    TEST_POINT_ASSERT_UINT(test_id,
+                           err == OS_NO_ERR && test_lock_errors == 0 &&
+                           test_lock_counter ==
+                           created * TEST_LOCK_ITERATIONS,
+                           created * TEST_LOCK_ITERATIONS,
+                           test_lock_counter,
+                           TEST_LOCK_ENABLED);
+}
+
+static void test_lock_spinlocks(void)
+{
+    kernel_spinlock_t inner_lock;
+
+    KERNEL_SPINLOCK_INIT_TYPE(inner_lock, KERNEL_SPINLOCK_MCS);
+
+    KERNEL_SPINLOCK_LOCK(test_ticket_lock);
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_TICKET0_ID,
+                           test_ticket_lock.next_ticket ==
+                           (uint16_t)(test_ticket_lock.owner_ticket + 1),
+                           (uint16_t)(test_ticket_lock.owner_ticket + 1),
+                           test_ticket_lock.next_ticket,
+                           TEST_LOCK_ENABLED);
+    KERNEL_SPINLOCK_UNLOCK(test_ticket_lock);
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_TICKET1_ID,
+                           test_ticket_lock.next_ticket ==
+                           test_ticket_lock.owner_ticket,
+                           test_ticket_lock.owner_ticket,
+                           test_ticket_lock.next_ticket,
+                           TEST_LOCK_ENABLED);
+
+    /* The owner node is the only node of the queue of a held MCS lock */
+    KERNEL_SPINLOCK_LOCK(test_mcs_lock);
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_MCS0_ID,
+                           test_mcs_lock.tail == &test_mcs_lock.owner &&
+                           test_mcs_lock.owner.next == NULL,
+                           TRUE,
+                           test_mcs_lock.tail == &test_mcs_lock.owner,
+                           TEST_LOCK_ENABLED);
+    KERNEL_SPINLOCK_UNLOCK(test_mcs_lock);
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_MCS1_ID,
+                           test_mcs_lock.tail == NULL,
+                           TRUE,
+                           test_mcs_lock.tail == NULL,
+                           TEST_LOCK_ENABLED);
+
+    /* The nested locks are independent from each other */
+    KERNEL_SPINLOCK_LOCK(test_mcs_lock);
+    KERNEL_SPINLOCK_LOCK(test_ticket_lock);
+    KERNEL_SPINLOCK_LOCK(inner_lock);
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_NESTED0_ID,
+                           test_mcs_lock.tail == &test_mcs_lock.owner &&
+                           inner_lock.tail == &inner_lock.owner &&
+                           test_ticket_lock.next_ticket !=
+                           test_ticket_lock.owner_ticket,
+                           TRUE,
+                           inner_lock.tail == &inner_lock.owner,
+                           TEST_LOCK_ENABLED);
+    KERNEL_SPINLOCK_UNLOCK(inner_lock);
+    KERNEL_SPINLOCK_UNLOCK(test_ticket_lock);
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_NESTED1_ID,
+                           test_mcs_lock.tail == &test_mcs_lock.owner &&
+                           inner_lock.tail == NULL &&
+                           test_ticket_lock.next_ticket ==
+                           test_ticket_lock.owner_ticket,
+                           TRUE,
+                           inner_lock.tail == NULL,
+                           TEST_LOCK_ENABLED);
+    KERNEL_SPINLOCK_UNLOCK(test_mcs_lock);
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_NESTED2_ID,
+                           test_mcs_lock.tail == NULL,
+                           TRUE,
+                           test_mcs_lock.tail == NULL,
+                           TEST_LOCK_ENABLED);
+}
+
+static void test_lock_critical(void)
+{
+    uint32_t initial_state;
+    uint32_t outer_state;
+    uint32_t inner_state;
+    uint32_t lock_state;
+
+    initial_state = _cpu_get_interrupt_state();
+
+    /* Only the outermost section enables the interrupts again */
+    ENTER_CRITICAL(outer_state);
+    ENTER_CRITICAL(inner_state);
+    KERNEL_SPINLOCK_LOCK_IRQSAVE(test_ticket_lock, lock_state);
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_CRITICAL0_ID,
+                           _cpu_get_interrupt_state() == 0 &&
+                           inner_state == 0 && lock_state == 0,
+                           0,
+                           _cpu_get_interrupt_state(),
+                           TEST_LOCK_ENABLED);
+    KERNEL_SPINLOCK_UNLOCK_IRQRESTORE(test_ticket_lock, lock_state);
+    EXIT_CRITICAL(inner_state);
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_CRITICAL1_ID,
+                           _cpu_get_interrupt_state() == 0,
+                           0,
+                           _cpu_get_interrupt_state(),
+                           TEST_LOCK_ENABLED);
+    EXIT_CRITICAL(outer_state);
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_CRITICAL2_ID,
+                           _cpu_get_interrupt_state() == initial_state &&
+                           outer_state == initial_state,
+                           initial_state,
+                           _cpu_get_interrupt_state(),
+                           TEST_LOCK_ENABLED);
+}
+
+static void test_lock_seqlock(void)
+{
+    uint32_t sequence;
+
+    sequence = KERNEL_SEQLOCK_READ_BEGIN(test_seqlock);
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_SEQLOCK0_ID,
+                           (sequence & 1) == 0 &&
+                           KERNEL_SEQLOCK_READ_RETRY(test_seqlock,
+                                                     sequence) == FALSE,
+                           0,
+                           sequence & 1,
+                           TEST_LOCK_ENABLED);
+
+    /* The sequence is odd during a write */
+    KERNEL_SEQLOCK_WRITE_LOCK(test_seqlock);
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_SEQLOCK1_ID,
+                           test_seqlock.sequence == sequence + 1,
+                           sequence + 1,
+                           test_seqlock.sequence,
+                           TEST_LOCK_ENABLED);
+    KERNEL_SEQLOCK_WRITE_UNLOCK(test_seqlock);
+
+    /* A read started before the write must be done again */
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_SEQLOCK2_ID,
+                           test_seqlock.sequence == sequence + 2 &&
+                           KERNEL_SEQLOCK_READ_RETRY(test_seqlock,
+                                                     sequence) == TRUE,
+                           sequence + 2,
+                           test_seqlock.sequence,
+                           TEST_LOCK_ENABLED);
+}
+
+static void test_lock_rwlock(void)
+{
+    /* The readers share the lock */
+    KERNEL_RWLOCK_READ_LOCK(test_rwlock);
+    KERNEL_RWLOCK_READ_LOCK(test_rwlock);
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_RWLOCK0_ID,
+                           test_rwlock.state == 2,
+                           2,
+                           test_rwlock.state,
+                           TEST_LOCK_ENABLED);
+    KERNEL_RWLOCK_READ_UNLOCK(test_rwlock);
+    KERNEL_RWLOCK_READ_UNLOCK(test_rwlock);
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_RWLOCK1_ID,
+                           test_rwlock.state == 0,
+                           0,
+                           test_rwlock.state,
+                           TEST_LOCK_ENABLED);
+
+    KERNEL_RWLOCK_WRITE_LOCK(test_rwlock);
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_RWLOCK2_ID,
+                           test_rwlock.state == KERNEL_RWLOCK_WRITER &&
+                           test_rwlock.waiting_writers == 0,
+                           KERNEL_RWLOCK_WRITER,
+                           test_rwlock.state,
+                           TEST_LOCK_ENABLED);
+    KERNEL_RWLOCK_WRITE_UNLOCK(test_rwlock);
+    TEST_POINT_ASSERT_UINT(TEST_LOCK_RWLOCK3_ID,
+                           test_rwlock.state == 0,
+                           0,
+                           test_rwlock.state,
+                           TEST_LOCK_ENABLED);
+}
+
+static void test_lock_mutex(void)
+{
+    OS_RETURN_E      err;
+    kernel_thread_t* current;
+    uint8_t          priority;
+
+    err = mutex_init(NULL, MUTEX_FLAG_NONE);
+    TEST_POINT_ASSERT_RCODE(TEST_LOCK_MUTEX_INIT0_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_LOCK_ENABLED);
+    err = mutex_init(&test_mutex, ~MUTEX_FLAG_PRIO_INHERITANCE);
+    TEST_POINT_ASSERT_RCODE(TEST_LOCK_MUTEX_INIT1_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_LOCK_ENABLED);
+    err = mutex_init(&test_mutex, MUTEX_FLAG_NONE);
+    TEST_POINT_ASSERT_RCODE(TEST_LOCK_MUTEX_INIT2_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_LOCK_ENABLED);
+
+    current  = scheduler_get_current_thread();
+    priority = current->priority;
+
+    err = mutex_lock(&test_mutex);
+    TEST_POINT_ASSERT_UDWORD(TEST_LOCK_MUTEX_LOCK0_ID,
+                             err == OS_NO_ERR &&
+                             test_mutex.owner == (uintptr_t)current,
+                             (uint64_t)(uintptr_t)current,
+                             (uint64_t)test_mutex.owner,
+                             TEST_LOCK_ENABLED);
+
+    /* The mutexes are not recursive */
+    err = mutex_trylock(&test_mutex);
+    TEST_POINT_ASSERT_RCODE(TEST_LOCK_MUTEX_TRYLOCK0_ID,
+                            err == OS_ERR_RESOURCE_BUSY,
+                            OS_ERR_RESOURCE_BUSY,
+                            err,
+                            TEST_LOCK_ENABLED);
+    err = mutex_lock(&test_mutex);
+    TEST_POINT_ASSERT_RCODE(TEST_LOCK_MUTEX_RELOCK0_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_LOCK_ENABLED);
+
+    /* Another mutex is taken while holding the first one */
+    err = mutex_trylock(&test_pi_mutex);
+    if(err == OS_NO_ERR)
+    {
+        err = mutex_unlock(&test_pi_mutex);
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_LOCK_MUTEX_NESTED0_ID,
+                            err == OS_NO_ERR &&
+                            test_pi_mutex.owner == 0 &&
+                            current->priority == priority,
+                            OS_NO_ERR,
+                            err,
+                            TEST_LOCK_ENABLED);
+
+    err = mutex_unlock(&test_mutex);
+    TEST_POINT_ASSERT_RCODE(TEST_LOCK_MUTEX_UNLOCK0_ID,
+                            err == OS_NO_ERR && test_mutex.owner == 0,
+                            OS_NO_ERR,
+                            err,
+                            TEST_LOCK_ENABLED);
+    err = mutex_unlock(&test_mutex);
+    TEST_POINT_ASSERT_RCODE(TEST_LOCK_MUTEX_UNLOCK1_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_LOCK_ENABLED);
+}
+
+static void test_lock_semaphore(void)
+{
+    OS_RETURN_E err;
+
+    err = semaphore_init(NULL, 1);
+    TEST_POINT_ASSERT_RCODE(TEST_LOCK_SEMAPHORE_INIT0_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_LOCK_ENABLED);
+
+    /* The posts would overflow the count */
+    err = semaphore_init(&test_semaphore, UINT32_MAX);
+    if(err == OS_NO_ERR)
+    {
+        err = semaphore_post(&test_semaphore);
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_LOCK_SEMAPHORE_OVERFLOW0_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_LOCK_ENABLED);
+
+    /* The units are taken until none is left */
+    err = semaphore_init(&test_semaphore, 2);
+    if(err == OS_NO_ERR)
+    {
+        err = semaphore_trywait(&test_semaphore);
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = semaphore_wait(&test_semaphore);
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_LOCK_SEMAPHORE_TAKE0_ID,
+                            err == OS_NO_ERR && test_semaphore.count == 0,
+                            OS_NO_ERR,
+                            err,
+                            TEST_LOCK_ENABLED);
+    err = semaphore_trywait(&test_semaphore);
+    TEST_POINT_ASSERT_RCODE(TEST_LOCK_SEMAPHORE_EMPTY0_ID,
+                            err == OS_ERR_RESOURCE_BUSY,
+                            OS_ERR_RESOURCE_BUSY,
+                            err,
+                            TEST_LOCK_ENABLED);
+
+    /* A posted unit is available again */
+    err = semaphore_post(&test_semaphore);
+    if(err == OS_NO_ERR)
+    {
+        err = semaphore_trywait(&test_semaphore);
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_LOCK_SEMAPHORE_POST0_ID,
+                            err == OS_NO_ERR && test_semaphore.count == 0,
+                            OS_NO_ERR,
+                            err,
+                            TEST_LOCK_ENABLED);
+
+    /* The contending threads use the semaphore as a lock */
+    err = semaphore_post(&test_semaphore);
+    TEST_POINT_ASSERT_RCODE(TEST_LOCK_SEMAPHORE_POST1_ID,
+                            err == OS_NO_ERR && test_semaphore.count == 1,
+                            OS_NO_ERR,
+                            err,
+                            TEST_LOCK_ENABLED);
+}
+
+void lock_test(void)
+{
+    test_lock_spinlocks();
+    test_lock_critical();
+    test_lock_seqlock();
+    test_lock_rwlock();
+    test_lock_mutex();
+    test_lock_semaphore();
+    test_lock_contention(TEST_LOCK_TICKET_CONTENTION0_ID,
+                         test_lock_ticket_increment);
+    test_lock_contention(TEST_LOCK_MCS_CONTENTION0_ID,
+                         test_lock_mcs_increment);
+    test_lock_contention(TEST_LOCK_SEQLOCK_CONTENTION0_ID,
+                         test_lock_seqlock_increment);
+    test_lock_contention(TEST_LOCK_RWLOCK_CONTENTION0_ID,
+                         test_lock_rwlock_increment);
+    test_lock_contention(TEST_LOCK_MUTEX_CONTENTION0_ID,
+                         test_lock_mutex_increment);
+    test_lock_contention(TEST_LOCK_SEMAPHORE_CONTENTION0_ID,
+                         test_lock_semaphore_increment);
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,319 @@
+/*******************************************************************************
+ * @file memmgt_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework physical memory manager testing.
+ *
+ * @details Testing framework physical memory manager testing. Checks the
+ * parameters validation, the alignment of the blocks and that a block split
+ * from a free block of the largest order merges back into it when the two
+ * halves are released. The merge is observed by holding every other block
+ * of the largest order.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <memmgt.h>
+#include <cpu_interrupt.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Order of the blocks split from the largest order blocks. */
+#define TEST_MEMMGT_SPLIT_ORDER (MEMMGT_MAX_ORDER - 1)
+
+/** @brief Size of a block of the split order, in bytes. */
+#define TEST_MEMMGT_SPLIT_SIZE \
+    ((uintptr_t)MEMMGT_FRAME_SIZE << TEST_MEMMGT_SPLIT_ORDER)
+
+/** @brief Size of a block of the largest order, in bytes. */
+#define TEST_MEMMGT_MAX_SIZE ((uintptr_t)MEMMGT_FRAME_SIZE << MEMMGT_MAX_ORDER)
+
+/** @brief Number of free blocks of the split order kept while searching a
+ * split block.
+ */
+#define TEST_MEMMGT_MAX_HELD 64
+
+/** @brief Number of blocks of the largest order that can be held. */
+#define TEST_MEMMGT_MAX_BLOCKS 1024
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The blocks of the split order that were already free. */
+static uintptr_t held_blocks[TEST_MEMMGT_MAX_HELD];
+
+/** @brief The blocks of the largest order held during the merge test. */
+static uintptr_t max_blocks[TEST_MEMMGT_MAX_BLOCKS];
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void test_memmgt_params(void)
+{
+    OS_RETURN_E err;
+    uintptr_t   frame;
+
+    err = memmgt_alloc_frames(0, NULL);
+    TEST_POINT_ASSERT_RCODE(TEST_MEMMGT_ALLOC_NULL0_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_MEMMGT_ENABLED);
+
+    err = memmgt_alloc_frames(MEMMGT_MAX_ORDER + 1, &frame);
+    TEST_POINT_ASSERT_RCODE(TEST_MEMMGT_ALLOC_BAD_ORDER0_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_MEMMGT_ENABLED);
+
+    err = memmgt_free_frames(MEMMGT_FRAME_SIZE, MEMMGT_MAX_ORDER + 1);
+    TEST_POINT_ASSERT_RCODE(TEST_MEMMGT_FREE_BAD_ORDER0_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_MEMMGT_ENABLED);
+}
+
+static void test_memmgt_max_order(void)
+{
+    OS_RETURN_E err;
+    uintptr_t   frame;
+
+    err = memmgt_alloc_frames(MEMMGT_MAX_ORDER, &frame);
+    TEST_POINT_ASSERT_RCODE(TEST_MEMMGT_ALLOC_MAX0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_MEMMGT_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+
+    /* The blocks are aligned on their size */
+    TEST_POINT_ASSERT_UDWORD(TEST_MEMMGT_ALLOC_MAX_ALIGN0_ID,
+                             (frame & (TEST_MEMMGT_MAX_SIZE - 1)) == 0,
+                             0,
+                             (uint64_t)(frame & (TEST_MEMMGT_MAX_SIZE - 1)),
+                             TEST_MEMMGT_ENABLED);
+
+    /* A block is released with its allocation order only */
+    err = memmgt_free_frames(frame, TEST_MEMMGT_SPLIT_ORDER);
+    TEST_POINT_ASSERT_RCODE(TEST_MEMMGT_FREE_WRONG_ORDER0_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_MEMMGT_ENABLED);
+
+    err = memmgt_free_frames(frame, MEMMGT_MAX_ORDER);
+    TEST_POINT_ASSERT_RCODE(TEST_MEMMGT_FREE_MAX0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_MEMMGT_ENABLED);
+
+    err = memmgt_free_frames(frame, MEMMGT_MAX_ORDER);
+    TEST_POINT_ASSERT_RCODE(TEST_MEMMGT_DOUBLE_FREE0_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_MEMMGT_ENABLED);
+}
+
+static void test_memmgt_coalesce(void)
+{
+    OS_RETURN_E err;
+    size_t      initial;
+    uintptr_t   block;
+    uintptr_t   merged;
+    uintptr_t   lower;
+    uintptr_t   upper;
+    uint32_t    max_held;
+    uint32_t    held;
+    uint32_t    i;
+    bool_t      split;
+
+    initial = memmgt_get_free_frames();
+
+    /* Hold every free block of the largest order, the last one is released
+     * and is then the only block the largest order can be served from.
+     */
+    max_held = 0;
+    err      = OS_NO_ERR;
+    while(max_held < TEST_MEMMGT_MAX_BLOCKS)
+    {
+        err = memmgt_alloc_frames(MEMMGT_MAX_ORDER, &block);
+        if(err != OS_NO_ERR)
+        {
+            break;
+        }
+        max_blocks[max_held++] = block;
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_MEMMGT_EXHAUST0_ID,
+                            err == OS_ERR_NO_MORE_MEMORY && max_held > 0,
+                            OS_ERR_NO_MORE_MEMORY,
+                            err,
+                            TEST_MEMMGT_ENABLED);
+
+    split = FALSE;
+    held  = 0;
+    lower = 0;
+    if(err == OS_ERR_NO_MORE_MEMORY && max_held > 0)
+    {
+        block = max_blocks[--max_held];
+        (void)memmgt_free_frames(block, MEMMGT_MAX_ORDER);
+
+        /* The blocks of the split order already free are kept until an
+         * allocation splits the released block. Its upper half is then the
+         * only free block that can serve the split order.
+         */
+        while(held < TEST_MEMMGT_MAX_HELD)
+        {
+            err = memmgt_alloc_frames(TEST_MEMMGT_SPLIT_ORDER, &lower);
+            if(err != OS_NO_ERR)
+            {
+                break;
+            }
+            if((lower & ~(TEST_MEMMGT_MAX_SIZE - 1)) == block)
+            {
+                split = TRUE;
+                break;
+            }
+            held_blocks[held++] = lower;
+        }
+    }
+    TEST_POINT_ASSERT_UINT(TEST_MEMMGT_SPLIT0_ID,
+                           split == TRUE && lower == block,
+                           TRUE,
+                           split,
+                           TEST_MEMMGT_ENABLED);
+
+    if(split == TRUE)
+    {
+        err = memmgt_alloc_frames(TEST_MEMMGT_SPLIT_ORDER, &upper);
+        TEST_POINT_ASSERT_UDWORD(TEST_MEMMGT_SPLIT_BUDDY0_ID,
+                                 err == OS_NO_ERR &&
+                                 (lower ^ upper) == TEST_MEMMGT_SPLIT_SIZE,
+                                 (uint64_t)(lower ^ TEST_MEMMGT_SPLIT_SIZE),
+                                 (uint64_t)upper,
+                                 TEST_MEMMGT_ENABLED);
+
+        /* The lower half cannot merge while its buddy is used */
+        (void)memmgt_free_frames(lower, TEST_MEMMGT_SPLIT_ORDER);
+        err = memmgt_alloc_frames(MEMMGT_MAX_ORDER, &merged);
+        TEST_POINT_ASSERT_RCODE(TEST_MEMMGT_FREE_LOWER0_ID,
+                                err == OS_ERR_NO_MORE_MEMORY,
+                                OS_ERR_NO_MORE_MEMORY,
+                                err,
+                                TEST_MEMMGT_ENABLED);
+        if(err == OS_NO_ERR)
+        {
+            (void)memmgt_free_frames(merged, MEMMGT_MAX_ORDER);
+        }
+
+        /* Both halves are free, they merge back into the largest order */
+        (void)memmgt_free_frames(upper, TEST_MEMMGT_SPLIT_ORDER);
+        err = memmgt_alloc_frames(MEMMGT_MAX_ORDER, &merged);
+        TEST_POINT_ASSERT_UDWORD(TEST_MEMMGT_COALESCE0_ID,
+                                 err == OS_NO_ERR && merged == block,
+                                 (uint64_t)block,
+                                 (uint64_t)merged,
+                                 TEST_MEMMGT_ENABLED);
+        if(err == OS_NO_ERR)
+        {
+            max_blocks[max_held++] = merged;
+        }
+    }
+
+    err = OS_NO_ERR;
+    for(i = 0; i < held; ++i)
+    {
+        if(memmgt_free_frames(held_blocks[i],
+                              TEST_MEMMGT_SPLIT_ORDER) != OS_NO_ERR)
+        {
+            err = OS_ERR_UNAUTHORIZED_ACTION;
+        }
+    }
+    for(i = 0; i < max_held; ++i)
+    {
+        if(memmgt_free_frames(max_blocks[i], MEMMGT_MAX_ORDER) != OS_NO_ERR)
+        {
+            err = OS_ERR_UNAUTHORIZED_ACTION;
+        }
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_MEMMGT_FREE_HELD0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_MEMMGT_ENABLED);
+
+    /* Every frame went back to the free lists */
+    TEST_POINT_ASSERT_UINT(TEST_MEMMGT_FREE_FRAMES0_ID,
+                           memmgt_get_free_frames() == initial,
+                           initial,
+                           memmgt_get_free_frames(),
+                           TEST_MEMMGT_ENABLED);
+}
+
+void memmgt_test(void)
+{
+    test_memmgt_params();
+    test_memmgt_max_order();
+    test_memmgt_coalesce();
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
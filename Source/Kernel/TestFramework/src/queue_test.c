@@ -0,0 +1,431 @@
+/*******************************************************************************
+ * @file queue_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework lock-free rings and message queues testing.
+ *
+ * @details Testing framework lock-free rings and message queues testing.
+ * Checks that the capacities that are not a power of two are rejected, then
+ * fills and drains the SPSC and MPMC rings: the push on a full ring and the
+ * pop on an empty ring fail and the elements come out in order. The same
+ * cycle runs again with the indexes started just before UINT32_MAX to wrap
+ * them around. Finally a thread sends more messages than a message queue
+ * holds, the sender waits for the receiver to free slots.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <queue.h>
+#include <scheduler.h>
+#include <semaphore.h>
+#include <cpu_interrupt.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Capacity of the tested queues. */
+#define TEST_QUEUE_CAPACITY 4
+
+/** @brief Index the wrapping tests start at, the indexes wrap around during
+ * the first fill.
+ */
+#define TEST_QUEUE_WRAP_START (UINT32_MAX - 1)
+
+/** @brief Number of messages sent through the tested message queue. */
+#define TEST_QUEUE_MESSAGES 64
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief The tested SPSC ring. */
+static spsc_queue_t test_spsc;
+
+/** @brief The tested SPSC ring storage. */
+static void* test_spsc_slots[TEST_QUEUE_CAPACITY];
+
+/** @brief The tested MPMC ring. */
+static mpmc_queue_t test_mpmc;
+
+/** @brief The tested MPMC ring and message queue storage. */
+static mpmc_cell_t test_cells[TEST_QUEUE_CAPACITY];
+
+/** @brief The tested message queue. */
+static mqueue_t test_mqueue;
+
+/** @brief Posted by the sender thread when it is done. */
+static semaphore_t test_sender_done;
+
+/** @brief The error returned to the sender thread, if any. */
+static OS_RETURN_E test_sender_err;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void test_queue_params(void)
+{
+    OS_RETURN_E err;
+
+    err = spsc_queue_init(&test_spsc, NULL, TEST_QUEUE_CAPACITY);
+    TEST_POINT_ASSERT_RCODE(TEST_QUEUE_SPSC_INIT_NULL0_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_QUEUE_ENABLED);
+
+    err = spsc_queue_init(&test_spsc, test_spsc_slots,
+                          TEST_QUEUE_CAPACITY - 1);
+    TEST_POINT_ASSERT_RCODE(TEST_QUEUE_SPSC_INIT_POW20_ID,
+                            err == OS_ERR_OUT_OF_BOUND,
+                            OS_ERR_OUT_OF_BOUND,
+                            err,
+                            TEST_QUEUE_ENABLED);
+
+    err = mpmc_queue_init(&test_mpmc, test_cells, TEST_QUEUE_CAPACITY - 1);
+    TEST_POINT_ASSERT_RCODE(TEST_QUEUE_MPMC_INIT_POW20_ID,
+                            err == OS_ERR_OUT_OF_BOUND,
+                            OS_ERR_OUT_OF_BOUND,
+                            err,
+                            TEST_QUEUE_ENABLED);
+
+    err = mpmc_queue_init(&test_mpmc, test_cells, 0);
+    TEST_POINT_ASSERT_RCODE(TEST_QUEUE_MPMC_INIT_ZERO0_ID,
+                            err == OS_ERR_OUT_OF_BOUND,
+                            OS_ERR_OUT_OF_BOUND,
+                            err,
+                            TEST_QUEUE_ENABLED);
+
+    err = mqueue_init(&test_mqueue, test_cells, TEST_QUEUE_CAPACITY + 2);
+    TEST_POINT_ASSERT_RCODE(TEST_QUEUE_MQUEUE_INIT_POW20_ID,
+                            err == OS_ERR_OUT_OF_BOUND,
+                            OS_ERR_OUT_OF_BOUND,
+                            err,
+                            TEST_QUEUE_ENABLED);
+}
+
+static bool_t test_queue_spsc_cycle(void)
+{
+    void*    element;
+    uint32_t i;
+
+    if(spsc_queue_pop(&test_spsc, &element) == TRUE)
+    {
+        return FALSE;
+    }
+
+    for(i = 0; i < TEST_QUEUE_CAPACITY; ++i)
+    {
+        if(spsc_queue_push(&test_spsc, (void*)(uintptr_t)(i + 1)) == FALSE)
+        {
+            return FALSE;
+        }
+    }
+    if(spsc_queue_push(&test_spsc, NULL) == TRUE)
+    {
+        return FALSE;
+    }
+
+    for(i = 0; i < TEST_QUEUE_CAPACITY; ++i)
+    {
+        if(spsc_queue_pop(&test_spsc, &element) == FALSE ||
+           element != (void*)(uintptr_t)(i + 1))
+        {
+            return FALSE;
+        }
+    }
+
+    return spsc_queue_pop(&test_spsc, &element) == FALSE;
+}
+
+static bool_t test_queue_mpmc_cycle(void)
+{
+    void*    element;
+    uint32_t i;
+
+    if(mpmc_queue_pop(&test_mpmc, &element) == TRUE)
+    {
+        return FALSE;
+    }
+
+    for(i = 0; i < TEST_QUEUE_CAPACITY; ++i)
+    {
+        if(mpmc_queue_push(&test_mpmc, (void*)(uintptr_t)(i + 1)) == FALSE)
+        {
+            return FALSE;
+        }
+    }
+    if(mpmc_queue_push(&test_mpmc, NULL) == TRUE)
+    {
+        return FALSE;
+    }
+
+    for(i = 0; i < TEST_QUEUE_CAPACITY; ++i)
+    {
+        if(mpmc_queue_pop(&test_mpmc, &element) == FALSE ||
+           element != (void*)(uintptr_t)(i + 1))
+        {
+            return FALSE;
+        }
+    }
+
+    return mpmc_queue_pop(&test_mpmc, &element) == FALSE;
+}
+
+static void test_queue_spsc(void)
+{
+    OS_RETURN_E err;
+    bool_t      valid;
+
+    err = spsc_queue_init(&test_spsc, test_spsc_slots, TEST_QUEUE_CAPACITY);
+    TEST_POINT_ASSERT_RCODE(TEST_QUEUE_SPSC_INIT0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_QUEUE_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+
+    valid = test_queue_spsc_cycle();
+    TEST_POINT_ASSERT_UINT(TEST_QUEUE_SPSC_CYCLE0_ID,
+                           valid == TRUE,
+                           TRUE,
+                           valid,
+                           TEST_QUEUE_ENABLED);
+
+    /* The empty ring restarts from the wrapping index */
+    test_spsc.tail        = TEST_QUEUE_WRAP_START;
+    test_spsc.cached_head = TEST_QUEUE_WRAP_START;
+    test_spsc.head        = TEST_QUEUE_WRAP_START;
+    test_spsc.cached_tail = TEST_QUEUE_WRAP_START;
+    valid = test_queue_spsc_cycle() && test_queue_spsc_cycle();
+    TEST_POINT_ASSERT_UINT(TEST_QUEUE_SPSC_WRAP0_ID,
+                           valid == TRUE &&
+                           test_spsc.tail < TEST_QUEUE_WRAP_START &&
+                           test_spsc.head == test_spsc.tail,
+                           TRUE,
+                           valid,
+                           TEST_QUEUE_ENABLED);
+}
+
+static void test_queue_mpmc(void)
+{
+    OS_RETURN_E err;
+    uint32_t    i;
+    bool_t      valid;
+
+    err = mpmc_queue_init(&test_mpmc, test_cells, TEST_QUEUE_CAPACITY);
+    TEST_POINT_ASSERT_RCODE(TEST_QUEUE_MPMC_INIT0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_QUEUE_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+
+    valid = test_queue_mpmc_cycle();
+    TEST_POINT_ASSERT_UINT(TEST_QUEUE_MPMC_CYCLE0_ID,
+                           valid == TRUE,
+                           TRUE,
+                           valid,
+                           TEST_QUEUE_ENABLED);
+
+    /* The empty ring restarts from the wrapping index, each cell waits for
+     * the next position it is used at
+     */
+    for(i = 0; i < TEST_QUEUE_CAPACITY; ++i)
+    {
+        test_cells[(TEST_QUEUE_WRAP_START + i) & test_mpmc.mask].sequence =
+            TEST_QUEUE_WRAP_START + i;
+    }
+    test_mpmc.tail = TEST_QUEUE_WRAP_START;
+    test_mpmc.head = TEST_QUEUE_WRAP_START;
+    valid = test_queue_mpmc_cycle() && test_queue_mpmc_cycle();
+    TEST_POINT_ASSERT_UINT(TEST_QUEUE_MPMC_WRAP0_ID,
+                           valid == TRUE &&
+                           test_mpmc.tail < TEST_QUEUE_WRAP_START &&
+                           test_mpmc.head == test_mpmc.tail,
+                           TRUE,
+                           valid,
+                           TEST_QUEUE_ENABLED);
+}
+
+static void* test_queue_sender_routine(void* args)
+{
+    uint32_t i;
+
+    (void)args;
+
+    test_sender_err = OS_NO_ERR;
+    for(i = 0; i < TEST_QUEUE_MESSAGES && test_sender_err == OS_NO_ERR; ++i)
+    {
+        test_sender_err = mqueue_send(&test_mqueue, (void*)(uintptr_t)(i + 1));
+    }
+
+    (void)semaphore_post(&test_sender_done);
+
+    return NULL;
+}
+
+static void test_queue_mqueue(void)
+{
+    OS_RETURN_E      err;
+    kernel_thread_t* thread;
+    void*            message;
+    uint32_t         i;
+    bool_t           valid;
+
+    err = mqueue_init(&test_mqueue, test_cells, TEST_QUEUE_CAPACITY);
+    TEST_POINT_ASSERT_RCODE(TEST_QUEUE_MQUEUE_INIT0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_QUEUE_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+
+    err = mqueue_tryreceive(&test_mqueue, &message);
+    TEST_POINT_ASSERT_RCODE(TEST_QUEUE_MQUEUE_EMPTY0_ID,
+                            err == OS_ERR_RESOURCE_BUSY,
+                            OS_ERR_RESOURCE_BUSY,
+                            err,
+                            TEST_QUEUE_ENABLED);
+
+    err = OS_NO_ERR;
+    for(i = 0; i < TEST_QUEUE_CAPACITY && err == OS_NO_ERR; ++i)
+    {
+        err = mqueue_trysend(&test_mqueue, (void*)(uintptr_t)(i + 1));
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = mqueue_trysend(&test_mqueue, NULL);
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_QUEUE_MQUEUE_FULL0_ID,
+                            err == OS_ERR_RESOURCE_BUSY,
+                            OS_ERR_RESOURCE_BUSY,
+                            err,
+                            TEST_QUEUE_ENABLED);
+
+    valid = TRUE;
+    for(i = 0; i < TEST_QUEUE_CAPACITY; ++i)
+    {
+        if(mqueue_tryreceive(&test_mqueue, &message) != OS_NO_ERR ||
+           message != (void*)(uintptr_t)(i + 1))
+        {
+            valid = FALSE;
+        }
+    }
+    TEST_POINT_ASSERT_UINT(TEST_QUEUE_MQUEUE_DRAIN0_ID,
+                           valid == TRUE &&
+                           mqueue_tryreceive(&test_mqueue, &message) ==
+                           OS_ERR_RESOURCE_BUSY,
+                           TRUE,
+                           valid,
+                           TEST_QUEUE_ENABLED);
+
+    /* The sender waits on the full queue, the receiver on the empty one */
+    err = semaphore_init(&test_sender_done, 0);
+    if(err == OS_NO_ERR)
+    {
+        err = scheduler_create_kernel_thread(&thread,
+                                             scheduler_get_current_thread()->
+                                             priority,
+                                             "queue_test",
+                                             test_queue_sender_routine,
+                                             NULL);
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_QUEUE_MQUEUE_THREAD0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_QUEUE_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+
+    valid = TRUE;
+    for(i = 0; i < TEST_QUEUE_MESSAGES && valid == TRUE; ++i)
+    {
+        if(mqueue_receive(&test_mqueue, &message) != OS_NO_ERR ||
+           message != (void*)(uintptr_t)(i + 1))
+        {
+            valid = FALSE;
+        }
+    }
+    if(valid == TRUE)
+    {
+        (void)semaphore_wait(&test_sender_done);
+    }
+    TEST_POINT_ASSERT_UINT(TEST_QUEUE_MQUEUE_BLOCKING0_ID,
+                           valid == TRUE && test_sender_err == OS_NO_ERR,
+                           TRUE,
+                           valid,
+                           TEST_QUEUE_ENABLED);
+}
+
+void queue_test(void)
+{
+    test_queue_params();
+    test_queue_spsc();
+    test_queue_mpmc();
+    test_queue_mqueue();
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
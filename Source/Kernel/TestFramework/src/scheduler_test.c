@@ -0,0 +1,805 @@
+/*******************************************************************************
+ * @file scheduler_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework scheduler testing.
+ *
+ * @details Testing framework scheduler testing. The init thread lowers its
+ * own priority below the tested threads and calls the scheduler: the tested
+ * threads then run in priority order and round robin in their priority ready
+ * queue until they all returned and the init thread is elected again. More
+ * threads than the threads pool holds are then created one after the other,
+ * checking that the returned threads control blocks are released. Finally the
+ * sleeping threads must wake up in their wakeup time order, and the init
+ * thread sleep latency, with only the one-shot timer deadline to wake the
+ * CPU, must stay below TEST_SCHED_SLEEP_SLACK_NS. The timer heap is also
+ * tested on its own: after each insertion and removal, every thread must be
+ * stored at the index it records and no thread may wake up before its parent.
+ * The deadline threads woken up together must then run in their absolute
+ * deadline order, and a deadline thread running past its budget must be
+ * throttled until its next release.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <critical.h>
+#include <scheduler.h>
+#include <semaphore.h>
+#include <ctrl_block.h>
+#include <cpu_interrupt.h>
+#include <time_mgt.h>
+#include <timer_heap.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Priority of the highest priority tested thread. */
+#define TEST_SCHED_PRIO_BASE 8
+
+/** @brief Priority given to the init thread while the tested threads run. */
+#define TEST_SCHED_INIT_PRIO (TEST_SCHED_PRIO_BASE + 8)
+
+/** @brief Number of threads of the priority order test. */
+#define TEST_SCHED_ORDER_COUNT 3
+
+/** @brief Number of threads of the round robin test. */
+#define TEST_SCHED_RR_COUNT 2
+
+/** @brief Number of laps of the round robin threads. */
+#define TEST_SCHED_RR_LAPS 2
+
+/** @brief Number of threads created by the control blocks reuse test. */
+#define TEST_SCHED_REUSE_COUNT (2 * KERNEL_MAX_THREAD_COUNT)
+
+/** @brief Number of threads of the sleep order test. */
+#define TEST_SCHED_SLEEP_COUNT 3
+
+/** @brief Sleep time unit of the sleeping threads in nanoseconds. */
+#define TEST_SCHED_SLEEP_UNIT_NS 1000000ULL
+
+/** @brief Sleep time of the init thread in the latency test. */
+#define TEST_SCHED_SLEEP_NS 2000000ULL
+
+/** @brief Maximal accepted sleep latency in nanoseconds. */
+#define TEST_SCHED_SLEEP_SLACK_NS 5000000ULL
+
+/** @brief Maximal number of sleep units the init thread waits for the
+ * sleeping threads.
+ */
+#define TEST_SCHED_SLEEP_WAIT 100
+
+/** @brief Number of threads inserted in the tested timer heap. */
+#define TEST_SCHED_HEAP_COUNT 8
+
+/** @brief Wakeup time of the thread removed from the tested timer heap. */
+#define TEST_SCHED_HEAP_REMOVED 60
+
+/** @brief Wakeup time of the thread inserted last in the tested timer heap. */
+#define TEST_SCHED_HEAP_EARLIEST 5
+
+/** @brief Time at which the expired threads are popped from the heap. */
+#define TEST_SCHED_HEAP_NOW 35
+
+/** @brief Number of threads expired by TEST_SCHED_HEAP_NOW. */
+#define TEST_SCHED_HEAP_EXPIRED 4
+
+/** @brief Number of threads of the deadline order test. */
+#define TEST_SCHED_DL_COUNT 3
+
+/** @brief Runtime of the deadline threads in nanoseconds. */
+#define TEST_SCHED_DL_RUNTIME_NS 2000000ULL
+
+/** @brief Relative deadline unit of the deadline order threads. */
+#define TEST_SCHED_DL_DEADLINE_NS 4000000ULL
+
+/** @brief Period of the deadline threads in nanoseconds. */
+#define TEST_SCHED_DL_PERIOD_NS 20000000ULL
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Values recorded by the tested threads in their running order. */
+static uintptr_t test_sched_trace[TEST_SCHED_RR_COUNT * TEST_SCHED_RR_LAPS];
+
+/** @brief Number of values recorded by the tested threads. */
+static volatile uint32_t test_sched_trace_count;
+
+/** @brief Number of deadline threads waiting for their start. */
+static volatile uint32_t test_sched_dl_armed;
+
+/** @brief Number of deadline threads which failed to set their parameters. */
+static volatile uint32_t test_sched_dl_errors;
+
+/** @brief Start of the deadline order threads. */
+static semaphore_t test_sched_dl_start;
+
+/** @brief Longest time the budget thread did not run, in nanoseconds. */
+static volatile uint64_t test_sched_dl_gap;
+
+/** @brief Time the budget thread ran before its longest gap. */
+static volatile uint64_t test_sched_dl_run;
+
+/** @brief Tells if the budget thread returned. */
+static volatile bool_t test_sched_dl_done;
+
+/** @brief Tested timer heap. */
+static timer_heap_t test_sched_heap;
+
+/** @brief Threads inserted in the tested timer heap, they never run. */
+static kernel_thread_t test_sched_heap_threads[TIMER_HEAP_CAPACITY + 1];
+
+/** @brief Wakeup times of the threads inserted in the tested timer heap. */
+static const uint64_t test_sched_heap_times[TEST_SCHED_HEAP_COUNT] = {
+    50, 20, 70, 10, TEST_SCHED_HEAP_REMOVED, 30, 80, 40
+};
+
+/** @brief Wakeup times of the expired threads, in their expiry order. */
+static const uint64_t test_sched_heap_expired[TEST_SCHED_HEAP_EXPIRED] = {
+    TEST_SCHED_HEAP_EARLIEST, 10, 20, 30
+};
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void* test_sched_record_routine(void* args)
+{
+    if(test_sched_trace_count < TEST_SCHED_RR_COUNT * TEST_SCHED_RR_LAPS)
+    {
+        test_sched_trace[test_sched_trace_count++] = (uintptr_t)args;
+    }
+
+    return NULL;
+}
+
+static void* test_sched_rr_routine(void* args)
+{
+    uint32_t i;
+
+    for(i = 0; i < TEST_SCHED_RR_LAPS; ++i)
+    {
+        test_sched_record_routine(args);
+        scheduler_schedule();
+    }
+
+    return NULL;
+}
+
+static void* test_sched_sleep_routine(void* args)
+{
+    OS_RETURN_E err;
+
+    /* The threads sleep for args units and record args once awake */
+    err = scheduler_sleep((uintptr_t)args * TEST_SCHED_SLEEP_UNIT_NS);
+    if(err == OS_NO_ERR)
+    {
+        test_sched_record_routine(args);
+    }
+
+    return NULL;
+}
+
+static void* test_sched_dl_order_routine(void* args)
+{
+    uint64_t deadline;
+
+    /* The threads wait for the start with their deadline parameters set */
+    deadline = ((uintptr_t)args + 1) * TEST_SCHED_DL_DEADLINE_NS;
+    if(scheduler_set_deadline(TEST_SCHED_DL_RUNTIME_NS, deadline,
+                              TEST_SCHED_DL_PERIOD_NS) != OS_NO_ERR)
+    {
+        __atomic_fetch_add(&test_sched_dl_errors, 1, __ATOMIC_RELAXED);
+        return NULL;
+    }
+
+    __atomic_fetch_add(&test_sched_dl_armed, 1, __ATOMIC_RELAXED);
+    if(semaphore_wait(&test_sched_dl_start) == OS_NO_ERR)
+    {
+        test_sched_record_routine(args);
+    }
+
+    if(scheduler_clear_deadline() != OS_NO_ERR)
+    {
+        __atomic_fetch_add(&test_sched_dl_errors, 1, __ATOMIC_RELAXED);
+    }
+
+    return NULL;
+}
+
+static void* test_sched_dl_budget_routine(void* args)
+{
+    uint64_t start;
+    uint64_t last;
+    uint64_t now;
+    uint64_t gap;
+
+    (void)args;
+
+    if(scheduler_set_deadline(TEST_SCHED_DL_RUNTIME_NS,
+                              TEST_SCHED_DL_PERIOD_NS,
+                              TEST_SCHED_DL_PERIOD_NS) != OS_NO_ERR)
+    {
+        __atomic_fetch_add(&test_sched_dl_errors, 1, __ATOMIC_RELAXED);
+        test_sched_dl_done = TRUE;
+        return NULL;
+    }
+
+    /* The thread spins past its budget up to its next release, the longest
+     * time between two uptime reads is the time it was throttled.
+     */
+    start = time_get_current_uptime_nano();
+    last  = start;
+    now   = start;
+    while(now - start < TEST_SCHED_DL_PERIOD_NS)
+    {
+        now = time_get_current_uptime_nano();
+        gap = now - last;
+        if(gap > test_sched_dl_gap)
+        {
+            test_sched_dl_gap = gap;
+            test_sched_dl_run = last - start;
+        }
+        last = now;
+    }
+
+    if(scheduler_clear_deadline() != OS_NO_ERR)
+    {
+        __atomic_fetch_add(&test_sched_dl_errors, 1, __ATOMIC_RELAXED);
+    }
+    test_sched_dl_done = TRUE;
+
+    return NULL;
+}
+
+static void test_sched_run_threads(void)
+{
+    kernel_thread_t* self;
+    uint8_t          priority;
+
+    /* The init thread is elected again once all the tested threads
+     * returned
+     */
+    self           = scheduler_get_current_thread();
+    priority       = self->priority;
+    self->priority = TEST_SCHED_INIT_PRIO;
+    scheduler_schedule();
+    self->priority = priority;
+}
+
+static void test_sched_create(void)
+{
+    OS_RETURN_E err;
+
+    err = scheduler_create_kernel_thread(NULL, TEST_SCHED_PRIO_BASE,
+                                         "test_sched", NULL, NULL);
+    TEST_POINT_ASSERT_RCODE(TEST_SCHED_CREATE_NULL0_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_SCHEDULER_ENABLED);
+
+    err = scheduler_create_kernel_thread(NULL, KERNEL_LOWEST_PRIORITY + 1,
+                                         "test_sched",
+                                         test_sched_record_routine, NULL);
+    TEST_POINT_ASSERT_RCODE(TEST_SCHED_CREATE_PRIO0_ID,
+                            err == OS_ERR_FORBIDEN_PRIORITY,
+                            OS_ERR_FORBIDEN_PRIORITY,
+                            err,
+                            TEST_SCHEDULER_ENABLED);
+}
+
+static void test_sched_priority_order(void)
+{
+    OS_RETURN_E err;
+    uint32_t    i;
+    uint8_t     priority;
+
+    /* The threads are created from the lowest to the highest priority */
+    test_sched_trace_count = 0;
+    for(i = 0; i < TEST_SCHED_ORDER_COUNT; ++i)
+    {
+        priority = TEST_SCHED_PRIO_BASE + TEST_SCHED_ORDER_COUNT - 1 - i;
+        err = scheduler_create_kernel_thread(NULL, priority, "test_sched",
+                                             test_sched_record_routine,
+                                             (void*)(uintptr_t)priority);
+        TEST_POINT_ASSERT_RCODE(TEST_SCHED_ORDER_CREATE(i),
+                                err == OS_NO_ERR,
+                                OS_NO_ERR,
+                                err,
+                                TEST_SCHEDULER_ENABLED);
+    }
+
+    test_sched_run_threads();
+
+    TEST_POINT_ASSERT_UINT(TEST_SCHED_ORDER_COUNT0_ID,
+                           test_sched_trace_count == TEST_SCHED_ORDER_COUNT,
+                           TEST_SCHED_ORDER_COUNT,
+                           test_sched_trace_count,
+                           TEST_SCHEDULER_ENABLED);
+
+    /* The highest priority thread ran first */
+    for(i = 0; i < TEST_SCHED_ORDER_COUNT; ++i)
+    {
+        TEST_POINT_ASSERT_UDWORD(TEST_SCHED_ORDER_CHECK(i),
+                                 test_sched_trace[i] ==
+                                 TEST_SCHED_PRIO_BASE + i,
+                                 (uint64_t)(TEST_SCHED_PRIO_BASE + i),
+                                 (uint64_t)test_sched_trace[i],
+                                 TEST_SCHEDULER_ENABLED);
+    }
+}
+
+static void test_sched_round_robin(void)
+{
+    OS_RETURN_E err;
+    uint32_t    i;
+
+    test_sched_trace_count = 0;
+    for(i = 0; i < TEST_SCHED_RR_COUNT; ++i)
+    {
+        err = scheduler_create_kernel_thread(NULL, TEST_SCHED_PRIO_BASE,
+                                             "test_sched",
+                                             test_sched_rr_routine,
+                                             (void*)(uintptr_t)i);
+        TEST_POINT_ASSERT_RCODE(TEST_SCHED_RR_CREATE(i),
+                                err == OS_NO_ERR,
+                                OS_NO_ERR,
+                                err,
+                                TEST_SCHEDULER_ENABLED);
+    }
+
+    test_sched_run_threads();
+
+    /* A thread calling the scheduler goes back at the end of its queue */
+    for(i = 0; i < TEST_SCHED_RR_COUNT * TEST_SCHED_RR_LAPS; ++i)
+    {
+        TEST_POINT_ASSERT_UDWORD(TEST_SCHED_RR_CHECK(i),
+                                 i < test_sched_trace_count &&
+                                 test_sched_trace[i] ==
+                                 i % TEST_SCHED_RR_COUNT,
+                                 (uint64_t)(i % TEST_SCHED_RR_COUNT),
+                                 (uint64_t)test_sched_trace[i],
+                                 TEST_SCHEDULER_ENABLED);
+    }
+}
+
+static void test_sched_reuse(void)
+{
+    OS_RETURN_E err;
+    uint32_t    i;
+
+    /* Each thread returns before the next one is created */
+    err = OS_NO_ERR;
+    for(i = 0; i < TEST_SCHED_REUSE_COUNT && err == OS_NO_ERR; ++i)
+    {
+        test_sched_trace_count = 0;
+        err = scheduler_create_kernel_thread(NULL, TEST_SCHED_PRIO_BASE,
+                                             "test_sched",
+                                             test_sched_record_routine,
+                                             NULL);
+        if(err == OS_NO_ERR)
+        {
+            test_sched_run_threads();
+        }
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_SCHED_REUSE0_ID,
+                            err == OS_NO_ERR && i == TEST_SCHED_REUSE_COUNT,
+                            OS_NO_ERR,
+                            err,
+                            TEST_SCHEDULER_ENABLED);
+}
+
+static void test_sched_sleep(void)
+{
+    OS_RETURN_E err;
+    uint64_t    start;
+    uint64_t    elapsed;
+    uint32_t    i;
+    uintptr_t   units;
+
+    /* The init thread sleeps with no other ready thread */
+    start   = time_get_current_uptime_nano();
+    err     = scheduler_sleep(TEST_SCHED_SLEEP_NS);
+    elapsed = time_get_current_uptime_nano() - start;
+    TEST_POINT_ASSERT_RCODE(TEST_SCHED_SLEEP0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_SCHEDULER_ENABLED);
+    TEST_POINT_ASSERT_UDWORD(TEST_SCHED_SLEEP_LATENCY0_ID,
+                             elapsed >= TEST_SCHED_SLEEP_NS &&
+                             elapsed < TEST_SCHED_SLEEP_NS +
+                                       TEST_SCHED_SLEEP_SLACK_NS,
+                             TEST_SCHED_SLEEP_NS,
+                             elapsed,
+                             TEST_SCHEDULER_ENABLED);
+
+    /* The threads are created from the longest to the shortest sleep */
+    test_sched_trace_count = 0;
+    for(i = 0; i < TEST_SCHED_SLEEP_COUNT; ++i)
+    {
+        units = TEST_SCHED_SLEEP_COUNT - i;
+        err = scheduler_create_kernel_thread(NULL, TEST_SCHED_PRIO_BASE,
+                                             "test_sched",
+                                             test_sched_sleep_routine,
+                                             (void*)units);
+        TEST_POINT_ASSERT_RCODE(TEST_SCHED_SLEEP_CREATE(i),
+                                err == OS_NO_ERR,
+                                OS_NO_ERR,
+                                err,
+                                TEST_SCHEDULER_ENABLED);
+    }
+
+    for(i = 0;
+        i < TEST_SCHED_SLEEP_WAIT &&
+        test_sched_trace_count < TEST_SCHED_SLEEP_COUNT;
+        ++i)
+    {
+        (void)scheduler_sleep(TEST_SCHED_SLEEP_UNIT_NS);
+    }
+
+    /* The shortest sleep wakes up first */
+    for(i = 0; i < TEST_SCHED_SLEEP_COUNT; ++i)
+    {
+        TEST_POINT_ASSERT_UDWORD(TEST_SCHED_SLEEP_ORDER(i),
+                                 i < test_sched_trace_count &&
+                                 test_sched_trace[i] == i + 1,
+                                 (uint64_t)(i + 1),
+                                 (uint64_t)test_sched_trace[i],
+                                 TEST_SCHEDULER_ENABLED);
+    }
+}
+
+static void test_sched_deadline(void)
+{
+    OS_RETURN_E      err;
+    kernel_thread_t* self;
+    kernel_thread_t* thread;
+    uint32_t         cpu_mask;
+    uint32_t         int_state;
+    uint32_t         i;
+    uintptr_t        order;
+
+    err = scheduler_set_deadline(SCHED_DEADLINE_MIN_RUNTIME_NS - 1,
+                                 TEST_SCHED_DL_PERIOD_NS,
+                                 TEST_SCHED_DL_PERIOD_NS);
+    TEST_POINT_ASSERT_RCODE(TEST_SCHED_DL_BOUND0_ID,
+                            err == OS_ERR_OUT_OF_BOUND,
+                            OS_ERR_OUT_OF_BOUND,
+                            err,
+                            TEST_SCHEDULER_ENABLED);
+
+    /* A thread using its whole CPU exceeds the admitted bandwidth */
+    err = scheduler_set_deadline(TEST_SCHED_DL_PERIOD_NS,
+                                 TEST_SCHED_DL_PERIOD_NS,
+                                 TEST_SCHED_DL_PERIOD_NS);
+    self = scheduler_get_current_thread();
+    TEST_POINT_ASSERT_RCODE(TEST_SCHED_DL_BUSY0_ID,
+                            err == OS_ERR_RESOURCE_BUSY &&
+                            self->sched_class == THREAD_SCHED_FIXED,
+                            OS_ERR_RESOURCE_BUSY,
+                            err,
+                            TEST_SCHEDULER_ENABLED);
+
+    err = scheduler_clear_deadline();
+    TEST_POINT_ASSERT_RCODE(TEST_SCHED_DL_CLEAR0_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_SCHEDULER_ENABLED);
+
+    /* All the threads reserve their bandwidth on the testing CPU, they are
+     * created from the latest to the earliest deadline.
+     */
+    cpu_mask = 1U << scheduler_get_current_cpu_id();
+    (void)scheduler_set_thread_affinity(self, cpu_mask);
+
+    test_sched_trace_count = 0;
+    test_sched_dl_armed    = 0;
+    test_sched_dl_errors   = 0;
+    err = semaphore_init(&test_sched_dl_start, 0);
+    for(i = 0; i < TEST_SCHED_DL_COUNT && err == OS_NO_ERR; ++i)
+    {
+        order = TEST_SCHED_DL_COUNT - 1 - i;
+        err = scheduler_create_kernel_thread(&thread, TEST_SCHED_PRIO_BASE,
+                                             "test_sched",
+                                             test_sched_dl_order_routine,
+                                             (void*)order);
+        if(err == OS_NO_ERR)
+        {
+            err = scheduler_set_thread_affinity(thread, cpu_mask);
+        }
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_SCHED_DL_CREATE0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_SCHEDULER_ENABLED);
+
+    for(i = 0;
+        i < TEST_SCHED_SLEEP_WAIT &&
+        test_sched_dl_armed + test_sched_dl_errors < TEST_SCHED_DL_COUNT;
+        ++i)
+    {
+        (void)scheduler_sleep(TEST_SCHED_SLEEP_UNIT_NS);
+    }
+
+    /* The threads are woken up together, their new deadlines keep the order
+     * of their relative deadlines.
+     */
+    ENTER_CRITICAL(int_state);
+    for(i = 0; i < test_sched_dl_armed; ++i)
+    {
+        (void)semaphore_post(&test_sched_dl_start);
+    }
+    EXIT_CRITICAL(int_state);
+
+    for(i = 0;
+        i < TEST_SCHED_SLEEP_WAIT &&
+        test_sched_trace_count < test_sched_dl_armed;
+        ++i)
+    {
+        (void)scheduler_sleep(TEST_SCHED_SLEEP_UNIT_NS);
+    }
+
+    /* The earliest deadline ran first */
+    for(i = 0; i < TEST_SCHED_DL_COUNT; ++i)
+    {
+        TEST_POINT_ASSERT_UDWORD(TEST_SCHED_DL_ORDER(i),
+                                 i < test_sched_trace_count &&
+                                 test_sched_trace[i] == i,
+                                 (uint64_t)i,
+                                 (uint64_t)test_sched_trace[i],
+                                 TEST_SCHEDULER_ENABLED);
+    }
+
+    /* The budget thread runs its budget, then waits for its next release */
+    test_sched_dl_gap  = 0;
+    test_sched_dl_run  = 0;
+    test_sched_dl_done = FALSE;
+    err = scheduler_create_kernel_thread(&thread, TEST_SCHED_PRIO_BASE,
+                                         "test_sched",
+                                         test_sched_dl_budget_routine, NULL);
+    if(err == OS_NO_ERR)
+    {
+        err = scheduler_set_thread_affinity(thread, cpu_mask);
+    }
+    for(i = 0; i < TEST_SCHED_SLEEP_WAIT && test_sched_dl_done == FALSE; ++i)
+    {
+        (void)scheduler_sleep(TEST_SCHED_SLEEP_UNIT_NS);
+    }
+
+    (void)scheduler_set_thread_affinity(self, SCHED_CPU_AFFINITY_ALL);
+
+    TEST_POINT_ASSERT_UINT(TEST_SCHED_DL_ERRORS0_ID,
+                           err == OS_NO_ERR && test_sched_dl_done == TRUE &&
+                           test_sched_dl_errors == 0,
+                           0,
+                           test_sched_dl_errors,
+                           TEST_SCHEDULER_ENABLED);
+    TEST_POINT_ASSERT_UDWORD(TEST_SCHED_DL_BUDGET0_ID,
+                             test_sched_dl_run <
+                             TEST_SCHED_DL_RUNTIME_NS +
+                             TEST_SCHED_SLEEP_SLACK_NS,
+                             TEST_SCHED_DL_RUNTIME_NS,
+                             test_sched_dl_run,
+                             TEST_SCHEDULER_ENABLED);
+    TEST_POINT_ASSERT_UDWORD(TEST_SCHED_DL_THROTTLE0_ID,
+                             test_sched_dl_gap +
+                             TEST_SCHED_DL_RUNTIME_NS +
+                             TEST_SCHED_SLEEP_SLACK_NS >=
+                             TEST_SCHED_DL_PERIOD_NS,
+                             TEST_SCHED_DL_PERIOD_NS -
+                             TEST_SCHED_DL_RUNTIME_NS,
+                             test_sched_dl_gap,
+                             TEST_SCHEDULER_ENABLED);
+}
+
+static bool_t test_sched_heap_valid(const timer_heap_t* heap)
+{
+    uint32_t i;
+
+    for(i = 1; i <= heap->size; ++i)
+    {
+        if(heap->threads[i]->timer_heap_index != i ||
+           (i > 1 &&
+            heap->threads[i / 2]->wakeup_time > heap->threads[i]->wakeup_time))
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static void test_sched_timer_heap(void)
+{
+    OS_RETURN_E      err;
+    kernel_thread_t* thread;
+    kernel_thread_t* removed;
+    kernel_thread_t* last;
+    uint32_t         i;
+    bool_t           valid;
+
+    timer_heap_init(&test_sched_heap);
+
+    /* Each insertion keeps the heap ordered and the indexes up to date */
+    err   = OS_NO_ERR;
+    valid = TRUE;
+    for(i = 0; i < TEST_SCHED_HEAP_COUNT && err == OS_NO_ERR; ++i)
+    {
+        test_sched_heap_threads[i].wakeup_time = test_sched_heap_times[i];
+        err   = timer_heap_insert(&test_sched_heap,
+                                  &test_sched_heap_threads[i]);
+        valid = valid && test_sched_heap_valid(&test_sched_heap);
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_SCHED_HEAP_INSERT0_ID,
+                            err == OS_NO_ERR &&
+                            test_sched_heap.size == TEST_SCHED_HEAP_COUNT,
+                            OS_NO_ERR,
+                            err,
+                            TEST_SCHEDULER_ENABLED);
+    TEST_POINT_ASSERT_UINT(TEST_SCHED_HEAP_INDEX0_ID,
+                           valid == TRUE,
+                           TRUE,
+                           valid,
+                           TEST_SCHEDULER_ENABLED);
+
+    err = timer_heap_insert(&test_sched_heap, &test_sched_heap_threads[0]);
+    TEST_POINT_ASSERT_RCODE(TEST_SCHED_HEAP_DOUBLE0_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_SCHEDULER_ENABLED);
+
+    /* Removing an inner thread moves the last thread in its place */
+    removed = &test_sched_heap_threads[4];
+    err     = timer_heap_remove(&test_sched_heap, removed);
+    TEST_POINT_ASSERT_RCODE(TEST_SCHED_HEAP_REMOVE0_ID,
+                            err == OS_NO_ERR &&
+                            removed->timer_heap_index ==
+                            TIMER_HEAP_NO_INDEX &&
+                            test_sched_heap.size ==
+                            TEST_SCHED_HEAP_COUNT - 1,
+                            OS_NO_ERR,
+                            err,
+                            TEST_SCHEDULER_ENABLED);
+    valid = test_sched_heap_valid(&test_sched_heap);
+    TEST_POINT_ASSERT_UINT(TEST_SCHED_HEAP_INDEX1_ID,
+                           valid == TRUE,
+                           TRUE,
+                           valid,
+                           TEST_SCHEDULER_ENABLED);
+
+    err = timer_heap_remove(&test_sched_heap, removed);
+    TEST_POINT_ASSERT_RCODE(TEST_SCHED_HEAP_REMOVE1_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_SCHEDULER_ENABLED);
+
+    /* The earliest thread is sifted up to the root */
+    last              = &test_sched_heap_threads[TEST_SCHED_HEAP_COUNT];
+    last->wakeup_time = TEST_SCHED_HEAP_EARLIEST;
+    err   = timer_heap_insert(&test_sched_heap, last);
+    valid = test_sched_heap_valid(&test_sched_heap);
+    TEST_POINT_ASSERT_UINT(TEST_SCHED_HEAP_PEEK0_ID,
+                           err == OS_NO_ERR && valid == TRUE &&
+                           timer_heap_peek(&test_sched_heap) == last &&
+                           last->timer_heap_index == 1,
+                           1,
+                           last->timer_heap_index,
+                           TEST_SCHEDULER_ENABLED);
+
+    /* The expired threads come out in their wakeup time order */
+    for(i = 0; i < TEST_SCHED_HEAP_EXPIRED; ++i)
+    {
+        thread = timer_heap_pop_expired(&test_sched_heap,
+                                        TEST_SCHED_HEAP_NOW);
+        valid  = test_sched_heap_valid(&test_sched_heap);
+        TEST_POINT_ASSERT_UDWORD(TEST_SCHED_HEAP_POP(i),
+                                 thread != NULL && valid == TRUE &&
+                                 thread->wakeup_time ==
+                                 test_sched_heap_expired[i] &&
+                                 thread->timer_heap_index ==
+                                 TIMER_HEAP_NO_INDEX,
+                                 test_sched_heap_expired[i],
+                                 thread != NULL ? thread->wakeup_time : 0,
+                                 TEST_SCHEDULER_ENABLED);
+    }
+    thread = timer_heap_pop_expired(&test_sched_heap, TEST_SCHED_HEAP_NOW);
+    TEST_POINT_ASSERT_UINT(TEST_SCHED_HEAP_POP_NONE0_ID,
+                           thread == NULL,
+                           TEST_SCHED_HEAP_COUNT - TEST_SCHED_HEAP_EXPIRED,
+                           test_sched_heap.size,
+                           TEST_SCHEDULER_ENABLED);
+
+    /* The heap refuses a thread once it holds TIMER_HEAP_CAPACITY threads */
+    timer_heap_init(&test_sched_heap);
+    for(i = 0; i <= TIMER_HEAP_CAPACITY; ++i)
+    {
+        test_sched_heap_threads[i].timer_heap_index = TIMER_HEAP_NO_INDEX;
+        test_sched_heap_threads[i].wakeup_time      = i;
+    }
+    err = OS_NO_ERR;
+    for(i = 0; i < TIMER_HEAP_CAPACITY && err == OS_NO_ERR; ++i)
+    {
+        err = timer_heap_insert(&test_sched_heap,
+                                &test_sched_heap_threads[i]);
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = timer_heap_insert(&test_sched_heap,
+                                &test_sched_heap_threads[i]);
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_SCHED_HEAP_FULL0_ID,
+                            err == OS_ERR_NO_MORE_MEMORY &&
+                            test_sched_heap.size == TIMER_HEAP_CAPACITY,
+                            OS_ERR_NO_MORE_MEMORY,
+                            err,
+                            TEST_SCHEDULER_ENABLED);
+}
+
+void scheduler_test(void)
+{
+    test_sched_timer_heap();
+    test_sched_create();
+    test_sched_priority_order();
+    test_sched_round_robin();
+    test_sched_reuse();
+    test_sched_sleep();
+    test_sched_deadline();
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
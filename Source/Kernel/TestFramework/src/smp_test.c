@@ -0,0 +1,190 @@
+/*******************************************************************************
+ * @file smp_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework application processors startup testing.
+ *
+ * @details Testing framework application processors startup testing. Once the
+ * APs are started, the init thread creates one thread per AP and keeps the
+ * BSP busy: the idle APs steal the threads, that wait for each other before
+ * returning. The test checks that every started AP runs one of the threads at
+ * the same time.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <cpu.h>
+#include <cpu_interrupt.h>
+#include <scheduler.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Priority of the tested threads. */
+#define TEST_SMP_PRIO 8
+
+/** @brief Number of spin iterations after which the threads stop waiting. */
+#define TEST_SMP_SPIN_LIMIT 100000000ULL
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief CPU local storage of the CPU that ran each thread. */
+static void* volatile test_smp_cpus[MAX_CPU_COUNT];
+
+/** @brief Number of threads that started to run. */
+static volatile uint32_t test_smp_arrived;
+
+/** @brief Number of threads that returned. */
+static volatile uint32_t test_smp_done;
+
+/** @brief Number of tested threads, one per AP. */
+static uint32_t test_smp_count;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void* test_smp_routine(void* args)
+{
+    uint64_t spins;
+
+    test_smp_cpus[(uintptr_t)args] = _cpu_get_local_storage();
+    __atomic_add_fetch(&test_smp_arrived, 1, __ATOMIC_SEQ_CST);
+
+    /* The threads only all arrive if each AP runs one of them */
+    for(spins = 0;
+        test_smp_arrived < test_smp_count && spins < TEST_SMP_SPIN_LIMIT;
+        ++spins)
+    {
+        _cpu_pause();
+    }
+
+    __atomic_add_fetch(&test_smp_done, 1, __ATOMIC_SEQ_CST);
+
+    return NULL;
+}
+
+void smp_test(void)
+{
+    OS_RETURN_E err;
+    uint64_t    spins;
+    uint32_t    started;
+    uint32_t    i;
+    uint32_t    j;
+    bool_t      distinct;
+
+    started = cpu_get_started_count();
+    TEST_POINT_ASSERT_UINT(TEST_SMP_STARTED0_ID,
+                           started >= 1 && started <= MAX_CPU_COUNT,
+                           MAX_CPU_COUNT,
+                           started,
+                           TEST_SMP_ENABLED);
+
+    test_smp_count   = started - 1;
+    test_smp_arrived = 0;
+    test_smp_done    = 0;
+    for(i = 0; i < test_smp_count; ++i)
+    {
+        test_smp_cpus[i] = NULL;
+        err = scheduler_create_kernel_thread(NULL, TEST_SMP_PRIO, "test_smp",
+                                             test_smp_routine,
+                                             (void*)(uintptr_t)i);
+        TEST_POINT_ASSERT_RCODE(TEST_SMP_CREATE(i),
+                                err == OS_NO_ERR,
+                                OS_NO_ERR,
+                                err,
+                                TEST_SMP_ENABLED);
+    }
+
+    /* The init thread keeps the BSP, the APs have to steal the threads */
+    for(spins = 0;
+        test_smp_done < test_smp_count && spins < 2 * TEST_SMP_SPIN_LIMIT;
+        ++spins)
+    {
+        _cpu_pause();
+    }
+
+    TEST_POINT_ASSERT_UINT(TEST_SMP_ARRIVED0_ID,
+                           test_smp_arrived == test_smp_count &&
+                           test_smp_done == test_smp_count,
+                           test_smp_count,
+                           test_smp_arrived,
+                           TEST_SMP_ENABLED);
+
+    /* Each thread ran on its own AP */
+    distinct = TRUE;
+    for(i = 0; i < test_smp_count; ++i)
+    {
+        if(test_smp_cpus[i] == NULL ||
+           test_smp_cpus[i] == _cpu_get_local_storage())
+        {
+            distinct = FALSE;
+        }
+        for(j = 0; j < i; ++j)
+        {
+            if(test_smp_cpus[i] == test_smp_cpus[j])
+            {
+                distinct = FALSE;
+            }
+        }
+    }
+    TEST_POINT_ASSERT_UINT(TEST_SMP_DISTINCT0_ID,
+                           distinct == TRUE,
+                           TRUE,
+                           distinct,
+                           TEST_SMP_ENABLED);
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,564 @@
+/*******************************************************************************
+ * @file syscall_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework system calls testing.
+ *
+ * @details Testing framework system calls testing. Checks the registration
+ * and removal of the system calls handlers and their dispatch. Then a thread
+ * enters the user space with a small code page that issues a system call
+ * with the fast system call instruction. Once back in the user space, the
+ * code gives the returned value and its stack pointer to a second system
+ * call that ends the thread. The user code is written as machine code since
+ * the kernel has no user space loader.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <cpu.h>
+#include <critical.h>
+#include <scheduler.h>
+#include <semaphore.h>
+#include <syscall.h>
+#include <memmgt.h>
+#include <vmm.h>
+#include <cpu_interrupt.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief System call identifier of the tested handler. */
+#define TEST_SYSCALL_ID      (SYSCALL_TABLE_SIZE - 1)
+/** @brief System call identifier ending the user thread. */
+#define TEST_SYSCALL_EXIT_ID (SYSCALL_TABLE_SIZE - 2)
+
+/** @brief Value returned by the tested handler. */
+#define TEST_SYSCALL_RETURN OS_ERR_UNAUTHORIZED_ACTION
+
+/** @brief First argument given by the user code. */
+#define TEST_SYSCALL_ARG0 0x10203040
+/** @brief Second argument given by the user code. */
+#define TEST_SYSCALL_ARG1 0x11213141
+/** @brief Third argument given by the user code. */
+#define TEST_SYSCALL_ARG2 0x12223242
+/** @brief Fourth argument given by the user code. */
+#define TEST_SYSCALL_ARG3 0x13233343
+/** @brief Fifth argument given by the user code, not given on i386. */
+#define TEST_SYSCALL_ARG4 0x14243444
+
+#ifdef ARCH_64_BITS
+/** @brief Expected fifth argument. */
+#define TEST_SYSCALL_EXPECTED_ARG4 TEST_SYSCALL_ARG4
+/** @brief User code selector, the one SYSRET loads, must match cpu.c. */
+#define TEST_SYSCALL_USER_CS 0x4B
+/** @brief User stack selector, the one SYSRET loads, must match cpu.c. */
+#define TEST_SYSCALL_USER_SS 0x43
+#else
+/** @brief Expected fifth argument. */
+#define TEST_SYSCALL_EXPECTED_ARG4 0
+/** @brief User code selector, the one the SYSENTER entry loads. */
+#define TEST_SYSCALL_USER_CS 0x2B
+/** @brief User stack selector, the one the SYSENTER entry loads. */
+#define TEST_SYSCALL_USER_SS 0x33
+#endif
+
+/** @brief Initial flags of the user code, interrupts disabled. */
+#define TEST_SYSCALL_USER_FLAGS 0x2
+
+/** @brief Virtual address of the user code page. */
+#define TEST_SYSCALL_USER_CODE KERNEL_USER_SPACE_START
+/** @brief Virtual address of the user stack page. */
+#define TEST_SYSCALL_USER_STACK (KERNEL_USER_SPACE_START + VMM_PAGE_SIZE)
+/** @brief Top of the user stack. */
+#define TEST_SYSCALL_USER_STACK_TOP (TEST_SYSCALL_USER_STACK + VMM_PAGE_SIZE)
+
+/** @brief Size of the kernel stack of the user thread. */
+#define TEST_SYSCALL_KERNEL_STACK_SIZE KERNEL_STACK_SIZE
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Arguments received by the tested handler. */
+static volatile uintptr_t test_syscall_args[5];
+
+/** @brief Number of calls of the tested handler. */
+static volatile uint32_t test_syscall_calls;
+
+/** @brief Value and stack pointer given by the user code when exiting. */
+static volatile uintptr_t test_syscall_exit_args[2];
+
+/** @brief Posted by the user thread when it exits. */
+static semaphore_t test_syscall_done;
+
+/** @brief Kernel stack of the user thread. */
+static uint8_t test_syscall_kernel_stack[TEST_SYSCALL_KERNEL_STACK_SIZE]
+    __attribute__((aligned(16)));
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static OS_RETURN_E test_syscall_handler(const uintptr_t arg0,
+                                        const uintptr_t arg1,
+                                        const uintptr_t arg2,
+                                        const uintptr_t arg3,
+                                        const uintptr_t arg4)
+{
+    test_syscall_args[0] = arg0;
+    test_syscall_args[1] = arg1;
+    test_syscall_args[2] = arg2;
+    test_syscall_args[3] = arg3;
+    test_syscall_args[4] = arg4;
+    ++test_syscall_calls;
+
+    return TEST_SYSCALL_RETURN;
+}
+
+static OS_RETURN_E test_syscall_exit(const uintptr_t arg0,
+                                     const uintptr_t arg1,
+                                     const uintptr_t arg2,
+                                     const uintptr_t arg3,
+                                     const uintptr_t arg4)
+{
+    kernel_thread_t* thread;
+    uint32_t         int_state;
+
+    (void)arg2;
+    (void)arg3;
+    (void)arg4;
+
+    test_syscall_exit_args[0] = arg0;
+    test_syscall_exit_args[1] = arg1;
+
+    /* The thread cannot go back to its kernel context, end it here the way
+     * the scheduler ends the returning threads.
+     */
+    thread = scheduler_get_current_thread();
+
+    ENTER_CRITICAL(int_state);
+    (void)int_state;
+
+    (void)semaphore_post(&test_syscall_done);
+
+    thread->int_stack      = 0;
+    thread->int_stack_size = 0;
+    thread->return_state   = THREAD_RETURN_STATE_RETURNED;
+    thread->state          = THREAD_STATE_ZOMBIE;
+    scheduler_schedule();
+
+    return OS_NO_ERR;
+}
+
+static void test_syscall_emit(uint8_t* code,
+                              uint32_t* offset,
+                              const uint8_t* bytes,
+                              const uint32_t size)
+{
+    uint32_t i;
+
+    for(i = 0; i < size; ++i)
+    {
+        code[*offset + i] = bytes[i];
+    }
+    *offset += size;
+}
+
+static void test_syscall_emit_imm(uint8_t* code,
+                                  uint32_t* offset,
+                                  const uint32_t value)
+{
+    uint32_t i;
+
+    for(i = 0; i < sizeof(uint32_t); ++i)
+    {
+        code[*offset + i] = (uint8_t)(value >> (i * 8));
+    }
+    *offset += sizeof(uint32_t);
+}
+
+static void test_syscall_write_user_code(uint8_t* code)
+{
+    uint32_t offset;
+
+    offset = 0;
+
+#ifdef ARCH_64_BITS
+    /* mov eax, id, then the arguments in edi, esi, edx, r10d and r8d */
+    test_syscall_emit(code, &offset, (const uint8_t*)"\xB8", 1);
+    test_syscall_emit_imm(code, &offset, TEST_SYSCALL_ID);
+    test_syscall_emit(code, &offset, (const uint8_t*)"\xBF", 1);
+    test_syscall_emit_imm(code, &offset, TEST_SYSCALL_ARG0);
+    test_syscall_emit(code, &offset, (const uint8_t*)"\xBE", 1);
+    test_syscall_emit_imm(code, &offset, TEST_SYSCALL_ARG1);
+    test_syscall_emit(code, &offset, (const uint8_t*)"\xBA", 1);
+    test_syscall_emit_imm(code, &offset, TEST_SYSCALL_ARG2);
+    test_syscall_emit(code, &offset, (const uint8_t*)"\x41\xBA", 2);
+    test_syscall_emit_imm(code, &offset, TEST_SYSCALL_ARG3);
+    test_syscall_emit(code, &offset, (const uint8_t*)"\x41\xB8", 2);
+    test_syscall_emit_imm(code, &offset, TEST_SYSCALL_ARG4);
+
+    /* syscall, then mov rdi, rax and mov rsi, rsp */
+    test_syscall_emit(code, &offset,
+                      (const uint8_t*)"\x0F\x05\x48\x89\xC7\x48\x89\xE6", 8);
+
+    /* mov eax, exit id, syscall */
+    test_syscall_emit(code, &offset, (const uint8_t*)"\xB8", 1);
+    test_syscall_emit_imm(code, &offset, TEST_SYSCALL_EXIT_ID);
+    test_syscall_emit(code, &offset, (const uint8_t*)"\x0F\x05", 2);
+#else
+    /* mov eax, id, then the arguments in ebx, esi, edi and ebp */
+    test_syscall_emit(code, &offset, (const uint8_t*)"\xB8", 1);
+    test_syscall_emit_imm(code, &offset, TEST_SYSCALL_ID);
+    test_syscall_emit(code, &offset, (const uint8_t*)"\xBB", 1);
+    test_syscall_emit_imm(code, &offset, TEST_SYSCALL_ARG0);
+    test_syscall_emit(code, &offset, (const uint8_t*)"\xBE", 1);
+    test_syscall_emit_imm(code, &offset, TEST_SYSCALL_ARG1);
+    test_syscall_emit(code, &offset, (const uint8_t*)"\xBF", 1);
+    test_syscall_emit_imm(code, &offset, TEST_SYSCALL_ARG2);
+    test_syscall_emit(code, &offset, (const uint8_t*)"\xBD", 1);
+    test_syscall_emit_imm(code, &offset, TEST_SYSCALL_ARG3);
+
+    /* mov ecx, esp, mov edx, return address, sysenter */
+    test_syscall_emit(code, &offset, (const uint8_t*)"\x89\xE1\xBA", 3);
+    test_syscall_emit_imm(code, &offset,
+                          TEST_SYSCALL_USER_CODE + offset + 6);
+    test_syscall_emit(code, &offset, (const uint8_t*)"\x0F\x34", 2);
+
+    /* mov ebx, eax, mov esi, esp, mov eax, exit id */
+    test_syscall_emit(code, &offset, (const uint8_t*)"\x89\xC3\x89\xE6\xB8", 5);
+    test_syscall_emit_imm(code, &offset, TEST_SYSCALL_EXIT_ID);
+
+    /* mov ecx, esp, mov edx, return address, sysenter */
+    test_syscall_emit(code, &offset, (const uint8_t*)"\x89\xE1\xBA", 3);
+    test_syscall_emit_imm(code, &offset,
+                          TEST_SYSCALL_USER_CODE + offset + 6);
+    test_syscall_emit(code, &offset, (const uint8_t*)"\x0F\x34", 2);
+#endif
+
+    /* jmp $, the exit system call does not return */
+    test_syscall_emit(code, &offset, (const uint8_t*)"\xEB\xFE", 2);
+}
+
+static void* test_syscall_user_routine(void* args)
+{
+    kernel_thread_t* thread;
+    uint32_t         int_state;
+
+    (void)args;
+
+    /* Publish the kernel stack used by the system calls entry, it is loaded
+     * each time the thread is elected.
+     */
+    thread = scheduler_get_current_thread();
+    thread->int_stack      = (uintptr_t)test_syscall_kernel_stack;
+    thread->int_stack_size = TEST_SYSCALL_KERNEL_STACK_SIZE;
+    scheduler_schedule();
+
+    ENTER_CRITICAL(int_state);
+    (void)int_state;
+
+    /* Return to the user space with an interrupt return frame */
+#ifdef ARCH_64_BITS
+    __asm__ __volatile__("swapgs\n\t"
+                         "pushq %0\n\t"
+                         "pushq %1\n\t"
+                         "pushq %2\n\t"
+                         "pushq %3\n\t"
+                         "pushq %4\n\t"
+                         "iretq"
+                         :: "i" (TEST_SYSCALL_USER_SS),
+                            "r" ((uintptr_t)TEST_SYSCALL_USER_STACK_TOP),
+                            "i" (TEST_SYSCALL_USER_FLAGS),
+                            "i" (TEST_SYSCALL_USER_CS),
+                            "r" ((uintptr_t)TEST_SYSCALL_USER_CODE)
+                         : "memory");
+#else
+    __asm__ __volatile__("movw %w0, %%ds\n\t"
+                         "movw %w0, %%es\n\t"
+                         "pushl %0\n\t"
+                         "pushl %1\n\t"
+                         "pushl %2\n\t"
+                         "pushl %3\n\t"
+                         "pushl %4\n\t"
+                         "iret"
+                         :: "r" ((uint32_t)TEST_SYSCALL_USER_SS),
+                            "r" ((uintptr_t)TEST_SYSCALL_USER_STACK_TOP),
+                            "i" (TEST_SYSCALL_USER_FLAGS),
+                            "i" (TEST_SYSCALL_USER_CS),
+                            "r" ((uintptr_t)TEST_SYSCALL_USER_CODE)
+                         : "memory");
+#endif
+
+    /* We should never come back */
+    return NULL;
+}
+
+static void test_syscall_table(void)
+{
+    OS_RETURN_E err;
+
+    err = syscall_register(TEST_SYSCALL_ID, NULL);
+    TEST_POINT_ASSERT_RCODE(TEST_SYSCALL_REGISTER_NULL0_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_SYSCALL_ENABLED);
+
+    err = syscall_register(SYSCALL_TABLE_SIZE, test_syscall_handler);
+    TEST_POINT_ASSERT_RCODE(TEST_SYSCALL_REGISTER_RANGE0_ID,
+                            err == OS_ERR_NO_SUCH_SYSCALL,
+                            OS_ERR_NO_SUCH_SYSCALL,
+                            err,
+                            TEST_SYSCALL_ENABLED);
+
+    err = syscall_register(TEST_SYSCALL_ID, test_syscall_handler);
+    TEST_POINT_ASSERT_RCODE(TEST_SYSCALL_REGISTER0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_SYSCALL_ENABLED);
+
+    err = syscall_register(TEST_SYSCALL_ID, test_syscall_handler);
+    TEST_POINT_ASSERT_RCODE(TEST_SYSCALL_REGISTER1_ID,
+                            err == OS_ERR_SYSCALL_ALREADY_REGISTERED,
+                            OS_ERR_SYSCALL_ALREADY_REGISTERED,
+                            err,
+                            TEST_SYSCALL_ENABLED);
+
+    /* The dispatcher gives the arguments in order */
+    test_syscall_calls = 0;
+    err = syscall_dispatch(TEST_SYSCALL_ARG0, TEST_SYSCALL_ARG1,
+                           TEST_SYSCALL_ARG2, TEST_SYSCALL_ARG3,
+                           TEST_SYSCALL_ARG4, TEST_SYSCALL_ID);
+    TEST_POINT_ASSERT_RCODE(TEST_SYSCALL_DISPATCH0_ID,
+                            err == TEST_SYSCALL_RETURN &&
+                            test_syscall_calls == 1 &&
+                            test_syscall_args[0] == TEST_SYSCALL_ARG0 &&
+                            test_syscall_args[1] == TEST_SYSCALL_ARG1 &&
+                            test_syscall_args[2] == TEST_SYSCALL_ARG2 &&
+                            test_syscall_args[3] == TEST_SYSCALL_ARG3 &&
+                            test_syscall_args[4] == TEST_SYSCALL_ARG4,
+                            TEST_SYSCALL_RETURN,
+                            err,
+                            TEST_SYSCALL_ENABLED);
+
+    err = syscall_dispatch(0, 0, 0, 0, 0, SYSCALL_TABLE_SIZE);
+    TEST_POINT_ASSERT_RCODE(TEST_SYSCALL_DISPATCH_RANGE0_ID,
+                            err == OS_ERR_NO_SUCH_SYSCALL,
+                            OS_ERR_NO_SUCH_SYSCALL,
+                            err,
+                            TEST_SYSCALL_ENABLED);
+
+    err = syscall_remove(TEST_SYSCALL_ID);
+    TEST_POINT_ASSERT_RCODE(TEST_SYSCALL_REMOVE0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_SYSCALL_ENABLED);
+
+    err = syscall_remove(TEST_SYSCALL_ID);
+    TEST_POINT_ASSERT_RCODE(TEST_SYSCALL_REMOVE1_ID,
+                            err == OS_ERR_NO_SUCH_SYSCALL,
+                            OS_ERR_NO_SUCH_SYSCALL,
+                            err,
+                            TEST_SYSCALL_ENABLED);
+
+    /* A removed handler is not called anymore */
+    err = syscall_dispatch(0, 0, 0, 0, 0, TEST_SYSCALL_ID);
+    TEST_POINT_ASSERT_RCODE(TEST_SYSCALL_DISPATCH_REMOVED0_ID,
+                            err == OS_ERR_NO_SUCH_SYSCALL &&
+                            test_syscall_calls == 1,
+                            OS_ERR_NO_SUCH_SYSCALL,
+                            err,
+                            TEST_SYSCALL_ENABLED);
+}
+
+static void test_syscall_round_trip(void)
+{
+    OS_RETURN_E      err;
+    kernel_thread_t* current;
+    uintptr_t        code_frame;
+    uintptr_t        stack_frame;
+
+    code_frame  = 0;
+    stack_frame = 0;
+
+    err = memmgt_alloc_frames(0, &code_frame);
+    if(err == OS_NO_ERR)
+    {
+        err = memmgt_alloc_frames(0, &stack_frame);
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = vmm_map(TEST_SYSCALL_USER_CODE, code_frame, VMM_PAGE_SIZE,
+                      VMM_FLAG_WRITE | VMM_FLAG_USER);
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = vmm_map(TEST_SYSCALL_USER_STACK, stack_frame, VMM_PAGE_SIZE,
+                      VMM_FLAG_WRITE | VMM_FLAG_USER);
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_SYSCALL_USER_MAP0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_SYSCALL_ENABLED);
+
+    if(err == OS_NO_ERR)
+    {
+        test_syscall_write_user_code((uint8_t*)TEST_SYSCALL_USER_CODE);
+        err = syscall_register(TEST_SYSCALL_ID, test_syscall_handler);
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = syscall_register(TEST_SYSCALL_EXIT_ID, test_syscall_exit);
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = semaphore_init(&test_syscall_done, 0);
+    }
+
+    test_syscall_calls        = 0;
+    test_syscall_exit_args[0] = 0;
+    test_syscall_exit_args[1] = 0;
+
+    /* The user thread enters the user space and comes back through the
+     * system calls only.
+     */
+    current = scheduler_get_current_thread();
+    if(err == OS_NO_ERR)
+    {
+        err = scheduler_create_kernel_thread(NULL, current->priority,
+                                             "syscall_test",
+                                             test_syscall_user_routine,
+                                             NULL);
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = semaphore_wait(&test_syscall_done);
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_SYSCALL_USER_THREAD0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_SYSCALL_ENABLED);
+
+    TEST_POINT_ASSERT_UINT(TEST_SYSCALL_USER_CALL0_ID,
+                           test_syscall_calls == 1,
+                           1,
+                           test_syscall_calls,
+                           TEST_SYSCALL_ENABLED);
+
+    TEST_POINT_ASSERT_UDWORD(TEST_SYSCALL_USER_ARGS0_ID,
+                             test_syscall_args[0] == TEST_SYSCALL_ARG0 &&
+                             test_syscall_args[1] == TEST_SYSCALL_ARG1 &&
+                             test_syscall_args[2] == TEST_SYSCALL_ARG2 &&
+                             test_syscall_args[3] == TEST_SYSCALL_ARG3,
+                             (uint64_t)TEST_SYSCALL_ARG3,
+                             (uint64_t)test_syscall_args[3],
+                             TEST_SYSCALL_ENABLED);
+
+    TEST_POINT_ASSERT_UDWORD(TEST_SYSCALL_USER_ARGS1_ID,
+                             test_syscall_args[4] ==
+                             TEST_SYSCALL_EXPECTED_ARG4,
+                             (uint64_t)TEST_SYSCALL_EXPECTED_ARG4,
+                             (uint64_t)test_syscall_args[4],
+                             TEST_SYSCALL_ENABLED);
+
+    /* The user code got the handler return value and its own stack back */
+    TEST_POINT_ASSERT_RCODE(TEST_SYSCALL_USER_RETURN0_ID,
+                            (uint32_t)test_syscall_exit_args[0] ==
+                            TEST_SYSCALL_RETURN,
+                            TEST_SYSCALL_RETURN,
+                            (uint32_t)test_syscall_exit_args[0],
+                            TEST_SYSCALL_ENABLED);
+
+    TEST_POINT_ASSERT_UDWORD(TEST_SYSCALL_USER_STACK0_ID,
+                             test_syscall_exit_args[1] ==
+                             TEST_SYSCALL_USER_STACK_TOP,
+                             (uint64_t)TEST_SYSCALL_USER_STACK_TOP,
+                             (uint64_t)test_syscall_exit_args[1],
+                             TEST_SYSCALL_ENABLED);
+
+    err = syscall_remove(TEST_SYSCALL_ID);
+    if(err == OS_NO_ERR)
+    {
+        err = syscall_remove(TEST_SYSCALL_EXIT_ID);
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = vmm_unmap(TEST_SYSCALL_USER_CODE, 2 * VMM_PAGE_SIZE);
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = memmgt_free_frames(code_frame, 0);
+    }
+    if(err == OS_NO_ERR)
+    {
+        err = memmgt_free_frames(stack_frame, 0);
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_SYSCALL_USER_UNMAP0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_SYSCALL_ENABLED);
+}
+
+void syscall_test(void)
+{
+    test_syscall_table();
+    test_syscall_round_trip();
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
@@ -12,7 +12,10 @@
  * @brief Testing framework.
  *
  * @details Testing framework. This modules allows to add dynamic test points
- * to the kernel an run a test suite.
+ * to the kernel an run a test suite. The test points results are stored in a
+ * bounded array of packed records and output in batches while the suite runs,
+ * one tagged JSON line per record. The memory usage is output with the
+ * benchmarks results.
  *
  * @copyright Alexy Torres Aurora Dugo
  ******************************************************************************/
@@ -29,6 +32,11 @@
 #include <stddef.h>        /* Standard definitions */
 #include <panic.h>         /* Kernel panic */
 #include <kerror.h>        /* Kernel errors */
+#include <cpu.h>           /* CPU timestamps */
+#include <cpu_features.h>  /* CPU features alternatives */
+#include <interrupts.h>    /* Interrupts state */
+#include <gcov.h>          /* Profile collection */
+#include <memstat.h>       /* Memory usage statistics */
 
 /* Configuration files */
 #include <config.h>
@@ -41,14 +49,33 @@
  ******************************************************************************/
 
 /** @brief Testing framework version. */
-#define TEST_FRAMEWORK_VERSION "0.5"
+#define TEST_FRAMEWORK_VERSION "0.7"
 
-/** @brief Testing framework memory pool size. */
-#define TEST_FRAMEWORK_MEM_POOL_SIZE 0x9000
+/** @brief Testing framework memory pool size, used by the benchmarks. */
+#define TEST_FRAMEWORK_MEM_POOL_SIZE 0x1000
+
+/** @brief Number of test records waiting to be output. */
+#define TEST_FRAMEWORK_RECORD_COUNT 256
+
+/** @brief Number of waiting test records that starts an output. */
+#define TEST_FRAMEWORK_STREAM_BATCH 16
+
+/** @brief Prefix of the tests results lines. */
+#define TEST_FRAMEWORK_STREAM_TAG "#TEST# "
+
+#ifndef _KERNEL_BUILD_MODE
+/** @brief Build mode of the kernel, given by the build settings. */
+#define _KERNEL_BUILD_MODE "unknown"
+#endif
 
 /** @brief Defines the current module's name. */
 #define MODULE_NAME "TEST FRAMEWORK"
 
+/** @brief Number of empty measures used to compute the time stamp counter
+ * reading overhead.
+ */
+#define TEST_FRAMEWORK_BENCH_CALIBRATION 256
+
 /*******************************************************************************
  * STRUCTURES AND TYPES
  ******************************************************************************/
@@ -68,18 +95,34 @@ typedef enum
     TEST_TYPE_RCODE  = 10,
 } TEST_ITEM_TYPE_E;
 
-typedef struct test_item
+typedef struct
 {
-    bool_t   status;
     uint64_t value;
     uint64_t expected;
     uint32_t id;
+    uint8_t  status;
+    uint8_t  type;
+} __attribute__((packed)) test_record_t;
 
-    TEST_ITEM_TYPE_E type;
 
-    struct test_item* next;
-} test_item_t;
+typedef struct test_bench
+{
+    const char* name;
 
+    test_bench_routine_t routine;
+    void*                args;
+
+    uint32_t warmup;
+    uint32_t iterations;
+
+    bool_t   done;
+    uint64_t min;
+    uint64_t median;
+    uint64_t p99;
+    uint64_t max;
+
+    struct test_bench* next;
+} test_bench_t;
 
 typedef union
 {
@@ -142,17 +185,29 @@ static uint8_t memoryPool[TEST_FRAMEWORK_MEM_POOL_SIZE];
 /** @brief Memory pool head pointer. */
 static uint8_t* memoryPoolHead = NULL;
 
-/** @brief Test items list head */
-test_item_t* test_list = NULL;
+/** @brief Test records waiting to be output, indexed modulo their count. */
+static test_record_t test_records[TEST_FRAMEWORK_RECORD_COUNT];
+
+/** @brief Number of test records added since the start of the suite. */
+static uint32_t record_head = 0;
+
+/** @brief Number of test records output since the start of the suite. */
+static uint32_t record_tail = 0;
 
-/** @brief Final test when allocation failed */
-test_item_t null_test_item = {
-    .expected = -1,
-    .id       = -1,
-    .type     = TEST_TYPE_BYTE,
-    .value    = -1,
-    .status   = FALSE
-};
+/** @brief Tells if the results header was output. */
+static bool_t stream_started = FALSE;
+
+/** @brief Registered benchmarks list head, in registration order. */
+static test_bench_t* bench_list = NULL;
+
+/** @brief Registered benchmarks list tail. */
+static test_bench_t* bench_list_tail = NULL;
+
+/** @brief Cycles samples of the benchmark being run. */
+static uint64_t bench_samples[TEST_FRAMEWORK_BENCH_MAX_ITERATIONS];
+
+/** @brief Cycles spent reading the time stamp counter around a measure. */
+static uint64_t bench_overhead = 0;
 
 /*******************************************************************************
  * STATIC FUNCTIONS DECLARATIONS
@@ -160,14 +215,34 @@ test_item_t null_test_item = {
 
 static void * _get_test_memory(const size_t size);
 
-static void _init_test_item(const uint32_t test_id,
-                            const bool_t condition,
-                            const uint64_t expected,
-                            const uint64_t value,
-                            test_item_t** item);
+static void _add_test_record(const uint32_t test_id,
+                             const bool_t condition,
+                             const uint64_t expected,
+                             const uint64_t value,
+                             const TEST_ITEM_TYPE_E type);
+
+static void _stream_start(void);
+
+static void _stream_records(void);
+
+static void _stream_bench(const test_bench_t* bench);
+
+static void _stream_memory(void);
 
 void _kill_qemu(void);
 
+inline static uint64_t _bench_tsc_start(void);
+
+inline static uint64_t _bench_tsc_end(void);
+
+static void _bench_empty(void* args);
+
+static void _bench_sort(uint64_t* samples, const uint32_t count);
+
+static void _bench_calibrate(void);
+
+static void _bench_measure(test_bench_t* bench);
+
 /*******************************************************************************
  * FUNCTIONS
  ******************************************************************************/
@@ -189,52 +264,175 @@ static void * _get_test_memory(const size_t size)
     return address;
 }
 
-static void _init_test_item(const uint32_t test_id,
-                            const bool_t condition,
-                            const uint64_t expected,
-                            const uint64_t value,
-                            test_item_t** item)
+static void _add_test_record(const uint32_t test_id,
+                             const bool_t condition,
+                             const uint64_t expected,
+                             const uint64_t value,
+                             const TEST_ITEM_TYPE_E type)
 {
-    /* Create test item and allocate memory */
-    *item = _get_test_memory(sizeof(test_item_t));
-    if(*item != NULL)
+    test_record_t* record;
+    uint32_t       int_state;
+    uint32_t       pending;
+
+    /* Make room for the record */
+    if(record_head - record_tail == TEST_FRAMEWORK_RECORD_COUNT)
     {
-        /* Setup information */
-        (*item)->id       = test_id;
-        (*item)->status   = condition;
-        (*item)->expected = expected;
-        (*item)->value    = value;
-
-        /* If the condition is expected then increment */
-        if(condition == TRUE)
-        {
-            ++success;
-        }
-        else
-        {
-            ++failures;
-        }
-        ++test_count;
+        _stream_records();
+    }
+
+    int_state = kernel_interrupt_disable();
 
-        /* Link test */
-        (*item)->next = test_list;
-        test_list = *item;
+    record = &test_records[record_head % TEST_FRAMEWORK_RECORD_COUNT];
+    record->id       = test_id;
+    record->status   = condition;
+    record->expected = expected;
+    record->value    = value;
+    record->type     = type;
+    ++record_head;
+
+    if(condition == TRUE)
+    {
+        ++success;
     }
     else
     {
-        /* Link NULL test item */
         ++failures;
-        ++test_count;
+    }
+    ++test_count;
+
+    pending = record_head - record_tail;
+
+    kernel_interrupt_restore(int_state);
+
+    /* Test points reached with interrupts disabled only add their record */
+    if(pending >= TEST_FRAMEWORK_STREAM_BATCH && int_state != 0)
+    {
+        _stream_records();
+    }
+}
+
+static void _stream_start(void)
+{
+    if(stream_started == TRUE)
+    {
+        return;
+    }
+    stream_started = TRUE;
 
-        /* Link test */
-        if(test_list != &null_test_item)
+    kernel_printf("\n" TEST_FRAMEWORK_STREAM_TAG
+                  "{\"header\": {\"version\": \"" TEST_FRAMEWORK_VERSION
+                  "\", \"name\": \"" TEST_FRAMEWORK_TEST_NAME
+                  "\", \"build\": \"" _KERNEL_BUILD_MODE "\"}}\n");
+}
+
+static void _stream_records(void)
+{
+    test_record_t record;
+    uint32_t      int_state;
+
+    _stream_start();
+
+    while(TRUE)
+    {
+        int_state = kernel_interrupt_disable();
+        if(record_tail == record_head)
         {
+            kernel_interrupt_restore(int_state);
+            break;
+        }
+        record = test_records[record_tail % TEST_FRAMEWORK_RECORD_COUNT];
+        ++record_tail;
+        kernel_interrupt_restore(int_state);
+
+        /* One line per record, other messages can be output in between */
+        kernel_printf(TEST_FRAMEWORK_STREAM_TAG
+                      "{\"test\": {\"id\": %u, \"result\": %llu, "
+                      "\"expected\": %llu, \"status\": %u, "
+                      "\"type\": %u}}\n",
+                      record.id, record.value, record.expected,
+                      record.status, record.type);
+    }
+}
+
+static void _stream_bench(const test_bench_t* bench)
+{
+    _stream_start();
+
+    kernel_printf(TEST_FRAMEWORK_STREAM_TAG
+                  "{\"bench\": {\"name\": \"%s\", \"iterations\": %u, "
+                  "\"completed\": %u, \"min\": %llu, \"median\": %llu, "
+                  "\"p99\": %llu, \"max\": %llu}}\n",
+                  bench->name, bench->iterations, bench->done, bench->min,
+                  bench->median, bench->p99, bench->max);
+}
+
+static void _stream_memory(void)
+{
+    memstat_snapshot_t    snapshot;
+    const memstat_site_t* sites;
+    uint32_t              i;
+
+    _stream_start();
+
+    /* The physical memory is not managed yet in the early suites */
+    if(memstat_snapshot(&snapshot) != OS_NO_ERR)
+    {
+        return;
+    }
 
-            null_test_item.next = test_list;
-            test_list = &null_test_item;
+    kernel_printf(TEST_FRAMEWORK_STREAM_TAG
+                  "{\"memory\": {\"elapsed_ns\": %llu, "
+                  "\"free_frames\": %llu, \"hot_frames\": %llu, "
+                  "\"free_blocks\": [",
+                  snapshot.elapsed_ns,
+                  (uint64_t)snapshot.frames.free_frames,
+                  (uint64_t)snapshot.frames.hot_frames);
+    for(i = 0; i <= MEMMGT_MAX_ORDER; ++i)
+    {
+        kernel_printf("%s%llu", (i != 0) ? ", " : "",
+                      (uint64_t)snapshot.frames.free_blocks[i]);
+    }
+    kernel_printf("], \"unusable\": [");
+    for(i = 0; i <= MEMMGT_MAX_ORDER; ++i)
+    {
+        kernel_printf("%s%u", (i != 0) ? ", " : "", snapshot.unusable[i]);
+    }
+    kernel_printf("]}}\n");
+
+#if KERNEL_MEMSTAT
+    for(i = 0; i < MEMSTAT_CLASS_COUNT; ++i)
+    {
+        kernel_printf(TEST_FRAMEWORK_STREAM_TAG
+                      "{\"memory_class\": {\"size\": %llu, "
+                      "\"allocations\": %llu, \"frees\": %llu, "
+                      "\"failures\": %llu, \"live\": %llu, "
+                      "\"peak\": %llu}}\n",
+                      (uint64_t)snapshot.class_sizes[i],
+                      snapshot.classes[i].allocations,
+                      snapshot.classes[i].frees,
+                      snapshot.classes[i].failures,
+                      snapshot.classes[i].live_bytes,
+                      snapshot.classes[i].peak_bytes);
+    }
+#endif
+
+    sites = memstat_get_sites(&snapshot.site_count);
+    for(i = 0; i < snapshot.site_count; ++i)
+    {
+        if(sites[i].allocations == 0 && sites[i].failures == 0)
+        {
+            continue;
         }
 
-        *item = &null_test_item;
+        kernel_printf(TEST_FRAMEWORK_STREAM_TAG
+                      "{\"memory_site\": {\"site\": \"%s:%u\", "
+                      "\"allocations\": %llu, \"frees\": %llu, "
+                      "\"failures\": %llu, \"requested\": %llu, "
+                      "\"live\": %llu, \"peak\": %llu}}\n",
+                      sites[i].file, sites[i].line,
+                      sites[i].allocations, sites[i].frees,
+                      sites[i].failures, sites[i].requested_bytes,
+                      sites[i].live_bytes, sites[i].peak_bytes);
     }
 }
 
@@ -248,54 +446,162 @@ void _kill_qemu(void)
 }
 
 
-void test_framework_init(void)
+inline static uint64_t _bench_tsc_start(void)
 {
-    memoryPoolHead = memoryPool;
+    uint32_t low;
+    uint32_t high;
+
+    /* The previous instructions complete before the counter is read and the
+     * measured ones start after
+     */
+    __asm__ __volatile__("lfence\n\t"
+                         "rdtsc\n\t"
+                         "lfence" : "=a" (low), "=d" (high) :: "memory");
+
+    return ((uint64_t)high << 32) | low;
 }
 
-void test_framework_end(void)
+inline static uint64_t _bench_tsc_end(void)
 {
-    uint32_t i;
+    uint32_t low;
+    uint32_t high;
+    uint32_t aux;
 
-    test_item_t* test_cursor;
+    /* RDTSCP waits for the measured instructions to complete */
+    if(CPU_FEATURE_STATIC(CPU_FEATURE_RDTSCP))
+    {
+        __asm__ __volatile__("rdtscp\n\t"
+                             "lfence" : "=a" (low), "=d" (high), "=c" (aux)
+                                      :: "memory");
+        (void)aux;
+    }
+    else
+    {
+        __asm__ __volatile__("lfence\n\t"
+                             "rdtsc" : "=a" (low), "=d" (high) :: "memory");
+    }
 
-    /* Print output header */
-    kernel_printf("\n#-------- TESTING SECTION START --------#\n");
-    kernel_printf("{\n");
-    kernel_printf("\t\"version\": \"" TEST_FRAMEWORK_VERSION "\",\n");
-    kernel_printf("\t\"name\": \"" TEST_FRAMEWORK_TEST_NAME "\",\n");
-    kernel_printf("\t\"number_of_tests\": %d,\n", test_count);
-    kernel_printf("\t\"failures\": %d,\n", failures);
-    kernel_printf("\t\"success\": %d,\n", success);
-    kernel_printf("\t\"test_suite\": {\n");
+    return ((uint64_t)high << 32) | low;
+}
 
-    test_cursor = test_list;
+static void _bench_empty(void* args)
+{
+    (void)args;
+}
 
-    for(i = 0; i < test_count && test_cursor != NULL; ++i)
+static void _bench_sort(uint64_t* samples, const uint32_t count)
+{
+    uint32_t i;
+    uint32_t j;
+    uint64_t value;
+
+    for(i = 1; i < count; ++i)
     {
-        kernel_printf("\t\t\"%d\": {\n", test_cursor->id);
+        value = samples[i];
+        for(j = i; j > 0 && samples[j - 1] > value; --j)
+        {
+            samples[j] = samples[j - 1];
+        }
+        samples[j] = value;
+    }
+}
 
-        kernel_printf("\t\t\t\"result\": %d,\n", test_cursor->value);
-        kernel_printf("\t\t\t\"expected\": %d,\n", test_cursor->expected);
-        kernel_printf("\t\t\t\"status\": %d,\n", test_cursor->status);
-        kernel_printf("\t\t\t\"type\": %d\n", test_cursor->type);
+static void _bench_calibrate(void)
+{
+    uint32_t i;
+    uint64_t start;
+    uint64_t cycles;
 
-        kernel_printf("\t\t}");
-        if(i < test_count - 1)
+    /* Keep the cheapest empty measure, the other ones were disturbed */
+    bench_overhead = (uint64_t)-1;
+    for(i = 0; i < TEST_FRAMEWORK_BENCH_CALIBRATION; ++i)
+    {
+        start = _bench_tsc_start();
+        _bench_empty(NULL);
+        cycles = _bench_tsc_end() - start;
+        if(cycles < bench_overhead)
         {
-            kernel_printf(",\n");
+            bench_overhead = cycles;
         }
-        else
+    }
+}
+
+static void _bench_measure(test_bench_t* bench)
+{
+    uint32_t i;
+    uint32_t int_state;
+    uint64_t start;
+    uint64_t cycles;
+
+    int_state = kernel_interrupt_disable();
+
+    for(i = 0; i < bench->warmup; ++i)
+    {
+        bench->routine(bench->args);
+    }
+
+    for(i = 0; i < bench->iterations; ++i)
+    {
+        start = _bench_tsc_start();
+        bench->routine(bench->args);
+        cycles = _bench_tsc_end() - start;
+
+        bench_samples[i] = (cycles > bench_overhead) ?
+                           cycles - bench_overhead : 0;
+    }
+
+    kernel_interrupt_restore(int_state);
+
+    _bench_sort(bench_samples, bench->iterations);
+
+    bench->min    = bench_samples[0];
+    bench->median = bench_samples[bench->iterations / 2];
+    bench->p99    = bench_samples[(bench->iterations * 99) / 100];
+    bench->max    = bench_samples[bench->iterations - 1];
+    bench->done   = TRUE;
+}
+
+void test_framework_init(void)
+{
+    memoryPoolHead = memoryPool;
+}
+
+void test_framework_end(void)
+{
+    test_bench_t* bench_cursor;
+
+    /* The results are output directly, after the messages still stored in
+     * the kernel log
+     */
+    (void)kernel_interrupt_disable();
+    kernel_output_disable_log();
+    kernel_output_drain_log();
+
+    _stream_records();
+
+    /* Benchmarks that were not run */
+    for(bench_cursor = bench_list;
+        bench_cursor != NULL;
+        bench_cursor = bench_cursor->next)
+    {
+        if(bench_cursor->done == FALSE)
         {
-            kernel_printf("\n");
+            _stream_bench(bench_cursor);
         }
-
-        test_cursor = test_cursor->next;
     }
 
-    kernel_printf("\t}\n");
-    kernel_printf("}\n");
-    kernel_printf("#-------- TESTING SECTION END --------#\n");
+    _stream_memory();
+
+    kernel_printf(TEST_FRAMEWORK_STREAM_TAG
+                  "{\"summary\": {\"number_of_tests\": %u, "
+                  "\"failures\": %u, \"success\": %u, "
+                  "\"bench_overhead\": %llu}}\n",
+                  test_count, failures, success, bench_overhead);
+
+#ifdef _PGO_GENERATE_ENABLED
+    /* The profile of the instrumented build follows the results */
+    gcov_dump();
+#endif
 
     _kill_qemu();
 }
@@ -305,17 +611,11 @@ void test_framework_assert_uint(const uint32_t test_id,
                                 const uint32_t expected,
                                 const uint32_t value)
 {
-    test_item_t* item;
-
-    /* Init */
-    _init_test_item(test_id,
-                    condition,
-                    (uint64_t)expected,
-                    (uint64_t)value,
-                    &item);
-
-    /* Set additional data */
-    item->type = TEST_TYPE_UDWORD;
+    _add_test_record(test_id,
+                     condition,
+                     (uint64_t)expected,
+                     (uint64_t)value,
+                     TEST_TYPE_UDWORD);
 }
 
 void test_framework_assert_int(const uint32_t test_id,
@@ -323,17 +623,11 @@ void test_framework_assert_int(const uint32_t test_id,
                                const int32_t expected,
                                const int32_t value)
 {
-    test_item_t* item;
-
-    /* Init */
-    _init_test_item(test_id,
-                    condition,
-                    (uint64_t)expected,
-                    (uint64_t)value,
-                    &item);
-
-    /* Set additional data */
-    item->type = TEST_TYPE_DWORD;
+    _add_test_record(test_id,
+                     condition,
+                     (uint64_t)expected,
+                     (uint64_t)value,
+                     TEST_TYPE_DWORD);
 }
 
 void test_framework_assert_huint(const uint32_t test_id,
@@ -341,17 +635,11 @@ void test_framework_assert_huint(const uint32_t test_id,
                                  const uint16_t expected,
                                  const uint16_t value)
 {
-    test_item_t* item;
-
-    /* Init */
-    _init_test_item(test_id,
-                    condition,
-                    (uint64_t)expected,
-                    (uint64_t)value,
-                    &item);
-
-    /* Set additional data */
-    item->type = TEST_TYPE_UHALF;
+    _add_test_record(test_id,
+                     condition,
+                     (uint64_t)expected,
+                     (uint64_t)value,
+                     TEST_TYPE_UHALF);
 }
 
 void test_framework_assert_hint(const uint32_t test_id,
@@ -359,17 +647,11 @@ void test_framework_assert_hint(const uint32_t test_id,
                                 const int16_t expected,
                                 const int16_t value)
 {
-    test_item_t* item;
-
-    /* Init */
-    _init_test_item(test_id,
-                    condition,
-                    (uint64_t)expected,
-                    (uint64_t)value,
-                    &item);
-
-    /* Set additional data */
-    item->type = TEST_TYPE_HALF;
+    _add_test_record(test_id,
+                     condition,
+                     (uint64_t)expected,
+                     (uint64_t)value,
+                     TEST_TYPE_HALF);
 }
 
 void test_framework_assert_ubyte(const uint32_t test_id,
@@ -377,17 +659,11 @@ void test_framework_assert_ubyte(const uint32_t test_id,
                                  const uint8_t expected,
                                  const uint8_t value)
 {
-    test_item_t* item;
-
-    /* Init */
-    _init_test_item(test_id,
-                    condition,
-                    (uint64_t)expected,
-                    (uint64_t)value,
-                    &item);
-
-    /* Set additional data */
-    item->type = TEST_TYPE_UBYTE;
+    _add_test_record(test_id,
+                     condition,
+                     (uint64_t)expected,
+                     (uint64_t)value,
+                     TEST_TYPE_UBYTE);
 }
 
 void test_framework_assert_byte(const uint32_t test_id,
@@ -395,17 +671,11 @@ void test_framework_assert_byte(const uint32_t test_id,
                                 const uint8_t expected,
                                 const uint8_t value)
 {
-    test_item_t* item;
-
-    /* Init */
-    _init_test_item(test_id,
-                    condition,
-                    (uint64_t)expected,
-                    (uint64_t)value,
-                    &item);
-
-    /* Set additional data */
-    item->type = TEST_TYPE_BYTE;
+    _add_test_record(test_id,
+                     condition,
+                     (uint64_t)expected,
+                     (uint64_t)value,
+                     TEST_TYPE_BYTE);
 }
 
 void test_framework_assert_udword(const uint32_t test_id,
@@ -413,17 +683,11 @@ void test_framework_assert_udword(const uint32_t test_id,
                                   const uint64_t expected,
                                   const uint64_t value)
 {
-    test_item_t* item;
-
-    /* Init */
-    _init_test_item(test_id,
-                    condition,
-                    expected,
-                    value,
-                    &item);
-
-    /* Set additional data */
-    item->type = TEST_TYPE_UDWORD;
+    _add_test_record(test_id,
+                     condition,
+                     expected,
+                     value,
+                     TEST_TYPE_UDWORD);
 }
 
 void test_framework_assert_dword(const uint32_t test_id,
@@ -431,17 +695,11 @@ void test_framework_assert_dword(const uint32_t test_id,
                                  const int64_t expected,
                                  const int64_t value)
 {
-    test_item_t* item;
-
-    /* Init */
-    _init_test_item(test_id,
-                    condition,
-                    (uint64_t)expected,
-                    (uint64_t)value,
-                    &item);
-
-    /* Set additional data */
-    item->type = TEST_TYPE_DWORD;
+    _add_test_record(test_id,
+                     condition,
+                     (uint64_t)expected,
+                     (uint64_t)value,
+                     TEST_TYPE_DWORD);
 }
 
 void test_framework_assert_float(const uint32_t test_id,
@@ -449,21 +707,16 @@ void test_framework_assert_float(const uint32_t test_id,
                                  const float expected,
                                  const float value)
 {
-    test_item_t* item;
     float_raw_t  float_conv_expected;
     float_raw_t  float_conv_value;
 
-    /* Init */
     float_conv_expected.float_value = expected;
     float_conv_value.float_value = value;
-    _init_test_item(test_id,
-                    condition,
-                    (uint64_t)float_conv_expected.raw_value,
-                    (uint64_t)float_conv_value.raw_value,
-                    &item);
-
-    /* Set additional data */
-    item->type = TEST_TYPE_FLOAT;
+    _add_test_record(test_id,
+                     condition,
+                     (uint64_t)float_conv_expected.raw_value,
+                     (uint64_t)float_conv_value.raw_value,
+                     TEST_TYPE_FLOAT);
 }
 
 void test_framework_assert_double(const uint32_t test_id,
@@ -471,21 +724,16 @@ void test_framework_assert_double(const uint32_t test_id,
                                   const double expected,
                                   const double value)
 {
-    test_item_t* item;
     double_raw_t double_conv_expected;
     double_raw_t double_conv_value;
 
-    /* Init */
     double_conv_expected.double_value = expected;
     double_conv_value.double_value = value;
-    _init_test_item(test_id,
-                    condition,
-                    double_conv_expected.raw_value,
-                    double_conv_value.raw_value,
-                    &item);
-
-    /* Set additional data */
-    item->type = TEST_TYPE_DOUBLE;
+    _add_test_record(test_id,
+                     condition,
+                     double_conv_expected.raw_value,
+                     double_conv_value.raw_value,
+                     TEST_TYPE_DOUBLE);
 }
 
 void test_framework_assert_errcode(const uint32_t test_id,
@@ -493,17 +741,73 @@ void test_framework_assert_errcode(const uint32_t test_id,
                                    const OS_RETURN_E expected,
                                    const OS_RETURN_E value)
 {
-    test_item_t* item;
+    _add_test_record(test_id,
+                     condition,
+                     (uint64_t)expected,
+                     (uint64_t)value,
+                     TEST_TYPE_RCODE);
+}
 
-    /* Init */
-    _init_test_item(test_id,
-                    condition,
-                    (uint64_t)expected,
-                    (uint64_t)value,
-                    &item);
+void test_framework_bench_register(const char* name,
+                                   test_bench_routine_t routine,
+                                   void* args,
+                                   const uint32_t warmup,
+                                   const uint32_t iterations)
+{
+    test_bench_t* bench;
+
+    TEST_ASSERT(name != NULL && routine != NULL && iterations != 0,
+                "Invalid benchmark", OS_ERR_NULL_POINTER);
+
+    bench = _get_test_memory(sizeof(test_bench_t));
+    TEST_ASSERT(bench != NULL, "Could not allocate the benchmark",
+                OS_ERR_NO_MORE_MEMORY);
+
+    bench->name       = name;
+    bench->routine    = routine;
+    bench->args       = args;
+    bench->warmup     = warmup;
+    bench->iterations = iterations;
+    if(bench->iterations > TEST_FRAMEWORK_BENCH_MAX_ITERATIONS)
+    {
+        bench->iterations = TEST_FRAMEWORK_BENCH_MAX_ITERATIONS;
+    }
+    bench->done   = FALSE;
+    bench->min    = 0;
+    bench->median = 0;
+    bench->p99    = 0;
+    bench->max    = 0;
+    bench->next   = NULL;
+
+    /* Keep the registration order */
+    if(bench_list_tail == NULL)
+    {
+        bench_list = bench;
+    }
+    else
+    {
+        bench_list_tail->next = bench;
+    }
+    bench_list_tail = bench;
+}
+
+void test_framework_bench_run(void)
+{
+    test_bench_t* bench;
+
+    /* Do not output the waiting records between the measures */
+    _stream_records();
 
-    /* Set additional data */
-    item->type = TEST_TYPE_RCODE;
+    _bench_calibrate();
+
+    for(bench = bench_list; bench != NULL; bench = bench->next)
+    {
+        if(bench->done == FALSE)
+        {
+            _bench_measure(bench);
+            _stream_bench(bench);
+        }
+    }
 }
 
 
@@ -0,0 +1,366 @@
+/*******************************************************************************
+ * @file ustar_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework USTAR driver testing.
+ *
+ * @details Testing framework USTAR driver testing. Checks the entries of the
+ * initial ram disk mounted on the VFS root by the first open: the path
+ * normalization, the entries types and sizes, the data read through the block
+ * cache and the errors of the mounts, lookups and reads. The expected entries
+ * are the ones of the initrd folder of the architecture configuration.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <string.h>
+#include <initrd.h>
+#include <blkdev.h>
+#include <bcache.h>
+#include <vfs.h>
+#include <ustar.h>
+#include <initcall.h>
+#include <cpu_interrupt.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Path of the tested file at the archive root. */
+#define TEST_USTAR_FILE_PATH "/fil1.test"
+/** @brief Content of the tested file at the archive root. */
+#define TEST_USTAR_FILE_DATA "Coucous Truncate me"
+/** @brief Size of the tested file at the archive root. */
+#define TEST_USTAR_FILE_SIZE (sizeof(TEST_USTAR_FILE_DATA) - 1)
+
+/** @brief Path of the tested file in a folder, with extra '/'. */
+#define TEST_USTAR_NESTED_PATH "/folder1/smallfile.txt/"
+/** @brief Content of the tested file in a folder. */
+#define TEST_USTAR_NESTED_DATA "I am smol"
+/** @brief Size of the tested file in a folder. */
+#define TEST_USTAR_NESTED_SIZE (sizeof(TEST_USTAR_NESTED_DATA) - 1)
+
+/** @brief Path of the tested empty file. */
+#define TEST_USTAR_EMPTY_PATH \
+    "/folder1/anotherfolder/myfileinfolder - Copie.txt"
+
+/** @brief Path of the tested folder. */
+#define TEST_USTAR_FOLDER_PATH "/folder1/"
+
+/** @brief Path of an entry that is not in the archive. */
+#define TEST_USTAR_MISSING_PATH "/folder1/smallfile"
+
+/** @brief Offset of the tested read. */
+#define TEST_USTAR_READ_OFFSET 8
+
+/** @brief Mount point of the corrupted archive. */
+#define TEST_USTAR_CORRUPT_PATH "/ustar_test"
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/** @brief Corrupted archive device, mounting it must fail. */
+static blkdev_t test_ustar_corrupt_dev;
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/**
+ * @brief Reads the blocks of the corrupted archive device.
+ *
+ * @details Reads the blocks of the corrupted archive device: every block holds
+ * a named header without the USTAR magic.
+ *
+ * @param[in] dev The device.
+ * @param[in] block The first block to read.
+ * @param[in] count The number of blocks to read.
+ * @param[out] buffer The buffer receiving the blocks.
+ *
+ * @return OS_NO_ERR is always returned.
+ */
+static OS_RETURN_E _test_ustar_corrupt_read(blkdev_t* dev,
+                                            const uint64_t block,
+                                            const uint32_t count,
+                                            void* buffer);
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static OS_RETURN_E _test_ustar_corrupt_read(blkdev_t* dev,
+                                            const uint64_t block,
+                                            const uint32_t count,
+                                            void* buffer)
+{
+    (void)dev;
+    (void)block;
+
+    memset(buffer, 0, count * BLKDEV_BLOCK_SIZE);
+    memcpy(buffer, "corrupted", sizeof("corrupted"));
+
+    return OS_NO_ERR;
+}
+
+static void test_ustar_mount(void)
+{
+    OS_RETURN_E err;
+    blkdev_t*   dev;
+    vfs_file_t  file;
+
+    /* The first open mounts the boot file systems */
+    err = vfs_open(TEST_USTAR_FILE_PATH, &file);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_LAZY_OPEN0_ID,
+                            err == OS_NO_ERR &&
+                            initcall_require(VFS_ROOT_INITCALL) == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_USTAR_ENABLED);
+
+    err = initrd_get_device(&dev);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_INITRD0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_USTAR_ENABLED);
+
+    err = vfs_mount(NULL, USTAR_DRIVER_NAME, dev);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_MOUNT_NULL0_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_USTAR_ENABLED);
+
+    /* The root is already mounted */
+    err = vfs_mount("/", USTAR_DRIVER_NAME, dev);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_MOUNT_AGAIN0_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_USTAR_ENABLED);
+
+    err = vfs_mount(TEST_USTAR_CORRUPT_PATH, "no_driver", dev);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_MOUNT_DRIVER0_ID,
+                            err == OS_ERR_NOT_SUPPORTED,
+                            OS_ERR_NOT_SUPPORTED,
+                            err,
+                            TEST_USTAR_ENABLED);
+
+    test_ustar_corrupt_dev.name        = "ustar_test";
+    test_ustar_corrupt_dev.block_count = 1;
+    test_ustar_corrupt_dev.read        = _test_ustar_corrupt_read;
+    test_ustar_corrupt_dev.map         = NULL;
+    test_ustar_corrupt_dev.driver_ctrl = NULL;
+    test_ustar_corrupt_dev.next_block  = 1;
+    err = vfs_mount(TEST_USTAR_CORRUPT_PATH, USTAR_DRIVER_NAME,
+                    &test_ustar_corrupt_dev);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_MOUNT_CORRUPT0_ID,
+                            err == OS_ERR_CORRUPTED_DATA,
+                            OS_ERR_CORRUPTED_DATA,
+                            err,
+                            TEST_USTAR_ENABLED);
+
+    /* The failed mount released the device blocks */
+    err = bcache_invalidate(&test_ustar_corrupt_dev);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_MOUNT_INVALIDATE0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_USTAR_ENABLED);
+}
+
+static void test_ustar_open(void)
+{
+    OS_RETURN_E err;
+    vfs_file_t  file;
+    size_t      size;
+    char        buffer[TEST_USTAR_FILE_SIZE + 1];
+
+    err = vfs_open(NULL, &file);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_OPEN_NULL0_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_USTAR_ENABLED);
+
+    err = vfs_open(TEST_USTAR_FILE_PATH, NULL);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_OPEN_NULL1_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_USTAR_ENABLED);
+
+    err = vfs_open(TEST_USTAR_FILE_PATH, &file);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_OPEN_FILE0_ID,
+                            err == OS_NO_ERR &&
+                            file.node.type == VFS_NODE_FILE &&
+                            file.node.size == TEST_USTAR_FILE_SIZE,
+                            OS_NO_ERR,
+                            err,
+                            TEST_USTAR_ENABLED);
+
+    /* The whole file is read when the buffer is larger */
+    size = 0;
+    if(err == OS_NO_ERR)
+    {
+        err = vfs_read(&file, buffer, sizeof(buffer), &size);
+    }
+    TEST_POINT_ASSERT_UINT(TEST_USTAR_FILE_DATA0_ID,
+                           err == OS_NO_ERR &&
+                           size == TEST_USTAR_FILE_SIZE &&
+                           memcmp(buffer, TEST_USTAR_FILE_DATA,
+                                  TEST_USTAR_FILE_SIZE) == 0,
+                           TEST_USTAR_FILE_SIZE,
+                           size,
+                           TEST_USTAR_ENABLED);
+
+    /* The trailing '/' are ignored */
+    err = vfs_open(TEST_USTAR_NESTED_PATH, &file);
+    size = 0;
+    if(err == OS_NO_ERR)
+    {
+        err = vfs_read(&file, buffer, sizeof(buffer), &size);
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_OPEN_NESTED0_ID,
+                            err == OS_NO_ERR &&
+                            file.node.type == VFS_NODE_FILE &&
+                            size == TEST_USTAR_NESTED_SIZE &&
+                            memcmp(buffer, TEST_USTAR_NESTED_DATA,
+                                   TEST_USTAR_NESTED_SIZE) == 0,
+                            OS_NO_ERR,
+                            err,
+                            TEST_USTAR_ENABLED);
+
+    err = vfs_open(TEST_USTAR_EMPTY_PATH, &file);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_OPEN_EMPTY0_ID,
+                            err == OS_NO_ERR &&
+                            file.node.type == VFS_NODE_FILE &&
+                            file.node.size == 0,
+                            OS_NO_ERR,
+                            err,
+                            TEST_USTAR_ENABLED);
+
+    err = vfs_open(TEST_USTAR_FOLDER_PATH, &file);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_OPEN_FOLDER0_ID,
+                            err == OS_NO_ERR &&
+                            file.node.type == VFS_NODE_DIRECTORY,
+                            OS_NO_ERR,
+                            err,
+                            TEST_USTAR_ENABLED);
+
+    /* A prefix of a path is not an entry */
+    err = vfs_open(TEST_USTAR_MISSING_PATH, &file);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_OPEN_MISSING0_ID,
+                            err == OS_ERR_FILE_NOT_FOUND,
+                            OS_ERR_FILE_NOT_FOUND,
+                            err,
+                            TEST_USTAR_ENABLED);
+}
+
+static void test_ustar_read(void)
+{
+    OS_RETURN_E err;
+    vfs_file_t  file;
+    size_t      size;
+    char        buffer[TEST_USTAR_FILE_SIZE];
+
+    err = vfs_open(TEST_USTAR_FILE_PATH, &file);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_READ_OPEN0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_USTAR_ENABLED);
+
+    err = vfs_read(NULL, buffer, sizeof(buffer), &size);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_READ_NULL0_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_USTAR_ENABLED);
+
+    size = 0;
+    err  = vfs_seek(&file, TEST_USTAR_READ_OFFSET);
+    if(err == OS_NO_ERR)
+    {
+        err = vfs_read(&file, buffer, sizeof(buffer), &size);
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_READ0_ID,
+                            err == OS_NO_ERR &&
+                            size == TEST_USTAR_FILE_SIZE -
+                                    TEST_USTAR_READ_OFFSET &&
+                            memcmp(buffer,
+                                   TEST_USTAR_FILE_DATA +
+                                   TEST_USTAR_READ_OFFSET,
+                                   size) == 0,
+                            OS_NO_ERR,
+                            err,
+                            TEST_USTAR_ENABLED);
+
+    /* Reading at the end returns no data, seeking after the end fails */
+    err = vfs_read(&file, buffer, sizeof(buffer), &size);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_READ_END0_ID,
+                            err == OS_NO_ERR && size == 0,
+                            OS_NO_ERR,
+                            err,
+                            TEST_USTAR_ENABLED);
+
+    err = vfs_seek(&file, file.node.size + 1);
+    TEST_POINT_ASSERT_RCODE(TEST_USTAR_READ_PAST0_ID,
+                            err == OS_ERR_OUT_OF_BOUND,
+                            OS_ERR_OUT_OF_BOUND,
+                            err,
+                            TEST_USTAR_ENABLED);
+}
+
+void ustar_test(void)
+{
+    test_ustar_mount();
+    test_ustar_open();
+    test_ustar_read();
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,493 @@
+/*******************************************************************************
+ * @file vmm_test.c
+ *
+ * @see test_framework.h
+ *
+ * @author Alexy Torres Aurora Dugo
+ *
+ * @date 14/10/2026
+ *
+ * @version 1.0
+ *
+ * @brief Testing framework virtual memory manager testing.
+ *
+ * @details Testing framework virtual memory manager testing. Maps a range
+ * aligned on the first level large pages in an address space, splits the
+ * large pages with a protection change and an unmap and checks the
+ * translations, the flags and the page sizes of the remaining pages. The
+ * physical range is never accessed, it does not need to be allocated. Then
+ * clones an address space mapping a private page and resolves the write
+ * faults of both sides as the ELF loader fault handler does: the clone gets
+ * a copy of the page and the original keeps the frame, written in place.
+ *
+ * @copyright Alexy Torres Aurora Dugo
+ ******************************************************************************/
+
+#ifdef _TESTING_FRAMEWORK_ENABLED
+
+/*******************************************************************************
+ * INCLUDES
+ ******************************************************************************/
+
+/* Included headers */
+#include <string.h>
+#include <cpu.h>
+#include <vmm.h>
+#include <memmgt.h>
+#include <cpu_interrupt.h>
+
+/* Configuration files */
+#include <config.h>
+
+/* Header file */
+#include <test_framework.h>
+
+/*******************************************************************************
+ * CONSTANTS
+ ******************************************************************************/
+
+/** @brief Size of the first level large pages. */
+#define TEST_VMM_LARGE_SIZE ((uintptr_t)VMM_PAGE_SIZE << CPU_PAGING_LEVEL_BITS)
+
+/** @brief Virtual address of the tested range, aligned on the large pages. */
+#define TEST_VMM_VIRT KERNEL_USER_SPACE_START
+
+/** @brief Physical address of the tested range, aligned on the large
+ * pages.
+ */
+#define TEST_VMM_PHYS (TEST_VMM_LARGE_SIZE * 2)
+
+/** @brief Size of the tested range. */
+#define TEST_VMM_SIZE (TEST_VMM_LARGE_SIZE * 2)
+
+/** @brief Mapping flags of the tested range. */
+#define TEST_VMM_FLAGS (VMM_FLAG_WRITE | VMM_FLAG_USER)
+
+/** @brief Mapping flags of the copy-on-write tests page once writable. */
+#define TEST_VMM_COW_FLAGS (VMM_FLAG_WRITE | VMM_FLAG_USER | VMM_FLAG_PRIVATE)
+
+/** @brief Mapping flags of the copy-on-write tests page once shared. */
+#define TEST_VMM_COW_SHARED_FLAGS \
+    (VMM_FLAG_COPY_ON_WRITE | VMM_FLAG_USER | VMM_FLAG_PRIVATE)
+
+/** @brief Value written in the copy-on-write tests page. */
+#define TEST_VMM_COW_PATTERN 0xC0FFEE42
+
+/*******************************************************************************
+ * STRUCTURES AND TYPES
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * MACROS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * GLOBAL VARIABLES
+ ******************************************************************************/
+
+/************************* Imported global variables **************************/
+/* None */
+
+/************************* Exported global variables **************************/
+/* None */
+
+/************************** Static global variables ***************************/
+/* None */
+
+/*******************************************************************************
+ * STATIC FUNCTIONS DECLARATIONS
+ ******************************************************************************/
+
+/* None */
+
+/*******************************************************************************
+ * FUNCTIONS
+ ******************************************************************************/
+
+static void test_vmm_check_page(const uint32_t test_id,
+                                const vmm_space_t* space,
+                                const uintptr_t virt,
+                                const uintptr_t phys,
+                                const uint32_t flags,
+                                const size_t page_size)
+{
+    OS_RETURN_E err;
+    uintptr_t   mapped_phys;
+    uint32_t    mapped_flags;
+    size_t      mapped_size;
+
+    mapped_phys  = 0;
+    mapped_flags = 0;
+    mapped_size  = 0;
+    err = vmm_space_get_mapping(space, virt, &mapped_phys, &mapped_flags,
+                                &mapped_size);
+    TEST_POINT_ASSERT_UDWORD(test_id,
+                             err == OS_NO_ERR &&
+                             mapped_phys == phys &&
+                             mapped_flags == flags &&
+                             mapped_size == page_size,
+                             (uint64_t)phys,
+                             (uint64_t)mapped_phys,
+                             TEST_VMM_ENABLED);
+}
+
+static void test_vmm_params(vmm_space_t* space)
+{
+    OS_RETURN_E err;
+    uintptr_t   phys;
+    uint32_t    flags;
+
+    err = vmm_space_map(space, TEST_VMM_VIRT + 1, TEST_VMM_PHYS,
+                        VMM_PAGE_SIZE, TEST_VMM_FLAGS);
+    TEST_POINT_ASSERT_RCODE(TEST_VMM_MAP_UNALIGNED0_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_VMM_ENABLED);
+
+    /* The address spaces only own the user range */
+    err = vmm_space_map(space, KERNEL_USER_SPACE_END, TEST_VMM_PHYS,
+                        VMM_PAGE_SIZE, TEST_VMM_FLAGS);
+    TEST_POINT_ASSERT_RCODE(TEST_VMM_MAP_KERNEL0_ID,
+                            err == OS_ERR_UNAUTHORIZED_ACTION,
+                            OS_ERR_UNAUTHORIZED_ACTION,
+                            err,
+                            TEST_VMM_ENABLED);
+
+    err = vmm_space_get_mapping(space, TEST_VMM_VIRT, &phys, &flags, NULL);
+    TEST_POINT_ASSERT_RCODE(TEST_VMM_GET_MAPPING_NULL0_ID,
+                            err == OS_ERR_NULL_POINTER,
+                            OS_ERR_NULL_POINTER,
+                            err,
+                            TEST_VMM_ENABLED);
+}
+
+static void test_vmm_split(vmm_space_t* space)
+{
+    OS_RETURN_E err;
+    uintptr_t   phys;
+    uint32_t    flags;
+    size_t      large_size;
+    size_t      page_size;
+
+    /* Without large pages the range is mapped with small pages */
+    large_size = (_cpu_get_max_page_level() >= 1) ? TEST_VMM_LARGE_SIZE :
+                                                    VMM_PAGE_SIZE;
+
+    err = vmm_space_map(space, TEST_VMM_VIRT, TEST_VMM_PHYS, TEST_VMM_SIZE,
+                        TEST_VMM_FLAGS);
+    TEST_POINT_ASSERT_RCODE(TEST_VMM_MAP0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_VMM_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+
+    test_vmm_check_page(TEST_VMM_MAP_CHECK0_ID, space,
+                        TEST_VMM_VIRT + TEST_VMM_LARGE_SIZE + 0x123,
+                        TEST_VMM_PHYS + TEST_VMM_LARGE_SIZE + 0x123,
+                        TEST_VMM_FLAGS, large_size);
+
+    err = vmm_space_map(space, TEST_VMM_VIRT + VMM_PAGE_SIZE, TEST_VMM_PHYS,
+                        VMM_PAGE_SIZE, TEST_VMM_FLAGS);
+    TEST_POINT_ASSERT_RCODE(TEST_VMM_MAP_EXISTS0_ID,
+                            err == OS_ERR_MAPPING_ALREADY_EXISTS,
+                            OS_ERR_MAPPING_ALREADY_EXISTS,
+                            err,
+                            TEST_VMM_ENABLED);
+
+    /* Protecting one page splits the first large page only */
+    err = vmm_space_protect(space, TEST_VMM_VIRT + VMM_PAGE_SIZE,
+                            VMM_PAGE_SIZE, VMM_FLAG_USER);
+    TEST_POINT_ASSERT_RCODE(TEST_VMM_PROTECT0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_VMM_ENABLED);
+
+    test_vmm_check_page(TEST_VMM_PROTECT_CHECK0_ID, space,
+                        TEST_VMM_VIRT + VMM_PAGE_SIZE,
+                        TEST_VMM_PHYS + VMM_PAGE_SIZE,
+                        VMM_FLAG_USER, VMM_PAGE_SIZE);
+    test_vmm_check_page(TEST_VMM_PROTECT_CHECK1_ID, space,
+                        TEST_VMM_VIRT,
+                        TEST_VMM_PHYS,
+                        TEST_VMM_FLAGS, VMM_PAGE_SIZE);
+    test_vmm_check_page(TEST_VMM_PROTECT_CHECK2_ID, space,
+                        TEST_VMM_VIRT + TEST_VMM_LARGE_SIZE - VMM_PAGE_SIZE,
+                        TEST_VMM_PHYS + TEST_VMM_LARGE_SIZE - VMM_PAGE_SIZE,
+                        TEST_VMM_FLAGS, VMM_PAGE_SIZE);
+    test_vmm_check_page(TEST_VMM_PROTECT_CHECK3_ID, space,
+                        TEST_VMM_VIRT + TEST_VMM_LARGE_SIZE,
+                        TEST_VMM_PHYS + TEST_VMM_LARGE_SIZE,
+                        TEST_VMM_FLAGS, large_size);
+
+    /* Unmapping one page splits the second large page */
+    err = vmm_space_unmap(space,
+                          TEST_VMM_VIRT + TEST_VMM_LARGE_SIZE +
+                          2 * VMM_PAGE_SIZE,
+                          VMM_PAGE_SIZE);
+    TEST_POINT_ASSERT_RCODE(TEST_VMM_UNMAP0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_VMM_ENABLED);
+
+    err = vmm_space_get_mapping(space,
+                                TEST_VMM_VIRT + TEST_VMM_LARGE_SIZE +
+                                2 * VMM_PAGE_SIZE,
+                                &phys, &flags, &page_size);
+    TEST_POINT_ASSERT_RCODE(TEST_VMM_UNMAP_CHECK0_ID,
+                            err == OS_ERR_MEMORY_NOT_MAPPED,
+                            OS_ERR_MEMORY_NOT_MAPPED,
+                            err,
+                            TEST_VMM_ENABLED);
+    test_vmm_check_page(TEST_VMM_UNMAP_CHECK1_ID, space,
+                        TEST_VMM_VIRT + TEST_VMM_LARGE_SIZE + VMM_PAGE_SIZE,
+                        TEST_VMM_PHYS + TEST_VMM_LARGE_SIZE + VMM_PAGE_SIZE,
+                        TEST_VMM_FLAGS, VMM_PAGE_SIZE);
+    test_vmm_check_page(TEST_VMM_UNMAP_CHECK2_ID, space,
+                        TEST_VMM_VIRT + TEST_VMM_LARGE_SIZE +
+                        3 * VMM_PAGE_SIZE,
+                        TEST_VMM_PHYS + TEST_VMM_LARGE_SIZE +
+                        3 * VMM_PAGE_SIZE,
+                        TEST_VMM_FLAGS, VMM_PAGE_SIZE);
+
+    /* The parts of the range already unmapped are ignored */
+    err = vmm_space_unmap(space, TEST_VMM_VIRT, TEST_VMM_SIZE);
+    TEST_POINT_ASSERT_RCODE(TEST_VMM_UNMAP1_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_VMM_ENABLED);
+
+    err = vmm_space_get_mapping(space, TEST_VMM_VIRT, &phys, &flags,
+                                &page_size);
+    TEST_POINT_ASSERT_RCODE(TEST_VMM_UNMAP_CHECK3_ID,
+                            err == OS_ERR_MEMORY_NOT_MAPPED,
+                            OS_ERR_MEMORY_NOT_MAPPED,
+                            err,
+                            TEST_VMM_ENABLED);
+}
+
+static OS_RETURN_E test_vmm_get_frame_address(const uintptr_t frame,
+                                              uint32_t** address)
+{
+    uintptr_t   virt;
+    uintptr_t   phys;
+    OS_RETURN_E err;
+
+    /* The frames are reached through the kernel linear mapping */
+    if((uint64_t)frame + VMM_PAGE_SIZE >
+       (uint64_t)KERNEL_VIRTUAL_ADDR_MAX - KERNEL_MEM_OFFSET)
+    {
+        return OS_ERR_NOT_SUPPORTED;
+    }
+
+    virt = frame + KERNEL_MEM_OFFSET;
+    err  = vmm_get_physical(virt, &phys);
+    if(err == OS_ERR_MEMORY_NOT_MAPPED)
+    {
+        err = vmm_map(virt, frame, VMM_PAGE_SIZE, VMM_FLAG_WRITE);
+    }
+    else if(err == OS_NO_ERR && phys != frame)
+    {
+        err = OS_ERR_NOT_SUPPORTED;
+    }
+
+    *address = (uint32_t*)virt;
+
+    return err;
+}
+
+static void test_vmm_cow(void)
+{
+    OS_RETURN_E  err;
+    vmm_space_t* space;
+    vmm_space_t* clone;
+    uintptr_t    frame;
+    uintptr_t    cow_frame;
+    uintptr_t    copy;
+    uint32_t*    frame_content;
+    uint32_t*    copy_content;
+
+    err = memmgt_alloc_frames(0, &frame);
+    if(err == OS_NO_ERR)
+    {
+        err = test_vmm_get_frame_address(frame, &frame_content);
+        if(err != OS_NO_ERR)
+        {
+            (void)memmgt_free_frames(frame, 0);
+        }
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_VMM_COW_ALLOC0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_VMM_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+    *frame_content = TEST_VMM_COW_PATTERN;
+
+    err = vmm_space_create(&space);
+    if(err == OS_NO_ERR)
+    {
+        err = vmm_space_map(space, TEST_VMM_VIRT, frame, VMM_PAGE_SIZE,
+                            TEST_VMM_COW_FLAGS);
+        if(err == OS_NO_ERR)
+        {
+            err = vmm_space_clone(space, &clone);
+        }
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_VMM_COW_CLONE0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_VMM_ENABLED);
+    if(err != OS_NO_ERR)
+    {
+        return;
+    }
+
+    /* Both sides share the frame, read only until their first write */
+    test_vmm_check_page(TEST_VMM_COW_CLONE_CHECK0_ID, space, TEST_VMM_VIRT,
+                        frame, TEST_VMM_COW_SHARED_FLAGS, VMM_PAGE_SIZE);
+    test_vmm_check_page(TEST_VMM_COW_CLONE_CHECK1_ID, clone, TEST_VMM_VIRT,
+                        frame, TEST_VMM_COW_SHARED_FLAGS, VMM_PAGE_SIZE);
+    TEST_POINT_ASSERT_UINT(TEST_VMM_COW_SHARED0_ID,
+                           memmgt_is_frame_shared(frame) == TRUE,
+                           TRUE,
+                           memmgt_is_frame_shared(frame),
+                           TEST_VMM_ENABLED);
+
+    /* Write fault in the clone: the frame is shared, the page is copied */
+    cow_frame = 0;
+    err = vmm_space_get_cow_frame(clone, TEST_VMM_VIRT, &cow_frame);
+    TEST_POINT_ASSERT_UDWORD(TEST_VMM_COW_GET_FRAME0_ID,
+                             err == OS_NO_ERR && cow_frame == frame,
+                             (uint64_t)frame,
+                             (uint64_t)cow_frame,
+                             TEST_VMM_ENABLED);
+
+    err = memmgt_alloc_frames(0, &copy);
+    if(err == OS_NO_ERR)
+    {
+        err = test_vmm_get_frame_address(copy, &copy_content);
+        if(err == OS_NO_ERR)
+        {
+            memcpy(copy_content, frame_content, VMM_PAGE_SIZE);
+            err = vmm_space_resolve_cow(clone, TEST_VMM_VIRT, copy);
+        }
+        if(err != OS_NO_ERR)
+        {
+            (void)memmgt_free_frames(copy, 0);
+        }
+    }
+    TEST_POINT_ASSERT_RCODE(TEST_VMM_COW_RESOLVE0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_VMM_ENABLED);
+
+    if(err == OS_NO_ERR)
+    {
+        /* The clone reference to the previous frame is dropped */
+        (void)memmgt_free_frames(frame, 0);
+
+        test_vmm_check_page(TEST_VMM_COW_RESOLVE_CHECK0_ID, clone,
+                            TEST_VMM_VIRT, copy, TEST_VMM_COW_FLAGS,
+                            VMM_PAGE_SIZE);
+        test_vmm_check_page(TEST_VMM_COW_RESOLVE_CHECK1_ID, space,
+                            TEST_VMM_VIRT, frame, TEST_VMM_COW_SHARED_FLAGS,
+                            VMM_PAGE_SIZE);
+        TEST_POINT_ASSERT_UINT(TEST_VMM_COW_COPY_CHECK0_ID,
+                               *copy_content == TEST_VMM_COW_PATTERN &&
+                               memmgt_is_frame_shared(frame) == FALSE,
+                               TEST_VMM_COW_PATTERN,
+                               *copy_content,
+                               TEST_VMM_ENABLED);
+
+        /* Write fault in the original: it holds the last reference, the
+         * frame is made writable in place
+         */
+        err = vmm_space_get_cow_frame(space, TEST_VMM_VIRT, &cow_frame);
+        if(err == OS_NO_ERR)
+        {
+            err = vmm_space_resolve_cow(space, TEST_VMM_VIRT, cow_frame);
+        }
+        TEST_POINT_ASSERT_RCODE(TEST_VMM_COW_RESOLVE1_ID,
+                                err == OS_NO_ERR,
+                                OS_NO_ERR,
+                                err,
+                                TEST_VMM_ENABLED);
+        test_vmm_check_page(TEST_VMM_COW_RESOLVE_CHECK2_ID, space,
+                            TEST_VMM_VIRT, frame, TEST_VMM_COW_FLAGS,
+                            VMM_PAGE_SIZE);
+
+        /* Each side has its own frame */
+        TEST_POINT_ASSERT_UDWORD(TEST_VMM_COW_OWN_FRAMES0_ID,
+                                 copy != frame,
+                                 (uint64_t)frame,
+                                 (uint64_t)copy,
+                                 TEST_VMM_ENABLED);
+
+        err = vmm_space_get_cow_frame(space, TEST_VMM_VIRT, &cow_frame);
+        TEST_POINT_ASSERT_RCODE(TEST_VMM_COW_RESOLVED0_ID,
+                                err == OS_ERR_UNAUTHORIZED_ACTION,
+                                OS_ERR_UNAUTHORIZED_ACTION,
+                                err,
+                                TEST_VMM_ENABLED);
+
+        (void)memmgt_free_frames(copy, 0);
+    }
+
+    /* The unmaps do not release the frames */
+    (void)vmm_space_unmap(clone, TEST_VMM_VIRT, VMM_PAGE_SIZE);
+    (void)vmm_space_unmap(space, TEST_VMM_VIRT, VMM_PAGE_SIZE);
+    (void)vmm_space_destroy(clone);
+    (void)vmm_space_destroy(space);
+    (void)memmgt_free_frames(frame, 0);
+}
+
+void vmm_test(void)
+{
+    OS_RETURN_E  err;
+    vmm_space_t* space;
+
+    err = vmm_space_create(&space);
+    TEST_POINT_ASSERT_RCODE(TEST_VMM_SPACE_CREATE0_ID,
+                            err == OS_NO_ERR,
+                            OS_NO_ERR,
+                            err,
+                            TEST_VMM_ENABLED);
+
+    if(err == OS_NO_ERR)
+    {
+        test_vmm_params(space);
+        test_vmm_split(space);
+
+        err = vmm_space_destroy(space);
+        TEST_POINT_ASSERT_RCODE(TEST_VMM_SPACE_DESTROY0_ID,
+                                err == OS_NO_ERR,
+                                OS_NO_ERR,
+                                err,
+                                TEST_VMM_ENABLED);
+    }
+
+    test_vmm_cow();
+
+    TEST_FRAMEWORK_END();
+}
+
+#endif /* #ifdef _TESTING_FRAMEWORK_ENABLED */
+
+/************************************ EOF *************************************/
@@ -0,0 +1,174 @@
+import argparse
+import json
+import os
+import queue
+import shutil
+import subprocess
+import sys
+import threading
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+from TestValidator import COLORS, TARGET_LIST, ParseInputFile, Validate, UpdateTestFile
+
+# Test list file, relative to the Source directory
+TEST_LIST_FILE = "Kernel/TestFramework/includes/test_list.h"
+
+# Files not copied in the workers build trees
+COPY_IGNORE = shutil.ignore_patterns("build", "*.o", "*.d", "*.elf", "*.iso")
+
+class Job:
+    def __init__(self, target, group, smpList):
+        self.target  = target
+        self.group   = group
+        self.smpList = smpList
+        self.results = {}
+        self.error   = None
+
+    def Name(self):
+        return "{}/{}".format(self.target, self.group["name"])
+
+def SelectShard(groups, shard):
+    # shard is "index/count", used to split the groups between CI machines
+    if shard is None:
+        return groups
+    index, count = [int(value) for value in shard.split("/")]
+    if count <= 0 or index < 0 or index >= count:
+        print("Error: invalid shard {}".format(shard))
+        exit(1)
+    return [group for i, group in enumerate(groups) if i % count == index]
+
+def RunJob(job, workDir, outputDir, timeout, makeArgs):
+    sourceDir = os.path.join(workDir, "Source")
+    fileBase  = "{}_{}".format(job.target, job.group["name"].replace(" ", "_"))
+
+    UpdateTestFile(os.path.join(sourceDir, TEST_LIST_FILE), job.group["group"], job.group["name"])
+
+    with open(os.path.join(outputDir, "CompileOutput_{}.txt".format(fileBase)), "w") as compileOutput:
+        if subprocess.call(["make", "clean"], cwd = sourceDir, stdout = subprocess.DEVNULL, stderr = subprocess.STDOUT) != 0:
+            job.error = "clean failed"
+            return
+        if subprocess.call(["make", "target={}".format(job.target), "TESTS=TRUE"] + makeArgs, cwd = sourceDir, stdout = compileOutput, stderr = subprocess.STDOUT) != 0:
+            job.error = "build failed"
+            return
+
+    # The same image is booted with each CPU count
+    for smp in job.smpList:
+        outputFileName = os.path.join(outputDir, "TestOutput_{}_smp{}.txt".format(fileBase, smp))
+        with open(outputFileName, "w") as outputFile:
+            p = subprocess.Popen(["make", "target={}".format(job.target), "QEMU_SMP={}".format(smp), "qemu-test-mode"],
+                                 cwd = sourceDir, stdout = outputFile, stderr = subprocess.STDOUT,
+                                 stdin = subprocess.DEVNULL, start_new_session = True)
+            try:
+                p.wait(timeout)
+            except subprocess.TimeoutExpired:
+                # Kill make and the QEMU instance it started
+                os.killpg(p.pid, 9)
+                p.wait()
+
+        job.results[smp] = ParseInputFile(outputFileName)
+
+def Worker(workerId, jobs, sourceDir, outputDir, timeout, makeArgs):
+    workDir = os.path.join(outputDir, "Worker{}".format(workerId))
+
+    # Each worker builds in its own copy of the sources
+    if os.path.exists(workDir):
+        shutil.rmtree(workDir)
+    shutil.copytree(sourceDir, os.path.join(workDir, "Source"), ignore = COPY_IGNORE)
+
+    while True:
+        try:
+            job = jobs.get_nowait()
+        except queue.Empty:
+            break
+
+        print(COLORS.OKBLUE + " > Worker {}: {} (smp {})".format(workerId, job.Name(), job.smpList) + COLORS.ENDC, flush = True)
+        try:
+            RunJob(job, workDir, outputDir, timeout, makeArgs)
+        except Exception as exception:
+            job.error = str(exception)
+
+    shutil.rmtree(workDir, ignore_errors = True)
+
+if __name__ == "__main__":
+    print(COLORS.OKBLUE + COLORS.BOLD + "#==============================================================================#" + COLORS.ENDC)
+    print(COLORS.OKBLUE + COLORS.BOLD + "| UTK UNIT TEST FRAMEWORK - SHARDED RUNNER                                     |" + COLORS.ENDC)
+    print(COLORS.OKBLUE + COLORS.BOLD + "#==============================================================================#"  + COLORS.ENDC)
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("source_dir", help = "the Source directory")
+    parser.add_argument("test_group_file", help = "the test groups file")
+    parser.add_argument("output_dir", help = "the directory receiving the outputs")
+    parser.add_argument("--targets", default = ",".join(TARGET_LIST), help = "comma separated targets")
+    parser.add_argument("--jobs", type = int, default = os.cpu_count(), help = "number of QEMU instances run at once")
+    parser.add_argument("--smp", default = "4", help = "comma separated CPU counts each suite is booted with")
+    parser.add_argument("--shard", default = None, help = "index/count, only runs one shard of the groups")
+    parser.add_argument("--timeout", type = int, default = 20, help = "timeout of one boot in seconds")
+    parser.add_argument("--make-args", default = "", help = "space separated build variables, e.g. \"LTO=TRUE PGO=TRUE\"")
+    args = parser.parse_args()
+
+    targets = args.targets.split(",")
+    for target in targets:
+        if target not in TARGET_LIST:
+            print("Error: Unknown target {}, only {} are supported".format(target, TARGET_LIST))
+            exit(1)
+
+    smpList = [int(smp) for smp in args.smp.split(",")]
+
+    with open(args.test_group_file) as groupFile:
+        groups = SelectShard(json.loads(groupFile.read()), args.shard)
+
+    outputDir = os.path.abspath(args.output_dir)
+    os.makedirs(outputDir, exist_ok = True)
+
+    jobList = [Job(target, group, smpList) for target in targets for group in groups]
+    jobs = queue.Queue()
+    for job in jobList:
+        jobs.put(job)
+
+    workers = []
+    for i in range(max(1, min(args.jobs, len(jobList)))):
+        worker = threading.Thread(target = Worker, args = (i, jobs, os.path.abspath(args.source_dir), outputDir, args.timeout, args.make_args.split()))
+        worker.start()
+        workers.append(worker)
+    for worker in workers:
+        worker.join()
+
+    # Validate and merge the results in the jobs order
+    error   = 0
+    success = 0
+    total   = 0
+    merged  = {}
+    for job in jobList:
+        for smp in job.smpList:
+            total += 1
+            name = "{}/smp{}".format(job.Name(), smp)
+            print(COLORS.OKBLUE + "\n#==============================================================================#" + COLORS.ENDC)
+            print(COLORS.OKBLUE + " > Group {}".format(name) + COLORS.ENDC)
+            print(COLORS.OKBLUE + "#==============================================================================#\n"  + COLORS.ENDC)
+
+            jsonTestsuite = job.results.get(smp, "")
+            merged[name] = jsonTestsuite if len(jsonTestsuite) != 0 else None
+            if job.error is not None:
+                print("Error: {}.".format(job.error))
+                error += 1
+            elif len(jsonTestsuite) == 0:
+                print("Error: testing result were not printed.")
+                error += 1
+            elif Validate(jsonTestsuite) == 0:
+                success += 1
+            else:
+                error += 1
+
+    with open(os.path.join(outputDir, "test_results.json"), "w") as resultsFile:
+        json.dump(merged, resultsFile, indent = 4)
+
+    print(COLORS.OKBLUE + COLORS.BOLD + "\n\n#==============================================================================#" + COLORS.ENDC)
+    print(COLORS.OKBLUE + COLORS.BOLD + "| FINAL REPORT                                                                 |" + COLORS.ENDC)
+    print(COLORS.OKBLUE + COLORS.BOLD + "#==============================================================================#"  + COLORS.ENDC)
+    print(COLORS.OKBLUE + COLORS.BOLD + "| Total:  {:<68} |".format(total)  + COLORS.ENDC)
+    print(COLORS.OKBLUE + COLORS.BOLD + "| Sucess: {:<68} |".format(success)  + COLORS.ENDC)
+    print(COLORS.OKBLUE + COLORS.BOLD + "| Errors: {:<68} |".format(error)  + COLORS.ENDC)
+    print(COLORS.OKBLUE + COLORS.BOLD + "#==============================================================================#"  + COLORS.ENDC)
+
+    exit(error)
@@ -40,6 +40,7 @@ def Validate(jsonTestsuite):
     print(COLORS.OKCYAN + COLORS.BOLD + "#--------------------------------------------------#" + COLORS.ENDC)
     print(COLORS.OKCYAN +"| Version: {:40s}|".format(jsonTestsuite["version"]) + COLORS.ENDC)
     print(COLORS.OKCYAN +"| Testname: {:39s}|".format(jsonTestsuite["name"]) + COLORS.ENDC)
+    print(COLORS.OKCYAN +"| Build: {:42s}|".format(jsonTestsuite["build"]) + COLORS.ENDC)
     print(COLORS.OKCYAN +"#--------------------------------------------------#" + COLORS.ENDC)
     print(COLORS.OKCYAN +"| N# of tests    | N# of success  | N# of failures |" + COLORS.ENDC)
     print(COLORS.OKCYAN +"|--------------------------------------------------#" + COLORS.ENDC)
@@ -56,6 +57,34 @@ def Validate(jsonTestsuite):
         #else:
         #    outComeStr = COLORS.OKGREEN + COLORS.BOLD + "PASS" + COLORS.ENDC
 
+    benchmarks = jsonTestsuite.get("benchmarks", {})
+    if len(benchmarks) != 0:
+        print()
+        print(COLORS.OKCYAN + "Benchmarks (cycles, overhead: {})".format(jsonTestsuite.get("bench_overhead", 0)) + COLORS.ENDC)
+        print(COLORS.OKCYAN + "| {:24s} | {:6s} | {:10s} | {:10s} | {:10s} | {:10s} |".format("Name", "Iter.", "Min", "Median", "P99", "Max") + COLORS.ENDC)
+        for benchName, benchContent in benchmarks.items():
+            if benchContent.get("completed", 0) == 0:
+                print(COLORS.WARNING + "| {:24s} | {:6d} | {:10s} | {:10s} | {:10s} | {:10s} |".format(benchName, benchContent["iterations"], "-", "-", "-", "-") + COLORS.ENDC)
+                continue
+            print("| {:24s} | {:6d} | {:10d} | {:10d} | {:10d} | {:10d} |".format(benchName, benchContent["iterations"], benchContent["min"], benchContent["median"], benchContent["p99"], benchContent["max"]))
+
+    memory = jsonTestsuite.get("memory", {})
+    if len(memory) != 0:
+        seconds = max(memory["elapsed_ns"], 1) / 1000000000
+        print()
+        print(COLORS.OKCYAN + "Memory (free frames: {}, hot frames: {})".format(memory["free_frames"], memory["hot_frames"]) + COLORS.ENDC)
+        print(COLORS.OKCYAN + "| {:5s} | {:10s} | {:10s} |".format("Order", "Free blks", "Unusable") + COLORS.ENDC)
+        for order in range(0, len(memory["free_blocks"])):
+            print("| {:5d} | {:10d} | {:9.1f}% |".format(order, memory["free_blocks"][order], memory["unusable"][order] / 10))
+
+        memoryTables = [("Class", jsonTestsuite["memory_classes"]), ("Site", jsonTestsuite["memory_sites"])]
+        for tableName, table in memoryTables:
+            if len(table) == 0:
+                continue
+            print(COLORS.OKCYAN + "| {:32s} | {:10s} | {:10s} | {:10s} | {:10s} | {:6s} |".format(tableName, "Live", "Peak", "Allocs/s", "Frees/s", "Fails") + COLORS.ENDC)
+            for name, content in table.items():
+                print("| {:32s} | {:10d} | {:10d} | {:10.1f} | {:10.1f} | {:6d} |".format(name[-32:], content["live"], content["peak"], content["allocations"] / seconds, content["frees"] / seconds, content["failures"]))
+
 
     print()
     if jsonTestsuite["failures"] == 0:
@@ -69,27 +98,60 @@ def Validate(jsonTestsuite):
     return jsonTestsuite["failures"]
 
 
+STREAM_TAG = "#TEST# "
+
 def ParseInputFile(filename):
-    isTestsuiteContent = False
+    jsonTestsuite = {
+        "version": "",
+        "name": "",
+        "build": "unknown",
+        "test_suite": {},
+        "benchmarks": {},
+        "memory": {},
+        "memory_classes": {},
+        "memory_sites": {}
+    }
+    summaryFound = False
     with open(filename, 'r', errors='ignore') as fileDesc:
-        fileContent = fileDesc.readlines()
-        jsonBody = ""
-        for line in fileContent:
-            line = line.strip("\n")
-            if line == "#-------- TESTING SECTION START --------#":
-                isTestsuiteContent = True
-            elif line == "#-------- TESTING SECTION END --------#":
-                isTestsuiteContent = False
-            else:
-                if isTestsuiteContent:
-                    jsonBody += line + "\n"
-
-        if len(jsonBody) == 0:
-            return ""
-
-        jsonObject = json.loads(jsonBody)
+        for line in fileDesc.readlines():
+            # Results lines can follow other output on the same line
+            position = line.find(STREAM_TAG)
+            if position == -1:
+                continue
+            try:
+                record = json.loads(line[position + len(STREAM_TAG):])
+            except json.JSONDecodeError:
+                print("Error: malformed test record: {}".format(line.strip()))
+                continue
 
-        return jsonObject
+            if "header" in record:
+                jsonTestsuite["version"] = record["header"]["version"]
+                jsonTestsuite["name"] = record["header"]["name"]
+                jsonTestsuite["build"] = record["header"].get("build", "unknown")
+            elif "test" in record:
+                testContent = record["test"]
+                jsonTestsuite["test_suite"][str(testContent["id"])] = testContent
+            elif "bench" in record:
+                benchContent = record["bench"]
+                jsonTestsuite["benchmarks"][benchContent["name"]] = benchContent
+            elif "memory" in record:
+                jsonTestsuite["memory"] = record["memory"]
+            elif "memory_class" in record:
+                classContent = record["memory_class"]
+                className = str(classContent["size"]) if classContent["size"] != 0 else "large"
+                jsonTestsuite["memory_classes"][className] = classContent
+            elif "memory_site" in record:
+                siteContent = record["memory_site"]
+                jsonTestsuite["memory_sites"][siteContent["site"]] = siteContent
+            elif "summary" in record:
+                jsonTestsuite.update(record["summary"])
+                summaryFound = True
+
+    # The suite did not complete
+    if not summaryFound:
+        return ""
+
+    return jsonTestsuite
 
 def UpdateTestFile(filename, testGroup, testName):
     with open(filename, "r+") as fileDesc:
@@ -0,0 +1,10 @@
+#!/bin/bash
+
+mkdir -p GeneratedFiles
+
+python3 Tools/CIWorkflow/ShardedTestRunner.py Source Source/Kernel/TestFramework/includes/test_groups.json GeneratedFiles --smp 1,4 "$@"
+
+if (( $? != 0 ))
+then
+    exit -1
+fi
@@ -0,0 +1,101 @@
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "CIWorkflow"))
+
+from TestValidator import COLORS, TARGET_LIST, UpdateTestFile
+from PgoProfile import ParseProfile, WriteProfile
+
+# Test list file, relative to the Source directory
+TEST_LIST_FILE = "Kernel/TestFramework/includes/test_list.h"
+
+# Test groups file, relative to the Source directory
+TEST_GROUP_FILE = "Kernel/TestFramework/includes/test_groups.json"
+
+# Profile directory, relative to the Source directory, must match PGO_DIR
+PROFILE_DIR = "PGO"
+
+# Group run by the instrumented kernel to collect the profile
+PROFILE_GROUP = "Benchmark Suite"
+
+def Make(sourceDir, arguments, output):
+    return subprocess.call(["make"] + arguments, cwd = sourceDir, stdout = output, stderr = subprocess.STDOUT)
+
+def CollectProfile(sourceDir, target, makeArgs, outputFileName, timeout):
+    # Instrumented build booted on the profile group
+    with open(os.path.join(sourceDir, TEST_GROUP_FILE)) as groupFile:
+        groups = [group for group in json.loads(groupFile.read()) if group["name"] == PROFILE_GROUP]
+    if len(groups) != 1:
+        print(COLORS.FAIL + "Error: cannot find the \"{}\" test group".format(PROFILE_GROUP) + COLORS.ENDC)
+        return 1
+    UpdateTestFile(os.path.join(sourceDir, TEST_LIST_FILE), groups[0]["group"], groups[0]["name"])
+
+    with open(outputFileName, "w") as outputFile:
+        if Make(sourceDir, ["clean"], outputFile) != 0:
+            return 1
+        if Make(sourceDir, ["target={}".format(target), "TESTS=TRUE", "PGO=GEN"] + makeArgs, outputFile) != 0:
+            print(COLORS.FAIL + "Error: the instrumented build failed" + COLORS.ENDC)
+            return 1
+
+        p = subprocess.Popen(["make", "target={}".format(target), "qemu-test-mode"],
+                             cwd = sourceDir, stdout = outputFile, stderr = subprocess.STDOUT,
+                             stdin = subprocess.DEVNULL, start_new_session = True)
+        try:
+            p.wait(timeout)
+        except subprocess.TimeoutExpired:
+            # Kill make and the QEMU instance it started
+            os.killpg(p.pid, 9)
+            p.wait()
+
+    files, count = ParseProfile(outputFileName)
+    if files is None or len(files) != count:
+        print(COLORS.FAIL + "Error: the kernel did not output its complete profile" + COLORS.ENDC)
+        return 1
+
+    WriteProfile(files, os.path.join(sourceDir, PROFILE_DIR, target))
+    print(COLORS.OKGREEN + "> Collected {} profile files".format(count) + COLORS.ENDC)
+    return 0
+
+if __name__ == "__main__":
+    print(COLORS.OKBLUE + COLORS.BOLD + "#==============================================================================#" + COLORS.ENDC)
+    print(COLORS.OKBLUE + COLORS.BOLD + "| UTK PROFILE GUIDED BUILD                                                     |" + COLORS.ENDC)
+    print(COLORS.OKBLUE + COLORS.BOLD + "#==============================================================================#"  + COLORS.ENDC)
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("source_dir", help = "the Source directory")
+    parser.add_argument("target", help = "the built target")
+    parser.add_argument("--make-args", default = "", help = "space separated build variables of both stages, e.g. \"LTO=TRUE\"")
+    parser.add_argument("--output", default = "pgo_output.txt", help = "the instrumented kernel output file")
+    parser.add_argument("--timeout", type = int, default = 60, help = "timeout of the profile run in seconds")
+    args = parser.parse_args()
+
+    if args.target not in TARGET_LIST:
+        print("Error: Unknown target {}, only {} are supported".format(args.target, TARGET_LIST))
+        exit(1)
+
+    sourceDir = os.path.abspath(args.source_dir)
+    makeArgs  = args.make_args.split()
+
+    # Stage 1: profile collection, the tests list is restored afterwards
+    shutil.rmtree(os.path.join(sourceDir, PROFILE_DIR, args.target), ignore_errors = True)
+    with open(os.path.join(sourceDir, TEST_LIST_FILE)) as testListFile:
+        testList = testListFile.read()
+    try:
+        error = CollectProfile(sourceDir, args.target, makeArgs, os.path.abspath(args.output), args.timeout)
+    finally:
+        with open(os.path.join(sourceDir, TEST_LIST_FILE), "w") as testListFile:
+            testListFile.write(testList)
+    if error != 0:
+        exit(error)
+
+    # Stage 2: optimized build
+    if Make(sourceDir, ["clean"], subprocess.DEVNULL) != 0:
+        exit(1)
+    error = Make(sourceDir, ["target={}".format(args.target), "PGO=TRUE"] + makeArgs, None)
+    if error != 0:
+        print(COLORS.FAIL + "Error: the optimized build failed" + COLORS.ENDC)
+    exit(error)
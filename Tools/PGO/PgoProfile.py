@@ -0,0 +1,66 @@
+import os
+import struct
+import sys
+
+sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "CIWorkflow"))
+
+from TestValidator import COLORS
+
+# Profile records tag, must match GCOV_STREAM_TAG in gcov.h
+STREAM_TAG = "#GCDA# "
+
+def ParseProfile(filename):
+    # Returns the gcda files content by path and the number of files the
+    # kernel reported, None if the profile output did not complete
+    files   = {}
+    current = None
+    done    = None
+    with open(filename, 'r', errors='ignore') as fileDesc:
+        for line in fileDesc.readlines():
+            # Records can follow other output on the same line
+            position = line.find(STREAM_TAG)
+            if position == -1:
+                continue
+            fields = line[position + len(STREAM_TAG):].split()
+            if len(fields) == 0:
+                continue
+
+            if fields[0] == "F" and len(fields) == 2:
+                current = bytearray()
+                files[fields[1]] = current
+            elif fields[0] == "D" and current is not None:
+                for word in fields[1:]:
+                    current += struct.pack("<I", int(word, 16))
+            elif fields[0] == "E":
+                current = None
+            elif fields[0] == "DONE" and len(fields) == 2:
+                done = int(fields[1])
+
+    if done is None:
+        return None, 0
+    return files, done
+
+def WriteProfile(files, profileDir):
+    # The build gives the tree base with -fprofile-prefix-path, the gcda
+    # names are the objects paths in the tree with '#' separators and do not
+    # depend on where the instrumented kernel was built
+    os.makedirs(profileDir, exist_ok = True)
+    for path, content in files.items():
+        with open(os.path.join(profileDir, os.path.basename(path)), "wb") as gcdaFile:
+            gcdaFile.write(content)
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        print("Usage: {} kernel_output profile_dir".format(sys.argv[0]))
+        exit(1)
+
+    files, count = ParseProfile(sys.argv[1])
+    if files is None:
+        print(COLORS.FAIL + "Error: the kernel did not output its profile" + COLORS.ENDC)
+        exit(1)
+    if len(files) != count:
+        print(COLORS.FAIL + "Error: {} profile files out of {}".format(len(files), count) + COLORS.ENDC)
+        exit(1)
+
+    WriteProfile(files, sys.argv[2])
+    print(COLORS.OKGREEN + "> Wrote {} profile files in {}".format(count, sys.argv[2]) + COLORS.ENDC)
@@ -0,0 +1,96 @@
+import argparse
+import bisect
+import subprocess
+import sys
+
+# Profile records tags, must match profiler_dump in profiler.c
+START_TAG  = "#PROF_START "
+CPU_TAG    = "#PROF_CPU "
+SAMPLE_TAG = "#PROF "
+END_TAG    = "#PROF_END"
+
+def ParseProfile(filename):
+    # Returns the samples count by (tid, frames), the per-CPU statistics and
+    # the profiler source, None if the profile output did not complete. The
+    # frames are the outermost first, resolved by the kernel or addresses
+    samples = {}
+    cpus    = []
+    source  = None
+    done    = False
+    with open(filename, "r", errors = "replace") as inputFile:
+        for line in inputFile:
+            line = line.strip()
+            if line.startswith(START_TAG):
+                source = line[len(START_TAG):]
+                samples = {}
+                cpus    = []
+                done    = False
+            elif line.startswith(CPU_TAG):
+                cpus.append([int(value) for value in line[len(CPU_TAG):].split()])
+            elif line.startswith(SAMPLE_TAG):
+                key, count = line[len(SAMPLE_TAG):].rsplit(None, 1)
+                frames = key.split(";")
+                key = (int(frames[0]), tuple(frames[1:]))
+                samples[key] = samples.get(key, 0) + int(count)
+            elif line.startswith(END_TAG):
+                done = True
+    if not done:
+        return None
+    return samples, cpus, source
+
+def LoadSymbols(kernelFile, nm):
+    # Returns the sorted text symbols addresses and names
+    output  = subprocess.check_output([nm, "-n", "-C", kernelFile], universal_newlines = True)
+    addresses = []
+    names     = []
+    for line in output.splitlines():
+        fields = line.split(None, 2)
+        if len(fields) == 3 and fields[1] in "tTwW":
+            addresses.append(int(fields[0], 16))
+            names.append(fields[2])
+    return addresses, names
+
+def Symbolize(address, addresses, names):
+    index = bisect.bisect_right(addresses, address) - 1
+    if index < 0:
+        return "0x{:x}".format(address)
+    return names[index]
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("log_file", help = "the kernel output containing the profile")
+    parser.add_argument("kernel_file", help = "the kernel ELF the profile was taken on")
+    parser.add_argument("--nm", default = "nm", help = "the nm binary matching the target")
+    parser.add_argument("--no-tid", action = "store_true", help = "merges the samples of all the threads")
+    args = parser.parse_args()
+
+    profile = ParseProfile(args.log_file)
+    if profile is None:
+        print("Error: the profile output did not complete")
+        exit(1)
+    samples, cpus, source = profile
+
+    addresses, names = LoadSymbols(args.kernel_file, args.nm)
+
+    # Folded stacks output, accepted by the flame graph tools. The kernel only
+    # leaves the addresses it could not resolve, the last frame is the
+    # sampled instruction, the others are return addresses.
+    folded = {}
+    for (tid, frames), count in samples.items():
+        symbols = []
+        for i, frame in enumerate(frames):
+            if frame.startswith("0x"):
+                address = int(frame, 16)
+                if i != len(frames) - 1:
+                    address -= 1
+                frame = Symbolize(address, addresses, names)
+            symbols.append(frame)
+        key = ";".join(symbols) if args.no_tid else "tid_{};{}".format(tid, ";".join(symbols))
+        folded[key] = folded.get(key, 0) + count
+
+    for key, count in sorted(folded.items(), key = lambda item: -item[1]):
+        print("{} {}".format(key, count))
+
+    for cpu in cpus:
+        print("# CPU {}: {} samples, {} dropped".format(cpu[0], cpu[1], cpu[2]), file = sys.stderr)
+    print("# Source: {}".format(source), file = sys.stderr)
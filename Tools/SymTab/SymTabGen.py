@@ -0,0 +1,93 @@
+import argparse
+import struct
+import subprocess
+import sys
+
+# Table layout, must match stack_trace_symtab_t in stack_trace.h
+SYMTAB_MAGIC  = 0x4D59534B
+HEADER_FORMAT = "<IIIIQ"
+
+# Linker symbols bounding the kernel text and the symbol table region
+TEXT_START  = "_START_TEXT_ADDR"
+TEXT_END    = "_END_TEXT_ADDR"
+REGION_SIZE = "_KERNEL_SYMTAB_REG_SIZE"
+
+# Text symbols types, the global ones are preferred for aliases
+GLOBAL_TYPES = "TW"
+LOCAL_TYPES  = "tw"
+
+def LoadSymbols(kernelFile, nm):
+    # Returns the symbols values and types by name, the text symbols as
+    # (address, global, name) tuples
+    output  = subprocess.check_output([nm, "--defined-only", kernelFile], universal_newlines = True)
+    values  = {}
+    symbols = []
+    for line in output.splitlines():
+        fields = line.split()
+        if len(fields) != 3:
+            continue
+        address, symbolType, name = int(fields[0], 16), fields[1], fields[2]
+        values[name] = address
+        if symbolType in GLOBAL_TYPES or symbolType in LOCAL_TYPES:
+            symbols.append((address, symbolType in GLOBAL_TYPES, name))
+    return values, symbols
+
+def BuildTable(values, symbols):
+    base = values[TEXT_START]
+    end  = values[TEXT_END]
+
+    # One name per address, the global symbol wins over the local aliases
+    byAddress = {}
+    for address, isGlobal, name in symbols:
+        if address < base or address >= end or name in (TEXT_START, TEXT_END):
+            continue
+        current = byAddress.get(address)
+        if current is None or (isGlobal and not current[0]):
+            byAddress[address] = (isGlobal, name)
+
+    offsets = []
+    nameOffsets = []
+    names = bytearray()
+    for address in sorted(byAddress):
+        offsets.append(address - base)
+        nameOffsets.append(len(names))
+        names += byAddress[address][1].encode() + b"\0"
+
+    # Keeps the table size a multiple of 8
+    while len(names) % 8 != 0:
+        names += b"\0"
+
+    table  = struct.pack(HEADER_FORMAT, SYMTAB_MAGIC, len(offsets), len(names), 0, base)
+    table += struct.pack("<{}I".format(len(offsets)), *offsets)
+    table += struct.pack("<{}I".format(len(nameOffsets)), *nameOffsets)
+    table += bytes(names)
+    return table
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument("kernel_file", help = "the linked kernel ELF")
+    parser.add_argument("table_file", help = "the symbol table file to write or check")
+    parser.add_argument("--nm", default = "nm", help = "the nm binary matching the target")
+    parser.add_argument("--check", action = "store_true", help = "checks that the table matches the kernel")
+    args = parser.parse_args()
+
+    values, symbols = LoadSymbols(args.kernel_file, args.nm)
+    for name in (TEXT_START, TEXT_END, REGION_SIZE):
+        if name not in values:
+            print("Error: {} is not defined in {}".format(name, args.kernel_file))
+            exit(1)
+
+    table = BuildTable(values, symbols)
+    if len(table) > values[REGION_SIZE]:
+        print("Error: the symbol table takes {} bytes, the region only has {}".format(len(table), values[REGION_SIZE]))
+        exit(1)
+
+    if args.check:
+        # The second link must not have moved the kernel text
+        with open(args.table_file, "rb") as tableFile:
+            if tableFile.read() != table:
+                print("Error: the symbol table does not match {}".format(args.kernel_file))
+                exit(1)
+    else:
+        with open(args.table_file, "wb") as tableFile:
+            tableFile.write(table)